@@ -6,6 +6,13 @@ IF (${CMAKE_SYSTEM_PROCESSOR} MATCHES "arm" OR ${CMAKE_SYSTEM_PROCESSOR} MATCHES
    set(SSE3_FOUND   false CACHE BOOL "SSE3 available on host")
    set(SSSE3_FOUND  false CACHE BOOL "SSSE3 available on host")
    set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
+   set(AVX2_FOUND   false CACHE BOOL "AVX2 available on host")
+   # Double precision NEON is part of the 64 bit ARM base instruction set
+   IF (${CMAKE_SYSTEM_PROCESSOR} MATCHES "aarch64|arm64")
+      set(NEON64_FOUND true CACHE BOOL "AArch64 NEON available on host")
+   ELSE ()
+      set(NEON64_FOUND false CACHE BOOL "AArch64 NEON available on host")
+   ENDIF ()
 ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Linux")
    EXEC_PROGRAM(cat ARGS "/proc/cpuinfo" OUTPUT_VARIABLE CPUINFO)
    STRING(REGEX REPLACE "^.*(sse2).*$" "\\1" SSE_THERE ${CPUINFO})
@@ -53,6 +60,15 @@ ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Linux")
       set(SSE4_2_FOUND false CACHE BOOL "SSE4.2 available on host")
    ENDIF (SSE42_TRUE)
 
+   STRING(REGEX REPLACE "^.*(avx2).*$" "\\1" SSE_THERE ${CPUINFO})
+   STRING(COMPARE EQUAL "avx2" "${SSE_THERE}" AVX2_TRUE)
+   IF (AVX2_TRUE)
+      set(AVX2_FOUND true CACHE BOOL "AVX2 available on host")
+   ELSE (AVX2_TRUE)
+      set(AVX2_FOUND false CACHE BOOL "AVX2 available on host")
+   ENDIF (AVX2_TRUE)
+   set(NEON64_FOUND false CACHE BOOL "AArch64 NEON available on host")
+
 ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Darwin")
    EXEC_PROGRAM("/usr/sbin/sysctl -n machdep.cpu.features" OUTPUT_VARIABLE
       CPUINFO)
@@ -88,17 +104,25 @@ ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Darwin")
    ELSE (SSE41_TRUE)
       set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
    ENDIF (SSE41_TRUE)
+
+   # AVX2 is reported in the leaf 7 features
+   set(AVX2_FOUND   false CACHE BOOL "AVX2 available on host")
+   set(NEON64_FOUND false CACHE BOOL "AArch64 NEON available on host")
 ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Windows")
    # TODO
    set(SSE2_FOUND   false CACHE BOOL "SSE2 available on host")
    set(SSE3_FOUND   false CACHE BOOL "SSE3 available on host")
    set(SSSE3_FOUND  false CACHE BOOL "SSSE3 available on host")
    set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
+   set(AVX2_FOUND   false CACHE BOOL "AVX2 available on host")
+   set(NEON64_FOUND false CACHE BOOL "AArch64 NEON available on host")
 ELSE()
    set(SSE2_FOUND   true  CACHE BOOL "SSE2 available on host")
    set(SSE3_FOUND   false CACHE BOOL "SSE3 available on host")
    set(SSSE3_FOUND  false CACHE BOOL "SSSE3 available on host")
    set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
+   set(AVX2_FOUND   false CACHE BOOL "AVX2 available on host")
+   set(NEON64_FOUND false CACHE BOOL "AArch64 NEON available on host")
 ENDIF()
 
 if(NOT SSE2_FOUND)
@@ -114,4 +138,9 @@ if(NOT SSE4_1_FOUND)
       MESSAGE(STATUS "Could not find hardware support for SSE4.1 on this machine.")
 endif(NOT SSE4_1_FOUND)
 
-mark_as_advanced(SSE2_FOUND SSE3_FOUND SSSE3_FOUND SSE4_1_FOUND)
+if(NOT AVX2_FOUND)
+      MESSAGE(STATUS "Could not find hardware support for AVX2 on this machine.")
+endif(NOT AVX2_FOUND)
+
+mark_as_advanced(SSE2_FOUND SSE3_FOUND SSSE3_FOUND SSE4_1_FOUND AVX2_FOUND
+  NEON64_FOUND)
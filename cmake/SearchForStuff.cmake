@@ -550,6 +550,17 @@ if (PKG_CONFIG_FOUND)
     BUILD_WARNING ("GNU Triangulation Surface library not found - Gazebo will not have CSG support.")
   endif ()
 
+  ########################################
+  # Find Zstandard
+  pkg_check_modules(libzstd libzstd)
+  if (libzstd_FOUND)
+    message (STATUS "Looking for libzstd - found")
+    set (HAVE_ZSTD TRUE)
+  else ()
+    set (HAVE_ZSTD FALSE)
+    BUILD_WARNING ("libzstd not found - Gazebo will not record logs with zstd encoding.")
+  endif ()
+
   #################################################
   # Find bullet
   # First and preferred option is to look for bullet standard pkgconfig,
@@ -573,6 +584,11 @@ if (PKG_CONFIG_FOUND)
     add_definitions( -DLIBBULLET_VERSION_GT_282 )
   endif()
 
+  # btDiscreteDynamicsWorldMt and the task schedulers are part of bullet 2.87
+  if (BULLET_VERSION VERSION_GREATER 2.86)
+    add_definitions( -DLIBBULLET_VERSION_GT_286 )
+  endif()
+
   ########################################
   # Find libusb
   pkg_check_modules(libusb-1.0 libusb-1.0)
@@ -586,6 +602,19 @@ if (PKG_CONFIG_FOUND)
     link_directories(${libusb-1.0_LIBRARY_DIRS})
   endif ()
 
+  ########################################
+  # Find EGL, used to render without a display server
+  pkg_check_modules(EGL egl)
+  if (NOT EGL_FOUND)
+    BUILD_WARNING ("EGL not found. Headless rendering without X will be disabled.")
+    set (HAVE_EGL OFF CACHE BOOL "HAVE EGL" FORCE)
+  else()
+    message (STATUS "Looking for EGL - found. Headless rendering enabled.")
+    set (HAVE_EGL ON CACHE BOOL "HAVE EGL" FORCE)
+    include_directories(${EGL_INCLUDE_DIRS})
+    link_directories(${EGL_LIBRARY_DIRS})
+  endif ()
+
   #################################################
   # Find Oculus SDK.
   pkg_check_modules(OculusVR OculusVR)
@@ -298,6 +298,7 @@ ODE_API dSpaceID dGeomGetSpace (dGeomID);
  *  @li dSimpleSpaceClass
  *  @li dHashSpaceClass
  *  @li dQuadTreeSpaceClass
+ *  @li dBVHSpaceClass
  *  @li dFirstUserClass
  *  @li dLastUserClass
  *
@@ -894,7 +895,8 @@ enum {
   dHashSpaceClass,
   dSweepAndPruneSpaceClass, // SAP
   dQuadTreeSpaceClass,
-  dLastSpaceClass = dQuadTreeSpaceClass,
+  dBVHSpaceClass,
+  dLastSpaceClass = dBVHSpaceClass,
 
   dFirstUserClass,
   dLastUserClass = dFirstUserClass + dMaxUserClasses - 1,
@@ -1120,6 +1122,30 @@ typedef struct dxHeightfieldData* dHeightfieldDataID;
  */
 typedef dReal dHeightfieldGetHeight( void* p_user_data, int x, int z );
 
+/**
+ * @brief Callback prototype
+ *
+ * Used by the callback heightfield data type to bound the sample heights
+ * of a rectangular zone.
+ *
+ * @param p_user_data Pointer to user data specified when setting the
+ * callback.
+ *
+ * @param min_x, max_x Inclusive range of sample indices in the local x
+ * axis, within zero to ( nWidthSamples - 1 ).
+ *
+ * @param min_z, max_z Inclusive range of sample indices in the local z
+ * axis, within zero to ( nDepthSamples - 1 ).
+ *
+ * @param min_height, max_height Bounds of the sample heights of the zone,
+ * before scale and offset are applied. They may be conservative, but
+ * every sample of the zone must be within them.
+ *
+ * @ingroup collide
+ */
+typedef void dHeightfieldGetRange( void* p_user_data, int min_x, int max_x,
+        int min_z, int max_z, dReal* min_height, dReal* max_height );
+
 
 
 /**
@@ -1434,6 +1460,24 @@ ODE_API void dGeomHeightfieldDataSetBounds( dHeightfieldDataID d,
         dReal minHeight, dReal maxHeight );
 
 
+/**
+ * @brief Set a callback that bounds the heights of a zone of samples.
+ *
+ * Before testing a geom against the cells under its AABB, the collider
+ * asks for the height range of those cells, and skips them all when the
+ * geom is above the range. This avoids reading every sample of the zone
+ * when the callback answers from a precomputed hierarchy. It is ignored
+ * in wrap mode.
+ *
+ * @param d A dHeightfieldDataID created by dGeomHeightfieldDataCreate
+ * @param pUserData User data passed to the callback.
+ * @param pCallback The callback, or NULL to disable it.
+ * @ingroup collide
+ */
+ODE_API void dGeomHeightfieldDataSetRangeCallback( dHeightfieldDataID d,
+        void* pUserData, dHeightfieldGetRange* pCallback );
+
+
 /**
  * @brief Assigns a dHeightfieldDataID to a heightfield geom.
  *
@@ -65,6 +65,32 @@ ODE_API dSpaceID dQuadTreeSpaceCreate (dSpaceID space, const dVector3 Center, co
 
 ODE_API dSpaceID dSweepAndPruneSpaceCreate( dSpaceID space, int axisorder );
 
+/**
+ * @brief Create a persistent dynamic AABB tree space.
+ *
+ * Geoms are kept in a balanced AABB tree using AABBs enlarged by a margin.
+ * A geom is only reinserted when it leaves its enlarged AABB, and the
+ * overlapping pairs are cached across calls to dSpaceCollide, so geoms
+ * that do not move cost nothing in the broadphase.
+ *
+ * @param space the parent space, or 0.
+ * @ingroup collide
+ */
+ODE_API dSpaceID dBVHSpaceCreate (dSpaceID space);
+
+/**
+ * @brief Set the margin added around the geom AABBs of a BVH space.
+ *
+ * A larger margin means fewer reinsertions for moving geoms, but more
+ * pairs passed to the AABB test.
+ *
+ * @param space the BVH space.
+ * @param margin the margin, must be >= 0.
+ * @ingroup collide
+ */
+ODE_API void dBVHSpaceSetMargin (dSpaceID space, dReal margin);
+ODE_API dReal dBVHSpaceGetMargin (dSpaceID space);
+
 
 
 ODE_API void dSpaceDestroy (dSpaceID);
@@ -161,6 +187,7 @@ ODE_API dGeomID dSpaceGetGeom (dSpaceID, int i);
  *  @li dHashSpaceClass
  *  @li dSweepAndPruneSpaceClass
  *  @li dQuadTreeSpaceClass
+ *  @li dBVHSpaceClass
  *  @li dFirstUserClass
  *  @li dLastUserClass
  *
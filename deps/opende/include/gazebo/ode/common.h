@@ -31,7 +31,12 @@
 extern "C" {
 #endif
 
+/* The precision is chosen at build time, see ODE_SINGLE_PRECISION in the
+   top level CMakeLists.txt. Users of the installed headers get the define
+   from pkg-config or the gazebo cmake config. */
+#if !defined(dSINGLE) && !defined(dDOUBLE)
 #define dDOUBLE 1
+#endif
 #define __ODE__ 1
 
 
@@ -71,6 +71,14 @@ ODE_API dWorldID dWorldCreate(void);
 ODE_API int dWorldGetBodyCount(dWorldID world);
 ODE_API dBodyID dWorldGetBody(dWorldID world, int id);
 
+/**
+ * @brief Get the first body of a world, to iterate over its bodies.
+ * @return The first body, 0 if the world has none.
+ * @sa dBodyGetNextBody
+ * @ingroup world
+ */
+ODE_API dBodyID dWorldGetFirstBody(dWorldID world);
+
 
 /**
  * @brief Destroy a world and everything in it.
@@ -108,10 +116,22 @@ ODE_API int dWorldGetIslandThreads (dWorldID);
  */
 ODE_API void dWorldSetIslandThreads (dWorldID, int num_island_threads);
 
+/**
+ * @brief Get the number of thread pool threads for quickstep
+ *
+ * @ingroup world
+ */
+ODE_API int dWorldGetQuickStepThreads (dWorldID);
+
 /**
  * @brief Set the number of thread pool threads for quickstep
  *
+ * When non-zero, the PGS sweep of each island is parallelized over its
+ * constraint rows: rows are grouped by joint, the groups are colored so
+ * that no two groups of a color share a body, and the groups of a color
+ * are solved concurrently.
  * @ingroup world
+ * @sa dWorldSetQuickStepDeterministicRows
  */
 ODE_API void dWorldSetQuickStepThreads (dWorldID, int num_quickstep_threads);
 
@@ -587,6 +607,13 @@ ODE_API dReal dWorldGetQuickStepContactSORScalingFactor (dWorldID);
  */
 ODE_API bool dWorldGetQuickStepThreadPositionCorrection (dWorldID);
 
+/**
+ * @brief Get whether the threaded row sweep is deterministic.
+ * see dWorldSetQuickStepDeterministicRows for details.
+ * @ingroup world
+ */
+ODE_API bool dWorldGetQuickStepDeterministicRows (dWorldID);
+
 /**
  * @brief Get option to turn on experimental row reordering.
  * see dWorldGetQuickStepExperimentalRowReordering for details.
@@ -646,6 +673,22 @@ ODE_API void dWorldSetQuickStepContactSORScalingFactor (dWorldID, dReal contact_
  */
 ODE_API void dWorldSetQuickStepThreadPositionCorrection (dWorldID, bool thread);
 
+/**
+ * @brief Choose between reproducibility and throughput for the threaded
+ * row sweep enabled by dWorldSetQuickStepThreads.
+ *
+ * When deterministic (the default), the colors are solved one after the
+ * other with a barrier in between, so that the result is bit-exact from
+ * run to run and does not depend on the number of threads.
+ * Otherwise all colors of an iteration are solved at once and only the
+ * iterations are synchronized. Rows of different colors may then update
+ * the same body concurrently, which is faster but not reproducible.
+ * @ingroup world
+ * @param deterministic set to false to drop the barriers between colors
+ */
+ODE_API void dWorldSetQuickStepDeterministicRows (dWorldID,
+  bool deterministic);
+
 /**
  * @brief Turn on experimental row reordering, so within one sweep,
  * following ordering of constraints are used:
@@ -1606,6 +1649,24 @@ ODE_API void dBodyDisable (dBodyID);
  */
 ODE_API int dBodyIsEnabled (dBodyID);
 
+/**
+ * @brief Enable or disable a body without resetting its auto-disable
+ * counters, so that a body disabled for a while keeps its idle time.
+ * @ingroup bodies
+ * @param enabled 1 to enable the body, 0 to disable it.
+ * @sa dBodyEnable
+ * @sa dBodyDisable
+ */
+ODE_API void dBodySetEnabledFlag (dBodyID, int enabled);
+
+/**
+ * @brief Get the next body of the world of a body.
+ * @ingroup bodies
+ * @return The next body, 0 if this is the last one.
+ * @sa dWorldGetFirstBody
+ */
+ODE_API dBodyID dBodyGetNextBody (dBodyID);
+
 /**
  * @brief Set whether the body is influenced by the world's gravity or not.
  * @ingroup bodies
@@ -2131,6 +2192,23 @@ ODE_API void dJointSetFeedback (dJointID, dJointFeedback *);
  */
 ODE_API dJointFeedback *dJointGetFeedback (dJointID);
 
+/**
+ * @brief Get the constraint impulses of the last step, used to warm start
+ * the quickstep solver on the next step.
+ * @ingroup joints
+ * @param lambda receives 6 values.
+ * @param lambda_erp receives 6 values.
+ */
+ODE_API void dJointGetWarmStart (dJointID, dReal *lambda, dReal *lambda_erp);
+
+/**
+ * @brief Set the constraint impulses used to warm start the quickstep
+ * solver, as returned by dJointGetWarmStart.
+ * @ingroup joints
+ */
+ODE_API void dJointSetWarmStart (dJointID, const dReal *lambda,
+    const dReal *lambda_erp);
+
 /**
  * @brief Set the joint anchor point.
  * @ingroup joints
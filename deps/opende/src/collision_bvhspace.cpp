@@ -0,0 +1,764 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001-2003 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+/*
+ *	Persistent dynamic AABB tree space.
+ *
+ *	The geoms are the leaves of a balanced binary AABB tree. Each leaf
+ *	stores the geom AABB enlarged by a margin ("fat" AABB), so a geom that
+ *	moves a little is not touched. A geom is reinserted only when its AABB
+ *	leaves the fat AABB. Overlapping leaf pairs are cached between calls
+ *	to collide(): only the pairs of reinserted leaves are recomputed, by
+ *	querying the tree with their new fat AABB. A geom that does not move
+ *	therefore costs nothing in the broadphase.
+ *
+ *	Geoms with infinite AABBs (planes) are kept out of the tree and tested
+ *	against all the other geoms, like in the SAP space.
+ */
+
+#include <gazebo/ode/common.h>
+#include <gazebo/ode/odemath.h>
+#include <gazebo/ode/matrix.h>
+#include <gazebo/ode/collision_space.h>
+#include <gazebo/ode/collision.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "collision_kernel.h"
+#include "collision_space_internal.h"
+
+#define GEOM_ENABLED(g) (((g)->gflags & GEOM_ENABLE_TEST_MASK) == GEOM_ENABLE_TEST_VALUE)
+
+// Default margin added around the geom AABBs.
+#define BVH_DEFAULT_MARGIN REAL(0.05)
+
+// Leaf index of geoms that are not in the tree.
+#define BVH_INFINITE_LEAF (-1)
+#define BVH_PENDING_LEAF (-2)
+
+#define BVH_NULL_NODE (-1)
+
+struct dxBVHSpace : public dxSpace
+{
+	dxBVHSpace( dSpaceID _space );
+	~dxBVHSpace();
+
+	// dxSpace
+	virtual void add( dxGeom* g );
+	virtual void remove( dxGeom* g );
+	virtual void computeAABB();
+	virtual void cleanGeoms();
+	virtual void collide( void *data, dNearCallback *callback );
+	virtual void collide2( void *data, dxGeom *geom, dNearCallback *callback );
+
+	void setMargin( dReal _margin ) { margin = _margin; }
+	dReal getMargin() const { return margin; }
+
+private:
+
+	struct Node
+	{
+		dReal aabb[6];	// fat AABB of a leaf, union of children otherwise
+		dxGeom* geom;	// geom of a leaf, 0 otherwise
+		int parent;		// parent node, or next free node
+		int child1;
+		int child2;
+		int height;		// 0 for leaves, -1 for free nodes
+
+		bool isLeaf() const { return child1 == BVH_NULL_NODE; }
+	};
+
+	typedef std::pair<int, int> Pair;
+
+	// Tree maintenance
+	int allocateNode();
+	void freeNode( int id );
+	void insertLeaf( int leaf );
+	void removeLeaf( int leaf );
+	int balance( int id );
+	void fitNode( int id );
+
+	// Keep the tree and the pair cache in sync with a cleaned geom.
+	void updateGeom( dxGeom* g );
+	void destroyLeaf( int leaf );
+
+	// Recompute the cached pairs of the reinserted leaves.
+	void updatePairs();
+
+	// Call _fn on every leaf whose fat AABB overlaps _aabb.
+	template <typename Fn>
+	void query( const dReal* _aabb, Fn _fn );
+
+	static bool isInfinite( const dReal* _aabb );
+	static bool overlap( const dReal* _a, const dReal* _b );
+	static bool contains( const dReal* _outer, const dReal* _inner );
+	static void combine( const dReal* _a, const dReal* _b, dReal* _out );
+	static dReal area( const dReal* _aabb );
+
+	dReal margin;
+
+	std::vector<Node> nodes;
+	int root;
+	int freeList;
+
+	// Leaf of each geom, or BVH_INFINITE_LEAF / BVH_PENDING_LEAF.
+	std::unordered_map<dxGeom*, int> leaves;
+
+	// Geoms with infinite AABBs.
+	std::vector<dxGeom*> infiniteGeoms;
+
+	// Leaves reinserted since the last pair update.
+	std::vector<int> moved;
+	std::vector<char> movedFlags;
+
+	// Leaf pairs with overlapping fat AABBs, sorted.
+	std::vector<Pair> pairs;
+
+	// Traversal stack.
+	std::vector<int> stack;
+};
+
+//==============================================================================
+
+dxBVHSpace::dxBVHSpace( dSpaceID _space ) : dxSpace( _space )
+{
+	type = dBVHSpaceClass;
+	margin = BVH_DEFAULT_MARGIN;
+	root = BVH_NULL_NODE;
+	freeList = BVH_NULL_NODE;
+}
+
+dxBVHSpace::~dxBVHSpace()
+{
+	CHECK_NOT_LOCKED(this);
+	// empty the space here so that our remove() is used
+	if ( cleanup ) {
+		// note that destroying each geom will call remove()
+		while ( first ) dGeomDestroy( first );
+	}
+	else {
+		while ( first ) remove( first );
+	}
+}
+
+void dxBVHSpace::add( dxGeom* g )
+{
+	dxSpace::add( g );
+	// the leaf is created when the geom is cleaned
+	leaves[g] = BVH_PENDING_LEAF;
+}
+
+void dxBVHSpace::remove( dxGeom* g )
+{
+	std::unordered_map<dxGeom*, int>::iterator iter = leaves.find( g );
+	dUASSERT( iter != leaves.end(), "object is not in this space" );
+
+	const int leaf = iter->second;
+	if ( leaf >= 0 ) {
+		destroyLeaf( leaf );
+	}
+	else if ( leaf == BVH_INFINITE_LEAF ) {
+		infiniteGeoms.erase( std::find( infiniteGeoms.begin(),
+			infiniteGeoms.end(), g ) );
+	}
+	leaves.erase( iter );
+
+	dxSpace::remove( g );
+}
+
+void dxBVHSpace::computeAABB()
+{
+	cleanGeoms();
+
+	if ( !infiniteGeoms.empty() ) {
+		aabb[0] = -dInfinity;
+		aabb[1] = dInfinity;
+		aabb[2] = -dInfinity;
+		aabb[3] = dInfinity;
+		aabb[4] = -dInfinity;
+		aabb[5] = dInfinity;
+	}
+	else if ( root != BVH_NULL_NODE ) {
+		// the fat AABB of the root is a valid, slightly loose, bound
+		memcpy( aabb, nodes[root].aabb, 6 * sizeof(dReal) );
+	}
+	else {
+		dSetZero( aabb, 6 );
+	}
+}
+
+void dxBVHSpace::cleanGeoms()
+{
+	// compute the AABBs of all dirty geoms, and clear the dirty flags.
+	// dirty geoms are at the front of the list.
+	lock_count++;
+	for ( dxGeom *g = first; g && (g->gflags & GEOM_DIRTY); g = g->next ) {
+		if ( IS_SPACE(g) ) {
+			((dxSpace*)g)->cleanGeoms();
+		}
+		g->recomputeAABB();
+		g->gflags &= (~(GEOM_DIRTY|GEOM_AABB_BAD));
+		updateGeom( g );
+	}
+	lock_count--;
+}
+
+void dxBVHSpace::collide( void *_data, dNearCallback *callback )
+{
+	dAASSERT( callback );
+
+	lock_count++;
+
+	cleanGeoms();
+	updatePairs();
+
+	// cached pairs, the tight AABBs are tested by collideAABBs
+	const size_t pairCount = pairs.size();
+	for ( size_t i = 0; i < pairCount; ++i ) {
+		dxGeom* g1 = nodes[pairs[i].first].geom;
+		dxGeom* g2 = nodes[pairs[i].second].geom;
+		if ( GEOM_ENABLED(g1) && GEOM_ENABLED(g2) )
+			collideAABBs( g1, g2, _data, callback );
+	}
+
+	// infinite geoms against everything
+	const size_t infCount = infiniteGeoms.size();
+	const size_t nodeCount = nodes.size();
+	for ( size_t m = 0; m < infCount; ++m ) {
+		dxGeom* g1 = infiniteGeoms[m];
+		if ( !GEOM_ENABLED(g1) )
+			continue;
+
+		for ( size_t n = m + 1; n < infCount; ++n ) {
+			dxGeom* g2 = infiniteGeoms[n];
+			if ( GEOM_ENABLED(g2) )
+				collideAABBs( g1, g2, _data, callback );
+		}
+
+		for ( size_t n = 0; n < nodeCount; ++n ) {
+			const Node& node = nodes[n];
+			if ( node.height == 0 && GEOM_ENABLED(node.geom) )
+				collideAABBs( g1, node.geom, _data, callback );
+		}
+	}
+
+	lock_count--;
+}
+
+void dxBVHSpace::collide2( void *_data, dxGeom *geom, dNearCallback *callback )
+{
+	dAASSERT( geom && callback );
+
+	lock_count++;
+
+	cleanGeoms();
+	geom->recomputeAABB();
+
+	if ( isInfinite( geom->aabb ) ) {
+		for ( dxGeom *g = first; g; g = g->next ) {
+			if ( GEOM_ENABLED(g) ) collideAABBs( g, geom, _data, callback );
+		}
+	}
+	else {
+		query( geom->aabb, [&]( int _leaf ) {
+			dxGeom* g = nodes[_leaf].geom;
+			if ( GEOM_ENABLED(g) ) collideAABBs( g, geom, _data, callback );
+		} );
+
+		const size_t infCount = infiniteGeoms.size();
+		for ( size_t i = 0; i < infCount; ++i ) {
+			dxGeom* g = infiniteGeoms[i];
+			if ( GEOM_ENABLED(g) ) collideAABBs( g, geom, _data, callback );
+		}
+	}
+
+	lock_count--;
+}
+
+//==============================================================================
+
+void dxBVHSpace::updateGeom( dxGeom* g )
+{
+	int& leaf = leaves[g];
+
+	if ( isInfinite( g->aabb ) ) {
+		if ( leaf >= 0 )
+			destroyLeaf( leaf );
+		if ( leaf != BVH_INFINITE_LEAF ) {
+			infiniteGeoms.push_back( g );
+			leaf = BVH_INFINITE_LEAF;
+		}
+		return;
+	}
+
+	if ( leaf == BVH_INFINITE_LEAF ) {
+		infiniteGeoms.erase( std::find( infiniteGeoms.begin(),
+			infiniteGeoms.end(), g ) );
+		leaf = BVH_PENDING_LEAF;
+	}
+
+	if ( leaf >= 0 ) {
+		// still inside the fat AABB: nothing to do
+		if ( contains( nodes[leaf].aabb, g->aabb ) )
+			return;
+		removeLeaf( leaf );
+	}
+	else {
+		leaf = allocateNode();
+		nodes[leaf].geom = g;
+	}
+
+	Node& node = nodes[leaf];
+	for ( int i = 0; i < 6; i += 2 ) {
+		node.aabb[i] = g->aabb[i] - margin;
+		node.aabb[i+1] = g->aabb[i+1] + margin;
+	}
+	insertLeaf( leaf );
+
+	if ( (size_t)leaf >= movedFlags.size() )
+		movedFlags.resize( nodes.size(), 0 );
+	if ( !movedFlags[leaf] ) {
+		movedFlags[leaf] = 1;
+		moved.push_back( leaf );
+	}
+}
+
+void dxBVHSpace::destroyLeaf( int leaf )
+{
+	removeLeaf( leaf );
+
+	// drop the cached pairs of the leaf
+	size_t kept = 0;
+	for ( size_t i = 0; i < pairs.size(); ++i ) {
+		if ( pairs[i].first != leaf && pairs[i].second != leaf )
+			pairs[kept++] = pairs[i];
+	}
+	pairs.resize( kept );
+
+	if ( (size_t)leaf < movedFlags.size() && movedFlags[leaf] ) {
+		movedFlags[leaf] = 0;
+		moved.erase( std::find( moved.begin(), moved.end(), leaf ) );
+	}
+
+	freeNode( leaf );
+}
+
+void dxBVHSpace::updatePairs()
+{
+	if ( moved.empty() )
+		return;
+
+	// the pairs of the moved leaves are found again below
+	size_t kept = 0;
+	for ( size_t i = 0; i < pairs.size(); ++i ) {
+		if ( !movedFlags[pairs[i].first] && !movedFlags[pairs[i].second] )
+			pairs[kept++] = pairs[i];
+	}
+	pairs.resize( kept );
+
+	const size_t movedCount = moved.size();
+	for ( size_t i = 0; i < movedCount; ++i ) {
+		const int leaf = moved[i];
+		query( nodes[leaf].aabb, [&]( int _other ) {
+			if ( _other == leaf )
+				return;
+			// a pair of two moved leaves is found twice, keep one
+			if ( movedFlags[_other] && _other < leaf )
+				return;
+			pairs.push_back( Pair( std::min( leaf, _other ),
+				std::max( leaf, _other ) ) );
+		} );
+	}
+
+	// sorted pairs give the same callback order for the same tree
+	std::sort( pairs.begin(), pairs.end() );
+
+	for ( size_t i = 0; i < movedCount; ++i )
+		movedFlags[moved[i]] = 0;
+	moved.clear();
+}
+
+template <typename Fn>
+void dxBVHSpace::query( const dReal* _aabb, Fn _fn )
+{
+	if ( root == BVH_NULL_NODE )
+		return;
+
+	stack.clear();
+	stack.push_back( root );
+	while ( !stack.empty() ) {
+		const int id = stack.back();
+		stack.pop_back();
+
+		const Node& node = nodes[id];
+		if ( !overlap( node.aabb, _aabb ) )
+			continue;
+
+		if ( node.isLeaf() ) {
+			_fn( id );
+		}
+		else {
+			stack.push_back( node.child1 );
+			stack.push_back( node.child2 );
+		}
+	}
+}
+
+//==============================================================================
+// Tree maintenance, see "Dynamic AABB trees" by E. Catto (Box2D) and
+// btDbvt (Bullet).
+
+int dxBVHSpace::allocateNode()
+{
+	if ( freeList == BVH_NULL_NODE ) {
+		Node node;
+		node.height = -1;
+		node.parent = BVH_NULL_NODE;
+		nodes.push_back( node );
+		freeList = (int)nodes.size() - 1;
+	}
+
+	const int id = freeList;
+	Node& node = nodes[id];
+	freeList = node.parent;
+	node.parent = BVH_NULL_NODE;
+	node.child1 = BVH_NULL_NODE;
+	node.child2 = BVH_NULL_NODE;
+	node.geom = 0;
+	node.height = 0;
+	return id;
+}
+
+void dxBVHSpace::freeNode( int id )
+{
+	Node& node = nodes[id];
+	node.parent = freeList;
+	node.geom = 0;
+	node.height = -1;
+	freeList = id;
+}
+
+void dxBVHSpace::insertLeaf( int leaf )
+{
+	if ( root == BVH_NULL_NODE ) {
+		root = leaf;
+		nodes[root].parent = BVH_NULL_NODE;
+		return;
+	}
+
+	// find the best sibling, using the surface area heuristic
+	dReal leafAABB[6];
+	memcpy( leafAABB, nodes[leaf].aabb, 6 * sizeof(dReal) );
+
+	int index = root;
+	while ( !nodes[index].isLeaf() ) {
+		const Node& node = nodes[index];
+		const int child1 = node.child1;
+		const int child2 = node.child2;
+
+		dReal combined[6];
+		combine( node.aabb, leafAABB, combined );
+		const dReal nodeArea = area( node.aabb );
+		const dReal combinedArea = area( combined );
+
+		// cost of creating a new parent for this node and the new leaf
+		const dReal cost = 2 * combinedArea;
+
+		// minimum cost of pushing the leaf further down the tree
+		const dReal inheritanceCost = 2 * (combinedArea - nodeArea);
+
+		dReal childCost[2];
+		const int children[2] = { child1, child2 };
+		for ( int c = 0; c < 2; ++c ) {
+			const Node& child = nodes[children[c]];
+			combine( child.aabb, leafAABB, combined );
+			if ( child.isLeaf() )
+				childCost[c] = area( combined ) + inheritanceCost;
+			else
+				childCost[c] = area( combined ) - area( child.aabb ) +
+					inheritanceCost;
+		}
+
+		if ( cost < childCost[0] && cost < childCost[1] )
+			break;
+
+		index = childCost[0] < childCost[1] ? child1 : child2;
+	}
+
+	const int sibling = index;
+
+	// create a new parent, this can reallocate the nodes
+	const int oldParent = nodes[sibling].parent;
+	const int newParent = allocateNode();
+	Node& parent = nodes[newParent];
+	parent.parent = oldParent;
+	parent.geom = 0;
+	combine( leafAABB, nodes[sibling].aabb, parent.aabb );
+	parent.height = nodes[sibling].height + 1;
+	parent.child1 = sibling;
+	parent.child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if ( oldParent != BVH_NULL_NODE ) {
+		if ( nodes[oldParent].child1 == sibling )
+			nodes[oldParent].child1 = newParent;
+		else
+			nodes[oldParent].child2 = newParent;
+	}
+	else {
+		root = newParent;
+	}
+
+	// walk back up the tree fixing heights and AABBs
+	index = nodes[leaf].parent;
+	while ( index != BVH_NULL_NODE ) {
+		index = balance( index );
+		fitNode( index );
+		index = nodes[index].parent;
+	}
+}
+
+void dxBVHSpace::removeLeaf( int leaf )
+{
+	if ( leaf == root ) {
+		root = BVH_NULL_NODE;
+		return;
+	}
+
+	const int parent = nodes[leaf].parent;
+	const int grandParent = nodes[parent].parent;
+	const int sibling = nodes[parent].child1 == leaf ?
+		nodes[parent].child2 : nodes[parent].child1;
+
+	if ( grandParent != BVH_NULL_NODE ) {
+		// destroy the parent and connect the sibling to the grand parent
+		if ( nodes[grandParent].child1 == parent )
+			nodes[grandParent].child1 = sibling;
+		else
+			nodes[grandParent].child2 = sibling;
+		nodes[sibling].parent = grandParent;
+		freeNode( parent );
+
+		int index = grandParent;
+		while ( index != BVH_NULL_NODE ) {
+			index = balance( index );
+			fitNode( index );
+			index = nodes[index].parent;
+		}
+	}
+	else {
+		root = sibling;
+		nodes[sibling].parent = BVH_NULL_NODE;
+		freeNode( parent );
+	}
+
+	nodes[leaf].parent = BVH_NULL_NODE;
+}
+
+void dxBVHSpace::fitNode( int id )
+{
+	Node& node = nodes[id];
+	const Node& child1 = nodes[node.child1];
+	const Node& child2 = nodes[node.child2];
+	node.height = 1 + std::max( child1.height, child2.height );
+	combine( child1.aabb, child2.aabb, node.aabb );
+}
+
+// Perform a left or right rotation if node A is imbalanced, and return the
+// new root of the subtree.
+int dxBVHSpace::balance( int iA )
+{
+	Node* A = &nodes[iA];
+	if ( A->isLeaf() || A->height < 2 )
+		return iA;
+
+	const int iB = A->child1;
+	const int iC = A->child2;
+	Node* B = &nodes[iB];
+	Node* C = &nodes[iC];
+
+	const int heightDiff = C->height - B->height;
+
+	// rotate C up
+	if ( heightDiff > 1 ) {
+		const int iF = C->child1;
+		const int iG = C->child2;
+		Node* F = &nodes[iF];
+		Node* G = &nodes[iG];
+
+		// swap A and C
+		C->child1 = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		// A's old parent should point to C
+		if ( C->parent != BVH_NULL_NODE ) {
+			if ( nodes[C->parent].child1 == iA )
+				nodes[C->parent].child1 = iC;
+			else
+				nodes[C->parent].child2 = iC;
+		}
+		else {
+			root = iC;
+		}
+
+		// rotate
+		if ( F->height > G->height ) {
+			C->child2 = iF;
+			A->child2 = iG;
+			G->parent = iA;
+			combine( B->aabb, G->aabb, A->aabb );
+			combine( A->aabb, F->aabb, C->aabb );
+			A->height = 1 + std::max( B->height, G->height );
+			C->height = 1 + std::max( A->height, F->height );
+		}
+		else {
+			C->child2 = iG;
+			A->child2 = iF;
+			F->parent = iA;
+			combine( B->aabb, F->aabb, A->aabb );
+			combine( A->aabb, G->aabb, C->aabb );
+			A->height = 1 + std::max( B->height, F->height );
+			C->height = 1 + std::max( A->height, G->height );
+		}
+
+		return iC;
+	}
+
+	// rotate B up
+	if ( heightDiff < -1 ) {
+		const int iD = B->child1;
+		const int iE = B->child2;
+		Node* D = &nodes[iD];
+		Node* E = &nodes[iE];
+
+		// swap A and B
+		B->child1 = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		// A's old parent should point to B
+		if ( B->parent != BVH_NULL_NODE ) {
+			if ( nodes[B->parent].child1 == iA )
+				nodes[B->parent].child1 = iB;
+			else
+				nodes[B->parent].child2 = iB;
+		}
+		else {
+			root = iB;
+		}
+
+		// rotate
+		if ( D->height > E->height ) {
+			B->child2 = iD;
+			A->child1 = iE;
+			E->parent = iA;
+			combine( C->aabb, E->aabb, A->aabb );
+			combine( A->aabb, D->aabb, B->aabb );
+			A->height = 1 + std::max( C->height, E->height );
+			B->height = 1 + std::max( A->height, D->height );
+		}
+		else {
+			B->child2 = iE;
+			A->child1 = iD;
+			D->parent = iA;
+			combine( C->aabb, D->aabb, A->aabb );
+			combine( A->aabb, E->aabb, B->aabb );
+			A->height = 1 + std::max( C->height, D->height );
+			B->height = 1 + std::max( A->height, E->height );
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+//==============================================================================
+
+bool dxBVHSpace::isInfinite( const dReal* _aabb )
+{
+	for ( int i = 0; i < 6; i += 2 ) {
+		if ( _dequal( _aabb[i], -dInfinity ) ||
+			 _dequal( _aabb[i+1], dInfinity ) )
+			return true;
+	}
+	return false;
+}
+
+bool dxBVHSpace::overlap( const dReal* _a, const dReal* _b )
+{
+	return _a[0] <= _b[1] && _a[1] >= _b[0] &&
+		_a[2] <= _b[3] && _a[3] >= _b[2] &&
+		_a[4] <= _b[5] && _a[5] >= _b[4];
+}
+
+bool dxBVHSpace::contains( const dReal* _outer, const dReal* _inner )
+{
+	return _outer[0] <= _inner[0] && _outer[1] >= _inner[1] &&
+		_outer[2] <= _inner[2] && _outer[3] >= _inner[3] &&
+		_outer[4] <= _inner[4] && _outer[5] >= _inner[5];
+}
+
+void dxBVHSpace::combine( const dReal* _a, const dReal* _b, dReal* _out )
+{
+	for ( int i = 0; i < 6; i += 2 ) {
+		_out[i] = std::min( _a[i], _b[i] );
+		_out[i+1] = std::max( _a[i+1], _b[i+1] );
+	}
+}
+
+dReal dxBVHSpace::area( const dReal* _aabb )
+{
+	const dReal dx = _aabb[1] - _aabb[0];
+	const dReal dy = _aabb[3] - _aabb[2];
+	const dReal dz = _aabb[5] - _aabb[4];
+	return 2 * (dx * dy + dy * dz + dz * dx);
+}
+
+//==============================================================================
+// space functions
+
+dSpaceID dBVHSpaceCreate( dxSpace* space )
+{
+	return new dxBVHSpace( space );
+}
+
+void dBVHSpaceSetMargin( dxSpace* space, dReal margin )
+{
+	dAASSERT( space );
+	dUASSERT( margin >= 0, "margin must be >= 0" );
+	dUASSERT( space->type == dBVHSpaceClass, "argument must be a BVH space" );
+	((dxBVHSpace*)space)->setMargin( margin );
+}
+
+dReal dBVHSpaceGetMargin( dxSpace* space )
+{
+	dAASSERT( space );
+	dUASSERT( space->type == dBVHSpaceClass, "argument must be a BVH space" );
+	return ((dxBVHSpace*)space)->getMargin();
+}
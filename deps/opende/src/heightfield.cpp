@@ -104,7 +104,9 @@ dxHeightfieldData::dxHeightfieldData() :  m_fWidth( 0 ),
                       m_pHeightData( NULL ),
                       m_pUserData( NULL ),
 
-                      m_pGetHeightCallback( NULL )
+                      m_pGetHeightCallback( NULL ),
+                      m_pGetRangeCallback( NULL ),
+                      m_pRangeUserData( NULL )
 {
   memset( m_contacts, 0, sizeof( m_contacts ) );
 }
@@ -861,6 +863,15 @@ void dGeomHeightfieldDataSetBounds( dHeightfieldDataID d, dReal minHeight, dReal
 }
 
 
+void dGeomHeightfieldDataSetRangeCallback( dHeightfieldDataID d,
+                                          void* pUserData, dHeightfieldGetRange* pCallback )
+{
+    dUASSERT(d, "Argument not Heightfield data");
+    d->m_pRangeUserData = pUserData;
+    d->m_pGetRangeCallback = pCallback;
+}
+
+
 void dGeomHeightfieldDataDestroy( dHeightfieldDataID d )
 {
     dUASSERT(d, "argument not Heightfield data");
@@ -980,6 +991,22 @@ int dxHeightfield::dCollideHeightfieldZone( const int minX, const int maxX, cons
     // localize and const for faster access
     const dReal cfSampleWidth = m_p_data->m_fSampleWidth;
     const dReal cfSampleDepth = m_p_data->m_fSampleDepth;
+
+    // skip the whole zone when the geom is above its highest sample,
+    // without reading the samples
+    if ( m_p_data->m_pGetRangeCallback && m_p_data->m_bWrapMode == 0 )
+    {
+        dReal zoneMin = -dInfinity;
+        dReal zoneMax = dInfinity;
+        (*m_p_data->m_pGetRangeCallback)( m_p_data->m_pRangeUserData,
+            minX, maxX, minZ, maxZ, &zoneMin, &zoneMax );
+        // a negative scale flips the range
+        const dReal h0 = ( zoneMin * m_p_data->m_fScale ) + m_p_data->m_fOffset;
+        const dReal h1 = ( zoneMax * m_p_data->m_fScale ) + m_p_data->m_fOffset;
+        if ( minO2Height - dMAX( h0, h1 ) > -dEpsilon )
+            return 0;
+    }
+
     {
         if (tempHeightBufferSizeX < numX || tempHeightBufferSizeZ < numZ)
         {
@@ -55,6 +55,9 @@ struct dxHeightfieldData
 
     dHeightfieldGetHeight* m_pGetHeightCallback;		// Callback pointer.
 
+    dHeightfieldGetRange* m_pGetRangeCallback;  // Zone bounds callback.
+    void* m_pRangeUserData;                     // Zone bounds user data
+
     dxHeightfieldData();
     ~dxHeightfieldData();
 
@@ -120,6 +120,7 @@ struct dxQuickStepParameters {
   dReal smooth_contacts;  // control quickstep smoothing for contact solution.
   dReal contact_sor_scale;  // sor scaling factor for contacts only
   bool thread_position_correction;  // threaded position correction computations
+  bool deterministic_rows;  // barrier between colors of the threaded row sweep
   bool row_reorder1;  // control quickstep row reordering
   dReal warm_start;  // warm start factor, 0: no warm start, 1: full warm start
   int friction_iterations;  // extra quickstep iterations friction.
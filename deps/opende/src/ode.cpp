@@ -910,6 +910,21 @@ int dBodyIsEnabled (dBodyID b)
 }
 
 
+void dBodySetEnabledFlag (dBodyID b, int enabled)
+{
+  dAASSERT (b);
+  if (enabled) b->flags &= ~dxBodyDisabled;
+  else b->flags |= dxBodyDisabled;
+}
+
+
+dBodyID dBodyGetNextBody (dBodyID b)
+{
+  dAASSERT (b);
+  return (dxBody*)b->next;
+}
+
+
 void dBodySetGravityMode (dBodyID b, int mode)
 {
   dAASSERT (b);
@@ -1542,6 +1557,25 @@ dJointFeedback *dJointGetFeedback (dxJoint *joint)
   return joint->feedback;
 }
 
+void dJointGetWarmStart (dxJoint *joint, dReal *lambda, dReal *lambda_erp)
+{
+  dAASSERT (joint && lambda && lambda_erp);
+  for (int i = 0; i < 6; i++) {
+    lambda[i] = joint->lambda[i];
+    lambda_erp[i] = joint->lambda_erp[i];
+  }
+}
+
+void dJointSetWarmStart (dxJoint *joint, const dReal *lambda,
+    const dReal *lambda_erp)
+{
+  dAASSERT (joint && lambda && lambda_erp);
+  for (int i = 0; i < 6; i++) {
+    joint->lambda[i] = lambda[i];
+    joint->lambda_erp[i] = lambda_erp[i];
+  }
+}
+
 
 
 dJointID dConnectingJoint (dBodyID in_b1, dBodyID in_b2)
@@ -1666,6 +1700,7 @@ dxWorld * dWorldCreate()
   w->qs.smooth_contacts = 0.01;
   w->qs.contact_sor_scale = 0.25;
   w->qs.thread_position_correction = false;
+  w->qs.deterministic_rows = true;
   w->qs.row_reorder1 = true;
   w->qs.warm_start = 0.5;
   w->qs.friction_iterations = 10;
@@ -1700,6 +1735,12 @@ int dWorldGetBodyCount(dxWorld *w)
   return c;
 }
 
+dBodyID dWorldGetFirstBody(dxWorld *w)
+{
+  dAASSERT (w);
+  return w->firstbody;
+}
+
 dBodyID dWorldGetBody(dxWorld *w, int id)
 {
   int c = 0;
@@ -1802,10 +1843,19 @@ void dWorldSetQuickStepThreads (dWorldID w, int num_quickstep_threads)
   }
   if (num_quickstep_threads > 0) {
     w->row_threadpool = new boost::threadpool::pool(num_quickstep_threads);
-    printf("setting quickstep pool threads to %d\n",num_quickstep_threads);
   }
 }
 
+int dWorldGetQuickStepThreads (dWorldID w)
+{
+  dAASSERT (w);
+  if (!w->row_threadpool) {
+    return 0;
+  }
+  // else
+  return w->row_threadpool->size();
+}
+
 void dWorldGetGravity (dWorldID w, dVector3 g)
 {
   dAASSERT (w);
@@ -2191,7 +2241,7 @@ void dWorldSetMaxAngularSpeed(dWorldID w, dReal max_speed)
         w->max_angular_speed = max_speed;
 }
 
-double dWorldGetQuickStepTolerance (dWorldID w)
+dReal dWorldGetQuickStepTolerance (dWorldID w)
 {
   dAASSERT(w);
   return w->qs.pgs_lcp_tolerance;
@@ -2307,6 +2357,12 @@ bool  dWorldGetQuickStepThreadPositionCorrection (dWorldID w)
   return w->qs.thread_position_correction;
 }
 
+bool  dWorldGetQuickStepDeterministicRows (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.deterministic_rows;
+}
+
 bool  dWorldGetQuickStepExperimentalRowReordering (dWorldID w)
 {
   dAASSERT(w);
@@ -2361,6 +2417,12 @@ void dWorldSetQuickStepThreadPositionCorrection (dWorldID w, bool thread)
   w->qs.thread_position_correction = thread;
 }
 
+void dWorldSetQuickStepDeterministicRows (dWorldID w, bool deterministic)
+{
+  dAASSERT(w);
+  w->qs.deterministic_rows = deterministic;
+}
+
 void dWorldSetQuickStepExperimentalRowReordering (dWorldID w, bool order)
 {
   dAASSERT(w);
@@ -19,6 +19,7 @@
 * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
 *                                                                       *
 *************************************************************************/
+#include <stdint.h>
 #include <thread>
 
 #include <gazebo/ode/common.h>
@@ -49,6 +50,56 @@ std::vector<dReal> errors;
 
 using namespace ode;
 
+//***************************************************************************
+// convert the per row type sums of one sweep into the rms values stored
+// in qs, returns the mean of the total residual
+static dReal StoreRMSStats(dxQuickStepParameters *qs,
+  const dReal *rms_dlambda, const dReal *rms_error, const int *m_rms_dlambda)
+{
+  dReal dlambda_bilateral_mean = 0.0;
+  dReal dlambda_contact_normal_mean = 0.0;
+  dReal dlambda_contact_friction_mean = 0.0;
+  dReal dlambda_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
+  if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
+    dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
+  qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
+  qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
+  qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
+
+  dReal residual_bilateral_mean = 0.0;
+  dReal residual_contact_normal_mean = 0.0;
+  dReal residual_contact_friction_mean = 0.0;
+  dReal residual_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
+  if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
+    residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
+  qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
+  qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
+  qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
+  qs->num_contacts = m_rms_dlambda[1];
+
+  return residual_total_mean;
+}
+
 static void* ComputeRows(void *p)
 {
   dxPGSLCPParameters *params = (dxPGSLCPParameters *)p;
@@ -205,7 +256,10 @@ static void* ComputeRows(void *p)
   dRealMutablePtr cforce_ptr2;
   int total_iterations = precon_iterations + num_iterations +
     friction_iterations;
-  for (int iteration = 0; iteration < total_iterations; ++iteration)
+  int iteration_end = params->iteration_end < 0 ? total_iterations :
+    params->iteration_end;
+  for (int iteration = params->iteration_begin; iteration < iteration_end;
+       ++iteration)
   {
     // reset rms_dlambda at beginning of iteration
     rms_dlambda[2] = 0;
@@ -813,50 +867,10 @@ static void* ComputeRows(void *p)
 
     // DO WE NEED TO COMPUTE NORM ACROSS ENTIRE SOLUTION SPACE (0,m)?
     // since local convergence might produce errors in other nodes?
-    dReal dlambda_bilateral_mean = 0.0;
-    dReal dlambda_contact_normal_mean = 0.0;
-    dReal dlambda_contact_friction_mean = 0.0;
-    dReal dlambda_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
-    if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
-      dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
-    qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
-    qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
-    qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
-
-    dReal residual_bilateral_mean = 0.0;
-    dReal residual_contact_normal_mean = 0.0;
-    dReal residual_contact_friction_mean = 0.0;
-    dReal residual_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
-    if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
-      residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
-    qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
-    qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
-    qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
-    qs->num_contacts = m_rms_dlambda[1];
-
 #ifdef HDF5_INSTRUMENT
-    errors[iteration] = residual_total_mean;
+    errors[iteration] =
 #endif
+      StoreRMSStats(qs, rms_dlambda, rms_error, m_rms_dlambda);
     // debugging mutex locking
     //{
     //  // verify
@@ -912,6 +926,14 @@ static void* ComputeRows(void *p)
     }
   } // end of for loop on iterations
 
+  // hand the sums of the last iteration over to the colored row sweep
+  for (int k = 0; k < 3; ++k)
+  {
+    params->rms_dlambda[k] = rms_dlambda[k];
+    params->rms_error[k] = rms_error[k];
+    params->m_rms_dlambda[k] = m_rms_dlambda[k];
+  }
+
 #ifdef SHOW_CONVERGENCE
   // show starting lambda
   printf("final lambdas: [");
@@ -953,6 +975,180 @@ static void* ComputeRows(void *p)
   return NULL;
 }
 
+#ifndef REORDER_CONSTRAINTS
+// rows per task of the colored row sweep. the partition into tasks does not
+// depend on the number of threads, so neither does the result.
+static const int colored_chunk_rows = 64;
+
+// number of colors tracked per body, groups of rows that do not fit in one
+// of them are solved serially after the colored ones.
+static const int max_row_colors = 64;
+
+//***************************************************************************
+// colored row sweep: parallel PGS within a single island.
+//
+// consecutive rows acting on the same pair of bodies are grouped, which
+// keeps the normal and friction rows of a contact together, and the groups
+// are greedily colored so that no two groups of a color share a body.
+// the rows of one color are independent, so they are split into chunks of
+// roughly colored_chunk_rows rows and solved concurrently on the row thread
+// pool. ComputeRows runs a single iteration per chunk, and the convergence
+// statistics are reduced here in chunk order.
+//
+// with qs->deterministic_rows the colors are separated by a barrier and the
+// result is bit-exact regardless of the number of threads. otherwise all
+// chunks of an iteration are scheduled at once, in the spirit of the
+// overlapping chunks above: faster, but rows of different colors may race
+// on the velocity of a shared body.
+//
+// order is rewritten, color by color.
+static void ComputeRowsColored (dxWorldProcessContext *context,
+  const dxPGSLCPParameters *base, boost::threadpool::pool* row_threadpool)
+{
+  const int m = base->m;
+  const int nb = base->nb;
+  const int *jb = base->jb;
+  IndexError *order = base->order;
+  dxQuickStepParameters *qs = base->qs;
+
+  // group the rows
+  int *group_start = context->AllocateArray<int> (m+1);
+  int num_groups = 0;
+  for (int i=0; i<m; i++) {
+    if (i == 0 || jb[i*2] != jb[i*2-2] || jb[i*2+1] != jb[i*2-1])
+      group_start[num_groups++] = i;
+  }
+  group_start[num_groups] = m;
+
+  // color the groups
+  uint64_t *body_colors = context->AllocateArray<uint64_t> (nb);
+  memset (body_colors, 0, nb*sizeof(uint64_t));
+  int *group_color = context->AllocateArray<int> (m);
+  int color_groups[max_row_colors+2];
+  memset (color_groups, 0, sizeof(color_groups));
+  for (int g=0; g<num_groups; g++) {
+    int b1 = jb[group_start[g]*2];
+    int b2 = jb[group_start[g]*2+1];
+    uint64_t used = 0;
+    if (b1 >= 0) used |= body_colors[b1];
+    if (b2 >= 0) used |= body_colors[b2];
+    int color = 0;
+    while (color < max_row_colors && (used & ((uint64_t)1 << color)))
+      color++;
+    if (color < max_row_colors) {
+      if (b1 >= 0) body_colors[b1] |= (uint64_t)1 << color;
+      if (b2 >= 0) body_colors[b2] |= (uint64_t)1 << color;
+    }
+    group_color[g] = color;
+    color_groups[color+1]++;
+  }
+
+  // sort the groups by color, keeping their relative order
+  for (int c=0; c<=max_row_colors; c++)
+    color_groups[c+1] += color_groups[c];
+  int *sorted_groups = context->AllocateArray<int> (m);
+  {
+    int next[max_row_colors+1];
+    memcpy (next, color_groups, sizeof(next));
+    for (int g=0; g<num_groups; g++)
+      sorted_groups[next[group_color[g]]++] = g;
+  }
+
+  // rewrite order and cut each color into chunks at group boundaries.
+  // the overflow color is kept in a single chunk.
+  int *chunk_start = context->AllocateArray<int> (m+1);
+  int color_chunks[max_row_colors+2];
+  int num_chunks = 0;
+  int row = 0;
+  for (int c=0; c<=max_row_colors; c++) {
+    color_chunks[c] = num_chunks;
+    for (int s=color_groups[c]; s<color_groups[c+1]; s++) {
+      if (s == color_groups[c] || (c < max_row_colors &&
+          row - chunk_start[num_chunks-1] >= colored_chunk_rows))
+        chunk_start[num_chunks++] = row;
+      int g = sorted_groups[s];
+      for (int i=group_start[g]; i<group_start[g+1]; i++)
+        order[row++].index = i;
+    }
+  }
+  color_chunks[max_row_colors+1] = num_chunks;
+  chunk_start[num_chunks] = m;
+  dIASSERT (row == m);
+
+  // each chunk writes its convergence statistics to its own copy of qs
+  dxQuickStepParameters *chunk_qs =
+    context->AllocateArray<dxQuickStepParameters> (num_chunks);
+  dxPGSLCPParameters *params =
+    context->AllocateArray<dxPGSLCPParameters> (num_chunks);
+  for (int k=0; k<num_chunks; k++) {
+    chunk_qs[k] = *qs;
+    params[k] = *base;
+    params[k].thread_id = k;
+    params[k].qs = chunk_qs + k;
+    params[k].nStart = chunk_start[k];
+    params[k].nChunkSize = chunk_start[k+1] - chunk_start[k];
+  }
+
+  const int solve_iterations = qs->precon_iterations + qs->num_iterations;
+  const int total_iterations = solve_iterations + qs->friction_iterations;
+  dReal rms_dlambda[3];
+  dSetZero (rms_dlambda, 3);
+  dReal rms_error[3];
+  dSetZero (rms_error, 3);
+  int m_rms_dlambda[3] = {0, 0, 0};
+  for (int iteration=0; iteration<total_iterations; iteration++) {
+    for (int k=0; k<num_chunks; k++) {
+      params[k].iteration_begin = iteration;
+      params[k].iteration_end = iteration + 1;
+    }
+
+    if (qs->deterministic_rows) {
+      for (int c=0; c<=max_row_colors; c++) {
+        int first = color_chunks[c];
+        int last = color_chunks[c+1];
+        if (last - first == 1) {
+          ComputeRows ((void*)(params + first));
+        }
+        else if (last > first) {
+          for (int k=first; k<last; k++) {
+            dxPGSLCPParameters *p = params + k;
+            row_threadpool->schedule ([p] { ComputeRows ((void*)p); });
+          }
+          row_threadpool->wait();
+        }
+      }
+    }
+    else {
+      for (int k=0; k<num_chunks; k++) {
+        dxPGSLCPParameters *p = params + k;
+        row_threadpool->schedule ([p] { ComputeRows ((void*)p); });
+      }
+      row_threadpool->wait();
+    }
+
+    // bilateral and contact normal rows are skipped during the extra
+    // friction iterations, keep their statistics from the last sweep.
+    int first_type = iteration < solve_iterations ? 0 : 2;
+    for (int t=first_type; t<3; t++) {
+      rms_dlambda[t] = 0;
+      rms_error[t] = 0;
+      m_rms_dlambda[t] = 0;
+      for (int k=0; k<num_chunks; k++) {
+        rms_dlambda[t] += params[k].rms_dlambda[t];
+        rms_error[t] += params[k].rms_error[t];
+        m_rms_dlambda[t] += params[k].m_rms_dlambda[t];
+      }
+    }
+    StoreRMSStats (qs, rms_dlambda, rms_error, m_rms_dlambda);
+
+    // option to stop when tolerance has been met
+    if (iteration >= qs->precon_iterations &&
+        qs->rms_constraint_residual[3] < qs->pgs_lcp_tolerance)
+      break;
+  }
+}
+#endif
+
 //***************************************************************************
 // PGS_LCP method was previously SOR_LCP
 //
@@ -975,11 +1171,8 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
-#ifdef USE_TPROW
-  , boost::threadpool::pool* row_threadpool
-#endif
-  )
+  dxQuickStepParameters *qs,
+  boost::threadpool::pool* row_threadpool)
 {
 
   // precompute iMJ = inv(M)*J'
@@ -1200,6 +1393,60 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   boost::recursive_mutex* mutex =
     context->AllocateArray<boost::recursive_mutex>(1);
 
+#ifndef REORDER_CONSTRAINTS
+  if (row_threadpool && row_threadpool->size() > 0 &&
+      m >= 2*colored_chunk_rows)
+  {
+    // parallel sweep over the rows of this island, position correction
+    // is always computed inline in that case.
+    dxPGSLCPParameters base = dxPGSLCPParameters();
+    base.thread_id = 0;
+    base.order     = order;
+    base.body      = body;
+    base.mutex     = mutex;
+    base.inline_position_correction = true;
+    base.position_correction_thread = false;
+#ifdef PENETRATION_JVERROR_CORRECTION
+    base.stepsize = stepsize;
+    base.vnew  = vnew;
+#endif
+    base.qs  = qs;
+    base.nStart = 0;
+    base.nChunkSize = m;
+    base.m = m;
+    base.nb = nb;
+    base.jb = jb;
+    base.findex = findex;
+    base.skip_friction = false;
+    base.hi = hi;
+    base.lo = lo;
+    base.invMOI = invMOI;
+    base.MOI= MOI;
+    base.Ad = Ad;
+    base.Adcfm = Adcfm;
+    base.Adcfm_precon = Adcfm_precon;
+    base.J = J;
+    base.iMJ = iMJ;
+    base.rhs_precon  = rhs_precon;
+    base.J_precon  = J_precon;
+    base.J_orig  = J_orig;
+    base.cforce  = cforce;
+    base.rhs = rhs;
+    base.caccel = caccel;
+    base.lambda = lambda;
+    base.rhs_erp = rhs_erp;
+    base.caccel_erp = caccel_erp;
+    base.lambda_erp = lambda_erp;
+    base.iteration_begin = 0;
+    base.iteration_end = -1;
+
+    IFTIMING (dTimerNow ("start colored pgs rows"));
+    ComputeRowsColored (context, &base, row_threadpool);
+    IFTIMING (dTimerNow ("colored pgs rows done"));
+    return;
+  }
+#endif
+
   // number of chunks must be at least 1
   // (single iteration, through all the constraints)
   int num_chunks = qs->num_chunks > 0 ? qs->num_chunks : 1; // min is 1
@@ -1294,6 +1541,8 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
       params_erp[thread_id].rhs = rhs_erp;
       params_erp[thread_id].caccel = caccel_erp;
       params_erp[thread_id].lambda = lambda_erp;
+      params_erp[thread_id].iteration_begin = 0;
+      params_erp[thread_id].iteration_end = -1;
 
 #ifdef REORDER_CONSTRAINTS
       params_erp[thread_id].last_lambda  = last_lambda_erp;
@@ -1362,6 +1611,8 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     params[thread_id].rhs = rhs;
     params[thread_id].caccel = caccel;
     params[thread_id].lambda = lambda;
+    params[thread_id].iteration_begin = 0;
+    params[thread_id].iteration_end = -1;
 
     if (!qs->thread_position_correction)
     {
@@ -1569,7 +1820,7 @@ void quickstep::dxConeFrictionModel(dReal& lo_act, dReal& hi_act, dReal& lo_act_
   } // if-else (abs(v)< eps)
 }
 
-size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
+size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int nb)
 {
   size_t res = dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for Ad
@@ -1585,6 +1836,16 @@ size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params_erp
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params
   res += dEFFICIENT_SIZE(sizeof(boost::recursive_mutex)); // for mutex
+#ifndef REORDER_CONSTRAINTS
+  // for the colored row sweep, bounded by one chunk per row
+  res += dEFFICIENT_SIZE(sizeof(int) * (m + 1)); // for group_start
+  res += dEFFICIENT_SIZE(sizeof(uint64_t) * nb); // for body_colors
+  res += dEFFICIENT_SIZE(sizeof(int) * m); // for group_color
+  res += dEFFICIENT_SIZE(sizeof(int) * m); // for sorted_groups
+  res += dEFFICIENT_SIZE(sizeof(int) * (m + 1)); // for chunk_start
+  res += dEFFICIENT_SIZE(sizeof(dxQuickStepParameters) * m); // for chunk_qs
+  res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params
+#endif
   return res;
 }
 
@@ -31,6 +31,14 @@
 #define Kf(x) _mm_set_pd((x),(x))
 #endif
 
+#ifdef ODE_AVX
+#include <immintrin.h>
+#endif
+
+#ifdef ODE_NEON
+#include <arm_neon.h>
+#endif
+
 
 #undef REPORT_THREAD_TIMING
 #undef USE_TPROW
@@ -169,6 +177,18 @@ struct dxPGSLCPParameters {
     dRealMutablePtr last_lambda ;
     dRealMutablePtr last_lambda_erp;
 #endif
+
+    /// Iterations [iteration_begin, iteration_end) are run by ComputeRows,
+    /// iteration_end < 0 runs all of them. The colored row sweep runs one
+    /// iteration per call.
+    int iteration_begin;
+    int iteration_end;
+
+    /// Sums of the last iteration per row type, written by ComputeRows
+    /// so that the colored row sweep can reduce them over its chunks.
+    dReal rms_dlambda[3];
+    dReal rms_error[3];
+    int m_rms_dlambda[3];
 };
 // ****************************************************************
 // ******************* Util Functions *****************************
@@ -219,13 +239,28 @@ inline void scaled_add (int n, dRealMutablePtr x, dRealPtr y, dRealPtr z, dReal
 // define ODE_SSE to enable SSE, which is used to speed up
 // vector math operations with gcc compiler
 // macro SSE is renamed to ODE_SSE due to conflict with Eigen3 in DART
+// ODE_AVX (x86_64 with AVX2) and ODE_NEON (aarch64) select wider or
+// native kernels, see deps/opende/CMakeLists.txt.
+// The 6-vectors are only 16 byte aligned, so the 256 bit accesses of the
+// AVX kernels are unaligned.
 inline dReal dot6(dRealPtr a, dRealPtr b)
 {
-#ifdef ODE_SSE
+#if defined(ODE_AVX)
+  __m256d p = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+  __m128d d = _mm_add_pd(_mm256_castpd256_pd128(p),
+                         _mm256_extractf128_pd(p, 1));
+  d = _mm_add_pd(d, _mm_mul_pd(_mm_load_pd(a+4), _mm_load_pd(b+4)));
+  return _mm_cvtsd_f64(_mm_add_sd(d, _mm_unpackhi_pd(d, d)));
+#elif defined(ODE_SSE)
   __m128d d = _mm_load_pd(a+0) * _mm_load_pd(b+0) + _mm_load_pd(a+2) * _mm_load_pd(b+2) + _mm_load_pd(a+4) * _mm_load_pd(b+4);
   double r[2];
   _mm_store_pd(r, d);
   return r[0] + r[1];
+#elif defined(ODE_NEON)
+  float64x2_t d = vmulq_f64(vld1q_f64(a+0), vld1q_f64(b+0));
+  d = vaddq_f64(d, vmulq_f64(vld1q_f64(a+2), vld1q_f64(b+2)));
+  d = vaddq_f64(d, vmulq_f64(vld1q_f64(a+4), vld1q_f64(b+4)));
+  return vaddvq_f64(d);
 #else
   return a[0] * b[0] +
          a[1] * b[1] +
@@ -239,11 +274,26 @@ inline dReal dot6(dRealPtr a, dRealPtr b)
 // a = a + delta * b, vector a and b with length 6
 inline void sum6(dRealMutablePtr a, dReal delta, dRealPtr b)
 {
-#ifdef ODE_SSE
+#if defined(ODE_AVX)
+  __m256d __delta = _mm256_set1_pd(delta);
+  _mm256_storeu_pd(a + 0, _mm256_add_pd(_mm256_loadu_pd(a + 0),
+                   _mm256_mul_pd(__delta, _mm256_loadu_pd(b + 0))));
+  _mm_store_pd(a + 4, _mm_add_pd(_mm_load_pd(a + 4),
+               _mm_mul_pd(_mm256_castpd256_pd128(__delta),
+                          _mm_load_pd(b + 4))));
+#elif defined(ODE_SSE)
   __m128d __delta = Kf(delta);
   _mm_store_pd(a + 0, _mm_load_pd(a + 0) + __delta * _mm_load_pd(b + 0));
   _mm_store_pd(a + 2, _mm_load_pd(a + 2) + __delta * _mm_load_pd(b + 2));
   _mm_store_pd(a + 4, _mm_load_pd(a + 4) + __delta * _mm_load_pd(b + 4));
+#elif defined(ODE_NEON)
+  float64x2_t __delta = vdupq_n_f64(delta);
+  vst1q_f64(a + 0, vaddq_f64(vld1q_f64(a + 0),
+            vmulq_f64(__delta, vld1q_f64(b + 0))));
+  vst1q_f64(a + 2, vaddq_f64(vld1q_f64(a + 2),
+            vmulq_f64(__delta, vld1q_f64(b + 2))));
+  vst1q_f64(a + 4, vaddq_f64(vld1q_f64(a + 4),
+            vmulq_f64(__delta, vld1q_f64(b + 4))));
 #else
   a[0] += delta * b[0];
   a[1] += delta * b[1];
@@ -466,6 +466,9 @@ inline dxHost dxDevice void operator-=(float4 &a, float4 b)
 }
 
 // multiply
+inline dxHost dxDevice vec4<float>::Type make_vec4(float a, float b, float c, float d);
+inline dxHost dxDevice vec4<double>::Type make_vec4(double a, double b, double c, double d);
+
 template <typename T> inline dxHost dxDevice typename vec4<T>::Type operator*(typename vec4<T>::Type a, T s)
 {
   return make_vec4(a.x * s, a.y * s, a.z * s, a.w * s);
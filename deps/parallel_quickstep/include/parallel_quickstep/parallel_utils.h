@@ -44,7 +44,7 @@ namespace parallel_utils
 #define alignSize(offset,alignment)     (((offset) + (alignment) - 1) & ~ ((alignment) - 1))
 #define alignDefaultSize(offset)        alignSize(offset,ParallelOptions::DEFAULTALIGN)
 #define alignOffset(offset,alignment)   (offset) = alignSize(offset,alignment)
-#define align(offset)                   alignOffset(offset,ParallelOptions::DEFAULTALIGN)
+#define alignDefaultOffset(offset)      alignOffset(offset,ParallelOptions::DEFAULTALIGN)
 
 /////////////////////////////////////////////////////////////////////////
 
@@ -54,7 +54,7 @@ inline int __alignedSize( VectorType<int>& vectorToAlign )
   for( size_t i = 0; i < vectorToAlign.size(); i++ )
   {
     totalSize += vectorToAlign[i];
-    align(totalSize);
+    alignDefaultOffset(totalSize);
   }
   return totalSize;
 }
@@ -1,11 +1,11 @@
-#include <ode/objects.h>
-#include <ode/ode.h>
-#include <ode/odemath.h>
-#include <ode/rotation.h>
-#include <ode/timer.h>
-#include <ode/error.h>
-#include <ode/matrix.h>
-#include <ode/misc.h>
+#include <gazebo/ode/objects.h>
+#include <gazebo/ode/ode.h>
+#include <gazebo/ode/odemath.h>
+#include <gazebo/ode/rotation.h>
+#include <gazebo/ode/timer.h>
+#include <gazebo/ode/error.h>
+#include <gazebo/ode/matrix.h>
+#include <gazebo/ode/misc.h>
 #include "objects.h"
 #include "config.h"
 #include "joints/joint.h"
@@ -614,6 +614,10 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
       dReal *c = context->AllocateArray<dReal> (m);
       dSetZero (c, m);
 
+      // init all to world max surface vel
+      dReal *c_v_max = context->AllocateArray<dReal> (m);
+      dSetValue (c_v_max, m, world->contactp.max_vel);
+
       {
         IFTIMING (dTimerNow ("create J"));
         // get jacobian data from constraints. an m*12 matrix will be created
@@ -645,6 +649,7 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
           Jinfo.J2l = Jrow + 6;
           Jinfo.J2a = Jrow + 9;
           Jinfo.c = c + ofsi;
+          Jinfo.c_v_max = c_v_max + ofsi;
           Jinfo.cfm = cfm + ofsi;
           Jinfo.lo = lo + ofsi;
           Jinfo.hi = hi + ofsi;
@@ -719,7 +724,12 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
       } END_STATE_SAVE(context, tmp1state);
 
       // complete rhs
-      for (int i=0; i<m; i++) rhs[i] = c[i]*stepsize1 - rhs[i];
+      for (int i=0; i<m; i++) {
+        if (dFabs(c[i]) > c_v_max[i])
+          rhs[i] = c_v_max[i]*stepsize1 - rhs[i];
+        else
+          rhs[i] = c[i]*stepsize1 - rhs[i];
+      }
 
       // scale CFM
       for (int j=0; j<m; j++) cfm[j] *= stepsize1;
@@ -925,6 +935,7 @@ size_t dxEstimateParallelStepMemoryRequirements (
 
       {
         size_t sub2_res1 = dEFFICIENT_SIZE(sizeof(dReal) * m); // for c
+        sub2_res1 += dEFFICIENT_SIZE(sizeof(dReal) * m); // for c_v_max
         {
           size_t sub3_res1 = dEFFICIENT_SIZE(sizeof(dReal) * 6 * nb); // for tmp1
 
@@ -23,6 +23,7 @@
 #include <boost/make_shared.hpp>
 #include <google/protobuf/descriptor.h>
 #include <set>
+#include <vector>
 #include "gazebo/transport/IOManager.hh"
 
 #include "Master.hh"
@@ -33,13 +34,31 @@ using namespace gazebo;
 
 namespace gazebo
 {
+  /// \brief Notifications of the same type for one connection, sent in a
+  /// single message.
+  struct MasterBatch
+  {
+    /// \brief Type of the notifications, such as "publisher_add".
+    std::string type;
+
+    /// \brief The notified publishers.
+    msgs::Publishers publishers;
+  };
+
   struct MasterPrivate
   {
-    /// \brief All the known publishers.
-    gazebo::Master::PubList publishers;
+    /// \brief All the known publishers, by topic.
+    std::map<std::string, gazebo::Master::PubList> publishers;
 
-    /// \brief All the known subscribers.
-    gazebo::Master::SubList subscribers;
+    /// \brief All the known subscribers, by topic.
+    std::map<std::string, gazebo::Master::SubList> subscribers;
+
+    /// \brief Notifications not sent yet, in order, by connection.
+    std::map<transport::ConnectionPtr, std::vector<MasterBatch> > batches;
+
+    /// \brief Connections of the clients that handle "<type>_batch"
+    /// notifications. The other clients get one message per publisher.
+    std::set<transport::ConnectionPtr> batchConnections;
 
     /// \brief All the known connections.
     gazebo::Master::Connection_M connections;
@@ -118,12 +137,10 @@ void Master::OnAccept(transport::ConnectionPtr _newConnection)
 
   // Send all the publishers
   msgs::Publishers publishersMsg;
-  PubList::iterator pubiter;
-  for (pubiter = this->dataPtr->publishers.begin();
-       pubiter != this->dataPtr->publishers.end(); ++pubiter)
+  for (auto const &topic : this->dataPtr->publishers)
   {
-    msgs::Publish *pub = publishersMsg.add_publisher();
-    pub->CopyFrom(pubiter->first);
+    for (auto const &publisher : topic.second)
+      publishersMsg.add_publisher()->CopyFrom(publisher.first);
   }
   _newConnection->EnqueueMsg(
       msgs::Package("publishers_init", publishersMsg), true);
@@ -177,15 +194,99 @@ void Master::OnRead(const unsigned int _connectionIndex,
 void Master::SendSubscribers(const std::string &_topic,
                              const std::string &_buffer)
 {
-  // Find all subscribers for this topic
+  // Send message to all unique connections
+  for (auto &conn : this->SubscriberConnections(_topic))
+    this->Send(conn, _buffer);
+}
+
+//////////////////////////////////////////////////
+std::set<transport::ConnectionPtr> Master::SubscriberConnections(
+    const std::string &_topic) const
+{
   std::set<transport::ConnectionPtr> uniqueConnections;
-  for (auto const &subscriber : this->dataPtr->subscribers)
-    if (subscriber.first.topic() == _topic)
+  auto subs = this->dataPtr->subscribers.find(_topic);
+  if (subs != this->dataPtr->subscribers.end())
+  {
+    for (auto const &subscriber : subs->second)
       uniqueConnections.insert(subscriber.second);
+  }
+  return uniqueConnections;
+}
 
-  // Send message to all unique connections
-  for (auto &conn : uniqueConnections)
-    conn->EnqueueMsg(_buffer);
+//////////////////////////////////////////////////
+void Master::Send(const transport::ConnectionPtr &_conn,
+    const std::string &_buffer, const bool _force)
+{
+  // Keep the order of the notifications and the other messages
+  this->FlushNotifications(_conn);
+  _conn->EnqueueMsg(_buffer, _force);
+}
+
+//////////////////////////////////////////////////
+void Master::Notify(const transport::ConnectionPtr &_conn,
+    const std::string &_type, const msgs::Publish &_pub)
+{
+  std::vector<MasterBatch> &batches = this->dataPtr->batches[_conn];
+
+  // Join the last batch of the same type, unless it is followed by a
+  // batch that could undo it, such as a publisher_del after a
+  // publisher_add
+  auto isAddDel = [](const std::string &_a, const std::string &_b)
+  {
+    return (_a == "publisher_add" && _b == "publisher_del") ||
+      (_a == "publisher_del" && _b == "publisher_add");
+  };
+
+  for (auto batch = batches.rbegin(); batch != batches.rend(); ++batch)
+  {
+    if (batch->type == _type)
+    {
+      batch->publishers.add_publisher()->CopyFrom(_pub);
+      return;
+    }
+    if (isAddDel(batch->type, _type))
+      break;
+  }
+
+  batches.push_back(MasterBatch());
+  batches.back().type = _type;
+  batches.back().publishers.add_publisher()->CopyFrom(_pub);
+}
+
+//////////////////////////////////////////////////
+void Master::FlushNotifications(const transport::ConnectionPtr &_conn)
+{
+  auto iter = this->dataPtr->batches.find(_conn);
+  if (iter == this->dataPtr->batches.end())
+    return;
+
+  const bool batchSupport = this->dataPtr->batchConnections.find(_conn) !=
+    this->dataPtr->batchConnections.end();
+
+  for (auto const &batch : iter->second)
+  {
+    if (!batchSupport || batch.publishers.publisher_size() == 1)
+    {
+      for (int i = 0; i < batch.publishers.publisher_size(); ++i)
+      {
+        _conn->EnqueueMsg(msgs::Package(batch.type,
+              batch.publishers.publisher(i)));
+      }
+    }
+    else
+    {
+      _conn->EnqueueMsg(msgs::Package(batch.type + "_batch",
+            batch.publishers));
+    }
+  }
+  this->dataPtr->batches.erase(iter);
+}
+
+//////////////////////////////////////////////////
+void Master::FlushNotifications()
+{
+  while (!this->dataPtr->batches.empty())
+    this->FlushNotifications(this->dataPtr->batches.begin()->first);
 }
 
 //////////////////////////////////////////////////
@@ -219,7 +320,7 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       for (iter2 = this->dataPtr->connections.begin();
           iter2 != this->dataPtr->connections.end(); ++iter2)
       {
-        iter2->second->EnqueueMsg(
+        this->Send(iter2->second,
             msgs::Package("topic_namespace_add", worldNameMsg));
       }
     }
@@ -234,13 +335,14 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     for (iter2 = this->dataPtr->connections.begin();
          iter2 != this->dataPtr->connections.end(); ++iter2)
     {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_add", pub));
+      this->Notify(iter2->second, "publisher_add", pub);
     }
 
-    this->dataPtr->publishers.push_back(std::make_pair(pub, conn));
+    this->dataPtr->publishers[pub.topic()].push_back(
+        std::make_pair(pub, conn));
 
-    this->SendSubscribers(pub.topic(),
-        msgs::Package("publisher_advertise", pub));
+    for (auto &subConn : this->SubscriberConnections(pub.topic()))
+      this->Notify(subConn, "publisher_advertise", pub);
   }
   else if (packet.type() == "unadvertise")
   {
@@ -259,18 +361,15 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     msgs::Subscribe sub;
     sub.ParseFromString(packet.serialized_data());
 
-    this->dataPtr->subscribers.push_back(std::make_pair(sub, conn));
-
-    PubList::iterator iter;
+    this->dataPtr->subscribers[sub.topic()].push_back(
+        std::make_pair(sub, conn));
 
     // Find all publishers of the topic
-    for (iter = this->dataPtr->publishers.begin();
-        iter != this->dataPtr->publishers.end(); ++iter)
+    auto pubs = this->dataPtr->publishers.find(sub.topic());
+    if (pubs != this->dataPtr->publishers.end())
     {
-      if (iter->first.topic() == sub.topic())
-      {
-        conn->EnqueueMsg(msgs::Package("publisher_subscribe", iter->first));
-      }
+      for (auto const &publisher : pubs->second)
+        this->Notify(conn, "publisher_subscribe", publisher.first);
     }
   }
   else if (packet.type() == "request")
@@ -281,14 +380,12 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     if (req.request() == "get_publishers")
     {
       msgs::Publishers msg;
-      PubList::iterator iter;
-      for (iter = this->dataPtr->publishers.begin();
-          iter != this->dataPtr->publishers.end(); ++iter)
+      for (auto const &topic : this->dataPtr->publishers)
       {
-        msgs::Publish *pub = msg.add_publisher();
-        pub->CopyFrom(iter->first);
+        for (auto const &publisher : topic.second)
+          msg.add_publisher()->CopyFrom(publisher.first);
       }
-      conn->EnqueueMsg(msgs::Package("publisher_list", msg), true);
+      this->Send(conn, msgs::Package("publisher_list", msg), true);
     }
     else if (req.request() == "get_topics")
     {
@@ -296,18 +393,12 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::GzString_V msg;
 
       // Add all topics that are published
-      for (PubList::iterator iter = this->dataPtr->publishers.begin();
-          iter != this->dataPtr->publishers.end(); ++iter)
-      {
-        topics.insert(iter->first.topic());
-      }
+      for (auto const &topic : this->dataPtr->publishers)
+        topics.insert(topic.first);
 
       // Add all topics that are subscribed
-      for (SubList::iterator iter = this->dataPtr->subscribers.begin();
-           iter != this->dataPtr->subscribers.end(); ++iter)
-      {
-        topics.insert(iter->first.topic());
-      }
+      for (auto const &topic : this->dataPtr->subscribers)
+        topics.insert(topic.first);
 
       // Construct the message of only unique names
       for (std::set<std::string>::iterator iter =
@@ -317,7 +408,7 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       }
 
       // Send the topic list message
-      conn->EnqueueMsg(msgs::Package("topic_list", msg), true);
+      this->Send(conn, msgs::Package("topic_list", msg), true);
     }
     else if (req.request() == "topic_info")
     {
@@ -325,37 +416,30 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::TopicInfo ti;
       ti.set_msg_type(pub.msg_type());
 
-      PubList::iterator piter;
-      SubList::iterator siter;
-
       // Find all publishers of the topic
-      for (piter = this->dataPtr->publishers.begin();
-          piter != this->dataPtr->publishers.end(); ++piter)
+      auto pubs = this->dataPtr->publishers.find(req.data());
+      if (pubs != this->dataPtr->publishers.end())
       {
-        if (piter->first.topic() == req.data())
-        {
-          msgs::Publish *pubPtr = ti.add_publisher();
-          pubPtr->CopyFrom(piter->first);
-        }
+        for (auto const &publisher : pubs->second)
+          ti.add_publisher()->CopyFrom(publisher.first);
       }
 
       // Find all subscribers of the topic
-      for (siter = this->dataPtr->subscribers.begin();
-          siter != this->dataPtr->subscribers.end(); ++siter)
+      auto subs = this->dataPtr->subscribers.find(req.data());
+      if (subs != this->dataPtr->subscribers.end())
       {
-        if (siter->first.topic() == req.data())
+        for (auto const &subscriber : subs->second)
         {
           // If the topic info message type has not been set or the
           // topic info message type is an empty string, then set the topic
           // info message type based on a subscriber's message type.
           if (!ti.has_msg_type() || ti.msg_type().empty())
-            ti.set_msg_type(siter->first.msg_type());
-          msgs::Subscribe *sub = ti.add_subscriber();
-          sub->CopyFrom(siter->first);
+            ti.set_msg_type(subscriber.first.msg_type());
+          ti.add_subscriber()->CopyFrom(subscriber.first);
         }
       }
 
-      conn->EnqueueMsg(msgs::Package("topic_info_response", ti));
+      this->Send(conn, msgs::Package("topic_info_response", ti));
     }
     else if (req.request() == "get_topic_namespaces")
     {
@@ -366,7 +450,12 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       {
         msg.add_data(*iter);
       }
-      conn->EnqueueMsg(msgs::Package("get_topic_namespaces_response", msg));
+      this->Send(conn, msgs::Package("get_topic_namespaces_response", msg));
+    }
+    else if (req.request() == "publisher_batches")
+    {
+      // The client handles "<type>_batch" notifications
+      this->dataPtr->batchConnections.insert(conn);
     }
     else
     {
@@ -417,14 +506,19 @@ void Master::RunOnce()
         iter != this->dataPtr->connections.end();)
     {
       if (iter->second && iter->second->IsOpen())
-      {
-        iter->second->ProcessWriteQueue();
         ++iter;
-      }
       else
-      {
         this->RemoveConnection(iter++);
-      }
+    }
+
+    // Send the notifications of this iteration, one message per type and
+    // connection
+    this->FlushNotifications();
+
+    for (iter = this->dataPtr->connections.begin();
+        iter != this->dataPtr->connections.end(); ++iter)
+    {
+      iter->second->ProcessWriteQueue();
     }
   }
 }
@@ -450,46 +544,67 @@ void Master::RemoveConnection(Connection_M::iterator _connIter)
     }
   }
 
-  // Remove all publishers for this connection
-  bool done = false;
-  while (!done)
+  const unsigned int connId = _connIter->second->GetId();
+
+  // Remove all publishers for this connection. RemovePublisher removes all
+  // the entries with the same topic, host and port, so each is removed once
+  std::vector<msgs::Publish> pubs;
+  for (auto const &topic : this->dataPtr->publishers)
+  {
+    for (auto const &publisher : topic.second)
+    {
+      if (publisher.second->GetId() == connId)
+        pubs.push_back(publisher.first);
+    }
+  }
+
+  for (auto const &pub : pubs)
   {
-    done = true;
-    PubList::iterator pubIter = this->dataPtr->publishers.begin();
-    while (pubIter != this->dataPtr->publishers.end())
+    auto topic = this->dataPtr->publishers.find(pub.topic());
+    if (topic == this->dataPtr->publishers.end())
+      continue;
+
+    for (auto const &publisher : topic->second)
     {
-      if ((*pubIter).second->GetId() == _connIter->second->GetId())
+      if (publisher.first.host() == pub.host() &&
+          publisher.first.port() == pub.port())
       {
-        this->RemovePublisher((*pubIter).first);
-        done = false;
+        this->RemovePublisher(pub);
         break;
       }
-      else
-        ++pubIter;
     }
   }
 
+  // Remove all subscribers for this connection
+  std::vector<msgs::Subscribe> subs;
+  for (auto const &topic : this->dataPtr->subscribers)
+  {
+    for (auto const &subscriber : topic.second)
+    {
+      if (subscriber.second->GetId() == connId)
+        subs.push_back(subscriber.first);
+    }
+  }
 
-  done = false;
-  while (!done)
+  for (auto const &sub : subs)
   {
-    done = true;
+    auto topic = this->dataPtr->subscribers.find(sub.topic());
+    if (topic == this->dataPtr->subscribers.end())
+      continue;
 
-    // Remove all subscribers for this connection
-    SubList::iterator subIter = this->dataPtr->subscribers.begin();
-    while (subIter != this->dataPtr->subscribers.end())
+    for (auto const &subscriber : topic->second)
     {
-      if ((*subIter).second->GetId() == _connIter->second->GetId())
+      if (subscriber.first.host() == sub.host() &&
+          subscriber.first.port() == sub.port())
       {
-        this->RemoveSubscriber((*subIter).first);
-        done = false;
+        this->RemoveSubscriber(sub);
         break;
       }
-      else
-        ++subIter;
     }
   }
 
+  this->dataPtr->batches.erase(_connIter->second);
+  this->dataPtr->batchConnections.erase(_connIter->second);
   this->dataPtr->connections.erase(_connIter);
 }
 
@@ -502,52 +617,62 @@ void Master::RemovePublisher(const msgs::Publish _pub)
     for (iter2 = this->dataPtr->connections.begin();
         iter2 != this->dataPtr->connections.end(); ++iter2)
     {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_del", _pub));
+      this->Notify(iter2->second, "publisher_del", _pub);
     }
   }
 
   this->SendSubscribers(_pub.topic(), msgs::Package("unadvertise", _pub));
 
-  PubList::iterator pubIter = this->dataPtr->publishers.begin();
-  while (pubIter != this->dataPtr->publishers.end())
+  auto topic = this->dataPtr->publishers.find(_pub.topic());
+  if (topic == this->dataPtr->publishers.end())
+    return;
+
+  PubList::iterator pubIter = topic->second.begin();
+  while (pubIter != topic->second.end())
   {
-    if (pubIter->first.topic() == _pub.topic() &&
-        pubIter->first.host() == _pub.host() &&
+    if (pubIter->first.host() == _pub.host() &&
         pubIter->first.port() == _pub.port())
     {
-      pubIter = this->dataPtr->publishers.erase(pubIter);
+      pubIter = topic->second.erase(pubIter);
     }
     else
       ++pubIter;
   }
+
+  if (topic->second.empty())
+    this->dataPtr->publishers.erase(topic);
 }
 
 /////////////////////////////////////////////////
 void Master::RemoveSubscriber(const msgs::Subscribe _sub)
 {
   // Find all publishers of the topic, and remove the subscriptions
-  for (PubList::iterator iter = this->dataPtr->publishers.begin();
-      iter != this->dataPtr->publishers.end(); ++iter)
+  auto pubs = this->dataPtr->publishers.find(_sub.topic());
+  if (pubs != this->dataPtr->publishers.end())
   {
-    if (iter->first.topic() == _sub.topic())
-    {
-      iter->second->EnqueueMsg(msgs::Package("unsubscribe", _sub));
-    }
+    for (auto const &publisher : pubs->second)
+      this->Send(publisher.second, msgs::Package("unsubscribe", _sub));
   }
 
   // Remove the subscribers from our list
-  SubList::iterator subiter = this->dataPtr->subscribers.begin();
-  while (subiter != this->dataPtr->subscribers.end())
+  auto topic = this->dataPtr->subscribers.find(_sub.topic());
+  if (topic == this->dataPtr->subscribers.end())
+    return;
+
+  SubList::iterator subiter = topic->second.begin();
+  while (subiter != topic->second.end())
   {
-    if (subiter->first.topic() == _sub.topic() &&
-        subiter->first.host() == _sub.host() &&
+    if (subiter->first.host() == _sub.host() &&
         subiter->first.port() == _sub.port())
     {
-      subiter = this->dataPtr->subscribers.erase(subiter);
+      subiter = topic->second.erase(subiter);
     }
     else
       ++subiter;
   }
+
+  if (topic->second.empty())
+    this->dataPtr->subscribers.erase(topic);
 }
 
 //////////////////////////////////////////////////
@@ -580,6 +705,8 @@ void Master::Fini()
   this->dataPtr->connections.clear();
   this->dataPtr->subscribers.clear();
   this->dataPtr->publishers.clear();
+  this->dataPtr->batches.clear();
+  this->dataPtr->batchConnections.clear();
 }
 
 //////////////////////////////////////////////////
@@ -587,18 +714,10 @@ msgs::Publish Master::GetPublisher(const std::string &_topic)
 {
   msgs::Publish msg;
 
-  PubList::iterator iter;
-
-  // Find all publishers of the topic
-  for (iter = this->dataPtr->publishers.begin();
-       iter != this->dataPtr->publishers.end(); ++iter)
-  {
-    if (iter->first.topic() == _topic)
-    {
-      msg = iter->first;
-      break;
-    }
-  }
+  // Find the first publisher of the topic
+  auto pubs = this->dataPtr->publishers.find(_topic);
+  if (pubs != this->dataPtr->publishers.end() && !pubs->second.empty())
+    msg = pubs->second.front().first;
 
   return msg;
 }
@@ -22,6 +22,7 @@
 #include <deque>
 #include <utility>
 #include <map>
+#include <set>
 #include <boost/shared_ptr.hpp>
 
 #include "gazebo/msgs/msgs.hh"
@@ -83,6 +84,37 @@ namespace gazebo
     private: void SendSubscribers(const std::string &_topic,
                                   const std::string &_buffer);
 
+    /// \brief Get the connections of the subscribers to a topic.
+    /// \param[in] _topic Name of the topic
+    /// \return The connections, each once
+    private: std::set<transport::ConnectionPtr> SubscriberConnections(
+                 const std::string &_topic) const;
+
+    /// \brief Send a message on a connection, after the notifications not
+    /// sent yet on the connection.
+    /// \param[in] _conn The connection
+    /// \param[in] _buffer Data to write
+    /// \param[in] _force True to write the message right away
+    private: void Send(const transport::ConnectionPtr &_conn,
+                       const std::string &_buffer, const bool _force = false);
+
+    /// \brief Queue a publisher notification for a connection. The
+    /// notifications of the same type are sent in one message by
+    /// FlushNotifications if the client sent a "publisher_batches"
+    /// request, and one message per publisher otherwise.
+    /// \param[in] _conn The connection
+    /// \param[in] _type Type of the notification, such as "publisher_add"
+    /// \param[in] _pub The publisher
+    private: void Notify(const transport::ConnectionPtr &_conn,
+                         const std::string &_type, const msgs::Publish &_pub);
+
+    /// \brief Send the queued notifications of a connection.
+    /// \param[in] _conn The connection
+    private: void FlushNotifications(const transport::ConnectionPtr &_conn);
+
+    /// \brief Send the queued notifications of all the connections.
+    private: void FlushNotifications();
+
     /// \brief Process a message
     /// \param[in] _connectionIndex Index of the connection which generated the
     /// message
@@ -24,7 +24,10 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include <atomic>
+#include <future>
 #include <mutex>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
@@ -33,19 +36,21 @@
 #include <sdf/sdf.hh>
 
 #include <ignition/math/Rand.hh>
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/gazebo.hh"
 #include "gazebo/transport/transport.hh"
 
 #include "gazebo/util/LogRecord.hh"
 #include "gazebo/util/LogPlay.hh"
+#include "gazebo/common/FuelModelDatabase.hh"
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/WorldCache.hh"
 
 #include "gazebo/msgs/msgs.hh"
 
@@ -104,11 +109,81 @@ namespace gazebo
 
     /// \brief Set whether to lockstep physics and rendering
     bool lockstep = false;
+
+    /// \brief World files to load in addition to the main world file.
+    std::vector<std::string> extraWorldFiles;
+
+    /// \brief Download of the models included by the world files, started
+    /// before the master, transport and rendering engine.
+    std::future<void> includesDownload;
   };
 }
 
 bool ServerPrivate::stop = true;
 
+/////////////////////////////////////////////////
+/// \brief Download the models included by a world file concurrently, so
+/// that the SDF parser finds them locally instead of downloading them one
+/// after another.
+/// \param[in] _filename Complete path to the world file.
+static void DownloadIncludes(const std::string &_filename)
+{
+  std::vector<std::string> modelUris;
+  std::vector<std::string> fuelUris;
+  for (auto const &uri : common::WorldCache::IncludeUris(_filename))
+  {
+    if (uri.find("model://") == 0)
+      modelUris.push_back(uri);
+    else if (uri.find("http://") == 0 || uri.find("https://") == 0)
+      fuelUris.push_back(uri);
+  }
+
+  auto fuel = std::async(std::launch::async, [&fuelUris]()
+      {
+        common::FuelModelDatabase::Instance()->ModelPaths(fuelUris);
+      });
+  common::ModelDatabase::Instance()->GetModelPaths(modelUris);
+  fuel.wait();
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a world file, from the world cache if it holds the world
+/// with its includes resolved, and save it to the cache otherwise.
+/// \param[in] _filename Complete path to the world file.
+/// \param[in] _sdf SDF to read the world into.
+/// \return False if the world file couldn't be read.
+static bool ReadWorldFile(const std::string &_filename, sdf::SDFPtr _sdf)
+{
+  const std::string cachePath = common::WorldCache::DefaultPath();
+  const std::string key = cachePath.empty() ?
+    std::string() : common::WorldCache::Key(_filename);
+
+  std::string cached;
+  if (common::WorldCache::Load(cachePath, key, cached))
+  {
+    sdf::SDFPtr cachedSdf(new sdf::SDF);
+    if (sdf::init(cachedSdf) && sdf::readString(cached, cachedSdf))
+    {
+      _sdf->Root(cachedSdf->Root());
+      return true;
+    }
+
+    gzwarn << "Unable to read cached world[" << _filename << "], the "
+           << "world file will be read instead\n";
+  }
+
+  DownloadIncludes(_filename);
+  if (!sdf::readFile(_filename, _sdf))
+    return false;
+
+  if (!key.empty())
+  {
+    common::WorldCache::Save(cachePath, key, _filename,
+        _sdf->Root()->ToString(""));
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 Server::Server()
   : dataPtr(new ServerPrivate())
@@ -154,26 +229,84 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("help,h", "Produce this help message.")
     ("pause,u", "Start the server in a paused state.")
     ("lockstep", "Lockstep simulation so sensor update rates are respected.")
+    ("realtime", "Run the world threads with SCHED_FIFO priority, lock the "
+     "memory and spin before each step, for hardware-in-the-loop tests.")
+    ("realtime_priority", po::value<int>()->default_value(80),
+     "SCHED_FIFO priority of the world threads in real-time mode (1-99).")
+    ("realtime_cpu", po::value<int>()->default_value(-1),
+     "CPU to pin the world threads to in real-time mode, -1 to not pin.")
+    ("compact_static", "Keep static models compact: no per-link state, "
+     "no per-link pose subscriptions, and one shared collision space with "
+     "ODE. Static models must then stay static.")
+    ("sdf_memory_saver", "Release the visual SDF of the models once "
+     "they are loaded, and recreate it when the world SDF is requested.")
+    ("staged_startup", "Answer the scene requests of clients while the "
+     "sensors initialize, instead of once the worlds run.")
+    ("async_factory", "Read spawned models, and load their meshes and "
+     "plugin libraries, on a separate thread instead of the world thread.")
+    ("factory_budget", po::value<double>(),
+     "Wall time in milliseconds the world thread spends inserting spawned "
+     "entities between two updates. The others wait for the next updates.")
     ("physics,e", po::value<std::string>(),
      "Specify a physics engine (ode|bullet|dart|simbody).")
     ("play,p", po::value<std::string>(), "Play a log file.")
+    ("play_mode", po::value<std::string>()->default_value("full"),
+     "World update run for each state played back "
+     "(full|poses|sensors). poses only applies and publishes poses, "
+     "sensors also updates the sensors.")
     ("record,r", "Record state data.")
     ("record_encoding", po::value<std::string>()->default_value("zlib"),
-     "Compression encoding format for log data (zlib|bz2|txt).")
+     "Compression encoding format for log data (zlib|bz2|zstd|txt).")
+    ("record_format", po::value<std::string>()->default_value("xml"),
+     "File format for log data (xml|binary).")
     ("record_path", po::value<std::string>()->default_value(""),
      "Absolute path in which to store state data")
     ("record_period", po::value<double>()->default_value(-1),
      "Recording period (seconds).")
     ("record_filter", po::value<std::string>()->default_value(""),
      "Recording filter (supports wildcard and regular expression).")
+    ("record_keyframe_period", po::value<double>()->default_value(0.0),
+     "Simulation time between full state frames (seconds). Frames in "
+     "between only hold what changed. A value <= 0 records full frames.")
+    ("record_tolerance", po::value<double>()->default_value(1e-6),
+     "Changes up to this value are left out of partial state frames.")
     ("record_resources", "Recording with model meshes and materials.")
+    ("record_resource_store", po::value<std::string>()->default_value(""),
+     "Directory in which recorded resources are shared between logs.")
+    ("record_bandwidth", po::value<double>()->default_value(0),
+     "Maximum rate at which log data is written (MB/s). 0 is unlimited.")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
+    ("io_threads", po::value<unsigned int>(),
+     "Number of threads that handle the TCP/IP connections.")
+    ("sensor_threads", po::value<unsigned int>(),
+     "Number of threads that update the non-rendering sensors.")
+    ("sensors_on_demand",
+     "Only update the sensors that have subscribers or connected callbacks.")
+    ("render_batch_window", po::value<double>(),
+     "Render the image sensors due in the same window of seconds together.")
+    ("sonar_ray_fan",
+     "Sense with a fan of rays in sonar sensors instead of a collision.")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
      "Load a plugin.")
     ("profile,o", po::value<std::string>(),
-     "Physics preset profile name from the options in the world file.");
+     "Physics preset profile name from the options in the world file.")
+    ("trace", po::value<std::string>(),
+     "Record the profiler scopes to a Chrome trace file.")
+    ("trace_duration", po::value<double>()->default_value(10),
+     "Seconds to record the trace for, zero until the server stops.")
+    ("add_world", po::value<std::vector<std::string> >(),
+     "Load an additional world file in the same server. Each world runs in "
+     "its own thread and must have a unique name. May be repeated.")
+    ("zygote", po::value<std::string>(),
+     "Listen on a UNIX socket and fork a server for each request. A "
+     "request is one line per argument, ended by an empty line: the master "
+     "port of the server (0 for GAZEBO_MASTER_URI), then its arguments. "
+     "The pid of the server is sent back.")
+    ("zygote_preload", po::value<std::vector<std::string> >(),
+     "Library loaded by the zygote before forking, shared by the servers "
+     "it forks. May be repeated.");
 
   po::options_description hiddenDesc("Hidden options");
   hiddenDesc.add_options()
@@ -235,6 +368,30 @@ bool Server::ParseArgs(int _argc, char **_argv)
   else
     gazebo::transport::setMinimalComms(false);
 
+  if (this->dataPtr->vm.count("io_threads"))
+  {
+    gazebo::transport::setIOThreadCount(
+        this->dataPtr->vm["io_threads"].as<unsigned int>());
+  }
+
+  if (this->dataPtr->vm.count("sensor_threads"))
+  {
+    gazebo::sensors::set_worker_thread_count(
+        this->dataPtr->vm["sensor_threads"].as<unsigned int>());
+  }
+
+  if (this->dataPtr->vm.count("sensors_on_demand"))
+    gazebo::sensors::set_on_demand_enabled(true);
+
+  if (this->dataPtr->vm.count("render_batch_window"))
+  {
+    gazebo::sensors::set_render_batch_window(
+        this->dataPtr->vm["render_batch_window"].as<double>());
+  }
+
+  if (this->dataPtr->vm.count("sonar_ray_fan"))
+    gazebo::sensors::set_sonar_ray_fan_enabled(true);
+
   // Set the random number seed if present on the command line.
   if (this->dataPtr->vm.count("seed"))
   {
@@ -268,6 +425,8 @@ bool Server::ParseArgs(int _argc, char **_argv)
       this->dataPtr->vm["record_path"].as<std::string>();
     this->dataPtr->params["record_encoding"] =
       this->dataPtr->vm["record_encoding"].as<std::string>();
+    this->dataPtr->params["record_format"] =
+      this->dataPtr->vm["record_format"].as<std::string>();
     if (this->dataPtr->vm.count("record_resources"))
       this->dataPtr->params["record_resources"] = "true";
   }
@@ -287,12 +446,47 @@ bool Server::ParseArgs(int _argc, char **_argv)
     }
   }
 
+  if (this->dataPtr->vm.count("trace"))
+  {
+    common::TraceRecorder::Start(
+        this->dataPtr->vm["trace"].as<std::string>(),
+        this->dataPtr->vm["trace_duration"].as<double>());
+  }
+
   if (this->dataPtr->vm.count("lockstep"))
   {
     this->dataPtr->lockstep = true;
   }
   rendering::set_lockstep_enabled(this->dataPtr->lockstep);
 
+  // Download the models of the worlds while the master, transport and
+  // rendering engine start up. A log file holds its own world.
+  if (!this->dataPtr->vm.count("play"))
+  {
+    std::vector<std::string> worldFiles;
+    worldFiles.push_back(common::find_file(this->dataPtr->vm.count(
+        "world_file") ? this->dataPtr->vm["world_file"].as<std::string>() :
+        "worlds/empty.world"));
+    if (this->dataPtr->vm.count("add_world"))
+    {
+      for (auto const &filename :
+          this->dataPtr->vm["add_world"].as<std::vector<std::string> >())
+      {
+        worldFiles.push_back(common::find_file(filename));
+      }
+    }
+
+    this->dataPtr->includesDownload = std::async(std::launch::async,
+        [worldFiles]()
+        {
+          for (auto const &filename : worldFiles)
+          {
+            if (!filename.empty())
+              DownloadIncludes(filename);
+          }
+        });
+  }
+
   if (!this->PreLoad())
   {
     gzerr << "Unable to load gazebo\n";
@@ -330,6 +524,19 @@ bool Server::ParseArgs(int _argc, char **_argv)
     // Load the server
     if (!this->LoadString(sdfString))
       return false;
+
+    const std::string playMode =
+      this->dataPtr->vm["play_mode"].as<std::string>();
+    physics::World::LogPlayMode mode = physics::World::LOG_PLAY_FULL;
+    if (playMode == "poses")
+      mode = physics::World::LOG_PLAY_POSES;
+    else if (playMode == "sensors")
+      mode = physics::World::LOG_PLAY_SENSORS;
+    else if (playMode != "full")
+      gzerr << "Invalid play mode[" << playMode << "], using full.\n";
+
+    for (auto const &world : physics::worlds())
+      world->SetLogPlayback(mode);
   }
   else
   {
@@ -345,6 +552,12 @@ bool Server::ParseArgs(int _argc, char **_argv)
     if (this->dataPtr->vm.count("physics"))
       physics = this->dataPtr->vm["physics"].as<std::string>();
 
+    if (this->dataPtr->vm.count("add_world"))
+    {
+      this->dataPtr->extraWorldFiles =
+        this->dataPtr->vm["add_world"].as<std::vector<std::string> >();
+    }
+
     // Load the server
     if (!this->LoadFile(configFilename, physics))
     {
@@ -356,16 +569,19 @@ bool Server::ParseArgs(int _argc, char **_argv)
     if (this->dataPtr->vm.count("profile"))
     {
       std::string profileName = this->dataPtr->vm["profile"].as<std::string>();
-      if (physics::get_world()->PresetMgr()->HasProfile(profileName))
-      {
-        physics::get_world()->PresetMgr()->CurrentProfile(profileName);
-        gzmsg << "Setting physics profile to [" << profileName << "]."
-              << std::endl;
-      }
-      else
+      for (auto const &world : physics::worlds())
       {
-        gzerr << "Specified profile [" << profileName << "] was not found."
-              << std::endl;
+        if (world->PresetMgr()->HasProfile(profileName))
+        {
+          world->PresetMgr()->CurrentProfile(profileName);
+          gzmsg << "Setting physics profile of world [" << world->Name()
+                << "] to [" << profileName << "]." << std::endl;
+        }
+        else
+        {
+          gzerr << "Specified profile [" << profileName << "] was not found "
+                << "in world [" << world->Name() << "]." << std::endl;
+        }
       }
     }
   }
@@ -402,7 +618,11 @@ bool Server::LoadFile(const std::string &_filename,
     return false;
   }
 
-  if (!sdf::readFile(common::find_file(_filename), sdf))
+  // The includes are local once the early download is done
+  if (this->dataPtr->includesDownload.valid())
+    this->dataPtr->includesDownload.wait();
+
+  if (!ReadWorldFile(common::find_file(_filename), sdf))
   {
     gzerr << "Unable to read sdf file[" << _filename << "]\n";
     return false;
@@ -443,43 +663,23 @@ bool Server::PreLoad()
 bool Server::LoadImpl(sdf::ElementPtr _elem,
                       const std::string &_physics)
 {
-  // If a physics engine is specified,
-  if (_physics.length())
-  {
-    // Check if physics engine name is valid
-    // This must be done after physics::load();
-    if (!physics::PhysicsFactory::IsRegistered(_physics))
-    {
-      gzerr << "Unregistered physics engine [" << _physics
-            << "], the default will be used instead.\n";
-    }
-    // Try inserting physics engine name if one is given
-    else if (_elem->HasElement("world") &&
-             _elem->GetElement("world")->HasElement("physics"))
-    {
-      _elem->GetElement("world")->GetElement("physics")
-           ->GetAttribute("type")->Set(_physics);
-    }
-    else
-    {
-      gzerr << "Cannot set physics engine: <world> does not have <physics>\n";
-    }
-  }
+  if (!this->LoadWorlds(_elem, _physics))
+    return false;
 
-  sdf::ElementPtr worldElem = _elem->GetElement("world");
-  if (worldElem)
+  // Additional worlds share the process wide resources (master, model
+  // database, mesh and render engine caches), but each one gets its own
+  // physics engine, transport namespace and update thread.
+  for (auto const &filename : this->dataPtr->extraWorldFiles)
   {
-    physics::WorldPtr world = physics::create_world();
-
-    // Create the world
-    try
+    sdf::SDFPtr sdf(new sdf::SDF);
+    if (!sdf::init(sdf) || !ReadWorldFile(common::find_file(filename), sdf))
     {
-      physics::load_world(world, worldElem);
-    }
-    catch(common::Exception &e)
-    {
-      gzthrow("Failed to load the World\n"  << e);
+      gzerr << "Unable to read sdf file[" << filename << "]\n";
+      return false;
     }
+
+    if (!this->LoadWorlds(sdf->Root(), _physics))
+      return false;
   }
 
   this->dataPtr->node = transport::NodePtr(new transport::Node());
@@ -518,6 +718,78 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
   return true;
 }
 
+/////////////////////////////////////////////////
+bool Server::LoadWorlds(sdf::ElementPtr _elem, const std::string &_physics)
+{
+  // Check if physics engine name is valid
+  // This must be done after physics::load();
+  if (_physics.length() && !physics::PhysicsFactory::IsRegistered(_physics))
+  {
+    gzerr << "Unregistered physics engine [" << _physics
+          << "], the default will be used instead.\n";
+  }
+
+  sdf::ElementPtr worldElem;
+  if (_elem->HasElement("world"))
+    worldElem = _elem->GetElement("world");
+
+  unsigned int loaded = 0;
+  while (worldElem)
+  {
+    std::string worldName = worldElem->Get<std::string>("name");
+
+    // World names are used as transport namespaces, so they must be unique.
+    if (!worldName.empty() && physics::has_world(worldName))
+    {
+      gzerr << "A world named [" << worldName << "] already exists. "
+            << "Skipping duplicate world.\n";
+      worldElem = worldElem->GetNextElement("world");
+      continue;
+    }
+
+    // Try inserting physics engine name if one is given
+    if (_physics.length() && physics::PhysicsFactory::IsRegistered(_physics))
+    {
+      if (worldElem->HasElement("physics"))
+      {
+        worldElem->GetElement("physics")->GetAttribute("type")->Set(_physics);
+      }
+      else
+      {
+        gzerr << "Cannot set physics engine: <world> does not have "
+              << "<physics>\n";
+      }
+    }
+
+    physics::WorldPtr world = physics::create_world();
+    if (this->dataPtr->vm.count("compact_static"))
+      world->SetCompactStaticModels(true);
+    if (this->dataPtr->vm.count("sdf_memory_saver"))
+      world->SetSDFMemorySaver(true);
+
+    // Create the world
+    try
+    {
+      physics::load_world(world, worldElem);
+    }
+    catch(common::Exception &e)
+    {
+      gzthrow("Failed to load the World\n"  << e);
+    }
+
+    ++loaded;
+    worldElem = worldElem->GetNextElement("world");
+  }
+
+  if (loaded == 0)
+  {
+    gzerr << "No world could be loaded.\n";
+    return false;
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void Server::SigInt(int)
 {
@@ -569,10 +841,31 @@ void Server::Run()
   if (this->dataPtr->stop)
     return;
 
+  // Clients can build their scene while the sensors initialize, instead of
+  // waiting for the worlds to run.
+  std::atomic<bool> sensorsReady(false);
+  std::thread startupThread;
+  if (this->dataPtr->vm.count("staged_startup"))
+  {
+    startupThread = std::thread([&sensorsReady]()
+        {
+          while (!sensorsReady)
+          {
+            for (auto const &world : physics::worlds())
+              world->ProcessStartupRequests();
+            common::Time::MSleep(10);
+          }
+        });
+  }
+
   // Make sure the sensors are updated once before running the world.
   // This makes sure plugins get loaded properly.
   sensors::run_once(true);
 
+  sensorsReady = true;
+  if (startupThread.joinable())
+    startupThread.join();
+
   // Run the sensor threads
   sensors::run_threads();
 
@@ -592,6 +885,27 @@ void Server::Run()
     }
   }
 
+  if (this->dataPtr->vm.count("realtime"))
+  {
+    for (auto const &world : physics::worlds())
+    {
+      world->SetRealTimeMode(true,
+          this->dataPtr->vm["realtime_priority"].as<int>(),
+          this->dataPtr->vm["realtime_cpu"].as<int>());
+    }
+  }
+
+  for (auto const &world : physics::worlds())
+  {
+    if (this->dataPtr->vm.count("async_factory"))
+      world->SetAsyncFactory(true);
+    if (this->dataPtr->vm.count("factory_budget"))
+    {
+      world->SetFactoryBudget(
+          this->dataPtr->vm["factory_budget"].as<double>() * 1e-3);
+    }
+  }
+
   // Run each world. Each world starts a new thread
   physics::run_worlds(iterations);
 
@@ -611,6 +925,7 @@ void Server::Run()
     //   gzerr << "time out reached!" << std::endl;
 
     this->ProcessControlMsgs();
+    common::TraceRecorder::Update();
     IGN_PROFILE_END();
 
     if (physics::worlds_running())
@@ -630,6 +945,9 @@ void Server::Run()
       common::Time::MSleep(1);
   }
 
+  // Write the trace if it is still recording
+  common::TraceRecorder::Stop();
+
   // Shutdown gazebo
   gazebo::shutdown();
 }
@@ -649,11 +967,19 @@ void Server::ProcessParams()
       util::LogRecordParams params;
 
       params.encoding = this->dataPtr->params["record_encoding"];
+      params.format = this->dataPtr->params["record_format"];
       params.path = iter->second;
       params.period = this->dataPtr->vm["record_period"].as<double>();
       params.filter = this->dataPtr->vm["record_filter"].as<std::string>();
+      params.keyframePeriod =
+          this->dataPtr->vm["record_keyframe_period"].as<double>();
+      params.tolerance = this->dataPtr->vm["record_tolerance"].as<double>();
       params.recordResources =
           this->dataPtr->params.count("record_resources") > 0;
+      params.resourceStore =
+          this->dataPtr->vm["record_resource_store"].as<std::string>();
+      params.bandwidth =
+          this->dataPtr->vm["record_bandwidth"].as<double>() * 1e6;
       util::LogRecord::Instance()->Start(params);
     }
   }
@@ -681,6 +1007,15 @@ void Server::ProcessControlMsgs()
   for (iter = this->dataPtr->controlMsgs.begin();
        iter != this->dataPtr->controlMsgs.end(); ++iter)
   {
+    if ((*iter).has_stop_trace() && (*iter).stop_trace())
+      common::TraceRecorder::Stop();
+
+    if ((*iter).has_trace_filename())
+    {
+      common::TraceRecorder::Start((*iter).trace_filename(),
+          (*iter).trace_duration());
+    }
+
     if ((*iter).has_clone() && (*iter).clone())
     {
       bool success = true;
@@ -94,6 +94,14 @@ namespace gazebo
     private: bool LoadImpl(sdf::ElementPtr _elem,
                            const std::string &_physics="");
 
+    /// \brief Create and load every <world> element of an SDF root. Worlds
+    /// whose name is already in use are skipped.
+    /// \param[in] _elem SDF root that contains the world elements.
+    /// \param[in] _physics Physics engine type (ode|bullet|dart|simbody).
+    /// \return True if at least one world was loaded.
+    private: bool LoadWorlds(sdf::ElementPtr _elem,
+                             const std::string &_physics);
+
     /// \brief SIGINT handler
     /// \param[in] _v Unused.
     private: static void SigInt(int _v);
@@ -28,6 +28,8 @@ Battery::Battery()
   this->dataPtr->realVoltage = 0.0;
   this->dataPtr->initVoltage = 0.0;
   this->dataPtr->powerLoadCounter = 0;
+  this->dataPtr->totalPowerLoad = 0.0;
+  this->dataPtr->updateRate = 0.0;
 
   this->SetUpdateFunc(std::bind(&Battery::UpdateDefault, this,
         std::placeholders::_1));
@@ -78,6 +80,7 @@ void Battery::InitConsumers()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->powerLoadsMutex);
   this->dataPtr->powerLoads.clear();
+  this->dataPtr->totalPowerLoad = 0.0;
 }
 
 /////////////////////////////////////////////////
@@ -93,8 +96,13 @@ uint32_t Battery::AddConsumer()
 bool Battery::RemoveConsumer(uint32_t _consumerId)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->powerLoadsMutex);
-  if (this->dataPtr->powerLoads.erase(_consumerId))
+  auto iter = this->dataPtr->powerLoads.find(_consumerId);
+  if (iter != this->dataPtr->powerLoads.end())
   {
+    this->dataPtr->totalPowerLoad -= iter->second;
+    this->dataPtr->powerLoads.erase(iter);
+    if (this->dataPtr->powerLoads.empty())
+      this->dataPtr->totalPowerLoad = 0.0;
     return true;
   }
   else
@@ -115,6 +123,7 @@ bool Battery::SetPowerLoad(const uint32_t _consumerId, const double _powerLoad)
     return false;
   }
 
+  this->dataPtr->totalPowerLoad += _powerLoad - iter->second;
   iter->second = _powerLoad;
   return true;
 }
@@ -141,6 +150,25 @@ const Battery::PowerLoad_M &Battery::PowerLoads() const
   return this->dataPtr->powerLoads;
 }
 
+/////////////////////////////////////////////////
+double Battery::TotalPowerLoad() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->powerLoadsMutex);
+  return this->dataPtr->totalPowerLoad;
+}
+
+/////////////////////////////////////////////////
+void Battery::SetUpdateRate(const double _rate)
+{
+  this->dataPtr->updateRate = std::max(0.0, _rate);
+}
+
+/////////////////////////////////////////////////
+double Battery::UpdateRate() const
+{
+  return this->dataPtr->updateRate;
+}
+
 /////////////////////////////////////////////////
 double Battery::Voltage() const
 {
@@ -42,10 +42,11 @@ namespace gazebo
     /// value as its constant voltage value. This behavior can be changed by
     /// specifying a custom update function.
     ///
-    /// The battery handles a list of consumers. It updates itself after each
-    /// simulation iteration. The update function takes the power loads for each
-    /// consumer and current voltage value as inputs and returns a new voltage
-    /// value.
+    /// The battery handles a list of consumers. It is updated by the
+    /// physics::BatteryRegistry of its world, after each simulation iteration
+    /// or at a lower rate, see SetUpdateRate. The update function takes the
+    /// power loads for each consumer and current voltage value as inputs and
+    /// returns a new voltage value.
     class GZ_COMMON_VISIBLE Battery :
       public std::enable_shared_from_this<Battery>
     {
@@ -107,6 +108,24 @@ namespace gazebo
       /// \return List of power loads in watts.
       public: const PowerLoad_M &PowerLoads() const;
 
+      /// \brief Get the sum of the power loads of all the consumers, kept
+      /// up to date as the power loads change.
+      /// \return Total power load in watts.
+      public: double TotalPowerLoad() const;
+
+      /// \brief Set the rate at which the battery is updated by the
+      /// physics::BatteryRegistry of its world. Update functions should
+      /// integrate over the simulation time elapsed since their last call.
+      /// \param[in] _rate Update rate in Hz of simulation time. Zero uses
+      /// the default rate of the registry.
+      /// \sa physics::BatteryRegistry::SetDefaultUpdateRate
+      public: void SetUpdateRate(const double _rate);
+
+      /// \brief Get the rate at which the battery is updated.
+      /// \return Update rate in Hz of simulation time, zero for the default
+      /// rate of the registry.
+      public: double UpdateRate() const;
+
       /// \brief Get the real voltage in volts.
       /// \return Voltage.
       public: double Voltage() const;
@@ -50,7 +50,13 @@ namespace gazebo
       /// \brief Name of the battery.
       public: std::string name;
 
-      /// \brief Mutex that protects the powerLoads map
+      /// \brief Sum of the power loads in watts.
+      public: double totalPowerLoad;
+
+      /// \brief Update rate in Hz, zero for the default rate.
+      public: double updateRate;
+
+      /// \brief Mutex that protects the powerLoads map and totalPowerLoad
       public: std::mutex powerLoadsMutex;
     };
   }
@@ -202,6 +202,36 @@ TEST_F(BatteryTest, SetUpdateFunc)
   EXPECT_DOUBLE_EQ(battery->Voltage(), initVoltage + N * fixture.step);
 }
 
+/////////////////////////////////////////////////
+TEST_F(BatteryTest, TotalPowerLoad)
+{
+  common::BatteryPtr battery(new common::Battery());
+  EXPECT_DOUBLE_EQ(battery->TotalPowerLoad(), 0.0);
+
+  uint32_t consumerId1 = battery->AddConsumer();
+  uint32_t consumerId2 = battery->AddConsumer();
+  EXPECT_TRUE(battery->SetPowerLoad(consumerId1, 1.5));
+  EXPECT_TRUE(battery->SetPowerLoad(consumerId2, 2.0));
+  EXPECT_DOUBLE_EQ(battery->TotalPowerLoad(), 3.5);
+
+  EXPECT_TRUE(battery->SetPowerLoad(consumerId1, 0.5));
+  EXPECT_DOUBLE_EQ(battery->TotalPowerLoad(), 2.5);
+
+  EXPECT_TRUE(battery->RemoveConsumer(consumerId2));
+  EXPECT_DOUBLE_EQ(battery->TotalPowerLoad(), 0.5);
+
+  // Reinitializing the battery discards the power loads
+  battery->Init();
+  EXPECT_DOUBLE_EQ(battery->TotalPowerLoad(), 0.0);
+
+  // The update rate defaults to the rate of the registry
+  EXPECT_DOUBLE_EQ(battery->UpdateRate(), 0.0);
+  battery->SetUpdateRate(10.0);
+  EXPECT_DOUBLE_EQ(battery->UpdateRate(), 10.0);
+  battery->SetUpdateRate(-1.0);
+  EXPECT_DOUBLE_EQ(battery->UpdateRate(), 0.0);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -17,9 +17,14 @@
 
 #include <tinyxml.h>
 #include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <set>
 #include <memory>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/unordered_map.hpp>
@@ -80,6 +85,177 @@ struct Vector2dHash : unary_function<const ignition::math::Vector2d,
   }
 };
 
+/////////////////////////////////////////////////
+/// \brief Arrays with less text than this are parsed on the calling thread.
+static const size_t PARALLEL_PARSE_SIZE = 1 << 20;
+
+/////////////////////////////////////////////////
+/// \brief Parse the values of a <float_array> in place, without copying
+/// the text into a stream or into a string per value.
+/// \param[in] _text Text of the array, may be null.
+/// \param[out] _values The values.
+static void ParseFloats(const char *_text, std::vector<double> &_values)
+{
+  _values.clear();
+  if (!_text)
+    return;
+
+  const char *cur = _text;
+  char *end = nullptr;
+  for (double value = std::strtod(cur, &end); end != cur;
+       value = std::strtod(cur, &end))
+  {
+    _values.push_back(value);
+    cur = end;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse the values of an index array, such as <p>, <vcount> or
+/// <v>, in place.
+/// \param[in] _text Text of the array, may be null.
+/// \param[out] _values The values.
+static void ParseIndices(const char *_text, std::vector<unsigned int> &_values)
+{
+  _values.clear();
+  if (!_text)
+    return;
+
+  const char *cur = _text;
+  char *end = nullptr;
+  for (long value = std::strtol(cur, &end, 10); end != cur;
+       value = std::strtol(cur, &end, 10))
+  {
+    _values.push_back(static_cast<unsigned int>(value));
+    cur = end;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Index the elements of a COLLADA document by id and sid, and
+/// collect its arrays.
+/// \param[in] _elem Element to index with its descendants.
+/// \param[in,out] _data Private data of the loader.
+/// \param[in,out] _floatXmls The <float_array> elements.
+/// \param[in,out] _indexXmls The index array elements.
+/// \param[in,out] _size Length of the text of the arrays.
+static void IndexDocument(TiXmlElement *_elem, ColladaLoaderPrivate &_data,
+    std::vector<TiXmlElement *> &_floatXmls,
+    std::vector<TiXmlElement *> &_indexXmls, size_t &_size)
+{
+  // The first element in document order wins, as with a search
+  if (_elem->Attribute("id"))
+    _data.elementIds.emplace(_elem->Attribute("id"), _elem);
+  if (_elem->Attribute("sid"))
+    _data.elementIds.emplace(_elem->Attribute("sid"), _elem);
+
+  const std::string name = _elem->ValueStr();
+  if (_elem->GetText() && (name == "float_array" || name == "p" ||
+      name == "vcount" || name == "v"))
+  {
+    _size += strlen(_elem->GetText());
+    if (name == "float_array")
+      _floatXmls.push_back(_elem);
+    else
+      _indexXmls.push_back(_elem);
+  }
+
+  for (TiXmlElement *child = _elem->FirstChildElement(); child;
+       child = child->NextSiblingElement())
+  {
+    IndexDocument(child, _data, _floatXmls, _indexXmls, _size);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Index a COLLADA document and parse all its arrays. The arrays
+/// hold nearly all the text of large files and don't depend on each other,
+/// so they are parsed on all the cores.
+/// \param[in] _root Root element of the document.
+/// \param[in,out] _data Private data of the loader.
+static void PrepareDocument(TiXmlElement *_root, ColladaLoaderPrivate &_data)
+{
+  std::vector<TiXmlElement *> floatXmls;
+  std::vector<TiXmlElement *> indexXmls;
+  size_t size = 0;
+  IndexDocument(_root, _data, floatXmls, indexXmls, size);
+
+  // Create the entries first, so that the workers only read the maps
+  for (auto const xml : floatXmls)
+    _data.floatArrays[xml];
+  for (auto const xml : indexXmls)
+    _data.indexArrays[xml];
+
+  const size_t arrayCount = floatXmls.size() + indexXmls.size();
+  std::atomic<size_t> next(0);
+  auto parse = [&]()
+  {
+    for (size_t i = next++; i < arrayCount; i = next++)
+    {
+      if (i < floatXmls.size())
+      {
+        ParseFloats(floatXmls[i]->GetText(),
+            _data.floatArrays.at(floatXmls[i]));
+      }
+      else
+      {
+        TiXmlElement *xml = indexXmls[i - floatXmls.size()];
+        ParseIndices(xml->GetText(), _data.indexArrays.at(xml));
+      }
+    }
+  };
+
+  unsigned int threadCount = 0;
+  if (size >= PARALLEL_PARSE_SIZE)
+  {
+    threadCount = std::min<unsigned int>(arrayCount,
+        std::max(1u, std::thread::hardware_concurrency())) - 1;
+  }
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < threadCount; ++i)
+    threads.push_back(std::thread(parse));
+  parse();
+  for (auto &thread : threads)
+    thread.join();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the values of a <float_array>, parsed when the document was
+/// loaded.
+/// \param[in] _data Private data of the loader.
+/// \param[in] _xml The <float_array> element.
+/// \return The values.
+static const std::vector<double> &FloatArray(ColladaLoaderPrivate &_data,
+    TiXmlElement *_xml)
+{
+  auto iter = _data.floatArrays.find(_xml);
+  if (iter == _data.floatArrays.end())
+  {
+    iter = _data.floatArrays.emplace(_xml, std::vector<double>()).first;
+    ParseFloats(_xml ? _xml->GetText() : nullptr, iter->second);
+  }
+  return iter->second;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the values of an index array, parsed when the document was
+/// loaded.
+/// \param[in] _data Private data of the loader.
+/// \param[in] _xml The array element.
+/// \return The values.
+static const std::vector<unsigned int> &IndexArray(
+    ColladaLoaderPrivate &_data, TiXmlElement *_xml)
+{
+  auto iter = _data.indexArrays.find(_xml);
+  if (iter == _data.indexArrays.end())
+  {
+    iter = _data.indexArrays.emplace(_xml, std::vector<unsigned int>()).first;
+    ParseIndices(_xml ? _xml->GetText() : nullptr, iter->second);
+  }
+  return iter->second;
+}
+
 //////////////////////////////////////////////////
   ColladaLoader::ColladaLoader()
 : MeshLoader(), dataPtr(new ColladaLoaderPrivate)
@@ -135,11 +311,21 @@ Mesh *ColladaLoader::Load(const std::string &_filename)
           unitXml->Attribute("meter"));
   }
 
+  this->dataPtr->elementIds.clear();
+  this->dataPtr->floatArrays.clear();
+  this->dataPtr->indexArrays.clear();
+  PrepareDocument(this->dataPtr->colladaXml, *this->dataPtr);
+
   Mesh *mesh = new Mesh();
   mesh->SetPath(this->dataPtr->path);
 
   this->LoadScene(mesh);
 
+  // The elements go away with the document
+  this->dataPtr->elementIds.clear();
+  this->dataPtr->floatArrays.clear();
+  this->dataPtr->indexArrays.clear();
+
   if (mesh->HasSkeleton())
     ApplyInvBindTransform(mesh->GetSkeleton());
 
@@ -443,31 +629,24 @@ void ColladaLoader::LoadController(TiXmlElement *_contrXml,
     gzthrow("Faild to parse skinning information in Collada file.");
   }
 
-  std::string posesStr = invBMXml->FirstChildElement("float_array")->GetText();
-
-  std::vector<std::string> strs;
-  boost::split(strs, posesStr, boost::is_any_of(" \t"));
+  const std::vector<double> &poses = FloatArray(*this->dataPtr,
+      invBMXml->FirstChildElement("float_array"));
 
   for (unsigned int i = 0; i < joints.size(); ++i)
   {
     unsigned int id = i * 16;
+    if (id + 15 >= poses.size())
+    {
+      gzerr << "Missing inverse bind transform for joint[" << joints[i]
+            << "]\n";
+      break;
+    }
+
     ignition::math::Matrix4d mat;
-    mat.Set(ignition::math::parseFloat(strs[id +  0]),
-            ignition::math::parseFloat(strs[id +  1]),
-            ignition::math::parseFloat(strs[id +  2]),
-            ignition::math::parseFloat(strs[id +  3]),
-            ignition::math::parseFloat(strs[id +  4]),
-            ignition::math::parseFloat(strs[id +  5]),
-            ignition::math::parseFloat(strs[id +  6]),
-            ignition::math::parseFloat(strs[id +  7]),
-            ignition::math::parseFloat(strs[id +  8]),
-            ignition::math::parseFloat(strs[id +  9]),
-            ignition::math::parseFloat(strs[id + 10]),
-            ignition::math::parseFloat(strs[id + 11]),
-            ignition::math::parseFloat(strs[id + 12]),
-            ignition::math::parseFloat(strs[id + 13]),
-            ignition::math::parseFloat(strs[id + 14]),
-            ignition::math::parseFloat(strs[id + 15]));
+    mat.Set(poses[id +  0], poses[id +  1], poses[id +  2], poses[id +  3],
+            poses[id +  4], poses[id +  5], poses[id +  6], poses[id +  7],
+            poses[id +  8], poses[id +  9], poses[id + 10], poses[id + 11],
+            poses[id + 12], poses[id + 13], poses[id + 14], poses[id + 15]);
 
     skeleton->GetNodeByName(joints[i])->SetInverseBindTransform(mat);
   }
@@ -498,30 +677,12 @@ void ColladaLoader::LoadController(TiXmlElement *_contrXml,
 
   TiXmlElement *weightsXml = this->GetElementId("source", weightsURL);
 
-  std::string wString = weightsXml->FirstChildElement("float_array")->GetText();
-  std::vector<std::string> wStrs;
-  boost::split(wStrs, wString, boost::is_any_of(" \t"));
-
-  std::vector<float> weights;
-  for (unsigned int i = 0; i < wStrs.size(); ++i)
-    weights.push_back(ignition::math::parseFloat(wStrs[i]));
-
-  std::string cString = vertWeightsXml->FirstChildElement("vcount")->GetText();
-  std::string vString = vertWeightsXml->FirstChildElement("v")->GetText();
-  std::vector<std::string> vCountStrs;
-  std::vector<std::string> vStrs;
-
-  boost::split(vCountStrs, cString, boost::is_any_of(" \t"));
-  boost::split(vStrs, vString, boost::is_any_of(" \t"));
-
-  std::vector<unsigned int> vCount;
-  std::vector<unsigned int> v;
-
-  for (unsigned int i = 0; i < vCountStrs.size(); ++i)
-    vCount.push_back(ignition::math::parseInt(vCountStrs[i]));
-
-  for (unsigned int i = 0; i < vStrs.size(); ++i)
-    v.push_back(ignition::math::parseInt(vStrs[i]));
+  const std::vector<double> &weights = FloatArray(*this->dataPtr,
+      weightsXml->FirstChildElement("float_array"));
+  const std::vector<unsigned int> &vCount = IndexArray(*this->dataPtr,
+      vertWeightsXml->FirstChildElement("vcount"));
+  const std::vector<unsigned int> &v = IndexArray(*this->dataPtr,
+      vertWeightsXml->FirstChildElement("v"));
 
   skeleton->SetNumVertAttached(vCount.size());
 
@@ -915,6 +1076,13 @@ TiXmlElement *ColladaLoader::GetElementId(TiXmlElement *_parent,
   if (id.length() > 0 && id[0] == '#')
     id.erase(0, 1);
 
+  if (_parent == this->dataPtr->colladaXml && !id.empty() &&
+      !this->dataPtr->elementIds.empty())
+  {
+    auto iter = this->dataPtr->elementIds.find(id);
+    return iter == this->dataPtr->elementIds.end() ? nullptr : iter->second;
+  }
+
   if ((id.empty() && _parent->Value() == _name) ||
       (_parent->Attribute("id") && _parent->Attribute("id") == id) ||
       (_parent->Attribute("sid") && _parent->Attribute("sid") == id))
@@ -1032,21 +1200,15 @@ void ColladaLoader::LoadPositions(const std::string &_id,
 
     return;
   }
-  std::string valueStr = floatArrayXml->GetText();
+  const std::vector<double> &floats = FloatArray(*this->dataPtr,
+      floatArrayXml);
 
   boost::unordered_map<ignition::math::Vector3d,
     unsigned int, Vector3Hash> unique;
 
-  std::vector<std::string> strs;
-  std::vector<std::string>::iterator iter, end;
-  boost::split(strs, valueStr, boost::is_any_of(" \t"));
-
-  end = strs.end();
-  for (iter = strs.begin(); iter != end; iter += 3)
+  for (size_t i = 0; i + 2 < floats.size(); i += 3)
   {
-    ignition::math::Vector3d vec(ignition::math::parseFloat(*iter),
-        ignition::math::parseFloat(*(iter+1)),
-        ignition::math::parseFloat(*(iter+2)));
+    ignition::math::Vector3d vec(floats[i], floats[i+1], floats[i+2]);
 
     vec = _transform * vec;
     _values.push_back(vec);
@@ -1118,25 +1280,21 @@ void ColladaLoader::LoadNormals(const std::string &_id,
   boost::unordered_map<ignition::math::Vector3d,
     unsigned int, Vector3Hash> unique;
 
-  std::string valueStr = floatArrayXml->GetText();
-  std::istringstream iss(valueStr);
-  do
+  const std::vector<double> &floats = FloatArray(*this->dataPtr,
+      floatArrayXml);
+  for (size_t i = 0; i + 2 < floats.size(); i += 3)
   {
-    ignition::math::Vector3d vec;
-    iss >> vec.X() >> vec.Y() >> vec.Z();
-    if (iss)
-    {
-      vec = rotMat * vec;
-      vec.Normalize();
-      _values.push_back(vec);
+    ignition::math::Vector3d vec(floats[i], floats[i+1], floats[i+2]);
+    vec = rotMat * vec;
+    vec.Normalize();
+    _values.push_back(vec);
 
-      // create a map of duplicate indices
-      if (unique.find(vec) != unique.end())
-        _duplicates[_values.size()-1] = unique[vec];
-      else
-        unique[vec] = _values.size()-1;
-    }
-  } while (iss);
+    // create a map of duplicate indices
+    if (unique.find(vec) != unique.end())
+      _duplicates[_values.size()-1] = unique[vec];
+    else
+      unique[vec] = _values.size()-1;
+  }
 
   this->dataPtr->normalDuplicateMap[_id] = _duplicates;
   this->dataPtr->normalIds[_id] = _values;
@@ -1266,17 +1424,16 @@ void ColladaLoader::LoadTexCoords(const std::string &_id,
   boost::unordered_map<ignition::math::Vector2d,
     unsigned int, Vector2dHash> unique;
 
-  // Read the raw texture values, and split them on spaces.
-  std::string valueStr = floatArrayXml->GetText();
-  std::vector<std::string> values;
-  boost::split(values, valueStr, boost::is_any_of(" "));
+  // The raw texture values
+  const std::vector<double> &values = FloatArray(*this->dataPtr,
+      floatArrayXml);
+  const size_t valueCount = std::min<size_t>(totCount, values.size());
 
   // Read in all the texture coordinates.
-  for (int i = 0; i < totCount; i += stride)
+  for (size_t i = 0; i + 1 < valueCount; i += stride)
   {
     // We only handle 2D texture coordinates right now.
-    ignition::math::Vector2d vec(boost::lexical_cast<double>(values[i]),
-          1.0 - boost::lexical_cast<double>(values[i+1]));
+    ignition::math::Vector2d vec(values[i], 1.0 - values[i+1]);
     _values.push_back(vec);
 
     // create a map of duplicate indices
@@ -1606,17 +1763,13 @@ void ColladaLoader::LoadPolylist(TiXmlElement *_polylistXml,
   // break poly into triangles
   // if vcount >= 4, anchor around 0 (note this is bad for concave elements)
   //   e.g. if vcount = 4, break into triangle 1: [0,1,2], triangle 2: [0,2,3]
-  std::vector<std::string> vcountStrs;
   TiXmlElement *vcountXml = _polylistXml->FirstChildElement("vcount");
-  std::string vcountStr = vcountXml->GetText();
-  boost::split(vcountStrs, vcountStr, boost::is_any_of(" \t"));
-  std::vector<int> vcounts;
-  for (unsigned int j = 0; j < vcountStrs.size(); ++j)
-    vcounts.push_back(ignition::math::parseInt(vcountStrs[j]));
+  const std::vector<unsigned int> &vcounts = IndexArray(*this->dataPtr,
+      vcountXml);
 
   // read p
   TiXmlElement *pXml = _polylistXml->FirstChildElement("p");
-  std::string pStr = pXml->GetText();
+  const std::vector<unsigned int> &p = IndexArray(*this->dataPtr, pXml);
 
   // vertexIndexMap is a map of collada vertex index to Gazebo submesh vertex
   // indices, used for identifying vertices that can be shared.
@@ -1624,14 +1777,19 @@ void ColladaLoader::LoadPolylist(TiXmlElement *_polylistXml,
   unsigned int *values = new unsigned int[inputSize];
   memset(values, 0, inputSize);
 
-  std::vector<std::string> strs;
-  boost::split(strs, pStr, boost::is_any_of(" \t"));
-  std::vector<std::string>::iterator strsIter = strs.begin();
+  size_t polyStart = 0;
   for (unsigned int l = 0; l < vcounts.size(); ++l)
   {
     // put us at the beginning of the polygon list
     if (l > 0)
-      strsIter += inputSize*vcounts[l-1];
+      polyStart += inputSize*vcounts[l-1];
+
+    if (polyStart + inputSize*vcounts[l] > p.size())
+    {
+      gzerr << "Collada file[" << this->dataPtr->filename
+        << "] has a <polylist> with fewer indices than its <vcount>\n";
+      break;
+    }
 
     for (unsigned int k = 2; k < (unsigned int)vcounts[l]; ++k)
     {
@@ -1652,7 +1810,7 @@ void ColladaLoader::LoadPolylist(TiXmlElement *_polylistXml,
 
         for (unsigned int i = 0; i < inputSize; ++i)
         {
-          values[i] = ignition::math::parseInt(strsIter[triangle_index+i]);
+          values[i] = p[polyStart + triangle_index + i];
           /*gzerr << "debug parsing "
                 << " poly-i[" << l
                 << "] tri-end-index[" << k
@@ -1952,7 +2110,7 @@ void ColladaLoader::LoadTriangles(TiXmlElement *_trianglesXml,
 
     return;
   }
-  std::string pStr = pXml->GetText();
+  const std::vector<unsigned int> &p = IndexArray(*this->dataPtr, pXml);
 
   // Collada format allows normals and texcoords to have their own set of
   // indices for more efficient storage of data but opengl only supports one
@@ -1965,14 +2123,11 @@ void ColladaLoader::LoadTriangles(TiXmlElement *_trianglesXml,
   std::map<unsigned int, std::vector<GeometryIndices> > vertexIndexMap;
 
   std::vector<unsigned int> values(offsetSize);
-  std::vector<std::string> strs;
-
-  boost::split(strs, pStr, boost::is_any_of(" \t"));
 
-  for (unsigned int j = 0; j < strs.size(); j += offsetSize)
+  for (size_t j = 0; j + offsetSize <= p.size(); j += offsetSize)
   {
     for (unsigned int i = 0; i < offsetSize; ++i)
-      values.at(i) = ignition::math::parseInt(strs[j+i]);
+      values.at(i) = p[j+i];
 
     unsigned int daeVertIndex = 0;
     bool addIndex = !hasVertices;
@@ -2127,21 +2282,15 @@ void ColladaLoader::LoadLines(TiXmlElement *_xml,
   this->LoadVertices(source, _transform, verts, norms);
 
   TiXmlElement *pXml = _xml->FirstChildElement("p");
-  std::string pStr = pXml->GetText();
-  std::istringstream iss(pStr);
+  const std::vector<unsigned int> &p = IndexArray(*this->dataPtr, pXml);
 
-  do
+  for (size_t i = 0; i + 1 < p.size(); i += 2)
   {
-    int a, b;
-    iss >> a >> b;
-
-    if (!iss)
-      break;
-    subMesh->AddVertex(verts[a]);
+    subMesh->AddVertex(verts[p[i]]);
     subMesh->AddIndex(subMesh->GetVertexCount() - 1);
-    subMesh->AddVertex(verts[b]);
+    subMesh->AddVertex(verts[p[i+1]]);
     subMesh->AddIndex(subMesh->GetVertexCount() - 1);
-  } while (iss);
+  }
 
   _mesh->AddSubMesh(subMesh);
 }
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <ignition/math/Vector3.hh>
@@ -85,6 +86,20 @@ namespace gazebo
       /// duplicate texture coordinates.
       public: std::map<std::string, std::map<unsigned int, unsigned int> >
           texcoordDuplicateMap;
+
+      /// \brief Elements of the COLLADA document by id and sid, while it
+      /// loads.
+      public: std::unordered_map<std::string, TiXmlElement *> elementIds;
+
+      /// \brief Values of the <float_array> elements, while the document
+      /// loads.
+      public: std::unordered_map<const TiXmlElement *, std::vector<double> >
+          floatArrays;
+
+      /// \brief Values of the index arrays (<p>, <vcount> and <v>), while
+      /// the document loads.
+      public: std::unordered_map<const TiXmlElement *,
+          std::vector<unsigned int> > indexArrays;
     };
 
     /// \brief Helper data structure for loading collada geometries.
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_CONCURRENTEVENT_HH_
+#define GAZEBO_COMMON_CONCURRENTEVENT_HH_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <tbb/task_group.h>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/PluginProfiler.hh"
+#include "gazebo/common/Profiler.hh"
+
+namespace gazebo
+{
+  namespace event
+  {
+    /// \addtogroup gazebo_event Events
+    /// \{
+
+    /// \brief Number of low bits of a connection id that index the
+    /// connection handles of a ConcurrentEventT. The high bits hold the
+    /// generation of the handle, so that a stale id never disconnects a
+    /// newer connection.
+    static const int CONCURRENT_EVENT_HANDLE_BITS = 20;
+
+    /// \brief Mask of the handle bits of a connection id.
+    static const int CONCURRENT_EVENT_HANDLE_MASK =
+        (1 << CONCURRENT_EVENT_HANDLE_BITS) - 1;
+
+    /// \brief Last generation of a handle, which keeps ids positive. A
+    /// handle is retired instead of wrapping around to generation 0.
+    static const int CONCURRENT_EVENT_GENERATION_MAX =
+        (1 << (31 - CONCURRENT_EVENT_HANDLE_BITS)) - 1;
+
+    /// \class ConcurrentEventT ConcurrentEvent.hh common/common.hh
+    /// \brief An event whose subscribers are safe to run at the same time.
+    /// Signal runs them on the task pool, and returns once they are all
+    /// done.
+    ///
+    /// Connections are kept in a vector, in the order they connected, and
+    /// connection ids index a table of handles, so Disconnect is O(1).
+    template<typename T>
+    class ConcurrentEventT : public Event
+    {
+      /// \brief Constructor.
+      public: ConcurrentEventT();
+
+      /// \brief Destructor.
+      public: virtual ~ConcurrentEventT();
+
+      /// \brief Connect a callback to this event.
+      /// \param[in] _subscriber Pointer to a callback function.
+      /// \return A Connection object, which will automatically call
+      /// Disconnect when it goes out of scope. Null once all the connection
+      /// ids of the event have been used.
+      public: ConnectionPtr Connect(const std::function<T> &_subscriber);
+
+      /// \brief Disconnect a callback to this event.
+      /// \param[in] _id The id of the connection to disconnect.
+      public: virtual void Disconnect(int _id);
+
+      /// \brief Get the number of connections.
+      /// \return Number of connection to this Event.
+      public: unsigned int ConnectionCount() const;
+
+      /// \brief Signal the event, running the subscribers on the task pool.
+      /// Subscribers must not connect to this event.
+      /// \param[in] _args Parameters of the event.
+      public: template<typename... Args>
+              void Signal(const Args &... _args)
+      {
+        this->SignalAlongside(std::function<void ()>(), _args...);
+      }
+
+      /// \brief Signal the event, running the subscribers on the task pool
+      /// while a function runs on the calling thread. Returns once the
+      /// function and all the subscribers are done.
+      /// \param[in] _inOrder Function run on the calling thread, typically
+      /// the signal of an EventT with the same parameters.
+      /// \param[in] _args Parameters of the event.
+      public: template<typename... Args>
+              void SignalAlongside(const std::function<void ()> &_inOrder,
+                  const Args &... _args)
+      {
+        IGN_PROFILE("ConcurrentEvent::Signal");
+
+        this->Cleanup();
+
+        this->SetSignaled(true);
+
+        if (this->connections.empty())
+        {
+          if (_inOrder)
+            _inOrder();
+          return;
+        }
+
+        tbb::task_group group;
+        for (auto const &conn : this->connections)
+        {
+          if (conn->on)
+          {
+            EventConnection *task = conn.get();
+            group.run([task, &_args...]()
+                {
+                  if (task->on)
+                    task->callback(_args...);
+                });
+          }
+        }
+
+        if (_inOrder)
+          _inOrder();
+
+        group.wait();
+      }
+
+      /// \internal
+      /// \brief Removes disconnected connections, keeping the others in
+      /// the order they connected.
+      /// We assume that this function is called from a Signal function.
+      private: void Cleanup();
+
+      /// \brief A private helper class used in maintaining connections.
+      private: class EventConnection
+      {
+        /// \brief Constructor
+        public: EventConnection(const std::function<T> &_cb,
+                    const int _handle)
+                : callback(_cb), handle(_handle)
+        {
+          this->on = true;
+        }
+
+        /// \brief On/off value for the event callback
+        public: std::atomic_bool on;
+
+        /// \brief Callback function
+        public: std::function<T> callback;
+
+        /// \brief Index of the handle of this connection.
+        public: int handle;
+      };
+
+      /// \brief Maps a connection id to its place in the connections.
+      private: class Handle
+      {
+        /// \brief Index in the connections, -1 once disconnected.
+        public: int index = -1;
+
+        /// \brief Incremented each time the handle is disconnected.
+        public: int generation = 0;
+      };
+
+      /// \brief Connection callbacks, in the order they connected.
+      private: std::vector<std::unique_ptr<EventConnection>> connections;
+
+      /// \brief Handles of the connections, indexed by connection id.
+      private: std::vector<Handle> handles;
+
+      /// \brief Handles free for new connections.
+      private: std::vector<int> freeHandles;
+
+      /// \brief Number of handles that reached their last generation.
+      private: unsigned int retiredHandles = 0;
+
+      /// \brief True if disconnected connections wait for Cleanup.
+      private: std::atomic_bool cleanupNeeded;
+
+      /// \brief A thread lock.
+      private: std::mutex mutex;
+    };
+
+    /// \brief Constructor.
+    template<typename T>
+    ConcurrentEventT<T>::ConcurrentEventT()
+    : Event()
+    {
+      this->cleanupNeeded = false;
+    }
+
+    /// \brief Destructor. Deletes all the associated connections.
+    template<typename T>
+    ConcurrentEventT<T>::~ConcurrentEventT()
+    {
+      this->connections.clear();
+    }
+
+    /// \brief Adds a connection.
+    /// \param[in] _subscriber the subscriber to connect.
+    template<typename T>
+    ConnectionPtr ConcurrentEventT<T>::Connect(
+        const std::function<T> &_subscriber)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+
+      int handle;
+      if (!this->freeHandles.empty())
+      {
+        handle = this->freeHandles.back();
+        this->freeHandles.pop_back();
+      }
+      else if (this->handles.size() <=
+          static_cast<size_t>(CONCURRENT_EVENT_HANDLE_MASK))
+      {
+        handle = static_cast<int>(this->handles.size());
+        this->handles.push_back(Handle());
+      }
+      else
+      {
+        return ConnectionPtr();
+      }
+
+      // Time the callbacks of plugins, see PluginProfiler
+      this->handles[handle].index = static_cast<int>(this->connections.size());
+      this->connections.emplace_back(new EventConnection(
+            common::PluginProfiler::Wrap(_subscriber), handle));
+
+      const int id = (this->handles[handle].generation <<
+          CONCURRENT_EVENT_HANDLE_BITS) | handle;
+      return ConnectionPtr(new Connection(this, id));
+    }
+
+    /// \brief Get the number of connections.
+    /// \return Number of connections.
+    template<typename T>
+    unsigned int ConcurrentEventT<T>::ConnectionCount() const
+    {
+      return this->handles.size() - this->freeHandles.size() -
+        this->retiredHandles;
+    }
+
+    /// \brief Removes a connection.
+    /// \param[in] _id the connection index.
+    template<typename T>
+    void ConcurrentEventT<T>::Disconnect(int _id)
+    {
+      if (_id < 0)
+        return;
+
+      std::lock_guard<std::mutex> lock(this->mutex);
+
+      // Find the connection, ignoring ids of previous connections.
+      const int handle = _id & CONCURRENT_EVENT_HANDLE_MASK;
+      if (handle >= static_cast<int>(this->handles.size()))
+        return;
+
+      Handle &entry = this->handles[handle];
+      if (entry.index < 0 ||
+          entry.generation != (_id >> CONCURRENT_EVENT_HANDLE_BITS))
+      {
+        return;
+      }
+
+      // The connection is removed by the next signal.
+      this->connections[entry.index]->on = false;
+      entry.index = -1;
+      this->cleanupNeeded = true;
+
+      // A handle that wrapped around would give the ids of its first
+      // connections again, so it is retired instead.
+      if (entry.generation < CONCURRENT_EVENT_GENERATION_MAX)
+      {
+        ++entry.generation;
+        this->freeHandles.push_back(handle);
+      }
+      else
+        ++this->retiredHandles;
+    }
+
+    /////////////////////////////////////////////
+    template<typename T>
+    void ConcurrentEventT<T>::Cleanup()
+    {
+      if (!this->cleanupNeeded)
+        return;
+
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->cleanupNeeded = false;
+
+      // Compact the connections that are still on.
+      size_t count = 0;
+      for (size_t i = 0; i < this->connections.size(); ++i)
+      {
+        if (!this->connections[i]->on)
+          continue;
+
+        if (count != i)
+          this->connections[count] = std::move(this->connections[i]);
+        this->handles[this->connections[count]->handle].index =
+            static_cast<int>(count);
+        ++count;
+      }
+      this->connections.resize(count);
+    }
+    /// \}
+  }
+}
+#endif
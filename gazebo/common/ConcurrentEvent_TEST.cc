@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gazebo/common/ConcurrentEvent.hh>
+#include <gazebo/common/Event.hh>
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ConcurrentEventTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ConcurrentEventTest, Signal)
+{
+  std::atomic<int> sum(0);
+
+  event::ConcurrentEventT<void (const int)> evt;
+  std::vector<event::ConnectionPtr> conns;
+  for (int i = 0; i < 100; ++i)
+  {
+    conns.push_back(evt.Connect([&sum](const int _value)
+        {
+          sum += _value;
+        }));
+  }
+  EXPECT_EQ(100u, evt.ConnectionCount());
+
+  // All the subscribers are done when the signal returns
+  evt.Signal(2);
+  EXPECT_EQ(200, sum);
+  EXPECT_TRUE(evt.Signaled());
+
+  // Remove every other connection
+  for (int i = 0; i < 100; i += 2)
+    conns[i].reset();
+  EXPECT_EQ(50u, evt.ConnectionCount());
+  evt.Signal(1);
+  EXPECT_EQ(250, sum);
+
+  conns.clear();
+  evt.Signal(1);
+  EXPECT_EQ(250, sum);
+  EXPECT_EQ(0u, evt.ConnectionCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConcurrentEventTest, SignalAlongside)
+{
+  std::atomic<int> sum(0);
+  std::vector<int> order;
+
+  event::EventT<void (const int)> ordered;
+  event::ConcurrentEventT<void (const int)> concurrent;
+  std::vector<event::ConnectionPtr> conns;
+  conns.push_back(ordered.Connect([&order](const int _value)
+      {
+        order.push_back(_value);
+      }));
+  conns.push_back(ordered.Connect([&order](const int _value)
+      {
+        order.push_back(_value + 1);
+      }));
+
+  for (int i = 0; i < 10; ++i)
+  {
+    conns.push_back(concurrent.Connect([&sum](const int _value)
+        {
+          sum += _value;
+        }));
+  }
+
+  concurrent.SignalAlongside([&ordered]() { ordered(2); }, 2);
+  EXPECT_EQ(20, sum);
+  EXPECT_EQ(std::vector<int>({2, 3}), order);
+
+  // The function still runs without concurrent subscribers
+  event::ConcurrentEventT<void (const int)> empty;
+  empty.SignalAlongside([&ordered]() { ordered(4); }, 4);
+  EXPECT_EQ(std::vector<int>({2, 3, 4, 5}), order);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConcurrentEventTest, StaleDisconnect)
+{
+  int calls = 0;
+  int calls1 = 0;
+
+  event::ConcurrentEventT<void ()> evt;
+  event::ConnectionPtr conn = evt.Connect([&calls]() { ++calls; });
+  const int staleId = conn->Id();
+  conn.reset();
+  EXPECT_EQ(0u, evt.ConnectionCount());
+
+  // The new connection reuses the handle of the old one, but not its id.
+  event::ConnectionPtr conn1 = evt.Connect([&calls1]() { ++calls1; });
+  EXPECT_NE(staleId, conn1->Id());
+  evt.Disconnect(staleId);
+  EXPECT_EQ(1u, evt.ConnectionCount());
+
+  evt.Signal();
+
+  EXPECT_EQ(0, calls);
+  EXPECT_EQ(1, calls1);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConcurrentEventTest, GenerationWrap)
+{
+  event::ConcurrentEventT<void ()> evt;
+  evt.Signal();
+
+  // Reuse the first handle until it reaches its last generation
+  std::set<int> ids;
+  for (int i = 0; i <= event::CONCURRENT_EVENT_GENERATION_MAX; ++i)
+  {
+    event::ConnectionPtr conn = evt.Connect([]() {});
+    ASSERT_TRUE(conn != nullptr);
+    EXPECT_EQ(0, conn->Id() & event::CONCURRENT_EVENT_HANDLE_MASK);
+    EXPECT_GE(conn->Id(), 0);
+    EXPECT_TRUE(ids.insert(conn->Id()).second);
+  }
+  EXPECT_EQ(0u, evt.ConnectionCount());
+
+  // The handle is retired instead of giving the first id again
+  int calls = 0;
+  event::ConnectionPtr conn = evt.Connect([&calls]() { ++calls; });
+  ASSERT_TRUE(conn != nullptr);
+  EXPECT_EQ(1, conn->Id() & event::CONCURRENT_EVENT_HANDLE_MASK);
+  EXPECT_EQ(1u, evt.ConnectionCount());
+
+  // None of the old ids disconnects the new connection
+  for (const int id : ids)
+    evt.Disconnect(id);
+  EXPECT_EQ(1u, evt.ConnectionCount());
+  evt.Signal();
+  EXPECT_EQ(1, calls);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
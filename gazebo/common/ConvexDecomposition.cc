@@ -0,0 +1,840 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/SystemPaths.hh"
+#include "gazebo/common/ConvexDecomposition.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \internal
+    /// \brief Private data for ConvexDecomposition
+    class ConvexDecompositionPrivate
+    {
+      /// \brief Compute a decomposition.
+      /// \param[in] _points Vertices of the mesh.
+      /// \param[in] _indices Vertex indices of the triangles.
+      /// \param[out] _hulls The hulls.
+      public: void Compute(const std::vector<ignition::math::Vector3d> &_points,
+                  const std::vector<unsigned int> &_indices,
+                  ConvexHull_V &_hulls) const;
+
+      /// \brief Get a cached decomposition, or compute it.
+      /// \param[in] _vertices Vertex array of the mesh.
+      /// \param[in] _vertexCount Number of vertices.
+      /// \param[in] _indices Index array of the mesh.
+      /// \param[in] _indexCount Number of indices.
+      /// \return The hulls.
+      public: const ConvexHull_V &Decompose(const float *_vertices,
+                  const unsigned int _vertexCount, const int *_indices,
+                  const unsigned int _indexCount);
+
+      /// \brief Load a decomposition from the disk cache.
+      /// \param[in] _filename The cache file.
+      /// \param[out] _hulls The hulls.
+      /// \return False if the file does not exist or is invalid.
+      public: static bool Read(const std::string &_filename,
+                  ConvexHull_V &_hulls);
+
+      /// \brief Save a decomposition to the disk cache.
+      /// \param[in] _filename The cache file.
+      /// \param[in] _hulls The hulls.
+      public: static void Write(const std::string &_filename,
+                  const ConvexHull_V &_hulls);
+
+      /// \brief Maximum number of hulls.
+      public: unsigned int maxHullCount = 16;
+
+      /// \brief Maximum number of vertices of a hull.
+      public: unsigned int maxHullVertexCount = 64;
+
+      /// \brief Concavity tolerance, relative to the mesh size.
+      public: double concavity = 0.01;
+
+      /// \brief Directory of the disk cache, empty if disabled.
+      public: std::string cachePath;
+
+      /// \brief Decompositions indexed by the hash of their input.
+      public: std::map<uint64_t, ConvexHull_V> cache;
+
+      /// \brief Protects the cache and the parameters.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+/// \brief Version of the cache files, to change with the algorithm.
+static const uint64_t kCacheVersion = 1;
+
+/// \brief Triangle of a hull under construction.
+struct HullFace
+{
+  /// \brief Vertex indices, counter clockwise seen from outside.
+  unsigned int v[3];
+
+  /// \brief Outward unit normal.
+  ignition::math::Vector3d normal;
+
+  /// \brief Plane offset, normal.Dot(p) for any point p of the face.
+  double offset;
+};
+
+/// \brief Part of a mesh being decomposed.
+struct Part
+{
+  /// \brief Triangles of the part, indices into the mesh triangles.
+  std::vector<unsigned int> triangles;
+
+  /// \brief Convex hull of the vertices of the part.
+  ConvexHull hull;
+
+  /// \brief Depth of the deepest vertex inside the hull.
+  double concavity = 0;
+};
+
+//////////////////////////////////////////////////
+/// \brief Fold data into a FNV-1a hash.
+/// \param[in] _data The data.
+/// \param[in] _size Number of bytes.
+/// \param[in,out] _hash The hash.
+static void HashBytes(const void *_data, const size_t _size, uint64_t &_hash)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(_data);
+  for (size_t i = 0; i < _size; ++i)
+  {
+    _hash ^= bytes[i];
+    _hash *= 1099511628211ULL;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Make a face from three points.
+/// \param[in] _points The points.
+/// \param[in] _a First vertex.
+/// \param[in] _b Second vertex.
+/// \param[in] _c Third vertex.
+/// \return The face, counter clockwise as given.
+static HullFace MakeFace(const std::vector<ignition::math::Vector3d> &_points,
+    const unsigned int _a, const unsigned int _b, const unsigned int _c)
+{
+  HullFace face;
+  face.v[0] = _a;
+  face.v[1] = _b;
+  face.v[2] = _c;
+  face.normal = (_points[_b] - _points[_a]).Cross(_points[_c] - _points[_a]);
+  const double length = face.normal.Length();
+  if (length > 0)
+    face.normal /= length;
+  face.offset = face.normal.Dot(_points[_a]);
+  return face;
+}
+
+//////////////////////////////////////////////////
+bool ConvexHull::Build(const std::vector<ignition::math::Vector3d> &_points)
+{
+  this->vertices.clear();
+  this->indices.clear();
+
+  if (_points.size() < 4)
+    return false;
+
+  // Tolerance relative to the size of the point set
+  ignition::math::Vector3d minPt = _points[0];
+  ignition::math::Vector3d maxPt = _points[0];
+  for (const auto &p : _points)
+  {
+    minPt.Min(p);
+    maxPt.Max(p);
+  }
+  const double size = (maxPt - minPt).Length();
+  if (size <= 0)
+    return false;
+  const double eps = size * 1e-9;
+
+  // Initial tetrahedron from extreme points
+  unsigned int i0 = 0;
+  for (unsigned int i = 1; i < _points.size(); ++i)
+  {
+    if (_points[i].X() < _points[i0].X())
+      i0 = i;
+  }
+
+  unsigned int i1 = i0;
+  double best = 0;
+  for (unsigned int i = 0; i < _points.size(); ++i)
+  {
+    const double d = (_points[i] - _points[i0]).SquaredLength();
+    if (d > best)
+    {
+      best = d;
+      i1 = i;
+    }
+  }
+  if (best <= eps * eps)
+    return false;
+
+  unsigned int i2 = i0;
+  best = 0;
+  const ignition::math::Vector3d axis =
+    (_points[i1] - _points[i0]).Normalized();
+  for (unsigned int i = 0; i < _points.size(); ++i)
+  {
+    const double d = axis.Cross(_points[i] - _points[i0]).Length();
+    if (d > best)
+    {
+      best = d;
+      i2 = i;
+    }
+  }
+  if (best <= eps)
+    return false;
+
+  unsigned int i3 = i0;
+  best = 0;
+  const ignition::math::Vector3d normal =
+    (_points[i1] - _points[i0]).Cross(_points[i2] - _points[i0]).Normalized();
+  for (unsigned int i = 0; i < _points.size(); ++i)
+  {
+    const double d = std::fabs(normal.Dot(_points[i] - _points[i0]));
+    if (d > best)
+    {
+      best = d;
+      i3 = i;
+    }
+  }
+  if (best <= eps)
+    return false;
+
+  // Orient the tetrahedron outward
+  if (normal.Dot(_points[i3] - _points[i0]) > 0)
+    std::swap(i1, i2);
+
+  std::vector<HullFace> faces;
+  faces.push_back(MakeFace(_points, i0, i1, i2));
+  faces.push_back(MakeFace(_points, i0, i3, i1));
+  faces.push_back(MakeFace(_points, i1, i3, i2));
+  faces.push_back(MakeFace(_points, i2, i3, i0));
+
+  // Add the other points one at a time, replacing the faces they see by a
+  // cone from the horizon to the point.
+  std::vector<bool> visible;
+  std::set<std::pair<unsigned int, unsigned int>> edges;
+  for (unsigned int p = 0; p < _points.size(); ++p)
+  {
+    if (p == i0 || p == i1 || p == i2 || p == i3)
+      continue;
+
+    visible.assign(faces.size(), false);
+    bool outside = false;
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+      if (faces[f].normal.Dot(_points[p]) - faces[f].offset > eps)
+      {
+        visible[f] = true;
+        outside = true;
+      }
+    }
+    if (!outside)
+      continue;
+
+    edges.clear();
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+      if (!visible[f])
+        continue;
+      for (int e = 0; e < 3; ++e)
+        edges.insert(std::make_pair(faces[f].v[e], faces[f].v[(e+1) % 3]));
+    }
+
+    std::vector<HullFace> kept;
+    kept.reserve(faces.size() + edges.size());
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+      if (!visible[f])
+        kept.push_back(faces[f]);
+    }
+
+    // Horizon edges are the edges of visible faces whose twin belongs to a
+    // hidden face.
+    for (const auto &edge : edges)
+    {
+      if (edges.count(std::make_pair(edge.second, edge.first)) == 0)
+        kept.push_back(MakeFace(_points, edge.first, edge.second, p));
+    }
+    faces.swap(kept);
+  }
+
+  // Keep only the vertices used by the faces
+  std::map<unsigned int, unsigned int> remap;
+  for (const auto &face : faces)
+  {
+    for (int e = 0; e < 3; ++e)
+    {
+      auto inserted = remap.insert(std::make_pair(face.v[e],
+            static_cast<unsigned int>(this->vertices.size())));
+      if (inserted.second)
+        this->vertices.push_back(_points[face.v[e]]);
+      this->indices.push_back(inserted.first->second);
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+double ConvexHull::Volume() const
+{
+  if (this->vertices.empty())
+    return 0;
+
+  const ignition::math::Vector3d &origin = this->vertices[0];
+  double volume = 0;
+  for (size_t i = 0; i + 2 < this->indices.size(); i += 3)
+  {
+    const ignition::math::Vector3d a =
+      this->vertices[this->indices[i]] - origin;
+    const ignition::math::Vector3d b =
+      this->vertices[this->indices[i+1]] - origin;
+    const ignition::math::Vector3d c =
+      this->vertices[this->indices[i+2]] - origin;
+    volume += a.Dot(b.Cross(c));
+  }
+  return volume / 6.0;
+}
+
+//////////////////////////////////////////////////
+double ConvexHull::Depth(const ignition::math::Vector3d &_point) const
+{
+  double depth = std::numeric_limits<double>::max();
+  for (size_t i = 0; i + 2 < this->indices.size(); i += 3)
+  {
+    const ignition::math::Vector3d &a = this->vertices[this->indices[i]];
+    ignition::math::Vector3d n =
+      (this->vertices[this->indices[i+1]] - a).Cross(
+       this->vertices[this->indices[i+2]] - a);
+    const double length = n.Length();
+    if (length <= 0)
+      continue;
+    n /= length;
+    depth = std::min(depth, n.Dot(a - _point));
+  }
+  return this->indices.empty() ? -depth : depth;
+}
+
+//////////////////////////////////////////////////
+/// \brief Build the hull of a part of a mesh.
+/// \param[in] _points Vertices of the mesh.
+/// \param[in] _indices Vertex indices of the mesh triangles.
+/// \param[in] _centroids Centroids of the mesh triangles.
+/// \param[in] _thickness Thickness given to flat parts.
+/// \param[in] _maxVertexCount Maximum number of vertices of the hull.
+/// \param[in,out] _part The part, its hull and concavity are updated.
+static void BuildPart(const std::vector<ignition::math::Vector3d> &_points,
+    const std::vector<unsigned int> &_indices,
+    const std::vector<ignition::math::Vector3d> &_centroids,
+    const double _thickness, const unsigned int _maxVertexCount, Part &_part)
+{
+  std::vector<unsigned int> used;
+  used.reserve(_part.triangles.size() * 3);
+  for (auto t : _part.triangles)
+  {
+    for (int e = 0; e < 3; ++e)
+      used.push_back(_indices[t*3+e]);
+  }
+  std::sort(used.begin(), used.end());
+  used.erase(std::unique(used.begin(), used.end()), used.end());
+
+  std::vector<ignition::math::Vector3d> points;
+  points.reserve(used.size());
+  for (auto v : used)
+    points.push_back(_points[v]);
+
+  if (!_part.hull.Build(points))
+  {
+    // Flat part, give it a thickness along the normal of its triangles
+    ignition::math::Vector3d normal;
+    for (auto t : _part.triangles)
+    {
+      const ignition::math::Vector3d &a = _points[_indices[t*3]];
+      ignition::math::Vector3d n = (_points[_indices[t*3+1]] - a).Cross(
+          _points[_indices[t*3+2]] - a);
+      if (normal.Dot(n) < 0)
+        n = -n;
+      normal += n;
+    }
+    if (normal.Length() <= 0)
+    {
+      _part.concavity = 0;
+      return;
+    }
+    normal.Normalize();
+
+    const size_t count = points.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+      points.push_back(points[i] - normal * (_thickness * 0.5));
+      points[i] += normal * (_thickness * 0.5);
+    }
+    if (!_part.hull.Build(points))
+    {
+      _part.concavity = 0;
+      return;
+    }
+  }
+
+  // Simplify large hulls by keeping the vertices that are the farthest
+  // from the ones already kept.
+  if (_part.hull.vertices.size() > _maxVertexCount)
+  {
+    const std::vector<ignition::math::Vector3d> &all = _part.hull.vertices;
+    std::vector<double> distances(all.size(),
+        std::numeric_limits<double>::max());
+    std::vector<ignition::math::Vector3d> kept;
+    size_t next = 0;
+    while (kept.size() < _maxVertexCount)
+    {
+      kept.push_back(all[next]);
+      double farthest = -1;
+      for (size_t i = 0; i < all.size(); ++i)
+      {
+        distances[i] = std::min(distances[i],
+            (all[i] - kept.back()).SquaredLength());
+        if (distances[i] > farthest)
+        {
+          farthest = distances[i];
+          next = i;
+        }
+      }
+    }
+    ConvexHull simplified;
+    if (simplified.Build(kept))
+      _part.hull = simplified;
+  }
+
+  // Vertices can all lie on the hull of a concave part, as in a U made of
+  // overlapping boxes, so the centroids of the triangles are measured too.
+  _part.concavity = 0;
+  for (auto v : used)
+    _part.concavity = std::max(_part.concavity, _part.hull.Depth(_points[v]));
+  for (auto t : _part.triangles)
+  {
+    _part.concavity = std::max(_part.concavity,
+        _part.hull.Depth(_centroids[t]));
+  }
+}
+
+//////////////////////////////////////////////////
+void ConvexDecompositionPrivate::Compute(
+    const std::vector<ignition::math::Vector3d> &_points,
+    const std::vector<unsigned int> &_indices, ConvexHull_V &_hulls) const
+{
+  _hulls.clear();
+  const unsigned int triangleCount = _indices.size() / 3;
+  if (triangleCount == 0)
+    return;
+
+  ignition::math::Vector3d minPt = _points[_indices[0]];
+  ignition::math::Vector3d maxPt = minPt;
+  for (auto v : _indices)
+  {
+    minPt.Min(_points[v]);
+    maxPt.Max(_points[v]);
+  }
+  const double size = (maxPt - minPt).Length();
+  if (size <= 0)
+    return;
+  const double tolerance = this->concavity * size;
+  const double thickness = size * 1e-3;
+
+  std::vector<ignition::math::Vector3d> centroids(triangleCount);
+  for (unsigned int t = 0; t < triangleCount; ++t)
+  {
+    centroids[t] = (_points[_indices[t*3]] + _points[_indices[t*3+1]] +
+        _points[_indices[t*3+2]]) / 3.0;
+  }
+
+  std::vector<Part> parts(1);
+  parts[0].triangles.resize(triangleCount);
+  for (unsigned int t = 0; t < triangleCount; ++t)
+    parts[0].triangles[t] = t;
+  BuildPart(_points, _indices, centroids, thickness,
+      this->maxHullVertexCount, parts[0]);
+
+  // Split the most concave part until all parts are convex enough
+  while (parts.size() < this->maxHullCount)
+  {
+    size_t worst = 0;
+    for (size_t i = 1; i < parts.size(); ++i)
+    {
+      if (parts[i].concavity > parts[worst].concavity)
+        worst = i;
+    }
+    if (parts[worst].concavity <= tolerance)
+      break;
+
+    // Split along the longest axis of the triangle centroids, at the
+    // candidate plane that gives the smallest total hull volume.
+    ignition::math::Vector3d cmin = centroids[parts[worst].triangles[0]];
+    ignition::math::Vector3d cmax = cmin;
+    for (auto t : parts[worst].triangles)
+    {
+      cmin.Min(centroids[t]);
+      cmax.Max(centroids[t]);
+    }
+    const ignition::math::Vector3d extent = cmax - cmin;
+    int axis = 0;
+    if (extent.Y() > extent[axis])
+      axis = 1;
+    if (extent.Z() > extent[axis])
+      axis = 2;
+
+    bool split = false;
+    Part bestFirst;
+    Part bestSecond;
+    double bestVolume = std::numeric_limits<double>::max();
+    for (const double ratio : {0.5, 0.25, 0.75})
+    {
+      const double cut = cmin[axis] + extent[axis] * ratio;
+      Part first;
+      Part second;
+      for (auto t : parts[worst].triangles)
+      {
+        if (centroids[t][axis] < cut)
+          first.triangles.push_back(t);
+        else
+          second.triangles.push_back(t);
+      }
+      if (first.triangles.empty() || second.triangles.empty())
+        continue;
+
+      BuildPart(_points, _indices, centroids, thickness,
+          this->maxHullVertexCount, first);
+      BuildPart(_points, _indices, centroids, thickness,
+          this->maxHullVertexCount, second);
+      const double volume = first.hull.Volume() + second.hull.Volume();
+      if (volume < bestVolume)
+      {
+        bestVolume = volume;
+        bestFirst = std::move(first);
+        bestSecond = std::move(second);
+        split = true;
+      }
+    }
+
+    if (!split)
+    {
+      // All the triangles are at the same place, it can't be split
+      parts[worst].concavity = 0;
+      continue;
+    }
+
+    parts[worst] = std::move(bestFirst);
+    parts.push_back(std::move(bestSecond));
+  }
+
+  for (auto &part : parts)
+  {
+    if (!part.hull.vertices.empty())
+      _hulls.push_back(std::move(part.hull));
+  }
+}
+
+//////////////////////////////////////////////////
+const ConvexHull_V &ConvexDecompositionPrivate::Decompose(
+    const float *_vertices, const unsigned int _vertexCount,
+    const int *_indices, const unsigned int _indexCount)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  uint64_t hash = 14695981039346656037ULL;
+  HashBytes(&kCacheVersion, sizeof(kCacheVersion), hash);
+  HashBytes(&this->maxHullCount, sizeof(this->maxHullCount), hash);
+  HashBytes(&this->maxHullVertexCount, sizeof(this->maxHullVertexCount),
+      hash);
+  HashBytes(&this->concavity, sizeof(this->concavity), hash);
+  HashBytes(_vertices, sizeof(_vertices[0]) * _vertexCount * 3, hash);
+  HashBytes(_indices, sizeof(_indices[0]) * _indexCount, hash);
+
+  auto iter = this->cache.find(hash);
+  if (iter != this->cache.end())
+    return iter->second;
+
+  ConvexHull_V &hulls = this->cache[hash];
+
+  std::string filename;
+  if (!this->cachePath.empty())
+  {
+    std::ostringstream stream;
+    stream << this->cachePath << "/" << std::hex << std::setw(16)
+           << std::setfill('0') << hash << ".hulls";
+    filename = stream.str();
+    if (Read(filename, hulls))
+      return hulls;
+  }
+
+  std::vector<ignition::math::Vector3d> points(_vertexCount);
+  for (unsigned int i = 0; i < _vertexCount; ++i)
+  {
+    points[i].Set(_vertices[i*3], _vertices[i*3+1], _vertices[i*3+2]);
+  }
+
+  std::vector<unsigned int> indices;
+  indices.reserve(_indexCount);
+  for (unsigned int i = 0; i + 2 < _indexCount; i += 3)
+  {
+    bool valid = true;
+    for (unsigned int e = 0; e < 3; ++e)
+    {
+      valid = valid && _indices[i+e] >= 0 &&
+          static_cast<unsigned int>(_indices[i+e]) < _vertexCount;
+    }
+    if (!valid)
+      continue;
+    for (unsigned int e = 0; e < 3; ++e)
+      indices.push_back(static_cast<unsigned int>(_indices[i+e]));
+  }
+
+  this->Compute(points, indices, hulls);
+
+  if (!filename.empty() && !hulls.empty())
+    Write(filename, hulls);
+
+  return hulls;
+}
+
+//////////////////////////////////////////////////
+bool ConvexDecompositionPrivate::Read(const std::string &_filename,
+    ConvexHull_V &_hulls)
+{
+  std::ifstream file(_filename);
+  if (!file)
+    return false;
+
+  std::string magic;
+  uint64_t version = 0;
+  size_t hullCount = 0;
+  file >> magic >> version >> hullCount;
+  if (!file || magic != "gazebo_convex_decomposition" ||
+      version != kCacheVersion)
+  {
+    return false;
+  }
+
+  _hulls.resize(hullCount);
+  for (auto &hull : _hulls)
+  {
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    file >> vertexCount >> indexCount;
+    if (!file)
+      break;
+    hull.vertices.resize(vertexCount);
+    hull.indices.resize(indexCount);
+    for (auto &v : hull.vertices)
+    {
+      double x, y, z;
+      file >> x >> y >> z;
+      v.Set(x, y, z);
+    }
+    for (auto &i : hull.indices)
+    {
+      file >> i;
+      if (i >= vertexCount)
+        file.setstate(std::ios::failbit);
+    }
+  }
+
+  if (!file)
+  {
+    gzwarn << "Ignoring invalid convex decomposition cache file ["
+           << _filename << "]" << std::endl;
+    _hulls.clear();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ConvexDecompositionPrivate::Write(const std::string &_filename,
+    const ConvexHull_V &_hulls)
+{
+  // Write to a temporary file first, other processes may read the cache
+  const std::string tmpFilename = _filename + ".tmp";
+  {
+    std::ofstream file(tmpFilename);
+    if (!file)
+    {
+      gzwarn << "Unable to write convex decomposition cache file ["
+             << _filename << "]" << std::endl;
+      return;
+    }
+
+    file << "gazebo_convex_decomposition " << kCacheVersion << " "
+         << _hulls.size() << "\n";
+    file << std::setprecision(17);
+    for (const auto &hull : _hulls)
+    {
+      file << hull.vertices.size() << " " << hull.indices.size() << "\n";
+      for (const auto &v : hull.vertices)
+        file << v.X() << " " << v.Y() << " " << v.Z() << "\n";
+      for (size_t i = 0; i < hull.indices.size(); ++i)
+        file << hull.indices[i] << ((i % 3 == 2) ? "\n" : " ");
+    }
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpFilename, _filename, ec);
+  if (ec)
+    boost::filesystem::remove(tmpFilename, ec);
+}
+
+//////////////////////////////////////////////////
+ConvexDecomposition::ConvexDecomposition()
+  : dataPtr(new ConvexDecompositionPrivate)
+{
+  this->SetCachePath(
+      SystemPaths::Instance()->GetLogPath() + "/convex_decomposition");
+}
+
+//////////////////////////////////////////////////
+ConvexDecomposition::~ConvexDecomposition()
+{
+}
+
+//////////////////////////////////////////////////
+const ConvexHull_V &ConvexDecomposition::Decompose(const Mesh *_mesh)
+{
+  static const ConvexHull_V empty;
+  if (!_mesh)
+    return empty;
+
+  float *vertices = nullptr;
+  int *indices = nullptr;
+  _mesh->FillArrays(&vertices, &indices);
+  const ConvexHull_V &hulls = this->dataPtr->Decompose(vertices,
+      _mesh->GetVertexCount(), indices, _mesh->GetIndexCount());
+  delete [] vertices;
+  delete [] indices;
+  return hulls;
+}
+
+//////////////////////////////////////////////////
+const ConvexHull_V &ConvexDecomposition::Decompose(const SubMesh *_subMesh)
+{
+  static const ConvexHull_V empty;
+  if (!_subMesh)
+    return empty;
+
+  float *vertices = nullptr;
+  int *indices = nullptr;
+  _subMesh->FillArrays(&vertices, &indices);
+  const ConvexHull_V &hulls = this->dataPtr->Decompose(vertices,
+      _subMesh->GetVertexCount(), indices, _subMesh->GetIndexCount());
+  delete [] vertices;
+  delete [] indices;
+  return hulls;
+}
+
+//////////////////////////////////////////////////
+void ConvexDecomposition::SetMaxHullCount(const unsigned int _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxHullCount = std::max(1u, _count);
+}
+
+//////////////////////////////////////////////////
+unsigned int ConvexDecomposition::MaxHullCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxHullCount;
+}
+
+//////////////////////////////////////////////////
+void ConvexDecomposition::SetMaxHullVertexCount(const unsigned int _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxHullVertexCount = std::max(4u, _count);
+}
+
+//////////////////////////////////////////////////
+unsigned int ConvexDecomposition::MaxHullVertexCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxHullVertexCount;
+}
+
+//////////////////////////////////////////////////
+void ConvexDecomposition::SetConcavity(const double _concavity)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->concavity = std::max(0.0, _concavity);
+}
+
+//////////////////////////////////////////////////
+double ConvexDecomposition::Concavity() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->concavity;
+}
+
+//////////////////////////////////////////////////
+void ConvexDecomposition::SetCachePath(const std::string &_path)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->cachePath = _path;
+  if (_path.empty())
+    return;
+
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(_path, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to create convex decomposition cache directory ["
+           << _path << "], the disk cache is disabled" << std::endl;
+    this->dataPtr->cachePath.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+std::string ConvexDecomposition::CachePath() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cachePath;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_CONVEXDECOMPOSITION_HH_
+#define GAZEBO_COMMON_CONVEXDECOMPOSITION_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+/// \brief Explicit instantiation for typed SingletonT.
+GZ_SINGLETON_DECLARE(GZ_COMMON_VISIBLE, gazebo, common, ConvexDecomposition)
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declarations.
+    class ConvexDecompositionPrivate;
+    class Mesh;
+    class SubMesh;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class ConvexHull ConvexDecomposition.hh common/common.hh
+    /// \brief Convex polyhedron with triangle faces.
+    class GZ_COMMON_VISIBLE ConvexHull
+    {
+      /// \brief Build the convex hull of a set of points.
+      /// \param[in] _points The points.
+      /// \return False if there are less than four points that are not
+      /// coplanar, in which case the hull is left empty.
+      public: bool Build(const std::vector<ignition::math::Vector3d> &_points);
+
+      /// \brief Get the volume of the hull.
+      /// \return The volume.
+      public: double Volume() const;
+
+      /// \brief Get the depth of a point inside the hull.
+      /// \param[in] _point The point.
+      /// \return Distance from the point to the closest face plane,
+      /// negative if the point is outside.
+      public: double Depth(const ignition::math::Vector3d &_point) const;
+
+      /// \brief Vertices of the hull.
+      public: std::vector<ignition::math::Vector3d> vertices;
+
+      /// \brief Vertex indices of the triangles, three per triangle,
+      /// counter clockwise when seen from outside of the hull.
+      public: std::vector<unsigned int> indices;
+    };
+
+    /// \def ConvexHull_V
+    /// \brief Vector of convex hulls.
+    typedef std::vector<ConvexHull> ConvexHull_V;
+
+    /// \class ConvexDecomposition ConvexDecomposition.hh common/common.hh
+    /// \brief Approximate convex decomposition of collision meshes.
+    ///
+    /// The triangles of a mesh are split recursively by axis aligned planes
+    /// until the vertices of each part are no deeper than the concavity
+    /// tolerance inside the convex hull of that part, or the maximum number
+    /// of hulls is reached. Each triangle belongs to exactly one part, so
+    /// the hulls cover the whole surface of the mesh.
+    ///
+    /// Decompositions are computed on unscaled vertices, since the hull of
+    /// scaled points is the scaled hull. They are cached in memory, and on
+    /// disk in CachePath(), indexed by a hash of the mesh data and of the
+    /// decomposition parameters.
+    class GZ_COMMON_VISIBLE ConvexDecomposition
+      : public SingletonT<ConvexDecomposition>
+    {
+      /// \brief Constructor.
+      private: ConvexDecomposition();
+
+      /// \brief Destructor.
+      private: virtual ~ConvexDecomposition();
+
+      /// \brief Decompose a mesh.
+      /// \param[in] _mesh The mesh, all its submeshes are decomposed
+      /// together.
+      /// \return The convex hulls, owned by the decomposition cache. Empty
+      /// if the mesh has no volume.
+      public: const ConvexHull_V &Decompose(const Mesh *_mesh);
+
+      /// \brief Decompose a submesh.
+      /// \param[in] _subMesh The submesh.
+      /// \return The convex hulls, owned by the decomposition cache. Empty
+      /// if the submesh has no volume.
+      public: const ConvexHull_V &Decompose(const SubMesh *_subMesh);
+
+      /// \brief Set the maximum number of hulls of a decomposition.
+      /// \param[in] _count The maximum number of hulls, at least 1.
+      public: void SetMaxHullCount(const unsigned int _count);
+
+      /// \brief Get the maximum number of hulls of a decomposition.
+      /// \return The maximum number of hulls. Default is 16.
+      public: unsigned int MaxHullCount() const;
+
+      /// \brief Set the maximum number of vertices of a hull. Larger hulls
+      /// are simplified.
+      /// \param[in] _count The maximum number of vertices, at least 4.
+      public: void SetMaxHullVertexCount(const unsigned int _count);
+
+      /// \brief Get the maximum number of vertices of a hull.
+      /// \return The maximum number of vertices. Default is 64.
+      public: unsigned int MaxHullVertexCount() const;
+
+      /// \brief Set the concavity tolerance.
+      /// \param[in] _concavity Maximum depth of a vertex inside the hull of
+      /// its part, relative to the diagonal of the mesh bounding box.
+      public: void SetConcavity(const double _concavity);
+
+      /// \brief Get the concavity tolerance.
+      /// \return The concavity tolerance. Default is 0.01.
+      public: double Concavity() const;
+
+      /// \brief Set the directory of the disk cache.
+      /// \param[in] _path The directory, created if needed. An empty path
+      /// disables the disk cache.
+      public: void SetCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the disk cache.
+      /// \return The directory. Default is convex_decomposition in the
+      /// gazebo log path, usually ~/.gazebo/convex_decomposition.
+      public: std::string CachePath() const;
+
+      /// \brief Singleton implementation
+      private: friend class SingletonT<ConvexDecomposition>;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<ConvexDecompositionPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/ConvexDecomposition.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ConvexDecomposition : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecomposition, Hull)
+{
+  common::ConvexHull hull;
+
+  // Coplanar points
+  std::vector<ignition::math::Vector3d> points = {
+      {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}};
+  EXPECT_FALSE(hull.Build(points));
+  EXPECT_TRUE(hull.vertices.empty());
+
+  // Unit cube, with a point inside and a point on an edge
+  points.clear();
+  for (int i = 0; i < 8; ++i)
+    points.push_back(ignition::math::Vector3d(i & 1, (i >> 1) & 1, i >> 2));
+  points.push_back(ignition::math::Vector3d(0.5, 0.5, 0.5));
+  points.push_back(ignition::math::Vector3d(0.5, 0, 0));
+  EXPECT_TRUE(hull.Build(points));
+  EXPECT_EQ(8u, hull.vertices.size());
+  EXPECT_EQ(36u, hull.indices.size());
+  EXPECT_NEAR(1.0, hull.Volume(), 1e-9);
+  EXPECT_NEAR(0.5, hull.Depth(ignition::math::Vector3d(0.5, 0.5, 0.5)),
+      1e-9);
+  EXPECT_NEAR(-1.0, hull.Depth(ignition::math::Vector3d(2, 0.5, 0.5)),
+      1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecomposition, Decompose)
+{
+  auto decomposition = common::ConvexDecomposition::Instance();
+  const std::string cachePath = decomposition->CachePath();
+  decomposition->SetCachePath("");
+  EXPECT_TRUE(decomposition->CachePath().empty());
+
+  EXPECT_EQ(16u, decomposition->MaxHullCount());
+  EXPECT_EQ(64u, decomposition->MaxHullVertexCount());
+  EXPECT_DOUBLE_EQ(0.01, decomposition->Concavity());
+
+  EXPECT_TRUE(decomposition->Decompose(
+        static_cast<const common::Mesh *>(nullptr)).empty());
+
+  // A box is convex, a single hull is enough
+  common::MeshManager::Instance()->CreateBox("convex_decomposition_box",
+      ignition::math::Vector3d(1, 2, 3), ignition::math::Vector2d(1, 1));
+  const common::Mesh *box = common::MeshManager::Instance()->GetMesh(
+      "convex_decomposition_box");
+  ASSERT_NE(nullptr, box);
+  const common::ConvexHull_V &boxHulls = decomposition->Decompose(box);
+  ASSERT_EQ(1u, boxHulls.size());
+  EXPECT_EQ(8u, boxHulls[0].vertices.size());
+  EXPECT_NEAR(6.0, boxHulls[0].Volume(), 1e-6);
+
+  // Same mesh, same hulls
+  EXPECT_EQ(&boxHulls, &decomposition->Decompose(box));
+
+  // A tube is split, and the hulls don't fill its hole
+  common::MeshManager::Instance()->CreateTube("convex_decomposition_tube",
+      0.8f, 1.0f, 1.0f, 1, 32);
+  const common::Mesh *tube = common::MeshManager::Instance()->GetMesh(
+      "convex_decomposition_tube");
+  ASSERT_NE(nullptr, tube);
+  const common::ConvexHull_V &tubeHulls = decomposition->Decompose(tube);
+  EXPECT_GT(tubeHulls.size(), 1u);
+  EXPECT_LE(tubeHulls.size(), decomposition->MaxHullCount());
+  for (const auto &hull : tubeHulls)
+  {
+    EXPECT_LE(hull.vertices.size(), decomposition->MaxHullVertexCount());
+    EXPECT_LT(hull.Depth(ignition::math::Vector3d::Zero), 0.0);
+  }
+
+  // Other parameters give another decomposition
+  decomposition->SetMaxHullCount(1);
+  const common::ConvexHull_V &singleHull = decomposition->Decompose(tube);
+  EXPECT_NE(&tubeHulls, &singleHull);
+  ASSERT_EQ(1u, singleHull.size());
+  EXPECT_GT(singleHull[0].Depth(ignition::math::Vector3d::Zero), 0.0);
+  decomposition->SetMaxHullCount(16);
+
+  decomposition->SetCachePath(cachePath);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ConvexDecomposition, DiskCache)
+{
+  auto decomposition = common::ConvexDecomposition::Instance();
+  const std::string cachePath = decomposition->CachePath();
+
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_convex_%%%%%%");
+  decomposition->SetCachePath(path.string());
+  EXPECT_EQ(path.string(), decomposition->CachePath());
+  EXPECT_TRUE(boost::filesystem::is_directory(path));
+
+  // Parameters are part of the key, so this isn't in the memory cache yet
+  decomposition->SetConcavity(0.02);
+  common::MeshManager::Instance()->CreateTube("convex_decomposition_cache",
+      0.5f, 1.0f, 1.0f, 1, 16);
+  const common::Mesh *tube = common::MeshManager::Instance()->GetMesh(
+      "convex_decomposition_cache");
+  ASSERT_NE(nullptr, tube);
+  const common::ConvexHull_V &hulls = decomposition->Decompose(tube);
+  EXPECT_FALSE(hulls.empty());
+
+  unsigned int files = 0;
+  for (boost::filesystem::directory_iterator iter(path);
+       iter != boost::filesystem::directory_iterator(); ++iter)
+  {
+    EXPECT_EQ(".hulls", iter->path().extension().string());
+    ++files;
+  }
+  EXPECT_EQ(1u, files);
+
+  decomposition->SetConcavity(0.01);
+  decomposition->SetCachePath(cachePath);
+  boost::filesystem::remove_all(path);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
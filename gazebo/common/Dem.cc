@@ -16,6 +16,8 @@
 */
 
 #include <algorithm>
+#include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <gazebo/gazebo_config.h>
 
@@ -31,6 +33,7 @@
 #include "gazebo/common/Dem.hh"
 #include "gazebo/common/DemPrivate.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/HeightmapCache.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
 
 using namespace gazebo;
@@ -38,6 +41,73 @@ using namespace common;
 
 #ifdef HAVE_GDAL
 
+/// \brief Largest side of the grid used by GetElevation and FillHeightMap.
+/// Larger rasters are resampled to this side, which bounds the memory of
+/// the grid to 64 MB.
+static const unsigned int DEM_MAX_SIDE = 4097;
+
+//////////////////////////////////////////////////
+/// \brief Get the cache key of a tile.
+/// \param[in] _level Resolution level.
+/// \param[in] _x Column of the tile.
+/// \param[in] _y Row of the tile.
+/// \return The key.
+static uint64_t TileKey(const unsigned int _level, const unsigned int _x,
+    const unsigned int _y)
+{
+  return (static_cast<uint64_t>(_level) << 48) |
+         (static_cast<uint64_t>(_y) << 24) | _x;
+}
+
+//////////////////////////////////////////////////
+const std::vector<float> *DemPrivate::Tile(const unsigned int _level,
+    const unsigned int _x, const unsigned int _y)
+{
+  const uint64_t key = TileKey(_level, _x, _y);
+  auto iter = this->tiles.find(key);
+  if (iter != this->tiles.end())
+  {
+    this->lru.splice(this->lru.begin(), this->lru, iter->second.second);
+    return &iter->second.first;
+  }
+
+  // Raster window of the tile, clipped to the raster
+  const unsigned int cell = 1u << _level;
+  const uint64_t xOff = static_cast<uint64_t>(_x) * this->tileSize * cell;
+  const uint64_t yOff = static_cast<uint64_t>(_y) * this->tileSize * cell;
+  if (xOff >= this->rasterWidth || yOff >= this->rasterHeight)
+    return nullptr;
+  const unsigned int xSize = std::min<uint64_t>(
+      this->tileSize * static_cast<uint64_t>(cell), this->rasterWidth - xOff);
+  const unsigned int ySize = std::min<uint64_t>(
+      this->tileSize * static_cast<uint64_t>(cell), this->rasterHeight - yOff);
+
+  // GDAL decimates the window to the samples of the level, from the
+  // overviews if the raster has them
+  std::vector<float> heights(this->tileSize * this->tileSize,
+      this->minElevation);
+  if (this->band->RasterIO(GF_Read, xOff, yOff, xSize, ySize, &heights[0],
+        (xSize + cell - 1) / cell, (ySize + cell - 1) / cell, GDT_Float32,
+        sizeof(float), this->tileSize * sizeof(float)) != CE_None)
+  {
+    gzerr << "Unable to read DEM tile [" << _x << ", " << _y
+          << "] of level [" << _level << "]" << std::endl;
+    return nullptr;
+  }
+
+  while (this->tiles.size() >= this->cacheSize && !this->lru.empty())
+  {
+    this->tiles.erase(this->lru.back());
+    this->lru.pop_back();
+  }
+
+  this->lru.push_front(key);
+  auto &entry = this->tiles[key];
+  entry.first = std::move(heights);
+  entry.second = this->lru.begin();
+  return &entry.first;
+}
+
 //////////////////////////////////////////////////
 Dem::Dem()
   : dataPtr(new DemPrivate)
@@ -104,6 +174,9 @@ int Dem::Load(const std::string &_filename)
   // Raster width and height
   xSize = this->dataPtr->dataSet->GetRasterXSize();
   ySize = this->dataPtr->dataSet->GetRasterYSize();
+  this->dataPtr->rasterWidth = xSize;
+  this->dataPtr->rasterHeight = ySize;
+  this->UpdateLevelCount();
 
   // Corner coordinates
   upLeftX = 0.0;
@@ -137,9 +210,12 @@ int Dem::Load(const std::string &_filename)
   else
     width = ignition::math::roundUpPowerOfTwo(xSize) + 1;
 
-  this->dataPtr->side = std::max(width, height);
+  // Larger rasters are resampled to a bounded grid, and read at full
+  // resolution through the tiles
+  this->dataPtr->side = std::min(std::max(width, height), DEM_MAX_SIDE);
 
   // Preload the DEM's data
+  this->dataPtr->cacheSource.clear();
   if (this->LoadData() != 0)
     return -1;
 
@@ -260,6 +336,144 @@ double Dem::GetWorldHeight() const
   return this->dataPtr->worldHeight;
 }
 
+//////////////////////////////////////////////////
+unsigned int Dem::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+void Dem::SetTileSize(const unsigned int _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->tileSize = std::max(_size, 2u);
+  this->dataPtr->tiles.clear();
+  this->dataPtr->lru.clear();
+  this->UpdateLevelCount();
+}
+
+//////////////////////////////////////////////////
+void Dem::UpdateLevelCount()
+{
+  const unsigned int side =
+    std::max(this->dataPtr->rasterWidth, this->dataPtr->rasterHeight);
+  if (side == 0)
+  {
+    this->dataPtr->levelCount = 0;
+    return;
+  }
+
+  unsigned int level = 0;
+  while (((side + (1u << level) - 1) >> level) > this->dataPtr->tileSize)
+    ++level;
+  this->dataPtr->levelCount = level + 1;
+}
+
+//////////////////////////////////////////////////
+unsigned int Dem::LevelCount() const
+{
+  return this->dataPtr->levelCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int Dem::LevelWidth(const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levelCount)
+    return 0;
+  return (this->dataPtr->rasterWidth + (1u << _level) - 1) >> _level;
+}
+
+//////////////////////////////////////////////////
+unsigned int Dem::LevelHeight(const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levelCount)
+    return 0;
+  return (this->dataPtr->rasterHeight + (1u << _level) - 1) >> _level;
+}
+
+//////////////////////////////////////////////////
+bool Dem::Tile(const unsigned int _level, const unsigned int _x,
+    const unsigned int _y, std::vector<float> &_heights)
+{
+  if (_level >= this->dataPtr->levelCount)
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  const std::vector<float> *tile = this->dataPtr->Tile(_level, _x, _y);
+  if (!tile)
+    return false;
+
+  _heights = *tile;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Dem::Region(const unsigned int _level, const unsigned int _x,
+    const unsigned int _y, const unsigned int _width,
+    const unsigned int _height, std::vector<float> &_heights)
+{
+  if (_level >= this->dataPtr->levelCount || _width == 0 || _height == 0)
+    return false;
+
+  _heights.assign(static_cast<size_t>(_width) * _height,
+      this->dataPtr->minElevation);
+
+  // Part of the rectangle inside of the level
+  const unsigned int levelWidth = this->LevelWidth(_level);
+  const unsigned int levelHeight = this->LevelHeight(_level);
+  if (_x >= levelWidth || _y >= levelHeight)
+    return true;
+  const unsigned int endX = std::min<uint64_t>(
+      static_cast<uint64_t>(_x) + _width, levelWidth);
+  const unsigned int endY = std::min<uint64_t>(
+      static_cast<uint64_t>(_y) + _height, levelHeight);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  for (unsigned int ty = _y / tileSize; ty * tileSize < endY; ++ty)
+  {
+    for (unsigned int tx = _x / tileSize; tx * tileSize < endX; ++tx)
+    {
+      const std::vector<float> *tile = this->dataPtr->Tile(_level, tx, ty);
+      if (!tile)
+        return false;
+
+      // Overlap of the tile and the rectangle
+      const unsigned int x0 = std::max(_x, tx * tileSize);
+      const unsigned int x1 = std::min(endX, (tx + 1) * tileSize);
+      const unsigned int y0 = std::max(_y, ty * tileSize);
+      const unsigned int y1 = std::min(endY, (ty + 1) * tileSize);
+      for (unsigned int y = y0; y < y1; ++y)
+      {
+        std::copy(
+            tile->begin() + (y - ty * tileSize) * tileSize + x0 - tx * tileSize,
+            tile->begin() + (y - ty * tileSize) * tileSize + x1 - tx * tileSize,
+            _heights.begin() + static_cast<size_t>(y - _y) * _width + x0 - _x);
+      }
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Dem::SetTileCacheSize(const unsigned int _tiles)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->cacheSize = std::max(_tiles, 1u);
+  while (this->dataPtr->tiles.size() > this->dataPtr->cacheSize)
+  {
+    this->dataPtr->tiles.erase(this->dataPtr->lru.back());
+    this->dataPtr->lru.pop_back();
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int Dem::TileCacheSize() const
+{
+  return this->dataPtr->cacheSize;
+}
+
 //////////////////////////////////////////////////
 void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
     const ignition::math::Vector3d &_size,
@@ -272,56 +486,57 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
     return;
   }
 
-  // Resize the vector to match the size of the vertices.
-  _heights.resize(_vertSize * _vertSize);
-
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  // Large terrains are shared with the other processes through the cache.
+  // The samples were already resampled to the grid, which is hashed rather
+  // than the raster, that may be much larger.
+  std::string key;
+  if (_vertSize >= HeightmapCache::MinVertSize &&
+      !HeightmapCache::Path().empty())
   {
-    double yf = y / static_cast<double>(_subSampling);
-    unsigned int y1 = floor(yf);
-    unsigned int y2 = ceil(yf);
-    if (y2 >= this->dataPtr->side)
-      y2 = this->dataPtr->side - 1;
-    double dy = yf - y1;
-
-    for (unsigned int x = 0; x < _vertSize; ++x)
-    {
-      double xf = x / static_cast<double>(_subSampling);
-      unsigned int x1 = floor(xf);
-      unsigned int x2 = ceil(xf);
-      if (x2 >= this->dataPtr->side)
-        x2 = this->dataPtr->side - 1;
-      double dx = xf - x1;
-
-      double px1 = this->dataPtr->demData[y1 * this->dataPtr->side + x1];
-      double px2 = this->dataPtr->demData[y1 * this->dataPtr->side + x2];
-      float h1 = (px1 - ((px1 - px2) * dx));
-
-      double px3 = this->dataPtr->demData[y2 * this->dataPtr->side + x1];
-      double px4 = this->dataPtr->demData[y2 * this->dataPtr->side + x2];
-      float h2 = (px3 - ((px3 - px4) * dx));
-
-      float h = this->dataPtr->minElevation +
-          (h1 - ((h1 - h2) * dy) - this->dataPtr->minElevation) * _scale.Z();
-
-      // Invert pixel definition so 1=ground, 0=full height,
-      // if the terrain size has a negative z component
-      // this is mainly for backward compatibility
-      if (_size.Z() < 0)
-        h *= -1;
-
-      // Convert to minElevation if a NODATA value is found
-      if (_size.Z() >= 0 && h < this->dataPtr->minElevation)
-        h = this->dataPtr->minElevation;
-
-      // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
-    }
+    if (this->dataPtr->cacheSource.empty())
+      this->dataPtr->cacheSource = common::get_sha1(this->dataPtr->demData);
+
+    key = HeightmapCache::Key(this->dataPtr->cacheSource, _subSampling,
+        _vertSize, _size, _scale);
+    if (HeightmapCache::Load(key, _vertSize, _flipY, _heights))
+      return;
   }
+
+  const unsigned int side = this->dataPtr->side;
+  const float *demData = this->dataPtr->demData.data();
+  const double minElevation = this->dataPtr->minElevation;
+  const double scaleZ = _scale.Z();
+  const double sizeZ = _size.Z();
+
+  HeightmapData::Interpolate(side, side, _subSampling, _vertSize, _flipY,
+      [&](unsigned int _row, double *_values)
+      {
+        const float *samples = demData + static_cast<size_t>(_row) * side;
+        for (unsigned int x = 0; x < side; ++x)
+          _values[x] = samples[x];
+      },
+      [&](double *_values, unsigned int _count)
+      {
+        for (unsigned int x = 0; x < _count; ++x)
+        {
+          float h = minElevation + (_values[x] - minElevation) * scaleZ;
+
+          // Invert pixel definition so 1=ground, 0=full height,
+          // if the terrain size has a negative z component
+          // this is mainly for backward compatibility
+          if (sizeZ < 0)
+            h *= -1;
+
+          // Convert to minElevation if a NODATA value is found
+          if (sizeZ >= 0 && h < minElevation)
+            h = minElevation;
+
+          _values[x] = h;
+        }
+      }, _heights);
+
+  if (!key.empty())
+    HeightmapCache::Save(key, _vertSize, _flipY, _heights);
 }
 
 //////////////////////////////////////////////////
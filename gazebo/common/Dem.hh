@@ -78,7 +78,8 @@ namespace gazebo
       /// \brief Get the terrain's height. Due to the Ogre constrains, this
       /// value will be a power of two plus one. The value returned might be
       /// different that the original DEM height because GetData() adds the
-      /// padding if necessary.
+      /// padding if necessary. Rasters larger than 4097 pixels are resampled
+      /// to 4097, and read at full resolution through Tile() and Region().
       /// \return The terrain's height (points) satisfying the ogre constrains
       /// (squared terrain with a height value that must be a power of two plus
       /// one).
@@ -87,7 +88,8 @@ namespace gazebo
       /// \brief Get the terrain's width. Due to the Ogre constrains, this
       /// value will be a power of two plus one. The value returned might be
       /// different that the original DEM width because GetData() adds the
-      /// padding if necessary.
+      /// padding if necessary. Rasters larger than 4097 pixels are resampled
+      /// to 4097, and read at full resolution through Tile() and Region().
       /// \return The terrain's width (points) satisfying the ogre constrains
       /// (squared terrain with a width value that must be a power of two plus
       /// one).
@@ -118,6 +120,72 @@ namespace gazebo
                   const bool _flipY,
                   std::vector<float> &_heights);
 
+      /// \brief Get the number of samples along each side of a tile.
+      /// \return Tile size. Default is 256.
+      public: unsigned int TileSize() const;
+
+      /// \brief Set the number of samples along each side of a tile. This
+      /// drops the resident tiles, and updates the level count.
+      /// \param[in] _size Tile size, at least 2.
+      public: void SetTileSize(const unsigned int _size);
+
+      /// \brief Get the number of resolution levels of the tiles. Level 0
+      /// has the resolution of the raster, and each next level halves it,
+      /// up to a level that fits in a single tile.
+      /// \return Number of levels, 0 before Load.
+      public: unsigned int LevelCount() const;
+
+      /// \brief Get the number of samples along each row of a level.
+      /// \param[in] _level Resolution level.
+      /// \return Number of samples, 0 if the level doesn't exist.
+      public: unsigned int LevelWidth(const unsigned int _level) const;
+
+      /// \brief Get the number of samples along each column of a level.
+      /// \param[in] _level Resolution level.
+      /// \return Number of samples, 0 if the level doesn't exist.
+      public: unsigned int LevelHeight(const unsigned int _level) const;
+
+      /// \brief Get a tile of elevations, read from the raster on demand.
+      /// Sample (i, j) of level L covers the raster pixels starting at
+      /// (i * 2^L, j * 2^L), and GDAL picks the overviews of the raster
+      /// when it has them. Tiles are kept in a least recently used cache.
+      /// This function is safe to call from several threads.
+      /// \param[in] _level Resolution level.
+      /// \param[in] _x Column of the tile.
+      /// \param[in] _y Row of the tile.
+      /// \param[out] _heights TileSize() * TileSize() elevations in meters,
+      /// row after row. Samples past the edge of the raster get the minimum
+      /// elevation.
+      /// \return False if the tile is outside of the level, or couldn't
+      /// be read.
+      public: bool Tile(const unsigned int _level, const unsigned int _x,
+                  const unsigned int _y, std::vector<float> &_heights);
+
+      /// \brief Get a rectangle of elevations of a level, assembled from the
+      /// tiles covering it. This is how the terrain around a point of
+      /// interest is read at full resolution, without loading the rest of
+      /// the raster.
+      /// \param[in] _level Resolution level.
+      /// \param[in] _x First column.
+      /// \param[in] _y First row.
+      /// \param[in] _width Number of columns.
+      /// \param[in] _height Number of rows.
+      /// \param[out] _heights _width * _height elevations in meters, row
+      /// after row. Samples outside of the level get the minimum elevation.
+      /// \return False if the level doesn't exist, the rectangle is empty,
+      /// or a tile couldn't be read.
+      public: bool Region(const unsigned int _level, const unsigned int _x,
+                  const unsigned int _y, const unsigned int _width,
+                  const unsigned int _height, std::vector<float> &_heights);
+
+      /// \brief Set the maximum number of resident tiles.
+      /// \param[in] _tiles Number of tiles, at least 1.
+      public: void SetTileCacheSize(const unsigned int _tiles);
+
+      /// \brief Get the maximum number of resident tiles.
+      /// \return Number of tiles. Default is 64.
+      public: unsigned int TileCacheSize() const;
+
       /// \brief Get the georeferenced coordinates (lat, long) of a terrain's
       /// pixel in WGS84.
       /// \param[in] _x X coordinate of the terrain.
@@ -128,6 +196,9 @@ namespace gazebo
                                     ignition::math::Angle &_latitude,
                                     ignition::math::Angle &_longitude) const;
 
+      /// \brief Update the number of resolution levels of the tiles.
+      private: void UpdateLevelCount();
+
       /// \brief Get the terrain file as a data array. Due to the Ogre
       /// constrains, the data might be stored in a bigger vector representing
       /// a squared terrain with padding.
@@ -23,6 +23,12 @@
 
 #ifdef HAVE_GDAL
 # include <gdal_priv.h>
+# include <cstdint>
+# include <list>
+# include <mutex>
+# include <string>
+# include <unordered_map>
+# include <utility>
 # include <vector>
 
 namespace gazebo
@@ -36,6 +42,15 @@ namespace gazebo
     /// \brief Private data for the Dem class.
     class GZ_COMMON_VISIBLE DemPrivate
     {
+      /// \brief Get a resident tile, reading it from the raster if needed.
+      /// Must be called with the cache mutex locked.
+      /// \param[in] _level Resolution level.
+      /// \param[in] _x Column of the tile.
+      /// \param[in] _y Row of the tile.
+      /// \return The samples of the tile, null if they couldn't be read.
+      public: const std::vector<float> *Tile(const unsigned int _level,
+                  const unsigned int _x, const unsigned int _y);
+
       /// \brief A set of associated raster bands.
       public: GDALDataset *dataSet;
 
@@ -59,6 +74,35 @@ namespace gazebo
 
       /// \brief DEM data converted to be OGRE-compatible.
       public: std::vector<float> demData;
+
+      /// \brief Width of the raster in pixels.
+      public: unsigned int rasterWidth = 0;
+
+      /// \brief Height of the raster in pixels.
+      public: unsigned int rasterHeight = 0;
+
+      /// \brief Number of samples along each side of a tile.
+      public: unsigned int tileSize = 256;
+
+      /// \brief Number of resolution levels of the tiles.
+      public: unsigned int levelCount = 0;
+
+      /// \brief Maximum number of resident tiles.
+      public: unsigned int cacheSize = 64;
+
+      /// \brief Resident tiles, the most recently used first.
+      public: std::list<uint64_t> lru;
+
+      /// \brief Resident tiles and their position in the lru list.
+      public: std::unordered_map<uint64_t, std::pair<std::vector<float>,
+              std::list<uint64_t>::iterator>> tiles;
+
+      /// \brief Protects the tile cache and the raster reads.
+      public: std::mutex cacheMutex;
+
+      /// \brief Hash of demData, see HeightmapCache. Empty until first
+      /// needed.
+      public: std::string cacheSource;
     };
     /// \}
   }
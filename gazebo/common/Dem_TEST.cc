@@ -167,6 +167,85 @@ TEST_F(DemTest, FillHeightmap)
   EXPECT_FLOAT_EQ(213.42966, elevations.at(elevations.size() / 2));
 }
 
+/////////////////////////////////////////////////
+TEST_F(DemTest, Tiles)
+{
+  common::Dem dem;
+  boost::filesystem::path path = TEST_PATH;
+
+  path /= "data/dem_squared.tif";
+  EXPECT_EQ(dem.Load(path.string()), 0);
+
+  EXPECT_EQ(256u, dem.TileSize());
+  EXPECT_EQ(1u, dem.LevelCount());
+  EXPECT_EQ(64u, dem.TileCacheSize());
+
+  // 129 samples at level 0, 65 at level 1, 33 at level 2, 17 at level 3
+  dem.SetTileSize(32);
+  EXPECT_EQ(32u, dem.TileSize());
+  EXPECT_EQ(4u, dem.LevelCount());
+  EXPECT_EQ(129u, dem.LevelWidth(0));
+  EXPECT_EQ(129u, dem.LevelHeight(0));
+  EXPECT_EQ(65u, dem.LevelWidth(1));
+  EXPECT_EQ(17u, dem.LevelHeight(3));
+  EXPECT_EQ(0u, dem.LevelWidth(4));
+
+  // Level 0 has the resolution of the raster
+  std::vector<float> tile;
+  EXPECT_TRUE(dem.Tile(0, 1, 2, tile));
+  ASSERT_EQ(32u * 32u, tile.size());
+  EXPECT_FLOAT_EQ(dem.GetElevation(32, 64), tile[0]);
+  EXPECT_FLOAT_EQ(dem.GetElevation(32 + 5, 64 + 7), tile[7 * 32 + 5]);
+
+  // Samples past the edge of the raster
+  EXPECT_TRUE(dem.Tile(0, 4, 4, tile));
+  EXPECT_FLOAT_EQ(dem.GetElevation(128, 128), tile[0]);
+  EXPECT_FLOAT_EQ(dem.GetMinElevation(), tile[1]);
+
+  // Tiles outside of the raster
+  EXPECT_FALSE(dem.Tile(0, 5, 0, tile));
+  EXPECT_FALSE(dem.Tile(4, 0, 0, tile));
+
+  // Coarser levels stay within the elevation range
+  EXPECT_TRUE(dem.Tile(3, 0, 0, tile));
+  for (unsigned int y = 0; y < 17; ++y)
+  {
+    for (unsigned int x = 0; x < 17; ++x)
+    {
+      EXPECT_LE(dem.GetMinElevation(), tile[y * 32 + x]);
+      EXPECT_GE(dem.GetMaxElevation(), tile[y * 32 + x]);
+    }
+  }
+
+  // A region across four tiles
+  std::vector<float> region;
+  EXPECT_TRUE(dem.Region(0, 20, 30, 40, 10, region));
+  ASSERT_EQ(400u, region.size());
+  for (unsigned int y = 0; y < 10; ++y)
+  {
+    for (unsigned int x = 0; x < 40; ++x)
+    {
+      EXPECT_FLOAT_EQ(dem.GetElevation(20 + x, 30 + y),
+          region[y * 40 + x]);
+    }
+  }
+
+  // A region partly outside of the raster
+  EXPECT_TRUE(dem.Region(0, 120, 0, 16, 1, region));
+  ASSERT_EQ(16u, region.size());
+  EXPECT_FLOAT_EQ(dem.GetElevation(128, 0), region[8]);
+  EXPECT_FLOAT_EQ(dem.GetMinElevation(), region[9]);
+
+  EXPECT_FALSE(dem.Region(0, 0, 0, 0, 1, region));
+  EXPECT_FALSE(dem.Region(4, 0, 0, 1, 1, region));
+
+  // A smaller cache still serves every tile
+  dem.SetTileCacheSize(1);
+  EXPECT_EQ(1u, dem.TileCacheSize());
+  EXPECT_TRUE(dem.Region(0, 20, 30, 40, 10, region));
+  EXPECT_FLOAT_EQ(dem.GetElevation(59, 39), region.back());
+}
+
 /////////////////////////////////////////////////
 TEST_F(DemTest, NegDem)
 {
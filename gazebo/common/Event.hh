@@ -27,9 +27,10 @@
 #include "gazebo/gazebo_config.h"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/PluginProfiler.hh"
 #include "gazebo/util/system.hh"
 
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
 
 namespace gazebo
 {
@@ -625,7 +626,9 @@ namespace gazebo
         auto const &iter = this->connections.rbegin();
         index = iter->first + 1;
       }
-      this->connections[index].reset(new EventConnection(true, _subscriber));
+      // Time the callbacks of plugins, see PluginProfiler
+      this->connections[index].reset(new EventConnection(true,
+            common::PluginProfiler::Wrap(_subscriber)));
       return ConnectionPtr(new Connection(this, index));
     }
 
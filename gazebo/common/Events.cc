@@ -31,6 +31,8 @@ EventT<void (std::string)> Events::addEntity;
 EventT<void (std::string)> Events::deleteEntity;
 
 EventT<void (const common::UpdateInfo &)> Events::worldUpdateBegin;
+ConcurrentEventT<void (const common::UpdateInfo &)>
+    Events::worldUpdateBeginConcurrent;
 EventT<void (const common::UpdateInfo &)> Events::beforePhysicsUpdate;
 
 EventT<void ()> Events::worldUpdateEnd;
@@ -22,6 +22,7 @@
 
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/UpdateInfo.hh"
+#include "gazebo/common/ConcurrentEvent.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/util/system.hh"
 
@@ -103,10 +104,18 @@ namespace gazebo
       //////////////////////////////////////////////////////////////////////////
       /// \brief Connect a callback to the world update start signal
       /// \param[in] _subscriber the subscriber to this event
+      /// \param[in] _concurrent True if the subscriber is safe to run at
+      /// the same time as other subscribers, on the task pool. Such
+      /// subscribers connect to worldUpdateBeginConcurrent.
       /// \return a connection
       public: template<typename T>
-              static ConnectionPtr ConnectWorldUpdateBegin(T _subscriber)
-              { return worldUpdateBegin.Connect(_subscriber); }
+              static ConnectionPtr ConnectWorldUpdateBegin(T _subscriber,
+                  const bool _concurrent = false)
+              {
+                if (_concurrent)
+                  return worldUpdateBeginConcurrent.Connect(_subscriber);
+                return worldUpdateBegin.Connect(_subscriber);
+              }
 
       //////////////////////////////////////////////////////////////////////////
       /// \brief Connect a callback to the before physics update signal
@@ -246,6 +255,11 @@ namespace gazebo
       /// \brief World update has started
       public: static EventT<void (const common::UpdateInfo &)> worldUpdateBegin;
 
+      /// \brief World update has started, for subscribers that run on the
+      /// task pool while the subscribers of worldUpdateBegin run in order.
+      public: static ConcurrentEventT<void (const common::UpdateInfo &)>
+                worldUpdateBeginConcurrent;
+
       /// \brief Collision detection has been done, physics update not yet
       public: static EventT<void (const common::UpdateInfo &)>
                 beforePhysicsUpdate;
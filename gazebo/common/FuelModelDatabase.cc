@@ -18,8 +18,12 @@
 #include <sys/stat.h>
 #include <tinyxml.h>
 
+#include <chrono>
 #include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -33,6 +37,7 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/FuelModelDatabase.hh"
+#include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/SemanticVersion.hh"
 #include "gazebo/common/SystemPaths.hh"
 
@@ -46,6 +51,15 @@ class gazebo::common::FuelModelDatabasePrivate
 {
   /// \brief A client to interact with Ignition Fuel.
   public: std::unique_ptr<ignition::fuel_tools::FuelClient> fuelClient;
+
+  /// \brief Local paths of the models queued on the download threads of
+  /// the ModelDatabase, by URI. They are waited for on destruction, since
+  /// the downloads use this database.
+  public: std::map<std::string, std::shared_future<std::string>>
+          pendingDownloads;
+
+  /// \brief Protects pendingDownloads.
+  public: std::mutex downloadMutex;
 };
 
 /////////////////////////////////////////////////
@@ -80,6 +94,14 @@ FuelModelDatabase::FuelModelDatabase()
 /////////////////////////////////////////////////
 FuelModelDatabase::~FuelModelDatabase()
 {
+  std::map<std::string, std::shared_future<std::string>> pending;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+    pending.swap(this->dataPtr->pendingDownloads);
+  }
+
+  for (auto &download : pending)
+    download.second.wait();
 }
 
 /////////////////////////////////////////////////
@@ -238,6 +260,50 @@ std::string FuelModelDatabase::ModelPath(const std::string &_uri,
   return path;
 }
 
+/////////////////////////////////////////////////
+std::shared_future<std::string> FuelModelDatabase::ModelPathAsync(
+    const std::string &_uri)
+{
+  // The download threads of the ModelDatabase share duplicate requests,
+  // and are joined by ModelDatabase::Fini.
+  std::shared_future<std::string> result =
+    ModelDatabase::Instance()->QueueDownload(_uri, [this, _uri]()
+      {
+        return this->ModelPath(_uri);
+      });
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+  for (auto iter = this->dataPtr->pendingDownloads.begin();
+       iter != this->dataPtr->pendingDownloads.end();)
+  {
+    // Forget the downloads that are done
+    if (iter->second.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready)
+    {
+      iter = this->dataPtr->pendingDownloads.erase(iter);
+    }
+    else
+      ++iter;
+  }
+  this->dataPtr->pendingDownloads[_uri] = result;
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> FuelModelDatabase::ModelPaths(
+    const std::vector<std::string> &_uris)
+{
+  std::vector<std::shared_future<std::string>> futures;
+  for (auto const &uri : _uris)
+    futures.push_back(this->ModelPathAsync(uri));
+
+  std::vector<std::string> paths;
+  for (auto &future : futures)
+    paths.push_back(future.get());
+  return paths;
+}
+
 /////////////////////////////////////////////////
 std::string FuelModelDatabase::CachedFilePath(const std::string &_uri)
 {
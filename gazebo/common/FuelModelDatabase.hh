@@ -18,6 +18,7 @@
 #define GAZEBO_COMMON_FUELMODELDATABASE_HH_
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -103,6 +104,23 @@ namespace gazebo
       public: std::string ModelPath(const std::string &_uri,
         const bool _forceDownload = false);
 
+      /// \brief Get the local path to a model without blocking. A model
+      /// that isn't cached is downloaded on the download threads of the
+      /// ModelDatabase, see ModelDatabase::QueueDownload, and a model
+      /// requested several times is downloaded once.
+      /// \param[in] _uri the model uri
+      /// \return Future local path to the model directory, empty if the
+      /// model couldn't be downloaded.
+      public: std::shared_future<std::string> ModelPathAsync(
+        const std::string &_uri);
+
+      /// \brief Get the local paths to several models, downloading the
+      /// models that aren't cached concurrently.
+      /// \param[in] _uris The model uris.
+      /// \return Local path to each model directory.
+      public: std::vector<std::string> ModelPaths(
+        const std::vector<std::string> &_uris);
+
       /// \brief Get the full local path to a cached file based on its URI.
       /// \param[in] _uri The file's URI
       /// \return Local path to the file
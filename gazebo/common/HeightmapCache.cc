@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/HeightmapCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+const unsigned int HeightmapCache::MinVertSize;
+
+/// \brief Magic string at the start of a heightmap cache file.
+static const char HEIGHTMAP_CACHE_MAGIC[8] = {'G', 'Z', 'H', 'M', 'A', 'P',
+  'C', '\0'};
+
+/// \brief Size of the header of a cache file, a multiple of the size of a
+/// height.
+static const size_t HEIGHTMAP_CACHE_HEADER = sizeof(HEIGHTMAP_CACHE_MAGIC) +
+  2 * sizeof(uint32_t);
+
+/// \brief Cache directory.
+class HeightmapCachePath
+{
+  /// \brief Constructor, reads the default directory.
+  public: HeightmapCachePath()
+  {
+    const char *cachePath = common::getEnv("GAZEBO_HEIGHTMAP_CACHE");
+    const char *homePath = common::getEnv("HOME");
+    if (cachePath)
+      this->path = cachePath;
+    else if (homePath)
+    {
+      this->path = (boost::filesystem::path(homePath) / ".gazebo" /
+          "heightmap_cache").string();
+    }
+  }
+
+  /// \brief The directory.
+  public: std::string path;
+
+  /// \brief Protects path.
+  public: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the cache directory.
+/// \return The directory.
+static HeightmapCachePath &CachePath()
+{
+  static HeightmapCachePath cachePath;
+  return cachePath;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the file of a cache key.
+/// \param[in] _path Cache directory.
+/// \param[in] _key Cache key.
+/// \return The file.
+static boost::filesystem::path CacheFile(const std::string &_path,
+    const std::string &_key)
+{
+  return boost::filesystem::path(_path) / (_key + ".heights");
+}
+
+//////////////////////////////////////////////////
+void HeightmapCache::SetPath(const std::string &_path)
+{
+  HeightmapCachePath &cachePath = CachePath();
+  std::lock_guard<std::mutex> lock(cachePath.mutex);
+  cachePath.path = _path;
+}
+
+//////////////////////////////////////////////////
+std::string HeightmapCache::Path()
+{
+  HeightmapCachePath &cachePath = CachePath();
+  std::lock_guard<std::mutex> lock(cachePath.mutex);
+  return cachePath.path;
+}
+
+//////////////////////////////////////////////////
+std::string HeightmapCache::Key(const std::string &_source,
+    const int _subSampling, const unsigned int _vertSize,
+    const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale)
+{
+  const uint32_t version = GZ_HEIGHTMAP_CACHE_VERSION;
+  const int32_t subSampling = _subSampling;
+  const uint32_t vertSize = _vertSize;
+  const double sizeZ = _size.Z();
+  const double scaleZ = _scale.Z();
+
+  std::string content = _source;
+  content += '\0';
+  content.append(reinterpret_cast<const char *>(&version), sizeof(version));
+  content.append(reinterpret_cast<const char *>(&subSampling),
+      sizeof(subSampling));
+  content.append(reinterpret_cast<const char *>(&vertSize), sizeof(vertSize));
+  content.append(reinterpret_cast<const char *>(&sizeZ), sizeof(sizeZ));
+  content.append(reinterpret_cast<const char *>(&scaleZ), sizeof(scaleZ));
+  return common::get_sha1<std::string>(content);
+}
+
+//////////////////////////////////////////////////
+bool HeightmapCache::Load(const std::string &_key,
+    const unsigned int _vertSize, const bool _flipY,
+    std::vector<float> &_heights)
+{
+  const std::string path = Path();
+  if (path.empty() || _key.empty())
+    return false;
+
+  const boost::filesystem::path filename = CacheFile(path, _key);
+  const size_t count = static_cast<size_t>(_vertSize) * _vertSize;
+
+  boost::system::error_code errorCode;
+  if (!boost::filesystem::exists(filename, errorCode) ||
+      boost::filesystem::file_size(filename, errorCode) !=
+      HEIGHTMAP_CACHE_HEADER + count * sizeof(float) || errorCode)
+  {
+    return false;
+  }
+
+  boost::iostreams::mapped_file_source file;
+  try
+  {
+    file.open(filename.string());
+  }
+  catch(std::exception &_e)
+  {
+    gzwarn << "Unable to map heightmap cache file[" << filename.string()
+           << "]: " << _e.what() << std::endl;
+    return false;
+  }
+
+  uint32_t version = 0;
+  uint32_t vertSize = 0;
+  const char *data = file.data();
+  std::memcpy(&version, data + sizeof(HEIGHTMAP_CACHE_MAGIC),
+      sizeof(version));
+  std::memcpy(&vertSize, data + sizeof(HEIGHTMAP_CACHE_MAGIC) +
+      sizeof(version), sizeof(vertSize));
+  if (std::memcmp(data, HEIGHTMAP_CACHE_MAGIC,
+        sizeof(HEIGHTMAP_CACHE_MAGIC)) != 0 ||
+      version != GZ_HEIGHTMAP_CACHE_VERSION || vertSize != _vertSize)
+  {
+    return false;
+  }
+
+  _heights.resize(count);
+  const char *heights = data + HEIGHTMAP_CACHE_HEADER;
+  const size_t rowBytes = _vertSize * sizeof(float);
+  for (unsigned int y = 0; y < _vertSize; ++y)
+  {
+    const unsigned int row = _flipY ? _vertSize - y - 1 : y;
+    std::memcpy(&_heights[static_cast<size_t>(row) * _vertSize],
+        heights + y * rowBytes, rowBytes);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapCache::Save(const std::string &_key,
+    const unsigned int _vertSize, const bool _flipY,
+    const std::vector<float> &_heights)
+{
+  const std::string path = Path();
+  const size_t count = static_cast<size_t>(_vertSize) * _vertSize;
+  if (path.empty() || _key.empty() || _heights.size() != count)
+    return false;
+
+  boost::system::error_code errorCode;
+  boost::filesystem::create_directories(path, errorCode);
+  if (errorCode)
+  {
+    gzwarn << "Unable to create heightmap cache directory[" << path << "]\n";
+    return false;
+  }
+
+  // Write to a temporary file first, so that other processes never map a
+  // partial file.
+  const boost::filesystem::path filename = CacheFile(path, _key);
+  const boost::filesystem::path tmp = filename.string() + "." +
+    boost::filesystem::unique_path("%%%%%%%%").string();
+
+  {
+    std::ofstream out(tmp.string(), std::ios::binary);
+    const uint32_t version = GZ_HEIGHTMAP_CACHE_VERSION;
+    const uint32_t vertSize = _vertSize;
+    out.write(HEIGHTMAP_CACHE_MAGIC, sizeof(HEIGHTMAP_CACHE_MAGIC));
+    out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char *>(&vertSize), sizeof(vertSize));
+    for (unsigned int y = 0; y < _vertSize && out; ++y)
+    {
+      const unsigned int row = _flipY ? _vertSize - y - 1 : y;
+      out.write(reinterpret_cast<const char *>(
+            &_heights[static_cast<size_t>(row) * _vertSize]),
+          _vertSize * sizeof(float));
+    }
+
+    if (!out)
+    {
+      gzwarn << "Unable to write heightmap cache file[" << tmp.string()
+             << "]\n";
+      out.close();
+      boost::filesystem::remove(tmp, errorCode);
+      return false;
+    }
+  }
+
+  boost::filesystem::rename(tmp, filename, errorCode);
+  if (errorCode)
+  {
+    boost::filesystem::remove(tmp, errorCode);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_HEIGHTMAPCACHE_HH_
+#define GAZEBO_COMMON_HEIGHTMAPCACHE_HH_
+
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+/// \brief Version of the heightmap cache file layout. Cache files of other
+/// versions are ignored, and replaced when the heights are computed again.
+#define GZ_HEIGHTMAP_CACHE_VERSION 1
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class HeightmapCache HeightmapCache.hh common/common.hh
+    /// \brief Functions to store the heights interpolated by
+    /// HeightmapData::FillHeightMap in binary files, so that gzserver and
+    /// gzclient, which both interpolate the same terrain, compute it once.
+    ///
+    /// A cache file starts with a magic string, the
+    /// GZ_HEIGHTMAP_CACHE_VERSION and the number of vertices per row,
+    /// followed by the heights, row by row, as if _flipY was false. Cache
+    /// files are named by a hash of the source samples and of the
+    /// parameters that change the heights, so they are shared by callers
+    /// which only differ in _flipY.
+    ///
+    /// Only terrains of at least MinVertSize vertices per row are cached,
+    /// smaller ones are faster to interpolate than to read back.
+    class GZ_COMMON_VISIBLE HeightmapCache
+    {
+      /// \brief Smallest number of vertices per row of a cached terrain.
+      public: static const unsigned int MinVertSize = 1025;
+
+      /// \brief Set the cache directory. Defaults to the
+      /// GAZEBO_HEIGHTMAP_CACHE environment variable if set, else to
+      /// ~/.gazebo/heightmap_cache.
+      /// \param[in] _path Cache directory, empty to disable the cache.
+      public: static void SetPath(const std::string &_path);
+
+      /// \brief Get the cache directory.
+      /// \return Cache directory, empty if the cache is disabled.
+      public: static std::string Path();
+
+      /// \brief Get the cache key of interpolated heights.
+      /// \param[in] _source Hash of the source samples, see
+      /// common::get_sha1.
+      /// \param[in] _subSampling Subsampling of FillHeightMap.
+      /// \param[in] _vertSize Number of vertices per row.
+      /// \param[in] _size Size of the terrain, only Z changes the heights.
+      /// \param[in] _scale Scale of the heights, only Z changes them.
+      /// \return The key.
+      public: static std::string Key(const std::string &_source,
+                  const int _subSampling, const unsigned int _vertSize,
+                  const ignition::math::Vector3d &_size,
+                  const ignition::math::Vector3d &_scale);
+
+      /// \brief Load heights from the cache.
+      /// \param[in] _key Cache key, see Key.
+      /// \param[in] _vertSize Number of vertices per row.
+      /// \param[in] _flipY True to flip the rows, as FillHeightMap does.
+      /// \param[out] _heights Heights, resized to _vertSize * _vertSize.
+      /// \return False if the heights are not in the cache.
+      public: static bool Load(const std::string &_key,
+                  const unsigned int _vertSize, const bool _flipY,
+                  std::vector<float> &_heights);
+
+      /// \brief Save heights to the cache, creating its directory if needed.
+      /// \param[in] _key Cache key, see Key.
+      /// \param[in] _vertSize Number of vertices per row.
+      /// \param[in] _flipY True if the rows of _heights are flipped.
+      /// \param[in] _heights Heights to save.
+      /// \return True if the heights were saved.
+      public: static bool Save(const std::string &_key,
+                  const unsigned int _vertSize, const bool _flipY,
+                  const std::vector<float> &_heights);
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/HeightmapCache.hh"
+#include "gazebo/common/ImageHeightmap.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class HeightmapCache : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapCache, SaveLoad)
+{
+  const std::string cachePath = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_heightmap_cache_%%%%")).string();
+  const std::string oldPath = common::HeightmapCache::Path();
+  common::HeightmapCache::SetPath(cachePath);
+  EXPECT_EQ(cachePath, common::HeightmapCache::Path());
+
+  const ignition::math::Vector3d size(10, 10, 5);
+  const ignition::math::Vector3d scale(1, 1, 2);
+  const std::string key =
+    common::HeightmapCache::Key("source", 2, 3, size, scale);
+  EXPECT_EQ(key, common::HeightmapCache::Key("source", 2, 3, size, scale));
+  EXPECT_NE(key, common::HeightmapCache::Key("other", 2, 3, size, scale));
+  EXPECT_NE(key, common::HeightmapCache::Key("source", 1, 3, size, scale));
+  EXPECT_NE(key, common::HeightmapCache::Key("source", 2, 3, size,
+        ignition::math::Vector3d(1, 1, 3)));
+
+  // Only Z changes the heights
+  EXPECT_EQ(key, common::HeightmapCache::Key("source", 2, 3,
+        ignition::math::Vector3d(20, 30, 5), scale));
+
+  // Nothing cached yet
+  std::vector<float> heights;
+  EXPECT_FALSE(common::HeightmapCache::Load(key, 3, false, heights));
+
+  const std::vector<float> rows = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_FALSE(common::HeightmapCache::Save(key, 2, false, rows));
+  EXPECT_TRUE(common::HeightmapCache::Save(key, 3, false, rows));
+
+  EXPECT_TRUE(common::HeightmapCache::Load(key, 3, false, heights));
+  EXPECT_EQ(rows, heights);
+
+  // Rows are flipped on load
+  const std::vector<float> flipped = {6, 7, 8, 3, 4, 5, 0, 1, 2};
+  EXPECT_TRUE(common::HeightmapCache::Load(key, 3, true, heights));
+  EXPECT_EQ(flipped, heights);
+
+  // Size mismatch
+  EXPECT_FALSE(common::HeightmapCache::Load(key, 4, false, heights));
+
+  // Saved flipped, stored in the same order
+  EXPECT_TRUE(common::HeightmapCache::Save(key, 3, true, flipped));
+  EXPECT_TRUE(common::HeightmapCache::Load(key, 3, false, heights));
+  EXPECT_EQ(rows, heights);
+
+  // Disabled
+  common::HeightmapCache::SetPath("");
+  EXPECT_FALSE(common::HeightmapCache::Load(key, 3, false, heights));
+  EXPECT_FALSE(common::HeightmapCache::Save(key, 3, false, rows));
+
+  common::HeightmapCache::SetPath(oldPath);
+  boost::system::error_code errorCode;
+  boost::filesystem::remove_all(cachePath, errorCode);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapCache, FillHeightMap)
+{
+  const std::string cachePath = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_heightmap_cache_%%%%")).string();
+  const std::string oldPath = common::HeightmapCache::Path();
+
+  common::ImageHeightmap img;
+  ASSERT_EQ(0, img.Load("file://media/materials/textures/heightmap_bowl.png"));
+
+  // Large enough to be cached
+  const int subSampling = 8;
+  const unsigned int vertSize = (img.GetWidth() - 1) * subSampling + 1;
+  ASSERT_GE(vertSize, common::HeightmapCache::MinVertSize);
+  const ignition::math::Vector3d size(129, 129, 10);
+  const ignition::math::Vector3d scale(1, 1, 10);
+
+  common::HeightmapCache::SetPath("");
+  std::vector<float> expected;
+  img.FillHeightMap(subSampling, vertSize, size, scale, false, expected);
+  std::vector<float> expectedFlipped;
+  img.FillHeightMap(subSampling, vertSize, size, scale, true,
+      expectedFlipped);
+  ASSERT_EQ(vertSize * vertSize, expected.size());
+
+  // Computed then saved, then loaded by another heightmap
+  common::HeightmapCache::SetPath(cachePath);
+  std::vector<float> heights;
+  img.FillHeightMap(subSampling, vertSize, size, scale, false, heights);
+  EXPECT_EQ(expected, heights);
+  EXPECT_TRUE(boost::filesystem::exists(cachePath));
+
+  common::ImageHeightmap other;
+  ASSERT_EQ(0,
+      other.Load("file://media/materials/textures/heightmap_bowl.png"));
+  other.FillHeightMap(subSampling, vertSize, size, scale, true, heights);
+  EXPECT_EQ(expectedFlipped, heights);
+
+  common::HeightmapCache::SetPath(oldPath);
+  boost::system::error_code errorCode;
+  boost::filesystem::remove_all(cachePath, errorCode);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
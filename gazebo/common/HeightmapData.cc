@@ -15,6 +15,12 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
 #include <gazebo/gazebo_config.h>
 
 #ifdef HAVE_GDAL
@@ -34,6 +40,122 @@
 using namespace gazebo;
 using namespace common;
 
+/// \brief Number of rows interpolated by a thread at a time.
+static const unsigned int INTERPOLATE_BLOCK_ROWS = 32;
+
+/// \brief Grids with fewer points per row are interpolated on the calling
+/// thread.
+static const unsigned int PARALLEL_INTERPOLATE_SIZE = 512;
+
+//////////////////////////////////////////////////
+void HeightmapData::Interpolate(const unsigned int _width,
+    const unsigned int _height, const int _subSampling,
+    const unsigned int _vertSize, const bool _flipY,
+    const std::function<void(unsigned int _row, double *_values)> &_readRow,
+    const std::function<void(double *_values, unsigned int _count)>
+        &_transform,
+    std::vector<float> &_heights)
+{
+  // Resize the vector to match the size of the vertices.
+  _heights.resize(static_cast<size_t>(_vertSize) * _vertSize);
+  if (_vertSize == 0 || _width == 0 || _height == 0 || _subSampling <= 0)
+    return;
+
+  // Source columns of each vertex, the same for all the rows
+  std::vector<unsigned int> x1s(_vertSize);
+  std::vector<unsigned int> x2s(_vertSize);
+  std::vector<double> dxs(_vertSize);
+  for (unsigned int x = 0; x < _vertSize; ++x)
+  {
+    double xf = x / static_cast<double>(_subSampling);
+    x1s[x] = std::min<unsigned int>(floor(xf), _width - 1);
+    x2s[x] = std::min<unsigned int>(ceil(xf), _width - 1);
+    dxs[x] = xf - x1s[x];
+  }
+
+  std::atomic<unsigned int> nextRow(0);
+  auto interpolate = [&]()
+  {
+    // Source rows interpolated along X, reused by the consecutive rows
+    // between the same source rows
+    std::vector<double> source(_width);
+    std::vector<float> rows[2] = {std::vector<float>(_vertSize),
+                                  std::vector<float>(_vertSize)};
+    int64_t rowIndices[2] = {-1, -1};
+    std::vector<double> values(_vertSize);
+
+    // Get a source row interpolated along X, without evicting _keep
+    auto row = [&](const unsigned int _row, const unsigned int _keep)
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        if (rowIndices[i] == _row)
+          return rows[i].data();
+      }
+
+      const int slot = rowIndices[0] == _keep ? 1 : 0;
+      _readRow(_row, source.data());
+      float *out = rows[slot].data();
+      for (unsigned int x = 0; x < _vertSize; ++x)
+      {
+        double px1 = source[x1s[x]];
+        double px2 = source[x2s[x]];
+        out[x] = (px1 - ((px1 - px2) * dxs[x]));
+      }
+      rowIndices[slot] = _row;
+      return out;
+    };
+
+    while (true)
+    {
+      const unsigned int start = nextRow.fetch_add(INTERPOLATE_BLOCK_ROWS);
+      if (start >= _vertSize)
+        break;
+      const unsigned int end =
+          std::min(start + INTERPOLATE_BLOCK_ROWS, _vertSize);
+
+      for (unsigned int y = start; y < end; ++y)
+      {
+        double yf = y / static_cast<double>(_subSampling);
+        unsigned int y1 = std::min<unsigned int>(floor(yf), _height - 1);
+        unsigned int y2 = std::min<unsigned int>(ceil(yf), _height - 1);
+        double dy = yf - y1;
+
+        const float *h1 = row(y1, y1);
+        const float *h2 = row(y2, y1);
+
+        // Contiguous rows, vectorized by the compiler
+        double *v = values.data();
+        for (unsigned int x = 0; x < _vertSize; ++x)
+          v[x] = h1[x] - ((h1[x] - h2[x]) * dy);
+
+        _transform(v, _vertSize);
+
+        float *out = &_heights[static_cast<size_t>(
+            _flipY ? _vertSize - y - 1 : y) * _vertSize];
+        for (unsigned int x = 0; x < _vertSize; ++x)
+          out[x] = v[x];
+      }
+    }
+  };
+
+  unsigned int threadCount = 0;
+  if (_vertSize >= PARALLEL_INTERPOLATE_SIZE)
+  {
+    const unsigned int blocks =
+        (_vertSize + INTERPOLATE_BLOCK_ROWS - 1) / INTERPOLATE_BLOCK_ROWS;
+    threadCount = std::min<unsigned int>(blocks,
+        std::max(1u, std::thread::hardware_concurrency())) - 1;
+  }
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < threadCount; ++i)
+    threads.push_back(std::thread(interpolate));
+  interpolate();
+  for (auto &thread : threads)
+    thread.join();
+}
+
 //////////////////////////////////////////////////
 HeightmapData *HeightmapDataLoader::LoadImageAsTerrain(
     const std::string &_filename)
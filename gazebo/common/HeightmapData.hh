@@ -18,6 +18,7 @@
 #ifndef GAZEBO_COMMON_HEIGHTMAPDATA_HH_
 #define GAZEBO_COMMON_HEIGHTMAPDATA_HH_
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <ignition/math/Vector3.hh>
@@ -67,6 +68,29 @@ namespace gazebo
       /// \brief Get the maximum terrain's elevation.
       /// \return The maximum terrain's elevation.
       public: virtual float GetMaxElevation() const = 0;
+
+      /// \brief Bilinearly interpolate a grid of samples, as FillHeightMap
+      /// does. Large grids are split in blocks of rows, interpolated on
+      /// several threads. Each thread interpolates the source rows along X
+      /// once, into contiguous rows, which are then blended along Y.
+      /// \param[in] _width Number of samples per source row.
+      /// \param[in] _height Number of source rows.
+      /// \param[in] _subSampling Multiplier used to increase the resolution.
+      /// \param[in] _vertSize Number of points per row.
+      /// \param[in] _flipY If true, it inverts the order of the rows.
+      /// \param[in] _readRow Function that reads a source row into _width
+      /// values. Called from several threads.
+      /// \param[in] _transform Function that turns interpolated values into
+      /// heights, in place. Called from several threads.
+      /// \param[out] _heights Vector containing the terrain heights.
+      protected: static void Interpolate(const unsigned int _width,
+          const unsigned int _height, const int _subSampling,
+          const unsigned int _vertSize, const bool _flipY,
+          const std::function<void(unsigned int _row, double *_values)>
+              &_readRow,
+          const std::function<void(double *_values, unsigned int _count)>
+              &_transform,
+          std::vector<float> &_heights);
     };
 
     /// \class HeightmapDataLoader HeightmapData.hh common/common.hh
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "gazebo/common/ImageConvert.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Number of bits of the fixed point weights of Resize.
+static const unsigned int RESIZE_BITS = 8;
+
+/// \brief Fixed point weight of a whole pixel in Resize.
+static const unsigned int RESIZE_ONE = 1u << RESIZE_BITS;
+
+/// \brief Source samples and weight of one output coordinate of Resize.
+struct ResizeSample
+{
+  /// \brief First source coordinate.
+  unsigned int first;
+
+  /// \brief Second source coordinate.
+  unsigned int second;
+
+  /// \brief Fixed point weight of the second coordinate.
+  unsigned int weight;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the source samples of every output coordinate along one axis
+/// of Resize. Pixel centers are aligned, so that scaling by an integer
+/// factor doesn't shift the image.
+/// \param[in] _size Source size.
+/// \param[in] _dstSize Output size.
+/// \return Sample of every output coordinate.
+static std::vector<ResizeSample> ResizeSamples(const unsigned int _size,
+    const unsigned int _dstSize)
+{
+  std::vector<ResizeSample> samples(_dstSize);
+  const double ratio = static_cast<double>(_size) / _dstSize;
+  for (unsigned int i = 0; i < _dstSize; ++i)
+  {
+    const double pos = std::min(std::max((i + 0.5) * ratio - 0.5, 0.0),
+        static_cast<double>(_size - 1));
+    const unsigned int first = static_cast<unsigned int>(pos);
+    samples[i].first = first;
+    samples[i].second = std::min(first + 1, _size - 1);
+    samples[i].weight =
+      static_cast<unsigned int>((pos - first) * RESIZE_ONE + 0.5);
+  }
+  return samples;
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::RGBToBGR(const uint8_t *_src, uint8_t *_dst,
+    const size_t _pixels)
+{
+  const size_t bytes = _pixels * 3;
+  size_t i = 0;
+
+#ifdef __SSSE3__
+  // Swap the five whole pixels of each 16 byte block. The last byte is
+  // stored unchanged, and overwritten by the next block.
+  const __m128i mask = _mm_setr_epi8(
+      2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+  for (; i + 16 <= bytes; i += 15)
+  {
+    const __m128i v =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(_src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i),
+        _mm_shuffle_epi8(v, mask));
+  }
+#endif
+
+  for (; i < bytes; i += 3)
+  {
+    const uint8_t r = _src[i];
+    _dst[i + 1] = _src[i + 1];
+    _dst[i] = _src[i + 2];
+    _dst[i + 2] = r;
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::RGBToMono(const uint8_t *_src, uint8_t *_dst,
+    const size_t _pixels)
+{
+  // 0.299, 0.587 and 0.114 in 8 bit fixed point
+  for (size_t i = 0; i < _pixels; ++i)
+  {
+    const uint8_t *p = _src + i * 3;
+    _dst[i] = static_cast<uint8_t>(
+        (77u * p[0] + 150u * p[1] + 29u * p[2] + 128u) >> 8);
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::Channel(const uint8_t *_src, uint8_t *_dst,
+    const size_t _pixels, const unsigned int _channels,
+    const unsigned int _channel)
+{
+  if (_channel >= _channels)
+    return;
+
+  const uint8_t *src = _src + _channel;
+  for (size_t i = 0; i < _pixels; ++i)
+    _dst[i] = src[i * _channels];
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::DepthToUInt16(const float *_src, uint16_t *_dst,
+    const size_t _count, const float _scale)
+{
+  size_t i = 0;
+
+#ifdef __SSE2__
+  const __m128 scale = _mm_set1_ps(_scale);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 max = _mm_set1_ps(65535.0f);
+  const __m128i offset = _mm_set1_epi32(32768);
+  const __m128i sign = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+  for (; i + 8 <= _count; i += 8)
+  {
+    // max returns its second operand when the first is NaN
+    __m128 a = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(_src + i), scale), zero);
+    __m128 b = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(_src + i + 4), scale),
+        zero);
+    a = _mm_min_ps(_mm_add_ps(a, half), max);
+    b = _mm_min_ps(_mm_add_ps(b, half), max);
+
+    // SSE2 only packs to signed 16 bit integers, so shift the range down
+    // before packing and flip the sign bit back after.
+    const __m128i ia = _mm_sub_epi32(_mm_cvttps_epi32(a), offset);
+    const __m128i ib = _mm_sub_epi32(_mm_cvttps_epi32(b), offset);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(_dst + i),
+        _mm_xor_si128(_mm_packs_epi32(ia, ib), sign));
+  }
+#endif
+
+  for (; i < _count; ++i)
+  {
+    float v = _src[i] * _scale;
+    v = v > 0.0f ? v + 0.5f : 0.0f;
+    v = v < 65535.0f ? v : 65535.0f;
+    _dst[i] = static_cast<uint16_t>(v);
+  }
+}
+
+//////////////////////////////////////////////////
+bool ImageConvert::RGBToBayer(const uint8_t *_src, uint8_t *_dst,
+    const unsigned int _width, const unsigned int _height,
+    const Image::PixelFormat _format)
+{
+  // Channel of the pixels on an (even row, even column), (even row, odd
+  // column), (odd row, even column) and (odd row, odd column).
+  unsigned int pattern[2][2];
+  switch (_format)
+  {
+    case Image::BAYER_RGGB8:
+      pattern[0][0] = 0; pattern[0][1] = 1;
+      pattern[1][0] = 1; pattern[1][1] = 2;
+      break;
+    case Image::BAYER_BGGR8:
+      pattern[0][0] = 2; pattern[0][1] = 1;
+      pattern[1][0] = 1; pattern[1][1] = 0;
+      break;
+    case Image::BAYER_GBRG8:
+      pattern[0][0] = 1; pattern[0][1] = 0;
+      pattern[1][0] = 2; pattern[1][1] = 1;
+      break;
+    case Image::BAYER_GRBG8:
+      pattern[0][0] = 1; pattern[0][1] = 2;
+      pattern[1][0] = 0; pattern[1][1] = 1;
+      break;
+    default:
+      return false;
+  }
+
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    const uint8_t *src = _src + static_cast<size_t>(y) * _width * 3;
+    uint8_t *dst = _dst + static_cast<size_t>(y) * _width;
+    const unsigned int even = pattern[y & 1][0];
+    const unsigned int odd = pattern[y & 1][1];
+
+    unsigned int x = 0;
+    for (; x + 1 < _width; x += 2)
+    {
+      dst[x] = src[x * 3 + even];
+      dst[x + 1] = src[x * 3 + 3 + odd];
+    }
+    if (x < _width)
+      dst[x] = src[x * 3 + even];
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::Resize(const uint8_t *_src, const unsigned int _width,
+    const unsigned int _height, const unsigned int _channels,
+    uint8_t *_dst, const unsigned int _dstWidth,
+    const unsigned int _dstHeight)
+{
+  if (_width == 0 || _height == 0 || _channels == 0 ||
+      _dstWidth == 0 || _dstHeight == 0)
+  {
+    return;
+  }
+
+  const std::vector<ResizeSample> columns = ResizeSamples(_width, _dstWidth);
+  const std::vector<ResizeSample> rows = ResizeSamples(_height, _dstHeight);
+  const size_t stride = static_cast<size_t>(_width) * _channels;
+  const size_t dstStride = static_cast<size_t>(_dstWidth) * _channels;
+
+  // Rows filtered horizontally, kept in fixed point
+  std::vector<uint32_t> top(dstStride);
+  std::vector<uint32_t> bottom(dstStride);
+
+  for (unsigned int y = 0; y < _dstHeight; ++y)
+  {
+    const ResizeSample &row = rows[y];
+    const uint8_t *src0 = _src + row.first * stride;
+    const uint8_t *src1 = _src + row.second * stride;
+
+    for (unsigned int x = 0; x < _dstWidth; ++x)
+    {
+      const ResizeSample &col = columns[x];
+      const unsigned int w1 = col.weight;
+      const unsigned int w0 = RESIZE_ONE - w1;
+      const size_t a = col.first * _channels;
+      const size_t b = col.second * _channels;
+      for (unsigned int c = 0; c < _channels; ++c)
+      {
+        top[x * _channels + c] = src0[a + c] * w0 + src0[b + c] * w1;
+        bottom[x * _channels + c] = src1[a + c] * w0 + src1[b + c] * w1;
+      }
+    }
+
+    const uint32_t w1 = row.weight;
+    const uint32_t w0 = RESIZE_ONE - w1;
+    const uint32_t round = 1u << (2 * RESIZE_BITS - 1);
+    uint8_t *dst = _dst + y * dstStride;
+    for (size_t i = 0; i < dstStride; ++i)
+    {
+      dst[i] = static_cast<uint8_t>(
+          (top[i] * w0 + bottom[i] * w1 + round) >> (2 * RESIZE_BITS));
+    }
+  }
+}
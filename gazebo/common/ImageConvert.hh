@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_IMAGECONVERT_HH_
+#define GAZEBO_COMMON_IMAGECONVERT_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gazebo/common/Image.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class ImageConvert ImageConvert.hh common/common.hh
+    /// \brief Functions to convert and scale raw image buffers, such as the
+    /// frames rendered by cameras.
+    ///
+    /// The buffers are tightly packed, row after row, without padding at
+    /// the end of the rows. Conversions use SSE instructions when the
+    /// compiler targets them, and plain loops the compiler can vectorize
+    /// otherwise. They give the same result either way.
+    class GZ_COMMON_VISIBLE ImageConvert
+    {
+      /// \brief Swap the red and blue channels of a three channel image.
+      /// \param[in] _src RGB or BGR pixels.
+      /// \param[out] _dst Converted pixels, which may be _src.
+      /// \param[in] _pixels Number of pixels.
+      public: static void RGBToBGR(const uint8_t *_src, uint8_t *_dst,
+                                   const size_t _pixels);
+
+      /// \brief Convert an RGB image to grayscale, with the ITU-R BT.601
+      /// luma weights.
+      /// \param[in] _src RGB pixels.
+      /// \param[out] _dst One byte per pixel.
+      /// \param[in] _pixels Number of pixels.
+      public: static void RGBToMono(const uint8_t *_src, uint8_t *_dst,
+                                    const size_t _pixels);
+
+      /// \brief Copy one channel of an image.
+      /// \param[in] _src Pixels with _channels bytes each.
+      /// \param[out] _dst One byte per pixel.
+      /// \param[in] _pixels Number of pixels.
+      /// \param[in] _channels Number of channels of _src.
+      /// \param[in] _channel Index of the channel to copy.
+      public: static void Channel(const uint8_t *_src, uint8_t *_dst,
+                                  const size_t _pixels,
+                                  const unsigned int _channels,
+                                  const unsigned int _channel);
+
+      /// \brief Convert floating point depths to 16 bit integers, as used by
+      /// L_INT16 depth images.
+      /// \param[in] _src Depths.
+      /// \param[out] _dst Depths multiplied by _scale and rounded. Negative
+      /// and NaN depths give 0 and large depths give 65535.
+      /// \param[in] _count Number of depths.
+      /// \param[in] _scale Units per depth unit, e.g. 1000 for millimeters
+      /// from depths in meters.
+      public: static void DepthToUInt16(const float *_src, uint16_t *_dst,
+                                        const size_t _count,
+                                        const float _scale);
+
+      /// \brief Convert an RGB image to a Bayer image, keeping the channel
+      /// of each pixel given by the Bayer pattern.
+      /// \param[in] _src RGB pixels.
+      /// \param[out] _dst One byte per pixel.
+      /// \param[in] _width Image width.
+      /// \param[in] _height Image height.
+      /// \param[in] _format One of the Image::BAYER_* formats.
+      /// \return False if _format is not a Bayer format.
+      public: static bool RGBToBayer(const uint8_t *_src, uint8_t *_dst,
+                                     const unsigned int _width,
+                                     const unsigned int _height,
+                                     const Image::PixelFormat _format);
+
+      /// \brief Scale an 8 bit image with bilinear filtering.
+      /// \param[in] _src Source pixels.
+      /// \param[in] _width Source width.
+      /// \param[in] _height Source height.
+      /// \param[in] _channels Bytes per pixel.
+      /// \param[out] _dst Scaled pixels, which can't overlap _src.
+      /// \param[in] _dstWidth Width of the scaled image.
+      /// \param[in] _dstHeight Height of the scaled image.
+      public: static void Resize(const uint8_t *_src,
+                                 const unsigned int _width,
+                                 const unsigned int _height,
+                                 const unsigned int _channels,
+                                 uint8_t *_dst,
+                                 const unsigned int _dstWidth,
+                                 const unsigned int _dstHeight);
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/ImageConvert.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ImageConvert : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Get an RGB test image where every byte differs from its
+/// neighbors.
+/// \param[in] _pixels Number of pixels.
+/// \return RGB pixels.
+std::vector<uint8_t> testImage(const size_t _pixels)
+{
+  std::vector<uint8_t> image(_pixels * 3);
+  for (size_t i = 0; i < image.size(); ++i)
+    image[i] = static_cast<uint8_t>(i * 7 + 3);
+  return image;
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvert, RGBToBGR)
+{
+  // Sizes around the 16 byte blocks
+  for (const size_t pixels : {1u, 4u, 5u, 6u, 37u, 1000u})
+  {
+    const std::vector<uint8_t> src = testImage(pixels);
+    std::vector<uint8_t> dst(src.size());
+    common::ImageConvert::RGBToBGR(src.data(), dst.data(), pixels);
+    for (size_t i = 0; i < pixels; ++i)
+    {
+      EXPECT_EQ(src[i * 3 + 2], dst[i * 3]);
+      EXPECT_EQ(src[i * 3 + 1], dst[i * 3 + 1]);
+      EXPECT_EQ(src[i * 3], dst[i * 3 + 2]);
+    }
+
+    // In place, and back
+    common::ImageConvert::RGBToBGR(dst.data(), dst.data(), pixels);
+    EXPECT_EQ(src, dst);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvert, RGBToMono)
+{
+  const uint8_t src[] = {255, 255, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0,
+      0, 0, 255, 100, 100, 100};
+  uint8_t dst[6];
+  common::ImageConvert::RGBToMono(src, dst, 6);
+  EXPECT_EQ(255, dst[0]);
+  EXPECT_EQ(0, dst[1]);
+  EXPECT_EQ(77, dst[2]);
+  EXPECT_EQ(149, dst[3]);
+  EXPECT_EQ(29, dst[4]);
+  EXPECT_EQ(100, dst[5]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvert, Channel)
+{
+  const std::vector<uint8_t> src = testImage(20);
+  std::vector<uint8_t> dst(20);
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    common::ImageConvert::Channel(src.data(), dst.data(), 20, 3, c);
+    for (size_t i = 0; i < 20; ++i)
+      EXPECT_EQ(src[i * 3 + c], dst[i]);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvert, DepthToUInt16)
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  const std::vector<float> src = {0.0f, 1.0f, 1.2344f, 1.2346f, -1.0f, nan,
+      inf, -inf, 65.534f, 100.0f, 0.0004f, 0.0006f, 2.5f};
+  const std::vector<uint16_t> expected = {0, 1000, 1234, 1235, 0, 0,
+      65535, 0, 65534, 65535, 0, 1, 2500};
+
+  std::vector<uint16_t> dst(src.size());
+  common::ImageConvert::DepthToUInt16(src.data(), dst.data(), src.size(),
+      1000.0f);
+  EXPECT_EQ(expected, dst);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvert, RGBToBayer)
+{
+  const unsigned int width = 5;
+  const unsigned int height = 3;
+  const std::vector<uint8_t> src = testImage(width * height);
+  std::vector<uint8_t> dst(width * height);
+
+  // Channel of (even row, even column), (even row, odd column),
+  // (odd row, even column) and (odd row, odd column)
+  const std::vector<std::pair<common::Image::PixelFormat,
+      std::vector<unsigned int>>> formats = {
+    {common::Image::BAYER_RGGB8, {0, 1, 1, 2}},
+    {common::Image::BAYER_BGGR8, {2, 1, 1, 0}},
+    {common::Image::BAYER_GBRG8, {1, 0, 2, 1}},
+    {common::Image::BAYER_GRBG8, {1, 2, 0, 1}}};
+
+  for (auto const &format : formats)
+  {
+    EXPECT_TRUE(common::ImageConvert::RGBToBayer(src.data(), dst.data(),
+        width, height, format.first));
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        const unsigned int c = format.second[(y % 2) * 2 + x % 2];
+        EXPECT_EQ(src[(y * width + x) * 3 + c], dst[y * width + x]);
+      }
+    }
+  }
+
+  EXPECT_FALSE(common::ImageConvert::RGBToBayer(src.data(), dst.data(),
+      width, height, common::Image::RGB_INT8));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvert, Resize)
+{
+  // Same size
+  const std::vector<uint8_t> src = testImage(6 * 4);
+  std::vector<uint8_t> dst(src.size());
+  common::ImageConvert::Resize(src.data(), 6, 4, 3, dst.data(), 6, 4);
+  EXPECT_EQ(src, dst);
+
+  // Constant image
+  const std::vector<uint8_t> gray(8 * 8 * 3, 128);
+  std::vector<uint8_t> scaled(5 * 3 * 3);
+  common::ImageConvert::Resize(gray.data(), 8, 8, 3, scaled.data(), 5, 3);
+  for (auto const value : scaled)
+    EXPECT_EQ(128, value);
+
+  // Interpolate between two pixels
+  const uint8_t line[] = {0, 255};
+  uint8_t up[4];
+  common::ImageConvert::Resize(line, 2, 1, 1, up, 4, 1);
+  EXPECT_EQ(0, up[0]);
+  EXPECT_EQ(64, up[1]);
+  EXPECT_EQ(191, up[2]);
+  EXPECT_EQ(255, up[3]);
+
+  // Halve a 4x2 image to 2x1, averaging each block of 2x2 pixels
+  const uint8_t block[] = {0, 100, 200, 40,
+                           100, 200, 40, 80};
+  uint8_t down[2];
+  common::ImageConvert::Resize(block, 4, 2, 1, down, 2, 1);
+  EXPECT_EQ(100, down[0]);
+  EXPECT_EQ(90, down[1]);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
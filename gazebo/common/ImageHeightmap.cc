@@ -15,18 +15,82 @@
  *
  */
 
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "gazebo/common/Assert.hh"
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/HeightmapCache.hh"
 #include "gazebo/common/ImageHeightmap.hh"
 
+/// \internal
+/// \brief Private data for the ImageHeightmap class.
+class gazebo::common::ImageHeightmapPrivate
+{
+  /// \brief Hash of the image file, see HeightmapCache. Empty until first
+  /// needed.
+  public: std::string cacheSource;
+
+  /// \brief Image file that cacheSource was computed from, which tells
+  /// when a heightmap was assigned another image.
+  public: std::string cacheFilename;
+};
+
 using namespace gazebo;
 using namespace common;
 
+namespace
+{
+  /// \brief Private data of the image heightmaps, by heightmap. It is kept
+  /// out of ImageHeightmap so that the layout of the class doesn't change.
+  class ImageHeightmapPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the heightmaps.
+    public: static ImageHeightmapPrivates &Instance()
+    {
+      static ImageHeightmapPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by heightmap.
+    public: std::unordered_map<const ImageHeightmap *,
+            std::unique_ptr<ImageHeightmapPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 ImageHeightmap::ImageHeightmap()
 {
 }
 
+//////////////////////////////////////////////////
+ImageHeightmap::~ImageHeightmap()
+{
+  ImageHeightmapPrivates &privates = ImageHeightmapPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+ImageHeightmapPrivate *ImageHeightmap::ImageHeightmapData() const
+{
+  ImageHeightmapPrivates &privates = ImageHeightmapPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  std::unique_ptr<ImageHeightmapPrivate> &data = privates.data[this];
+  if (!data)
+    data.reset(new ImageHeightmapPrivate);
+  return data.get();
+}
+
 //////////////////////////////////////////////////
 int ImageHeightmap::Load(const std::string &_filename)
 {
@@ -35,6 +99,7 @@ int ImageHeightmap::Load(const std::string &_filename)
     gzerr << "Unable to load image file as a terrain [" << _filename << "]\n";
     return -1;
   }
+  this->ImageHeightmapData()->cacheSource.clear();
 
   return 0;
 }
@@ -45,8 +110,34 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
     const ignition::math::Vector3d &_scale, bool _flipY,
     std::vector<float> &_heights)
 {
-  // Resize the vector to match the size of the vertices.
-  _heights.resize(_vertSize * _vertSize);
+  // Large terrains are shared with the other processes through the cache
+  std::string key;
+  if (_vertSize >= HeightmapCache::MinVertSize &&
+      !HeightmapCache::Path().empty())
+  {
+    ImageHeightmapPrivate *data = this->ImageHeightmapData();
+    const std::string filename = this->GetFilename();
+    if (data->cacheSource.empty() || data->cacheFilename != filename)
+    {
+      data->cacheSource.clear();
+      data->cacheFilename = filename;
+      std::ifstream in(filename, std::ios::binary);
+      if (in)
+      {
+        std::string content((std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+        data->cacheSource = common::get_sha1<std::string>(content);
+      }
+    }
+
+    if (!data->cacheSource.empty())
+    {
+      key = HeightmapCache::Key(data->cacheSource, _subSampling, _vertSize,
+          _size, _scale);
+      if (HeightmapCache::Load(key, _vertSize, _flipY, _heights))
+        return;
+    }
+  }
 
   int imgHeight = this->GetHeight();
   int imgWidth = this->GetWidth();
@@ -63,51 +154,37 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
   unsigned int count;
   this->img.GetData(&data, count);
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
-  {
-    // yf ranges between 0 and 4
-    double yf = y / static_cast<double>(_subSampling);
-    int y1 = floor(yf);
-    int y2 = ceil(yf);
-    if (y2 >= imgHeight)
-      y2 = imgHeight-1;
-    double dy = yf - y1;
-
-    for (unsigned int x = 0; x < _vertSize; ++x)
-    {
-      double xf = x / static_cast<double>(_subSampling);
-      int x1 = floor(xf);
-      int x2 = ceil(xf);
-      if (x2 >= imgWidth)
-        x2 = imgWidth-1;
-      double dx = xf - x1;
-
-      double px1 = static_cast<int>(data[y1 * pitch + x1 * bpp]) / 255.0;
-      double px2 = static_cast<int>(data[y1 * pitch + x2 * bpp]) / 255.0;
-      float h1 = (px1 - ((px1 - px2) * dx));
-
-      double px3 = static_cast<int>(data[y2 * pitch + x1 * bpp]) / 255.0;
-      double px4 = static_cast<int>(data[y2 * pitch + x2 * bpp]) / 255.0;
-      float h2 = (px3 - ((px3 - px4) * dx));
-
-      float h = (h1 - ((h1 - h2) * dy)) * _scale.Z();
-
-      // invert pixel definition so 1=ground, 0=full height,
-      //   if the terrain size has a negative z component
-      //   this is mainly for backward compatibility
-      if (_size.Z() < 0)
-        h = 1.0 - h;
-
-      // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
-    }
-  }
+  const double scaleZ = _scale.Z();
+  const bool inverted = _size.Z() < 0;
+
+  HeightmapData::Interpolate(imgWidth, imgHeight, _subSampling, _vertSize,
+      _flipY,
+      [&](unsigned int _row, double *_values)
+      {
+        const unsigned char *pixels = data + static_cast<size_t>(_row) * pitch;
+        for (int x = 0; x < imgWidth; ++x)
+          _values[x] = static_cast<int>(pixels[x * bpp]) / 255.0;
+      },
+      [&](double *_values, unsigned int _count)
+      {
+        for (unsigned int x = 0; x < _count; ++x)
+        {
+          float h = _values[x] * scaleZ;
+
+          // invert pixel definition so 1=ground, 0=full height,
+          //   if the terrain size has a negative z component
+          //   this is mainly for backward compatibility
+          if (inverted)
+            h = 1.0 - h;
+
+          _values[x] = h;
+        }
+      }, _heights);
 
   delete [] data;
+
+  if (!key.empty())
+    HeightmapCache::Save(key, _vertSize, _flipY, _heights);
 }
 
 //////////////////////////////////////////////////
@@ -30,6 +30,9 @@ namespace gazebo
 {
   namespace common
   {
+    // Forward declare private data class
+    class ImageHeightmapPrivate;
+
     /// \addtogroup gazebo_common Common
     /// \{
 
@@ -42,6 +45,9 @@ namespace gazebo
       /// \param[in] _filename the path to the image
       public: ImageHeightmap();
 
+      /// \brief Destructor
+      public: virtual ~ImageHeightmap();
+
       /// \brief Load an image file as a heightmap.
       /// \param[in] _filename the path to the image file.
       /// \return True when the operation succeeds to open a file.
@@ -66,6 +72,13 @@ namespace gazebo
       // Documentation inherited.
       public: float GetMaxElevation() const;
 
+      /// \internal
+      /// \brief Get the private data of this heightmap, created on first
+      /// use so that implicit copies get their own. It is kept out of the
+      /// class so that its layout doesn't change.
+      /// \return The private data.
+      private: ImageHeightmapPrivate *ImageHeightmapData() const;
+
       /// \brief Image containing the heightmap data.
       private: gazebo::common::Image img;
     };
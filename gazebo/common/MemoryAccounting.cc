@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "gazebo/common/MemoryAccounting.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Names of the subsystems, indexed by MemoryAccounting::Subsystem.
+static const char *SUBSYSTEM_NAMES[MemoryAccounting::SUBSYSTEM_COUNT] = {
+  "meshes",
+  "physics_meshes",
+  "contacts",
+  "transport",
+  "sensors",
+  "logging",
+  "rendering"};
+
+/// \brief Counters of the accounting.
+class MemoryCounters
+{
+  /// \brief Bytes per subsystem.
+  public: std::atomic<int64_t> subsystems[MemoryAccounting::SUBSYSTEM_COUNT];
+
+  /// \brief Bytes per subsystem, by owner. Owners are removed when they
+  /// hold nothing.
+  public: std::map<std::string, std::vector<int64_t>> owners;
+
+  /// \brief Protects owners.
+  public: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get whether the environment enables the accounting.
+/// \return True if GAZEBO_MEMORY_ACCOUNTING is set to anything but 0.
+static bool EnabledByEnvironment()
+{
+  const char *value = std::getenv("GAZEBO_MEMORY_ACCOUNTING");
+  return value && std::strcmp(value, "0") != 0;
+}
+
+std::atomic<bool> MemoryAccounting::enabled(EnabledByEnvironment());
+
+//////////////////////////////////////////////////
+/// \brief Get the counters. They are never destroyed, since accounts of
+/// static objects may be destroyed while the process exits.
+/// \return The counters.
+static MemoryCounters &Counters()
+{
+  static MemoryCounters *counters = []()
+  {
+    auto result = new MemoryCounters;
+    for (auto &subsystem : result->subsystems)
+      subsystem = 0;
+    return result;
+  }();
+  return *counters;
+}
+
+//////////////////////////////////////////////////
+MemoryAccounting::Account::Account(const Subsystem _subsystem,
+    const std::string &_owner)
+  : subsystem(_subsystem), owner(_owner)
+{
+}
+
+//////////////////////////////////////////////////
+MemoryAccounting::Account::~Account()
+{
+  this->Add(-this->bytes);
+}
+
+//////////////////////////////////////////////////
+void MemoryAccounting::Account::Set(const int64_t _bytes)
+{
+  const int64_t bytes = MemoryAccounting::Enabled() ? _bytes : 0;
+  this->Add(bytes - this->bytes);
+  this->bytes = bytes;
+}
+
+//////////////////////////////////////////////////
+void MemoryAccounting::Account::SetOwner(const std::string &_owner)
+{
+  if (_owner == this->owner)
+    return;
+
+  const int64_t bytes = this->bytes;
+  this->Add(-bytes);
+  this->owner = _owner;
+  this->Add(bytes);
+}
+
+//////////////////////////////////////////////////
+int64_t MemoryAccounting::Account::Bytes() const
+{
+  return this->bytes;
+}
+
+//////////////////////////////////////////////////
+void MemoryAccounting::Account::Add(const int64_t _delta)
+{
+  if (_delta == 0)
+    return;
+
+  MemoryCounters &counters = Counters();
+  counters.subsystems[this->subsystem] += _delta;
+
+  // Only the buffers of models take the lock
+  if (this->owner.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(counters.mutex);
+  auto iter = counters.owners.emplace(this->owner,
+      std::vector<int64_t>(SUBSYSTEM_COUNT, 0)).first;
+  iter->second[this->subsystem] += _delta;
+
+  for (const int64_t bytes : iter->second)
+  {
+    if (bytes != 0)
+      return;
+  }
+  counters.owners.erase(iter);
+}
+
+//////////////////////////////////////////////////
+void MemoryAccounting::SetEnabled(const bool _enabled)
+{
+  enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+int64_t MemoryAccounting::Bytes(const Subsystem _subsystem)
+{
+  if (_subsystem >= SUBSYSTEM_COUNT)
+    return 0;
+  return Counters().subsystems[_subsystem];
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, std::vector<int64_t>> MemoryAccounting::ModelBytes()
+{
+  MemoryCounters &counters = Counters();
+  std::lock_guard<std::mutex> lock(counters.mutex);
+  return counters.owners;
+}
+
+//////////////////////////////////////////////////
+std::string MemoryAccounting::Name(const Subsystem _subsystem)
+{
+  if (_subsystem >= SUBSYSTEM_COUNT)
+    return "";
+  return SUBSYSTEM_NAMES[_subsystem];
+}
+
+//////////////////////////////////////////////////
+int64_t MemoryAccounting::ResidentBytes()
+{
+#ifdef __linux__
+  // The second field of statm is the resident set size, in pages
+  FILE *file = std::fopen("/proc/self/statm", "r");
+  if (!file)
+    return 0;
+
+  long size = 0;
+  long resident = 0;
+  const int read = std::fscanf(file, "%ld %ld", &size, &resident);
+  std::fclose(file);
+
+  if (read != 2)
+    return 0;
+  return static_cast<int64_t>(resident) * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
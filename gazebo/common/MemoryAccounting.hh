@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MEMORYACCOUNTING_HH_
+#define GAZEBO_COMMON_MEMORYACCOUNTING_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class MemoryAccounting MemoryAccounting.hh common/common.hh
+    /// \brief Counts the memory held by the large buffers of each
+    /// subsystem, and by model where the owner of a buffer is known.
+    ///
+    /// The buffers are counted through Account objects, which add their
+    /// size to the counter of their subsystem. The accounting is disabled
+    /// by default, and enabled by setting the GAZEBO_MEMORY_ACCOUNTING
+    /// environment variable to 1 or with SetEnabled. Only the buffers
+    /// sized while enabled are counted, so it is meant to be enabled at
+    /// startup.
+    class GZ_COMMON_VISIBLE MemoryAccounting
+    {
+      /// \brief Subsystems the memory is counted for.
+      public: enum Subsystem
+      {
+        /// \brief Meshes loaded by common::MeshManager.
+        MESHES = 0,
+
+        /// \brief Triangle meshes and convex hulls of the physics engines.
+        PHYSICS_MESHES,
+
+        /// \brief Contacts of the contact manager.
+        CONTACTS,
+
+        /// \brief Serialized messages held by the transport queues.
+        TRANSPORT,
+
+        /// \brief Data buffers of the sensors.
+        SENSORS,
+
+        /// \brief Buffers of the log recorder.
+        LOGGING,
+
+        /// \brief Textures and meshes of the rendering engine.
+        RENDERING,
+
+        /// \brief Number of subsystems.
+        SUBSYSTEM_COUNT
+      };
+
+      /// \brief Memory of a buffer, counted until it is destroyed.
+      public: class GZ_COMMON_VISIBLE Account
+      {
+        /// \brief Constructor.
+        /// \param[in] _subsystem Subsystem of the buffer.
+        /// \param[in] _owner Scoped name of the model owning the buffer,
+        /// empty if none.
+        public: explicit Account(const Subsystem _subsystem,
+                    const std::string &_owner = "");
+
+        /// \brief Destructor, removes the size from the counters.
+        public: ~Account();
+
+        /// \brief Set the size of the buffer. Sizes set while the
+        /// accounting is disabled count as zero.
+        /// \param[in] _bytes Size in bytes.
+        public: void Set(const int64_t _bytes);
+
+        /// \brief Set the model owning the buffer.
+        /// \param[in] _owner Scoped name of the model, empty if none.
+        public: void SetOwner(const std::string &_owner);
+
+        /// \brief Get the size counted for the buffer.
+        /// \return Size in bytes.
+        public: int64_t Bytes() const;
+
+        /// \brief Add to the counters.
+        /// \param[in] _delta Bytes to add, negative to remove.
+        private: void Add(const int64_t _delta);
+
+        /// \brief Subsystem of the buffer.
+        private: const Subsystem subsystem;
+
+        /// \brief Owner of the buffer, empty if none.
+        private: std::string owner;
+
+        /// \brief Size counted.
+        private: int64_t bytes = 0;
+
+        /// \brief Not copyable, since the size would be counted twice.
+        private: Account(const Account &) = delete;
+
+        /// \brief Not copyable, since the size would be counted twice.
+        private: Account &operator=(const Account &) = delete;
+      };
+
+      /// \brief Get whether the accounting is enabled.
+      /// \return True if enabled.
+      public: static bool Enabled()
+              {
+                return enabled.load(std::memory_order_relaxed);
+              }
+
+      /// \brief Enable or disable the accounting. Disabling it doesn't
+      /// remove the sizes already counted, until they are set again.
+      /// \param[in] _enabled True to enable.
+      public: static void SetEnabled(const bool _enabled);
+
+      /// \brief Get the memory counted for a subsystem.
+      /// \param[in] _subsystem The subsystem.
+      /// \return Size in bytes.
+      public: static int64_t Bytes(const Subsystem _subsystem);
+
+      /// \brief Get the memory counted per model.
+      /// \return Sizes in bytes indexed by subsystem, by scoped model name.
+      public: static std::map<std::string, std::vector<int64_t>> ModelBytes();
+
+      /// \brief Get the name of a subsystem.
+      /// \param[in] _subsystem The subsystem.
+      /// \return Name, such as "meshes".
+      public: static std::string Name(const Subsystem _subsystem);
+
+      /// \brief Get the resident memory of the process, to compare with
+      /// the memory counted.
+      /// \return Size in bytes, or zero if unknown on this platform.
+      public: static int64_t ResidentBytes();
+
+      /// \brief True while counting.
+      private: static std::atomic<bool> enabled;
+    };
+    /// \}
+  }
+}
+#endif
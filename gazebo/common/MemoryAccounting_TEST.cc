@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "gazebo/common/MemoryAccounting.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using common::MemoryAccounting;
+
+class MemoryAccountingTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MemoryAccountingTest, Accounts)
+{
+  MemoryAccounting::SetEnabled(true);
+  const int64_t meshes = MemoryAccounting::Bytes(MemoryAccounting::MESHES);
+  const int64_t sensors = MemoryAccounting::Bytes(MemoryAccounting::SENSORS);
+
+  std::unique_ptr<MemoryAccounting::Account> mesh(
+      new MemoryAccounting::Account(MemoryAccounting::MESHES));
+  mesh->Set(100);
+  EXPECT_EQ(100, mesh->Bytes());
+  EXPECT_EQ(meshes + 100, MemoryAccounting::Bytes(MemoryAccounting::MESHES));
+
+  mesh->Set(40);
+  EXPECT_EQ(meshes + 40, MemoryAccounting::Bytes(MemoryAccounting::MESHES));
+  EXPECT_EQ(0u, MemoryAccounting::ModelBytes().count(""));
+
+  // The memory of models is also counted by model
+  std::unique_ptr<MemoryAccounting::Account> camera(
+      new MemoryAccounting::Account(MemoryAccounting::SENSORS, "robot"));
+  camera->Set(1000);
+  EXPECT_EQ(sensors + 1000,
+      MemoryAccounting::Bytes(MemoryAccounting::SENSORS));
+  auto models = MemoryAccounting::ModelBytes();
+  ASSERT_EQ(1u, models.count("robot"));
+  ASSERT_EQ(static_cast<size_t>(MemoryAccounting::SUBSYSTEM_COUNT),
+      models["robot"].size());
+  EXPECT_EQ(1000, models["robot"][MemoryAccounting::SENSORS]);
+  EXPECT_EQ(0, models["robot"][MemoryAccounting::MESHES]);
+
+  camera->SetOwner("other_robot");
+  models = MemoryAccounting::ModelBytes();
+  EXPECT_EQ(0u, models.count("robot"));
+  ASSERT_EQ(1u, models.count("other_robot"));
+  EXPECT_EQ(1000, models["other_robot"][MemoryAccounting::SENSORS]);
+
+  // Destroying the accounts removes their memory
+  camera.reset();
+  EXPECT_EQ(sensors, MemoryAccounting::Bytes(MemoryAccounting::SENSORS));
+  EXPECT_EQ(0u, MemoryAccounting::ModelBytes().count("other_robot"));
+
+  // Sizes set while disabled count as zero
+  MemoryAccounting::SetEnabled(false);
+  EXPECT_FALSE(MemoryAccounting::Enabled());
+  mesh->Set(500);
+  EXPECT_EQ(0, mesh->Bytes());
+  EXPECT_EQ(meshes, MemoryAccounting::Bytes(MemoryAccounting::MESHES));
+  mesh.reset();
+  EXPECT_EQ(meshes, MemoryAccounting::Bytes(MemoryAccounting::MESHES));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MemoryAccountingTest, Names)
+{
+  EXPECT_EQ("meshes", MemoryAccounting::Name(MemoryAccounting::MESHES));
+  EXPECT_EQ("rendering", MemoryAccounting::Name(MemoryAccounting::RENDERING));
+  EXPECT_EQ("", MemoryAccounting::Name(MemoryAccounting::SUBSYSTEM_COUNT));
+
+#ifdef __linux__
+  EXPECT_GT(MemoryAccounting::ResidentBytes(), 0);
+#endif
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
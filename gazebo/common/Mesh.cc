@@ -17,6 +17,11 @@
 #include <float.h>
 #include <string.h>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "gazebo/common/Material.hh"
 #include "gazebo/common/Exception.hh"
@@ -25,9 +30,77 @@
 #include "gazebo/common/Skeleton.hh"
 #include "gazebo/gazebo_config.h"
 
+/// \internal
+/// \brief Private data for the SubMesh class, the storage of a compact
+/// submesh.
+class gazebo::common::SubMeshPrivate
+{
+  /// \brief Get a value of the vertex buffer.
+  /// \param[in] _vertex Vertex index.
+  /// \param[in] _offset Offset within the vertex.
+  /// \return The value.
+  public: double CompactValue(unsigned int _vertex,
+              unsigned int _offset) const
+  {
+    return this->vertexBuffer[_vertex * this->vertexStride + _offset];
+  }
+
+  /// \brief Get an index, without range checks.
+  /// \param[in] _i Position in the index buffer.
+  /// \return The index.
+  public: unsigned int CompactIndex(unsigned int _i) const
+  {
+    if (!this->indices32.empty())
+      return this->indices32[_i];
+    return this->indices16[_i];
+  }
+
+  /// \brief Interleaved vertex buffer.
+  public: std::vector<float> vertexBuffer;
+
+  /// \brief Floats per vertex of the vertex buffer, 0 if the submesh is
+  /// not compact.
+  public: unsigned int vertexStride = 0;
+
+  /// \brief Offset of the normals in the vertex buffer.
+  public: int normalOffset = -1;
+
+  /// \brief Offset of the texture coordinates in the vertex buffer.
+  public: int texCoordOffset = -1;
+
+  /// \brief 16 bit index array.
+  public: std::vector<uint16_t> indices16;
+
+  /// \brief 32 bit index array.
+  public: std::vector<uint32_t> indices32;
+};
+
 using namespace gazebo;
 using namespace common;
 
+namespace
+{
+  /// \brief Private data of the submeshes, by submesh. It is kept out of
+  /// SubMesh so that the layout of the class doesn't change.
+  class SubMeshPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the submeshes.
+    public: static SubMeshPrivates &Instance()
+    {
+      static SubMeshPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by submesh.
+    public: std::unordered_map<const SubMesh *,
+            std::unique_ptr<SubMeshPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 
 //////////////////////////////////////////////////
 Mesh::Mesh()
@@ -193,6 +266,15 @@ unsigned int Mesh::GetTexCoordCount() const
 }
 
 
+//////////////////////////////////////////////////
+size_t Mesh::MemorySize() const
+{
+  size_t size = 0;
+  for (auto const &submesh : this->submeshes)
+    size += submesh->MemorySize();
+  return size;
+}
+
 //////////////////////////////////////////////////
 void Mesh::AddSubMesh(SubMesh *_sub)
 {
@@ -323,6 +405,18 @@ void Mesh::FillArrays(float **_vertArr, int **_indArr) const
   }
 }
 
+//////////////////////////////////////////////////
+unsigned int Mesh::Compact()
+{
+  unsigned int count = 0;
+  for (auto &subMesh : this->submeshes)
+  {
+    if (subMesh->Compact())
+      ++count;
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////
 void Mesh::RecalculateNormals()
 {
@@ -407,6 +501,12 @@ void Mesh::Translate(const ignition::math::Vector3d &_vec)
 //////////////////////////////////////////////////
 SubMesh::SubMesh()
 {
+  {
+    SubMeshPrivates &privates = SubMeshPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new SubMeshPrivate);
+  }
+
   this->materialIndex = -1;
   this->primitiveType = TRIANGLES;
 }
@@ -414,6 +514,12 @@ SubMesh::SubMesh()
 //////////////////////////////////////////////////
 SubMesh::SubMesh(const SubMesh *_mesh)
 {
+  {
+    SubMeshPrivates &privates = SubMeshPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new SubMeshPrivate);
+  }
+
   if (!_mesh)
   {
     gzerr << "Submesh is null." << std::endl;
@@ -435,6 +541,8 @@ SubMesh::SubMesh(const SubMesh *_mesh)
       std::back_inserter(this->texCoords));
   std::copy(_mesh->vertices.begin(), _mesh->vertices.end(),
       std::back_inserter(this->vertices));
+
+  *this->SubMeshData() = *_mesh->SubMeshData();
 }
 
 //////////////////////////////////////////////////
@@ -443,6 +551,18 @@ SubMesh::~SubMesh()
   this->vertices.clear();
   this->indices.clear();
   this->nodeAssignments.clear();
+
+  SubMeshPrivates &privates = SubMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+SubMeshPrivate *SubMesh::SubMeshData() const
+{
+  SubMeshPrivates &privates = SubMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -460,6 +580,7 @@ SubMesh::PrimitiveType SubMesh::GetPrimitiveType() const
 //////////////////////////////////////////////////
 void SubMesh::CopyVertices(const std::vector<ignition::math::Vector3d> &_verts)
 {
+  this->Expand();
   this->vertices.clear();
   this->vertices.resize(_verts.size());
   std::copy(_verts.begin(), _verts.end(), this->vertices.begin());
@@ -468,6 +589,7 @@ void SubMesh::CopyVertices(const std::vector<ignition::math::Vector3d> &_verts)
 //////////////////////////////////////////////////
 void SubMesh::CopyNormals(const std::vector<ignition::math::Vector3d> &_norms)
 {
+  this->Expand();
   this->normals.clear();
   this->normals.resize(_norms.size());
   for (unsigned int i = 0; i < _norms.size(); ++i)
@@ -484,36 +606,42 @@ void SubMesh::CopyNormals(const std::vector<ignition::math::Vector3d> &_norms)
 //////////////////////////////////////////////////
 void SubMesh::SetVertexCount(unsigned int _count)
 {
+  this->Expand();
   this->vertices.resize(_count);
 }
 
 //////////////////////////////////////////////////
 void SubMesh::SetIndexCount(unsigned int _count)
 {
+  this->Expand();
   this->indices.resize(_count);
 }
 
 //////////////////////////////////////////////////
 void SubMesh::SetNormalCount(unsigned int _count)
 {
+  this->Expand();
   this->normals.resize(_count);
 }
 
 //////////////////////////////////////////////////
 void SubMesh::SetTexCoordCount(unsigned int _count)
 {
+  this->Expand();
   this->texCoords.resize(_count);
 }
 
 //////////////////////////////////////////////////
 void SubMesh::AddIndex(unsigned int _i)
 {
+  this->Expand();
   this->indices.push_back(_i);
 }
 
 //////////////////////////////////////////////////
 void SubMesh::AddVertex(const ignition::math::Vector3d &_v)
 {
+  this->Expand();
   this->vertices.push_back(_v);
 }
 
@@ -526,6 +654,7 @@ void SubMesh::AddVertex(double _x, double _y, double _z)
 //////////////////////////////////////////////////
 void SubMesh::AddNormal(const ignition::math::Vector3d &_n)
 {
+  this->Expand();
   this->normals.push_back(_n);
 }
 
@@ -538,6 +667,7 @@ void SubMesh::AddNormal(double _x, double _y, double _z)
 //////////////////////////////////////////////////
 void SubMesh::AddTexCoord(double _u, double _v)
 {
+  this->Expand();
   this->texCoords.push_back(ignition::math::Vector2d(_u, _v));
 }
 
@@ -556,15 +686,23 @@ void SubMesh::AddNodeAssignment(unsigned int _vertex, unsigned int _node,
 //////////////////////////////////////////////////
 ignition::math::Vector3d SubMesh::Vertex(unsigned int _i) const
 {
-  if (_i >= this->vertices.size())
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (_i >= this->GetVertexCount())
     gzthrow("Index too large");
 
+  if (data->vertexStride > 0)
+  {
+    return ignition::math::Vector3d(data->CompactValue(_i, 0),
+        data->CompactValue(_i, 1), data->CompactValue(_i, 2));
+  }
+
   return this->vertices[_i];
 }
 
 //////////////////////////////////////////////////
 void SubMesh::SetVertex(unsigned int _i, const ignition::math::Vector3d &_v)
 {
+  this->Expand();
   if (_i >= this->vertices.size())
     gzthrow("Index too large");
 
@@ -574,15 +712,25 @@ void SubMesh::SetVertex(unsigned int _i, const ignition::math::Vector3d &_v)
 //////////////////////////////////////////////////
 ignition::math::Vector3d SubMesh::Normal(unsigned int _i) const
 {
-  if (_i >= this->normals.size())
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (_i >= this->GetNormalCount())
     gzthrow("Index too large");
 
+  if (data->vertexStride > 0)
+  {
+    return ignition::math::Vector3d(
+        data->CompactValue(_i, data->normalOffset),
+        data->CompactValue(_i, data->normalOffset + 1),
+        data->CompactValue(_i, data->normalOffset + 2));
+  }
+
   return this->normals[_i];
 }
 
 //////////////////////////////////////////////////
 void SubMesh::SetNormal(unsigned int _i, const ignition::math::Vector3d &_n)
 {
+  this->Expand();
   if (_i >= this->normals.size())
     gzthrow("Index too large");
 
@@ -592,9 +740,17 @@ void SubMesh::SetNormal(unsigned int _i, const ignition::math::Vector3d &_n)
 //////////////////////////////////////////////////
 ignition::math::Vector2d SubMesh::TexCoord(unsigned int _i) const
 {
-  if (_i >= this->texCoords.size())
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (_i >= this->GetTexCoordCount())
     gzthrow("Index too large");
 
+  if (data->vertexStride > 0)
+  {
+    return ignition::math::Vector2d(
+        data->CompactValue(_i, data->texCoordOffset),
+        data->CompactValue(_i, data->texCoordOffset + 1));
+  }
+
   return this->texCoords[_i];
 }
 
@@ -610,6 +766,7 @@ NodeAssignment SubMesh::GetNodeAssignment(unsigned int _i) const
 //////////////////////////////////////////////////
 void SubMesh::SetTexCoord(unsigned int _i, const ignition::math::Vector2d &_t)
 {
+  this->Expand();
   if (_i >= this->texCoords.size())
     gzthrow("Index too large");
 
@@ -619,6 +776,14 @@ void SubMesh::SetTexCoord(unsigned int _i, const ignition::math::Vector2d &_t)
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetIndex(unsigned int _i) const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+  {
+    if (_i >= this->GetIndexCount())
+      gzthrow("Index too large");
+    return data->CompactIndex(_i);
+  }
+
   if (_i > this->indices.size())
     gzthrow("Index too large");
 
@@ -628,6 +793,7 @@ unsigned int SubMesh::GetIndex(unsigned int _i) const
 //////////////////////////////////////////////////
 ignition::math::Vector3d SubMesh::Max() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
   ignition::math::Vector3d max;
   std::vector<ignition::math::Vector3d>::const_iterator iter;
 
@@ -635,6 +801,18 @@ ignition::math::Vector3d SubMesh::Max() const
   max.Y(-FLT_MAX);
   max.Z(-FLT_MAX);
 
+  if (data->vertexStride > 0)
+  {
+    const unsigned int count = this->GetVertexCount();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      max.X(std::max(max.X(), data->CompactValue(i, 0)));
+      max.Y(std::max(max.Y(), data->CompactValue(i, 1)));
+      max.Z(std::max(max.Z(), data->CompactValue(i, 2)));
+    }
+    return max;
+  }
+
   for (iter = this->vertices.begin(); iter != this->vertices.end(); ++iter)
   {
     max.X(std::max(max.X(), (*iter).X()));
@@ -648,6 +826,7 @@ ignition::math::Vector3d SubMesh::Max() const
 //////////////////////////////////////////////////
 ignition::math::Vector3d SubMesh::Min() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
   ignition::math::Vector3d min;
   std::vector<ignition::math::Vector3d>::const_iterator iter;
 
@@ -655,6 +834,18 @@ ignition::math::Vector3d SubMesh::Min() const
   min.Y(FLT_MAX);
   min.Z(FLT_MAX);
 
+  if (data->vertexStride > 0)
+  {
+    const unsigned int count = this->GetVertexCount();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      min.X(std::min(min.X(), data->CompactValue(i, 0)));
+      min.Y(std::min(min.Y(), data->CompactValue(i, 1)));
+      min.Z(std::min(min.Z(), data->CompactValue(i, 2)));
+    }
+    return min;
+  }
+
   for (iter = this->vertices.begin(); iter != this->vertices.end(); ++iter)
   {
     min.X(std::min(min.X(), (*iter).X()));
@@ -668,24 +859,36 @@ ignition::math::Vector3d SubMesh::Min() const
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetVertexCount() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+    return data->vertexBuffer.size() / data->vertexStride;
   return this->vertices.size();
 }
 
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetNormalCount() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+    return data->normalOffset < 0 ? 0 : this->GetVertexCount();
   return this->normals.size();
 }
 
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetIndexCount() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+    return data->indices16.size() + data->indices32.size();
   return this->indices.size();
 }
 
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetTexCoordCount() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+    return data->texCoordOffset < 0 ? 0 : this->GetVertexCount();
   return this->texCoords.size();
 }
 
@@ -698,6 +901,15 @@ unsigned int SubMesh::GetNodeAssignmentsCount() const
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetMaxIndex() const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+  {
+    unsigned int maxIndex = 0;
+    for (unsigned int i = 0; i < this->GetIndexCount(); ++i)
+      maxIndex = std::max(maxIndex, data->CompactIndex(i));
+    return maxIndex;
+  }
+
   std::vector<unsigned int>::const_iterator maxIter;
   maxIter = std::max_element(this->indices.begin(), this->indices.end());
 
@@ -722,6 +934,15 @@ unsigned int SubMesh::GetMaterialIndex() const
 //////////////////////////////////////////////////
 bool SubMesh::HasVertex(const ignition::math::Vector3d &_v) const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+  {
+    for (unsigned int i = 0; i < this->GetVertexCount(); ++i)
+      if (_v.Equal(this->Vertex(i)))
+        return true;
+    return false;
+  }
+
   std::vector< ignition::math::Vector3d >::const_iterator iter;
 
   for (iter = this->vertices.begin(); iter != this->vertices.end(); ++iter)
@@ -734,6 +955,15 @@ bool SubMesh::HasVertex(const ignition::math::Vector3d &_v) const
 //////////////////////////////////////////////////
 unsigned int SubMesh::GetVertexIndex(const ignition::math::Vector3d &_v) const
 {
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+  {
+    for (unsigned int i = 0; i < this->GetVertexCount(); ++i)
+      if (_v.Equal(this->Vertex(i)))
+        return i;
+    return 0;
+  }
+
   std::vector< ignition::math::Vector3d >::const_iterator iter;
 
   for (iter = this->vertices.begin(); iter != this->vertices.end(); ++iter)
@@ -746,7 +976,8 @@ unsigned int SubMesh::GetVertexIndex(const ignition::math::Vector3d &_v) const
 //////////////////////////////////////////////////
 void SubMesh::FillArrays(float **_vertArr, int **_indArr) const
 {
-  if (this->vertices.empty() || this->indices.empty())
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (this->GetVertexCount() == 0 || this->GetIndexCount() == 0)
     gzerr << "No vertices or indices\n";
 
   std::vector<ignition::math::Vector3d>::const_iterator viter;
@@ -759,6 +990,21 @@ void SubMesh::FillArrays(float **_vertArr, int **_indArr) const
   if (*_indArr)
     delete [] *_indArr;
 
+  if (data->vertexStride > 0)
+  {
+    *_vertArr = new float[this->GetVertexCount() * 3];
+    *_indArr = new int[this->GetIndexCount()];
+
+    for (i = 0; i < this->GetVertexCount(); ++i)
+    {
+      memcpy(*_vertArr + i * 3, &data->vertexBuffer[i * data->vertexStride],
+          3 * sizeof(float));
+    }
+    for (i = 0; i < this->GetIndexCount(); ++i)
+      (*_indArr)[i] = data->CompactIndex(i);
+    return;
+  }
+
   *_vertArr = new float[this->vertices.size() * 3];
   *_indArr = new int[this->indices.size()];
 
@@ -777,9 +1023,173 @@ void SubMesh::FillArrays(float **_vertArr, int **_indArr) const
   }
 }
 
+//////////////////////////////////////////////////
+bool SubMesh::Compact()
+{
+  SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride > 0)
+    return true;
+
+  const size_t count = this->vertices.size();
+  if ((!this->normals.empty() && this->normals.size() != count) ||
+      (!this->texCoords.empty() && this->texCoords.size() != count))
+  {
+    return false;
+  }
+
+  data->vertexStride = 3;
+  data->normalOffset = -1;
+  data->texCoordOffset = -1;
+  if (!this->normals.empty())
+  {
+    data->normalOffset = data->vertexStride;
+    data->vertexStride += 3;
+  }
+  if (!this->texCoords.empty())
+  {
+    data->texCoordOffset = data->vertexStride;
+    data->vertexStride += 2;
+  }
+
+  data->vertexBuffer.resize(count * data->vertexStride);
+  float *v = data->vertexBuffer.data();
+  for (size_t i = 0; i < count; ++i)
+  {
+    *v++ = static_cast<float>(this->vertices[i].X());
+    *v++ = static_cast<float>(this->vertices[i].Y());
+    *v++ = static_cast<float>(this->vertices[i].Z());
+    if (data->normalOffset >= 0)
+    {
+      *v++ = static_cast<float>(this->normals[i].X());
+      *v++ = static_cast<float>(this->normals[i].Y());
+      *v++ = static_cast<float>(this->normals[i].Z());
+    }
+    if (data->texCoordOffset >= 0)
+    {
+      *v++ = static_cast<float>(this->texCoords[i].X());
+      *v++ = static_cast<float>(this->texCoords[i].Y());
+    }
+  }
+
+  // 16 bit indices when every index fits
+  unsigned int maxIndex = 0;
+  for (auto const index : this->indices)
+    maxIndex = std::max(maxIndex, index);
+
+  if (maxIndex <= std::numeric_limits<uint16_t>::max())
+    data->indices16.assign(this->indices.begin(), this->indices.end());
+  else
+    data->indices32.assign(this->indices.begin(), this->indices.end());
+
+  std::vector<ignition::math::Vector3d>().swap(this->vertices);
+  std::vector<ignition::math::Vector3d>().swap(this->normals);
+  std::vector<ignition::math::Vector2d>().swap(this->texCoords);
+  std::vector<unsigned int>().swap(this->indices);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SubMesh::Expand()
+{
+  SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride == 0)
+    return;
+
+  const unsigned int count = this->GetVertexCount();
+  this->vertices.resize(count);
+  this->normals.resize(this->GetNormalCount());
+  this->texCoords.resize(this->GetTexCoordCount());
+  this->indices.resize(this->GetIndexCount());
+
+  for (unsigned int i = 0; i < count; ++i)
+    this->vertices[i] = this->Vertex(i);
+  for (unsigned int i = 0; i < this->normals.size(); ++i)
+    this->normals[i] = this->Normal(i);
+  for (unsigned int i = 0; i < this->texCoords.size(); ++i)
+    this->texCoords[i] = this->TexCoord(i);
+  for (unsigned int i = 0; i < this->indices.size(); ++i)
+    this->indices[i] = data->CompactIndex(i);
+
+  std::vector<float>().swap(data->vertexBuffer);
+  std::vector<uint16_t>().swap(data->indices16);
+  std::vector<uint32_t>().swap(data->indices32);
+  data->vertexStride = 0;
+  data->normalOffset = -1;
+  data->texCoordOffset = -1;
+}
+
+//////////////////////////////////////////////////
+bool SubMesh::IsCompact() const
+{
+  return this->SubMeshData()->vertexStride > 0;
+}
+
+//////////////////////////////////////////////////
+const float *SubMesh::VertexBuffer() const
+{
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride == 0)
+    return nullptr;
+  return data->vertexBuffer.data();
+}
+
+//////////////////////////////////////////////////
+unsigned int SubMesh::VertexStride() const
+{
+  return this->SubMeshData()->vertexStride;
+}
+
+//////////////////////////////////////////////////
+int SubMesh::NormalOffset() const
+{
+  return this->SubMeshData()->normalOffset;
+}
+
+//////////////////////////////////////////////////
+int SubMesh::TexCoordOffset() const
+{
+  return this->SubMeshData()->texCoordOffset;
+}
+
+//////////////////////////////////////////////////
+const void *SubMesh::IndexBuffer() const
+{
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride == 0)
+    return nullptr;
+  if (!data->indices32.empty())
+    return data->indices32.data();
+  return data->indices16.data();
+}
+
+//////////////////////////////////////////////////
+unsigned int SubMesh::IndexSize() const
+{
+  const SubMeshPrivate *data = this->SubMeshData();
+  if (data->vertexStride == 0)
+    return 0;
+  return data->indices32.empty() ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+//////////////////////////////////////////////////
+size_t SubMesh::MemorySize() const
+{
+  const SubMeshPrivate *data = this->SubMeshData();
+  return this->vertices.capacity() * sizeof(this->vertices[0]) +
+    this->normals.capacity() * sizeof(this->normals[0]) +
+    this->texCoords.capacity() * sizeof(this->texCoords[0]) +
+    this->indices.capacity() * sizeof(this->indices[0]) +
+    data->vertexBuffer.capacity() * sizeof(data->vertexBuffer[0]) +
+    data->indices16.capacity() * sizeof(data->indices16[0]) +
+    data->indices32.capacity() * sizeof(data->indices32[0]) +
+    this->nodeAssignments.capacity() * sizeof(this->nodeAssignments[0]);
+}
+
 //////////////////////////////////////////////////
 void SubMesh::RecalculateNormals()
 {
+  this->Expand();
   unsigned int i;
   if (normals.size() < 3)
     return;
@@ -854,6 +1264,7 @@ void Mesh::GetAABB(ignition::math::Vector3d &_center,
 //////////////////////////////////////////////////
 void SubMesh::GenSphericalTexCoord(const ignition::math::Vector3d &_center)
 {
+  this->Expand();
   std::vector<ignition::math::Vector3d>::const_iterator viter;
   for (viter = this->vertices.begin(); viter != this->vertices.end(); ++viter)
   {
@@ -875,6 +1286,7 @@ void SubMesh::GenSphericalTexCoord(const ignition::math::Vector3d &_center)
 //////////////////////////////////////////////////
 void SubMesh::Scale(double _factor)
 {
+  this->Expand();
   for (auto &vert : this->vertices)
     vert *= _factor;
 }
@@ -882,6 +1294,7 @@ void SubMesh::Scale(double _factor)
 //////////////////////////////////////////////////
 void SubMesh::SetScale(const ignition::math::Vector3d &_factor)
 {
+  this->Expand();
   for (auto &vert : this->vertices)
     vert *= _factor;
 }
@@ -900,6 +1313,7 @@ void SubMesh::Center(const ignition::math::Vector3d &_center)
 //////////////////////////////////////////////////
 void SubMesh::Translate(const ignition::math::Vector3d &_vec)
 {
+  this->Expand();
   for (auto &vert : this->vertices)
     vert += _vec;
 }
@@ -34,6 +34,9 @@ namespace gazebo
     class SubMesh;
     class Skeleton;
 
+    // Forward declare private data class
+    class SubMeshPrivate;
+
     /// \addtogroup gazebo_common Common
     /// \{
 
@@ -87,6 +90,11 @@ namespace gazebo
       /// \return the count
       public: unsigned int GetTexCoordCount() const;
 
+      /// \brief Get the memory held by the vertex and index data of the
+      /// submeshes.
+      /// \return Size in bytes.
+      public: size_t MemorySize() const;
+
       /// \brief Add a submesh mesh.
       /// The Mesh object takes ownership of the submesh.
       /// \param[in] _child the submesh
@@ -131,6 +139,11 @@ namespace gazebo
       /// \param[out] _indArr the index array
       public: void FillArrays(float **_vertArr, int **_indArr) const;
 
+      /// \brief Convert all the submeshes to compact storage.
+      /// \return Number of submeshes that are compact.
+      /// \sa SubMesh::Compact
+      public: unsigned int Compact();
+
       /// \brief Recalculate all the normals of each face defined by three
       /// indices.
       public: void RecalculateNormals();
@@ -396,6 +409,60 @@ namespace gazebo
       /// \param[in] _indArr
       public: void FillArrays(float **_vertArr, int **_indArr) const;
 
+      /// \brief Convert the submesh to compact storage. The vertices,
+      /// normals and texture coordinates are interleaved in a single float
+      /// buffer, and the indices are stored with 16 bits when the vertex
+      /// count allows it, 32 bits otherwise. Rendering and physics engines
+      /// can use these buffers directly.
+      ///
+      /// The accessors keep working on a compact submesh, with float
+      /// precision. Functions that modify the submesh convert it back to
+      /// the default storage first.
+      /// \return False if the normal or texture coordinate count doesn't
+      /// match the vertex count, in which case the storage is unchanged.
+      public: bool Compact();
+
+      /// \brief Get whether the submesh uses compact storage.
+      /// \return True after a successful call to Compact, until the
+      /// submesh is modified.
+      public: bool IsCompact() const;
+
+      /// \brief Get the interleaved vertex buffer of a compact submesh.
+      /// Each vertex is a position, followed by a normal and a texture
+      /// coordinate when the submesh has them.
+      /// \return VertexStride() floats per vertex, or nullptr if the
+      /// submesh is not compact.
+      public: const float *VertexBuffer() const;
+
+      /// \brief Get the number of floats per vertex of VertexBuffer().
+      /// \return 3, 5, 6 or 8, or 0 if the submesh is not compact.
+      public: unsigned int VertexStride() const;
+
+      /// \brief Get the offset of the normal in each vertex of
+      /// VertexBuffer().
+      /// \return Offset in floats, or -1 if there are no normals or the
+      /// submesh is not compact.
+      public: int NormalOffset() const;
+
+      /// \brief Get the offset of the texture coordinate in each vertex of
+      /// VertexBuffer().
+      /// \return Offset in floats, or -1 if there are no texture
+      /// coordinates or the submesh is not compact.
+      public: int TexCoordOffset() const;
+
+      /// \brief Get the index buffer of a compact submesh.
+      /// \return GetIndexCount() indices of IndexSize() bytes each, or
+      /// nullptr if the submesh is not compact.
+      public: const void *IndexBuffer() const;
+
+      /// \brief Get the size of each index of IndexBuffer().
+      /// \return 2 or 4 bytes, or 0 if the submesh is not compact.
+      public: unsigned int IndexSize() const;
+
+      /// \brief Get the memory held by the vertex and index data.
+      /// \return Size in bytes.
+      public: size_t MemorySize() const;
+
       /// \brief Recalculate all the normals.
       public: void RecalculateNormals();
 
@@ -423,6 +490,16 @@ namespace gazebo
       /// \param[in] _factor Scaling vector
       public: void SetScale(const ignition::math::Vector3d &_factor);
 
+      /// \brief Convert a compact submesh back to the default storage, so
+      /// that it can be modified.
+      private: void Expand();
+
+      /// \internal
+      /// \brief Get the private data of this submesh. It is kept out of
+      /// the class so that its layout doesn't change.
+      /// \return The private data.
+      private: SubMeshPrivate *SubMeshData() const;
+
       /// \brief the vertex array
       private: std::vector<ignition::math::Vector3d> vertices;
 
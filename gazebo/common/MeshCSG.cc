@@ -15,7 +15,14 @@
  *
  */
 
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <gts.h>
 
 #include "gazebo/common/Assert.hh"
@@ -24,11 +31,99 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Mesh.hh"
 #include "gazebo/common/MeshCSG.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/MeshManager.hh"
 
 using namespace gazebo;
 using namespace common;
 
+/// \brief Version of the cache keys, to change when the results of the
+/// boolean operations change.
+static const uint32_t kCacheVersion = 1;
+
+/// \brief Maximum number of results cached in memory.
+static const size_t kCacheSize = 128;
+
+/// \brief Results cached in memory, shared by the instances of MeshCSG.
+class MeshCSGCache
+{
+  /// \brief Protects the other fields.
+  public: std::mutex mutex;
+
+  /// \brief Results by key.
+  public: std::unordered_map<uint64_t, std::unique_ptr<Mesh>> meshes;
+
+  /// \brief Keys in insertion order, the oldest is evicted first.
+  public: std::deque<uint64_t> order;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the cache of the process.
+/// \return The cache.
+static MeshCSGCache &Cache()
+{
+  static MeshCSGCache cache;
+  return cache;
+}
+
+//////////////////////////////////////////////////
+/// \brief Update an FNV-1a hash with bytes.
+/// \param[in] _data The data.
+/// \param[in] _size Number of bytes.
+/// \param[in,out] _hash The hash.
+static void HashBytes(const void *_data, const size_t _size, uint64_t &_hash)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(_data);
+  for (size_t i = 0; i < _size; ++i)
+  {
+    _hash ^= bytes[i];
+    _hash *= 1099511628211ULL;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Update a hash with the vertices and indices of a mesh.
+/// \param[in] _mesh The mesh.
+/// \param[in,out] _hash The hash.
+static void HashMesh(const Mesh *_mesh, uint64_t &_hash)
+{
+  const unsigned int subMeshCount = _mesh->GetSubMeshCount();
+  HashBytes(&subMeshCount, sizeof(subMeshCount), _hash);
+  for (unsigned int i = 0; i < subMeshCount; ++i)
+  {
+    const SubMesh *subMesh = _mesh->GetSubMesh(i);
+
+    const unsigned int vertexCount = subMesh->GetVertexCount();
+    HashBytes(&vertexCount, sizeof(vertexCount), _hash);
+    for (unsigned int j = 0; j < vertexCount; ++j)
+    {
+      const ignition::math::Vector3d v = subMesh->Vertex(j);
+      const double xyz[3] = {v.X(), v.Y(), v.Z()};
+      HashBytes(xyz, sizeof(xyz), _hash);
+    }
+
+    const unsigned int indexCount = subMesh->GetIndexCount();
+    HashBytes(&indexCount, sizeof(indexCount), _hash);
+    for (unsigned int j = 0; j < indexCount; ++j)
+    {
+      const unsigned int index = subMesh->GetIndex(j);
+      HashBytes(&index, sizeof(index), _hash);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Copy the submeshes of a mesh.
+/// \param[in] _mesh The mesh.
+/// \return New mesh, owned by the caller.
+static Mesh *CopyMesh(const Mesh *_mesh)
+{
+  Mesh *mesh = new Mesh();
+  for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+    mesh->AddSubMesh(new SubMesh(_mesh->GetSubMesh(i)));
+  return mesh;
+}
+
 //////////////////////////////////////////////////
 MeshCSG::MeshCSG()
 {
@@ -138,6 +233,72 @@ static void FillFace(GtsTriangle *_t, gpointer *_data)
 //////////////////////////////////////////////////
 Mesh *MeshCSG::CreateBoolean(const Mesh *_m1, const Mesh *_m2, int _operation,
     const ignition::math::Pose3d &_offset)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  HashBytes(&kCacheVersion, sizeof(kCacheVersion), hash);
+  HashBytes(&_operation, sizeof(_operation), hash);
+  const double pose[7] = {_offset.Pos().X(), _offset.Pos().Y(),
+      _offset.Pos().Z(), _offset.Rot().W(), _offset.Rot().X(),
+      _offset.Rot().Y(), _offset.Rot().Z()};
+  HashBytes(pose, sizeof(pose), hash);
+  HashMesh(_m1, hash);
+  HashMesh(_m2, hash);
+
+  MeshCSGCache &cache = Cache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto iter = cache.meshes.find(hash);
+    if (iter != cache.meshes.end())
+      return CopyMesh(iter->second.get());
+  }
+
+  std::ostringstream stream;
+  stream << "csg_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+  const std::string key = stream.str();
+  const std::string cachePath = MeshManager::Instance()->CachePath();
+
+  // Computed without holding the lock, GTS is only used from one thread
+  std::unique_ptr<Mesh> mesh;
+  if (!cachePath.empty())
+    mesh.reset(MeshCache::Load(cachePath, key));
+  if (!mesh)
+  {
+    mesh.reset(this->Compute(_m1, _m2, _operation, _offset));
+    // Failures are not cached, so that they are reported each time
+    if (!mesh)
+      return nullptr;
+    if (!cachePath.empty())
+      MeshCache::Save(cachePath, key, mesh.get());
+  }
+
+  Mesh *result = CopyMesh(mesh.get());
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.meshes.find(hash) == cache.meshes.end())
+  {
+    if (cache.order.size() >= kCacheSize)
+    {
+      cache.meshes.erase(cache.order.front());
+      cache.order.pop_front();
+    }
+    cache.meshes[hash] = std::move(mesh);
+    cache.order.push_back(hash);
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+void MeshCSG::ClearCache()
+{
+  MeshCSGCache &cache = Cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.meshes.clear();
+  cache.order.clear();
+}
+
+//////////////////////////////////////////////////
+Mesh *MeshCSG::Compute(const Mesh *_m1, const Mesh *_m2, const int _operation,
+    const ignition::math::Pose3d &_offset)
 {
   GtsSurface *s1, *s2, *s3;
   GtsSurfaceInter *si;
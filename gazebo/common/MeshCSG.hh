@@ -48,16 +48,35 @@ namespace gazebo
       /// \brief Destructor.
       public: virtual ~MeshCSG();
 
-      /// \brief Create a boolean mesh from two meshes
+      /// \brief Create a boolean mesh from two meshes.
+      ///
+      /// Results are cached by a hash of the operation, the offset and the
+      /// vertices and indices of both meshes: in memory for the process,
+      /// and on disk in the MeshManager cache path, so that the same
+      /// operation on the same meshes is computed once.
       /// \param[in] _m1 the parent mesh in the boolean operation
       /// \param[in] _m2 the child mesh in the boolean operation
       /// \param[in] _operation the boolean operation applied to the two meshes
       /// \param[in] _offset _m2's pose offset from _m1
-      /// \return a pointer to the created mesh
+      /// \return a pointer to the created mesh, owned by the caller, or
+      /// nullptr on failure
       public: Mesh *CreateBoolean(const Mesh *_m1, const Mesh *_m2,
           const int _operation,
           const ignition::math::Pose3d &_offset = ignition::math::Pose3d::Zero);
 
+      /// \brief Clear the results cached in memory by CreateBoolean. The
+      /// results cached on disk are kept.
+      public: static void ClearCache();
+
+      /// \brief Compute a boolean mesh, without the cache.
+      /// \param[in] _m1 the parent mesh in the boolean operation
+      /// \param[in] _m2 the child mesh in the boolean operation
+      /// \param[in] _operation the boolean operation applied to the two meshes
+      /// \param[in] _offset _m2's pose offset from _m1
+      /// \return a pointer to the created mesh, or nullptr on failure
+      private: Mesh *Compute(const Mesh *_m1, const Mesh *_m2,
+          const int _operation, const ignition::math::Pose3d &_offset);
+
       /// \brief Helper method for converting Mesh to GTS Surface
       private: void ConvertMeshToGTS(const Mesh *mesh, GtsSurface *surface);
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCSG.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshCSG : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Check that two meshes have the same vertices and indices.
+/// \param[in] _m1 First mesh.
+/// \param[in] _m2 Second mesh.
+static void ExpectSameMesh(const common::Mesh *_m1, const common::Mesh *_m2)
+{
+  ASSERT_EQ(_m1->GetSubMeshCount(), _m2->GetSubMeshCount());
+  for (unsigned int i = 0; i < _m1->GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *s1 = _m1->GetSubMesh(i);
+    const common::SubMesh *s2 = _m2->GetSubMesh(i);
+    ASSERT_EQ(s1->GetVertexCount(), s2->GetVertexCount());
+    ASSERT_EQ(s1->GetIndexCount(), s2->GetIndexCount());
+    for (unsigned int j = 0; j < s1->GetVertexCount(); ++j)
+      EXPECT_EQ(s1->Vertex(j), s2->Vertex(j));
+    for (unsigned int j = 0; j < s1->GetIndexCount(); ++j)
+      EXPECT_EQ(s1->GetIndex(j), s2->GetIndex(j));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCSG, CachedBoolean)
+{
+  common::MeshManager *mgr = common::MeshManager::Instance();
+  const std::string oldCachePath = mgr->CachePath();
+  const boost::filesystem::path cachePath =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_csg_cache_%%%%");
+  mgr->SetCachePath(cachePath.string());
+  common::MeshCSG::ClearCache();
+
+  mgr->CreateBox("csg_wall", ignition::math::Vector3d(4, 0.2, 2),
+      ignition::math::Vector2d(1, 1));
+  mgr->CreateBox("csg_window", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector2d(1, 1));
+  const common::Mesh *wall = mgr->GetMesh("csg_wall");
+  const common::Mesh *window = mgr->GetMesh("csg_window");
+  ASSERT_NE(nullptr, wall);
+  ASSERT_NE(nullptr, window);
+
+  const ignition::math::Pose3d offset(1, 0, 0.2, 0, 0, 0);
+  common::MeshCSG csg;
+  std::unique_ptr<common::Mesh> computed(csg.CreateBoolean(wall, window,
+      common::MeshCSG::DIFFERENCE, offset));
+  ASSERT_NE(nullptr, computed);
+  EXPECT_GT(computed->GetVertexCount(), 0u);
+
+  // Saved to disk
+  unsigned int files = 0;
+  for (boost::filesystem::directory_iterator it(cachePath);
+      it != boost::filesystem::directory_iterator(); ++it)
+  {
+    EXPECT_EQ(".mesh", it->path().extension().string());
+    ++files;
+  }
+  EXPECT_EQ(1u, files);
+
+  // From memory, as a copy owned by the caller
+  std::unique_ptr<common::Mesh> cached(csg.CreateBoolean(wall, window,
+      common::MeshCSG::DIFFERENCE, offset));
+  ASSERT_NE(nullptr, cached);
+  EXPECT_NE(computed.get(), cached.get());
+  ExpectSameMesh(computed.get(), cached.get());
+
+  // From disk
+  common::MeshCSG::ClearCache();
+  std::unique_ptr<common::Mesh> loaded(csg.CreateBoolean(wall, window,
+      common::MeshCSG::DIFFERENCE, offset));
+  ASSERT_NE(nullptr, loaded);
+  ExpectSameMesh(computed.get(), loaded.get());
+
+  // Another offset is another result
+  const ignition::math::Pose3d offset2(-1, 0, 0.2, 0, 0, 0);
+  std::unique_ptr<common::Mesh> moved(csg.CreateBoolean(wall, window,
+      common::MeshCSG::DIFFERENCE, offset2));
+  ASSERT_NE(nullptr, moved);
+  files = 0;
+  for (boost::filesystem::directory_iterator it(cachePath);
+      it != boost::filesystem::directory_iterator(); ++it)
+  {
+    ++files;
+  }
+  EXPECT_EQ(2u, files);
+
+  common::MeshCSG::ClearCache();
+  mgr->SetCachePath(oldCachePath);
+  boost::filesystem::remove_all(cachePath);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
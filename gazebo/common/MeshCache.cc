@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Magic string at the start of a mesh cache file.
+static const char MESH_CACHE_MAGIC[8] = {'G', 'Z', 'M', 'E', 'S', 'H', 'C',
+  '\0'};
+
+/// \brief Arrays in a cache file are aligned to this many bytes.
+static const size_t MESH_CACHE_ALIGNMENT = 8;
+
+//////////////////////////////////////////////////
+/// \brief Append the bytes of a value to a buffer.
+/// \param[in,out] _buffer Buffer to append to.
+/// \param[in] _value Value to append.
+template<typename T>
+static void Append(std::string &_buffer, const T &_value)
+{
+  _buffer.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+//////////////////////////////////////////////////
+/// \brief Append a length prefixed string to a buffer.
+/// \param[in,out] _buffer Buffer to append to.
+/// \param[in] _value String to append.
+static void AppendString(std::string &_buffer, const std::string &_value)
+{
+  Append(_buffer, static_cast<uint32_t>(_value.size()));
+  _buffer.append(_value);
+}
+
+//////////////////////////////////////////////////
+/// \brief Append a color to a buffer.
+/// \param[in,out] _buffer Buffer to append to.
+/// \param[in] _color Color to append.
+static void AppendColor(std::string &_buffer,
+    const ignition::math::Color &_color)
+{
+  Append(_buffer, _color.R());
+  Append(_buffer, _color.G());
+  Append(_buffer, _color.B());
+  Append(_buffer, _color.A());
+}
+
+//////////////////////////////////////////////////
+/// \brief Pad a buffer up to the alignment of arrays.
+/// \param[in,out] _buffer Buffer to pad.
+static void AppendPadding(std::string &_buffer)
+{
+  const size_t rem = _buffer.size() % MESH_CACHE_ALIGNMENT;
+  if (rem != 0)
+    _buffer.append(MESH_CACHE_ALIGNMENT - rem, '\0');
+}
+
+//////////////////////////////////////////////////
+/// \brief Reads values from a mapped cache file, checking that they lie
+/// inside the file.
+class MeshCacheReader
+{
+  /// \brief Constructor.
+  /// \param[in] _data Start of the file.
+  /// \param[in] _size Size of the file.
+  public: MeshCacheReader(const char *_data, const size_t _size)
+          : data(_data), size(_size)
+  {
+  }
+
+  /// \brief Get a pointer to the next bytes, and skip them.
+  /// \param[in] _bytes Number of bytes.
+  /// \return Pointer to the bytes, nullptr if past the end of the file.
+  public: const char *Span(const size_t _bytes)
+  {
+    if (_bytes > this->size - this->offset)
+      return nullptr;
+    const char *result = this->data + this->offset;
+    this->offset += _bytes;
+    return result;
+  }
+
+  /// \brief Read a value.
+  /// \param[out] _value Value read.
+  /// \return False if past the end of the file.
+  public: template<typename T>
+          bool Read(T &_value)
+  {
+    const char *bytes = this->Span(sizeof(T));
+    if (!bytes)
+      return false;
+    std::memcpy(&_value, bytes, sizeof(T));
+    return true;
+  }
+
+  /// \brief Read a length prefixed string.
+  /// \param[out] _value String read.
+  /// \return False if past the end of the file.
+  public: bool ReadString(std::string &_value)
+  {
+    uint32_t length = 0;
+    if (!this->Read(length))
+      return false;
+    const char *bytes = this->Span(length);
+    if (!bytes)
+      return false;
+    _value.assign(bytes, length);
+    return true;
+  }
+
+  /// \brief Read a color.
+  /// \param[out] _color Color read.
+  /// \return False if past the end of the file.
+  public: bool ReadColor(ignition::math::Color &_color)
+  {
+    float r, g, b, a;
+    if (!this->Read(r) || !this->Read(g) || !this->Read(b) || !this->Read(a))
+      return false;
+    _color.Set(r, g, b, a);
+    return true;
+  }
+
+  /// \brief Skip the padding before an array.
+  /// \return False if past the end of the file.
+  public: bool SkipPadding()
+  {
+    const size_t rem = this->offset % MESH_CACHE_ALIGNMENT;
+    return rem == 0 || this->Span(MESH_CACHE_ALIGNMENT - rem) != nullptr;
+  }
+
+  /// \brief Start of the file.
+  private: const char *data;
+
+  /// \brief Size of the file.
+  private: size_t size;
+
+  /// \brief Offset of the next value.
+  private: size_t offset = 0;
+};
+
+//////////////////////////////////////////////////
+/// \brief Read a material from a cache file.
+/// \param[in] _reader Reader of the file.
+/// \return New material, nullptr if the file is truncated.
+static Material *ReadMaterial(MeshCacheReader &_reader)
+{
+  std::string texture;
+  ignition::math::Color ambient, diffuse, specular, emissive;
+  double transparency, shininess, srcFactor, dstFactor, pointSize;
+  uint32_t blendMode, shadeMode;
+  uint8_t depthWrite, lighting;
+
+  if (!_reader.ReadString(texture) || !_reader.ReadColor(ambient) ||
+      !_reader.ReadColor(diffuse) || !_reader.ReadColor(specular) ||
+      !_reader.ReadColor(emissive) || !_reader.Read(transparency) ||
+      !_reader.Read(shininess) || !_reader.Read(srcFactor) ||
+      !_reader.Read(dstFactor) || !_reader.Read(pointSize) ||
+      !_reader.Read(blendMode) || !_reader.Read(shadeMode) ||
+      !_reader.Read(depthWrite) || !_reader.Read(lighting) ||
+      blendMode >= Material::BLEND_COUNT || shadeMode >= Material::SHADE_COUNT)
+  {
+    return nullptr;
+  }
+
+  Material *material = new Material();
+  material->SetTextureImage(texture);
+  material->SetAmbient(ambient);
+  material->SetDiffuse(diffuse);
+  material->SetSpecular(specular);
+  material->SetEmissive(emissive);
+  material->SetTransparency(transparency);
+  material->SetShininess(shininess);
+  material->SetBlendFactors(srcFactor, dstFactor);
+  material->SetPointSize(pointSize);
+  material->SetBlendMode(static_cast<Material::BlendMode>(blendMode));
+  material->SetShadeMode(static_cast<Material::ShadeMode>(shadeMode));
+  material->SetDepthWrite(depthWrite != 0);
+  material->SetLighting(lighting != 0);
+  return material;
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a submesh from a cache file.
+/// \param[in] _reader Reader of the file.
+/// \return New submesh, nullptr if the file is truncated.
+static SubMesh *ReadSubMesh(MeshCacheReader &_reader)
+{
+  std::string name;
+  uint32_t primitiveType, vertexCount, normalCount, texCoordCount,
+           indexCount;
+  int32_t materialIndex;
+
+  if (!_reader.ReadString(name) || !_reader.Read(primitiveType) ||
+      !_reader.Read(materialIndex) || !_reader.Read(vertexCount) ||
+      !_reader.Read(normalCount) || !_reader.Read(texCoordCount) ||
+      !_reader.Read(indexCount) || !_reader.SkipPadding() ||
+      primitiveType > SubMesh::TRISTRIPS)
+  {
+    return nullptr;
+  }
+
+  const char *vertices = _reader.Span(vertexCount * 3 * sizeof(double));
+  const char *normals = _reader.Span(normalCount * 3 * sizeof(double));
+  const char *texCoords = _reader.Span(texCoordCount * 2 * sizeof(double));
+  const char *indices = _reader.Span(indexCount * sizeof(uint32_t));
+  if (!vertices || !normals || !texCoords || !indices ||
+      !_reader.SkipPadding())
+  {
+    return nullptr;
+  }
+
+  std::unique_ptr<SubMesh> subMesh(new SubMesh());
+  subMesh->SetName(name);
+  subMesh->SetPrimitiveType(static_cast<SubMesh::PrimitiveType>(
+        primitiveType));
+  if (materialIndex >= 0)
+    subMesh->SetMaterialIndex(materialIndex);
+
+  double v[3];
+  subMesh->SetVertexCount(vertexCount);
+  for (uint32_t i = 0; i < vertexCount; ++i)
+  {
+    std::memcpy(v, vertices + i * sizeof(v), sizeof(v));
+    subMesh->SetVertex(i, ignition::math::Vector3d(v[0], v[1], v[2]));
+  }
+
+  subMesh->SetNormalCount(normalCount);
+  for (uint32_t i = 0; i < normalCount; ++i)
+  {
+    std::memcpy(v, normals + i * sizeof(v), sizeof(v));
+    subMesh->SetNormal(i, ignition::math::Vector3d(v[0], v[1], v[2]));
+  }
+
+  subMesh->SetTexCoordCount(texCoordCount);
+  for (uint32_t i = 0; i < texCoordCount; ++i)
+  {
+    std::memcpy(v, texCoords + i * 2 * sizeof(double), 2 * sizeof(double));
+    subMesh->SetTexCoord(i, ignition::math::Vector2d(v[0], v[1]));
+  }
+
+  for (uint32_t i = 0; i < indexCount; ++i)
+  {
+    uint32_t index;
+    std::memcpy(&index, indices + i * sizeof(index), sizeof(index));
+    subMesh->AddIndex(index);
+  }
+
+  return subMesh.release();
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::Key(const std::string &_filename)
+{
+  std::ifstream in(_filename, std::ios::binary);
+  if (!in)
+    return std::string();
+
+  // The path is part of the key, since materials hold texture paths
+  // resolved relative to the mesh file.
+  std::string content = _filename;
+  content += '\0';
+  content.append(std::istreambuf_iterator<char>(in),
+      std::istreambuf_iterator<char>());
+  return common::get_sha1<std::string>(content);
+}
+
+//////////////////////////////////////////////////
+Mesh *MeshCache::Load(const std::string &_path, const std::string &_key)
+{
+  if (_path.empty() || _key.empty())
+    return nullptr;
+
+  const boost::filesystem::path filename =
+    boost::filesystem::path(_path) / (_key + ".mesh");
+
+  boost::system::error_code errorCode;
+  if (!boost::filesystem::exists(filename, errorCode) ||
+      boost::filesystem::file_size(filename, errorCode) == 0 || errorCode)
+  {
+    return nullptr;
+  }
+
+  boost::iostreams::mapped_file_source file;
+  try
+  {
+    file.open(filename.string());
+  }
+  catch(std::exception &_e)
+  {
+    gzwarn << "Unable to map mesh cache file[" << filename.string() << "]: "
+           << _e.what() << std::endl;
+    return nullptr;
+  }
+
+  MeshCacheReader reader(file.data(), file.size());
+
+  const char *magic = reader.Span(sizeof(MESH_CACHE_MAGIC));
+  uint32_t version = 0;
+  if (!magic ||
+      std::memcmp(magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 ||
+      !reader.Read(version) || version != GZ_MESH_CACHE_VERSION)
+  {
+    return nullptr;
+  }
+
+  std::string name, path;
+  uint32_t materialCount = 0, subMeshCount = 0;
+  if (!reader.ReadString(name) || !reader.ReadString(path) ||
+      !reader.Read(materialCount) || !reader.Read(subMeshCount))
+  {
+    gzwarn << "Truncated mesh cache file[" << filename.string() << "]\n";
+    return nullptr;
+  }
+
+  std::unique_ptr<Mesh> mesh(new Mesh());
+  mesh->SetName(name);
+  mesh->SetPath(path);
+
+  for (uint32_t i = 0; i < materialCount; ++i)
+  {
+    Material *material = ReadMaterial(reader);
+    if (!material)
+    {
+      gzwarn << "Truncated mesh cache file[" << filename.string() << "]\n";
+      return nullptr;
+    }
+    mesh->AddMaterial(material);
+  }
+
+  for (uint32_t i = 0; i < subMeshCount; ++i)
+  {
+    SubMesh *subMesh = ReadSubMesh(reader);
+    if (!subMesh)
+    {
+      gzwarn << "Truncated mesh cache file[" << filename.string() << "]\n";
+      return nullptr;
+    }
+    mesh->AddSubMesh(subMesh);
+  }
+
+  return mesh.release();
+}
+
+//////////////////////////////////////////////////
+bool MeshCache::Save(const std::string &_path, const std::string &_key,
+    const Mesh *_mesh)
+{
+  if (_path.empty() || _key.empty() || !_mesh || _mesh->HasSkeleton())
+    return false;
+
+  std::string buffer(MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+  Append(buffer, static_cast<uint32_t>(GZ_MESH_CACHE_VERSION));
+  AppendString(buffer, _mesh->GetName());
+  AppendString(buffer, _mesh->GetPath());
+  Append(buffer, static_cast<uint32_t>(_mesh->GetMaterialCount()));
+  Append(buffer, static_cast<uint32_t>(_mesh->GetSubMeshCount()));
+
+  for (unsigned int i = 0; i < _mesh->GetMaterialCount(); ++i)
+  {
+    const Material *material = _mesh->GetMaterial(i);
+    double srcFactor, dstFactor;
+    material->GetBlendFactors(srcFactor, dstFactor);
+
+    AppendString(buffer, material->GetTextureImage());
+    AppendColor(buffer, material->Ambient());
+    AppendColor(buffer, material->Diffuse());
+    AppendColor(buffer, material->Specular());
+    AppendColor(buffer, material->Emissive());
+    Append(buffer, material->GetTransparency());
+    Append(buffer, material->GetShininess());
+    Append(buffer, srcFactor);
+    Append(buffer, dstFactor);
+    Append(buffer, material->GetPointSize());
+    Append(buffer, static_cast<uint32_t>(material->GetBlendMode()));
+    Append(buffer, static_cast<uint32_t>(material->GetShadeMode()));
+    Append(buffer, static_cast<uint8_t>(material->GetDepthWrite()));
+    Append(buffer, static_cast<uint8_t>(material->GetLighting()));
+  }
+
+  for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh->GetSubMesh(i);
+    AppendString(buffer, subMesh->GetName());
+    Append(buffer, static_cast<uint32_t>(subMesh->GetPrimitiveType()));
+    Append(buffer, static_cast<int32_t>(subMesh->GetMaterialIndex()));
+    Append(buffer, static_cast<uint32_t>(subMesh->GetVertexCount()));
+    Append(buffer, static_cast<uint32_t>(subMesh->GetNormalCount()));
+    Append(buffer, static_cast<uint32_t>(subMesh->GetTexCoordCount()));
+    Append(buffer, static_cast<uint32_t>(subMesh->GetIndexCount()));
+    AppendPadding(buffer);
+
+    for (unsigned int v = 0; v < subMesh->GetVertexCount(); ++v)
+    {
+      const ignition::math::Vector3d vertex = subMesh->Vertex(v);
+      Append(buffer, vertex.X());
+      Append(buffer, vertex.Y());
+      Append(buffer, vertex.Z());
+    }
+    for (unsigned int n = 0; n < subMesh->GetNormalCount(); ++n)
+    {
+      const ignition::math::Vector3d normal = subMesh->Normal(n);
+      Append(buffer, normal.X());
+      Append(buffer, normal.Y());
+      Append(buffer, normal.Z());
+    }
+    for (unsigned int t = 0; t < subMesh->GetTexCoordCount(); ++t)
+    {
+      const ignition::math::Vector2d texCoord = subMesh->TexCoord(t);
+      Append(buffer, texCoord.X());
+      Append(buffer, texCoord.Y());
+    }
+    for (unsigned int n = 0; n < subMesh->GetIndexCount(); ++n)
+      Append(buffer, static_cast<uint32_t>(subMesh->GetIndex(n)));
+    AppendPadding(buffer);
+  }
+
+  boost::system::error_code errorCode;
+  boost::filesystem::create_directories(_path, errorCode);
+  if (errorCode)
+  {
+    gzwarn << "Unable to create mesh cache directory[" << _path << "]\n";
+    return false;
+  }
+
+  // Write to a temporary file first, so that other processes never map a
+  // partial file.
+  const boost::filesystem::path filename =
+    boost::filesystem::path(_path) / (_key + ".mesh");
+  const boost::filesystem::path tmp = filename.string() + "." +
+    boost::filesystem::unique_path("%%%%%%%%").string();
+
+  {
+    std::ofstream out(tmp.string(), std::ios::binary);
+    out.write(buffer.data(), buffer.size());
+    if (!out)
+    {
+      gzwarn << "Unable to write mesh cache file[" << tmp.string() << "]\n";
+      out.close();
+      boost::filesystem::remove(tmp, errorCode);
+      return false;
+    }
+  }
+
+  boost::filesystem::rename(tmp, filename, errorCode);
+  if (errorCode)
+  {
+    boost::filesystem::remove(tmp, errorCode);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHCACHE_HH_
+#define GAZEBO_COMMON_MESHCACHE_HH_
+
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+/// \brief Version of the mesh cache file layout. Cache files of other
+/// versions are ignored, and replaced when the mesh is loaded again.
+#define GZ_MESH_CACHE_VERSION 1
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class MeshCache MeshCache.hh common/common.hh
+    /// \brief Functions to store parsed meshes in binary files, so that
+    /// processes loading the same mesh files skip parsing them.
+    ///
+    /// A cache file starts with a magic string and the
+    /// GZ_MESH_CACHE_VERSION, followed by the materials and the submeshes
+    /// of the mesh. The vertices, normals, texture coordinates and indices
+    /// of each submesh are stored as contiguous arrays, which are read
+    /// straight from a memory mapping of the file. Meshes with a skeleton
+    /// are not cached.
+    ///
+    /// Cache files are named by a hash of the path and content of the
+    /// mesh file, so an edited mesh file is parsed again.
+    ///
+    /// \sa MeshManager::SetCachePath
+    class GZ_COMMON_VISIBLE MeshCache
+    {
+      /// \brief Get the cache key of a mesh file.
+      /// \param[in] _filename Complete path to the mesh file.
+      /// \return Hash of the path and content of the file, empty if the
+      /// file can't be read.
+      public: static std::string Key(const std::string &_filename);
+
+      /// \brief Load a mesh from the cache.
+      /// \param[in] _path Cache directory.
+      /// \param[in] _key Cache key of the mesh file.
+      /// \return New mesh, owned by the caller, or nullptr if the mesh is
+      /// not in the cache.
+      public: static Mesh *Load(const std::string &_path,
+                                const std::string &_key);
+
+      /// \brief Save a mesh to the cache.
+      /// \param[in] _path Cache directory, created if needed.
+      /// \param[in] _key Cache key of the mesh file.
+      /// \param[in] _mesh Mesh to save.
+      /// \return True if the mesh was saved, false on error or if the mesh
+      /// has a skeleton.
+      public: static bool Save(const std::string &_path,
+                               const std::string &_key, const Mesh *_mesh);
+    };
+    /// \}
+  }
+}
+#endif
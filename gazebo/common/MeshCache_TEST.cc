@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "test_config.h"
+#include "gazebo/common/ColladaLoader.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+#include "gazebo/common/Skeleton.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshCache : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MeshCache, SaveLoad)
+{
+  const std::string filename =
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/box.dae";
+  const std::string cachePath = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_mesh_cache_%%%%")).string();
+
+  const std::string key = common::MeshCache::Key(filename);
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, common::MeshCache::Key(filename));
+  EXPECT_TRUE(common::MeshCache::Key(filename + "_missing").empty());
+
+  // Nothing cached yet
+  EXPECT_EQ(nullptr, common::MeshCache::Load(cachePath, key));
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(filename));
+  ASSERT_NE(nullptr, mesh);
+  mesh->SetName("box");
+  EXPECT_TRUE(common::MeshCache::Save(cachePath, key, mesh.get()));
+
+  std::unique_ptr<common::Mesh> cached(
+      common::MeshCache::Load(cachePath, key));
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ(mesh->GetName(), cached->GetName());
+  EXPECT_EQ(mesh->GetPath(), cached->GetPath());
+  EXPECT_EQ(mesh->Max(), cached->Max());
+  EXPECT_EQ(mesh->Min(), cached->Min());
+  ASSERT_EQ(mesh->GetSubMeshCount(), cached->GetSubMeshCount());
+  ASSERT_EQ(mesh->GetMaterialCount(), cached->GetMaterialCount());
+
+  for (unsigned int i = 0; i < mesh->GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *subMesh = mesh->GetSubMesh(i);
+    const common::SubMesh *cachedSubMesh = cached->GetSubMesh(i);
+    EXPECT_EQ(subMesh->GetName(), cachedSubMesh->GetName());
+    EXPECT_EQ(subMesh->GetPrimitiveType(),
+        cachedSubMesh->GetPrimitiveType());
+    EXPECT_EQ(subMesh->GetMaterialIndex(), cachedSubMesh->GetMaterialIndex());
+    ASSERT_EQ(subMesh->GetVertexCount(), cachedSubMesh->GetVertexCount());
+    ASSERT_EQ(subMesh->GetNormalCount(), cachedSubMesh->GetNormalCount());
+    ASSERT_EQ(subMesh->GetIndexCount(), cachedSubMesh->GetIndexCount());
+    for (unsigned int v = 0; v < subMesh->GetVertexCount(); ++v)
+    {
+      EXPECT_EQ(subMesh->Vertex(v), cachedSubMesh->Vertex(v));
+      EXPECT_EQ(subMesh->Normal(v), cachedSubMesh->Normal(v));
+    }
+    for (unsigned int n = 0; n < subMesh->GetIndexCount(); ++n)
+      EXPECT_EQ(subMesh->GetIndex(n), cachedSubMesh->GetIndex(n));
+  }
+
+  for (unsigned int i = 0; i < mesh->GetMaterialCount(); ++i)
+  {
+    const common::Material *material = mesh->GetMaterial(i);
+    const common::Material *cachedMaterial = cached->GetMaterial(i);
+    EXPECT_EQ(material->GetTextureImage(), cachedMaterial->GetTextureImage());
+    EXPECT_EQ(material->Ambient(), cachedMaterial->Ambient());
+    EXPECT_EQ(material->Diffuse(), cachedMaterial->Diffuse());
+    EXPECT_EQ(material->Specular(), cachedMaterial->Specular());
+    EXPECT_EQ(material->Emissive(), cachedMaterial->Emissive());
+    EXPECT_DOUBLE_EQ(material->GetShininess(),
+        cachedMaterial->GetShininess());
+    EXPECT_DOUBLE_EQ(material->GetTransparency(),
+        cachedMaterial->GetTransparency());
+    EXPECT_EQ(material->GetLighting(), cachedMaterial->GetLighting());
+  }
+
+  // A truncated file is a cache miss
+  const std::string cacheFile = cachePath + "/" + key + ".mesh";
+  boost::filesystem::resize_file(cacheFile,
+      boost::filesystem::file_size(cacheFile) / 2);
+  EXPECT_EQ(nullptr, common::MeshCache::Load(cachePath, key));
+
+  boost::filesystem::remove_all(cachePath);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCache, Skeleton)
+{
+  const std::string cachePath = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_mesh_cache_%%%%")).string();
+
+  // Meshes with a skeleton are not cached
+  common::Mesh mesh;
+  mesh.SetSkeleton(new common::Skeleton());
+  EXPECT_FALSE(common::MeshCache::Save(cachePath, "skeleton", &mesh));
+  EXPECT_FALSE(boost::filesystem::exists(cachePath + "/skeleton.mesh"));
+
+  boost::filesystem::remove_all(cachePath);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
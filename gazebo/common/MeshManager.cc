@@ -16,13 +16,26 @@
  */
 
 #include <sys/stat.h>
-#include <string>
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryAccounting.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/ColladaLoader.hh"
 #include "gazebo/common/ColladaExporter.hh"
 #include "gazebo/common/STLLoader.hh"
@@ -43,19 +56,9 @@ namespace common
 //////////////////////////////////////////////////
 class MeshManagerPrivate
 {
-  /// \brief 3D mesh loader for COLLADA files
-  public: ColladaLoader *colladaLoader = nullptr;
-
   /// \brief 3D mesh exporter for COLLADA files
   public: ColladaExporter *colladaExporter = nullptr;
 
-  /// \brief 3D mesh loader for STL files
-  public: STLLoader *stlLoader = nullptr;
-
-  // \brief 3D mesh loader for FBX files
-  // \todo The FBX loader needs to be implemented.
-  // public: FBXLoader *fbxLoader = nullptr;
-
   /// \brief Dictionary of meshes, indexed by name
   public: std::map<std::string, Mesh*> meshes;
 
@@ -63,21 +66,136 @@ class MeshManagerPrivate
   public: std::vector<std::string> fileExtensions;
 
   /// \brief Mutex to protect from loading the same mesh in different threads
-  /// at the same time.
+  /// at the same time. Different meshes are loaded concurrently.
   public: boost::mutex mutex;
+
+  /// \brief Names of the meshes being loaded. Protected by mutex.
+  public: std::set<std::string> loading;
+
+  /// \brief Signaled when a mesh has been loaded.
+  public: boost::condition_variable loadCondition;
+
+  /// \brief Protects the dictionary of meshes and the levels of detail. It
+  /// is only held briefly, so that a thread can look up meshes while
+  /// another one loads a mesh.
+  public: boost::mutex meshesMutex;
+
+  /// \brief Levels of detail of the meshes, indexed by mesh name. Each
+  /// level holds the indices of every submesh of the mesh.
+  public: std::map<std::string,
+      std::vector<std::vector<std::vector<unsigned int> > > > lods;
+
+  /// \brief Directory of the binary mesh cache, empty if disabled.
+  public: std::string cachePath;
+
+  /// \brief Memory of the meshes, counted when they are added. Protected
+  /// by meshesMutex.
+  public: MemoryAccounting::Account memory{MemoryAccounting::MESHES};
 };
 
+/// \brief Meshes with fewer triangles are not worth reducing.
+static const unsigned int LOD_MIN_TRIANGLES = 1000;
+
+/// \brief A level of detail must keep less than this ratio of the
+/// triangles of the previous level.
+static const double LOD_MAX_RATIO = 0.8;
+
+/// \brief Largest number of grid cells along an axis when clustering.
+static const uint64_t LOD_MAX_CELLS = (1u << 21) - 1;
+
+//////////////////////////////////////////////////
+/// \brief Cluster the vertices of a submesh on a grid, and get the
+/// triangles that remain when each vertex is replaced by the vertex closest
+/// to the center of its cell.
+/// \param[in] _subMesh The submesh to reduce.
+/// \param[in] _min Origin of the grid.
+/// \param[in] _cellSize Size of the cells of the grid.
+/// \return Indices of the remaining triangles.
+static std::vector<unsigned int> ClusterIndices(const SubMesh *_subMesh,
+    const ignition::math::Vector3d &_min, const double _cellSize)
+{
+  std::vector<unsigned int> indices;
+  const unsigned int vertexCount = _subMesh->GetVertexCount();
+
+  if (_subMesh->GetPrimitiveType() != SubMesh::TRIANGLES)
+  {
+    for (unsigned int i = 0; i < _subMesh->GetIndexCount(); ++i)
+      indices.push_back(_subMesh->GetIndex(i));
+    return indices;
+  }
+
+  // Find the cell of each vertex, and the vertex closest to the center of
+  // each cell
+  std::vector<uint64_t> cells(vertexCount);
+  std::unordered_map<uint64_t, std::pair<unsigned int, double> > closest;
+  for (unsigned int v = 0; v < vertexCount; ++v)
+  {
+    ignition::math::Vector3d pos = (_subMesh->Vertex(v) - _min) / _cellSize;
+    uint64_t x = std::min(static_cast<uint64_t>(std::max(pos.X(), 0.0)),
+        LOD_MAX_CELLS);
+    uint64_t y = std::min(static_cast<uint64_t>(std::max(pos.Y(), 0.0)),
+        LOD_MAX_CELLS);
+    uint64_t z = std::min(static_cast<uint64_t>(std::max(pos.Z(), 0.0)),
+        LOD_MAX_CELLS);
+    cells[v] = (x << 42) | (y << 21) | z;
+
+    double dist = pos.Distance(ignition::math::Vector3d(x + 0.5, y + 0.5,
+        z + 0.5));
+    auto iter = closest.find(cells[v]);
+    if (iter == closest.end())
+      closest[cells[v]] = std::make_pair(v, dist);
+    else if (dist < iter->second.second)
+      iter->second = std::make_pair(v, dist);
+  }
+
+  // Keep the triangles that don't collapse, once each
+  std::set<std::tuple<unsigned int, unsigned int, unsigned int> > triangles;
+  for (unsigned int i = 0; i + 2 < _subMesh->GetIndexCount(); i += 3)
+  {
+    unsigned int tri[3];
+    bool valid = true;
+    for (unsigned int j = 0; j < 3 && valid; ++j)
+    {
+      unsigned int index = _subMesh->GetIndex(i + j);
+      valid = index < vertexCount;
+      if (valid)
+        tri[j] = closest[cells[index]].first;
+    }
+
+    if (!valid || tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2])
+      continue;
+
+    unsigned int sorted[3] = {tri[0], tri[1], tri[2]};
+    std::sort(sorted, sorted + 3);
+    if (!triangles.insert(
+          std::make_tuple(sorted[0], sorted[1], sorted[2])).second)
+    {
+      continue;
+    }
+
+    indices.insert(indices.end(), tri, tri + 3);
+  }
+
+  return indices;
+}
+
 // added here for ABI compatibility
 // TODO move to header / private class when merging forward.
-static OBJLoader objLoader;
-
 //////////////////////////////////////////////////
 MeshManager::MeshManager()
   : dataPtr(new MeshManagerPrivate)
 {
-  this->dataPtr->colladaLoader = new ColladaLoader();
   this->dataPtr->colladaExporter = new ColladaExporter();
-  this->dataPtr->stlLoader = new STLLoader();
+
+  const char *cachePath = common::getEnv("GAZEBO_MESH_CACHE");
+  const char *homePath = common::getEnv("HOME");
+  if (cachePath)
+    this->dataPtr->cachePath = cachePath;
+  else if (homePath)
+  {
+    this->dataPtr->cachePath =
+      (boost::filesystem::path(homePath) / ".gazebo" / "mesh_cache").string();
+  }
 
   // Create some basic shapes
   this->CreatePlane("unit_plane",
@@ -116,9 +234,7 @@ MeshManager::MeshManager()
 //////////////////////////////////////////////////
 MeshManager::~MeshManager()
 {
-  delete this->dataPtr->colladaLoader;
   delete this->dataPtr->colladaExporter;
-  delete this->dataPtr->stlLoader;
   for (auto &pairNameMesh : this->dataPtr->meshes)
   {
     delete pairNameMesh.second;
@@ -129,6 +245,27 @@ MeshManager::~MeshManager()
   this->dataPtr = nullptr;
 }
 
+//////////////////////////////////////////////////
+void MeshManager::FinishLoad(const std::string &_filename)
+{
+  boost::mutex::scoped_lock lock(this->dataPtr->mutex);
+  this->dataPtr->loading.erase(_filename);
+  this->dataPtr->loadCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+void MeshManager::SetCachePath(const std::string &_path)
+{
+  boost::mutex::scoped_lock lock(this->dataPtr->mutex);
+  this->dataPtr->cachePath = _path;
+}
+
+//////////////////////////////////////////////////
+std::string MeshManager::CachePath() const
+{
+  return this->dataPtr->cachePath;
+}
+
 //////////////////////////////////////////////////
 const Mesh *MeshManager::Load(const std::string &_filename)
 {
@@ -144,7 +281,7 @@ const Mesh *MeshManager::Load(const std::string &_filename)
 
   if (this->HasMesh(_filename))
   {
-    return this->dataPtr->meshes[_filename];
+    return this->GetMesh(_filename);
 
     // This breaks trimesh geom. Each new trimesh should have a unique name.
     /*
@@ -166,46 +303,75 @@ const Mesh *MeshManager::Load(const std::string &_filename)
     extension = fullname.substr(fullname.rfind(".")+1, fullname.size());
     std::transform(extension.begin(), extension.end(),
         extension.begin(), ::tolower);
-    MeshLoader *loader = nullptr;
+    // Loaders keep state while parsing, so each load uses its own.
+    std::unique_ptr<MeshLoader> loader;
 
     if (extension == "stl" || extension == "stlb" || extension == "stla")
-      loader = this->dataPtr->stlLoader;
+      loader.reset(new STLLoader());
     else if (extension == "dae")
-      loader = this->dataPtr->colladaLoader;
+      loader.reset(new ColladaLoader());
     else if (extension == "obj")
-      loader = &objLoader;
+      loader.reset(new OBJLoader());
     else
     {
       gzerr << "Unsupported mesh format for file[" << _filename << "]\n";
       return nullptr;
     }
 
-    try
+    std::string cachePath;
     {
-      // This mutex prevents two threads from loading the same mesh at the
-      // same time.
+      // Wait while another thread loads the same mesh
       boost::mutex::scoped_lock lock(this->dataPtr->mutex);
-      if (!this->HasMesh(_filename))
+      while (this->dataPtr->loading.count(_filename) > 0)
+        this->dataPtr->loadCondition.wait(lock);
+
+      if (this->HasMesh(_filename))
+        return this->GetMesh(_filename);
+
+      this->dataPtr->loading.insert(_filename);
+      cachePath = this->dataPtr->cachePath;
+    }
+
+    try
+    {
+      // Skip parsing the file if it is in the binary mesh cache
+      std::string key;
+      bool cached = false;
+      if (!cachePath.empty())
       {
-        if ((mesh = loader->Load(fullname)) != nullptr)
-        {
-          mesh->SetName(_filename);
-          this->dataPtr->meshes.insert(std::make_pair(_filename, mesh));
-        }
-        else
-          gzerr << "Unable to load mesh[" << fullname << "]\n";
+        key = MeshCache::Key(fullname);
+        mesh = MeshCache::Load(cachePath, key);
+        cached = mesh != nullptr;
       }
-      else
+
+      if (!mesh)
+        mesh = loader->Load(fullname);
+
+      if (mesh)
       {
-        mesh = this->dataPtr->meshes[_filename];
+        mesh->SetName(_filename);
+        if (!cached)
+          MeshCache::Save(cachePath, key, mesh);
+
+        // Rendering and physics engines read the buffers of compact
+        // submeshes directly. Skinned meshes keep the default storage,
+        // since they need separate buffers for animation.
+        if (!mesh->HasSkeleton())
+          mesh->Compact();
+        this->AddMesh(mesh);
       }
+      else
+        gzerr << "Unable to load mesh[" << fullname << "]\n";
     }
     catch(gazebo::common::Exception &e)
     {
+      this->FinishLoad(_filename);
       gzerr << "Error loading mesh[" << fullname << "]\n";
       gzerr << e << "\n";
       gzthrow(e);
     }
+
+    this->FinishLoad(_filename);
   }
   else
     gzerr << "Unable to find file[" << _filename << "]\n";
@@ -264,13 +430,19 @@ void MeshManager::GenSphericalTexCoord(const Mesh *_mesh,
 //////////////////////////////////////////////////
 void MeshManager::AddMesh(Mesh *_mesh)
 {
-  if (!this->HasMesh(_mesh->GetName()))
-    this->dataPtr->meshes[_mesh->GetName()] = _mesh;
+  boost::mutex::scoped_lock lock(this->dataPtr->meshesMutex);
+  if (this->dataPtr->meshes.insert(
+        std::make_pair(_mesh->GetName(), _mesh)).second)
+  {
+    this->dataPtr->memory.Set(this->dataPtr->memory.Bytes() +
+        static_cast<int64_t>(_mesh->MemorySize()));
+  }
 }
 
 //////////////////////////////////////////////////
 const Mesh *MeshManager::GetMesh(const std::string &_name) const
 {
+  boost::mutex::scoped_lock lock(this->dataPtr->meshesMutex);
   std::map<std::string, Mesh*>::const_iterator iter;
 
   iter = this->dataPtr->meshes.find(_name);
@@ -287,12 +459,97 @@ bool MeshManager::HasMesh(const std::string &_name) const
   if (_name.empty())
     return false;
 
+  boost::mutex::scoped_lock lock(this->dataPtr->meshesMutex);
   std::map<std::string, Mesh*>::const_iterator iter;
   iter = this->dataPtr->meshes.find(_name);
 
   return iter != this->dataPtr->meshes.end();
 }
 
+//////////////////////////////////////////////////
+unsigned int MeshManager::GenerateLods(const Mesh *_mesh,
+    const unsigned int _levels)
+{
+  if (!_mesh || _levels == 0 || _mesh->HasSkeleton())
+    return 0;
+
+  {
+    boost::mutex::scoped_lock lock(this->dataPtr->meshesMutex);
+    auto cached = this->dataPtr->lods.find(_mesh->GetName());
+    if (cached != this->dataPtr->lods.end())
+      return cached->second.size();
+  }
+
+  // Generate the levels without holding the lock, other threads keep the
+  // first levels generated for the mesh
+  std::vector<std::vector<std::vector<unsigned int> > > lods;
+
+  unsigned int triangleCount = 0;
+  for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh->GetSubMesh(i);
+    if (subMesh->GetPrimitiveType() == SubMesh::TRIANGLES)
+      triangleCount += subMesh->GetIndexCount() / 3;
+  }
+
+  ignition::math::Vector3d min = _mesh->Min();
+  ignition::math::Vector3d size = _mesh->Max() - min;
+  double extent = std::max(size.X(), std::max(size.Y(), size.Z()));
+  if (triangleCount < LOD_MIN_TRIANGLES || !size.IsFinite() || extent <= 0)
+    return 0;
+
+  // A surface covers a number of cells in the order of the square of the
+  // resolution of the grid. Start from the resolution that matches the
+  // triangles of the mesh, and halve it until a level is reduced enough.
+  double resolution = std::sqrt(static_cast<double>(triangleCount));
+  while (lods.size() < _levels)
+  {
+    resolution *= 0.5;
+    if (resolution < 2.0)
+      break;
+
+    std::vector<std::vector<unsigned int> > levelIndices;
+    unsigned int levelTriangleCount = 0;
+    for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+    {
+      const SubMesh *subMesh = _mesh->GetSubMesh(i);
+      levelIndices.push_back(ClusterIndices(subMesh, min,
+          extent / resolution));
+      if (subMesh->GetPrimitiveType() == SubMesh::TRIANGLES)
+        levelTriangleCount += levelIndices.back().size() / 3;
+    }
+
+    if (levelTriangleCount > triangleCount * LOD_MAX_RATIO)
+      continue;
+
+    lods.push_back(levelIndices);
+    triangleCount = levelTriangleCount;
+  }
+
+  boost::mutex::scoped_lock lock(this->dataPtr->meshesMutex);
+  return this->dataPtr->lods.insert(
+      std::make_pair(_mesh->GetName(), lods)).first->second.size();
+}
+
+//////////////////////////////////////////////////
+bool MeshManager::LodIndices(const std::string &_name,
+    const unsigned int _level, const unsigned int _subMesh,
+    std::vector<unsigned int> &_indices) const
+{
+  boost::mutex::scoped_lock lock(this->dataPtr->meshesMutex);
+
+  auto iter = this->dataPtr->lods.find(_name);
+  if (iter == this->dataPtr->lods.end() || _level == 0 ||
+      _level > iter->second.size() ||
+      _subMesh >= iter->second[_level - 1].size())
+  {
+    return false;
+  }
+
+  _indices = iter->second[_level - 1][_subMesh];
+  return true;
+}
+
 //////////////////////////////////////////////////
 void MeshManager::CreateSphere(const std::string &name, float radius,
     int rings, int segments)
@@ -310,7 +567,7 @@ void MeshManager::CreateSphere(const std::string &name, float radius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(name);
-  this->dataPtr->meshes.insert(std::make_pair(name, mesh));
+  this->AddMesh(mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -378,7 +635,7 @@ void MeshManager::CreatePlane(const std::string &_name,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->AddMesh(mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -458,7 +715,7 @@ void MeshManager::CreateBox(const std::string &_name,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->AddMesh(mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -759,7 +1016,7 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
     }
   }
 
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->AddMesh(mesh);
   return;
 }
 
@@ -775,7 +1032,7 @@ void MeshManager::CreateCamera(const std::string &_name, float _scale)
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->AddMesh(mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -876,7 +1133,7 @@ void MeshManager::CreateCylinder(const std::string &name, float radius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(name);
-  this->dataPtr->meshes.insert(std::make_pair(name, mesh));
+  this->AddMesh(mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -993,7 +1250,7 @@ void MeshManager::CreateCone(const std::string &name, float radius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(name);
-  this->dataPtr->meshes.insert(std::make_pair(name, mesh));
+  this->AddMesh(mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -1110,7 +1367,7 @@ void MeshManager::CreateTube(const std::string &_name, float _innerRadius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->AddMesh(mesh);
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
 
@@ -1330,8 +1587,10 @@ void MeshManager::CreateBoolean(const std::string &_name, const Mesh *_m1,
 
   MeshCSG csg;
   Mesh *mesh = csg.CreateBoolean(_m1, _m2, _operation, _offset);
+  if (!mesh)
+    return;
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->AddMesh(mesh);
 }
 #endif
 
@@ -57,11 +57,25 @@ namespace gazebo
       /// Destroys the collada loader, the stl loader and all the meshes
       private: virtual ~MeshManager();
 
-      /// \brief Load a mesh from a file
+      /// \brief Load a mesh from a file. Different meshes may be loaded
+      /// from several threads at the same time.
       /// \param[in] _filename the path to the mesh
       /// \return a pointer to the created mesh
       public: const Mesh *Load(const std::string &_filename);
 
+      /// \brief Set the directory of the binary mesh cache. Meshes loaded
+      /// from files are saved in the cache, and later loads of the same
+      /// file read the cache instead of parsing the file. Defaults to the
+      /// GAZEBO_MESH_CACHE environment variable if set, or
+      /// ~/.gazebo/mesh_cache.
+      /// \param[in] _path Cache directory, empty to disable the cache.
+      /// \sa MeshCache
+      public: void SetCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the binary mesh cache.
+      /// \return Cache directory, empty if the cache is disabled.
+      public: std::string CachePath() const;
+
       /// \brief Export a mesh to a file
       /// \param[in] _mesh Pointer to the mesh to be exported
       /// \param[in] _filename Exported file's path and name
@@ -107,6 +121,32 @@ namespace gazebo
       /// \param[in] _name the name of the mesh
       public: bool HasMesh(const std::string &_name) const;
 
+      /// \brief Generate the levels of detail of a mesh. Each level
+      /// clusters the vertices of the mesh on a grid coarser than the one
+      /// of the previous level, and keeps one vertex per cell. The levels
+      /// reuse the vertices of the mesh and only differ by their indices.
+      /// Submeshes that are not made of triangles keep all their indices,
+      /// and meshes with a skeleton are not reduced. The levels are
+      /// generated once per mesh, later calls return the same levels.
+      /// \param[in] _mesh The mesh to reduce.
+      /// \param[in] _levels Maximum number of levels to generate.
+      /// \return Number of levels of the mesh, which is less than _levels
+      /// when a level would not reduce the mesh any further.
+      /// \sa LodIndices
+      public: unsigned int GenerateLods(const Mesh *_mesh,
+                  const unsigned int _levels);
+
+      /// \brief Get the indices of a submesh at a level of detail generated
+      /// by GenerateLods.
+      /// \param[in] _name Name of the mesh.
+      /// \param[in] _level Level of detail, 1 being the first reduced level.
+      /// \param[in] _subMesh Index of the submesh.
+      /// \param[out] _indices Indices of the submesh at the level.
+      /// \return True if the level of detail exists.
+      public: bool LodIndices(const std::string &_name,
+                  const unsigned int _level, const unsigned int _subMesh,
+                  std::vector<unsigned int> &_indices) const;
+
       /// \brief Create a sphere mesh.
       /// \param[in] _name the name of the mesh
       /// \param[in] _radius radius of the sphere in meter
@@ -261,6 +301,11 @@ namespace gazebo
                       const ignition::math::Vector2d &_p,
                       double _tol);
 
+      /// \brief Mark a mesh as loaded, and wake up the threads waiting to
+      /// load it.
+      /// \param[in] _filename Name of the mesh.
+      private: void FinishLoad(const std::string &_filename);
+
       /// \brief Singleton implementation
       private: friend class SingletonT<MeshManager>;
 
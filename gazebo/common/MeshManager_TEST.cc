@@ -16,6 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "test_config.h"
 #include "gazebo/common/Mesh.hh"
@@ -266,6 +269,92 @@ TEST_F(MeshManager, CreateExtrudedPolylineInvalid)
   EXPECT_TRUE(!common::MeshManager::Instance()->HasMesh(meshName));
 }
 
+/////////////////////////////////////////////////
+TEST_F(MeshManager, GenerateLods)
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+
+  // Meshes with few triangles are not reduced
+  const common::Mesh *box = meshManager->GetMesh("unit_box");
+  ASSERT_NE(box, nullptr);
+  EXPECT_EQ(meshManager->GenerateLods(box, 3), 0u);
+  std::vector<unsigned int> indices;
+  EXPECT_FALSE(meshManager->LodIndices("unit_box", 1, 0, indices));
+
+  meshManager->CreateSphere("lod_sphere", 1.0, 64, 64);
+  const common::Mesh *sphere = meshManager->GetMesh("lod_sphere");
+  ASSERT_NE(sphere, nullptr);
+  ASSERT_EQ(sphere->GetSubMeshCount(), 1u);
+  const common::SubMesh *subMesh = sphere->GetSubMesh(0);
+
+  unsigned int levels = meshManager->GenerateLods(sphere, 3);
+  EXPECT_GE(levels, 1u);
+  EXPECT_LE(levels, 3u);
+
+  // The levels are kept
+  EXPECT_EQ(meshManager->GenerateLods(sphere, 3), levels);
+
+  // Each level has fewer triangles than the previous one, made of the
+  // vertices of the mesh
+  unsigned int prevCount = subMesh->GetIndexCount();
+  for (unsigned int level = 1; level <= levels; ++level)
+  {
+    ASSERT_TRUE(meshManager->LodIndices("lod_sphere", level, 0, indices));
+    EXPECT_EQ(indices.size() % 3, 0u);
+    EXPECT_GT(indices.size(), 0u);
+    EXPECT_LT(indices.size(), prevCount);
+    for (const auto index : indices)
+      EXPECT_LT(index, subMesh->GetVertexCount());
+    prevCount = indices.size();
+  }
+
+  EXPECT_FALSE(meshManager->LodIndices("lod_sphere", 0, 0, indices));
+  EXPECT_FALSE(meshManager->LodIndices("lod_sphere", levels + 1, 0,
+      indices));
+  EXPECT_FALSE(meshManager->LodIndices("lod_sphere", 1, 1, indices));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshManager, ConcurrentLoad)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+  manager->SetCachePath("");
+
+  const std::vector<std::string> filenames = {
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/box_offset.dae",
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/box_with_default_stride.dae",
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/box.obj",
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/twoFaces.stl"};
+
+  // Every thread loads every mesh, in a different order
+  const unsigned int threadCount = 8;
+  std::vector<std::vector<const common::Mesh *>> meshes(threadCount,
+      std::vector<const common::Mesh *>(filenames.size(), nullptr));
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < threadCount; ++t)
+  {
+    threads.push_back(std::thread([&, t]()
+        {
+          for (size_t i = 0; i < filenames.size(); ++i)
+          {
+            const size_t index = (i + t) % filenames.size();
+            meshes[t][index] = manager->Load(filenames[index]);
+          }
+        }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  // Each mesh is loaded once
+  for (size_t i = 0; i < filenames.size(); ++i)
+  {
+    EXPECT_NE(nullptr, meshes[0][i]);
+    EXPECT_EQ(manager->GetMesh(filenames[i]), meshes[0][i]);
+    for (unsigned int t = 1; t < threadCount; ++t)
+      EXPECT_EQ(meshes[0][i], meshes[t][i]);
+  }
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -334,6 +334,113 @@ TEST_F(MeshTest, STLRead)
   }
 }
 
+/////////////////////////////////////////////////
+// Test compact submesh storage
+TEST_F(MeshTest, SubMeshCompact)
+{
+  common::SubMesh subMesh;
+  subMesh.AddVertex(0, 0, 0);
+  subMesh.AddVertex(1, 0, 0);
+  subMesh.AddVertex(1, 1, 0.5);
+  subMesh.AddNormal(0, 0, 1);
+  subMesh.AddNormal(0, 0, 1);
+  subMesh.AddNormal(0, 1, 0);
+  subMesh.AddTexCoord(0, 0);
+  subMesh.AddTexCoord(1, 0);
+  subMesh.AddTexCoord(0.5, 1);
+  subMesh.AddIndex(0);
+  subMesh.AddIndex(1);
+  subMesh.AddIndex(2);
+
+  EXPECT_FALSE(subMesh.IsCompact());
+  EXPECT_EQ(nullptr, subMesh.VertexBuffer());
+  EXPECT_EQ(nullptr, subMesh.IndexBuffer());
+  EXPECT_EQ(0u, subMesh.VertexStride());
+  EXPECT_EQ(0u, subMesh.IndexSize());
+
+  EXPECT_TRUE(subMesh.Compact());
+  EXPECT_TRUE(subMesh.IsCompact());
+  EXPECT_EQ(3u, subMesh.GetVertexCount());
+  EXPECT_EQ(3u, subMesh.GetNormalCount());
+  EXPECT_EQ(3u, subMesh.GetTexCoordCount());
+  EXPECT_EQ(3u, subMesh.GetIndexCount());
+  EXPECT_EQ(8u, subMesh.VertexStride());
+  EXPECT_EQ(3, subMesh.NormalOffset());
+  EXPECT_EQ(6, subMesh.TexCoordOffset());
+  EXPECT_EQ(2u, subMesh.IndexSize());
+
+  // Interleaved position, normal and texture coordinate
+  const float *vertices = subMesh.VertexBuffer();
+  ASSERT_NE(nullptr, vertices);
+  const float expected[] = {1, 1, 0.5, 0, 1, 0, 0.5, 1};
+  for (unsigned int i = 0; i < 8; ++i)
+    EXPECT_FLOAT_EQ(expected[i], vertices[2 * 8 + i]);
+  const uint16_t *indices =
+    static_cast<const uint16_t *>(subMesh.IndexBuffer());
+  ASSERT_NE(nullptr, indices);
+  EXPECT_EQ(2u, indices[2]);
+
+  // Accessors read the compact buffers
+  EXPECT_EQ(ignition::math::Vector3d(1, 1, 0.5), subMesh.Vertex(2));
+  EXPECT_EQ(ignition::math::Vector3d(0, 1, 0), subMesh.Normal(2));
+  EXPECT_EQ(ignition::math::Vector2d(0.5, 1), subMesh.TexCoord(2));
+  EXPECT_EQ(2u, subMesh.GetIndex(2));
+  EXPECT_EQ(2u, subMesh.GetMaxIndex());
+  EXPECT_EQ(ignition::math::Vector3d(1, 1, 0.5), subMesh.Max());
+  EXPECT_EQ(ignition::math::Vector3d::Zero, subMesh.Min());
+  EXPECT_TRUE(subMesh.HasVertex(ignition::math::Vector3d(1, 0, 0)));
+  EXPECT_EQ(1u, subMesh.GetVertexIndex(ignition::math::Vector3d(1, 0, 0)));
+  EXPECT_THROW(subMesh.Vertex(3), common::Exception);
+
+  float *vertArray = nullptr;
+  int *indArray = nullptr;
+  subMesh.FillArrays(&vertArray, &indArray);
+  EXPECT_FLOAT_EQ(1, vertArray[6]);
+  EXPECT_FLOAT_EQ(0.5, vertArray[8]);
+  EXPECT_EQ(2, indArray[2]);
+  delete [] vertArray;
+  delete [] indArray;
+
+  // Copies keep the compact storage
+  common::SubMesh copy(&subMesh);
+  EXPECT_TRUE(copy.IsCompact());
+  EXPECT_EQ(subMesh.Vertex(1), copy.Vertex(1));
+
+  // Modifying the submesh converts it back
+  subMesh.Translate(ignition::math::Vector3d(0, 0, 1));
+  EXPECT_FALSE(subMesh.IsCompact());
+  EXPECT_EQ(ignition::math::Vector3d(1, 1, 1.5), subMesh.Vertex(2));
+  EXPECT_EQ(ignition::math::Vector3d(0, 1, 0), subMesh.Normal(2));
+  EXPECT_EQ(ignition::math::Vector2d(0.5, 1), subMesh.TexCoord(2));
+  EXPECT_EQ(3u, subMesh.GetIndexCount());
+  EXPECT_EQ(ignition::math::Vector3d(1, 1, 0.5), copy.Vertex(2));
+
+  // Indices that don't fit in 16 bits
+  common::SubMesh large;
+  for (unsigned int i = 0; i < 70000; ++i)
+  {
+    large.AddVertex(i, 0, 0);
+    large.AddIndex(i);
+  }
+  EXPECT_TRUE(large.Compact());
+  EXPECT_EQ(3u, large.VertexStride());
+  EXPECT_EQ(-1, large.NormalOffset());
+  EXPECT_EQ(-1, large.TexCoordOffset());
+  EXPECT_EQ(0u, large.GetNormalCount());
+  EXPECT_EQ(4u, large.IndexSize());
+  EXPECT_EQ(69999u, large.GetIndex(69999));
+  EXPECT_EQ(69999u, large.GetMaxIndex());
+
+  // Normals that don't match the vertices
+  common::SubMesh mismatch;
+  mismatch.AddVertex(0, 0, 0);
+  mismatch.AddVertex(1, 0, 0);
+  mismatch.AddNormal(0, 0, 1);
+  EXPECT_FALSE(mismatch.Compact());
+  EXPECT_FALSE(mismatch.IsCompact());
+  EXPECT_EQ(2u, mismatch.GetVertexCount());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
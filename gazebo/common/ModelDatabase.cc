@@ -23,6 +23,9 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/bind.hpp>
@@ -86,6 +89,11 @@ void ModelDatabase::Start(bool _fetchImmediately)
 {
   boost::recursive_mutex::scoped_lock lock(this->dataPtr->startCacheMutex);
 
+  {
+    std::lock_guard<std::mutex> downloadLock(this->dataPtr->downloadMutex);
+    this->dataPtr->stopDownloads = false;
+  }
+
   if (!this->dataPtr->updateCacheThread)
   {
     this->dataPtr->stop = false;
@@ -112,6 +120,25 @@ void ModelDatabase::Fini()
     delete this->dataPtr->updateCacheThread;
     this->dataPtr->updateCacheThread = nullptr;
   }
+
+  // Stop the download threads once their current download completes, and
+  // fail the queued downloads.
+  std::vector<std::thread> downloadThreads;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+    this->dataPtr->stopDownloads = true;
+    for (auto &download : this->dataPtr->downloads)
+    {
+      download.promise->set_value(std::string());
+      this->dataPtr->pendingDownloads.erase(download.key);
+    }
+    this->dataPtr->downloads.clear();
+    downloadThreads.swap(this->dataPtr->downloadThreads);
+  }
+  this->dataPtr->downloadCondition.notify_all();
+
+  for (auto &thread : downloadThreads)
+    thread.join();
 }
 
 /////////////////////////////////////////////////
@@ -397,153 +424,184 @@ std::string ModelDatabase::GetModelName(const std::string &_uri)
 }
 
 /////////////////////////////////////////////////
-std::string ModelDatabase::GetModelPath(const std::string &_uri,
-                                        bool _forceDownload)
+/// \brief Split a model URI into the name of the model on the database,
+/// and the path of a file inside the model.
+/// \param[in] _uri The model URI.
+/// \param[out] _modelName Name of the model.
+/// \param[out] _suffix Path inside the model, starting with '/', or empty.
+/// \return False if the URI is missing ://.
+static bool ParseModelUri(const std::string &_uri, std::string &_modelName,
+    std::string &_suffix)
 {
-  std::string path, suffix;
-
-  if (!_forceDownload)
-    path = SystemPaths::Instance()->FindFileURI(_uri);
-
-  struct stat st;
-
-  if (path.empty() || stat(path.c_str(), &st) != 0 )
+  // Get the model name from the uri
+  size_t startIndex = _uri.find_first_of("://");
+  if (startIndex == std::string::npos)
   {
-    if (!ModelDatabase::HasModel(_uri))
-    {
-      return std::string();
-    }
-
-    // Get the model name from the uri
-    size_t startIndex = _uri.find_first_of("://");
-    if (startIndex == std::string::npos)
-    {
-      gzerr << "URI[" << _uri << "] is missing ://\n";
-      return std::string();
-    }
-
-    std::string modelName = _uri;
-    boost::replace_first(modelName, "model://", "");
-    boost::replace_first(modelName, ModelDatabase::GetURI(), "");
-
-    startIndex = modelName[0] == '/' ? 1 : 0;
-    size_t endIndex = modelName.find_first_of("/", startIndex);
-    size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
-      endIndex - startIndex;
-
-    if (endIndex != std::string::npos)
-      suffix = modelName.substr(endIndex, std::string::npos);
-
-    modelName = modelName.substr(startIndex, modelNameLen);
+    gzerr << "URI[" << _uri << "] is missing ://\n";
+    return false;
+  }
 
-    // Store downloaded .tar.gz and intermediate .tar files in temp location
-    boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
-    tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
-    std::string tarfilename = tmppath.string() + ".tar";
-    std::string tgzfilename = tarfilename + ".gz";
+  std::string modelName = _uri;
+  boost::replace_first(modelName, "model://", "");
+  boost::replace_first(modelName, ModelDatabase::GetURI(), "");
 
-    CURL *curl = curl_easy_init();
-    if (!curl)
-    {
-      gzerr << "Unable to initialize libcurl\n";
-      return std::string();
-    }
+  startIndex = modelName[0] == '/' ? 1 : 0;
+  size_t endIndex = modelName.find_first_of("/", startIndex);
+  size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
+    endIndex - startIndex;
 
-    curl_easy_setopt(curl, CURLOPT_URL,
-        (ModelDatabase::GetURI() + "/" +
-         modelName + "/model.tar.gz").c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
+  _suffix.clear();
+  if (endIndex != std::string::npos)
+    _suffix = modelName.substr(endIndex, std::string::npos);
 
-    bool retry = true;
-    int iterations = 0;
-    while (retry && iterations < 4)
-    {
-      retry = false;
-      iterations++;
+  _modelName = modelName.substr(startIndex, modelNameLen);
+  return true;
+}
 
-      FILE *fp = fopen(tgzfilename.c_str(), "wb");
-      if (!fp)
-      {
-        gzerr << "Could not download model[" << _uri << "] because we were"
-          << "unable to write to file[" << tgzfilename << "]."
-          << "Please fix file permissions.";
-        return std::string();
-      }
+/////////////////////////////////////////////////
+bool gazebo::common::ResumeDownload(CURL *_curl, const std::string &_url,
+    const std::string &_filename)
+{
+  // Resume from the bytes received by a previous attempt
+  boost::system::error_code errorCode;
+  uintmax_t received = boost::filesystem::exists(_filename, errorCode) ?
+    boost::filesystem::file_size(_filename, errorCode) : 0;
+  if (errorCode)
+    received = 0;
+
+  FILE *fp = fopen(_filename.c_str(), received > 0 ? "ab" : "wb");
+  if (!fp)
+  {
+    gzerr << "Unable to write to file[" << _filename << "]. "
+          << "Please fix file permissions.\n";
+    return false;
+  }
 
-      /// Download the model tarball
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-      CURLcode success = curl_easy_perform(curl);
+  curl_easy_setopt(_curl, CURLOPT_URL, _url.c_str());
+  curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, write_data);
+  curl_easy_setopt(_curl, CURLOPT_WRITEDATA, fp);
+  curl_easy_setopt(_curl, CURLOPT_RESUME_FROM_LARGE,
+      static_cast<curl_off_t>(received));
+  CURLcode success = curl_easy_perform(_curl);
+  fclose(fp);
 
-      if (success != CURLE_OK)
-      {
-        gzwarn << "Unable to connect to model database using ["
-               << _uri << "]\n";
-        retry = true;
-        continue;
-      }
+  long responseCode = 0;
+  curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, &responseCode);
+  curl_easy_setopt(_curl, CURLOPT_RESUME_FROM_LARGE,
+      static_cast<curl_off_t>(0));
 
-      fclose(fp);
+  if (received > 0 && responseCode == 200)
+  {
+    // The server ignored the range, so the file holds the start of the
+    // file twice. Download it again from the start.
+    boost::filesystem::remove(_filename, errorCode);
+    return false;
+  }
 
-      try
-      {
-        // Unzip model tarball
-        std::ifstream file(tgzfilename.c_str(),
-            std::ios_base::in | std::ios_base::binary);
-        std::ofstream out(tarfilename.c_str(),
-            std::ios_base::out | std::ios_base::binary);
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-        in.push(boost::iostreams::gzip_decompressor());
-        in.push(file);
-        boost::iostreams::copy(in, out);
-      }
-      catch(...)
-      {
-        gzerr << "Failed to unzip model tarball. Trying again...\n";
-        retry = true;
-        continue;
-      }
+  return success == CURLE_OK;
+}
 
-#ifndef _WIN32
-      TAR *tar;
-      tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
-          nullptr, O_RDONLY, 0644, TAR_GNU);
+/////////////////////////////////////////////////
+/// \brief Download and extract a model tarball. A download interrupted by
+/// a connection error resumes where it stopped on the next attempt.
+/// \param[in] _uri URI of the model, for the messages.
+/// \param[in] _modelName Name of the model on the database.
+/// \param[in] _curl Handle used for the download, which keeps its
+/// connection to the database open for the next download.
+/// \return Path to the model directory, empty on failure.
+static std::string DownloadModel(const std::string &_uri,
+    const std::string &_modelName, CURL *_curl)
+{
+  std::string path;
 
-      std::string outputPath = getenv("HOME");
-      outputPath += "/.gazebo/models";
+  // Store downloaded .tar.gz and intermediate .tar files in temp location
+  boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
+  tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
+  std::string tarfilename = tmppath.string() + ".tar";
+  std::string tgzfilename = tarfilename + ".gz";
 
-      tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
-      path = outputPath + "/" + modelName;
+  const std::string url =
+    ModelDatabase::GetURI() + "/" + _modelName + "/model.tar.gz";
 
-      ModelDatabase::DownloadDependencies(path);
-#endif
-    }
+  bool retry = true;
+  int iterations = 0;
+  while (retry && iterations < 4)
+  {
+    retry = false;
+    iterations++;
 
-    curl_easy_cleanup(curl);
-    if (retry)
+    /// Download the model tarball
+    if (!ResumeDownload(_curl, url, tgzfilename))
     {
-      gzerr << "Could not download model[" << _uri << "]."
-        << "The model may be corrupt.\n";
-      path.clear();
+      gzwarn << "Unable to download model[" << _uri << "]\n";
+      retry = true;
+      continue;
     }
 
-    // Clean up
+    boost::system::error_code errorCode;
     try
     {
-      boost::filesystem::remove(tarfilename);
-      boost::filesystem::remove(tgzfilename);
+      // Unzip model tarball
+      std::ifstream file(tgzfilename.c_str(),
+          std::ios_base::in | std::ios_base::binary);
+      std::ofstream out(tarfilename.c_str(),
+          std::ios_base::out | std::ios_base::binary);
+      boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+      in.push(boost::iostreams::gzip_decompressor());
+      in.push(file);
+      boost::iostreams::copy(in, out);
     }
     catch(...)
     {
-      gzwarn << "Failed to remove temporary model files after download.";
+      gzerr << "Failed to unzip model tarball. Trying again...\n";
+      boost::filesystem::remove(tgzfilename, errorCode);
+      retry = true;
+      continue;
     }
+
+#ifndef _WIN32
+    TAR *tar;
+    tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
+        nullptr, O_RDONLY, 0644, TAR_GNU);
+
+    std::string outputPath = getenv("HOME");
+    outputPath += "/.gazebo/models";
+
+    tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
+    tar_close(tar);
+    path = outputPath + "/" + _modelName;
+#endif
+  }
+
+  if (retry)
+  {
+    gzerr << "Could not download model[" << _uri << "]."
+      << "The model may be corrupt.\n";
+    path.clear();
+  }
+
+  // Clean up
+  try
+  {
+    boost::filesystem::remove(tarfilename);
+    boost::filesystem::remove(tgzfilename);
+  }
+  catch(...)
+  {
+    gzwarn << "Failed to remove temporary model files after download.";
   }
 
-  return path + suffix;
+  return path;
 }
 
 /////////////////////////////////////////////////
-void ModelDatabase::DownloadDependencies(const std::string &_path)
+/// \brief Get the URIs of the dependencies listed in the manifest of a
+/// model.
+/// \param[in] _path Path to the model directory.
+/// \return The URIs.
+static std::vector<std::string> DependencyUris(const std::string &_path)
 {
+  std::vector<std::string> uris;
   boost::filesystem::path manifestPath = _path;
 
   // Get the GZ_MODEL_MANIFEST_FILENAME.
@@ -562,22 +620,19 @@ void ModelDatabase::DownloadDependencies(const std::string &_path)
     if (!modelXML)
     {
       gzerr << "No <model> element in manifest file[" << _path << "]\n";
-      return;
+      return uris;
     }
 
     TiXmlElement *dependXML = modelXML->FirstChildElement("depend");
     if (!dependXML)
-      return;
+      return uris;
 
     for (TiXmlElement *depXML = dependXML->FirstChildElement("model");
          depXML; depXML = depXML->NextSiblingElement())
     {
       TiXmlElement *uriXML = depXML->FirstChildElement("uri");
-      if (uriXML)
-      {
-        // Download the model if it doesn't exist.
-        ModelDatabase::GetModelPath(uriXML->GetText());
-      }
+      if (uriXML && uriXML->GetText())
+        uris.push_back(uriXML->GetText());
       else
       {
         gzerr << "Model depend is missing <uri> in manifest["
@@ -587,6 +642,189 @@ void ModelDatabase::DownloadDependencies(const std::string &_path)
   }
   else
     gzerr << "Unable to load manifest file[" << manifestPath << "]\n";
+
+  return uris;
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::DownloadWorker()
+{
+  CURL *curl = curl_easy_init();
+  if (!curl)
+    gzerr << "Unable to initialize libcurl\n";
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->downloadMutex);
+  while (!this->dataPtr->stopDownloads)
+  {
+    if (this->dataPtr->downloads.empty())
+    {
+      this->dataPtr->downloadCondition.wait(lock);
+      continue;
+    }
+
+    ModelDatabasePrivate::Download download =
+      this->dataPtr->downloads.front();
+    this->dataPtr->downloads.pop_front();
+    lock.unlock();
+
+    std::string path;
+    if (download.download)
+      path = download.download();
+    else if (curl)
+      path = DownloadModel(download.uri, download.modelName, curl);
+
+    // Start the dependencies right away. They are waited for by
+    // DownloadDependencies, so that the download threads never wait.
+    if (!download.download && !path.empty())
+    {
+      for (auto const &uri : DependencyUris(path))
+        this->GetModelPathAsync(uri);
+    }
+
+    lock.lock();
+    download.promise->set_value(path);
+    this->dataPtr->pendingDownloads.erase(download.key);
+  }
+
+  if (curl)
+    curl_easy_cleanup(curl);
+}
+
+/////////////////////////////////////////////////
+std::shared_future<std::string> ModelDatabase::GetModelPathAsync(
+    const std::string &_uri, bool _forceDownload)
+{
+  std::promise<std::string> ready;
+  std::shared_future<std::string> result = ready.get_future().share();
+
+  std::string path;
+  if (!_forceDownload)
+    path = SystemPaths::Instance()->FindFileURI(_uri);
+
+  struct stat st;
+  std::string modelName, suffix;
+  if (!path.empty() && stat(path.c_str(), &st) == 0)
+  {
+    // Return the model directory, not a file inside it
+    if (ParseModelUri(_uri, modelName, suffix) && !suffix.empty() &&
+        path.size() > suffix.size() &&
+        path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0)
+    {
+      path.erase(path.size() - suffix.size());
+    }
+    ready.set_value(path);
+    return result;
+  }
+
+  if (!ModelDatabase::HasModel(_uri) ||
+      !ParseModelUri(_uri, modelName, suffix))
+  {
+    ready.set_value(std::string());
+    return result;
+  }
+
+  return this->Queue(modelName, _uri, modelName, nullptr);
+}
+
+/////////////////////////////////////////////////
+std::shared_future<std::string> ModelDatabase::QueueDownload(
+    const std::string &_key, const std::function<std::string ()> &_download)
+{
+  return this->Queue(_key, std::string(), std::string(), _download);
+}
+
+/////////////////////////////////////////////////
+std::shared_future<std::string> ModelDatabase::Queue(const std::string &_key,
+    const std::string &_uri, const std::string &_modelName,
+    const std::function<std::string ()> &_download)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+  auto pending = this->dataPtr->pendingDownloads.find(_key);
+  if (pending != this->dataPtr->pendingDownloads.end())
+    return pending->second;
+
+  if (this->dataPtr->stopDownloads)
+  {
+    std::promise<std::string> stopped;
+    stopped.set_value(std::string());
+    return stopped.get_future().share();
+  }
+
+  ModelDatabasePrivate::Download download;
+  download.key = _key;
+  download.uri = _uri;
+  download.modelName = _modelName;
+  download.download = _download;
+  download.promise = std::make_shared<std::promise<std::string>>();
+  std::shared_future<std::string> result =
+    download.promise->get_future().share();
+  this->dataPtr->pendingDownloads[_key] = result;
+  this->dataPtr->downloads.push_back(download);
+
+  // Start the download threads on the first download
+  if (this->dataPtr->downloadThreads.empty())
+  {
+    for (unsigned int i = 0; i < GZ_MODEL_DOWNLOAD_THREADS; ++i)
+    {
+      this->dataPtr->downloadThreads.push_back(
+          std::thread(&ModelDatabase::DownloadWorker, this));
+    }
+  }
+  this->dataPtr->downloadCondition.notify_one();
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::string ModelDatabase::GetModelPath(const std::string &_uri,
+                                        bool _forceDownload)
+{
+  std::string path;
+
+  if (!_forceDownload)
+    path = SystemPaths::Instance()->FindFileURI(_uri);
+
+  struct stat st;
+
+  if (path.empty() || stat(path.c_str(), &st) != 0 )
+  {
+    std::string modelName, suffix;
+    if (!ModelDatabase::HasModel(_uri) ||
+        !ParseModelUri(_uri, modelName, suffix))
+    {
+      return std::string();
+    }
+
+    path = this->GetModelPathAsync(_uri, _forceDownload).get();
+    if (path.empty())
+      return std::string();
+
+    ModelDatabase::DownloadDependencies(path);
+    path += suffix;
+  }
+
+  return path;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> ModelDatabase::GetModelPaths(
+    const std::vector<std::string> &_uris)
+{
+  // Queue every download before waiting for the first one
+  for (auto const &uri : _uris)
+    this->GetModelPathAsync(uri);
+
+  std::vector<std::string> paths;
+  for (auto const &uri : _uris)
+    paths.push_back(this->GetModelPath(uri));
+  return paths;
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::DownloadDependencies(const std::string &_path)
+{
+  // Download the models that don't exist.
+  this->GetModelPaths(DependencyUris(_path));
 }
 
 /////////////////////////////////////////////////
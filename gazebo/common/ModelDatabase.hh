@@ -17,9 +17,12 @@
 #ifndef _GAZEBO_MODELDATABSE_HH_
 #define _GAZEBO_MODELDATABSE_HH_
 
+#include <functional>
+#include <future>
 #include <string>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include <boost/function.hpp>
 #include "gazebo/common/Event.hh"
@@ -33,6 +36,9 @@
 /// \brief The file name of model database XML configuration.
 #define GZ_MODEL_DB_MANIFEST_FILENAME "database.config"
 
+/// \brief Number of downloads run at the same time by the model database.
+#define GZ_MODEL_DOWNLOAD_THREADS 4
+
 /// \brief Explicit instantiation for typed SingletonT.
 GZ_SINGLETON_DECLARE(GZ_COMMON_VISIBLE, gazebo, common, ModelDatabase)
 
@@ -113,6 +119,40 @@ namespace gazebo
       public: std::string GetModelPath(const std::string &_uri,
                   bool _forceDownload = false);
 
+      /// \brief Get the local path to a model without blocking.
+      ///
+      /// A model that isn't found locally is queued for download. Models
+      /// are downloaded concurrently by a pool of threads, and a model
+      /// requested several times is downloaded once. The dependencies of
+      /// the model are queued once it is downloaded, but not waited for.
+      /// \param[in] _uri the model uri
+      /// \param[in] _forceDownload True to skip searching local paths.
+      /// \return Future path to the model directory, empty if the model
+      /// couldn't be found nor downloaded.
+      /// \sa GetModelPaths
+      public: std::shared_future<std::string> GetModelPathAsync(
+                  const std::string &_uri, bool _forceDownload = false);
+
+      /// \brief Get the local paths to several models, downloading the
+      /// missing models and their dependencies concurrently.
+      /// \param[in] _uris The model uris.
+      /// \return Path to each model, as returned by GetModelPath.
+      public: std::vector<std::string> GetModelPaths(
+                  const std::vector<std::string> &_uris);
+
+      /// \brief Run a download on the download threads of the database,
+      /// next to the model downloads. A download queued several times
+      /// under the same key runs once. Downloads still queued when Fini is
+      /// called don't run, and their future is an empty string.
+      /// \param[in] _key Key of the download, such as its URI.
+      /// \param[in] _download Function that downloads the resource and
+      /// returns its local path, empty on failure.
+      /// \return Future path returned by _download.
+      /// \sa GetModelPathAsync
+      public: std::shared_future<std::string> QueueDownload(
+                  const std::string &_key,
+                  const std::function<std::string ()> &_download);
+
       /// \brief Get a model's SDF file based on a URI.
       ///
       /// Get a model file based on a URI. If the model is on
@@ -125,7 +165,7 @@ namespace gazebo
       ///
       /// Look's in the model's manifest file (_path/model.config)
       /// for all models listed in the <depend> block, and downloads the
-      /// models if necessary.
+      /// models if necessary. The dependencies are downloaded concurrently.
       /// \param[in] _path Path to a model.
       public: void DownloadDependencies(const std::string &_path);
 
@@ -150,6 +190,22 @@ namespace gazebo
       /// no one else should use this function.
       private: bool UpdateModelCacheImpl();
 
+      /// \brief Used by the download threads to download the queued
+      /// models.
+      private: void DownloadWorker();
+
+      /// \brief Queue a download, unless one with the same key is pending.
+      /// \param[in] _key Key of the download.
+      /// \param[in] _uri URI of the model, empty if _download is set.
+      /// \param[in] _modelName Name of the model on the database, empty if
+      /// _download is set.
+      /// \param[in] _download Function run in place of the model download,
+      /// may be empty.
+      /// \return Future path to the download.
+      private: std::shared_future<std::string> Queue(const std::string &_key,
+                   const std::string &_uri, const std::string &_modelName,
+                   const std::function<std::string ()> &_download);
+
       /// \brief Private data.
       private: ModelDatabasePrivate *dataPtr;
 
@@ -17,9 +17,19 @@
 #ifndef _GAZEBO_MODELDATABSE_PRIVATE_HH_
 #define _GAZEBO_MODELDATABSE_PRIVATE_HH_
 
+#include <curl/curl.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
@@ -68,7 +78,65 @@ namespace gazebo
       /// calling ModelDatabase::GetModels()
       public: event::EventT<
                void (std::map<std::string, std::string>)> modelDBUpdated;
+
+      /// \brief A download waiting for a download thread.
+      public: class Download
+      {
+        /// \brief Key of the download in pendingDownloads.
+        public: std::string key;
+
+        /// \brief URI of the model.
+        public: std::string uri;
+
+        /// \brief Name of the model on the database.
+        public: std::string modelName;
+
+        /// \brief Function run in place of the model download, see
+        /// ModelDatabase::QueueDownload.
+        public: std::function<std::string ()> download;
+
+        /// \brief Set to the local path of the model once downloaded, or
+        /// to an empty string on failure.
+        public: std::shared_ptr<std::promise<std::string>> promise;
+      };
+
+      /// \brief Downloads waiting for a download thread.
+      public: std::deque<Download> downloads;
+
+      /// \brief Local paths of the downloads in progress, by model name or
+      /// by key, so that a model is downloaded once however many times it
+      /// is requested.
+      public: std::map<std::string, std::shared_future<std::string>>
+              pendingDownloads;
+
+      /// \brief Threads that download the models. Each one keeps its
+      /// connection to the database open between downloads.
+      public: std::vector<std::thread> downloadThreads;
+
+      /// \brief Protects downloads, pendingDownloads, downloadThreads and
+      /// stopDownloads.
+      public: std::mutex downloadMutex;
+
+      /// \brief Notified when a download is queued, or the download threads
+      /// must stop.
+      public: std::condition_variable downloadCondition;
+
+      /// \brief True to stop the download threads.
+      public: bool stopDownloads = false;
     };
+
+    /// \internal
+    /// \brief Download a file, resuming after the bytes already in it. A
+    /// server that ignores the range sends the whole file again, so the
+    /// file is removed to start over on the next attempt.
+    /// \param[in] _curl Handle used for the download.
+    /// \param[in] _url URL of the file.
+    /// \param[in] _filename Local file, created if needed.
+    /// \return True once the file is complete, false if the download must
+    /// be attempted again.
+    GZ_COMMON_VISIBLE
+    bool ResumeDownload(CURL *_curl, const std::string &_url,
+        const std::string &_filename);
   }
 }
 #endif
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <curl/curl.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/ModelDatabase.hh"
+#include "gazebo/common/ModelDatabasePrivate.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ModelDatabase : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Read a whole file.
+/// \param[in] _filename Path to the file.
+/// \return Content of the file.
+std::string ReadFile(const boost::filesystem::path &_filename)
+{
+  std::ifstream in(_filename.string(), std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+      std::istreambuf_iterator<char>());
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a whole file.
+/// \param[in] _filename Path to the file.
+/// \param[in] _content Content of the file.
+void WriteFile(const boost::filesystem::path &_filename,
+    const std::string &_content)
+{
+  std::ofstream out(_filename.string(), std::ios::binary);
+  out << _content;
+}
+
+/////////////////////////////////////////////////
+TEST_F(ModelDatabase, QueueDownloadOnce)
+{
+  auto db = common::ModelDatabase::Instance();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool release = false;
+  std::atomic<int> calls(0);
+  auto download = [&]()
+  {
+    ++calls;
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&release]() { return release; });
+    return std::string("/tmp/model");
+  };
+
+  // The second request shares the pending download
+  auto first = db->QueueDownload("test://once", download);
+  auto second = db->QueueDownload("test://once", download);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  condition.notify_all();
+
+  EXPECT_EQ("/tmp/model", first.get());
+  EXPECT_EQ("/tmp/model", second.get());
+  EXPECT_EQ(1, calls);
+
+  // A new request once the download is done runs it again
+  EXPECT_EQ("/tmp/model", db->QueueDownload("test://once", download).get());
+  EXPECT_EQ(2, calls);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ModelDatabase, QueueDownloadThreads)
+{
+  auto db = common::ModelDatabase::Instance();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool release = false;
+  int running = 0;
+  int maxRunning = 0;
+  auto download = [&]()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    maxRunning = std::max(maxRunning, ++running);
+    condition.notify_all();
+    condition.wait(lock, [&release]() { return release; });
+    --running;
+    return std::string("done");
+  };
+
+  const int count = 3 * GZ_MODEL_DOWNLOAD_THREADS;
+  std::vector<std::shared_future<std::string>> futures;
+  for (int i = 0; i < count; ++i)
+  {
+    futures.push_back(
+        db->QueueDownload("test://threads/" + std::to_string(i), download));
+  }
+
+  // The pool runs as many downloads as it has threads, and no more
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds(5),
+        [&running]() { return running == GZ_MODEL_DOWNLOAD_THREADS; }));
+    release = true;
+  }
+  condition.notify_all();
+
+  for (auto &future : futures)
+    EXPECT_EQ("done", future.get());
+  EXPECT_EQ(GZ_MODEL_DOWNLOAD_THREADS, maxRunning);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ModelDatabase, QueueDownloadFini)
+{
+  auto db = common::ModelDatabase::Instance();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool release = false;
+  std::atomic<int> calls(0);
+  auto download = [&]()
+  {
+    ++calls;
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&release]() { return release; });
+    return std::string("done");
+  };
+
+  // Keep every thread busy, and queue one more download
+  std::vector<std::shared_future<std::string>> running;
+  for (int i = 0; i < GZ_MODEL_DOWNLOAD_THREADS; ++i)
+  {
+    running.push_back(
+        db->QueueDownload("test://fini/" + std::to_string(i), download));
+  }
+  auto queued = db->QueueDownload("test://fini/queued", download);
+
+  // Fini fails the queued download, then waits for the running ones
+  auto fini = std::async(std::launch::async, [db]() { db->Fini(); });
+  EXPECT_EQ(std::future_status::ready,
+      queued.wait_for(std::chrono::seconds(5)));
+  EXPECT_EQ("", queued.get());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  condition.notify_all();
+  fini.wait();
+
+  for (auto &future : running)
+    EXPECT_EQ("done", future.get());
+  EXPECT_EQ(GZ_MODEL_DOWNLOAD_THREADS, calls);
+
+  // Nothing is queued once stopped
+  EXPECT_EQ("", db->QueueDownload("test://fini/late", download).get());
+  EXPECT_EQ(GZ_MODEL_DOWNLOAD_THREADS, calls);
+
+  // Start lets downloads run again
+  db->Start();
+  EXPECT_EQ("done", db->QueueDownload("test://fini/late", download).get());
+  db->Fini();
+}
+
+/////////////////////////////////////////////////
+TEST_F(ModelDatabase, ResumeDownload)
+{
+  const boost::filesystem::path dir =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_model_database_%%%%");
+  boost::filesystem::create_directories(dir);
+
+  std::string content;
+  for (int i = 0; i < 10000; ++i)
+    content += static_cast<char>('a' + i % 26);
+  const boost::filesystem::path source = dir / "model.tar.gz";
+  WriteFile(source, content);
+  const std::string url = "file://" + source.string();
+
+  CURL *curl = curl_easy_init();
+  ASSERT_NE(nullptr, curl);
+
+  // A new file is downloaded whole
+  const boost::filesystem::path target = dir / "download";
+  EXPECT_TRUE(common::ResumeDownload(curl, url, target.string()));
+  EXPECT_EQ(content, ReadFile(target));
+
+  // A partial file is completed with the missing bytes only
+  WriteFile(target, content.substr(0, 4000));
+  EXPECT_TRUE(common::ResumeDownload(curl, url, target.string()));
+  EXPECT_EQ(content, ReadFile(target));
+
+  // A missing source fails, so that the caller tries again
+  boost::filesystem::remove(target);
+  EXPECT_FALSE(common::ResumeDownload(curl,
+        "file://" + (dir / "missing").string(), target.string()));
+
+  curl_easy_cleanup(curl);
+  boost::filesystem::remove_all(dir);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
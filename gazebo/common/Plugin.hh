@@ -36,6 +36,7 @@
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/PluginRegistry.hh"
 #include "gazebo/common/Exception.hh"
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -116,12 +117,7 @@ namespace gazebo
             {
               TPtr result;
               // PluginPtr result;
-              struct stat st;
-              bool found = false;
-              std::string fullname, filename(_filename);
-              std::list<std::string>::iterator iter;
-              std::list<std::string> pluginPaths =
-                common::SystemPaths::Instance()->GetPluginPaths();
+              std::string filename(_filename);
 
 #ifdef __APPLE__
               // This is a hack to work around issue #800,
@@ -153,41 +149,11 @@ namespace gazebo
               }
 #endif  // ifdef __APPLE__
 
-              for (iter = pluginPaths.begin();
-                   iter!= pluginPaths.end(); ++iter)
-              {
-                fullname = (*iter)+std::string("/")+filename;
-                fullname = boost::filesystem::path(fullname)
-                    .make_preferred().string();
-                if (stat(fullname.c_str(), &st) == 0)
-                {
-                  found = true;
-                  break;
-                }
-              }
-
-              if (!found)
-                fullname = filename;
-
               fptr_union_t registerFunc;
-              std::string registerName = "RegisterPlugin";
-
-              void *dlHandle = dlopen(fullname.c_str(), RTLD_LAZY|RTLD_GLOBAL);
-              if (!dlHandle)
-              {
-                gzerr << "Failed to load plugin " << fullname << ": "
-                  << dlerror() << "\n";
-                return result;
-              }
-
-              registerFunc.ptr = dlsym(dlHandle, registerName.c_str());
-
+              void *dlHandle = nullptr;
+              registerFunc.ptr = PluginRegistry::Factory(filename, dlHandle);
               if (!registerFunc.ptr)
-              {
-                gzerr << "Failed to resolve " << registerName
-                      << ": " << dlerror();
                 return result;
-              }
 
               // Register the new controller.
               result.reset(registerFunc.func());
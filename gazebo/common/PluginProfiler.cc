@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Timestamp.hh"
+#include "gazebo/common/PluginProfiler.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Minimum time between two slow call warnings of a plugin, in
+/// nanoseconds.
+static const int64_t WARNING_PERIOD = 10000000000;
+
+/// \brief Plugin the connections of this thread are attributed to.
+static thread_local PluginCallbackStats *g_currentPlugin = nullptr;
+
+/// \brief True if callbacks are timed.
+static std::atomic<bool> g_profilerEnabled(true);
+
+/// \brief Duration above which a call logs a warning, in nanoseconds.
+static std::atomic<int64_t> g_warningThreshold(0);
+
+/// \brief Stats of every plugin that was timed.
+class PluginStatsRegistry
+{
+  /// \brief Stats by filename and instance name.
+  public: std::map<std::pair<std::string, std::string>,
+          std::unique_ptr<PluginCallbackStats>> stats;
+
+  /// \brief Stats in the order they were created.
+  public: std::vector<const PluginCallbackStats *> ordered;
+
+  /// \brief Protects the stats.
+  public: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the registry of the stats. It is never destroyed, since
+/// static events may call timed callbacks while the process exits.
+/// \return The registry.
+static PluginStatsRegistry &Registry()
+{
+  static PluginStatsRegistry *registry = new PluginStatsRegistry;
+  return *registry;
+}
+
+//////////////////////////////////////////////////
+PluginCallbackStats::PluginCallbackStats(const std::string &_filename,
+    const std::string &_instance)
+  : filename(_filename), instance(_instance)
+{
+}
+
+//////////////////////////////////////////////////
+void PluginCallbackStats::Record(const int64_t _nsec)
+{
+  ++this->calls;
+  this->totalTime += _nsec;
+
+  int64_t max = this->maxTime;
+  while (_nsec > max && !this->maxTime.compare_exchange_weak(max, _nsec))
+  {
+  }
+
+  const int64_t threshold = g_warningThreshold;
+  if (threshold <= 0 || _nsec <= threshold)
+    return;
+
+  const int64_t now = Timestamp::Now().Nanoseconds();
+  int64_t last = this->lastWarning;
+  if ((last != 0 && now - last < WARNING_PERIOD) ||
+      !this->lastWarning.compare_exchange_strong(last, now))
+  {
+    return;
+  }
+
+  gzwarn << "Plugin [" << this->instance << "] from [" << this->filename
+    << "] spent " << _nsec * 1e-6 << " ms in an event callback, more than "
+    << "the limit of " << threshold * 1e-6 << " ms.\n";
+}
+
+//////////////////////////////////////////////////
+PluginProfiler::Scope::Scope(const std::string &_filename,
+    const std::string &_instance)
+  : previous(g_currentPlugin)
+{
+  if (!g_profilerEnabled)
+  {
+    g_currentPlugin = nullptr;
+    return;
+  }
+
+  PluginStatsRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto &stats = registry.stats[std::make_pair(_filename, _instance)];
+  if (!stats)
+  {
+    stats.reset(new PluginCallbackStats(_filename, _instance));
+    registry.ordered.push_back(stats.get());
+  }
+  g_currentPlugin = stats.get();
+}
+
+//////////////////////////////////////////////////
+PluginProfiler::Scope::Scope(PluginCallbackStats *_stats)
+  : previous(g_currentPlugin)
+{
+  g_currentPlugin = _stats;
+}
+
+//////////////////////////////////////////////////
+PluginProfiler::Scope::~Scope()
+{
+  g_currentPlugin = this->previous;
+}
+
+//////////////////////////////////////////////////
+PluginProfiler::Timer::Timer(PluginCallbackStats *_stats)
+  : stats(_stats), scope(_stats), start(Timestamp::Now().Nanoseconds())
+{
+}
+
+//////////////////////////////////////////////////
+PluginProfiler::Timer::~Timer()
+{
+  this->stats->Record(Timestamp::Now().Nanoseconds() - this->start);
+}
+
+//////////////////////////////////////////////////
+PluginCallbackStats *PluginProfiler::Current()
+{
+  return g_currentPlugin;
+}
+
+//////////////////////////////////////////////////
+void PluginProfiler::SetEnabled(const bool _enabled)
+{
+  g_profilerEnabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool PluginProfiler::Enabled()
+{
+  return g_profilerEnabled;
+}
+
+//////////////////////////////////////////////////
+void PluginProfiler::SetWarningThreshold(const double _seconds)
+{
+  g_warningThreshold = _seconds > 0 ?
+      Timestamp::FromSeconds(_seconds).Nanoseconds() : 0;
+}
+
+//////////////////////////////////////////////////
+double PluginProfiler::WarningThreshold()
+{
+  return g_warningThreshold * 1e-9;
+}
+
+//////////////////////////////////////////////////
+std::vector<const PluginCallbackStats *> PluginProfiler::Stats()
+{
+  PluginStatsRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.ordered;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PLUGINPROFILER_HH_
+#define GAZEBO_COMMON_PLUGINPROFILER_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class PluginCallbackStats PluginProfiler.hh common/common.hh
+    /// \brief Time spent in the event callbacks of one plugin instance.
+    class GZ_COMMON_VISIBLE PluginCallbackStats
+    {
+      /// \brief Constructor.
+      /// \param[in] _filename Filename of the plugin library.
+      /// \param[in] _instance Scoped name of the plugin instance.
+      public: PluginCallbackStats(const std::string &_filename,
+                  const std::string &_instance);
+
+      /// \brief Add the duration of a call.
+      /// \param[in] _nsec Wall time in nanoseconds.
+      public: void Record(const int64_t _nsec);
+
+      /// \brief Filename of the plugin library.
+      public: const std::string filename;
+
+      /// \brief Scoped name of the plugin instance.
+      public: const std::string instance;
+
+      /// \brief Number of calls.
+      public: std::atomic<uint64_t> calls{0};
+
+      /// \brief Total wall time of the calls in nanoseconds.
+      public: std::atomic<int64_t> totalTime{0};
+
+      /// \brief Longest call in nanoseconds.
+      public: std::atomic<int64_t> maxTime{0};
+
+      /// \brief Wall clock time of the last slow call warning.
+      public: std::atomic<int64_t> lastWarning{0};
+    };
+
+    /// \class PluginProfiler PluginProfiler.hh common/common.hh
+    /// \brief Measures the time plugins spend in their event callbacks.
+    ///
+    /// While a Scope is alive, which the world, models and sensors open
+    /// around the Load and Init functions of their plugins, callbacks
+    /// connected to an event::EventT are wrapped with a timer that adds to
+    /// the stats of the plugin. Connections made from a timed callback are
+    /// attributed to the same plugin.
+    ///
+    /// A call longer than the warning threshold logs a warning, at most
+    /// once every 10 seconds per plugin instance.
+    class GZ_COMMON_VISIBLE PluginProfiler
+    {
+      /// \brief Attributes the connections made on this thread to a plugin
+      /// for as long as it is alive.
+      public: class GZ_COMMON_VISIBLE Scope
+      {
+        /// \brief Constructor.
+        /// \param[in] _filename Filename of the plugin library.
+        /// \param[in] _instance Scoped name of the plugin instance.
+        public: Scope(const std::string &_filename,
+                    const std::string &_instance);
+
+        /// \brief Constructor.
+        /// \param[in] _stats Stats to attribute the connections to, or null
+        /// to not time them.
+        public: explicit Scope(PluginCallbackStats *_stats);
+
+        /// \brief Destructor, restores the previous plugin.
+        public: ~Scope();
+
+        /// \brief Plugin of the enclosing scope.
+        private: PluginCallbackStats *previous;
+      };
+
+      /// \brief Times a callback for as long as it is alive.
+      public: class GZ_COMMON_VISIBLE Timer
+      {
+        /// \brief Constructor.
+        /// \param[in] _stats Stats to add the time to.
+        public: explicit Timer(PluginCallbackStats *_stats);
+
+        /// \brief Destructor, records the time.
+        public: ~Timer();
+
+        /// \brief Stats to add the time to.
+        private: PluginCallbackStats *stats;
+
+        /// \brief Attributes connections made by the callback.
+        private: Scope scope;
+
+        /// \brief Start time in nanoseconds.
+        private: int64_t start;
+      };
+
+      /// \brief Get the plugin connections are attributed to on this
+      /// thread.
+      /// \return Stats of the plugin, or null outside of a Scope.
+      public: static PluginCallbackStats *Current();
+
+      /// \brief Wrap a callback with a timer if connections are attributed
+      /// to a plugin.
+      /// \param[in] _callback Callback to wrap.
+      /// \return Timed callback, or _callback outside of a Scope.
+      public: template<typename R, typename... Args>
+              static std::function<R(Args...)> Wrap(
+                  const std::function<R(Args...)> &_callback)
+              {
+                PluginCallbackStats *stats = Current();
+                if (!stats || !_callback)
+                  return _callback;
+
+                return [_callback, stats](Args... _args) -> R
+                  {
+                    Timer timer(stats);
+                    return _callback(std::forward<Args>(_args)...);
+                  };
+              }
+
+      /// \brief Enable or disable timing. Enabled by default.
+      /// \param[in] _enabled False to connect callbacks without a timer.
+      public: static void SetEnabled(const bool _enabled);
+
+      /// \brief Get whether timing is enabled.
+      /// \return True if enabled.
+      public: static bool Enabled();
+
+      /// \brief Set the duration above which a call logs a warning.
+      /// \param[in] _seconds Wall time in seconds, zero to never warn.
+      public: static void SetWarningThreshold(const double _seconds);
+
+      /// \brief Get the duration above which a call logs a warning.
+      /// \return Wall time in seconds.
+      public: static double WarningThreshold();
+
+      /// \brief Get the stats of all the plugins that were timed. The
+      /// pointers stay valid until the end of the process.
+      /// \return Stats, in the order the plugins were first seen.
+      public: static std::vector<const PluginCallbackStats *> Stats();
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/PluginProfiler.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class PluginProfiler : public gazebo::testing::AutoLogFixture { };
+
+//////////////////////////////////////////////////
+/// \brief Find the stats of a plugin instance.
+/// \param[in] _instance Instance name.
+/// \return The stats, null if not found.
+const common::PluginCallbackStats *FindStats(const std::string &_instance)
+{
+  for (auto const stats : common::PluginProfiler::Stats())
+  {
+    if (stats->instance == _instance)
+      return stats;
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+TEST_F(PluginProfiler, Connect)
+{
+  event::EventT<void (int)> evt;
+  int count = 0;
+  event::ConnectionPtr untimed = evt.Connect([&count](int _n)
+      {
+        count += _n;
+      });
+  EXPECT_EQ(nullptr, common::PluginProfiler::Current());
+
+  event::ConnectionPtr timed, nested;
+  {
+    common::PluginProfiler::Scope scope("libtest.so", "model::plugin");
+    ASSERT_NE(nullptr, common::PluginProfiler::Current());
+    timed = evt.Connect([&](int _n)
+        {
+          count += _n;
+
+          // Connections made by a timed callback are timed too
+          if (!nested)
+          {
+            nested = evt.Connect([&count](int _m)
+                {
+                  count += _m;
+                });
+          }
+        });
+  }
+  EXPECT_EQ(nullptr, common::PluginProfiler::Current());
+
+  // The nested callback also runs in the signal that connects it
+  evt(1);
+  evt(1);
+  EXPECT_EQ(6, count);
+
+  const common::PluginCallbackStats *stats = FindStats("model::plugin");
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ("libtest.so", stats->filename);
+  EXPECT_EQ(4u, stats->calls);
+  EXPECT_GE(stats->totalTime, stats->maxTime);
+  EXPECT_GE(stats->maxTime, 0);
+
+  // The same instance reuses its stats
+  {
+    common::PluginProfiler::Scope scope("libtest.so", "model::plugin");
+    EXPECT_EQ(stats, common::PluginProfiler::Current());
+  }
+
+  // No timing when disabled
+  common::PluginProfiler::SetEnabled(false);
+  EXPECT_FALSE(common::PluginProfiler::Enabled());
+  {
+    common::PluginProfiler::Scope scope("libtest.so", "disabled");
+    EXPECT_EQ(nullptr, common::PluginProfiler::Current());
+  }
+  common::PluginProfiler::SetEnabled(true);
+  EXPECT_EQ(nullptr, FindStats("disabled"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(PluginProfiler, SlowCallback)
+{
+  common::PluginProfiler::SetWarningThreshold(0.001);
+  EXPECT_NEAR(0.001, common::PluginProfiler::WarningThreshold(), 1e-12);
+
+  event::EventT<void ()> evt;
+  event::ConnectionPtr conn;
+  {
+    common::PluginProfiler::Scope scope("libslow.so", "slow");
+    conn = evt.Connect([]()
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        });
+  }
+
+  evt();
+  evt();
+  const common::PluginCallbackStats *stats = FindStats("slow");
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(2u, stats->calls);
+  EXPECT_GE(stats->maxTime, 5000000);
+
+  // Warned once, the second slow call is within the warning period
+  EXPECT_NE(0, stats->lastWarning);
+
+  common::PluginProfiler::SetWarningThreshold(0);
+  EXPECT_DOUBLE_EQ(0.0, common::PluginProfiler::WarningThreshold());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <dlfcn.h>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/PluginRegistry.hh"
+#include "gazebo/common/SystemPaths.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief A plugin library in the registry.
+class PluginLibrary
+{
+  /// \brief Plugin paths the library was searched in.
+  public: std::list<std::string> paths;
+
+  /// \brief Handle of the library, nullptr if it failed to load.
+  public: void *handle = nullptr;
+
+  /// \brief Address of the RegisterPlugin function of the library.
+  public: void *factory = nullptr;
+};
+
+/// \brief Libraries by filename.
+static std::map<std::string, PluginLibrary> g_pluginLibraries;
+
+/// \brief Protects g_pluginLibraries.
+static std::mutex g_pluginLibrariesMutex;
+
+//////////////////////////////////////////////////
+void *PluginRegistry::Factory(const std::string &_filename, void *&_handle)
+{
+  const std::list<std::string> pluginPaths =
+    common::SystemPaths::Instance()->GetPluginPaths();
+
+  std::lock_guard<std::mutex> lock(g_pluginLibrariesMutex);
+  auto iter = g_pluginLibraries.find(_filename);
+  if (iter != g_pluginLibraries.end() && iter->second.paths == pluginPaths)
+  {
+    _handle = iter->second.handle;
+    return iter->second.factory;
+  }
+
+  PluginLibrary &library = g_pluginLibraries[_filename];
+  library = PluginLibrary();
+  library.paths = pluginPaths;
+
+  std::string fullname = common::SystemPaths::Instance()->FindFileInPaths(
+      _filename, pluginPaths);
+  if (!fullname.empty())
+  {
+    fullname = boost::filesystem::path(fullname)
+        .make_preferred().string();
+  }
+  else
+  {
+    fullname = _filename;
+  }
+
+  library.handle = dlopen(fullname.c_str(), RTLD_LAZY|RTLD_GLOBAL);
+  if (!library.handle)
+  {
+    gzerr << "Failed to load plugin " << fullname << ": "
+      << dlerror() << "\n";
+    return nullptr;
+  }
+
+  library.factory = dlsym(library.handle, "RegisterPlugin");
+  if (!library.factory)
+  {
+    gzerr << "Failed to resolve RegisterPlugin: " << dlerror();
+    return nullptr;
+  }
+
+  _handle = library.handle;
+  return library.factory;
+}
+
+//////////////////////////////////////////////////
+unsigned int PluginRegistry::Count()
+{
+  std::lock_guard<std::mutex> lock(g_pluginLibrariesMutex);
+  return g_pluginLibraries.size();
+}
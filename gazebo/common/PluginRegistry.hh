@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PLUGINREGISTRY_HH_
+#define GAZEBO_COMMON_PLUGINREGISTRY_HH_
+
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class PluginRegistry PluginRegistry.hh common/common.hh
+    /// \brief Process wide cache of the plugin libraries.
+    ///
+    /// The first plugin created from a library finds the library in the
+    /// plugin paths, opens it and resolves its RegisterPlugin symbol. The
+    /// next plugins created from the same library, by any world, model or
+    /// sensor, reuse the handle and the symbol. A library that failed to
+    /// load is not tried again, unless the plugin paths change.
+    class GZ_COMMON_VISIBLE PluginRegistry
+    {
+      /// \brief Get the RegisterPlugin function of a plugin library,
+      /// loading the library on first use. Errors are logged.
+      /// \param[in] _filename Filename of the library, searched in the
+      /// plugin paths.
+      /// \param[out] _handle Handle of the library.
+      /// \return Address of the RegisterPlugin function, or nullptr if the
+      /// library or the function couldn't be loaded.
+      public: static void *Factory(const std::string &_filename,
+                                   void *&_handle);
+
+      /// \brief Get the number of libraries in the registry.
+      /// \return Number of libraries, including the ones that failed to
+      /// load.
+      public: static unsigned int Count();
+    };
+    /// \}
+  }
+}
+#endif
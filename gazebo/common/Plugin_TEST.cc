@@ -69,6 +69,30 @@ TEST_F(PluginTest, LoadWorldPlugin)
   EXPECT_EQ(plugin->GetHandle(), "pluginInterfaceTest");
 }
 
+TEST_F(PluginTest, SharedLibrary)
+{
+  ModelPluginPtr first = ModelPlugin::Create("libBuoyancyPlugin.so",
+                                             "first");
+  ASSERT_TRUE(first != nullptr);
+  const unsigned int count = common::PluginRegistry::Count();
+
+  // The second plugin reuses the library opened for the first one
+  ModelPluginPtr second = ModelPlugin::Create("libBuoyancyPlugin.so",
+                                              "second");
+  ASSERT_TRUE(second != nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(count, common::PluginRegistry::Count());
+  EXPECT_EQ(second->GetHandle(), "second");
+
+  // A missing library is only looked up once
+  EXPECT_TRUE(ModelPlugin::Create("libMissingPlugin.so", "missing") ==
+      nullptr);
+  EXPECT_EQ(count + 1, common::PluginRegistry::Count());
+  EXPECT_TRUE(ModelPlugin::Create("libMissingPlugin.so", "missing") ==
+      nullptr);
+  EXPECT_EQ(count + 1, common::PluginRegistry::Count());
+}
+
 TEST_F(PluginTest, LoadSensorPlugin)
 {
   SensorPluginPtr plugin = SensorPlugin::Create("libContactPlugin.so",
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PROFILER_HH_
+#define GAZEBO_COMMON_PROFILER_HH_
+
+#include <ignition/common/Profiler.hh>
+
+#include "gazebo/common/TraceRecorder.hh"
+
+// Builds with ENABLE_PROFILER send the scopes to the Ignition profiler.
+// Other builds record them with common::TraceRecorder while a trace is
+// being recorded, and otherwise only read a flag.
+#if !IGN_PROFILER_ENABLE
+
+#undef IGN_PROFILE_THREAD_NAME
+#undef IGN_PROFILE_BEGIN
+#undef IGN_PROFILE_END
+#undef IGN_PROFILE
+
+#define GZ_PROFILE_CONCAT_IMPL(_a, _b) _a##_b
+#define GZ_PROFILE_CONCAT(_a, _b) GZ_PROFILE_CONCAT_IMPL(_a, _b)
+
+/// \brief Set the name of the calling thread in the traces.
+#define IGN_PROFILE_THREAD_NAME(_name) \
+  gazebo::common::TraceRecorder::SetThreadName(_name)
+
+/// \brief Begin a scope, ended by IGN_PROFILE_END.
+#define IGN_PROFILE_BEGIN(_name) \
+  gazebo::common::TraceRecorder::BeginScope(_name)
+
+/// \brief End the scope begun last by IGN_PROFILE_BEGIN, if it was
+/// recorded.
+#define IGN_PROFILE_END() \
+  gazebo::common::TraceRecorder::EndScope()
+
+/// \brief Record a scope until the end of the enclosing block.
+#define IGN_PROFILE(_name) \
+  gazebo::common::TraceRecorder::Scope \
+    GZ_PROFILE_CONCAT(gzProfileScope, __LINE__)(_name)
+
+#endif
+#endif
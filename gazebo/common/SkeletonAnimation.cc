@@ -15,24 +15,116 @@
  *
 */
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "gazebo/common/SkeletonAnimation.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Assert.hh"
 
+/// \internal
+/// \brief Private data for the NodeAnimation class.
+class gazebo::common::NodeAnimationPrivate
+{
+  /// \brief Times of the key frames, sorted, so that frames are found by
+  /// index.
+  public: std::vector<double> keyTimes;
+
+  /// \brief Transformations of the key frames, in the order of keyTimes.
+  public: std::vector<ignition::math::Matrix4d> keyTransforms;
+
+  /// \brief Rotations of keyTransforms, so that they aren't extracted from
+  /// the matrices at every interpolation.
+  public: std::vector<ignition::math::Quaterniond> keyRotations;
+};
+
+/// \internal
+/// \brief Private data for the SkeletonAnimation class.
+class gazebo::common::SkeletonAnimationPrivate
+{
+  /// \brief The node animations in the order they were added, which is the
+  /// order of NodeIndex.
+  public: std::vector<NodeAnimation *> nodes;
+};
+
 using namespace gazebo;
 using namespace common;
 
+namespace
+{
+  /// \brief Private data of the node animations, by node animation. It is
+  /// kept out of NodeAnimation so that the layout of the class doesn't
+  /// change.
+  class NodeAnimationPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the node animations.
+    public: static NodeAnimationPrivates &Instance()
+    {
+      static NodeAnimationPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by node animation.
+    public: std::unordered_map<const NodeAnimation *,
+            std::unique_ptr<NodeAnimationPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+
+  /// \brief Private data of the skeleton animations, by skeleton
+  /// animation. It is kept out of SkeletonAnimation so that the layout of
+  /// the class doesn't change.
+  class SkeletonAnimationPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the skeleton animations.
+    public: static SkeletonAnimationPrivates &Instance()
+    {
+      static SkeletonAnimationPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by skeleton animation.
+    public: std::unordered_map<const SkeletonAnimation *,
+            std::unique_ptr<SkeletonAnimationPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 NodeAnimation::NodeAnimation(const std::string& _name)
 {
   this->name = _name;
   this->length = 0.0;
+
+  NodeAnimationPrivates &privates = NodeAnimationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new NodeAnimationPrivate);
 }
 
 //////////////////////////////////////////////////
 NodeAnimation::~NodeAnimation()
 {
   this->keyFrames.clear();
+
+  NodeAnimationPrivates &privates = NodeAnimationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+NodeAnimationPrivate *NodeAnimation::NodeAnimationData() const
+{
+  NodeAnimationPrivates &privates = NodeAnimationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -55,6 +147,24 @@ void NodeAnimation::AddKeyFrame(const double _time,
     this->length = _time;
 
   this->keyFrames[_time] = _trans;
+
+  // Keep the key frame arrays sorted like the map
+  NodeAnimationPrivate *data = this->NodeAnimationData();
+  auto iter = std::lower_bound(data->keyTimes.begin(), data->keyTimes.end(),
+      _time);
+  const size_t index = iter - data->keyTimes.begin();
+  if (iter != data->keyTimes.end() && *iter == _time)
+  {
+    data->keyTransforms[index] = _trans;
+    data->keyRotations[index] = _trans.Rotation();
+  }
+  else
+  {
+    data->keyTimes.insert(iter, _time);
+    data->keyTransforms.insert(data->keyTransforms.begin() + index, _trans);
+    data->keyRotations.insert(data->keyRotations.begin() + index,
+        _trans.Rotation());
+  }
 }
 
 //////////////////////////////////////////////////
@@ -84,13 +194,9 @@ void NodeAnimation::GetKeyFrame(const unsigned int _i, double &_time,
   }
   else
   {
-    std::map<double, ignition::math::Matrix4d>::const_iterator iter =
-      this->keyFrames.begin();
-
-    std::advance(iter, _i);
-
-    _time = iter->first;
-    _trans = iter->second;
+    NodeAnimationPrivate *data = this->NodeAnimationData();
+    _time = data->keyTimes[_i];
+    _trans = data->keyTransforms[_i];
   }
 }
 
@@ -114,6 +220,19 @@ double NodeAnimation::GetLength() const
 //////////////////////////////////////////////////
 ignition::math::Matrix4d NodeAnimation::FrameAt(double _time, bool _loop) const
 {
+  unsigned int cursor = 0;
+  return this->FrameAt(_time, _loop, cursor);
+}
+
+//////////////////////////////////////////////////
+ignition::math::Matrix4d NodeAnimation::FrameAt(double _time, bool _loop,
+    unsigned int &_cursor) const
+{
+  NodeAnimationPrivate *data = this->NodeAnimationData();
+  const size_t count = data->keyTimes.size();
+  if (count == 0)
+    return ignition::math::Matrix4d::Identity;
+
   double time = _time;
   if (time > this->length)
   {
@@ -125,23 +244,34 @@ ignition::math::Matrix4d NodeAnimation::FrameAt(double _time, bool _loop) const
   }
 
   if (ignition::math::equal(time, this->length))
-    return this->keyFrames.rbegin()->second;
-
-  std::map<double, ignition::math::Matrix4d>::const_iterator it1 =
-    this->keyFrames.upper_bound(time);
+    return data->keyTransforms.back();
 
-  if (it1 == this->keyFrames.begin() || ignition::math::equal(it1->first, time))
-    return it1->second;
+  // Index of the first key frame after time. The cursor is still valid, or
+  // a few frames behind, when the animation plays forward.
+  size_t next = _cursor;
+  if (next == 0 || next > count || data->keyTimes[next - 1] > time)
+  {
+    next = std::upper_bound(data->keyTimes.begin(), data->keyTimes.end(),
+        time) - data->keyTimes.begin();
+  }
+  else
+  {
+    while (next < count && data->keyTimes[next] <= time)
+      ++next;
+  }
+  _cursor = static_cast<unsigned int>(next);
 
-  std::map<double, ignition::math::Matrix4d>::const_iterator it2 = it1--;
+  if (next == count)
+    return data->keyTransforms.back();
 
-  if (ignition::math::equal(it2->first, time))
-    return it2->second;
+  if (next == 0 || ignition::math::equal(data->keyTimes[next], time))
+    return data->keyTransforms[next];
 
-  double nextKey = it2->first;
-  ignition::math::Matrix4d nextTrans = it2->second;
-  double prevKey = it1->first;
-  ignition::math::Matrix4d prevTrans = it1->second;
+  const size_t prev = next - 1;
+  double nextKey = data->keyTimes[next];
+  const ignition::math::Matrix4d &nextTrans = data->keyTransforms[next];
+  double prevKey = data->keyTimes[prev];
+  const ignition::math::Matrix4d &prevTrans = data->keyTransforms[prev];
 
   double t = (time - prevKey) / (nextKey - prevKey);
   if (t < 0.0 || t > 1.0)
@@ -158,10 +288,8 @@ ignition::math::Matrix4d NodeAnimation::FrameAt(double _time, bool _loop) const
       prevPos.Y() + ((nextPos.Y() - prevPos.Y()) * t),
       prevPos.Z() + ((nextPos.Z() - prevPos.Z()) * t));
 
-  ignition::math::Quaterniond nextRot = nextTrans.Rotation();
-  ignition::math::Quaterniond prevRot = prevTrans.Rotation();
   ignition::math::Quaterniond rot = ignition::math::Quaterniond::Slerp(t,
-      prevRot, nextRot, true);
+      data->keyRotations[prev], data->keyRotations[next], true);
 
   ignition::math::Matrix4d trans(rot);
   trans.SetTranslation(pos);
@@ -178,6 +306,9 @@ void NodeAnimation::Scale(const double _scale)
     ignition::math::Vector3d pos = mat->Translation();
     mat->SetTranslation(pos * _scale);
   }
+
+  for (auto &mat : this->NodeAnimationData()->keyTransforms)
+    mat.SetTranslation(mat.Translation() * _scale);
 }
 
 //////////////////////////////////////////////////
@@ -208,12 +339,28 @@ double NodeAnimation::GetTimeAtX(const double _x) const
 SkeletonAnimation::SkeletonAnimation(const std::string& _name)
 {
   this->name = _name;
+
+  SkeletonAnimationPrivates &privates = SkeletonAnimationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new SkeletonAnimationPrivate);
 }
 
 //////////////////////////////////////////////////
 SkeletonAnimation::~SkeletonAnimation()
 {
   this->animations.clear();
+
+  SkeletonAnimationPrivates &privates = SkeletonAnimationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+SkeletonAnimationPrivate *SkeletonAnimation::SkeletonAnimationData() const
+{
+  SkeletonAnimationPrivates &privates = SkeletonAnimationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -245,7 +392,11 @@ void SkeletonAnimation::AddKeyFrame(const std::string& _node,
     const double _time, const ignition::math::Matrix4d &_mat)
 {
   if (this->animations.find(_node) == this->animations.end())
+  {
     this->animations[_node] = new NodeAnimation(_node);
+    this->SkeletonAnimationData()->nodes.push_back(
+        this->animations[_node]);
+  }
 
   if (_time > this->length)
     this->length = _time;
@@ -258,7 +409,11 @@ void SkeletonAnimation::AddKeyFrame(const std::string &_node,
       const double _time, const ignition::math::Pose3d &_pose)
 {
   if (this->animations.find(_node) == this->animations.end())
+  {
     this->animations[_node] = new NodeAnimation(_node);
+    this->SkeletonAnimationData()->nodes.push_back(
+        this->animations[_node]);
+  }
 
   if (_time > this->length)
     this->length = _time;
@@ -298,6 +453,40 @@ std::map<std::string, ignition::math::Matrix4d> SkeletonAnimation::PoseAt(
 //////////////////////////////////////////////////
 std::map<std::string, ignition::math::Matrix4d> SkeletonAnimation::PoseAtX(
     const double _x, const std::string &_node, const bool _loop) const
+{
+  return this->PoseAt(this->TimeAtX(_x, _node, _loop), _loop);
+}
+
+//////////////////////////////////////////////////
+int SkeletonAnimation::NodeIndex(const std::string &_node) const
+{
+  const std::vector<NodeAnimation *> &nodes =
+      this->SkeletonAnimationData()->nodes;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i]->GetName() == _node)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+//////////////////////////////////////////////////
+void SkeletonAnimation::PoseAt(const double _time,
+    std::vector<ignition::math::Matrix4d> &_pose,
+    std::vector<unsigned int> &_cursors, const bool _loop) const
+{
+  const std::vector<NodeAnimation *> &nodes =
+      this->SkeletonAnimationData()->nodes;
+  _pose.resize(nodes.size());
+  _cursors.resize(nodes.size(), 0);
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+    _pose[i] = nodes[i]->FrameAt(_time, _loop, _cursors[i]);
+}
+
+//////////////////////////////////////////////////
+double SkeletonAnimation::TimeAtX(const double _x, const std::string &_node,
+    const bool _loop) const
 {
   std::map<std::string, NodeAnimation*>::const_iterator nodeAnim =
       this->animations.find(_node);
@@ -317,9 +506,7 @@ std::map<std::string, ignition::math::Matrix4d> SkeletonAnimation::PoseAtX(
   while (x > lastX)
     x -= lastX;
 
-  double time = nodeAnim->second->GetTimeAtX(x);
-
-  return this->PoseAt(time, _loop);
+  return nodeAnim->second->GetTimeAtX(x);
 }
 
 //////////////////////////////////////////////////
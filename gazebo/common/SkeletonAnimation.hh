@@ -20,6 +20,7 @@
 #include <map>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include <ignition/math/Matrix4.hh>
 #include <ignition/math/Pose3.hh>
@@ -31,6 +32,10 @@ namespace gazebo
 {
   namespace common
   {
+    // Forward declare private data classes
+    class NodeAnimationPrivate;
+    class SkeletonAnimationPrivate;
+
     /// \addtogroup gazebo_common Common Animation
     /// \{
 
@@ -99,6 +104,19 @@ namespace gazebo
       public: ignition::math::Matrix4d FrameAt(
                   double _time, bool _loop = true) const;
 
+      /// \brief Returns a frame transformation at a specific time, like
+      /// FrameAt(double, bool), starting the search for the surrounding key
+      /// frames at a cursor. Playing an animation forward through the same
+      /// cursor finds the key frames in constant time.
+      /// \param[in] _time the time
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// (see GetLength)
+      /// \param[in,out] _cursor Index of the key frame following the
+      /// previous time, 0 when unknown. Updated for the next call.
+      /// \return The transformation.
+      public: ignition::math::Matrix4d FrameAt(double _time, bool _loop,
+                  unsigned int &_cursor) const;
+
       /// \brief Scales each transformation in the key frames. This only affects
       /// the translational values.
       /// \param[in] _scale the scaling factor
@@ -112,6 +130,12 @@ namespace gazebo
       /// valid range.
       public: double GetTimeAtX(const double _x) const;
 
+      /// \internal
+      /// \brief Get the private data of this node animation. It is kept out
+      /// of the class so that its layout doesn't change.
+      /// \return The private data.
+      private: NodeAnimationPrivate *NodeAnimationData() const;
+
       /// \brief the name of the animation
       protected: std::string name;
 
@@ -200,6 +224,40 @@ namespace gazebo
                   const double _x, const std::string &_node,
                   const bool _loop = true) const;
 
+      /// \brief Get the index of a node in the poses of
+      /// PoseAt(double, std::vector<ignition::math::Matrix4d> &,
+      /// std::vector<unsigned int> &, bool). Indices don't change as key
+      /// frames are added.
+      /// \param[in] _node the name of the animation node
+      /// \return Index of the node, -1 if the animation has no such node.
+      public: int NodeIndex(const std::string &_node) const;
+
+      /// \brief Get the transformation of every node at a specific time,
+      /// like PoseAt(double, bool), into preallocated storage and without
+      /// looking nodes up by name. Used to evaluate an animation every frame.
+      /// \param[in] _time the time
+      /// \param[out] _pose Transformation of every node, by NodeIndex.
+      /// Resized to GetNodeCount when needed.
+      /// \param[in,out] _cursors Key frame cursor of every node, see
+      /// NodeAnimation::FrameAt. Resized to GetNodeCount when needed, and
+      /// kept by the caller between calls.
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// (see GetLength)
+      public: void PoseAt(const double _time,
+                  std::vector<ignition::math::Matrix4d> &_pose,
+                  std::vector<unsigned int> &_cursors,
+                  const bool _loop = true) const;
+
+      /// \brief Get the time at which a named node transformation's
+      /// translational value along the X axis is equal to _x, as used by
+      /// PoseAtX.
+      /// \param[in] _x the value along x.
+      /// \param[in] _node the name of the animation node
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// (see GetLength)
+      /// \return The time.
+      public: double TimeAtX(const double _x, const std::string &_node,
+                  const bool _loop = true) const;
 
       /// \brief Scales every animation in the animations list
       /// \param[in] _scale the scaling factor
@@ -209,6 +267,12 @@ namespace gazebo
       /// \return the duration in seconds
       public: double GetLength() const;
 
+      /// \internal
+      /// \brief Get the private data of this skeleton animation. It is kept
+      /// out of the class so that its layout doesn't change.
+      /// \return The private data.
+      private: SkeletonAnimationPrivate *SkeletonAnimationData() const;
+
       /// \brief the node name
       protected: std::string name;
 
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/SkeletonAnimation.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SkeletonAnimationTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Get the transform of a test key frame.
+/// \param[in] _x Translation along X.
+/// \param[in] _yaw Rotation about Z.
+/// \return The transform.
+ignition::math::Matrix4d keyFrame(const double _x, const double _yaw)
+{
+  return ignition::math::Matrix4d(ignition::math::Pose3d(_x, 1, 0, 0, 0,
+      _yaw));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SkeletonAnimationTest, NodeFrames)
+{
+  // Key frames added out of order
+  common::NodeAnimation anim("node");
+  anim.AddKeyFrame(2.0, keyFrame(4, 1.0));
+  anim.AddKeyFrame(0.0, keyFrame(0, 0.0));
+  anim.AddKeyFrame(1.0, keyFrame(1, 0.5));
+  EXPECT_EQ(3u, anim.GetFrameCount());
+  EXPECT_DOUBLE_EQ(2.0, anim.GetLength());
+
+  for (unsigned int i = 0; i < 3; ++i)
+    EXPECT_DOUBLE_EQ(static_cast<double>(i), anim.KeyFrame(i).first);
+  EXPECT_EQ(keyFrame(1, 0.5), anim.KeyFrame(1).second);
+
+  // Replace a key frame
+  anim.AddKeyFrame(1.0, keyFrame(2, 0.5));
+  EXPECT_EQ(3u, anim.GetFrameCount());
+  EXPECT_EQ(keyFrame(2, 0.5), anim.KeyFrame(1).second);
+
+  EXPECT_EQ(keyFrame(0, 0.0), anim.FrameAt(0.0));
+  EXPECT_EQ(keyFrame(2, 0.5), anim.FrameAt(1.0));
+  EXPECT_EQ(keyFrame(3, 0.75), anim.FrameAt(1.5));
+  EXPECT_EQ(keyFrame(4, 1.0), anim.FrameAt(2.0));
+
+  // Looping
+  EXPECT_EQ(keyFrame(1, 0.25), anim.FrameAt(2.5));
+  EXPECT_EQ(keyFrame(4, 1.0), anim.FrameAt(2.5, false));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SkeletonAnimationTest, NodeCursor)
+{
+  common::NodeAnimation anim("node");
+  for (unsigned int i = 0; i <= 10; ++i)
+    anim.AddKeyFrame(i * 0.3, keyFrame(i * i, i * 0.1));
+
+  // Forward, looping several times, then backward
+  unsigned int cursor = 0;
+  for (int i = 0; i < 200; ++i)
+  {
+    const double time = i * 0.07;
+    EXPECT_EQ(anim.FrameAt(time), anim.FrameAt(time, true, cursor));
+  }
+  for (int i = 60; i >= 0; --i)
+  {
+    const double time = i * 0.05;
+    EXPECT_EQ(anim.FrameAt(time, false), anim.FrameAt(time, false, cursor));
+  }
+
+  // Out of range cursor
+  cursor = 100;
+  EXPECT_EQ(anim.FrameAt(1.0), anim.FrameAt(1.0, true, cursor));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SkeletonAnimationTest, Pose)
+{
+  common::SkeletonAnimation anim("walk");
+  for (unsigned int i = 0; i <= 4; ++i)
+  {
+    anim.AddKeyFrame("root", i * 0.5, keyFrame(i, 0.0));
+    anim.AddKeyFrame("arm", i * 0.5, keyFrame(0, i * 0.2));
+  }
+  anim.AddKeyFrame("leg", 1.0, keyFrame(1, 1.0));
+
+  EXPECT_EQ(3u, anim.GetNodeCount());
+  EXPECT_EQ(0, anim.NodeIndex("root"));
+  EXPECT_EQ(1, anim.NodeIndex("arm"));
+  EXPECT_EQ(2, anim.NodeIndex("leg"));
+  EXPECT_EQ(-1, anim.NodeIndex("head"));
+
+  std::vector<ignition::math::Matrix4d> pose;
+  std::vector<unsigned int> cursors;
+  const std::vector<std::string> nodes = {"root", "arm", "leg"};
+  for (int i = 0; i < 50; ++i)
+  {
+    const double time = i * 0.1;
+    const std::map<std::string, ignition::math::Matrix4d> expected =
+      anim.PoseAt(time);
+    anim.PoseAt(time, pose, cursors);
+    ASSERT_EQ(3u, pose.size());
+    ASSERT_EQ(3u, cursors.size());
+    for (size_t n = 0; n < nodes.size(); ++n)
+      EXPECT_EQ(expected.at(nodes[n]), pose[n]);
+  }
+
+  // Time along the X axis
+  EXPECT_DOUBLE_EQ(0.75, anim.TimeAtX(1.5, "root"));
+  EXPECT_EQ(keyFrame(1.5, 0.0), anim.PoseAtX(1.5, "root")["root"]);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
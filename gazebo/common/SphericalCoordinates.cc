@@ -15,6 +15,7 @@
  *
 */
 #include <string>
+#include <vector>
 #include <math.h>
 
 #include "gazebo/common/Console.hh"
@@ -39,6 +40,106 @@ const double g_EarthWGS84Flattening = 1.0/298.257223563;
 // Radius of the Earth (meters).
 const double g_EarthRadius = 6371000.0;
 
+//////////////////////////////////////////////////
+/// \brief Check a coordinate type.
+/// \param[in] _type The coordinate type.
+/// \return True if the type is one of SPHERICAL, ECEF, GLOBAL and LOCAL.
+static bool ValidType(const SphericalCoordinates::CoordinateType _type)
+{
+  return _type == SphericalCoordinates::SPHERICAL ||
+      _type == SphericalCoordinates::ECEF ||
+      _type == SphericalCoordinates::GLOBAL ||
+      _type == SphericalCoordinates::LOCAL;
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert a position to ECEF.
+/// \param[in] _data Ellipsoid and cached transforms.
+/// \param[in] _pos Position in frame _in, with angles in radians.
+/// \param[in] _in Valid CoordinateType of _pos.
+/// \return The ECEF position.
+static ignition::math::Vector3d ToECEF(
+    const SphericalCoordinatesPrivate &_data,
+    const ignition::math::Vector3d &_pos,
+    const SphericalCoordinates::CoordinateType _in)
+{
+  switch (_in)
+  {
+    case SphericalCoordinates::LOCAL:
+      return _data.origin + _data.rotLocalToECEF * _pos;
+
+    case SphericalCoordinates::GLOBAL:
+      return _data.origin + _data.rotGlobalToECEF * _pos;
+
+    case SphericalCoordinates::SPHERICAL:
+      {
+        double cosLat = cos(_pos.X());
+        double sinLat = sin(_pos.X());
+        double cosLon = cos(_pos.Y());
+        double sinLon = sin(_pos.Y());
+
+        // Radius of planet curvature (meters)
+        double curvature = _data.ellA /
+            sqrt(1.0 - _data.ellE2 * sinLat * sinLat);
+
+        return ignition::math::Vector3d(
+            (_pos.Z() + curvature) * cosLat * cosLon,
+            (_pos.Z() + curvature) * cosLat * sinLon,
+            (_data.ellB2A2 * curvature + _pos.Z()) * sinLat);
+      }
+
+    default:
+      return _pos;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert an ECEF position.
+/// \param[in] _data Ellipsoid and cached transforms.
+/// \param[in] _ecef The ECEF position.
+/// \param[in] _out Valid CoordinateType of the result.
+/// \return Position in frame _out, with angles in radians.
+static ignition::math::Vector3d FromECEF(
+    const SphericalCoordinatesPrivate &_data,
+    const ignition::math::Vector3d &_ecef,
+    const SphericalCoordinates::CoordinateType _out)
+{
+  switch (_out)
+  {
+    case SphericalCoordinates::SPHERICAL:
+      {
+        double p = sqrt(_ecef.X() * _ecef.X() + _ecef.Y() * _ecef.Y());
+        double theta = atan((_ecef.Z() * _data.ellA) / (p * _data.ellB));
+        double sinTheta = sin(theta);
+        double cosTheta = cos(theta);
+
+        // Calculate latitude and longitude
+        double lat = atan(
+            (_ecef.Z() + _data.ellP2 * _data.ellB *
+             sinTheta * sinTheta * sinTheta) /
+            (p - _data.ellE2 * _data.ellA * cosTheta * cosTheta * cosTheta));
+
+        double lon = atan2(_ecef.Y(), _ecef.X());
+
+        // Recalculate radius of planet curvature at the current latitude.
+        double sinLat = sin(lat);
+        double nCurvature = _data.ellA /
+            sqrt(1.0 - _data.ellE2 * sinLat * sinLat);
+
+        return ignition::math::Vector3d(lat, lon, p / cos(lat) - nCurvature);
+      }
+
+    case SphericalCoordinates::GLOBAL:
+      return _data.rotECEFToGlobal * (_ecef - _data.origin);
+
+    case SphericalCoordinates::LOCAL:
+      return _data.rotECEFToLocal * (_ecef - _data.origin);
+
+    default:
+      return _ecef;
+  }
+}
+
 //////////////////////////////////////////////////
 SphericalCoordinates::SurfaceType SphericalCoordinates::Convert(
   const std::string &_str)
@@ -154,6 +255,13 @@ void SphericalCoordinates::SetSurfaceType(const SurfaceType &_type)
           std::pow(this->dataPtr->ellA, 2) / std::pow(this->dataPtr->ellB, 2) -
           1.0);
 
+      // Cache the squares used by every position transform
+      this->dataPtr->ellE2 = this->dataPtr->ellE * this->dataPtr->ellE;
+      this->dataPtr->ellP2 = this->dataPtr->ellP * this->dataPtr->ellP;
+      this->dataPtr->ellB2A2 =
+          (this->dataPtr->ellB * this->dataPtr->ellB) /
+          (this->dataPtr->ellA * this->dataPtr->ellA);
+
       break;
       }
     default:
@@ -203,6 +311,19 @@ ignition::math::Vector3d SphericalCoordinates::SphericalFromLocal(
   return result;
 }
 
+//////////////////////////////////////////////////
+void SphericalCoordinates::SphericalFromLocal(
+    const std::vector<ignition::math::Vector3d> &_xyz,
+    std::vector<ignition::math::Vector3d> &_spherical) const
+{
+  this->PositionTransform(_xyz, _spherical, LOCAL, SPHERICAL);
+  for (auto &spherical : _spherical)
+  {
+    spherical.X(IGN_RTOD(spherical.X()));
+    spherical.Y(IGN_RTOD(spherical.Y()));
+  }
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d SphericalCoordinates::LocalFromSpherical(
     const ignition::math::Vector3d &_xyz) const
@@ -279,6 +400,21 @@ void SphericalCoordinates::UpdateTransformationMatrix()
   this->dataPtr->cosHea = cos(-this->dataPtr->headingOffset.Radian());
   this->dataPtr->sinHea = sin(-this->dataPtr->headingOffset.Radian());
 
+  // Fold the heading into the rotations, so that LOCAL positions take a
+  // single matrix product. The heading applied to LOCAL inputs is the one
+  // PositionTransform has always used.
+  const double cosHea = this->dataPtr->cosHea;
+  const double sinHea = this->dataPtr->sinHea;
+  this->dataPtr->rotLocalToECEF = this->dataPtr->rotGlobalToECEF *
+    ignition::math::Matrix3d(
+        -cosHea, sinHea, 0.0,
+        -sinHea, -cosHea, 0.0,
+        0.0, 0.0, 1.0);
+  this->dataPtr->rotECEFToLocal = ignition::math::Matrix3d(
+        cosHea, -sinHea, 0.0,
+        sinHea, cosHea, 0.0,
+        0.0, 0.0, 1.0) * this->dataPtr->rotECEFToGlobal;
+
   // Cache the ECEF coordinate of the origin
   this->dataPtr->origin = ignition::math::Vector3d(
     this->dataPtr->latitudeReference.Radian(),
@@ -293,113 +429,47 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
     const ignition::math::Vector3d &_pos,
     const CoordinateType &_in, const CoordinateType &_out) const
 {
-  ignition::math::Vector3d tmp = _pos;
-
-  // Cache trig results
-  double cosLat = cos(_pos.X());
-  double sinLat = sin(_pos.X());
-  double cosLon = cos(_pos.Y());
-  double sinLon = sin(_pos.Y());
-
-  // Radius of planet curvature (meters)
-  double curvature = 1.0 -
-    this->dataPtr->ellE * this->dataPtr->ellE * sinLat * sinLat;
-  curvature = this->dataPtr->ellA / sqrt(curvature);
-
-  // Convert whatever arrives to a more flexible ECEF coordinate
-  switch (_in)
+  if (!ValidType(_in))
   {
-    // East, North, Up (ENU), note no break at end of case
-    case LOCAL:
-      {
-        tmp.X(-_pos.X() * this->dataPtr->cosHea + _pos.Y() *
-            this->dataPtr->sinHea);
-        tmp.Y(-_pos.X() * this->dataPtr->sinHea - _pos.Y() *
-            this->dataPtr->cosHea);
-      }
-      [[fallthrough]];
-
-    case GLOBAL:
-      {
-        tmp = this->dataPtr->origin + this->dataPtr->rotGlobalToECEF * tmp;
-        break;
-      }
-
-    case SPHERICAL:
-      {
-        tmp.X((_pos.Z() + curvature) * cosLat * cosLon);
-        tmp.Y((_pos.Z() + curvature) * cosLat * sinLon);
-        tmp.Z(((this->dataPtr->ellB * this->dataPtr->ellB)/
-              (this->dataPtr->ellA * this->dataPtr->ellA) *
-              curvature + _pos.Z()) * sinLat);
-        break;
-      }
-
-    // Do nothing
-    case ECEF:
-      break;
-    default:
-      gzerr << "Invalid coordinate type[" << _in << "]\n";
-      return _pos;
+    gzerr << "Invalid coordinate type[" << _in << "]\n";
+    return _pos;
   }
 
-  // Convert ECEF to the requested output coordinate system
-  switch (_out)
+  if (!ValidType(_out))
   {
-    case SPHERICAL:
-      {
-        // Convert from ECEF to SPHERICAL
-        double p = sqrt(tmp.X() * tmp.X() + tmp.Y() * tmp.Y());
-        double theta = atan((tmp.Z() * this->dataPtr->ellA) /
-            (p * this->dataPtr->ellB));
-
-        // Calculate latitude and longitude
-        double lat = atan(
-            (tmp.Z() + std::pow(this->dataPtr->ellP, 2) * this->dataPtr->ellB *
-             std::pow(sin(theta), 3)) /
-            (p - std::pow(this->dataPtr->ellE, 2) *
-             this->dataPtr->ellA * std::pow(cos(theta), 3)));
-
-        double lon = atan2(tmp.Y(), tmp.X());
-
-        // Recalculate radius of planet curvature at the current latitude.
-        double nCurvature = 1.0 - std::pow(this->dataPtr->ellE, 2) *
-          std::pow(sin(lat), 2);
-        nCurvature = this->dataPtr->ellA / sqrt(nCurvature);
-
-        tmp.X(lat);
-        tmp.Y(lon);
-
-        // Now calculate Z
-        tmp.Z(p/cos(lat) - nCurvature);
-        break;
-      }
-
-    // Convert from ECEF TO GLOBAL
-    case GLOBAL:
-      tmp = this->dataPtr->rotECEFToGlobal * (tmp - this->dataPtr->origin);
-      break;
-
-    // Convert from ECEF TO LOCAL
-    case LOCAL:
-      tmp = this->dataPtr->rotECEFToGlobal * (tmp - this->dataPtr->origin);
+    gzerr << "Unknown coordinate type[" << _out << "]\n";
+    return _pos;
+  }
 
-      tmp = ignition::math::Vector3d(
-          tmp.X() * this->dataPtr->cosHea - tmp.Y() * this->dataPtr->sinHea,
-          tmp.X() * this->dataPtr->sinHea + tmp.Y() * this->dataPtr->cosHea,
-          tmp.Z());
-      break;
+  // Convert whatever arrives to a more flexible ECEF coordinate, then to the
+  // requested output coordinate system
+  return FromECEF(*this->dataPtr, ToECEF(*this->dataPtr, _pos, _in), _out);
+}
 
-    // Return ECEF (do nothing)
-    case ECEF:
-      break;
+/////////////////////////////////////////////////
+void SphericalCoordinates::PositionTransform(
+    const std::vector<ignition::math::Vector3d> &_pos,
+    std::vector<ignition::math::Vector3d> &_result,
+    const CoordinateType &_in, const CoordinateType &_out) const
+{
+  if (!ValidType(_in))
+  {
+    gzerr << "Invalid coordinate type[" << _in << "]\n";
+    _result = _pos;
+    return;
+  }
 
-    default:
-      gzerr << "Unknown coordinate type[" << _out << "]\n";
-      return _pos;
+  if (!ValidType(_out))
+  {
+    gzerr << "Unknown coordinate type[" << _out << "]\n";
+    _result = _pos;
+    return;
   }
 
-  return tmp;
+  _result.resize(_pos.size());
+  const SphericalCoordinatesPrivate &data = *this->dataPtr;
+  for (size_t i = 0; i < _pos.size(); ++i)
+    _result[i] = FromECEF(data, ToECEF(data, _pos[i], _in), _out);
 }
 
 //////////////////////////////////////////////////
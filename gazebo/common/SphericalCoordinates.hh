@@ -18,6 +18,7 @@
 #define _GAZEBO_SPHERICALCOORDINATES_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/math/Angle.hh>
 #include <ignition/math/Vector3.hh>
@@ -93,6 +94,17 @@ namespace gazebo
       public: ignition::math::Vector3d SphericalFromLocal(
                   const ignition::math::Vector3d &_xyz) const;
 
+      /// \brief Convert Cartesian position vectors to geodetic coordinates,
+      /// see SphericalFromLocal. Cheaper than converting the positions one
+      /// by one.
+      /// \param[in] _xyz Cartesian position vectors in gazebo's world frame.
+      /// \param[out] _spherical Coordinates of each position: geodetic
+      /// latitude (deg), longitude (deg), altitude above sea level (m).
+      /// Resized to the number of positions, its storage is reused.
+      public: void SphericalFromLocal(
+                  const std::vector<ignition::math::Vector3d> &_xyz,
+                  std::vector<ignition::math::Vector3d> &_spherical) const;
+
       /// \brief Convert a Cartesian velocity vector in the local gazebo frame
       ///        to a global Cartesian frame with components East, North, Up.
       /// \param[in] _xyz Cartesian vector in gazebo's world frame.
@@ -186,6 +198,19 @@ namespace gazebo
               PositionTransform(const ignition::math::Vector3d &_pos,
                   const CoordinateType &_in, const CoordinateType &_out) const;
 
+      /// \brief Convert positions between SPHERICAL/ECEF/LOCAL/GLOBAL frames,
+      /// see PositionTransform. The coordinate types are checked once for
+      /// all the positions.
+      /// \param[in] _pos Position vectors in frame defined by parameter _in
+      /// \param[out] _result Transformed positions, resized to the number of
+      /// positions. Its storage is reused.
+      /// \param[in] _in  CoordinateType for input
+      /// \param[in] _out CoordinateType for output
+      public: void PositionTransform(
+                  const std::vector<ignition::math::Vector3d> &_pos,
+                  std::vector<ignition::math::Vector3d> &_result,
+                  const CoordinateType &_in, const CoordinateType &_out) const;
+
       /// \brief Convert between velocity in SPHERICAL/ECEF/LOCAL/GLOBAL frame
       /// \param[in] _pos Velocity vector in frame defined by parameter _in
       /// \param[in] _in  CoordinateType for input
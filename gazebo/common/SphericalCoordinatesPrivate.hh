@@ -70,12 +70,29 @@ namespace gazebo
       /// \brief Second eccentricity ellipse parameter
       public: double ellP;
 
+      /// \brief Square of the first eccentricity
+      public: double ellE2;
+
+      /// \brief Square of the second eccentricity
+      public: double ellP2;
+
+      /// \brief Square of the ratio of the semi-minor to the semi-major axis
+      public: double ellB2A2;
+
       /// \brief Rotation matrix that moves ECEF to GLOBAL
       public: ignition::math::Matrix3d rotECEFToGlobal;
 
       /// \brief Rotation matrix that moves GLOBAL to ECEF
       public: ignition::math::Matrix3d rotGlobalToECEF;
 
+      /// \brief Rotation matrix that moves LOCAL to ECEF, the heading
+      /// rotation followed by rotGlobalToECEF
+      public: ignition::math::Matrix3d rotLocalToECEF;
+
+      /// \brief Rotation matrix that moves ECEF to LOCAL, rotECEFToGlobal
+      /// followed by the heading rotation
+      public: ignition::math::Matrix3d rotECEFToLocal;
+
       /// \brief Cache the ECEF position of the the origin
       public: ignition::math::Vector3d origin;
 
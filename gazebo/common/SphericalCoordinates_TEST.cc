@@ -15,6 +15,7 @@
  *
 */
 
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "gazebo/common/Console.hh"
@@ -266,6 +267,57 @@ TEST_F(SphericalCoordinatesTest, Distance)
   EXPECT_NEAR(14002, d, 20);
 }
 
+//////////////////////////////////////////////////
+// Test that batch conversions match the conversions of single positions
+TEST_F(SphericalCoordinatesTest, BatchTransforms)
+{
+  common::SphericalCoordinates sc(common::SphericalCoordinates::EARTH_WGS84,
+      ignition::math::Angle(0.3), ignition::math::Angle(-1.2), 354.1,
+      ignition::math::Angle(0.4));
+
+  std::vector<ignition::math::Vector3d> xyz;
+  for (int i = 0; i < 20; ++i)
+    xyz.push_back(ignition::math::Vector3d(i * 37.0 - 300, 500 - i * 11.0, i));
+
+  std::vector<ignition::math::Vector3d> spherical(3);
+  sc.SphericalFromLocal(xyz, spherical);
+  ASSERT_EQ(xyz.size(), spherical.size());
+  for (size_t i = 0; i < xyz.size(); ++i)
+  {
+    const ignition::math::Vector3d expected = sc.SphericalFromLocal(xyz[i]);
+    EXPECT_NEAR(expected.X(), spherical[i].X(), 1e-9);
+    EXPECT_NEAR(expected.Y(), spherical[i].Y(), 1e-9);
+    EXPECT_NEAR(expected.Z(), spherical[i].Z(), 1e-6);
+  }
+
+  const common::SphericalCoordinates::CoordinateType types[] =
+  {
+    common::SphericalCoordinates::ECEF,
+    common::SphericalCoordinates::GLOBAL,
+    common::SphericalCoordinates::LOCAL
+  };
+
+  std::vector<ignition::math::Vector3d> result;
+  for (auto const in : types)
+  {
+    for (auto const out : types)
+    {
+      sc.PositionTransform(xyz, result, in, out);
+      ASSERT_EQ(xyz.size(), result.size());
+      for (size_t i = 0; i < xyz.size(); ++i)
+      {
+        EXPECT_NEAR(0.0, (sc.PositionTransform(xyz[i], in, out) -
+              result[i]).Length(), 1e-6);
+      }
+    }
+  }
+
+  // Empty input
+  std::vector<ignition::math::Vector3d> empty;
+  sc.SphericalFromLocal(empty, spherical);
+  EXPECT_TRUE(spherical.empty());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
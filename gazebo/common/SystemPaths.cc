@@ -15,9 +15,13 @@
  *
  */
 
+#include <ctime>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <unordered_set>
 
 #include <boost/filesystem.hpp>
 #include <ignition/common/StringUtils.hh>
@@ -25,6 +29,9 @@
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#ifdef __linux__
+  #include <sys/inotify.h>
+#endif
 
 // See below for Windows dirent include. cpplint complains about system
 // header order if "win_dirent.h" is in the wrong location.
@@ -38,6 +45,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/SystemPaths.hh"
+#include "gazebo/common/Timestamp.hh"
 
 using namespace gazebo;
 using namespace common;
@@ -56,6 +64,50 @@ char pathDelimiter()
 /// TODO(chapulina): Move to member variable when porting forward
 std::vector<std::function<std::string (const std::string &)>> g_findFileCbs;
 
+/// \brief Seconds between checks of the modification time of a search path,
+/// which catches the changes that aren't notified, e.g. on network drives.
+static const double INDEX_CHECK_PERIOD = 1.0;
+
+/// \brief Listing of a search path, to skip the lookups of files that can't
+/// be in it without touching the file system.
+class DirectoryIndex
+{
+  /// \brief True if the listing is up to date.
+  public: bool valid = false;
+
+  /// \brief True if the search path is a directory.
+  public: bool exists = false;
+
+  /// \brief True if the entries of the directory could be read.
+  public: bool listed = false;
+
+  /// \brief Modification time of the directory when it was listed.
+  public: std::time_t modified = 0;
+
+  /// \brief When the modification time was last checked.
+  public: Timestamp checked;
+
+  /// \brief Inotify watch of the directory, -1 if none.
+  public: int watch = -1;
+
+  /// \brief Names of the entries of the directory.
+  public: std::unordered_set<std::string> entries;
+};
+
+/// \brief Listings of the search paths, by path.
+/// TODO: Move to member variable when porting forward
+std::map<std::string, DirectoryIndex> g_pathIndices;
+
+/// \brief Inotify watches, by watch descriptor, to the search path.
+std::map<int, std::string> g_pathWatches;
+
+/// \brief Inotify instance that reports changes to the search paths, -1 if
+/// not available.
+int g_pathNotify = -1;
+
+/// \brief Protects the listings of the search paths.
+std::mutex g_pathIndexMutex;
+
 //////////////////////////////////////////////////
 SystemPaths::SystemPaths()
 {
@@ -315,15 +367,21 @@ std::string SystemPaths::FindFileURI(const std::string &_uri)
   // paths
   if (prefix == "model")
   {
-    boost::filesystem::path path;
-    for (std::list<std::string>::iterator iter = this->modelPaths.begin();
-         iter != this->modelPaths.end(); ++iter)
+    filename = this->FindFileInPaths(suffix, this->modelPaths);
+
+    // The listings may miss a model that was just added, so look again
+    // before downloading it
+    if (filename.empty())
     {
-      path = boost::filesystem::path(*iter) / suffix;
-      if (boost::filesystem::exists(path))
+      for (auto const &modelPath : this->modelPaths)
       {
-        filename = path.string();
-        break;
+        boost::filesystem::path path =
+          boost::filesystem::path(modelPath) / suffix;
+        if (boost::filesystem::exists(path))
+        {
+          filename = path.string();
+          break;
+        }
       }
     }
 
@@ -340,6 +398,157 @@ std::string SystemPaths::FindFileURI(const std::string &_uri)
   return filename;
 }
 
+//////////////////////////////////////////////////
+/// \brief Invalidate the listings of the search paths that changed, as
+/// reported by inotify.
+static void ReadPathChanges()
+{
+#ifdef __linux__
+  if (g_pathNotify < 0)
+    return;
+
+  alignas(struct inotify_event) char buffer[4096];
+  ssize_t len;
+  while ((len = read(g_pathNotify, buffer, sizeof(buffer))) > 0)
+  {
+    for (char *p = buffer; p < buffer + len;)
+    {
+      const struct inotify_event *event =
+        reinterpret_cast<const struct inotify_event *>(p);
+      p += sizeof(struct inotify_event) + event->len;
+
+      // Events were lost
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        for (auto &index : g_pathIndices)
+          index.second.valid = false;
+        continue;
+      }
+
+      auto iter = g_pathWatches.find(event->wd);
+      if (iter == g_pathWatches.end())
+        continue;
+
+      DirectoryIndex &index = g_pathIndices[iter->second];
+      index.valid = false;
+      if (event->mask & IN_IGNORED)
+      {
+        index.watch = -1;
+        g_pathWatches.erase(iter);
+      }
+    }
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+/// \brief Bring the listing of a search path up to date, if it changed or
+/// wasn't checked for a while.
+/// \param[in] _dir Search path.
+/// \param[in,out] _index Listing of the search path.
+static void UpdatePathIndex(const std::string &_dir, DirectoryIndex &_index)
+{
+  const Timestamp now = Timestamp::Now();
+  if (_index.valid && (now - _index.checked).Double() < INDEX_CHECK_PERIOD)
+    return;
+  _index.checked = now;
+
+  struct stat st;
+  if (stat(_dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+  {
+    _index.valid = true;
+    _index.exists = false;
+    _index.listed = false;
+    _index.entries.clear();
+    return;
+  }
+
+  if (_index.valid && _index.exists && _index.modified == st.st_mtime)
+    return;
+
+#ifdef __linux__
+  if (g_pathNotify < 0)
+    g_pathNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (g_pathNotify >= 0 && _index.watch < 0)
+  {
+    _index.watch = inotify_add_watch(g_pathNotify, _dir.c_str(),
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+        IN_DELETE_SELF | IN_MOVE_SELF);
+    if (_index.watch >= 0)
+      g_pathWatches[_index.watch] = _dir;
+  }
+#endif
+
+  _index.entries.clear();
+  DIR *dir = opendir(_dir.c_str());
+  if (dir)
+  {
+    while (struct dirent *entry = readdir(dir))
+      _index.entries.insert(entry->d_name);
+    closedir(dir);
+  }
+
+  // Modification times only have a resolution of a second, so a directory
+  // that changed in the last seconds may change again without a new time.
+  _index.exists = true;
+  _index.listed = dir != nullptr;
+  _index.modified = st.st_mtime;
+  _index.valid = std::time(nullptr) - st.st_mtime > 2;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find a file in a search path, checking the listing of the search
+/// path first.
+/// \param[in] _dir Search path.
+/// \param[in] _relative Path of the file relative to _dir.
+/// \return Full path of the file, or an empty path if it doesn't exist.
+static boost::filesystem::path FindInPath(const std::string &_dir,
+    const std::string &_relative)
+{
+  const boost::filesystem::path path = boost::filesystem::path(_dir) /
+    _relative;
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+  // The listings are case sensitive, so they are only used where file names
+  // are too.
+  const size_t start = _relative.find_first_not_of('/');
+  const size_t end = _relative.find('/', start);
+  const std::string first = start == std::string::npos ?
+    std::string() : _relative.substr(start, end - start);
+  if (!first.empty() && first != "." && first != "..")
+  {
+    std::lock_guard<std::mutex> lock(g_pathIndexMutex);
+    ReadPathChanges();
+    DirectoryIndex &index = g_pathIndices[_dir];
+    UpdatePathIndex(_dir, index);
+    if (!index.exists ||
+        (index.listed && index.entries.count(first) == 0))
+    {
+      return boost::filesystem::path();
+    }
+  }
+#endif
+
+  if (!boost::filesystem::exists(path))
+    return boost::filesystem::path();
+
+  return path;
+}
+
+//////////////////////////////////////////////////
+std::string SystemPaths::FindFileInPaths(const std::string &_filename,
+    const std::list<std::string> &_paths)
+{
+  for (auto const &dir : _paths)
+  {
+    const boost::filesystem::path path = FindInPath(dir, _filename);
+    if (!path.empty())
+      return path.string();
+  }
+  return std::string();
+}
+
+//////////////////////////////////////////////////
 static bool isAbsolute(const std::string &_filename)
 {
   boost::filesystem::path path(_filename);
@@ -372,16 +581,10 @@ std::string SystemPaths::FindFile(const std::string &_filename,
     // Gazebo log playback makes use of this feature
     if (!boost::filesystem::exists(path))
     {
-      for (std::list<std::string>::iterator iter = this->modelPaths.begin();
-           iter != this->modelPaths.end(); ++iter)
-      {
-        auto modelPath = boost::filesystem::path(*iter) / path;
-        if (boost::filesystem::exists(modelPath))
-        {
-          path = modelPath;
-          break;
-        }
-      }
+      const std::string modelPath =
+        this->FindFileInPaths(_filename, this->modelPaths);
+      if (!modelPath.empty())
+        path = modelPath;
     }
   }
   // Try appending to Gazebo paths
@@ -415,9 +618,8 @@ std::string SystemPaths::FindFile(const std::string &_filename,
       for (std::list<std::string>::const_iterator iter = paths.begin();
           iter != paths.end() && !found; ++iter)
       {
-        path = boost::filesystem::path((*iter));
-        path = boost::filesystem::operator/(path, _filename);
-        if (boost::filesystem::exists(path))
+        path = FindInPath(*iter, _filename);
+        if (!path.empty())
         {
           found = true;
           break;
@@ -427,10 +629,8 @@ std::string SystemPaths::FindFile(const std::string &_filename,
         for (suffixIter = this->suffixPaths.begin();
             suffixIter != this->suffixPaths.end(); ++suffixIter)
         {
-          path = boost::filesystem::path(*iter);
-          path = boost::filesystem::operator/(path, *suffixIter);
-          path = boost::filesystem::operator/(path, _filename);
-          if (boost::filesystem::exists(path))
+          path = FindInPath(*iter, *suffixIter + _filename);
+          if (!path.empty())
           {
             found = true;
             break;
@@ -116,6 +116,17 @@ namespace gazebo
       public: std::string FindFile(const std::string &_filename,
                                    bool _searchLocalPath = true);
 
+      /// \brief Find a file relative to one of a list of directories, such
+      /// as the paths of GetPluginPaths. Each directory is listed once and
+      /// kept up to date, so that the directories which can't contain the
+      /// file are skipped without touching the file system.
+      /// \param[in] _filename Path of the file relative to the directories.
+      /// \param[in] _paths Directories to search, in order.
+      /// \return Full path of the first match, or an empty string if the
+      /// file isn't in any of the directories.
+      public: std::string FindFileInPaths(const std::string &_filename,
+                  const std::list<std::string> &_paths);
+
       /// \brief Add a callback to use when Gazebo can't find a file.
       /// The callback should return a full local path to the requested file, or
       /// and empty string if the file was not found in the callback.
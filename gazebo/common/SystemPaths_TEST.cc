@@ -16,8 +16,11 @@
 */
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <list>
 #include <string>
 #include <vector>
+#include <boost/filesystem.hpp>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/SystemPaths.hh"
@@ -190,6 +193,51 @@ TEST_F(SystemPathsTest, SystemPaths)
   putenv(const_cast<char*>(pluginPathBackup.c_str()));
 }
 
+//////////////////////////////////////////////////
+TEST_F(SystemPathsTest, FindFileInPaths)
+{
+  auto sysPaths = common::SystemPaths::Instance();
+
+  const boost::filesystem::path dir1 = boost::filesystem::temp_directory_path()
+    / boost::filesystem::unique_path("gz_paths_%%%%");
+  const boost::filesystem::path dir2 = boost::filesystem::temp_directory_path()
+    / boost::filesystem::unique_path("gz_paths_%%%%");
+  boost::filesystem::create_directories(dir1 / "model" / "meshes");
+  boost::filesystem::create_directories(dir2 / "model");
+  std::ofstream((dir2 / "model" / "model.config").string()) << "config";
+  std::ofstream((dir1 / "model" / "meshes" / "mesh.dae").string()) << "mesh";
+
+  const std::list<std::string> paths = {"/bad/gz/path", dir1.string(),
+      dir2.string()};
+  EXPECT_EQ((dir2 / "model" / "model.config").string(),
+      sysPaths->FindFileInPaths("model/model.config", paths));
+  EXPECT_EQ((dir1 / "model" / "meshes" / "mesh.dae").string(),
+      sysPaths->FindFileInPaths("model/meshes/mesh.dae", paths));
+  EXPECT_EQ((dir1 / "model").string(),
+      sysPaths->FindFileInPaths("model", paths));
+  EXPECT_EQ("", sysPaths->FindFileInPaths("model/missing", paths));
+  EXPECT_EQ("", sysPaths->FindFileInPaths("missing/model.config", paths));
+
+#ifdef __linux__
+  // Files added after the directories were listed
+  std::ofstream((dir1 / "plugin.so").string()) << "plugin";
+  boost::filesystem::create_directories(dir2 / "other");
+  EXPECT_EQ((dir1 / "plugin.so").string(),
+      sysPaths->FindFileInPaths("plugin.so", paths));
+  EXPECT_EQ((dir2 / "other").string(),
+      sysPaths->FindFileInPaths("other", paths));
+
+  // And removed
+  boost::filesystem::remove_all(dir1 / "model");
+  EXPECT_EQ((dir2 / "model" / "model.config").string(),
+      sysPaths->FindFileInPaths("model/model.config", paths));
+  EXPECT_EQ("", sysPaths->FindFileInPaths("model/meshes/mesh.dae", paths));
+#endif
+
+  boost::filesystem::remove_all(dir1);
+  boost::filesystem::remove_all(dir2);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -49,6 +49,12 @@ using namespace common;
 Time Time::wallTime;
 std::string Time::wallTimeISO;
 
+/// \brief Last GetWallTime value of each thread.
+static thread_local Time g_wallTime;
+
+/// \brief Last GetWallTimeAsISOString value of each thread.
+static thread_local std::string g_wallTimeISO;
+
 struct timespec Time::clockResolution;
 const Time Time::Zero = common::Time(0, 0);
 const Time Time::Second = common::Time(1, 0);
@@ -221,17 +227,17 @@ const Time &Time::GetWallTime()
 #else
   clock_gettime(0, &tv);
 #endif
-  wallTime = tv;
-  return wallTime;
+  g_wallTime = tv;
+  return g_wallTime;
 }
 
 /////////////////////////////////////////////////
 const std::string &Time::GetWallTimeAsISOString()
 {
-  wallTimeISO = boost::posix_time::to_iso_extended_string(
+  g_wallTimeISO = boost::posix_time::to_iso_extended_string(
       boost::posix_time::microsec_clock::local_time());
 
-  return wallTimeISO;
+  return g_wallTimeISO;
 }
 
 /////////////////////////////////////////////////
@@ -108,11 +108,14 @@ namespace gazebo
       public: static Time Maximum();
 
       /// \brief Get the wall time
-      /// \return the current time
+      /// \return the current time. The reference is to storage of the
+      /// calling thread, valid until its next call.
+      /// \sa Timestamp::Now for a cheaper monotonic time.
       public: static const Time &GetWallTime();
 
       /// \brief Get the wall time as an ISO string: YYYY-MM-DDTHH:MM:SS
-      /// \return The current wall time as an ISO string.
+      /// \return The current wall time as an ISO string. The reference is
+      /// to storage of the calling thread, valid until its next call.
       public: static const std::string &GetWallTimeAsISOString();
 
       /// \brief Set the time to the wall time
@@ -468,10 +471,12 @@ namespace gazebo
       /// milliseconds.
       public: static const int32_t nsInMs;
 
-      /// \brief a singleton value of the last GetWallTime() value
+      /// \brief Unused, GetWallTime returns storage of the calling thread.
+      /// Kept for binary compatibility.
       private: static Time wallTime;
 
-      /// \brief Wall time as an ISO string.
+      /// \brief Unused, GetWallTimeAsISOString returns storage of the
+      /// calling thread. Kept for binary compatibility.
       private: static std::string wallTimeISO;
 
       /// \brief Correct the time so that small additions/substractions
@@ -22,6 +22,7 @@
 #endif
 
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Timestamp.hh"
 #include "test/util.hh"
 
 using namespace gazebo;
@@ -252,6 +253,43 @@ TEST_F(TimeTest, Maximum)
   EXPECT_EQ(common::Time::Maximum(), maximum);
 }
 
+/////////////////////////////////////////////////
+TEST_F(TimeTest, Timestamp)
+{
+  // Conversions
+  const common::Timestamp stamp(common::Time(3, 250000000));
+  EXPECT_EQ(3250000000, stamp.Nanoseconds());
+  EXPECT_DOUBLE_EQ(3.25, stamp.Double());
+  EXPECT_EQ(common::Time(3, 250000000), stamp.ToTime());
+  EXPECT_EQ(stamp, common::Timestamp::FromSeconds(3.25));
+  EXPECT_EQ(common::Time(-1, 500000000),
+      common::Timestamp::FromSeconds(-0.5).ToTime());
+
+  // Arithmetic
+  common::Timestamp sum = stamp + common::Timestamp(750000000);
+  EXPECT_EQ(common::Time(4, 0), sum.ToTime());
+  sum -= stamp;
+  EXPECT_EQ(750000000, sum.Nanoseconds());
+  sum += stamp;
+  EXPECT_EQ(4000000000, sum.Nanoseconds());
+  EXPECT_EQ(-3250000000, (common::Timestamp() - stamp).Nanoseconds());
+
+  // Comparisons
+  EXPECT_TRUE(stamp < sum);
+  EXPECT_TRUE(stamp <= sum);
+  EXPECT_TRUE(sum > stamp);
+  EXPECT_TRUE(sum >= stamp);
+  EXPECT_TRUE(stamp != sum);
+  EXPECT_FALSE(stamp == sum);
+
+  // The clock is monotonic
+  const common::Timestamp start = common::Timestamp::Now();
+  common::Time::MSleep(10);
+  const common::Timestamp elapsed = common::Timestamp::Now() - start;
+  EXPECT_GE(elapsed, common::Timestamp::FromSeconds(0.01));
+  EXPECT_LT(elapsed, common::Timestamp::FromSeconds(1.0));
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
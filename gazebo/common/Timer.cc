@@ -24,6 +24,15 @@
 using namespace gazebo;
 using namespace common;
 
+//////////////////////////////////////////////////
+/// \brief Read the monotonic clock. The value is kept in a Time, which
+/// holds it exactly, so that the layout of Timer doesn't change.
+/// \return Time since an unspecified point.
+static Time MonotonicNow()
+{
+  return Timestamp::Now().ToTime();
+}
+
 //////////////////////////////////////////////////
 Timer::Timer()
   : reset(true), running(false), countdown(false)
@@ -46,13 +55,13 @@ void Timer::Start()
 {
   if (this->reset)
   {
-    this->start = Time::GetWallTime();
+    this->start = MonotonicNow();
     this->reset = false;
   }
   else if (!this->running)
   {
     // Add the time that has elapsed since stopping to the start time.
-    this->start += (Time::GetWallTime() - this->stop);
+    this->start += MonotonicNow() - this->stop;
   }
 
   this->running = true;
@@ -61,7 +70,7 @@ void Timer::Start()
 //////////////////////////////////////////////////
 void Timer::Stop()
 {
-  this->stop = Time::GetWallTime();
+  this->stop = MonotonicNow();
   this->running = false;
 }
 
@@ -70,7 +79,7 @@ void Timer::Reset()
 {
   this->running = false;
   this->reset = true;
-  this->start = this->stop = Time::GetWallTime();
+  this->start = this->stop = MonotonicNow();
 }
 
 //////////////////////////////////////////////////
@@ -82,15 +91,8 @@ bool Timer::GetRunning() const
 //////////////////////////////////////////////////
 Time Timer::GetElapsed() const
 {
-  Time elapsedTime;
-  if (this->running)
-  {
-    elapsedTime = Time::GetWallTime() - this->start;
-  }
-  else
-  {
-    elapsedTime = this->stop - this->start;
-  }
+  const Time elapsedTime =
+    (this->running ? MonotonicNow() : this->stop) - this->start;
 
   // If we're counting down, return the countdown time minus the total
   // elapsed time.
@@ -24,6 +24,7 @@
 
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Timestamp.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -34,7 +35,9 @@ namespace gazebo
     /// \{
 
     /// \class Timer Timer.hh common/common.hh
-    /// \brief A timer class, used to time things in real world walltime
+    /// \brief A timer class, used to time things in real world walltime.
+    /// It reads the monotonic clock of Timestamp::Now, so setting the system
+    /// time doesn't affect it.
     class GZ_COMMON_VISIBLE Timer
     {
       /// \brief Default constructor
@@ -84,10 +87,12 @@ namespace gazebo
       /// False by default.
       private: bool countdown;
 
-      /// \brief The time of the last call to Start
+      /// \brief The time of the last call to Start, read from the
+      /// monotonic clock.
       private: Time start;
 
-      /// \brief The time when Stop was called.
+      /// \brief The time when Stop was called, read from the monotonic
+      /// clock.
       private: Time stop;
 
       /// \brief Maximum time, only used in countdown.
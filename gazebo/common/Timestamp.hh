@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_TIMESTAMP_HH_
+#define GAZEBO_COMMON_TIMESTAMP_HH_
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include "gazebo/common/Time.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class Timestamp Timestamp.hh common/common.hh
+    /// \brief A time stored as a single count of nanoseconds, for hot paths
+    /// that read the clock or do arithmetic on times often.
+    ///
+    /// Unlike Time, no normalization of seconds and nanoseconds is needed, so
+    /// arithmetic and comparisons are single integer operations. Now() reads
+    /// a monotonic clock, which doesn't jump when the system time is set.
+    class Timestamp
+    {
+      /// \brief Constructor, zero time.
+      public: Timestamp() = default;
+
+      /// \brief Constructor.
+      /// \param[in] _nsec Nanoseconds.
+      public: explicit Timestamp(const int64_t _nsec)
+              : nsec(_nsec)
+              {
+              }
+
+      /// \brief Constructor.
+      /// \param[in] _time Time to convert.
+      public: explicit Timestamp(const Time &_time)
+              : nsec(static_cast<int64_t>(_time.sec) * NS_IN_SEC + _time.nsec)
+              {
+              }
+
+      /// \brief Get the current time of a monotonic clock. The origin of
+      /// the clock is unspecified, so only differences between the
+      /// returned times are meaningful.
+      /// \return Current time.
+      public: static Timestamp Now()
+              {
+                return Timestamp(static_cast<int64_t>(
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                      .count()));
+              }
+
+      /// \brief Get a timestamp from seconds.
+      /// \param[in] _sec Seconds.
+      /// \return Timestamp, rounded to the nearest nanosecond.
+      public: static Timestamp FromSeconds(const double _sec)
+              {
+                return Timestamp(
+                    static_cast<int64_t>(std::llround(_sec * 1e9)));
+              }
+
+      /// \brief Get the time in nanoseconds.
+      /// \return Nanoseconds.
+      public: int64_t Nanoseconds() const
+              {
+                return this->nsec;
+              }
+
+      /// \brief Get the time in seconds.
+      /// \return Seconds.
+      public: double Double() const
+              {
+                return this->nsec * 1e-9;
+              }
+
+      /// \brief Convert to a Time.
+      /// \return Time with normalized seconds and nanoseconds.
+      public: Time ToTime() const
+              {
+                int64_t sec = this->nsec / NS_IN_SEC;
+                int64_t ns = this->nsec % NS_IN_SEC;
+                if (ns < 0)
+                {
+                  --sec;
+                  ns += NS_IN_SEC;
+                }
+                return Time(static_cast<int32_t>(sec),
+                            static_cast<int32_t>(ns));
+              }
+
+      /// \brief Addition operator.
+      /// \param[in] _other Timestamp to add.
+      /// \return Sum of the timestamps.
+      public: Timestamp operator+(const Timestamp &_other) const
+              {
+                return Timestamp(this->nsec + _other.nsec);
+              }
+
+      /// \brief Subtraction operator.
+      /// \param[in] _other Timestamp to subtract.
+      /// \return Difference of the timestamps.
+      public: Timestamp operator-(const Timestamp &_other) const
+              {
+                return Timestamp(this->nsec - _other.nsec);
+              }
+
+      /// \brief Addition assignment operator.
+      /// \param[in] _other Timestamp to add.
+      /// \return Reference to this timestamp.
+      public: Timestamp &operator+=(const Timestamp &_other)
+              {
+                this->nsec += _other.nsec;
+                return *this;
+              }
+
+      /// \brief Subtraction assignment operator.
+      /// \param[in] _other Timestamp to subtract.
+      /// \return Reference to this timestamp.
+      public: Timestamp &operator-=(const Timestamp &_other)
+              {
+                this->nsec -= _other.nsec;
+                return *this;
+              }
+
+      /// \brief Equality operator.
+      /// \param[in] _other Timestamp to compare to.
+      /// \return True if the timestamps are equal.
+      public: bool operator==(const Timestamp &_other) const
+              {
+                return this->nsec == _other.nsec;
+              }
+
+      /// \brief Inequality operator.
+      /// \param[in] _other Timestamp to compare to.
+      /// \return True if the timestamps differ.
+      public: bool operator!=(const Timestamp &_other) const
+              {
+                return this->nsec != _other.nsec;
+              }
+
+      /// \brief Less than operator.
+      /// \param[in] _other Timestamp to compare to.
+      /// \return True if this timestamp is earlier.
+      public: bool operator<(const Timestamp &_other) const
+              {
+                return this->nsec < _other.nsec;
+              }
+
+      /// \brief Less than or equal operator.
+      /// \param[in] _other Timestamp to compare to.
+      /// \return True if this timestamp is not later.
+      public: bool operator<=(const Timestamp &_other) const
+              {
+                return this->nsec <= _other.nsec;
+              }
+
+      /// \brief Greater than operator.
+      /// \param[in] _other Timestamp to compare to.
+      /// \return True if this timestamp is later.
+      public: bool operator>(const Timestamp &_other) const
+              {
+                return this->nsec > _other.nsec;
+              }
+
+      /// \brief Greater than or equal operator.
+      /// \param[in] _other Timestamp to compare to.
+      /// \return True if this timestamp is not earlier.
+      public: bool operator>=(const Timestamp &_other) const
+              {
+                return this->nsec >= _other.nsec;
+              }
+
+      /// \brief Nanoseconds in a second.
+      private: static constexpr int64_t NS_IN_SEC = 1000000000;
+
+      /// \brief Nanoseconds.
+      private: int64_t nsec = 0;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Timestamp.hh"
+#include "gazebo/common/TraceRecorder.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Maximum number of scopes recorded per thread, so that a long
+/// recording doesn't exhaust the memory.
+static const size_t TRACE_MAX_EVENTS = 1000000;
+
+/// \brief Depth of the BeginScope scopes whose begin is remembered.
+static const unsigned int TRACE_SCOPE_BITS = 64;
+
+/// \brief Whether each open BeginScope scope of the thread was begun, one
+/// bit per depth.
+static thread_local uint64_t scopesBegun = 0;
+
+/// \brief Number of open BeginScope scopes of the thread.
+static thread_local unsigned int scopeDepth = 0;
+
+/// \brief A scope that ended.
+class TraceEvent
+{
+  /// \brief Name of the scope.
+  public: std::string name;
+
+  /// \brief Start time in nanoseconds since the recording started.
+  public: int64_t start;
+
+  /// \brief Duration in nanoseconds.
+  public: int64_t duration;
+};
+
+/// \brief A scope that didn't end yet.
+class TraceOpenScope
+{
+  /// \brief Name of the scope.
+  public: const char *name;
+
+  /// \brief Start time.
+  public: Timestamp start;
+};
+
+/// \brief Scopes of a thread. The mutex is only contended while the
+/// trace is written.
+class TraceThread
+{
+  /// \brief Identifier of the thread in the trace.
+  public: unsigned int tid = 0;
+
+  /// \brief Name of the thread, empty if not set.
+  public: std::string name;
+
+  /// \brief Recording the open scopes belong to.
+  public: uint64_t session = 0;
+
+  /// \brief Scopes begun and not ended yet.
+  public: std::vector<TraceOpenScope> open;
+
+  /// \brief Scopes ended during the recording.
+  public: std::vector<TraceEvent> events;
+
+  /// \brief Scopes not recorded because events was full.
+  public: uint64_t dropped = 0;
+
+  /// \brief Protects the members.
+  public: std::mutex mutex;
+};
+
+/// \brief State of the recording.
+class TraceRecording
+{
+  /// \brief Threads that recorded a scope or set their name. They are
+  /// kept after the threads exit, to write their scopes.
+  public: std::vector<std::shared_ptr<TraceThread>> threads;
+
+  /// \brief Incremented when a recording starts.
+  public: std::atomic<uint64_t> session{0};
+
+  /// \brief Path of the trace file.
+  public: std::string filename;
+
+  /// \brief Time the recording started, in nanoseconds. Atomic since
+  /// threads may end a scope while a new recording starts.
+  public: std::atomic<int64_t> start{0};
+
+  /// \brief Time the recording stops at, zero if unbounded.
+  public: Timestamp end;
+
+  /// \brief Protects the members but session.
+  public: std::mutex mutex;
+};
+
+std::atomic<bool> TraceRecorder::active(false);
+
+//////////////////////////////////////////////////
+/// \brief Get the state of the recording. It is never destroyed, since
+/// threads may end scopes while the process exits.
+/// \return The recording.
+static TraceRecording &State()
+{
+  static TraceRecording *recording = new TraceRecording;
+  return *recording;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the scopes of the calling thread, registering it on first
+/// use.
+/// \return Scopes of the thread.
+static TraceThread &CurrentThread()
+{
+  static thread_local std::shared_ptr<TraceThread> thread;
+  if (!thread)
+  {
+    thread = std::make_shared<TraceThread>();
+    TraceRecording &recording = State();
+    std::lock_guard<std::mutex> lock(recording.mutex);
+    thread->tid = static_cast<unsigned int>(recording.threads.size() + 1);
+    recording.threads.push_back(thread);
+  }
+  return *thread;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a string as a JSON string literal.
+/// \param[in] _out Stream to write to.
+/// \param[in] _str String to write.
+static void WriteJsonString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (const char c : _str)
+  {
+    if (c == '"' || c == '\\')
+      _out << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      _out << escaped;
+    }
+    else
+      _out << c;
+  }
+  _out << '"';
+}
+
+//////////////////////////////////////////////////
+bool TraceRecorder::Start(const std::string &_filename,
+    const double _duration)
+{
+  TraceRecording &recording = State();
+  std::lock_guard<std::mutex> lock(recording.mutex);
+  if (active)
+  {
+    gzerr << "Already recording a trace to [" << recording.filename << "]\n";
+    return false;
+  }
+
+  for (auto &thread : recording.threads)
+  {
+    std::lock_guard<std::mutex> threadLock(thread->mutex);
+    thread->events.clear();
+    thread->dropped = 0;
+  }
+
+  recording.filename = _filename;
+  const Timestamp now = Timestamp::Now();
+  recording.start = now.Nanoseconds();
+  recording.end = _duration > 0 ?
+    now + Timestamp::FromSeconds(_duration) : Timestamp();
+  ++recording.session;
+  active = true;
+
+  gzmsg << "Recording a trace to [" << _filename << "]\n";
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool TraceRecorder::Stop()
+{
+  TraceRecording &recording = State();
+  std::lock_guard<std::mutex> lock(recording.mutex);
+  if (!active)
+    return false;
+  active = false;
+
+  std::ofstream out(recording.filename);
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool first = true;
+  uint64_t dropped = 0;
+  for (auto &thread : recording.threads)
+  {
+    std::lock_guard<std::mutex> threadLock(thread->mutex);
+    if (!thread->name.empty())
+    {
+      out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+        << "\"pid\":1,\"tid\":" << thread->tid << ",\"args\":{\"name\":";
+      WriteJsonString(out, thread->name);
+      out << "}}";
+      first = false;
+    }
+
+    // Chrome traces are in microseconds
+    for (auto const &event : thread->events)
+    {
+      out << (first ? "" : ",") << "\n{\"name\":";
+      WriteJsonString(out, event.name);
+      out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->tid
+        << ",\"ts\":" << event.start * 1e-3
+        << ",\"dur\":" << event.duration * 1e-3 << "}";
+      first = false;
+    }
+    dropped += thread->dropped;
+
+    thread->events.clear();
+    thread->events.shrink_to_fit();
+  }
+  out << "\n]}\n";
+  out.close();
+
+  if (dropped > 0)
+  {
+    gzwarn << "The trace is missing [" << dropped << "] scopes of threads "
+      << "that recorded more than " << TRACE_MAX_EVENTS << "\n";
+  }
+
+  if (!out)
+  {
+    gzerr << "Unable to write trace [" << recording.filename << "]\n";
+    return false;
+  }
+
+  gzmsg << "Wrote trace [" << recording.filename << "]\n";
+  return true;
+}
+
+//////////////////////////////////////////////////
+void TraceRecorder::Update()
+{
+  if (!active)
+    return;
+
+  bool expired;
+  {
+    TraceRecording &recording = State();
+    std::lock_guard<std::mutex> lock(recording.mutex);
+    expired = recording.end != Timestamp() &&
+      Timestamp::Now() >= recording.end;
+  }
+
+  if (expired)
+    Stop();
+}
+
+//////////////////////////////////////////////////
+void TraceRecorder::Begin(const char *_name)
+{
+  TraceThread &thread = CurrentThread();
+  const uint64_t session = State().session;
+
+  std::lock_guard<std::mutex> lock(thread.mutex);
+
+  // Scopes still open from a previous recording are dropped
+  if (thread.session != session)
+  {
+    thread.open.clear();
+    thread.session = session;
+  }
+  thread.open.push_back({_name, Timestamp::Now()});
+}
+
+//////////////////////////////////////////////////
+void TraceRecorder::End()
+{
+  const Timestamp now = Timestamp::Now();
+  TraceThread &thread = CurrentThread();
+  TraceRecording &recording = State();
+
+  std::lock_guard<std::mutex> lock(thread.mutex);
+
+  // Ignore the end of a scope begun before the recording started
+  if (thread.session != recording.session || thread.open.empty())
+    return;
+
+  const TraceOpenScope scope = thread.open.back();
+  thread.open.pop_back();
+
+  if (thread.events.size() >= TRACE_MAX_EVENTS)
+  {
+    ++thread.dropped;
+    return;
+  }
+
+  thread.events.push_back({scope.name,
+      scope.start.Nanoseconds() - recording.start,
+      (now - scope.start).Nanoseconds()});
+}
+
+//////////////////////////////////////////////////
+void TraceRecorder::BeginScope(const char *_name)
+{
+  const unsigned int depth = scopeDepth++;
+  if (depth >= TRACE_SCOPE_BITS)
+    return;
+
+  const uint64_t bit = uint64_t(1) << depth;
+  if (Recording())
+  {
+    scopesBegun |= bit;
+    Begin(_name);
+  }
+  else
+    scopesBegun &= ~bit;
+}
+
+//////////////////////////////////////////////////
+void TraceRecorder::EndScope()
+{
+  if (scopeDepth == 0)
+    return;
+
+  const unsigned int depth = --scopeDepth;
+  if (depth < TRACE_SCOPE_BITS && (scopesBegun >> depth) & 1)
+    End();
+}
+
+//////////////////////////////////////////////////
+void TraceRecorder::SetThreadName(const char *_name)
+{
+  TraceThread &thread = CurrentThread();
+  std::lock_guard<std::mutex> lock(thread.mutex);
+  thread.name = _name;
+}
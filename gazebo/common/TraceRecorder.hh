@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_TRACERECORDER_HH_
+#define GAZEBO_COMMON_TRACERECORDER_HH_
+
+#include <atomic>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class TraceRecorder TraceRecorder.hh common/common.hh
+    /// \brief Records the profiler scopes of all threads to a file in the
+    /// Chrome trace event format, which chrome://tracing and Perfetto open.
+    ///
+    /// Unless gazebo is built with ENABLE_PROFILER, the IGN_PROFILE macros
+    /// included through gazebo/common/Profiler.hh record to this class.
+    /// While not recording, IGN_PROFILE only reads an atomic flag, and
+    /// IGN_PROFILE_BEGIN and IGN_PROFILE_END also keep track of the depth
+    /// of the scopes of the thread.
+    class GZ_COMMON_VISIBLE TraceRecorder
+    {
+      /// \brief Records a scope for as long as it is alive.
+      public: class GZ_COMMON_VISIBLE Scope
+      {
+        /// \brief Constructor.
+        /// \param[in] _name Name of the scope.
+        public: explicit Scope(const char *_name)
+                : active(TraceRecorder::Recording())
+                {
+                  if (this->active)
+                    TraceRecorder::Begin(_name);
+                }
+
+        /// \brief Destructor, ends the scope.
+        public: ~Scope()
+                {
+                  if (this->active)
+                    TraceRecorder::End();
+                }
+
+        /// \brief True if the scope was started while recording.
+        private: const bool active;
+      };
+
+      /// \brief Start recording. Scopes that started before are not
+      /// recorded.
+      /// \param[in] _filename Path of the trace file, written when the
+      /// recording stops.
+      /// \param[in] _duration Wall time in seconds after which Update stops
+      /// the recording, zero to record until Stop is called.
+      /// \return False if already recording.
+      public: static bool Start(const std::string &_filename,
+                  const double _duration = 0);
+
+      /// \brief Stop recording, and write the trace file.
+      /// \return False if not recording or the file can't be written.
+      public: static bool Stop();
+
+      /// \brief Stop recording if its duration elapsed. Called periodically
+      /// by the server.
+      public: static void Update();
+
+      /// \brief Get whether scopes are being recorded.
+      /// \return True while recording.
+      public: static bool Recording()
+              {
+                return active.load(std::memory_order_relaxed);
+              }
+
+      /// \brief Begin a scope on this thread. Scopes must be nested.
+      /// \param[in] _name Name of the scope.
+      public: static void Begin(const char *_name);
+
+      /// \brief End the last scope begun on this thread.
+      public: static void End();
+
+      /// \brief Begin a scope on this thread if recording, and remember
+      /// whether it was begun for the matching EndScope. Scopes nested
+      /// deeper than 64 are not recorded.
+      /// \param[in] _name Name of the scope.
+      public: static void BeginScope(const char *_name);
+
+      /// \brief End the last scope of BeginScope on this thread, if it was
+      /// begun. Whether it is recorded does not depend on the recording
+      /// still being active.
+      public: static void EndScope();
+
+      /// \brief Set the name of this thread in the trace.
+      /// \param[in] _name Name of the thread.
+      public: static void SetThreadName(const char *_name);
+
+      /// \brief True while recording.
+      private: static std::atomic<bool> active;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/common/TraceRecorder.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TraceRecorder : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Read a whole file.
+/// \param[in] _filename Path of the file.
+/// \return Content of the file.
+std::string readFile(const std::string &_filename)
+{
+  std::ifstream in(_filename);
+  std::stringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Count the occurrences of a string.
+/// \param[in] _str String to search.
+/// \param[in] _pattern String to count.
+/// \return Number of occurrences.
+size_t count(const std::string &_str, const std::string &_pattern)
+{
+  size_t n = 0;
+  for (size_t pos = _str.find(_pattern); pos != std::string::npos;
+       pos = _str.find(_pattern, pos + 1))
+  {
+    ++n;
+  }
+  return n;
+}
+
+// The macros only record to the trace without the Ignition profiler
+#if !IGN_PROFILER_ENABLE
+/////////////////////////////////////////////////
+/// \brief Record a few scopes with the profiler macros.
+void recordScopes()
+{
+  IGN_PROFILE("outer");
+  IGN_PROFILE_BEGIN("inner");
+  IGN_PROFILE_END();
+}
+
+/////////////////////////////////////////////////
+TEST_F(TraceRecorder, Record)
+{
+  const std::string filename = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("trace-%%%%%%.json")).string();
+
+  // Nothing is recorded before starting
+  EXPECT_FALSE(common::TraceRecorder::Recording());
+  EXPECT_FALSE(common::TraceRecorder::Stop());
+  recordScopes();
+
+  // A scope begun before the recording is not recorded
+  IGN_PROFILE_BEGIN("before");
+
+  EXPECT_TRUE(common::TraceRecorder::Start(filename));
+  EXPECT_TRUE(common::TraceRecorder::Recording());
+  EXPECT_FALSE(common::TraceRecorder::Start(filename));
+
+  // Its end is not recorded either, and doesn't end another scope
+  IGN_PROFILE_BEGIN("during");
+  IGN_PROFILE_END();
+  IGN_PROFILE_END();
+  recordScopes();
+  std::thread thread([]()
+      {
+        IGN_PROFILE_THREAD_NAME("worker \"1\"");
+        recordScopes();
+      });
+  thread.join();
+
+  EXPECT_TRUE(common::TraceRecorder::Stop());
+  EXPECT_FALSE(common::TraceRecorder::Recording());
+
+  // Nothing is recorded after stopping
+  recordScopes();
+
+  const std::string trace = readFile(filename);
+  EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_EQ(2u, count(trace, "{\"name\":\"outer\",\"ph\":\"X\""));
+  EXPECT_EQ(2u, count(trace, "{\"name\":\"inner\",\"ph\":\"X\""));
+  EXPECT_EQ(0u, count(trace, "before"));
+  EXPECT_EQ(1u, count(trace, "{\"name\":\"during\",\"ph\":\"X\""));
+  EXPECT_EQ(1u, count(trace, "\"args\":{\"name\":\"worker \\\"1\\\"\"}"));
+
+  boost::filesystem::remove(filename);
+}
+#endif
+
+/////////////////////////////////////////////////
+TEST_F(TraceRecorder, Duration)
+{
+  const std::string filename = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("trace-%%%%%%.json")).string();
+
+  EXPECT_TRUE(common::TraceRecorder::Start(filename, 0.05));
+  common::TraceRecorder::Update();
+  EXPECT_TRUE(common::TraceRecorder::Recording());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  common::TraceRecorder::Update();
+  EXPECT_FALSE(common::TraceRecorder::Recording());
+  EXPECT_TRUE(boost::filesystem::exists(filename));
+
+  boost::filesystem::remove(filename);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
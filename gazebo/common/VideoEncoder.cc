@@ -14,7 +14,14 @@
  * limitations under the License.
  *
 */
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <stdio.h>
 #include <gazebo/gazebo_config.h>
 
@@ -44,6 +51,11 @@ extern "C"
 #if defined(__linux__) && defined(HAVE_AVDEVICE)
 #include <libavdevice/avdevice.h>
 #endif
+
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 0, 0)
+#include <libavutil/hwcontext.h>
+#define GAZEBO_HW_VIDEO_ENCODING
+#endif
 }
 #endif
 
@@ -58,9 +70,48 @@ using namespace common;
 #define AV_ERROR_MAX_STRING_SIZE 64
 #endif
 
+/// \brief A frame waiting in the encoding queue.
+struct QueuedFrame
+{
+  /// \brief RGB pixel data.
+  std::vector<unsigned char> data;
+
+  /// \brief Frame width.
+  unsigned int width;
+
+  /// \brief Frame height.
+  unsigned int height;
+};
+
 // Private data class
 class gazebo::common::VideoEncoderPrivate
 {
+  /// \brief Convert and encode a frame, and write the encoded packets to
+  /// the video file.
+  /// \param[in] _frame RGB image buffer.
+  /// \param[in] _width Frame width.
+  /// \param[in] _height Frame height.
+  /// \return True on success.
+  public: bool Encode(const unsigned char *_frame,
+                      const unsigned int _width,
+                      const unsigned int _height);
+
+  /// \brief Copy a frame into the encoding queue.
+  /// \param[in] _frame RGB image buffer.
+  /// \param[in] _width Frame width.
+  /// \param[in] _height Frame height.
+  /// \return False if the queue is full and the frame was dropped.
+  public: bool Enqueue(const unsigned char *_frame,
+                       const unsigned int _width,
+                       const unsigned int _height);
+
+  /// \brief Encode queued frames until the encode thread is stopped and
+  /// the queue is empty.
+  public: void RunEncodeThread();
+
+  /// \brief Stop the encode thread once it has encoded the queued frames.
+  public: void StopEncodeThread();
+
   /// \brief Name of the file which stores the video while it is being
   ///        recorded.
   public: std::string filename;
@@ -87,8 +138,50 @@ class gazebo::common::VideoEncoderPrivate
 
   /// \brief Software scaling context
   public: SwsContext *swsCtx = nullptr;
+
+  /// \brief Pixel format of the frames produced by the scaling context.
+  public: AVPixelFormat outPixFmt = AV_PIX_FMT_YUV420P;
+
+#ifdef GAZEBO_HW_VIDEO_ENCODING
+  /// \brief Hardware device context when encoding through VAAPI.
+  public: AVBufferRef *hwDeviceCtx = nullptr;
+
+  /// \brief Pool of hardware frames when encoding through VAAPI.
+  public: AVBufferRef *hwFramesCtx = nullptr;
+
+  /// \brief Hardware frame the output frame is uploaded to.
+  public: AVFrame *hwFrame = nullptr;
+#endif
 #endif
 
+  /// \brief Requested hardware encoder, empty for the default.
+  public: std::string hwEncoder;
+
+  /// \brief Maximum number of queued frames, zero to encode frames in
+  /// the thread adding them.
+  public: unsigned int queueSize = 0;
+
+  /// \brief Frames waiting to be encoded.
+  public: std::deque<QueuedFrame> queue;
+
+  /// \brief Buffers of encoded frames, reused by later frames.
+  public: std::vector<std::vector<unsigned char>> spareBuffers;
+
+  /// \brief Number of frames dropped because the queue was full.
+  public: std::atomic<uint64_t> droppedFrames{0};
+
+  /// \brief Thread encoding the queued frames.
+  public: std::thread encodeThread;
+
+  /// \brief True to stop the encode thread once the queue is empty.
+  public: bool stopEncodeThread = false;
+
+  /// \brief Protects the queue.
+  public: std::mutex queueMutex;
+
+  /// \brief Signals the encode thread of a new frame or of a stop.
+  public: std::condition_variable queueCondition;
+
   /// \brief True if the encoder is running
   public: bool encoding = false;
 
@@ -143,6 +236,36 @@ unsigned int VideoEncoder::BitRate() const
   return this->dataPtr->bitRate;
 }
 
+/////////////////////////////////////////////////
+void VideoEncoder::SetQueueSize(const unsigned int _size)
+{
+  this->dataPtr->queueSize = _size;
+}
+
+/////////////////////////////////////////////////
+unsigned int VideoEncoder::QueueSize() const
+{
+  return this->dataPtr->queueSize;
+}
+
+/////////////////////////////////////////////////
+uint64_t VideoEncoder::DroppedFrames() const
+{
+  return this->dataPtr->droppedFrames;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoder::SetHardwareEncoder(const std::string &_encoder)
+{
+  this->dataPtr->hwEncoder = _encoder;
+}
+
+/////////////////////////////////////////////////
+std::string VideoEncoder::HardwareEncoder() const
+{
+  return this->dataPtr->hwEncoder;
+}
+
 /////////////////////////////////////////////////
 #ifdef HAVE_FFMPEG
 bool VideoEncoder::Start(const std::string &_format,
@@ -203,6 +326,7 @@ bool VideoEncoder::Start(const std::string &_format,
   this->dataPtr->format = _format.compare("v4l") == 0 ? "v4l2" : _format;
   this->dataPtr->fps = _fps;
   this->dataPtr->frameCount = 0;
+  this->dataPtr->droppedFrames = 0;
   this->dataPtr->filename = _filename;
 
   // Create a default filenamae if the provided filename is empty.
@@ -309,6 +433,49 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
+  std::string hwEncoder = this->dataPtr->hwEncoder;
+  const char *hwEncoderEnv = std::getenv("GAZEBO_VIDEO_HW_ENCODER");
+  if (hwEncoder.empty() && hwEncoderEnv)
+    hwEncoder = hwEncoderEnv;
+
+  if (!hwEncoder.empty())
+  {
+    AVCodec *hwCodec = nullptr;
+#ifdef GAZEBO_HW_VIDEO_ENCODING
+    // Hardware encoders produce H.264, which not every container can hold
+    if (avformat_query_codec(this->dataPtr->formatCtx->oformat,
+          AV_CODEC_ID_H264, FF_COMPLIANCE_NORMAL) == 1)
+    {
+      if (hwEncoder == "nvenc")
+      {
+        hwCodec = avcodec_find_encoder_by_name("h264_nvenc");
+      }
+      else if (hwEncoder == "vaapi")
+      {
+        hwCodec = avcodec_find_encoder_by_name("h264_vaapi");
+        if (hwCodec && av_hwdevice_ctx_create(&this->dataPtr->hwDeviceCtx,
+              AV_HWDEVICE_TYPE_VAAPI, nullptr, nullptr, 0) < 0)
+        {
+          hwCodec = nullptr;
+        }
+      }
+      else
+      {
+        gzwarn << "Unknown hardware encoder[" << hwEncoder << "]\n";
+      }
+    }
+#endif
+
+    if (hwCodec)
+      encoder = hwCodec;
+    else
+    {
+      gzwarn << "Hardware encoder[" << hwEncoder << "] is not available for "
+             << "format[" << this->dataPtr->format << "]. "
+             << "Using software encoding.\n";
+    }
+  }
+
   // Create a new video stream
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
   this->dataPtr->videoStream = avformat_new_stream(this->dataPtr->formatCtx,
@@ -371,10 +538,48 @@ bool VideoEncoder::Start(const std::string &_format,
   this->dataPtr->codecCtx->max_b_frames = 1;
   this->dataPtr->codecCtx->pix_fmt = AV_PIX_FMT_YUV420P;
   this->dataPtr->codecCtx->thread_count = 5;
+  this->dataPtr->outPixFmt = AV_PIX_FMT_YUV420P;
+
+#ifdef GAZEBO_HW_VIDEO_ENCODING
+  // VAAPI encodes frames that have been uploaded to the device
+  if (this->dataPtr->hwDeviceCtx)
+  {
+    this->dataPtr->hwFramesCtx =
+      av_hwframe_ctx_alloc(this->dataPtr->hwDeviceCtx);
+    if (!this->dataPtr->hwFramesCtx)
+    {
+      gzerr << "Could not allocate hardware frames. "
+            << "Video encoding is not started\n";
+      this->Reset();
+      return false;
+    }
+
+    AVHWFramesContext *framesCtx = reinterpret_cast<AVHWFramesContext *>(
+        this->dataPtr->hwFramesCtx->data);
+    framesCtx->format = AV_PIX_FMT_VAAPI;
+    framesCtx->sw_format = AV_PIX_FMT_NV12;
+    framesCtx->width = this->dataPtr->codecCtx->width;
+    framesCtx->height = this->dataPtr->codecCtx->height;
+    framesCtx->initial_pool_size = 20;
+
+    if (av_hwframe_ctx_init(this->dataPtr->hwFramesCtx) < 0)
+    {
+      gzerr << "Could not initialize hardware frames. "
+            << "Video encoding is not started\n";
+      this->Reset();
+      return false;
+    }
+
+    this->dataPtr->codecCtx->hw_frames_ctx =
+      av_buffer_ref(this->dataPtr->hwFramesCtx);
+    this->dataPtr->codecCtx->pix_fmt = AV_PIX_FMT_VAAPI;
+    this->dataPtr->outPixFmt = AV_PIX_FMT_NV12;
+    this->dataPtr->hwFrame = av_frame_alloc();
+  }
+#endif
 
   // Set the codec id
-  this->dataPtr->codecCtx->codec_id =
-    this->dataPtr->formatCtx->oformat->video_codec;
+  this->dataPtr->codecCtx->codec_id = encoder->id;
 
   if (this->dataPtr->codecCtx->codec_id == AV_CODEC_ID_MPEG1VIDEO)
   {
@@ -422,7 +627,7 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
-  this->dataPtr->avOutFrame->format = this->dataPtr->codecCtx->pix_fmt;
+  this->dataPtr->avOutFrame->format = this->dataPtr->outPixFmt;
   this->dataPtr->avOutFrame->width = this->dataPtr->codecCtx->width;
   this->dataPtr->avOutFrame->height = this->dataPtr->codecCtx->height;
 
@@ -432,7 +637,7 @@ bool VideoEncoder::Start(const std::string &_format,
                      this->dataPtr->avOutFrame->linesize,
                      this->dataPtr->codecCtx->width,
                      this->dataPtr->codecCtx->height,
-                     this->dataPtr->codecCtx->pix_fmt, 32) < 0)
+                     this->dataPtr->outPixFmt, 32) < 0)
   {
     gzerr << "Could not allocate raw picture buffer."
           << "Video encoding is not started\n";
@@ -496,6 +701,13 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
+  if (this->dataPtr->queueSize > 0)
+  {
+    this->dataPtr->stopEncodeThread = false;
+    this->dataPtr->encodeThread = std::thread(
+        &VideoEncoderPrivate::RunEncodeThread, this->dataPtr.get());
+  }
+
   this->dataPtr->encoding = true;
   return true;
 }
@@ -554,54 +766,64 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
 
   this->dataPtr->timePrev = _timestamp;
 
+  if (this->dataPtr->encodeThread.joinable())
+    return this->dataPtr->Enqueue(_frame, _width, _height);
+
+  return this->dataPtr->Encode(_frame, _width, _height);
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::Encode(const unsigned char *_frame,
+    const unsigned int _width, const unsigned int _height)
+{
   // Cause the sws to be recreated on image resize
-  if (this->dataPtr->swsCtx &&
-      (this->dataPtr->inWidth != _width || this->dataPtr->inHeight != _height))
+  if (this->swsCtx &&
+      (this->inWidth != _width || this->inHeight != _height))
   {
-    sws_freeContext(this->dataPtr->swsCtx);
-    this->dataPtr->swsCtx = nullptr;
+    sws_freeContext(this->swsCtx);
+    this->swsCtx = nullptr;
 
-    if (this->dataPtr->avInFrame)
+    if (this->avInFrame)
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
-      av_free(this->dataPtr->avInFrame);
+      av_free(this->avInFrame);
 #else
-      av_frame_free(&this->dataPtr->avInFrame);
+      av_frame_free(&this->avInFrame);
 #endif
-    this->dataPtr->avInFrame = nullptr;
+    this->avInFrame = nullptr;
   }
 
-  if (!this->dataPtr->swsCtx)
+  if (!this->swsCtx)
   {
-    this->dataPtr->inWidth = _width;
-    this->dataPtr->inHeight = _height;
+    this->inWidth = _width;
+    this->inHeight = _height;
 
-    if (!this->dataPtr->avInFrame)
+    if (!this->avInFrame)
     {
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
-      this->dataPtr->avInFrame = new AVPicture;
-      avpicture_alloc(this->dataPtr->avInFrame,
-          AV_PIX_FMT_RGB24, this->dataPtr->inWidth,
-          this->dataPtr->inHeight);
+      this->avInFrame = new AVPicture;
+      avpicture_alloc(this->avInFrame,
+          AV_PIX_FMT_RGB24, this->inWidth,
+          this->inHeight);
 #else
-      this->dataPtr->avInFrame = av_frame_alloc();
+      this->avInFrame = av_frame_alloc();
 
-      av_image_alloc(this->dataPtr->avInFrame->data,
-          this->dataPtr->avInFrame->linesize,
-          this->dataPtr->inWidth, this->dataPtr->inHeight,
+      av_image_alloc(this->avInFrame->data,
+          this->avInFrame->linesize,
+          this->inWidth, this->inHeight,
           AV_PIX_FMT_RGB24, 1);
 #endif
     }
 
-    this->dataPtr->swsCtx = sws_getContext(
-        this->dataPtr->inWidth,
-        this->dataPtr->inHeight,
+    this->swsCtx = sws_getContext(
+        this->inWidth,
+        this->inHeight,
         AV_PIX_FMT_RGB24,
-        this->dataPtr->codecCtx->width,
-        this->dataPtr->codecCtx->height,
-        this->dataPtr->codecCtx->pix_fmt,
+        this->codecCtx->width,
+        this->codecCtx->height,
+        this->outPixFmt,
         SWS_BICUBIC, nullptr, nullptr, nullptr);
 
-    if (this->dataPtr->swsCtx == nullptr)
+    if (this->swsCtx == nullptr)
     {
       gzerr << "Error while calling sws_getContext\n";
       return false;
@@ -609,17 +831,17 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
   }
 
   // encode
-  memcpy(this->dataPtr->avInFrame->data[0], _frame,
-         this->dataPtr->inWidth * this->dataPtr->inHeight * 3);
+  memcpy(this->avInFrame->data[0], _frame,
+         this->inWidth * this->inHeight * 3);
 
-  sws_scale(this->dataPtr->swsCtx,
-      this->dataPtr->avInFrame->data,
-      this->dataPtr->avInFrame->linesize,
-      0, this->dataPtr->inHeight,
-      this->dataPtr->avOutFrame->data,
-      this->dataPtr->avOutFrame->linesize);
+  sws_scale(this->swsCtx,
+      this->avInFrame->data,
+      this->avInFrame->linesize,
+      0, this->inHeight,
+      this->avOutFrame->data,
+      this->avOutFrame->linesize);
 
-  this->dataPtr->avOutFrame->pts = this->dataPtr->frameCount++;
+  this->avOutFrame->pts = this->frameCount++;
 
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 40, 101)
   int gotOutput = 0;
@@ -628,31 +850,31 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
   avPacket.data = nullptr;
   avPacket.size = 0;
 
-  int ret = avcodec_encode_video2(this->dataPtr->codecCtx, &avPacket,
-      this->dataPtr->avOutFrame, &gotOutput);
+  int ret = avcodec_encode_video2(this->codecCtx, &avPacket,
+      this->avOutFrame, &gotOutput);
 
   if (ret >= 0 && gotOutput == 1)
   {
-    avPacket.stream_index = this->dataPtr->videoStream->index;
+    avPacket.stream_index = this->videoStream->index;
 
     // Scale timestamp appropriately.
     if (avPacket.pts != static_cast<int64_t>(AV_NOPTS_VALUE))
     {
       avPacket.pts = av_rescale_q(avPacket.pts,
-          this->dataPtr->codecCtx->time_base,
-          this->dataPtr->videoStream->time_base);
+          this->codecCtx->time_base,
+          this->videoStream->time_base);
     }
 
     if (avPacket.dts != static_cast<int64_t>(AV_NOPTS_VALUE))
     {
       avPacket.dts = av_rescale_q(
           avPacket.dts,
-          this->dataPtr->codecCtx->time_base,
-          this->dataPtr->videoStream->time_base);
+          this->codecCtx->time_base,
+          this->videoStream->time_base);
     }
 
     // Write frame to disk
-    ret = av_interleaved_write_frame(this->dataPtr->formatCtx, &avPacket);
+    ret = av_interleaved_write_frame(this->formatCtx, &avPacket);
 
     if (ret < 0)
     {
@@ -666,44 +888,58 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
 // #else for libavcodec version check
 #else
 
+  AVFrame *outFrame = this->avOutFrame;
+
+#ifdef GAZEBO_HW_VIDEO_ENCODING
+  if (this->hwFramesCtx)
+  {
+    av_frame_unref(this->hwFrame);
+    if (av_hwframe_get_buffer(this->hwFramesCtx, this->hwFrame, 0) < 0 ||
+        av_hwframe_transfer_data(this->hwFrame, this->avOutFrame, 0) < 0)
+    {
+      gzerr << "Unable to upload a frame to the hardware encoder\n";
+      return false;
+    }
+    this->hwFrame->pts = this->avOutFrame->pts;
+    outFrame = this->hwFrame;
+  }
+#endif
+
   AVPacket *avPacket = av_packet_alloc();
   av_init_packet(avPacket);
 
   avPacket->data = nullptr;
   avPacket->size = 0;
 
-  int ret = avcodec_send_frame(this->dataPtr->codecCtx,
-                               this->dataPtr->avOutFrame);
+  int ret = avcodec_send_frame(this->codecCtx, outFrame);
 
   // This loop will retrieve and write available packets
   while (ret >= 0)
   {
-    ret = avcodec_receive_packet(this->dataPtr->codecCtx, avPacket);
+    ret = avcodec_receive_packet(this->codecCtx, avPacket);
 
-    // Potential performance improvement: Queue the packets and write in
-    // a separate thread.
     if (ret >= 0)
     {
-      avPacket->stream_index = this->dataPtr->videoStream->index;
+      avPacket->stream_index = this->videoStream->index;
 
       // Scale timestamp appropriately.
       if (avPacket->pts != static_cast<int64_t>(AV_NOPTS_VALUE))
       {
         avPacket->pts = av_rescale_q(avPacket->pts,
-            this->dataPtr->codecCtx->time_base,
-            this->dataPtr->videoStream->time_base);
+            this->codecCtx->time_base,
+            this->videoStream->time_base);
       }
 
       if (avPacket->dts != static_cast<int64_t>(AV_NOPTS_VALUE))
       {
         avPacket->dts = av_rescale_q(
             avPacket->dts,
-            this->dataPtr->codecCtx->time_base,
-            this->dataPtr->videoStream->time_base);
+            this->codecCtx->time_base,
+            this->videoStream->time_base);
       }
 
       // Write frame to disk
-      if (av_interleaved_write_frame(this->dataPtr->formatCtx, avPacket) < 0)
+      if (av_interleaved_write_frame(this->formatCtx, avPacket) < 0)
         gzerr << "Error writing frame" << std::endl;
     }
   }
@@ -712,6 +948,59 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
 #endif
   return true;
 }
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::Enqueue(const unsigned char *_frame,
+    const unsigned int _width, const unsigned int _height)
+{
+  std::lock_guard<std::mutex> lock(this->queueMutex);
+
+  // Drop the frame rather than wait for the encoder to catch up
+  if (this->queue.size() >= this->queueSize)
+  {
+    ++this->droppedFrames;
+    return false;
+  }
+
+  QueuedFrame frame;
+  if (!this->spareBuffers.empty())
+  {
+    frame.data = std::move(this->spareBuffers.back());
+    this->spareBuffers.pop_back();
+  }
+  frame.data.assign(_frame, _frame + _width * _height * 3);
+  frame.width = _width;
+  frame.height = _height;
+
+  this->queue.push_back(std::move(frame));
+  this->queueCondition.notify_one();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoderPrivate::RunEncodeThread()
+{
+  std::unique_lock<std::mutex> lock(this->queueMutex);
+  while (true)
+  {
+    this->queueCondition.wait(lock, [this]
+        {return this->stopEncodeThread || !this->queue.empty();});
+
+    // Stop once every queued frame has been encoded
+    if (this->queue.empty())
+      break;
+
+    QueuedFrame frame = std::move(this->queue.front());
+    this->queue.pop_front();
+
+    lock.unlock();
+    this->Encode(frame.data.data(), frame.width, frame.height);
+    lock.lock();
+
+    this->spareBuffers.push_back(std::move(frame.data));
+  }
+}
+
 // #else for HAVE_FFMPEG check
 #else
 bool VideoEncoder::AddFrame(const unsigned char */*_frame*/,
@@ -726,9 +1015,28 @@ bool VideoEncoder::AddFrame(const unsigned char */*_frame*/,
 }
 #endif
 
+/////////////////////////////////////////////////
+void VideoEncoderPrivate::StopEncodeThread()
+{
+  if (!this->encodeThread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    this->stopEncodeThread = true;
+  }
+  this->queueCondition.notify_all();
+  this->encodeThread.join();
+
+  this->spareBuffers.clear();
+}
+
 /////////////////////////////////////////////////
 bool VideoEncoder::Stop()
 {
+  // Encode the frames that are still queued before writing the trailer
+  this->dataPtr->StopEncodeThread();
+
 #ifdef HAVE_FFMPEG
   if (this->dataPtr->encoding && this->dataPtr->formatCtx)
     av_write_trailer(this->dataPtr->formatCtx);
@@ -759,6 +1067,15 @@ bool VideoEncoder::Stop()
     sws_freeContext(this->dataPtr->swsCtx);
   this->dataPtr->swsCtx = nullptr;
 
+#ifdef GAZEBO_HW_VIDEO_ENCODING
+  if (this->dataPtr->hwFrame)
+    av_frame_free(&this->dataPtr->hwFrame);
+  this->dataPtr->hwFrame = nullptr;
+
+  av_buffer_unref(&this->dataPtr->hwFramesCtx);
+  av_buffer_unref(&this->dataPtr->hwDeviceCtx);
+#endif
+
   // This frees the context and all the streams
   if (this->dataPtr->formatCtx)
     avformat_free_context(this->dataPtr->formatCtx);
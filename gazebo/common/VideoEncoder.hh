@@ -18,6 +18,7 @@
 #define GAZEBO_COMMON_VIDEOENCODER_HH_
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <gazebo/util/system.hh>
@@ -118,6 +119,39 @@ namespace gazebo
       /// \return Bit rate
       public: unsigned int BitRate() const;
 
+      /// \brief Encode frames in a worker thread. AddFrame then copies each
+      /// frame into a queue of at most _size frames and returns without
+      /// waiting for the frame to be encoded. Frames added while the queue
+      /// is full are dropped instead of blocking the caller. A size of zero,
+      /// the default, encodes frames in the thread calling AddFrame. This
+      /// must be called before Start.
+      /// \param[in] _size Maximum number of frames waiting to be encoded.
+      public: void SetQueueSize(const unsigned int _size);
+
+      /// \brief Get the maximum number of frames waiting to be encoded.
+      /// \return Queue size, zero if frames are encoded synchronously.
+      /// \sa SetQueueSize
+      public: unsigned int QueueSize() const;
+
+      /// \brief Get the number of frames dropped because the encoding
+      /// queue was full since Start was called.
+      /// \return Number of dropped frames.
+      public: uint64_t DroppedFrames() const;
+
+      /// \brief Set the hardware encoder to use. Supported values are
+      /// "nvenc" and "vaapi", which encode H.264 through FFmpeg. An empty
+      /// string, the default, uses the GAZEBO_VIDEO_HW_ENCODER environment
+      /// variable if set, and software encoding otherwise. Encoding falls
+      /// back to software when the hardware encoder is not available or
+      /// the video format can't hold H.264. This must be called before
+      /// Start.
+      /// \param[in] _encoder Name of the hardware encoder.
+      public: void SetHardwareEncoder(const std::string &_encoder);
+
+      /// \brief Get the hardware encoder requested with SetHardwareEncoder.
+      /// \return Name of the hardware encoder, empty for the default.
+      public: std::string HardwareEncoder() const;
+
       /// \brief Reset to default video properties and clean up allocated
       /// memory. This will also delete any temporary files.
       public: void Reset();
@@ -14,6 +14,8 @@
  *
 */
 #include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/VideoEncoder.hh"
@@ -75,3 +77,46 @@ TEST_F(VideoEncoderTest, Exists)
   EXPECT_FALSE(common::exists(common::cwd() + "/TMP_RECORDING.mp4"));
 #endif
 }
+
+/////////////////////////////////////////////////
+TEST_F(VideoEncoderTest, Queue)
+{
+  VideoEncoder video;
+  EXPECT_EQ(0u, video.QueueSize());
+  EXPECT_EQ(0u, video.DroppedFrames());
+  EXPECT_TRUE(video.HardwareEncoder().empty());
+
+  video.SetQueueSize(2);
+  EXPECT_EQ(2u, video.QueueSize());
+
+  video.SetHardwareEncoder("nvenc");
+  EXPECT_EQ("nvenc", video.HardwareEncoder());
+  video.SetHardwareEncoder("");
+
+#ifdef HAVE_FFMPEG
+  const unsigned int width = 320;
+  const unsigned int height = 240;
+  std::vector<unsigned char> frame(width * height * 3, 128);
+
+  EXPECT_TRUE(video.Start("mp4", "", width, height));
+  EXPECT_TRUE(video.IsEncoding());
+
+  // Add frames faster than they can be encoded, one frame period apart so
+  // that none are skipped by the frame rate check.
+  auto timestamp = std::chrono::steady_clock::now();
+  unsigned int added = 0;
+  for (unsigned int i = 0; i < 50; ++i)
+  {
+    timestamp += std::chrono::milliseconds(1000 / VIDEO_ENCODER_FPS_DEFAULT);
+    if (video.AddFrame(frame.data(), width, height, timestamp))
+      ++added;
+  }
+  EXPECT_EQ(50u, added + video.DroppedFrames());
+
+  // Stop encodes the queued frames
+  EXPECT_TRUE(video.Stop());
+  EXPECT_FALSE(video.IsEncoding());
+  video.Reset();
+  EXPECT_FALSE(common::exists(common::cwd() + "/TMP_RECORDING.mp4"));
+#endif
+}
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <tinyxml.h>
+
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <sdf/sdf.hh>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/WorldCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Magic string at the start of a world cache file.
+static const char WORLD_CACHE_MAGIC[] = "GZWORLDC";
+
+//////////////////////////////////////////////////
+/// \brief Read the content of a file.
+/// \param[in] _filename Path to the file.
+/// \param[out] _content Content of the file.
+/// \return False if the file can't be read.
+static bool ReadFile(const std::string &_filename, std::string &_content)
+{
+  std::ifstream in(_filename, std::ios::binary);
+  if (!in)
+    return false;
+
+  _content.assign(std::istreambuf_iterator<char>(in),
+      std::istreambuf_iterator<char>());
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the hash of the content of a file.
+/// \param[in] _filename Path to the file.
+/// \return The hash, empty if the file can't be read.
+static std::string FileHash(const std::string &_filename)
+{
+  std::string content;
+  if (!ReadFile(_filename, content))
+    return std::string();
+  return common::get_sha1<std::string>(content);
+}
+
+//////////////////////////////////////////////////
+/// \brief Add the URIs of the includes under an XML element.
+/// \param[in] _elem XML element.
+/// \param[in,out] _uris URIs found.
+static void CollectIncludeUris(const TiXmlElement *_elem,
+    std::vector<std::string> &_uris)
+{
+  for (const TiXmlElement *child = _elem->FirstChildElement(); child;
+       child = child->NextSiblingElement())
+  {
+    if (child->ValueStr() == "include")
+    {
+      const TiXmlElement *uriElem = child->FirstChildElement("uri");
+      if (uriElem && uriElem->GetText())
+        _uris.push_back(uriElem->GetText());
+    }
+    else
+      CollectIncludeUris(child, _uris);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Add the files included by a world or model file, recursively.
+/// \param[in] _filename Path to the world or model file.
+/// \param[in,out] _visited Files already visited.
+/// \param[in,out] _files Files found.
+static void CollectDependencies(const std::string &_filename,
+    std::set<std::string> &_visited, std::vector<std::string> &_files)
+{
+  if (!_visited.insert(_filename).second)
+    return;
+
+  TiXmlDocument doc;
+  if (!doc.LoadFile(_filename) || !doc.RootElement())
+    return;
+
+  std::vector<std::string> uris;
+  CollectIncludeUris(doc.RootElement(), uris);
+
+  for (auto const &uri : uris)
+  {
+    const std::string path = common::find_file(uri);
+    if (path.empty())
+      continue;
+
+    std::string modelFile = path;
+    if (boost::filesystem::is_directory(path))
+    {
+      const boost::filesystem::path config =
+        boost::filesystem::path(path) / "model.config";
+      if (boost::filesystem::exists(config) &&
+          _visited.insert(config.string()).second)
+      {
+        _files.push_back(config.string());
+      }
+      modelFile = sdf::getModelFilePath(path);
+    }
+
+    if (modelFile.empty() || _visited.count(modelFile))
+      continue;
+
+    _files.push_back(modelFile);
+    CollectDependencies(modelFile, _visited, _files);
+  }
+}
+
+//////////////////////////////////////////////////
+std::string WorldCache::DefaultPath()
+{
+  const char *cachePath = common::getEnv("GAZEBO_WORLD_CACHE");
+  if (cachePath)
+    return cachePath;
+
+  const char *homePath = common::getEnv("HOME");
+  if (homePath)
+  {
+    return (boost::filesystem::path(homePath) / ".gazebo" /
+        "world_cache").string();
+  }
+  return std::string();
+}
+
+//////////////////////////////////////////////////
+std::string WorldCache::Key(const std::string &_filename)
+{
+  std::string content;
+  if (!ReadFile(_filename, content))
+    return std::string();
+
+  // The model path is part of the key, since it decides which models the
+  // includes resolve to.
+  const char *modelPath = common::getEnv("GAZEBO_MODEL_PATH");
+  std::string key = _filename;
+  key += '\0';
+  key += modelPath ? modelPath : "";
+  key += '\0';
+  key += SDF_VERSION;
+  key += '\0';
+  key += content;
+  return common::get_sha1<std::string>(key);
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> WorldCache::IncludeUris(const std::string &_filename)
+{
+  std::vector<std::string> uris;
+
+  TiXmlDocument doc;
+  if (doc.LoadFile(_filename) && doc.RootElement())
+    CollectIncludeUris(doc.RootElement(), uris);
+
+  return uris;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> WorldCache::Dependencies(
+    const std::string &_filename)
+{
+  std::set<std::string> visited;
+  std::vector<std::string> files;
+  CollectDependencies(_filename, visited, files);
+  return files;
+}
+
+//////////////////////////////////////////////////
+bool WorldCache::Load(const std::string &_path, const std::string &_key,
+    std::string &_sdf)
+{
+  if (_path.empty() || _key.empty())
+    return false;
+
+  const boost::filesystem::path filename =
+    boost::filesystem::path(_path) / (_key + ".world");
+  std::ifstream in(filename.string(), std::ios::binary);
+  if (!in)
+    return false;
+
+  std::string magic;
+  int version = 0;
+  size_t count = 0;
+  in >> magic >> version >> count;
+  if (!in || magic != WORLD_CACHE_MAGIC || version != GZ_WORLD_CACHE_VERSION)
+    return false;
+  in.ignore(1);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::string line;
+    if (!std::getline(in, line))
+      return false;
+
+    const size_t space = line.find(' ');
+    if (space == std::string::npos ||
+        FileHash(line.substr(space + 1)) != line.substr(0, space))
+    {
+      gzmsg << "World cache file[" << filename.string() << "] is out of "
+            << "date, the world will be read again\n";
+      return false;
+    }
+  }
+
+  _sdf.assign(std::istreambuf_iterator<char>(in),
+      std::istreambuf_iterator<char>());
+  return !_sdf.empty();
+}
+
+//////////////////////////////////////////////////
+bool WorldCache::Save(const std::string &_path, const std::string &_key,
+    const std::string &_filename, const std::string &_sdf)
+{
+  if (_path.empty() || _key.empty() || _sdf.empty())
+    return false;
+
+  std::ostringstream header;
+  const std::vector<std::string> files = Dependencies(_filename);
+  header << WORLD_CACHE_MAGIC << " " << GZ_WORLD_CACHE_VERSION << " "
+         << files.size() << "\n";
+  for (auto const &file : files)
+  {
+    const std::string hash = FileHash(file);
+    if (hash.empty())
+      return false;
+    header << hash << " " << file << "\n";
+  }
+
+  boost::system::error_code errorCode;
+  boost::filesystem::create_directories(_path, errorCode);
+  if (errorCode)
+  {
+    gzwarn << "Unable to create world cache directory[" << _path << "]\n";
+    return false;
+  }
+
+  // Write to a temporary file first, so that other processes never read a
+  // partial file.
+  const boost::filesystem::path filename =
+    boost::filesystem::path(_path) / (_key + ".world");
+  const boost::filesystem::path tmp = filename.string() + "." +
+    boost::filesystem::unique_path("%%%%%%%%").string();
+
+  {
+    std::ofstream out(tmp.string(), std::ios::binary);
+    out << header.str() << _sdf;
+    if (!out)
+    {
+      gzwarn << "Unable to write world cache file[" << tmp.string() << "]\n";
+      out.close();
+      boost::filesystem::remove(tmp, errorCode);
+      return false;
+    }
+  }
+
+  boost::filesystem::rename(tmp, filename, errorCode);
+  if (errorCode)
+  {
+    boost::filesystem::remove(tmp, errorCode);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_WORLDCACHE_HH_
+#define GAZEBO_COMMON_WORLDCACHE_HH_
+
+#include <string>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+/// \brief Version of the world cache file layout. Cache files of other
+/// versions are ignored, and replaced when the world is loaded again.
+#define GZ_WORLD_CACHE_VERSION 1
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class WorldCache WorldCache.hh common/common.hh
+    /// \brief Functions to store world files with their includes resolved,
+    /// so that servers loading the same world skip the resolution of the
+    /// included models.
+    ///
+    /// A cache file starts with a magic string and the
+    /// GZ_WORLD_CACHE_VERSION, followed by the hashes of the files the
+    /// world was built from, and by the SDF of the world with every
+    /// include replaced by the model it refers to.
+    ///
+    /// Cache files are named by a hash of the path and content of the
+    /// world file and of the model path. A cached world is only used while
+    /// the model files it includes are unchanged.
+    class GZ_COMMON_VISIBLE WorldCache
+    {
+      /// \brief Get the default cache directory, which is the
+      /// GAZEBO_WORLD_CACHE environment variable if set, or
+      /// ~/.gazebo/world_cache. An empty path disables the cache.
+      /// \return The cache directory.
+      public: static std::string DefaultPath();
+
+      /// \brief Get the cache key of a world file.
+      /// \param[in] _filename Complete path to the world file.
+      /// \return Hash of the path and content of the file and of
+      /// GAZEBO_MODEL_PATH, empty if the file can't be read.
+      public: static std::string Key(const std::string &_filename);
+
+      /// \brief Get the URIs of the models a world or model file includes
+      /// directly, in the order they appear.
+      /// \param[in] _filename Complete path to the world or model file.
+      /// \return The URIs, empty if the file can't be read.
+      public: static std::vector<std::string> IncludeUris(
+                  const std::string &_filename);
+
+      /// \brief Get the files a world or model file includes, recursively.
+      /// The files of models that can't be found are left out.
+      /// \param[in] _filename Complete path to the world or model file.
+      /// \return Complete paths to the SDF and model.config files of the
+      /// included models.
+      public: static std::vector<std::string> Dependencies(
+                  const std::string &_filename);
+
+      /// \brief Load a world from the cache.
+      /// \param[in] _path Cache directory.
+      /// \param[in] _key Cache key of the world file.
+      /// \param[out] _sdf SDF of the world, with the includes resolved.
+      /// \return False if the world is not in the cache, or if one of the
+      /// files it was built from changed.
+      public: static bool Load(const std::string &_path,
+                               const std::string &_key, std::string &_sdf);
+
+      /// \brief Save a world to the cache.
+      /// \param[in] _path Cache directory, created if needed.
+      /// \param[in] _key Cache key of the world file.
+      /// \param[in] _filename Complete path to the world file.
+      /// \param[in] _sdf SDF of the world, with the includes resolved.
+      /// \return True if the world was saved.
+      public: static bool Save(const std::string &_path,
+                               const std::string &_key,
+                               const std::string &_filename,
+                               const std::string &_sdf);
+    };
+    /// \}
+  }
+}
+#endif
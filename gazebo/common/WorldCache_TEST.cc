@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/WorldCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class WorldCache : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Write a file.
+/// \param[in] _filename Path to the file.
+/// \param[in] _content Content of the file.
+void WriteFile(const boost::filesystem::path &_filename,
+    const std::string &_content)
+{
+  std::ofstream out(_filename.string());
+  out << _content;
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldCache, SaveLoad)
+{
+  const boost::filesystem::path dir =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_world_cache_%%%%");
+  const boost::filesystem::path modelDir = dir / "box";
+  const std::string cachePath = (dir / "cache").string();
+  boost::filesystem::create_directories(modelDir);
+
+  WriteFile(modelDir / "model.config",
+      "<?xml version='1.0'?><model><name>box</name>"
+      "<sdf version='1.6'>model.sdf</sdf></model>");
+  WriteFile(modelDir / "model.sdf",
+      "<?xml version='1.0'?><sdf version='1.6'><model name='box'>"
+      "<link name='link'/></model></sdf>");
+  const std::string worldFile = (dir / "test.world").string();
+  WriteFile(worldFile,
+      "<?xml version='1.0'?><sdf version='1.6'><world name='default'>"
+      "<include><uri>" + modelDir.string() + "</uri></include>"
+      "</world></sdf>");
+
+  const std::string key = common::WorldCache::Key(worldFile);
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, common::WorldCache::Key(worldFile));
+  EXPECT_TRUE(common::WorldCache::Key(worldFile + "_missing").empty());
+
+  const std::vector<std::string> deps =
+    common::WorldCache::Dependencies(worldFile);
+  ASSERT_EQ(2u, deps.size());
+  EXPECT_EQ((modelDir / "model.config").string(), deps[0]);
+  EXPECT_EQ((modelDir / "model.sdf").string(), deps[1]);
+
+  // Nothing cached yet
+  std::string sdf;
+  EXPECT_FALSE(common::WorldCache::Load(cachePath, key, sdf));
+
+  const std::string resolved = "<sdf version='1.6'><world name='default'>"
+    "<model name='box'><link name='link'/></model></world></sdf>";
+  EXPECT_TRUE(common::WorldCache::Save(cachePath, key, worldFile, resolved));
+  EXPECT_TRUE(common::WorldCache::Load(cachePath, key, sdf));
+  EXPECT_EQ(resolved, sdf);
+
+  // A disabled cache never loads nor saves
+  EXPECT_FALSE(common::WorldCache::Load("", key, sdf));
+  EXPECT_FALSE(common::WorldCache::Save("", key, worldFile, resolved));
+
+  // Editing an included model invalidates the cached world
+  WriteFile(modelDir / "model.sdf",
+      "<?xml version='1.0'?><sdf version='1.6'><model name='box'>"
+      "<link name='base'/></model></sdf>");
+  EXPECT_FALSE(common::WorldCache::Load(cachePath, key, sdf));
+
+  boost::filesystem::remove_all(dir);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldCache, IncludeUris)
+{
+  const boost::filesystem::path dir =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_world_cache_%%%%");
+  boost::filesystem::create_directories(dir);
+
+  // Includes nested in other elements are found, in order
+  const std::string worldFile = (dir / "test.world").string();
+  WriteFile(worldFile,
+      "<?xml version='1.0'?><sdf version='1.6'><world name='default'>"
+      "<include><uri>model://ground_plane</uri></include>"
+      "<model name='parent'>"
+      "<include><uri>https://fuel.example.org/models/box</uri></include>"
+      "</model>"
+      "<include><name>no_uri</name></include>"
+      "<actor name='actor'><skin><uri>model://skin</uri></skin></actor>"
+      "</world></sdf>");
+
+  const std::vector<std::string> uris =
+    common::WorldCache::IncludeUris(worldFile);
+  ASSERT_EQ(2u, uris.size());
+  EXPECT_EQ("model://ground_plane", uris[0]);
+  EXPECT_EQ("https://fuel.example.org/models/box", uris[1]);
+
+  EXPECT_TRUE(common::WorldCache::IncludeUris(worldFile + "_missing").empty());
+
+  boost::filesystem::remove_all(dir);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
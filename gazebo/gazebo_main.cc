@@ -51,17 +51,37 @@ void help()
   << "  -e [ --physics ] arg          Specify a physics engine "
   << "(ode|bullet|dart|simbody).\n"
   << "  -p [ --play ] arg             Play a log file.\n"
+  << "  --play_mode arg (=full)       World update run for each state "
+  << "played back\n"
+  << "                                (full|poses|sensors).\n"
   << "  -r [ --record ]               Record state data.\n"
   << "  --record_encoding arg (=zlib) Compression encoding format for log "
   << "data \n"
-  << "                                (zlib|bz2|txt).\n"
+  << "                                (zlib|bz2|zstd|txt).\n"
+  << "  --record_format arg (=xml)    File format for log data "
+  << "(xml|binary).\n"
   << "  --record_path arg             Absolute path in which to store "
   << "state data.\n"
   << "  --record_period arg (=-1)     Recording period (seconds).\n"
   << "  --record_filter arg           Recording filter (supports wildcard and "
   << "regular expression).\n"
+  << "  --record_keyframe_period arg (=0)\n"
+  << "                                Simulation time between full state "
+  << "frames\n"
+  << "                                (seconds). A value <= 0 records full "
+  << "frames.\n"
+  << "  --record_tolerance arg (=1e-06)\n"
+  << "                                Changes up to this value are left out "
+  << "of\n"
+  << "                                partial state frames.\n"
   << "  --record_resources           Recording with model meshes and "
   << "materials.\n"
+  << "  --record_resource_store arg   Directory in which recorded resources "
+  << "are\n"
+  << "                                shared between logs.\n"
+  << "  --record_bandwidth arg (=0)   Maximum rate at which log data is "
+  << "written\n"
+  << "                                (MB/s). 0 is unlimited.\n"
   << "  --seed arg                    Start with a given random number seed.\n"
   << "  --iters arg                   Number of iterations to simulate.\n"
   << "  --minimal_comms               Reduce the TCP/IP traffic output by "
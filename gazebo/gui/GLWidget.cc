@@ -64,9 +64,12 @@ GLWidget::GLWidget(QWidget *_parent)
   this->dataPtr->copyEntityName = "";
   this->dataPtr->modelEditorEnabled = false;
 
+  // Frames are painted from a precise timer, so that the frame rate
+  // doesn't drift with the event load of the other widgets.
   this->dataPtr->updateTimer = new QTimer(this);
+  this->dataPtr->updateTimer->setTimerType(Qt::PreciseTimer);
   connect(this->dataPtr->updateTimer, SIGNAL(timeout()),
-  this, SLOT(update()));
+  this, SLOT(OnRenderTimer()));
 
   this->dataPtr->windowId = -1;
 
@@ -294,6 +297,29 @@ void GLWidget::paintEvent(QPaintEvent *_e)
   _e->accept();
 }
 
+/////////////////////////////////////////////////
+void GLWidget::OnRenderTimer()
+{
+  // Pick the visual under the mouse once per frame rather than on every
+  // mouse move, since picking renders the selection buffer.
+  if (this->dataPtr->hoverPending && this->dataPtr->userCamera)
+  {
+    this->dataPtr->hoverPending = false;
+
+    rendering::VisualPtr vis = this->dataPtr->userCamera->Visual(
+        this->dataPtr->mouseEvent.Pos());
+
+    if (vis && !vis->IsPlane())
+      QApplication::setOverrideCursor(Qt::PointingHandCursor);
+    else
+      QApplication::setOverrideCursor(Qt::ArrowCursor);
+  }
+
+  // Paint now instead of posting an update request, which waits behind
+  // the events already queued.
+  this->repaint();
+}
+
 /////////////////////////////////////////////////
 void GLWidget::resizeEvent(QResizeEvent *_e)
 {
@@ -706,13 +732,8 @@ void GLWidget::OnMouseMoveNormal()
   if (!this->dataPtr->userCamera)
     return;
 
-  rendering::VisualPtr vis = this->dataPtr->userCamera->Visual(
-      this->dataPtr->mouseEvent.Pos());
-
-  if (vis && !vis->IsPlane())
-    QApplication::setOverrideCursor(Qt::PointingHandCursor);
-  else
-    QApplication::setOverrideCursor(Qt::ArrowCursor);
+  // The cursor is updated on the next frame
+  this->dataPtr->hoverPending = true;
 
   this->dataPtr->userCamera->HandleMouseEvent(this->dataPtr->mouseEvent);
 }
@@ -206,6 +206,9 @@ namespace gazebo
       /// \brief QT Callback that turns on perspective projection
       private slots: void OnPerspective();
 
+      /// \brief Qt callback to render a frame, at the rate of the camera.
+      private slots: void OnRenderTimer();
+
       /// \brief Set this->mouseEvent's Buttons property to the value of
       /// _event->buttons(). Note that this is different from the
       /// SetMouseEventButtons, plural, function.
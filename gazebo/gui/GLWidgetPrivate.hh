@@ -115,6 +115,10 @@ namespace gazebo
       /// \brief Timer used to update the render window.
       public: QTimer *updateTimer = nullptr;
 
+      /// \brief True if the mouse moved since the visual under it was last
+      /// picked.
+      public: bool hoverPending = false;
+
       /// \brief Time when the last wheel event was processed
       public: common::Time lastWheelEventTime;
     };
@@ -92,5 +92,60 @@ void GLWidget_TEST::SelectObject()
   delete mainWindow;
 }
 
+/////////////////////////////////////////////////
+void GLWidget_TEST::HoverCursor()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/shapes.world", false, false, false);
+
+  // Create the main window.
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != NULL);
+
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  // Get GLWidget
+  gazebo::gui::GLWidget *glWidget =
+      mainWindow->findChild<gazebo::gui::GLWidget *>("GLWidget");
+  QVERIFY(glWidget != NULL);
+
+  // Move over the box in the center of the screen. The cursor changes on
+  // the next frame, not on the mouse move itself.
+  QPoint moveTo(glWidget->width()/2, glWidget->height()/2);
+  QTest::mouseMove(glWidget, moveTo);
+  this->ProcessEventsAndDraw(mainWindow);
+
+  QVERIFY(QApplication::overrideCursor() != NULL);
+  QCOMPARE(QApplication::overrideCursor()->shape(), Qt::PointingHandCursor);
+
+  // Move over the sky in the top left corner
+  QTest::mouseMove(glWidget, QPoint(5, 5));
+  this->ProcessEventsAndDraw(mainWindow);
+
+  QVERIFY(QApplication::overrideCursor() != NULL);
+  QCOMPARE(QApplication::overrideCursor()->shape(), Qt::ArrowCursor);
+
+  // Many moves in a row give the cursor of the last position
+  for (int i = 0; i < 20; ++i)
+    QTest::mouseMove(glWidget, QPoint(5 + i, 5));
+  QTest::mouseMove(glWidget, moveTo);
+  this->ProcessEventsAndDraw(mainWindow);
+
+  QVERIFY(QApplication::overrideCursor() != NULL);
+  QCOMPARE(QApplication::overrideCursor()->shape(), Qt::PointingHandCursor);
+
+  while (QApplication::overrideCursor())
+    QApplication::restoreOverrideCursor();
+
+  mainWindow->close();
+  delete mainWindow;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(GLWidget_TEST)
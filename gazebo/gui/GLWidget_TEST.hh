@@ -27,6 +27,9 @@ class GLWidget_TEST : public QTestFixture
 
   /// \brief Test selecting an object.
   private slots: void SelectObject();
+
+  /// \brief Test the cursor over visuals, updated once per frame.
+  private slots: void HoverCursor();
 };
 
 #endif
@@ -154,6 +154,7 @@ bool parse_args(int _argc, char **_argv)
     ("version,v", "Output version information.")
     ("verbose", "Increase the messages written to the terminal.")
     ("help,h", "Produce this help message.")
+    ("remote", "Reduce the bandwidth used to connect to a remote server.")
     ("gui-client-plugin", po::value<std::vector<std::string> >(),
      "Load a GUI plugin.")
     ("gui-plugin,g", po::value<std::vector<std::string> >(),
@@ -192,6 +193,9 @@ bool parse_args(int _argc, char **_argv)
     gazebo::common::Console::SetQuiet(false);
   }
 
+  if (vm.count("remote"))
+    rendering::set_remote_client(true);
+
   /// Load the System plugins specified on the command line
   /// see https://github.com/osrf/gazebo/issues/2279 for details
   if (vm.count("gui-plugin"))
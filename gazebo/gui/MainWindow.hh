@@ -281,6 +281,10 @@ namespace gazebo
 
       private: void OnModel(ConstModelPtr &_msg);
 
+      /// \brief Callback for models inserted together.
+      /// \param[in] _msg Message with the models.
+      private: void OnModels(ConstModel_VPtr &_msg);
+
       /// \brief Light message callback.
       /// \param[in] _msg Pointer to the light message.
       private: void OnLight(ConstLightPtr &_msg);
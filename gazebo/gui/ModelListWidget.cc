@@ -58,6 +58,10 @@
 using namespace gazebo;
 using namespace gui;
 
+/// \brief Maximum number of model messages processed by one update, so
+/// that the GUI stays responsive while a large world is loaded.
+static const size_t MAX_MODEL_MSGS_PER_UPDATE = 1000;
+
 extern ModelRightMenu *g_modelRightMenu;
 
 /////////////////////////////////////////////////
@@ -90,6 +94,9 @@ ModelListWidget::ModelListWidget(QWidget *_parent)
   connect(this->dataPtr->modelTreeWidget,
       SIGNAL(customContextMenuRequested(const QPoint &)),
       this, SLOT(OnCustomContextMenu(const QPoint &)));
+  connect(this->dataPtr->modelTreeWidget,
+      SIGNAL(itemExpanded(QTreeWidgetItem *)),
+      this, SLOT(OnItemExpanded(QTreeWidgetItem *)));
 
   this->dataPtr->variantManager = new QtVariantPropertyManager();
   this->dataPtr->propTreeBrowser = new QtTreePropertyBrowser();
@@ -273,6 +280,7 @@ void ModelListWidget::OnSetSelectedEntity(const std::string &_name,
         this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
       }
       this->dataPtr->modelTreeWidget->setCurrentItem(mItem);
+      this->PopulateModelItem(mItem);
       mItem->setExpanded(!mItem->isExpanded());
     }
     else if (lItem)
@@ -346,7 +354,14 @@ void ModelListWidget::Update()
   this->ProcessRemoveEntity();
   this->ProcessModelMsgs();
   this->ProcessLightMsgs();
-  QTimer::singleShot(1000, this, SLOT(Update()));
+
+  // Come back soon if some model messages are left
+  bool pending;
+  {
+    std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+    pending = !this->dataPtr->modelMsgs.empty();
+  }
+  QTimer::singleShot(pending ? 10 : 1000, this, SLOT(Update()));
 }
 
 /////////////////////////////////////////////////
@@ -371,16 +386,21 @@ void ModelListWidget::OnLightUpdate(const msgs::Light &_msg)
 void ModelListWidget::ProcessModelMsgs()
 {
   std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
-  QFont subheaderFont;
-  subheaderFont.setBold(true);
 
-  for (auto iter = this->dataPtr->modelMsgs.begin();
-       iter != this->dataPtr->modelMsgs.end(); ++iter)
+  // New model items, added to the tree at once. Their links, joints and
+  // plugins are only created when they're expanded.
+  QList<QTreeWidgetItem *> newItems;
+
+  size_t count = 0;
+  auto iter = this->dataPtr->modelMsgs.begin();
+  for (; iter != this->dataPtr->modelMsgs.end() &&
+       count < MAX_MODEL_MSGS_PER_UPDATE; ++iter, ++count)
   {
     std::string name = (*iter).name();
 
-    QTreeWidgetItem *listItem = this->ListItem((*iter).name(),
-                                                  this->dataPtr->modelsItem);
+    auto itemIter = this->dataPtr->modelItems.find(name);
+    QTreeWidgetItem *listItem = itemIter != this->dataPtr->modelItems.end() ?
+        itemIter->second : nullptr;
 
     if (!listItem)
     {
@@ -388,109 +408,36 @@ void ModelListWidget::ProcessModelMsgs()
       {
         // Create an item for the model name
         QTreeWidgetItem *topItem = new QTreeWidgetItem(
-            this->dataPtr->modelsItem,
             QStringList(QString("%1").arg(QString::fromStdString(name))));
 
         topItem->setData(0, Qt::UserRole, QVariant((*iter).name().c_str()));
-        this->dataPtr->modelTreeWidget->addTopLevelItem(topItem);
-
-        if ((*iter).link_size() > 0)
-        {
-          // Create subheader for links
-          QTreeWidgetItem *linkHeaderItem = new QTreeWidgetItem(topItem,
-          QStringList(QString("%1").arg(QString::fromStdString("LINKS"))));
-          linkHeaderItem->setFont(0, subheaderFont);
-          linkHeaderItem->setFlags(Qt::NoItemFlags);
-          this->dataPtr->modelTreeWidget->addTopLevelItem(linkHeaderItem);
-        }
 
+        ModelListWidgetPrivate::ModelChildren children;
+        children.id = (*iter).id();
         for (int i = 0; i < (*iter).link_size(); ++i)
-        {
-          std::string linkName = (*iter).link(i).name();
-          int index = linkName.rfind("::") + 2;
-          std::string linkNameShort = linkName.substr(index,
-                                                      linkName.size() - index);
-
-          QTreeWidgetItem *linkItem = new QTreeWidgetItem(topItem,
-              QStringList(QString("%1").arg(
-                  QString::fromStdString(linkNameShort))));
-
-          linkItem->setData(0, Qt::UserRole, QVariant(linkName.c_str()));
-          linkItem->setData(1, Qt::UserRole, QVariant((*iter).name().c_str()));
-          linkItem->setData(2, Qt::UserRole, QVariant((*iter).id()));
-          linkItem->setData(3, Qt::UserRole, QVariant("Link"));
-          this->dataPtr->modelTreeWidget->addTopLevelItem(linkItem);
-        }
-
-        if ((*iter).joint_size() > 0)
-        {
-          // Create subheader for joints
-          QTreeWidgetItem *jointHeaderItem = new QTreeWidgetItem(topItem,
-          QStringList(QString("%1").arg(QString::fromStdString("JOINTS"))));
-          jointHeaderItem->setFont(0, subheaderFont);
-          jointHeaderItem->setFlags(Qt::NoItemFlags);
-          this->dataPtr->modelTreeWidget->addTopLevelItem(jointHeaderItem);
-        }
-
+          children.links.push_back((*iter).link(i).name());
         for (int i = 0; i < (*iter).joint_size(); ++i)
-        {
-          std::string jointName = (*iter).joint(i).name();
-
-          int index = jointName.rfind("::") + 2;
-          std::string jointNameShort = jointName.substr(
-              index, jointName.size() - index);
-
-          QTreeWidgetItem *jointItem = new QTreeWidgetItem(topItem,
-              QStringList(QString("%1").arg(
-                  QString::fromStdString(jointNameShort))));
-
-          jointItem->setData(0, Qt::UserRole, QVariant(jointName.c_str()));
-          jointItem->setData(3, Qt::UserRole, QVariant("Joint"));
-          this->dataPtr->modelTreeWidget->addTopLevelItem(jointItem);
-        }
+          children.joints.push_back((*iter).joint(i).name());
+        for (int i = 0; i < (*iter).plugin_size(); ++i)
+          children.plugins.push_back((*iter).plugin(i).name());
 
-        if ((*iter).plugin_size() > 0)
+        if (!children.links.empty() || !children.joints.empty() ||
+            !children.plugins.empty())
         {
-          // Create subheader for plugins
-          QTreeWidgetItem *pluginHeaderItem = new QTreeWidgetItem(topItem,
-          QStringList(QString("%1").arg("PLUGINS")));
-          pluginHeaderItem->setFont(0, subheaderFont);
-          pluginHeaderItem->setFlags(Qt::NoItemFlags);
-          this->dataPtr->modelTreeWidget->addTopLevelItem(pluginHeaderItem);
+          topItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+          this->dataPtr->unpopulatedItems[topItem] = std::move(children);
         }
 
-        for (int i = 0; i < (*iter).plugin_size(); ++i)
-        {
-          std::string pluginName = (*iter).plugin(i).name();
-
-          QTreeWidgetItem *pluginItem = new QTreeWidgetItem(topItem,
-              QStringList(QString("%1").arg(
-                  QString::fromStdString(pluginName))));
-
-          common::URI pluginUri;
-          pluginUri.SetScheme("data");
-
-          pluginUri.Path().PushBack("world");
-          pluginUri.Path().PushBack(gui::get_world());
-          pluginUri.Path().PushBack("model");
-          pluginUri.Path().PushBack((*iter).name());
-          pluginUri.Path().PushBack("plugin");
-          pluginUri.Path().PushBack(pluginName);
-
-          pluginItem->setData(0, Qt::UserRole,
-              QVariant(pluginUri.Str().c_str()));
-          pluginItem->setData(3, Qt::UserRole, QVariant("Plugin"));
-
-          this->dataPtr->modelTreeWidget->addTopLevelItem(pluginItem);
-        }
+        this->dataPtr->modelItems[name] = topItem;
+        newItems.push_back(topItem);
       }
     }
     else
     {
       if ((*iter).has_deleted() && (*iter).deleted())
       {
-        int i = this->dataPtr->modelsItem->indexOfChild(listItem);
-        this->dataPtr->modelsItem->takeChild(i);
+        newItems.removeOne(listItem);
+        this->RemoveModelItem(listItem);
       }
       else
       {
@@ -499,7 +446,143 @@ void ModelListWidget::ProcessModelMsgs()
       }
     }
   }
-  this->dataPtr->modelMsgs.clear();
+  this->dataPtr->modelMsgs.erase(this->dataPtr->modelMsgs.begin(), iter);
+
+  if (!newItems.empty())
+    this->dataPtr->modelsItem->addChildren(newItems);
+}
+
+/////////////////////////////////////////////////
+void ModelListWidget::OnItemExpanded(QTreeWidgetItem *_item)
+{
+  if (_item && _item->parent() == this->dataPtr->modelsItem)
+    this->PopulateModelItem(_item);
+}
+
+/////////////////////////////////////////////////
+void ModelListWidget::PopulateModelItem(QTreeWidgetItem *_item)
+{
+  auto iter = this->dataPtr->unpopulatedItems.find(_item);
+  if (iter == this->dataPtr->unpopulatedItems.end())
+    return;
+
+  const ModelListWidgetPrivate::ModelChildren children =
+      std::move(iter->second);
+  this->dataPtr->unpopulatedItems.erase(iter);
+
+  const std::string modelName =
+      _item->data(0, Qt::UserRole).toString().toStdString();
+
+  QFont subheaderFont;
+  subheaderFont.setBold(true);
+
+  QList<QTreeWidgetItem *> items;
+  if (!children.links.empty())
+  {
+    // Create subheader for links
+    QTreeWidgetItem *linkHeaderItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(QString::fromStdString("LINKS"))));
+    linkHeaderItem->setFont(0, subheaderFont);
+    linkHeaderItem->setFlags(Qt::NoItemFlags);
+    items.push_back(linkHeaderItem);
+  }
+
+  for (const auto &linkName : children.links)
+  {
+    int index = linkName.rfind("::") + 2;
+    std::string linkNameShort = linkName.substr(index,
+                                                linkName.size() - index);
+
+    QTreeWidgetItem *linkItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(
+            QString::fromStdString(linkNameShort))));
+
+    linkItem->setData(0, Qt::UserRole, QVariant(linkName.c_str()));
+    linkItem->setData(1, Qt::UserRole, QVariant(modelName.c_str()));
+    linkItem->setData(2, Qt::UserRole, QVariant(children.id));
+    linkItem->setData(3, Qt::UserRole, QVariant("Link"));
+    this->dataPtr->childItems[linkName] = linkItem;
+    items.push_back(linkItem);
+  }
+
+  if (!children.joints.empty())
+  {
+    // Create subheader for joints
+    QTreeWidgetItem *jointHeaderItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(QString::fromStdString("JOINTS"))));
+    jointHeaderItem->setFont(0, subheaderFont);
+    jointHeaderItem->setFlags(Qt::NoItemFlags);
+    items.push_back(jointHeaderItem);
+  }
+
+  for (const auto &jointName : children.joints)
+  {
+    int index = jointName.rfind("::") + 2;
+    std::string jointNameShort = jointName.substr(
+        index, jointName.size() - index);
+
+    QTreeWidgetItem *jointItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(
+            QString::fromStdString(jointNameShort))));
+
+    jointItem->setData(0, Qt::UserRole, QVariant(jointName.c_str()));
+    jointItem->setData(3, Qt::UserRole, QVariant("Joint"));
+    this->dataPtr->childItems[jointName] = jointItem;
+    items.push_back(jointItem);
+  }
+
+  if (!children.plugins.empty())
+  {
+    // Create subheader for plugins
+    QTreeWidgetItem *pluginHeaderItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg("PLUGINS")));
+    pluginHeaderItem->setFont(0, subheaderFont);
+    pluginHeaderItem->setFlags(Qt::NoItemFlags);
+    items.push_back(pluginHeaderItem);
+  }
+
+  for (const auto &pluginName : children.plugins)
+  {
+    QTreeWidgetItem *pluginItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(
+            QString::fromStdString(pluginName))));
+
+    common::URI pluginUri;
+    pluginUri.SetScheme("data");
+
+    pluginUri.Path().PushBack("world");
+    pluginUri.Path().PushBack(gui::get_world());
+    pluginUri.Path().PushBack("model");
+    pluginUri.Path().PushBack(modelName);
+    pluginUri.Path().PushBack("plugin");
+    pluginUri.Path().PushBack(pluginName);
+
+    pluginItem->setData(0, Qt::UserRole,
+        QVariant(pluginUri.Str().c_str()));
+    pluginItem->setData(3, Qt::UserRole, QVariant("Plugin"));
+    this->dataPtr->childItems[pluginUri.Str()] = pluginItem;
+    items.push_back(pluginItem);
+  }
+
+  _item->addChildren(items);
+  _item->setChildIndicatorPolicy(
+      QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+/////////////////////////////////////////////////
+void ModelListWidget::RemoveModelItem(QTreeWidgetItem *_item)
+{
+  this->dataPtr->modelItems.erase(
+      _item->data(0, Qt::UserRole).toString().toStdString());
+  this->dataPtr->unpopulatedItems.erase(_item);
+  for (int i = 0; i < _item->childCount(); ++i)
+  {
+    this->dataPtr->childItems.erase(
+        _item->child(i)->data(0, Qt::UserRole).toString().toStdString());
+  }
+
+  // Deleting the item also removes it from the tree
+  delete _item;
 }
 
 /////////////////////////////////////////////////
@@ -610,7 +693,10 @@ void ModelListWidget::RemoveEntity(const std::string &_name)
     QTreeWidgetItem *listItem = this->ListItem(_name, items[i]);
     if (listItem)
     {
-      items[i]->takeChild(items[i]->indexOfChild(listItem));
+      if (listItem->parent() == this->dataPtr->modelsItem)
+        this->RemoveModelItem(listItem);
+      else if (listItem->parent() == items[i])
+        delete listItem;
       this->dataPtr->propTreeBrowser->clear();
       this->dataPtr->selectedEntityName.clear();
       this->dataPtr->sdfElement.reset();
@@ -624,6 +710,29 @@ void ModelListWidget::RemoveEntity(const std::string &_name)
 QTreeWidgetItem *ModelListWidget::ListItem(const std::string &_name,
                                               QTreeWidgetItem *_parent)
 {
+  if (_parent == this->dataPtr->modelsItem)
+  {
+    auto iter = this->dataPtr->modelItems.find(_name);
+    if (iter != this->dataPtr->modelItems.end())
+      return iter->second;
+
+    iter = this->dataPtr->childItems.find(_name);
+    if (iter != this->dataPtr->childItems.end())
+      return iter->second;
+
+    // The name may be a link or joint of a model that wasn't expanded yet
+    iter = this->dataPtr->modelItems.find(_name.substr(0, _name.find("::")));
+    if (iter != this->dataPtr->modelItems.end() &&
+        this->dataPtr->unpopulatedItems.count(iter->second))
+    {
+      this->PopulateModelItem(iter->second);
+      iter = this->dataPtr->childItems.find(_name);
+      if (iter != this->dataPtr->childItems.end())
+        return iter->second;
+    }
+    return nullptr;
+  }
+
   QTreeWidgetItem *listItem = nullptr;
 
   // Find an existing element with the name from the message
@@ -661,8 +770,7 @@ void ModelListWidget::OnCustomContextMenu(const QPoint &_pt)
     return;
 
   // Check to see if the selected item is a model
-  int i = this->dataPtr->modelsItem->indexOfChild(item);
-  if (i >= 0)
+  if (item->parent() == this->dataPtr->modelsItem)
   {
     g_modelRightMenu->Run(item->text(0).toStdString(),
                           this->dataPtr->modelTreeWidget->mapToGlobal(_pt),
@@ -671,8 +779,7 @@ void ModelListWidget::OnCustomContextMenu(const QPoint &_pt)
   }
 
   // Check to see if the selected item is a light
-  i = this->dataPtr->lightsItem->indexOfChild(item);
-  if (i >= 0)
+  if (item->parent() == this->dataPtr->lightsItem)
   {
     g_modelRightMenu->Run(item->text(0).toStdString(),
                           this->dataPtr->modelTreeWidget->mapToGlobal(_pt),
@@ -717,10 +824,11 @@ void ModelListWidget::OnPropertyChanged(QtProperty *_item)
   if (!currentItem)
     return;
 
-  if (this->dataPtr->modelsItem->indexOfChild(currentItem) != -1 ||
-      this->dataPtr->modelsItem->indexOfChild(currentItem->parent()) != -1)
+  QTreeWidgetItem *parentItem = currentItem->parent();
+  if (parentItem == this->dataPtr->modelsItem ||
+      (parentItem && parentItem->parent() == this->dataPtr->modelsItem))
     this->ModelPropertyChanged(_item);
-  else if (this->dataPtr->lightsItem->indexOfChild(currentItem) != -1)
+  else if (parentItem == this->dataPtr->lightsItem)
     this->LightPropertyChanged(_item);
   else if (currentItem == this->dataPtr->sceneItem)
     this->ScenePropertyChanged(_item);
@@ -2896,6 +3004,9 @@ void ModelListWidget::InitTransport(const std::string &_name)
 void ModelListWidget::ResetTree()
 {
   this->dataPtr->modelTreeWidget->clear();
+  this->dataPtr->modelItems.clear();
+  this->dataPtr->childItems.clear();
+  this->dataPtr->unpopulatedItems.clear();
 
   // Create the top level of items in the tree widget
   {
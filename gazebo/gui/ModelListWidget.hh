@@ -49,6 +49,10 @@ namespace gazebo
       private slots: void OnPropertyChanged(QtProperty *_item);
       private slots: void OnCustomContextMenu(const QPoint &_pt);
       private slots: void OnCurrentPropertyChanged(QtBrowserItem *_item);
+
+      /// \brief Create the children of a model item when it is expanded.
+      /// \param[in] _item Expanded item.
+      private slots: void OnItemExpanded(QTreeWidgetItem *_item);
       private: void OnSetSelectedEntity(const std::string &_name,
                                         const std::string &_mode);
       private: void OnResponse(ConstResponsePtr &_msg);
@@ -112,6 +116,15 @@ namespace gazebo
 
       private: void RemoveEntity(const std::string &_name);
 
+      /// \brief Create the link, joint and plugin items of a model item, if
+      /// they weren't created yet.
+      /// \param[in] _item Model item.
+      private: void PopulateModelItem(QTreeWidgetItem *_item);
+
+      /// \brief Delete a model item and forget about its children.
+      /// \param[in] _item Model item.
+      private: void RemoveModelItem(QTreeWidgetItem *_item);
+
       private: QTreeWidgetItem *ListItem(const std::string &_name,
                                          QTreeWidgetItem *_parent);
 
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <list>
+#include <unordered_map>
 #include <vector>
 #include <deque>
 #include <sdf/sdf.hh>
@@ -102,6 +103,34 @@ namespace gazebo
       typedef std::list<std::string> RemoveEntity_L;
       public: RemoveEntity_L removeEntityList;
 
+      /// \brief Names of the links, joints and plugins of a model, kept
+      /// until its tree item is first expanded.
+      public: class ModelChildren
+      {
+        /// \brief Model id.
+        public: uint32_t id = 0;
+
+        /// \brief Scoped link names.
+        public: std::vector<std::string> links;
+
+        /// \brief Scoped joint names.
+        public: std::vector<std::string> joints;
+
+        /// \brief Plugin names.
+        public: std::vector<std::string> plugins;
+      };
+
+      /// \brief Model tree items by model name.
+      public: std::unordered_map<std::string, QTreeWidgetItem *> modelItems;
+
+      /// \brief Link, joint and plugin tree items by the name in their
+      /// data.
+      public: std::unordered_map<std::string, QTreeWidgetItem *> childItems;
+
+      /// \brief Children of the model tree items that weren't created yet.
+      public: std::unordered_map<QTreeWidgetItem *, ModelChildren>
+              unpopulatedItems;
+
       public: msgs::Model modelMsg;
       public: msgs::Link linkMsg;
       public: msgs::Scene sceneMsg;
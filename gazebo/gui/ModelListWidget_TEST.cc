@@ -16,7 +16,10 @@
 */
 #include <boost/filesystem.hpp>
 #include <memory>
+#include <sstream>
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/PhysicsIface.hh"
+#include "gazebo/physics/World.hh"
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/gui/GuiEvents.hh"
 #include "gazebo/gui/GuiIface.hh"
@@ -377,6 +380,100 @@ void ModelListWidget_TEST::ModelsTree()
   modelListWidget = nullptr;
 }
 
+/////////////////////////////////////////////////
+void ModelListWidget_TEST::ManyModels()
+{
+  this->Load("worlds/empty.world", true);
+
+  gazebo::gui::ModelListWidget *modelListWidget
+      = new gazebo::gui::ModelListWidget;
+  QCoreApplication::processEvents();
+
+  QTreeWidget *modelTreeWidget = modelListWidget->findChild<QTreeWidget *>(
+      "modelTreeWidget");
+  QVERIFY(modelTreeWidget != nullptr);
+  QList<QTreeWidgetItem *> treeModelItems =
+      modelTreeWidget->findItems(tr("Models"), Qt::MatchExactly);
+  QCOMPARE(treeModelItems.size(), 1);
+  QTreeWidgetItem *modelsItem = treeModelItems.front();
+  QVERIFY(modelsItem != nullptr);
+
+  // More models than the widget processes in one update
+  gazebo::physics::WorldPtr world = gazebo::physics::get_world("default");
+  QVERIFY(world != nullptr);
+  const int count = 1100;
+  for (int i = 0; i < count; ++i)
+  {
+    std::ostringstream modelStr;
+    modelStr << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='model_" << i << "'>"
+      << "  <pose>" << i << " 0 0 0 0 0</pose>"
+      << "  <link name='link'/>"
+      << "  <joint name='joint' type='fixed'>"
+      << "    <parent>world</parent>"
+      << "    <child>link</child>"
+      << "  </joint>"
+      << "</model>"
+      << "</sdf>";
+    world->InsertModelString(modelStr.str());
+  }
+
+  // The models and the ground plane are listed
+  int sleep = 0;
+  int maxSleep = 120;
+  while (modelsItem->childCount() < count + 1 && sleep < maxSleep)
+  {
+    QCoreApplication::processEvents();
+    QTest::qWait(500);
+    sleep++;
+  }
+  QCOMPARE(modelsItem->childCount(), count + 1);
+
+  QList<QTreeWidgetItem *> items = modelTreeWidget->findItems(
+      tr("model_0"), Qt::MatchExactly | Qt::MatchRecursive);
+  QCOMPARE(items.size(), 1);
+  QTreeWidgetItem *modelItem = items.front();
+
+  // The link and joint items are created when the model is expanded
+  QCOMPARE(modelItem->childCount(), 0);
+  QCOMPARE(modelItem->childIndicatorPolicy(),
+      QTreeWidgetItem::ShowIndicator);
+  modelTreeWidget->expandItem(modelItem);
+  QCoreApplication::processEvents();
+  QCOMPARE(modelItem->childCount(), 4);
+  QCOMPARE(modelItem->child(0)->text(0), tr("LINKS"));
+  QCOMPARE(modelItem->child(1)->text(0), tr("link"));
+  QCOMPARE(modelItem->child(1)->data(0, Qt::UserRole).toString(),
+      tr("model_0::link"));
+  QCOMPARE(modelItem->child(2)->text(0), tr("JOINTS"));
+  QCOMPARE(modelItem->child(3)->text(0), tr("joint"));
+
+  // Expanding it again doesn't add children
+  modelTreeWidget->collapseItem(modelItem);
+  modelTreeWidget->expandItem(modelItem);
+  QCoreApplication::processEvents();
+  QCOMPARE(modelItem->childCount(), 4);
+
+  // Removed models leave the tree, whether they were expanded or not
+  world->RemoveModel("model_0");
+  world->RemoveModel("model_1");
+  sleep = 0;
+  maxSleep = 20;
+  while (modelsItem->childCount() > count - 1 && sleep < maxSleep)
+  {
+    QCoreApplication::processEvents();
+    QTest::qWait(500);
+    sleep++;
+  }
+  QCOMPARE(modelsItem->childCount(), count - 1);
+  QVERIFY(modelTreeWidget->findItems(tr("model_0"),
+      Qt::MatchExactly | Qt::MatchRecursive).empty());
+  QVERIFY(modelTreeWidget->findItems(tr("model_1"),
+      Qt::MatchExactly | Qt::MatchRecursive).empty());
+
+  delete modelListWidget;
+}
+
 /////////////////////////////////////////////////
 void ModelListWidget_TEST::ModelProperties()
 {
@@ -103,6 +103,11 @@ class ModelListWidget_TEST : public QTestFixture
   /// \brief Test that the model widget item contains all models in the world.
   private slots: void ModelsTree();
 
+  /// \brief Test that a world with more models than are processed in one
+  /// update is listed, and that the children of a model are only created
+  /// when it is expanded.
+  private slots: void ManyModels();
+
   /// \brief Test that the property browser displays correct model properties.
   /// The test then modifies the properties, refresh the property browser, and
   /// verify the changes are set.
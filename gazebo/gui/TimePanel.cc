@@ -15,6 +15,7 @@
  *
  */
 #include <functional>
+#include <iomanip>
 #include <mutex>
 #include <sstream>
 
@@ -256,6 +257,25 @@ void TimePanel::OnStats(ConstWorldStatisticsPtr &_msg)
     // Set the iterations
     this->dataPtr->timeWidget->EmitSetIterations(QString::fromStdString(
         boost::lexical_cast<std::string>(_msg->iterations())));
+
+    // Set the phase times, shown when hovering the real time factor
+    if (_msg->has_phase_times())
+    {
+      const msgs::WorldStatistics::PhaseTimes &phases = _msg->phase_times();
+      std::ostringstream stream;
+      stream << std::fixed << std::setprecision(3)
+        << "Wall time per iteration (ms)"
+        << "\nMessages: " << phases.message_processing() * 1e3
+        << "\nModels: " << phases.model_update() * 1e3
+        << "\nCollision: " << phases.collision() * 1e3
+        << "\nPhysics: " << phases.physics() * 1e3
+        << "\nDirty poses: " << phases.dirty_poses() * 1e3
+        << "\nContacts: " << phases.contact_publish() * 1e3
+        << "\nLogging: " << phases.logging() * 1e3
+        << "\nSensors: " << phases.sensor_wait() * 1e3;
+      this->dataPtr->timeWidget->EmitSetPhaseTimes(
+          QString::fromStdString(stream.str()));
+    }
   }
   else if (this->dataPtr->logPlayWidget->isVisible())
   {
@@ -187,6 +187,11 @@ TimeWidget::TimeWidget(QWidget *_parent)
   // This is used for thread safety.
   connect(this, SIGNAL(SetRealTime(QString)), this->dataPtr->realTimeEdit,
       SLOT(setText(QString)), Qt::QueuedConnection);
+
+  // Create a QueuedConnection to set the phase times.
+  // This is used for thread safety.
+  connect(this, SIGNAL(SetPhaseTimes(QString)), this,
+      SLOT(OnSetPhaseTimes(QString)), Qt::QueuedConnection);
 }
 
 /////////////////////////////////////////////////
@@ -301,6 +306,18 @@ void TimeWidget::EmitSetFPS(QString _time)
   this->SetFPS(_time);
 }
 
+/////////////////////////////////////////////////
+void TimeWidget::EmitSetPhaseTimes(QString _string)
+{
+  this->SetPhaseTimes(_string);
+}
+
+/////////////////////////////////////////////////
+void TimeWidget::OnSetPhaseTimes(QString _string)
+{
+  this->dataPtr->percentRealTimeEdit->setToolTip(_string);
+}
+
 /////////////////////////////////////////////////
 void TimeWidget::SetPercentRealTimeEdit(QString _text)
 {
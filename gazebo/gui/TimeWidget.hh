@@ -88,6 +88,11 @@ namespace gazebo
       /// \param[in] _string String representation of average FPS.
       public: void EmitSetFPS(QString _string);
 
+      /// \brief Emit a signal used to set the tooltip of the real time
+      /// factor with the phase times of the world update.
+      /// \param[in] _string Description of the phase times.
+      public: void EmitSetPhaseTimes(QString _string);
+
       /// \brief A signal used to set the sim time line edit.
       /// \param[in] _string String representation of real time factor.
       public: void SetPercentRealTimeEdit(QString _text);
@@ -115,6 +120,14 @@ namespace gazebo
       /// \param[in] _string String representation of avg fps.
       signals: void SetFPS(QString _string);
 
+      /// \brief A signal used to set the tooltip of the real time factor.
+      /// \param[in] _string Description of the phase times.
+      signals: void SetPhaseTimes(QString _string);
+
+      /// \brief Qt callback to set the tooltip of the real time factor.
+      /// \param[in] _string Description of the phase times.
+      private slots: void OnSetPhaseTimes(QString _string);
+
       /// \internal
       /// \brief Pointer to private data.
       private: TimeWidgetPrivate *dataPtr;
@@ -684,6 +684,10 @@ void BuildingMaker::GenerateSDF()
   std::stringstream visualNameStream;
   std::stringstream collisionNameStream;
 
+  // Apply the size changes still queued by the editor
+  for (auto const &itemsIt : this->dataPtr->allItems)
+    itemsIt.second->ApplySize();
+
   modelElem->GetAttribute("name")->Set(this->dataPtr->folderName);
   auto modelOrigin = ignition::math::Pose3d::Zero;
   if (this->dataPtr->previewVisual)
@@ -1030,6 +1034,10 @@ void BuildingMaker::GenerateSDFWithCSG()
   std::stringstream visualNameStream;
   std::stringstream collisionNameStream;
 
+  // Apply the size changes still queued by the editor
+  for (auto const &itemsIt : this->dataPtr->allItems)
+    itemsIt.second->ApplySize();
+
   modelElem->GetAttribute("name")->Set(this->dataPtr->folderName);
 
   for (auto itemsIt : this->dataPtr->allItems)
@@ -15,12 +15,16 @@
  *
 */
 
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/rendering/Visual.hh"
 #include "gazebo/gui/qt.h"
 #include "gazebo/gui/GuiIface.hh"
 #include "gazebo/gui/MainWindow.hh"
 #include "gazebo/gui/building/BuildingEditorEvents.hh"
 #include "gazebo/gui/building/BuildingMaker.hh"
 #include "gazebo/gui/building/BuildingMaker_TEST.hh"
+#include "gazebo/gui/building/BuildingModelManip.hh"
 
 #include "test_config.h"
 
@@ -137,5 +141,70 @@ void BuildingMaker_TEST::Layers()
   delete mainWindow;
 }
 
+/////////////////////////////////////////////////
+void BuildingMaker_TEST::QueuedSize()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  // Load an empty world
+  this->Load("worlds/empty.world", false, false, false);
+
+  // Create the main window.
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != NULL);
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  // Create a building maker
+  auto buildingMaker = new gazebo::gui::BuildingMaker();
+  QVERIFY(buildingMaker != NULL);
+
+  // Add a wall 1m wide, 0.2m deep and 2.5m high
+  auto wall = buildingMaker->AddWall(QVector3D(100, 20, 250),
+      QVector3D(0, 0, 0), 0);
+  auto manip = buildingMaker->ManipByName(wall);
+  QVERIFY(manip != NULL);
+  auto vis = manip->Visual();
+  QVERIFY(vis != NULL);
+  QVERIFY(vis->Scale() == ignition::math::Vector3d(1, 0.2, 2.5));
+  QVERIFY(ignition::math::equal(vis->Position().Z(), 1.25));
+
+  // The editor item emits one signal per dimension. None of them touches
+  // the visual until the event loop runs.
+  QVERIFY(QMetaObject::invokeMethod(manip, "OnWidthChanged",
+      Qt::DirectConnection, Q_ARG(double, 300)));
+  QVERIFY(QMetaObject::invokeMethod(manip, "OnHeightChanged",
+      Qt::DirectConnection, Q_ARG(double, 100)));
+  QVERIFY(vis->Scale() == ignition::math::Vector3d(1, 0.2, 2.5));
+
+  // Both changes are applied, keeping the bottom of the wall in place
+  QCoreApplication::processEvents();
+  QVERIFY(vis->Scale() == ignition::math::Vector3d(3, 0.2, 1));
+  QVERIFY(ignition::math::equal(vis->Position().Z(), 0.5));
+
+  // Generating the SDF applies the changes still queued
+  QVERIFY(QMetaObject::invokeMethod(manip, "OnDepthChanged",
+      Qt::DirectConnection, Q_ARG(double, 50)));
+  buildingMaker->GenerateSDF();
+
+  sdf::SDF sdf;
+  sdf.SetFromString(buildingMaker->ModelSDF());
+  QVERIFY(sdf.Root() != NULL);
+  QVERIFY(sdf.Root()->HasElement("model"));
+  auto link = sdf.Root()->GetElement("model")->GetElement("link");
+  QVERIFY(link != NULL);
+  auto size = link->GetElement("visual")->GetElement("geometry")
+      ->GetElement("box")->Get<ignition::math::Vector3d>("size");
+  QVERIFY(size == ignition::math::Vector3d(3, 0.5, 1));
+  QVERIFY(vis->Scale() == size);
+
+  delete buildingMaker;
+  delete mainWindow;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(BuildingMaker_TEST)
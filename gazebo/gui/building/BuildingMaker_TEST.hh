@@ -33,6 +33,9 @@ class BuildingMaker_TEST : public QTestFixture
 
   /// \brief Test attaching and detaching manips.
   private slots: void Attach();
+
+  /// \brief Test that the size changes of an edit are applied together.
+  private slots: void QueuedSize();
 };
 
 #endif
@@ -100,13 +100,9 @@ void BuildingModelManip::SetMaker(BuildingMaker *_maker)
 void BuildingModelManip::OnSizeChanged(double _width, double _depth,
     double _height)
 {
+  this->QueueSize();
   this->dataPtr->size =
       BuildingMaker::ConvertSize(_width, _depth, _height);
-  double dScaleZ = this->dataPtr->visual->Scale().Z() - this->dataPtr->size.Z();
-  this->dataPtr->visual->SetScale(this->dataPtr->size);
-  auto originalPos = this->dataPtr->visual->Position();
-  auto newPos = originalPos - ignition::math::Vector3d(0, 0, dScaleZ/2.0);
-  this->dataPtr->visual->SetPosition(newPos);
   this->dataPtr->maker->BuildingChanged();
 }
 
@@ -148,9 +144,8 @@ void BuildingModelManip::OnPositionChanged(double _x, double _y, double _z)
 void BuildingModelManip::OnWidthChanged(double _width)
 {
   double scaledWidth = BuildingMaker::Convert(_width);
-  this->dataPtr->size = this->dataPtr->visual->Scale();
+  this->QueueSize();
   this->dataPtr->size.X(scaledWidth);
-  this->dataPtr->visual->SetScale(this->dataPtr->size);
   this->dataPtr->maker->BuildingChanged();
 }
 
@@ -158,9 +153,8 @@ void BuildingModelManip::OnWidthChanged(double _width)
 void BuildingModelManip::OnDepthChanged(double _depth)
 {
   double scaledDepth = BuildingMaker::Convert(_depth);
-  this->dataPtr->size = this->dataPtr->visual->Scale();
+  this->QueueSize();
   this->dataPtr->size.Y(scaledDepth);
-  this->dataPtr->visual->SetScale(this->dataPtr->size);
   this->dataPtr->maker->BuildingChanged();
 }
 
@@ -168,15 +162,8 @@ void BuildingModelManip::OnDepthChanged(double _depth)
 void BuildingModelManip::OnHeightChanged(double _height)
 {
   double scaledHeight = BuildingMaker::Convert(_height);
-  this->dataPtr->size = this->dataPtr->visual->Scale();
+  this->QueueSize();
   this->dataPtr->size.Z(scaledHeight);
-  auto dScale = this->dataPtr->visual->Scale() - this->dataPtr->size;
-  auto originalPos = this->dataPtr->visual->Position();
-  this->dataPtr->visual->SetScale(this->dataPtr->size);
-
-  auto newPos = originalPos - ignition::math::Vector3d(0, 0, dScale.Z()/2.0);
-
-  this->dataPtr->visual->SetPosition(newPos);
   this->dataPtr->maker->BuildingChanged();
 }
 
@@ -296,6 +283,8 @@ void BuildingModelManip::SetRotation(double _roll, double _pitch, double _yaw)
 /////////////////////////////////////////////////
 void BuildingModelManip::SetSize(double _width, double _depth, double _height)
 {
+  this->ApplySize();
+
   this->dataPtr->size = BuildingMaker::ConvertSize(_width, _depth, _height);
 
   auto dScale = this->dataPtr->visual->Scale() - this->dataPtr->size;
@@ -310,6 +299,33 @@ void BuildingModelManip::SetSize(double _width, double _depth, double _height)
   this->dataPtr->visual->SetPosition(newPos);
 }
 
+/////////////////////////////////////////////////
+void BuildingModelManip::QueueSize()
+{
+  if (this->dataPtr->sizePending)
+    return;
+
+  // Start from the size of the visual, which may have been scaled directly
+  this->dataPtr->size = this->dataPtr->visual->Scale();
+  this->dataPtr->sizePending = true;
+  QTimer::singleShot(0, this, SLOT(ApplySize()));
+}
+
+/////////////////////////////////////////////////
+void BuildingModelManip::ApplySize()
+{
+  if (!this->dataPtr->sizePending)
+    return;
+  this->dataPtr->sizePending = false;
+
+  // Keep the bottom of the visual in place when its height changes
+  double dScaleZ = this->dataPtr->visual->Scale().Z() - this->dataPtr->size.Z();
+  auto originalPos = this->dataPtr->visual->Position();
+  this->dataPtr->visual->SetScale(this->dataPtr->size);
+  this->dataPtr->visual->SetPosition(
+      originalPos - ignition::math::Vector3d(0, 0, dScaleZ/2.0));
+}
+
 /////////////////////////////////////////////////
 void BuildingModelManip::SetColor(QColor _color)
 {
@@ -244,9 +244,18 @@ namespace gazebo
       /// \param[in] _transparency Transparency.
       private slots: void OnTransparencyChanged(float _transparency);
 
+      /// \brief Apply the size changes queued by the editor item to the
+      /// visual. Resizing the visual updates the SDF of its geometry, so the
+      /// several size signals of a single edit are applied together.
+      public slots: void ApplySize();
+
       /// \brief Qt callback when the associated editor item has been deleted.
       private slots: void OnDeleted();
 
+      /// \brief Queue a size change, to be applied on the next turn of the
+      /// event loop.
+      private: void QueueSize();
+
       /// \brief Callback received when the building level being edited has
       /// changed. Do not confuse with OnLevelChange, where the manip's level
       /// is changed.
@@ -49,6 +49,10 @@ namespace gazebo
       /// \brief Size of the manipular.
       public: ignition::math::Vector3d size;
 
+      /// \brief True if the size has changed since it was last applied to
+      /// the visual.
+      public: bool sizePending = false;
+
       /// \brief Pose of the manip.
       public: ignition::math::Pose3d pose;
 
@@ -224,6 +224,27 @@ using namespace gui;
 const std::string ModelCreatorPrivate::modelDefaultName = "Untitled";
 const std::string ModelCreatorPrivate::previewName = "ModelPreview";
 
+/////////////////////////////////////////////////
+/// \brief Find the entry of an entity, or of the parent of the entity, in a
+/// map of the parts of the model. The parent is looked up first, so that a
+/// visual of a link finds the link.
+/// \param[in] _parts Map of the parts of the model, by name.
+/// \param[in] _name Scoped name of the entity.
+/// \return Iterator to the entry, or _parts.end() if neither is a part.
+template<typename T>
+static typename std::map<std::string, T>::iterator FindPart(
+    std::map<std::string, T> &_parts, const std::string &_name)
+{
+  size_t pos = _name.rfind("::");
+  if (pos != std::string::npos)
+  {
+    auto it = _parts.find(_name.substr(0, pos));
+    if (it != _parts.end())
+      return it;
+  }
+  return _parts.find(_name);
+}
+
 /////////////////////////////////////////////////
 ModelCreator::ModelCreator(QObject *_parent)
   : QObject(_parent),
@@ -3073,35 +3094,27 @@ void ModelCreator::OnEntityScaleChanged(const std::string &_name,
   const ignition::math::Vector3d &/*_scale*/)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->updateMutex);
-  for (auto linksIt : this->dataPtr->allLinks)
-  {
-    std::string linkName;
-    size_t pos = _name.rfind("::");
-    if (pos != std::string::npos)
-      linkName = _name.substr(0, pos);
-    if (_name == linksIt.first || linkName == linksIt.first)
-    {
-      // Update inspector according to visual size
-      linksIt.second->UpdateInspectorScale();
+  auto linksIt = FindPart(this->dataPtr->allLinks, _name);
+  if (linksIt == this->dataPtr->allLinks.end())
+    return;
 
-      // Queue to only register command once it is finalized
-      auto linkVis = linksIt.second->LinkVisual();
-      std::map<std::string, ignition::math::Vector3d> scales;
-      for (unsigned int i = 0; i < linkVis->GetChildCount(); ++i)
-      {
-        auto child = linkVis->GetChild(i);
-        if (child->GetType() == rendering::Visual::VT_GUI ||
-            child->GetType() == rendering::Visual::VT_PHYSICS)
-          continue;
+  // Update inspector according to visual size
+  linksIt->second->UpdateInspectorScale();
 
-        // Add to map of scales to update
-        scales[child->Name()] = linkVis->GetChild(i)->GetGeometrySize();
-      }
-      this->dataPtr->linkScaleUpdate[linksIt.second] = scales;
+  // Queue to only register command once it is finalized
+  auto linkVis = linksIt->second->LinkVisual();
+  std::map<std::string, ignition::math::Vector3d> scales;
+  for (unsigned int i = 0; i < linkVis->GetChildCount(); ++i)
+  {
+    auto child = linkVis->GetChild(i);
+    if (child->GetType() == rendering::Visual::VT_GUI ||
+        child->GetType() == rendering::Visual::VT_PHYSICS)
+      continue;
 
-      break;
-    }
+    // Add to map of scales to update
+    scales[child->Name()] = linkVis->GetChild(i)->GetGeometrySize();
   }
+  this->dataPtr->linkScaleUpdate[linksIt->second] = scales;
 }
 
 /////////////////////////////////////////////////
@@ -3109,74 +3122,64 @@ void ModelCreator::OnEntityMoved(const std::string &_name,
   const ignition::math::Pose3d &_pose, const bool _isFinal)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->updateMutex);
-  for (auto linksIt : this->dataPtr->allLinks)
+  auto linksIt = FindPart(this->dataPtr->allLinks, _name);
+  if (linksIt != this->dataPtr->allLinks.end())
   {
-    std::string linkName;
-    size_t pos = _name.rfind("::");
-    if (pos != std::string::npos)
-      linkName = _name.substr(0, pos);
-    if (_name == linksIt.first || linkName == linksIt.first)
+    LinkData *link = linksIt->second;
+
+    // Register user command
+    if (_isFinal)
     {
-      // Register user command
-      if (_isFinal)
-      {
-        auto cmd = this->dataPtr->userCmdManager->NewCmd(
-            "Move [" + linksIt.second->Name() + "]", MEUserCmd::MOVING_LINK);
-        cmd->SetScopedName(linksIt.second->LinkVisual()->Name());
+      auto cmd = this->dataPtr->userCmdManager->NewCmd(
+          "Move [" + link->Name() + "]", MEUserCmd::MOVING_LINK);
+      cmd->SetScopedName(link->LinkVisual()->Name());
 
-        auto localPose = this->WorldToLocal(_pose);
-        cmd->SetPoseChange(linksIt.second->Pose(), localPose);
-        linksIt.second->SetPose(localPose);
-        this->ModelChanged();
-      }
-      // Only register command on MouseRelease
-      else
-      {
-        // Get local pose
-        auto linkLocalPose = this->WorldToLocal(_pose);
+      auto localPose = this->WorldToLocal(_pose);
+      cmd->SetPoseChange(link->Pose(), localPose);
+      link->SetPose(localPose);
+      this->ModelChanged();
+    }
+    // Only register command on MouseRelease
+    else
+    {
+      // Get local pose
+      auto linkLocalPose = this->WorldToLocal(_pose);
 
-        // Update inspector only
-        linksIt.second->inspector->GetLinkConfig()->SetPose(linkLocalPose);
+      // Update inspector only
+      link->inspector->GetLinkConfig()->SetPose(linkLocalPose);
 
-        // Queue to register command once it is finalized
-        this->dataPtr->linkPoseUpdate[linksIt.second] = linkLocalPose;
-      }
-      break;
+      // Queue to register command once it is finalized
+      this->dataPtr->linkPoseUpdate[link] = linkLocalPose;
     }
   }
-  for (auto nestedModelsIt : this->dataPtr->allNestedModels)
+
+  auto nestedModelsIt = FindPart(this->dataPtr->allNestedModels, _name);
+  if (nestedModelsIt != this->dataPtr->allNestedModels.end())
   {
-    std::string nestedModelName;
-    size_t pos = _name.rfind("::");
-    if (pos != std::string::npos)
-      nestedModelName = _name.substr(0, pos);
-    if (_name == nestedModelsIt.first ||
-        nestedModelName == nestedModelsIt.first)
+    NestedModelData *nestedModel = nestedModelsIt->second;
+
+    // Register user command
+    if (_isFinal)
     {
-      // Register user command
-      if (_isFinal)
-      {
-        auto cmd = this->dataPtr->userCmdManager->NewCmd(
-            "Move [" + nestedModelsIt.second->Name() + "]",
-            MEUserCmd::MOVING_NESTED_MODEL);
-        cmd->SetScopedName(nestedModelsIt.second->modelVisual->Name());
-
-        auto localPose = this->WorldToLocal(_pose);
-        cmd->SetPoseChange(nestedModelsIt.second->Pose(), localPose);
-        nestedModelsIt.second->SetPose(localPose);
-        this->ModelChanged();
-      }
-      // Only register command on MouseRelease
-      else
-      {
-        // Get local pose
-        auto nestedModelLocalPose = this->WorldToLocal(_pose);
+      auto cmd = this->dataPtr->userCmdManager->NewCmd(
+          "Move [" + nestedModel->Name() + "]",
+          MEUserCmd::MOVING_NESTED_MODEL);
+      cmd->SetScopedName(nestedModel->modelVisual->Name());
+
+      auto localPose = this->WorldToLocal(_pose);
+      cmd->SetPoseChange(nestedModel->Pose(), localPose);
+      nestedModel->SetPose(localPose);
+      this->ModelChanged();
+    }
+    // Only register command on MouseRelease
+    else
+    {
+      // Get local pose
+      auto nestedModelLocalPose = this->WorldToLocal(_pose);
 
-        // Queue to register command once it is finalized
-        this->dataPtr->nestedModelPoseUpdate[nestedModelsIt.second] =
-            nestedModelLocalPose;
-      }
-      break;
+      // Queue to register command once it is finalized
+      this->dataPtr->nestedModelPoseUpdate[nestedModel] =
+          nestedModelLocalPose;
     }
   }
 }
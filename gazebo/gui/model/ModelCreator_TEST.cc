@@ -705,5 +705,85 @@ void ModelCreator_TEST::CopyPaste()
   mainWindow = NULL;
 }
 
+/////////////////////////////////////////////////
+void ModelCreator_TEST::MoveEntity()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world", false, false, false);
+
+  // Create the main window.
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != NULL);
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  // Create a model creator
+  gui::ModelCreator *modelCreator = new gui::ModelCreator();
+  QVERIFY(modelCreator != NULL);
+
+  // a link
+  gui::LinkData *link =
+      modelCreator->AddShape(gui::ModelCreator::ENTITY_BOX);
+  QVERIFY(link != NULL);
+  QCOMPARE(link->LinkVisual()->Name(),
+      std::string("ModelPreview_0_0::link_0"));
+  QVERIFY(link->LinkVisual()->GetChildCount() > 0u);
+
+  // a nested model
+  msgs::Model model;
+  model.set_name("box_model");
+  msgs::AddBoxLink(model, 1.0, ignition::math::Vector3d::One);
+  gui::NestedModelData *nestedModel =
+      modelCreator->AddModel(msgs::ModelToSDF(model));
+  QVERIFY(nestedModel != NULL);
+  QCOMPARE(nestedModel->modelVisual->Name(),
+      std::string("ModelPreview_0_0::box_model"));
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  auto nestedModelPose = nestedModel->Pose();
+
+  // Move the link by its name
+  ignition::math::Pose3d pose(1, 2, 3, 0, 0, 0.5);
+  gazebo::gui::Events::moveEntity(link->LinkVisual()->Name(), pose, true);
+  QVERIFY(link->Pose() == modelCreator->WorldToLocal(pose));
+  QVERIFY(nestedModel->Pose() == nestedModelPose);
+
+  // Move the link by the name of one of its visuals
+  pose.Set(-1, 0, 2, 0, 0, 0);
+  gazebo::gui::Events::moveEntity(link->LinkVisual()->GetChild(0)->Name(),
+      pose, true);
+  QVERIFY(link->Pose() == modelCreator->WorldToLocal(pose));
+  QVERIFY(nestedModel->Pose() == nestedModelPose);
+
+  // Move the nested model, which doesn't move the link
+  auto linkPose = link->Pose();
+  pose.Set(0, 4, 1, 0, 0, 1.0);
+  gazebo::gui::Events::moveEntity(nestedModel->modelVisual->Name(), pose,
+      true);
+  QVERIFY(nestedModel->Pose() == modelCreator->WorldToLocal(pose));
+  QVERIFY(link->Pose() == linkPose);
+
+  // Unknown entities are ignored
+  nestedModelPose = nestedModel->Pose();
+  gazebo::gui::Events::moveEntity("ModelPreview_0_0::link_00",
+      ignition::math::Pose3d(5, 5, 5, 0, 0, 0), true);
+  gazebo::gui::Events::scaleEntity("ModelPreview_0_0::link_00",
+      ignition::math::Vector3d(2, 2, 2));
+  QVERIFY(link->Pose() == linkPose);
+  QVERIFY(nestedModel->Pose() == nestedModelPose);
+
+  delete modelCreator;
+  modelCreator = NULL;
+  mainWindow->close();
+  delete mainWindow;
+  mainWindow = NULL;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(ModelCreator_TEST)
@@ -42,6 +42,9 @@ class ModelCreator_TEST : public QTestFixture
 
   // \brief Test copy and pasting entites in the model editor.
   private slots: void CopyPaste();
+
+  /// \brief Test moving links and nested models by their scoped names.
+  private slots: void MoveEntity();
 };
 
 #endif
@@ -14,7 +14,12 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <ignition/math/Color.hh>
 
 #include "gazebo/common/Assert.hh"
@@ -23,10 +28,15 @@
 #include "gazebo/gui/plot/qwt_gazebo.h"
 #include "gazebo/gui/plot/IncrementalPlot.hh"
 #include "gazebo/gui/plot/PlotCurve.hh"
+#include "gazebo/gui/plot/PlotRecorder.hh"
 
 using namespace gazebo;
 using namespace gui;
 
+/// \brief Maximum number of points kept by a curve. The oldest points are
+/// dropped first.
+static const size_t MAX_SAMPLE_SIZE = 11000;
+
 namespace gazebo
 {
   namespace gui
@@ -45,13 +55,35 @@ namespace gazebo
           Colors[ColorGroupCount][ColorCount];
     };
 
-    /// \brief A class that manages curve data
-    class CurveData: public QwtArraySeriesData<QPointF>
+    /// \brief Curve data, kept in a ring buffer of bounded size.
+    ///
+    /// Points are usually added by the topic and introspection callbacks,
+    /// which run in transport threads. They're buffered and moved to the
+    /// ring buffer by Flush, on the GUI thread, so that Qwt can read the
+    /// samples without locking.
+    class CurveData: public QwtSeriesData<QPointF>
     {
       public: CurveData()
-              {}
+              {
+                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+              }
 
-      /// \brief Add a point to the sample.
+      /// \brief Get the number of samples.
+      /// \return Number of samples.
+      public: virtual size_t size() const
+              {
+                return this->samples.size();
+              }
+
+      /// \brief Get a sample, the oldest one being at index 0.
+      /// \param[in] _i Sample index.
+      /// \return Sample.
+      public: virtual QPointF sample(size_t _i) const
+              {
+                return this->samples[(this->start + _i) % this->samples.size()];
+              }
+
+      /// \brief Get the bounding box of the samples.
       /// \return Bounding box of the sample.
       public: virtual QRectF boundingRect() const
               {
@@ -75,24 +107,82 @@ namespace gazebo
                 return this->d_boundingRect;
               }
 
-      /// \brief Add a point to the sample.
+      /// \brief Add a point to the sample. This can be called from any
+      /// thread; the point is part of the samples after the next Flush.
       /// \param[in] _point Point to add.
-      public: inline void Add(const QPointF &_point)
+      public: void Add(const QPointF &_point)
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->pending.push_back(_point);
+
+                // Don't grow while nothing flushes, e.g. when the plot is
+                // hidden.
+                if (this->pending.size() > MAX_SAMPLE_SIZE)
+                  this->pending.pop_front();
+              }
+
+      /// \brief Move the points added since the last call to the samples.
+      /// Must be called from the thread that draws the curve.
+      public: void Flush()
+              {
+                std::deque<QPointF> points;
+                {
+                  std::lock_guard<std::mutex> lock(this->mutex);
+                  if (this->pending.empty())
+                    return;
+                  points.swap(this->pending);
+                }
+
+                for (const auto &point : points)
+                  this->Append(point);
+              }
+
+      /// \brief Clear the sample data.
+      public: void Clear()
               {
-                this->d_samples += _point;
+                {
+                  std::lock_guard<std::mutex> lock(this->mutex);
+                  this->pending.clear();
+                }
+                std::vector<QPointF>().swap(this->samples);
+                this->start = 0;
+                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+              }
 
-                if (this->d_samples.size() > maxSampleSize)
+      /// \brief Append a point to the ring buffer, overwriting the oldest
+      /// point once it is full.
+      /// \param[in] _point Point to append.
+      private: void Append(const QPointF &_point)
+              {
+                if (this->samples.size() < MAX_SAMPLE_SIZE)
                 {
-                  // remove sample window
-                  // update bounding rect?
-                  this->d_samples.remove(0, windowSize);
+                  this->samples.push_back(_point);
+                }
+                else
+                {
+                  // Recompute the bounding rect lazily if the oldest point
+                  // was on its border.
+                  const QPointF &oldest = this->samples[this->start];
+                  const QRectF &rect = this->d_boundingRect;
+                  if (oldest.x() <= rect.left() || oldest.x() >= rect.right()
+                      || oldest.y() <= rect.top() ||
+                      oldest.y() >= rect.bottom())
+                  {
+                    this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+                  }
+
+                  this->samples[this->start] = _point;
+                  this->start = (this->start + 1) % this->samples.size();
                 }
 
-                if (this->d_samples.size() == 1)
+                if (this->d_boundingRect.width() < 0.0)
                 {
-                  // init bounding rect
-                  this->d_boundingRect.setTopLeft(_point);
-                  this->d_boundingRect.setBottomRight(_point);
+                  if (this->samples.size() == 1u)
+                  {
+                    // init bounding rect
+                    this->d_boundingRect.setTopLeft(_point);
+                    this->d_boundingRect.setBottomRight(_point);
+                  }
                   return;
                 }
 
@@ -107,29 +197,116 @@ namespace gazebo
                   this->d_boundingRect.setBottom(_point.y());
               }
 
-      /// \brief Clear the sample data.
-      public: void Clear()
-              {
-                this->d_samples.clear();
-                this->d_samples.squeeze();
-                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
-              }
+      /// \brief Samples, oldest first, starting at index start.
+      private: std::vector<QPointF> samples;
+
+      /// \brief Index of the oldest sample.
+      private: size_t start = 0;
 
-      /// \brief Get the sample data.
-      /// \return A vector of same points.
-      public: QVector<QPointF> Samples() const
+      /// \brief Points added since the last flush.
+      private: std::deque<QPointF> pending;
+
+      /// \brief Mutex to protect the pending points.
+      private: std::mutex mutex;
+    };
+
+    /// \brief A Qwt curve which draws long series decimated to the pixel
+    /// columns of the canvas. Each column gets the first, lowest, highest
+    /// and last point that fall in it, so that peaks stay visible while
+    /// the number of lines drawn doesn't depend on the number of samples.
+    class DecimatingCurve : public QwtPlotCurve
+    {
+      /// \brief Constructor.
+      /// \param[in] _title Curve title.
+      public: explicit DecimatingCurve(const QString &_title)
+              : QwtPlotCurve(_title)
               {
-                return this->d_samples;
               }
 
-      /// \brief maxium sample size of this curve.
-      private: int maxSampleSize = 11000;
+      // Documentation inherited
+      public: virtual void drawSeries(QPainter *_painter,
+                  const QwtScaleMap &_xMap, const QwtScaleMap &_yMap,
+                  const QRectF &_canvasRect, int _from, int _to) const
+              {
+                if (_to < 0)
+                  _to = static_cast<int>(this->dataSize()) - 1;
+
+                // Draw short ranges as is, such as the last point drawn by
+                // the direct painter, or a zoomed in part of the curve.
+                const double left = std::floor(_canvasRect.left()) - 1.0;
+                const double right = std::ceil(_canvasRect.right()) + 1.0;
+                if (_to - _from < 4 * static_cast<int>(right - left))
+                {
+                  QwtPlotCurve::drawSeries(_painter, _xMap, _yMap,
+                      _canvasRect, _from, _to);
+                  return;
+                }
 
-      /// \brief Size of samples to remove when maxSampleSize is reached.
-      private: int windowSize = 1000;
+                QPolygonF polyline;
+                polyline.reserve(4 * static_cast<int>(right - left + 1.0));
+
+                // Points of the current column. Points outside the canvas
+                // fall in the columns next to its edges.
+                int column = 0;
+                int count = 0;
+                QPointF first, low, high, last;
+                int lowIndex = 0;
+                int highIndex = 0;
+                auto appendColumn = [&]()
+                {
+                  polyline << first;
+                  if (lowIndex < highIndex)
+                    polyline << low << high;
+                  else
+                    polyline << high << low;
+                  polyline << last;
+                };
+
+                for (int i = _from; i <= _to; ++i)
+                {
+                  const QPointF point = this->sample(i);
+                  const QPointF pt(_xMap.transform(point.x()),
+                      _yMap.transform(point.y()));
+                  if (std::isnan(pt.x()) || std::isnan(pt.y()))
+                    continue;
+
+                  const int c = static_cast<int>(
+                      std::floor(std::min(std::max(pt.x(), left), right)));
+                  if (count == 0 || c != column)
+                  {
+                    if (count > 0)
+                      appendColumn();
+                    column = c;
+                    count = 1;
+                    first = low = high = last = pt;
+                    lowIndex = highIndex = i;
+                    continue;
+                  }
+
+                  ++count;
+                  last = pt;
+                  if (pt.y() < low.y())
+                  {
+                    low = pt;
+                    lowIndex = i;
+                  }
+                  if (pt.y() > high.y())
+                  {
+                    high = pt;
+                    highIndex = i;
+                  }
+                }
+                if (count > 0)
+                  appendColumn();
+
+                // Symbols are left out, they would cover the whole line
+                _painter->save();
+                _painter->setPen(this->pen());
+                QwtPainter::drawPolyline(_painter, polyline);
+                _painter->restore();
+              }
     };
 
-
     /// \internal
     /// \brief PlotCurve private data
     class PlotCurvePrivate
@@ -146,6 +323,13 @@ namespace gazebo
       /// \brief Age of the curve since the first restart;
       public: unsigned int age = 0;
 
+      /// \brief Recorder of the added points, if any.
+      public: PlotRecorderPtr recorder;
+
+      /// \brief Mutex to protect the recorder, since points are added from
+      /// other threads.
+      public: std::mutex recorderMutex;
+
       /// \brief Qwt Curve object.
       public: QwtPlotCurve *curve = nullptr;
 
@@ -212,7 +396,7 @@ unsigned int PlotCurvePrivate::colorCounter = 0;
 PlotCurve::PlotCurve(const std::string &_label)
   : dataPtr(new PlotCurvePrivate())
 {
-  QwtPlotCurve *curve = new QwtPlotCurve(QString::fromStdString(_label));
+  QwtPlotCurve *curve = new DecimatingCurve(QString::fromStdString(_label));
   this->dataPtr->curve = curve;
 
   curve->setYAxis(QwtPlot::yLeft);
@@ -257,6 +441,10 @@ void PlotCurve::AddPoint(const ignition::math::Vector2d &_pt)
 
   // Add a point
   this->dataPtr->curveData->Add(QPointF(_pt.X(), _pt.Y()));
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->recorderMutex);
+  if (this->dataPtr->recorder)
+    this->dataPtr->recorder->AddPoint(this->dataPtr->id, _pt);
 }
 
 /////////////////////////////////////////////////
@@ -270,6 +458,13 @@ void PlotCurve::AddPoints(const std::vector<ignition::math::Vector2d> &_pts)
   {
     this->dataPtr->curveData->Add(QPointF(pt.X(), pt.Y()));
   }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->recorderMutex);
+  if (this->dataPtr->recorder)
+  {
+    for (const auto &pt : _pts)
+      this->dataPtr->recorder->AddPoint(this->dataPtr->id, pt);
+  }
 }
 
 /////////////////////////////////////////////////
@@ -278,6 +473,16 @@ void PlotCurve::Clear()
   this->dataPtr->curveData->Clear();
 }
 
+/////////////////////////////////////////////////
+void PlotCurve::SetRecorder(PlotRecorderPtr _recorder)
+{
+  if (_recorder)
+    _recorder->AddCurve(this->dataPtr->id, this->dataPtr->label);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->recorderMutex);
+  this->dataPtr->recorder = _recorder;
+}
+
 /////////////////////////////////////////////////
 void PlotCurve::Detach()
 {
@@ -342,12 +547,14 @@ void PlotCurve::SetAge(const unsigned int _age)
 /////////////////////////////////////////////////
 unsigned int PlotCurve::Size() const
 {
-  return static_cast<unsigned int>(this->dataPtr->curveData->samples().size());
+  this->dataPtr->curveData->Flush();
+  return static_cast<unsigned int>(this->dataPtr->curveData->size());
 }
 
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Min()
 {
+  this->dataPtr->curveData->Flush();
   return ignition::math::Vector2d(this->dataPtr->curve->minXValue(),
       this->dataPtr->curve->minYValue());
 }
@@ -355,6 +562,7 @@ ignition::math::Vector2d PlotCurve::Min()
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Max()
 {
+  this->dataPtr->curveData->Flush();
   return ignition::math::Vector2d(this->dataPtr->curve->maxXValue(),
       this->dataPtr->curve->maxYValue());
 }
@@ -362,14 +570,14 @@ ignition::math::Vector2d PlotCurve::Max()
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Point(const unsigned int _index) const
 {
-  if (_index >= static_cast<unsigned int>(
-      this->dataPtr->curveData->samples().size()))
+  this->dataPtr->curveData->Flush();
+  if (_index >= this->dataPtr->curveData->size())
   {
     return ignition::math::Vector2d(ignition::math::NAN_D,
         ignition::math::NAN_D);
   }
 
-  const QPointF &pt = this->dataPtr->curveData->samples()[_index];
+  const QPointF pt = this->dataPtr->curveData->sample(_index);
   return ignition::math::Vector2d(pt.x(), pt.y());
 }
 
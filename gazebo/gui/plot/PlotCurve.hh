@@ -24,6 +24,7 @@
 #include <ignition/math/Vector2.hh>
 
 #include "gazebo/gui/qt.h"
+#include "gazebo/gui/plot/PlottingTypes.hh"
 #include "gazebo/util/system.hh"
 
 class QwtPlotCurve;
@@ -47,17 +48,25 @@ namespace gazebo
       /// \brief Destructor.
       public: ~PlotCurve();
 
-      /// \brief Add a point to the curve
+      /// \brief Add a point to the curve. This can be called from any
+      /// thread. The curve keeps a bounded number of points, dropping the
+      /// oldest ones first.
       /// \param[in] _pt Point to add.
       public: void AddPoint(const ignition::math::Vector2d &_pt);
 
-      /// \brief Add points to the curve
+      /// \brief Add points to the curve. This can be called from any
+      /// thread.
       /// \param[in] _pts Points to add.
       public: void AddPoints(const std::vector<ignition::math::Vector2d> &_pt);
 
       /// \brief Clear all data from the curve.
       public: void Clear();
 
+      /// \brief Record the points added to the curve from now on.
+      /// \param[in] _recorder Recorder to add the points to, nullptr to stop
+      /// recording.
+      public: void SetRecorder(PlotRecorderPtr _recorder);
+
       /// \brief Attach the curve to a plot.
       /// \param[in] _plot Plot to attach to.
       public: void Attach(IncrementalPlot *_plot);
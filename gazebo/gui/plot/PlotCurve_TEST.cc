@@ -15,6 +15,8 @@
  *
 */
 
+#include <thread>
+
 #include "gazebo/gui/plot/PlottingTypes.hh"
 #include "gazebo/gui/plot/PlotCurve.hh"
 #include "gazebo/gui/plot/PlotCurve_TEST.hh"
@@ -133,5 +135,50 @@ void PlotCurve_TEST::AddPoint()
   delete plotCurve;
 }
 
+/////////////////////////////////////////////////
+void PlotCurve_TEST::MaxSize()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world");
+
+  gazebo::gui::PlotCurve *plotCurve = new gazebo::gui::PlotCurve("curve01");
+  QVERIFY(plotCurve != nullptr);
+
+  // add points from another thread, as the curve handlers do
+  unsigned int ptSize = 50000;
+  std::thread addThread([&]()
+  {
+    for (unsigned int i = 0; i < ptSize; ++i)
+      plotCurve->AddPoint(ignition::math::Vector2d(i, i % 100));
+  });
+  addThread.join();
+
+  // only the newest points are kept
+  unsigned int size = plotCurve->Size();
+  QVERIFY(size > 0u);
+  QVERIFY(size < ptSize);
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    unsigned int x = ptSize - size + i;
+    QCOMPARE(plotCurve->Point(i), ignition::math::Vector2d(x, x % 100));
+  }
+
+  // the bounds follow the points that are kept
+  QCOMPARE(plotCurve->Min(), ignition::math::Vector2d(ptSize - size, 0));
+  QCOMPARE(plotCurve->Max(), ignition::math::Vector2d(ptSize - 1, 99));
+
+  // adding more points keeps the size
+  plotCurve->AddPoint(ignition::math::Vector2d(ptSize, 0));
+  QCOMPARE(plotCurve->Size(), size);
+  QCOMPARE(plotCurve->Point(size - 1), ignition::math::Vector2d(ptSize, 0));
+
+  plotCurve->Clear();
+  QCOMPARE(plotCurve->Size(), 0u);
+
+  delete plotCurve;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(PlotCurve_TEST)
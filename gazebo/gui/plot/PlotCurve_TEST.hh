@@ -32,5 +32,8 @@ class PlotCurve_TEST : public QTestFixture
 
   /// \brief Test adding points to the curve
   private slots: void AddPoint();
+
+  /// \brief Test that the curve keeps a bounded number of points
+  private slots: void MaxSize();
 };
 #endif
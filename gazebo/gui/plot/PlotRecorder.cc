@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/gui/plot/PlotRecorder.hh"
+
+using namespace gazebo;
+using namespace gui;
+
+/// \brief Magic string at the start of a recording.
+static const char PLOT_RECORD_MAGIC[8] = {'G', 'Z', 'P', 'L', 'O', 'T', '0',
+  '1'};
+
+/// \brief Type of the records of the label of a column.
+static const uint8_t PLOT_RECORD_COLUMN = 1;
+
+/// \brief Type of the records of a block of points.
+static const uint8_t PLOT_RECORD_BLOCK = 2;
+
+/// \brief Number of queued points which wake up the writer before its
+/// period ends.
+static const size_t PLOT_RECORD_FLUSH_SIZE = 8192;
+
+/// \brief Period at which the writer writes the queued points.
+static const std::chrono::milliseconds PLOT_RECORD_PERIOD(250);
+
+namespace gazebo
+{
+  namespace gui
+  {
+    /// \brief A queued point of a column.
+    class PlotRecorderSample
+    {
+      /// \brief Column index.
+      public: uint32_t column;
+
+      /// \brief X value.
+      public: double x;
+
+      /// \brief Y value.
+      public: double y;
+    };
+
+    /// \brief Private data for the PlotRecorder class
+    class PlotRecorderPrivate
+    {
+      /// \brief Mutex to protect the queues and the columns.
+      public: mutable std::mutex mutex;
+
+      /// \brief Wakes up the writer.
+      public: std::condition_variable condition;
+
+      /// \brief Column index of each curve, by curve id.
+      public: std::unordered_map<unsigned int, uint32_t> columns;
+
+      /// \brief Label of each column.
+      public: std::vector<std::string> labels;
+
+      /// \brief Columns waiting to be written.
+      public: std::vector<std::pair<uint32_t, std::string>> pendingColumns;
+
+      /// \brief Points waiting to be written.
+      public: std::vector<PlotRecorderSample> pending;
+
+      /// \brief True while recording.
+      public: bool recording = false;
+
+      /// \brief True to stop the writer.
+      public: bool stop = false;
+
+      /// \brief File being recorded, only used by the writer once started.
+      public: std::ofstream file;
+
+      /// \brief Writer thread.
+      public: std::thread thread;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the bytes of a value to a buffer.
+/// \param[in,out] _buffer Buffer to append to.
+/// \param[in] _value Value to append.
+template<typename T>
+static void Append(std::string &_buffer, const T &_value)
+{
+  _buffer.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the bytes of a value from a stream.
+/// \param[in] _in Stream to read from.
+/// \param[out] _value Value read.
+/// \return False if the stream ended.
+template<typename T>
+static bool Read(std::istream &_in, T &_value)
+{
+  return static_cast<bool>(
+      _in.read(reinterpret_cast<char *>(&_value), sizeof(T)));
+}
+
+/////////////////////////////////////////////////
+PlotRecorder::PlotRecorder()
+  : dataPtr(new PlotRecorderPrivate())
+{
+}
+
+/////////////////////////////////////////////////
+PlotRecorder::~PlotRecorder()
+{
+  this->Stop();
+}
+
+/////////////////////////////////////////////////
+bool PlotRecorder::Start(const std::string &_filename)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->recording)
+    return false;
+
+  this->dataPtr->file.open(_filename,
+      std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!this->dataPtr->file)
+  {
+    gzerr << "Unable to open plot recording[" << _filename << "]\n";
+    this->dataPtr->file.clear();
+    return false;
+  }
+  this->dataPtr->file.write(PLOT_RECORD_MAGIC, sizeof(PLOT_RECORD_MAGIC));
+
+  // Columns added before starting are written first
+  this->dataPtr->pendingColumns.clear();
+  for (uint32_t i = 0; i < this->dataPtr->labels.size(); ++i)
+    this->dataPtr->pendingColumns.emplace_back(i, this->dataPtr->labels[i]);
+  this->dataPtr->pending.clear();
+
+  this->dataPtr->stop = false;
+  this->dataPtr->recording = true;
+  this->dataPtr->thread = std::thread(&PlotRecorder::Run, this);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PlotRecorder::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (!this->dataPtr->recording)
+      return;
+    this->dataPtr->recording = false;
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->condition.notify_one();
+  this->dataPtr->thread.join();
+  this->dataPtr->file.close();
+}
+
+/////////////////////////////////////////////////
+bool PlotRecorder::Recording() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->recording;
+}
+
+/////////////////////////////////////////////////
+void PlotRecorder::AddCurve(const unsigned int _id, const std::string &_label)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->columns.count(_id))
+    return;
+
+  const uint32_t column = this->dataPtr->labels.size();
+  this->dataPtr->columns[_id] = column;
+  this->dataPtr->labels.push_back(_label);
+  if (this->dataPtr->recording)
+    this->dataPtr->pendingColumns.emplace_back(column, _label);
+}
+
+/////////////////////////////////////////////////
+void PlotRecorder::AddPoint(const unsigned int _id,
+    const ignition::math::Vector2d &_pt)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->recording)
+    return;
+
+  auto it = this->dataPtr->columns.find(_id);
+  if (it == this->dataPtr->columns.end())
+    return;
+
+  this->dataPtr->pending.push_back({it->second, _pt.X(), _pt.Y()});
+  if (this->dataPtr->pending.size() == PLOT_RECORD_FLUSH_SIZE)
+    this->dataPtr->condition.notify_one();
+}
+
+/////////////////////////////////////////////////
+void PlotRecorder::Run()
+{
+  std::vector<std::pair<uint32_t, std::string>> columns;
+  std::vector<PlotRecorderSample> samples;
+  std::string buffer;
+
+  bool done = false;
+  while (!done)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+      this->dataPtr->condition.wait_for(lock, PLOT_RECORD_PERIOD, [this]
+          {
+            return this->dataPtr->stop ||
+                this->dataPtr->pending.size() >= PLOT_RECORD_FLUSH_SIZE;
+          });
+      done = this->dataPtr->stop;
+
+      // Swap the queues, so that the next points reuse the memory of the
+      // points written last
+      columns.swap(this->dataPtr->pendingColumns);
+      samples.swap(this->dataPtr->pending);
+    }
+
+    buffer.clear();
+    for (auto const &column : columns)
+    {
+      Append(buffer, PLOT_RECORD_COLUMN);
+      Append(buffer, column.first);
+      Append(buffer, static_cast<uint32_t>(column.second.size()));
+      buffer.append(column.second);
+    }
+
+    // Write the points of each column as a block, in the order they came
+    std::stable_sort(samples.begin(), samples.end(),
+        [](const PlotRecorderSample &_a, const PlotRecorderSample &_b)
+        {
+          return _a.column < _b.column;
+        });
+    for (size_t i = 0; i < samples.size();)
+    {
+      size_t end = i;
+      while (end < samples.size() && samples[end].column == samples[i].column)
+        ++end;
+
+      Append(buffer, PLOT_RECORD_BLOCK);
+      Append(buffer, samples[i].column);
+      Append(buffer, static_cast<uint32_t>(end - i));
+      for (size_t s = i; s < end; ++s)
+        Append(buffer, samples[s].x);
+      for (size_t s = i; s < end; ++s)
+        Append(buffer, samples[s].y);
+      i = end;
+    }
+
+    if (!buffer.empty())
+      this->dataPtr->file.write(buffer.data(), buffer.size());
+
+    columns.clear();
+    samples.clear();
+  }
+
+  this->dataPtr->file.flush();
+  if (!this->dataPtr->file)
+    gzerr << "Unable to write plot recording\n";
+}
+
+/////////////////////////////////////////////////
+bool PlotRecorder::Load(const std::string &_filename,
+    std::map<std::string, std::vector<ignition::math::Vector2d>> &_series)
+{
+  _series.clear();
+
+  std::ifstream file(_filename, std::ios::in | std::ios::binary);
+  char magic[sizeof(PLOT_RECORD_MAGIC)];
+  if (!file.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, PLOT_RECORD_MAGIC, sizeof(magic)) != 0)
+  {
+    return false;
+  }
+
+  std::unordered_map<uint32_t, std::string> labels;
+  uint8_t type;
+  while (Read(file, type))
+  {
+    uint32_t column;
+    uint32_t size;
+    if (!Read(file, column) || !Read(file, size))
+      return false;
+
+    if (type == PLOT_RECORD_COLUMN)
+    {
+      std::string label(size, '\0');
+      if (!file.read(&label[0], size))
+        return false;
+      labels[column] = label;
+      _series[label];
+    }
+    else if (type == PLOT_RECORD_BLOCK)
+    {
+      auto it = labels.find(column);
+      if (it == labels.end())
+        return false;
+
+      std::vector<double> values(static_cast<size_t>(size) * 2);
+      if (!file.read(reinterpret_cast<char *>(values.data()),
+          values.size() * sizeof(double)))
+      {
+        return false;
+      }
+
+      auto &points = _series[it->second];
+      for (size_t i = 0; i < size; ++i)
+        points.emplace_back(values[i], values[size + i]);
+    }
+    else
+      return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_GUI_PLOT_PLOTRECORDER_HH_
+#define GAZEBO_GUI_PLOT_PLOTRECORDER_HH_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector2.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace gui
+  {
+    // Forward declare private data class
+    class PlotRecorderPrivate;
+
+    /// \brief Records the points added to plot curves to a binary file,
+    /// while they are plotted.
+    ///
+    /// Points are queued by the threads that add them to the curves, and
+    /// written in blocks by a background thread, so recording doesn't hold
+    /// the points in memory like an export does.
+    ///
+    /// The file starts with the 8 byte magic string "GZPLOT01", followed
+    /// by records in the byte order of the host. Each record starts with a
+    /// one byte type:
+    /// - 1: a column, with a uint32 column index, and a uint32 length
+    ///      followed by the label of the curve.
+    /// - 2: a block of points of a column, with a uint32 column index, a
+    ///      uint32 count, and the count x values followed by the count y
+    ///      values, as doubles.
+    class GZ_GUI_VISIBLE PlotRecorder
+    {
+      /// \brief Constructor.
+      public: PlotRecorder();
+
+      /// \brief Destructor. Stops recording.
+      public: ~PlotRecorder();
+
+      /// \brief Start recording to a file.
+      /// \param[in] _filename Path of the file, which is overwritten.
+      /// \return False if the file can't be opened or the recorder is
+      /// already recording.
+      public: bool Start(const std::string &_filename);
+
+      /// \brief Stop recording, after the queued points are written.
+      public: void Stop();
+
+      /// \brief Get whether the recorder is recording.
+      /// \return True if recording.
+      public: bool Recording() const;
+
+      /// \brief Add a column for the points of a curve.
+      /// \param[in] _id Id of the curve.
+      /// \param[in] _label Label of the curve.
+      public: void AddCurve(const unsigned int _id, const std::string &_label);
+
+      /// \brief Queue a point of a curve to be written. This can be called
+      /// from any thread. Points of curves without a column are ignored.
+      /// \param[in] _id Id of the curve.
+      /// \param[in] _pt Point to write.
+      public: void AddPoint(const unsigned int _id,
+                  const ignition::math::Vector2d &_pt);
+
+      /// \brief Read the points of a recorded file.
+      /// \param[in] _filename Path of the file.
+      /// \param[out] _series Points of each curve, by label.
+      /// \return False if the file can't be read or is not a recording.
+      public: static bool Load(const std::string &_filename,
+                  std::map<std::string, std::vector<ignition::math::Vector2d>>
+                  &_series);
+
+      /// \brief Write the queued points until the recorder stops.
+      private: void Run();
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<PlotRecorderPrivate> dataPtr;
+    };
+  }
+}
+#endif
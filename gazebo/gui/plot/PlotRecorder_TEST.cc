@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/gui/plot/PlotCurve.hh"
+#include "gazebo/gui/plot/PlotRecorder.hh"
+#include "gazebo/gui/plot/PlotRecorder_TEST.hh"
+
+/////////////////////////////////////////////////
+void PlotRecorder_TEST::Record()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  const std::string filename = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_plot_%%%%.gzplot")).string();
+
+  gazebo::gui::PlotCurve curve01("curve01");
+  gazebo::gui::PlotCurve curve02("curve02");
+
+  // Points added before recording are not recorded
+  curve01.AddPoint(ignition::math::Vector2d(-1, -1));
+
+  auto recorder = std::make_shared<gazebo::gui::PlotRecorder>();
+  QVERIFY(!recorder->Recording());
+  QVERIFY(recorder->Start(filename));
+  QVERIFY(recorder->Recording());
+  QVERIFY(!recorder->Start(filename));
+
+  curve01.SetRecorder(recorder);
+  curve02.SetRecorder(recorder);
+
+  // Add points from two threads, more than one block of each curve
+  const unsigned int count = 20000;
+  std::thread thread([&]()
+      {
+        for (unsigned int i = 0; i < count; ++i)
+          curve02.AddPoint(ignition::math::Vector2d(i, -2.0 * i));
+      });
+  for (unsigned int i = 0; i < count; ++i)
+    curve01.AddPoint(ignition::math::Vector2d(i, 0.5 * i));
+  thread.join();
+
+  curve01.AddPoints({ignition::math::Vector2d(count, 1),
+      ignition::math::Vector2d(count + 1, 2)});
+
+  recorder->Stop();
+  QVERIFY(!recorder->Recording());
+
+  // Not recorded after stopping
+  curve01.AddPoint(ignition::math::Vector2d(-1, -1));
+
+  std::map<std::string, std::vector<ignition::math::Vector2d>> series;
+  QVERIFY(gazebo::gui::PlotRecorder::Load(filename, series));
+  QCOMPARE(series.size(), static_cast<size_t>(2));
+
+  const auto &points01 = series["curve01"];
+  QCOMPARE(points01.size(), static_cast<size_t>(count + 2));
+  for (unsigned int i = 0; i < count; ++i)
+    QVERIFY(points01[i] == ignition::math::Vector2d(i, 0.5 * i));
+  QVERIFY(points01[count + 1] == ignition::math::Vector2d(count + 1, 2));
+
+  const auto &points02 = series["curve02"];
+  QCOMPARE(points02.size(), static_cast<size_t>(count));
+  for (unsigned int i = 0; i < count; ++i)
+    QVERIFY(points02[i] == ignition::math::Vector2d(i, -2.0 * i));
+
+  // A truncated file is not a valid recording
+  boost::filesystem::resize_file(filename,
+      boost::filesystem::file_size(filename) - 4);
+  QVERIFY(!gazebo::gui::PlotRecorder::Load(filename, series));
+
+  boost::filesystem::remove(filename);
+}
+
+/////////////////////////////////////////////////
+void PlotRecorder_TEST::InvalidFile()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  gazebo::gui::PlotRecorder recorder;
+  QVERIFY(!recorder.Start("/invalid_dir/plot.gzplot"));
+  QVERIFY(!recorder.Recording());
+
+  std::map<std::string, std::vector<ignition::math::Vector2d>> series;
+  QVERIFY(!gazebo::gui::PlotRecorder::Load("/invalid_dir/plot.gzplot",
+      series));
+}
+
+// Generate a main function for the test
+QTEST_MAIN(PlotRecorder_TEST)
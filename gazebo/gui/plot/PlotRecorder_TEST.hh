@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GAZEBO_GUI_PLOT_PLOTRECORDER_TEST_HH_
+#define GAZEBO_GUI_PLOT_PLOTRECORDER_TEST_HH_
+
+#include "gazebo/gui/QTestFixture.hh"
+
+/// \brief A test class for the PlotRecorder class.
+class PlotRecorder_TEST : public QTestFixture
+{
+  Q_OBJECT
+
+  /// \brief Test recording the points of curves and reading them back
+  private slots: void Record();
+
+  /// \brief Test recording to a file that can't be opened
+  private slots: void InvalidFile();
+};
+#endif
@@ -25,6 +25,7 @@
 #include "gazebo/gui/plot/PlotCanvas.hh"
 #include "gazebo/gui/plot/PlotCurve.hh"
 #include "gazebo/gui/plot/PlotManager.hh"
+#include "gazebo/gui/plot/PlotRecorder.hh"
 #include "gazebo/gui/plot/PlotWindow.hh"
 
 using namespace gazebo;
@@ -45,6 +46,12 @@ namespace gazebo
 
       /// \brief Flag to indicate whether the plots should be restarted.
       public: bool restart = false;
+
+      /// \brief Recorder of the plotted variables while recording.
+      public: PlotRecorderPtr recorder;
+
+      /// \brief Button to start and stop recording.
+      public: QPushButton *recordButton = nullptr;
     };
   }
 }
@@ -117,8 +124,24 @@ PlotWindow::PlotWindow(QWidget *_parent)
   exportPlotButton->setGraphicsEffect(exportPlotShadow);
   connect(exportPlotButton, SIGNAL(clicked()), this, SLOT(OnExport()));
 
+  // record button
+  this->dataPtr->recordButton = new QPushButton("Record");
+  this->dataPtr->recordButton->setObjectName("plotRecord");
+  this->dataPtr->recordButton->setDefault(false);
+  this->dataPtr->recordButton->setAutoDefault(false);
+  this->dataPtr->recordButton->setCheckable(true);
+  this->dataPtr->recordButton->setToolTip(
+      "Record the plotted variables to a file");
+  QGraphicsDropShadowEffect *recordShadow = new QGraphicsDropShadowEffect();
+  recordShadow->setBlurRadius(8);
+  recordShadow->setOffset(0, 0);
+  this->dataPtr->recordButton->setGraphicsEffect(recordShadow);
+  connect(this->dataPtr->recordButton, SIGNAL(clicked()), this,
+      SLOT(OnRecord()));
+
   QHBoxLayout *addButtonLayout = new QHBoxLayout;
   addButtonLayout->addWidget(exportPlotButton);
+  addButtonLayout->addWidget(this->dataPtr->recordButton);
   addButtonLayout->addStretch();
   addButtonLayout->addWidget(addCanvasButton);
   addButtonLayout->setAlignment(Qt::AlignRight | Qt::AlignBottom);
@@ -170,6 +193,8 @@ PlotWindow::PlotWindow(QWidget *_parent)
 PlotWindow::~PlotWindow()
 {
   PlotManager::Instance()->RemoveWindow(this);
+  if (this->dataPtr->recorder)
+    this->dataPtr->recorder->Stop();
   this->Clear();
 }
 
@@ -268,6 +293,10 @@ void PlotWindow::Update()
       canvas->Restart();
     }
     this->dataPtr->restart = false;
+
+    // Keep recording the new curves
+    if (this->dataPtr->recorder)
+      this->SetRecorder(this->dataPtr->recorder);
   }
 
   for (int i = 0; i < this->dataPtr->canvasSplitter->count(); ++i)
@@ -352,6 +381,76 @@ void PlotWindow::OnExport()
   }
 }
 
+/////////////////////////////////////////////////
+void PlotWindow::OnRecord()
+{
+  if (this->dataPtr->recorder)
+  {
+    this->SetRecorder(nullptr);
+    this->dataPtr->recorder->Stop();
+    this->dataPtr->recorder.reset();
+    this->dataPtr->recordButton->setChecked(false);
+    this->dataPtr->recordButton->setText("Record");
+    return;
+  }
+
+  this->dataPtr->recordButton->setChecked(false);
+
+  QFileDialog fileDialog(this, tr("Record Plot Data"),
+      QDir::homePath() + "/plot.gzplot", tr("Plot recordings (*.gzplot)"));
+  fileDialog.setWindowFlags(Qt::Window | Qt::WindowCloseButtonHint |
+      Qt::WindowStaysOnTopHint | Qt::CustomizeWindowHint);
+  fileDialog.setAcceptMode(QFileDialog::AcceptSave);
+  fileDialog.setDefaultSuffix("gzplot");
+  if (fileDialog.exec() != QDialog::Accepted ||
+      fileDialog.selectedFiles().empty())
+  {
+    return;
+  }
+
+  auto recorder = std::make_shared<PlotRecorder>();
+  if (!recorder->Start(fileDialog.selectedFiles().front().toStdString()))
+  {
+    QMessageBox msgBox(
+        QMessageBox::Warning,
+        QString("Unable to record"),
+        QString("Unable to open the file to record to."),
+        QMessageBox::Close,
+        this,
+        Qt::Window | Qt::WindowTitleHint |
+        Qt::WindowStaysOnTopHint | Qt::CustomizeWindowHint);
+    msgBox.exec();
+    return;
+  }
+
+  this->dataPtr->recorder = recorder;
+  this->SetRecorder(recorder);
+  this->dataPtr->recordButton->setChecked(true);
+  this->dataPtr->recordButton->setText("Stop");
+}
+
+/////////////////////////////////////////////////
+void PlotWindow::SetRecorder(PlotRecorderPtr _recorder)
+{
+  for (int i = 0; i < this->dataPtr->canvasSplitter->count(); ++i)
+  {
+    PlotCanvas *canvas =
+        qobject_cast<PlotCanvas *>(this->dataPtr->canvasSplitter->widget(i));
+    if (!canvas)
+      continue;
+
+    for (const auto &plot : canvas->Plots())
+    {
+      for (const auto &curve : plot->Curves())
+      {
+        auto c = curve.lock();
+        if (c)
+          c->SetRecorder(_recorder);
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 std::list<PlotCanvas *> PlotWindow::Plots()
 {
@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "gazebo/gui/qt.h"
+#include "gazebo/gui/plot/PlottingTypes.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -77,6 +78,14 @@ namespace gazebo
       /// \brief QT callback for when a plot is to be exported.
       private slots: void OnExport();
 
+      /// \brief QT callback to start or stop recording the plotted
+      /// variables to a file.
+      private slots: void OnRecord();
+
+      /// \brief Set the recorder of all the curves of the window.
+      /// \param[in] _recorder Recorder, nullptr to stop recording.
+      private: void SetRecorder(PlotRecorderPtr _recorder);
+
       /// \brief Qt Callback when a new plot canvas should be added.
       private slots: void OnAddCanvas();
 
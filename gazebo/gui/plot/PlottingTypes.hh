@@ -31,6 +31,7 @@ namespace gazebo
   namespace gui
   {
     class PlotCurve;
+    class PlotRecorder;
 
     /// \def PlotCurvePtr
     /// \brief std shared pointer to a PlotCurve object
@@ -40,6 +41,10 @@ namespace gazebo
     /// \brief std weak pointer to a PlotCurve object
     typedef std::weak_ptr<PlotCurve> PlotCurveWeakPtr;
 
+    /// \def PlotRecorderPtr
+    /// \brief std shared pointer to a PlotRecorder object
+    typedef std::shared_ptr<PlotRecorder> PlotRecorderPtr;
+
     /// \def CurveVariableSet
     /// \brief A set of unique plot curve pointers
     using CurveVariableSet = std::set<PlotCurveWeakPtr,
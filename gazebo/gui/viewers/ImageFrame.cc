@@ -15,7 +15,12 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "gazebo/common/Image.hh"
+#include "gazebo/common/ImageConvert.hh"
 #include "gazebo/gui/viewers/ImageFramePrivate.hh"
 #include "gazebo/gui/viewers/ImageFrame.hh"
 
@@ -31,22 +36,25 @@ ImageFrame::ImageFrame(QWidget *_parent)
 /////////////////////////////////////////////////
 ImageFrame::~ImageFrame()
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  if (this->dataPtr->depthBuffer)
-    delete [] this->dataPtr->depthBuffer;
-  if (this->dataPtr->imageBuffer)
-    delete [] this->dataPtr->imageBuffer;
 }
 
 /////////////////////////////////////////////////
 void ImageFrame::paintEvent(QPaintEvent * /*_event*/)
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->updatePending = false;
+
+  // Images are implicitly shared, so only hold the lock for the copy
+  QImage image;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    image = this->dataPtr->image;
+  }
+
   QPainter painter(this);
 
-  if (!this->dataPtr->image.isNull())
+  if (!image.isNull())
   {
-    painter.drawImage(this->contentsRect(), this->dataPtr->image);
+    painter.drawImage(this->contentsRect(), image);
   }
   else
   {
@@ -61,128 +69,145 @@ void ImageFrame::paintEvent(QPaintEvent * /*_event*/)
   }
 }
 
+/////////////////////////////////////////////////
+void ImageFrame::resizeEvent(QResizeEvent *_event)
+{
+  QFrame::resizeEvent(_event);
+  this->dataPtr->width = this->contentsRect().width();
+  this->dataPtr->height = this->contentsRect().height();
+}
+
 /////////////////////////////////////////////////
 void ImageFrame::OnImage(const msgs::Image &_msg)
 {
-  if (_msg.width() == 0 || _msg.height() == 0)
+  const unsigned int width = _msg.width();
+  const unsigned int height = _msg.height();
+  if (width == 0 || height == 0)
     return;
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  QImage::Format qFormat;
-  bool isDepthImage = false;
+  std::lock_guard<std::mutex> convertLock(this->dataPtr->convertMutex);
+
+  const size_t pixels = static_cast<size_t>(width) * height;
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(_msg.data().data());
+  const size_t dataSize = _msg.data().size();
+  std::vector<uint8_t> &buffer = this->dataPtr->buffer;
+
+  // Convert the image data to 8 bit gray or RGB pixels
+  unsigned int channels = 3;
+  bool converted = false;
   switch (_msg.pixel_format())
   {
     case common::Image::PixelFormat::L_INT8:
     {
-      qFormat = QImage::Format_Grayscale8;
+      channels = 1;
       break;
     }
     case common::Image::PixelFormat::R_FLOAT16:
     case common::Image::PixelFormat::R_FLOAT32:
     {
-      qFormat = QImage::Format_RGB888;
-      isDepthImage = true;
-      break;
-    }
-    default:
-    {
-      qFormat = QImage::Format_RGB888;
-      break;
-    }
-  }
+      channels = 1;
+      if (dataSize < pixels * sizeof(float))
+        return;
 
-  if (_msg.width() != static_cast<unsigned int>(this->dataPtr->image.width()) ||
-      _msg.height() != static_cast<unsigned int>(this->dataPtr->image.height())
-      || qFormat != this->dataPtr->image.format() || _msg.step() !=
-      static_cast<unsigned int>(this->dataPtr->image.bytesPerLine()))
-  {
-    this->dataPtr->image = QImage(_msg.width(), _msg.height(), qFormat);
-    delete [] this->dataPtr->imageBuffer;
-    this->dataPtr->imageBuffer = nullptr;
-    delete [] this->dataPtr->depthBuffer;
-    this->dataPtr->depthBuffer = nullptr;
-  }
+      std::vector<float> depths(pixels);
+      memcpy(depths.data(), data, pixels * sizeof(float));
 
-  // Convert the image data to RGB
-  if (isDepthImage)
-  {
-    unsigned int depthSamples = _msg.width() * _msg.height();
-    float f;
-    // cppchecker recommends using sizeof(varname)
-    unsigned int depthBufferSize = depthSamples * sizeof(f);
-
-    if (!this->dataPtr->depthBuffer)
-      this->dataPtr->depthBuffer = new float[depthSamples];
-    memcpy(this->dataPtr->depthBuffer, _msg.data().c_str(), depthBufferSize);
-
-    float maxDepth = 0;
-    for (unsigned int i = 0; i < _msg.height() * _msg.width(); ++i)
-    {
-      if (this->dataPtr->depthBuffer[i] > maxDepth &&
-          !std::isinf(this->dataPtr->depthBuffer[i]))
+      float maxDepth = 0;
+      for (const float d : depths)
       {
-        maxDepth = this->dataPtr->depthBuffer[i];
+        if (d > maxDepth && !std::isinf(d))
+          maxDepth = d;
       }
-    }
-    unsigned int idx = 0;
-    double factor = 255 / maxDepth;
-    for (unsigned int j = 0; j < _msg.height(); ++j)
-    {
-      for (unsigned int i = 0; i < _msg.width(); ++i)
+
+      // Near depths are bright
+      const float factor = maxDepth > 0 ? 255 / maxDepth : 0;
+      buffer.resize(pixels);
+      for (size_t i = 0; i < pixels; ++i)
       {
-        float d = this->dataPtr->depthBuffer[idx++];
-        d = 255 - (d * factor);
-        QRgb value = qRgb(d, d, d);
-        this->dataPtr->image.setPixel(i, j, value);
+        float d = 255 - depths[i] * factor;
+        d = d > 0 ? d : 0;
+        buffer[i] = static_cast<uint8_t>(d < 255 ? d : 255);
       }
+      converted = true;
+      break;
     }
-  }
-  // convert 16 bit camera images to rgb image format for display
-  else if (_msg.pixel_format() == common::Image::PixelFormat::L_INT16
-      || _msg.pixel_format() == common::Image::PixelFormat::RGB_INT16)
-  {
-    uint16_t u;
-    // cppchecker recommends using sizeof(varname)
-    unsigned int channels = _msg.step() / _msg.width() / sizeof(u);
-    unsigned int samples = _msg.width() * _msg.height() * channels;
-    unsigned int bufferSize = samples * sizeof(u);
-
-    if (!this->dataPtr->imageBuffer)
-      this->dataPtr->imageBuffer = new unsigned char[bufferSize];
-    memcpy(this->dataPtr->imageBuffer, _msg.data().c_str(), bufferSize);
-
-    // factor to convert from 16bit to 8bit value
-    double factor = 255 / (std::pow(2, 16) - 1);
-    uint16_t *uint16Buffer = reinterpret_cast<uint16_t *>(
-        this->dataPtr->imageBuffer);
-    int rgb[3] = {0, 0, 0};
-    unsigned int width = _msg.width()*channels;
-    for (unsigned int j = 0; j < _msg.height(); ++j)
+    case common::Image::PixelFormat::L_INT16:
+    case common::Image::PixelFormat::RGB_INT16:
     {
-      for (unsigned int i = 0; i < width; i+=channels)
+      // convert 16 bit camera images to 8 bit for display
+      const unsigned int channels16 =
+          _msg.step() / width / sizeof(uint16_t);
+      if (channels16 == 0 || dataSize < pixels * channels16 * 2)
+        return;
+      channels = channels16 < 3 ? 1 : 3;
+
+      std::vector<uint16_t> values(pixels * channels16);
+      memcpy(values.data(), data, values.size() * sizeof(uint16_t));
+
+      buffer.resize(pixels * channels);
+      for (size_t i = 0; i < pixels; ++i)
       {
-        u = uint16Buffer[j*width + i] * factor;
-        // for L16 we set rgb to be the same value
-        rgb[0] = rgb[1] = rgb[2] = u;
-        // handle the case for rgb16
-        for (unsigned int k = 1; k < channels; ++k)
+        for (unsigned int k = 0; k < channels; ++k)
         {
-          rgb[k] = uint16Buffer[j*width + i + k] * factor;
+          buffer[i * channels + k] = static_cast<uint8_t>(
+              values[i * channels16 + k] * 255u / 65535u);
         }
-        QRgb value = qRgb(rgb[0], rgb[1], rgb[2]);
-        this->dataPtr->image.setPixel(i/channels, j, value);
       }
+      converted = true;
+      break;
     }
+    default:
+      break;
   }
-  else
+
+  // 8 bit images are used as is, without the padding of their rows
+  if (!converted)
   {
-    const char *buffer = _msg.data().c_str();
-    for (int i = 0; i < this->dataPtr->image.height(); ++i)
-    {
-      memcpy(this->dataPtr->image.scanLine(i),
-          buffer + i*this->dataPtr->image.bytesPerLine(),
-          this->dataPtr->image.bytesPerLine());
-    }
+    const size_t rowSize = static_cast<size_t>(width) * channels;
+    const size_t step = std::max<size_t>(_msg.step(), rowSize);
+    if (dataSize < step * (height - 1) + rowSize)
+      return;
+
+    buffer.resize(pixels * channels);
+    for (unsigned int j = 0; j < height; ++j)
+      memcpy(&buffer[j * rowSize], data + j * step, rowSize);
+  }
+
+  // Scale large images down to the frame size here rather than on every
+  // paint. Smaller images are scaled up by the painter.
+  unsigned int dstWidth = width;
+  unsigned int dstHeight = height;
+  const int frameWidth = this->dataPtr->width;
+  const int frameHeight = this->dataPtr->height;
+  if (frameWidth > 0 && frameHeight > 0)
+  {
+    dstWidth = std::min(dstWidth, static_cast<unsigned int>(frameWidth));
+    dstHeight = std::min(dstHeight, static_cast<unsigned int>(frameHeight));
+  }
+
+  const uint8_t *pixelsData = buffer.data();
+  if (dstWidth != width || dstHeight != height)
+  {
+    this->dataPtr->scaled.resize(
+        static_cast<size_t>(dstWidth) * dstHeight * channels);
+    common::ImageConvert::Resize(buffer.data(), width, height, channels,
+        this->dataPtr->scaled.data(), dstWidth, dstHeight);
+    pixelsData = this->dataPtr->scaled.data();
+  }
+
+  QImage image(dstWidth, dstHeight,
+      channels == 1 ? QImage::Format_Grayscale8 : QImage::Format_RGB888);
+  const size_t dstRowSize = static_cast<size_t>(dstWidth) * channels;
+  for (unsigned int j = 0; j < dstHeight; ++j)
+    memcpy(image.scanLine(j), pixelsData + j * dstRowSize, dstRowSize);
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->image = image;
   }
-  this->update();
+
+  // Frames received faster than they're drawn replace each other, and
+  // only the latest one is drawn.
+  if (!this->dataPtr->updatePending.exchange(true))
+    QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
 }
@@ -40,7 +40,9 @@ namespace gazebo
       /// \brief Destructor
       public: virtual ~ImageFrame();
 
-      /// \brief Receives incoming image messages.
+      /// \brief Receives incoming image messages. The image is converted
+      /// and scaled to the frame size by the calling thread, and only the
+      /// latest image is drawn.
       /// \param[in] _msg New image message.
       public: void OnImage(const msgs::Image &_msg);
 
@@ -48,6 +50,10 @@ namespace gazebo
       /// \param[in] _event Pointer to the event information.
       protected: void paintEvent(QPaintEvent *_event);
 
+      /// \brief Event used to keep track of the frame size.
+      /// \param[in] _event Pointer to the event information.
+      protected: void resizeEvent(QResizeEvent *_event);
+
       /// \brief Pointer to private data
       private: std::unique_ptr<ImageFramePrivate> dataPtr;
     };
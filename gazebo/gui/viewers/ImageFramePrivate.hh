@@ -17,7 +17,11 @@
 #ifndef GAZEBO_GUI_VIEWERS_IMAGEFRAMEPRIVATE_HH_
 #define GAZEBO_GUI_VIEWERS_IMAGEFRAMEPRIVATE_HH_
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <vector>
+
 #include "gazebo/gui/qt.h"
 
 namespace gazebo
@@ -26,17 +30,29 @@ namespace gazebo
   {
     class ImageFramePrivate
     {
-      /// \brief The image to draw.
+      /// \brief The latest converted image, which is drawn.
       public: QImage image;
 
       /// \brief Mutex for protecting the image.
       public: std::mutex mutex;
 
-      /// \brief Depth camera image data buffer.
-      public: float *depthBuffer = nullptr;
+      /// \brief Mutex for protecting the conversion buffers.
+      public: std::mutex convertMutex;
+
+      /// \brief 8 bit pixels of the latest message, before scaling.
+      public: std::vector<uint8_t> buffer;
+
+      /// \brief Scaled pixels of the latest message.
+      public: std::vector<uint8_t> scaled;
+
+      /// \brief Width of the frame contents, used to scale images.
+      public: std::atomic<int> width{0};
+
+      /// \brief Height of the frame contents, used to scale images.
+      public: std::atomic<int> height{0};
 
-      /// \brief Camera image data buffer.
-      public: unsigned char *imageBuffer = nullptr;
+      /// \brief True if a repaint was requested and not done yet.
+      public: std::atomic<bool> updatePending{false};
     };
   }
 }
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Image.hh"
+#include "gazebo/gui/viewers/ImageFrame.hh"
+#include "gazebo/gui/viewers/ImageFrame_TEST.hh"
+
+/////////////////////////////////////////////////
+/// \brief Create an image message.
+/// \param[in] _width Image width.
+/// \param[in] _height Image height.
+/// \param[in] _format Pixel format.
+/// \param[in] _step Size of a row in bytes.
+/// \param[in] _data Image data.
+/// \param[in] _size Size of the image data in bytes.
+/// \return The message.
+gazebo::msgs::Image ImageMsg(const unsigned int _width,
+    const unsigned int _height,
+    const gazebo::common::Image::PixelFormat _format,
+    const unsigned int _step, const void *_data, const size_t _size)
+{
+  gazebo::msgs::Image msg;
+  msg.set_width(_width);
+  msg.set_height(_height);
+  msg.set_pixel_format(_format);
+  msg.set_step(_step);
+  msg.set_data(std::string(static_cast<const char *>(_data), _size));
+  return msg;
+}
+
+/////////////////////////////////////////////////
+/// \brief Draw a frame into an image.
+/// \param[in] _frame The frame.
+/// \return What the frame draws.
+QImage Draw(gazebo::gui::ImageFrame *_frame)
+{
+  // Run the queued repaint, then draw the frame
+  QCoreApplication::processEvents();
+  return _frame->grab().toImage();
+}
+
+/////////////////////////////////////////////////
+void ImageFrame_TEST::Image8Bit()
+{
+  gazebo::gui::ImageFrame frame(nullptr);
+  frame.resize(3, 2);
+  frame.show();
+  QCoreApplication::processEvents();
+  QCOMPARE(frame.contentsRect().width(), 3);
+
+  // 3x2 RGB image with rows padded to 12 bytes
+  std::vector<uint8_t> rgb(12 * 2, 0xAB);
+  const uint8_t colors[6][3] = {
+    {255, 0, 0}, {0, 255, 0}, {0, 0, 255},
+    {10, 20, 30}, {40, 50, 60}, {70, 80, 90}};
+  for (int j = 0; j < 2; ++j)
+  {
+    for (int i = 0; i < 3; ++i)
+      memcpy(&rgb[j * 12 + i * 3], colors[j * 3 + i], 3);
+  }
+  frame.OnImage(ImageMsg(3, 2, gazebo::common::Image::RGB_INT8, 12,
+      rgb.data(), rgb.size()));
+
+  QImage image = Draw(&frame);
+  for (int j = 0; j < 2; ++j)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      const uint8_t *c = colors[j * 3 + i];
+      QCOMPARE(image.pixel(i, j), qRgb(c[0], c[1], c[2]));
+    }
+  }
+
+  // Gray image
+  const uint8_t gray[6] = {0, 50, 100, 150, 200, 255};
+  frame.OnImage(ImageMsg(3, 2, gazebo::common::Image::L_INT8, 3,
+      gray, sizeof(gray)));
+  image = Draw(&frame);
+  for (int k = 0; k < 6; ++k)
+    QCOMPARE(image.pixel(k % 3, k / 3), qRgb(gray[k], gray[k], gray[k]));
+
+  // Truncated images are ignored, and the previous image stays
+  frame.OnImage(ImageMsg(3, 2, gazebo::common::Image::RGB_INT8, 12,
+      rgb.data(), 12));
+  image = Draw(&frame);
+  QCOMPARE(image.pixel(0, 0), qRgb(0, 0, 0));
+}
+
+/////////////////////////////////////////////////
+void ImageFrame_TEST::ImageConverted()
+{
+  gazebo::gui::ImageFrame frame(nullptr);
+  frame.resize(2, 1);
+  frame.show();
+  QCoreApplication::processEvents();
+
+  // 16 bit values are scaled to 8 bits
+  const uint16_t gray16[2] = {0, 65535};
+  frame.OnImage(ImageMsg(2, 1, gazebo::common::Image::L_INT16, 4,
+      gray16, sizeof(gray16)));
+  QImage image = Draw(&frame);
+  QCOMPARE(image.pixel(0, 0), qRgb(0, 0, 0));
+  QCOMPARE(image.pixel(1, 0), qRgb(255, 255, 255));
+
+  const uint16_t rgb16[6] = {65535, 0, 0, 0, 0, 65535};
+  frame.OnImage(ImageMsg(2, 1, gazebo::common::Image::RGB_INT16, 12,
+      rgb16, sizeof(rgb16)));
+  image = Draw(&frame);
+  QCOMPARE(image.pixel(0, 0), qRgb(255, 0, 0));
+  QCOMPARE(image.pixel(1, 0), qRgb(0, 0, 255));
+
+  // Near depths are bright, and infinite depths are ignored when finding
+  // the farthest one
+  const float depths[2] = {0.0f, 4.0f};
+  frame.OnImage(ImageMsg(2, 1, gazebo::common::Image::R_FLOAT32, 8,
+      depths, sizeof(depths)));
+  image = Draw(&frame);
+  QCOMPARE(image.pixel(0, 0), qRgb(255, 255, 255));
+  QCOMPARE(image.pixel(1, 0), qRgb(0, 0, 0));
+
+  const float infDepths[2] = {2.0f, std::numeric_limits<float>::infinity()};
+  frame.OnImage(ImageMsg(2, 1, gazebo::common::Image::R_FLOAT32, 8,
+      infDepths, sizeof(infDepths)));
+  image = Draw(&frame);
+  QCOMPARE(image.pixel(0, 0), qRgb(0, 0, 0));
+  QCOMPARE(image.pixel(1, 0), qRgb(0, 0, 0));
+}
+
+/////////////////////////////////////////////////
+void ImageFrame_TEST::ScaleDown()
+{
+  gazebo::gui::ImageFrame frame(nullptr);
+  frame.resize(4, 4);
+  frame.show();
+  QCoreApplication::processEvents();
+
+  // Left half red, right half blue
+  const unsigned int size = 64;
+  std::vector<uint8_t> rgb(size * size * 3, 0);
+  for (unsigned int j = 0; j < size; ++j)
+  {
+    for (unsigned int i = 0; i < size; ++i)
+      rgb[(j * size + i) * 3 + (i < size / 2 ? 0 : 2)] = 255;
+  }
+  frame.OnImage(ImageMsg(size, size, gazebo::common::Image::RGB_INT8,
+      size * 3, rgb.data(), rgb.size()));
+
+  QImage image = Draw(&frame);
+  QCOMPARE(image.width(), 4);
+  for (int j = 0; j < 4; ++j)
+  {
+    QCOMPARE(image.pixel(0, j), qRgb(255, 0, 0));
+    QCOMPARE(image.pixel(3, j), qRgb(0, 0, 255));
+  }
+}
+
+/////////////////////////////////////////////////
+void ImageFrame_TEST::LatestOnly()
+{
+  gazebo::gui::ImageFrame frame(nullptr);
+  frame.resize(1, 1);
+  frame.show();
+  QCoreApplication::processEvents();
+
+  // Images received before the frame is drawn replace each other
+  for (uint8_t value = 0; value <= 100; value += 10)
+  {
+    frame.OnImage(ImageMsg(1, 1, gazebo::common::Image::L_INT8, 1,
+        &value, 1));
+  }
+  QImage image = Draw(&frame);
+  QCOMPARE(image.pixel(0, 0), qRgb(100, 100, 100));
+}
+
+// Generate a main function for the test
+QTEST_MAIN(ImageFrame_TEST)
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GAZEBO_GUI_VIEWERS_IMAGEFRAME_TEST_HH_
+#define GAZEBO_GUI_VIEWERS_IMAGEFRAME_TEST_HH_
+
+#include "gazebo/gui/QTestFixture.hh"
+
+/// \brief A test class for the ImageFrame widget.
+class ImageFrame_TEST : public QTestFixture
+{
+  Q_OBJECT
+
+  /// \brief Test drawing 8 bit images, with padded rows.
+  private slots: void Image8Bit();
+
+  /// \brief Test drawing 16 bit and depth images.
+  private slots: void ImageConverted();
+
+  /// \brief Test that images larger than the frame are scaled down.
+  private slots: void ScaleDown();
+
+  /// \brief Test that only the latest image is drawn.
+  private slots: void LatestOnly();
+};
+#endif
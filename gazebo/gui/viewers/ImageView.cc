@@ -16,9 +16,11 @@
  */
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Node.hh"
+#include "gazebo/transport/SubscribeOptions.hh"
 #include "gazebo/transport/Publisher.hh"
 
 #include "gazebo/common/Image.hh"
+#include "gazebo/rendering/RenderingIface.hh"
 
 #include "gazebo/gui/viewers/ViewFactory.hh"
 #include "gazebo/gui/viewers/ImageViewPrivate.hh"
@@ -27,6 +29,10 @@
 using namespace gazebo;
 using namespace gui;
 
+/// \brief Rate in Hz at which remote clients receive images, see
+/// rendering::set_remote_client.
+static const double REMOTE_IMAGE_RATE = 5.0;
+
 GZ_REGISTER_STATIC_VIEWER("gazebo.msgs.ImageStamped", ImageView)
 
 /////////////////////////////////////////////////
@@ -61,8 +67,17 @@ void ImageView::SetTopic(const std::string &_topicName)
 {
   TopicView::SetTopic(_topicName);
 
-  // Subscribe to the new topic.
-  this->sub = this->node->Subscribe(_topicName, &ImageView::OnImage, this);
+  // Subscribe to the new topic. Only the latest image is drawn, so ask
+  // the publisher to drop the images we can't keep up with.
+  transport::SubscribeOptions limits;
+  limits.SetLatestOnly(true);
+  if (rendering::remote_client())
+  {
+    limits.SetMaxRate(REMOTE_IMAGE_RATE);
+    limits.SetCodec("zlib");
+  }
+  this->sub = this->node->Subscribe(_topicName, &ImageView::OnImage, this,
+      limits);
 }
 
 /////////////////////////////////////////////////
@@ -17,8 +17,10 @@
 #include <memory>
 
 #include "gazebo/transport/Node.hh"
+#include "gazebo/transport/SubscribeOptions.hh"
 
 #include "gazebo/common/Image.hh"
+#include "gazebo/rendering/RenderingIface.hh"
 
 #include "gazebo/gui/viewers/ViewFactory.hh"
 #include "gazebo/gui/viewers/ImagesViewPrivate.hh"
@@ -27,6 +29,10 @@
 using namespace gazebo;
 using namespace gui;
 
+/// \brief Rate in Hz at which remote clients receive images, see
+/// rendering::set_remote_client.
+static const double REMOTE_IMAGE_RATE = 5.0;
+
 GZ_REGISTER_STATIC_VIEWER("gazebo.msgs.ImagesStamped", ImagesView)
 
 /////////////////////////////////////////////////
@@ -104,9 +110,20 @@ void ImagesView::SetTopic(const std::string &_topicName)
 
   TopicView::SetTopic(_topicName);
 
-  // Subscribe to the new topic.
+  // Subscribe to the new topic. Only the latest images are drawn, so ask
+  // the publisher to drop the images we can't keep up with.
   if (this->node)
-    this->sub = this->node->Subscribe(_topicName, &ImagesView::OnImages, this);
+  {
+    transport::SubscribeOptions limits;
+    limits.SetLatestOnly(true);
+    if (rendering::remote_client())
+    {
+      limits.SetMaxRate(REMOTE_IMAGE_RATE);
+      limits.SetCodec("zlib");
+    }
+    this->sub = this->node->Subscribe(_topicName, &ImagesView::OnImages,
+        this, limits);
+  }
 }
 
 /////////////////////////////////////////////////
@@ -17,6 +17,9 @@
 
 #include <google/protobuf/descriptor.h>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/MassMatrix3.hh>
 #include <ignition/math/Rand.hh>
 
@@ -37,6 +40,11 @@ namespace gazebo
     /// \param[in] _sdf sdf::ElementPtr to fill with data.
     void AxisToSDF(const msgs::Axis &_msg, sdf::ElementPtr _sdf);
 
+    /// \brief Custom element of a mesh holding the distances of its levels
+    /// of detail, since SDF doesn't describe them. Custom elements read by
+    /// gazebo share the gz prefix, see also <gz:ccd> in Link.
+    static const std::string LOD_DISTANCES_ELEMENT = "gz:lod_distances";
+
     /////////////////////////////////////////////
     /// Create a request message
     msgs::Request *CreateRequest(const std::string &_request,
@@ -160,6 +168,96 @@ namespace gazebo
       Set(_p->mutable_orientation(), _v.Rot());
     }
 
+    /// \brief Number of bits of each component of a packed orientation.
+    static const unsigned int COMPACT_ROT_BITS = 20;
+
+    /// \brief Largest value of a component of a packed orientation.
+    static const uint64_t COMPACT_ROT_MAX = (1u << COMPACT_ROT_BITS) - 1;
+
+    /// \brief Largest absolute value of the components of a unit
+    /// quaternion that are not its largest one.
+    static const double COMPACT_ROT_RANGE = 1.0 / std::sqrt(2.0);
+
+    /////////////////////////////////////////////
+    void AddCompactPose(msgs::PosesCompact &_msg, const uint32_t _id,
+        const ignition::math::Pose3d &_pose)
+    {
+      if (_msg.position_precision() <= 0)
+        _msg.set_position_precision(1e-4);
+      const double precision = _msg.position_precision();
+
+      _msg.add_id(_id);
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const double v = _pose.Pos()[i];
+        _msg.add_position(std::isfinite(v) ?
+            static_cast<int64_t>(std::llround(v / precision)) : 0);
+      }
+
+      ignition::math::Quaterniond rot = _pose.Rot();
+      rot.Normalize();
+      const double q[4] = {rot.W(), rot.X(), rot.Y(), rot.Z()};
+      unsigned int largest = 0;
+      for (unsigned int i = 1; i < 4; ++i)
+      {
+        if (std::abs(q[i]) > std::abs(q[largest]))
+          largest = i;
+      }
+
+      // q and -q are the same rotation, so the largest component is made
+      // positive and left out
+      const double sign = q[largest] < 0 ? -1.0 : 1.0;
+      uint64_t packed = largest;
+      for (unsigned int i = 0; i < 4; ++i)
+      {
+        if (i == largest)
+          continue;
+        const double v = ignition::math::clamp(sign * q[i] / COMPACT_ROT_RANGE,
+            -1.0, 1.0);
+        packed = (packed << COMPACT_ROT_BITS) |
+            static_cast<uint64_t>(std::llround((v + 1.0) * 0.5 *
+            COMPACT_ROT_MAX));
+      }
+      _msg.add_orientation(packed);
+    }
+
+    /////////////////////////////////////////////
+    ignition::math::Pose3d CompactPose(const msgs::PosesCompact &_msg,
+        const int _index)
+    {
+      if (_index < 0 || _msg.position_size() < (_index + 1) * 3 ||
+          _msg.orientation_size() <= _index)
+      {
+        return ignition::math::Pose3d::Zero;
+      }
+
+      const double precision = _msg.position_precision();
+      ignition::math::Vector3d pos(
+          _msg.position(_index * 3) * precision,
+          _msg.position(_index * 3 + 1) * precision,
+          _msg.position(_index * 3 + 2) * precision);
+
+      uint64_t packed = _msg.orientation(_index);
+      const unsigned int largest =
+          static_cast<unsigned int>(packed >> (3 * COMPACT_ROT_BITS)) & 3;
+      double q[4];
+      double sum = 0;
+      for (int i = 3; i >= 0; --i)
+      {
+        if (static_cast<unsigned int>(i) == largest)
+          continue;
+        const double v = static_cast<double>(packed & COMPACT_ROT_MAX) /
+            COMPACT_ROT_MAX * 2.0 - 1.0;
+        q[i] = v * COMPACT_ROT_RANGE;
+        sum += q[i] * q[i];
+        packed >>= COMPACT_ROT_BITS;
+      }
+      q[largest] = std::sqrt(std::max(0.0, 1.0 - sum));
+
+      return ignition::math::Pose3d(pos,
+          ignition::math::Quaterniond(q[0], q[1], q[2], q[3]));
+    }
+
     /////////////////////////////////////////////
     void Set(msgs::Color *_c, const ignition::math::Color &_v)
     {
@@ -888,6 +986,16 @@ namespace gazebo
           }
         }
 
+        if (_sdf->HasElement(LOD_DISTANCES_ELEMENT) &&
+            _sdf->GetElement(LOD_DISTANCES_ELEMENT)->GetValue())
+        {
+          std::istringstream stream(_sdf->GetElement(
+                LOD_DISTANCES_ELEMENT)->GetValue()->GetAsString());
+          double distance;
+          while (stream >> distance)
+            result.add_lod_distance(distance);
+        }
+
       return result;
     }
 
@@ -2903,6 +3011,29 @@ namespace gazebo
       {
         meshSDF->GetElement("scale")->Set(ConvertIgn(_msg.scale()));
       }
+      if (_msg.lod_distance_size() > 0)
+      {
+        std::ostringstream stream;
+        for (int i = 0; i < _msg.lod_distance_size(); ++i)
+          stream << (i > 0 ? " " : "") << _msg.lod_distance(i);
+
+        // The element is not part of the description of a mesh, add it
+        // the way sdformat adds custom elements.
+        sdf::ElementPtr lodElem;
+        if (meshSDF->HasElement(LOD_DISTANCES_ELEMENT))
+        {
+          lodElem = meshSDF->GetElement(LOD_DISTANCES_ELEMENT);
+        }
+        else
+        {
+          lodElem.reset(new sdf::Element);
+          lodElem->SetName(LOD_DISTANCES_ELEMENT);
+          lodElem->AddValue("string", "", false, "Level of detail distances");
+          lodElem->SetParent(meshSDF);
+          meshSDF->InsertElement(lodElem);
+        }
+        lodElem->GetValue()->SetFromString(stream.str());
+      }
       return meshSDF;
     }
 
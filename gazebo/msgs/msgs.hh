@@ -340,6 +340,25 @@ namespace gazebo
     GAZEBO_VISIBLE
     void Set(msgs::PlaneGeom *_p, const ignition::math::Planed &_v);
 
+    /// \brief Append a pose to a msgs::PosesCompact, with its position
+    /// quantized to the position precision of the message and its
+    /// orientation packed into 64 bits.
+    /// \param[in,out] _msg The message, whose position precision is set.
+    /// \param[in] _id Id of the entity.
+    /// \param[in] _pose The pose.
+    GAZEBO_VISIBLE
+    void AddCompactPose(msgs::PosesCompact &_msg, const uint32_t _id,
+        const ignition::math::Pose3d &_pose);
+
+    /// \brief Get a pose of a msgs::PosesCompact.
+    /// \param[in] _msg The message.
+    /// \param[in] _index Index of the pose, less than the size of the id
+    /// field.
+    /// \return The pose, identity if the message is truncated.
+    GAZEBO_VISIBLE
+    ignition::math::Pose3d CompactPose(const msgs::PosesCompact &_msg,
+        const int _index);
+
     /// \brief Create a msgs::TrackVisual from a track visual SDF element
     /// \param[in] _sdf The sdf element
     /// \return The new msgs::TrackVisual object
@@ -246,6 +246,46 @@ TEST_F(MsgsTest, ConvertMsgsQuaternionToMath)
   EXPECT_DOUBLE_EQ(v.W(), 0.27059805007309851);
 }
 
+TEST_F(MsgsTest, CompactPose)
+{
+  msgs::PosesCompact msg;
+  msgs::Set(msg.mutable_time(), common::Time(1, 0));
+  msg.set_position_precision(1e-3);
+
+  const ignition::math::Pose3d poses[] = {
+    ignition::math::Pose3d(1.2345, -20.5, 0.0004, 0.1, -0.2, 0.3),
+    ignition::math::Pose3d(0, 0, 0, M_PI, 0, 0),
+    ignition::math::Pose3d(-1000, 3, 7, 0.5, 1.2, -2.9),
+    ignition::math::Pose3d(0, 0, 0, 0, 0, -M_PI * 0.5)};
+  for (unsigned int i = 0; i < 4; ++i)
+    msgs::AddCompactPose(msg, i + 10, poses[i]);
+
+  ASSERT_EQ(msg.id_size(), 4);
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(msg.id(i), static_cast<uint32_t>(i + 10));
+    const ignition::math::Pose3d pose = msgs::CompactPose(msg, i);
+    EXPECT_LE(pose.Pos().Distance(poses[i].Pos()), 1e-3);
+
+    // Same rotation, possibly with the opposite sign
+    EXPECT_NEAR(std::abs(pose.Rot().Dot(poses[i].Rot())), 1.0, 1e-6);
+  }
+
+  // Out of range
+  EXPECT_EQ(msgs::CompactPose(msg, 4), ignition::math::Pose3d::Zero);
+
+  // Smaller than the full poses
+  msgs::PosesStamped full;
+  msgs::Set(full.mutable_time(), common::Time(1, 0));
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    msgs::Pose *pose = full.add_pose();
+    pose->set_id(i + 10);
+    msgs::Set(pose, poses[i]);
+  }
+  EXPECT_LT(msg.ByteSize() * 2, full.ByteSize());
+}
+
 TEST_F(MsgsTest, ConvertPoseMathToMsgs)
 {
   msgs::Pose msg = msgs::Convert(ignition::math::Pose3d(
@@ -2796,6 +2836,31 @@ TEST_F(MsgsTest, MeshToSDF)
   EXPECT_FALSE(meshSDF2->HasElement("submesh"));
 }
 
+/////////////////////////////////////////////////
+TEST_F(MsgsTest, MeshLodDistances)
+{
+  msgs::MeshGeom msg;
+  msg.set_filename("test_filename");
+  msg.add_lod_distance(10);
+  msg.add_lod_distance(25.5);
+
+  // The distances are kept through a custom element of the mesh
+  sdf::ElementPtr meshSDF = msgs::MeshToSDF(msg);
+  EXPECT_TRUE(meshSDF->HasElement("gz:lod_distances"));
+
+  msgs::MeshGeom msg2 = msgs::MeshFromSDF(meshSDF);
+  ASSERT_EQ(msg2.lod_distance_size(), 2);
+  EXPECT_DOUBLE_EQ(msg2.lod_distance(0), 10);
+  EXPECT_DOUBLE_EQ(msg2.lod_distance(1), 25.5);
+
+  // No distances
+  msgs::MeshGeom msg3;
+  msg3.set_filename("test_filename");
+  sdf::ElementPtr meshSDF3 = msgs::MeshToSDF(msg3);
+  EXPECT_FALSE(meshSDF3->HasElement("gz:lod_distances"));
+  EXPECT_EQ(msgs::MeshFromSDF(meshSDF3).lod_distance_size(), 0);
+}
+
 /////////////////////////////////////////////////
 TEST_F(MsgsTest, InertialToSDF)
 {
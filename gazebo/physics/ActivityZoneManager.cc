@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/ActivityZoneManager.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A frozen model.
+    class FrozenModel
+    {
+      /// \brief The model.
+      public: ModelPtr model;
+
+      /// \brief Refresh counter value when the model was last seen.
+      public: uint64_t stamp = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the ActivityZoneManager class
+    class ActivityZoneManagerPrivate
+    {
+      /// \brief Get the key of a tile.
+      /// \param[in] _x Tile index along x.
+      /// \param[in] _y Tile index along y.
+      /// \return Key of the tile in the index.
+      public: static int64_t TileKey(const int64_t _x, const int64_t _y)
+      {
+        return static_cast<int64_t>(
+            (static_cast<uint64_t>(_x) << 32) ^
+            (static_cast<uint64_t>(_y) & 0xffffffffu));
+      }
+
+      /// \brief Get the tile index of a coordinate.
+      /// \param[in] _v Coordinate in meters.
+      /// \return Tile index.
+      public: int64_t TileIndex(const double _v) const
+      {
+        return static_cast<int64_t>(std::floor(_v / this->tileSize));
+      }
+
+      /// \brief Freeze or unfreeze a model and its nested models through
+      /// the FreezeRegistry of its world, so that the other reasons to
+      /// freeze the model are kept.
+      /// \param[in] _model The model.
+      /// \param[in] _frozen True to freeze.
+      public: static void SetFrozen(const ModelPtr &_model,
+                  const bool _frozen)
+      {
+        FreezeRegistry &freezes = _model->GetWorld()->Freezes();
+        if (_frozen)
+          freezes.Freeze(_model, "activity_zones");
+        else
+          freezes.Unfreeze(_model, "activity_zones");
+      }
+
+      /// \brief True when enabled.
+      public: bool enabled = false;
+
+      /// \brief True when the activity must be refreshed on the next
+      /// update, regardless of the refresh period.
+      public: bool dirty = true;
+
+      /// \brief Tile side length.
+      public: double tileSize = 50.0;
+
+      /// \brief Iterations between refreshes.
+      public: unsigned int refreshPeriod = 10;
+
+      /// \brief Iterations between updates of inactive models.
+      public: unsigned int inactiveUpdatePeriod = 10;
+
+      /// \brief True to defer the plugins of inactive models.
+      public: bool deferPlugins = false;
+
+      /// \brief Radius of the zones, by model name.
+      public: std::map<std::string, double> zones;
+
+      /// \brief Models of every tile. Vectors are kept between refreshes
+      /// to avoid reallocating them.
+      public: std::unordered_map<int64_t, Model_V> tiles;
+
+      /// \brief Ids of the models that are in an active tile.
+      public: std::unordered_set<uint32_t> active;
+
+      /// \brief Frozen models, by id.
+      public: std::unordered_map<uint32_t, FrozenModel> frozen;
+
+      /// \brief Current world iteration.
+      public: uint64_t iteration = 0;
+
+      /// \brief Refresh counter.
+      public: uint64_t stamp = 0;
+
+      /// \brief Number of active non static models.
+      public: unsigned int activeCount = 0;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+ActivityZoneManager::ActivityZoneManager()
+  : dataPtr(new ActivityZoneManagerPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ActivityZoneManager::~ActivityZoneManager()
+{
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::SetEnabled(const bool _enabled)
+{
+  if (_enabled == this->dataPtr->enabled)
+    return;
+
+  this->dataPtr->enabled = _enabled;
+  this->dataPtr->dirty = true;
+
+  if (!_enabled)
+  {
+    for (auto const &frozen : this->dataPtr->frozen)
+      ActivityZoneManagerPrivate::SetFrozen(frozen.second.model, false);
+    this->dataPtr->frozen.clear();
+    this->dataPtr->tiles.clear();
+    this->dataPtr->active.clear();
+    this->dataPtr->activeCount = 0;
+  }
+}
+
+//////////////////////////////////////////////////
+bool ActivityZoneManager::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::SetTileSize(const double _size)
+{
+  if (_size <= 0)
+  {
+    gzerr << "Tile size must be positive, got [" << _size << "]\n";
+    return;
+  }
+
+  this->dataPtr->tileSize = _size;
+  this->dataPtr->tiles.clear();
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+double ActivityZoneManager::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::SetRefreshPeriod(const unsigned int _iterations)
+{
+  this->dataPtr->refreshPeriod = std::max(1u, _iterations);
+}
+
+//////////////////////////////////////////////////
+unsigned int ActivityZoneManager::RefreshPeriod() const
+{
+  return this->dataPtr->refreshPeriod;
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::SetInactiveUpdatePeriod(
+    const unsigned int _iterations)
+{
+  this->dataPtr->inactiveUpdatePeriod = _iterations;
+}
+
+//////////////////////////////////////////////////
+unsigned int ActivityZoneManager::InactiveUpdatePeriod() const
+{
+  return this->dataPtr->inactiveUpdatePeriod;
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::SetDeferPlugins(const bool _defer)
+{
+  this->dataPtr->deferPlugins = _defer;
+}
+
+//////////////////////////////////////////////////
+bool ActivityZoneManager::DeferPlugins() const
+{
+  return this->dataPtr->deferPlugins;
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::SetZone(const std::string &_modelName,
+    const double _radius)
+{
+  this->dataPtr->zones[_modelName] = std::max(0.0, _radius);
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+bool ActivityZoneManager::RemoveZone(const std::string &_modelName)
+{
+  this->dataPtr->dirty = true;
+  return this->dataPtr->zones.erase(_modelName) > 0;
+}
+
+//////////////////////////////////////////////////
+unsigned int ActivityZoneManager::ZoneCount() const
+{
+  return this->dataPtr->zones.size();
+}
+
+//////////////////////////////////////////////////
+bool ActivityZoneManager::IsActive(const ModelPtr &_model) const
+{
+  if (!this->dataPtr->enabled || !_model)
+    return true;
+
+  return this->dataPtr->frozen.find(_model->GetId()) ==
+      this->dataPtr->frozen.end();
+}
+
+//////////////////////////////////////////////////
+unsigned int ActivityZoneManager::ActiveModelCount() const
+{
+  return this->dataPtr->activeCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int ActivityZoneManager::InactiveModelCount() const
+{
+  return this->dataPtr->frozen.size();
+}
+
+//////////////////////////////////////////////////
+bool ActivityZoneManager::ShouldUpdate(const ModelPtr &_model) const
+{
+  if (this->IsActive(_model))
+    return true;
+
+  const unsigned int period = this->dataPtr->inactiveUpdatePeriod;
+  return period > 0 && this->dataPtr->iteration % period == 0;
+}
+
+//////////////////////////////////////////////////
+void ActivityZoneManager::Update(const Model_V &_models,
+    const uint64_t _iteration)
+{
+  this->dataPtr->iteration = _iteration;
+
+  if (!this->dataPtr->enabled)
+    return;
+
+  if (!this->dataPtr->dirty &&
+      _iteration % this->dataPtr->refreshPeriod != 0)
+  {
+    return;
+  }
+  this->dataPtr->dirty = false;
+
+  const uint64_t stamp = ++this->dataPtr->stamp;
+
+  // Rebuild the spatial index, and find the models that own a zone.
+  for (auto &tile : this->dataPtr->tiles)
+    tile.second.clear();
+
+  std::vector<std::pair<ignition::math::Vector3d, double>> zoneCenters;
+  for (auto const &model : _models)
+  {
+    if (model->IsStatic())
+      continue;
+
+    const ignition::math::Vector3d &pos = model->WorldPose().Pos();
+    const int64_t key = ActivityZoneManagerPrivate::TileKey(
+        this->dataPtr->TileIndex(pos.X()), this->dataPtr->TileIndex(pos.Y()));
+    this->dataPtr->tiles[key].push_back(model);
+
+    auto zone = this->dataPtr->zones.find(model->GetName());
+    if (zone != this->dataPtr->zones.end())
+      zoneCenters.push_back(std::make_pair(pos, zone->second));
+  }
+
+  // Activate the models of the tiles covered by a zone.
+  this->dataPtr->active.clear();
+  for (auto const &zone : zoneCenters)
+  {
+    const ignition::math::Vector3d &c = zone.first;
+    const double r = zone.second;
+    const int64_t minX = this->dataPtr->TileIndex(c.X() - r);
+    const int64_t maxX = this->dataPtr->TileIndex(c.X() + r);
+    const int64_t minY = this->dataPtr->TileIndex(c.Y() - r);
+    const int64_t maxY = this->dataPtr->TileIndex(c.Y() + r);
+
+    for (int64_t x = minX; x <= maxX; ++x)
+    {
+      for (int64_t y = minY; y <= maxY; ++y)
+      {
+        auto tile = this->dataPtr->tiles.find(
+            ActivityZoneManagerPrivate::TileKey(x, y));
+        if (tile == this->dataPtr->tiles.end())
+          continue;
+
+        for (auto const &model : tile->second)
+          this->dataPtr->active.insert(model->GetId());
+      }
+    }
+  }
+
+  // Freeze models that left the active tiles, and unfreeze the others.
+  this->dataPtr->activeCount = 0;
+  for (auto const &tile : this->dataPtr->tiles)
+  {
+    for (auto const &model : tile.second)
+    {
+      const uint32_t id = model->GetId();
+      auto frozen = this->dataPtr->frozen.find(id);
+      if (this->dataPtr->active.count(id))
+      {
+        this->dataPtr->activeCount++;
+        if (frozen != this->dataPtr->frozen.end())
+        {
+          ActivityZoneManagerPrivate::SetFrozen(model, false);
+          this->dataPtr->frozen.erase(frozen);
+        }
+      }
+      else if (frozen == this->dataPtr->frozen.end())
+      {
+        ActivityZoneManagerPrivate::SetFrozen(model, true);
+        FrozenModel &entry = this->dataPtr->frozen[id];
+        entry.model = model;
+        entry.stamp = stamp;
+      }
+      else
+      {
+        frozen->second.stamp = stamp;
+      }
+    }
+  }
+
+  // Forget the models that were removed from the world.
+  for (auto iter = this->dataPtr->frozen.begin();
+       iter != this->dataPtr->frozen.end();)
+  {
+    if (iter->second.stamp != stamp)
+      iter = this->dataPtr->frozen.erase(iter);
+    else
+      ++iter;
+  }
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ACTIVITYZONEMANAGER_HH_
+#define GAZEBO_PHYSICS_ACTIVITYZONEMANAGER_HH_
+
+#include <memory>
+#include <string>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class ActivityZoneManagerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class ActivityZoneManager ActivityZoneManager.hh physics/physics.hh
+    /// \brief Tile based update of very large worlds.
+    ///
+    /// The ground plane is split into square tiles, and models are indexed
+    /// by the tile that contains their origin. Activity zones are circles
+    /// that follow a model, typically a robot. Tiles that overlap an
+    /// activity zone are active; models in the other tiles are inactive.
+    ///
+    /// Inactive models are frozen in the physics engine (their links are
+    /// frozen with the "activity_zones" reason of the FreezeRegistry of the
+    /// world, so the engine skips them in collision and integration) and
+    /// their Model::Update, which runs their plugins and joint controllers,
+    /// is only called once every InactiveUpdatePeriod iterations. Models
+    /// that own a zone are always active. Static models are not affected.
+    ///
+    /// The manager is owned by the World and disabled by default, see
+    /// World::ActivityZones. The ActivityZonePlugin world plugin configures
+    /// it from SDF.
+    class GZ_PHYSICS_VISIBLE ActivityZoneManager
+    {
+      /// \brief Constructor.
+      public: ActivityZoneManager();
+
+      /// \brief Destructor.
+      public: ~ActivityZoneManager();
+
+      /// \brief Enable or disable the tile based update. Disabling
+      /// unfreezes every model.
+      /// \param[in] _enabled True to enable.
+      public: void SetEnabled(const bool _enabled);
+
+      /// \brief Get whether the tile based update is enabled.
+      /// \return True if enabled.
+      public: bool Enabled() const;
+
+      /// \brief Set the size of the tiles of the spatial index.
+      /// \param[in] _size Side length of a tile in meters.
+      public: void SetTileSize(const double _size);
+
+      /// \brief Get the size of the tiles of the spatial index.
+      /// \return Side length of a tile in meters.
+      public: double TileSize() const;
+
+      /// \brief Set how often the spatial index and the activity of the
+      /// models are refreshed.
+      /// \param[in] _iterations Number of world iterations between
+      /// refreshes, at least 1.
+      public: void SetRefreshPeriod(const unsigned int _iterations);
+
+      /// \brief Get how often the spatial index is refreshed.
+      /// \return Number of world iterations between refreshes.
+      public: unsigned int RefreshPeriod() const;
+
+      /// \brief Set how often inactive models are updated.
+      /// \param[in] _iterations Number of world iterations between calls
+      /// to Model::Update of inactive models. Zero never updates them.
+      public: void SetInactiveUpdatePeriod(const unsigned int _iterations);
+
+      /// \brief Get how often inactive models are updated.
+      /// \return Number of world iterations between updates.
+      public: unsigned int InactiveUpdatePeriod() const;
+
+      /// \brief Defer the model plugins of models that are inactive when the
+      /// world loads its plugins, until the models first become active.
+      /// Plugins of models spawned later are not deferred.
+      /// \param[in] _defer True to defer the plugins. The default is false.
+      public: void SetDeferPlugins(const bool _defer);
+
+      /// \brief Get whether the plugins of inactive models are deferred.
+      /// \return True if deferred.
+      public: bool DeferPlugins() const;
+
+      /// \brief Add, or replace, an activity zone around a model.
+      /// \param[in] _modelName Name of the top level model the zone follows.
+      /// \param[in] _radius Radius of the zone in meters.
+      public: void SetZone(const std::string &_modelName,
+                  const double _radius);
+
+      /// \brief Remove the activity zone of a model.
+      /// \param[in] _modelName Name of the model.
+      /// \return False if the model had no zone.
+      public: bool RemoveZone(const std::string &_modelName);
+
+      /// \brief Number of activity zones.
+      /// \return Number of zones.
+      public: unsigned int ZoneCount() const;
+
+      /// \brief Get whether a model is active. Always true when disabled.
+      /// \param[in] _model A top level model.
+      /// \return True if the model is in an active tile.
+      public: bool IsActive(const ModelPtr &_model) const;
+
+      /// \brief Number of active non static models, as of the last refresh.
+      /// \return Number of active models.
+      public: unsigned int ActiveModelCount() const;
+
+      /// \brief Number of inactive models, as of the last refresh.
+      /// \return Number of frozen models.
+      public: unsigned int InactiveModelCount() const;
+
+      /// \brief Check whether Model::Update should be called for a model
+      /// in the current iteration.
+      /// \param[in] _model A top level model.
+      /// \return True if the model should be updated.
+      public: bool ShouldUpdate(const ModelPtr &_model) const;
+
+      /// \brief Refresh the spatial index and freeze or unfreeze models.
+      /// Called by the world at the start of each iteration.
+      /// \param[in] _models Top level models of the world.
+      /// \param[in] _iteration Current world iteration.
+      public: void Update(const Model_V &_models, const uint64_t _iteration);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ActivityZoneManagerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ActivityZoneManager.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class ActivityZoneManagerTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(ActivityZoneManagerTest, Disabled)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  physics::ActivityZoneManager &zones = world->ActivityZones();
+  EXPECT_FALSE(zones.Enabled());
+
+  // Everything is active when disabled
+  for (auto const &model : world->Models())
+  {
+    EXPECT_TRUE(zones.IsActive(model));
+    EXPECT_TRUE(zones.ShouldUpdate(model));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(ActivityZoneManagerTest, FreezeOutsideZones)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_NE(nullptr, box);
+  ASSERT_NE(nullptr, sphere);
+
+  // Move the sphere far away from the box, then lift it so that it would
+  // fall if it was not frozen.
+  sphere->SetWorldPose(ignition::math::Pose3d(500, 0, 5, 0, 0, 0));
+
+  physics::ActivityZoneManager &zones = world->ActivityZones();
+  zones.SetTileSize(10);
+  zones.SetRefreshPeriod(1);
+  zones.SetInactiveUpdatePeriod(0);
+  zones.SetZone("box", 20);
+  EXPECT_EQ(1u, zones.ZoneCount());
+  zones.SetEnabled(true);
+
+  world->Step(100);
+
+  EXPECT_TRUE(zones.IsActive(box));
+  EXPECT_FALSE(zones.IsActive(sphere));
+  EXPECT_FALSE(zones.ShouldUpdate(sphere));
+  EXPECT_FALSE(sphere->GetLink()->GetEnabled());
+  EXPECT_NEAR(5.0, sphere->WorldPose().Pos().Z(), 1e-6);
+  EXPECT_GE(zones.InactiveModelCount(), 1u);
+  EXPECT_GE(zones.ActiveModelCount(), 1u);
+
+  // Moving the zone next to the sphere wakes it up
+  zones.SetZone("box", 1000);
+  world->Step(100);
+  EXPECT_TRUE(zones.IsActive(sphere));
+  EXPECT_TRUE(sphere->GetLink()->GetEnabled());
+  EXPECT_LT(sphere->WorldPose().Pos().Z(), 5.0);
+
+  // Disabling unfreezes everything
+  EXPECT_TRUE(zones.RemoveZone("box"));
+  world->Step(1);
+  EXPECT_FALSE(zones.IsActive(sphere));
+  zones.SetEnabled(false);
+  EXPECT_TRUE(zones.IsActive(sphere));
+  EXPECT_TRUE(sphere->GetLink()->GetEnabled());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
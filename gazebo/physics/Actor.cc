@@ -17,6 +17,9 @@
 #include <sstream>
 #include <limits>
 #include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "gazebo/common/BVHLoader.hh"
 #include "gazebo/common/Console.hh"
@@ -35,6 +38,42 @@
 
 #include "gazebo/transport/Node.hh"
 
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief An animation of an actor, with the bones of the skeleton bound
+    /// to the animation nodes by index.
+    class ActorAnimationState
+    {
+      /// \brief True once the bones are bound.
+      public: bool bound = false;
+
+      /// \brief Index of the animation node of every bone handle, or -1 if
+      /// the animation doesn't move the bone.
+      public: std::vector<int> boneNodes;
+
+      /// \brief Aligners of every bone handle, for BVH animations.
+      public: std::vector<ignition::math::Matrix4d> translationAligners;
+
+      /// \brief Rotation aligners of every bone handle, for BVH animations.
+      public: std::vector<ignition::math::Matrix4d> rotationAligners;
+
+      /// \brief Name of the animation node of the root bone.
+      public: std::string rootNode;
+
+      /// \brief Index of the animation node of the root bone, or -1.
+      public: int rootIndex = -1;
+
+      /// \brief Transform of every animation node, reused each frame.
+      public: std::vector<ignition::math::Matrix4d> pose;
+
+      /// \brief Key frame cursors of every animation node.
+      public: std::vector<unsigned int> cursors;
+    };
+  }
+}
+
 /// \brief Private data for Actor class
 class gazebo::physics::ActorPrivate
 {
@@ -48,6 +87,38 @@ class gazebo::physics::ActorPrivate
   /// \brief Rotations to align BVH skeleton to DAE skin
   public: std::map<std::string, ignition::math::Matrix4d>
       rotationAligner;
+
+  /// \brief Animations by type, bound the first time they are played.
+  public: std::map<std::string, ActorAnimationState> animationStates;
+
+  /// \brief Skeleton bones by handle.
+  public: std::vector<SkeletonNode *> bones;
+
+  /// \brief Link of every bone handle.
+  public: std::vector<LinkPtr> boneLinks;
+
+  /// \brief Link of the parent of every bone handle, null for the root.
+  public: std::vector<LinkPtr> parentLinks;
+
+  /// \brief True once EvaluateAnimation ran for the next Update.
+  public: bool evaluated = false;
+
+  /// \brief Animation evaluated by EvaluateAnimation and not applied yet,
+  /// null if none.
+  public: const ActorAnimationState *pendingState = nullptr;
+
+  /// \brief Transform of the root bone of pendingState.
+  public: ignition::math::Matrix4d pendingRoot;
+
+  /// \brief True if pendingPose is to be applied, for actors without
+  /// skeleton animation.
+  public: bool posePending = false;
+
+  /// \brief Pose of the actor evaluated by EvaluateAnimation.
+  public: ignition::math::Pose3d pendingPose;
+
+  /// \brief Simulation time of the pending frame, in seconds.
+  public: double pendingTime = 0.0;
 };
 
 using namespace gazebo;
@@ -182,6 +253,8 @@ bool Actor::LoadSkin(sdf::ElementPtr _skinSdf)
   }
 
   this->skeleton = this->mesh->GetSkeleton();
+  this->dataPtr->bones.clear();
+  this->dataPtr->animationStates.clear();
   this->SetScale({this->skinScale, this->skinScale, this->skinScale});
 
   auto actorName = this->GetName();
@@ -508,6 +581,9 @@ void Actor::LoadAnimation(sdf::ElementPtr _sdf)
   this->skelAnimation[animName] = skel->GetAnimation(0);
   this->interpolateX[animName] = _sdf->Get<bool>("interpolate_x");
   this->skelNodesMap[animName] = skelMap;
+
+  // Bind again, the aligners may have changed
+  this->dataPtr->animationStates.clear();
 }
 
 //////////////////////////////////////////////////
@@ -667,17 +743,42 @@ bool Actor::IsActive() const
 ///////////////////////////////////////////////////
 void Actor::Update()
 {
+  if (!this->dataPtr->evaluated)
+    this->EvaluateAnimation();
+  this->dataPtr->evaluated = false;
+
+  if (this->dataPtr->posePending)
+  {
+    this->dataPtr->posePending = false;
+    this->SetWorldPose(this->dataPtr->pendingPose);
+  }
+  else if (this->dataPtr->pendingState)
+  {
+    const ActorAnimationState *state = this->dataPtr->pendingState;
+    this->dataPtr->pendingState = nullptr;
+    this->SetPose(*state, this->dataPtr->pendingRoot,
+        this->dataPtr->pendingTime);
+  }
+}
+
+///////////////////////////////////////////////////
+bool Actor::EvaluateAnimation()
+{
+  this->dataPtr->evaluated = true;
+  this->dataPtr->posePending = false;
+  this->dataPtr->pendingState = nullptr;
+
   if (!this->active)
-    return;
+    return false;
 
   if (this->skelAnimation.empty() && this->trajectories.empty())
-    return;
+    return false;
 
   common::Time currentTime = this->world->SimTime();
 
   // do not refresh animation faster than 30 Hz sim time
   if ((currentTime - this->prevFrameTime).Double() < (1.0 / 30.0))
-    return;
+    return false;
 
   // Get trajectory
   TrajectoryInfo *tinfo = nullptr;
@@ -688,13 +789,13 @@ void Actor::Update()
 
     // waiting for delayed start
     if (this->scriptTime < 0)
-      return;
+      return false;
 
     if (this->scriptTime >= this->scriptLength)
     {
       if (!this->loop)
       {
-        return;
+        return false;
       }
       else
       {
@@ -718,7 +819,7 @@ void Actor::Update()
     {
       gzerr << "Trajectory not found at time [" << this->scriptTime << "]"
           << std::endl;
-      return;
+      return false;
     }
 
     this->scriptTime = this->scriptTime - tinfo->startTime;
@@ -766,39 +867,26 @@ void Actor::Update()
   // If there's no skeleton animation, we just update the global pose
   if (!skelAnim)
   {
-    this->SetWorldPose(modelPose);
-    return;
+    this->dataPtr->pendingPose = modelPose;
+    this->dataPtr->posePending = true;
+    return true;
   }
 
-  auto skelMap = this->skelNodesMap[tinfo->type];
+  ActorAnimationState &state = this->AnimationState(tinfo->type);
 
-  std::map<std::string, ignition::math::Matrix4d> frame;
-  if (!this->customTrajectoryInfo)
-  {
-    if (this->interpolateX[tinfo->type] &&
-          this->trajectories.find(tinfo->id) != this->trajectories.end())
-    {
-      frame = skelAnim->PoseAtX(this->pathLength,
-                skelMap[this->skeleton->GetRootNode()->GetName()]);
-    }
-    else
-    {
-      frame = skelAnim->PoseAt(this->scriptTime);
-    }
-  }
-  else
+  double animTime = this->scriptTime;
+  if (!this->customTrajectoryInfo && this->interpolateX[tinfo->type] &&
+      this->trajectories.find(tinfo->id) != this->trajectories.end())
   {
-    frame = skelAnim->PoseAt(this->scriptTime);
+    animTime = skelAnim->TimeAtX(this->pathLength, state.rootNode);
   }
+  skelAnim->PoseAt(animTime, state.pose, state.cursors);
 
   this->lastTraj = tinfo->id;
 
   ignition::math::Matrix4d rootTrans = ignition::math::Matrix4d::Identity;
-  auto iter = frame.find(skelMap[this->skeleton->GetRootNode()->GetName()]);
-  if (iter != frame.end())
-  {
-    rootTrans = frame[skelMap[this->skeleton->GetRootNode()->GetName()]];
-  }
+  if (state.rootIndex >= 0)
+    rootTrans = state.pose[state.rootIndex];
 
   ignition::math::Vector3d rootPos = rootTrans.Translation();
   ignition::math::Quaterniond rootRot = rootTrans.Rotation();
@@ -839,20 +927,79 @@ void Actor::Update()
   // workaround for rotation bug
   rootM.SetTranslation(rootM.Translation() * this->skinScale);
 
-  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] = rootM;
+  this->dataPtr->pendingState = &state;
+  this->dataPtr->pendingRoot = rootM;
+  this->dataPtr->pendingTime = currentTime.Double();
+  return true;
+}
 
-  this->SetPose(frame, skelMap, currentTime.Double());
+//////////////////////////////////////////////////
+ActorAnimationState &Actor::AnimationState(const std::string &_type)
+{
+  ActorAnimationState &state = this->dataPtr->animationStates[_type];
+  if (state.bound)
+    return state;
+
+  // Bones and their links are the same for every animation
+  if (this->dataPtr->bones.empty())
+  {
+    for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+    {
+      SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
+      this->dataPtr->bones.push_back(bone);
+      this->dataPtr->boneLinks.push_back(this->GetChildLink(bone->GetName()));
+      this->dataPtr->parentLinks.push_back(bone->GetParent() ?
+          this->GetChildLink(bone->GetParent()->GetName()) : LinkPtr());
+    }
+  }
+
+  const SkeletonAnimation *skelAnim = this->skelAnimation[_type];
+  const std::map<std::string, std::string> &skelMap =
+    this->skelNodesMap[_type];
+  const size_t boneCount = this->dataPtr->bones.size();
+
+  state.boneNodes.assign(boneCount, -1);
+  state.translationAligners.assign(boneCount,
+      ignition::math::Matrix4d::Identity);
+  state.rotationAligners.assign(boneCount,
+      ignition::math::Matrix4d::Identity);
+
+  for (size_t i = 0; i < boneCount; ++i)
+  {
+    auto iter = skelMap.find(this->dataPtr->bones[i]->GetName());
+    if (iter == skelMap.end())
+      continue;
+
+    state.boneNodes[i] = skelAnim->NodeIndex(iter->second);
+    if (this->dataPtr->bvhFile)
+    {
+      state.translationAligners[i] =
+        this->dataPtr->translationAligner[iter->second];
+      state.rotationAligners[i] = this->dataPtr->rotationAligner[iter->second];
+    }
+  }
+
+  auto rootIter = skelMap.find(this->skeleton->GetRootNode()->GetName());
+  state.rootNode = rootIter != skelMap.end() ? rootIter->second : "";
+  state.rootIndex = skelAnim->NodeIndex(state.rootNode);
+  state.bound = true;
+
+  return state;
 }
 
 //////////////////////////////////////////////////
-void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
-    std::map<std::string, std::string> _skelMap, const double _time)
+void Actor::SetPose(const ActorAnimationState &_state,
+    const ignition::math::Matrix4d &_rootTrans, const double _time)
 {
-  msgs::PoseAnimation msg;
-  msg.set_model_name(this->visualName);
-  msg.set_model_id(this->visualId);
+  // Only build the message when someone listens
+  boost::shared_ptr<msgs::PoseAnimation> msg;
+  if (this->bonePosePub && this->bonePosePub->HasConnections())
+  {
+    msg = this->bonePosePub->BorrowMessage<msgs::PoseAnimation>();
+    msg->set_model_name(this->visualName);
+    msg->set_model_id(this->visualId);
+  }
 
-  ignition::math::Matrix4d modelTrans(ignition::math::Matrix4d::Identity);
   ignition::math::Pose3d mainLinkPose;
 
   if (this->customTrajectoryInfo)
@@ -861,20 +1008,19 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
     mainLinkPose.Rot() = this->worldPose.Rot();
   }
 
-  for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+  const SkeletonNode *root = this->skeleton->GetRootNode();
+  for (size_t i = 0; i < this->dataPtr->bones.size(); ++i)
   {
-    SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
-    SkeletonNode *parentBone = bone->GetParent();
+    SkeletonNode *bone = this->dataPtr->bones[i];
+    const int node = _state.boneNodes[i];
     ignition::math::Matrix4d transform(ignition::math::Matrix4d::Identity);
 
-    if (_frame.find(_skelMap[bone->GetName()]) != _frame.end())
+    if (bone == root || node >= 0)
     {
+      transform = bone == root ? _rootTrans : _state.pose[node];
       if (this->dataPtr->bvhFile)
       {
-        std::string tempStr(_skelMap[bone->GetName()]);
-        transform = _frame[tempStr];
-
-        if (bone->GetName() != this->skeleton->GetRootNode()->GetName())
+        if (bone != root)
         {
           ignition::math::Vector3d bvhOffset = transform.Translation();
           ignition::math::Vector3d daeOffset = bone->Transform().Translation();
@@ -882,12 +1028,8 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
           transform.SetTranslation(daeOffset.Length() * bvhOffset.Normalize());
         }
 
-        transform = this->dataPtr->translationAligner[tempStr] * transform *
-            this->dataPtr->rotationAligner[tempStr];
-      }
-      else
-      {
-        transform = _frame[_skelMap[bone->GetName()]];
+        transform = _state.translationAligners[i] * transform *
+            _state.rotationAligners[i];
       }
     }
     else
@@ -895,7 +1037,7 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
       transform = bone->Transform();
     }
 
-    LinkPtr currentLink = this->GetChildLink(bone->GetName());
+    const LinkPtr &currentLink = this->dataPtr->boneLinks[i];
     ignition::math::Pose3d bonePose = transform.Pose();
     if (!bonePose.IsFinite())
     {
@@ -904,59 +1046,75 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
       bonePose.Correct();
     }
 
-    msgs::Pose *bone_pose = msg.add_pose();
-    bone_pose->set_name(bone->GetName());
+    msgs::Pose *bone_pose = msg ? msg->add_pose() : nullptr;
+    if (bone_pose)
+      bone_pose->set_name(bone->GetName());
 
-    if (!parentBone)
+    if (!bone->GetParent())
     {
-      bone_pose->mutable_position()->CopyFrom(
-          msgs::Convert(ignition::math::Vector3d()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
-          ignition::math::Quaterniond()));
+      if (bone_pose)
+      {
+        bone_pose->mutable_position()->CopyFrom(
+            msgs::Convert(ignition::math::Vector3d()));
+        bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
+            ignition::math::Quaterniond()));
+      }
       if (!this->customTrajectoryInfo)
         mainLinkPose = bonePose;
     }
     else
     {
-      bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.Pos()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(bonePose.Rot()));
-      LinkPtr parentLink = this->GetChildLink(parentBone->GetName());
-      auto parentPose = parentLink->WorldPose();
-      ignition::math::Matrix4d parentTrans(parentPose);
+      if (bone_pose)
+      {
+        bone_pose->mutable_position()->CopyFrom(
+            msgs::Convert(bonePose.Pos()));
+        bone_pose->mutable_orientation()->CopyFrom(
+            msgs::Convert(bonePose.Rot()));
+      }
+      ignition::math::Matrix4d parentTrans(
+          this->dataPtr->parentLinks[i]->WorldPose());
       transform = parentTrans * transform;
     }
 
-    msgs::Pose *link_pose = msg.add_pose();
-    link_pose->set_name(currentLink->GetScopedName());
-    link_pose->set_id(currentLink->GetId());
-    ignition::math::Pose3d linkPose = transform.Pose() - mainLinkPose;
-    link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.Pos()));
-    link_pose->mutable_orientation()->CopyFrom(msgs::Convert(linkPose.Rot()));
+    if (msg)
+    {
+      msgs::Pose *link_pose = msg->add_pose();
+      link_pose->set_name(currentLink->GetScopedName());
+      link_pose->set_id(currentLink->GetId());
+      ignition::math::Pose3d linkPose = transform.Pose() - mainLinkPose;
+      link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.Pos()));
+      link_pose->mutable_orientation()->CopyFrom(
+          msgs::Convert(linkPose.Rot()));
+    }
     currentLink->SetWorldPose(transform.Pose(), true, false);
   }
 
-  msgs::Time *stamp = msg.add_time();
-  stamp->CopyFrom(msgs::Convert(_time));
-
-  msgs::Pose *model_pose = msg.add_pose();
-  model_pose->set_name(this->GetScopedName());
-  model_pose->set_id(this->GetId());
-  if (!this->customTrajectoryInfo)
-  {
-    model_pose->mutable_position()->CopyFrom(msgs::Convert(mainLinkPose.Pos()));
-    model_pose->mutable_orientation()->CopyFrom(
-        msgs::Convert(mainLinkPose.Rot()));
-  }
-  else
+  if (msg)
   {
-    model_pose->mutable_position()->CopyFrom(
-        msgs::Convert(this->worldPose.Pos()));
-    model_pose->mutable_orientation()->CopyFrom(
-        msgs::Convert(this->worldPose.Rot()));
+    msgs::Time *stamp = msg->add_time();
+    stamp->CopyFrom(msgs::Convert(_time));
+
+    msgs::Pose *model_pose = msg->add_pose();
+    model_pose->set_name(this->GetScopedName());
+    model_pose->set_id(this->GetId());
+    if (!this->customTrajectoryInfo)
+    {
+      model_pose->mutable_position()->CopyFrom(
+          msgs::Convert(mainLinkPose.Pos()));
+      model_pose->mutable_orientation()->CopyFrom(
+          msgs::Convert(mainLinkPose.Rot()));
+    }
+    else
+    {
+      model_pose->mutable_position()->CopyFrom(
+          msgs::Convert(this->worldPose.Pos()));
+      model_pose->mutable_orientation()->CopyFrom(
+          msgs::Convert(this->worldPose.Rot()));
+    }
+
+    this->bonePosePub->Publish(transport::MessagePtr(msg));
   }
 
-  if (this->bonePosePub && this->bonePosePub->HasConnections())
-    this->bonePosePub->Publish(msg);
   if (!this->customTrajectoryInfo)
     this->SetWorldPose(mainLinkPose, true, false);
 }
@@ -988,6 +1146,9 @@ void Actor::Reset()
   this->playStartTime = this->world->SimTime();
   this->pathLength = 0.0;
   this->lastTraj = 1e+5;
+  this->dataPtr->evaluated = false;
+  this->dataPtr->posePending = false;
+  this->dataPtr->pendingState = nullptr;
   this->Init();
 
   Model::Reset();
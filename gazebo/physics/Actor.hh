@@ -39,6 +39,7 @@ namespace gazebo
 
   namespace physics
   {
+    class ActorAnimationState;
     class ActorPrivate;
 
     /// \brief Information about a trajectory for an Actor.
@@ -111,9 +112,18 @@ namespace gazebo
       /// \return True if animation is being played.
       public: virtual bool IsActive() const;
 
-      /// \brief Update the actor
+      /// \brief Update the actor. Applies the frame evaluated by
+      /// EvaluateAnimation, evaluating it first unless the world already did.
       public: void Update();
 
+      /// \brief Evaluate the trajectory and skeleton animation of the actor
+      /// at the current simulation time, without moving any link. The
+      /// result is applied by the next call to Update. This only touches the
+      /// actor's own data, so the world can evaluate several actors
+      /// concurrently before updating them in order.
+      /// \return True if a new frame is to be applied.
+      public: bool EvaluateAnimation();
+
       /// \brief Finalize the actor
       public: virtual void Fini();
 
@@ -277,14 +287,20 @@ namespace gazebo
       /// \param[in] _sdf SDF element containing the trajectory script.
       private: void LoadScript(sdf::ElementPtr _sdf);
 
+      /// \brief Get an animation with the bones of the skeleton bound to
+      /// its nodes, binding them the first time.
+      /// \param[in] _type Animation type.
+      /// \return The bound animation.
+      private: ActorAnimationState &AnimationState(const std::string &_type);
+
       /// \brief Set the actor's pose. This sets the pose for each bone in the
       /// skeleton and also the actor's pose in the world.
-      /// \param[in] _frame Each frame name and transform.
-      /// \param[in] _skelMap Map of bone relationships.
+      /// \param[in] _state Animation with the transform of each of its
+      /// nodes evaluated.
+      /// \param[in] _rootTrans Transform of the root bone.
       /// \param[in] _time Time over which to animate the set pose.
-      private: void SetPose(
-                   std::map<std::string, ignition::math::Matrix4d> _frame,
-                   std::map<std::string, std::string> _skelMap,
+      private: void SetPose(const ActorAnimationState &_state,
+                   const ignition::math::Matrix4d &_rootTrans,
                    const double _time);
 
       /// \brief Pointer to the actor's mesh.
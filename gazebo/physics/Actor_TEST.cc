@@ -102,6 +102,37 @@ TEST_F(ActorTest, TrajectoryFromSDF)
   EXPECT_LT(fabs(actor->ScriptTime() - world->SimTime().Double()), 1.0 / 30);
 }
 
+//////////////////////////////////////////////////
+TEST_F(ActorTest, ParallelModelUpdate)
+{
+  // Load a world with an actor
+  this->Load("worlds/actor.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto actor = boost::dynamic_pointer_cast<physics::Actor>(
+      world->ModelByName("actor"));
+  ASSERT_TRUE(actor != nullptr);
+
+  // Evaluating doesn't move the actor until it is updated
+  world->Step(100);
+  const auto pose = actor->WorldPose();
+  world->SetSimTime(world->SimTime() + common::Time(0.5));
+  EXPECT_TRUE(actor->EvaluateAnimation());
+  EXPECT_EQ(pose, actor->WorldPose());
+  actor->Update();
+  EXPECT_NE(pose, actor->WorldPose());
+
+  // Animations evaluated on the thread pool follow the same trajectory
+  world->Reset();
+  world->SetParallelModelUpdate(true);
+  world->Step(4000);
+
+  ignition::math::Vector3d target(1.0, 0.0, 1.0);
+  EXPECT_LT((target - actor->WorldPose().Pos()).Length(), 0.1);
+  EXPECT_LT(fabs(actor->ScriptTime() - world->SimTime().Double()), 1.0 / 30);
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "gazebo/common/Battery.hh"
+#include "gazebo/physics/BatteryRegistry.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A battery of the registry.
+    class RegisteredBattery
+    {
+      /// \brief The battery.
+      public: common::BatteryPtr battery;
+
+      /// \brief Simulation time of the next update in seconds.
+      public: double nextTime = 0;
+
+      /// \brief Simulation time of the last update in seconds, negative if
+      /// never updated.
+      public: double lastTime = -1;
+    };
+
+    /// \internal
+    /// \brief Private data for the BatteryRegistry class
+    class BatteryRegistryPrivate
+    {
+      /// \brief The batteries, updated in order.
+      public: std::vector<RegisteredBattery> batteries;
+
+      /// \brief Update rate of the batteries without their own rate.
+      public: double defaultRate = 0;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+BatteryRegistry::BatteryRegistry()
+  : dataPtr(new BatteryRegistryPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+BatteryRegistry::~BatteryRegistry()
+{
+}
+
+/////////////////////////////////////////////////
+void BatteryRegistry::Add(const common::BatteryPtr &_battery)
+{
+  if (!_battery)
+    return;
+
+  auto &batteries = this->dataPtr->batteries;
+  if (std::find_if(batteries.begin(), batteries.end(),
+        [&](const RegisteredBattery &_b)
+        {
+          return _b.battery == _battery;
+        }) != batteries.end())
+  {
+    return;
+  }
+
+  RegisteredBattery entry;
+  entry.battery = _battery;
+  batteries.push_back(entry);
+}
+
+/////////////////////////////////////////////////
+bool BatteryRegistry::Remove(const common::BatteryPtr &_battery)
+{
+  auto &batteries = this->dataPtr->batteries;
+  auto iter = std::find_if(batteries.begin(), batteries.end(),
+      [&](const RegisteredBattery &_b)
+      {
+        return _b.battery == _battery;
+      });
+  if (iter == batteries.end())
+    return false;
+
+  batteries.erase(iter);
+  return true;
+}
+
+/////////////////////////////////////////////////
+unsigned int BatteryRegistry::BatteryCount() const
+{
+  return this->dataPtr->batteries.size();
+}
+
+/////////////////////////////////////////////////
+void BatteryRegistry::SetDefaultUpdateRate(const double _rate)
+{
+  this->dataPtr->defaultRate = std::max(0.0, _rate);
+}
+
+/////////////////////////////////////////////////
+double BatteryRegistry::DefaultUpdateRate() const
+{
+  return this->dataPtr->defaultRate;
+}
+
+/////////////////////////////////////////////////
+void BatteryRegistry::Update(const common::Time &_simTime)
+{
+  const double t = _simTime.Double();
+  for (auto &entry : this->dataPtr->batteries)
+  {
+    // Due, within rounding of the step sizes, or the time went back
+    if (t + 1e-6 < entry.nextTime && t >= entry.lastTime)
+      continue;
+
+    entry.battery->Update();
+
+    double rate = entry.battery->UpdateRate();
+    if (rate <= 0)
+      rate = this->dataPtr->defaultRate;
+    entry.lastTime = t;
+    entry.nextTime = rate > 0 ? t + 1.0 / rate : t;
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BATTERYREGISTRY_HH_
+#define GAZEBO_PHYSICS_BATTERYREGISTRY_HH_
+
+#include <memory>
+
+#include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class BatteryRegistryPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class BatteryRegistry BatteryRegistry.hh physics/physics.hh
+    /// \brief Updates all the batteries of a world in a single pass.
+    ///
+    /// Links add their batteries when they load and remove them in
+    /// Link::Fini. The world updates the registry at the start of each
+    /// iteration, right after the update scheduler, and the registry calls
+    /// common::Battery::Update on the batteries that are due. A battery is
+    /// due once every 1 / rate seconds of simulation time, where the rate is
+    /// common::Battery::UpdateRate if set, else the default rate of the
+    /// registry. A rate of zero updates the battery every iteration.
+    ///
+    /// The registry is owned by the World, see World::Batteries.
+    class GZ_PHYSICS_VISIBLE BatteryRegistry
+    {
+      /// \brief Constructor.
+      public: BatteryRegistry();
+
+      /// \brief Destructor.
+      public: ~BatteryRegistry();
+
+      /// \brief Add a battery. It is first updated in the next call to
+      /// Update.
+      /// \param[in] _battery The battery.
+      public: void Add(const common::BatteryPtr &_battery);
+
+      /// \brief Remove a battery added with Add.
+      /// \param[in] _battery The battery.
+      /// \return False if the battery wasn't added.
+      public: bool Remove(const common::BatteryPtr &_battery);
+
+      /// \brief Get the number of batteries.
+      /// \return Number of batteries.
+      public: unsigned int BatteryCount() const;
+
+      /// \brief Set the update rate of the batteries without their own rate.
+      /// \param[in] _rate Update rate in Hz of simulation time. Zero, the
+      /// default, updates them every iteration.
+      public: void SetDefaultUpdateRate(const double _rate);
+
+      /// \brief Get the update rate of the batteries without their own rate.
+      /// \return Update rate in Hz of simulation time.
+      public: double DefaultUpdateRate() const;
+
+      /// \brief Update the batteries that are due.
+      /// \param[in] _simTime Current simulation time. The batteries are due
+      /// again if it goes back, e.g. after a reset.
+      public: void Update(const common::Time &_simTime);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BatteryRegistryPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/Battery.hh"
+#include "gazebo/physics/BatteryRegistry.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class BatteryRegistryTest : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Create a battery that counts its updates.
+/// \param[out] _count Incremented by each update.
+/// \return The battery.
+static common::BatteryPtr CountingBattery(int &_count)
+{
+  common::BatteryPtr battery(new common::Battery());
+  battery->SetUpdateFunc([&_count](const common::BatteryPtr &_battery)
+      {
+        ++_count;
+        return _battery->Voltage();
+      });
+  return battery;
+}
+
+/////////////////////////////////////////////////
+TEST_F(BatteryRegistryTest, AddRemove)
+{
+  physics::BatteryRegistry registry;
+  int count = 0;
+  common::BatteryPtr battery = CountingBattery(count);
+
+  registry.Add(battery);
+  registry.Add(battery);
+  registry.Add(common::BatteryPtr());
+  EXPECT_EQ(1u, registry.BatteryCount());
+
+  registry.Update(common::Time(0.001));
+  EXPECT_EQ(1, count);
+
+  EXPECT_TRUE(registry.Remove(battery));
+  EXPECT_FALSE(registry.Remove(battery));
+  EXPECT_EQ(0u, registry.BatteryCount());
+
+  registry.Update(common::Time(0.002));
+  EXPECT_EQ(1, count);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BatteryRegistryTest, Rate)
+{
+  physics::BatteryRegistry registry;
+  int full = 0, slow = 0, fallback = 0;
+  common::BatteryPtr fullBattery = CountingBattery(full);
+  common::BatteryPtr slowBattery = CountingBattery(slow);
+  common::BatteryPtr fallbackBattery = CountingBattery(fallback);
+  slowBattery->SetUpdateRate(10);
+  registry.Add(fullBattery);
+  registry.Add(slowBattery);
+  registry.Add(fallbackBattery);
+
+  // 1 kHz physics for one second
+  for (int i = 1; i <= 1000; ++i)
+    registry.Update(common::Time(i * 0.001));
+  EXPECT_EQ(1000, full);
+  EXPECT_EQ(10, slow);
+  EXPECT_EQ(1000, fallback);
+
+  // The default rate applies to the batteries without their own rate
+  registry.SetDefaultUpdateRate(100);
+  EXPECT_DOUBLE_EQ(100, registry.DefaultUpdateRate());
+  full = slow = fallback = 0;
+  fullBattery->SetUpdateRate(1000);
+  for (int i = 1001; i <= 2000; ++i)
+    registry.Update(common::Time(i * 0.001));
+  EXPECT_EQ(1000, full);
+  EXPECT_EQ(10, slow);
+  EXPECT_EQ(100, fallback);
+
+  // Going back in time, e.g. after a reset, updates every battery
+  full = slow = fallback = 0;
+  registry.Update(common::Time(0.001));
+  EXPECT_EQ(1, full);
+  EXPECT_EQ(1, slow);
+  EXPECT_EQ(1, fallback);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,12 +14,20 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/TransportIface.hh"
 
+#include "gazebo/common/MemoryAccounting.hh"
 #include "gazebo/common/Time.hh"
 
 #include "gazebo/physics/World.hh"
@@ -27,15 +35,92 @@
 #include "gazebo/physics/Contact.hh"
 #include "gazebo/physics/ContactManager.hh"
 
+/// \internal
+/// \brief Private data for the ContactManager class.
+class gazebo::physics::ContactManagerPrivate
+{
+  /// \brief Custom publishers with subscribers, collected by
+  /// UpdateDemand. Protected by customMutex.
+  public: std::vector<ContactPublisher *> activeFilters;
+
+  /// \brief Active filters of each monitored collision, so that each
+  /// new contact is handed to its filters with two lookups. Collected
+  /// by UpdateDemand, protected by customMutex.
+  public: boost::unordered_map<Collision *,
+      std::vector<ContactPublisher *> > collisionFilters;
+
+  /// \brief Functions that receive the contacts of each step instead of
+  /// the publisher, by filter. Protected by customMutex.
+  public: std::unordered_map<const ContactPublisher *,
+      std::function<void(const std::vector<Contact *> &)>> callbacks;
+
+  /// \brief True if all contacts are recorded, because the default
+  /// topic has subscribers or NeverDropContacts() is true.
+  public: bool recordAll = false;
+
+  /// \brief Number of contacts dropped in the current step.
+  public: unsigned int droppedContactCount = 0;
+
+  /// \brief Fills in the wrenches of the current contacts.
+  public: std::function<void()> wrenchUpdater;
+
+  /// \brief True if the wrenches of the current contacts have not been
+  /// filled in yet.
+  public: bool wrenchesPending = false;
+
+  /// \brief Memory of the contacts, which are reused across steps.
+  public: common::MemoryAccounting::Account memory{
+              common::MemoryAccounting::CONTACTS};
+
+  /// \brief Get the active filters that monitor a collision.
+  /// \param[in] _collision The collision object.
+  /// \return The filters, null if no active filter monitors it.
+  public: const std::vector<ContactPublisher *> *Filters(
+              Collision *_collision) const
+  {
+    auto iter = this->collisionFilters.find(_collision);
+    if (iter == this->collisionFilters.end())
+      return nullptr;
+    return &iter->second;
+  }
+};
+
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Private data of the contact managers, by manager. It is kept
+  /// out of ContactManager so that the layout of the class doesn't change.
+  class ContactManagerPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the contact managers.
+    public: static ContactManagerPrivates &Instance()
+    {
+      static ContactManagerPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by contact manager.
+    public: std::unordered_map<const ContactManager *,
+            std::unique_ptr<ContactManagerPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 /////////////////////////////////////////////////
 ContactManager::ContactManager()
 {
   this->contactIndex = 0;
   this->customMutex = new boost::recursive_mutex();
   this->neverDropContacts = false;
+
+  ContactManagerPrivates &privates = ContactManagerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new ContactManagerPrivate);
 }
 
 /////////////////////////////////////////////////
@@ -66,6 +151,18 @@ ContactManager::~ContactManager()
   this->customMutex = NULL;
 
   this->world.reset();
+
+  ContactManagerPrivates &privates = ContactManagerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+/////////////////////////////////////////////////
+ContactManagerPrivate *ContactManager::ContactManagerData() const
+{
+  ContactManagerPrivates &privates = ContactManagerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 /////////////////////////////////////////////////
@@ -78,12 +175,15 @@ void ContactManager::Init(WorldPtr _world)
 
   this->contactPub =
     this->node->Advertise<msgs::Contacts>("~/physics/contacts", 50);
+  this->contactPub->SetPriority(transport::Publisher::BULK);
 }
 
 /////////////////////////////////////////////////
 void ContactManager::SetNeverDropContacts(const bool _neverDrop)
 {
   this->neverDropContacts = _neverDrop;
+  if (_neverDrop)
+    this->ContactManagerData()->recordAll = true;
 }
 
 /////////////////////////////////////////////////
@@ -96,90 +196,68 @@ bool ContactManager::NeverDropContacts() const
 bool ContactManager::SubscribersConnected(Collision *_collision1,
                                           Collision *_collision2) const
 {
-  if (this->contactPub->HasConnections()) return true;
+  if (this->contactPub && this->contactPub->HasConnections())
+    return true;
 
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
-  boost::unordered_map<std::string, ContactPublisher *>::const_iterator iter;
-  for (iter = this->customContactPublishers.begin();
-       iter != this->customContactPublishers.end(); ++iter)
-  {
-    // A model can simply be loaded later, so check the collisionNames as well.
-    if (!iter->second->collisionNames.empty())
-    {
-      std::vector<std::string>::const_iterator it;
-      for (it = iter->second->collisionNames.begin();
-           it != iter->second->collisionNames.end(); ++it)
-      {
-        BasePtr b = this->world->BaseByName(*it);
-        if (b)
-        {
-          return true;
-        }
-        // We could do the same transformation which is done in
-        // GetCustomPublishers() here (insert collisions which now have been
-        // loaded), but this would remove the const qualifier of this function.
-        // It would however speed up repeated calls of this function without
-        // a call of NewContact() or GetCustomPublishers() in between.
-      }
-    }
-
-    // only reason _collision1 or _collision1 cannot be const parameters
-    // is that compiler can't find const pointers in unordered set
-    if (iter->second->collisions.find(_collision1) !=
-        iter->second->collisions.end() ||
-        iter->second->collisions.find(_collision2) !=
-        iter->second->collisions.end())
-    {
-      return true;
-    }
-  }
-  return false;
+  ContactManagerPrivate *data = this->ContactManagerData();
+  return data->Filters(_collision1) || data->Filters(_collision2);
 }
 
 /////////////////////////////////////////////////
-void ContactManager::GetCustomPublishers(Collision *_collision1,
-                     Collision *_collision2, const bool _getOnlyConnected,
-                     std::vector<ContactPublisher*> &_publishers)
+void ContactManager::UpdateDemand()
 {
+  ContactManagerPrivate *data = this->ContactManagerData();
+  data->recordAll = this->NeverDropContacts() ||
+      (this->contactPub && this->contactPub->HasConnections());
+
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
-  boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
-  for (iter = this->customContactPublishers.begin();
-       iter != this->customContactPublishers.end(); ++iter)
+  data->activeFilters.clear();
+  for (auto &filters : data->collisionFilters)
+    filters.second.clear();
+
+  for (auto &iter : this->customContactPublishers)
   {
-    // A model can simply be loaded later, so convert ones that are not yet
-    // found
-    if (!iter->second->collisionNames.empty())
+    ContactPublisher *contactPublisher = iter.second;
+    contactPublisher->contacts.clear();
+
+    const bool hasCallback = data->callbacks.count(contactPublisher) > 0;
+    GZ_ASSERT(contactPublisher->publisher != NULL || hasCallback,
+              "ContactPublisher must have a valid publisher or callback");
+    if (!hasCallback && !contactPublisher->publisher->HasConnections())
     {
-      std::vector<std::string>::iterator it;
-      for (it = iter->second->collisionNames.begin();
-          it != iter->second->collisionNames.end();)
-      {
-        Collision *col = boost::dynamic_pointer_cast<Collision>(
-            this->world->BaseByName(*it)).get();
-        if (!col)
-        {
-          ++it;
-          continue;
-        }
-        it = iter->second->collisionNames.erase(it);
-        iter->second->collisions.insert(col);
-      }
+      continue;
     }
 
-    // only reason _collision1 or _collision1 cannot be const parameters
-    // is that compiler can't find const pointers in unordered set
-    if (iter->second->collisions.find(_collision1) !=
-        iter->second->collisions.end() ||
-        iter->second->collisions.find(_collision2) !=
-        iter->second->collisions.end())
+    // A model can simply be loaded later, so convert ones that are not yet
+    // found
+    for (auto it = contactPublisher->collisionNames.begin();
+        it != contactPublisher->collisionNames.end();)
     {
-      GZ_ASSERT(iter->second->publisher != NULL,
-                "ContactPublisher must have a valid publisher");
-      if (!_getOnlyConnected || iter->second->publisher->HasConnections())
+      Collision *col = boost::dynamic_pointer_cast<Collision>(
+          this->world->BaseByName(*it)).get();
+      if (!col)
       {
-        _publishers.push_back(iter->second);
+        ++it;
+        continue;
       }
+      it = contactPublisher->collisionNames.erase(it);
+      contactPublisher->collisions.insert(col);
     }
+
+    data->activeFilters.push_back(contactPublisher);
+    for (auto const &col : contactPublisher->collisions)
+      data->collisionFilters[col].push_back(contactPublisher);
+  }
+
+  // Forget the collisions that no active filter monitors
+  for (auto iter = data->collisionFilters.begin();
+       iter != data->collisionFilters.end();)
+  {
+    if (iter->second.empty())
+      iter = data->collisionFilters.erase(iter);
+    else
+      ++iter;
   }
 }
 
@@ -193,40 +271,61 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   if (!_collision1 || !_collision2)
     return result;
 
-  // If no one is listening to the default topic, or there are no
-  // custom contact publishers then don't create any contact information.
-  // This is a signal to the Physics engine that it can skip the extra
-  // processing necessary to get back contact information.
-
-  std::vector<ContactPublisher *> publishers;
-  bool getOnlyConnected = false;
-  // TODO check: getOnlyConnected set to false to keep same behaviour as before.
-  // But should we not only add publishers which are connected, as is done
-  // for this->contactPub->HasConnections() condition?
-  this->GetCustomPublishers(_collision1, _collision2,
-                            getOnlyConnected, publishers);
-
-  if (this->NeverDropContacts() ||
-      this->contactPub->HasConnections() ||
-      !publishers.empty())
+  ContactManagerPrivate *data = this->ContactManagerData();
+
+  // If no one is listening to the default topic, or to a filter that
+  // monitors one of the collisions, then don't create any contact
+  // information. This is a signal to the Physics engine that it can skip
+  // the extra processing necessary to get back contact information.
+  if (!data->recordAll && data->activeFilters.empty())
   {
-    // Get or create a contact feedback object.
-    if (this->contactIndex < this->contacts.size())
-      result = this->contacts[this->contactIndex++];
-    else
-    {
-      result = new Contact();
-      this->contacts.push_back(result);
-      this->contactIndex = this->contacts.size();
-    }
-    for (unsigned int i = 0; i < publishers.size(); ++i)
-    {
-      publishers[i]->contacts.push_back(result);
-    }
+    ++data->droppedContactCount;
+    return result;
   }
 
-  if (!result)
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+
+  const std::vector<ContactPublisher *> *filters1 =
+      data->Filters(_collision1);
+  const std::vector<ContactPublisher *> *filters2 =
+      _collision2 != _collision1 ? data->Filters(_collision2) : nullptr;
+
+  if (!data->recordAll && !filters1 && !filters2)
+  {
+    ++data->droppedContactCount;
     return result;
+  }
+
+  // Get or create a contact feedback object.
+  if (this->contactIndex < this->contacts.size())
+    result = this->contacts[this->contactIndex++];
+  else
+  {
+    result = new Contact();
+    this->contacts.push_back(result);
+    this->contactIndex = this->contacts.size();
+    data->memory.Set(this->contacts.size() * sizeof(Contact) +
+        this->contacts.capacity() * sizeof(Contact *));
+  }
+
+  // Only the filters that monitor the collisions get the contact, once
+  // for filters that monitor both collisions
+  if (filters1)
+  {
+    for (auto const &publisher : *filters1)
+      publisher->contacts.push_back(result);
+  }
+  if (filters2)
+  {
+    for (auto const &publisher : *filters2)
+    {
+      if (!filters1 || publisher->collisions.find(_collision1) ==
+          publisher->collisions.end())
+      {
+        publisher->contacts.push_back(result);
+      }
+    }
+  }
 
   result->count = 0;
   result->collision1 = _collision1;
@@ -246,6 +345,7 @@ unsigned int ContactManager::GetContactCount() const
 /////////////////////////////////////////////////
 Contact *ContactManager::GetContact(unsigned int _index) const
 {
+  this->UpdateWrenches();
   if (_index < this->contactIndex)
     return this->contacts[_index];
   else
@@ -255,13 +355,58 @@ Contact *ContactManager::GetContact(unsigned int _index) const
 /////////////////////////////////////////////////
 const std::vector<Contact*> &ContactManager::GetContacts() const
 {
+  this->UpdateWrenches();
   return this->contacts;
 }
 
+/////////////////////////////////////////////////
+bool ContactManager::CountOnly() const
+{
+  ContactManagerPrivate *data = this->ContactManagerData();
+  return !data->recordAll && data->activeFilters.empty();
+}
+
+/////////////////////////////////////////////////
+unsigned int ContactManager::DroppedContactCount() const
+{
+  return this->ContactManagerData()->droppedContactCount;
+}
+
 /////////////////////////////////////////////////
 void ContactManager::ResetCount()
 {
+  ContactManagerPrivate *data = this->ContactManagerData();
   this->contactIndex = 0;
+  data->droppedContactCount = 0;
+  data->wrenchesPending = false;
+  this->UpdateDemand();
+}
+
+/////////////////////////////////////////////////
+void ContactManager::SetWrenchUpdater(const std::function<void()> &_updater)
+{
+  ContactManagerPrivate *data = this->ContactManagerData();
+  data->wrenchUpdater = _updater;
+  data->wrenchesPending = false;
+}
+
+/////////////////////////////////////////////////
+void ContactManager::SetWrenchesPending()
+{
+  ContactManagerPrivate *data = this->ContactManagerData();
+  data->wrenchesPending = static_cast<bool>(data->wrenchUpdater);
+}
+
+/////////////////////////////////////////////////
+void ContactManager::UpdateWrenches() const
+{
+  ContactManagerPrivate *data = this->ContactManagerData();
+  if (!data->wrenchesPending)
+    return;
+
+  // Clear the flag first, the updater writes to the contacts
+  data->wrenchesPending = false;
+  data->wrenchUpdater();
 }
 
 /////////////////////////////////////////////////
@@ -272,6 +417,8 @@ void ContactManager::Clear()
     delete this->contacts[i];
 
   this->contacts.clear();
+  this->ContactManagerData()->memory.Set(
+      this->contacts.capacity() * sizeof(Contact *));
 
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
@@ -280,6 +427,7 @@ void ContactManager::Clear()
 
   // Reset the contact count to zero.
   this->contactIndex = 0;
+  this->ContactManagerData()->wrenchesPending = false;
 }
 
 /////////////////////////////////////////////////
@@ -295,42 +443,57 @@ void ContactManager::PublishContacts()
     return;
   }
 
+  this->UpdateWrenches();
+
   // publish to default topic, ~/physics/contacts
-  if (!transport::getMinimalComms())
+  if (!transport::getMinimalComms() && this->contactPub->HasConnections())
   {
-    msgs::Contacts msg;
+    // Fill a recycled message, whose contacts are reused, and hand it to
+    // the publisher without a copy
+    auto msg = this->contactPub->BorrowMessage<msgs::Contacts>();
     for (unsigned int i = 0; i < this->contactIndex; ++i)
     {
       if (this->contacts[i]->count == 0)
         continue;
 
-      msgs::Contact *contactMsg = msg.add_contact();
+      msgs::Contact *contactMsg = msg->add_contact();
       this->contacts[i]->FillMsg(*contactMsg);
     }
 
-    msgs::Set(msg.mutable_time(), this->world->SimTime());
-    this->contactPub->Publish(msg);
+    msgs::Set(msg->mutable_time(), this->world->SimTime());
+    this->contactPub->Publish(transport::MessagePtr(msg));
   }
 
-  // publish to other custom topics
+  // publish to the custom topics that have subscribers
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
-  boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
-  for (iter = this->customContactPublishers.begin();
-      iter != this->customContactPublishers.end(); ++iter)
+  ContactManagerPrivate *data = this->ContactManagerData();
+  for (auto const &contactPublisher : data->activeFilters)
   {
-    ContactPublisher *contactPublisher = iter->second;
-    msgs::Contacts msg2;
+    // Hand the contacts to the callback as they are
+    auto callback = data->callbacks.find(contactPublisher);
+    if (callback != data->callbacks.end())
+    {
+      auto &contacts = contactPublisher->contacts;
+      contacts.erase(std::remove_if(contacts.begin(), contacts.end(),
+          [](const Contact *_contact) {return _contact->count == 0;}),
+          contacts.end());
+      callback->second(contacts);
+      contacts.clear();
+      continue;
+    }
+
+    auto msg2 = contactPublisher->publisher->BorrowMessage<msgs::Contacts>();
     for (unsigned int j = 0;
         j < contactPublisher->contacts.size(); ++j)
     {
       if (contactPublisher->contacts[j]->count == 0)
         continue;
 
-      msgs::Contact *contactMsg = msg2.add_contact();
+      msgs::Contact *contactMsg = msg2->add_contact();
       contactPublisher->contacts[j]->FillMsg(*contactMsg);
     }
-    msgs::Set(msg2.mutable_time(), this->world->SimTime());
-    contactPublisher->publisher->Publish(msg2);
+    msgs::Set(msg2->mutable_time(), this->world->SimTime());
+    contactPublisher->publisher->Publish(transport::MessagePtr(msg2));
     contactPublisher->contacts.clear();
   }
 }
@@ -363,6 +526,7 @@ std::string ContactManager::CreateFilter(const std::string &_name,
 
   ContactPublisher *contactPublisher = new ContactPublisher;
   contactPublisher->publisher = this->node->Advertise<msgs::Contacts>(topic);
+  contactPublisher->publisher->SetPriority(transport::Publisher::BULK);
 
   std::map<std::string, physics::CollisionPtr>::const_iterator iter;
   for (iter = _collisions.begin(); iter != _collisions.end(); ++iter)
@@ -424,6 +588,44 @@ std::string ContactManager::CreateFilter(const std::string &_name,
   return topic;
 }
 
+/////////////////////////////////////////////////
+bool ContactManager::CreateFilter(const std::string &_name,
+    const std::vector<std::string> &_collisions,
+    const std::function<void(const std::vector<Contact *> &)> &_callback)
+{
+  if (_collisions.empty() || !_callback)
+    return false;
+
+  std::string name = _name;
+  boost::replace_all(name, "::", "/");
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  if (this->customContactPublishers.find(name) !=
+    this->customContactPublishers.end())
+  {
+    gzerr << "Filter with the same name already exists! Aborting" << std::endl;
+    return false;
+  }
+
+  ContactPublisher *contactPublisher = new ContactPublisher;
+  this->ContactManagerData()->callbacks[contactPublisher] = _callback;
+
+  // some collisions may not be loaded yet, so store their names in
+  // collisionNames and try to find them later.
+  for (auto const &collisionName : _collisions)
+  {
+    Collision *col = boost::dynamic_pointer_cast<Collision>(
+        this->world->BaseByName(collisionName)).get();
+    if (col)
+      contactPublisher->collisions.insert(col);
+    else
+      contactPublisher->collisionNames.push_back(collisionName);
+  }
+
+  this->customContactPublishers[name] = contactPublisher;
+  return true;
+}
+
 /////////////////////////////////////////////////
 void ContactManager::RemoveFilter(const std::string &_name)
 {
@@ -436,11 +638,27 @@ void ContactManager::RemoveFilter(const std::string &_name)
   if (iter != customContactPublishers.end())
   {
     ContactPublisher *contactPublisher = iter->second;
+    ContactManagerPrivate *data = this->ContactManagerData();
+    data->activeFilters.erase(std::remove(data->activeFilters.begin(),
+        data->activeFilters.end(), contactPublisher),
+        data->activeFilters.end());
+    for (auto const &col : contactPublisher->collisions)
+    {
+      auto filters = data->collisionFilters.find(col);
+      if (filters == data->collisionFilters.end())
+        continue;
+      filters->second.erase(std::remove(filters->second.begin(),
+          filters->second.end(), contactPublisher), filters->second.end());
+      if (filters->second.empty())
+        data->collisionFilters.erase(filters);
+    }
     contactPublisher->contacts.clear();
     contactPublisher->collisionNames.clear();
     contactPublisher->collisions.clear();
-    contactPublisher->publisher->Fini();
+    if (contactPublisher->publisher)
+      contactPublisher->publisher->Fini();
     contactPublisher->publisher.reset();
+    data->callbacks.erase(contactPublisher);
     this->customContactPublishers.erase(iter);
   }
 }
@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 #define GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <map>
@@ -37,11 +38,14 @@ namespace gazebo
 {
   namespace physics
   {
+    class ContactManagerPrivate;
+
     /// \brief A custom contact publisher created for each contact filter
     /// in the Contact Manager.
     class GZ_PHYSICS_VISIBLE ContactPublisher
     {
-      /// \brief Contact message publisher
+      /// \brief Contact message publisher, null for filters that hand
+      /// their contacts to a callback.
       public: transport::PublisherPtr publisher;
 
       /// \brief Pointers of collisions monitored by contact manager for
@@ -122,15 +126,9 @@ namespace gazebo
       /// \e _collision1 or \e collision2, given that they have been loaded
       /// into the world already.
       /// This is the same test which NewContact() uses to determine whether
-      /// there are any subscribers for the contacts, but the test here is
-      /// optimized because it returns as soon as one subscriber is found which
-      /// listens to either of the collisions.
-      /// Note that this function needs to go through the list of custom
-      /// publishers and check whether \e _collsion1 or \e _collision2
-      /// are part of the custom publishers and whether they have been loaded
-      /// into the world, which comes at a cost.
-      /// Unless there are any benefits in calling this function ahead of
-      /// NewContact, it may be better to just use NewContact() directly.
+      /// there are any subscribers for the contacts. The listeners are
+      /// collected once per step by ResetCount, so the test only looks up
+      /// the collisions in the filters that have subscribers.
       /// Also note that in order to exclude that NewContact() returns NULL,
       /// it is advisable to check NeverDropContacts() first (if it returns
       /// true, NewContacts() never returns NULL).
@@ -143,6 +141,18 @@ namespace gazebo
       /// \brief Return the number of valid contacts.
       public: unsigned int GetContactCount() const;
 
+      /// \brief Return true if nobody listens to the contacts of the
+      /// current step: the default topic has no subscribers, no filter has
+      /// subscribers and NeverDropContacts() is false. NewContact then only
+      /// counts the contacts, see DroppedContactCount.
+      /// \return True if no contact is recorded in the current step.
+      public: bool CountOnly() const;
+
+      /// \brief Return the number of contacts of the current step that
+      /// were not recorded because nobody listens to them.
+      /// \return Number of dropped contacts.
+      public: unsigned int DroppedContactCount() const;
+
       /// \brief Get a single contact by index. The index must be between
       /// 0 and ContactManager::GetContactCount.
       /// \param[in] _index Index of the Contact to return.
@@ -162,9 +172,23 @@ namespace gazebo
       /// \brief Publish all contacts in a msgs::Contacts message.
       public: void PublishContacts();
 
-      /// \brief Set the contact count to zero.
+      /// \brief Set the contact count to zero, and collect the listeners
+      /// of the contacts of the next step. Called by the physics engine
+      /// before each collision detection pass.
       public: void ResetCount();
 
+      /// \brief Set the function that fills in the wrenches of the current
+      /// contacts. Physics engines that convert wrenches on demand set it,
+      /// then call SetWrenchesPending after each step. The function is
+      /// called on the first access to the contacts through GetContact,
+      /// GetContacts or PublishContacts.
+      /// \param[in] _updater The function, nullptr to remove it.
+      public: void SetWrenchUpdater(const std::function<void()> &_updater);
+
+      /// \brief Mark the wrenches of the current contacts as not computed
+      /// yet, see SetWrenchUpdater.
+      public: void SetWrenchesPending();
+
       /// \brief Create a filter for contacts. A new publisher will be created
       /// that publishes contacts associated to the input collisions.
       /// param[in] _name Filter name.
@@ -191,6 +215,20 @@ namespace gazebo
                   const std::map<std::string, physics::CollisionPtr>
                   &_collisions);
 
+      /// \brief Create a filter for contacts that hands the contacts of the
+      /// input collisions to a callback after each step, instead of
+      /// publishing them. The contacts are owned by the contact manager and
+      /// are only valid during the call, which is made from the physics
+      /// thread. Unlike the other filters, the filter is always active.
+      /// param[in] _name Filter name.
+      /// param[in] _collisions A list of collision names used for filtering.
+      /// param[in] _callback Function that receives the contacts.
+      /// \return True if the filter was created.
+      public: bool CreateFilter(const std::string &_name,
+                  const std::vector<std::string> &_collisions,
+                  const std::function<void(const std::vector<Contact *> &)>
+                  &_callback);
+
       /// \brief Remove a contacts filter and the associated custom publisher
       /// param[in] _name Filter name.
       public: void RemoveFilter(const std::string &_name);
@@ -204,16 +242,17 @@ namespace gazebo
       /// return True if the filter exists.
       public: bool HasFilter(const std::string &_name);
 
-      /// \brief Helper function which gets the custom publishers which publish
-      ///   contacts of either \e _collision1 or \e _collision2.
-      /// \param[in] _collision1 the first collision object
-      /// \param[in] _collision2 the second collision object
-      /// \param[in] _getOnlyConnected return only publishers which currently
-      ///   have subscribers
-      /// \param[out] _publishers the resulting publishers.
-      private: void GetCustomPublishers(Collision *_collision1,
-                       Collision *_collision2, const bool _getOnlyConnected,
-                       std::vector<ContactPublisher*> &_publishers);
+      /// \brief Call the wrench updater if the wrenches are pending.
+      private: void UpdateWrenches() const;
+
+      /// \brief Collect the custom publishers that have subscribers, and
+      /// check whether the default topic has subscribers. Collisions that
+      /// were not loaded when their filter was created are looked up here.
+      private: void UpdateDemand();
+
+      /// \brief Get the private data of the contact manager.
+      /// \return The private data, see ContactManagerPrivate.
+      private: ContactManagerPrivate *ContactManagerData() const;
 
       private: std::vector<Contact*> contacts;
 
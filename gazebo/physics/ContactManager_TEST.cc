@@ -15,6 +15,10 @@
  *
 */
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/test/ServerFixture.hh"
 
@@ -194,6 +198,172 @@ TEST_F(ContactManagerTest, NeverDropContacts)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, WrenchUpdater)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // The ODE contact wrenches are filled in on the first access after a
+  // step, they must match the weight of the box resting on the ground.
+  manager->SetNeverDropContacts(true);
+  world->Step(100);
+  ASSERT_GT(manager->GetContactCount(), 0u);
+
+  double normalForce = 0;
+  for (unsigned int i = 0; i < manager->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = manager->GetContact(i);
+    for (int j = 0; j < contact->count; ++j)
+    {
+      normalForce += std::abs(contact->wrench[j].body1Force.Z()) +
+          std::abs(contact->wrench[j].body2Force.Z());
+    }
+  }
+  EXPECT_GT(normalForce, 0.0);
+
+  // The updater is called once per pending step
+  int calls = 0;
+  manager->SetWrenchUpdater([&calls]() {++calls;});
+  manager->GetContacts();
+  EXPECT_EQ(calls, 0);
+
+  manager->SetWrenchesPending();
+  manager->GetContacts();
+  manager->GetContact(0);
+  EXPECT_EQ(calls, 1);
+
+  // Resetting the contacts drops the pending update
+  manager->SetWrenchesPending();
+  manager->ResetCount();
+  manager->GetContacts();
+  EXPECT_EQ(calls, 1);
+
+  manager->SetWrenchUpdater(nullptr);
+  manager->SetWrenchesPending();
+  manager->GetContacts();
+  EXPECT_EQ(calls, 1);
+}
+
+/////////////////////////////////////////////////
+void OnContacts(ConstContactsPtr &/*_msg*/)
+{
+}
+
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, CountOnly)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // Nobody listens, the contacts are only counted
+  world->Step(10);
+  EXPECT_TRUE(manager->CountOnly());
+  EXPECT_EQ(manager->GetContactCount(), 0u);
+  EXPECT_GT(manager->DroppedContactCount(), 0u);
+
+  // A filter without subscribers does not record contacts
+  std::string topic = manager->CreateFilter("box_filter",
+      "box::link::collision");
+  EXPECT_FALSE(topic.empty());
+  world->Step(1);
+  EXPECT_TRUE(manager->CountOnly());
+  EXPECT_EQ(manager->GetContactCount(), 0u);
+
+  // Only the contacts of the filtered collision are recorded once the
+  // filter has a subscriber
+  transport::SubscriberPtr sub = this->node->Subscribe(topic, &OnContacts);
+  world->Step(1);
+  EXPECT_FALSE(manager->CountOnly());
+  ASSERT_GT(manager->GetContactCount(), 0u);
+  EXPECT_EQ(manager->DroppedContactCount(), 0u);
+  for (unsigned int i = 0; i < manager->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = manager->GetContact(i);
+    EXPECT_TRUE(contact->collision1->GetScopedName() ==
+        "box::link::collision" ||
+        contact->collision2->GetScopedName() == "box::link::collision");
+  }
+
+  // Back to counting once the subscriber is gone
+  sub.reset();
+  manager->RemoveFilter("box_filter");
+  world->Step(1);
+  EXPECT_TRUE(manager->CountOnly());
+  EXPECT_EQ(manager->GetContactCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, CallbackFilter)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  int calls = 0;
+  std::vector<physics::Contact *> contacts;
+  auto callback = [&](const std::vector<physics::Contact *> &_contacts)
+  {
+    ++calls;
+    contacts = _contacts;
+  };
+
+  EXPECT_FALSE(manager->CreateFilter("empty_filter",
+      std::vector<std::string>(), callback));
+  EXPECT_FALSE(manager->HasFilter("empty_filter"));
+
+  // The filter monitors both collisions of the contact, which is handed
+  // to the callback once
+  std::vector<std::string> collisions = {"box::link::collision",
+      "ground_plane::link::collision"};
+  EXPECT_TRUE(manager->CreateFilter("box_filter", collisions, callback));
+  EXPECT_FALSE(manager->CreateFilter("box_filter", collisions, callback));
+  EXPECT_TRUE(manager->HasFilter("box_filter"));
+
+  // The callback filter is active without subscribers
+  world->Step(2);
+  EXPECT_FALSE(manager->CountOnly());
+  EXPECT_EQ(calls, 2);
+  ASSERT_FALSE(contacts.empty());
+  EXPECT_LE(contacts.size(), manager->GetContactCount());
+  for (auto const &contact : contacts)
+  {
+    EXPECT_GT(contact->count, 0);
+    EXPECT_TRUE(contact->collision1->GetScopedName() ==
+        "box::link::collision" ||
+        contact->collision2->GetScopedName() == "box::link::collision");
+  }
+
+  manager->RemoveFilter("box_filter");
+  EXPECT_FALSE(manager->HasFilter("box_filter"));
+  world->Step(1);
+  EXPECT_EQ(calls, 2);
+  EXPECT_TRUE(manager->CountOnly());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_CONTACTPOINT_HH_
+#define GAZEBO_PHYSICS_CONTACTPOINT_HH_
+
+#include <functional>
+#include <ignition/math/Vector3.hh>
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class Collision;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class ContactPoint ContactPoint.hh physics/physics.hh
+    /// \brief A contact point between two collisions, as generated by the
+    /// physics engine before the solve. A contact callback can change the
+    /// friction of the point, e.g. to simulate a conveyor belt or a track.
+    /// \sa PhysicsEngine::SetContactCallback
+    class ContactPoint
+    {
+      /// \brief Position of the point in world frame.
+      public: ignition::math::Vector3d position;
+
+      /// \brief Normal of the contact in world frame, in the direction the
+      /// physics engine reports it.
+      public: ignition::math::Vector3d normal;
+
+      /// \brief Penetration depth.
+      public: double depth = 0;
+
+      /// \brief First friction direction in world frame. Zero to keep the
+      /// direction given by the surfaces of the collisions.
+      public: ignition::math::Vector3d frictionDirection1;
+
+      /// \brief Velocity of the surface along frictionDirection1, which
+      /// the solver tries to reach at the point. Only used with a non zero
+      /// frictionDirection1.
+      public: double surfaceMotion1 = 0;
+    };
+
+    /// \def ContactCallback
+    /// \brief Callback that modifies the contact points between two
+    /// collisions. The collision the callback is set on can be either of
+    /// the two.
+    /// \param[in] _collision1 First collision.
+    /// \param[in] _collision2 Second collision.
+    /// \param[in,out] _points Contact points.
+    /// \param[in] _count Number of contact points.
+    typedef std::function<void(Collision *_collision1, Collision *_collision2,
+        ContactPoint *_points, const unsigned int _count)> ContactCallback;
+
+    /// \}
+  }
+}
+#endif
@@ -86,8 +86,13 @@ void Entity::Load(sdf::ElementPtr _sdf)
   Base::Load(_sdf);
   this->node->Init(this->GetWorld()->Name());
 
-  this->poseSub = this->node->Subscribe("~/pose/modify",
-      &Entity::OnPoseMsg, this);
+  // The parts of compact static models are only moved with their model
+  if (!this->IsStatic() || !this->parentEntity ||
+      !this->GetWorld()->CompactStaticModels())
+  {
+    this->poseSub = this->node->Subscribe("~/pose/modify",
+        &Entity::OnPoseMsg, this);
+  }
   this->visPub = this->node->Advertise<msgs::Visual>("~/visual", 200);
   this->requestPub = this->node->Advertise<msgs::Request>("~/request");
 
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the FreezeRegistry class
+    class FreezeRegistryPrivate
+    {
+      /// \brief Append the links of a model and its nested models.
+      /// \param[in] _model The model.
+      /// \param[out] _links Links are appended here.
+      public: static void CollectLinks(const ModelPtr &_model,
+                  std::vector<Link *> &_links)
+      {
+        for (auto const &link : _model->GetLinks())
+          _links.push_back(link.get());
+        for (auto const &nested : _model->NestedModels())
+          CollectLinks(nested, _links);
+      }
+
+      /// \brief Number of requests of each frozen link, by reason.
+      public: std::unordered_map<const Link *,
+              std::map<std::string, unsigned int>> links;
+
+      /// \brief Protects links. Models are frozen from the world thread,
+      /// but plugins may also freeze them from transport callbacks.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+FreezeRegistry::FreezeRegistry()
+  : dataPtr(new FreezeRegistryPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+FreezeRegistry::~FreezeRegistry()
+{
+}
+
+/////////////////////////////////////////////////
+void FreezeRegistry::Freeze(Link *_link, const std::string &_reason)
+{
+  if (!_link)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &reasons = this->dataPtr->links[_link];
+  const bool frozen = !reasons.empty();
+  ++reasons[_reason];
+  if (!frozen)
+    _link->SetEnabled(false);
+}
+
+/////////////////////////////////////////////////
+bool FreezeRegistry::Unfreeze(Link *_link, const std::string &_reason)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->links.find(_link);
+  if (iter == this->dataPtr->links.end())
+    return false;
+
+  auto reason = iter->second.find(_reason);
+  if (reason == iter->second.end())
+    return false;
+
+  if (--reason->second == 0)
+    iter->second.erase(reason);
+
+  if (iter->second.empty())
+  {
+    this->dataPtr->links.erase(iter);
+    _link->SetEnabled(true);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void FreezeRegistry::Freeze(const ModelPtr &_model,
+    const std::string &_reason)
+{
+  if (!_model)
+    return;
+
+  std::vector<Link *> links;
+  FreezeRegistryPrivate::CollectLinks(_model, links);
+  for (auto const &link : links)
+    this->Freeze(link, _reason);
+}
+
+/////////////////////////////////////////////////
+void FreezeRegistry::Unfreeze(const ModelPtr &_model,
+    const std::string &_reason)
+{
+  if (!_model)
+    return;
+
+  std::vector<Link *> links;
+  FreezeRegistryPrivate::CollectLinks(_model, links);
+  for (auto const &link : links)
+    this->Unfreeze(link, _reason);
+}
+
+/////////////////////////////////////////////////
+void FreezeRegistry::UnfreezeAll(const std::string &_reason)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto iter = this->dataPtr->links.begin();
+       iter != this->dataPtr->links.end();)
+  {
+    iter->second.erase(_reason);
+    if (iter->second.empty())
+    {
+      iter->first->SetEnabled(true);
+      iter = this->dataPtr->links.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+/////////////////////////////////////////////////
+void FreezeRegistry::RemoveAll(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->links.erase(_link);
+}
+
+/////////////////////////////////////////////////
+bool FreezeRegistry::Frozen(const Link *_link) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->links.find(_link) != this->dataPtr->links.end();
+}
+
+/////////////////////////////////////////////////
+unsigned int FreezeRegistry::Requests(const Link *_link,
+    const std::string &_reason) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->links.find(_link);
+  if (iter == this->dataPtr->links.end())
+    return 0;
+
+  auto reason = iter->second.find(_reason);
+  return reason == iter->second.end() ? 0 : reason->second;
+}
+
+/////////////////////////////////////////////////
+unsigned int FreezeRegistry::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->links.size();
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_FREEZEREGISTRY_HH_
+#define GAZEBO_PHYSICS_FREEZEREGISTRY_HH_
+
+#include <memory>
+#include <string>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class FreezeRegistryPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class FreezeRegistry FreezeRegistry.hh physics/physics.hh
+    /// \brief Arbitrates the freezing of links between the features that
+    /// disable them, such as the SleepManager, the ActivityZoneManager and
+    /// the WorldPartitionPlugin.
+    ///
+    /// Each feature freezes and unfreezes links with its own reason, such
+    /// as "sleep". Requests are counted per link and reason, and a link is
+    /// disabled, see Link::SetEnabled, while it has a request for any
+    /// reason. This way a model woken up by a contact stays frozen if it is
+    /// also outside of the activity zones.
+    ///
+    /// The registry is owned by the World, see World::Freezes.
+    class GZ_PHYSICS_VISIBLE FreezeRegistry
+    {
+      /// \brief Constructor.
+      public: FreezeRegistry();
+
+      /// \brief Destructor.
+      public: ~FreezeRegistry();
+
+      /// \brief Add a freeze request for a link. The link is disabled by
+      /// its first request.
+      /// \param[in] _link The link.
+      /// \param[in] _reason Reason of the request, such as "sleep".
+      public: void Freeze(Link *_link, const std::string &_reason);
+
+      /// \brief Withdraw a request made with Freeze. The link is enabled
+      /// once all its requests are withdrawn, whatever their reason.
+      /// \param[in] _link The link.
+      /// \param[in] _reason Reason of the request.
+      /// \return False if the link had no request for the reason.
+      public: bool Unfreeze(Link *_link, const std::string &_reason);
+
+      /// \brief Freeze the links of a model and of its nested models.
+      /// \param[in] _model The model.
+      /// \param[in] _reason Reason of the request.
+      public: void Freeze(const ModelPtr &_model, const std::string &_reason);
+
+      /// \brief Withdraw a request made with Freeze for a model.
+      /// \param[in] _model The model.
+      /// \param[in] _reason Reason of the request.
+      public: void Unfreeze(const ModelPtr &_model,
+                  const std::string &_reason);
+
+      /// \brief Withdraw all the requests made for a reason.
+      /// \param[in] _reason Reason of the requests.
+      public: void UnfreezeAll(const std::string &_reason);
+
+      /// \brief Forget a link, without enabling it. Called by Link::Fini.
+      /// \param[in] _link The link.
+      public: void RemoveAll(Link *_link);
+
+      /// \brief Get whether a link has freeze requests.
+      /// \param[in] _link The link.
+      /// \return True if the link has a request for any reason.
+      public: bool Frozen(const Link *_link) const;
+
+      /// \brief Get the number of freeze requests of a link for a reason.
+      /// \param[in] _link The link.
+      /// \param[in] _reason Reason of the requests.
+      /// \return Number of requests.
+      public: unsigned int Requests(const Link *_link,
+                  const std::string &_reason) const;
+
+      /// \brief Get the number of frozen links.
+      /// \return Number of links with at least one request.
+      public: unsigned int LinkCount() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<FreezeRegistryPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
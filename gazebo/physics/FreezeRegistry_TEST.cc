@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
+#include "gazebo/physics/SleepManager.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class FreezeRegistryTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(FreezeRegistryTest, Reasons)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  auto link = box->GetLink();
+  ASSERT_NE(nullptr, link);
+
+  physics::FreezeRegistry &freezes = world->Freezes();
+  EXPECT_EQ(0u, freezes.LinkCount());
+  EXPECT_FALSE(freezes.Unfreeze(link.get(), "sleep"));
+
+  // Requests are counted per reason
+  freezes.Freeze(box, "sleep");
+  freezes.Freeze(box, "activity_zones");
+  freezes.Freeze(box, "activity_zones");
+  EXPECT_TRUE(freezes.Frozen(link.get()));
+  EXPECT_FALSE(link->GetEnabled());
+  EXPECT_EQ(1u, freezes.Requests(link.get(), "sleep"));
+  EXPECT_EQ(2u, freezes.Requests(link.get(), "activity_zones"));
+  EXPECT_EQ(1u, freezes.LinkCount());
+
+  // The link stays frozen while any reason remains
+  EXPECT_TRUE(freezes.Unfreeze(link.get(), "sleep"));
+  EXPECT_FALSE(freezes.Unfreeze(link.get(), "sleep"));
+  EXPECT_FALSE(link->GetEnabled());
+  freezes.Unfreeze(box, "activity_zones");
+  EXPECT_FALSE(link->GetEnabled());
+  freezes.Unfreeze(box, "activity_zones");
+  EXPECT_FALSE(freezes.Frozen(link.get()));
+  EXPECT_TRUE(link->GetEnabled());
+
+  // All the requests of a reason
+  freezes.Freeze(box, "world_partition");
+  freezes.Freeze(box, "world_partition");
+  freezes.Freeze(box, "sleep");
+  freezes.UnfreezeAll("world_partition");
+  EXPECT_FALSE(link->GetEnabled());
+  freezes.UnfreezeAll("sleep");
+  EXPECT_TRUE(link->GetEnabled());
+  EXPECT_EQ(0u, freezes.LinkCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(FreezeRegistryTest, WakeKeepsOtherReasons)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  physics::SleepManager *sleepManager = world->Physics()->SleepMgr();
+  sleepManager->SetEnabled(true);
+  sleepManager->SetSleepTime(0.1);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  auto link = box->GetLink();
+  ASSERT_NE(nullptr, link);
+
+  world->Step(500);
+  ASSERT_TRUE(sleepManager->IsSleeping(box));
+  EXPECT_EQ(1u, world->Freezes().Requests(link.get(), "sleep"));
+
+  // Waking up a model that is also frozen by another feature doesn't
+  // unfreeze it
+  world->Freezes().Freeze(box, "activity_zones");
+  sleepManager->Wake(box);
+  EXPECT_FALSE(sleepManager->IsSleeping(box));
+  EXPECT_EQ(0u, world->Freezes().Requests(link.get(), "sleep"));
+  EXPECT_FALSE(link->GetEnabled());
+
+  world->Freezes().Unfreeze(box, "activity_zones");
+  EXPECT_TRUE(link->GetEnabled());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
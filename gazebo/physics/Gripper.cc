@@ -14,9 +14,11 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <functional>
-#include <map>
 #include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <ignition/math/Helpers.hh>
@@ -26,9 +28,6 @@
 
 #include "gazebo/common/Events.hh"
 
-#include "gazebo/transport/Node.hh"
-#include "gazebo/transport/Subscriber.hh"
-
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Joint.hh"
@@ -46,9 +45,15 @@ using namespace physics;
 /// \brief Private data class for Gripper
 class gazebo::physics::GripperPrivate
 {
-  /// \brief Callback used when the gripper contacts an object.
-  /// \param[in] _msg Message that contains contact information.
-  public: void OnContacts(ConstContactsPtr &_msg);
+  /// \brief Callback that receives the contacts of the gripper
+  /// collisions after each step.
+  /// \param[in] _contacts The contacts.
+  public: void OnContacts(const std::vector<Contact *> &_contacts);
+
+  /// \brief Count a contact of a collision, unless it belongs to the
+  /// gripper.
+  /// \param[in] _collision The collision.
+  public: void CountContact(Collision *_collision);
 
   /// \brief Update the gripper.
   public: void OnUpdate();
@@ -78,12 +83,17 @@ class gazebo::physics::GripperPrivate
   public: std::vector<event::ConnectionPtr> connections;
 
   /// \brief The collisions for the links in the gripper.
-  public: std::map<std::string, physics::CollisionPtr> collisions;
+  public: std::vector<Collision *> collisions;
+
+  /// \brief Number of contacts between dynamic collisions since the last
+  /// update.
+  public: unsigned int contactCount = 0;
 
-  /// \brief The current contacts.
-  public: std::vector<msgs::Contact> contacts;
+  /// \brief Collisions of other objects touching the gripper since the
+  /// last update, with their number of contacts.
+  public: std::vector<std::pair<CollisionPtr, unsigned int>> contactCounts;
 
-  /// \brief Mutex used to protect reading/writing the contact message.
+  /// \brief Mutex used to protect the contact counts.
   public: std::mutex mutexContacts;
 
   /// \brief True if the gripper has an object.
@@ -125,11 +135,8 @@ class gazebo::physics::GripperPrivate
   /// \brief Name of the gripper.
   public: std::string name;
 
-  /// \brief Node for communication.
-  public: transport::NodePtr node;
-
-  /// \brief Subscription to contact messages from the physics engine.
-  public: transport::SubscriberPtr contactSub;
+  /// \brief True if a contact filter was created.
+  public: bool filtered = false;
 };
 
 /////////////////////////////////////////////////
@@ -145,14 +152,13 @@ Gripper::Gripper(ModelPtr _model) : dataPtr(new GripperPrivate)
   this->dataPtr->attached = false;
 
   this->dataPtr->updateRate = common::Time(0, common::Time::SecToNano(0.75));
-
-  this->dataPtr->node = transport::NodePtr(new transport::Node());
 }
 
 /////////////////////////////////////////////////
 Gripper::~Gripper()
 {
-  if (this->dataPtr->world && this->dataPtr->world->Running())
+  if (this->dataPtr->filtered && this->dataPtr->world &&
+      this->dataPtr->world->Running())
   {
     physics::ContactManager *mgr =
         this->dataPtr->world->Physics()->GetContactManager();
@@ -167,8 +173,6 @@ Gripper::~Gripper()
 /////////////////////////////////////////////////
 void Gripper::Load(sdf::ElementPtr _sdf)
 {
-  this->dataPtr->node->Init(this->dataPtr->world->Name());
-
   this->dataPtr->name = _sdf->Get<std::string>("name");
   this->dataPtr->fixedJoint =
       this->dataPtr->world->Physics()->CreateJoint("fixed",
@@ -195,6 +199,7 @@ void Gripper::Load(sdf::ElementPtr _sdf)
 
   sdf::ElementPtr gripperLinkElem = _sdf->GetElement("gripper_link");
 
+  std::vector<std::string> collisionNames;
   while (gripperLinkElem)
   {
     physics::LinkPtr gripperLink
@@ -202,29 +207,28 @@ void Gripper::Load(sdf::ElementPtr _sdf)
     for (unsigned int j = 0; j < gripperLink->GetChildCount(); ++j)
     {
       physics::CollisionPtr collision = gripperLink->GetCollision(j);
-      std::map<std::string, physics::CollisionPtr>::iterator collIter
-        = this->dataPtr->collisions.find(collision->GetScopedName());
-      if (collIter != this->dataPtr->collisions.end())
+      if (std::find(this->dataPtr->collisions.begin(),
+            this->dataPtr->collisions.end(), collision.get()) !=
+          this->dataPtr->collisions.end())
+      {
         continue;
+      }
 
-      this->dataPtr->collisions[collision->GetScopedName()] = collision;
+      this->dataPtr->collisions.push_back(collision.get());
+      collisionNames.push_back(collision->GetScopedName());
     }
     gripperLinkElem = gripperLinkElem->GetNextElement("gripper_link");
   }
 
-  if (!this->dataPtr->collisions.empty())
+  if (!collisionNames.empty() && !this->dataPtr->filtered)
   {
-    // request the contact manager to publish messages to a custom topic for
-    // this sensor
+    // Have the contact manager hand the contacts of the gripper
+    // collisions to the gripper directly, without messages
     physics::ContactManager *mgr =
         this->dataPtr->world->Physics()->GetContactManager();
-    std::string topic = mgr->CreateFilter(this->Name(),
-        this->dataPtr->collisions);
-    if (!this->dataPtr->contactSub)
-    {
-      this->dataPtr->contactSub = this->dataPtr->node->Subscribe(topic,
-          &GripperPrivate::OnContacts, this->dataPtr.get());
-    }
+    this->dataPtr->filtered = mgr->CreateFilter(this->Name(), collisionNames,
+        std::bind(&GripperPrivate::OnContacts, this->dataPtr.get(),
+          std::placeholders::_1));
   }
   this->dataPtr->connections.push_back(event::Events::ConnectWorldUpdateEnd(
           std::bind(&GripperPrivate::OnUpdate, this->dataPtr.get())));
@@ -260,7 +264,7 @@ void GripperPrivate::OnUpdate()
   }
 
   // @todo: should package the decision into a function
-  if (this->contacts.size() >= this->minContactCount)
+  if (this->contactCount >= this->minContactCount)
   {
     this->posCount++;
     this->zeroCount = 0;
@@ -282,7 +286,8 @@ void GripperPrivate::OnUpdate()
 
   {
     std::lock_guard<std::mutex> lock(this->mutexContacts);
-    this->contacts.clear();
+    this->contactCount = 0;
+    this->contactCounts.clear();
   }
 
   this->prevUpdateTime = common::Time::GetWallTime();
@@ -297,69 +302,36 @@ void GripperPrivate::HandleAttach()
     return;
   }
 
-  std::map<std::string, physics::CollisionPtr> cc;
-  std::map<std::string, int> contactCounts;
-  std::map<std::string, int>::iterator iter;
-
-  // This function is only called from the OnUpdate function so
-  // the call to contacts.clear() is not going to happen in
-  // parallel with the reads in the following code, no mutex
-  // needed.
-  for (unsigned int i = 0; i < this->contacts.size(); ++i)
-  {
-    std::string name1 = this->contacts[i].collision1();
-    std::string name2 = this->contacts[i].collision2();
-
-    if (this->collisions.find(name1) == this->collisions.end())
-    {
-      cc[name1] = boost::dynamic_pointer_cast<Collision>(
-          this->world->EntityByName(name1));
-      contactCounts[name1] += 1;
-    }
-
-    if (this->collisions.find(name2) == this->collisions.end())
-    {
-      cc[name2] = boost::dynamic_pointer_cast<Collision>(
-          this->world->EntityByName(name2));
-      contactCounts[name2] += 1;
-    }
-  }
-
-  iter = contactCounts.begin();
-  while (iter != contactCounts.end())
+  // This function is only called from the OnUpdate function, before the
+  // counts are reset, and the contacts of the step were already handed to
+  // OnContacts, so no mutex is needed.
+  for (auto const &count : this->contactCounts)
   {
-    if (iter->second < 2)
-    {
-      contactCounts.erase(iter++);
-    }
-    else
-    {
-      if (!this->attached && cc[iter->first])
-      {
-        ignition::math::Pose3d diff =
-          cc[iter->first]->GetLink()->WorldPose() - this->palmLink->WorldPose();
+    if (count.second < 2 || this->attached)
+      continue;
 
-        double dd = (diff - this->prevDiff).Pos().SquaredLength();
+    LinkPtr link = count.first->GetLink();
+    ignition::math::Pose3d diff =
+      link->WorldPose() - this->palmLink->WorldPose();
 
-        this->prevDiff = diff;
+    double dd = (diff - this->prevDiff).Pos().SquaredLength();
 
-        this->diffs[this->diffIndex] = dd;
-        double var = ignition::math::variance<double>(this->diffs);
-        double max = ignition::math::max<double>(this->diffs);
+    this->prevDiff = diff;
 
-        if (var < 1e-5 && max < 1e-5)
-        {
-          this->attached = true;
+    this->diffs[this->diffIndex] = dd;
+    double var = ignition::math::variance<double>(this->diffs);
+    double max = ignition::math::max<double>(this->diffs);
 
-          this->fixedJoint->Load(this->palmLink,
-              cc[iter->first]->GetLink(), ignition::math::Pose3d());
-          this->fixedJoint->Init();
-        }
+    if (var < 1e-5 && max < 1e-5)
+    {
+      this->attached = true;
 
-        this->diffIndex = (this->diffIndex+1) % 10;
-      }
-      ++iter;
+      this->fixedJoint->Load(this->palmLink, link,
+          ignition::math::Pose3d());
+      this->fixedJoint->Init();
     }
+
+    this->diffIndex = (this->diffIndex+1) % 10;
   }
 }
 
@@ -371,22 +343,47 @@ void GripperPrivate::HandleDetach()
 }
 
 /////////////////////////////////////////////////
-void GripperPrivate::OnContacts(ConstContactsPtr &_msg)
+void GripperPrivate::OnContacts(const std::vector<Contact *> &_contacts)
+{
+  std::lock_guard<std::mutex> lock(this->mutexContacts);
+  for (auto const *contact : _contacts)
+  {
+    Collision *collision1 = contact->collision1;
+    Collision *collision2 = contact->collision2;
+    if (!collision1 || !collision2 || collision1->IsStatic() ||
+        collision2->IsStatic())
+    {
+      continue;
+    }
+
+    ++this->contactCount;
+    this->CountContact(collision1);
+    this->CountContact(collision2);
+  }
+}
+
+/////////////////////////////////////////////////
+void GripperPrivate::CountContact(Collision *_collision)
 {
-  for (int i = 0; i < _msg->contact_size(); ++i)
+  if (std::find(this->collisions.begin(), this->collisions.end(),
+        _collision) != this->collisions.end())
   {
-    CollisionPtr collision1 = boost::dynamic_pointer_cast<Collision>(
-        this->world->EntityByName(_msg->contact(i).collision1()));
-    CollisionPtr collision2 = boost::dynamic_pointer_cast<Collision>(
-        this->world->EntityByName(_msg->contact(i).collision2()));
+    return;
+  }
 
-    if ((collision1 && !collision1->IsStatic()) &&
-        (collision2 && !collision2->IsStatic()))
+  // Few objects touch a gripper at once, a linear search is enough
+  for (auto &count : this->contactCounts)
+  {
+    if (count.first.get() == _collision)
     {
-      std::lock_guard<std::mutex> lock(this->mutexContacts);
-      this->contacts.push_back(_msg->contact(i));
+      ++count.second;
+      return;
     }
   }
+
+  this->contactCounts.push_back(std::make_pair(
+      boost::static_pointer_cast<Collision>(_collision->shared_from_this()),
+      1u));
 }
 
 /////////////////////////////////////////////////
@@ -0,0 +1,446 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/HeightmapPyramid.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief One level of the pyramid.
+    class HeightmapPyramidLevel
+    {
+      /// \brief Number of nodes along each side.
+      public: unsigned int count = 0;
+
+      /// \brief Minimum height of each node, row after row.
+      public: std::vector<HeightmapPyramid::HeightType> min;
+
+      /// \brief Maximum height of each node, row after row.
+      public: std::vector<HeightmapPyramid::HeightType> max;
+    };
+
+    /// \internal
+    /// \brief Private data for HeightmapPyramid.
+    class HeightmapPyramidPrivate
+    {
+      /// \brief Merge the bounds of the nodes of a level that overlap a
+      /// range of tiles.
+      /// \param[in] _level Level of the node.
+      /// \param[in] _x Column of the node.
+      /// \param[in] _y Row of the node.
+      /// \param[in] _minX First tile column.
+      /// \param[in] _minY First tile row.
+      /// \param[in] _maxX Last tile column, inclusive.
+      /// \param[in] _maxY Last tile row, inclusive.
+      /// \param[in,out] _min Lower bound.
+      /// \param[in,out] _max Upper bound.
+      public: void Merge(const unsigned int _level, const unsigned int _x,
+                  const unsigned int _y, const unsigned int _minX,
+                  const unsigned int _minY, const unsigned int _maxX,
+                  const unsigned int _maxY,
+                  HeightmapPyramid::HeightType &_min,
+                  HeightmapPyramid::HeightType &_max) const;
+
+      /// \brief Get a resident tile of paged heights, loading it if needed.
+      /// Must be called with the cache mutex locked.
+      /// \param[in] _tile Index of the tile.
+      /// \return The heights of the tile, null if it couldn't be read.
+      public: const std::vector<HeightmapPyramid::HeightType> *Tile(
+                  const unsigned int _tile);
+
+      /// \brief Number of vertices along each side of the grid.
+      public: unsigned int size = 0;
+
+      /// \brief Number of cells along each side of a tile.
+      public: unsigned int tileSize = 32;
+
+      /// \brief Number of tiles along each side of the grid.
+      public: unsigned int tileCount = 0;
+
+      /// \brief Levels of the pyramid, from the tiles to the root.
+      public: std::vector<HeightmapPyramidLevel> levels;
+
+      /// \brief Path of the tile file of paged heights, empty if the heights
+      /// are not paged.
+      public: std::string tilePath;
+
+      /// \brief Tile file of paged heights.
+      public: std::ifstream tileFile;
+
+      /// \brief Maximum number of resident tiles.
+      public: unsigned int cacheSize = 256;
+
+      /// \brief Resident tiles, the most recently used first.
+      public: std::list<unsigned int> lru;
+
+      /// \brief Resident tiles and their position in the lru list.
+      public: std::unordered_map<unsigned int,
+              std::pair<std::vector<HeightmapPyramid::HeightType>,
+                        std::list<unsigned int>::iterator>> tiles;
+
+      /// \brief Protects the tile cache.
+      public: std::mutex cacheMutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+void HeightmapPyramidPrivate::Merge(const unsigned int _level,
+    const unsigned int _x, const unsigned int _y, const unsigned int _minX,
+    const unsigned int _minY, const unsigned int _maxX,
+    const unsigned int _maxY, HeightmapPyramid::HeightType &_min,
+    HeightmapPyramid::HeightType &_max) const
+{
+  const HeightmapPyramidLevel &level = this->levels[_level];
+  if (_x >= level.count || _y >= level.count)
+    return;
+
+  // Tiles covered by the node
+  const unsigned int first0 = _x << _level;
+  const unsigned int first1 = _y << _level;
+  const unsigned int last0 = first0 + (1u << _level) - 1;
+  const unsigned int last1 = first1 + (1u << _level) - 1;
+  if (first0 > _maxX || last0 < _minX || first1 > _maxY || last1 < _minY)
+    return;
+
+  if (_level == 0 || (first0 >= _minX && last0 <= _maxX &&
+                      first1 >= _minY && last1 <= _maxY))
+  {
+    const unsigned int index = _y * level.count + _x;
+    _min = std::min(_min, level.min[index]);
+    _max = std::max(_max, level.max[index]);
+    return;
+  }
+
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    this->Merge(_level - 1, _x * 2 + (i & 1), _y * 2 + (i >> 1),
+        _minX, _minY, _maxX, _maxY, _min, _max);
+  }
+}
+
+//////////////////////////////////////////////////
+const std::vector<HeightmapPyramid::HeightType> *HeightmapPyramidPrivate::Tile(
+    const unsigned int _tile)
+{
+  auto iter = this->tiles.find(_tile);
+  if (iter != this->tiles.end())
+  {
+    this->lru.splice(this->lru.begin(), this->lru, iter->second.second);
+    return &iter->second.first;
+  }
+
+  const unsigned int stride = this->tileSize + 1;
+  std::vector<HeightmapPyramid::HeightType> heights(stride * stride);
+  const std::streamsize bytes =
+    heights.size() * sizeof(HeightmapPyramid::HeightType);
+  this->tileFile.clear();
+  this->tileFile.seekg(static_cast<std::streamoff>(_tile) * bytes);
+  this->tileFile.read(reinterpret_cast<char *>(heights.data()), bytes);
+  if (!this->tileFile)
+  {
+    gzerr << "Unable to read heightmap tile [" << _tile << "] from ["
+          << this->tilePath << "]" << std::endl;
+    return nullptr;
+  }
+
+  while (this->tiles.size() >= this->cacheSize && !this->lru.empty())
+  {
+    this->tiles.erase(this->lru.back());
+    this->lru.pop_back();
+  }
+
+  this->lru.push_front(_tile);
+  auto &entry = this->tiles[_tile];
+  entry.first = std::move(heights);
+  entry.second = this->lru.begin();
+  return &entry.first;
+}
+
+//////////////////////////////////////////////////
+HeightmapPyramid::HeightmapPyramid()
+  : dataPtr(new HeightmapPyramidPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+HeightmapPyramid::~HeightmapPyramid()
+{
+  this->Clear();
+}
+
+//////////////////////////////////////////////////
+bool HeightmapPyramid::Build(const std::vector<HeightType> &_heights,
+    const unsigned int _size, const unsigned int _tileSize, const bool _page)
+{
+  this->Clear();
+
+  if (_size < 2 || _tileSize == 0 || _heights.size() != _size * _size)
+  {
+    gzerr << "Invalid heightmap pyramid parameters" << std::endl;
+    return false;
+  }
+
+  this->dataPtr->size = _size;
+  this->dataPtr->tileSize = _tileSize;
+  this->dataPtr->tileCount = (_size - 2) / _tileSize + 1;
+
+  // Tiles share their border vertices with their neighbors
+  const unsigned int count = this->dataPtr->tileCount;
+  HeightmapPyramidLevel tileLevel;
+  tileLevel.count = count;
+  tileLevel.min.resize(count * count, std::numeric_limits<HeightType>::max());
+  tileLevel.max.resize(count * count,
+      -std::numeric_limits<HeightType>::max());
+  for (unsigned int y = 0; y < _size; ++y)
+  {
+    const unsigned int ty = std::min(y / _tileSize, count - 1);
+    const bool border = y % _tileSize == 0 && y > 0 && y / _tileSize < count;
+    for (unsigned int x = 0; x < _size; ++x)
+    {
+      const HeightType h = _heights[y * _size + x];
+      const unsigned int tx = std::min(x / _tileSize, count - 1);
+      const bool borderX = x % _tileSize == 0 && x > 0 &&
+        x / _tileSize < count;
+
+      // A vertex belongs to up to 4 tiles
+      for (unsigned int i = 0; i < 4; ++i)
+      {
+        if (((i & 1) && !borderX) || ((i & 2) && !border))
+          continue;
+        const unsigned int index =
+          (ty - (i >> 1)) * count + (tx - (i & 1));
+        tileLevel.min[index] = std::min(tileLevel.min[index], h);
+        tileLevel.max[index] = std::max(tileLevel.max[index], h);
+      }
+    }
+  }
+  this->dataPtr->levels.push_back(std::move(tileLevel));
+
+  while (this->dataPtr->levels.back().count > 1)
+  {
+    const HeightmapPyramidLevel &child = this->dataPtr->levels.back();
+    HeightmapPyramidLevel level;
+    level.count = (child.count + 1) / 2;
+    level.min.resize(level.count * level.count,
+        std::numeric_limits<HeightType>::max());
+    level.max.resize(level.count * level.count,
+        -std::numeric_limits<HeightType>::max());
+    for (unsigned int y = 0; y < child.count; ++y)
+    {
+      for (unsigned int x = 0; x < child.count; ++x)
+      {
+        const unsigned int index = (y / 2) * level.count + x / 2;
+        level.min[index] = std::min(level.min[index],
+            child.min[y * child.count + x]);
+        level.max[index] = std::max(level.max[index],
+            child.max[y * child.count + x]);
+      }
+    }
+    this->dataPtr->levels.push_back(std::move(level));
+  }
+
+  if (!_page)
+    return true;
+
+  // Write the tiles one after the other, padding the tiles at the end of
+  // the grid with its last row and column
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_heightmap_%%%%-%%%%.tiles");
+  std::ofstream out(path.string(), std::ios::binary);
+  const unsigned int stride = _tileSize + 1;
+  std::vector<HeightType> tile(stride * stride);
+  for (unsigned int ty = 0; ty < count && out; ++ty)
+  {
+    for (unsigned int tx = 0; tx < count && out; ++tx)
+    {
+      for (unsigned int y = 0; y < stride; ++y)
+      {
+        const unsigned int gy = std::min(ty * _tileSize + y, _size - 1);
+        for (unsigned int x = 0; x < stride; ++x)
+        {
+          const unsigned int gx = std::min(tx * _tileSize + x, _size - 1);
+          tile[y * stride + x] = _heights[gy * _size + gx];
+        }
+      }
+      out.write(reinterpret_cast<const char *>(tile.data()),
+          tile.size() * sizeof(HeightType));
+    }
+  }
+  out.close();
+
+  this->dataPtr->tilePath = path.string();
+  this->dataPtr->tileFile.open(this->dataPtr->tilePath, std::ios::binary);
+  if (!out || !this->dataPtr->tileFile)
+  {
+    gzerr << "Unable to write heightmap tiles to [" << path.string() << "]"
+          << std::endl;
+    this->Clear();
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void HeightmapPyramid::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->size = 0;
+  this->dataPtr->tileCount = 0;
+  this->dataPtr->levels.clear();
+  this->dataPtr->tiles.clear();
+  this->dataPtr->lru.clear();
+
+  if (this->dataPtr->tileFile.is_open())
+    this->dataPtr->tileFile.close();
+  if (!this->dataPtr->tilePath.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(this->dataPtr->tilePath, ec);
+    this->dataPtr->tilePath.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapPyramid::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapPyramid::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapPyramid::LevelCount() const
+{
+  return this->dataPtr->levels.size();
+}
+
+//////////////////////////////////////////////////
+bool HeightmapPyramid::Paged() const
+{
+  return !this->dataPtr->tilePath.empty();
+}
+
+//////////////////////////////////////////////////
+void HeightmapPyramid::SetCacheSize(const unsigned int _tiles)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->cacheSize = std::max(_tiles, 1u);
+  while (this->dataPtr->tiles.size() > this->dataPtr->cacheSize)
+  {
+    this->dataPtr->tiles.erase(this->dataPtr->lru.back());
+    this->dataPtr->lru.pop_back();
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapPyramid::CacheSize() const
+{
+  return this->dataPtr->cacheSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapPyramid::ResidentTileCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  return this->dataPtr->tiles.size();
+}
+
+//////////////////////////////////////////////////
+HeightmapPyramid::HeightType HeightmapPyramid::Height(const int _x,
+    const int _y) const
+{
+  const int size = static_cast<int>(this->dataPtr->size);
+  if (!this->Paged() || _x < 0 || _y < 0 || _x >= size || _y >= size)
+    return 0;
+
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  const unsigned int count = this->dataPtr->tileCount;
+  const unsigned int tx = std::min(_x / tileSize, count - 1);
+  const unsigned int ty = std::min(_y / tileSize, count - 1);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  const std::vector<HeightType> *tile =
+    this->dataPtr->Tile(ty * count + tx);
+  if (!tile)
+    return 0;
+
+  const unsigned int x = _x - tx * tileSize;
+  const unsigned int y = _y - ty * tileSize;
+  return (*tile)[y * (tileSize + 1) + x];
+}
+
+//////////////////////////////////////////////////
+bool HeightmapPyramid::Range(int _minX, int _minY, int _maxX, int _maxY,
+    HeightType &_min, HeightType &_max) const
+{
+  const int size = static_cast<int>(this->dataPtr->size);
+  _minX = std::max(_minX, 0);
+  _minY = std::max(_minY, 0);
+  _maxX = std::min(_maxX, size - 1);
+  _maxY = std::min(_maxY, size - 1);
+  if (this->dataPtr->levels.empty() || _minX > _maxX || _minY > _maxY)
+    return false;
+
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  const unsigned int last = this->dataPtr->tileCount - 1;
+  _min = std::numeric_limits<HeightType>::max();
+  _max = -std::numeric_limits<HeightType>::max();
+  this->dataPtr->Merge(this->dataPtr->levels.size() - 1, 0, 0,
+      std::min(_minX / tileSize, last), std::min(_minY / tileSize, last),
+      std::min(_maxX / tileSize, last), std::min(_maxY / tileSize, last),
+      _min, _max);
+  return true;
+}
+
+//////////////////////////////////////////////////
+HeightmapPyramid::HeightType HeightmapPyramid::MinHeight() const
+{
+  if (this->dataPtr->levels.empty())
+    return 0;
+  return this->dataPtr->levels.back().min[0];
+}
+
+//////////////////////////////////////////////////
+HeightmapPyramid::HeightType HeightmapPyramid::MaxHeight() const
+{
+  if (this->dataPtr->levels.empty())
+    return 0;
+  return this->dataPtr->levels.back().max[0];
+}
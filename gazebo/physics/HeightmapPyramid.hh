@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_HEIGHTMAPPYRAMID_HH_
+#define GAZEBO_PHYSICS_HEIGHTMAPPYRAMID_HH_
+
+#include <memory>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class HeightmapPyramidPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class HeightmapPyramid HeightmapPyramid.hh physics/physics.hh
+    /// \brief Min/max pyramid over the heights of a square heightmap.
+    ///
+    /// The grid is split into square tiles of TileSize() cells. The first
+    /// level of the pyramid stores the height range of each tile, and each
+    /// following level merges 2x2 nodes of the previous one, up to a single
+    /// root node. Range() bounds the heights of any rectangle of vertices
+    /// by visiting O(log(n)) nodes, so colliders can cull the cells under a
+    /// geom without reading them.
+    ///
+    /// The heights may also be paged: they are then written tile by tile to
+    /// a temporary file, and Height() loads tiles on demand, keeping at most
+    /// CacheSize() of them resident, so the caller can drop the full grid.
+    /// The pyramid itself always stays in memory.
+    ///
+    /// Range() is safe to call from several threads. Height() is too, but
+    /// it then serializes on the tile cache when the heights are paged.
+    class GZ_PHYSICS_VISIBLE HeightmapPyramid
+    {
+      /// \brief Height data type, same as HeightmapShape::HeightType.
+      public: typedef float HeightType;
+
+      /// \brief Constructor.
+      public: HeightmapPyramid();
+
+      /// \brief Destructor. Removes the tile file of paged heights.
+      public: ~HeightmapPyramid();
+
+      /// \brief Build the pyramid.
+      /// \param[in] _heights Heights of the grid, row after row, with
+      /// _size * _size values.
+      /// \param[in] _size Number of vertices along each side, at least 2.
+      /// \param[in] _tileSize Number of cells along each side of a tile.
+      /// \param[in] _page True to page the heights from disk. Otherwise
+      /// only the pyramid is kept, and Height() can't be used.
+      /// \return False if the parameters are invalid, or if paging was
+      /// requested and the tile file couldn't be written.
+      public: bool Build(const std::vector<HeightType> &_heights,
+                  const unsigned int _size, const unsigned int _tileSize,
+                  const bool _page = false);
+
+      /// \brief Drop the heights and the pyramid.
+      public: void Clear();
+
+      /// \brief Get the number of vertices along each side of the grid.
+      /// \return Number of vertices, 0 before Build.
+      public: unsigned int Size() const;
+
+      /// \brief Get the number of cells along each side of a tile.
+      /// \return Tile size.
+      public: unsigned int TileSize() const;
+
+      /// \brief Get the number of levels of the pyramid.
+      /// \return Number of levels, 0 before Build.
+      public: unsigned int LevelCount() const;
+
+      /// \brief Get whether the heights are paged from disk.
+      /// \return True if paged.
+      public: bool Paged() const;
+
+      /// \brief Set the maximum number of resident tiles of paged heights.
+      /// \param[in] _tiles Number of tiles, at least 1.
+      public: void SetCacheSize(const unsigned int _tiles);
+
+      /// \brief Get the maximum number of resident tiles of paged heights.
+      /// \return Number of tiles. Default is 256.
+      public: unsigned int CacheSize() const;
+
+      /// \brief Get the number of tiles currently resident.
+      /// \return Number of tiles, 0 if the heights are not paged.
+      public: unsigned int ResidentTileCount() const;
+
+      /// \brief Get the height of a vertex of paged heights.
+      /// \param[in] _x Column of the vertex.
+      /// \param[in] _y Row of the vertex.
+      /// \return The height, 0 if the vertex is outside of the grid or if
+      /// the heights are not paged.
+      public: HeightType Height(const int _x, const int _y) const;
+
+      /// \brief Bound the heights of a rectangle of vertices. The bounds are
+      /// those of the tiles covering the rectangle, so they may be wider
+      /// than the exact range, never narrower.
+      /// \param[in] _minX First column, clamped to the grid.
+      /// \param[in] _minY First row, clamped to the grid.
+      /// \param[in] _maxX Last column, inclusive, clamped to the grid.
+      /// \param[in] _maxY Last row, inclusive, clamped to the grid.
+      /// \param[out] _min Lower bound of the heights.
+      /// \param[out] _max Upper bound of the heights.
+      /// \return False if the rectangle doesn't overlap the grid.
+      public: bool Range(int _minX, int _minY, int _maxX, int _maxY,
+                  HeightType &_min, HeightType &_max) const;
+
+      /// \brief Get the minimum height of the whole grid.
+      /// \return The minimum height, 0 before Build.
+      public: HeightType MinHeight() const;
+
+      /// \brief Get the maximum height of the whole grid.
+      /// \return The maximum height, 0 before Build.
+      public: HeightType MaxHeight() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<HeightmapPyramidPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "gazebo/physics/HeightmapPyramid.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class HeightmapPyramid_TEST : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Heights of a 65x65 grid, with a single peak.
+/// \param[in] _x Column of the peak.
+/// \param[in] _y Row of the peak.
+/// \return The heights.
+static std::vector<float> PeakHeights(const unsigned int _x,
+    const unsigned int _y)
+{
+  std::vector<float> heights(65 * 65);
+  for (unsigned int y = 0; y < 65; ++y)
+  {
+    for (unsigned int x = 0; x < 65; ++x)
+      heights[y * 65 + x] = 0.01f * ((x * 7 + y * 13) % 11);
+  }
+  heights[_y * 65 + _x] = 10.0f;
+  return heights;
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapPyramid_TEST, Range)
+{
+  physics::HeightmapPyramid pyramid;
+  EXPECT_EQ(0u, pyramid.LevelCount());
+  float min, max;
+  EXPECT_FALSE(pyramid.Range(0, 0, 1, 1, min, max));
+
+  // Invalid parameters
+  std::vector<float> heights = PeakHeights(24, 40);
+  EXPECT_FALSE(pyramid.Build(heights, 64, 8));
+  EXPECT_FALSE(pyramid.Build(heights, 65, 0));
+
+  // 8x8 tiles give 4 levels
+  ASSERT_TRUE(pyramid.Build(heights, 65, 8));
+  EXPECT_EQ(65u, pyramid.Size());
+  EXPECT_EQ(8u, pyramid.TileSize());
+  EXPECT_EQ(4u, pyramid.LevelCount());
+  EXPECT_FALSE(pyramid.Paged());
+  EXPECT_FLOAT_EQ(10.0f, pyramid.MaxHeight());
+  EXPECT_FLOAT_EQ(*std::min_element(heights.begin(), heights.end()),
+      pyramid.MinHeight());
+
+  // Zones away from the peak are low
+  EXPECT_TRUE(pyramid.Range(40, 0, 64, 30, min, max));
+  EXPECT_LT(max, 0.2f);
+  EXPECT_TRUE(pyramid.Range(-10, -10, 15, 15, min, max));
+  EXPECT_LT(max, 0.2f);
+
+  // The peak is on the border of two tile columns, it bounds both
+  EXPECT_TRUE(pyramid.Range(17, 41, 18, 42, min, max));
+  EXPECT_FLOAT_EQ(10.0f, max);
+  EXPECT_TRUE(pyramid.Range(25, 41, 26, 42, min, max));
+  EXPECT_FLOAT_EQ(10.0f, max);
+  EXPECT_TRUE(pyramid.Range(30, 30, 30, 30, min, max));
+  EXPECT_LT(max, 0.2f);
+
+  // Outside of the grid
+  EXPECT_FALSE(pyramid.Range(70, 0, 80, 10, min, max));
+  EXPECT_FALSE(pyramid.Range(10, 10, 5, 5, min, max));
+
+  // The bounds always contain the exact range
+  for (int y0 = 0; y0 < 65; y0 += 5)
+  {
+    for (int x0 = 0; x0 < 65; x0 += 3)
+    {
+      const int x1 = std::min(x0 + 9, 64);
+      const int y1 = std::min(y0 + 4, 64);
+      float exactMin = 100, exactMax = -100;
+      for (int y = y0; y <= y1; ++y)
+      {
+        for (int x = x0; x <= x1; ++x)
+        {
+          exactMin = std::min(exactMin, heights[y * 65 + x]);
+          exactMax = std::max(exactMax, heights[y * 65 + x]);
+        }
+      }
+      EXPECT_TRUE(pyramid.Range(x0, y0, x1, y1, min, max));
+      EXPECT_LE(min, exactMin);
+      EXPECT_GE(max, exactMax);
+    }
+  }
+
+  pyramid.Clear();
+  EXPECT_EQ(0u, pyramid.LevelCount());
+  EXPECT_EQ(0u, pyramid.Size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapPyramid_TEST, Paging)
+{
+  physics::HeightmapPyramid pyramid;
+  EXPECT_EQ(256u, pyramid.CacheSize());
+  pyramid.SetCacheSize(0);
+  EXPECT_EQ(1u, pyramid.CacheSize());
+  pyramid.SetCacheSize(4);
+
+  std::vector<float> heights = PeakHeights(64, 3);
+  ASSERT_TRUE(pyramid.Build(heights, 65, 16, true));
+  EXPECT_TRUE(pyramid.Paged());
+  EXPECT_EQ(0u, pyramid.ResidentTileCount());
+
+  // Every height reads back, with at most 4 tiles resident
+  for (int y = 0; y < 65; ++y)
+  {
+    for (int x = 0; x < 65; ++x)
+      EXPECT_FLOAT_EQ(heights[y * 65 + x], pyramid.Height(x, y));
+  }
+  EXPECT_EQ(4u, pyramid.ResidentTileCount());
+  EXPECT_FLOAT_EQ(0.0f, pyramid.Height(-1, 0));
+  EXPECT_FLOAT_EQ(0.0f, pyramid.Height(0, 65));
+
+  pyramid.SetCacheSize(2);
+  EXPECT_EQ(2u, pyramid.ResidentTileCount());
+  EXPECT_FLOAT_EQ(10.0f, pyramid.Height(64, 3));
+
+  // The pyramid doesn't need the tiles
+  float min, max;
+  EXPECT_TRUE(pyramid.Range(60, 0, 64, 5, min, max));
+  EXPECT_FLOAT_EQ(10.0f, max);
+
+  pyramid.Clear();
+  EXPECT_FALSE(pyramid.Paged());
+  EXPECT_EQ(0u, pyramid.ResidentTileCount());
+  EXPECT_FLOAT_EQ(0.0f, pyramid.Height(64, 3));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,7 +16,10 @@
 */
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <ignition/math/Helpers.hh>
 #include <gazebo/gazebo_config.h>
 
@@ -26,12 +29,49 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
 #include "gazebo/physics/HeightmapShape.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/transport/transport.hh"
 
+/// \internal
+/// \brief Private data for the HeightmapShape class.
+class gazebo::physics::HeightmapShapePrivate
+{
+  /// \brief True if the engine reads the heights only through GetHeight.
+  public: bool tilePagingSupported = false;
+
+  /// \brief Min/max pyramid of the heights.
+  public: HeightmapPyramid pyramid;
+};
+
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Number of cells along each side of a tile of the height pyramid.
+static const unsigned int HEIGHTMAP_TILE_SIZE = 32;
+
+namespace
+{
+  /// \brief Private data of the heightmap shapes, by shape. It is kept out
+  /// of HeightmapShape so that the layout of the class doesn't change.
+  class HeightmapShapePrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the shapes.
+    public: static HeightmapShapePrivates &Instance()
+    {
+      static HeightmapShapePrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by shape.
+    public: std::unordered_map<const HeightmapShape *,
+            std::unique_ptr<HeightmapShapePrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
 
 //////////////////////////////////////////////////
 HeightmapShape::HeightmapShape(CollisionPtr _parent)
@@ -41,8 +81,15 @@ HeightmapShape::HeightmapShape(CollisionPtr _parent)
       std::is_same<HeightType, float>::value ||
       std::is_same<HeightType, double>::value,
       "Height field needs to be double or float");
+  static_assert(
+      std::is_same<HeightType, HeightmapPyramid::HeightType>::value,
+      "Height pyramid and height field types must match");
   this->vertSize = 0;
   this->AddType(Base::HEIGHTMAP_SHAPE);
+
+  HeightmapShapePrivates &privates = HeightmapShapePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new HeightmapShapePrivate);
 }
 
 //////////////////////////////////////////////////
@@ -53,6 +100,24 @@ HeightmapShape::~HeightmapShape()
   if (this->node)
     this->node->Fini();
   this->node.reset();
+
+  HeightmapShapePrivates &privates = HeightmapShapePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+HeightmapShapePrivate *HeightmapShape::HeightmapShapeData() const
+{
+  HeightmapShapePrivates &privates = HeightmapShapePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::SetTilePagingSupported(const bool _supported)
+{
+  this->HeightmapShapeData()->tilePagingSupported = _supported;
 }
 
 //////////////////////////////////////////////////
@@ -190,6 +255,12 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
   }
 }
 
+//////////////////////////////////////////////////
+const HeightmapPyramid &HeightmapShape::Pyramid() const
+{
+  return this->HeightmapShapeData()->pyramid;
+}
+
 //////////////////////////////////////////////////
 int HeightmapShape::GetSubSampling() const
 {
@@ -247,6 +318,26 @@ void HeightmapShape::Init()
 
   // Construct the heightmap lookup table
   this->FillHeightfield(this->heights);
+
+  // Build the pyramid used to cull cells, and move the heights to disk if
+  // the physics engine asks for it and this engine can read them back
+  HeightmapShapePrivate *data = this->HeightmapShapeData();
+  bool page = false;
+  PhysicsEnginePtr physics = this->world ? this->world->Physics() : nullptr;
+  if (physics && data->tilePagingSupported)
+  {
+    boost::any value;
+    if (physics->GetParam("heightmap_tile_paging", value))
+      page = boost::any_cast<bool>(value);
+    if (page && physics->GetParam("heightmap_tile_cache_size", value))
+      data->pyramid.SetCacheSize(boost::any_cast<int>(value));
+  }
+
+  if (data->pyramid.Build(this->heights, this->vertSize, HEIGHTMAP_TILE_SIZE,
+        page) && data->pyramid.Paged())
+  {
+    std::vector<HeightType>().swap(this->heights);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -298,8 +389,8 @@ void HeightmapShape::FillHeights(msgs::Geometry &_msg) const
   {
     for (unsigned int x = 0; x < this->vertSize; ++x)
     {
-      int index = (this->vertSize - y - 1) * this->vertSize + x;
-      _msg.mutable_heightmap()->add_heights(this->heights[index]);
+      _msg.mutable_heightmap()->add_heights(
+          this->GetHeight(x, this->vertSize - y - 1));
     }
   }
 }
@@ -319,6 +410,10 @@ ignition::math::Vector2i HeightmapShape::VertexCount() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 {
+  const HeightmapPyramid &pyramid = this->Pyramid();
+  if (pyramid.Paged())
+    return pyramid.Height(_x, _y);
+
   int index =  _y * this->vertSize + _x;
   if (_x < 0 || _y < 0 || index >= static_cast<int>(this->heights.size()))
     return 0.0;
@@ -329,6 +424,10 @@ HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 {
+  const HeightmapPyramid &pyramid = this->Pyramid();
+  if (pyramid.LevelCount() > 0)
+    return pyramid.MaxHeight();
+
   HeightType max = -std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -342,6 +441,10 @@ HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMinHeight() const
 {
+  const HeightmapPyramid &pyramid = this->Pyramid();
+  if (pyramid.LevelCount() > 0)
+    return pyramid.MinHeight();
+
   HeightType min = std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
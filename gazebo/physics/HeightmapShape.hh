@@ -27,6 +27,7 @@
 #include "gazebo/common/HeightmapData.hh"
 #include "gazebo/common/Dem.hh"
 #include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/physics/HeightmapPyramid.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Shape.hh"
 #include "gazebo/util/system.hh"
@@ -35,6 +36,8 @@ namespace gazebo
 {
   namespace physics
   {
+    class HeightmapShapePrivate;
+
     /// \addtogroup gazebo_physics
     /// \{
 
@@ -119,6 +122,11 @@ namespace gazebo
       /// \return The minimum height.
       public: HeightType GetMinHeight() const;
 
+      /// \brief Get the min/max pyramid of the heights, built by Init.
+      /// Colliders use it to skip the cells that a geom can't touch.
+      /// \return The pyramid.
+      public: const HeightmapPyramid &Pyramid() const;
+
       /// \brief Get the amount of subsampling.
       /// \return Amount of subsampling.
       public: int GetSubSampling() const;
@@ -140,6 +148,16 @@ namespace gazebo
       /// \param[in] _msg The request message.
       private: void OnRequest(ConstRequestPtr &_msg);
 
+      /// \brief Set whether the engine reads the heights only through
+      /// GetHeight, in which case Init can drop the lookup table when the
+      /// physics engine pages heightmaps from disk. Call it before Init.
+      /// \param[in] _supported True if tile paging is supported.
+      protected: void SetTilePagingSupported(const bool _supported);
+
+      /// \brief Get the private data of the shape.
+      /// \return The private data, see HeightmapShapePrivate.
+      private: HeightmapShapePrivate *HeightmapShapeData() const;
+
       /// \brief Fills the heightmap data (float) into the vector
       /// by calling HeightmapData::FillHeightMap with \e heights
       /// \param[in] heights height field to fill with data.
@@ -1583,9 +1583,9 @@ void Joint::RegisterIntrospectionItems()
 /////////////////////////////////////////////////
 void Joint::RegisterIntrospectionPosition(const unsigned int _index)
 {
-  auto f = [this, _index]()
+  auto f = [](const Joint &_joint, const unsigned int _i)
   {
-    return this->Position(_index);
+    return _joint.Position(_i);
   };
 
   common::URI uri(this->URI());
@@ -1593,15 +1593,15 @@ void Joint::RegisterIntrospectionPosition(const unsigned int _index)
       "axis/" + std::to_string(_index) + "/double/position");
   this->introspectionItems.push_back(uri);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <double>(uri.Str(), f);
+      <double>(uri.Str(), *this, f, _index);
 }
 
 /////////////////////////////////////////////////
 void Joint::RegisterIntrospectionVelocity(const unsigned int _index)
 {
-  auto f = [this, _index]()
+  auto f = [](const Joint &_joint, const unsigned int _i)
   {
-    return this->GetVelocity(_index);
+    return _joint.GetVelocity(_i);
   };
 
   common::URI uri(this->URI());
@@ -1609,6 +1609,6 @@ void Joint::RegisterIntrospectionVelocity(const unsigned int _index)
       "axis/" + std::to_string(_index) + "/double/velocity");
   this->introspectionItems.push_back(uri);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <double>(uri.Str(), f);
+      <double>(uri.Str(), *this, f, _index);
 }
 
@@ -15,6 +15,8 @@
  *
 */
 
+#include <utility>
+#include <vector>
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
@@ -31,6 +33,60 @@
 using namespace gazebo;
 using namespace physics;
 
+/////////////////////////////////////////////////
+void JointControllerPrivate::Compile()
+{
+  this->forceCmds.clear();
+  this->posCmds.clear();
+  this->velCmds.clear();
+
+  for (auto const &force : this->forces)
+  {
+    auto joint = this->joints.find(force.first);
+    if (joint == this->joints.end() || !joint->second)
+      continue;
+
+    JointCommand cmd;
+    cmd.joint = joint->second.get();
+    cmd.value = &force.second;
+    this->forceCmds.push_back(cmd);
+  }
+
+  auto compilePids = [this](const std::map<std::string, double> &_targets,
+      std::map<std::string, common::PID> &_pids,
+      std::vector<JointCommand> &_cmds)
+  {
+    for (auto const &target : _targets)
+    {
+      auto joint = this->joints.find(target.first);
+      auto pid = _pids.find(target.first);
+      if (joint == this->joints.end() || !joint->second || pid == _pids.end())
+        continue;
+
+      JointCommand cmd;
+      cmd.joint = joint->second.get();
+      cmd.pid = &pid->second;
+      cmd.value = &target.second;
+      _cmds.push_back(cmd);
+    }
+  };
+  compilePids(this->positions, this->posPids, this->posCmds);
+  compilePids(this->velocities, this->velPids, this->velCmds);
+
+  this->dirty = false;
+}
+
+/////////////////////////////////////////////////
+void JointControllerPrivate::SetValue(std::map<std::string, double> &_map,
+    const std::string &_name, const double _value)
+{
+  auto result = _map.insert(std::make_pair(_name, _value));
+  if (result.second)
+    this->dirty = true;
+  else
+    result.first->second = _value;
+}
+
 /////////////////////////////////////////////////
 JointController::JointController(ModelPtr _model)
   : dataPtr(new JointControllerPrivate)
@@ -74,6 +130,7 @@ void JointController::AddJoint(JointPtr _joint)
       1, 0.1, 0.01, 1, -1, 1000, -1000);
   this->dataPtr->velPids[_joint->GetScopedName()].Init(
       1, 0.1, 0.01, 1, -1, 1000, -1000);
+  this->dataPtr->dirty = true;
 }
 
 /////////////////////////////////////////////////
@@ -84,6 +141,7 @@ void JointController::RemoveJoint(Joint *_joint)
     this->dataPtr->joints.erase(_joint->GetScopedName());
     this->dataPtr->posPids.erase(_joint->GetScopedName());
     this->dataPtr->velPids.erase(_joint->GetScopedName());
+    this->dataPtr->dirty = true;
   }
 }
 
@@ -94,6 +152,7 @@ void JointController::Reset()
   this->dataPtr->positions.clear();
   this->dataPtr->velocities.clear();
   this->dataPtr->forces.clear();
+  this->dataPtr->dirty = true;
 
   std::map<std::string, common::PID>::iterator iter;
 
@@ -123,43 +182,33 @@ void JointController::Update()
   // TODO: fix this when World::ResetTime is improved
   if (stepTime > 0)
   {
-    if (!this->dataPtr->forces.empty())
-    {
-      std::map<std::string, double>::iterator iter;
-      for (iter = this->dataPtr->forces.begin();
-          iter != this->dataPtr->forces.end(); ++iter)
-      {
-        this->dataPtr->joints[iter->first]->SetForce(0, iter->second);
-      }
-    }
-
-    if (!this->dataPtr->positions.empty())
-    {
-      std::map<std::string, double>::iterator iter;
-
-      for (iter = this->dataPtr->positions.begin();
-           iter != this->dataPtr->positions.end(); ++iter)
-      {
-        double cmd = this->dataPtr->posPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->Position(0) -
-            iter->second, stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
-      }
-    }
-
-    if (!this->dataPtr->velocities.empty())
-    {
-      std::map<std::string, double>::iterator iter;
-
-      for (iter = this->dataPtr->velocities.begin();
-           iter != this->dataPtr->velocities.end(); ++iter)
-      {
-        double cmd = this->dataPtr->velPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->GetVelocity(0) - iter->second,
-            stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
-      }
-    }
+    if (this->dataPtr->dirty)
+      this->dataPtr->Compile();
+
+    for (auto const &cmd : this->dataPtr->forceCmds)
+      cmd.joint->SetForce(0, *cmd.value);
+
+    // Read the state of every joint, then evaluate every PID, then apply
+    // the efforts, each in one pass over the commands.
+    std::vector<double> &efforts = this->dataPtr->efforts;
+
+    const std::vector<JointCommand> &posCmds = this->dataPtr->posCmds;
+    efforts.resize(posCmds.size());
+    for (size_t i = 0; i < posCmds.size(); ++i)
+      efforts[i] = posCmds[i].joint->Position(0) - *posCmds[i].value;
+    for (size_t i = 0; i < posCmds.size(); ++i)
+      efforts[i] = posCmds[i].pid->Update(efforts[i], stepTime);
+    for (size_t i = 0; i < posCmds.size(); ++i)
+      posCmds[i].joint->SetForce(0, efforts[i]);
+
+    const std::vector<JointCommand> &velCmds = this->dataPtr->velCmds;
+    efforts.resize(velCmds.size());
+    for (size_t i = 0; i < velCmds.size(); ++i)
+      efforts[i] = velCmds[i].joint->GetVelocity(0) - *velCmds[i].value;
+    for (size_t i = 0; i < velCmds.size(); ++i)
+      efforts[i] = velCmds[i].pid->Update(efforts[i], stepTime);
+    for (size_t i = 0; i < velCmds.size(); ++i)
+      velCmds[i].joint->SetForce(0, efforts[i]);
   }
 
   /* enable below if we want to set position kinematically
@@ -241,6 +290,9 @@ void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
   iter = this->dataPtr->joints.find(_msg.name());
   if (iter != this->dataPtr->joints.end())
   {
+    const size_t pidCount =
+      this->dataPtr->posPids.size() + this->dataPtr->velPids.size();
+
     if (_msg.reset())
     {
       if (this->dataPtr->forces.find(_msg.name()) !=
@@ -262,10 +314,14 @@ void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
         this->dataPtr->velocities.erase(
             this->dataPtr->velocities.find(_msg.name()));
       }
+      this->dataPtr->dirty = true;
     }
 
     if (_msg.has_force_optional())
-      this->dataPtr->forces[_msg.name()] = _msg.force_optional().data();
+    {
+      this->dataPtr->SetValue(this->dataPtr->forces, _msg.name(),
+          _msg.force_optional().data());
+    }
 
     if (_msg.has_position())
     {
@@ -368,6 +424,13 @@ void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
             -_msg.velocity().limit_optional().data());
       }
     }
+
+    // The gains above create a PID if the joint had none
+    if (pidCount !=
+        this->dataPtr->posPids.size() + this->dataPtr->velPids.size())
+    {
+      this->dataPtr->dirty = true;
+    }
   }
   else
     gzerr << "Unable to find joint[" << _msg.name() << "]\n";
@@ -470,7 +533,10 @@ void JointController::SetPositionPID(const std::string &_jointName,
   iter = this->dataPtr->joints.find(_jointName);
 
   if (iter != this->dataPtr->joints.end())
+  {
     this->dataPtr->posPids[_jointName] = _pid;
+    this->dataPtr->dirty = true;
+  }
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
 }
@@ -484,7 +550,7 @@ bool JointController::SetPositionTarget(const std::string &_jointName,
   if (this->dataPtr->posPids.find(_jointName) !=
       this->dataPtr->posPids.end())
   {
-    this->dataPtr->positions[_jointName] = _target;
+    this->dataPtr->SetValue(this->dataPtr->positions, _jointName, _target);
     result = true;
   }
 
@@ -499,7 +565,10 @@ void JointController::SetVelocityPID(const std::string &_jointName,
   iter = this->dataPtr->joints.find(_jointName);
 
   if (iter != this->dataPtr->joints.end())
+  {
     this->dataPtr->velPids[_jointName] = _pid;
+    this->dataPtr->dirty = true;
+  }
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
 }
@@ -513,7 +582,7 @@ bool JointController::SetVelocityTarget(const std::string &_jointName,
   if (this->dataPtr->velPids.find(_jointName) !=
       this->dataPtr->velPids.end())
   {
-    this->dataPtr->velocities[_jointName] = _target;
+    this->dataPtr->SetValue(this->dataPtr->velocities, _jointName, _target);
     result = true;
   }
 
@@ -529,7 +598,7 @@ bool JointController::SetForce(const std::string &_jointName,
   if (this->dataPtr->joints.find(_jointName) !=
       this->dataPtr->joints.end())
   {
-    this->dataPtr->forces[_jointName] = _force;
+    this->dataPtr->SetValue(this->dataPtr->forces, _jointName, _force);
     result = true;
   }
 
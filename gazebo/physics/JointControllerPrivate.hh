@@ -19,6 +19,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <ignition/transport.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -30,8 +31,34 @@ namespace gazebo
 {
   namespace physics
   {
+    /// \internal
+    /// \brief A command of the controller, compiled from the maps of
+    /// JointControllerPrivate so that Update doesn't look up joint names.
+    class JointCommand
+    {
+      /// \brief The joint.
+      public: Joint *joint = nullptr;
+
+      /// \brief The PID of the command, null for forces.
+      public: common::PID *pid = nullptr;
+
+      /// \brief The target or force, owned by the map of the command.
+      public: const double *value = nullptr;
+    };
+
     class JointControllerPrivate
     {
+      /// \brief Rebuild the command arrays from the maps.
+      public: void Compile();
+
+      /// \brief Set a value of a map, and mark the commands as outdated if
+      /// the key is new.
+      /// \param[in] _map The map.
+      /// \param[in] _name The key.
+      /// \param[in] _value The value.
+      public: void SetValue(std::map<std::string, double> &_map,
+                  const std::string &_name, const double _value);
+
       /// \brief Model to control.
       public: ModelPtr model;
 
@@ -68,6 +95,22 @@ namespace gazebo
 
       /// \brief Last time the controller was updated.
       public: common::Time prevUpdateTime;
+
+      /// \brief Force commands. The map nodes they point to stay valid
+      /// until a key is erased, which marks the commands as outdated.
+      public: std::vector<JointCommand> forceCmds;
+
+      /// \brief Position commands.
+      public: std::vector<JointCommand> posCmds;
+
+      /// \brief Velocity commands.
+      public: std::vector<JointCommand> velCmds;
+
+      /// \brief Errors, then efforts, of the PID commands.
+      public: std::vector<double> efforts;
+
+      /// \brief True if the commands must be compiled again.
+      public: bool dirty = true;
     };
   }
 }
@@ -73,6 +73,12 @@ bool LightState::IsZero() const
   return this->pose == ignition::math::Pose3d::Zero;
 }
 
+/////////////////////////////////////////////////
+bool LightState::IsZero(const double _tolerance) const
+{
+  return IsNearZero(this->pose, _tolerance);
+}
+
 /////////////////////////////////////////////////
 LightState &LightState::operator=(const LightState &_state)
 {
@@ -82,6 +82,13 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Return true if the values in the state are within a
+      /// tolerance of zero.
+      /// \param[in] _tolerance Tolerance on positions in meters and on
+      /// rotation angles in radians.
+      /// \return True if the values in the state are within the tolerance.
+      public: bool IsZero(const double _tolerance) const;
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
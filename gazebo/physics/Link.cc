@@ -32,6 +32,7 @@
 #include "gazebo/common/Battery.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
 
+#include "gazebo/physics/BatteryRegistry.hh"
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Model.hh"
@@ -39,7 +40,9 @@
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
 #include "gazebo/physics/Link.hh"
+#include "gazebo/physics/LinkDataRegistry.hh"
 #include "gazebo/physics/Wind.hh"
 
 #include "gazebo/util/IntrospectionManager.hh"
@@ -70,17 +73,15 @@ class gazebo::physics::LinkPrivate
   /// \brief All the attached models.
   public: std::vector<ModelPtr> attachedModels;
 
-  /// \brief Link data publisher
+  /// \brief Link data publisher, on ~/<scoped link name>. Null while the
+  /// link has no request in the LinkDataRegistry.
   public: transport::PublisherPtr dataPub;
 
   /// \brief Link data message
   public: msgs::LinkData linkDataMsg;
 
-  /// \brief True to publish data, false otherwise
-  public: bool publishData = false;
-
-  /// \brief Mutex to protect the publishData variable
-  public: std::recursive_mutex *publishDataMutex;
+  /// \brief Protects dataPub, requests come from the threads of sensors.
+  public: std::mutex dataPubMutex;
 
   /// \brief Cached list of collisions. This is here for performance.
   public: Collision_V collisions;
@@ -97,8 +98,9 @@ class gazebo::physics::LinkPrivate
   /// \brief Wind velocity.
   public: ignition::math::Vector3d windLinearVel;
 
-  /// \brief Update connection to calculate wind velocity.
-  public: event::ConnectionPtr updateConnection;
+  /// \brief True if the link is in the links of the wind, which sets
+  /// windLinearVel every world update.
+  public: bool windRegistered = false;
 
   /// \brief All the attached batteries.
   public: std::vector<common::BatteryPtr> batteries;
@@ -117,6 +119,16 @@ class gazebo::physics::LinkPrivate
 
   /// \brief SDF Link DOM object
   public: const sdf::Link *linkSDFDom = nullptr;
+
+  /// \brief True to use continuous collision detection.
+  public: bool continuousCollision = false;
+
+  /// \brief Applies continuous collision detection to the physics engine,
+  /// see Link::SetContinuousCollisionFunction.
+  public: std::function<void (const bool)> applyContinuousCollision;
+
+  /// \brief True if the visual elements were removed from the SDF.
+  public: bool visualSDFReleased = false;
 };
 
 using namespace gazebo;
@@ -130,7 +142,6 @@ Link::Link(EntityPtr _parent)
   this->inertial.reset(new Inertial);
   this->dataPtr->parentJoints.clear();
   this->dataPtr->childJoints.clear();
-  this->dataPtr->publishDataMutex = new std::recursive_mutex();
 }
 
 //////////////////////////////////////////////////
@@ -182,6 +193,10 @@ void Link::Load(sdf::ElementPtr _sdf)
     }
   }
 
+  // Continuous collision detection, a custom element since SDF has none
+  if (this->sdf->HasElement("gz:ccd"))
+    this->SetContinuousCollision(this->sdf->Get<bool>("gz:ccd"));
+
   if (this->sdf->HasElement("sensor"))
   {
     sdf::ElementPtr sensorElem = this->sdf->GetElement("sensor");
@@ -344,13 +359,24 @@ void Link::Init()
 //////////////////////////////////////////////////
 void Link::Fini()
 {
-  this->dataPtr->updateConnection.reset();
+  if (this->dataPtr->windRegistered)
+  {
+    this->world->Wind().RemoveLink(this);
+    this->dataPtr->windRegistered = false;
+  }
+  if (this->world)
+  {
+    this->world->LinkData().RemoveAll(this);
+    this->world->Freezes().RemoveAll(this);
+  }
 
   this->dataPtr->attachedModels.clear();
   this->dataPtr->parentJoints.clear();
   this->dataPtr->childJoints.clear();
   this->dataPtr->collisions.clear();
   this->inertial.reset();
+  for (auto const &battery : this->dataPtr->batteries)
+    this->world->Batteries().Remove(battery);
   this->dataPtr->batteries.clear();
 
   // Remove all the sensors attached to the link
@@ -405,16 +431,16 @@ void Link::Fini()
 
   // Clean transport
   {
-    this->dataPtr->dataPub.reset();
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->dataPubMutex);
+      this->dataPtr->dataPub.reset();
+    }
     this->visPub.reset();
 
     this->dataPtr->wrenchSub.reset();
   }
   this->connections.clear();
 
-  delete this->dataPtr->publishDataMutex;
-  this->dataPtr->publishDataMutex = NULL;
-
   Entity::Fini();
 }
 
@@ -573,6 +599,27 @@ bool Link::GetSelfCollide() const
     return false;
 }
 
+//////////////////////////////////////////////////
+void Link::SetContinuousCollision(const bool _enable)
+{
+  this->dataPtr->continuousCollision = _enable;
+  if (this->dataPtr->applyContinuousCollision)
+    this->dataPtr->applyContinuousCollision(_enable);
+}
+
+//////////////////////////////////////////////////
+void Link::SetContinuousCollisionFunction(
+    const std::function<void (const bool)> &_apply)
+{
+  this->dataPtr->applyContinuousCollision = _apply;
+}
+
+//////////////////////////////////////////////////
+bool Link::ContinuousCollision() const
+{
+  return this->dataPtr->continuousCollision;
+}
+
 //////////////////////////////////////////////////
 void Link::SetLaserRetro(float _retro)
 {
@@ -624,12 +671,6 @@ void Link::Update(const common::UpdateInfo & /*_info*/)
       this->ProcessWrenchMsg(it);
     }
   }
-
-  // Update the batteries.
-  for (auto &battery : this->dataPtr->batteries)
-  {
-    battery->Update();
-  }
 }
 
 //////////////////////////////////////////////////
@@ -842,28 +883,39 @@ void Link::SetWindMode(const bool _mode)
 {
   this->sdf->GetElement("enable_wind")->Set(_mode);
 
-  if (!this->WindMode() && this->dataPtr->updateConnection)
+  if (!this->WindMode() && this->dataPtr->windRegistered)
     this->SetWindEnabled(false);
-  else if (this->WindMode() && !this->dataPtr->updateConnection)
+  else if (this->WindMode() && !this->dataPtr->windRegistered)
     this->SetWindEnabled(true);
 }
 
 /////////////////////////////////////////////////
 void Link::SetWindEnabled(const bool _enable)
 {
+  // The wind samples the velocity of all its links in one pass every world
+  // update
   if (_enable)
   {
-    this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-        std::bind(&Link::UpdateWind, this, std::placeholders::_1));
+    if (!this->dataPtr->windRegistered)
+      this->world->Wind().AddLink(this);
+    this->dataPtr->windRegistered = true;
   }
   else
   {
-    this->dataPtr->updateConnection.reset();
+    if (this->dataPtr->windRegistered)
+      this->world->Wind().RemoveLink(this);
+    this->dataPtr->windRegistered = false;
     // Make sure wind velocity is null
     this->dataPtr->windLinearVel.Set(0, 0, 0);
   }
 }
 
+//////////////////////////////////////////////////
+void Link::SetWorldWindLinearVel(const ignition::math::Vector3d &_vel)
+{
+  this->dataPtr->windLinearVel = _vel;
+}
+
 //////////////////////////////////////////////////
 const ignition::math::Vector3d Link::WorldWindLinearVel() const
 {
@@ -1219,49 +1271,48 @@ void Link::SetKinematic(const bool &/*_kinematic*/)
 /////////////////////////////////////////////////
 void Link::SetPublishData(bool _enable)
 {
-  // Skip if we're trying to disable after the publisher has already been
-  // cleared
-  if (!_enable && !this->dataPtr->dataPub)
+  if (!this->world)
     return;
 
-  {
-    std::lock_guard<std::recursive_mutex> lock(
-        *this->dataPtr->publishDataMutex);
-    if (this->dataPtr->publishData == _enable)
-      return;
-
-    this->dataPtr->publishData = _enable;
-  }
+  std::lock_guard<std::mutex> lock(this->dataPtr->dataPubMutex);
+  LinkDataRegistry &registry = this->world->LinkData();
   if (_enable)
   {
-    std::string topic = "~/" + this->GetScopedName();
-    this->dataPtr->dataPub = this->node->Advertise<msgs::LinkData>(topic);
-    this->connections.push_back(
-      event::Events::ConnectWorldUpdateEnd(
-        std::bind(&Link::PublishData, this)));
+    registry.Add(this);
+    if (!this->dataPtr->dataPub && this->node)
+    {
+      this->dataPtr->dataPub = this->node->Advertise<msgs::LinkData>(
+          "~/" + this->GetScopedName());
+    }
   }
-  else
+  else if (registry.Remove(this) && !registry.Contains(this))
   {
     this->dataPtr->dataPub.reset();
-    // Do we want to clear all of them though?
-    this->connections.clear();
   }
 }
 
 /////////////////////////////////////////////////
 void Link::PublishData()
 {
-  if (this->dataPtr->publishData && this->dataPtr->dataPub->HasConnections())
+  transport::PublisherPtr pub;
   {
-    msgs::Set(this->dataPtr->linkDataMsg.mutable_time(),
-        this->world->SimTime());
-    this->dataPtr->linkDataMsg.set_name(this->GetScopedName());
-    msgs::Set(this->dataPtr->linkDataMsg.mutable_linear_velocity(),
-        this->WorldLinearVel());
-    msgs::Set(this->dataPtr->linkDataMsg.mutable_angular_velocity(),
-        this->WorldAngularVel());
-    this->dataPtr->dataPub->Publish(this->dataPtr->linkDataMsg);
+    std::lock_guard<std::mutex> lock(this->dataPtr->dataPubMutex);
+    pub = this->dataPtr->dataPub;
   }
+  if (!pub || !pub->HasConnections())
+    return;
+
+  LinkDataRegistry::Sample sample;
+  if (!this->world || !this->world->LinkData().Data(this, sample))
+    return;
+
+  msgs::Set(this->dataPtr->linkDataMsg.mutable_time(), sample.time);
+  this->dataPtr->linkDataMsg.set_name(this->GetScopedName());
+  msgs::Set(this->dataPtr->linkDataMsg.mutable_linear_velocity(),
+      sample.linearVel);
+  msgs::Set(this->dataPtr->linkDataMsg.mutable_angular_velocity(),
+      sample.angularVel);
+  pub->Publish(this->dataPtr->linkDataMsg);
 }
 
 //////////////////////////////////////////////////
@@ -1833,6 +1884,7 @@ void Link::LoadBattery(sdf::ElementPtr _sdf)
   common::BatteryPtr battery(new common::Battery());
   battery->Load(_sdf);
   this->dataPtr->batteries.push_back(battery);
+  this->world->Batteries().Add(battery);
 }
 
 /////////////////////////////////////////////////
@@ -1847,30 +1899,30 @@ void Link::RegisterIntrospectionItems()
 {
   auto uri = this->URI();
 
-  // Callbacks.
-  auto fLinkPose = [this]()
+  // Getters, sampled without allocating at every update.
+  auto fLinkPose = [](const Link &_link, const unsigned int)
   {
-    return this->WorldPose();
+    return _link.WorldPose();
   };
 
-  auto fLinkLinVel = [this]()
+  auto fLinkLinVel = [](const Link &_link, const unsigned int)
   {
-    return this->WorldLinearVel();
+    return _link.WorldLinearVel();
   };
 
-  auto fLinkAngVel = [this]()
+  auto fLinkAngVel = [](const Link &_link, const unsigned int)
   {
-    return this->WorldAngularVel();
+    return _link.WorldAngularVel();
   };
 
-  auto fLinkLinAcc = [this]()
+  auto fLinkLinAcc = [](const Link &_link, const unsigned int)
   {
-    return this->WorldLinearAccel();
+    return _link.WorldLinearAccel();
   };
 
-  auto fLinkAngAcc = [this]()
+  auto fLinkAngAcc = [](const Link &_link, const unsigned int)
   {
-    return this->WorldAngularAccel();
+    return _link.WorldAngularAccel();
   };
 
   // Register items.
@@ -1878,31 +1930,31 @@ void Link::RegisterIntrospectionItems()
   poseURI.Query().Insert("p", "pose3d/world_pose");
   this->introspectionItems.push_back(poseURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Pose3d>(poseURI.Str(), fLinkPose);
+      <ignition::math::Pose3d>(poseURI.Str(), *this, fLinkPose);
 
   common::URI linVelURI(uri);
   linVelURI.Query().Insert("p", "vector3d/world_linear_velocity");
   this->introspectionItems.push_back(linVelURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(linVelURI.Str(), fLinkLinVel);
+      <ignition::math::Vector3d>(linVelURI.Str(), *this, fLinkLinVel);
 
   common::URI angVelURI(uri);
   angVelURI.Query().Insert("p", "vector3d/world_angular_velocity");
   this->introspectionItems.push_back(angVelURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(angVelURI.Str(), fLinkAngVel);
+      <ignition::math::Vector3d>(angVelURI.Str(), *this, fLinkAngVel);
 
   common::URI linAccURI(uri);
   linAccURI.Query().Insert("p", "vector3d/world_linear_acceleration");
   this->introspectionItems.push_back(linAccURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(linAccURI.Str(), fLinkLinAcc);
+      <ignition::math::Vector3d>(linAccURI.Str(), *this, fLinkLinAcc);
 
   common::URI angAccURI(uri);
   angAccURI.Query().Insert("p", "vector3d/world_angular_acceleration");
   this->introspectionItems.push_back(angAccURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(angAccURI.Str(), fLinkAngAcc);
+      <ignition::math::Vector3d>(angAccURI.Str(), *this, fLinkAngAcc);
 }
 
 /////////////////////////////////////////////////
@@ -1941,6 +1993,36 @@ const Link::Visuals_M &Link::Visuals() const
   return this->visuals;
 }
 
+//////////////////////////////////////////////////
+void Link::ReleaseVisualSDF()
+{
+  if (this->dataPtr->visualSDFReleased)
+    return;
+
+  // The visual messages keep everything the server uses.
+  while (this->sdf->HasElement("visual"))
+    this->sdf->RemoveChild(this->sdf->GetElement("visual"));
+  this->dataPtr->visualSDFReleased = true;
+}
+
+//////////////////////////////////////////////////
+void Link::RestoreVisualSDF()
+{
+  if (!this->dataPtr->visualSDFReleased)
+    return;
+  this->dataPtr->visualSDFReleased = false;
+
+  const std::string prefix = this->GetScopedName() + "::";
+  for (auto const &iter : this->visuals)
+  {
+    msgs::Visual msg = iter.second;
+    if (msg.name().compare(0, prefix.size(), prefix) == 0)
+      msg.set_name(msg.name().substr(prefix.size()));
+
+    msgs::VisualToSDF(msg, this->sdf->AddElement("visual"));
+  }
+}
+
 //////////////////////////////////////////////////
 const sdf::Link *Link::GetSDFDom() const
 {
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_LINK_HH_
 #define GAZEBO_PHYSICS_LINK_HH_
 
+#include <functional>
 #include <map>
 #include <vector>
 #include <string>
@@ -142,6 +143,21 @@ namespace gazebo
       /// \return True if self collision is enabled.
       public: bool GetSelfCollide() const;
 
+      /// \brief Set whether continuous collision detection is used for this
+      /// link, so that it doesn't tunnel through other collisions when it
+      /// moves by more than its size during a step. Read from the custom
+      /// <gz:ccd> element of the link SDF. Engines that don't support it
+      /// ignore it.
+      /// \param[in] _enable True to enable continuous collision detection.
+      /// \sa SetContinuousCollisionFunction
+      public: void SetContinuousCollision(const bool _enable);
+
+      /// \brief Get whether continuous collision detection is used for this
+      /// link.
+      /// \return True if continuous collision detection is enabled.
+      /// \sa SetContinuousCollision
+      public: bool ContinuousCollision() const;
+
       /// \brief Set the laser retro reflectiveness.
       /// \param[in] _retro Retro value for all child collisions.
       public: void SetLaserRetro(float _retro);
@@ -480,8 +496,13 @@ namespace gazebo
       /// \return Vector of parent Links connected by joints.
       public: Link_V GetParentJointsLinks() const;
 
-      /// \brief Enable/Disable link data publishing
-      /// \param[in] _enable True to enable publishing, false to stop publishing
+      /// \brief Request or withdraw the data of the link, such as its
+      /// velocities. Requests are counted by the LinkDataRegistry of the
+      /// world, which samples the links once per iteration, see
+      /// World::LinkData. While the link has requests, its data is
+      /// published on ~/<scoped link name> when the topic has subscribers,
+      /// and with the data of the other links on ~/link_data.
+      /// \param[in] _enable True to add a request, false to withdraw one
       public: void SetPublishData(bool _enable);
 
       /// \brief Get the parent joints.
@@ -566,6 +587,12 @@ namespace gazebo
       /// \return this link's wind velocity.
       public: const ignition::math::Vector3d WorldWindLinearVel() const;
 
+      /// \brief Set this link's wind velocity in the world coordinate
+      /// frame. Called by Wind every world update while the wind is enabled
+      /// for the link.
+      /// \param[in] _vel Wind velocity.
+      public: void SetWorldWindLinearVel(const ignition::math::Vector3d &_vel);
+
       /// \brief Returns this link's wind velocity.
       /// \return this link's wind velocity.
       public: const ignition::math::Vector3d RelativeWindLinearVel() const;
@@ -624,7 +651,17 @@ namespace gazebo
       /// \return a map of unique ID to visual message
       public: const Visuals_M &Visuals() const;
 
-      /// \brief Publish timestamped link data such as velocity.
+      /// \brief Remove the visual elements from the SDF of the link, to
+      /// save memory. The visual messages are kept.
+      /// \sa RestoreVisualSDF
+      public: void ReleaseVisualSDF();
+
+      /// \brief Recreate the visual elements released by ReleaseVisualSDF
+      /// from the visual messages. Does nothing if they weren't released.
+      public: void RestoreVisualSDF();
+
+      /// \brief Publish timestamped link data such as velocity, sampled by
+      /// the LinkDataRegistry, if the topic of the link has subscribers.
       private: void PublishData();
 
       /// \brief Load a new collision helper function.
@@ -675,6 +712,13 @@ namespace gazebo
       /// \brief Register items in the introspection service.
       protected: virtual void RegisterIntrospectionItems() override;
 
+      /// \brief Set the function that applies continuous collision
+      /// detection to the physics engine. SetContinuousCollision calls it
+      /// each time the setting changes.
+      /// \param[in] _apply Function called with the new setting.
+      protected: void SetContinuousCollisionFunction(
+                     const std::function<void (const bool)> &_apply);
+
       /// \brief Inertial properties.
       protected: InertialPtr inertial;
 
@@ -689,6 +733,9 @@ namespace gazebo
 
       /// \brief Pointer to private data
       private: std::unique_ptr<LinkPrivate> dataPtr;
+
+      /// \brief LinkDataRegistry calls PublishData once it sampled the link
+      private: friend class LinkDataRegistry;
     };
     /// \}
   }
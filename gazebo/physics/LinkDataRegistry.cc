@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/LinkDataRegistry.hh"
+#include "gazebo/transport/Publisher.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A link of the registry.
+    class RegisteredLink
+    {
+      /// \brief The link.
+      public: Link *link = nullptr;
+
+      /// \brief Scoped name of the link, for the published message.
+      public: std::string name;
+
+      /// \brief Number of requests.
+      public: unsigned int requests = 0;
+
+      /// \brief True once the link was sampled.
+      public: bool sampled = false;
+
+      /// \brief Latest data of the link.
+      public: LinkDataRegistry::Sample sample;
+    };
+
+    /// \internal
+    /// \brief Private data for the LinkDataRegistry class
+    class LinkDataRegistryPrivate
+    {
+      /// \brief Remove the link at an index, moving the last link there.
+      /// Must be called with the mutex locked.
+      /// \param[in] _index Index of the link in links.
+      public: void Erase(const size_t _index)
+      {
+        this->indices.erase(this->links[_index].link);
+        if (_index + 1 < this->links.size())
+        {
+          this->links[_index] = std::move(this->links.back());
+          this->indices[this->links[_index].link] = _index;
+        }
+        this->links.pop_back();
+      }
+
+      /// \brief The links.
+      public: std::vector<RegisteredLink> links;
+
+      /// \brief Index of each link in links.
+      public: std::unordered_map<const Link *, size_t> indices;
+
+      /// \brief Publisher of the batched message, may be null.
+      public: transport::PublisherPtr pub;
+
+      /// \brief Batched message, reused between updates.
+      public: msgs::LinkData_V msg;
+
+      /// \brief Links that publish their own data after an update, reused
+      /// between updates.
+      public: std::vector<Link *> publishers;
+
+      /// \brief Protects links, indices and pub. Update runs on the thread
+      /// of the world while sensors read the data from theirs.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+LinkDataRegistry::LinkDataRegistry()
+  : dataPtr(new LinkDataRegistryPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+LinkDataRegistry::~LinkDataRegistry()
+{
+}
+
+/////////////////////////////////////////////////
+void LinkDataRegistry::SetPublisher(const transport::PublisherPtr &_pub)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->pub = _pub;
+}
+
+/////////////////////////////////////////////////
+void LinkDataRegistry::Add(Link *_link)
+{
+  if (!_link)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link);
+  if (iter != this->dataPtr->indices.end())
+  {
+    ++this->dataPtr->links[iter->second].requests;
+    return;
+  }
+
+  RegisteredLink entry;
+  entry.link = _link;
+  entry.name = _link->GetScopedName();
+  entry.requests = 1;
+  this->dataPtr->indices[_link] = this->dataPtr->links.size();
+  this->dataPtr->links.push_back(std::move(entry));
+}
+
+/////////////////////////////////////////////////
+bool LinkDataRegistry::Remove(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link);
+  if (iter == this->dataPtr->indices.end())
+    return false;
+
+  if (--this->dataPtr->links[iter->second].requests == 0)
+    this->dataPtr->Erase(iter->second);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LinkDataRegistry::RemoveAll(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link);
+  if (iter != this->dataPtr->indices.end())
+    this->dataPtr->Erase(iter->second);
+}
+
+/////////////////////////////////////////////////
+bool LinkDataRegistry::Contains(const Link *_link) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->indices.find(_link) !=
+    this->dataPtr->indices.end();
+}
+
+/////////////////////////////////////////////////
+unsigned int LinkDataRegistry::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->links.size();
+}
+
+/////////////////////////////////////////////////
+bool LinkDataRegistry::Data(const Link *_link, Sample &_sample) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link);
+  if (iter == this->dataPtr->indices.end())
+    return false;
+
+  const RegisteredLink &entry = this->dataPtr->links[iter->second];
+  if (!entry.sampled)
+    return false;
+
+  _sample = entry.sample;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LinkDataRegistry::Update(const common::Time &_simTime)
+{
+  transport::PublisherPtr pub;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->publishers.clear();
+    for (auto &entry : this->dataPtr->links)
+    {
+      entry.sample.time = _simTime;
+      entry.sample.linearVel = entry.link->WorldLinearVel();
+      entry.sample.angularVel = entry.link->WorldAngularVel();
+      entry.sampled = true;
+      this->dataPtr->publishers.push_back(entry.link);
+    }
+  }
+
+  // Per link topics, published by the links since they own them. Their
+  // data is read back from the registry.
+  for (Link *link : this->dataPtr->publishers)
+    link->PublishData();
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (!this->dataPtr->pub || !this->dataPtr->pub->HasConnections() ||
+        this->dataPtr->links.empty())
+    {
+      return;
+    }
+    pub = this->dataPtr->pub;
+
+    // Fill the message while the links can't change, reusing its elements
+    msgs::LinkData_V &msg = this->dataPtr->msg;
+    msgs::Set(msg.mutable_time(), _simTime);
+    while (msg.link_data_size() >
+        static_cast<int>(this->dataPtr->links.size()))
+    {
+      msg.mutable_link_data()->RemoveLast();
+    }
+    for (size_t i = 0; i < this->dataPtr->links.size(); ++i)
+    {
+      const RegisteredLink &entry = this->dataPtr->links[i];
+      msgs::LinkData *data = static_cast<int>(i) < msg.link_data_size() ?
+          msg.mutable_link_data(i) : msg.add_link_data();
+      msgs::Set(data->mutable_time(), _simTime);
+      data->set_name(entry.name);
+      msgs::Set(data->mutable_linear_velocity(), entry.sample.linearVel);
+      msgs::Set(data->mutable_angular_velocity(), entry.sample.angularVel);
+    }
+  }
+
+  pub->Publish(this->dataPtr->msg);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_LINKDATAREGISTRY_HH_
+#define GAZEBO_PHYSICS_LINKDATAREGISTRY_HH_
+
+#include <memory>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class LinkDataRegistryPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class LinkDataRegistry LinkDataRegistry.hh physics/physics.hh
+    /// \brief Samples the data of the links that requested it, such as
+    /// the links of IMU sensors, in a single pass per iteration.
+    ///
+    /// Links are added by Link::SetPublishData. Requests are counted, so a
+    /// link stays in the registry until each request is withdrawn. At the
+    /// end of each iteration, right before the world update end event, the
+    /// world updates the registry, which stores the simulation time and the
+    /// world velocities of the links. Sensors of the same process read them
+    /// with Data, from any thread. If the publisher set with SetPublisher
+    /// has subscribers, the data of all the links is also published in one
+    /// msgs::LinkData_V message, on ~/link_data for the world. Each link
+    /// also publishes its msgs::LinkData on ~/<scoped link name> while that
+    /// topic has subscribers.
+    ///
+    /// The registry is owned by the World, see World::LinkData.
+    class GZ_PHYSICS_VISIBLE LinkDataRegistry
+    {
+      /// \brief Data of a link.
+      public: class Sample
+      {
+        /// \brief Simulation time of the data.
+        public: common::Time time;
+
+        /// \brief Linear velocity of the link origin, in the world frame.
+        public: ignition::math::Vector3d linearVel;
+
+        /// \brief Angular velocity of the link, in the world frame.
+        public: ignition::math::Vector3d angularVel;
+      };
+
+      /// \brief Constructor.
+      public: LinkDataRegistry();
+
+      /// \brief Destructor.
+      public: ~LinkDataRegistry();
+
+      /// \brief Set the publisher of the batched message.
+      /// \param[in] _pub Publisher of msgs::LinkData_V, null to only keep
+      /// the data in memory.
+      public: void SetPublisher(const transport::PublisherPtr &_pub);
+
+      /// \brief Request the data of a link. Its data is first available
+      /// after the next call to Update.
+      /// \param[in] _link The link.
+      public: void Add(Link *_link);
+
+      /// \brief Withdraw a request made with Add. The link is removed once
+      /// all its requests are withdrawn.
+      /// \param[in] _link The link.
+      /// \return False if the link wasn't added.
+      public: bool Remove(Link *_link);
+
+      /// \brief Remove a link, whatever the number of its requests. Called
+      /// by Link::Fini.
+      /// \param[in] _link The link.
+      public: void RemoveAll(Link *_link);
+
+      /// \brief Get whether a link has requests.
+      /// \param[in] _link The link.
+      /// \return True if the link was added and not removed since.
+      public: bool Contains(const Link *_link) const;
+
+      /// \brief Get the number of links.
+      /// \return Number of links with at least one request.
+      public: unsigned int LinkCount() const;
+
+      /// \brief Get the latest data of a link.
+      /// \param[in] _link The link.
+      /// \param[out] _sample The data.
+      /// \return False if the link wasn't added, or wasn't sampled yet.
+      public: bool Data(const Link *_link, Sample &_sample) const;
+
+      /// \brief Sample the data of all the links, and publish it if the
+      /// publisher has subscribers. Each link then publishes its own data
+      /// if its topic has subscribers.
+      /// \param[in] _simTime Current simulation time.
+      public: void Update(const common::Time &_simTime);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<LinkDataRegistryPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -211,6 +211,12 @@ bool LinkState::IsZero() const
   return this->pose == ignition::math::Pose3d::Zero;
 }
 
+/////////////////////////////////////////////////
+bool LinkState::IsZero(const double _tolerance) const
+{
+  return IsNearZero(this->pose, _tolerance);
+}
+
 /////////////////////////////////////////////////
 LinkState &LinkState::operator=(const LinkState &_state)
 {
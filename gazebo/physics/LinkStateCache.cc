@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/LinkStateCache.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the LinkStateCache class
+    class LinkStateCachePrivate
+    {
+      /// \brief Links of one model in the arrays.
+      public: class ModelRange
+      {
+        /// \brief The model.
+        public: ModelPtr model;
+
+        /// \brief Index of the first link of the model.
+        public: size_t start;
+
+        /// \brief Number of links of the model.
+        public: size_t count;
+      };
+
+      /// \brief Append the links of a model and its nested models.
+      /// \param[in] _model Model to add.
+      public: void AddModel(const ModelPtr &_model)
+      {
+        const Link_V &modelLinks = _model->GetLinks();
+        this->modelIndices[_model->GetId()] = this->ranges.size();
+        this->ranges.push_back({_model, this->links.size(),
+            modelLinks.size()});
+
+        for (auto const &link : modelLinks)
+        {
+          this->linkIndices[link->GetId()] = this->links.size();
+          this->links.push_back(link);
+          this->canonical.push_back(link->IsCanonicalLink());
+        }
+
+        for (auto const &nested : _model->NestedModels())
+          this->AddModel(nested);
+      }
+
+      /// \brief Get the range of a model.
+      /// \param[in] _model The model.
+      /// \return The range, null if the model is not in the cache.
+      public: const ModelRange *Range(const ModelPtr &_model) const
+      {
+        if (!_model)
+          return nullptr;
+
+        auto iter = this->modelIndices.find(_model->GetId());
+        if (iter == this->modelIndices.end())
+          return nullptr;
+        return &this->ranges[iter->second];
+      }
+
+      /// \brief Get the index of a link.
+      /// \param[in] _link The link.
+      /// \param[out] _index Index of the link in the arrays.
+      /// \return False if the link is not in the cache.
+      public: bool Index(const LinkPtr &_link, size_t &_index) const
+      {
+        if (!_link)
+          return false;
+
+        auto iter = this->linkIndices.find(_link->GetId());
+        if (iter == this->linkIndices.end())
+          return false;
+
+        _index = iter->second;
+        return true;
+      }
+
+      /// \brief Copy the entries of a model.
+      /// \param[in] _model The model.
+      /// \param[in] _values Array to copy from.
+      /// \param[out] _out Entries of the links of the model.
+      /// \return False if the model is not in the cache.
+      public: bool CopyRange(const ModelPtr &_model,
+                  const std::vector<ignition::math::Pose3d> &_values,
+                  std::vector<ignition::math::Pose3d> &_out) const
+      {
+        const ModelRange *range = this->Range(_model);
+        if (!range)
+          return false;
+
+        auto first = _values.begin() + range->start;
+        _out.assign(first, first + range->count);
+        return true;
+      }
+
+      /// \brief True if the layout must be rebuilt.
+      public: bool dirty = true;
+
+      /// \brief Links, in cache order.
+      public: Link_V links;
+
+      /// \brief True for the canonical links, which keep their initial
+      /// relative pose.
+      public: std::vector<bool> canonical;
+
+      /// \brief Link id to index in the arrays.
+      public: std::unordered_map<uint32_t, size_t> linkIndices;
+
+      /// \brief Models, in cache order.
+      public: std::vector<ModelRange> ranges;
+
+      /// \brief Model id to index in ranges.
+      public: std::unordered_map<uint32_t, size_t> modelIndices;
+
+      /// \brief World poses.
+      public: std::vector<ignition::math::Pose3d> poses;
+
+      /// \brief Poses relative to the model of the link.
+      public: std::vector<ignition::math::Pose3d> relativePoses;
+
+      /// \brief World linear velocities.
+      public: std::vector<ignition::math::Vector3d> linearVels;
+
+      /// \brief World angular velocities.
+      public: std::vector<ignition::math::Vector3d> angularVels;
+
+      /// \brief World linear accelerations.
+      public: std::vector<ignition::math::Vector3d> linearAccels;
+
+      /// \brief World angular accelerations.
+      public: std::vector<ignition::math::Vector3d> angularAccels;
+
+      /// \brief Protects the layout and the arrays.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+LinkStateCache::LinkStateCache()
+  : dataPtr(new LinkStateCachePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+LinkStateCache::~LinkStateCache()
+{
+}
+
+//////////////////////////////////////////////////
+void LinkStateCache::MarkDirty()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+void LinkStateCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->links.clear();
+  this->dataPtr->canonical.clear();
+  this->dataPtr->linkIndices.clear();
+  this->dataPtr->ranges.clear();
+  this->dataPtr->modelIndices.clear();
+  this->dataPtr->poses.clear();
+  this->dataPtr->relativePoses.clear();
+  this->dataPtr->linearVels.clear();
+  this->dataPtr->angularVels.clear();
+  this->dataPtr->linearAccels.clear();
+  this->dataPtr->angularAccels.clear();
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+void LinkStateCache::Update(const Model_V &_models)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (this->dataPtr->dirty)
+  {
+    this->dataPtr->links.clear();
+    this->dataPtr->canonical.clear();
+    this->dataPtr->linkIndices.clear();
+    this->dataPtr->ranges.clear();
+    this->dataPtr->modelIndices.clear();
+
+    for (auto const &model : _models)
+      this->dataPtr->AddModel(model);
+
+    const size_t count = this->dataPtr->links.size();
+    this->dataPtr->poses.resize(count);
+    this->dataPtr->relativePoses.resize(count);
+    this->dataPtr->linearVels.resize(count);
+    this->dataPtr->angularVels.resize(count);
+    this->dataPtr->linearAccels.resize(count);
+    this->dataPtr->angularAccels.resize(count);
+
+    this->dataPtr->dirty = false;
+  }
+
+  for (auto const &range : this->dataPtr->ranges)
+  {
+    const ignition::math::Pose3d modelPose = range.model->WorldPose();
+    for (size_t i = range.start; i < range.start + range.count; ++i)
+    {
+      const Link *link = this->dataPtr->links[i].get();
+      this->dataPtr->poses[i] = link->WorldPose();
+      this->dataPtr->relativePoses[i] = this->dataPtr->canonical[i] ?
+          link->RelativePose() : this->dataPtr->poses[i] - modelPose;
+      this->dataPtr->linearVels[i] = link->WorldLinearVel();
+      this->dataPtr->angularVels[i] = link->WorldAngularVel();
+      this->dataPtr->linearAccels[i] = link->WorldLinearAccel();
+      this->dataPtr->angularAccels[i] = link->WorldAngularAccel();
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+size_t LinkStateCache::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->links.size();
+}
+
+//////////////////////////////////////////////////
+bool LinkStateCache::LinkIndex(const LinkPtr &_link, size_t &_index) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->Index(_link, _index);
+}
+
+//////////////////////////////////////////////////
+bool LinkStateCache::ModelRange(const ModelPtr &_model, size_t &_start,
+    size_t &_count) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto range = this->dataPtr->Range(_model);
+  if (!range)
+    return false;
+
+  _start = range->start;
+  _count = range->count;
+  return true;
+}
+
+//////////////////////////////////////////////////
+Link_V LinkStateCache::Links() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->links;
+}
+
+//////////////////////////////////////////////////
+std::vector<ignition::math::Pose3d> LinkStateCache::WorldPoses() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->poses;
+}
+
+//////////////////////////////////////////////////
+std::vector<ignition::math::Vector3d> LinkStateCache::WorldLinearVels() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->linearVels;
+}
+
+//////////////////////////////////////////////////
+std::vector<ignition::math::Vector3d> LinkStateCache::WorldAngularVels() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->angularVels;
+}
+
+//////////////////////////////////////////////////
+std::vector<ignition::math::Vector3d>
+LinkStateCache::WorldLinearAccels() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->linearAccels;
+}
+
+//////////////////////////////////////////////////
+std::vector<ignition::math::Vector3d>
+LinkStateCache::WorldAngularAccels() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->angularAccels;
+}
+
+//////////////////////////////////////////////////
+bool LinkStateCache::LinkWorldPose(const LinkPtr &_link,
+    ignition::math::Pose3d &_pose) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  size_t index = 0;
+  if (!this->dataPtr->Index(_link, index))
+    return false;
+
+  _pose = this->dataPtr->poses[index];
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LinkStateCache::LinkWorldVelocity(const LinkPtr &_link,
+    ignition::math::Vector3d &_linear,
+    ignition::math::Vector3d &_angular) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  size_t index = 0;
+  if (!this->dataPtr->Index(_link, index))
+    return false;
+
+  _linear = this->dataPtr->linearVels[index];
+  _angular = this->dataPtr->angularVels[index];
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LinkStateCache::ModelLinkPoses(const ModelPtr &_model,
+    std::vector<ignition::math::Pose3d> &_poses) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->CopyRange(_model, this->dataPtr->poses, _poses);
+}
+
+//////////////////////////////////////////////////
+bool LinkStateCache::ModelLinkRelativePoses(const ModelPtr &_model,
+    std::vector<ignition::math::Pose3d> &_poses) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->CopyRange(_model, this->dataPtr->relativePoses,
+      _poses);
+}
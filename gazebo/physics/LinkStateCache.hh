@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_LINKSTATECACHE_HH_
+#define GAZEBO_PHYSICS_LINKSTATECACHE_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class LinkStateCachePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class LinkStateCache LinkStateCache.hh physics/physics.hh
+    /// \brief World owned, contiguous cache of the world frame state of
+    /// every link.
+    ///
+    /// The state is stored as a structure of arrays: one array per
+    /// quantity, with the links of a model stored next to each other. The
+    /// cache is refreshed once per World::Update, right after the physics
+    /// engine poses have been propagated to the entities, so reading from
+    /// it avoids the virtual dispatch and tree walk of Link::WorldPose,
+    /// Link::WorldLinearVel and friends.
+    ///
+    /// The cache is disabled by default, see World::SetLinkStateCacheEnabled.
+    /// The accessors return copies taken under a lock, so they can be
+    /// called from any thread while the world updates.
+    class GZ_PHYSICS_VISIBLE LinkStateCache
+    {
+      /// \brief Constructor.
+      public: LinkStateCache();
+
+      /// \brief Destructor.
+      public: ~LinkStateCache();
+
+      /// \brief Mark the list of links as outdated. The link layout is
+      /// rebuilt on the next Update. Called by the world when models are
+      /// inserted or removed.
+      public: void MarkDirty();
+
+      /// \brief Drop all the links, so that the cache doesn't keep removed
+      /// links alive while it is disabled. The layout is rebuilt on the
+      /// next Update.
+      public: void Clear();
+
+      /// \brief Rebuild the layout if needed and copy the current state of
+      /// every link into the cache.
+      /// \param[in] _models Top level models of the world.
+      public: void Update(const Model_V &_models);
+
+      /// \brief Number of links in the cache.
+      /// \return Number of cached links.
+      public: size_t LinkCount() const;
+
+      /// \brief Get the index of a link in the cache arrays.
+      /// \param[in] _link The link to look up.
+      /// \param[out] _index Index of the link in the arrays.
+      /// \return False if the link is not in the cache.
+      public: bool LinkIndex(const LinkPtr &_link, size_t &_index) const;
+
+      /// \brief Get the range of the links of a model in the cache arrays.
+      /// Only direct links are included, as returned by Model::GetLinks.
+      /// \param[in] _model The model to look up.
+      /// \param[out] _start Index of the first link of the model.
+      /// \param[out] _count Number of links of the model.
+      /// \return False if the model is not in the cache.
+      public: bool ModelRange(const ModelPtr &_model, size_t &_start,
+                  size_t &_count) const;
+
+      /// \brief Get the links, in cache order.
+      /// \return The cached links.
+      public: Link_V Links() const;
+
+      /// \brief Get the world poses of all links.
+      /// \return World poses, in cache order.
+      public: std::vector<ignition::math::Pose3d> WorldPoses() const;
+
+      /// \brief Get the world linear velocities of all links.
+      /// \return World linear velocities at the link origin, in cache order.
+      public: std::vector<ignition::math::Vector3d> WorldLinearVels() const;
+
+      /// \brief Get the world angular velocities of all links.
+      /// \return World angular velocities, in cache order.
+      public: std::vector<ignition::math::Vector3d> WorldAngularVels() const;
+
+      /// \brief Get the world linear accelerations of all links.
+      /// \return World linear accelerations, in cache order.
+      public: std::vector<ignition::math::Vector3d> WorldLinearAccels() const;
+
+      /// \brief Get the world angular accelerations of all links.
+      /// \return World angular accelerations, in cache order.
+      public: std::vector<ignition::math::Vector3d> WorldAngularAccels()
+                  const;
+
+      /// \brief Get the cached world pose of a link, as returned by
+      /// Link::WorldPose at the last update.
+      /// \param[in] _link The link.
+      /// \param[out] _pose World pose of the link.
+      /// \return False if the link is not in the cache.
+      public: bool LinkWorldPose(const LinkPtr &_link,
+                  ignition::math::Pose3d &_pose) const;
+
+      /// \brief Get the cached world velocity of a link, as returned by
+      /// Link::WorldLinearVel and Link::WorldAngularVel at the last update.
+      /// \param[in] _link The link.
+      /// \param[out] _linear World linear velocity of the link origin.
+      /// \param[out] _angular World angular velocity of the link.
+      /// \return False if the link is not in the cache.
+      public: bool LinkWorldVelocity(const LinkPtr &_link,
+                  ignition::math::Vector3d &_linear,
+                  ignition::math::Vector3d &_angular) const;
+
+      /// \brief Copy the world poses of the links of a model.
+      /// \param[in] _model The model.
+      /// \param[out] _poses World poses of the model's links, in the
+      /// same order as Model::GetLinks.
+      /// \return False if the model is not in the cache.
+      public: bool ModelLinkPoses(const ModelPtr &_model,
+                  std::vector<ignition::math::Pose3d> &_poses) const;
+
+      /// \brief Copy the poses of the links of a model relative to the
+      /// model, as returned by Link::RelativePose at the last update.
+      /// \param[in] _model The model.
+      /// \param[out] _poses Relative poses of the model's links, in the
+      /// same order as Model::GetLinks.
+      /// \return False if the model is not in the cache.
+      public: bool ModelLinkRelativePoses(const ModelPtr &_model,
+                  std::vector<ignition::math::Pose3d> &_poses) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<LinkStateCachePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/LinkStateCache.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LinkStateCacheTest : public ServerFixture {};
+
+//////////////////////////////////////////////////
+TEST_F(LinkStateCacheTest, Disabled)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_FALSE(world->LinkStateCacheEnabled());
+  EXPECT_EQ(0u, world->LinkStates().LinkCount());
+
+  world->Step(10);
+  EXPECT_EQ(0u, world->LinkStates().LinkCount());
+}
+
+//////////////////////////////////////////////////
+TEST_F(LinkStateCacheTest, MatchesLinks)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  world->SetLinkStateCacheEnabled(true);
+  EXPECT_TRUE(world->LinkStateCacheEnabled());
+
+  // Drop the box so it has non zero velocity
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 5, 0, 0, 0));
+  world->Step(50);
+
+  const physics::LinkStateCache &cache = world->LinkStates();
+  EXPECT_GE(cache.LinkCount(), 3u);
+  ASSERT_EQ(cache.LinkCount(), cache.WorldPoses().size());
+  ASSERT_EQ(cache.LinkCount(), cache.WorldLinearVels().size());
+
+  for (auto const &model : world->Models())
+  {
+    size_t start = 0;
+    size_t count = 0;
+    ASSERT_TRUE(cache.ModelRange(model, start, count));
+    EXPECT_EQ(model->GetLinks().size(), count);
+
+    std::vector<ignition::math::Pose3d> poses;
+    EXPECT_TRUE(cache.ModelLinkPoses(model, poses));
+    ASSERT_EQ(count, poses.size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto link = model->GetLinks()[i];
+      size_t index = 0;
+      EXPECT_TRUE(cache.LinkIndex(link, index));
+      EXPECT_EQ(start + i, index);
+      EXPECT_EQ(link->WorldPose(), poses[i]);
+      EXPECT_EQ(link->WorldPose(), cache.WorldPoses()[index]);
+      EXPECT_EQ(link->WorldLinearVel(), cache.WorldLinearVels()[index]);
+      EXPECT_EQ(link->WorldAngularVel(), cache.WorldAngularVels()[index]);
+
+      ignition::math::Pose3d pose;
+      EXPECT_TRUE(cache.LinkWorldPose(link, pose));
+      EXPECT_EQ(link->WorldPose(), pose);
+
+      ignition::math::Vector3d linear;
+      ignition::math::Vector3d angular;
+      EXPECT_TRUE(cache.LinkWorldVelocity(link, linear, angular));
+      EXPECT_EQ(link->WorldLinearVel(), linear);
+      EXPECT_EQ(link->WorldAngularVel(), angular);
+    }
+
+    std::vector<ignition::math::Pose3d> relativePoses;
+    EXPECT_TRUE(cache.ModelLinkRelativePoses(model, relativePoses));
+    ASSERT_EQ(count, relativePoses.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+      EXPECT_EQ(model->GetLinks()[i]->RelativePose(), relativePoses[i]);
+    }
+  }
+
+  auto boxLink = box->GetLink();
+  ASSERT_NE(nullptr, boxLink);
+  size_t boxIndex = 0;
+  ASSERT_TRUE(cache.LinkIndex(boxLink, boxIndex));
+  EXPECT_LT(cache.WorldLinearVels()[boxIndex].Z(), 0.0);
+
+  // Removed models are dropped on the next update
+  world->RemoveModel("box");
+  world->Step(1);
+  EXPECT_FALSE(cache.LinkIndex(boxLink, boxIndex));
+  size_t start = 0;
+  size_t count = 0;
+  EXPECT_FALSE(cache.ModelRange(box, start, count));
+
+  // Disabling the cache drops the links
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_NE(nullptr, sphere);
+  auto sphereLink = sphere->GetLink();
+  ASSERT_NE(nullptr, sphereLink);
+  size_t sphereIndex = 0;
+  EXPECT_TRUE(cache.LinkIndex(sphereLink, sphereIndex));
+  world->SetLinkStateCacheEnabled(false);
+  EXPECT_EQ(0u, cache.LinkCount());
+  EXPECT_FALSE(cache.LinkIndex(sphereLink, sphereIndex));
+  world->Step(1);
+  EXPECT_EQ(0u, cache.LinkCount());
+
+  // And enabling it fills it right away
+  world->SetLinkStateCacheEnabled(true);
+  EXPECT_TRUE(cache.LinkIndex(sphereLink, sphereIndex));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
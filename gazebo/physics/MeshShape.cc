@@ -114,6 +114,18 @@ std::string MeshShape::GetMeshURI() const
   return this->sdf->Get<std::string>("uri");
 }
 
+//////////////////////////////////////////////////
+const common::Mesh *MeshShape::MeshData() const
+{
+  return this->mesh;
+}
+
+//////////////////////////////////////////////////
+const common::SubMesh *MeshShape::SubMeshData() const
+{
+  return this->submesh;
+}
+
 //////////////////////////////////////////////////
 void MeshShape::SetMesh(const std::string &_uri,
     const std::string &_submesh, bool _center)
@@ -65,6 +65,14 @@ namespace gazebo
                            const std::string &_submesh = "",
                            bool _center = false);
 
+      /// \brief Get the mesh data.
+      /// \return Pointer to the mesh, null if no mesh was loaded.
+      public: const common::Mesh *MeshData() const;
+
+      /// \brief Get the submesh used instead of the whole mesh.
+      /// \return Pointer to the submesh, null if the whole mesh is used.
+      public: const common::SubMesh *SubMeshData() const;
+
       /// \brief Set the scaling factor.
       /// \param[in] _scale Scaling factor.
       public: void SetScale(const ignition::math::Vector3d &_scale);
@@ -25,11 +25,14 @@
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/SemanticVersion.hh>
 #include <ignition/msgs/plugin_v.pb.h>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
 
 #include "gazebo/common/KeyFrame.hh"
 #include "gazebo/common/Animation.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/PluginProfiler.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
@@ -45,6 +48,7 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelPrivate.hh"
 #include "gazebo/physics/Contact.hh"
 
 #include "gazebo/transport/Node.hh"
@@ -56,17 +60,56 @@
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Private data of the models, by model. It is kept out of Model
+  /// so that the layout of the class doesn't change.
+  class ModelPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the models.
+    public: static ModelPrivates &Instance()
+    {
+      static ModelPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by model.
+    public: std::unordered_map<const Model *,
+            std::unique_ptr<ModelPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 Model::Model(BasePtr _parent)
   : Entity(_parent)
 {
   this->AddType(MODEL);
+
+  ModelPrivates &privates = ModelPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new ModelPrivate);
 }
 
 //////////////////////////////////////////////////
 Model::~Model()
 {
   this->Fini();
+
+  ModelPrivates &privates = ModelPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+ModelPrivate *Model::ModelData() const
+{
+  ModelPrivates &privates = ModelPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -551,9 +594,30 @@ void Model::UpdateParameters(sdf::ElementPtr _sdf)
 //////////////////////////////////////////////////
 const sdf::ElementPtr Model::GetSDF()
 {
+  this->RestoreSDF();
   return Entity::GetSDF();
 }
 
+//////////////////////////////////////////////////
+void Model::ReleaseSDF()
+{
+  for (auto const &link : this->links)
+    link->ReleaseVisualSDF();
+
+  for (auto const &model : this->models)
+    model->ReleaseSDF();
+}
+
+//////////////////////////////////////////////////
+void Model::RestoreSDF()
+{
+  for (auto const &link : this->links)
+    link->RestoreVisualSDF();
+
+  for (auto const &model : this->models)
+    model->RestoreSDF();
+}
+
 const sdf::Model *Model::GetSDFDom() const
 {
   return this->modelSDFDom;
@@ -563,6 +627,7 @@ const sdf::Model *Model::GetSDFDom() const
 const sdf::ElementPtr Model::UnscaledSDF()
 {
   GZ_ASSERT(this->sdf != NULL, "Model sdf member is NULL");
+  this->RestoreSDF();
   this->sdf->Update();
 
   sdf::ElementPtr unscaledSdf(this->sdf);
@@ -1103,6 +1168,10 @@ void Model::LoadPlugin(sdf::ElementPtr _sdf)
 
     ModelPtr myself = boost::static_pointer_cast<Model>(shared_from_this());
 
+    // Time the event callbacks the plugin connects
+    common::PluginProfiler::Scope scope(filename,
+        this->GetScopedName(true) + "::" + pluginName);
+
     try
     {
       plugin->Load(myself, _sdf);
@@ -1261,6 +1330,79 @@ void Model::ProcessMsg(const msgs::Model &_msg)
     this->SetWindMode(_msg.enable_wind());
 }
 
+//////////////////////////////////////////////////
+void Model::JointStates(const Joint_V &_joints,
+    std::vector<double> *_positions, std::vector<double> *_velocities,
+    std::vector<double> *_efforts) const
+{
+  const ModelPrivate *data = this->ModelData();
+  if (data->jointStates)
+    data->jointStates(_joints, _positions, _velocities, _efforts);
+  else
+    this->DefaultJointStates(_joints, _positions, _velocities, _efforts);
+}
+
+//////////////////////////////////////////////////
+void Model::DefaultJointStates(const Joint_V &_joints,
+    std::vector<double> *_positions, std::vector<double> *_velocities,
+    std::vector<double> *_efforts) const
+{
+  if (_positions)
+    _positions->clear();
+  if (_velocities)
+    _velocities->clear();
+  if (_efforts)
+    _efforts->clear();
+
+  for (auto const &joint : _joints)
+  {
+    const unsigned int dof = joint->DOF();
+    for (unsigned int i = 0; i < dof; ++i)
+    {
+      if (_positions)
+        _positions->push_back(joint->Position(i));
+      if (_velocities)
+        _velocities->push_back(joint->GetVelocity(i));
+      if (_efforts)
+        _efforts->push_back(joint->GetForce(i));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Model::SetJointStatesFunction(
+    const std::function<void (const Joint_V &, std::vector<double> *,
+        std::vector<double> *, std::vector<double> *)> &_jointStates)
+{
+  this->ModelData()->jointStates = _jointStates;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointForces(const Joint_V &_joints,
+    const std::vector<double> &_forces)
+{
+  size_t count = 0;
+  for (auto const &joint : _joints)
+    count += joint->DOF();
+
+  if (count != _forces.size())
+  {
+    gzerr << "Got [" << _forces.size() << "] forces for [" << count
+          << "] joint axes\n";
+    return false;
+  }
+
+  size_t index = 0;
+  for (auto const &joint : _joints)
+  {
+    const unsigned int dof = joint->DOF();
+    for (unsigned int i = 0; i < dof; ++i)
+      joint->SetForce(i, _forces[index++]);
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Model::SetJointAnimation(
     const std::map<std::string, common::NumericAnimationPtr> &_anims,
@@ -1454,6 +1596,30 @@ bool Model::GetAutoDisable() const
   return this->sdf->Get<bool>("allow_auto_disable");
 }
 
+/////////////////////////////////////////////////
+void Model::SetThreadSafeUpdate(const bool _safe)
+{
+  this->ModelData()->threadSafeUpdate = _safe;
+}
+
+/////////////////////////////////////////////////
+bool Model::ThreadSafeUpdate() const
+{
+  return this->ModelData()->threadSafeUpdate;
+}
+
+/////////////////////////////////////////////////
+void Model::SetPhysicsSubsteps(const unsigned int _substeps)
+{
+  this->ModelData()->physicsSubsteps = std::max(1u, _substeps);
+}
+
+/////////////////////////////////////////////////
+unsigned int Model::PhysicsSubsteps() const
+{
+  return this->ModelData()->physicsSubsteps;
+}
+
 /////////////////////////////////////////////////
 void Model::SetSelfCollide(bool _self_collide)
 {
@@ -1641,30 +1807,30 @@ void Model::RegisterIntrospectionItems()
 {
   auto uri = this->URI();
 
-  // Callbacks.
-  auto fModelPose = [this]()
+  // Getters, sampled without allocating at every update.
+  auto fModelPose = [](const Model &_model, const unsigned int)
   {
-    return this->WorldPose();
+    return _model.WorldPose();
   };
 
-  auto fModelLinVel = [this]()
+  auto fModelLinVel = [](const Model &_model, const unsigned int)
   {
-    return this->WorldLinearVel();
+    return _model.WorldLinearVel();
   };
 
-  auto fModelAngVel = [this]()
+  auto fModelAngVel = [](const Model &_model, const unsigned int)
   {
-    return this->WorldAngularVel();
+    return _model.WorldAngularVel();
   };
 
-  auto fModelLinAcc = [this]()
+  auto fModelLinAcc = [](const Model &_model, const unsigned int)
   {
-    return this->WorldLinearAccel();
+    return _model.WorldLinearAccel();
   };
 
-  auto fModelAngAcc = [this]()
+  auto fModelAngAcc = [](const Model &_model, const unsigned int)
   {
-    return this->WorldAngularAccel();
+    return _model.WorldAngularAccel();
   };
 
   // Register items.
@@ -1672,31 +1838,31 @@ void Model::RegisterIntrospectionItems()
   poseURI.Query().Insert("p", "pose3d/world_pose");
   this->introspectionItems.push_back(poseURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Pose3d>(poseURI.Str(), fModelPose);
+      <ignition::math::Pose3d>(poseURI.Str(), *this, fModelPose);
 
   common::URI linVelURI(uri);
   linVelURI.Query().Insert("p", "vector3d/world_linear_velocity");
   this->introspectionItems.push_back(linVelURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(linVelURI.Str(), fModelLinVel);
+      <ignition::math::Vector3d>(linVelURI.Str(), *this, fModelLinVel);
 
   common::URI angVelURI(uri);
   angVelURI.Query().Insert("p", "vector3d/world_angular_velocity");
   this->introspectionItems.push_back(angVelURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(angVelURI.Str(), fModelAngVel);
+      <ignition::math::Vector3d>(angVelURI.Str(), *this, fModelAngVel);
 
   common::URI linAccURI(uri);
   linAccURI.Query().Insert("p", "vector3d/world_linear_acceleration");
   this->introspectionItems.push_back(linAccURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(linAccURI.Str(), fModelLinAcc);
+      <ignition::math::Vector3d>(linAccURI.Str(), *this, fModelLinAcc);
 
   common::URI angAccURI(uri);
   angAccURI.Query().Insert("p", "vector3d/world_angular_acceleration");
   this->introspectionItems.push_back(angAccURI);
   gazebo::util::IntrospectionManager::Instance()->Register
-      <ignition::math::Vector3d>(angAccURI.Str(), fModelAngAcc);
+      <ignition::math::Vector3d>(angAccURI.Str(), *this, fModelAngAcc);
 }
 
 /////////////////////////////////////////////////
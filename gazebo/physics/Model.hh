@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_MODEL_HH_
 #define GAZEBO_PHYSICS_MODEL_HH_
 
+#include <functional>
 #include <string>
 #include <map>
 #include <mutex>
@@ -50,6 +51,7 @@ namespace gazebo
   namespace physics
   {
     class Gripper;
+    class ModelPrivate;
 
     /// \addtogroup gazebo_physics
     /// \{
@@ -85,10 +87,17 @@ namespace gazebo
       /// \param[in] _sdf SDF values to update from.
       public: virtual void UpdateParameters(sdf::ElementPtr _sdf) override;
 
-      /// \brief Get the SDF values for the model.
+      /// \brief Get the SDF values for the model. Elements released by
+      /// ReleaseSDF are recreated first.
       /// \return The SDF value for this model.
       public: virtual const sdf::ElementPtr GetSDF() override;
 
+      /// \brief Remove the parts of the SDF of the model and its nested
+      /// models that the server keeps in another form, to save memory.
+      /// They are recreated from the state of the entities by the next
+      /// call to GetSDF or UnscaledSDF.
+      public: void ReleaseSDF();
+
       /// \brief Get the SDF DOM for the model.
       /// \return The SDF DOM for this model.
       public: const sdf::Model *GetSDFDom() const;
@@ -262,6 +271,34 @@ namespace gazebo
       public: void SetJointPositions(
                   const std::map<std::string, double> &_jointPositions);
 
+      /// \brief Read the state of the axes of a list of joints in one call.
+      /// The values are laid out joint after joint, Joint::DOF values per
+      /// joint, in the order of the list. Physics engines may replace it,
+      /// see SetJointStatesFunction, to read the state of all the joints at
+      /// once.
+      /// \param[in] _joints Joints of this model or of its nested models.
+      /// \param[out] _positions Positions, as returned by Joint::Position.
+      /// Null to skip.
+      /// \param[out] _velocities Velocities, as returned by
+      /// Joint::GetVelocity. Null to skip.
+      /// \param[out] _efforts Forces applied in the current step, as returned
+      /// by Joint::GetForce. Null to skip.
+      public: void JointStates(const Joint_V &_joints,
+                  std::vector<double> *_positions,
+                  std::vector<double> *_velocities,
+                  std::vector<double> *_efforts = nullptr) const;
+
+      /// \brief Apply forces to the axes of a list of joints in one call,
+      /// laid out as in JointStates. Each force goes through
+      /// Joint::SetForce, so it is truncated to the effort limit of the
+      /// axis and recorded as the applied force.
+      /// \param[in] _joints Joints of this model or of its nested models.
+      /// \param[in] _forces Forces, one per axis of the joints.
+      /// \return False, and no force applied, if the number of forces
+      /// isn't the number of axes.
+      public: bool SetJointForces(const Joint_V &_joints,
+                  const std::vector<double> &_forces);
+
       /// \brief Joint Animation.
       /// \param[in] _anim Map of joint names to their position animation.
       /// \param[in] _onComplete Callback function for when the animation
@@ -344,6 +381,37 @@ namespace gazebo
       /// \return True if auto disable is allowed for this model.
       public: bool GetAutoDisable() const;
 
+      /// \brief Declare whether Model::Update may run concurrently with the
+      /// update of other models. Only models flagged as thread safe are
+      /// dispatched to worker threads when the world's parallel model update
+      /// stage is enabled, see World::SetParallelModelUpdate. A model plugin
+      /// that does not touch state outside of its own model may set this
+      /// during its Load.
+      /// \param[in] _safe True if this model can be updated in parallel.
+      public: void SetThreadSafeUpdate(const bool _safe);
+
+      /// \brief Get whether Model::Update may run concurrently with the
+      /// update of other models.
+      /// \return True if this model can be updated in parallel.
+      /// \sa SetThreadSafeUpdate
+      public: bool ThreadSafeUpdate() const;
+
+      /// \brief Set the number of substeps of the links of this model per
+      /// physics step. A model with fast dynamics, such as a stiff
+      /// manipulator next to a slow vehicle, can be stepped at a finer rate
+      /// than the rest of the world, which keeps the step size of the world.
+      /// The substeps end together with the world step. A model connected
+      /// to another dynamic model, by a joint or a contact, is stepped with
+      /// the world. Only honored by the ODE physics engine.
+      /// \param[in] _substeps Number of substeps, 1 to step with the world.
+      public: void SetPhysicsSubsteps(const unsigned int _substeps);
+
+      /// \brief Get the number of substeps of the links of this model per
+      /// physics step.
+      /// \return Number of substeps, 1 if the model steps with the world.
+      /// \sa SetPhysicsSubsteps
+      public: unsigned int PhysicsSubsteps() const;
+
       /// \brief Load all plugins
       ///
       /// Load all plugins specified in the SDF for the model.
@@ -483,6 +551,33 @@ namespace gazebo
       /// \brief Register items in the introspection service.
       protected: virtual void RegisterIntrospectionItems() override;
 
+      /// \brief Read the state of the joints one joint at a time, as
+      /// JointStates does when no function replaces it.
+      /// \param[in] _joints Joints of this model or of its nested models.
+      /// \param[out] _positions Positions. Null to skip.
+      /// \param[out] _velocities Velocities. Null to skip.
+      /// \param[out] _efforts Forces applied in the current step. Null to
+      /// skip.
+      /// \sa JointStates
+      protected: void DefaultJointStates(const Joint_V &_joints,
+                     std::vector<double> *_positions,
+                     std::vector<double> *_velocities,
+                     std::vector<double> *_efforts) const;
+
+      /// \brief Set the function that JointStates calls in place of
+      /// DefaultJointStates. Physics engines set it in the constructor of
+      /// their model.
+      /// \param[in] _jointStates Function with the parameters of
+      /// JointStates.
+      protected: void SetJointStatesFunction(
+                     const std::function<void (const Joint_V &,
+                         std::vector<double> *, std::vector<double> *,
+                         std::vector<double> *)> &_jointStates);
+
+      /// \brief Get the private data of the model.
+      /// \return The private data, see ModelPrivate.
+      private: ModelPrivate *ModelData() const;
+
       /// \brief Load all the links.
       private: void LoadLinks();
 
@@ -509,6 +604,9 @@ namespace gazebo
       /// \brief Publish the scale.
       private: virtual void PublishScale();
 
+      /// \brief Recreate the SDF elements removed by ReleaseSDF.
+      private: void RestoreSDF();
+
       /// used by Model::AttachStaticModel
       protected: std::vector<ModelPtr> attachedModels;
 
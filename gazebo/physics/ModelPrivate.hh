@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_MODELPRIVATE_HH_
+#define GAZEBO_PHYSICS_MODELPRIVATE_HH_
+
+#include <functional>
+#include <vector>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the Model class. It is kept out of the
+    /// class, see Model::ModelData, so that its layout doesn't change.
+    class ModelPrivate
+    {
+      /// \brief True if Model::Update can run in parallel with other models.
+      public: bool threadSafeUpdate = false;
+
+      /// \brief Number of substeps per physics step.
+      public: unsigned int physicsSubsteps = 1;
+
+      /// \brief Reads the joint states in place of
+      /// Model::DefaultJointStates, see Model::SetJointStatesFunction.
+      public: std::function<void (const Joint_V &, std::vector<double> *,
+                  std::vector<double> *, std::vector<double> *)>
+              jointStates;
+    };
+  }
+}
+#endif
@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelSpatialIndex.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Maximum number of models in a leaf of the hierarchy.
+    static const unsigned int IndexLeafSize = 4;
+
+    /// \internal
+    /// \brief A model of the index.
+    class IndexEntry
+    {
+      /// \brief The model.
+      public: ModelPtr model;
+
+      /// \brief Bounding box of the model, as returned by
+      /// Model::BoundingBox.
+      public: ignition::math::AxisAlignedBox box;
+
+      /// \brief Box that contains the bounding boxes and the origins of
+      /// the links of the model.
+      public: ignition::math::AxisAlignedBox bounds;
+    };
+
+    /// \internal
+    /// \brief A node of the hierarchy. Inner nodes have a zero count and
+    /// their children at first and first + 1.
+    class IndexNode
+    {
+      /// \brief Bounds of the models below the node.
+      public: ignition::math::AxisAlignedBox bounds;
+
+      /// \brief First index of a leaf, or first child of an inner node.
+      public: unsigned int first = 0;
+
+      /// \brief Number of models of a leaf.
+      public: unsigned int count = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the ModelSpatialIndex class
+    class ModelSpatialIndexPrivate
+    {
+      /// \brief Add a model and its nested models to the entries, depth
+      /// first.
+      /// \param[in] _models Models to add.
+      public: void AddModels(const Model_V &_models);
+
+      /// \brief Build the hierarchy over the entries.
+      public: void Build();
+
+      /// \brief Fill a node and split it if it has too many models.
+      /// \param[in] _node Index of the node.
+      /// \param[in] _begin First model index of the node.
+      /// \param[in] _end One past the last model index of the node.
+      public: void Split(const size_t _node, const size_t _begin,
+                  const size_t _end);
+
+      /// \brief Visit the entries of the leaves whose bounds pass a test,
+      /// and the unbounded entries.
+      /// \param[in] _test Test of the bounds of a node.
+      /// \param[in] _visit Called with the index of each entry.
+      public: template<typename Test, typename Visit>
+              void Traverse(const Test &_test, const Visit &_visit) const
+      {
+        for (auto const index : this->unbounded)
+          _visit(index);
+
+        if (this->nodes.empty())
+          return;
+
+        std::vector<unsigned int> stack(1, 0u);
+        while (!stack.empty())
+        {
+          const IndexNode &node = this->nodes[stack.back()];
+          stack.pop_back();
+          if (!_test(node.bounds))
+            continue;
+
+          if (node.count == 0)
+          {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+            continue;
+          }
+
+          for (unsigned int i = node.first; i < node.first + node.count; ++i)
+            _visit(this->indices[i]);
+        }
+      }
+
+      /// \brief Models of the world, in the order of a depth first walk.
+      public: std::vector<IndexEntry> entries;
+
+      /// \brief Nodes, the root first.
+      public: std::vector<IndexNode> nodes;
+
+      /// \brief Entry indices referenced by the leaves.
+      public: std::vector<unsigned int> indices;
+
+      /// \brief Entry indices with infinite bounds, kept out of the
+      /// hierarchy.
+      public: std::vector<unsigned int> unbounded;
+
+      /// \brief Iteration the hierarchy was built for.
+      public: uint64_t iteration = 0;
+
+      /// \brief True if the hierarchy must be rebuilt.
+      public: bool dirty = true;
+
+      /// \brief Protects everything above.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+/// \brief Get a box that contains nothing, grown by operator+=.
+/// \return The empty box.
+static ignition::math::AxisAlignedBox EmptyBox()
+{
+  ignition::math::AxisAlignedBox box;
+  box.Min().Set(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  box.Max().Set(-ignition::math::MAX_D, -ignition::math::MAX_D,
+      -ignition::math::MAX_D);
+  return box;
+}
+
+//////////////////////////////////////////////////
+/// \brief Center of a box along an axis.
+/// \param[in] _box The box.
+/// \param[in] _axis Axis index.
+/// \return Center coordinate.
+static double Center(const ignition::math::AxisAlignedBox &_box,
+    const int _axis)
+{
+  return 0.5 * (_box.Min()[_axis] + _box.Max()[_axis]);
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndexPrivate::AddModels(const Model_V &_models)
+{
+  for (auto const &model : _models)
+  {
+    if (!model)
+      continue;
+
+    IndexEntry entry;
+    entry.model = model;
+    entry.box = model->BoundingBox();
+    entry.bounds = entry.box;
+    for (auto const &link : model->GetLinks())
+    {
+      if (!link)
+        continue;
+
+      const ignition::math::Vector3d pos = link->WorldPose().Pos();
+      entry.bounds.Min().Min(pos);
+      entry.bounds.Max().Max(pos);
+    }
+    this->entries.push_back(entry);
+
+    // The bounding box of a model does not contain its nested models
+    this->AddModels(model->NestedModels());
+  }
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndexPrivate::Build()
+{
+  this->nodes.clear();
+  this->indices.clear();
+
+  this->unbounded.clear();
+
+  // Models without links have empty bounds and are never found. Models
+  // with infinite bounds, such as planes, would make the bounds of the
+  // nodes meaningless, so they are tested by every query instead.
+  for (unsigned int i = 0; i < this->entries.size(); ++i)
+  {
+    const ignition::math::AxisAlignedBox &b = this->entries[i].bounds;
+    if (!(b.Min().X() <= b.Max().X()))
+      continue;
+
+    if (b.Min().IsFinite() && b.Max().IsFinite())
+      this->indices.push_back(i);
+    else
+      this->unbounded.push_back(i);
+  }
+  if (this->indices.empty())
+    return;
+
+  this->nodes.reserve(2 * this->indices.size());
+  this->nodes.emplace_back();
+  this->Split(0, 0, this->indices.size());
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndexPrivate::Split(const size_t _node, const size_t _begin,
+    const size_t _end)
+{
+  ignition::math::AxisAlignedBox bounds = EmptyBox();
+  ignition::math::AxisAlignedBox centers = EmptyBox();
+  for (size_t i = _begin; i < _end; ++i)
+  {
+    const ignition::math::AxisAlignedBox &b =
+        this->entries[this->indices[i]].bounds;
+    bounds += b;
+
+    const ignition::math::Vector3d center(
+        Center(b, 0), Center(b, 1), Center(b, 2));
+    centers.Min().Min(center);
+    centers.Max().Max(center);
+  }
+  this->nodes[_node].bounds = bounds;
+
+  if (_end - _begin <= IndexLeafSize)
+  {
+    this->nodes[_node].first = _begin;
+    this->nodes[_node].count = _end - _begin;
+    return;
+  }
+
+  int axis = 0;
+  for (int a = 1; a < 3; ++a)
+  {
+    if (centers.Max()[a] - centers.Min()[a] >
+        centers.Max()[axis] - centers.Min()[axis])
+    {
+      axis = a;
+    }
+  }
+
+  const size_t mid = (_begin + _end) / 2;
+  std::nth_element(this->indices.begin() + _begin,
+      this->indices.begin() + mid, this->indices.begin() + _end,
+      [&](const unsigned int _a, const unsigned int _b)
+      {
+        return Center(this->entries[_a].bounds, axis) <
+               Center(this->entries[_b].bounds, axis);
+      });
+
+  const size_t left = this->nodes.size();
+  this->nodes.emplace_back();
+  this->nodes.emplace_back();
+  this->nodes[_node].first = left;
+  this->nodes[_node].count = 0;
+
+  this->Split(left, _begin, mid);
+  this->Split(left + 1, mid, _end);
+}
+
+//////////////////////////////////////////////////
+ModelSpatialIndex::ModelSpatialIndex()
+  : dataPtr(new ModelSpatialIndexPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ModelSpatialIndex::~ModelSpatialIndex()
+{
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndex::MarkDirty()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->dirty = true;
+  this->dataPtr->entries.clear();
+  this->dataPtr->nodes.clear();
+  this->dataPtr->indices.clear();
+  this->dataPtr->unbounded.clear();
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndex::Update(const Model_V &_models,
+    const uint64_t _iteration)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->dirty && this->dataPtr->iteration == _iteration)
+    return;
+
+  this->dataPtr->entries.clear();
+  this->dataPtr->AddModels(_models);
+  this->dataPtr->Build();
+
+  this->dataPtr->iteration = _iteration;
+  this->dataPtr->dirty = false;
+}
+
+//////////////////////////////////////////////////
+size_t ModelSpatialIndex::ModelCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->entries.size();
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndex::Intersect(const ignition::math::AxisAlignedBox &_box,
+    Model_V &_models) const
+{
+  _models.clear();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Traverse(
+      [&](const ignition::math::AxisAlignedBox &_bounds)
+      {
+        return _bounds.Intersects(_box);
+      },
+      [&](const unsigned int _index)
+      {
+        const IndexEntry &entry = this->dataPtr->entries[_index];
+        if (entry.bounds.Intersects(_box))
+          _models.push_back(entry.model);
+      });
+}
+
+//////////////////////////////////////////////////
+void ModelSpatialIndex::Intersect(const ignition::math::Frustum &_frustum,
+    Model_V &_models) const
+{
+  _models.clear();
+
+  // A box outside the frustum has a separating plane, which also
+  // separates every box it contains, so whole subtrees can be skipped.
+  std::vector<unsigned int> found;
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Traverse(
+      [&](const ignition::math::AxisAlignedBox &_bounds)
+      {
+        return _frustum.Contains(_bounds);
+      },
+      [&](const unsigned int _index)
+      {
+        if (_frustum.Contains(this->dataPtr->entries[_index].box))
+          found.push_back(_index);
+      });
+
+  // Report the models in the order of the walk of the world
+  std::sort(found.begin(), found.end());
+  _models.reserve(found.size());
+  for (auto const index : found)
+    _models.push_back(this->dataPtr->entries[index].model);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_MODELSPATIALINDEX_HH_
+#define GAZEBO_PHYSICS_MODELSPATIALINDEX_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class ModelSpatialIndexPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class ModelSpatialIndex ModelSpatialIndex.hh physics/physics.hh
+    /// \brief World owned bounding volume hierarchy over the bounding boxes
+    /// of the models, nested models included, for sensors that look for
+    /// the models in a region, such as the logical camera and the RFID
+    /// sensor.
+    ///
+    /// The hierarchy is rebuilt at most once per world iteration, by the
+    /// first query of the iteration, and when models are inserted or
+    /// removed. Models moved while the world is paused are only seen at
+    /// the next iteration. Every function can be called from any thread.
+    /// See World::ModelIndex.
+    class GZ_PHYSICS_VISIBLE ModelSpatialIndex
+    {
+      /// \brief Constructor.
+      public: ModelSpatialIndex();
+
+      /// \brief Destructor.
+      public: ~ModelSpatialIndex();
+
+      /// \brief Mark the index as outdated and release its models. The
+      /// hierarchy is rebuilt on the next Update. Called by the world when
+      /// models are inserted or removed.
+      public: void MarkDirty();
+
+      /// \brief Rebuild the hierarchy, unless it was already built for this
+      /// iteration.
+      /// \param[in] _models Top level models of the world.
+      /// \param[in] _iteration Current world iteration.
+      public: void Update(const Model_V &_models, const uint64_t _iteration);
+
+      /// \brief Number of models in the index, nested models included.
+      /// \return Number of models.
+      public: size_t ModelCount() const;
+
+      /// \brief Get the models whose bounds intersect a box. The bounds of
+      /// a model contain the bounding boxes and the origins of its links.
+      /// \param[in] _box Box in the world frame.
+      /// \param[out] _models The models, in no particular order.
+      public: void Intersect(const ignition::math::AxisAlignedBox &_box,
+                  Model_V &_models) const;
+
+      /// \brief Get the models whose bounding box, as returned by
+      /// Model::BoundingBox, passes ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Frustum in the world frame.
+      /// \param[out] _models The models, in the order of a depth first walk
+      /// of World::Models and Model::NestedModels.
+      public: void Intersect(const ignition::math::Frustum &_frustum,
+                  Model_V &_models) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ModelSpatialIndexPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
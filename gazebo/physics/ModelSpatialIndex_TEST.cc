@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ModelSpatialIndex.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ModelSpatialIndexTest : public ServerFixture {};
+
+/////////////////////////////////////////////////
+/// \brief Check whether a list of models has a model.
+/// \param[in] _models The models.
+/// \param[in] _name Name of the model.
+/// \return True if found.
+static bool HasModel(const physics::Model_V &_models,
+    const std::string &_name)
+{
+  for (auto const &model : _models)
+  {
+    if (model->GetName() == _name)
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+TEST_F(ModelSpatialIndexTest, Intersect)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  physics::ModelSpatialIndex &index = world->ModelIndex();
+
+  // Ground plane, box, sphere and cylinder
+  EXPECT_EQ(4u, index.ModelCount());
+
+  // A small box around the sphere. The ground plane has infinite bounds.
+  physics::Model_V models;
+  index.Intersect(ignition::math::AxisAlignedBox(
+        ignition::math::Vector3d(-0.1, 1.4, 0.4),
+        ignition::math::Vector3d(0.1, 1.6, 0.6)), models);
+  EXPECT_TRUE(HasModel(models, "sphere"));
+  EXPECT_FALSE(HasModel(models, "box"));
+  EXPECT_FALSE(HasModel(models, "cylinder"));
+
+  // Far away from the shapes
+  index.Intersect(ignition::math::AxisAlignedBox(
+        ignition::math::Vector3d(50, 50, 10),
+        ignition::math::Vector3d(51, 51, 11)), models);
+  EXPECT_FALSE(HasModel(models, "sphere"));
+  EXPECT_FALSE(HasModel(models, "box"));
+  EXPECT_FALSE(HasModel(models, "cylinder"));
+
+  // Camera at the origin, 5 m up, looking down at the box
+  ignition::math::Frustum frustum;
+  frustum.SetNear(0.1);
+  frustum.SetFar(10);
+  frustum.SetFOV(IGN_DTOR(20));
+  frustum.SetAspectRatio(1);
+  frustum.SetPose(ignition::math::Pose3d(0, 0, 5, 0, IGN_PI_2, 0));
+
+  index.Intersect(frustum, models);
+  EXPECT_TRUE(HasModel(models, "box"));
+  EXPECT_FALSE(HasModel(models, "sphere"));
+  EXPECT_FALSE(HasModel(models, "cylinder"));
+
+  // Same result as testing every model
+  physics::Model_V expected;
+  for (auto const &model : world->Models())
+  {
+    if (frustum.Contains(model->BoundingBox()))
+      expected.push_back(model);
+  }
+  EXPECT_EQ(expected, models);
+
+  // Moving a model is seen after the next iteration
+  world->ModelByName("sphere")->SetWorldPose(
+      ignition::math::Pose3d(0.2, 0.2, 0.5, 0, 0, 0));
+  world->Step(1);
+  world->ModelIndex().Intersect(frustum, models);
+  EXPECT_TRUE(HasModel(models, "sphere"));
+
+  // Removing a model releases it
+  world->RemoveModel("sphere");
+  EXPECT_EQ(3u, world->ModelIndex().ModelCount());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
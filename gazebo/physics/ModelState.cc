@@ -24,6 +24,16 @@
 using namespace gazebo;
 using namespace physics;
 
+/////////////////////////////////////////////////
+/// \brief Check whether a model uses the compact representation of static
+/// models, whose state is only a pose and a scale.
+/// \param[in] _model The model.
+/// \return True if the links and nested models have no state.
+static bool IsCompactStatic(const ModelPtr &_model)
+{
+  return _model->IsStatic() && _model->GetWorld()->CompactStaticModels();
+}
+
 /////////////////////////////////////////////////
 ModelState::ModelState()
 : State()
@@ -38,6 +48,9 @@ ModelState::ModelState(const ModelPtr _model, const common::Time &_realTime,
   this->pose = _model->WorldPose();
   this->scale = _model->Scale();
 
+  if (IsCompactStatic(_model))
+    return;
+
   // Copy all the links
   const Link_V links = _model->GetLinks();
   for (Link_V::const_iterator iter = links.begin(); iter != links.end(); ++iter)
@@ -71,6 +84,9 @@ ModelState::ModelState(const ModelPtr _model)
   this->pose = _model->WorldPose();
   this->scale = _model->Scale();
 
+  if (IsCompactStatic(_model))
+    return;
+
   // Copy all the links
   const Link_V links = _model->GetLinks();
   for (Link_V::const_iterator iter = links.begin(); iter != links.end(); ++iter)
@@ -122,6 +138,11 @@ void ModelState::Load(const ModelPtr _model, const common::Time &_realTime,
 
   // Load all the links
   this->linkStates.clear();
+  this->modelStates.clear();
+
+  if (IsCompactStatic(_model))
+    return;
+
   const Link_V links = _model->GetLinks();
   for (Link_V::const_iterator iter = links.begin(); iter != links.end(); ++iter)
   {
@@ -130,7 +151,6 @@ void ModelState::Load(const ModelPtr _model, const common::Time &_realTime,
   }
 
   // Load all the models
-  this->modelStates.clear();
   for (const auto &m : _model->NestedModels())
   {
     this->modelStates[m->GetName()].Load(m, _realTime, _simTime, _iterations);
@@ -256,6 +276,25 @@ bool ModelState::IsZero() const
       this->scale == ignition::math::Vector3d::Zero;
 }
 
+/////////////////////////////////////////////////
+bool ModelState::IsZero(const double _tolerance) const
+{
+  for (auto const &linkState : this->linkStates)
+  {
+    if (!linkState.second.IsZero(_tolerance))
+      return false;
+  }
+
+  for (auto const &ms : this->modelStates)
+  {
+    if (!ms.second.IsZero(_tolerance))
+      return false;
+  }
+
+  return IsNearZero(this->pose, _tolerance) &&
+      this->scale.Length() <= _tolerance;
+}
+
 /////////////////////////////////////////////////
 unsigned int ModelState::GetLinkStateCount() const
 {
@@ -106,6 +106,13 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Return true if the values in the state are within a
+      /// tolerance of zero.
+      /// \param[in] _tolerance Tolerance on positions in meters, on rotation
+      /// angles in radians and on scale factors.
+      /// \return True if the values in the state are within the tolerance.
+      public: bool IsZero(const double _tolerance) const;
+
       /// \brief Get the number of link states.
       ///
       /// This returns the number of Links recorded.
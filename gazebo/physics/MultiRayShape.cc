@@ -14,19 +14,78 @@
  * limitations under the License.
  *
 */
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "gazebo/common/Exception.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Link.hh"
 #include "gazebo/physics/MultiRayShape.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/RayQuery.hh"
+#include "gazebo/physics/World.hh"
+
+/// \internal
+/// \brief Private data for the MultiRayShape class.
+class gazebo::physics::MultiRayShapePrivate
+{
+  /// \brief True to cast the rays with the shared ray query.
+  public: bool batched = false;
+
+  /// \brief Start points of the rays, for the shared ray query.
+  public: std::vector<ignition::math::Vector3d> batchStarts;
+
+  /// \brief End points of the rays, for the shared ray query.
+  public: std::vector<ignition::math::Vector3d> batchEnds;
+
+  /// \brief Hit distances of the rays, for the shared ray query.
+  public: std::vector<double> batchDistances;
+
+  /// \brief Hit collision indices of the rays, for the shared ray query.
+  public: std::vector<int> batchHits;
+
+  /// \brief Hit laser retro values of the rays, for the shared ray query.
+  public: std::vector<double> batchRetros;
+};
 
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Private data of the multi-ray shapes, by shape. It is kept out
+  /// of MultiRayShape so that the layout of the class doesn't change.
+  class MultiRayShapePrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the shapes.
+    public: static MultiRayShapePrivates &Instance()
+    {
+      static MultiRayShapePrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by shape.
+    public: std::unordered_map<const MultiRayShape *,
+            std::unique_ptr<MultiRayShapePrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 MultiRayShape::MultiRayShape(CollisionPtr _parent)
 : Shape(_parent)
 {
   this->AddType(MULTIRAY_SHAPE);
   this->SetName("multiray");
+
+  MultiRayShapePrivates &privates = MultiRayShapePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new MultiRayShapePrivate);
 }
 
 //////////////////////////////////////////////////
@@ -39,6 +98,18 @@ MultiRayShape::MultiRayShape(PhysicsEnginePtr /*_physicsEngine*/)
 MultiRayShape::~MultiRayShape()
 {
   this->rays.clear();
+
+  MultiRayShapePrivates &privates = MultiRayShapePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+MultiRayShapePrivate *MultiRayShape::MultiRayShapeData() const
+{
+  MultiRayShapePrivates &privates = MultiRayShapePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -167,6 +238,13 @@ int MultiRayShape::GetFiducial(unsigned int _index)
 //////////////////////////////////////////////////
 void MultiRayShape::Update()
 {
+  if (this->MultiRayShapeData()->batched && this->UpdateRaysBatched())
+  {
+    // for plugin
+    this->newLaserScans();
+    return;
+  }
+
   // The measurable range is (max-min)
   double fullRange = this->GetMaxRange() - this->GetMinRange();
 
@@ -189,6 +267,91 @@ void MultiRayShape::Update()
   this->newLaserScans();
 }
 
+//////////////////////////////////////////////////
+void MultiRayShape::SetBatched(const bool _batched)
+{
+  this->MultiRayShapeData()->batched = _batched;
+}
+
+//////////////////////////////////////////////////
+bool MultiRayShape::Batched() const
+{
+  return this->MultiRayShapeData()->batched;
+}
+
+//////////////////////////////////////////////////
+bool MultiRayShape::UpdateRaysBatched()
+{
+  WorldPtr world = this->GetWorld();
+  if (!world || !world->Physics())
+    return false;
+
+  // Like the engines, the relative points of the rays are in the link
+  // frame, and a stand alone shape uses them as global points.
+  const Link *link = this->collisionParent ?
+      this->collisionParent->GetLink().get() : nullptr;
+  ignition::math::Pose3d pose;
+
+  // The snapshot is immutable, so no lock against physics is needed.
+  if (world->RayQuerySnapshotEnabled())
+  {
+    std::shared_ptr<const RayQuery> snapshot = world->RayQuerySnapshot();
+    if (snapshot && (!link || snapshot->LinkPose(link, pose)))
+    {
+      this->CastBatched(*snapshot, pose);
+      return true;
+    }
+  }
+
+  boost::recursive_mutex::scoped_lock lock(
+      *world->Physics()->GetPhysicsUpdateMutex());
+
+  RayQuery &query = world->SharedRayQuery();
+  if (!query.Update(world->Models(), world->Iterations()))
+    return false;
+
+  if (link)
+    pose = link->WorldPose();
+  this->CastBatched(query, pose);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MultiRayShape::CastBatched(const RayQuery &_query,
+    const ignition::math::Pose3d &_pose)
+{
+  MultiRayShapePrivate *data = this->MultiRayShapeData();
+  const double fullRange = this->GetMaxRange() - this->GetMinRange();
+
+  const size_t raySize = this->rays.size();
+  data->batchStarts.resize(raySize);
+  data->batchEnds.resize(raySize);
+  for (size_t i = 0; i < raySize; ++i)
+  {
+    this->rays[i]->SetLength(fullRange);
+    this->rays[i]->SetRetro(0.0);
+
+    ignition::math::Vector3d start, end;
+    this->rays[i]->RelativePoints(start, end);
+    data->batchStarts[i] = _pose.CoordPositionAdd(start);
+    data->batchEnds[i] = _pose.CoordPositionAdd(end);
+  }
+
+  _query.CastRays(data->batchStarts, data->batchEnds,
+      data->batchDistances, data->batchHits, &data->batchRetros);
+
+  for (size_t i = 0; i < raySize; ++i)
+  {
+    if (data->batchHits[i] >= 0 && data->batchDistances[i] < fullRange)
+    {
+      this->rays[i]->SetLength(data->batchDistances[i]);
+      this->rays[i]->SetRetro(data->batchRetros[i]);
+      this->rays[i]->SetCollisionName(
+          _query.CollisionName(data->batchHits[i]));
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 bool MultiRayShape::SetRay(const unsigned int _rayIndex,
     const ignition::math::Vector3d &_start,
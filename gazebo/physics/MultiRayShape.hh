@@ -30,6 +30,8 @@ namespace gazebo
 {
   namespace physics
   {
+    class MultiRayShapePrivate;
+
     /// \addtogroup gazebo_physics
     /// \{
 
@@ -127,6 +129,20 @@ namespace gazebo
       /// \brief Update the ray collisions.
       public: void Update();
 
+      /// \brief Cast the rays with the shared ray query of the world
+      /// instead of the physics engine. The engine is still used if the
+      /// world has collision shapes that the query does not support.
+      /// When the world publishes ray query snapshots, the rays are cast
+      /// with the latest snapshot without locking the physics engine.
+      /// \param[in] _batched True to use the shared ray query.
+      /// \sa World::SharedRayQuery
+      /// \sa World::SetRayQuerySnapshotEnabled
+      public: void SetBatched(const bool _batched);
+
+      /// \brief Get whether the rays are cast with the shared ray query.
+      /// \return True if the shared ray query is used.
+      public: bool Batched() const;
+
       /// \TODO This function is not implemented.
       /// \brief Fill a message with this shape's values.
       /// \param[out] _msg Message that contains the shape's values.
@@ -203,6 +219,22 @@ namespace gazebo
       /// \brief New laser scans event.
       protected: event::EventT<void()> newLaserScans;
 
+      /// \brief Cast the rays with the ray query snapshot of the world if
+      /// there is one, or else with the shared ray query.
+      /// \return False if the query can not be used, in which case the
+      /// rays are left untouched.
+      private: bool UpdateRaysBatched();
+
+      /// \brief Cast the rays with a ray query and store the results.
+      /// \param[in] _query Query to cast the rays with.
+      /// \param[in] _pose World pose of the frame of the ray points.
+      private: void CastBatched(const RayQuery &_query,
+                   const ignition::math::Pose3d &_pose);
+
+      /// \brief Get the private data of the shape.
+      /// \return The private data, see MultiRayShapePrivate.
+      private: MultiRayShapePrivate *MultiRayShapeData() const;
+
       /// \brief Min range of a ray
       private: double minRange = 0;
 
@@ -15,6 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/lexical_cast.hpp>
 
 #include <sdf/sdf.hh>
@@ -28,15 +32,52 @@
 #include "gazebo/transport/Node.hh"
 
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/Joint.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/PhysicsEnginePrivate.hh"
 #include "gazebo/physics/PresetManager.hh"
+#include "gazebo/physics/SleepManager.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Append the links of a model and its nested models.
+  /// \param[in] _model The model.
+  /// \param[out] _links Links are appended here.
+  void SnapshotLinks(const ModelPtr &_model, Link_V &_links)
+  {
+    const Link_V &links = _model->GetLinks();
+    _links.insert(_links.end(), links.begin(), links.end());
+    for (auto const &nested : _model->NestedModels())
+      SnapshotLinks(nested, _links);
+  }
+
+  /// \brief Private data of the engines, by engine. It is kept out of
+  /// PhysicsEngine so that the layout of the class doesn't change.
+  class EnginePrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the engines.
+    public: static EnginePrivates &Instance()
+    {
+      static EnginePrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by engine.
+    public: std::unordered_map<const PhysicsEngine *,
+            std::unique_ptr<PhysicsEnginePrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 PhysicsEngine::PhysicsEngine(WorldPtr _world)
   : world(_world)
@@ -64,6 +105,16 @@ PhysicsEngine::PhysicsEngine(WorldPtr _world)
   // Create and initialized the contact manager.
   this->contactManager = new ContactManager();
   this->contactManager->Init(this->world);
+
+  PhysicsEnginePrivate *data = new PhysicsEnginePrivate;
+  {
+    EnginePrivates &privates = EnginePrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(data);
+  }
+
+  data->sleepManager = new SleepManager();
+  data->sleepManager->Init(this->world);
 }
 
 //////////////////////////////////////////////////
@@ -99,6 +150,20 @@ void PhysicsEngine::Fini()
     this->sdf.reset();
   }
 
+  PhysicsEnginePrivate *data = this->EngineData();
+  {
+    std::lock_guard<std::mutex> lock(data->jointWrenchesMutex);
+    data->wrenchJoints.clear();
+    data->jointWrenches.clear();
+    data->pendingWrenchJoints.clear();
+  }
+
+  if (data->sleepManager)
+  {
+    delete data->sleepManager;
+    data->sleepManager = NULL;
+  }
+
   if (this->contactManager)
   {
     delete this->contactManager;
@@ -118,6 +183,18 @@ void PhysicsEngine::Fini()
 PhysicsEngine::~PhysicsEngine()
 {
   this->Fini();
+
+  EnginePrivates &privates = EnginePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+PhysicsEnginePrivate *PhysicsEngine::EngineData() const
+{
+  EnginePrivates &privates = EnginePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -243,6 +320,33 @@ bool PhysicsEngine::SetParam(const std::string &_key,
       this->world->SetMagneticField(
           any_cast<ignition::math::Vector3d>(copy));
     }
+    else if (_key == "sleep_enabled")
+      this->SleepMgr()->SetEnabled(any_cast<bool>(_value));
+    else if (_key == "sleep_linear_threshold")
+    {
+      this->SleepMgr()->SetThresholds(any_cast<double>(_value),
+          this->SleepMgr()->AngularThreshold());
+    }
+    else if (_key == "sleep_angular_threshold")
+    {
+      this->SleepMgr()->SetThresholds(
+          this->SleepMgr()->LinearThreshold(), any_cast<double>(_value));
+    }
+    else if (_key == "sleep_time")
+      this->SleepMgr()->SetSleepTime(any_cast<double>(_value));
+    else if (_key == "heightmap_tile_paging")
+      this->EngineData()->heightmapTilePaging = any_cast<bool>(_value);
+    else if (_key == "heightmap_tile_cache_size")
+    {
+      int value = any_cast<int>(_value);
+      if (value < 1)
+      {
+        gzerr << "heightmap_tile_cache_size must be at least 1" << std::endl;
+        return false;
+      }
+      this->EngineData()->heightmapTileCacheSize =
+          static_cast<unsigned int>(value);
+    }
     else
     {
       gzwarn << "SetParam failed for [" << _key << "] in physics engine "
@@ -295,6 +399,18 @@ bool PhysicsEngine::GetParam(const std::string &_key,
     _value = this->world->Gravity();
   else if (_key == "magnetic_field")
     _value = this->world->MagneticField();
+  else if (_key == "sleep_enabled")
+    _value = this->SleepMgr()->Enabled();
+  else if (_key == "sleep_linear_threshold")
+    _value = this->SleepMgr()->LinearThreshold();
+  else if (_key == "sleep_angular_threshold")
+    _value = this->SleepMgr()->AngularThreshold();
+  else if (_key == "sleep_time")
+    _value = this->SleepMgr()->SleepTime();
+  else if (_key == "heightmap_tile_paging")
+    _value = this->EngineData()->heightmapTilePaging;
+  else if (_key == "heightmap_tile_cache_size")
+    _value = static_cast<int>(this->EngineData()->heightmapTileCacheSize);
   else
   {
     gzwarn << "GetParam failed for [" << _key << "] in physics engine "
@@ -311,6 +427,125 @@ ContactManager *PhysicsEngine::GetContactManager() const
   return this->contactManager;
 }
 
+//////////////////////////////////////////////////
+void PhysicsEngine::SetContactCallback(const Collision *_collision,
+    const ContactCallback &_callback)
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+  if (_callback)
+    data->contactCallbacks[_collision] = _callback;
+  else
+    data->contactCallbacks.erase(_collision);
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RunContactCallbacks(Collision *_collision1,
+    Collision *_collision2, ContactPoint *_points,
+    const unsigned int _count) const
+{
+  const auto &callbacks = this->EngineData()->contactCallbacks;
+  if (callbacks.empty())
+    return false;
+
+  bool called = false;
+  auto it = callbacks.find(_collision1);
+  if (it != callbacks.end())
+  {
+    it->second(_collision1, _collision2, _points, _count);
+    called = true;
+  }
+
+  it = callbacks.find(_collision2);
+  if (it != callbacks.end())
+  {
+    it->second(_collision1, _collision2, _points, _count);
+    called = true;
+  }
+
+  return called;
+}
+
+//////////////////////////////////////////////////
+unsigned int PhysicsEngine::AddJointWrenchMonitor(const JointPtr &_joint)
+{
+  _joint->SetProvideFeedback(true);
+
+  PhysicsEnginePrivate *data = this->EngineData();
+  std::lock_guard<std::mutex> lock(data->jointWrenchesMutex);
+
+  // Reuse a free slot
+  for (unsigned int i = 0; i < data->wrenchJoints.size(); ++i)
+  {
+    if (!data->wrenchJoints[i])
+    {
+      data->wrenchJoints[i] = _joint;
+      data->jointWrenches[i] = JointWrench();
+      return i;
+    }
+  }
+
+  data->wrenchJoints.push_back(_joint);
+  data->jointWrenches.push_back(JointWrench());
+  return data->wrenchJoints.size() - 1;
+}
+
+//////////////////////////////////////////////////
+void PhysicsEngine::RemoveJointWrenchMonitor(const unsigned int _index)
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+  std::lock_guard<std::mutex> lock(data->jointWrenchesMutex);
+  if (_index < data->wrenchJoints.size())
+    data->wrenchJoints[_index].reset();
+}
+
+//////////////////////////////////////////////////
+JointWrench PhysicsEngine::MonitoredJointWrench(
+    const unsigned int _index) const
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+  std::lock_guard<std::mutex> lock(data->jointWrenchesMutex);
+  if (_index >= data->jointWrenches.size())
+    return JointWrench();
+  return data->jointWrenches[_index];
+}
+
+//////////////////////////////////////////////////
+void PhysicsEngine::UpdateJointWrenches()
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+
+  // Sensors add and remove monitors from their own thread
+  {
+    std::lock_guard<std::mutex> lock(data->jointWrenchesMutex);
+    if (data->wrenchJoints.empty())
+      return;
+    data->pendingWrenchJoints = data->wrenchJoints;
+  }
+
+  const Joint_V &joints = data->pendingWrenchJoints;
+  data->pendingJointWrenches.resize(joints.size());
+  for (size_t i = 0; i < joints.size(); ++i)
+  {
+    if (joints[i])
+      data->pendingJointWrenches[i] = joints[i]->GetForceTorque(0u);
+  }
+
+  // Joints added meanwhile keep a zero wrench until the next update
+  std::lock_guard<std::mutex> lock(data->jointWrenchesMutex);
+  const size_t count = std::min(joints.size(), data->wrenchJoints.size());
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (data->wrenchJoints[i] == joints[i])
+      data->jointWrenches[i] = data->pendingJointWrenches[i];
+  }
+}
+
+//////////////////////////////////////////////////
+SleepManager *PhysicsEngine::SleepMgr() const
+{
+  return this->EngineData()->sleepManager;
+}
+
 //////////////////////////////////////////////////
 sdf::ElementPtr PhysicsEngine::GetSDF() const
 {
@@ -322,3 +557,93 @@ WorldPtr PhysicsEngine::World() const
 {
   return this->world;
 }
+
+//////////////////////////////////////////////////
+void PhysicsEngine::SetSnapshotFunctions(
+    const std::function<void (std::vector<double> &)> &_save,
+    const std::function<bool (const std::vector<double> &)> &_restore)
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+  data->saveSnapshot = _save;
+  data->restoreSnapshot = _restore;
+}
+
+//////////////////////////////////////////////////
+void PhysicsEngine::SaveSnapshot(std::vector<double> &_state) const
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+  if (data->saveSnapshot)
+  {
+    data->saveSnapshot(_state);
+    return;
+  }
+
+  // Layout: link count, then per link its id, world pose and velocities
+  Link_V links;
+  for (auto const &model : this->world->Models())
+    SnapshotLinks(model, links);
+
+  _state.reserve(_state.size() + 1 + links.size() * 14);
+  _state.push_back(static_cast<double>(links.size()));
+
+  for (auto const &link : links)
+  {
+    const ignition::math::Pose3d &pose = link->WorldPose();
+    const ignition::math::Vector3d linVel = link->WorldCoGLinearVel();
+    const ignition::math::Vector3d angVel = link->WorldAngularVel();
+
+    _state.insert(_state.end(), {static_cast<double>(link->GetId()),
+        pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+        pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(), pose.Rot().Z(),
+        linVel.X(), linVel.Y(), linVel.Z(),
+        angVel.X(), angVel.Y(), angVel.Z()});
+  }
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RestoreSnapshot(const std::vector<double> &_state)
+{
+  PhysicsEnginePrivate *data = this->EngineData();
+  if (data->restoreSnapshot)
+    return data->restoreSnapshot(_state);
+
+  Link_V links;
+  for (auto const &model : this->world->Models())
+    SnapshotLinks(model, links);
+
+  // Links are matched by id, so the order of the models doesn't matter
+  std::unordered_map<uint32_t, Link *> linksById;
+  for (auto const &link : links)
+    linksById[link->GetId()] = link.get();
+
+  if (_state.empty() || static_cast<size_t>(_state[0]) != links.size() ||
+      _state.size() != 1 + links.size() * 14)
+  {
+    gzerr << "Snapshot does not match the links of world ["
+          << this->world->Name() << "]\n";
+    return false;
+  }
+
+  const double *v = _state.data() + 1;
+  for (size_t i = 0; i < links.size(); ++i, v += 14)
+  {
+    if (linksById.find(static_cast<uint32_t>(v[0])) == linksById.end())
+    {
+      gzerr << "Snapshot link [" << static_cast<uint32_t>(v[0])
+            << "] is not in world [" << this->world->Name() << "]\n";
+      return false;
+    }
+  }
+
+  v = _state.data() + 1;
+  for (size_t i = 0; i < links.size(); ++i, v += 14)
+  {
+    Link *link = linksById[static_cast<uint32_t>(v[0])];
+    link->SetWorldPose(ignition::math::Pose3d(v[1], v[2], v[3],
+          v[4], v[5], v[6], v[7]));
+    link->SetLinearVel(ignition::math::Vector3d(v[8], v[9], v[10]));
+    link->SetAngularVel(ignition::math::Vector3d(v[11], v[12], v[13]));
+  }
+
+  return true;
+}
@@ -19,12 +19,16 @@
 
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/any.hpp>
+#include <functional>
 #include <string>
+#include <vector>
 #include <ignition/transport/Node.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
 
+#include "gazebo/physics/ContactPoint.hh"
+#include "gazebo/physics/JointWrench.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/util/system.hh"
 
@@ -32,6 +36,9 @@ namespace gazebo
 {
   namespace physics
   {
+    // Forward declare private data class.
+    class PhysicsEnginePrivate;
+
     class ContactManager;
 
     /// \addtogroup gazebo_physics
@@ -215,6 +222,11 @@ namespace gazebo
       ///          (defined but not used in ode).
       ///       -# "max_step_size" (double) - maximum physics step size when
       ///          physics update step must return.
+      ///       -# "heightmap_tile_paging" (bool) - page the heights of the
+      ///          heightmaps initialized afterwards from disk, tile by tile,
+      ///          instead of keeping the full grid in memory. (ODE/Bullet)
+      ///       -# "heightmap_tile_cache_size" (int) - maximum number of
+      ///          resident tiles of each paged heightmap.
       ///
       /// \param[in] _value The value to set to
       /// \return true if SetParam is successful, false if operation fails.
@@ -238,6 +250,23 @@ namespace gazebo
       /// \brief Debug print out of the physic engine state.
       public: virtual void DebugPrint() const = 0;
 
+      /// \brief Append the dynamic state of the world to a buffer.
+      /// The generic implementation stores the world pose and velocities
+      /// of every link. Engines replace it with SetSnapshotFunctions to
+      /// capture their internal state (e.g. solver warm start) so that a
+      /// restore reproduces the next steps exactly.
+      /// \param[out] _state Buffer the state is appended to.
+      /// \sa World::SaveSnapshot
+      public: void SaveSnapshot(std::vector<double> &_state) const;
+
+      /// \brief Restore a state saved with SaveSnapshot. No entity is
+      /// created, destroyed or reloaded, so the world must contain the same
+      /// links as when the snapshot was taken.
+      /// \param[in] _state State written by SaveSnapshot.
+      /// \return False if the state does not match the current world.
+      /// \sa World::RestoreSnapshot
+      public: bool RestoreSnapshot(const std::vector<double> &_state);
+
       /// \brief Get a pointer to the world.
       /// \return Pointer to the world.
       public: WorldPtr World() const;
@@ -246,6 +275,47 @@ namespace gazebo
       /// \return Pointer to the contact manager.
       public: ContactManager *GetContactManager() const;
 
+      /// \brief Set a callback that modifies the contact points of a
+      /// collision before the solve, e.g. to change their friction
+      /// directions. It's called during UpdateCollision, for the contacts
+      /// that constrain the collision, without needing contact messages
+      /// or ContactManager::SetNeverDropContacts. Call this from the
+      /// physics thread, e.g. in a plugin's Init, or with the physics update
+      /// mutex locked.
+      /// \param[in] _collision The collision.
+      /// \param[in] _callback The callback, or an empty callback to remove
+      /// the callback of the collision.
+      /// \sa ContactPoint
+      public: void SetContactCallback(const Collision *_collision,
+                                      const ContactCallback &_callback);
+
+      /// \brief Gather the wrench of a joint once per physics update, in
+      /// the same frames as Joint::GetForceTorque, e.g. for force torque
+      /// sensors. The wrenches of all the monitored joints are computed in a
+      /// single pass after the link poses are updated, and kept in a
+      /// preallocated array. This enables the feedback of the joint.
+      /// \param[in] _joint The joint.
+      /// \return Index of the wrench, see MonitoredJointWrench.
+      public: unsigned int AddJointWrenchMonitor(const JointPtr &_joint);
+
+      /// \brief Stop gathering the wrench of a joint.
+      /// \param[in] _index Index returned by AddJointWrenchMonitor.
+      public: void RemoveJointWrenchMonitor(const unsigned int _index);
+
+      /// \brief Get the wrench of a monitored joint, as of the last physics
+      /// update. It can be called from any thread.
+      /// \param[in] _index Index returned by AddJointWrenchMonitor.
+      /// \return The wrench, zero before the first update.
+      public: JointWrench MonitoredJointWrench(const unsigned int _index) const;
+
+      /// \brief Gather the wrenches of the monitored joints. Called by the
+      /// world after each physics update, once the link poses are updated.
+      public: void UpdateJointWrenches();
+
+      /// \brief Get the engine independent sleeping policy.
+      /// \return Pointer to the sleep manager.
+      public: SleepManager *SleepMgr() const;
+
       /// \brief returns a pointer to the PhysicsEngine#physicsUpdateMutex.
       /// \return Pointer to the physics mutex.
       public: boost::recursive_mutex *GetPhysicsUpdateMutex() const
@@ -280,6 +350,34 @@ namespace gazebo
         }
       }
 
+      /// \brief Replace the generic SaveSnapshot and RestoreSnapshot with
+      /// the ones of the engine. Call this from the constructor of the
+      /// engine.
+      /// \param[in] _save Appends the state of the engine to a buffer.
+      /// \param[in] _restore Restores a state written by _save, returns
+      /// false if it doesn't match the current world.
+      protected: void SetSnapshotFunctions(
+                     const std::function<void (std::vector<double> &)> &_save,
+                     const std::function<bool (const std::vector<double> &)>
+                     &_restore);
+
+      /// \internal
+      /// \brief Get the private data of the engine. It is kept out of the
+      /// class so that the layout of the class doesn't change.
+      /// \return The private data, valid until the engine is destroyed.
+      protected: PhysicsEnginePrivate *EngineData() const;
+
+      /// \brief Call the contact callbacks of two collisions.
+      /// \param[in] _collision1 First collision.
+      /// \param[in] _collision2 Second collision.
+      /// \param[in,out] _points Contact points between the collisions.
+      /// \param[in] _count Number of contact points.
+      /// \return True if a callback was called.
+      protected: bool RunContactCallbacks(Collision *_collision1,
+                                          Collision *_collision2,
+                                          ContactPoint *_points,
+                                          const unsigned int _count) const;
+
       /// \brief virtual callback for gztopic "~/request".
       /// \param[in] _msg Request message.
       protected: virtual void OnRequest(ConstRequestPtr &_msg);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_PHYSICSENGINEPRIVATE_HH_
+#define GAZEBO_PHYSICS_PHYSICSENGINEPRIVATE_HH_
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/physics/ContactPoint.hh"
+#include "gazebo/physics/JointWrench.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the PhysicsEngine class. It is kept out of
+    /// the class, see PhysicsEngine::EngineData, so that its layout doesn't
+    /// change.
+    class PhysicsEnginePrivate
+    {
+      /// \brief Puts idle models to sleep.
+      public: SleepManager *sleepManager = nullptr;
+
+      /// \brief Contact callbacks, by collision. Engines check that this is
+      /// not empty before looking up the collisions of a contact.
+      public: std::unordered_map<const Collision *, ContactCallback>
+              contactCallbacks;
+
+      /// \brief Joints whose wrench is gathered, null for free slots.
+      public: Joint_V wrenchJoints;
+
+      /// \brief Wrenches of the monitored joints, by index.
+      public: std::vector<JointWrench> jointWrenches;
+
+      /// \brief Copy of wrenchJoints used by UpdateJointWrenches.
+      public: Joint_V pendingWrenchJoints;
+
+      /// \brief Wrenches being gathered by UpdateJointWrenches, copied to
+      /// jointWrenches once complete.
+      public: std::vector<JointWrench> pendingJointWrenches;
+
+      /// \brief Protects wrenchJoints and jointWrenches.
+      public: mutable std::mutex jointWrenchesMutex;
+
+      /// \brief True to page the heights of heightmaps from disk, see the
+      /// "heightmap_tile_paging" parameter.
+      public: bool heightmapTilePaging = false;
+
+      /// \brief Maximum number of resident tiles of each paged heightmap.
+      public: unsigned int heightmapTileCacheSize = 256;
+
+      /// \brief Engine specific SaveSnapshot, empty for the generic one.
+      public: std::function<void (std::vector<double> &)> saveSnapshot;
+
+      /// \brief Engine specific RestoreSnapshot, empty for the generic one.
+      public: std::function<bool (const std::vector<double> &)>
+              restoreSnapshot;
+    };
+  }
+}
+#endif
@@ -78,6 +78,12 @@ physics::WorldPtr physics::get_world(const std::string &_name)
   gzthrow("Unable to find world by name in physics::get_world(world_name)");
 }
 
+/////////////////////////////////////////////////
+std::vector<physics::WorldPtr> physics::worlds()
+{
+  return g_worlds;
+}
+
 /////////////////////////////////////////////////
 bool physics::has_world(const std::string &_name)
 {
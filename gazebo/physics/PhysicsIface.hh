@@ -18,6 +18,7 @@
 #define _PHYSICSIFACE_HH_
 
 #include <string>
+#include <vector>
 #include <sdf/sdf.hh>
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -52,6 +53,11 @@ namespace gazebo
     GZ_PHYSICS_VISIBLE
     WorldPtr get_world(const std::string &_name = "");
 
+    /// \brief Get all the worlds loaded in this process.
+    /// \return The worlds, in creation order.
+    GZ_PHYSICS_VISIBLE
+    std::vector<WorldPtr> worlds();
+
     /// \brief checks if the world with this name exists.
     /// Can be used to check if get_world(const std::string&)
     /// will succeed or throw an exception.
@@ -41,6 +41,14 @@ namespace gazebo
     class Actor;
     class Light;
     class Link;
+    class LinkDataRegistry;
+    class FreezeRegistry;
+    class LinkStateCache;
+    class RayQuery;
+    class ModelSpatialIndex;
+    class ActivityZoneManager;
+    class UpdateScheduler;
+    class BatteryRegistry;
     class Collision;
     class FrictionPyramid;
     class Gripper;
@@ -48,6 +56,7 @@ namespace gazebo
     class JointController;
     class Contact;
     class PresetManager;
+    class SleepManager;
     class UserCmd;
     class UserCmdManager;
     class PhysicsEngine;
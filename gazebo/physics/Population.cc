@@ -106,32 +106,21 @@ bool Population::PopulateOne(const sdf::ElementPtr _population)
   sdf.SetFromString("<sdf version ='" + std::string(SDF_PROTOCOL_VERSION) +
     "'>" + params.modelSdf + "</sdf>");
 
+  // Clone the model once per pose, in a single batch.
+  std::vector<ignition::math::Pose3d> poses;
+  std::vector<std::string> names;
+  poses.reserve(objects.size());
+  names.reserve(objects.size());
   for (size_t i = 0; i < objects.size(); ++i)
   {
-    ignition::math::Vector3d p(objects[i].X(), objects[i].Y(), objects[i].Z());
-
-    // Create a unique model for each clone.
-    std::string cloneSdf = sdf.ToString();
-    std::string delim = "model name='";
-    size_t first = cloneSdf.find(delim) + delim.size();
-    size_t last = cloneSdf.find("'", first);
-    std::string newName = params.modelName + std::string("_clone_") +
-      boost::lexical_cast<std::string>(i);
-    cloneSdf.replace(first, last - first, newName);
-
-    // Insert the <pose> element.
-    std::string endDelim = "'>";
-    first = cloneSdf.find(delim) + delim.size();
-    last = cloneSdf.find(endDelim, first);
-    std::string pose = "\n    <pose>" +
-      boost::lexical_cast<std::string>(p.X()) + " " +
-      boost::lexical_cast<std::string>(p.Y()) + " " +
-      boost::lexical_cast<std::string>(p.Z()) + " 0 0 0</pose>";
-    cloneSdf.insert(last + endDelim.size(), pose);
-
-    this->dataPtr->world->InsertModelString(cloneSdf);
+    poses.push_back(ignition::math::Pose3d(objects[i].X(), objects[i].Y(),
+        objects[i].Z(), 0, 0, 0));
+    names.push_back(params.modelName + std::string("_clone_") +
+      boost::lexical_cast<std::string>(i));
   }
 
+  this->dataPtr->world->InsertModelInstances(sdf.ToString(), poses, names);
+
   return true;
 }
 
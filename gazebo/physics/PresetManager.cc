@@ -89,6 +89,49 @@ bool Preset::SetAllPhysicsParameters(PhysicsEnginePtr _physicsEngine) const
   return result;
 }
 
+//////////////////////////////////////////////////
+bool Preset::ApplyPhysicsParameters(PhysicsEnginePtr _physicsEngine)
+{
+  if (!_physicsEngine)
+  {
+    gzwarn << "Physics engine for PresetManager is NULL. PresetManager will "
+           << "have no effect on simulation!" << std::endl;
+    return false;
+  }
+
+  if (!this->dataPtr->blockDirty)
+  {
+    bool result = true;
+    for (auto const &param : this->dataPtr->block)
+      result = _physicsEngine->SetParam(param.first, param.second) && result;
+    return result;
+  }
+
+  // Set every parameter once, and keep the ones the engine accepts
+  bool result = true;
+  this->dataPtr->block.clear();
+  for (auto const &param : this->dataPtr->parameterMap)
+  {
+    // disable params we know can't be set
+    if (param.first == "type")
+      continue;
+
+    if (_physicsEngine->SetParam(param.first, param.second))
+    {
+      this->dataPtr->block.push_back(param);
+    }
+    else
+    {
+      gzwarn << "Couldn't set parameter [" << param.first
+        << "] in physics engine" << std::endl;
+      result = false;
+    }
+  }
+  this->dataPtr->blockDirty = false;
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 bool Preset::SetAllParamsFromSDF(const sdf::ElementPtr _elem)
 {
@@ -164,9 +207,14 @@ bool Preset::SetParam(const std::string &_key, const boost::any &_value)
   bool result = true;
 
   if (_key.empty())
+  {
     result = false;
+  }
   else
+  {
     this->dataPtr->parameterMap[_key] = _value;
+    this->dataPtr->blockDirty = true;
+  }
 
   return result;
 }
@@ -278,7 +326,7 @@ bool PresetManager::CurrentProfile(const std::string &_name)
 
     // For now, ignore the return value of this function, since not all
     // parameters are supported
-    this->CurrentPreset()->SetAllPhysicsParameters(
+    this->CurrentPreset()->ApplyPhysicsParameters(
         this->dataPtr->physicsEngine);
   }
 
@@ -291,6 +339,50 @@ std::string PresetManager::CurrentProfile() const
   return this->dataPtr->currentPreset;
 }
 
+//////////////////////////////////////////////////
+bool PresetManager::RequestProfile(const std::string &_name)
+{
+  if (_name.empty())
+    return false;
+
+  if (!this->HasProfile(_name))
+  {
+    gzwarn << "Profile [" << _name << "] not found." << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->pendingPresetMutex);
+  this->dataPtr->pendingPreset = _name;
+  this->dataPtr->hasPendingPreset = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string PresetManager::PendingProfile() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pendingPresetMutex);
+  return this->dataPtr->pendingPreset;
+}
+
+//////////////////////////////////////////////////
+bool PresetManager::ApplyPendingProfile()
+{
+  if (!this->dataPtr->hasPendingPreset)
+    return false;
+
+  std::string name;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->pendingPresetMutex);
+    name.swap(this->dataPtr->pendingPreset);
+    this->dataPtr->hasPendingPreset = false;
+  }
+
+  if (name.empty() || name == this->CurrentProfile())
+    return false;
+
+  return this->CurrentProfile(name);
+}
+
 //////////////////////////////////////////////////
 std::vector<std::string> PresetManager::AllProfiles() const
 {
@@ -75,6 +75,17 @@ namespace gazebo
       public: bool SetAllPhysicsParameters(PhysicsEnginePtr _physicsEngine)
           const;
 
+      /// \brief Set the parameters of this preset in the physics engine,
+      /// like SetAllPhysicsParameters. The first call keeps the parameters
+      /// the engine accepted in a flat block, and the next calls only set
+      /// those, until a parameter of the preset changes. Parameters the
+      /// engine can't set are then reported once, rather than at each
+      /// switch.
+      /// \param[in] _physicsEngine The physics engine in which to affect the
+      /// change.
+      /// \return True if setting all parameters was successful.
+      public: bool ApplyPhysicsParameters(PhysicsEnginePtr _physicsEngine);
+
       /// \brief Set all parameters of this preset based on the key/value pairs
       /// in the given SDF element.
       /// \param[in] _elem The physics SDF element from which to read values.
@@ -124,6 +135,26 @@ namespace gazebo
       /// \return The name of the current profile.
       public: std::string CurrentProfile() const;
 
+      /// \brief Request a switch to a profile at the next step boundary.
+      /// The world applies the profile at the start of its next update,
+      /// after the World Update Begin event, so that all the parameters
+      /// change between two steps. Can be called from any thread, for
+      /// example by a plugin switching between a coarse and a fine profile.
+      /// A later request replaces a pending one.
+      /// \param[in] _name The name of the profile.
+      /// \return False if there is no such profile.
+      public: bool RequestProfile(const std::string &_name);
+
+      /// \brief Get the name of the profile requested for the next step
+      /// boundary.
+      /// \return The name of the profile, empty if none.
+      public: std::string PendingProfile() const;
+
+      /// \brief Switch to the profile requested by RequestProfile, if any.
+      /// Called by the world between steps.
+      /// \return True if the profile was switched.
+      public: bool ApplyPendingProfile();
+
       /// \brief Get the name of all profiles.
       /// \return A vector containing all profile names.
       public: std::vector<std::string> AllProfiles() const;
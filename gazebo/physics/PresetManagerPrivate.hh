@@ -17,9 +17,12 @@
 #ifndef _GAZEBO_PHYSICS_PRESETMANAGER_PRIVATE_HH_
 #define _GAZEBO_PHYSICS_PRESETMANAGER_PRIVATE_HH_
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include "gazebo/physics/PhysicsEngine.hh"
 
 namespace gazebo
@@ -45,6 +48,13 @@ namespace gazebo
 
       /// \brief SDF for the physics element represented by this object
       public: sdf::ElementPtr elementSDF;
+
+      /// \brief Parameters accepted by the physics engine, see
+      /// Preset::ApplyPhysicsParameters
+      public: std::vector<std::pair<std::string, boost::any>> block;
+
+      /// \brief True if block must be built again
+      public: bool blockDirty = true;
     };
 
     class Preset;
@@ -64,6 +74,16 @@ namespace gazebo
 
       /// \brief Mutex to protect setting the current preset profile.
       public: std::mutex currentProfileMutex;
+
+      /// \brief Name of the preset requested for the next step boundary
+      public: std::string pendingPreset;
+
+      /// \brief True if pendingPreset is set, checked at each step without
+      /// locking
+      public: std::atomic<bool> hasPendingPreset{false};
+
+      /// \brief Mutex to protect pendingPreset.
+      public: mutable std::mutex pendingPresetMutex;
     };
   }
 }
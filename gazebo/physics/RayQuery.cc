@@ -0,0 +1,1128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/MeshShape.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PlaneShape.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/RayQuery.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Number of rays traced together.
+    static const int PacketSize = 4;
+
+    /// \brief Maximum number of primitives in a leaf of a hierarchy.
+    static const unsigned int LeafSize = 4;
+
+    /// \brief Depth of the traversal stack, enough for the balanced
+    /// hierarchies built by RayBVH.
+    static const int StackSize = 64;
+
+    /// \brief Directions components smaller than this are parallel.
+    static const double ParallelTol = 1e-12;
+
+    /// \internal
+    /// \brief Axis aligned bounding box.
+    class RayBounds
+    {
+      /// \brief Grow the box to contain a point.
+      /// \param[in] _p Point to add.
+      public: void Add(const ignition::math::Vector3d &_p)
+      {
+        for (int a = 0; a < 3; ++a)
+        {
+          this->min[a] = std::min(this->min[a], _p[a]);
+          this->max[a] = std::max(this->max[a], _p[a]);
+        }
+      }
+
+      /// \brief Grow the box to contain another box.
+      /// \param[in] _b Box to add.
+      public: void Add(const RayBounds &_b)
+      {
+        for (int a = 0; a < 3; ++a)
+        {
+          this->min[a] = std::min(this->min[a], _b.min[a]);
+          this->max[a] = std::max(this->max[a], _b.max[a]);
+        }
+      }
+
+      /// \brief Center of the box along an axis.
+      /// \param[in] _axis Axis index.
+      /// \return Center coordinate.
+      public: double Center(const int _axis) const
+      {
+        return 0.5 * (this->min[_axis] + this->max[_axis]);
+      }
+
+      /// \brief Minimum corner.
+      public: double min[3] = {ignition::math::MAX_D,
+          ignition::math::MAX_D, ignition::math::MAX_D};
+
+      /// \brief Maximum corner.
+      public: double max[3] = {-ignition::math::MAX_D,
+          -ignition::math::MAX_D, -ignition::math::MAX_D};
+    };
+
+    /// \internal
+    /// \brief Flat bounding volume hierarchy over a list of bounds.
+    class RayBVH
+    {
+      /// \brief A node of the hierarchy. Inner nodes have a zero count and
+      /// their children at first and first + 1.
+      public: class Node
+      {
+        /// \brief Bounds of everything below the node.
+        public: RayBounds bounds;
+
+        /// \brief First index of a leaf, or first child of an inner node.
+        public: unsigned int first = 0;
+
+        /// \brief Number of primitives of a leaf.
+        public: unsigned int count = 0;
+      };
+
+      /// \brief Build the hierarchy with median splits along the longest
+      /// axis of the centroids.
+      /// \param[in] _bounds Bounds of the primitives.
+      public: void Build(const std::vector<RayBounds> &_bounds)
+      {
+        this->nodes.clear();
+        this->indices.resize(_bounds.size());
+        std::iota(this->indices.begin(), this->indices.end(), 0u);
+        if (_bounds.empty())
+          return;
+
+        this->nodes.reserve(2 * _bounds.size());
+        this->nodes.emplace_back();
+        this->Split(0, 0, this->indices.size(), _bounds);
+      }
+
+      /// \brief Fill a node and split it if it has too many primitives.
+      /// \param[in] _node Index of the node.
+      /// \param[in] _begin First primitive index of the node.
+      /// \param[in] _end One past the last primitive index of the node.
+      /// \param[in] _bounds Bounds of the primitives.
+      private: void Split(const size_t _node, const size_t _begin,
+          const size_t _end, const std::vector<RayBounds> &_bounds)
+      {
+        RayBounds bounds;
+        RayBounds centers;
+        for (size_t i = _begin; i < _end; ++i)
+        {
+          const RayBounds &b = _bounds[this->indices[i]];
+          bounds.Add(b);
+          centers.Add(ignition::math::Vector3d(
+                b.Center(0), b.Center(1), b.Center(2)));
+        }
+        this->nodes[_node].bounds = bounds;
+
+        if (_end - _begin <= LeafSize)
+        {
+          this->nodes[_node].first = _begin;
+          this->nodes[_node].count = _end - _begin;
+          return;
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+        {
+          if (centers.max[a] - centers.min[a] >
+              centers.max[axis] - centers.min[axis])
+          {
+            axis = a;
+          }
+        }
+
+        const size_t mid = (_begin + _end) / 2;
+        std::nth_element(this->indices.begin() + _begin,
+            this->indices.begin() + mid, this->indices.begin() + _end,
+            [&](const unsigned int _a, const unsigned int _b)
+            {
+              return _bounds[_a].Center(axis) < _bounds[_b].Center(axis);
+            });
+
+        const size_t left = this->nodes.size();
+        this->nodes.emplace_back();
+        this->nodes.emplace_back();
+        this->nodes[_node].first = left;
+        this->nodes[_node].count = 0;
+
+        this->Split(left, _begin, mid, _bounds);
+        this->Split(left + 1, mid, _end, _bounds);
+      }
+
+      /// \brief Nodes, the root first.
+      public: std::vector<Node> nodes;
+
+      /// \brief Primitive indices referenced by the leaves.
+      public: std::vector<unsigned int> indices;
+    };
+
+    /// \internal
+    /// \brief A packet of rays, stored one array per component so the
+    /// lane loops can be vectorized by the compiler.
+    class RayPacket
+    {
+      /// \brief Ray origins.
+      public: double origin[3][PacketSize];
+
+      /// \brief Unit ray directions.
+      public: double dir[3][PacketSize];
+
+      /// \brief Inverse of the ray directions.
+      public: double invDir[3][PacketSize];
+
+      /// \brief Distance to the closest hit so far, initially the length
+      /// of the ray. Negative for unused lanes.
+      public: double tMax[PacketSize];
+
+      /// \brief Index of the collision of the closest hit so far, -1 for
+      /// no hit.
+      public: int hit[PacketSize];
+
+      /// \brief Compute the inverse directions.
+      public: void Prepare()
+      {
+        for (int a = 0; a < 3; ++a)
+        {
+          for (int i = 0; i < PacketSize; ++i)
+            this->invDir[a][i] = 1.0 / this->dir[a][i];
+        }
+      }
+
+      /// \brief Get the origin of a lane.
+      /// \param[in] _i Lane index.
+      /// \return Origin of the ray.
+      public: ignition::math::Vector3d Origin(const int _i) const
+      {
+        return ignition::math::Vector3d(
+            this->origin[0][_i], this->origin[1][_i], this->origin[2][_i]);
+      }
+
+      /// \brief Get the direction of a lane.
+      /// \param[in] _i Lane index.
+      /// \return Direction of the ray.
+      public: ignition::math::Vector3d Dir(const int _i) const
+      {
+        return ignition::math::Vector3d(
+            this->dir[0][_i], this->dir[1][_i], this->dir[2][_i]);
+      }
+
+      /// \brief Set the origin and direction of a lane.
+      /// \param[in] _i Lane index.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Direction of the ray.
+      public: void Set(const int _i, const ignition::math::Vector3d &_origin,
+          const ignition::math::Vector3d &_dir)
+      {
+        for (int a = 0; a < 3; ++a)
+        {
+          this->origin[a][_i] = _origin[a];
+          this->dir[a][_i] = _dir[a];
+        }
+      }
+    };
+
+    //////////////////////////////////////////////////
+    /// \brief Test whether any ray of a packet crosses a box before its
+    /// closest hit.
+    /// \param[in] _bounds Box to test.
+    /// \param[in] _packet Rays to test.
+    /// \return True if at least one ray crosses the box.
+    static inline bool PacketHitsBounds(const RayBounds &_bounds,
+        const RayPacket &_packet)
+    {
+      bool hit[PacketSize];
+      for (int i = 0; i < PacketSize; ++i)
+      {
+        double t0 = 0;
+        double t1 = _packet.tMax[i];
+        for (int a = 0; a < 3; ++a)
+        {
+          const double tA =
+              (_bounds.min[a] - _packet.origin[a][i]) * _packet.invDir[a][i];
+          const double tB =
+              (_bounds.max[a] - _packet.origin[a][i]) * _packet.invDir[a][i];
+          // A NaN, from a ray along a face of the box, keeps t0 and t1.
+          t0 = std::max(t0, std::min(tA, tB));
+          t1 = std::min(t1, std::max(tA, tB));
+        }
+        hit[i] = t0 <= t1;
+      }
+
+      bool any = false;
+      for (int i = 0; i < PacketSize; ++i)
+        any = any || hit[i];
+      return any;
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Traverse a hierarchy with a packet of rays.
+    /// \param[in] _bvh Hierarchy to traverse.
+    /// \param[in] _packet Rays, culled against the closest hits.
+    /// \param[in] _leaf Called with each primitive index of the leaves
+    /// crossed by at least one ray.
+    template<typename LeafFunc>
+    static void Traverse(const RayBVH &_bvh, const RayPacket &_packet,
+        LeafFunc _leaf)
+    {
+      if (_bvh.nodes.empty())
+        return;
+
+      unsigned int stack[StackSize];
+      int top = 0;
+      stack[top++] = 0;
+      while (top > 0)
+      {
+        const RayBVH::Node &node = _bvh.nodes[stack[--top]];
+        if (!PacketHitsBounds(node.bounds, _packet))
+          continue;
+
+        if (node.count > 0)
+        {
+          for (unsigned int k = node.first; k < node.first + node.count; ++k)
+            _leaf(_bvh.indices[k]);
+        }
+        else
+        {
+          stack[top++] = node.first;
+          stack[top++] = node.first + 1;
+        }
+      }
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Pick the hit distance of a ray in an entry/exit interval.
+    /// Like ODE, a ray that starts inside a solid hits its exit point.
+    /// \param[in] _tIn Entry distance.
+    /// \param[in] _tOut Exit distance.
+    /// \param[out] _t Hit distance.
+    /// \return True if the interval is hit.
+    static inline bool IntervalHit(const double _tIn, const double _tOut,
+        double &_t)
+    {
+      if (_tIn > _tOut)
+        return false;
+      _t = _tIn >= 0 ? _tIn : _tOut;
+      return _t >= 0;
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Intersect a ray with a box centered at the origin.
+    /// \param[in] _o Ray origin.
+    /// \param[in] _d Unit ray direction.
+    /// \param[in] _half Half extents of the box.
+    /// \param[out] _t Hit distance.
+    /// \return True on hit.
+    static bool RayBox(const ignition::math::Vector3d &_o,
+        const ignition::math::Vector3d &_d,
+        const ignition::math::Vector3d &_half, double &_t)
+    {
+      double tIn = -ignition::math::MAX_D;
+      double tOut = ignition::math::MAX_D;
+      for (int a = 0; a < 3; ++a)
+      {
+        if (std::abs(_d[a]) < ParallelTol)
+        {
+          if (std::abs(_o[a]) > _half[a])
+            return false;
+          continue;
+        }
+        double t0 = (-_half[a] - _o[a]) / _d[a];
+        double t1 = (_half[a] - _o[a]) / _d[a];
+        if (t0 > t1)
+          std::swap(t0, t1);
+        tIn = std::max(tIn, t0);
+        tOut = std::min(tOut, t1);
+      }
+      return IntervalHit(tIn, tOut, _t);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Intersect a ray with a sphere centered at the origin.
+    /// \param[in] _o Ray origin.
+    /// \param[in] _d Unit ray direction.
+    /// \param[in] _radius Radius of the sphere.
+    /// \param[out] _t Hit distance.
+    /// \return True on hit.
+    static bool RaySphere(const ignition::math::Vector3d &_o,
+        const ignition::math::Vector3d &_d, const double _radius, double &_t)
+    {
+      const double b = _o.Dot(_d);
+      const double c = _o.SquaredLength() - _radius * _radius;
+      const double disc = b * b - c;
+      if (disc < 0)
+        return false;
+      const double s = std::sqrt(disc);
+      return IntervalHit(-b - s, -b + s, _t);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Intersect a ray with a z aligned cylinder centered at the
+    /// origin.
+    /// \param[in] _o Ray origin.
+    /// \param[in] _d Unit ray direction.
+    /// \param[in] _radius Radius of the cylinder.
+    /// \param[in] _halfLength Half of the length of the cylinder.
+    /// \param[out] _t Hit distance.
+    /// \return True on hit.
+    static bool RayCylinder(const ignition::math::Vector3d &_o,
+        const ignition::math::Vector3d &_d, const double _radius,
+        const double _halfLength, double &_t)
+    {
+      double tIn = -ignition::math::MAX_D;
+      double tOut = ignition::math::MAX_D;
+
+      const double a = _d.X() * _d.X() + _d.Y() * _d.Y();
+      const double b = _o.X() * _d.X() + _o.Y() * _d.Y();
+      const double c = _o.X() * _o.X() + _o.Y() * _o.Y() - _radius * _radius;
+      if (a < ParallelTol)
+      {
+        if (c > 0)
+          return false;
+      }
+      else
+      {
+        const double disc = b * b - a * c;
+        if (disc < 0)
+          return false;
+        const double s = std::sqrt(disc);
+        tIn = (-b - s) / a;
+        tOut = (-b + s) / a;
+      }
+
+      if (std::abs(_d.Z()) < ParallelTol)
+      {
+        if (std::abs(_o.Z()) > _halfLength)
+          return false;
+      }
+      else
+      {
+        double t0 = (-_halfLength - _o.Z()) / _d.Z();
+        double t1 = (_halfLength - _o.Z()) / _d.Z();
+        if (t0 > t1)
+          std::swap(t0, t1);
+        tIn = std::max(tIn, t0);
+        tOut = std::min(tOut, t1);
+      }
+      return IntervalHit(tIn, tOut, _t);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Intersect a ray with a triangle, both faces.
+    /// \param[in] _o Ray origin.
+    /// \param[in] _d Unit ray direction.
+    /// \param[in] _v Pointer to the three vertices of the triangle.
+    /// \param[out] _t Hit distance.
+    /// \return True on hit.
+    static inline bool RayTriangle(const ignition::math::Vector3d &_o,
+        const ignition::math::Vector3d &_d, const ignition::math::Vector3d *_v,
+        double &_t)
+    {
+      const ignition::math::Vector3d e1 = _v[1] - _v[0];
+      const ignition::math::Vector3d e2 = _v[2] - _v[0];
+      const ignition::math::Vector3d p = _d.Cross(e2);
+      const double det = e1.Dot(p);
+      if (std::abs(det) < ParallelTol)
+        return false;
+
+      const double inv = 1.0 / det;
+      const ignition::math::Vector3d s = _o - _v[0];
+      const double u = s.Dot(p) * inv;
+      if (u < 0 || u > 1)
+        return false;
+
+      const ignition::math::Vector3d q = s.Cross(e1);
+      const double v = _d.Dot(q) * inv;
+      if (v < 0 || u + v > 1)
+        return false;
+
+      _t = e2.Dot(q) * inv;
+      return _t >= 0;
+    }
+
+    /// \internal
+    /// \brief Scaled triangles of a mesh and their hierarchy.
+    class RayMesh
+    {
+      /// \brief Three vertices per triangle, in the collision frame.
+      public: std::vector<ignition::math::Vector3d> vertices;
+
+      /// \brief Bounds of all the triangles, in the collision frame.
+      public: RayBounds bounds;
+
+      /// \brief Hierarchy over the triangles.
+      public: RayBVH bvh;
+    };
+
+    /// \internal
+    /// \brief A collision copied into the query.
+    class RayPrimitive
+    {
+      /// \brief Supported shapes.
+      public: enum Type {BOX, SPHERE, CYLINDER, PLANE, MESH};
+
+      /// \brief The collision. Only used to refresh the live query, never
+      /// through a snapshot, where the collision may have been deleted.
+      public: Collision *collision = nullptr;
+
+      /// \brief Index of the collision in the query.
+      public: int id = -1;
+
+      /// \brief Laser retro value of the collision.
+      public: double retro = 0;
+
+      /// \brief Shape of the collision.
+      public: Type type = BOX;
+
+      /// \brief World pose of the collision.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Box half extents; x radius of a sphere; x radius and
+      /// y half length of a cylinder; plane normal.
+      public: ignition::math::Vector3d size;
+
+      /// \brief Triangles of a mesh.
+      public: std::shared_ptr<const RayMesh> mesh;
+
+      /// \brief Check whether the pose or laser retro of the collision
+      /// changed since the last refresh.
+      /// \return True if either changed.
+      public: bool Changed() const
+      {
+        return this->collision->WorldPose() != this->pose ||
+            this->collision->GetLaserRetro() != this->retro;
+      }
+
+      /// \brief Copy the pose and laser retro of the collision.
+      public: void Refresh()
+      {
+        this->pose = this->collision->WorldPose();
+        this->retro = this->collision->GetLaserRetro();
+      }
+    };
+
+    /// \internal
+    /// \brief Primitives and their hierarchy.
+    class RayPrimitiveSet
+    {
+      /// \brief Rebuild the hierarchy from the primitive poses.
+      public: void Build();
+
+      /// \brief The primitives.
+      public: std::vector<RayPrimitive> prims;
+
+      /// \brief Hierarchy of the primitives.
+      public: RayBVH bvh;
+    };
+
+    /// \internal
+    /// \brief Private data for the RayQuery class
+    class RayQueryPrivate
+    {
+      /// \brief Append the collisions of a model and its nested models.
+      /// \param[in] _model Model to add.
+      /// \return False if a collision shape is not supported.
+      public: bool AddModel(const ModelPtr &_model)
+      {
+        for (auto const &link : _model->GetLinks())
+        {
+          (*this->linkIndices)[link.get()] = this->links.size();
+          this->links.push_back(link.get());
+          for (auto const &collision : link->GetCollisions())
+          {
+            if (!this->AddCollision(collision))
+              return false;
+          }
+        }
+
+        for (auto const &nested : _model->NestedModels())
+        {
+          if (!this->AddModel(nested))
+            return false;
+        }
+        return true;
+      }
+
+      /// \brief Append a collision to the static, dynamic or plane list.
+      /// \param[in] _collision Collision to add.
+      /// \return False if the collision shape is not supported.
+      public: bool AddCollision(const CollisionPtr &_collision)
+      {
+        // Sensor shapes, such as contact based sonar cones, are not
+        // obstacles
+        ShapePtr shape = _collision->GetShape();
+        if (!shape || shape->HasType(Base::RAY_SHAPE) ||
+            shape->HasType(Base::MULTIRAY_SHAPE) ||
+            _collision->HasType(Base::SENSOR_COLLISION))
+        {
+          return true;
+        }
+
+        RayPrimitive prim;
+        prim.collision = _collision.get();
+        prim.id = static_cast<int>(this->names->size());
+        if (shape->HasType(Base::BOX_SHAPE))
+        {
+          prim.type = RayPrimitive::BOX;
+          prim.size = boost::static_pointer_cast<BoxShape>(shape)->Size() * 0.5;
+        }
+        else if (shape->HasType(Base::SPHERE_SHAPE))
+        {
+          prim.type = RayPrimitive::SPHERE;
+          prim.size.X(
+              boost::static_pointer_cast<SphereShape>(shape)->GetRadius());
+        }
+        else if (shape->HasType(Base::CYLINDER_SHAPE))
+        {
+          auto cylinder = boost::static_pointer_cast<CylinderShape>(shape);
+          prim.type = RayPrimitive::CYLINDER;
+          prim.size.Set(cylinder->GetRadius(), cylinder->GetLength() * 0.5, 0);
+        }
+        else if (shape->HasType(Base::PLANE_SHAPE))
+        {
+          prim.type = RayPrimitive::PLANE;
+          prim.size = boost::static_pointer_cast<PlaneShape>(
+              shape)->Normal().Normalized();
+          this->names->push_back(_collision->GetScopedName());
+          this->planes.push_back(prim);
+          return true;
+        }
+        else if (shape->HasType(Base::MESH_SHAPE) &&
+                 !shape->HasType(Base::POLYLINE_SHAPE))
+        {
+          prim.type = RayPrimitive::MESH;
+          prim.mesh = this->Mesh(boost::static_pointer_cast<MeshShape>(shape));
+          if (!prim.mesh)
+            return false;
+        }
+        else
+        {
+          return false;
+        }
+
+        this->names->push_back(_collision->GetScopedName());
+        if (_collision->IsStatic())
+          this->statics->prims.push_back(prim);
+        else
+          this->dynamics.prims.push_back(prim);
+        return true;
+      }
+
+      /// \brief Get the triangles of a mesh shape, from the cache if the
+      /// same mesh was already used with the same scale.
+      /// \param[in] _shape The mesh shape.
+      /// \return The triangles, null if the shape has no mesh data.
+      public: std::shared_ptr<const RayMesh> Mesh(
+          const MeshShapePtr &_shape)
+      {
+        const common::Mesh *mesh = _shape->MeshData();
+        const common::SubMesh *submesh = _shape->SubMeshData();
+        if (!mesh && !submesh)
+          return nullptr;
+
+        const ignition::math::Vector3d scale = _shape->Size();
+        const MeshKey key(mesh, submesh, scale.X(), scale.Y(), scale.Z());
+        auto iter = this->meshes.find(key);
+        if (iter != this->meshes.end())
+          return iter->second;
+
+        float *vertArr = nullptr;
+        int *indArr = nullptr;
+        unsigned int indexCount = 0;
+        if (submesh)
+        {
+          submesh->FillArrays(&vertArr, &indArr);
+          indexCount = submesh->GetIndexCount();
+        }
+        else
+        {
+          mesh->FillArrays(&vertArr, &indArr);
+          indexCount = mesh->GetIndexCount();
+        }
+
+        auto result = std::make_shared<RayMesh>();
+        const unsigned int triCount = indexCount / 3;
+        result->vertices.reserve(triCount * 3);
+
+        std::vector<RayBounds> triBounds(triCount);
+        for (unsigned int i = 0; i < triCount * 3; ++i)
+        {
+          const int v = indArr[i];
+          const ignition::math::Vector3d p(vertArr[v * 3] * scale.X(),
+              vertArr[v * 3 + 1] * scale.Y(), vertArr[v * 3 + 2] * scale.Z());
+          result->vertices.push_back(p);
+          triBounds[i / 3].Add(p);
+          result->bounds.Add(p);
+        }
+        delete [] vertArr;
+        delete [] indArr;
+
+        result->bvh.Build(triBounds);
+        this->meshes[key] = result;
+        return result;
+      }
+
+      /// \brief Compute the world bounds of a primitive.
+      /// \param[in] _prim The primitive.
+      /// \return World axis aligned bounds.
+      public: static RayBounds WorldBounds(const RayPrimitive &_prim)
+      {
+        ignition::math::Vector3d center;
+        ignition::math::Vector3d half;
+        switch (_prim.type)
+        {
+          case RayPrimitive::BOX:
+            half = _prim.size;
+            break;
+          case RayPrimitive::SPHERE:
+            half.Set(_prim.size.X(), _prim.size.X(), _prim.size.X());
+            break;
+          case RayPrimitive::CYLINDER:
+            half.Set(_prim.size.X(), _prim.size.X(), _prim.size.Y());
+            break;
+          case RayPrimitive::MESH:
+          {
+            const RayBounds &b = _prim.mesh->bounds;
+            center.Set(b.Center(0), b.Center(1), b.Center(2));
+            half.Set(b.max[0] - center.X(), b.max[1] - center.Y(),
+                b.max[2] - center.Z());
+            break;
+          }
+          default:
+            break;
+        }
+
+        const ignition::math::Matrix3d rot(_prim.pose.Rot());
+        const ignition::math::Vector3d worldCenter =
+            _prim.pose.Pos() + _prim.pose.Rot().RotateVector(center);
+
+        RayBounds bounds;
+        for (int r = 0; r < 3; ++r)
+        {
+          double extent = 0;
+          for (int c = 0; c < 3; ++c)
+            extent += std::abs(rot(r, c)) * half[c];
+          bounds.min[r] = worldCenter[r] - extent;
+          bounds.max[r] = worldCenter[r] + extent;
+        }
+        return bounds;
+      }
+
+      /// \brief Clear the collision lists and start new shared data, so
+      /// snapshots of the previous lists are not modified.
+      public: void Clear()
+      {
+        this->statics = std::make_shared<RayPrimitiveSet>();
+        this->dynamics = RayPrimitiveSet();
+        this->planes.clear();
+        this->names = std::make_shared<std::vector<std::string>>();
+        this->links.clear();
+        this->linkPoses.clear();
+        this->linkIndices =
+            std::make_shared<std::unordered_map<const Link *, size_t>>();
+        this->meshes.clear();
+      }
+
+      /// \brief Refresh the poses of the collisions and links.
+      /// \param[in] _rebuilt True if the lists were just rebuilt.
+      public: void Refresh(const bool _rebuilt)
+      {
+        for (auto &plane : this->planes)
+          plane.Refresh();
+
+        // Static collisions only move when set by the user. Their set is
+        // shared with the snapshots, so it is replaced instead of being
+        // modified.
+        bool staticChanged = _rebuilt;
+        for (auto const &prim : this->statics->prims)
+        {
+          if (staticChanged)
+            break;
+          staticChanged = prim.Changed();
+        }
+
+        if (staticChanged)
+        {
+          auto statics = std::make_shared<RayPrimitiveSet>();
+          statics->prims = this->statics->prims;
+          for (auto &prim : statics->prims)
+            prim.Refresh();
+          statics->Build();
+          this->statics = statics;
+        }
+
+        for (auto &prim : this->dynamics.prims)
+          prim.Refresh();
+        this->dynamics.Build();
+
+        this->linkPoses.resize(this->links.size());
+        for (size_t i = 0; i < this->links.size(); ++i)
+          this->linkPoses[i] = this->links[i]->WorldPose();
+      }
+
+      /// \brief Test the rays of a packet against a primitive and keep the
+      /// closest hits.
+      /// \param[in] _prim Primitive to test.
+      /// \param[in,out] _packet Rays to test.
+      public: static void Intersect(const RayPrimitive &_prim,
+          RayPacket &_packet)
+      {
+        const ignition::math::Quaterniond invRot = _prim.pose.Rot().Inverse();
+
+        if (_prim.type == RayPrimitive::MESH)
+        {
+          // The pose is rigid, so distances along the local rays match the
+          // world ones and the local packet shares the closest hits.
+          RayPacket local;
+          for (int i = 0; i < PacketSize; ++i)
+          {
+            local.Set(i,
+                invRot.RotateVector(_packet.Origin(i) - _prim.pose.Pos()),
+                invRot.RotateVector(_packet.Dir(i)));
+            local.tMax[i] = _packet.tMax[i];
+            local.hit[i] = -1;
+          }
+          local.Prepare();
+
+          const RayMesh &mesh = *_prim.mesh;
+          Traverse(mesh.bvh, local, [&](const unsigned int _tri)
+              {
+                const ignition::math::Vector3d *v = &mesh.vertices[_tri * 3];
+                for (int i = 0; i < PacketSize; ++i)
+                {
+                  double t;
+                  if (local.tMax[i] >= 0 &&
+                      RayTriangle(local.Origin(i), local.Dir(i), v, t) &&
+                      t < local.tMax[i])
+                  {
+                    local.tMax[i] = t;
+                    local.hit[i] = _prim.id;
+                  }
+                }
+              });
+
+          for (int i = 0; i < PacketSize; ++i)
+          {
+            if (local.hit[i] >= 0)
+            {
+              _packet.tMax[i] = local.tMax[i];
+              _packet.hit[i] = local.hit[i];
+            }
+          }
+          return;
+        }
+
+        for (int i = 0; i < PacketSize; ++i)
+        {
+          if (_packet.tMax[i] < 0)
+            continue;
+
+          double t = 0;
+          bool hit = false;
+          if (_prim.type == RayPrimitive::PLANE)
+          {
+            const ignition::math::Vector3d normal =
+                _prim.pose.Rot().RotateVector(_prim.size);
+            const double denom = normal.Dot(_packet.Dir(i));
+            if (std::abs(denom) >= ParallelTol)
+            {
+              t = normal.Dot(_prim.pose.Pos() - _packet.Origin(i)) / denom;
+              hit = t >= 0;
+            }
+          }
+          else
+          {
+            const ignition::math::Vector3d o =
+                invRot.RotateVector(_packet.Origin(i) - _prim.pose.Pos());
+            const ignition::math::Vector3d d =
+                invRot.RotateVector(_packet.Dir(i));
+            if (_prim.type == RayPrimitive::BOX)
+              hit = RayBox(o, d, _prim.size, t);
+            else if (_prim.type == RayPrimitive::SPHERE)
+              hit = RaySphere(o, d, _prim.size.X(), t);
+            else
+              hit = RayCylinder(o, d, _prim.size.X(), _prim.size.Y(), t);
+          }
+
+          if (hit && t < _packet.tMax[i])
+          {
+            _packet.tMax[i] = t;
+            _packet.hit[i] = _prim.id;
+          }
+        }
+      }
+
+      /// \brief Key of the mesh cache: mesh, submesh and scale.
+      public: using MeshKey = std::tuple<const common::Mesh *,
+          const common::SubMesh *, double, double, double>;
+
+      /// \brief True if the collision lists must be rebuilt.
+      public: bool dirty = true;
+
+      /// \brief True if every collision shape is supported.
+      public: bool supported = false;
+
+      /// \brief Iteration of the last refresh of the dynamic collisions.
+      public: uint64_t iteration = std::numeric_limits<uint64_t>::max();
+
+      /// \brief Static collisions, shared with the snapshots.
+      public: std::shared_ptr<RayPrimitiveSet> statics =
+          std::make_shared<RayPrimitiveSet>();
+
+      /// \brief Other collisions.
+      public: RayPrimitiveSet dynamics;
+
+      /// \brief Planes, unbounded and tested against every ray.
+      public: std::vector<RayPrimitive> planes;
+
+      /// \brief Scoped names of the collisions, by index, shared with the
+      /// snapshots.
+      public: std::shared_ptr<std::vector<std::string>> names =
+          std::make_shared<std::vector<std::string>>();
+
+      /// \brief Links of the models. Only used to refresh the live query.
+      public: std::vector<Link *> links;
+
+      /// \brief World poses of the links.
+      public: std::vector<ignition::math::Pose3d> linkPoses;
+
+      /// \brief Link to index in links and linkPoses, shared with the
+      /// snapshots.
+      public: std::shared_ptr<std::unordered_map<const Link *, size_t>>
+          linkIndices =
+          std::make_shared<std::unordered_map<const Link *, size_t>>();
+
+      /// \brief Triangles of the meshes.
+      public: std::map<MeshKey, std::shared_ptr<const RayMesh>> meshes;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+void RayPrimitiveSet::Build()
+{
+  std::vector<RayBounds> bounds;
+  bounds.reserve(this->prims.size());
+  for (auto const &prim : this->prims)
+    bounds.push_back(RayQueryPrivate::WorldBounds(prim));
+  this->bvh.Build(bounds);
+}
+
+//////////////////////////////////////////////////
+RayQuery::RayQuery()
+  : dataPtr(new RayQueryPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+RayQuery::RayQuery(const RayQuery &_other)
+  : dataPtr(new RayQueryPrivate(*_other.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+RayQuery::~RayQuery()
+{
+}
+
+//////////////////////////////////////////////////
+void RayQuery::MarkDirty()
+{
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+bool RayQuery::Update(const Model_V &_models, const uint64_t _iteration)
+{
+  bool rebuilt = false;
+  if (this->dataPtr->dirty)
+  {
+    this->dataPtr->dirty = false;
+    this->dataPtr->Clear();
+
+    this->dataPtr->supported = true;
+    for (auto const &model : _models)
+    {
+      if (!this->dataPtr->AddModel(model))
+      {
+        this->dataPtr->supported = false;
+        break;
+      }
+    }
+
+    if (!this->dataPtr->supported)
+      this->dataPtr->Clear();
+    rebuilt = true;
+  }
+
+  if (!this->dataPtr->supported)
+    return false;
+
+  if (rebuilt || this->dataPtr->iteration != _iteration)
+  {
+    this->dataPtr->iteration = _iteration;
+    this->dataPtr->Refresh(rebuilt);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t RayQuery::CollisionCount() const
+{
+  return this->dataPtr->names->size();
+}
+
+//////////////////////////////////////////////////
+size_t RayQuery::StaticCollisionCount() const
+{
+  size_t count = this->dataPtr->statics->prims.size();
+  for (auto const &plane : this->dataPtr->planes)
+  {
+    if (plane.collision->IsStatic())
+      ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+const std::string &RayQuery::CollisionName(const int _hit) const
+{
+  static const std::string empty;
+  if (_hit < 0 || static_cast<size_t>(_hit) >= this->dataPtr->names->size())
+    return empty;
+  return (*this->dataPtr->names)[_hit];
+}
+
+//////////////////////////////////////////////////
+bool RayQuery::LinkPose(const Link *_link, ignition::math::Pose3d &_pose) const
+{
+  auto iter = this->dataPtr->linkIndices->find(_link);
+  if (iter == this->dataPtr->linkIndices->end() ||
+      iter->second >= this->dataPtr->linkPoses.size())
+  {
+    return false;
+  }
+
+  _pose = this->dataPtr->linkPoses[iter->second];
+  return true;
+}
+
+//////////////////////////////////////////////////
+void RayQuery::CastRays(const std::vector<ignition::math::Vector3d> &_starts,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    std::vector<double> &_distances, std::vector<int> &_hits,
+    std::vector<double> *_retros) const
+{
+  const size_t count = std::min(_starts.size(), _ends.size());
+  _distances.assign(count, ignition::math::MAX_D);
+  _hits.assign(count, -1);
+  if (_retros)
+    _retros->assign(count, 0.0);
+
+  const RayPrimitiveSet &statics = *this->dataPtr->statics;
+  const RayPrimitiveSet &dynamics = this->dataPtr->dynamics;
+  double retros[PacketSize];
+
+  for (size_t begin = 0; begin < count; begin += PacketSize)
+  {
+    RayPacket packet;
+    for (int i = 0; i < PacketSize; ++i)
+    {
+      const size_t index = begin + i;
+      ignition::math::Vector3d dir = ignition::math::Vector3d::UnitX;
+      double length = -1;
+      if (index < count)
+      {
+        dir = _ends[index] - _starts[index];
+        length = dir.Length();
+        if (length > 0)
+          dir /= length;
+        else
+          length = -1;
+      }
+      packet.Set(i, index < count ? _starts[index] :
+          ignition::math::Vector3d::Zero, dir);
+      packet.tMax[i] = length;
+      packet.hit[i] = -1;
+      retros[i] = 0;
+    }
+    packet.Prepare();
+
+    // Track the retro value of each hit as it is found, so the caller
+    // does not need to look it up afterwards.
+    auto intersect = [&](const RayPrimitive &_prim)
+    {
+      int before[PacketSize];
+      std::copy(packet.hit, packet.hit + PacketSize, before);
+      RayQueryPrivate::Intersect(_prim, packet);
+      for (int i = 0; i < PacketSize; ++i)
+      {
+        if (packet.hit[i] != before[i])
+          retros[i] = _prim.retro;
+      }
+    };
+
+    for (auto const &plane : this->dataPtr->planes)
+      intersect(plane);
+
+    Traverse(statics.bvh, packet, [&](const unsigned int _k)
+        {
+          intersect(statics.prims[_k]);
+        });
+    Traverse(dynamics.bvh, packet, [&](const unsigned int _k)
+        {
+          intersect(dynamics.prims[_k]);
+        });
+
+    for (int i = 0; i < PacketSize && begin + i < count; ++i)
+    {
+      if (packet.hit[i] >= 0)
+      {
+        _distances[begin + i] = packet.tMax[i];
+        _hits[begin + i] = packet.hit[i];
+        if (_retros)
+          (*_retros)[begin + i] = retros[i];
+      }
+    }
+  }
+}
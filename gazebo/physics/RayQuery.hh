@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_RAYQUERY_HH_
+#define GAZEBO_PHYSICS_RAYQUERY_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class RayQueryPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class RayQuery RayQuery.hh physics/physics.hh
+    /// \brief World owned, engine neutral batched ray caster.
+    ///
+    /// The collisions of the world are copied into two bounding volume
+    /// hierarchies: one for the static collisions, built when models are
+    /// inserted or removed and shared by every ray sensor, and one for the
+    /// other collisions, rebuilt at most once per world iteration. Meshes
+    /// get their own triangle hierarchy, built once per mesh and scale.
+    /// Rays are traced in packets of four that traverse the hierarchies
+    /// together.
+    ///
+    /// Boxes, spheres, cylinders, planes and meshes are supported. If the
+    /// world has a collision of any other shape, such as a heightmap or a
+    /// polyline, Update returns false and callers must fall back to the
+    /// ray casting of the physics engine.
+    ///
+    /// The caller must hold the physics update mutex while calling Update
+    /// and CastRays. See World::SharedRayQuery and MultiRayShape::SetBatched.
+    ///
+    /// A copy is an immutable snapshot that can be queried from any thread
+    /// without the physics mutex: it never touches the collisions, and
+    /// shares the static hierarchy and the meshes with the original. See
+    /// World::RayQuerySnapshot.
+    class GZ_PHYSICS_VISIBLE RayQuery
+    {
+      /// \brief Constructor.
+      public: RayQuery();
+
+      /// \brief Copy constructor, used to take a snapshot.
+      /// \param[in] _other Query to copy.
+      public: RayQuery(const RayQuery &_other);
+
+      /// \brief Destructor.
+      public: ~RayQuery();
+
+      /// \brief Mark the list of collisions as outdated. The hierarchies
+      /// are rebuilt on the next Update. Called by the world when models
+      /// are inserted or removed.
+      public: void MarkDirty();
+
+      /// \brief Rebuild the hierarchies if needed, and refresh the poses of
+      /// the collisions once per world iteration.
+      /// \param[in] _models Top level models of the world.
+      /// \param[in] _iteration Current world iteration.
+      /// \return False if the world has a collision shape that is not
+      /// supported.
+      public: bool Update(const Model_V &_models, const uint64_t _iteration);
+
+      /// \brief Number of collisions in the hierarchies.
+      /// \return Number of collisions, planes included.
+      public: size_t CollisionCount() const;
+
+      /// \brief Number of static collisions in the shared hierarchy.
+      /// \return Number of static collisions, planes included.
+      public: size_t StaticCollisionCount() const;
+
+      /// \brief Get the scoped name of a collision hit by CastRays.
+      /// \param[in] _hit Index returned by CastRays.
+      /// \return Scoped name of the collision, empty for an invalid index.
+      public: const std::string &CollisionName(const int _hit) const;
+
+      /// \brief Get the world pose of a link, as of the last Update.
+      /// \param[in] _link The link, which is not dereferenced.
+      /// \param[out] _pose World pose of the link.
+      /// \return False if the link is not part of the query.
+      public: bool LinkPose(const Link *_link,
+                  ignition::math::Pose3d &_pose) const;
+
+      /// \brief Cast a batch of ray segments against the collisions.
+      /// \param[in] _starts Start points of the rays, in the world frame.
+      /// \param[in] _ends End points of the rays, in the world frame.
+      /// \param[out] _distances Distance from the start point to the
+      /// closest hit of each ray, ignition::math::MAX_D for no hit.
+      /// \param[out] _hits Index of the collision hit by each ray, -1 for
+      /// no hit. See CollisionName.
+      /// \param[out] _retros Optional laser retro value of the collision
+      /// hit by each ray, 0 for no hit.
+      public: void CastRays(
+                  const std::vector<ignition::math::Vector3d> &_starts,
+                  const std::vector<ignition::math::Vector3d> &_ends,
+                  std::vector<double> &_distances,
+                  std::vector<int> &_hits,
+                  std::vector<double> *_retros = nullptr) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<RayQueryPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
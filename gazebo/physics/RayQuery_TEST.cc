@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/RayQuery.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class RayQueryTest : public ServerFixture {};
+
+//////////////////////////////////////////////////
+TEST_F(RayQueryTest, Shapes)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  physics::RayQuery &query = world->SharedRayQuery();
+  EXPECT_TRUE(query.Update(world->Models(), world->Iterations()));
+
+  // Ground plane, box, sphere and cylinder
+  EXPECT_EQ(4u, query.CollisionCount());
+  EXPECT_EQ(1u, query.StaticCollisionCount());
+
+  // Cast down onto each shape, onto the ground, and into the sky. The
+  // count is not a multiple of the packet size on purpose.
+  std::vector<ignition::math::Vector3d> starts = {
+      {0, 0, 5}, {0, 1.5, 5}, {0, -1.5, 5}, {5, 5, 5}, {5, 5, 5}};
+  std::vector<ignition::math::Vector3d> ends = {
+      {0, 0, -5}, {0, 1.5, -5}, {0, -1.5, -5}, {5, 5, -5}, {5, 5, 6}};
+
+  std::vector<double> distances;
+  std::vector<int> hits;
+  std::vector<double> retros;
+  query.CastRays(starts, ends, distances, hits, &retros);
+  ASSERT_EQ(starts.size(), distances.size());
+  ASSERT_EQ(starts.size(), hits.size());
+  ASSERT_EQ(starts.size(), retros.size());
+
+  const std::vector<std::string> models = {
+      "box", "sphere", "cylinder", "ground_plane"};
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    ASSERT_GE(hits[i], 0);
+    EXPECT_EQ(0u, query.CollisionName(hits[i]).find(models[i] + "::"));
+  }
+  EXPECT_NEAR(4.0, distances[0], 1e-3);
+  EXPECT_NEAR(4.0, distances[1], 1e-3);
+  EXPECT_NEAR(4.0, distances[2], 1e-3);
+  EXPECT_NEAR(5.0, distances[3], 1e-3);
+  EXPECT_EQ(-1, hits[4]);
+  EXPECT_DOUBLE_EQ(ignition::math::MAX_D, distances[4]);
+  EXPECT_TRUE(query.CollisionName(hits[4]).empty());
+
+  // Same distances as the ray of the physics engine
+  physics::RayShapePtr ray = boost::dynamic_pointer_cast<physics::RayShape>(
+      world->Physics()->CreateShape("ray", physics::CollisionPtr()));
+  ASSERT_NE(nullptr, ray);
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    double dist;
+    std::string entity;
+    ray->SetPoints(starts[i], ends[i]);
+    ray->GetIntersection(dist, entity);
+    EXPECT_NEAR(dist, distances[i], 1e-3) << models[i];
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_F(RayQueryTest, ModelChanges)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  physics::RayQuery &query = world->SharedRayQuery();
+  EXPECT_TRUE(query.Update(world->Models(), world->Iterations()));
+  EXPECT_EQ(4u, query.CollisionCount());
+
+  const std::vector<ignition::math::Vector3d> starts = {{3, 0, 5}};
+  const std::vector<ignition::math::Vector3d> ends = {{3, 0, -5}};
+  std::vector<double> distances;
+  std::vector<int> hits;
+
+  // Poses of the dynamic collisions are refreshed on the next iteration
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(3, 0, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(query.Update(world->Models(), world->Iterations()));
+  query.CastRays(starts, ends, distances, hits);
+  EXPECT_EQ(0u, query.CollisionName(hits[0]).find("box::"));
+  EXPECT_NEAR(4.0, distances[0], 1e-2);
+
+  // Removed models are dropped
+  world->RemoveModel("box");
+  EXPECT_TRUE(query.Update(world->Models(), world->Iterations()));
+  EXPECT_EQ(3u, query.CollisionCount());
+  query.CastRays(starts, ends, distances, hits);
+  EXPECT_EQ(0u, query.CollisionName(hits[0]).find("ground_plane::"));
+  EXPECT_NEAR(5.0, distances[0], 1e-3);
+}
+
+//////////////////////////////////////////////////
+TEST_F(RayQueryTest, Snapshot)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_FALSE(world->RayQuerySnapshotEnabled());
+  EXPECT_EQ(nullptr, world->RayQuerySnapshot());
+
+  world->SetRayQuerySnapshotEnabled(true);
+  EXPECT_TRUE(world->RayQuerySnapshotEnabled());
+  std::shared_ptr<const physics::RayQuery> first = world->RayQuerySnapshot();
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(4u, first->CollisionCount());
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  physics::LinkPtr link = box->GetLink();
+  ASSERT_NE(nullptr, link);
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(first->LinkPose(link.get(), pose));
+  EXPECT_EQ(link->WorldPose(), pose);
+
+  const std::vector<ignition::math::Vector3d> starts = {{3, 0, 5}};
+  const std::vector<ignition::math::Vector3d> ends = {{3, 0, -5}};
+  std::vector<double> distances;
+  std::vector<int> hits;
+
+  // Every step publishes a new snapshot, older ones are left untouched
+  box->SetWorldPose(ignition::math::Pose3d(3, 0, 0.5, 0, 0, 0));
+  world->Step(1);
+  std::shared_ptr<const physics::RayQuery> second = world->RayQuerySnapshot();
+  ASSERT_NE(nullptr, second);
+  EXPECT_NE(first, second);
+
+  first->CastRays(starts, ends, distances, hits);
+  EXPECT_EQ(0u, first->CollisionName(hits[0]).find("ground_plane::"));
+  EXPECT_NEAR(5.0, distances[0], 1e-3);
+
+  second->CastRays(starts, ends, distances, hits);
+  EXPECT_EQ(0u, second->CollisionName(hits[0]).find("box::"));
+  EXPECT_NEAR(4.0, distances[0], 1e-2);
+  EXPECT_TRUE(second->LinkPose(link.get(), pose));
+  EXPECT_NEAR(3.0, pose.Pos().X(), 1e-3);
+
+  // A snapshot outlives the models it was taken from
+  world->RemoveModel("box");
+  second->CastRays(starts, ends, distances, hits);
+  EXPECT_EQ(0u, second->CollisionName(hits[0]).find("box::"));
+
+  world->SetRayQuerySnapshotEnabled(false);
+  EXPECT_EQ(nullptr, world->RayQuerySnapshot());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
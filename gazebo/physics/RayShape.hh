@@ -164,6 +164,10 @@ namespace gazebo
       /// \brief ODEMultiRayShape needs to call SetCollisionName when it is
       /// updated
       protected: friend class ODEMultiRayShape;
+
+      /// \brief MultiRayShape needs to call SetCollisionName when its rays
+      /// are cast with the shared ray query
+      protected: friend class MultiRayShape;
     };
     /// \}
   }
@@ -0,0 +1,426 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gazebo/util/Diagnostics.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/SleepManager.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Sleeping state of a top level model.
+    class ModelSleepState
+    {
+      /// \brief The model.
+      public: ModelPtr model;
+
+      /// \brief Links of the model and its nested models.
+      public: Link_V links;
+
+      /// \brief True if the model may fall asleep.
+      public: bool allowSleep = false;
+
+      /// \brief True if the model did not move during the last update.
+      public: bool idle = false;
+
+      /// \brief True if the model is sleeping.
+      public: bool asleep = false;
+
+      /// \brief Simulation time the model has been idle.
+      public: double idleTime = 0;
+
+      /// \brief Update counter value when the model was last seen.
+      public: uint64_t stamp = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the SleepManager class
+    class SleepManagerPrivate
+    {
+      /// \brief Append the links of a model and its nested models.
+      /// \param[in] _model The model.
+      /// \param[out] _links Links are appended here.
+      public: static void CollectLinks(const ModelPtr &_model,
+                  Link_V &_links)
+      {
+        const Link_V &links = _model->GetLinks();
+        _links.insert(_links.end(), links.begin(), links.end());
+        for (auto const &nested : _model->NestedModels())
+          CollectLinks(nested, _links);
+      }
+
+      /// \brief Put a model to sleep or wake it up.
+      /// \param[in] _state State of the model.
+      /// \param[in] _asleep True to put the model to sleep.
+      public: void SetAsleep(ModelSleepState &_state, const bool _asleep)
+      {
+        // Links frozen for other reasons, e.g. outside of the activity
+        // zones, stay disabled when the model wakes up
+        FreezeRegistry &freezes = this->world->Freezes();
+        for (auto const &link : _state.links)
+        {
+          if (_asleep)
+            freezes.Freeze(link.get(), "sleep");
+          else
+            freezes.Unfreeze(link.get(), "sleep");
+        }
+
+        _state.asleep = _asleep;
+        _state.idleTime = 0;
+      }
+
+      /// \brief Check if all the links of a model are below the
+      /// thresholds.
+      /// \param[in] _state State of the model.
+      /// \return True if the model is idle.
+      public: bool IsIdle(const ModelSleepState &_state) const
+      {
+        const double linear2 = this->linearThreshold * this->linearThreshold;
+        const double angular2 =
+            this->angularThreshold * this->angularThreshold;
+
+        for (auto const &link : _state.links)
+        {
+          if (link->WorldCoGLinearVel().SquaredLength() > linear2 ||
+              link->WorldAngularVel().SquaredLength() > angular2)
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      /// \brief Get the state of the top level model of a collision.
+      /// \param[in] _collision The collision.
+      /// \return The state, null if the model is not tracked.
+      public: ModelSleepState *StateOf(Collision *_collision)
+      {
+        if (!_collision)
+          return nullptr;
+
+        ModelPtr model = _collision->GetParentModel();
+        if (!model)
+          return nullptr;
+
+        auto iter = this->states.find(model->GetId());
+        return iter == this->states.end() ? nullptr : &iter->second;
+      }
+
+      /// \brief World whose models are managed.
+      public: WorldPtr world;
+
+      /// \brief True if the policy is enabled.
+      public: bool enabled = false;
+
+      /// \brief Linear velocity threshold.
+      public: double linearThreshold = 0.01;
+
+      /// \brief Angular velocity threshold.
+      public: double angularThreshold = 0.01;
+
+      /// \brief Idle time before sleeping.
+      public: double sleepTime = 1.0;
+
+      /// \brief Value of ContactManager::NeverDropContacts before enabling.
+      public: bool prevNeverDropContacts = false;
+
+      /// \brief State of every non static top level model, by model id.
+      public: std::unordered_map<uint32_t, ModelSleepState> states;
+
+      /// \brief Update counter.
+      public: uint64_t stamp = 0;
+
+      /// \brief Number of sleeping models.
+      public: unsigned int sleepingModels = 0;
+
+      /// \brief Number of sleeping links.
+      public: unsigned int sleepingLinks = 0;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+SleepManager::SleepManager()
+  : dataPtr(new SleepManagerPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SleepManager::~SleepManager()
+{
+}
+
+//////////////////////////////////////////////////
+void SleepManager::Init(WorldPtr _world)
+{
+  this->dataPtr->world = _world;
+}
+
+//////////////////////////////////////////////////
+void SleepManager::SetEnabled(const bool _enabled)
+{
+  if (_enabled == this->dataPtr->enabled)
+    return;
+
+  this->dataPtr->enabled = _enabled;
+
+  ContactManager *contactManager = nullptr;
+  if (this->dataPtr->world && this->dataPtr->world->Physics())
+    contactManager = this->dataPtr->world->Physics()->GetContactManager();
+
+  if (_enabled)
+  {
+    // Contacts are needed to wake up models that are touched.
+    if (contactManager)
+    {
+      this->dataPtr->prevNeverDropContacts =
+          contactManager->NeverDropContacts();
+      contactManager->SetNeverDropContacts(true);
+    }
+  }
+  else
+  {
+    for (auto &state : this->dataPtr->states)
+    {
+      if (state.second.asleep)
+        this->dataPtr->SetAsleep(state.second, false);
+    }
+    this->dataPtr->states.clear();
+    this->dataPtr->sleepingModels = 0;
+    this->dataPtr->sleepingLinks = 0;
+
+    if (contactManager)
+    {
+      contactManager->SetNeverDropContacts(
+          this->dataPtr->prevNeverDropContacts);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool SleepManager::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+//////////////////////////////////////////////////
+void SleepManager::SetThresholds(const double _linear, const double _angular)
+{
+  this->dataPtr->linearThreshold = std::max(0.0, _linear);
+  this->dataPtr->angularThreshold = std::max(0.0, _angular);
+}
+
+//////////////////////////////////////////////////
+double SleepManager::LinearThreshold() const
+{
+  return this->dataPtr->linearThreshold;
+}
+
+//////////////////////////////////////////////////
+double SleepManager::AngularThreshold() const
+{
+  return this->dataPtr->angularThreshold;
+}
+
+//////////////////////////////////////////////////
+void SleepManager::SetSleepTime(const double _time)
+{
+  this->dataPtr->sleepTime = std::max(0.0, _time);
+}
+
+//////////////////////////////////////////////////
+double SleepManager::SleepTime() const
+{
+  return this->dataPtr->sleepTime;
+}
+
+//////////////////////////////////////////////////
+void SleepManager::Wake(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  auto iter = this->dataPtr->states.find(_model->GetId());
+  if (iter == this->dataPtr->states.end())
+    return;
+
+  if (iter->second.asleep)
+  {
+    this->dataPtr->SetAsleep(iter->second, false);
+    this->dataPtr->sleepingModels--;
+    this->dataPtr->sleepingLinks -= iter->second.links.size();
+  }
+  iter->second.idleTime = 0;
+}
+
+//////////////////////////////////////////////////
+bool SleepManager::IsSleeping(const ModelPtr &_model) const
+{
+  if (!_model)
+    return false;
+
+  auto iter = this->dataPtr->states.find(_model->GetId());
+  return iter != this->dataPtr->states.end() && iter->second.asleep;
+}
+
+//////////////////////////////////////////////////
+unsigned int SleepManager::SleepingModelCount() const
+{
+  return this->dataPtr->sleepingModels;
+}
+
+//////////////////////////////////////////////////
+unsigned int SleepManager::SleepingLinkCount() const
+{
+  return this->dataPtr->sleepingLinks;
+}
+
+//////////////////////////////////////////////////
+void SleepManager::Update(const double _dt)
+{
+  if (!this->dataPtr->enabled || !this->dataPtr->world)
+    return;
+
+  const uint64_t stamp = ++this->dataPtr->stamp;
+  auto &states = this->dataPtr->states;
+
+  // Refresh the idle state of every model.
+  for (auto const &model : this->dataPtr->world->Models())
+  {
+    if (model->IsStatic())
+      continue;
+
+    auto result = states.emplace(model->GetId(), ModelSleepState());
+    ModelSleepState &state = result.first->second;
+    if (result.second)
+    {
+      state.model = model;
+      state.allowSleep = model->GetAutoDisable();
+      SleepManagerPrivate::CollectLinks(model, state.links);
+    }
+    state.stamp = stamp;
+
+    if (state.asleep)
+    {
+      // The engine woke the model up, e.g. through its own islands.
+      for (auto const &link : state.links)
+      {
+        if (link->GetEnabled())
+        {
+          this->dataPtr->SetAsleep(state, false);
+          break;
+        }
+      }
+      state.idle = state.asleep;
+    }
+    else
+    {
+      state.idle = this->dataPtr->IsIdle(state);
+    }
+  }
+
+  // Wake up sleeping models touched by moving ones. Repeat so that the
+  // wake up spreads through stacks of sleeping models.
+  ContactManager *contactManager =
+      this->dataPtr->world->Physics()->GetContactManager();
+  std::vector<std::pair<ModelSleepState *, ModelSleepState *>> touching;
+  for (unsigned int i = 0; i < contactManager->GetContactCount(); ++i)
+  {
+    Contact *contact = contactManager->GetContact(i);
+    ModelSleepState *a = this->dataPtr->StateOf(contact->collision1);
+    ModelSleepState *b = this->dataPtr->StateOf(contact->collision2);
+    if (a && b && a != b && (a->asleep || b->asleep))
+      touching.push_back(std::make_pair(a, b));
+  }
+
+  bool woke = true;
+  while (woke)
+  {
+    woke = false;
+    for (auto const &pair : touching)
+    {
+      if (pair.first->asleep == pair.second->asleep)
+        continue;
+
+      ModelSleepState *sleeper = pair.first->asleep ? pair.first : pair.second;
+      ModelSleepState *other = pair.first->asleep ? pair.second : pair.first;
+
+      // Idle awake models, e.g. a box resting on a sleeping pile, do not
+      // wake their neighbors. Models that were just woken up count as
+      // moving.
+      if (other->idle)
+        continue;
+
+      this->dataPtr->SetAsleep(*sleeper, false);
+      sleeper->idle = false;
+      woke = true;
+    }
+  }
+
+  // Put idle models to sleep and count, dropping removed models.
+  this->dataPtr->sleepingModels = 0;
+  this->dataPtr->sleepingLinks = 0;
+  for (auto iter = states.begin(); iter != states.end();)
+  {
+    ModelSleepState &state = iter->second;
+    if (state.stamp != stamp)
+    {
+      iter = states.erase(iter);
+      continue;
+    }
+
+    if (!state.asleep && state.allowSleep)
+    {
+      state.idleTime = state.idle ? state.idleTime + _dt : 0;
+      if (state.idleTime >= this->dataPtr->sleepTime && !state.links.empty())
+      {
+        this->dataPtr->SetAsleep(state, true);
+
+        // Engines that can not disable links keep the model awake.
+        if (state.links.front()->GetEnabled())
+          this->dataPtr->SetAsleep(state, false);
+      }
+    }
+
+    if (state.asleep)
+    {
+      this->dataPtr->sleepingModels++;
+      this->dataPtr->sleepingLinks += state.links.size();
+    }
+    ++iter;
+  }
+
+  DIAG_VALUE("sleeping_models", this->dataPtr->sleepingModels);
+  DIAG_VALUE("sleeping_links", this->dataPtr->sleepingLinks);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SLEEPMANAGER_HH_
+#define GAZEBO_PHYSICS_SLEEPMANAGER_HH_
+
+#include <memory>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class SleepManagerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SleepManager SleepManager.hh physics/physics.hh
+    /// \brief Engine independent sleeping policy for idle models.
+    ///
+    /// A model falls asleep once all of its links have stayed below the
+    /// linear and angular velocity thresholds for the sleep time. Sleeping
+    /// models have their links frozen with the "sleep" reason of the
+    /// FreezeRegistry of the world, so the engine can skip them, and waking
+    /// up keeps the links frozen for other reasons. A sleeping model wakes
+    /// up when the engine re-enables one of its links, or when it is in
+    /// contact with an awake, moving model. Wake ups propagate through
+    /// chains of touching sleeping models, so a whole pile wakes up
+    /// together.
+    ///
+    /// Only top level, non static models that allow auto disable (SDF
+    /// <allow_auto_disable>) are considered. Models with joints sleep as a
+    /// whole. The manager is owned by the PhysicsEngine and updated by the
+    /// World after every physics step. It is disabled by default.
+    class GZ_PHYSICS_VISIBLE SleepManager
+    {
+      /// \brief Constructor.
+      public: SleepManager();
+
+      /// \brief Destructor.
+      public: ~SleepManager();
+
+      /// \brief Initialize the manager.
+      /// \param[in] _world World whose models are managed.
+      public: void Init(WorldPtr _world);
+
+      /// \brief Enable or disable the sleeping policy. Disabling wakes up
+      /// every sleeping model.
+      /// \param[in] _enabled True to let idle models sleep.
+      public: void SetEnabled(const bool _enabled);
+
+      /// \brief Get whether the sleeping policy is enabled.
+      /// \return True if enabled.
+      public: bool Enabled() const;
+
+      /// \brief Set the velocity thresholds under which a link is idle.
+      /// \param[in] _linear Linear velocity threshold in m/s.
+      /// \param[in] _angular Angular velocity threshold in rad/s.
+      public: void SetThresholds(const double _linear, const double _angular);
+
+      /// \brief Get the linear velocity threshold.
+      /// \return Linear velocity threshold in m/s.
+      public: double LinearThreshold() const;
+
+      /// \brief Get the angular velocity threshold.
+      /// \return Angular velocity threshold in rad/s.
+      public: double AngularThreshold() const;
+
+      /// \brief Set how long a model has to stay idle before it sleeps.
+      /// \param[in] _time Time in seconds of simulation time.
+      public: void SetSleepTime(const double _time);
+
+      /// \brief Get how long a model has to stay idle before it sleeps.
+      /// \return Time in seconds of simulation time.
+      public: double SleepTime() const;
+
+      /// \brief Wake up a model. Call it after moving or pushing a sleeping
+      /// model from a plugin.
+      /// \param[in] _model The model to wake up.
+      public: void Wake(const ModelPtr &_model);
+
+      /// \brief Get whether a model is sleeping.
+      /// \param[in] _model The model.
+      /// \return True if the model is sleeping.
+      public: bool IsSleeping(const ModelPtr &_model) const;
+
+      /// \brief Number of sleeping models.
+      /// \return Number of sleeping models.
+      public: unsigned int SleepingModelCount() const;
+
+      /// \brief Number of links of the sleeping models.
+      /// \return Number of sleeping links.
+      public: unsigned int SleepingLinkCount() const;
+
+      /// \brief Update the sleeping state of every model. Called by the
+      /// world after the physics update.
+      /// \param[in] _dt Simulation time elapsed since the last update.
+      public: void Update(const double _dt);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SleepManagerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
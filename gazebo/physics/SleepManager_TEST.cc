@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/SleepManager.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class SleepManagerTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, Params)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto physics = world->Physics();
+  physics::SleepManager *sleepManager = physics->SleepMgr();
+  ASSERT_NE(nullptr, sleepManager);
+  EXPECT_FALSE(sleepManager->Enabled());
+
+  EXPECT_TRUE(physics->SetParam("sleep_enabled", true));
+  EXPECT_TRUE(physics->SetParam("sleep_linear_threshold", 0.2));
+  EXPECT_TRUE(physics->SetParam("sleep_angular_threshold", 0.3));
+  EXPECT_TRUE(physics->SetParam("sleep_time", 2.0));
+
+  EXPECT_TRUE(sleepManager->Enabled());
+  EXPECT_DOUBLE_EQ(0.2, sleepManager->LinearThreshold());
+  EXPECT_DOUBLE_EQ(0.3, sleepManager->AngularThreshold());
+  EXPECT_DOUBLE_EQ(2.0, sleepManager->SleepTime());
+
+  boost::any value;
+  EXPECT_TRUE(physics->GetParam("sleep_time", value));
+  EXPECT_DOUBLE_EQ(2.0, boost::any_cast<double>(value));
+
+  // Enabling requires contacts to detect wake ups
+  EXPECT_TRUE(physics->GetContactManager()->NeverDropContacts());
+  sleepManager->SetEnabled(false);
+  EXPECT_FALSE(physics->GetContactManager()->NeverDropContacts());
+}
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, SleepAndWake)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  physics::SleepManager *sleepManager = world->Physics()->SleepMgr();
+  sleepManager->SetEnabled(true);
+  sleepManager->SetSleepTime(0.1);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  auto link = box->GetLink();
+  ASSERT_NE(nullptr, link);
+
+  // Resting shapes fall asleep
+  world->Step(500);
+  EXPECT_TRUE(sleepManager->IsSleeping(box));
+  EXPECT_FALSE(link->GetEnabled());
+  EXPECT_GE(sleepManager->SleepingModelCount(), 1u);
+  EXPECT_GE(sleepManager->SleepingLinkCount(), 1u);
+
+  // Static models never sleep
+  EXPECT_FALSE(sleepManager->IsSleeping(world->ModelByName("ground_plane")));
+
+  // Explicit wake up
+  sleepManager->Wake(box);
+  EXPECT_FALSE(sleepManager->IsSleeping(box));
+  EXPECT_TRUE(link->GetEnabled());
+
+  // Disabling wakes up everything
+  world->Step(500);
+  EXPECT_TRUE(sleepManager->IsSleeping(box));
+  sleepManager->SetEnabled(false);
+  EXPECT_EQ(0u, sleepManager->SleepingModelCount());
+  EXPECT_TRUE(link->GetEnabled());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
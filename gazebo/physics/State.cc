@@ -15,6 +15,9 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "gazebo/common/Exception.hh"
 #include "gazebo/physics/State.hh"
 
@@ -131,3 +134,16 @@ void State::SetIterations(const uint64_t _iterations)
 {
   this->iterations = _iterations;
 }
+
+/////////////////////////////////////////////////
+bool State::IsNearZero(const ignition::math::Pose3d &_pose,
+    const double _tolerance)
+{
+  // The vector part of a unit quaternion is the rotation axis scaled by
+  // the sine of half the rotation angle.
+  const ignition::math::Vector3d axis(
+      _pose.Rot().X(), _pose.Rot().Y(), _pose.Rot().Z());
+  const double angle = 2.0 * std::asin(std::min(1.0, axis.Length()));
+
+  return _pose.Pos().Length() <= _tolerance && angle <= _tolerance;
+}
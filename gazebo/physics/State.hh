@@ -24,6 +24,7 @@
 #include <string>
 
 #include <sdf/sdf.hh>
+#include <ignition/math/Pose3.hh>
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/common/Time.hh"
@@ -120,6 +121,15 @@ namespace gazebo
       /// \param[in] _iterations Iterations when the data was recorded.
       public: virtual void SetIterations(const uint64_t _iterations);
 
+      /// \brief Get whether a pose difference, as computed by the
+      /// subtraction operators, is within a tolerance.
+      /// \param[in] _pose The pose difference.
+      /// \param[in] _tolerance Tolerance on the position in meters and on
+      /// the rotation angle in radians.
+      /// \return True if the difference is within the tolerance.
+      protected: static bool IsNearZero(const ignition::math::Pose3d &_pose,
+                                        const double _tolerance);
+
       /// \brief Name associated with this State
       protected: std::string name;
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/common/PluginProfiler.hh"
+#include "gazebo/common/Timestamp.hh"
+#include "gazebo/util/Diagnostics.hh"
+#include "gazebo/physics/UpdateScheduler.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A callback of the scheduler.
+    class ScheduledCallback
+    {
+      /// \brief Callback function.
+      public: UpdateScheduler::Callback callback;
+
+      /// \brief Name reported to the diagnostics.
+      public: std::string name;
+
+      /// \brief Requested rate in Hz.
+      public: double rate = 0;
+
+      /// \brief Requested phase, negative for automatic.
+      public: double phase = -1;
+
+      /// \brief Connection id.
+      public: int id = -1;
+
+      /// \brief Cleared when disconnected.
+      public: std::atomic_bool on{true};
+
+      /// \brief Number of iterations between calls, 0 until scheduled.
+      public: uint64_t period = 0;
+
+      /// \brief Iteration of the calls modulo the period.
+      public: uint64_t offset = 0;
+
+      /// \brief Next iteration to call the callback.
+      public: uint64_t next = 0;
+
+      /// \brief Total wall time spent in the callback.
+      public: common::Timestamp time;
+
+      /// \brief Number of calls.
+      public: uint64_t calls = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the UpdateScheduler class
+    class UpdateSchedulerPrivate
+    {
+      /// \brief Get the first iteration at or after another one that is
+      /// due for a callback.
+      /// \param[in] _iteration Earliest iteration.
+      /// \param[in] _cb The callback.
+      /// \return Iteration.
+      public: static uint64_t NextIteration(const uint64_t _iteration,
+                  const ScheduledCallback &_cb)
+      {
+        const uint64_t rem = _iteration % _cb.period;
+        return _iteration + (_cb.offset + _cb.period - rem) % _cb.period;
+      }
+
+      /// \brief Compute the period and offset of a callback.
+      /// \param[in] _cb The callback.
+      /// \param[in] _iteration Current world iteration.
+      public: void Schedule(ScheduledCallback &_cb, const uint64_t _iteration)
+      {
+        _cb.period = 1;
+        if (_cb.rate > 0 && this->stepSize > 0)
+        {
+          _cb.period = static_cast<uint64_t>(std::max(1.0,
+                std::round(1.0 / (_cb.rate * this->stepSize))));
+        }
+
+        if (_cb.phase >= 0)
+        {
+          _cb.offset = static_cast<uint64_t>(
+              std::floor(_cb.phase * _cb.period)) % _cb.period;
+        }
+        else
+        {
+          // Pick the offset that the fewest scheduled callbacks share
+          std::vector<unsigned int> load(_cb.period, 0);
+          for (auto const &other : this->callbacks)
+          {
+            if (other.get() == &_cb || other->period == 0 || !other->on)
+              continue;
+            for (uint64_t i = other->offset % other->period; i < _cb.period;
+                 i += other->period)
+            {
+              ++load[i];
+            }
+          }
+          _cb.offset = static_cast<uint64_t>(
+              std::min_element(load.begin(), load.end()) - load.begin());
+        }
+
+        _cb.next = NextIteration(_iteration, _cb);
+      }
+
+      /// \brief Scheduled callbacks, in the order they connected.
+      public: std::vector<std::unique_ptr<ScheduledCallback>> callbacks;
+
+      /// \brief Callbacks connected since the last update.
+      public: std::vector<std::unique_ptr<ScheduledCallback>> pending;
+
+      /// \brief Step size the callbacks were scheduled with.
+      public: double stepSize = 0;
+
+      /// \brief Id of the next connection.
+      public: int nextId = 0;
+
+      /// \brief True if disconnected callbacks wait to be removed.
+      public: std::atomic_bool cleanupNeeded{false};
+
+      /// \brief Protects the callback lists.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+UpdateScheduler::UpdateScheduler()
+  : dataPtr(new UpdateSchedulerPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+UpdateScheduler::~UpdateScheduler()
+{
+}
+
+//////////////////////////////////////////////////
+event::ConnectionPtr UpdateScheduler::Connect(const Callback &_callback,
+    const double _rate, const std::string &_name, const double _phase)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  std::unique_ptr<ScheduledCallback> cb(new ScheduledCallback);
+  cb->callback = common::PluginProfiler::Wrap(_callback);
+  cb->name = _name;
+  cb->rate = _rate;
+  cb->phase = _phase >= 0 ? std::fmod(_phase, 1.0) : -1.0;
+  cb->id = this->dataPtr->nextId++;
+
+  const int id = cb->id;
+  this->dataPtr->pending.push_back(std::move(cb));
+  return event::ConnectionPtr(new event::Connection(this, id));
+}
+
+//////////////////////////////////////////////////
+void UpdateScheduler::Disconnect(int _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  for (auto const &cb : this->dataPtr->callbacks)
+  {
+    if (cb->id == _id)
+    {
+      // Removed by the next update, the callbacks may be running
+      cb->on = false;
+      this->dataPtr->cleanupNeeded = true;
+      return;
+    }
+  }
+
+  auto iter = std::find_if(this->dataPtr->pending.begin(),
+      this->dataPtr->pending.end(),
+      [_id](const std::unique_ptr<ScheduledCallback> &_cb)
+      {
+        return _cb->id == _id;
+      });
+  if (iter != this->dataPtr->pending.end())
+    this->dataPtr->pending.erase(iter);
+}
+
+//////////////////////////////////////////////////
+unsigned int UpdateScheduler::ConnectionCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  unsigned int count = this->dataPtr->pending.size();
+  for (auto const &cb : this->dataPtr->callbacks)
+  {
+    if (cb->on)
+      ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+void UpdateScheduler::Update(const common::UpdateInfo &_info,
+    const uint64_t _iteration, const double _stepSize)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    if (this->dataPtr->cleanupNeeded)
+    {
+      auto &callbacks = this->dataPtr->callbacks;
+      callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+            [](const std::unique_ptr<ScheduledCallback> &_cb)
+            {
+              return !_cb->on;
+            }), callbacks.end());
+      this->dataPtr->cleanupNeeded = false;
+    }
+
+    if (std::abs(_stepSize - this->dataPtr->stepSize) > 1e-12)
+    {
+      this->dataPtr->stepSize = _stepSize;
+      for (auto &cb : this->dataPtr->callbacks)
+        cb->period = 0;
+      for (auto &cb : this->dataPtr->callbacks)
+        this->dataPtr->Schedule(*cb, _iteration);
+    }
+
+    for (auto &cb : this->dataPtr->pending)
+    {
+      this->dataPtr->callbacks.push_back(std::move(cb));
+      this->dataPtr->Schedule(*this->dataPtr->callbacks.back(), _iteration);
+    }
+    this->dataPtr->pending.clear();
+  }
+
+  this->SetSignaled(true);
+
+  // Index the callbacks, they may connect or disconnect others
+  for (size_t i = 0; i < this->dataPtr->callbacks.size(); ++i)
+  {
+    ScheduledCallback &cb = *this->dataPtr->callbacks[i];
+
+    // The iterations went back, e.g. after a reset
+    if (cb.next > _iteration + cb.period)
+      cb.next = UpdateSchedulerPrivate::NextIteration(_iteration, cb);
+
+    if (!cb.on || _iteration < cb.next)
+      continue;
+
+    const common::Timestamp start = common::Timestamp::Now();
+    cb.callback(_info);
+    const common::Timestamp elapsed = common::Timestamp::Now() - start;
+
+    cb.next = UpdateSchedulerPrivate::NextIteration(_iteration + 1, cb);
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      cb.time += elapsed;
+      ++cb.calls;
+    }
+
+    DIAG_VALUE("UpdateScheduler::" + cb.name + " ms", elapsed.Double() * 1e3);
+  }
+}
+
+//////////////////////////////////////////////////
+double UpdateScheduler::CallbackTime(const std::string &_name) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  common::Timestamp time;
+  for (auto const &cb : this->dataPtr->callbacks)
+  {
+    if (cb->name == _name)
+      time += cb->time;
+  }
+  return time.Double();
+}
+
+//////////////////////////////////////////////////
+uint64_t UpdateScheduler::CallCount(const std::string &_name) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  uint64_t calls = 0;
+  for (auto const &cb : this->dataPtr->callbacks)
+  {
+    if (cb->name == _name)
+      calls += cb->calls;
+  }
+  return calls;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_UPDATESCHEDULER_HH_
+#define GAZEBO_PHYSICS_UPDATESCHEDULER_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/UpdateInfo.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class UpdateSchedulerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class UpdateScheduler UpdateScheduler.hh physics/physics.hh
+    /// \brief Calls world update callbacks at a lower rate than physics.
+    ///
+    /// Many plugins only need to run at 10 to 50 Hz, but a callback
+    /// connected with event::Events::ConnectWorldUpdateBegin runs on every
+    /// physics step. A callback connected to the scheduler of a world runs
+    /// once every N iterations instead, where N is the closest whole number
+    /// of steps to its period. The steps of callbacks without a phase are
+    /// offset from each other, so that callbacks connected at the same rate
+    /// don't all run in the same iteration.
+    ///
+    /// The time spent in each callback is reported to the diagnostics as
+    /// "UpdateScheduler::<name> ms", and a running total is kept, see
+    /// CallbackTime.
+    ///
+    /// The world owns a scheduler, see World::Scheduler, and runs it right
+    /// after the world update begin event. Connections must be released
+    /// before the world is destroyed, which is the case for connections
+    /// held by plugins.
+    class GZ_PHYSICS_VISIBLE UpdateScheduler : public event::Event
+    {
+      /// \brief Callback type.
+      public: using Callback =
+                  std::function<void (const common::UpdateInfo &)>;
+
+      /// \brief Constructor.
+      public: UpdateScheduler();
+
+      /// \brief Destructor.
+      public: virtual ~UpdateScheduler();
+
+      /// \brief Connect a callback.
+      /// \param[in] _callback Function to call.
+      /// \param[in] _rate Update rate in Hz of simulation time. Zero or a
+      /// rate above the physics rate calls it on every iteration.
+      /// \param[in] _name Name reported to the diagnostics, typically the
+      /// name of the plugin.
+      /// \param[in] _phase Position of the calls within the period, in
+      /// [0, 1). Negative picks the least busy iterations.
+      /// \return Connection, which disconnects the callback when released.
+      public: event::ConnectionPtr Connect(const Callback &_callback,
+                  const double _rate, const std::string &_name,
+                  const double _phase = -1.0);
+
+      /// \brief Disconnect a callback.
+      /// \param[in] _id Id of the connection.
+      public: virtual void Disconnect(int _id) override;
+
+      /// \brief Get the number of connected callbacks.
+      /// \return Number of callbacks.
+      public: unsigned int ConnectionCount() const;
+
+      /// \brief Call the callbacks that are due.
+      /// \param[in] _info Passed to the callbacks.
+      /// \param[in] _iteration Current world iteration.
+      /// \param[in] _stepSize Physics step size in seconds.
+      public: void Update(const common::UpdateInfo &_info,
+                  const uint64_t _iteration, const double _stepSize);
+
+      /// \brief Get the total time spent in the callbacks with a name.
+      /// \param[in] _name Name given to Connect.
+      /// \return Wall time in seconds.
+      public: double CallbackTime(const std::string &_name) const;
+
+      /// \brief Get the number of calls of the callbacks with a name.
+      /// \param[in] _name Name given to Connect.
+      /// \return Number of calls.
+      public: uint64_t CallCount(const std::string &_name) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<UpdateSchedulerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "gazebo/physics/UpdateScheduler.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class UpdateSchedulerTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(UpdateSchedulerTest, Rate)
+{
+  physics::UpdateScheduler scheduler;
+  std::vector<uint64_t> full, slow;
+  uint64_t iteration = 0;
+
+  auto fullConn = scheduler.Connect([&](const common::UpdateInfo &)
+      {
+        full.push_back(iteration);
+      }, 0, "full");
+  auto slowConn = scheduler.Connect([&](const common::UpdateInfo &)
+      {
+        slow.push_back(iteration);
+      }, 100, "slow");
+  EXPECT_EQ(2u, scheduler.ConnectionCount());
+
+  // 1 kHz physics, the slow callback runs every 10 iterations
+  common::UpdateInfo info;
+  for (iteration = 0; iteration < 100; ++iteration)
+    scheduler.Update(info, iteration, 0.001);
+
+  EXPECT_EQ(100u, full.size());
+  ASSERT_EQ(10u, slow.size());
+  for (size_t i = 1; i < slow.size(); ++i)
+    EXPECT_EQ(10u, slow[i] - slow[i - 1]);
+  EXPECT_EQ(10u, scheduler.CallCount("slow"));
+  EXPECT_EQ(100u, scheduler.CallCount("full"));
+  EXPECT_EQ(0u, scheduler.CallCount("missing"));
+  EXPECT_GE(scheduler.CallbackTime("slow"), 0.0);
+
+  // Halving the step size doubles the period
+  slow.clear();
+  for (; iteration < 200; ++iteration)
+    scheduler.Update(info, iteration, 0.0005);
+  ASSERT_EQ(5u, slow.size());
+  for (size_t i = 1; i < slow.size(); ++i)
+    EXPECT_EQ(20u, slow[i] - slow[i - 1]);
+
+  // Released connections are no longer called
+  slowConn.reset();
+  EXPECT_EQ(1u, scheduler.ConnectionCount());
+  slow.clear();
+  for (; iteration < 300; ++iteration)
+    scheduler.Update(info, iteration, 0.001);
+  EXPECT_TRUE(slow.empty());
+  EXPECT_EQ(300u, full.size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(UpdateSchedulerTest, Phase)
+{
+  physics::UpdateScheduler scheduler;
+  std::vector<unsigned int> counts(10, 0);
+  std::vector<event::ConnectionPtr> connections;
+
+  // Callbacks without a phase are spread over the period
+  for (int i = 0; i < 10; ++i)
+  {
+    connections.push_back(scheduler.Connect(
+        [&counts](const common::UpdateInfo &_info)
+        {
+          ++counts[_info.simTime.nsec];
+        }, 10, "spread"));
+  }
+
+  common::UpdateInfo info;
+  for (uint64_t iteration = 0; iteration < 10; ++iteration)
+  {
+    info.simTime.nsec = iteration;
+    scheduler.Update(info, iteration, 0.01);
+  }
+  for (auto const count : counts)
+    EXPECT_EQ(1u, count);
+
+  connections.clear();
+
+  // A fixed phase
+  std::vector<uint64_t> calls;
+  uint64_t iteration = 100;
+  auto conn = scheduler.Connect([&](const common::UpdateInfo &)
+      {
+        calls.push_back(iteration);
+      }, 10, "phase", 0.5);
+  for (; iteration < 120; ++iteration)
+    scheduler.Update(info, iteration, 0.01);
+  ASSERT_EQ(2u, calls.size());
+  EXPECT_EQ(105u, calls[0]);
+  EXPECT_EQ(115u, calls[1]);
+
+  // The iterations going back, as after a reset
+  calls.clear();
+  for (iteration = 0; iteration < 10; ++iteration)
+    scheduler.Update(info, iteration, 0.01);
+  ASSERT_EQ(1u, calls.size());
+  EXPECT_EQ(5u, calls[0]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(UpdateSchedulerTest, ConnectFromCallback)
+{
+  physics::UpdateScheduler scheduler;
+  int inner = 0;
+  event::ConnectionPtr innerConn;
+  event::ConnectionPtr outerConn;
+  outerConn = scheduler.Connect([&](const common::UpdateInfo &)
+      {
+        if (!innerConn)
+        {
+          innerConn = scheduler.Connect([&](const common::UpdateInfo &)
+              {
+                ++inner;
+              }, 0, "inner");
+        }
+        // Disconnect itself
+        outerConn.reset();
+      }, 0, "outer");
+
+  common::UpdateInfo info;
+  scheduler.Update(info, 0, 0.001);
+  EXPECT_EQ(0, inner);
+  EXPECT_EQ(1u, scheduler.ConnectionCount());
+
+  scheduler.Update(info, 1, 0.001);
+  scheduler.Update(info, 2, 0.001);
+  EXPECT_EQ(2, inner);
+  EXPECT_EQ(2u, scheduler.CallCount("inner"));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
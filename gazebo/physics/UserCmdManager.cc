@@ -14,11 +14,13 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
 #include "gazebo/transport/transport.hh"
 
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/WorldState.hh"
 
@@ -28,12 +30,69 @@
 using namespace gazebo;
 using namespace physics;
 
+/////////////////////////////////////////////////
+/// \brief Get the names of the models of a state.
+/// \param[in] _state The state.
+/// \param[in,out] _names The names are appended, without duplicates.
+static void AppendStateNames(const WorldState &_state,
+    std::vector<std::string> &_names)
+{
+  for (auto const &model : _state.GetModelStates())
+  {
+    if (std::find(_names.begin(), _names.end(), model.first) == _names.end())
+      _names.push_back(model.first);
+  }
+}
+
+/////////////////////////////////////////////////
+WorldState UserCmdPrivate::Capture(
+    const std::vector<std::string> &_modelNames, const bool _allModels) const
+{
+  if (_allModels)
+    return WorldState(this->world);
+
+  Model_V models;
+  for (auto const &name : _modelNames)
+  {
+    ModelPtr model = this->world->ModelByName(name);
+    if (model)
+      models.push_back(model);
+  }
+
+  WorldState state;
+  state.Load(this->world, models);
+  return state;
+}
+
+/////////////////////////////////////////////////
+void UserCmdPrivate::Apply(const WorldState &_state) const
+{
+  // Reset physics states of the models which are about to be set
+  for (auto const &modelState : _state.GetModelStates())
+  {
+    ModelPtr model = this->world->ModelByName(modelState.first);
+    if (model)
+      model->ResetPhysicsStates();
+  }
+
+  this->world->SetState(_state);
+}
 
 /////////////////////////////////////////////////
 UserCmd::UserCmd(const unsigned int _id,
                  physics::WorldPtr _world,
                  const std::string &_description,
                  const msgs::UserCmd::Type &_type)
+  : UserCmd(_id, _world, _description, _type, std::vector<std::string>())
+{
+}
+
+/////////////////////////////////////////////////
+UserCmd::UserCmd(const unsigned int _id,
+                 physics::WorldPtr _world,
+                 const std::string &_description,
+                 const msgs::UserCmd::Type &_type,
+                 const std::vector<std::string> &_modelNames)
   : dataPtr(new UserCmdPrivate())
 {
   this->dataPtr->id = _id;
@@ -41,8 +100,21 @@ UserCmd::UserCmd(const unsigned int _id,
   this->dataPtr->description = _description;
   this->dataPtr->type = _type;
 
-  // Record current world state
-  this->dataPtr->startState = WorldState(this->dataPtr->world);
+  for (auto const &name : _modelNames)
+  {
+    // States are kept per top level model
+    const std::string topName = name.substr(0, name.find("::"));
+    if (std::find(this->dataPtr->modelNames.begin(),
+          this->dataPtr->modelNames.end(), topName) ==
+        this->dataPtr->modelNames.end())
+    {
+      this->dataPtr->modelNames.push_back(topName);
+    }
+  }
+
+  // Record current state
+  this->dataPtr->startState = this->dataPtr->Capture(
+      this->dataPtr->modelNames, this->dataPtr->modelNames.empty());
 }
 
 /////////////////////////////////////////////////
@@ -56,27 +128,50 @@ UserCmd::~UserCmd()
   this->dataPtr = NULL;
 }
 
+/////////////////////////////////////////////////
+void UserCmd::Complete()
+{
+  if (this->dataPtr->complete)
+    return;
+
+  // Keep the full states of the models and lights which changed, before and
+  // after, and drop the rest of the snapshot
+  WorldState state = this->dataPtr->Capture(this->dataPtr->modelNames,
+      this->dataPtr->modelNames.empty());
+  WorldState startState = this->dataPtr->startState;
+  this->dataPtr->endState = state.Changes(startState, 0);
+  this->dataPtr->startState = startState.Changes(state, 0);
+
+  this->dataPtr->complete = true;
+}
+
+/////////////////////////////////////////////////
+bool UserCmd::IsComplete() const
+{
+  return this->dataPtr->complete;
+}
+
 /////////////////////////////////////////////////
 void UserCmd::Undo()
 {
-  // Record / override the state for redo
-  this->dataPtr->endState = WorldState(this->dataPtr->world);
+  this->Complete();
 
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
+  // Record / override the state for redo, only for the entities changed by
+  // the command
+  std::vector<std::string> names;
+  AppendStateNames(this->dataPtr->startState, names);
+  AppendStateNames(this->dataPtr->endState, names);
+  this->dataPtr->endState = this->dataPtr->Capture(names, false);
 
   // Set state to the moment the command was executed
-  this->dataPtr->world->SetState(this->dataPtr->startState);
+  this->dataPtr->Apply(this->dataPtr->startState);
 }
 
 /////////////////////////////////////////////////
 void UserCmd::Redo()
 {
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
-
   // Set state to the moment undo was triggered
-  this->dataPtr->world->SetState(this->dataPtr->endState);
+  this->dataPtr->Apply(this->dataPtr->endState);
 }
 
 /////////////////////////////////////////////////
@@ -160,9 +255,35 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
   // Generate unique id
   unsigned int id = this->dataPtr->idCounter++;
 
+  // The previous command has been executed by now, keep only what it
+  // changed
+  if (!this->dataPtr->undoCmds.empty())
+    this->dataPtr->undoCmds.back()->Complete();
+
+  // Only record the models the command can change, lights are cheap and
+  // always recorded
+  std::vector<std::string> modelNames;
+  switch (_msg->type())
+  {
+    case msgs::UserCmd::MOVING:
+    case msgs::UserCmd::SCALING:
+    {
+      for (int i = 0; i < _msg->model_size(); ++i)
+        modelNames.push_back(_msg->model(i).name());
+      break;
+    }
+    case msgs::UserCmd::WRENCH:
+    {
+      modelNames.push_back(_msg->entity_name());
+      break;
+    }
+    default:
+      break;
+  }
+
   // Create command
   UserCmdPtr cmd(new UserCmd(id, this->dataPtr->world, _msg->description(),
-      _msg->type()));
+      _msg->type(), modelNames));
 
   // Forward message after we've saved the current state
   switch (_msg->type())
@@ -18,6 +18,7 @@
 #define GAZEBO_PHYSICS_USERCMDMANAGER_HH_
 
 #include <string>
+#include <vector>
 
 #include "gazebo/transport/TransportTypes.hh"
 
@@ -45,9 +46,35 @@ namespace gazebo
                       const std::string &_description,
                       const msgs::UserCmd::Type &_type);
 
+      /// \brief Constructor which only records the state of some models,
+      /// and of the lights.
+      /// \param[in] _id Unique ID for this command
+      /// \param[in] _world Pointer to the world
+      /// \param[in] _description Description for the command, such as
+      /// "Rotate box", "Delete sphere", etc.
+      /// \param[in] _type Type of command, such as MOVING, DELETING, etc.
+      /// \param[in] _modelNames Names of the models the command can change.
+      /// Scoped names are reduced to their top level model. Empty to record
+      /// the whole world.
+      public: UserCmd(const unsigned int _id,
+                      physics::WorldPtr _world,
+                      const std::string &_description,
+                      const msgs::UserCmd::Type &_type,
+                      const std::vector<std::string> &_modelNames);
+
       /// \brief Destructor
       public: virtual ~UserCmd();
 
+      /// \brief Record the state of the world once the command has been
+      /// executed, and only keep the states of the models and lights it
+      /// changed, before and after. Called by UserCmdManager when the next
+      /// command arrives and by Undo. Does nothing after the first call.
+      public: void Complete();
+
+      /// \brief Get whether Complete was called.
+      /// \return True if only the changed states are kept.
+      public: bool IsComplete() const;
+
       /// \brief Undo this command.
       public: virtual void Undo();
 
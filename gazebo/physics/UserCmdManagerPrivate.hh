@@ -35,16 +35,37 @@ namespace gazebo
     /// \brief Private data for the UserCmdManager class
     class UserCmdPrivate
     {
+      /// \brief Record the state of some models and of the lights.
+      /// \param[in] _modelNames Names of top level models.
+      /// \param[in] _allModels True to record every model instead.
+      /// \return The state.
+      public: WorldState Capture(const std::vector<std::string> &_modelNames,
+                  const bool _allModels) const;
+
+      /// \brief Reset the physics states of the models of a state and set
+      /// the state to the world.
+      /// \param[in] _state The state.
+      public: void Apply(const WorldState &_state) const;
+
       /// \brief Pointer to the world.
       public: WorldPtr world;
 
-      /// \brief Whole world state the moment the user command was executed.
+      /// \brief State the moment the user command was executed. Once the
+      /// command is complete, only the models and lights it changed.
       public: WorldState startState;
 
-      /// \brief Whole world state for the most recent time the user has
+      /// \brief State of the models and lights changed by the command, when
+      /// it completed and then for the most recent time the user has
       /// triggered undo for this command.
       public: WorldState endState;
 
+      /// \brief Top level models the command can change, empty for the
+      /// whole world.
+      public: std::vector<std::string> modelNames;
+
+      /// \brief True once the states were reduced to the changed entities.
+      public: bool complete = false;
+
       /// \brief Unique ID identifying this command in the server.
       public: unsigned int id;
 
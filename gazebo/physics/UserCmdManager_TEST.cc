@@ -15,6 +15,7 @@
  *
 */
 
+#include <string>
 #include <sdf/sdf.hh>
 
 #include "gazebo/test/ServerFixture.hh"
@@ -61,6 +62,57 @@ TEST_F(UserCmdManagerTest, CreateCmd)
   manager = NULL;
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, UndoChangedModels)
+{
+  Load("test/worlds/empty_test.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+  SpawnBox("other_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(3, 0, 0.5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr box = world->ModelByName("box");
+  physics::ModelPtr otherBox = world->ModelByName("other_box");
+  ASSERT_TRUE(box != NULL);
+  ASSERT_TRUE(otherBox != NULL);
+
+  const ignition::math::Pose3d boxStart = box->WorldPose();
+  const ignition::math::Pose3d boxEnd(1, 2, 0.5, 0, 0, 0.3);
+  const ignition::math::Pose3d otherEnd(3, 4, 0.5, 0, 0, 0);
+
+  // Command recording the whole world, which only moves the box
+  physics::UserCmd cmd(0, world, "Move box", msgs::UserCmd::MOVING);
+  EXPECT_FALSE(cmd.IsComplete());
+  box->SetWorldPose(boxEnd);
+  cmd.Complete();
+  EXPECT_TRUE(cmd.IsComplete());
+
+  // Moved after the command completed, not undone
+  otherBox->SetWorldPose(otherEnd);
+
+  cmd.Undo();
+  EXPECT_EQ(boxStart, box->WorldPose());
+  EXPECT_EQ(otherEnd, otherBox->WorldPose());
+
+  cmd.Redo();
+  EXPECT_EQ(boxEnd, box->WorldPose());
+  EXPECT_EQ(otherEnd, otherBox->WorldPose());
+
+  // Command recording only the box, completed lazily by undo
+  physics::UserCmd boxCmd(1, world, "Move box", msgs::UserCmd::MOVING,
+      {"box::link"});
+  box->SetWorldPose(boxStart);
+  boxCmd.Undo();
+  EXPECT_TRUE(boxCmd.IsComplete());
+  EXPECT_EQ(boxEnd, box->WorldPose());
+
+  boxCmd.Redo();
+  EXPECT_EQ(boxStart, box->WorldPose());
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -15,16 +15,21 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <boost/lexical_cast.hpp>
 #include <sdf/sdf.hh>
 
+#include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3.hh>
 
+#include "gazebo/common/Events.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/Link.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Wind.hh"
 #include "gazebo/physics/World.hh"
@@ -44,6 +49,15 @@ namespace gazebo
       {
       }
 
+      /// \brief Sample the wind field at a list of positions.
+      /// \param[in] _positions Positions in the world frame.
+      /// \param[in] _time Sim time in seconds.
+      /// \param[out] _vels Wind velocity at each position.
+      public: void SampleField(
+                  const std::vector<ignition::math::Vector3d> &_positions,
+                  const double _time,
+                  std::vector<ignition::math::Vector3d> &_vels) const;
+
       /// \brief Reference to the world.
       public: World &world;
 
@@ -57,6 +71,49 @@ namespace gazebo
       public: std::function< ignition::math::Vector3d (
                   const Wind *, const Entity *)> linearVelFunc;
 
+      /// \brief True if linearVelFunc was set by the user.
+      public: bool customFunc = false;
+
+      /// \brief Position of the first node of the wind field.
+      public: ignition::math::Vector3d fieldOrigin;
+
+      /// \brief Distance between the nodes of the wind field.
+      public: ignition::math::Vector3d fieldSpacing;
+
+      /// \brief Number of nodes of the wind field along each axis.
+      public: ignition::math::Vector3i fieldSize;
+
+      /// \brief Velocity at the nodes of each frame of the wind field, empty
+      /// if there is no field.
+      public: std::vector<std::vector<ignition::math::Vector3d>> fieldFrames;
+
+      /// \brief Sim time between two frames of the wind field.
+      public: double fieldPeriod = 0;
+
+      /// \brief Standard deviation of the turbulence velocity.
+      public: double turbulenceStdDev = 0;
+
+      /// \brief Correlation time of the turbulence.
+      public: double turbulenceTime = 1;
+
+      /// \brief Links whose wind velocity is sampled every world update.
+      public: std::vector<Link *> links;
+
+      /// \brief Turbulence velocity of each link.
+      public: std::vector<ignition::math::Vector3d> gusts;
+
+      /// \brief Positions of the links, reused between updates.
+      public: std::vector<ignition::math::Vector3d> positions;
+
+      /// \brief Wind velocities of the links, reused between updates.
+      public: std::vector<ignition::math::Vector3d> vels;
+
+      /// \brief Sim time of the last update.
+      public: common::Time prevTime;
+
+      /// \brief Connection to the world update begin event.
+      public: event::ConnectionPtr updateConnection;
+
       // Transport is declared last.
       /// \brief Node for communication.
       public: transport::NodePtr node;
@@ -95,11 +152,16 @@ Wind::Wind(World &_world, sdf::ElementPtr _sdf)
 
   this->SetLinearVelFunc(std::bind(&Wind::LinearVelDefault, this,
         std::placeholders::_1, std::placeholders::_2));
+  this->dataPtr->customFunc = false;
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&Wind::Update, this, std::placeholders::_1));
 }
 
 //////////////////////////////////////////////////
 Wind::~Wind()
 {
+  this->dataPtr->updateConnection.reset();
   this->dataPtr->windSub.reset();
   this->dataPtr->requestSub.reset();
   this->dataPtr->responsePub.reset();
@@ -109,9 +171,15 @@ Wind::~Wind()
 
 //////////////////////////////////////////////////
 ignition::math::Vector3d Wind::LinearVelDefault(
-    const Wind *_wind, const Entity */*_entity*/)
+    const Wind *_wind, const Entity *_entity)
 {
-  return _wind->LinearVel();
+  if (this->dataPtr->fieldFrames.empty() || !_entity)
+    return _wind->LinearVel();
+
+  std::vector<ignition::math::Vector3d> vels;
+  this->dataPtr->SampleField({_entity->WorldPose().Pos()},
+      this->dataPtr->world.SimTime().Double(), vels);
+  return vels[0];
 }
 
 //////////////////////////////////////////////////
@@ -239,4 +307,236 @@ void Wind::SetLinearVelFunc(std::function< ignition::math::Vector3d (
     const Wind *, const Entity *_entity) > _linearVelFunc)
 {
   this->dataPtr->linearVelFunc = _linearVelFunc;
+  this->dataPtr->customFunc = true;
+}
+
+/////////////////////////////////////////////////
+bool Wind::SetField(const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_spacing,
+    const ignition::math::Vector3i &_size,
+    const std::vector<std::vector<ignition::math::Vector3d>> &_frames,
+    const double _period)
+{
+  if (_size.X() < 1 || _size.Y() < 1 || _size.Z() < 1)
+  {
+    gzerr << "Invalid wind field size [" << _size << "]\n";
+    return false;
+  }
+
+  if (_frames.empty())
+  {
+    gzerr << "A wind field needs at least one frame\n";
+    return false;
+  }
+
+  const size_t nodes = static_cast<size_t>(_size.X()) * _size.Y() * _size.Z();
+  for (auto const &frame : _frames)
+  {
+    if (frame.size() != nodes)
+    {
+      gzerr << "Wind field frame has [" << frame.size() << "] nodes instead "
+            << "of [" << nodes << "]\n";
+      return false;
+    }
+  }
+
+  if (_frames.size() > 1 && _period <= 0)
+  {
+    gzerr << "Invalid wind field period [" << _period << "]\n";
+    return false;
+  }
+
+  this->dataPtr->fieldOrigin = _origin;
+  this->dataPtr->fieldSpacing = _spacing;
+  this->dataPtr->fieldSize = _size;
+  this->dataPtr->fieldFrames = _frames;
+  this->dataPtr->fieldPeriod = _period;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Wind::ClearField()
+{
+  this->dataPtr->fieldFrames.clear();
+}
+
+/////////////////////////////////////////////////
+bool Wind::HasField() const
+{
+  return !this->dataPtr->fieldFrames.empty();
+}
+
+/////////////////////////////////////////////////
+void Wind::SetTurbulence(const double _stdDev, const double _correlationTime)
+{
+  this->dataPtr->turbulenceStdDev = std::max(0.0, _stdDev);
+  this->dataPtr->turbulenceTime = std::max(1e-6, _correlationTime);
+
+  if (this->dataPtr->turbulenceStdDev <= 0)
+  {
+    std::fill(this->dataPtr->gusts.begin(), this->dataPtr->gusts.end(),
+        ignition::math::Vector3d::Zero);
+  }
+}
+
+/////////////////////////////////////////////////
+void Wind::AddLink(Link *_link)
+{
+  if (!_link || std::find(this->dataPtr->links.begin(),
+        this->dataPtr->links.end(), _link) != this->dataPtr->links.end())
+  {
+    return;
+  }
+
+  this->dataPtr->links.push_back(_link);
+  this->dataPtr->gusts.push_back(ignition::math::Vector3d::Zero);
+}
+
+/////////////////////////////////////////////////
+void Wind::RemoveLink(Link *_link)
+{
+  auto iter = std::find(this->dataPtr->links.begin(),
+      this->dataPtr->links.end(), _link);
+  if (iter == this->dataPtr->links.end())
+    return;
+
+  const size_t index = iter - this->dataPtr->links.begin();
+  this->dataPtr->links.erase(iter);
+  this->dataPtr->gusts.erase(this->dataPtr->gusts.begin() + index);
+}
+
+/////////////////////////////////////////////////
+void Wind::Update(const common::UpdateInfo &_info)
+{
+  if (_info.worldName != this->dataPtr->world.Name() ||
+      this->dataPtr->links.empty())
+  {
+    return;
+  }
+
+  const double dt = (_info.simTime - this->dataPtr->prevTime).Double();
+  this->dataPtr->prevTime = _info.simTime;
+
+  const std::vector<Link *> &links = this->dataPtr->links;
+  std::vector<ignition::math::Vector3d> &vels = this->dataPtr->vels;
+  vels.resize(links.size());
+
+  if (this->dataPtr->customFunc)
+  {
+    for (size_t i = 0; i < links.size(); ++i)
+      vels[i] = this->dataPtr->linearVelFunc(this, links[i]);
+  }
+  else if (!this->dataPtr->fieldFrames.empty())
+  {
+    std::vector<ignition::math::Vector3d> &positions =
+        this->dataPtr->positions;
+    positions.resize(links.size());
+    for (size_t i = 0; i < links.size(); ++i)
+      positions[i] = links[i]->WorldPose().Pos();
+
+    this->dataPtr->SampleField(positions, _info.simTime.Double(), vels);
+  }
+  else
+  {
+    std::fill(vels.begin(), vels.end(), this->dataPtr->linearVel);
+  }
+
+  // Discrete first order Gauss-Markov process, stationary with the
+  // requested standard deviation whatever the step size
+  std::vector<ignition::math::Vector3d> &gusts = this->dataPtr->gusts;
+  if (this->dataPtr->turbulenceStdDev > 0 && dt > 0)
+  {
+    const double a = std::exp(-dt / this->dataPtr->turbulenceTime);
+    const double b = this->dataPtr->turbulenceStdDev * std::sqrt(1 - a * a);
+    for (auto &gust : gusts)
+    {
+      gust = a * gust + b * ignition::math::Vector3d(
+          ignition::math::Rand::DblNormal(0, 1),
+          ignition::math::Rand::DblNormal(0, 1),
+          ignition::math::Rand::DblNormal(0, 1));
+    }
+  }
+
+  for (size_t i = 0; i < links.size(); ++i)
+    links[i]->SetWorldWindLinearVel(vels[i] + gusts[i]);
+}
+
+/////////////////////////////////////////////////
+void WindPrivate::SampleField(
+    const std::vector<ignition::math::Vector3d> &_positions,
+    const double _time, std::vector<ignition::math::Vector3d> &_vels) const
+{
+  _vels.resize(_positions.size());
+
+  // Frames to blend, looping
+  const size_t frameCount = this->fieldFrames.size();
+  size_t frame0 = 0;
+  size_t frame1 = 0;
+  double blend = 0;
+  if (frameCount > 1)
+  {
+    double t = std::fmod(_time / this->fieldPeriod,
+        static_cast<double>(frameCount));
+    if (t < 0)
+      t += frameCount;
+    frame0 = std::min(static_cast<size_t>(t), frameCount - 1);
+    frame1 = (frame0 + 1) % frameCount;
+    blend = t - frame0;
+  }
+  const std::vector<ignition::math::Vector3d> &a = this->fieldFrames[frame0];
+  const std::vector<ignition::math::Vector3d> &b = this->fieldFrames[frame1];
+
+  const int size[3] = {this->fieldSize.X(), this->fieldSize.Y(),
+      this->fieldSize.Z()};
+  const size_t stride[3] = {1, static_cast<size_t>(size[0]),
+      static_cast<size_t>(size[0]) * size[1]};
+
+  for (size_t p = 0; p < _positions.size(); ++p)
+  {
+    // Lower node and weight of the upper node along each axis
+    size_t node[3];
+    size_t step[3];
+    double w[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      node[axis] = 0;
+      step[axis] = 0;
+      w[axis] = 0;
+      if (size[axis] < 2 || this->fieldSpacing[axis] <= 0)
+        continue;
+
+      double u = (_positions[p][axis] - this->fieldOrigin[axis]) /
+          this->fieldSpacing[axis];
+      u = ignition::math::clamp(u, 0.0, size[axis] - 1.0);
+      const size_t i = std::min(static_cast<size_t>(u),
+          static_cast<size_t>(size[axis] - 2));
+      node[axis] = i * stride[axis];
+      step[axis] = stride[axis];
+      w[axis] = u - i;
+    }
+
+    ignition::math::Vector3d vel;
+    const size_t base = node[0] + node[1] + node[2];
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      double weight = 1;
+      size_t index = base;
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        if (corner & (1 << axis))
+        {
+          weight *= w[axis];
+          index += step[axis];
+        }
+        else
+        {
+          weight *= 1 - w[axis];
+        }
+      }
+
+      if (weight > 0)
+        vel += weight * ((1 - blend) * a[index] + blend * b[index]);
+    }
+    _vels[p] = vel;
+  }
 }
@@ -20,8 +20,11 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <vector>
 #include <boost/any.hpp>
+#include <ignition/math/Vector3.hh>
 
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/util/system.hh"
@@ -38,6 +41,12 @@ namespace gazebo
 
     /// \class Wind Wind.hh physics/physics.hh
     /// \brief Base class for wind.
+    ///
+    /// The wind velocity of every link with wind enabled is sampled in one
+    /// pass at the start of each world update, see AddLink. The velocity
+    /// comes from the function set with SetLinearVelFunc if any, else from
+    /// the wind field set with SetField if any, else it is the global
+    /// LinearVel. Turbulence, see SetTurbulence, is added on top.
     class GZ_PHYSICS_VISIBLE Wind
     {
       /// \brief Default constructor.
@@ -114,7 +123,55 @@ namespace gazebo
       public: void SetLinearVelFunc(std::function< ignition::math::Vector3d (
           const Wind *_wind, const Entity *_entity) > _linearVelFunc);
 
-      /// \brief Get the global wind velocity, ignoring the entity.
+      /// \brief Set a wind field sampled on a regular grid, interpolated
+      /// linearly in space and in time. Positions outside the grid get the
+      /// velocity of the nearest boundary.
+      /// \param[in] _origin Position of the first node, in the world frame.
+      /// \param[in] _spacing Distance between two nodes along each axis.
+      /// \param[in] _size Number of nodes along each axis, at least 1.
+      /// \param[in] _frames Velocity at every node for each frame of the
+      /// field, x varying fastest, then y, then z.
+      /// \param[in] _period Sim time between two frames, in seconds. The
+      /// frames loop. Ignored if there is only one frame.
+      /// \return False, and the field unchanged, if the sizes don't match.
+      /// \sa ClearField
+      public: bool SetField(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_spacing,
+                  const ignition::math::Vector3i &_size,
+                  const std::vector<std::vector<ignition::math::Vector3d>>
+                  &_frames, const double _period);
+
+      /// \brief Remove the wind field, and use the global wind velocity.
+      public: void ClearField();
+
+      /// \brief Get whether a wind field is set.
+      /// \return True if SetField was called since the last ClearField.
+      public: bool HasField() const;
+
+      /// \brief Set the turbulence added to the wind velocity of each link,
+      /// a first order Gauss-Markov process per link and per axis.
+      /// \param[in] _stdDev Standard deviation of the turbulence velocity,
+      /// zero to disable it.
+      /// \param[in] _correlationTime Correlation time of the turbulence, in
+      /// seconds of sim time.
+      public: void SetTurbulence(const double _stdDev,
+                  const double _correlationTime);
+
+      /// \brief Add a link to the links whose wind velocity is sampled every
+      /// world update. Called by Link::SetWindEnabled.
+      /// \param[in] _link The link.
+      public: void AddLink(Link *_link);
+
+      /// \brief Remove a link added with AddLink.
+      /// \param[in] _link The link.
+      public: void RemoveLink(Link *_link);
+
+      /// \brief Sample the wind velocity of all the links.
+      /// \param[in] _info World update information.
+      private: void Update(const common::UpdateInfo &_info);
+
+      /// \brief Get the global wind velocity, or the velocity of the wind
+      /// field at the entity location if a field is set.
       /// \param[in] _wind Reference to the wind.
       /// \param[in] _entity Pointer to an entity at which location the wind
       /// velocity is to be calculated.
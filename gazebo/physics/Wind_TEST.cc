@@ -15,6 +15,7 @@
  *
 */
 #include <memory>
+#include <vector>
 
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -221,6 +222,68 @@ TEST_F(WindTest, WindSetLinearVelFunc)
   WindSetLinearVelFunc();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WindTest, WindField)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(1, 0, 0.5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != NULL);
+
+  physics::Wind &wind = world->Wind();
+  wind.SetLinearVel(ignition::math::Vector3d(0, 3, 0));
+  EXPECT_FALSE(wind.HasField());
+
+  // Two nodes along x, 2 m apart, a single frame
+  const ignition::math::Vector3d origin(0, 0, 0);
+  const ignition::math::Vector3d spacing(2, 1, 1);
+  std::vector<std::vector<ignition::math::Vector3d>> frames(1);
+  frames[0].push_back(ignition::math::Vector3d(0, 0, 0));
+  frames[0].push_back(ignition::math::Vector3d(2, 0, 0));
+
+  // Wrong sizes are rejected
+  EXPECT_FALSE(wind.SetField(origin, spacing,
+        ignition::math::Vector3i(3, 1, 1), frames, 0));
+  EXPECT_FALSE(wind.SetField(origin, spacing,
+        ignition::math::Vector3i(0, 1, 1), frames, 0));
+  EXPECT_FALSE(wind.HasField());
+
+  EXPECT_TRUE(wind.SetField(origin, spacing,
+        ignition::math::Vector3i(2, 1, 1), frames, 0));
+  EXPECT_TRUE(wind.HasField());
+
+  // Halfway between the two nodes
+  EXPECT_EQ(ignition::math::Vector3d(1, 0, 0),
+      wind.WorldLinearVel(model.get()));
+
+  // Beyond the last node
+  model->SetWorldPose(ignition::math::Pose3d(5, 0, 0.5, 0, 0, 0));
+  EXPECT_EQ(ignition::math::Vector3d(2, 0, 0),
+      wind.WorldLinearVel(model.get()));
+
+  // The links with wind enabled are updated every world update
+  physics::LinkPtr link = model->GetLink("body");
+  ASSERT_TRUE(link != NULL);
+  link->SetWindMode(true);
+  world->Step(1);
+  EXPECT_EQ(ignition::math::Vector3d(2, 0, 0), link->WorldWindLinearVel());
+
+  // Back to the global wind velocity
+  wind.ClearField();
+  EXPECT_FALSE(wind.HasField());
+  world->Step(1);
+  EXPECT_EQ(ignition::math::Vector3d(0, 3, 0), link->WorldWindLinearVel());
+
+  // Disabling wind on the link zeroes its wind velocity
+  link->SetWindMode(false);
+  EXPECT_EQ(ignition::math::Vector3d::Zero, link->WorldWindLinearVel());
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -17,15 +17,29 @@
 
 #include <time.h>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
 #include <deque>
+#include <future>
 #include <list>
+#include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -36,7 +50,7 @@
 #include <ignition/msgs/plugin_v.pb.h>
 #include <ignition/msgs/stringmsg.pb.h>
 
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
 #include <ignition/common/URI.hh>
 #include "gazebo/common/FuelModelDatabase.hh"
 
@@ -44,15 +58,20 @@
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/Subscriber.hh"
+#include "gazebo/transport/TopicStatistics.hh"
 
 #include "gazebo/util/LogPlay.hh"
 
+#include "gazebo/common/MemoryAccounting.hh"
+#include "gazebo/common/MeshManager.hh"
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/PluginProfiler.hh"
+#include "gazebo/common/PluginRegistry.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/URI.hh"
@@ -81,10 +100,12 @@
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
+#include "gazebo/common/SystemPaths.hh"
 
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/Population.hh"
+#include "gazebo/physics/SleepManager.hh"
 
 using namespace gazebo;
 using namespace physics;
@@ -93,6 +114,407 @@ using namespace physics;
 /// This will be replaced with a class member variable in Gazebo 3.0
 bool g_clearModels;
 
+/// \brief Wall time between two messages on ~/plugins/stats.
+static const common::Time PLUGIN_STATS_PERIOD(1, 0);
+
+/// \brief Wall time between two messages on ~/transport/stats.
+static const common::Time TRANSPORT_STATS_PERIOD(1, 0);
+
+/// \brief Wall time over which the phase times sent with the world
+/// statistics are averaged, in nanoseconds.
+static const common::Timestamp PHASE_TIMES_PERIOD(1000000000);
+
+/// \brief Upper bounds of the buckets of the step period histogram, as
+/// the wall time in seconds by which an update started after its deadline.
+static const std::vector<double> STEP_LATENESS_BOUNDS =
+  {1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3, 1e-2};
+
+/// \brief Wall time before the start of a step during which the world
+/// thread spins instead of sleeping in real-time mode, in nanoseconds. It
+/// covers the wake up latency of the thread.
+static const common::Timestamp REAL_TIME_SPIN(200000);
+
+//////////////////////////////////////////////////
+/// \brief Get whether an SDF element or its children hold a sensor that
+/// renders the visuals of the world.
+/// \param[in] _elem SDF element.
+/// \return True if a rendering sensor was found.
+static bool HasRenderingSensor(sdf::ElementPtr _elem)
+{
+  if (_elem->GetName() == "sensor" && _elem->HasAttribute("type"))
+  {
+    const std::string type = _elem->Get<std::string>("type");
+    if (type == "camera" || type == "depth" || type == "multicamera" ||
+        type == "wideanglecamera" || type == "gpu_ray" || type == "gpu_lidar")
+    {
+      return true;
+    }
+  }
+
+  for (sdf::ElementPtr child = _elem->GetFirstElement(); child;
+       child = child->GetNextElement())
+  {
+    if (HasRenderingSensor(child))
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the URIs of the meshes in an SDF element and its
+/// children.
+/// \param[in] _elem SDF element.
+/// \param[in] _visuals False to skip the meshes of visuals.
+/// \param[in,out] _uris Set of mesh URIs.
+static void CollectMeshUris(sdf::ElementPtr _elem, const bool _visuals,
+    std::set<std::string> &_uris)
+{
+  if (!_visuals && _elem->GetName() == "visual")
+    return;
+
+  if (_elem->GetName() == "mesh" && _elem->HasElement("uri"))
+  {
+    const std::string uri = _elem->Get<std::string>("uri");
+    if (!uri.empty() && uri != "__default__")
+      _uris.insert(uri);
+  }
+
+  for (sdf::ElementPtr child = _elem->GetFirstElement(); child;
+       child = child->GetNextElement())
+  {
+    CollectMeshUris(child, _visuals, _uris);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the library filenames of the plugins of an SDF element
+/// and its children, leaving out the visual plugins which the server
+/// doesn't load.
+/// \param[in] _elem SDF element.
+/// \param[in,out] _filenames Library filenames found.
+static void CollectPluginFilenames(sdf::ElementPtr _elem,
+    std::set<std::string> &_filenames)
+{
+  if (_elem->GetName() == "visual")
+    return;
+
+  if (_elem->GetName() == "plugin" && _elem->HasAttribute("filename"))
+  {
+    const std::string filename = _elem->Get<std::string>("filename");
+    if (!filename.empty() && filename != "__default__")
+      _filenames.insert(filename);
+    return;
+  }
+
+  for (sdf::ElementPtr child = _elem->GetFirstElement(); child;
+       child = child->GetNextElement())
+  {
+    CollectPluginFilenames(child, _filenames);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the model a resource URI belongs to. Resources of the same
+/// model are resolved one after another, so that a model is not
+/// downloaded by several threads at the same time.
+/// \param[in] _uri Resource URI.
+/// \return model://<name> for model URIs, the URI up to the files of the
+/// model for Fuel URIs, or the URI itself.
+static std::string ResourceModel(const std::string &_uri)
+{
+  const std::string modelPrefix = "model://";
+  if (_uri.compare(0, modelPrefix.size(), modelPrefix) == 0)
+    return _uri.substr(0, _uri.find('/', modelPrefix.size()));
+
+  const size_t files = _uri.find("/files/");
+  if (files != std::string::npos && _uri.find("://") != std::string::npos)
+    return _uri.substr(0, files);
+
+  return _uri;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the SDF file of a model inserted by filename or URI.
+/// \param[in] _uri Filename or URI of the factory message.
+/// \return Path of the SDF file, downloading the model if needed.
+static std::string FactoryModelFile(const std::string &_uri)
+{
+  // If http(s), look at Fuel
+  auto uri = ignition::common::URI(_uri);
+  if (uri.Valid() && (uri.Scheme() == "https" || uri.Scheme() == "http"))
+    return common::FuelModelDatabase::Instance()->ModelFile(_uri);
+
+  // Otherwise, look at database
+  return common::ModelDatabase::Instance()->GetModelFile(_uri);
+}
+
+//////////////////////////////////////////////////
+/// \brief Forget the poses last published for a model, its links and its
+/// nested models, so that ids of removed entities don't accumulate.
+/// \param[in] _model The removed model.
+/// \param[in,out] _poses Last published poses, by entity id.
+static void ErasePublishedPoses(const ModelPtr &_model,
+    std::unordered_map<uint32_t, ignition::math::Pose3d> &_poses)
+{
+  if (_poses.empty())
+    return;
+
+  _poses.erase(_model->GetId());
+  for (auto const &link : _model->GetLinks())
+    _poses.erase(link->GetId());
+  for (auto const &nested : _model->NestedModels())
+    ErasePublishedPoses(nested, _poses);
+}
+
+//////////////////////////////////////////////////
+/// \brief Read the SDF of a factory message, and load the meshes and
+/// plugin libraries it uses, so that the world thread only has to create
+/// the entities.
+/// \param[in] _msg Factory message.
+/// \param[in] _sdf SDF to read into, initialized with root.sdf.
+/// \return A copy of the root element, or nullptr if the world thread
+/// must read the message itself: to clone a model, or to report errors.
+static sdf::ElementPtr PrepareFactorySDF(const msgs::Factory &_msg,
+    sdf::SDFPtr _sdf)
+{
+  _sdf->Clear();
+
+  if (_msg.has_sdf() && !_msg.sdf().empty())
+  {
+    if (!sdf::readString(_msg.sdf(), _sdf))
+      return sdf::ElementPtr();
+  }
+  else if (_msg.has_sdf_filename() && !_msg.sdf_filename().empty())
+  {
+    if (!sdf::readFile(FactoryModelFile(_msg.sdf_filename()), _sdf))
+      return sdf::ElementPtr();
+  }
+  else
+  {
+    return sdf::ElementPtr();
+  }
+
+  sdf::ElementPtr root = _sdf->Root()->Clone();
+  if (_msg.has_edit_name())
+    return root;
+
+  std::set<std::string> uris;
+  CollectMeshUris(root, HasRenderingSensor(root), uris);
+  for (auto const &uri : uris)
+  {
+    const std::string filename = common::find_file(uri);
+    if (filename.empty() ||
+        !common::MeshManager::Instance()->IsValidFilename(filename))
+    {
+      continue;
+    }
+
+    // Errors are reported again when the shapes load.
+    try
+    {
+      common::MeshManager::Instance()->Load(filename);
+    }
+    catch(common::Exception &)
+    {
+    }
+  }
+
+  std::set<std::string> plugins;
+  CollectPluginFilenames(root, plugins);
+  for (auto const &plugin : plugins)
+  {
+    void *handle = nullptr;
+    common::PluginRegistry::Factory(plugin, handle);
+  }
+
+  return root;
+}
+
+//////////////////////////////////////////////////
+/// \brief Run the calling thread with the SCHED_FIFO policy, pin it to a
+/// CPU, and lock the memory of the process so that steps don't page fault.
+/// Failures are logged, and the world runs with what could be applied.
+/// \param[in] _world Name of the world, for the messages.
+/// \param[in] _priority SCHED_FIFO priority.
+/// \param[in] _cpu CPU to pin the thread to, -1 to not pin it.
+static void EnableRealTime(const std::string &_world, const int _priority,
+    const int _cpu)
+{
+#ifdef __linux__
+  sched_param param;
+  param.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO),
+      std::min(_priority, sched_get_priority_max(SCHED_FIFO)));
+  int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (err != 0)
+  {
+    gzwarn << "Unable to run world [" << _world << "] with SCHED_FIFO "
+           << "priority [" << param.sched_priority << "]: " << strerror(err)
+           << ". An rtprio limit or CAP_SYS_NICE is required.\n";
+  }
+
+  if (_cpu >= 0 && _cpu < CPU_SETSIZE)
+  {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(_cpu, &cpus);
+    err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (err != 0)
+    {
+      gzwarn << "Unable to pin world [" << _world << "] to CPU [" << _cpu
+             << "]: " << strerror(err) << "\n";
+    }
+  }
+  else if (_cpu >= 0)
+    gzwarn << "Invalid CPU [" << _cpu << "] for world [" << _world << "]\n";
+
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+  {
+    gzwarn << "Unable to lock the memory of the process: "
+           << strerror(errno) << "\n";
+  }
+#else
+  gzwarn << "The real-time mode of world [" << _world << "] with priority ["
+         << _priority << "] and CPU [" << _cpu << "] is only supported on "
+         << "Linux\n";
+#endif
+}
+
+//////////////////////////////////////////////////
+/// \brief Signal the start of a world update. The concurrent subscribers
+/// run on the task pool while the other subscribers run in order.
+/// \param[in] _info Update information.
+static void SignalWorldUpdateBegin(const common::UpdateInfo &_info)
+{
+  event::Events::worldUpdateBeginConcurrent.SignalAlongside(
+      [&_info]() { event::Events::worldUpdateBegin(_info); }, _info);
+}
+
+//////////////////////////////////////////////////
+/// \brief Add the wall time between the starts of two world updates to
+/// the step period histogram.
+/// \param[in,out] _data Private data of the world.
+/// \param[in] _period Wall time since the start of the previous update.
+/// \param[in] _target Target period, zero if the update rate is not
+/// throttled.
+static void RecordStepPeriod(WorldPrivate &_data,
+    const common::Timestamp &_period, const common::Timestamp &_target)
+{
+  if (_data.stepPeriodCount == 0 || _period < _data.stepPeriodMin)
+    _data.stepPeriodMin = _period;
+  if (_data.stepPeriodCount == 0 || _period > _data.stepPeriodMax)
+    _data.stepPeriodMax = _period;
+  _data.stepPeriodTotal += _period;
+  ++_data.stepPeriodCount;
+
+  const common::Timestamp lateness = _period - _target;
+  _data.stepLateness.resize(STEP_LATENESS_BOUNDS.size() + 1);
+  const size_t bucket = std::lower_bound(STEP_LATENESS_BOUNDS.begin(),
+      STEP_LATENESS_BOUNDS.end(), lateness.Double()) -
+    STEP_LATENESS_BOUNDS.begin();
+  ++_data.stepLateness[bucket];
+
+  if (_target > common::Timestamp() &&
+      lateness.Nanoseconds() * 10 > _target.Nanoseconds())
+  {
+    ++_data.stepOverruns;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Recreate the SDF elements of the models released in the SDF
+/// memory saver mode, before the world SDF is used.
+/// \param[in] _data Private data of the world.
+static void RestoreModelSDF(WorldPrivate &_data)
+{
+  if (!_data.sdfMemorySaver)
+    return;
+
+  for (auto const &model : _data.models)
+    model->GetSDF();
+}
+
+//////////////////////////////////////////////////
+/// \brief Load the plugins of the models that were inactive when the world
+/// loaded its plugins, and are now active.
+/// \param[in,out] _data Private data of the world.
+static void LoadDeferredPlugins(WorldPrivate &_data)
+{
+  auto iter = _data.deferredPluginModels.begin();
+  while (iter != _data.deferredPluginModels.end())
+  {
+    if (_data.activityZones.IsActive(*iter))
+    {
+      ModelPtr model = *iter;
+      iter = _data.deferredPluginModels.erase(iter);
+      model->LoadPlugins();
+    }
+    else
+      ++iter;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Add the wall time elapsed since the start of a phase of the
+/// world update to the time of the phase.
+/// \param[in,out] _data Private data of the world.
+/// \param[in] _phase Phase.
+/// \param[in] _start Wall time at which the phase started.
+/// \return Current wall time, to start the next phase.
+static common::Timestamp AddPhaseTime(WorldPrivate &_data,
+    const WorldPhase _phase, const common::Timestamp &_start)
+{
+  const common::Timestamp now = common::Timestamp::Now();
+  _data.phaseTimes[_phase] += now - _start;
+  return now;
+}
+
+//////////////////////////////////////////////////
+/// \brief Refresh the link state cache, if it is enabled.
+/// \param[in,out] _data Private data of the world.
+static void UpdateLinkStateCache(WorldPrivate &_data)
+{
+  if (!_data.linkStateCacheEnabled)
+    return;
+
+  _data.linkStateCache.Update(_data.models);
+  _data.linkStateCacheFresh = true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Fill a message with the memory counted by
+/// common::MemoryAccounting.
+/// \param[out] _msg Message to fill.
+static void FillMemoryInfo(msgs::MemoryInfo &_msg)
+{
+  typedef common::MemoryAccounting Accounting;
+
+  _msg.set_enabled(Accounting::Enabled());
+  _msg.set_resident(Accounting::ResidentBytes());
+  for (int i = 0; i < Accounting::SUBSYSTEM_COUNT; ++i)
+  {
+    const Accounting::Subsystem subsystem =
+      static_cast<Accounting::Subsystem>(i);
+    msgs::MemoryInfo::Subsystem *subsystemMsg = _msg.add_subsystems();
+    subsystemMsg->set_name(Accounting::Name(subsystem));
+    subsystemMsg->set_bytes(Accounting::Bytes(subsystem));
+  }
+
+  for (auto const &model : Accounting::ModelBytes())
+  {
+    msgs::MemoryInfo::Model *modelMsg = _msg.add_models();
+    modelMsg->set_name(model.first);
+    for (size_t i = 0; i < model.second.size(); ++i)
+    {
+      if (model.second[i] == 0)
+        continue;
+      msgs::MemoryInfo::Subsystem *subsystemMsg = modelMsg->add_subsystems();
+      subsystemMsg->set_name(
+          Accounting::Name(static_cast<Accounting::Subsystem>(i)));
+      subsystemMsg->set_bytes(model.second[i]);
+    }
+  }
+}
+
 class ModelUpdate_TBB
 {
   public: explicit ModelUpdate_TBB(Model_V *_models) : models(_models) {}
@@ -107,6 +529,28 @@ class ModelUpdate_TBB
   private: Model_V *models;
 };
 
+/// \brief Header of the buffers written by World::SaveSnapshot.
+class WorldSnapshotHeader
+{
+  /// \brief Value used to detect buffers that are not snapshots.
+  public: static const uint32_t kMagic = 0x475a5353;
+
+  /// \brief Set to kMagic.
+  public: uint32_t magic = kMagic;
+
+  /// \brief Simulation time seconds.
+  public: int32_t sec = 0;
+
+  /// \brief Simulation time nanoseconds.
+  public: int32_t nsec = 0;
+
+  /// \brief World iterations.
+  public: uint64_t iterations = 0;
+
+  /// \brief Number of engine state values following the header.
+  public: uint64_t stateSize = 0;
+};
+
 //////////////////////////////////////////////////
 World::World(const std::string &_name)
   : dataPtr(new WorldPrivate)
@@ -147,7 +591,11 @@ World::World(const std::string &_name)
   this->dataPtr->enableWind = true;
   this->dataPtr->enableAtmosphere = true;
 
-  this->dataPtr->sleepOffset = common::Time(0);
+  this->dataPtr->sleepOffset = common::Timestamp();
+
+  // Models are updated serially unless parallel model updates are enabled
+  // through World::SetParallelModelUpdate.
+  this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
 
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
   this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
@@ -221,9 +669,16 @@ void World::Load(sdf::ElementPtr _sdf)
     this->dataPtr->node->Advertise<msgs::PosesStamped>("~/pose/local/info", 10);
 
   // pose pub for client with a cap on publishing rate to reduce traffic
-  // overhead
+  // overhead. The rate is applied in World::ProcessMessages before building
+  // the message, see World::SetPosePublishRate.
   this->dataPtr->posePub = this->dataPtr->node->Advertise<msgs::PosesStamped>(
-    "~/pose/info", 10, 60);
+    "~/pose/info", 10);
+
+  // Same poses without names, quantized, for clients that ask for them by
+  // subscribing to this topic instead.
+  this->dataPtr->compactPosePub =
+    this->dataPtr->node->Advertise<msgs::PosesCompact>(
+    "~/pose/compact/info", 10);
 
   this->dataPtr->guiPub = this->dataPtr->node->Advertise<msgs::GUI>("~/gui", 5);
   if (this->dataPtr->sdf->HasElement("gui"))
@@ -259,12 +714,24 @@ void World::Load(sdf::ElementPtr _sdf)
   this->dataPtr->statPub =
     this->dataPtr->node->Advertise<msgs::WorldStatistics>(
         "~/world_stats", 100, 5);
+  this->dataPtr->pluginStatsPub =
+    this->dataPtr->node->Advertise<msgs::PluginStats>("~/plugins/stats");
+  this->dataPtr->transportStatsPub =
+    this->dataPtr->node->Advertise<msgs::TransportStats>("~/transport/stats");
+
+  // Responses and statistics are sent before bulk data such as contacts
+  this->dataPtr->responsePub->SetPriority(transport::Publisher::CONTROL);
+  this->dataPtr->statPub->SetPriority(transport::Publisher::CONTROL);
   this->dataPtr->modelPub = this->dataPtr->node->Advertise<msgs::Model>(
       "~/model/info");
+  this->dataPtr->modelVPub = this->dataPtr->node->Advertise<msgs::Model_V>(
+      "~/model/info_v");
   this->dataPtr->lightPub = this->dataPtr->node->Advertise<msgs::Light>(
       "~/light/modify");
   this->dataPtr->lightFactoryPub = this->dataPtr->node->Advertise<msgs::Light>(
       "~/factory/light");
+  this->dataPtr->linkData.SetPublisher(
+      this->dataPtr->node->Advertise<msgs::LinkData_V>("~/link_data"));
 
   // Ignition transport
   std::string pluginInfoService("/physics/info/plugin");
@@ -338,19 +805,15 @@ void World::Load(sdf::ElementPtr _sdf)
   // initialized improperly.
   {
     // Create all the entities
+    this->PrefetchResources(this->dataPtr->sdf);
     this->LoadEntities(this->dataPtr->sdf, this->dataPtr->rootElement);
 
     for (unsigned int i = 0; i < this->ModelCount(); ++i)
       this->ModelByIndex(i)->LoadJoints();
-  }
 
-  // TODO: Performance test to see if TBB model updating is necessary
-  // Choose threaded or unthreaded model updating depending on the number of
-  // models in the scene
-  // if (this->ModelCount() < 20)
-  this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
-  // else
-  // this->dataPtr->modelUpdateFunc = &World::ModelUpdateTBB;
+    if (this->dataPtr->prefetch.valid())
+      this->dataPtr->prefetch.wait();
+  }
 
   event::Events::worldCreated(this->Name());
 
@@ -399,6 +862,77 @@ void World::Save(const std::string &_filename)
   out.close();
 }
 
+//////////////////////////////////////////////////
+void World::SaveCheckpoint(const std::string &_filename)
+{
+  // Only one checkpoint is written at a time.
+  this->WaitForCheckpoint();
+
+  // Regenerate the world description only when the models changed.
+  std::vector<std::string> modelNames;
+  for (auto const &model : this->dataPtr->models)
+    modelNames.push_back(model->GetName());
+
+  if (this->dataPtr->checkpointDescription.empty() ||
+      modelNames != this->dataPtr->checkpointModels)
+  {
+    RestoreModelSDF(*this->dataPtr);
+    this->dataPtr->sdf->Update();
+    sdf::ElementPtr description = this->dataPtr->sdf->Clone();
+    if (description->HasElement("state"))
+      description->RemoveChild(description->GetElement("state"));
+
+    this->dataPtr->checkpointDescription = description->ToString("");
+    this->dataPtr->checkpointModels = modelNames;
+  }
+
+  WorldState state(shared_from_this());
+  std::string description = this->dataPtr->checkpointDescription;
+
+  this->dataPtr->checkpointThread = std::thread(
+      [state, description, _filename]() mutable
+      {
+        sdf::ElementPtr stateElem(new sdf::Element);
+        sdf::initFile("state.sdf", stateElem);
+        state.FillSDF(stateElem);
+
+        // Put the state at the end of the world element.
+        std::string data = description;
+        const std::string endWorld = "</world>";
+        const size_t pos = data.rfind(endWorld);
+        data.insert(pos == std::string::npos ? data.size() : pos,
+            stateElem->ToString("  "));
+
+        std::ofstream out(_filename.c_str(), std::ios::out);
+        if (!out)
+        {
+          gzerr << "Unable to open file[" << _filename << "]\n";
+          return;
+        }
+
+        out << "<?xml version ='1.0'?>\n"
+            << "<sdf version='" << SDF_VERSION << "'>\n"
+            << data
+            << "</sdf>\n";
+      });
+}
+
+//////////////////////////////////////////////////
+void World::WaitForCheckpoint()
+{
+  if (this->dataPtr->checkpointThread.joinable())
+    this->dataPtr->checkpointThread.join();
+}
+
+//////////////////////////////////////////////////
+void World::SetCheckpointPeriod(const std::string &_filename,
+    const double _period)
+{
+  this->dataPtr->checkpointFilename = _filename;
+  this->dataPtr->checkpointPeriod = _period;
+  this->dataPtr->checkpointLastTime = this->dataPtr->simTime;
+}
+
 //////////////////////////////////////////////////
 void World::Init()
 {
@@ -421,6 +955,15 @@ void World::Init(UpdateScenePosesFunc _func)
   // Initialize the physics engine
   this->dataPtr->physicsEngine->Init();
 
+  // Size the dirty pose buffer so that engines never hit the slow path
+  // while moving the links that exist at startup.
+  {
+    size_t linkCount = 0;
+    for (auto const &model : this->dataPtr->models)
+      linkCount += model->GetLinks().size();
+    this->dataPtr->dirtyPoses.Reserve(linkCount);
+  }
+
   this->dataPtr->presetManager = PresetManagerPtr(
       new PresetManager(this->dataPtr->physicsEngine, this->dataPtr->sdf));
 
@@ -529,13 +1072,20 @@ void World::RunLoop()
 {
   this->dataPtr->physicsEngine->InitForThread();
 
+  if (this->dataPtr->realTime)
+  {
+    EnableRealTime(this->Name(), this->dataPtr->realTimePriority,
+        this->dataPtr->realTimeCpu);
+  }
+
   this->dataPtr->startTime = common::Time::GetWallTime();
 
   // This fixes a minor issue when the world is paused before it's started
   if (this->IsPaused())
     this->dataPtr->pauseStartTime = this->dataPtr->startTime;
 
-  this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+  this->dataPtr->prevStepWallTime = common::Timestamp::Now();
+  this->CacheStepTimes(this->dataPtr->prevStepWallTime);
 
   // Get the first state
   this->dataPtr->prevStates[0] = WorldState(shared_from_this());
@@ -641,7 +1191,10 @@ void World::LogStep()
         this->dataPtr->logLastStatePlayedSimTime =
             this->dataPtr->logPlayState.GetSimTime();
         this->SetState(this->dataPtr->logPlayState);
-        this->Update();
+        if (this->dataPtr->logPlayMode == LOG_PLAY_FULL)
+          this->Update();
+        else
+          this->LogPlayUpdate();
       }
 
       if (this->dataPtr->stepInc > 0)
@@ -676,6 +1229,7 @@ void World::SetSensorWaitFunc(std::function<void(double, double)> _func)
 void World::Step()
 {
   DIAG_TIMER_START("World::Step");
+  DIAG_PROBE("World::Step");
 
   IGN_PROFILE("World::Step");
   IGN_PROFILE_BEGIN("loadPlugins");
@@ -692,36 +1246,71 @@ void World::Step()
   IGN_PROFILE_END();
   DIAG_TIMER_LAP("World::Step", "loadPlugins");
 
+  // Run a batch requested from another thread through World::BatchStep.
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+    if (this->dataPtr->batchIterations > 0)
+    {
+      this->dataPtr->batchRate = this->BatchStepImpl(
+          this->dataPtr->batchIterations, this->dataPtr->batchEvents);
+      this->dataPtr->batchIterations = 0;
+      this->dataPtr->batchDone = true;
+      this->dataPtr->batchCondition.notify_all();
+    }
+  }
+
   IGN_PROFILE_BEGIN("publishWorldStats");
   // Send statistics about the world simulation
   this->PublishWorldStats();
+  this->PublishPluginStats();
+  this->PublishTransportStats();
   IGN_PROFILE_END();
 
   DIAG_TIMER_LAP("World::Step", "publishWorldStats");
 
   IGN_PROFILE_BEGIN("sleepOffset");
   if (this->dataPtr->waitForSensors)
+  {
+    const common::Timestamp waitStart = common::Timestamp::Now();
     this->dataPtr->waitForSensors(this->dataPtr->simTime.Double(),
         this->dataPtr->physicsEngine->GetMaxStepSize());
+    AddPhaseTime(*this->dataPtr, WORLD_PHASE_SENSORS, waitStart);
+  }
 
-  double updatePeriod = this->dataPtr->physicsEngine->GetUpdatePeriod();
+  const common::Timestamp updatePeriod = common::Timestamp::FromSeconds(
+      this->dataPtr->physicsEngine->GetUpdatePeriod());
   // sleep here to get the correct update rate
-  common::Time tmpTime = common::Time::GetWallTime();
-  common::Time sleepTime = this->dataPtr->prevStepWallTime +
-    common::Time(updatePeriod) - tmpTime - this->dataPtr->sleepOffset;
+  common::Timestamp now = common::Timestamp::Now();
+  common::Timestamp sleepTime = this->dataPtr->prevStepWallTime +
+    updatePeriod - now - this->dataPtr->sleepOffset;
 
-  common::Time actualSleep;
-  if (sleepTime > 0)
+  common::Timestamp actualSleep;
+  if (this->dataPtr->realTime)
+  {
+    // Sleep until just before the deadline, then spin so that the wake up
+    // latency of the thread doesn't delay the step.
+    const common::Timestamp deadline =
+      this->dataPtr->prevStepWallTime + updatePeriod;
+    if (deadline - now > REAL_TIME_SPIN)
+      common::Time::Sleep((deadline - now - REAL_TIME_SPIN).ToTime());
+    while (now < deadline)
+      now = common::Timestamp::Now();
+    sleepTime = common::Timestamp();
+  }
+  else if (sleepTime > common::Timestamp())
   {
-    common::Time::Sleep(sleepTime);
-    actualSleep = common::Time::GetWallTime() - tmpTime;
+    common::Time::Sleep(sleepTime.ToTime());
+    const common::Timestamp wake = common::Timestamp::Now();
+    actualSleep = wake - now;
+    now = wake;
   }
   else
-    sleepTime = 0;
+    sleepTime = common::Timestamp();
 
   // exponentially avg out
-  this->dataPtr->sleepOffset = (actualSleep - sleepTime) * 0.01 +
-                      this->dataPtr->sleepOffset * 0.99;
+  this->dataPtr->sleepOffset = common::Timestamp(
+      (actualSleep - sleepTime).Nanoseconds() / 100 +
+      this->dataPtr->sleepOffset.Nanoseconds() / 100 * 99);
 
   IGN_PROFILE_END();
   DIAG_TIMER_LAP("World::Step", "sleepOffset");
@@ -729,14 +1318,17 @@ void World::Step()
   IGN_PROFILE_BEGIN("worldUpdateMutex");
   // throttling update rate, with sleepOffset as tolerance
   // the tolerance is needed as the sleep time is not exact
-  if (common::Time::GetWallTime() - this->dataPtr->prevStepWallTime +
-      this->dataPtr->sleepOffset >= common::Time(updatePeriod))
+  if (now - this->dataPtr->prevStepWallTime +
+      this->dataPtr->sleepOffset >= updatePeriod)
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
 
     DIAG_TIMER_LAP("World::Step", "worldUpdateMutex");
 
-    this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+    const common::Timestamp stepStart = common::Timestamp::Now();
+    RecordStepPeriod(*this->dataPtr,
+        stepStart - this->dataPtr->prevStepWallTime, updatePeriod);
+    this->dataPtr->prevStepWallTime = stepStart;
 
     double stepTime = this->dataPtr->physicsEngine->GetMaxStepSize();
 
@@ -746,6 +1338,7 @@ void World::Step()
       // query timestep to allow dynamic time step size updates
       this->dataPtr->simTime += stepTime;
       this->dataPtr->iterations++;
+      this->CacheStepTimes(this->dataPtr->prevStepWallTime);
       this->Update();
 
       DIAG_TIMER_LAP("World::Step", "update");
@@ -759,6 +1352,7 @@ void World::Step()
       if (util::LogRecord::Instance()->BufferSize() > 0)
         util::LogRecord::Instance()->Notify();
       this->dataPtr->pauseTime += stepTime;
+      this->CacheStepTimes(this->dataPtr->prevStepWallTime);
     }
   }
   IGN_PROFILE_END();
@@ -802,59 +1396,221 @@ void World::Step(const unsigned int _steps)
 }
 
 //////////////////////////////////////////////////
-void World::Update()
+double World::BatchStep(const unsigned int _iterations,
+    const unsigned int _events)
 {
-  DIAG_TIMER_START("World::Update");
+  if (_iterations == 0)
+    return 0.0;
 
-  IGN_PROFILE("World::Update");
-  IGN_PROFILE_BEGIN("needsReset");
-  if (this->dataPtr->needsReset)
+  if (!this->IsPaused())
   {
-    if (this->dataPtr->resetAll)
-      this->Reset();
-    else if (this->dataPtr->resetTimeOnly)
-      this->ResetTime();
-    else if (this->dataPtr->resetModelOnly)
-      this->ResetEntities(Base::MODEL);
-    this->dataPtr->needsReset = false;
-    return;
+    gzwarn << "Calling World::BatchStep while world is not paused\n";
+    this->SetPaused(true);
   }
-  IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "needsReset");
-
-  IGN_PROFILE_BEGIN("worldUpdateBegin");
-  this->dataPtr->updateInfo.simTime = this->SimTime();
-  this->dataPtr->updateInfo.realTime = this->RealTime();
-  event::Events::worldUpdateBegin(this->dataPtr->updateInfo);
-  IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
 
-  IGN_PROFILE_BEGIN("Update");
-  // Update all the models
-  (*this.*dataPtr->modelUpdateFunc)();
-  IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "Model::Update");
+  // Run inline if there's no world thread to hand the batch over to.
+  if (!this->dataPtr->thread ||
+      this->dataPtr->thread->get_id() == std::this_thread::get_id() ||
+      this->dataPtr->stop)
+  {
+    return this->BatchStepImpl(_iterations, _events);
+  }
 
-  IGN_PROFILE_BEGIN("UpdateCollision");
-  // This must be called before PhysicsEngine::UpdatePhysics for ODE.
-  this->dataPtr->physicsEngine->UpdateCollision();
-  IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
+  std::unique_lock<std::recursive_mutex> lock(
+      this->dataPtr->worldUpdateMutex);
+  this->dataPtr->batchIterations = _iterations;
+  this->dataPtr->batchEvents = _events;
+  this->dataPtr->batchDone = false;
 
-  IGN_PROFILE_BEGIN("beforePhysicsUpdate");
-  // Wait for logging to finish, if it's running.
-  if (util::LogRecord::Instance()->Running())
+  // Block on completion
+  while (!this->dataPtr->batchDone && !this->dataPtr->stop)
   {
-    std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
-
-    // It's possible the logWorker thread never processed the previous
-    // state. This checks to make sure that we don't continute until the log
-    // worker catchs up.
-    if (this->dataPtr->iterations - this->dataPtr->logPrevIteration > 1)
-    {
-      this->dataPtr->logCondition.notify_one();
-      this->dataPtr->logContinueCondition.wait(lock);
-    }
+    this->dataPtr->batchCondition.wait_for(lock,
+        std::chrono::milliseconds(100));
+  }
+
+  this->dataPtr->batchIterations = 0;
+  return this->dataPtr->batchDone ? this->dataPtr->batchRate : 0.0;
+}
+
+//////////////////////////////////////////////////
+double World::BatchStepImpl(const unsigned int _iterations,
+    const unsigned int _events)
+{
+  DIAG_TIMER_START("World::BatchStep");
+  IGN_PROFILE("World::BatchStep");
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  const common::Timestamp startTime = common::Timestamp::Now();
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    // Switch profiles between two steps, as World::Update does
+    if (this->dataPtr->presetManager)
+      this->dataPtr->presetManager->ApplyPendingProfile();
+
+    // query timestep to allow dynamic time step size updates
+    this->dataPtr->simTime += this->dataPtr->physicsEngine->GetMaxStepSize();
+    this->dataPtr->iterations++;
+    this->CacheStepTimes(startTime);
+
+    this->dataPtr->activityZones.Update(this->dataPtr->models,
+        this->dataPtr->iterations);
+    if (!this->dataPtr->deferredPluginModels.empty())
+      LoadDeferredPlugins(*this->dataPtr);
+    (*this.*dataPtr->modelUpdateFunc)();
+
+    this->dataPtr->physicsEngine->UpdateCollision();
+
+    if (this->dataPtr->enablePhysicsEngine)
+    {
+      this->dataPtr->physicsEngine->UpdatePhysics();
+
+      boost::recursive_mutex::scoped_lock plock(
+          *this->Physics()->GetPhysicsUpdateMutex());
+      this->dataPtr->dirtyPoses.Drain([](Entity *_dirtyEntity)
+      {
+        _dirtyEntity->SetWorldPose(_dirtyEntity->DirtyPose(), false);
+      });
+
+      SleepManager *sleepManager = this->dataPtr->physicsEngine->SleepMgr();
+      if (sleepManager->Enabled())
+        sleepManager->Update(this->dataPtr->physicsEngine->GetMaxStepSize());
+    }
+  }
+
+  if (this->dataPtr->enablePhysicsEngine)
+    this->dataPtr->physicsEngine->UpdateJointWrenches();
+  UpdateLinkStateCache(*this->dataPtr);
+  this->UpdateRayQuerySnapshot();
+
+  const common::Timestamp elapsed = common::Timestamp::Now() - startTime;
+  DIAG_TIMER_LAP("World::BatchStep", "iterations");
+
+  this->dataPtr->updateInfo.simTime = this->SimTime();
+  this->dataPtr->updateInfo.realTime = this->RealTime();
+
+  if (_events & BATCH_WORLD_UPDATE_BEGIN)
+  {
+    SignalWorldUpdateBegin(this->dataPtr->updateInfo);
+    this->dataPtr->scheduler.Update(this->dataPtr->updateInfo,
+        this->dataPtr->iterations,
+        this->dataPtr->physicsEngine->GetMaxStepSize());
+    this->dataPtr->batteries.Update(this->dataPtr->updateInfo.simTime);
+  }
+
+  if (_events & BATCH_BEFORE_PHYSICS_UPDATE)
+    event::Events::beforePhysicsUpdate(this->dataPtr->updateInfo);
+
+  if (_events & BATCH_PUBLISH_CONTACTS)
+    this->dataPtr->physicsEngine->GetContactManager()->PublishContacts();
+
+  if (_events & BATCH_WORLD_UPDATE_END)
+  {
+    this->dataPtr->linkData.Update(this->SimTime());
+    event::Events::worldUpdateEnd();
+  }
+
+  if (_events & BATCH_PUBLISH_STATS)
+    this->PublishWorldStats();
+
+  double rate = 0.0;
+  if (elapsed > common::Timestamp())
+    rate = _iterations / elapsed.Double();
+
+  DIAG_VALUE("World::BatchStep iterations/s", rate);
+  DIAG_TIMER_STOP("World::BatchStep");
+
+  return rate;
+}
+
+//////////////////////////////////////////////////
+void World::Update()
+{
+  DIAG_TIMER_START("World::Update");
+  DIAG_PROBE("World::Update");
+
+  IGN_PROFILE("World::Update");
+  IGN_PROFILE_BEGIN("needsReset");
+  if (this->dataPtr->needsReset)
+  {
+    if (this->dataPtr->resetAll)
+      this->Reset();
+    else if (this->dataPtr->resetTimeOnly)
+      this->ResetTime();
+    else if (this->dataPtr->resetModelOnly)
+      this->ResetEntities(Base::MODEL);
+    this->dataPtr->needsReset = false;
+    return;
+  }
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "needsReset");
+
+  // Switch to the physics profile requested since the last step before
+  // anything reads the physics parameters, so that they change together,
+  // between two steps
+  if (this->dataPtr->presetManager)
+    this->dataPtr->presetManager->ApplyPendingProfile();
+
+  IGN_PROFILE_BEGIN("worldUpdateBegin");
+  this->dataPtr->updateInfo.simTime = this->SimTime();
+  this->dataPtr->updateInfo.realTime = this->RealTime();
+  SignalWorldUpdateBegin(this->dataPtr->updateInfo);
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
+
+  IGN_PROFILE_BEGIN("UpdateScheduler");
+  this->dataPtr->scheduler.Update(this->dataPtr->updateInfo,
+      this->dataPtr->iterations,
+      this->dataPtr->physicsEngine->GetMaxStepSize());
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "UpdateScheduler");
+
+  IGN_PROFILE_BEGIN("UpdateBatteries");
+  this->dataPtr->batteries.Update(this->dataPtr->updateInfo.simTime);
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "BatteryRegistry::Update");
+
+  ++this->dataPtr->phaseIterations;
+  common::Timestamp phaseStart = common::Timestamp::Now();
+
+  IGN_PROFILE_BEGIN("Update");
+  // Freeze or unfreeze models depending on the activity zones
+  this->dataPtr->activityZones.Update(this->dataPtr->models,
+      this->dataPtr->iterations);
+  if (!this->dataPtr->deferredPluginModels.empty())
+    LoadDeferredPlugins(*this->dataPtr);
+
+  // Update all the models
+  (*this.*dataPtr->modelUpdateFunc)();
+  IGN_PROFILE_END();
+  phaseStart = AddPhaseTime(*this->dataPtr, WORLD_PHASE_MODELS, phaseStart);
+  DIAG_TIMER_LAP("World::Update", "Model::Update");
+
+  IGN_PROFILE_BEGIN("UpdateCollision");
+  // This must be called before PhysicsEngine::UpdatePhysics for ODE.
+  this->dataPtr->physicsEngine->UpdateCollision();
+  IGN_PROFILE_END();
+  AddPhaseTime(*this->dataPtr, WORLD_PHASE_COLLISION, phaseStart);
+  DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
+
+  IGN_PROFILE_BEGIN("beforePhysicsUpdate");
+  // Wait for logging to finish, if it's running.
+  if (util::LogRecord::Instance()->Running())
+  {
+    phaseStart = common::Timestamp::Now();
+    std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+
+    // It's possible the logWorker thread never processed the previous
+    // state. This checks to make sure that we don't continute until the log
+    // worker catchs up.
+    if (this->dataPtr->iterations - this->dataPtr->logPrevIteration > 1)
+    {
+      this->dataPtr->logCondition.notify_one();
+      this->dataPtr->logContinueCondition.wait(lock);
+    }
+    AddPhaseTime(*this->dataPtr, WORLD_PHASE_LOGGING, phaseStart);
   }
 
   // Give clients a possibility to react to collisions before the physics
@@ -869,9 +1625,12 @@ void World::Update()
   if (this->dataPtr->enablePhysicsEngine && this->dataPtr->physicsEngine)
   {
     IGN_PROFILE_BEGIN("UpdatePhysics");
+    phaseStart = common::Timestamp::Now();
     // This must be called directly after PhysicsEngine::UpdateCollision.
     this->dataPtr->physicsEngine->UpdatePhysics();
 
+    phaseStart =
+      AddPhaseTime(*this->dataPtr, WORLD_PHASE_PHYSICS, phaseStart);
     IGN_PROFILE_END();
     DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdatePhysics");
 
@@ -884,16 +1643,53 @@ void World::Update()
       boost::recursive_mutex::scoped_lock plock(
           *this->Physics()->GetPhysicsUpdateMutex());
 
-      for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+      this->dataPtr->dirtyPoses.Drain([](Entity *_dirtyEntity)
       {
-        dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
-      }
-
-      this->dataPtr->dirtyPoses.clear();
+        _dirtyEntity->SetWorldPose(_dirtyEntity->DirtyPose(), false);
+      });
       IGN_PROFILE_END();
     }
+    AddPhaseTime(*this->dataPtr, WORLD_PHASE_DIRTY_POSES, phaseStart);
 
     DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
+
+    IGN_PROFILE_BEGIN("UpdateJointWrenches");
+    this->dataPtr->physicsEngine->UpdateJointWrenches();
+    IGN_PROFILE_END();
+
+    SleepManager *sleepManager = this->dataPtr->physicsEngine->SleepMgr();
+    if (sleepManager->Enabled())
+    {
+      IGN_PROFILE_BEGIN("SleepManager::Update");
+      sleepManager->Update(this->dataPtr->physicsEngine->GetMaxStepSize());
+      IGN_PROFILE_END();
+      DIAG_TIMER_LAP("World::Update", "SleepManager::Update");
+    }
+  }
+
+  if (this->dataPtr->linkStateCacheEnabled)
+  {
+    IGN_PROFILE_BEGIN("LinkStateCache");
+    UpdateLinkStateCache(*this->dataPtr);
+    IGN_PROFILE_END();
+    DIAG_TIMER_LAP("World::Update", "LinkStateCache::Update");
+  }
+
+  if (this->dataPtr->rayQuerySnapshotEnabled)
+  {
+    IGN_PROFILE_BEGIN("RayQuerySnapshot");
+    this->UpdateRayQuerySnapshot();
+    IGN_PROFILE_END();
+    DIAG_TIMER_LAP("World::Update", "UpdateRayQuerySnapshot");
+  }
+
+  // Save a periodic checkpoint.
+  if (this->dataPtr->checkpointPeriod > 0 &&
+      (this->dataPtr->simTime - this->dataPtr->checkpointLastTime).Double() >=
+      this->dataPtr->checkpointPeriod)
+  {
+    this->dataPtr->checkpointLastTime = this->dataPtr->simTime;
+    this->SaveCheckpoint(this->dataPtr->checkpointFilename);
   }
 
   IGN_PROFILE_BEGIN("LogRecordNotify");
@@ -904,12 +1700,19 @@ void World::Update()
   DIAG_TIMER_LAP("World::Update", "LogRecordNotify");
 
   IGN_PROFILE_BEGIN("PublishContacts");
+  phaseStart = common::Timestamp::Now();
   // Output the contact information
   this->dataPtr->physicsEngine->GetContactManager()->PublishContacts();
 
+  AddPhaseTime(*this->dataPtr, WORLD_PHASE_CONTACTS, phaseStart);
   IGN_PROFILE_END();
   DIAG_TIMER_LAP("World::Update", "ContactManager::PublishContacts");
 
+  IGN_PROFILE_BEGIN("UpdateLinkData");
+  this->dataPtr->linkData.Update(this->dataPtr->simTime);
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "LinkDataRegistry::Update");
+
   event::Events::worldUpdateEnd();
 
   gazebo::util::IntrospectionManager::Instance()->Update();
@@ -917,12 +1720,52 @@ void World::Update()
   DIAG_TIMER_STOP("World::Update");
 }
 
+//////////////////////////////////////////////////
+void World::LogPlayUpdate()
+{
+  IGN_PROFILE("World::LogPlayUpdate");
+
+  // SetState already moved the entities, and their poses are published with
+  // the next messages. Physics is disabled during playback, so there are no
+  // collisions or contacts to process.
+  this->dataPtr->updateInfo.simTime = this->SimTime();
+  this->dataPtr->updateInfo.realTime = this->RealTime();
+
+  // Sensors wait on these events for the simulation time to advance.
+  const bool events = this->dataPtr->logPlayMode == LOG_PLAY_SENSORS;
+  if (events)
+    SignalWorldUpdateBegin(this->dataPtr->updateInfo);
+
+  UpdateLinkStateCache(*this->dataPtr);
+
+  if (this->dataPtr->rayQuerySnapshotEnabled)
+    this->UpdateRayQuerySnapshot();
+
+  if (events)
+  {
+    this->dataPtr->linkData.Update(this->dataPtr->updateInfo.simTime);
+    event::Events::worldUpdateEnd();
+  }
+}
+
 //////////////////////////////////////////////////
 void World::Fini()
 {
   this->dataPtr->stop = true;
   this->dataPtr->enablePhysicsEngine = false;
 
+  // Flush the responses that are still queued on the message thread.
+  this->SetPipelinedMessages(false);
+  this->SetAsyncFactory(false);
+
+  // Finish writing the last checkpoint.
+  this->dataPtr->checkpointPeriod = 0;
+  this->WaitForCheckpoint();
+
+  // Unfreeze models, and release the references held by the manager.
+  this->dataPtr->activityZones.SetEnabled(false);
+  this->dataPtr->deferredPluginModels.clear();
+
 #ifdef HAVE_OPENAL
   util::OpenAL::Instance()->Fini();
 #endif
@@ -939,12 +1782,17 @@ void World::Fini()
 
     this->dataPtr->poseLocalPub.reset();
     this->dataPtr->posePub.reset();
+    this->dataPtr->compactPosePub.reset();
     this->dataPtr->guiPub.reset();
     this->dataPtr->responsePub.reset();
     this->dataPtr->statPub.reset();
+    this->dataPtr->pluginStatsPub.reset();
+    this->dataPtr->transportStatsPub.reset();
     this->dataPtr->modelPub.reset();
+    this->dataPtr->modelVPub.reset();
     this->dataPtr->lightPub.reset();
     this->dataPtr->lightFactoryPub.reset();
+    this->dataPtr->linkData.SetPublisher(nullptr);
 
     this->dataPtr->factorySub.reset();
     this->dataPtr->controlSub.reset();
@@ -971,6 +1819,9 @@ void World::Fini()
   this->dataPtr->publishModelPoses.clear();
   this->dataPtr->publishModelScales.clear();
   this->dataPtr->publishLightPoses.clear();
+  this->dataPtr->pendingModelPoses.clear();
+  this->dataPtr->pendingLightPoses.clear();
+  this->dataPtr->publishedPoses.clear();
 
   // Clean entities
   for (auto &model : this->dataPtr->models)
@@ -979,6 +1830,8 @@ void World::Fini()
       model->Fini();
   }
   this->dataPtr->models.clear();
+  this->dataPtr->rayQuery.MarkDirty();
+  this->dataPtr->modelIndex.MarkDirty();
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -1001,7 +1854,7 @@ void World::Fini()
   }
   this->dataPtr->prevStates[0].SetWorld(WorldPtr());
   this->dataPtr->prevStates[1].SetWorld(WorldPtr());
-  this->dataPtr->prevUnfilteredState.SetWorld(WorldPtr());
+  this->dataPtr->logModels.clear();
   this->dataPtr->logPlayState.SetWorld(WorldPtr());
   this->dataPtr->states[0].clear();
   this->dataPtr->states[1].clear();
@@ -1205,6 +2058,9 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->linkStateCache.MarkDirty();
+  this->dataPtr->rayQuery.MarkDirty();
+  this->dataPtr->modelIndex.MarkDirty();
   return model;
 }
 
@@ -1260,6 +2116,9 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->linkStateCache.MarkDirty();
+  this->dataPtr->rayQuery.MarkDirty();
+  this->dataPtr->modelIndex.MarkDirty();
 
   return actor;
 }
@@ -1325,6 +2184,80 @@ void World::LoadEntities(sdf::ElementPtr _sdf, BasePtr _parent)
   }
 }
 
+//////////////////////////////////////////////////
+void World::PrefetchResources(sdf::ElementPtr _sdf)
+{
+  IGN_PROFILE("World::PrefetchResources");
+
+  // Visual meshes are only used by the server when sensors render them
+  std::set<std::string> uris;
+  CollectMeshUris(_sdf, HasRenderingSensor(_sdf), uris);
+
+  std::map<std::string, std::vector<std::string>> models;
+  for (auto const &uri : uris)
+    models[ResourceModel(uri)].push_back(uri);
+
+  std::vector<std::vector<std::string> *> groups;
+  for (auto &model : models)
+    groups.push_back(&model.second);
+
+  // Resolve the URIs, downloading missing models concurrently. This
+  // completes before the entities load, so that a model is never
+  // downloaded by an entity and a prefetch thread at the same time.
+  std::vector<std::vector<std::string>> filenames(groups.size());
+  tbb::parallel_for(static_cast<size_t>(0), groups.size(),
+      [&groups, &filenames](const size_t _i)
+      {
+        for (auto const &uri : *groups[_i])
+        {
+          const std::string filename = common::find_file(uri);
+          if (!filename.empty() &&
+              common::MeshManager::Instance()->IsValidFilename(filename))
+          {
+            filenames[_i].push_back(filename);
+          }
+        }
+      });
+
+  std::vector<std::string> meshes;
+  for (auto const &group : filenames)
+    meshes.insert(meshes.end(), group.begin(), group.end());
+
+  std::set<std::string> plugins;
+  CollectPluginFilenames(_sdf, plugins);
+
+  if (meshes.empty() && plugins.empty())
+    return;
+
+  // Parse the meshes and load the plugin libraries while the entities are
+  // created. An entity that needs a mesh still being parsed waits for it
+  // in the MeshManager.
+  this->dataPtr->prefetch = std::async(std::launch::async,
+      [meshes, plugins]()
+      {
+        tbb::parallel_for(static_cast<size_t>(0), meshes.size(),
+            [&meshes](const size_t _i)
+            {
+              // Errors are reported again when the shapes load.
+              try
+              {
+                common::MeshManager::Instance()->Load(meshes[_i]);
+              }
+              catch(common::Exception &)
+              {
+              }
+            });
+
+        // The libraries stay in the plugin registry, where the plugins
+        // find them. Errors are reported when the libraries load.
+        for (auto const &plugin : plugins)
+        {
+          void *handle = nullptr;
+          common::PluginRegistry::Factory(plugin, handle);
+        }
+      });
+}
+
 //////////////////////////////////////////////////
 unsigned int World::ModelCount() const
 {
@@ -1370,6 +2303,7 @@ void World::ResetTime()
   this->dataPtr->startTime = common::Time::GetWallTime();
   this->dataPtr->realTimeOffset = common::Time(0);
   this->dataPtr->iterations = 0;
+  this->CacheStepTimes(common::Timestamp::Now());
 
   if (this->IsPaused())
     this->dataPtr->pauseStartTime = this->dataPtr->startTime;
@@ -1436,6 +2370,27 @@ gazebo::common::Time World::SimTime() const
 void World::SetSimTime(const common::Time &_t)
 {
   this->dataPtr->simTime = _t;
+  this->dataPtr->stepSimTime = common::Timestamp(_t).Nanoseconds();
+}
+
+//////////////////////////////////////////////////
+common::Time World::StepSimTime() const
+{
+  return common::Timestamp(this->dataPtr->stepSimTime).ToTime();
+}
+
+//////////////////////////////////////////////////
+common::Timestamp World::StepWallTime() const
+{
+  return common::Timestamp(this->dataPtr->stepWallTime);
+}
+
+//////////////////////////////////////////////////
+void World::CacheStepTimes(const common::Timestamp &_wallTime)
+{
+  this->dataPtr->stepSimTime =
+    common::Timestamp(this->dataPtr->simTime).Nanoseconds();
+  this->dataPtr->stepWallTime = _wallTime.Nanoseconds();
 }
 
 //////////////////////////////////////////////////
@@ -1506,8 +2461,25 @@ void World::SetPaused(const bool _p)
 //////////////////////////////////////////////////
 void World::OnFactoryMsg(ConstFactoryPtr &_msg)
 {
+  this->QueueFactoryMsg(*_msg);
+}
+
+//////////////////////////////////////////////////
+void World::QueueFactoryMsg(const msgs::Factory &_msg)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->factoryMutex);
+    if (this->dataPtr->factoryThread)
+    {
+      this->dataPtr->factoryQueue.push_back(_msg);
+      this->dataPtr->factoryCondition.notify_one();
+      return;
+    }
+  }
+
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
-  this->dataPtr->factoryMsgs.push_back(*_msg);
+  this->dataPtr->factoryMsgs.emplace_back();
+  this->dataPtr->factoryMsgs.back().msg = _msg;
 }
 
 //////////////////////////////////////////////////
@@ -1585,6 +2557,30 @@ void World::ProcessPlaybackControlMsgs()
       common::Time targetSimTime = msgs::Convert(msg.seek());
       util::LogPlay::Instance()->Seek(targetSimTime);
       this->dataPtr->stepInc = 1;
+
+      // Frames that are not keyframes only hold what changed. Rebuild the
+      // state at the new position from the frames before it in its chunk,
+      // which starts with a keyframe.
+      std::vector<std::string> frames;
+      if (util::LogPlay::Instance()->ChunkFrames(frames) && !frames.empty())
+      {
+        WorldState seekState;
+        for (auto const &frame : frames)
+        {
+          // Skip the initial world description.
+          if (frame.find("<state") == std::string::npos)
+            continue;
+
+          this->dataPtr->logPlayStateSDF->Clear();
+          if (!sdf::readString(frame, this->dataPtr->logPlayStateSDF))
+            continue;
+
+          WorldState frameState;
+          frameState.Load(this->dataPtr->logPlayStateSDF);
+          seekState.Merge(frameState);
+        }
+        this->SetState(seekState);
+      }
     }
 
     if (msg.has_rewind() && msg.rewind())
@@ -1673,19 +2669,91 @@ void World::BuildSceneMsg(msgs::Scene &_scene, BasePtr _entity)
 
 
 //////////////////////////////////////////////////
-// void World::ModelUpdateTBB()
-// {
-//   tbb::parallel_for (tbb::blocked_range<size_t>(0,
-//   this->dataPtr->models.size(), 10),
-//       ModelUpdate_TBB(&this->dataPtr->models));
-// }
+void World::ModelUpdateTBB()
+{
+  // Gather the entities that are not safe to run concurrently, which are
+  // updated in order on the world thread, and the rest for the thread pool.
+  this->dataPtr->parallelModels.clear();
+  this->dataPtr->serialEntities.clear();
+  this->dataPtr->animatedActors.clear();
+  const bool zones = this->dataPtr->activityZones.Enabled();
+  for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
+  {
+    BasePtr child = this->dataPtr->rootElement->GetChild(i);
+    if (child->HasType(Base::MODEL))
+    {
+      ModelPtr model = boost::static_pointer_cast<Model>(child);
+      if (zones && !this->dataPtr->activityZones.ShouldUpdate(model))
+        continue;
+
+      if (model->ThreadSafeUpdate() && !model->IsStatic())
+      {
+        this->dataPtr->parallelModels.push_back(model);
+        continue;
+      }
+
+      if (child->HasType(Base::ACTOR))
+      {
+        ActorPtr actor = boost::static_pointer_cast<Actor>(child);
+        if (actor->IsActive())
+          this->dataPtr->animatedActors.push_back(actor);
+      }
+    }
+    this->dataPtr->serialEntities.push_back(child);
+  }
+
+  // Evaluating skeleton animations only touches each actor, so it runs on
+  // the thread pool. Setting the link poses stays in Actor::Update.
+  if (this->dataPtr->animatedActors.size() > 1)
+  {
+    Actor_V &actors = this->dataPtr->animatedActors;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, actors.size(), 1),
+        [&actors](const tbb::blocked_range<size_t> &_r)
+        {
+          for (size_t i = _r.begin(); i != _r.end(); ++i)
+            actors[i]->EvaluateAnimation();
+        });
+  }
+
+  for (auto const &entity : this->dataPtr->serialEntities)
+    entity->Update();
+
+  if (this->dataPtr->parallelModels.empty())
+    return;
+
+  // A grain size of one lets the scheduler steal individual models, which
+  // balances well when the cost of Model::Update varies a lot between models.
+  tbb::parallel_for(tbb::blocked_range<size_t>(0,
+      this->dataPtr->parallelModels.size(), 1),
+      ModelUpdate_TBB(&this->dataPtr->parallelModels));
+}
 
 //////////////////////////////////////////////////
 void World::ModelUpdateSingleLoop()
 {
   // Update all the models
+  if (!this->dataPtr->activityZones.Enabled())
+  {
+    for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount();
+         ++i)
+    {
+      this->dataPtr->rootElement->GetChild(i)->Update();
+    }
+    return;
+  }
+
+  // Inactive models are only updated at a reduced rate
   for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
-    this->dataPtr->rootElement->GetChild(i)->Update();
+  {
+    BasePtr child = this->dataPtr->rootElement->GetChild(i);
+    if (child->HasType(Base::MODEL) &&
+        !this->dataPtr->activityZones.ShouldUpdate(
+          boost::static_pointer_cast<Model>(child)))
+    {
+      continue;
+    }
+    child->Update();
+  }
 }
 
 
@@ -1703,6 +2771,16 @@ void World::LoadPlugins()
     }
   }
 
+  // World plugins may configure the activity zones, so the frozen models
+  // are only known now.
+  const bool defer = this->dataPtr->activityZones.Enabled() &&
+      this->dataPtr->activityZones.DeferPlugins();
+  if (defer)
+  {
+    this->dataPtr->activityZones.Update(this->dataPtr->models,
+        this->dataPtr->iterations);
+  }
+
   // Load the plugins for all the models
   for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
   {
@@ -1710,7 +2788,13 @@ void World::LoadPlugins()
     {
       ModelPtr model = boost::static_pointer_cast<Model>(
           this->dataPtr->rootElement->GetChild(i));
-      model->LoadPlugins();
+      if (defer && !this->dataPtr->activityZones.IsActive(model))
+        this->dataPtr->deferredPluginModels.push_back(model);
+      else
+        model->LoadPlugins();
+
+      if (this->dataPtr->sdfMemorySaver)
+        model->ReleaseSDF();
     }
   }
 }
@@ -1732,6 +2816,8 @@ void World::LoadPlugin(const std::string &_filename,
             << "Plugin filename[" << _filename << "] name[" << _name << "]\n";
       return;
     }
+    common::PluginProfiler::Scope scope(_filename,
+        this->Name() + "::" + _name);
     plugin->Load(shared_from_this(), _sdf);
     this->dataPtr->plugins.push_back(plugin);
 
@@ -1782,19 +2868,26 @@ void World::ProcessEntityMsgs()
 //////////////////////////////////////////////////
 void World::ProcessRequestMsgs()
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
-  msgs::Response response;
+  // Take the pending requests so that the transport callbacks are not
+  // blocked while the responses are built.
+  std::list<msgs::Request> requestMsgs;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+    requestMsgs.swap(this->dataPtr->requestMsgs);
+  }
 
-  for (auto const &requestMsg : this->dataPtr->requestMsgs)
+  for (auto const &requestMsg : requestMsgs)
   {
     bool send = true;
+    msgs::Response response;
+    std::unique_ptr<google::protobuf::Message> payload;
     response.set_id(requestMsg.id());
     response.set_request(requestMsg.request());
     response.set_response("success");
 
     if (requestMsg.request() == "entity_list")
     {
-      msgs::Model_V modelVMsg;
+      auto modelVMsg = std::make_unique<msgs::Model_V>();
 
       for (unsigned int i = 0;
           i < this->dataPtr->rootElement->GetChildCount(); ++i)
@@ -1802,15 +2895,13 @@ void World::ProcessRequestMsgs()
         BasePtr entity = this->dataPtr->rootElement->GetChild(i);
         if (entity->HasType(Base::MODEL))
         {
-          msgs::Model *modelMsg = modelVMsg.add_models();
+          msgs::Model *modelMsg = modelVMsg->add_models();
           ModelPtr model = boost::dynamic_pointer_cast<Model>(entity);
           model->FillMsg(*modelMsg);
         }
       }
 
-      response.set_type(modelVMsg.GetTypeName());
-      std::string *serializedData = response.mutable_serialized_data();
-      modelVMsg.SerializeToString(serializedData);
+      payload = std::move(modelVMsg);
     }
     else if (requestMsg.request() == "entity_delete")
     {
@@ -1825,44 +2916,32 @@ void World::ProcessRequestMsgs()
       {
         if (entity->HasType(Base::MODEL))
         {
-          msgs::Model modelMsg;
+          auto modelMsg = std::make_unique<msgs::Model>();
           ModelPtr model = boost::dynamic_pointer_cast<Model>(entity);
-          model->FillMsg(modelMsg);
-
-          std::string *serializedData = response.mutable_serialized_data();
-          modelMsg.SerializeToString(serializedData);
-          response.set_type(modelMsg.GetTypeName());
+          model->FillMsg(*modelMsg);
+          payload = std::move(modelMsg);
         }
         else if (entity->HasType(Base::LINK))
         {
-          msgs::Link linkMsg;
+          auto linkMsg = std::make_unique<msgs::Link>();
           LinkPtr link = boost::dynamic_pointer_cast<Link>(entity);
-          link->FillMsg(linkMsg);
-
-          std::string *serializedData = response.mutable_serialized_data();
-          linkMsg.SerializeToString(serializedData);
-          response.set_type(linkMsg.GetTypeName());
+          link->FillMsg(*linkMsg);
+          payload = std::move(linkMsg);
         }
         else if (entity->HasType(Base::COLLISION))
         {
-          msgs::Collision collisionMsg;
+          auto collisionMsg = std::make_unique<msgs::Collision>();
           CollisionPtr collision =
             boost::dynamic_pointer_cast<Collision>(entity);
-          collision->FillMsg(collisionMsg);
-
-          std::string *serializedData = response.mutable_serialized_data();
-          collisionMsg.SerializeToString(serializedData);
-          response.set_type(collisionMsg.GetTypeName());
+          collision->FillMsg(*collisionMsg);
+          payload = std::move(collisionMsg);
         }
         else if (entity->HasType(Base::JOINT))
         {
-          msgs::Joint jointMsg;
+          auto jointMsg = std::make_unique<msgs::Joint>();
           JointPtr joint = boost::dynamic_pointer_cast<Joint>(entity);
-          joint->FillMsg(jointMsg);
-
-          std::string *serializedData = response.mutable_serialized_data();
-          jointMsg.SerializeToString(serializedData);
-          response.set_type(jointMsg.GetTypeName());
+          joint->FillMsg(*jointMsg);
+          payload = std::move(jointMsg);
         }
       }
       else
@@ -1901,28 +2980,28 @@ void World::ProcessRequestMsgs()
         }
       }
 
-      msgs::GzString msg;
+      auto msg = std::make_unique<msgs::GzString>();
       std::ostringstream stream;
       stream << "<?xml version='1.0'?>\n"
              << "<sdf version='" << SDF_VERSION << "'>\n"
              << newSdf->ToString("")
              << "</sdf>";
 
-      msg.set_data(stream.str());
-
-      std::string *serializedData = response.mutable_serialized_data();
-      msg.SerializeToString(serializedData);
-      response.set_type(msg.GetTypeName());
+      msg->set_data(stream.str());
+      payload = std::move(msg);
     }
     else if (requestMsg.request() == "scene_info")
     {
-      this->dataPtr->sceneMsg.clear_model();
-      this->dataPtr->sceneMsg.clear_light();
-      this->BuildSceneMsg(this->dataPtr->sceneMsg, this->dataPtr->rootElement);
-
-      std::string *serializedData = response.mutable_serialized_data();
-      this->dataPtr->sceneMsg.SerializeToString(serializedData);
-      response.set_type(this->dataPtr->sceneMsg.GetTypeName());
+      {
+        // sceneMsg is also updated by the transport callbacks
+        std::lock_guard<std::recursive_mutex> lock(
+            this->dataPtr->receiveMutex);
+        this->dataPtr->sceneMsg.clear_model();
+        this->dataPtr->sceneMsg.clear_light();
+        this->BuildSceneMsg(this->dataPtr->sceneMsg,
+            this->dataPtr->rootElement);
+        payload = std::make_unique<msgs::Scene>(this->dataPtr->sceneMsg);
+      }
 
       for (auto road : this->dataPtr->roads)
       {
@@ -1932,30 +3011,364 @@ void World::ProcessRequestMsgs()
     }
     else if (requestMsg.request() == "spherical_coordinates_info")
     {
-      msgs::SphericalCoordinates sphereCoordMsg;
-      msgs::Set(&sphereCoordMsg, *(this->dataPtr->sphericalCoordinates));
-
-      std::string *serializedData = response.mutable_serialized_data();
-      sphereCoordMsg.SerializeToString(serializedData);
-      response.set_type(sphereCoordMsg.GetTypeName());
+      auto sphereCoordMsg = std::make_unique<msgs::SphericalCoordinates>();
+      msgs::Set(sphereCoordMsg.get(), *(this->dataPtr->sphericalCoordinates));
+      payload = std::move(sphereCoordMsg);
+    }
+    else if (requestMsg.request() == "memory_info")
+    {
+      auto memoryMsg = std::make_unique<msgs::MemoryInfo>();
+      FillMemoryInfo(*memoryMsg);
+      payload = std::move(memoryMsg);
     }
     else
       send = false;
 
     if (send)
-    {
-      this->dataPtr->responsePub->Publish(response);
-    }
+      this->SendResponse(response, std::move(payload));
   }
-
-  this->dataPtr->requestMsgs.clear();
 }
 
 //////////////////////////////////////////////////
-void World::ProcessModelMsgs()
+void World::SendResponse(msgs::Response &_response,
+    std::unique_ptr<google::protobuf::Message> _payload)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
-  for (auto const &modelMsg : this->dataPtr->modelMsgs)
+  if (_payload)
+    _response.set_type(_payload->GetTypeName());
+
+  if (this->dataPtr->pipelinedMessages)
+  {
+    // Serialization and publication happen on the message thread, in
+    // parallel with the next physics step.
+    std::lock_guard<std::mutex> lock(this->dataPtr->responseMutex);
+    this->dataPtr->responseQueue.emplace_back();
+    this->dataPtr->responseQueue.back().response.Swap(&_response);
+    this->dataPtr->responseQueue.back().payload = std::move(_payload);
+    this->dataPtr->responseCondition.notify_one();
+    return;
+  }
+
+  if (_payload)
+    _payload->SerializeToString(_response.mutable_serialized_data());
+  this->dataPtr->responsePub->Publish(_response);
+}
+
+//////////////////////////////////////////////////
+void World::ResponseWorker()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->responseMutex);
+  while (!this->dataPtr->stopResponseThread ||
+         !this->dataPtr->responseQueue.empty())
+  {
+    if (this->dataPtr->responseQueue.empty())
+    {
+      this->dataPtr->responseCondition.wait(lock);
+      continue;
+    }
+
+    std::list<PendingResponse> responses;
+    responses.swap(this->dataPtr->responseQueue);
+    lock.unlock();
+
+    for (auto &pending : responses)
+    {
+      if (pending.payload)
+      {
+        pending.payload->SerializeToString(
+            pending.response.mutable_serialized_data());
+      }
+      if (this->dataPtr->responsePub)
+        this->dataPtr->responsePub->Publish(pending.response);
+    }
+
+    lock.lock();
+  }
+}
+
+//////////////////////////////////////////////////
+void World::SetPipelinedMessages(const bool _enable)
+{
+  if (_enable && !this->dataPtr->responseThread)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->responseMutex);
+      this->dataPtr->stopResponseThread = false;
+    }
+    this->dataPtr->responseThread =
+      new std::thread(std::bind(&World::ResponseWorker, this));
+    this->dataPtr->pipelinedMessages = true;
+  }
+  else if (!_enable && this->dataPtr->responseThread)
+  {
+    this->dataPtr->pipelinedMessages = false;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->responseMutex);
+      this->dataPtr->stopResponseThread = true;
+      this->dataPtr->responseCondition.notify_all();
+    }
+    // The worker flushes the queued responses before exiting.
+    this->dataPtr->responseThread->join();
+    delete this->dataPtr->responseThread;
+    this->dataPtr->responseThread = nullptr;
+  }
+}
+
+//////////////////////////////////////////////////
+bool World::PipelinedMessages() const
+{
+  return this->dataPtr->pipelinedMessages;
+}
+
+//////////////////////////////////////////////////
+void World::FactoryWorker()
+{
+  // The world thread keeps factorySDF for itself
+  sdf::SDFPtr factorySDF(new sdf::SDF);
+  sdf::initFile("root.sdf", factorySDF);
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->factoryMutex);
+  while (!this->dataPtr->stopFactoryThread)
+  {
+    if (this->dataPtr->factoryQueue.empty())
+    {
+      this->dataPtr->factoryCondition.wait(lock);
+      continue;
+    }
+
+    FactoryRequest request;
+    request.msg = this->dataPtr->factoryQueue.front();
+    this->dataPtr->factoryQueue.pop_front();
+    lock.unlock();
+
+    request.sdf = PrepareFactorySDF(request.msg, factorySDF);
+    {
+      std::lock_guard<std::recursive_mutex> receiveLock(
+          this->dataPtr->receiveMutex);
+      this->dataPtr->factoryMsgs.push_back(std::move(request));
+    }
+
+    lock.lock();
+  }
+}
+
+//////////////////////////////////////////////////
+void World::SetAsyncFactory(const bool _enable)
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->factoryMutex);
+  if (_enable && !this->dataPtr->factoryThread)
+  {
+    this->dataPtr->stopFactoryThread = false;
+    this->dataPtr->factoryThread =
+      new std::thread(std::bind(&World::FactoryWorker, this));
+  }
+  else if (!_enable && this->dataPtr->factoryThread)
+  {
+    this->dataPtr->stopFactoryThread = true;
+    this->dataPtr->factoryCondition.notify_all();
+    std::thread *thread = this->dataPtr->factoryThread;
+    this->dataPtr->factoryThread = nullptr;
+    lock.unlock();
+
+    // The worker finishes the message it is reading, the world thread
+    // reads the ones left.
+    thread->join();
+    delete thread;
+
+    lock.lock();
+    std::lock_guard<std::recursive_mutex> receiveLock(
+        this->dataPtr->receiveMutex);
+    for (auto const &msg : this->dataPtr->factoryQueue)
+    {
+      this->dataPtr->factoryMsgs.emplace_back();
+      this->dataPtr->factoryMsgs.back().msg = msg;
+    }
+    this->dataPtr->factoryQueue.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+bool World::AsyncFactory() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->factoryMutex);
+  return this->dataPtr->factoryThread != nullptr;
+}
+
+//////////////////////////////////////////////////
+void World::SetFactoryBudget(const double _seconds)
+{
+  this->dataPtr->factoryBudget = _seconds;
+}
+
+//////////////////////////////////////////////////
+double World::FactoryBudget() const
+{
+  return this->dataPtr->factoryBudget;
+}
+
+//////////////////////////////////////////////////
+void World::SetLogPlayback(const LogPlayMode _mode)
+{
+  this->dataPtr->logPlayMode = _mode;
+}
+
+//////////////////////////////////////////////////
+World::LogPlayMode World::LogPlayback() const
+{
+  return this->dataPtr->logPlayMode;
+}
+
+//////////////////////////////////////////////////
+void World::ProcessModelInstances()
+{
+  std::list<ModelInstances> instancesList;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+    std::swap(instancesList, this->dataPtr->modelInstances);
+  }
+
+  if (instancesList.empty())
+    return;
+
+  std::lock_guard<std::mutex> deleteLock(this->dataPtr->factoryDeleteMutex);
+  std::unique_lock<std::mutex> lock(this->dataPtr->loadModelMutex);
+
+  // Names in use, so that making a name unique doesn't search the whole
+  // entity tree for every model
+  std::set<std::string> names;
+  for (auto const &model : this->dataPtr->models)
+    names.insert(model->GetName());
+
+  std::vector<sdf::ElementPtr> elems;
+  for (auto const &instances : instancesList)
+  {
+    sdf::SDFPtr sdfParsed(new sdf::SDF);
+    sdf::initFile("root.sdf", sdfParsed);
+    if (!sdf::readString(instances.sdf, sdfParsed))
+    {
+      gzerr << "Unable to read sdf string[" << instances.sdf << "]\n";
+      continue;
+    }
+
+    sdf::ElementPtr root = sdfParsed->Root();
+    if (root->HasElement("world"))
+      root = root->GetElement("world");
+    if (!root->HasElement("model"))
+    {
+      gzerr << "Unable to find a model in:\n";
+      sdfParsed->Root()->PrintValues("");
+      continue;
+    }
+
+    std::vector<sdf::ElementPtr> batch;
+    sdf::ElementPtr modelElem = root->GetElement("model");
+    if (instances.poses.empty())
+    {
+      for (; modelElem; modelElem = modelElem->GetNextElement("model"))
+        batch.push_back(modelElem->Clone());
+    }
+    else
+    {
+      // Defaults to <name>_<index> for the clones
+      const std::string name = modelElem->Get<std::string>("name");
+      for (size_t i = 0; i < instances.poses.size(); ++i)
+      {
+        sdf::ElementPtr clone = modelElem->Clone();
+        clone->GetElement("pose")->Set(instances.poses[i]);
+        clone->GetAttribute("name")->Set(name + "_" + std::to_string(i));
+        batch.push_back(clone);
+      }
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      std::string name = i < instances.names.size() ?
+          instances.names[i] : batch[i]->Get<std::string>("name");
+      if (name.empty())
+      {
+        gzerr << "Can't load model with empty name" << std::endl;
+        continue;
+      }
+
+      const std::string base = name;
+      int suffix = 0;
+      while (names.count(name) > 0)
+        name = base + "_" + std::to_string(suffix++);
+      names.insert(name);
+
+      batch[i]->GetAttribute("name")->Set(name);
+      elems.push_back(batch[i]);
+    }
+  }
+
+  // Load every model before announcing them in a single message
+  msgs::Model_V modelsMsg;
+  std::vector<ModelPtr> loaded;
+  loaded.reserve(elems.size());
+  for (auto const &elem : elems)
+  {
+    try
+    {
+      elem->SetParent(this->dataPtr->sdf);
+      this->dataPtr->sdf->InsertElement(elem);
+
+      ModelPtr model = this->dataPtr->physicsEngine->CreateModel(
+          this->dataPtr->rootElement);
+      model->SetWorld(shared_from_this());
+      model->Load(elem);
+
+      event::Events::addEntity(model->GetScopedName());
+      model->FillMsg(*modelsMsg.add_models());
+
+      this->PublishModelPose(model);
+      this->dataPtr->models.push_back(model);
+      loaded.push_back(model);
+    }
+    catch(...)
+    {
+      gzerr << "Loading model [" << elem->Get<std::string>("name")
+        << "] failed\n";
+    }
+  }
+
+  lock.unlock();
+
+  if (loaded.empty())
+    return;
+
+  this->EnableAllModels();
+  this->dataPtr->linkStateCache.MarkDirty();
+  this->dataPtr->rayQuery.MarkDirty();
+  this->dataPtr->modelIndex.MarkDirty();
+  this->dataPtr->modelVPub->Publish(modelsMsg);
+
+  // Plugins may look up other models, so the lock must be released first
+
+  for (auto const &model : loaded)
+  {
+    try
+    {
+      model->Init();
+      model->LoadPlugins();
+    }
+    catch(...)
+    {
+      gzerr << "Initializing model [" << model->GetName() << "] failed\n";
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void World::ProcessModelMsgs()
+{
+  // Take the pending messages so that the transport callbacks are not
+  // blocked while they are applied.
+  std::list<msgs::Model> modelMsgs;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+    modelMsgs.swap(this->dataPtr->modelMsgs);
+  }
+
+  for (auto const &modelMsg : modelMsgs)
   {
     ModelPtr model;
     if (modelMsg.has_id())
@@ -1995,11 +3408,8 @@ void World::ProcessModelMsgs()
     }
   }
 
-  if (!this->dataPtr->modelMsgs.empty())
-  {
+  if (!modelMsgs.empty())
     this->EnableAllModels();
-    this->dataPtr->modelMsgs.clear();
-  }
 }
 
 //////////////////////////////////////////////////
@@ -2077,57 +3487,62 @@ void World::ProcessLightFactoryMsgs()
 //////////////////////////////////////////////////
 void World::ProcessFactoryMsgs()
 {
-  std::list<sdf::ElementPtr> modelsToLoad, lightsToLoad;
-
-  std::list<msgs::Factory> factoryMsgsCopy;
+  std::list<FactoryRequest> requests;
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
-
-    std::copy(this->dataPtr->factoryMsgs.begin(),
-      this->dataPtr->factoryMsgs.end(),
-      std::back_inserter(factoryMsgsCopy));
-    this->dataPtr->factoryMsgs.clear();
+    requests.swap(this->dataPtr->factoryMsgs);
   }
 
-  for (auto const &factoryMsg : factoryMsgsCopy)
+  // Stop inserting once the budget is spent, at least one request is
+  // processed per call. The rest waits for the next call.
+  const double budget = this->dataPtr->factoryBudget;
+  const common::Time budgetStart = common::Time::GetWallTime();
+
+  for (bool first = true; !requests.empty(); first = false)
   {
-    this->dataPtr->factorySDF->Clear();
+    if (!first && budget > 0 &&
+        (common::Time::GetWallTime() - budgetStart).Double() >= budget)
+    {
+      break;
+    }
+
+    FactoryRequest request = std::move(requests.front());
+    requests.pop_front();
+    const msgs::Factory &factoryMsg = request.msg;
 
-    if (factoryMsg.has_sdf() && !factoryMsg.sdf().empty())
+    // Root element of the SDF to insert, read by the factory thread or
+    // here.
+    sdf::ElementPtr root = request.sdf;
+
+    if (!root && factoryMsg.has_sdf() && !factoryMsg.sdf().empty())
     {
+      this->dataPtr->factorySDF->Clear();
+
       // SDF Parsing happens here
       if (!sdf::readString(factoryMsg.sdf(), this->dataPtr->factorySDF))
       {
         gzerr << "Unable to read sdf string[" << factoryMsg.sdf() << "]\n";
         continue;
       }
+      root = this->dataPtr->factorySDF->Root();
     }
-    else if (factoryMsg.has_sdf_filename() &&
+    else if (!root && factoryMsg.has_sdf_filename() &&
             !factoryMsg.sdf_filename().empty())
     {
-      std::string filename;
-      // If http(s), look at Fuel
-      auto uri = ignition::common::URI(factoryMsg.sdf_filename());
-      if (uri.Valid() && (uri.Scheme() == "https" || uri.Scheme() == "http"))
-      {
-        filename = common::FuelModelDatabase::Instance()->ModelFile(
-            factoryMsg.sdf_filename());
-      }
-      // Otherwise, look at database
-      else
-      {
-        filename = common::ModelDatabase::Instance()->GetModelFile(
-            factoryMsg.sdf_filename());
-      }
+      this->dataPtr->factorySDF->Clear();
 
+      std::string filename = FactoryModelFile(factoryMsg.sdf_filename());
       if (!sdf::readFile(filename, this->dataPtr->factorySDF))
       {
         gzerr << "Unable to read sdf file.\n";
         continue;
       }
+      root = this->dataPtr->factorySDF->Root();
     }
-    else if (factoryMsg.has_clone_model_name())
+    else if (!root && factoryMsg.has_clone_model_name())
     {
+      this->dataPtr->factorySDF->Clear();
+
       ModelPtr model = this->ModelByName(factoryMsg.clone_model_name());
       if (!model)
       {
@@ -2144,8 +3559,9 @@ void World::ProcessFactoryMsgs()
 
       this->dataPtr->factorySDF->Root()->GetElement("model")->GetAttribute(
           "name")->Set(newName);
+      root = this->dataPtr->factorySDF->Root();
     }
-    else
+    else if (!root)
     {
       gzerr << "Unable to load sdf from factory message."
         << "No SDF or SDF filename specified.\n";
@@ -2159,10 +3575,10 @@ void World::ProcessFactoryMsgs()
       if (base)
       {
         sdf::ElementPtr elem;
-        if (this->dataPtr->factorySDF->Root()->GetName() == "sdf")
-          elem = this->dataPtr->factorySDF->Root()->GetFirstElement();
+        if (root->GetName() == "sdf")
+          elem = root->GetFirstElement();
         else
-          elem = this->dataPtr->factorySDF->Root();
+          elem = root;
 
         base->UpdateParameters(elem);
       }
@@ -2173,12 +3589,13 @@ void World::ProcessFactoryMsgs()
       bool isModel = false;
       bool isLight = false;
 
-      sdf::ElementPtr elem = this->dataPtr->factorySDF->Root()->Clone();
+      // The factory thread already gave us a copy.
+      sdf::ElementPtr elem = request.sdf ? root : root->Clone();
 
       if (!elem)
       {
         gzerr << "Invalid SDF:";
-        this->dataPtr->factorySDF->Root()->PrintValues("");
+        root->PrintValues("");
         continue;
       }
 
@@ -2203,7 +3620,7 @@ void World::ProcessFactoryMsgs()
       else
       {
         gzerr << "Unable to find a model, light, or actor in:\n";
-        this->dataPtr->factorySDF->Root()->PrintValues("");
+        root->PrintValues("");
         continue;
       }
 
@@ -2246,50 +3663,51 @@ void World::ProcessFactoryMsgs()
           elem->GetAttribute("name")->Set(entityName);
         }
 
-        modelsToLoad.push_back(elem);
+        try
+        {
+          std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
+
+          ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
+          if (model != nullptr)
+          {
+            model->Init();
+            model->LoadPlugins();
+            if (this->dataPtr->sdfMemorySaver)
+              model->ReleaseSDF();
+          }
+        }
+        catch(...)
+        {
+          gzerr << "Loading model from factory message failed\n";
+        }
       }
       else if (isLight)
       {
-        lightsToLoad.push_back(elem);
-      }
-    }
-  }
-
-  // Load models
-  for (auto const &elem : modelsToLoad)
-  {
-    try
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
+        try
+        {
+          std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
 
-      ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
-      if (model != nullptr)
-      {
-        model->Init();
-        model->LoadPlugins();
+          LightPtr light = this->LoadLight(elem, this->dataPtr->rootElement);
+          light->Init();
+        }
+        catch(...)
+        {
+          gzerr << "Loading light from factory message failed\n";
+        }
       }
     }
-    catch(...)
-    {
-      gzerr << "Loading model from factory message failed\n";
-    }
   }
 
-  // Load lights
-  for (auto const &elem : lightsToLoad)
+  if (!requests.empty())
   {
-    try
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
-
-      LightPtr light = this->LoadLight(elem, this->dataPtr->rootElement);
-      light->Init();
-    }
-    catch(...)
-    {
-      gzerr << "Loading light from factory message failed\n";
-    }
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+    this->dataPtr->factoryMsgs.splice(this->dataPtr->factoryMsgs.begin(),
+        requests);
   }
+
+  // Don't keep the last model read around
+  if (this->dataPtr->sdfMemorySaver)
+    this->dataPtr->factorySDF->Clear();
 }
 
 //////////////////////////////////////////////////
@@ -2320,6 +3738,79 @@ EntityPtr World::EntityBelowPoint(const ignition::math::Vector3d &_pt) const
   return this->EntityByName(entityName);
 }
 
+//////////////////////////////////////////////////
+void World::SaveSnapshot(std::string &_snapshot)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  boost::recursive_mutex::scoped_lock plock(
+      *this->Physics()->GetPhysicsUpdateMutex());
+
+  std::vector<double> &state = this->dataPtr->snapshotState;
+  state.clear();
+  this->dataPtr->physicsEngine->SaveSnapshot(state);
+
+  WorldSnapshotHeader header;
+  header.sec = this->dataPtr->simTime.sec;
+  header.nsec = this->dataPtr->simTime.nsec;
+  header.iterations = this->dataPtr->iterations;
+  header.stateSize = state.size();
+
+  const size_t stateBytes = state.size() * sizeof(double);
+  _snapshot.resize(sizeof(header) + stateBytes);
+  std::memcpy(&_snapshot[0], &header, sizeof(header));
+  if (stateBytes > 0)
+    std::memcpy(&_snapshot[sizeof(header)], state.data(), stateBytes);
+}
+
+//////////////////////////////////////////////////
+bool World::RestoreSnapshot(const std::string &_snapshot)
+{
+  WorldSnapshotHeader header;
+  if (_snapshot.size() < sizeof(header))
+  {
+    gzerr << "Invalid world snapshot, size is too small\n";
+    return false;
+  }
+
+  std::memcpy(&header, _snapshot.data(), sizeof(header));
+  if (header.magic != WorldSnapshotHeader::kMagic ||
+      _snapshot.size() != sizeof(header) + header.stateSize * sizeof(double))
+  {
+    gzerr << "Invalid world snapshot\n";
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  boost::recursive_mutex::scoped_lock plock(
+      *this->Physics()->GetPhysicsUpdateMutex());
+
+  std::vector<double> &state = this->dataPtr->snapshotState;
+  state.resize(header.stateSize);
+  if (header.stateSize > 0)
+  {
+    std::memcpy(state.data(), _snapshot.data() + sizeof(header),
+        header.stateSize * sizeof(double));
+  }
+
+  if (!this->dataPtr->physicsEngine->RestoreSnapshot(state))
+    return false;
+
+  // Engines that write their poses through the dirty pose buffer need it
+  // applied now, so the entities match the restored state while paused.
+  this->dataPtr->dirtyPoses.Drain([](Entity *_dirtyEntity)
+  {
+    _dirtyEntity->SetWorldPose(_dirtyEntity->DirtyPose(), false);
+  });
+
+  this->SetSimTime(common::Time(header.sec, header.nsec));
+  this->dataPtr->iterations = header.iterations;
+
+  UpdateLinkStateCache(*this->dataPtr);
+  this->UpdateRayQuerySnapshot();
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 void World::SetState(const WorldState &_state)
 {
@@ -2455,28 +3946,38 @@ void World::SetState(const WorldState &_state)
 //////////////////////////////////////////////////
 void World::InsertModelFile(const std::string &_sdfFilename)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   msgs::Factory msg;
   msg.set_sdf_filename(_sdfFilename);
-  this->dataPtr->factoryMsgs.push_back(msg);
+  this->QueueFactoryMsg(msg);
 }
 
 //////////////////////////////////////////////////
 void World::InsertModelSDF(const sdf::SDF &_sdf)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   msgs::Factory msg;
   msg.set_sdf(_sdf.ToString());
-  this->dataPtr->factoryMsgs.push_back(msg);
+  this->QueueFactoryMsg(msg);
 }
 
 //////////////////////////////////////////////////
 void World::InsertModelString(const std::string &_sdfString)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   msgs::Factory msg;
   msg.set_sdf(_sdfString);
-  this->dataPtr->factoryMsgs.push_back(msg);
+  this->QueueFactoryMsg(msg);
+}
+
+//////////////////////////////////////////////////
+void World::InsertModelInstances(const std::string &_sdfString,
+    const std::vector<ignition::math::Pose3d> &_poses,
+    const std::vector<std::string> &_names)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  ModelInstances instances;
+  instances.sdf = _sdfString;
+  instances.poses = _poses;
+  instances.names = _names;
+  this->dataPtr->modelInstances.push_back(std::move(instances));
 }
 
 //////////////////////////////////////////////////
@@ -2509,6 +4010,7 @@ void World::DisableAllModels()
 //////////////////////////////////////////////////
 void World::UpdateStateSDF()
 {
+  RestoreModelSDF(*this->dataPtr);
   this->dataPtr->sdf->Update();
   sdf::ElementPtr stateElem = this->dataPtr->sdf->GetElement("state");
   stateElem->ClearElements();
@@ -2687,84 +4189,107 @@ bool World::OnLog(std::ostringstream &_stream)
 //////////////////////////////////////////////////
 void World::ProcessMessages()
 {
+  const common::Timestamp phaseStart = common::Timestamp::Now();
+
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
-    if ((this->dataPtr->posePub && this->dataPtr->posePub->HasConnections()) ||
-      // When ready to use the direct API for updating scene poses from server,
-      // uncomment the following line:
-         this->dataPtr->updateScenePoses ||
+    // Poses for the server side scene and rendering sensors. This stream is
+    // never throttled nor delta encoded, since rendering::Scene relies on its
+    // time stamp.
+    if (this->dataPtr->updateScenePoses ||
         (this->dataPtr->poseLocalPub &&
          this->dataPtr->poseLocalPub->HasConnections()))
     {
-      msgs::PosesStamped msg;
+      // Fill a message recycled by the publisher when it is published, so
+      // that it is handed over without a copy
+      const bool publish = this->dataPtr->poseLocalPub &&
+          this->dataPtr->poseLocalPub->HasConnections();
+      boost::shared_ptr<msgs::PosesStamped> msg = publish ?
+          this->dataPtr->poseLocalPub->BorrowMessage<msgs::PosesStamped>() :
+          this->dataPtr->poseLocalMsg;
+
+      // Clear keeps the allocated pose messages around for reuse.
+      msg->Clear();
 
       // Time stamp this PosesStamped message
-      msgs::Set(msg.mutable_time(), this->SimTime());
+      msgs::Set(msg->mutable_time(), this->SimTime());
 
-      if (!this->dataPtr->publishModelPoses.empty() ||
-          !this->dataPtr->publishLightPoses.empty())
-      {
-        for (auto const &model : this->dataPtr->publishModelPoses)
-        {
-          std::list<ModelPtr> modelList;
-          modelList.push_back(model);
-          while (!modelList.empty())
-          {
-            ModelPtr m = modelList.front();
-            modelList.pop_front();
-            msgs::Pose *poseMsg = msg.add_pose();
+      this->FillPosesMsg(*msg, this->dataPtr->publishModelPoses,
+          this->dataPtr->publishLightPoses, false);
 
-            // Publish the model's relative pose
-            poseMsg->set_name(m->GetScopedName());
-            poseMsg->set_id(m->GetId());
-            msgs::Set(poseMsg, m->RelativePose());
+      if (publish)
+      {
+        // rendering::Scene depends on this timestamp, which is used by
+        // rendering sensors to time stamp their data
+        this->dataPtr->poseLocalPub->Publish(transport::MessagePtr(msg));
+      }
 
-            // Publish each of the model's child links relative poses
-            Link_V links = m->GetLinks();
-            for (auto const &link : links)
-            {
-              poseMsg = msg.add_pose();
-              poseMsg->set_name(link->GetScopedName());
-              poseMsg->set_id(link->GetId());
-              msgs::Set(poseMsg, link->RelativePose());
-            }
+      // Execute callback to export Pose msg
+      if (this->dataPtr->updateScenePoses)
+      {
+        this->dataPtr->updateScenePoses(this->Name(), *msg);
+      }
+    }
 
-            // add all nested models to the queue
-            Model_V models = m->NestedModels();
-            for (auto const &n : models)
-              modelList.push_back(n);
-          }
+    // Poses for clients. Entities that moved are accumulated until the
+    // publish period has elapsed, so that the message is only built when it
+    // is actually sent. Each client gets the full or the compact poses,
+    // depending on the topic it subscribed to.
+    const bool fullPoses =
+        this->dataPtr->posePub && this->dataPtr->posePub->HasConnections();
+    const bool compactPoses = this->dataPtr->compactPosePub &&
+        this->dataPtr->compactPosePub->HasConnections();
+    if (fullPoses || compactPoses)
+    {
+      this->dataPtr->pendingModelPoses.insert(
+          this->dataPtr->publishModelPoses.begin(),
+          this->dataPtr->publishModelPoses.end());
+      this->dataPtr->pendingLightPoses.insert(
+          this->dataPtr->publishLightPoses.begin(),
+          this->dataPtr->publishLightPoses.end());
+
+      common::Time now = common::Time::GetWallTime();
+      bool due = this->dataPtr->posePublishPeriod <= common::Time::Zero ||
+          now - this->dataPtr->prevPosePublishTime >=
+          this->dataPtr->posePublishPeriod;
+
+      if (due && (!this->dataPtr->pendingModelPoses.empty() ||
+                  !this->dataPtr->pendingLightPoses.empty()))
+      {
+        // A recycled message keeps its pose entries from earlier publishes
+        boost::shared_ptr<msgs::PosesStamped> msg;
+        if (fullPoses)
+        {
+          msg = this->dataPtr->posePub->BorrowMessage<msgs::PosesStamped>();
+          msgs::Set(msg->mutable_time(), this->SimTime());
         }
 
-        for (auto const &light : this->dataPtr->publishLightPoses)
+        boost::shared_ptr<msgs::PosesCompact> compact;
+        if (compactPoses)
         {
-          msgs::Pose *poseMsg = msg.add_pose();
-
-          // Publish the light's pose
-          poseMsg->set_name(light->GetScopedName());
-          poseMsg->set_id(light->GetId());
-          msgs::Set(poseMsg, light->RelativePose());
+          compact =
+            this->dataPtr->compactPosePub->BorrowMessage<msgs::PosesCompact>();
+          msgs::Set(compact->mutable_time(), this->SimTime());
+          compact->set_position_precision(
+              this->dataPtr->compactPosePrecision);
         }
 
-        if (this->dataPtr->posePub && this->dataPtr->posePub->HasConnections())
-          this->dataPtr->posePub->Publish(msg);
-      }
+        this->FillPosesMsg(msg.get(), compact.get(),
+            this->dataPtr->pendingModelPoses,
+            this->dataPtr->pendingLightPoses, true);
 
-      if (this->dataPtr->poseLocalPub &&
-          this->dataPtr->poseLocalPub->HasConnections())
-      {
-        // rendering::Scene depends on this timestamp, which is used by
-        // rendering sensors to time stamp their data
-        this->dataPtr->poseLocalPub->Publish(msg);
-      }
+        if (msg && msg->pose_size() > 0)
+          this->dataPtr->posePub->Publish(transport::MessagePtr(msg));
+        if (compact && compact->id_size() > 0)
+        {
+          this->dataPtr->compactPosePub->Publish(
+              transport::MessagePtr(compact));
+        }
 
-      // When ready to use the direct API for updating scene poses from server,
-      // uncomment the following lines:
-      // Execute callback to export Pose msg
-      if (this->dataPtr->updateScenePoses)
-      {
-        this->dataPtr->updateScenePoses(this->Name(), msg);
+        this->dataPtr->prevPosePublishTime = now;
+        this->dataPtr->pendingModelPoses.clear();
+        this->dataPtr->pendingLightPoses.clear();
       }
     }
 
@@ -2847,11 +4372,14 @@ void World::ProcessMessages()
     this->ProcessEntityMsgs();
     this->ProcessRequestMsgs();
     this->ProcessFactoryMsgs();
+    this->ProcessModelInstances();
     this->ProcessModelMsgs();
     this->ProcessLightFactoryMsgs();
     this->ProcessLightModifyMsgs();
     this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
   }
+
+  AddPhaseTime(*this->dataPtr, WORLD_PHASE_MESSAGES, phaseStart);
 }
 
 //////////////////////////////////////////////////
@@ -2881,11 +4409,358 @@ void World::PublishWorldStats()
         logStats);
   }
 
+  // Average the phase times once per period, so that the messages that
+  // pass the throttling of the publisher all carry a recent breakdown.
+  const common::Timestamp now = common::Timestamp::Now();
+  if (now - this->dataPtr->phaseTimesStart >= PHASE_TIMES_PERIOD)
+  {
+    if (this->dataPtr->phaseIterations > 0)
+    {
+      double avg[WORLD_PHASE_COUNT];
+      for (int i = 0; i < WORLD_PHASE_COUNT; ++i)
+      {
+        avg[i] = this->dataPtr->phaseTimes[i].Double() /
+          this->dataPtr->phaseIterations;
+      }
+
+      msgs::WorldStatistics::PhaseTimes &phases =
+        this->dataPtr->phaseTimesMsg;
+      phases.set_message_processing(avg[WORLD_PHASE_MESSAGES]);
+      phases.set_model_update(avg[WORLD_PHASE_MODELS]);
+      phases.set_collision(avg[WORLD_PHASE_COLLISION]);
+      phases.set_physics(avg[WORLD_PHASE_PHYSICS]);
+      phases.set_dirty_poses(avg[WORLD_PHASE_DIRTY_POSES]);
+      phases.set_contact_publish(avg[WORLD_PHASE_CONTACTS]);
+      phases.set_logging(avg[WORLD_PHASE_LOGGING]);
+      phases.set_sensor_wait(avg[WORLD_PHASE_SENSORS]);
+    }
+
+    for (auto &phaseTime : this->dataPtr->phaseTimes)
+      phaseTime = common::Timestamp();
+    this->dataPtr->phaseIterations = 0;
+    this->dataPtr->phaseTimesStart = now;
+
+    if (this->dataPtr->stepPeriodCount > 0)
+    {
+      msgs::WorldStatistics::StepJitter &jitter =
+        this->dataPtr->stepJitterMsg;
+      jitter.Clear();
+      jitter.set_target_period(
+          this->dataPtr->physicsEngine->GetUpdatePeriod());
+      jitter.set_period_min(this->dataPtr->stepPeriodMin.Double());
+      jitter.set_period_avg(this->dataPtr->stepPeriodTotal.Double() /
+          this->dataPtr->stepPeriodCount);
+      jitter.set_period_max(this->dataPtr->stepPeriodMax.Double());
+      for (auto const bound : STEP_LATENESS_BOUNDS)
+        jitter.add_bucket_bound(bound);
+      for (auto const count : this->dataPtr->stepLateness)
+        jitter.add_bucket_count(count);
+      jitter.set_overruns(this->dataPtr->stepOverruns);
+      jitter.set_real_time(this->dataPtr->realTime);
+    }
+
+    this->dataPtr->stepPeriodTotal = common::Timestamp();
+    this->dataPtr->stepPeriodCount = 0;
+    this->dataPtr->stepLateness.assign(STEP_LATENESS_BOUNDS.size() + 1, 0);
+  }
+
+  if (this->dataPtr->phaseTimesMsg.IsInitialized())
+  {
+    this->dataPtr->worldStatsMsg.mutable_phase_times()->CopyFrom(
+        this->dataPtr->phaseTimesMsg);
+  }
+
+  if (this->dataPtr->stepJitterMsg.IsInitialized())
+  {
+    this->dataPtr->worldStatsMsg.mutable_step_jitter()->CopyFrom(
+        this->dataPtr->stepJitterMsg);
+  }
+
   if (this->dataPtr->statPub && this->dataPtr->statPub->HasConnections())
     this->dataPtr->statPub->Publish(this->dataPtr->worldStatsMsg);
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
 }
 
+//////////////////////////////////////////////////
+void World::PublishPluginStats()
+{
+  const common::Time wallTime = common::Time::GetWallTime();
+  if (wallTime - this->dataPtr->prevPluginStatsTime < PLUGIN_STATS_PERIOD)
+    return;
+  this->dataPtr->prevPluginStatsTime = wallTime;
+
+  double budget = this->dataPtr->physicsEngine->GetMaxStepSize();
+  const double factor =
+    this->dataPtr->physicsEngine->GetTargetRealTimeFactor();
+  if (factor > 0)
+    budget /= factor;
+  common::PluginProfiler::SetWarningThreshold(
+      this->dataPtr->slowCallbackFraction * budget);
+
+  if (!this->dataPtr->pluginStatsPub ||
+      !this->dataPtr->pluginStatsPub->HasConnections())
+  {
+    return;
+  }
+
+  // The stats are kept for the whole process, keep this world's plugins
+  const std::string prefix = this->Name() + "::";
+  msgs::PluginStats msg;
+  msgs::Set(msg.mutable_sim_time(), this->SimTime());
+  for (auto const stats : common::PluginProfiler::Stats())
+  {
+    if (stats->instance.compare(0, prefix.size(), prefix) != 0)
+      continue;
+
+    msgs::PluginStats::Plugin *plugin = msg.add_plugin();
+    plugin->set_filename(stats->filename);
+    plugin->set_instance(stats->instance);
+    plugin->set_call_count(stats->calls);
+    plugin->set_total_time(stats->totalTime * 1e-9);
+    plugin->set_max_time(stats->maxTime * 1e-9);
+  }
+  this->dataPtr->pluginStatsPub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void World::PublishTransportStats()
+{
+  if (!this->dataPtr->transportStatsPub ||
+      !this->dataPtr->transportStatsPub->HasConnections())
+  {
+    return;
+  }
+
+  const common::Time wallTime = common::Time::GetWallTime();
+  if (wallTime - this->dataPtr->prevTransportStatsTime <
+      TRANSPORT_STATS_PERIOD)
+  {
+    return;
+  }
+  this->dataPtr->prevTransportStatsTime = wallTime;
+
+  // The stats are kept for the whole process, including the topics of
+  // other worlds
+  msgs::TransportStats msg;
+  transport::TopicStatistics::Fill(msg);
+  this->dataPtr->transportStatsPub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void World::SetSlowCallbackFraction(const double _fraction)
+{
+  this->dataPtr->slowCallbackFraction = std::max(0.0, _fraction);
+
+  // Apply the new threshold on the next step
+  this->dataPtr->prevPluginStatsTime = common::Time::Zero;
+}
+
+//////////////////////////////////////////////////
+double World::SlowCallbackFraction() const
+{
+  return this->dataPtr->slowCallbackFraction;
+}
+
+//////////////////////////////////////////////////
+void World::SetRealTimeMode(const bool _enable, const int _priority,
+    const int _cpu)
+{
+  if (this->dataPtr->thread)
+  {
+    gzwarn << "The real-time mode of world [" << this->Name()
+           << "] is applied when it starts running\n";
+  }
+
+  this->dataPtr->realTime = _enable;
+  this->dataPtr->realTimePriority = _priority;
+  this->dataPtr->realTimeCpu = _cpu;
+}
+
+//////////////////////////////////////////////////
+bool World::RealTimeMode() const
+{
+  return this->dataPtr->realTime;
+}
+
+//////////////////////////////////////////////////
+void World::SetCompactStaticModels(const bool _enable)
+{
+  this->dataPtr->compactStaticModels = _enable;
+}
+
+//////////////////////////////////////////////////
+bool World::CompactStaticModels() const
+{
+  return this->dataPtr->compactStaticModels;
+}
+
+//////////////////////////////////////////////////
+void World::ProcessStartupRequests()
+{
+  if (this->dataPtr->thread != nullptr)
+    return;
+
+  this->ProcessRequestMsgs();
+}
+
+//////////////////////////////////////////////////
+void World::SetSDFMemorySaver(const bool _enable)
+{
+  this->dataPtr->sdfMemorySaver = _enable;
+}
+
+//////////////////////////////////////////////////
+bool World::SDFMemorySaver() const
+{
+  return this->dataPtr->sdfMemorySaver;
+}
+
+//////////////////////////////////////////////////
+void World::SetParallelModelUpdate(const bool _enable)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  if (_enable)
+    this->dataPtr->modelUpdateFunc = &World::ModelUpdateTBB;
+  else
+    this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
+}
+
+//////////////////////////////////////////////////
+bool World::ParallelModelUpdate() const
+{
+  return this->dataPtr->modelUpdateFunc == &World::ModelUpdateTBB;
+}
+
+//////////////////////////////////////////////////
+void World::SetLinkStateCacheEnabled(const bool _enable)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  if (_enable && !this->dataPtr->linkStateCacheEnabled)
+  {
+    // Fill the cache right away so it's valid before the next update.
+    this->dataPtr->linkStateCacheEnabled = true;
+    this->dataPtr->linkStateCache.MarkDirty();
+    UpdateLinkStateCache(*this->dataPtr);
+  }
+  else if (!_enable && this->dataPtr->linkStateCacheEnabled)
+  {
+    // Don't keep the links alive while nothing refreshes them
+    this->dataPtr->linkStateCacheEnabled = false;
+    this->dataPtr->linkStateCacheFresh = false;
+    this->dataPtr->linkStateCache.Clear();
+  }
+}
+
+//////////////////////////////////////////////////
+bool World::LinkStateCacheEnabled() const
+{
+  return this->dataPtr->linkStateCacheEnabled;
+}
+
+//////////////////////////////////////////////////
+const LinkStateCache &World::LinkStates() const
+{
+  return this->dataPtr->linkStateCache;
+}
+
+//////////////////////////////////////////////////
+RayQuery &World::SharedRayQuery()
+{
+  return this->dataPtr->rayQuery;
+}
+
+//////////////////////////////////////////////////
+void World::SetRayQuerySnapshotEnabled(const bool _enable)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->rayQuerySnapshotEnabled = _enable;
+  if (_enable)
+  {
+    // Take a snapshot right away so it's valid before the next update.
+    this->UpdateRayQuerySnapshot();
+  }
+  else
+  {
+    std::lock_guard<std::mutex> snapshotLock(
+        this->dataPtr->rayQuerySnapshotMutex);
+    this->dataPtr->rayQuerySnapshot.reset();
+  }
+}
+
+//////////////////////////////////////////////////
+bool World::RayQuerySnapshotEnabled() const
+{
+  return this->dataPtr->rayQuerySnapshotEnabled;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const RayQuery> World::RayQuerySnapshot() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->rayQuerySnapshotMutex);
+  return this->dataPtr->rayQuerySnapshot;
+}
+
+//////////////////////////////////////////////////
+void World::UpdateRayQuerySnapshot()
+{
+  if (!this->dataPtr->rayQuerySnapshotEnabled)
+    return;
+
+  std::shared_ptr<const RayQuery> snapshot;
+  {
+    boost::recursive_mutex::scoped_lock lock(
+        *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+    if (this->dataPtr->rayQuery.Update(this->dataPtr->models,
+          this->dataPtr->iterations))
+    {
+      snapshot = std::make_shared<RayQuery>(this->dataPtr->rayQuery);
+    }
+  }
+
+  // The previous snapshot is released after the lock, or later by the
+  // last sensor that still uses it.
+  std::lock_guard<std::mutex> lock(this->dataPtr->rayQuerySnapshotMutex);
+  this->dataPtr->rayQuerySnapshot.swap(snapshot);
+}
+
+//////////////////////////////////////////////////
+ActivityZoneManager &World::ActivityZones()
+{
+  return this->dataPtr->activityZones;
+}
+
+//////////////////////////////////////////////////
+ModelSpatialIndex &World::ModelIndex()
+{
+  this->dataPtr->modelIndex.Update(this->dataPtr->models,
+      this->dataPtr->iterations);
+  return this->dataPtr->modelIndex;
+}
+
+//////////////////////////////////////////////////
+UpdateScheduler &World::Scheduler()
+{
+  return this->dataPtr->scheduler;
+}
+
+//////////////////////////////////////////////////
+BatteryRegistry &World::Batteries()
+{
+  return this->dataPtr->batteries;
+}
+
+//////////////////////////////////////////////////
+LinkDataRegistry &World::LinkData()
+{
+  return this->dataPtr->linkData;
+}
+
+//////////////////////////////////////////////////
+FreezeRegistry &World::Freezes()
+{
+  return this->dataPtr->freezes;
+}
+
 //////////////////////////////////////////////////
 bool World::IsLoaded() const
 {
@@ -2899,6 +4774,170 @@ void World::PublishModelPose(physics::ModelPtr _model)
 
   // Only add if the model name is not in the list
   this->dataPtr->publishModelPoses.insert(_model);
+
+  // The pose changed after the link state cache was refreshed
+  this->dataPtr->linkStateCacheFresh = false;
+}
+
+//////////////////////////////////////////////////
+void World::FillPosesMsg(msgs::PosesStamped &_msg,
+    const std::set<ModelPtr> &_models, const std::set<LightPtr> &_lights,
+    const bool _delta)
+{
+  this->FillPosesMsg(&_msg, nullptr, _models, _lights, _delta);
+}
+
+//////////////////////////////////////////////////
+void World::FillPosesMsg(msgs::PosesStamped *_msg,
+    msgs::PosesCompact *_compact, const std::set<ModelPtr> &_models,
+    const std::set<LightPtr> &_lights, const bool _delta)
+{
+  // Returns true if the entity should be added to the message, and
+  // remembers the pose that is published.
+  auto moved = [this, _delta](const uint32_t _id,
+      const ignition::math::Pose3d &_pose)
+  {
+    if (!_delta || (this->dataPtr->poseLinearThreshold <= 0 &&
+                    this->dataPtr->poseAngularThreshold <= 0))
+    {
+      return true;
+    }
+
+    auto iter = this->dataPtr->publishedPoses.find(_id);
+    if (iter != this->dataPtr->publishedPoses.end())
+    {
+      const ignition::math::Pose3d &prev = iter->second;
+      const double dist = prev.Pos().Distance(_pose.Pos());
+      const double angle = 2.0 * std::acos(std::min(1.0,
+          std::abs((prev.Rot().Inverse() * _pose.Rot()).W())));
+      if (dist <= this->dataPtr->poseLinearThreshold &&
+          angle <= this->dataPtr->poseAngularThreshold)
+      {
+        return false;
+      }
+      iter->second = _pose;
+    }
+    else
+    {
+      this->dataPtr->publishedPoses[_id] = _pose;
+    }
+    return true;
+  };
+
+  auto addPose = [_msg, _compact](const BasePtr &_entity,
+      const ignition::math::Pose3d &_pose)
+  {
+    if (_msg)
+    {
+      msgs::Pose *poseMsg = _msg->add_pose();
+      poseMsg->set_name(_entity->GetScopedName());
+      poseMsg->set_id(_entity->GetId());
+      msgs::Set(poseMsg, _pose);
+    }
+    if (_compact)
+      msgs::AddCompactPose(*_compact, _entity->GetId(), _pose);
+  };
+
+  // Read the link poses from the link state cache when no pose changed
+  // since it was refreshed. Models inserted since then aren't in it yet.
+  const bool cached = this->dataPtr->linkStateCacheEnabled &&
+      this->dataPtr->linkStateCacheFresh;
+  std::vector<ignition::math::Pose3d> linkPoses;
+
+  for (auto const &model : _models)
+  {
+    std::list<ModelPtr> modelList;
+    modelList.push_back(model);
+    while (!modelList.empty())
+    {
+      ModelPtr m = modelList.front();
+      modelList.pop_front();
+
+      // Publish the model's relative pose
+      const ignition::math::Pose3d modelPose = m->RelativePose();
+      if (moved(m->GetId(), modelPose))
+        addPose(m, modelPose);
+
+      // Publish each of the model's child links relative poses
+      const Link_V &links = m->GetLinks();
+      if (cached && this->dataPtr->linkStateCache.ModelLinkRelativePoses(
+            m, linkPoses) && linkPoses.size() == links.size())
+      {
+        for (size_t i = 0; i < links.size(); ++i)
+        {
+          if (moved(links[i]->GetId(), linkPoses[i]))
+            addPose(links[i], linkPoses[i]);
+        }
+      }
+      else
+      {
+        for (auto const &link : links)
+        {
+          const ignition::math::Pose3d linkPose = link->RelativePose();
+          if (moved(link->GetId(), linkPose))
+            addPose(link, linkPose);
+        }
+      }
+
+      // add all nested models to the queue
+      for (auto const &n : m->NestedModels())
+        modelList.push_back(n);
+    }
+  }
+
+  for (auto const &light : _lights)
+  {
+    // Publish the light's pose
+    const ignition::math::Pose3d lightPose = light->RelativePose();
+    if (moved(light->GetId(), lightPose))
+      addPose(light, lightPose);
+  }
+}
+
+//////////////////////////////////////////////////
+void World::SetPosePublishRate(const double _hz)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  if (_hz > 0)
+    this->dataPtr->posePublishPeriod = common::Time(1.0 / _hz);
+  else
+    this->dataPtr->posePublishPeriod = common::Time::Zero;
+}
+
+//////////////////////////////////////////////////
+double World::PosePublishRate() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  if (this->dataPtr->posePublishPeriod <= common::Time::Zero)
+    return 0.0;
+  return 1.0 / this->dataPtr->posePublishPeriod.Double();
+}
+
+//////////////////////////////////////////////////
+void World::SetPosePublishThreshold(const double _linear,
+    const double _angular)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  this->dataPtr->poseLinearThreshold = _linear;
+  this->dataPtr->poseAngularThreshold = _angular;
+  this->dataPtr->publishedPoses.clear();
+}
+
+//////////////////////////////////////////////////
+void World::SetCompactPosePrecision(const double _precision)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  if (_precision > 0)
+    this->dataPtr->compactPosePrecision = _precision;
+  else
+    gzerr << "Compact pose precision must be positive\n";
+}
+
+//////////////////////////////////////////////////
+double World::CompactPosePrecision() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  return this->dataPtr->compactPosePrecision;
 }
 
 //////////////////////////////////////////////////
@@ -2929,48 +4968,89 @@ void World::LogWorker()
 
   GZ_ASSERT(self, "Self pointer to World is invalid");
 
-  // Init the prevUnfilteredState
-  this->dataPtr->prevUnfilteredState.Load(self);
+  // Init the entities used to find insertions and deletions
+  {
+    std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
+    this->dataPtr->logModelNames.clear();
+    for (auto const &model : this->Models())
+      this->dataPtr->logModelNames.insert(model->GetName());
+    this->dataPtr->logLightNames.clear();
+    for (auto const &light : this->Lights())
+      this->dataPtr->logLightNames.insert(light->GetName());
+
+    this->dataPtr->logFilter = util::LogRecord::Instance()->Filter();
+    this->dataPtr->logModels =
+      WorldState::FilterModels(self, this->dataPtr->logFilter);
+  }
 
   while (!this->dataPtr->stop)
   {
-    // get unfiltered world state
-    WorldState unfilteredState;
-    {
-      std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
-      unfilteredState.Load(self);
-    }
-
-    // compute world state diff and find out about insertions and deletions
     std::vector<std::string> insertions;
     std::vector<std::string> deletions;
     bool insertDelete = false;
 
+    // Throttle state capture based on log recording frequency.
+    auto simTime = this->SimTime();
+    int currState = (this->dataPtr->stateToggle + 1) % 2;
+    bool captured = false;
+
     {
-      WorldState unfilteredDiffState = unfilteredState -
-          this->dataPtr->prevUnfilteredState;
-      if (!unfilteredDiffState.IsZero())
+      std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
+
+      // Find insertions and deletions by name, so that the models outside
+      // of the filter don't need to be captured.
+      std::set<std::string> modelNames;
+      for (auto const &model : this->Models())
       {
-        insertions = unfilteredDiffState.Insertions();
-        deletions = unfilteredDiffState.Deletions();
-        insertDelete = !insertions.empty() || !deletions.empty();
+        modelNames.insert(model->GetName());
+        if (!this->dataPtr->logModelNames.count(model->GetName()))
+          insertions.push_back(model->UnscaledSDF()->ToString(""));
       }
-    }
-    this->dataPtr->prevUnfilteredState = unfilteredState;
 
-    // Throttle state capture based on log recording frequency.
-    auto simTime = this->SimTime();
-    if ((simTime - this->dataPtr->logLastStateTime >=
-        util::LogRecord::Instance()->Period()) || insertDelete)
-    {
-      int currState = (this->dataPtr->stateToggle + 1) % 2;
+      std::set<std::string> lightNames;
+      for (auto const &light : this->Lights())
+      {
+        lightNames.insert(light->GetName());
+        if (!this->dataPtr->logLightNames.count(light->GetName()))
+          insertions.push_back(light->GetSDF()->ToString(""));
+      }
+
+      for (auto const &modelName : this->dataPtr->logModelNames)
+      {
+        if (!modelNames.count(modelName))
+          deletions.push_back(modelName);
+      }
+
+      for (auto const &lightName : this->dataPtr->logLightNames)
+      {
+        if (!lightNames.count(lightName))
+          deletions.push_back(lightName);
+      }
+
+      insertDelete = !insertions.empty() || !deletions.empty();
+      this->dataPtr->logModelNames.swap(modelNames);
+      this->dataPtr->logLightNames.swap(lightNames);
 
+      // Resolve the filter again only when the models or the filter change.
       std::string filterStr = util::LogRecord::Instance()->Filter();
-      // compute diff for filtered states
+      if (insertDelete || filterStr != this->dataPtr->logFilter)
+      {
+        this->dataPtr->logFilter = filterStr;
+        this->dataPtr->logModels = WorldState::FilterModels(self, filterStr);
+      }
+
+      if ((simTime - this->dataPtr->logLastStateTime >=
+          util::LogRecord::Instance()->Period()) || insertDelete)
       {
-        std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
-        this->dataPtr->prevStates[currState].LoadWithFilter(self, filterStr);
+        // Capture the filtered models only.
+        this->dataPtr->prevStates[currState].Load(self,
+            this->dataPtr->logModels);
+        captured = true;
       }
+    }
+
+    if (captured)
+    {
       WorldState diffState = this->dataPtr->prevStates[currState] -
           this->dataPtr->prevStates[this->dataPtr->stateToggle];
       this->dataPtr->logPrevIteration = this->dataPtr->iterations;
@@ -2979,18 +5059,43 @@ void World::LogWorker()
       {
         this->dataPtr->stateToggle = currState;
         {
-          // Store the entire current state (instead of the diffState). A slow
-          // moving link may never be captured if only diff state is recorded.
           std::lock_guard<std::mutex> bLock(this->dataPtr->logBufferMutex);
 
-          this->dataPtr->prevStates[currState].SetInsertions(insertions);
-          this->dataPtr->prevStates[currState].SetDeletions(deletions);
-          this->dataPtr->states[this->dataPtr->currentStateBuffer].push_back(
-              this->dataPtr->prevStates[currState]);
+          WorldState &state = this->dataPtr->prevStates[currState];
+          state.SetInsertions(insertions);
+          state.SetDeletions(deletions);
+
+          // Every chunk starts with a keyframe, so playback can rebuild the
+          // state at any frame from the frames before it in its chunk.
+          auto &buffer =
+            this->dataPtr->states[this->dataPtr->currentStateBuffer];
+          const double keyframePeriod =
+            util::LogRecord::Instance()->KeyframePeriod();
+          if (keyframePeriod <= 0 || buffer.empty() ||
+              simTime - this->dataPtr->logLastKeyframeTime >= keyframePeriod)
+          {
+            buffer.push_back(state);
+            this->dataPtr->logRecordedState = state;
+            this->dataPtr->logLastKeyframeTime = simTime;
+          }
+          else
+          {
+            // Only store what changed since the recorded state (instead of
+            // the diff against the last captured state), so that slow
+            // moving links are recorded once they moved far enough.
+            WorldState changes = state.Changes(
+                this->dataPtr->logRecordedState,
+                util::LogRecord::Instance()->Tolerance());
+            if (changes.GetModelStateCount() > 0 ||
+                changes.LightStateCount() > 0 || insertDelete)
+            {
+              buffer.push_back(changes);
+              this->dataPtr->logRecordedState.Merge(changes);
+            }
+          }
 
           // Tell the logger to update, once the number of states exceeds 1000
-          if (this->dataPtr->states[this->dataPtr->currentStateBuffer].size() >
-              1000)
+          if (buffer.size() > 1000)
           {
             util::LogRecord::Instance()->Notify();
           }
@@ -3025,19 +5130,11 @@ void World::RemoveModel(const std::string &_name)
   std::lock_guard<std::mutex> flock(this->dataPtr->factoryDeleteMutex);
 
   // Remove all the dirty poses from the delete entity.
+  this->dataPtr->dirtyPoses.RemoveIf([&_name](Entity *_entity)
   {
-    for (auto entity = this->dataPtr->dirtyPoses.begin();
-             entity != this->dataPtr->dirtyPoses.end(); ++entity)
-    {
-      if ((*entity)->GetName() == _name ||
-         ((*entity)->GetParent() && (*entity)->GetParent()->GetName() == _name))
-      {
-        this->dataPtr->dirtyPoses.erase(entity++);
-      }
-      else
-        ++entity;
-    }
-  }
+    return _entity->GetName() == _name ||
+      (_entity->GetParent() && _entity->GetParent()->GetName() == _name);
+  });
 
   // Remove from SDF
   if (this->dataPtr->sdf->HasElement("model"))
@@ -3062,6 +5159,10 @@ void World::RemoveModel(const std::string &_name)
     }
   }
 
+  // Removed entities, whose last published poses are forgotten below
+  ModelPtr removedModel;
+  LightPtr removedLight;
+
   // remove objects in world
   {
     boost::recursive_mutex::scoped_lock lock(
@@ -3073,8 +5174,16 @@ void World::RemoveModel(const std::string &_name)
     {
       if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
       {
+        removedModel = *model;
+        this->dataPtr->deferredPluginModels.erase(
+            std::remove(this->dataPtr->deferredPluginModels.begin(),
+              this->dataPtr->deferredPluginModels.end(), *model),
+            this->dataPtr->deferredPluginModels.end());
         this->dataPtr->models.erase(model);
         this->dataPtr->rootElement->RemoveChild(_name);
+        this->dataPtr->linkStateCache.MarkDirty();
+        this->dataPtr->rayQuery.MarkDirty();
+        this->dataPtr->modelIndex.MarkDirty();
         break;
       }
     }
@@ -3095,6 +5204,7 @@ void World::RemoveModel(const std::string &_name)
           // list
           (*light)->GetParent()->RemoveChild(*light);
         }
+        removedLight = *light;
         this->dataPtr->lights.erase(light);
         break;
       }
@@ -3127,18 +5237,56 @@ void World::RemoveModel(const std::string &_name)
     }
   }
 
+  // Cleanup the pendingModelPoses list.
+  {
+    std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
+    for (auto model = this->dataPtr->pendingModelPoses.begin();
+             model != this->dataPtr->pendingModelPoses.end(); ++model)
+    {
+      if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
+      {
+        this->dataPtr->pendingModelPoses.erase(model);
+        break;
+      }
+    }
+  }
+
   // Cleanup the publishLightPoses list.
   {
     std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
-    for (auto light : this->dataPtr->publishLightPoses)
+    for (auto light = this->dataPtr->publishLightPoses.begin();
+             light != this->dataPtr->publishLightPoses.end(); ++light)
     {
-      if (light->GetName() == _name || light->GetScopedName() == _name)
+      if ((*light)->GetName() == _name || (*light)->GetScopedName() == _name)
       {
         this->dataPtr->publishLightPoses.erase(light);
         break;
       }
     }
   }
+
+  // Cleanup the pendingLightPoses list.
+  {
+    std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
+    for (auto light = this->dataPtr->pendingLightPoses.begin();
+             light != this->dataPtr->pendingLightPoses.end(); ++light)
+    {
+      if ((*light)->GetName() == _name || (*light)->GetScopedName() == _name)
+      {
+        this->dataPtr->pendingLightPoses.erase(light);
+        break;
+      }
+    }
+  }
+
+  // Cleanup the last published poses.
+  {
+    std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
+    if (removedModel)
+      ErasePublishedPoses(removedModel, this->dataPtr->publishedPoses);
+    if (removedLight)
+      this->dataPtr->publishedPoses.erase(removedLight->GetId());
+  }
 }
 
 /////////////////////////////////////////////////
@@ -3220,7 +5368,7 @@ void World::SetAtmosphereEnabled(const bool _enable)
 void World::_AddDirty(Entity *_entity)
 {
   GZ_ASSERT(_entity != nullptr, "_entity is nullptr");
-  this->dataPtr->dirtyPoses.push_back(_entity);
+  this->dataPtr->dirtyPoses.Push(_entity);
 }
 
 /////////////////////////////////////////////////
@@ -24,6 +24,8 @@
 #include <string>
 #include <memory>
 
+#include <ignition/math/Pose3.hh>
+
 #include <boost/enable_shared_from_this.hpp>
 
 #include <sdf/sdf.hh>
@@ -33,6 +35,7 @@
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/Timestamp.hh"
 #include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/common/URI.hh"
@@ -74,6 +77,39 @@ namespace gazebo
     class GZ_PHYSICS_VISIBLE World :
       public boost::enable_shared_from_this<World>
     {
+      /// \brief Events and side effects that World::BatchStep can trigger
+      /// once, after the last iteration of the batch. Values can be
+      /// combined with a bitwise or.
+      public: enum BatchStepEvent
+      {
+        /// \brief Trigger nothing.
+        BATCH_NONE = 0x00,
+        /// \brief Fire the worldUpdateBegin event.
+        BATCH_WORLD_UPDATE_BEGIN = 0x01,
+        /// \brief Fire the beforePhysicsUpdate event.
+        BATCH_BEFORE_PHYSICS_UPDATE = 0x02,
+        /// \brief Fire the worldUpdateEnd event.
+        BATCH_WORLD_UPDATE_END = 0x04,
+        /// \brief Publish the contacts of the last iteration.
+        BATCH_PUBLISH_CONTACTS = 0x08,
+        /// \brief Publish world statistics.
+        BATCH_PUBLISH_STATS = 0x10
+      };
+
+      /// \brief How much of the world update runs for each state played
+      /// back from a log file.
+      public: enum LogPlayMode
+      {
+        /// \brief Run the full world update: plugins, collisions and
+        /// contacts.
+        LOG_PLAY_FULL,
+        /// \brief Only apply the poses of the state and publish them.
+        LOG_PLAY_POSES,
+        /// \brief Apply and publish the poses, and fire the world update
+        /// events so that sensors update at the simulation time of the log.
+        LOG_PLAY_SENSORS
+      };
+
       /// \brief Constructor.
       /// Constructor for the World. Must specify a unique name.
       /// \param[in] _name Name of the world.
@@ -100,6 +136,27 @@ namespace gazebo
       /// \param[in] _filename Name of the file to save into.
       public: void Save(const std::string &_filename);
 
+      /// \brief Save a checkpoint of the world to a file.
+      /// Only the state (poses, velocities and joints) is captured on the
+      /// calling thread. The world description is reused from the previous
+      /// checkpoint unless models were inserted or deleted, and the SDF
+      /// generation and file output run in a background thread. The file
+      /// has the same format as the one written by Save.
+      /// \param[in] _filename Name of the file to save into.
+      /// \sa SetCheckpointPeriod
+      public: void SaveCheckpoint(const std::string &_filename);
+
+      /// \brief Block until the last checkpoint has been written.
+      public: void WaitForCheckpoint();
+
+      /// \brief Save checkpoints periodically while the world runs.
+      /// \param[in] _filename Name of the file to save into. Each checkpoint
+      /// replaces the previous one.
+      /// \param[in] _period Simulation time between checkpoints in seconds.
+      /// Zero or less disables periodic checkpoints.
+      public: void SetCheckpointPeriod(const std::string &_filename,
+                  const double _period);
+
       /// \brief Initialize the world.
       /// This is called after Load.
       /// \deprecated See Init(UpdateScenePosesFunc)
@@ -227,6 +284,19 @@ namespace gazebo
       /// \param[in] _t The new simulation time
       public: void SetSimTime(const common::Time &_t);
 
+      /// \brief Get the simulation time of the current step. It is cached
+      /// when each step starts, so it can be read from any thread without
+      /// locking, e.g. by sensors.
+      /// \return Simulation time of the current step.
+      /// \sa SimTime
+      public: common::Time StepSimTime() const;
+
+      /// \brief Get the wall time at the start of the current step, cached
+      /// like StepSimTime, for consumers that need a wall time once per step
+      /// but don't need it exact.
+      /// \return Monotonic time of the start of the current step.
+      public: common::Timestamp StepWallTime() const;
+
       /// \brief Get the amount of time simulation has been paused.
       /// \return The pause time.
       public: common::Time PauseTime() const;
@@ -297,6 +367,22 @@ namespace gazebo
       /// \param _state The state to set the World to.
       public: void SetState(const WorldState &_state);
 
+      /// \brief Save the dynamic state of the world into a compact binary
+      /// buffer. Unlike WorldState, the snapshot is taken directly from the
+      /// physics engine (including internal state such as the solver warm
+      /// start) and does not go through SDF.
+      /// \param[out] _snapshot Buffer that receives the snapshot.
+      /// \sa RestoreSnapshot
+      public: void SaveSnapshot(std::string &_snapshot);
+
+      /// \brief Restore a snapshot created with SaveSnapshot. Simulation
+      /// time, iterations and the state of every body are restored in
+      /// place, without creating or removing entities, so models must not
+      /// have been inserted or removed since the snapshot was taken.
+      /// \param[in] _snapshot Buffer written by SaveSnapshot.
+      /// \return False if the snapshot does not match this world.
+      public: bool RestoreSnapshot(const std::string &_snapshot);
+
       /// \brief Insert a model from an SDF file.
       /// Spawns a model into the world base on and SDF file.
       /// \param[in] _sdfFilename The name of the SDF file (including path).
@@ -312,6 +398,25 @@ namespace gazebo
       /// \param[in] _sdf A reference to an SDF object.
       public: void InsertModelSDF(const sdf::SDF &_sdf);
 
+      /// \brief Insert many models at once.
+      /// The SDF string is parsed once, and all the models are loaded in
+      /// the same world update and announced to the GUI and rendering with
+      /// a single message on ~/model/info_v. This is much faster than
+      /// calling InsertModelString for each model when spawning hundreds
+      /// or thousands of them.
+      /// \param[in] _sdfString A string containing valid SDF markup with
+      /// one or more <model> elements.
+      /// \param[in] _poses If empty, every model of _sdfString is inserted
+      /// once. Otherwise, the first model of _sdfString is cloned once per
+      /// pose.
+      /// \param[in] _names Name of each inserted model, in the same order
+      /// as the models or poses. Missing names default to the name of the
+      /// model, followed by "_<index>" when cloning. Names that are already
+      /// taken are made unique.
+      public: void InsertModelInstances(const std::string &_sdfString,
+                  const std::vector<ignition::math::Pose3d> &_poses = {},
+                  const std::vector<std::string> &_names = {});
+
       /// \brief Return a version of the name with "<world_name>::" removed
       /// \param[in] _name Usually the name of an entity.
       /// \return The stripped world name.
@@ -331,6 +436,23 @@ namespace gazebo
       /// \param[in] _steps The number of steps the World should take.
       public: void Step(const unsigned int _steps);
 
+      /// \brief Advance the world by a number of iterations in a tight loop.
+      /// Each iteration only updates the models and the physics engine:
+      /// no events are fired, nothing is published, sensors are not waited
+      /// on, the update rate is not throttled and the state is not logged.
+      /// A physics profile requested through the PresetManager is applied
+      /// at the start of the next iteration, as in a regular step.
+      /// The events selected in _events are triggered once, after the last
+      /// iteration. Like Step(unsigned int), this pauses the world and
+      /// blocks until the batch is complete.
+      /// The achieved rate is reported through the DiagnosticManager as
+      /// "World::BatchStep iterations/s".
+      /// \param[in] _iterations Number of iterations to take.
+      /// \param[in] _events Bitwise or of BatchStepEvent values.
+      /// \return Achieved number of iterations per wall clock second.
+      public: double BatchStep(const unsigned int _iterations,
+                  const unsigned int _events = BATCH_NONE);
+
       /// \brief Load a plugin
       /// \param[in] _filename The filename of the plugin.
       /// \param[in] _name A unique name for the plugin.
@@ -371,6 +493,218 @@ namespace gazebo
       /// \param[in] _enable True to enable the atmosphere model.
       public: void SetAtmosphereEnabled(const bool _enable);
 
+      /// \brief Enable or disable the parallel model update stage.
+      /// When enabled, models that declare Model::ThreadSafeUpdate are
+      /// updated concurrently on a work-stealing thread pool, while all
+      /// other models are updated serially on the world thread.
+      /// Plugin callbacks connected to the worldUpdateBegin event are not
+      /// affected and always run on the world thread.
+      /// \param[in] _enable True to enable parallel model updates.
+      public: void SetParallelModelUpdate(const bool _enable);
+
+      /// \brief Get whether the parallel model update stage is enabled.
+      /// \return True if models are updated in parallel.
+      /// \sa SetParallelModelUpdate
+      public: bool ParallelModelUpdate() const;
+
+      /// \brief Set the fraction of the wall time budget of a step above
+      /// which a plugin event callback logs a warning. The budget is the
+      /// step size divided by the target real time factor. The time spent
+      /// by each plugin is published on ~/plugins/stats, see
+      /// common::PluginProfiler.
+      /// \param[in] _fraction Fraction of the budget, zero to never warn.
+      /// The default is 0.5.
+      public: void SetSlowCallbackFraction(const double _fraction);
+
+      /// \brief Get the fraction of the step budget above which a plugin
+      /// event callback logs a warning.
+      /// \return Fraction of the budget.
+      /// \sa SetSlowCallbackFraction
+      public: double SlowCallbackFraction() const;
+
+      /// \brief Enable or disable the real-time mode of the world thread,
+      /// for hardware-in-the-loop simulation. In real-time mode the world
+      /// thread runs with the SCHED_FIFO policy, optionally pinned to a
+      /// CPU, the memory of the process is locked, and the thread spins
+      /// instead of sleeping just before the start of each step. The mode
+      /// only takes effect on Linux, and is applied when the world starts
+      /// running. The step period histogram and the overrun count are
+      /// published with the world statistics in either mode.
+      /// \param[in] _enable True to enable the real-time mode.
+      /// \param[in] _priority SCHED_FIFO priority of the world thread,
+      /// from 1 to 99.
+      /// \param[in] _cpu CPU to pin the world thread to, -1 to not pin it.
+      public: void SetRealTimeMode(const bool _enable,
+                  const int _priority = 80, const int _cpu = -1);
+
+      /// \brief Get whether the real-time mode is enabled.
+      /// \return True if enabled.
+      /// \sa SetRealTimeMode
+      public: bool RealTimeMode() const;
+
+      /// \brief Enable or disable the compact representation of static
+      /// models. Static models loaded while it is enabled:
+      /// - have no link or nested model states in WorldState, only their
+      /// pose and scale;
+      /// - only subscribe to ~/pose/modify at the model level, not for
+      /// each link and collision;
+      /// - with ODE, share one collision space for all their collisions,
+      /// so that the broadphase tests the static geometry as one tree.
+      /// Such models should stay static. Set it before the world loads to
+      /// cover the models of the world file.
+      /// \param[in] _enable True to enable the compact representation.
+      public: void SetCompactStaticModels(const bool _enable);
+
+      /// \brief Get whether static models use the compact representation.
+      /// \return True if enabled.
+      /// \sa SetCompactStaticModels
+      public: bool CompactStaticModels() const;
+
+      /// \brief Answer the requests received before the world runs, so
+      /// that clients get the scene while the server is still starting up,
+      /// e.g. while the sensors initialize. Does nothing once the world
+      /// runs, since the update loop answers the requests then.
+      public: void ProcessStartupRequests();
+
+      /// \brief Enable or disable the SDF memory saver. When enabled, the
+      /// parts of the SDF of each model that the server keeps in another
+      /// form, such as the visuals, are released once the plugins of the
+      /// model are loaded. World::SDF, World::Save and Model::GetSDF
+      /// recreate them from the entities, after which they are kept.
+      /// \param[in] _enable True to enable the memory saver.
+      public: void SetSDFMemorySaver(const bool _enable);
+
+      /// \brief Get whether the SDF memory saver is enabled.
+      /// \return True if enabled.
+      /// \sa SetSDFMemorySaver
+      public: bool SDFMemorySaver() const;
+
+      /// \brief Enable or disable the link state cache. When enabled, the
+      /// world pose, velocity and acceleration of every link are copied into
+      /// contiguous arrays once per update, see LinkStateCache.
+      /// \param[in] _enable True to refresh the cache every update.
+      public: void SetLinkStateCacheEnabled(const bool _enable);
+
+      /// \brief Get whether the link state cache is refreshed every update.
+      /// \return True if the cache is enabled.
+      public: bool LinkStateCacheEnabled() const;
+
+      /// \brief Get the link state cache. The content is only up to date
+      /// when the cache is enabled, and is empty while it is disabled. When
+      /// enabled, the link poses published on ~/pose/info are read from it.
+      /// \return Reference to the link state cache.
+      /// \sa SetLinkStateCacheEnabled
+      public: const LinkStateCache &LinkStates() const;
+
+      /// \brief Get the batched ray query shared by the multi-ray shapes of
+      /// this world. The caller must hold the physics update mutex.
+      /// \return Reference to the shared ray query.
+      /// \sa MultiRayShape::SetBatched
+      public: RayQuery &SharedRayQuery();
+
+      /// \brief Enable or disable ray query snapshots. When enabled, a copy
+      /// of the shared ray query is taken after every physics step, and
+      /// batched multi-ray shapes cast their rays against it from any
+      /// thread without locking the physics engine.
+      /// \param[in] _enable True to take a snapshot every step.
+      /// \sa MultiRayShape::SetBatched
+      public: void SetRayQuerySnapshotEnabled(const bool _enable);
+
+      /// \brief Get whether ray query snapshots are taken every step.
+      /// \return True if snapshots are enabled.
+      public: bool RayQuerySnapshotEnabled() const;
+
+      /// \brief Get the latest ray query snapshot.
+      /// \return The snapshot, null if snapshots are disabled or if the
+      /// world has collision shapes that the ray query does not support.
+      public: std::shared_ptr<const RayQuery> RayQuerySnapshot() const;
+
+      /// \brief Take a ray query snapshot if snapshots are enabled.
+      private: void UpdateRayQuerySnapshot();
+
+      /// \brief Get the tile based update manager, used to freeze the
+      /// parts of a large world that are far from any activity zone. It is
+      /// disabled by default. Configure it from the world thread, e.g. from
+      /// a plugin.
+      /// \return Reference to the activity zone manager.
+      public: ActivityZoneManager &ActivityZones();
+
+      /// \brief Get the spatial index of the bounding boxes of the models,
+      /// used by sensors that look for the models in a region. It is
+      /// brought up to date with the current iteration first, and can be
+      /// used from any thread.
+      /// \return Reference to the model spatial index.
+      public: ModelSpatialIndex &ModelIndex();
+
+      /// \brief Get the scheduler of the callbacks that run at a lower
+      /// rate than the physics, e.g. plugins that only need to update at
+      /// 10 to 50 Hz. The callbacks run right after the world update begin
+      /// event.
+      /// \return Reference to the update scheduler.
+      public: UpdateScheduler &Scheduler();
+
+      /// \brief Get the registry of the batteries of the links, which
+      /// updates them in a single pass right after the update scheduler.
+      /// \return Reference to the battery registry.
+      public: BatteryRegistry &Batteries();
+
+      /// \brief Get the registry of the link data requested by sensors,
+      /// see Link::SetPublishData. The data is sampled in a single pass
+      /// right before the world update end event.
+      /// \return Reference to the link data registry.
+      public: LinkDataRegistry &LinkData();
+
+      /// \brief Get the registry that arbitrates the freezing of links
+      /// between the sleep manager, the activity zones and plugins.
+      /// \return Reference to the freeze registry.
+      public: FreezeRegistry &Freezes();
+
+      /// \brief Enable or disable pipelined message processing.
+      /// Incoming messages are always applied at the same point, between two
+      /// world updates. When pipelining is enabled, the responses to
+      /// requests (entity_info, scene_info, ...) are serialized and
+      /// published by a separate thread, which overlaps with the next
+      /// physics update instead of delaying it.
+      /// \param[in] _enable True to enable pipelining.
+      public: void SetPipelinedMessages(const bool _enable);
+
+      /// \brief Get whether pipelined message processing is enabled.
+      /// \return True if responses are published from a separate thread.
+      public: bool PipelinedMessages() const;
+
+      /// \brief Enable or disable the factory thread. When enabled, the SDF
+      /// of factory messages and inserted models is read, and the meshes
+      /// and plugin libraries it uses are loaded, on a separate thread. The
+      /// world thread then only creates the entities, between two world
+      /// updates. Models are cloned and errors are reported by the world
+      /// thread.
+      /// \param[in] _enable True to enable the factory thread.
+      public: void SetAsyncFactory(const bool _enable);
+
+      /// \brief Get whether the factory thread is enabled.
+      /// \return True if factory messages are read on a separate thread.
+      public: bool AsyncFactory() const;
+
+      /// \brief Set the wall time the world thread spends inserting the
+      /// entities of factory messages each time it processes messages.
+      /// At least one message is processed each time, the others wait.
+      /// \param[in] _seconds Budget in seconds, zero or less for no limit.
+      /// The default is no limit.
+      public: void SetFactoryBudget(const double _seconds);
+
+      /// \brief Get the wall time budget of the factory messages.
+      /// \return Budget in seconds, zero or less for no limit.
+      public: double FactoryBudget() const;
+
+      /// \brief Set how much of the world update runs during log playback.
+      /// The default is LOG_PLAY_FULL.
+      /// \param[in] _mode Playback mode.
+      public: void SetLogPlayback(const LogPlayMode _mode);
+
+      /// \brief Get how much of the world update runs during log playback.
+      /// \return Playback mode.
+      public: LogPlayMode LogPlayback() const;
+
       /// \brief Update the state SDF value from the current state.
       public: void UpdateStateSDF();
 
@@ -388,6 +722,40 @@ namespace gazebo
       /// \param[in] _model Pointer to the model to publish.
       public: void PublishModelPose(physics::ModelPtr _model);
 
+      /// \brief Set the maximum rate at which poses are published on
+      /// ~/pose/info for clients. The ~/pose/local/info stream used by
+      /// server side rendering is never throttled.
+      /// \param[in] _hz Maximum rate in Hz, zero for no limit. The default
+      /// is 60 Hz.
+      public: void SetPosePublishRate(const double _hz);
+
+      /// \brief Get the maximum rate at which poses are published on
+      /// ~/pose/info.
+      /// \return Rate in Hz, zero if there's no limit.
+      public: double PosePublishRate() const;
+
+      /// \brief Only publish an entity on ~/pose/info if it moved more than
+      /// the given thresholds since the last time it was published. Both
+      /// thresholds default to zero, which disables the filter.
+      /// \param[in] _linear Position threshold in meters.
+      /// \param[in] _angular Orientation threshold in radians.
+      public: void SetPosePublishThreshold(const double _linear,
+                  const double _angular);
+
+      /// \brief Set the precision of the positions published on
+      /// ~/pose/compact/info. That topic carries the same poses as
+      /// ~/pose/info, at the same rate, as a msgs::PosesCompact without
+      /// names, for the subscribers that ask for it. It is only built while
+      /// it has subscribers.
+      /// \param[in] _precision Size of a position step in meters, 1e-4 by
+      /// default.
+      public: void SetCompactPosePrecision(const double _precision);
+
+      /// \brief Get the precision of the positions published on
+      /// ~/pose/compact/info.
+      /// \return Size of a position step in meters.
+      public: double CompactPosePrecision() const;
+
       /// \brief Publish scale updates for a model.
       /// This list of models to publish is processed and cleared once every
       /// iteration.
@@ -483,6 +851,15 @@ namespace gazebo
       /// \param[in] _parent Parent of the model to load.
       private: void LoadEntities(sdf::ElementPtr _sdf, BasePtr _parent);
 
+      /// \brief Resolve and download the collision meshes of a world
+      /// description on the thread pool, before the entities are created.
+      /// Visual meshes are included when a sensor renders them. The meshes
+      /// are then parsed, and the plugin libraries loaded, in the
+      /// background while the entities are created, which waits for the
+      /// meshes it needs in the MeshManager.
+      /// \param[in] _sdf SDF element of the world.
+      private: void PrefetchResources(sdf::ElementPtr _sdf);
+
       /// \brief Load a model.
       /// \param[in] _sdf SDF element containing the Model description.
       /// \param[in] _parent Parent of the model.
@@ -514,12 +891,29 @@ namespace gazebo
       /// \brief Step the world once.
       private: void Step();
 
+      /// \brief Implementation of BatchStep, must be called from the world
+      /// thread or when the world is not running.
+      /// \param[in] _iterations Number of iterations to take.
+      /// \param[in] _events Bitwise or of BatchStepEvent values.
+      /// \return Achieved number of iterations per wall clock second.
+      private: double BatchStepImpl(const unsigned int _iterations,
+                   const unsigned int _events);
+
       /// \brief Step the world once by reading from a log file.
       private: void LogStep();
 
       /// \brief Update the world.
       private: void Update();
 
+      /// \brief Cache the times of the current step, read by StepSimTime
+      /// and StepWallTime.
+      /// \param[in] _wallTime Time the step started.
+      private: void CacheStepTimes(const common::Timestamp &_wallTime);
+
+      /// \brief Light update of the world after a state was played back,
+      /// used instead of Update unless the playback mode is LOG_PLAY_FULL.
+      private: void LogPlayUpdate();
+
       /// \brief Pause callback.
       /// \param[in] _p True if paused.
       private: void OnPause(bool _p);
@@ -580,10 +974,35 @@ namespace gazebo
       /// Must only be called from the World::ProcessMessages function.
       private: void ProcessRequestMsgs();
 
-      /// \brief Process all received factory messages.
+      /// \brief Serialize a payload into a response and publish it, on the
+      /// message thread when pipelining is enabled.
+      /// \param[in,out] _response Response to send. Its content is moved
+      /// away when pipelining is enabled.
+      /// \param[in] _payload Message to send as the response data, may be
+      /// null.
+      private: void SendResponse(msgs::Response &_response,
+                   std::unique_ptr<google::protobuf::Message> _payload);
+
+      /// \brief Thread function that publishes queued responses.
+      private: void ResponseWorker();
+
+      /// \brief Queue a factory message, for the factory thread if it is
+      /// enabled, or for the world thread.
+      /// \param[in] _msg The factory message.
+      private: void QueueFactoryMsg(const msgs::Factory &_msg);
+
+      /// \brief Thread function that reads queued factory messages.
+      private: void FactoryWorker();
+
+      /// \brief Process the received factory messages, within the factory
+      /// budget.
       /// Must only be called from the World::ProcessMessages function.
       private: void ProcessFactoryMsgs();
 
+      /// \brief Load the models queued by InsertModelInstances.
+      /// Must only be called from the World::ProcessMessages function.
+      private: void ProcessModelInstances();
+
       /// \brief Process all received model messages.
       /// Must only be called from the World::ProcessMessages function.
       private: void ProcessModelMsgs();
@@ -610,9 +1029,44 @@ namespace gazebo
       /// \brief Process all incoming messages.
       private: void ProcessMessages();
 
+      /// \brief Append the relative poses of models, their links and nested
+      /// models, and lights to a poses message.
+      /// \param[in,out] _msg Message to fill.
+      /// \param[in] _models Models to add.
+      /// \param[in] _lights Lights to add.
+      /// \param[in] _delta True to skip the entities that didn't move more
+      /// than the thresholds set with SetPosePublishThreshold.
+      private: void FillPosesMsg(msgs::PosesStamped &_msg,
+                   const std::set<ModelPtr> &_models,
+                   const std::set<LightPtr> &_lights, const bool _delta);
+
+      /// \brief Append the relative poses of models, their links and nested
+      /// models, and lights to a poses message, a compact poses message, or
+      /// both.
+      /// \param[in,out] _msg Message to fill, null for none.
+      /// \param[in,out] _compact Compact message to fill, null for none.
+      /// \param[in] _models Models to add.
+      /// \param[in] _lights Lights to add.
+      /// \param[in] _delta True to skip the entities that didn't move more
+      /// than the thresholds set with SetPosePublishThreshold.
+      private: void FillPosesMsg(msgs::PosesStamped *_msg,
+                   msgs::PosesCompact *_compact,
+                   const std::set<ModelPtr> &_models,
+                   const std::set<LightPtr> &_lights, const bool _delta);
+
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
+      /// \brief Publish the time spent by the plugins, and update the slow
+      /// callback threshold. Does nothing if called less than a second
+      /// after the previous time.
+      private: void PublishPluginStats();
+
+      /// \brief Publish the queues and latencies of the topics of the
+      /// process. Does nothing if called less than a second after the
+      /// previous time, or if nobody subscribed.
+      private: void PublishTransportStats();
+
       /// \brief Thread function for logging state data.
       private: void LogWorker();
 
@@ -654,12 +1108,6 @@ namespace gazebo
       /// \internal
       /// \brief Private data pointer.
       private: std::unique_ptr<WorldPrivate> dataPtr;
-
-      /// Friend DARTLink so that it has access to dataPtr->dirtyPoses
-      private: friend class DARTLink;
-
-      /// Friend SimbodyPhysics so that it has access to dataPtr->dirtyPoses
-      private: friend class SimbodyPhysics;
     };
     /// \}
   }
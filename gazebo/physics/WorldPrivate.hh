@@ -17,8 +17,10 @@
 #ifndef GAZEBO_PHYSICS_WORLDPRIVATE_HH_
 #define GAZEBO_PHYSICS_WORLDPRIVATE_HH_
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
+#include <future>
 #include <vector>
 #include <list>
 #include <memory>
@@ -27,30 +29,215 @@
 #include <string>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <condition_variable>
 
 #include <ignition/transport.hh>
 
 #include "gazebo/common/Event.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Timestamp.hh"
 #include "gazebo/common/URI.hh"
 
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/physics/ActivityZoneManager.hh"
+#include "gazebo/physics/BatteryRegistry.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
+#include "gazebo/physics/LinkDataRegistry.hh"
+#include "gazebo/physics/LinkStateCache.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/ModelSpatialIndex.hh"
+#include "gazebo/physics/RayQuery.hh"
+#include "gazebo/physics/UpdateScheduler.hh"
+#include "gazebo/physics/World.hh"
 #include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
 {
   namespace physics
   {
+    /// \brief Models queued by World::InsertModelInstances.
+    class ModelInstances
+    {
+      /// \brief SDF string with the models.
+      public: std::string sdf;
+
+      /// \brief Pose of each clone, or empty to insert the models as is.
+      public: std::vector<ignition::math::Pose3d> poses;
+
+      /// \brief Name of each model.
+      public: std::vector<std::string> names;
+    };
+
+    /// \brief Contiguous buffer of entities whose pose was changed by the
+    /// physics engine during a step.
+    ///
+    /// Physics engines call Push from any thread without taking a lock:
+    /// a slot is claimed with an atomic counter in a pre-sized array. If the
+    /// array is full, the entity goes to a mutex protected overflow list and
+    /// the array is grown on the next Drain, so the slow path is only taken
+    /// for one step after the number of moving entities increases.
+    ///
+    /// Drain, RemoveIf and Reserve must not run concurrently with Push.
+    /// World calls them while holding the physics update mutex.
+    class DirtyPoseBuffer
+    {
+      /// \brief Make room for at least _size entities.
+      /// \param[in] _size Number of slots in the lock free array.
+      public: void Reserve(const size_t _size)
+      {
+        if (_size > this->entities.size())
+          this->entities.resize(_size, nullptr);
+      }
+
+      /// \brief Mark an entity as dirty. Safe to call from multiple threads.
+      /// \param[in] _entity Entity that has moved.
+      public: void Push(Entity *_entity)
+      {
+        const size_t index =
+          this->count.fetch_add(1, std::memory_order_relaxed);
+        if (index < this->entities.size())
+        {
+          this->entities[index] = _entity;
+        }
+        else
+        {
+          std::lock_guard<std::mutex> lock(this->overflowMutex);
+          this->overflow.push_back(_entity);
+        }
+      }
+
+      /// \brief Call a function on every dirty entity, then clear the buffer.
+      /// \param[in] _func Function to call for each entity.
+      public: template<typename F>
+              void Drain(F _func)
+      {
+        const size_t total = this->count.load(std::memory_order_relaxed);
+        const size_t inArray = std::min(total, this->entities.size());
+        for (size_t i = 0; i < inArray; ++i)
+          _func(this->entities[i]);
+
+        for (auto &entity : this->overflow)
+          _func(entity);
+
+        if (!this->overflow.empty())
+        {
+          this->overflow.clear();
+          this->Reserve(total);
+        }
+        this->count.store(0, std::memory_order_relaxed);
+      }
+
+      /// \brief Remove every entity for which _pred returns true.
+      /// \param[in] _pred Predicate selecting the entities to remove.
+      public: template<typename P>
+              void RemoveIf(P _pred)
+      {
+        const size_t total = this->count.load(std::memory_order_relaxed);
+        const size_t inArray = std::min(total, this->entities.size());
+        auto end = std::remove_if(this->entities.begin(),
+            this->entities.begin() + inArray, _pred);
+        const size_t kept = end - this->entities.begin();
+
+        this->overflow.erase(std::remove_if(this->overflow.begin(),
+              this->overflow.end(), _pred), this->overflow.end());
+
+        this->count.store(kept + this->overflow.size(),
+            std::memory_order_relaxed);
+
+        // Entries from overflow are not in the array anymore, move them
+        // after the kept entries so that Drain sees a consistent layout.
+        if (!this->overflow.empty())
+        {
+          this->Reserve(kept + this->overflow.size());
+          std::copy(this->overflow.begin(), this->overflow.end(),
+              this->entities.begin() + kept);
+          this->overflow.clear();
+        }
+      }
+
+      /// \brief Number of dirty entities.
+      /// \return Number of entities pushed since the last Drain.
+      public: size_t Size() const
+      {
+        return this->count.load(std::memory_order_relaxed);
+      }
+
+      /// \brief Pre-sized storage. Only the first count entries are valid.
+      private: std::vector<Entity *> entities;
+
+      /// \brief Number of entities pushed since the last drain.
+      private: std::atomic<size_t> count{0};
+
+      /// \brief Entities that did not fit in the array.
+      private: std::vector<Entity *> overflow;
+
+      /// \brief Protects overflow.
+      private: std::mutex overflowMutex;
+    };
+
+    /// \brief A response to a request, waiting to be serialized and
+    /// published by the message thread.
+    class PendingResponse
+    {
+      /// \brief Response header, without the serialized data.
+      public: msgs::Response response;
+
+      /// \brief Message to serialize into the response, may be null.
+      public: std::unique_ptr<google::protobuf::Message> payload;
+    };
+
+    /// \brief A factory message waiting for the world thread.
+    class FactoryRequest
+    {
+      /// \brief The factory message.
+      public: msgs::Factory msg;
+
+      /// \brief Root element of the SDF of the message, read by the factory
+      /// thread. Null if the world thread reads the message.
+      public: sdf::ElementPtr sdf;
+    };
+
+    /// \brief Phases of the world update whose average wall time is sent
+    /// with the world statistics.
+    enum WorldPhase
+    {
+      /// \brief World::ProcessMessages.
+      WORLD_PHASE_MESSAGES = 0,
+
+      /// \brief Update of the models.
+      WORLD_PHASE_MODELS,
+
+      /// \brief PhysicsEngine::UpdateCollision.
+      WORLD_PHASE_COLLISION,
+
+      /// \brief PhysicsEngine::UpdatePhysics.
+      WORLD_PHASE_PHYSICS,
+
+      /// \brief Propagation of the dirty poses.
+      WORLD_PHASE_DIRTY_POSES,
+
+      /// \brief ContactManager::PublishContacts.
+      WORLD_PHASE_CONTACTS,
+
+      /// \brief Waiting for the log worker.
+      WORLD_PHASE_LOGGING,
+
+      /// \brief Waiting for the sensors.
+      WORLD_PHASE_SENSORS,
+
+      /// \brief Number of phases.
+      WORLD_PHASE_COUNT
+    };
+
     /// \brief Private data class for World.
     class WorldPrivate
     {
       /// \brief For keeping track of time step throttling.
-      public: common::Time prevStepWallTime;
+      public: common::Timestamp prevStepWallTime;
 
       /// \brief Pointer the physics engine.
       public: PhysicsEnginePtr physicsEngine;
@@ -80,6 +267,14 @@ namespace gazebo
       /// \brief Current simulation time.
       public: common::Time simTime;
 
+      /// \brief Simulation time of the current step in nanoseconds, read
+      /// without locks by World::StepSimTime.
+      public: std::atomic<int64_t> stepSimTime{0};
+
+      /// \brief Monotonic time the current step started in nanoseconds,
+      /// read without locks by World::StepWallTime.
+      public: std::atomic<int64_t> stepWallTime{0};
+
       /// \brief Amount of time simulation has been paused.
       public: common::Time pauseTime;
 
@@ -101,12 +296,31 @@ namespace gazebo
       /// \brief Publisher for world statistics messages.
       public: transport::PublisherPtr statPub;
 
+      /// \brief Publisher for the time spent by plugins.
+      public: transport::PublisherPtr pluginStatsPub;
+
+      /// \brief Wall time of the last plugin stats update.
+      public: common::Time prevPluginStatsTime;
+
+      /// \brief Publisher for the queues and latencies of the topics.
+      public: transport::PublisherPtr transportStatsPub;
+
+      /// \brief Wall time of the last transport stats update.
+      public: common::Time prevTransportStatsTime;
+
+      /// \brief Fraction of the step budget above which a plugin event
+      /// callback logs a warning.
+      public: double slowCallbackFraction = 0.5;
+
       /// \brief Publisher for request response messages.
       public: transport::PublisherPtr responsePub;
 
       /// \brief Publisher for model messages.
       public: transport::PublisherPtr modelPub;
 
+      /// \brief Publisher of models inserted by InsertModelInstances.
+      public: transport::PublisherPtr modelVPub;
+
       /// \brief Publisher for gui messages.
       public: transport::PublisherPtr guiPub;
 
@@ -122,6 +336,9 @@ namespace gazebo
       /// \brief Publisher for local pose messages.
       public: transport::PublisherPtr poseLocalPub;
 
+      /// \brief Publisher for compact pose messages.
+      public: transport::PublisherPtr compactPosePub;
+
       /// \brief Subscriber to world control messages.
       public: transport::SubscriberPtr controlSub;
 
@@ -158,9 +375,78 @@ namespace gazebo
       /// \brief Function pointer to the model update function.
       public: void (World::*modelUpdateFunc)();
 
+      /// \brief Models dispatched to the thread pool by
+      /// World::ModelUpdateTBB. Kept here to avoid reallocating every step.
+      public: Model_V parallelModels;
+
+      /// \brief Entities updated in order on the world thread by
+      /// World::ModelUpdateTBB. Kept here to avoid reallocating every step.
+      public: Base_V serialEntities;
+
+      /// \brief Playing actors whose animations World::ModelUpdateTBB
+      /// evaluates on the thread pool.
+      public: Actor_V animatedActors;
+
       /// \brief Last time a world statistics message was sent.
       public: common::Time prevStatTime;
 
+      /// \brief Wall time spent in each phase since the phase times were
+      /// last averaged.
+      public: common::Timestamp phaseTimes[WORLD_PHASE_COUNT];
+
+      /// \brief Iterations since the phase times were last averaged.
+      public: uint64_t phaseIterations = 0;
+
+      /// \brief Wall time at which the phase times were last averaged.
+      public: common::Timestamp phaseTimesStart;
+
+      /// \brief Average wall time of the phases, sent with the world
+      /// statistics.
+      public: msgs::WorldStatistics::PhaseTimes phaseTimesMsg;
+
+      /// \brief Shortest wall time between the starts of two world
+      /// updates since the step periods were last summarized.
+      public: common::Timestamp stepPeriodMin;
+
+      /// \brief Longest wall time between the starts of two world updates
+      /// since the step periods were last summarized.
+      public: common::Timestamp stepPeriodMax;
+
+      /// \brief Total wall time between the starts of world updates since
+      /// the step periods were last summarized.
+      public: common::Timestamp stepPeriodTotal;
+
+      /// \brief Step periods measured since they were last summarized.
+      public: uint64_t stepPeriodCount = 0;
+
+      /// \brief Histogram of the step periods since they were last
+      /// summarized, by lateness. See STEP_LATENESS_BOUNDS in World.cc.
+      public: std::vector<uint64_t> stepLateness;
+
+      /// \brief Updates that started late since the world started.
+      public: uint64_t stepOverruns = 0;
+
+      /// \brief Summary of the step periods, sent with the world
+      /// statistics.
+      public: msgs::WorldStatistics::StepJitter stepJitterMsg;
+
+      /// \brief True to run the world thread in real-time mode.
+      public: std::atomic<bool> realTime{false};
+
+      /// \brief SCHED_FIFO priority of the world thread in real-time mode.
+      public: int realTimePriority = 80;
+
+      /// \brief CPU the world thread is pinned to in real-time mode, -1 if
+      /// it isn't pinned.
+      public: int realTimeCpu = -1;
+
+      /// \brief True if static models use the compact representation.
+      public: bool compactStaticModels = false;
+
+      /// \brief True to release the SDF the models don't need after their
+      /// plugins load.
+      public: bool sdfMemorySaver = false;
+
       /// \brief Time at which pause started.
       public: common::Time pauseStartTime;
 
@@ -170,6 +456,25 @@ namespace gazebo
       /// \brief Mutex to protect incoming message buffers.
       public: std::recursive_mutex receiveMutex;
 
+      /// \brief True to publish request responses from responseThread.
+      public: std::atomic_bool pipelinedMessages{false};
+
+      /// \brief Thread that serializes and publishes request responses
+      /// while the world thread steps physics.
+      public: std::thread *responseThread = nullptr;
+
+      /// \brief Responses waiting for responseThread.
+      public: std::list<PendingResponse> responseQueue;
+
+      /// \brief Protects responseQueue and stopResponseThread.
+      public: std::mutex responseMutex;
+
+      /// \brief Wakes up responseThread.
+      public: std::condition_variable responseCondition;
+
+      /// \brief True to stop responseThread once responseQueue is empty.
+      public: bool stopResponseThread = false;
+
       /// \brief Mutex to protext loading of models.
       public: std::mutex loadModelMutex;
 
@@ -190,6 +495,22 @@ namespace gazebo
       /// World::SetPaused to assign world::pause
       public: std::recursive_mutex worldUpdateMutex;
 
+      /// \brief Number of iterations requested through World::BatchStep,
+      /// to be run by the world thread.
+      public: unsigned int batchIterations = 0;
+
+      /// \brief Events requested through World::BatchStep.
+      public: unsigned int batchEvents = 0;
+
+      /// \brief True when the requested batch has been run.
+      public: bool batchDone = false;
+
+      /// \brief Iterations per second achieved by the last batch.
+      public: double batchRate = 0.0;
+
+      /// \brief Signaled by the world thread when a batch is done.
+      public: std::condition_variable_any batchCondition;
+
       /// \brief The world's current SDF description.
       public: sdf::ElementPtr sdf;
 
@@ -203,7 +524,30 @@ namespace gazebo
       public: std::list<msgs::Request> requestMsgs;
 
       /// \brief Factory message buffer.
-      public: std::list<msgs::Factory> factoryMsgs;
+      public: std::list<FactoryRequest> factoryMsgs;
+
+      /// \brief Thread that reads the SDF of factory messages, and loads
+      /// the resources they use, before the world thread inserts them.
+      public: std::thread *factoryThread = nullptr;
+
+      /// \brief Factory messages waiting for factoryThread.
+      public: std::list<msgs::Factory> factoryQueue;
+
+      /// \brief Protects factoryThread, factoryQueue and stopFactoryThread.
+      public: mutable std::mutex factoryMutex;
+
+      /// \brief Wakes up factoryThread.
+      public: std::condition_variable factoryCondition;
+
+      /// \brief True to stop factoryThread.
+      public: bool stopFactoryThread = false;
+
+      /// \brief Wall time in seconds that ProcessFactoryMsgs spends
+      /// inserting entities per call, zero or less for no limit.
+      public: std::atomic<double> factoryBudget{0.0};
+
+      /// \brief Models queued by InsertModelInstances.
+      public: std::list<ModelInstances> modelInstances;
 
       /// \brief Model message buffer.
       public: std::list<msgs::Model> modelMsgs;
@@ -244,6 +588,10 @@ namespace gazebo
       /// \brief True to enable the atmosphere model.
       public: bool enableAtmosphere;
 
+      /// \brief Mesh parsing and plugin library loading started by
+      /// World::PrefetchResources, which run while the entities load.
+      public: std::future<void> prefetch;
+
       /// \brief Ray used to test for collisions when placing entities.
       public: RayShapePtr testRay;
 
@@ -251,7 +599,7 @@ namespace gazebo
       public: bool pluginsLoaded;
 
       /// \brief sleep timing error offset due to clock wake up latency
-      public: common::Time sleepOffset;
+      public: common::Timestamp sleepOffset;
 
       /// \brief Last time incoming messages were processed.
       public: common::Time prevProcessMsgsTime;
@@ -268,13 +616,29 @@ namespace gazebo
       /// \brief Buffer of prev states
       public: WorldState prevStates[2];
 
-      /// \brief Previous unfiltered state. Used for determining insertions
-      /// and deletions
-      public: WorldState prevUnfilteredState;
+      /// \brief Names of the models seen by the log worker. Used for
+      /// determining insertions and deletions.
+      public: std::set<std::string> logModelNames;
+
+      /// \brief Names of the lights seen by the log worker. Used for
+      /// determining insertions and deletions.
+      public: std::set<std::string> logLightNames;
+
+      /// \brief Models that match the log filter. Refreshed when models
+      /// are inserted or deleted, or the filter changes.
+      public: Model_V logModels;
+
+      /// \brief Log filter that logModels was resolved with.
+      public: std::string logFilter;
 
       /// \brief Int used to toggle between prevStates
       public: int stateToggle;
 
+      /// \brief State of the logged models and lights, as playback
+      /// rebuilds it from the frames recorded so far. Frames that are not
+      /// keyframes only hold the changes against this state.
+      public: WorldState logRecordedState;
+
       /// \brief State from from log file.
       public: sdf::ElementPtr logPlayStateSDF;
 
@@ -288,6 +652,40 @@ namespace gazebo
       /// \brief The list of models that need to publish their pose.
       public: std::set<ModelPtr> publishModelPoses;
 
+      /// \brief Models that moved since the last ~/pose/info message.
+      public: std::set<ModelPtr> pendingModelPoses;
+
+      /// \brief Lights that moved since the last ~/pose/info message.
+      public: std::set<LightPtr> pendingLightPoses;
+
+      /// \brief Minimum wall time between two ~/pose/info messages. Zero
+      /// means no limit.
+      public: common::Time posePublishPeriod = common::Time(1.0 / 60.0);
+
+      /// \brief Wall time of the last ~/pose/info message.
+      public: common::Time prevPosePublishTime;
+
+      /// \brief An entity is only added to ~/pose/info if its position
+      /// changed by more than this distance [m] since it was last published.
+      public: double poseLinearThreshold = 0.0;
+
+      /// \brief An entity is only added to ~/pose/info if its orientation
+      /// changed by more than this angle [rad] since it was last published.
+      public: double poseAngularThreshold = 0.0;
+
+      /// \brief Size of a position step on ~/pose/compact/info, in meters.
+      public: double compactPosePrecision = 1e-4;
+
+      /// \brief Last relative pose published on ~/pose/info, by entity id.
+      public: std::unordered_map<uint32_t, ignition::math::Pose3d>
+              publishedPoses;
+
+      /// \brief Reused ~/pose/local/info message, filled when there is no
+      /// subscriber to borrow a message from the publisher for, to avoid
+      /// reallocating the pose entries every time.
+      public: boost::shared_ptr<msgs::PosesStamped> poseLocalMsg{
+                new msgs::PosesStamped};
+
       /// \brief The list of models that need to publish their scale.
       public: std::set<ModelPtr> publishModelScales;
 
@@ -300,6 +698,9 @@ namespace gazebo
       /// \brief The number of simulation iterations.
       public: uint64_t iterations;
 
+      /// \brief Scratch buffer used when saving and restoring snapshots.
+      public: std::vector<double> snapshotState;
+
       /// \brief The number of simulation iterations to take before stopping.
       public: uint64_t stopIterations;
 
@@ -339,9 +740,54 @@ namespace gazebo
       public: std::mutex factoryDeleteMutex;
 
       /// \brief when physics engine makes an update and changes a link pose,
-      /// this flag is set to trigger Entity::SetWorldPose on the
+      /// the entity is added here to trigger Entity::SetWorldPose on the
       /// physics::Link in World::Update.
-      public: std::list<Entity*> dirtyPoses;
+      public: DirtyPoseBuffer dirtyPoses;
+
+      /// \brief Contiguous cache of link states, refreshed every update
+      /// when linkStateCacheEnabled is true.
+      public: LinkStateCache linkStateCache;
+
+      /// \brief True to refresh linkStateCache every update.
+      public: bool linkStateCacheEnabled = false;
+
+      /// \brief True if no pose was set since linkStateCache was refreshed,
+      /// so that the poses to publish can be read from it.
+      public: std::atomic_bool linkStateCacheFresh{false};
+
+      /// \brief Batched ray query shared by the multi-ray shapes.
+      public: RayQuery rayQuery;
+
+      /// \brief True to take a snapshot of rayQuery every step.
+      public: std::atomic<bool> rayQuerySnapshotEnabled{false};
+
+      /// \brief Latest snapshot of rayQuery.
+      public: std::shared_ptr<const RayQuery> rayQuerySnapshot;
+
+      /// \brief Protects rayQuerySnapshot.
+      public: mutable std::mutex rayQuerySnapshotMutex;
+
+      /// \brief Tile based freezing of the models far from activity zones.
+      public: ActivityZoneManager activityZones;
+
+      /// \brief Bounding volume hierarchy over the models, for sensors.
+      public: ModelSpatialIndex modelIndex;
+
+      /// \brief Models whose plugins wait for the model to become active.
+      public: Model_V deferredPluginModels;
+
+      /// \brief Callbacks run at a lower rate than the physics.
+      public: UpdateScheduler scheduler;
+
+      /// \brief Batteries of the links, updated in a single pass.
+      public: BatteryRegistry batteries;
+
+      /// \brief Data of the links requested by sensors, sampled in a
+      /// single pass.
+      public: LinkDataRegistry linkData;
+
+      /// \brief Freeze requests of the links, by reason.
+      public: FreezeRegistry freezes;
 
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
@@ -356,6 +802,9 @@ namespace gazebo
       /// \brief Simulation time of the last log state captured.
       public: gazebo::common::Time logLastStateTime;
 
+      /// \brief Simulation time of the last full log state captured.
+      public: gazebo::common::Time logLastKeyframeTime;
+
       /// \brief Simulation time of the last log state played.
       public: gazebo::common::Time logLastStatePlayedSimTime;
 
@@ -365,6 +814,9 @@ namespace gazebo
       /// \brief Log play real time factor
       public: double logPlayRealTimeFactor;
 
+      /// \brief How much of the world update runs during log playback.
+      public: World::LogPlayMode logPlayMode = World::LOG_PLAY_FULL;
+
       /// \brief URI of this world.
       public: common::URI uri;
 
@@ -385,6 +837,25 @@ namespace gazebo
 
       /// \brief SDF World DOM object
       public: std::unique_ptr<sdf::World> worldSDFDom;
+
+      /// \brief World description of the last checkpoint, without a state.
+      public: std::string checkpointDescription;
+
+      /// \brief Names of the models in checkpointDescription.
+      public: std::vector<std::string> checkpointModels;
+
+      /// \brief Thread writing the last checkpoint.
+      public: std::thread checkpointThread;
+
+      /// \brief File to save periodic checkpoints into.
+      public: std::string checkpointFilename;
+
+      /// \brief Simulation time between periodic checkpoints, zero or less
+      /// when disabled.
+      public: double checkpointPeriod = 0;
+
+      /// \brief Simulation time of the last periodic checkpoint.
+      public: common::Time checkpointLastTime;
     };
   }
 }
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gazebo/physics/WorldPrivate.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class DirtyPoseBufferTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Get a fake entity pointer, which the buffer never dereferences.
+/// \param[in] _index Index of the entity.
+/// \return A distinct pointer for each index.
+physics::Entity *fakeEntity(const size_t _index)
+{
+  static std::vector<char> storage(100000);
+  return reinterpret_cast<physics::Entity *>(&storage[_index]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(DirtyPoseBufferTest, Drain)
+{
+  physics::DirtyPoseBuffer buffer;
+  buffer.Reserve(2);
+
+  // The last entity goes to the overflow list
+  for (size_t i = 0; i < 3; ++i)
+    buffer.Push(fakeEntity(i));
+  EXPECT_EQ(3u, buffer.Size());
+
+  std::vector<physics::Entity *> drained;
+  buffer.Drain([&drained](physics::Entity *_entity)
+      {
+        drained.push_back(_entity);
+      });
+  EXPECT_EQ(0u, buffer.Size());
+  ASSERT_EQ(3u, drained.size());
+  for (size_t i = 0; i < 3; ++i)
+    EXPECT_EQ(fakeEntity(i), drained[i]);
+
+  // Nothing left to drain
+  drained.clear();
+  buffer.Drain([&drained](physics::Entity *_entity)
+      {
+        drained.push_back(_entity);
+      });
+  EXPECT_TRUE(drained.empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(DirtyPoseBufferTest, ConcurrentPush)
+{
+  const size_t threadCount = 8;
+  const size_t perThread = 10000;
+
+  physics::DirtyPoseBuffer buffer;
+  buffer.Reserve(100);
+
+  // Run twice: the first drain grows the array to fit every entity
+  for (int run = 0; run < 2; ++run)
+  {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t)
+    {
+      threads.emplace_back([&buffer, t, perThread]()
+          {
+            for (size_t i = 0; i < perThread; ++i)
+              buffer.Push(fakeEntity(t * perThread + i));
+          });
+    }
+    for (auto &thread : threads)
+      thread.join();
+
+    EXPECT_EQ(threadCount * perThread, buffer.Size());
+
+    std::set<physics::Entity *> drained;
+    buffer.Drain([&drained](physics::Entity *_entity)
+        {
+          EXPECT_TRUE(drained.insert(_entity).second);
+        });
+    EXPECT_EQ(threadCount * perThread, drained.size());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(DirtyPoseBufferTest, RemoveIf)
+{
+  physics::DirtyPoseBuffer buffer;
+  buffer.Reserve(4);
+
+  // Entities in the array and in the overflow list
+  for (size_t i = 0; i < 8; ++i)
+    buffer.Push(fakeEntity(i));
+
+  // Remove the even entities
+  const std::set<physics::Entity *> removed = {fakeEntity(0),
+      fakeEntity(2), fakeEntity(4), fakeEntity(6)};
+  buffer.RemoveIf([&removed](physics::Entity *_entity)
+      {
+        return removed.count(_entity) > 0;
+      });
+  EXPECT_EQ(4u, buffer.Size());
+
+  std::vector<physics::Entity *> drained;
+  buffer.Drain([&drained](physics::Entity *_entity)
+      {
+        drained.push_back(_entity);
+      });
+  EXPECT_EQ(std::vector<physics::Entity *>({fakeEntity(1), fakeEntity(3),
+        fakeEntity(5), fakeEntity(7)}), drained);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
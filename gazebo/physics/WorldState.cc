@@ -90,18 +90,15 @@ void WorldState::LoadWithFilter(const WorldPtr _world,
 /////////////////////////////////////////////////
 void WorldState::Load(const WorldPtr _world)
 {
-  this->world = _world;
-  this->name = _world->Name();
-  this->wallTime = common::Time::GetWallTime();
-  this->simTime = _world->SimTime();
-  this->realTime = _world->RealTime();
-  this->iterations = _world->Iterations();
-  this->insertions.clear();
-  this->deletions.clear();
+  this->Load(_world, FilterModels(_world, worldStateFilter));
+}
 
-  std::string filter = worldStateFilter;
+/////////////////////////////////////////////////
+Model_V WorldState::FilterModels(const WorldPtr _world,
+    const std::string &_filter)
+{
   std::list<std::string> mainParts, parts;
-  boost::split(mainParts, filter, boost::is_any_of("/"));
+  boost::split(mainParts, _filter, boost::is_any_of("/"));
 
   // Create the model filter
   if (!mainParts.empty())
@@ -112,28 +109,43 @@ void WorldState::Load(const WorldPtr _world)
   }
   std::list<std::string>::iterator partIter = parts.begin();
 
-  // Add a state for all the models that match the filter
   Model_V models = _world->Models();
-  for (Model_V::const_iterator iter = models.begin();
-       iter != models.end(); ++iter)
+
+  // The first element in the filter must be a model name or a star.
+  if (partIter == parts.end() || (*partIter).empty() || (*partIter) == "*")
+    return models;
+
+  std::string regexStr = *partIter;
+  boost::replace_all(regexStr, "*", ".*");
+  boost::regex regex(regexStr);
+
+  Model_V result;
+  for (auto const &model : models)
   {
-    bool add = true;
+    if (boost::regex_match(model->GetName(), regex))
+      result.push_back(model);
+  }
 
-    // The first element in the filter must be a model name or a star.
-    if (partIter != parts.end() && !parts.empty() &&
-        !(*partIter).empty() && (*partIter) != "*")
-    {
-      std::string regexStr = *partIter;
-      boost::replace_all(regexStr, "*", ".*");
-      boost::regex regex(regexStr);
-      add = boost::regex_match((*iter)->GetName(), regex);
-    }
+  return result;
+}
 
-    if (add)
-    {
-      this->modelStates[(*iter)->GetName()].Load(*iter, this->realTime,
-          this->simTime, this->iterations);
-    }
+/////////////////////////////////////////////////
+void WorldState::Load(const WorldPtr _world, const Model_V &_models)
+{
+  this->world = _world;
+  this->name = _world->Name();
+  this->wallTime = common::Time::GetWallTime();
+  this->simTime = _world->SimTime();
+  this->realTime = _world->RealTime();
+  this->iterations = _world->Iterations();
+  this->insertions.clear();
+  this->deletions.clear();
+
+  // Add a state for all the given models
+  for (auto const &model : _models)
+  {
+    this->modelStates[model->GetName()].Load(model, this->realTime,
+        this->simTime, this->iterations);
   }
 
   // Remove models that no longer exist. We determine this by check the time
@@ -576,6 +588,67 @@ WorldState WorldState::operator+(const WorldState &_state) const
   return result;
 }
 
+/////////////////////////////////////////////////
+WorldState WorldState::Changes(const WorldState &_state,
+    const double _tolerance) const
+{
+  WorldState result;
+
+  result.name = this->name;
+  result.simTime = this->simTime;
+  result.realTime = this->realTime;
+  result.wallTime = this->wallTime;
+  result.iterations = this->iterations;
+  result.insertions = this->insertions;
+  result.deletions = this->deletions;
+
+  for (auto const &model : this->modelStates)
+  {
+    auto iter = _state.modelStates.find(model.first);
+    if (iter == _state.modelStates.end() ||
+        !(model.second - iter->second).IsZero(_tolerance))
+    {
+      result.modelStates.insert(model);
+    }
+  }
+
+  for (auto const &light : this->lightStates)
+  {
+    auto iter = _state.lightStates.find(light.first);
+    if (iter == _state.lightStates.end() ||
+        !(light.second - iter->second).IsZero(_tolerance))
+    {
+      result.lightStates.insert(light);
+    }
+  }
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+void WorldState::Merge(const WorldState &_state)
+{
+  this->name = _state.name;
+  this->simTime = _state.simTime;
+  this->realTime = _state.realTime;
+  this->wallTime = _state.wallTime;
+  this->iterations = _state.iterations;
+  this->insertions.clear();
+  this->deletions.clear();
+
+  for (auto const &model : _state.modelStates)
+    this->modelStates[model.first] = model.second;
+
+  for (auto const &light : _state.lightStates)
+    this->lightStates[light.first] = light.second;
+
+  for (auto const &deletion : _state.deletions)
+  {
+    this->modelStates.erase(deletion);
+    this->lightStates.erase(deletion);
+  }
+}
+
 /////////////////////////////////////////////////
 void WorldState::FillSDF(sdf::ElementPtr _sdf)
 {
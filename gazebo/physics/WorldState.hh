@@ -78,6 +78,22 @@ namespace gazebo
       public: void LoadWithFilter(const WorldPtr _world,
           const std::string &_filter);
 
+      /// \brief Load the state of a set of models from a World pointer.
+      ///
+      /// Only the given models are captured, so a filter can be resolved
+      /// once with FilterModels instead of on every load.
+      /// \param[in] _world Pointer to a world
+      /// \param[in] _models Models to capture.
+      public: void Load(const WorldPtr _world, const Model_V &_models);
+
+      /// \brief Get the models of a world that match a filter.
+      /// \param[in] _world Pointer to a world
+      /// \param[in] _filter String for filtering models states, as used by
+      /// LoadWithFilter. An empty filter matches every model.
+      /// \return The models that match the filter.
+      public: static Model_V FilterModels(const WorldPtr _world,
+          const std::string &_filter);
+
       /// \brief Load state from SDF element.
       ///
       /// Set a WorldState from an SDF element containing WorldState info.
@@ -167,6 +183,28 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Get the models and lights that changed since another
+      /// state. Unlike the subtraction operator, the changed models and
+      /// lights keep their full state, so the result can be applied on top
+      /// of the other state.
+      /// \param[in] _state An earlier state.
+      /// \param[in] _tolerance Changes in position (meters), rotation
+      /// (radians) and scale up to this value are ignored.
+      /// \return State with the name, times, insertions and deletions of
+      /// this state, and the states of the models and lights that changed
+      /// or are missing in _state.
+      /// \sa Merge
+      public: WorldState Changes(const WorldState &_state,
+                                 const double _tolerance) const;
+
+      /// \brief Apply a later state on top of this one. Model and light
+      /// states of _state replace the ones in this state, and deleted
+      /// entities are removed. The name and times are taken from _state.
+      /// Insertions are not kept.
+      /// \param[in] _state The later state.
+      /// \sa Changes
+      public: void Merge(const WorldState &_state);
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
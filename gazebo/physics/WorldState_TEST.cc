@@ -113,6 +113,31 @@ TEST_F(WorldStateTest, WorldConstructor)
       ignition::math::Pose3d(0, 0, 10, 0, 0, 0));
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldStateTest, FilterModels)
+{
+  // Load a world
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+
+  EXPECT_EQ(1u, physics::WorldState::FilterModels(world, "").size());
+  EXPECT_EQ(1u, physics::WorldState::FilterModels(world, "*").size());
+  EXPECT_EQ(1u, physics::WorldState::FilterModels(world, "ground*").size());
+  EXPECT_EQ(1u,
+      physics::WorldState::FilterModels(world, "ground_plane.pose").size());
+  EXPECT_TRUE(physics::WorldState::FilterModels(world, "box").empty());
+
+  // Only the given models are captured
+  physics::WorldState worldState;
+  worldState.Load(world, physics::Model_V());
+  EXPECT_EQ(0u, worldState.GetModelStateCount());
+  EXPECT_EQ(1u, worldState.LightStateCount());
+
+  worldState.Load(world, physics::WorldState::FilterModels(world, "ground*"));
+  EXPECT_EQ(1u, worldState.GetModelStateCount());
+  EXPECT_TRUE(worldState.HasModelState("ground_plane"));
+}
+
 //////////////////////////////////////////////////
 TEST_F(WorldStateTest, FillSDF)
 {
@@ -261,6 +286,91 @@ TEST_F(WorldStateTest, OperatorsNoInsertionsDeletions)
   EXPECT_TRUE((worldState0 - worldState1).IsZero());
 }
 
+//////////////////////////////////////////////////
+/// \brief Create a world state from SDF.
+/// \param[in] _boxX X position of the box model.
+/// \param[in] _sunZ Z position of the sun light.
+/// \return The world state.
+physics::WorldState stateFromSDF(const double _boxX, const double _sunZ)
+{
+  std::ostringstream sdfStr;
+  sdfStr << "<sdf version ='" << SDF_VERSION << "'>"
+    << "<world name='default'>"
+    << "<state world_name='default'>"
+    << "<model name='ground_plane'>"
+    << "  <pose>0 0 0 0 0 0</pose>"
+    << "</model>"
+    << "<model name='box'>"
+    << "  <pose>" << _boxX << " 0 0.5 0 0 0</pose>"
+    << "  <link name='link'>"
+    << "    <pose>" << _boxX << " 0 0.5 0 0 0</pose>"
+    << "  </link>"
+    << "</model>"
+    << "<light name='sun'>"
+    << "  <pose>0 0 " << _sunZ << " 0 0 0</pose>"
+    << "</light>"
+    << "</state>"
+    << "</world>"
+    << "</sdf>";
+
+  sdf::SDFPtr worldSDF(new sdf::SDF);
+  worldSDF->SetFromString(sdfStr.str());
+
+  return physics::WorldState(
+      worldSDF->Root()->GetElement("world")->GetElement("state"));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldStateTest, ChangesMerge)
+{
+  physics::WorldState state0 = stateFromSDF(1.0, 10.0);
+
+  // Nothing changed
+  physics::WorldState changes = state0.Changes(state0, 1e-6);
+  EXPECT_EQ(0u, changes.GetModelStateCount());
+  EXPECT_EQ(0u, changes.LightStateCount());
+
+  // Only the box moved, and it keeps its full state
+  physics::WorldState state1 = stateFromSDF(2.0, 10.0);
+  changes = state1.Changes(state0, 1e-6);
+  EXPECT_EQ(1u, changes.GetModelStateCount());
+  EXPECT_EQ(0u, changes.LightStateCount());
+  ASSERT_TRUE(changes.HasModelState("box"));
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0.5, 0, 0, 0),
+      changes.GetModelState("box").Pose());
+
+  // Changes within the tolerance are left out
+  physics::WorldState state2 = stateFromSDF(1.001, 10.5);
+  changes = state2.Changes(state0, 0.01);
+  EXPECT_EQ(0u, changes.GetModelStateCount());
+  EXPECT_EQ(1u, changes.LightStateCount());
+  EXPECT_TRUE(changes.HasLightState("sun"));
+
+  // Everything is new against an empty state
+  changes = state0.Changes(physics::WorldState(), 1e-6);
+  EXPECT_EQ(2u, changes.GetModelStateCount());
+  EXPECT_EQ(1u, changes.LightStateCount());
+
+  // Merging the changes on the earlier state rebuilds the later one
+  changes = state1.Changes(state0, 1e-6);
+  physics::WorldState merged = state0;
+  merged.Merge(changes);
+  EXPECT_EQ(2u, merged.GetModelStateCount());
+  EXPECT_EQ(1u, merged.LightStateCount());
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0.5, 0, 0, 0),
+      merged.GetModelState("box").Pose());
+  EXPECT_EQ(ignition::math::Pose3d::Zero,
+      merged.GetModelState("ground_plane").Pose());
+  EXPECT_TRUE(merged.Changes(state1, 1e-6).IsZero());
+
+  // Deleted entities are removed
+  std::vector<std::string> deletions = {"box"};
+  changes.SetDeletions(deletions);
+  merged.Merge(changes);
+  EXPECT_FALSE(merged.HasModelState("box"));
+  EXPECT_TRUE(merged.HasModelState("ground_plane"));
+}
+
 //////////////////////////////////////////////////
 TEST_F(WorldStateTest, InsertionOfMeshModel)
 {
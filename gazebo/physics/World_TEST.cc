@@ -15,8 +15,18 @@
  *
 */
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/PluginProfiler.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/transport/TransportIface.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "test/util.hh"
 
@@ -216,6 +226,430 @@ TEST_F(WorldTest, Stop)
   EXPECT_TRUE(world->Running());
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldTest, ParallelModelUpdate)
+{
+  // Load a world with a few dynamic models
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // Serial updates by default
+  EXPECT_FALSE(world->ParallelModelUpdate());
+
+  world->SetParallelModelUpdate(true);
+  EXPECT_TRUE(world->ParallelModelUpdate());
+
+  auto box = world->ModelByName("box");
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_NE(nullptr, box);
+  ASSERT_NE(nullptr, sphere);
+  EXPECT_FALSE(box->ThreadSafeUpdate());
+
+  // Mix of thread safe and unsafe models
+  box->SetThreadSafeUpdate(true);
+  EXPECT_TRUE(box->ThreadSafeUpdate());
+
+  auto iterations = world->Iterations();
+  world->Step(100);
+  EXPECT_EQ(iterations + 100u, world->Iterations());
+
+  world->SetParallelModelUpdate(false);
+  EXPECT_FALSE(world->ParallelModelUpdate());
+  world->Step(10);
+  EXPECT_EQ(iterations + 110u, world->Iterations());
+}
+
+/// \brief Number of messages received on ~/pose/info.
+std::atomic<int> g_poseInfoCount(0);
+
+//////////////////////////////////////////////////
+void OnPoseInfo(ConstPosesStampedPtr &/*_msg*/)
+{
+  ++g_poseInfoCount;
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, PosePublishRate)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // Default rate for clients
+  EXPECT_NEAR(60.0, world->PosePublishRate(), 1e-6);
+
+  world->SetPosePublishRate(0.0);
+  EXPECT_DOUBLE_EQ(0.0, world->PosePublishRate());
+
+  world->SetPosePublishRate(5.0);
+  EXPECT_NEAR(5.0, world->PosePublishRate(), 1e-6);
+
+  g_poseInfoCount = 0;
+  auto sub = this->node->Subscribe("~/pose/info", &OnPoseInfo);
+
+  // Keep the box moving so poses are published every step
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 100, 0, 0, 0));
+
+  world->SetPaused(false);
+  common::Time::Sleep(common::Time(1.0));
+  world->SetPaused(true);
+
+  // Allow some slack for timing
+  EXPECT_GT(g_poseInfoCount, 0);
+  EXPECT_LE(g_poseInfoCount, 8);
+}
+
+/// \brief Last message received on ~/pose/compact/info.
+msgs::PosesCompact g_compactPoses;
+
+/// \brief Protects g_compactPoses.
+std::mutex g_compactPosesMutex;
+
+//////////////////////////////////////////////////
+void OnCompactPoses(ConstPosesCompactPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_compactPosesMutex);
+  g_compactPoses.CopyFrom(*_msg);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, CompactPoses)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_NEAR(1e-4, world->CompactPosePrecision(), 1e-12);
+  world->SetCompactPosePrecision(1e-3);
+  EXPECT_NEAR(1e-3, world->CompactPosePrecision(), 1e-12);
+  world->SetCompactPosePrecision(0);
+  EXPECT_NEAR(1e-3, world->CompactPosePrecision(), 1e-12);
+
+  // Only subscribe to the compact poses
+  auto sub = this->node->Subscribe("~/pose/compact/info", &OnCompactPoses);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(1, 2, 100, 0, 0, 0.5));
+
+  world->SetPaused(false);
+  common::Time::Sleep(common::Time(0.5));
+  world->SetPaused(true);
+  common::Time::Sleep(common::Time(0.1));
+
+  std::lock_guard<std::mutex> lock(g_compactPosesMutex);
+  EXPECT_NEAR(1e-3, g_compactPoses.position_precision(), 1e-12);
+  bool found = false;
+  for (int i = 0; i < g_compactPoses.id_size(); ++i)
+  {
+    if (g_compactPoses.id(i) != box->GetId())
+      continue;
+    found = true;
+    const auto pose = msgs::CompactPose(g_compactPoses, i);
+    EXPECT_NEAR(box->WorldPose().Pos().X(), pose.Pos().X(), 1e-3);
+    EXPECT_NEAR(box->WorldPose().Pos().Y(), pose.Pos().Y(), 1e-3);
+    EXPECT_NEAR(box->WorldPose().Rot().Yaw(), pose.Rot().Yaw(), 1e-4);
+  }
+  EXPECT_TRUE(found);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, PipelinedMessages)
+{
+  this->Load("worlds/shapes.world", false);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_FALSE(world->PipelinedMessages());
+  world->SetPipelinedMessages(true);
+  EXPECT_TRUE(world->PipelinedMessages());
+
+  // Responses are still delivered while the world is running
+  for (int i = 0; i < 3; ++i)
+  {
+    auto response = transport::request("default", "scene_info");
+    ASSERT_NE(nullptr, response);
+    EXPECT_EQ("success", response->response());
+
+    msgs::Scene sceneMsg;
+    EXPECT_TRUE(sceneMsg.ParseFromString(response->serialized_data()));
+    EXPECT_EQ(world->ModelCount(),
+        static_cast<unsigned int>(sceneMsg.model_size()));
+
+    auto info = transport::request("default", "entity_info", "box");
+    ASSERT_NE(nullptr, info);
+    EXPECT_EQ("success", info->response());
+    msgs::Model modelMsg;
+    EXPECT_TRUE(modelMsg.ParseFromString(info->serialized_data()));
+    EXPECT_EQ("box", modelMsg.name());
+  }
+
+  world->SetPipelinedMessages(false);
+  EXPECT_FALSE(world->PipelinedMessages());
+
+  auto response = transport::request("default", "entity_info", "sphere");
+  ASSERT_NE(nullptr, response);
+  EXPECT_EQ("success", response->response());
+}
+
+/// \brief Number of models received on ~/model/info_v.
+std::atomic<int> g_modelInfoVCount(0);
+
+//////////////////////////////////////////////////
+void OnModelInfoV(ConstModel_VPtr &_msg)
+{
+  g_modelInfoVCount += _msg->models_size();
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, InsertModelInstances)
+{
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  g_modelInfoVCount = 0;
+  auto sub = this->node->Subscribe("~/model/info_v", &OnModelInfoV);
+
+  const std::string boxSdf = "<sdf version='" + std::string(SDF_VERSION) +
+    "'><model name='box'><link name='link'/></model></sdf>";
+
+  // Clone one model per pose
+  std::vector<ignition::math::Pose3d> poses;
+  for (int i = 0; i < 3; ++i)
+    poses.push_back(ignition::math::Pose3d(i, 2 * i, 0, 0, 0, 0));
+  world->InsertModelInstances(boxSdf, poses);
+
+  int sleep = 0;
+  while (sleep < 20 && world->ModelCount() < 3u)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_EQ(3u, world->ModelCount());
+  for (int i = 0; i < 3; ++i)
+  {
+    auto model = world->ModelByName("box_" + std::to_string(i));
+    ASSERT_NE(nullptr, model);
+    EXPECT_EQ(poses[i], model->WorldPose());
+  }
+
+  // Every model of the string, with a name that is already taken
+  const std::string modelsSdf = "<sdf version='" +
+    std::string(SDF_VERSION) + "'>"
+    "<model name='a'><link name='link'/></model>"
+    "<model name='b'><link name='link'/></model></sdf>";
+  world->InsertModelInstances(modelsSdf, {}, {"box_0"});
+
+  sleep = 0;
+  while (sleep < 20 && world->ModelCount() < 5u)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_EQ(5u, world->ModelCount());
+  EXPECT_NE(nullptr, world->ModelByName("box_0_0"));
+  EXPECT_NE(nullptr, world->ModelByName("b"));
+  EXPECT_EQ(nullptr, world->ModelByName("a"));
+
+  sleep = 0;
+  while (sleep < 20 && g_modelInfoVCount < 5)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_EQ(5, g_modelInfoVCount);
+}
+
+/// \brief Number of messages received on ~/plugins/stats.
+std::atomic<int> g_pluginStatsCount(0);
+
+//////////////////////////////////////////////////
+void OnPluginStats(ConstPluginStatsPtr &/*_msg*/)
+{
+  ++g_pluginStatsCount;
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, PluginStats)
+{
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_DOUBLE_EQ(0.5, world->SlowCallbackFraction());
+  world->SetSlowCallbackFraction(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, world->SlowCallbackFraction());
+  world->SetSlowCallbackFraction(2.0);
+  EXPECT_DOUBLE_EQ(2.0, world->SlowCallbackFraction());
+
+  g_pluginStatsCount = 0;
+  auto sub = this->node->Subscribe("~/plugins/stats", &OnPluginStats);
+
+  int sleep = 0;
+  while (sleep < 30 && g_pluginStatsCount == 0)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_GT(g_pluginStatsCount, 0);
+
+  // Twice the step budget, with the default real time factor of 1
+  EXPECT_NEAR(2.0 * world->Physics()->GetMaxStepSize(),
+      common::PluginProfiler::WarningThreshold(), 1e-9);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, BatchStep)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  int updateBegin = 0;
+  int updateEnd = 0;
+  auto beginConnection = event::Events::ConnectWorldUpdateBegin(
+      [&updateBegin](const common::UpdateInfo &)
+      {
+        ++updateBegin;
+      });
+  auto endConnection = event::Events::ConnectWorldUpdateEnd(
+      [&updateEnd]()
+      {
+        ++updateEnd;
+      });
+
+  const auto iterations = world->Iterations();
+  const auto simTime = world->SimTime();
+  const double dt = world->Physics()->GetMaxStepSize();
+
+  // No events by default
+  double rate = world->BatchStep(500);
+  EXPECT_GT(rate, 0.0);
+  EXPECT_EQ(iterations + 500u, world->Iterations());
+  EXPECT_NEAR((simTime + 500 * dt).Double(), world->SimTime().Double(), 1e-6);
+  EXPECT_EQ(world->SimTime(), world->StepSimTime());
+  EXPECT_GT(common::Timestamp::Now(), world->StepWallTime());
+  EXPECT_EQ(0, updateBegin);
+  EXPECT_EQ(0, updateEnd);
+
+  // Selected events fire once per batch
+  rate = world->BatchStep(100, physics::World::BATCH_WORLD_UPDATE_END);
+  EXPECT_GT(rate, 0.0);
+  EXPECT_EQ(iterations + 600u, world->Iterations());
+  EXPECT_EQ(0, updateBegin);
+  EXPECT_EQ(1, updateEnd);
+
+  // The world is still paused
+  EXPECT_TRUE(world->IsPaused());
+  EXPECT_DOUBLE_EQ(0.0, world->BatchStep(0));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Snapshot)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  // Lift the box so that it falls while stepping
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 5, 0, 0, 0));
+  world->Step(10);
+
+  const auto pose = box->WorldPose();
+  const auto iterations = world->Iterations();
+  const auto simTime = world->SimTime();
+
+  std::string snapshot;
+  world->SaveSnapshot(snapshot);
+  EXPECT_FALSE(snapshot.empty());
+
+  world->Step(100);
+  const auto steppedPose = box->WorldPose();
+  EXPECT_LT(steppedPose.Pos().Z(), pose.Pos().Z());
+
+  // Restore puts the box and time back, without stepping
+  EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+  EXPECT_EQ(pose, box->WorldPose());
+  EXPECT_EQ(iterations, world->Iterations());
+  EXPECT_EQ(simTime, world->SimTime());
+
+  // Stepping again from the snapshot gives the same result
+  world->Step(100);
+  EXPECT_EQ(steppedPose, box->WorldPose());
+
+  // Garbage is rejected
+  EXPECT_FALSE(world->RestoreSnapshot("not a snapshot"));
+
+  // So are snapshots of bodies that were removed since
+  world->RemoveModel("sphere");
+  ASSERT_EQ(nullptr, world->ModelByName("sphere"));
+  const auto currentPose = box->WorldPose();
+  EXPECT_FALSE(world->RestoreSnapshot(snapshot));
+  EXPECT_EQ(currentPose, box->WorldPose());
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Checkpoint)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  const std::string filename =
+    (boost::filesystem::temp_directory_path() /
+     boost::filesystem::unique_path("gz_checkpoint_%%%%.world")).string();
+
+  for (const double z : {5.0, 3.0})
+  {
+    box->SetWorldPose(ignition::math::Pose3d(0, 0, z, 0, 0, 0));
+    world->SaveCheckpoint(filename);
+    world->WaitForCheckpoint();
+
+    // The checkpoint is a world file with the current state
+    sdf::SDFPtr sdf(new sdf::SDF());
+    ASSERT_TRUE(sdf::init(sdf));
+    ASSERT_TRUE(sdf::readFile(filename, sdf));
+
+    auto worldElem = sdf->Root()->GetElement("world");
+    ASSERT_NE(nullptr, worldElem);
+    EXPECT_TRUE(worldElem->HasElement("model"));
+    ASSERT_TRUE(worldElem->HasElement("state"));
+
+    physics::WorldState state(worldElem->GetElement("state"));
+    ASSERT_TRUE(state.HasModelState("box"));
+    EXPECT_EQ(ignition::math::Pose3d(0, 0, z, 0, 0, 0),
+        state.GetModelState("box").Pose());
+  }
+
+  boost::filesystem::remove(filename);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, LogPlayback)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_EQ(physics::World::LOG_PLAY_FULL, world->LogPlayback());
+
+  world->SetLogPlayback(physics::World::LOG_PLAY_POSES);
+  EXPECT_EQ(physics::World::LOG_PLAY_POSES, world->LogPlayback());
+
+  world->SetLogPlayback(physics::World::LOG_PLAY_SENSORS);
+  EXPECT_EQ(physics::World::LOG_PLAY_SENSORS, world->LogPlayback());
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -15,6 +15,8 @@
  *
 */
 
+#include <cmath>
+
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Assert.hh"
 
@@ -28,12 +30,79 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \internal
+/// \brief Bullet heightfield that culls the cells under an AABB with the
+/// height pyramid of the shape, and reads paged heights from the shape.
+class BulletPyramidHeightfield : public btHeightfieldTerrainShape
+{
+  /// \brief Constructor.
+  /// \param[in] _shape The heightmap shape.
+  /// \param[in] _heights The heights, null if they are paged, in which
+  /// case they are read through getRawHeightFieldValue.
+  /// \param[in] _minHeight Minimum height.
+  /// \param[in] _maxHeight Maximum height.
+  public: BulletPyramidHeightfield(const HeightmapShape *_shape,
+              const float *_heights, const float _minHeight,
+              const float _maxHeight)
+    : btHeightfieldTerrainShape(
+        _shape->VertexCount().X(),  // # of heights along width
+        _shape->VertexCount().Y(),  // # of height along height
+        _heights,                   // The heights
+        1,                          // Height scaling
+        _minHeight,                 // Min height
+        _maxHeight,                 // Max height
+        2,                          // Up axis, Z is up
+        PHY_FLOAT,
+        false),                     // Flip quad edges
+      shape(_shape)
+  {
+  }
+
+  // Documentation inherited
+  public: virtual void processAllTriangles(btTriangleCallback *_callback,
+              const btVector3 &_aabbMin, const btVector3 &_aabbMax) const
+  {
+    // Same local frame as btHeightfieldTerrainShape::processAllTriangles,
+    // where the up coordinate is the raw height
+    const btVector3 invScaling(1.0 / this->m_localScaling.x(),
+        1.0 / this->m_localScaling.y(), 1.0 / this->m_localScaling.z());
+    const btVector3 localMin = _aabbMin * invScaling + this->m_localOrigin;
+    const btVector3 localMax = _aabbMax * invScaling + this->m_localOrigin;
+
+    HeightmapShape::HeightType minHeight, maxHeight;
+    if (this->shape->Pyramid().Range(
+          static_cast<int>(std::floor(localMin.x())) - 1,
+          static_cast<int>(std::floor(localMin.y())) - 1,
+          static_cast<int>(std::ceil(localMax.x())) + 1,
+          static_cast<int>(std::ceil(localMax.y())) + 1,
+          minHeight, maxHeight) && localMin.z() > maxHeight)
+    {
+      return;
+    }
+
+    btHeightfieldTerrainShape::processAllTriangles(
+        _callback, _aabbMin, _aabbMax);
+  }
+
+  // Documentation inherited
+  protected: virtual btScalar getRawHeightFieldValue(int _x, int _y) const
+  {
+    if (this->shape->Pyramid().Paged())
+      return this->shape->GetHeight(_x, _y);
+    return btHeightfieldTerrainShape::getRawHeightFieldValue(_x, _y);
+  }
+
+  /// \brief The heightmap shape.
+  private: const HeightmapShape *shape;
+};
+
 //////////////////////////////////////////////////
 BulletHeightmapShape::BulletHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
   // Bullet need the height values flipped in the y direction
   this->flipY = true;
+  this->SetTilePagingSupported(true);
 }
 
 //////////////////////////////////////////////////
@@ -49,20 +118,11 @@ void BulletHeightmapShape::Init()
   float maxHeight = this->GetMaxHeight();
   float minHeight = this->GetMinHeight();
 
-  // This will force the Z-axis to be up
-  int upIndex = 2;
   btVector3 localScaling(this->scale.X(), this->scale.Y(), 1.0);
 
-  this->heightFieldShape  = new btHeightfieldTerrainShape(
-      this->vertSize,     // # of heights along width
-      this->vertSize,     // # of height along height
-      &this->heights[0],  // The heights
-      1,                  // Height scaling
-      minHeight,          // Min height
-      maxHeight,          // Max height
-      upIndex,            // Up axis
-      PHY_FLOAT,
-      false);             // Flip quad edges
+  this->heightFieldShape = new BulletPyramidHeightfield(this,
+      this->heights.empty() ? nullptr : &this->heights[0],
+      minHeight, maxHeight);
 
   this->heightFieldShape->setLocalScaling(localScaling);
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -42,6 +44,11 @@ BulletLink::BulletLink(EntityPtr _parent)
       this->GetWorld()->Physics());
   if (this->bulletPhysics == nullptr)
     gzerr << "Not using the bullet physics engine\n";
+
+  this->SetContinuousCollisionFunction([this](const bool _enable)
+      {
+        this->ApplyContinuousCollision(_enable);
+      });
 }
 
 //////////////////////////////////////////////////
@@ -164,9 +171,7 @@ void BulletLink::Init()
   this->rigidLink->setFriction(0.5*(hackMu1 + hackMu2));  // Hack
 
   // Setup motion clamping to prevent objects from moving too fast.
-  // this->rigidLink->setCcdMotionThreshold(1);
-  // auto size = this->BoundingBox().Size();
-  // this->rigidLink->setCcdSweptSphereRadius(size.GetMax()*0.8);
+  this->ApplyContinuousCollision(this->ContinuousCollision());
 
   if (this->inertial->Mass() <= 0.0)
     this->rigidLink->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
@@ -294,6 +299,28 @@ void BulletLink::SetSelfCollide(bool _collide)
   this->sdf->GetElement("self_collide")->Set(_collide);
 }
 
+//////////////////////////////////////////////////
+void BulletLink::ApplyContinuousCollision(const bool _enable)
+{
+  if (!this->rigidLink || !this->compoundShape)
+    return;
+
+  // A zero threshold disables the sweep
+  btScalar radius = 0;
+  if (_enable)
+  {
+    // Sweep a sphere inside the shapes once the link moves by more than
+    // half of its smallest size during a step
+    btVector3 aabbMin, aabbMax;
+    this->compoundShape->getAabb(btTransform::getIdentity(), aabbMin,
+        aabbMax);
+    const btVector3 halfSize = (aabbMax - aabbMin) * 0.5;
+    radius = std::max(btScalar(0), halfSize[halfSize.minAxis()]);
+  }
+  this->rigidLink->setCcdMotionThreshold(radius);
+  this->rigidLink->setCcdSweptSphereRadius(radius * 0.5);
+}
+
 //////////////////////////////////////////////////
 // void BulletLink::AttachCollision(Collision *_collision)
 // {
@@ -338,23 +365,24 @@ void BulletLink::OnPoseChange()
 //////////////////////////////////////////////////
 bool BulletLink::GetEnabled() const
 {
-  // This function and its counterpart BulletLink::SetEnabled
-  // don't do anything yet.
-  return true;
+  if (!this->rigidLink)
+    return true;
+
+  return this->rigidLink->getActivationState() != ISLAND_SLEEPING &&
+         this->rigidLink->getActivationState() != DISABLE_SIMULATION;
 }
 
 //////////////////////////////////////////////////
-void BulletLink::SetEnabled(bool /*_enable*/) const
+void BulletLink::SetEnabled(bool _enable) const
 {
-  /*
   if (!this->rigidLink)
     return;
 
+  // Sleeping bodies are woken up by Bullet's islands when touched.
   if (_enable)
     this->rigidLink->activate(true);
   else
-    this->rigidLink->setActivationState(WANTS_DEACTIVATION);
-    */
+    this->rigidLink->setActivationState(ISLAND_SLEEPING);
 }
 
 //////////////////////////////////////////////////
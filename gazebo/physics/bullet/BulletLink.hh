@@ -102,6 +102,10 @@ namespace gazebo
       // Documentation inherited.
       public: virtual void SetSelfCollide(bool _collide);
 
+      /// \brief Apply continuous collision detection to the rigid body.
+      /// \param[in] _enable True to enable continuous collision detection.
+      private: void ApplyContinuousCollision(const bool _enable);
+
       /// \brief Get the bullet rigid body.
       /// \return Pointer to bullet rigid body object.
       public: btRigidBody *GetBulletLink() const;
@@ -15,24 +15,103 @@
  *
 */
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "gazebo/common/Mesh.hh"
 
+#include "gazebo/physics/World.hh"
 #include "gazebo/physics/bullet/BulletTypes.hh"
 #include "gazebo/physics/bullet/BulletCollision.hh"
 #include "gazebo/physics/bullet/BulletPhysics.hh"
 #include "gazebo/physics/bullet/BulletMesh.hh"
 
+/// \internal
+/// \brief Private data for the BulletMesh class.
+class gazebo::physics::BulletMeshPrivate
+{
+  /// \brief Children of the compound shape, which doesn't own them.
+  public: std::vector<std::unique_ptr<btCollisionShape>> hullShapes;
+
+  /// \brief Triangles of a compact submesh, which the mesh shape doesn't
+  /// own.
+  public: std::unique_ptr<btTriangleIndexVertexArray> meshInterface;
+};
+
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Private data of the bullet meshes, by mesh. It is kept out of
+  /// BulletMesh so that the layout of the class doesn't change.
+  class BulletMeshPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the meshes.
+    public: static BulletMeshPrivates &Instance()
+    {
+      static BulletMeshPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by mesh.
+    public: std::unordered_map<const BulletMesh *,
+            std::unique_ptr<BulletMeshPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
+//////////////////////////////////////////////////
+/// \brief Check if meshes of a collision use their convex decomposition.
+/// \param[in] _collision The collision.
+/// \return Value of the mesh_convex_decomposition physics parameter.
+static bool ConvexDecompositionEnabled(BulletCollisionPtr _collision)
+{
+  WorldPtr world = _collision->GetWorld();
+  if (!world || !world->Physics())
+    return false;
+
+  boost::any value;
+  if (!world->Physics()->GetParam("mesh_convex_decomposition", value))
+    return false;
+
+  try
+  {
+    return boost::any_cast<bool>(value);
+  }
+  catch(boost::bad_any_cast &)
+  {
+    return false;
+  }
+}
+
 //////////////////////////////////////////////////
 BulletMesh::BulletMesh()
 {
+  BulletMeshPrivates &privates = BulletMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new BulletMeshPrivate);
 }
 
 //////////////////////////////////////////////////
 BulletMesh::~BulletMesh()
 {
+  BulletMeshPrivates &privates = BulletMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+BulletMeshPrivate *BulletMesh::BulletMeshData() const
+{
+  BulletMeshPrivates &privates = BulletMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -40,6 +119,19 @@ void BulletMesh::Init(const common::SubMesh *_subMesh,
                       BulletCollisionPtr _collision,
                       const ignition::math::Vector3d &_scale)
 {
+  if (ConvexDecompositionEnabled(_collision) && this->CreateHulls(
+        common::ConvexDecomposition::Instance()->Decompose(_subMesh),
+        _collision, _scale))
+  {
+    return;
+  }
+
+  if (_subMesh->IsCompact())
+  {
+    this->CreateMesh(_subMesh, _collision, _scale);
+    return;
+  }
+
   float *vertices = nullptr;
   int *indices = nullptr;
 
@@ -61,6 +153,21 @@ void BulletMesh::Init(const common::Mesh *_mesh,
                       BulletCollisionPtr _collision,
                       const ignition::math::Vector3d &_scale)
 {
+  if (ConvexDecompositionEnabled(_collision) && this->CreateHulls(
+        common::ConvexDecomposition::Instance()->Decompose(_mesh),
+        _collision, _scale))
+  {
+    return;
+  }
+
+  // A mesh with a single compact submesh is used without copying it
+  if (_mesh->GetSubMeshCount() == 1 && _mesh->GetSubMesh(0)->IsCompact() &&
+      _mesh->GetSubMesh(0)->GetVertexCount() > 2)
+  {
+    this->CreateMesh(_mesh->GetSubMesh(0), _collision, _scale);
+    return;
+  }
+
   float *vertices = nullptr;
   int *indices = nullptr;
 
@@ -116,3 +223,68 @@ void BulletMesh::CreateMesh(float *_vertices, int *_indices,
 
   _collision->SetCollisionShape(gimpactMeshShape);
 }
+
+/////////////////////////////////////////////////
+void BulletMesh::CreateMesh(const common::SubMesh *_subMesh,
+    BulletCollisionPtr _collision, const ignition::math::Vector3d &_scale)
+{
+  // Bullet reads the interleaved vertices and the 16 or 32 bit indices of
+  // the submesh in place, and scales them through the shape.
+  btIndexedMesh indexedMesh;
+  indexedMesh.m_numTriangles = _subMesh->GetIndexCount() / 3;
+  indexedMesh.m_triangleIndexBase =
+    static_cast<const unsigned char *>(_subMesh->IndexBuffer());
+  indexedMesh.m_triangleIndexStride = 3 * _subMesh->IndexSize();
+  indexedMesh.m_numVertices = _subMesh->GetVertexCount();
+  indexedMesh.m_vertexBase =
+    reinterpret_cast<const unsigned char *>(_subMesh->VertexBuffer());
+  indexedMesh.m_vertexStride = _subMesh->VertexStride() * sizeof(float);
+  indexedMesh.m_vertexType = PHY_FLOAT;
+  indexedMesh.m_indexType =
+    _subMesh->IndexSize() == sizeof(uint16_t) ? PHY_SHORT : PHY_INTEGER;
+
+  BulletMeshPrivate *data = this->BulletMeshData();
+  data->meshInterface.reset(new btTriangleIndexVertexArray());
+  data->meshInterface->addIndexedMesh(indexedMesh, indexedMesh.m_indexType);
+
+  btGImpactMeshShape *gimpactMeshShape =
+    new btGImpactMeshShape(data->meshInterface.get());
+  gimpactMeshShape->setLocalScaling(
+      btVector3(_scale.X(), _scale.Y(), _scale.Z()));
+  gimpactMeshShape->updateBound();
+
+  _collision->SetCollisionShape(gimpactMeshShape);
+}
+
+/////////////////////////////////////////////////
+bool BulletMesh::CreateHulls(const common::ConvexHull_V &_hulls,
+    BulletCollisionPtr _collision, const ignition::math::Vector3d &_scale)
+{
+  if (_hulls.empty())
+    return false;
+
+  BulletMeshPrivate *data = this->BulletMeshData();
+  btCompoundShape *compoundShape = new btCompoundShape();
+  for (const auto &hull : _hulls)
+  {
+    btConvexHullShape *hullShape = new btConvexHullShape();
+    for (const auto &v : hull.vertices)
+    {
+      hullShape->addPoint(btVector3(v.X() * _scale.X(), v.Y() * _scale.Y(),
+            v.Z() * _scale.Z()), false);
+    }
+    hullShape->recalcLocalAabb();
+
+    // The default margin is added outside of the hull, and would make the
+    // mesh float above the surfaces it rests on.
+    hullShape->setMargin(1e-3);
+
+    btTransform identity;
+    identity.setIdentity();
+    compoundShape->addChildShape(identity, hullShape);
+    data->hullShapes.emplace_back(hullShape);
+  }
+
+  _collision->SetCollisionShape(compoundShape);
+  return true;
+}
@@ -20,6 +20,7 @@
 
 #include <ignition/math/Vector3.hh>
 
+#include "gazebo/common/ConvexDecomposition.hh"
 #include "gazebo/physics/bullet/BulletTypes.hh"
 #include "gazebo/util/system.hh"
 
@@ -27,11 +28,18 @@ namespace gazebo
 {
   namespace physics
   {
+    class BulletMeshPrivate;
+
     /// \ingroup gazebo_physics
     /// \addtogroup gazebo_physics_bullet Bullet Physics
     /// \{
 
     /// \brief Triangle mesh collision helper class
+    ///
+    /// If the mesh_convex_decomposition parameter of the physics engine is
+    /// true when the mesh is initialized, the collision shape is a compound
+    /// of the convex hulls of the convex decomposition of the mesh, instead
+    /// of a GImpact triangle mesh.
     class GZ_PHYSICS_VISIBLE BulletMesh
     {
       /// \brief Constructor
@@ -67,6 +75,29 @@ namespace gazebo
                    unsigned int _numVertices, unsigned int _numIndices,
                    BulletCollisionPtr _collision,
                    const ignition::math::Vector3d &_scale);
+
+      /// \brief Helper function to create the collision shape from the
+      /// buffers of a compact submesh, without copying them.
+      /// \param[in] _subMesh Compact submesh.
+      /// \param[in] _collision Pointer to the collision object.
+      /// \param[in] _scale Scaling factor.
+      private: void CreateMesh(const common::SubMesh *_subMesh,
+                   BulletCollisionPtr _collision,
+                   const ignition::math::Vector3d &_scale);
+
+      /// \brief Helper function to create a compound collision shape from
+      /// convex hulls.
+      /// \param[in] _hulls Convex decomposition of the mesh.
+      /// \param[in] _collision Pointer to the collision object.
+      /// \param[in] _scale Scaling factor.
+      /// \return False if there are no hulls.
+      private: bool CreateHulls(const common::ConvexHull_V &_hulls,
+                   BulletCollisionPtr _collision,
+                   const ignition::math::Vector3d &_scale);
+
+      /// \brief Get the private data of the mesh.
+      /// \return The private data, see BulletMeshPrivate.
+      private: BulletMeshPrivate *BulletMeshData() const;
     };
     /// \}
   }
@@ -16,9 +16,12 @@
 */
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/physics/bullet/BulletTypes.hh"
@@ -62,11 +65,49 @@
 #include "gazebo/physics/bullet/BulletPhysics.hh"
 #include "gazebo/physics/bullet/BulletSurfaceParams.hh"
 
+/// \internal
+/// \brief Private data for the BulletPhysics class.
+class gazebo::physics::BulletPhysicsPrivate
+{
+  /// \brief Broadphase filter, installed on every dynamics world.
+  public: btOverlapFilterCallback *filterCallback = nullptr;
+
+  /// \brief Number of threads of the dynamics world.
+  public: int threadCount = 1;
+
+  /// \brief True to collide meshes with their convex decomposition.
+  public: bool meshConvexDecomposition = false;
+};
+
 using namespace gazebo;
 using namespace physics;
 
 GZ_REGISTER_PHYSICS_ENGINE("bullet", BulletPhysics)
 
+namespace
+{
+  /// \brief Private data of the bullet physics engines, by engine. It is
+  /// kept out of BulletPhysics so that the layout of the class doesn't
+  /// change.
+  class BulletPhysicsPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the engines.
+    public: static BulletPhysicsPrivates &Instance()
+    {
+      static BulletPhysicsPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by engine.
+    public: std::unordered_map<const BulletPhysics *,
+            std::unique_ptr<BulletPhysicsPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 extern ContactAddedCallback gContactAddedCallback;
 extern ContactProcessedCallback gContactProcessedCallback;
 
@@ -262,14 +303,17 @@ bool ContactProcessed(btManifoldPoint &/*_cp*/, void * /*_body0*/,
 BulletPhysics::BulletPhysics(WorldPtr _world)
     : PhysicsEngine(_world)
 {
+  {
+    BulletPhysicsPrivates &privates = BulletPhysicsPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new BulletPhysicsPrivate);
+  }
+
   // This function currently follows the pattern of bullet/Demos/HelloWorld
 
   // Default setup for memory and collisions
   this->collisionConfig = new btDefaultCollisionConfiguration();
 
-  // Default collision dispatcher, a multi-threaded dispatcher may be available
-  this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
-
   // Broadphase collision detection uses axis-aligned bounding boxes (AABB)
   // to detect pairs of objects that may be in contact.
   // The narrow-phase collision detection evaluates each pair generated by the
@@ -282,40 +326,36 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Here we are using btDbvtBroadphase.
   this->broadPhase = new btDbvtBroadphase();
 
-  // Create btSequentialImpulseConstraintSolver, the default constraint solver.
-  // Note that a multi-threaded solver may be available.
-  this->solver = new btSequentialImpulseConstraintSolver;
+  this->BulletPhysicsData()->filterCallback = new CollisionFilter();
 
-  // Create a btDiscreteDynamicsWorld, which is used for discrete rigid bodies.
-  // An alternative is btSoftRigidDynamicsWorld, which handles both soft and
-  // rigid bodies.
-  this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
-      this->broadPhase, this->solver, this->collisionConfig);
-
-  btOverlapFilterCallback *filterCallback = new CollisionFilter();
-  btOverlappingPairCache* pairCache = this->dynamicsWorld->getPairCache();
-  GZ_ASSERT(pairCache != nullptr,
-      "Bullet broadphase overlapping pair cache is null");
-  pairCache->setOverlapFilterCallback(filterCallback);
+  // Single threaded until the "thread_count" parameter is set
+  this->CreateDynamicsWorld(false);
 
   // TODO: Enable this to do custom contact setting
   gContactAddedCallback = ContactCallback;
   gContactProcessedCallback = ContactProcessed;
 
-  this->dynamicsWorld->setInternalTickCallback(
-      InternalTickCallback, static_cast<void *>(this));
-
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(ignition::math::Rand::Seed());
-
-  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
 }
 
 //////////////////////////////////////////////////
 BulletPhysics::~BulletPhysics()
 {
   this->Fini();
+
+  BulletPhysicsPrivates &privates = BulletPhysicsPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+BulletPhysicsPrivate *BulletPhysics::BulletPhysicsData() const
+{
+  BulletPhysicsPrivates &privates = BulletPhysicsPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -325,6 +365,12 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
 
   sdf::ElementPtr bulletElem = this->sdf->GetElement("bullet");
 
+  // Optional element outside of the bullet SDF description. The dynamics
+  // world is replaced before the solver is configured.
+  sdf::ElementPtr solverElem = bulletElem->GetElement("solver");
+  if (solverElem->HasElement("thread_count"))
+    this->SetThreadCount(solverElem->Get<int>("thread_count"));
+
   auto g = this->world->Gravity();
   // ODEPhysics checks this, so we will too.
   if (g == ignition::math::Vector3d::Zero)
@@ -402,6 +448,7 @@ void BulletPhysics::OnRequest(ConstRequestPtr &_msg)
     msgs::Physics physicsMsg;
     physicsMsg.set_type(msgs::Physics::BULLET);
     physicsMsg.set_solver_type(this->solverType);
+    physicsMsg.set_thread_count(this->BulletPhysicsData()->threadCount);
     // min_step_size is defined but not yet used
     physicsMsg.set_min_step_size(
       boost::any_cast<double>(this->GetParam("min_step_size")));
@@ -446,6 +493,9 @@ void BulletPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
   if (_msg->has_solver_type())
     this->SetParam("solver_type", _msg->solver_type());
 
+  if (_msg->has_thread_count())
+    this->SetParam("thread_count", _msg->thread_count());
+
   if (_msg->has_iters())
     this->SetParam("iters", _msg->iters());
 
@@ -554,9 +604,149 @@ void BulletPhysics::Fini()
     delete this->collisionConfig;
   this->collisionConfig = nullptr;
 
+  BulletPhysicsPrivate *data = this->BulletPhysicsData();
+  if (data->filterCallback)
+    delete data->filterCallback;
+  data->filterCallback = nullptr;
+
   PhysicsEngine::Fini();
 }
 
+//////////////////////////////////////////////////
+void BulletPhysics::CreateDynamicsWorld(const bool _multithreaded)
+{
+  btContactSolverInfo info;
+  btVector3 gravity(0, 0, -10);
+  const bool replace = this->dynamicsWorld != nullptr;
+  if (replace)
+  {
+    info = this->dynamicsWorld->getSolverInfo();
+    gravity = this->dynamicsWorld->getGravity();
+  }
+
+  // Delete in reverse-order of creation
+  delete this->dynamicsWorld;
+  delete this->solver;
+  delete this->dispatcher;
+
+#ifdef LIBBULLET_VERSION_GT_286
+  if (_multithreaded)
+  {
+    // Collision pairs are dispatched and simulation islands are solved on
+    // the threads of the task scheduler. Each thread borrows a sequential
+    // impulse solver from the pool.
+    this->dispatcher = new btCollisionDispatcherMt(this->collisionConfig);
+    btConstraintSolverPoolMt *pool =
+        new btConstraintSolverPoolMt(this->BulletPhysicsData()->threadCount);
+    this->solver = pool;
+#if BT_BULLET_VERSION >= 288
+    this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+        this->broadPhase, pool, nullptr, this->collisionConfig);
+#else
+    this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+        this->broadPhase, pool, this->collisionConfig);
+#endif
+  }
+  else
+#endif
+  {
+    GZ_ASSERT(!_multithreaded, "Bullet does not support multithreading");
+
+    // Default collision dispatcher
+    this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
+
+    // Create btSequentialImpulseConstraintSolver, the default constraint
+    // solver.
+    this->solver = new btSequentialImpulseConstraintSolver;
+
+    // Create a btDiscreteDynamicsWorld, which is used for discrete rigid
+    // bodies. An alternative is btSoftRigidDynamicsWorld, which handles both
+    // soft and rigid bodies.
+    this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
+        this->broadPhase, this->solver, this->collisionConfig);
+  }
+
+  btOverlappingPairCache* pairCache = this->dynamicsWorld->getPairCache();
+  GZ_ASSERT(pairCache != nullptr,
+      "Bullet broadphase overlapping pair cache is null");
+  pairCache->setOverlapFilterCallback(
+      this->BulletPhysicsData()->filterCallback);
+
+  this->dynamicsWorld->setInternalTickCallback(
+      InternalTickCallback, static_cast<void *>(this));
+
+  btGImpactCollisionAlgorithm::registerAlgorithm(this->dispatcher);
+
+  if (replace)
+  {
+    this->dynamicsWorld->getSolverInfo() = info;
+    this->dynamicsWorld->setGravity(gravity);
+  }
+}
+
+//////////////////////////////////////////////////
+bool BulletPhysics::SetThreadCount(const int _count)
+{
+  if (_count < 1)
+  {
+    gzerr << "Bullet thread_count must be at least 1, got "
+          << _count << std::endl;
+    return false;
+  }
+
+  BulletPhysicsPrivate *data = this->BulletPhysicsData();
+  if (_count == data->threadCount)
+    return true;
+
+#ifdef LIBBULLET_VERSION_GT_286
+  const bool multithreaded = dynamic_cast<btDiscreteDynamicsWorldMt *>(
+      this->dynamicsWorld) != nullptr;
+  const bool replace = multithreaded != (_count > 1);
+
+  // Bodies and joints keep pointers to the dynamics world, which can only
+  // be replaced while it is empty.
+  if (replace && (this->dynamicsWorld->getNumCollisionObjects() > 0 ||
+      this->dynamicsWorld->getNumConstraints() > 0))
+  {
+    gzwarn << "Bullet thread_count can only switch between single and "
+           << "multithreaded before models are loaded" << std::endl;
+    return false;
+  }
+
+  if (_count > 1)
+  {
+    // The task scheduler is global to the process, TBB is preferred
+    // since gazebo already uses it.
+    btITaskScheduler *scheduler = btGetTaskScheduler();
+    if (!scheduler || scheduler->getMaxNumThreads() <= 1)
+    {
+      scheduler = btGetTBBTaskScheduler();
+      if (!scheduler)
+        scheduler = btGetOpenMPTaskScheduler();
+      if (!scheduler)
+        scheduler = btCreateDefaultTaskScheduler();
+      if (!scheduler)
+      {
+        gzwarn << "Bullet was built without BT_THREADSAFE, "
+               << "thread_count is ignored" << std::endl;
+        return false;
+      }
+      btSetTaskScheduler(scheduler);
+    }
+    scheduler->setNumThreads(std::min(_count, scheduler->getMaxNumThreads()));
+  }
+
+  data->threadCount = _count;
+  if (replace)
+    this->CreateDynamicsWorld(_count > 1);
+  return true;
+#else
+  gzwarn << "Bullet older than 2.87 has no multithreaded dynamics world, "
+         << "thread_count is ignored" << std::endl;
+  return false;
+#endif
+}
+
 //////////////////////////////////////////////////
 void BulletPhysics::Reset()
 {
@@ -659,6 +849,23 @@ bool BulletPhysics::SetParam(const std::string &_key, const boost::any &_value)
       double value = any_cast<double>(_value);
       bulletElem->GetElement("solver")->GetElement("min_step_size")->Set(value);
     }
+    else if (_key == "thread_count")
+    {
+      // Not part of the bullet SDF description, only kept in sync when the
+      // world file has it
+      int value = any_cast<int>(_value);
+      if (!this->SetThreadCount(value))
+        return false;
+      sdf::ElementPtr solverElem = bulletElem->GetElement("solver");
+      if (solverElem->HasElement("thread_count"))
+        solverElem->GetElement("thread_count")->Set(value);
+    }
+    else if (_key == "mesh_convex_decomposition")
+    {
+      // Applies to the meshes initialized afterwards
+      this->BulletPhysicsData()->meshConvexDecomposition =
+          any_cast<bool>(_value);
+    }
     else
     {
       return PhysicsEngine::SetParam(_key, _value);
@@ -721,6 +928,10 @@ bool BulletPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->sdf->GetElement("max_contacts")->Get<int>();
   else if (_key == "min_step_size")
     _value = bulletElem->GetElement("solver")->Get<double>("min_step_size");
+  else if (_key == "thread_count")
+    _value = this->BulletPhysicsData()->threadCount;
+  else if (_key == "mesh_convex_decomposition")
+    _value = this->BulletPhysicsData()->meshConvexDecomposition;
   else
   {
     return PhysicsEngine::GetParam(_key, _value);
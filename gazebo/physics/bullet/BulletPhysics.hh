@@ -39,6 +39,7 @@ namespace gazebo
     class Entity;
     class XMLConfigNode;
     class Mass;
+    class BulletPhysicsPrivate;
 
     /// \ingroup gazebo_physics
     /// \addtogroup gazebo_physics_bullet Bullet Physics
@@ -172,11 +173,28 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSORPGSIters(unsigned int iters);
 
-      private: btBroadphaseInterface *broadPhase;
-      private: btDefaultCollisionConfiguration *collisionConfig;
-      private: btCollisionDispatcher *dispatcher;
-      private: btSequentialImpulseConstraintSolver *solver;
-      private: btDiscreteDynamicsWorld *dynamicsWorld;
+      /// \brief Create the dynamics world, along with its dispatcher and
+      /// constraint solver. The solver settings and gravity of the previous
+      /// world are kept. Must not be called once the world has bodies.
+      /// \param[in] _multithreaded True to create a btDiscreteDynamicsWorldMt
+      /// that runs on the bullet task scheduler.
+      private: void CreateDynamicsWorld(const bool _multithreaded);
+
+      /// \brief Set the number of threads of the dynamics world, see the
+      /// "thread_count" parameter.
+      /// \param[in] _count Number of threads, 1 for a single threaded world.
+      /// \return False if the count could not be applied.
+      private: bool SetThreadCount(const int _count);
+
+      /// \brief Get the private data of the physics engine.
+      /// \return The private data, see BulletPhysicsPrivate.
+      private: BulletPhysicsPrivate *BulletPhysicsData() const;
+
+      private: btBroadphaseInterface *broadPhase = nullptr;
+      private: btDefaultCollisionConfiguration *collisionConfig = nullptr;
+      private: btCollisionDispatcher *dispatcher = nullptr;
+      private: btConstraintSolver *solver = nullptr;
+      private: btDiscreteDynamicsWorld *dynamicsWorld = nullptr;
 
       private: common::Time lastUpdateTime;
 
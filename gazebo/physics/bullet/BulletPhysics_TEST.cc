@@ -16,10 +16,12 @@
 */
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include <string>
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/bullet/BulletCollision.hh"
 #include "gazebo/physics/bullet/BulletPhysics.hh"
 #include "gazebo/physics/bullet/BulletTypes.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -180,6 +182,99 @@ TEST_F(BulletPhysics_TEST, PhysicsParam)
   EXPECT_DOUBLE_EQ(maxStepSize, maxStepSizeRet);
 }
 
+/////////////////////////////////////////////////
+/// Test the thread count of the dynamics world
+TEST_F(BulletPhysics_TEST, ThreadCount)
+{
+  Load("worlds/blank.world", true, "bullet");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  BulletPhysicsPtr bulletPhysics
+      = boost::dynamic_pointer_cast<BulletPhysics>(world->Physics());
+  ASSERT_TRUE(bulletPhysics != nullptr);
+
+  EXPECT_EQ(1, boost::any_cast<int>(bulletPhysics->GetParam("thread_count")));
+  EXPECT_FALSE(bulletPhysics->SetParam("thread_count", 0));
+  EXPECT_EQ(1, boost::any_cast<int>(bulletPhysics->GetParam("thread_count")));
+
+  // Only available with a thread safe build of bullet 2.87 or later
+  if (bulletPhysics->SetParam("thread_count", 2))
+  {
+    EXPECT_EQ(2,
+        boost::any_cast<int>(bulletPhysics->GetParam("thread_count")));
+    EXPECT_TRUE(bulletPhysics->GetDynamicsWorld() != nullptr);
+  }
+
+  // A falling box behaves the same either way
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 10));
+  ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  world->Step(100);
+  EXPECT_LT(model->WorldPose().Pos().Z(), 10.0);
+  EXPECT_NEAR(model->WorldPose().Pos().X(), 0.0, 1e-6);
+
+  // The world can't be replaced once it has bodies
+  const int count =
+      boost::any_cast<int>(bulletPhysics->GetParam("thread_count"));
+  EXPECT_FALSE(bulletPhysics->SetParam("thread_count", count > 1 ? 1 : 2));
+  EXPECT_EQ(count,
+      boost::any_cast<int>(bulletPhysics->GetParam("thread_count")));
+}
+
+/////////////////////////////////////////////////
+/// Test that a mesh collision is a compound of convex hulls when enabled
+TEST_F(BulletPhysics_TEST, MeshConvexDecomposition)
+{
+  Load("worlds/empty.world", true, "bullet");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_FALSE(boost::any_cast<bool>(
+      physics->GetParam("mesh_convex_decomposition")));
+  EXPECT_TRUE(physics->SetParam("mesh_convex_decomposition", true));
+  EXPECT_TRUE(boost::any_cast<bool>(
+      physics->GetParam("mesh_convex_decomposition")));
+
+  std::ostringstream modelStr;
+  modelStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name ='mesh_model'>"
+    << "<pose>0 0 1 0 0 0</pose>"
+    << "<link name ='link'>"
+    << "  <collision name ='collision'>"
+    << "    <geometry>"
+    << "      <mesh>"
+    << "        <uri>" << std::string(PROJECT_SOURCE_PATH)
+                       << "/test/data/box_offset.dae</uri>"
+    << "      </mesh>"
+    << "    </geometry>"
+    << "  </collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(modelStr.str());
+  ModelPtr model = world->ModelByName("mesh_model");
+  ASSERT_TRUE(model != nullptr);
+
+  BulletCollisionPtr collision =
+    boost::dynamic_pointer_cast<BulletCollision>(
+        model->GetLink("link")->GetCollision("collision"));
+  ASSERT_TRUE(collision != nullptr);
+  btCompoundShape *shape =
+    dynamic_cast<btCompoundShape *>(collision->GetCollisionShape());
+  ASSERT_TRUE(shape != nullptr);
+
+  // The box is convex, so it is a single hull
+  EXPECT_EQ(1, shape->getNumChildShapes());
+
+  // It falls and rests on the ground plane
+  world->Step(2000);
+  EXPECT_NEAR(0.0, model->GetLink("link")->WorldLinearVel().Length(), 1e-2);
+}
+
 /////////////////////////////////////////////////
 void BulletPhysics_TEST::OnPhysicsMsgResponse(ConstResponsePtr &_msg)
 {
@@ -251,11 +251,17 @@ void DARTLink::Init()
   // We don't add dart body node to the skeleton here because dart body node
   // should be set its parent joint before being added. This body node will be
   // added to the skeleton in DARTModel::Init().
+
+  this->dataPtr->dartPhysics->AddDARTLink(
+      boost::static_pointer_cast<DARTLink>(shared_from_this()));
 }
 
 //////////////////////////////////////////////////
 void DARTLink::Fini()
 {
+  if (this->dataPtr->dartPhysics)
+    this->dataPtr->dartPhysics->RemoveDARTLink(this);
+
   Link::Fini();
 }
 
@@ -297,6 +303,10 @@ void DARTLink::UpdateMass()
 //////////////////////////////////////////////////
 void DARTLink::OnPoseChange()
 {
+  // Links without a free joint keep their DART transform, so the next sync
+  // must restore their gazebo pose even if the transform did not change.
+  this->dataPtr->lastTransformValid = false;
+
   if (!this->dataPtr->IsInitialized())
   {
     this->dataPtr->Cache("DARTLink::OnPoseChange",
@@ -335,16 +345,28 @@ void DARTLink::OnPoseChange()
 }
 
 //////////////////////////////////////////////////
-void DARTLink::SetEnabled(bool /*_enable*/) const
+void DARTLink::SetEnabled(bool _enable) const
 {
-  // TODO: DART does not support this functionality.
+  // DART can only freeze a whole skeleton. Links are disabled together by
+  // physics::SleepManager, which wakes the model up on contact.
+  if (!this->dataPtr->IsInitialized() || this->IsStatic())
+    return;
+
+  dart::dynamics::SkeletonPtr skeleton =
+      this->dataPtr->dtBodyNode->getSkeleton();
+  if (skeleton)
+    skeleton->setMobile(_enable);
 }
 
 //////////////////////////////////////////////////
 bool DARTLink::GetEnabled() const
 {
-  // TODO: DART does not support this functionality.
-  return true;
+  if (!this->dataPtr->IsInitialized() || this->IsStatic())
+    return true;
+
+  dart::dynamics::SkeletonPtr skeleton =
+      this->dataPtr->dtBodyNode->getSkeleton();
+  return !skeleton || skeleton->isMobile();
 }
 
 //////////////////////////////////////////////////
@@ -955,17 +977,27 @@ void DARTLink::updateDirtyPoseFromDARTTransformation()
     return;
   }
 
-  // Step 1: get dart body's transformation
+  // Step 1: get dart body's transformation, skip the link if it has not
+  // moved since the last sync
   // Step 2: set gazebo link's pose using the transformation
-  ignition::math::Pose3d newPose = DARTTypes::ConvPoseIgn(
-      this->dataPtr->dtBodyNode->getTransform());
+  const Eigen::Isometry3d &transform =
+      this->dataPtr->dtBodyNode->getTransform();
+  if (this->dataPtr->lastTransformValid &&
+      transform.matrix() == this->dataPtr->lastTransform.matrix())
+  {
+    return;
+  }
+  this->dataPtr->lastTransform = transform;
+  this->dataPtr->lastTransformValid = true;
+
+  ignition::math::Pose3d newPose = DARTTypes::ConvPoseIgn(transform);
 
   // Set the new pose to this link
   this->dirtyPose = newPose;
 
   // Set the new pose to the world
   // (Below method can be changed in gazebo code)
-  this->world->dataPtr->dirtyPoses.push_back(this);
+  this->world->_AddDirty(this);
 }
 
 //////////////////////////////////////////////////
@@ -51,7 +51,9 @@ namespace gazebo
           dartChildJoints {},
           isSoftBody(false),
           staticLink(false),
-          dtWeldJointConst(nullptr)
+          dtWeldJointConst(nullptr),
+          lastTransform(Eigen::Isometry3d::Identity()),
+          lastTransformValid(false)
       {
       }
 
@@ -180,6 +182,13 @@ namespace gazebo
 
       /// \brief Weld joint constraint for SetLinkStatic()
       public: dart::constraint::WeldJointConstraintPtr dtWeldJointConst;
+
+      /// \brief Transform of the body node last pushed to the gazebo link.
+      public: Eigen::Isometry3d lastTransform;
+
+      /// \brief False if the gazebo link pose may differ from
+      /// lastTransform, in which case the next sync can't be skipped.
+      public: bool lastTransformValid;
     };
   }
 }
@@ -36,6 +36,12 @@ using namespace physics;
 DARTModel::DARTModel(BasePtr _parent)
   : Model(_parent), dataPtr(new DARTModelPrivate())
 {
+  this->SetJointStatesFunction([this](const Joint_V &_joints,
+        std::vector<double> *_positions, std::vector<double> *_velocities,
+        std::vector<double> *_efforts)
+      {
+        this->SkeletonJointStates(_joints, _positions, _velocities, _efforts);
+      });
 }
 
 //////////////////////////////////////////////////
@@ -418,3 +424,77 @@ bool DARTModel::RemoveJoint(const std::string &_name)
 
   return Model::RemoveJoint(_name);
 }
+
+//////////////////////////////////////////////////
+void DARTModel::SkeletonJointStates(const Joint_V &_joints,
+    std::vector<double> *_positions, std::vector<double> *_velocities,
+    std::vector<double> *_efforts) const
+{
+  const dart::dynamics::SkeletonPtr &skeleton = this->dataPtr->dtSkeleton;
+  if (!skeleton || this->IsStatic())
+  {
+    Model::DefaultJointStates(_joints, _positions, _velocities, _efforts);
+    return;
+  }
+
+  if (_positions)
+    _positions->clear();
+  if (_velocities)
+    _velocities->clear();
+  if (_efforts)
+    _efforts->clear();
+
+  Eigen::VectorXd positions;
+  Eigen::VectorXd velocities;
+  if (_positions)
+    positions = skeleton->getPositions();
+  if (_velocities)
+    velocities = skeleton->getVelocities();
+
+  std::vector<double> jointPositions;
+  std::vector<double> jointVelocities;
+  std::vector<double> jointEfforts;
+  for (auto const &joint : _joints)
+  {
+    DARTJointPtr dartJoint = boost::dynamic_pointer_cast<DARTJoint>(joint);
+    dart::dynamics::Joint *dtJoint =
+        dartJoint ? dartJoint->GetDARTJoint() : nullptr;
+    const unsigned int dof = joint->DOF();
+
+    if (!dtJoint || dtJoint->getSkeleton() != skeleton ||
+        dtJoint->getNumDofs() != dof)
+    {
+      Model::DefaultJointStates({joint},
+          _positions ? &jointPositions : nullptr,
+          _velocities ? &jointVelocities : nullptr,
+          _efforts ? &jointEfforts : nullptr);
+      if (_positions)
+      {
+        _positions->insert(_positions->end(), jointPositions.begin(),
+            jointPositions.end());
+      }
+      if (_velocities)
+      {
+        _velocities->insert(_velocities->end(), jointVelocities.begin(),
+            jointVelocities.end());
+      }
+      if (_efforts)
+      {
+        _efforts->insert(_efforts->end(), jointEfforts.begin(),
+            jointEfforts.end());
+      }
+      continue;
+    }
+
+    for (unsigned int i = 0; i < dof; ++i)
+    {
+      const std::size_t index = dtJoint->getIndexInSkeleton(i);
+      if (_positions)
+        _positions->push_back(positions[index]);
+      if (_velocities)
+        _velocities->push_back(velocities[index]);
+      if (_efforts)
+        _efforts->push_back(joint->GetForce(i));
+    }
+  }
+}
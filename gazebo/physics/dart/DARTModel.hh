@@ -74,6 +74,16 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool RemoveJoint(const std::string &_name);
 
+      /// \brief Read the positions and velocities of the joints of the
+      /// skeleton from its generalized coordinate vectors, fetched once.
+      /// Joints of other skeletons fall back to Model::DefaultJointStates.
+      /// Set as the joint states function of the model.
+      /// \sa Model::JointStates
+      private: void SkeletonJointStates(const Joint_V &_joints,
+                   std::vector<double> *_positions,
+                   std::vector<double> *_velocities,
+                   std::vector<double> *_efforts) const;
+
       /// \brief
       public: void BackupState();
 
@@ -15,6 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
 // required for HAVE_DART_BULLET define
 #include <gazebo/gazebo_config.h>
 
@@ -25,7 +30,7 @@
 #include <dart/collision/dart/dart.hpp>
 #include <dart/collision/fcl/fcl.hpp>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -61,6 +66,7 @@
 #include "gazebo/physics/dart/DARTMultiRayShape.hh"
 #include "gazebo/physics/dart/DARTHeightmapShape.hh"
 
+#include "gazebo/physics/dart/DARTCollision.hh"
 #include "gazebo/physics/dart/DARTModel.hh"
 #include "gazebo/physics/dart/DARTLink.hh"
 
@@ -73,6 +79,85 @@ using namespace physics;
 
 GZ_REGISTER_PHYSICS_ENGINE("dart", DARTPhysics)
 
+/// \brief Maximum number of positions tested along the path of a
+/// continuous collision link during a step.
+static const unsigned int CCD_MAX_SAMPLES = 64;
+
+/// \brief Collision filter of the overlap test of a swept body node: skips
+/// the pairs of shapes of a same body node, then defers to the filter of
+/// the constraint solver.
+class SweepCollisionFilter : public dart::collision::CollisionFilter
+{
+  /// \brief Constructor.
+  /// \param[in] _filter Filter of the constraint solver, may be null.
+  public: explicit SweepCollisionFilter(
+              const std::shared_ptr<dart::collision::CollisionFilter> &_filter)
+    : filter(_filter)
+  {
+  }
+
+  // Documentation inherited
+  public: bool ignoresCollision(
+              const dart::collision::CollisionObject *_object1,
+              const dart::collision::CollisionObject *_object2) const override
+  {
+    const dart::dynamics::ShapeNode *node1 =
+        _object1->getShapeFrame()->asShapeNode();
+    const dart::dynamics::ShapeNode *node2 =
+        _object2->getShapeFrame()->asShapeNode();
+    if (node1 && node2 &&
+        node1->getBodyNodePtr().get() == node2->getBodyNodePtr().get())
+    {
+      return true;
+    }
+    return this->filter && this->filter->ignoresCollision(_object1, _object2);
+  }
+
+  /// \brief Filter of the constraint solver.
+  private: std::shared_ptr<dart::collision::CollisionFilter> filter;
+};
+
+//////////////////////////////////////////////////
+/// \brief Half of the smallest size of the collisions of a link.
+/// \param[in] _link The link.
+/// \return The radius, 0 if the link has no collision.
+static double SweepRadius(const DARTLinkPtr &_link)
+{
+  double radius = 0;
+  for (const CollisionPtr &collision : _link->GetCollisions())
+  {
+    DARTCollisionPtr dartCollision =
+        boost::dynamic_pointer_cast<DARTCollision>(collision);
+    if (!dartCollision || !dartCollision->DARTCollisionShapeNode())
+      continue;
+
+    const dart::math::BoundingBox &box =
+        dartCollision->DARTCollisionShapeNode()->getShape()->getBoundingBox();
+    const double halfSize = 0.5 * (box.getMax() - box.getMin()).minCoeff();
+    if (halfSize > 0 && (radius <= 0 || halfSize < radius))
+      radius = halfSize;
+  }
+  return radius;
+}
+
+//////////////////////////////////////////////////
+/// \brief Move a body node with a free joint, see DARTLink::OnPoseChange.
+/// \param[in] _bodyNode The body node.
+/// \param[in] _transform New world transform of the body node.
+static void SetFreeJointTransform(dart::dynamics::BodyNode *_bodyNode,
+    const Eigen::Isometry3d &_transform)
+{
+  dart::dynamics::Joint *joint = _bodyNode->getParentJoint();
+  Eigen::Isometry3d parent = Eigen::Isometry3d::Identity();
+  if (_bodyNode->getParentBodyNode())
+    parent = _bodyNode->getParentBodyNode()->getTransform();
+
+  const Eigen::Isometry3d q =
+      joint->getTransformFromParentBodyNode().inverse() * parent.inverse() *
+      _transform * joint->getTransformFromChildBodyNode();
+  joint->setPositions(dart::dynamics::FreeJoint::convertToPositions(q));
+}
+
 //////////////////////////////////////////////////
 DARTPhysics::DARTPhysics(WorldPtr _world)
     : PhysicsEngine(_world), dataPtr(new DARTPhysicsPrivate())
@@ -97,6 +182,11 @@ void DARTPhysics::Load(sdf::ElementPtr _sdf)
   if (g == ignition::math::Vector3d::Zero)
     gzwarn << "Gravity vector is (0, 0, 0). Objects will float.\n";
   this->dataPtr->dtWorld->setGravity(Eigen::Vector3d(g.X(), g.Y(), g.Z()));
+
+  // Contact cap, only when given since DART's default is larger than the
+  // default of the SDF element
+  if (this->sdf->HasElement("max_contacts"))
+    this->SetParam("max_contacts", this->sdf->Get<int>("max_contacts"));
 }
 
 //////////////////////////////////////////////////
@@ -116,6 +206,8 @@ void DARTPhysics::Init()
 //////////////////////////////////////////////////
 void DARTPhysics::Fini()
 {
+  this->dataPtr->dartLinks.clear();
+  this->dataPtr->bodyNodeLinks.clear();
   PhysicsEngine::Fini();
 }
 
@@ -220,36 +312,6 @@ class LinkPair
   private: DARTLinkPtr dtLink2;
 };
 
-//////////////////////////////////////////////////
-static DARTLinkPtr StaticFindDARTLink(
-    DARTPhysics *_dtPhysics,
-    const dart::dynamics::BodyNode *_dtBodyNode)
-{
-  DARTLinkPtr res;
-
-  const Model_V& models = _dtPhysics->World()->Models();
-
-  for (Model_V::const_iterator itModel = models.begin();
-       itModel != models.end(); ++itModel)
-  {
-    const Link_V& links = (*itModel)->GetLinks();
-
-    for (Link_V::const_iterator itLink = links.begin();
-         itLink != links.end(); ++itLink)
-    {
-      DARTLinkPtr dartLink = boost::dynamic_pointer_cast<DARTLink>(*itLink);
-
-      if (dartLink->DARTBodyNode() == _dtBodyNode)
-      {
-        res = dartLink;
-        break;
-      }
-    }
-  }
-
-  return res;
-}
-
 //////////////////////////////////////////////////
 static void RetrieveDARTCollisions(
     DARTPhysics* _dtPhysics,
@@ -308,8 +370,8 @@ static void RetrieveDARTCollisions(
     GZ_ASSERT(dtBodyNode1, "body node 1 is null!");
     GZ_ASSERT(dtBodyNode2, "body node 2 is null!");
 
-    DARTLinkPtr dartLink1 = StaticFindDARTLink(_dtPhysics, dtBodyNode1);
-    DARTLinkPtr dartLink2 = StaticFindDARTLink(_dtPhysics, dtBodyNode2);
+    DARTLinkPtr dartLink1 = _dtPhysics->FindDARTLink(dtBodyNode1);
+    DARTLinkPtr dartLink2 = _dtPhysics->FindDARTLink(dtBodyNode2);
 
     GZ_ASSERT(dartLink1, "dartLink1 in collision pair is null");
     GZ_ASSERT(dartLink2, "dartLink2 in collision pair is null");
@@ -419,19 +481,20 @@ void DARTPhysics::UpdateCollision()
 
   if (!this->world->PhysicsEnabled())
   {
-    dart::collision::CollisionResult localResult;
-
     // collision computation is disabled when UpdatePhysics() is not
-    // being called, so do collision detection separately here.
-    std::size_t maxContacts = 1000u;
-    dart::collision::CollisionOption opt(true, maxContacts);
+    // being called, so do collision detection separately here, with the
+    // options of the constraint solver.
     // call of checkCollision will not update the result which
     // can be retrieved with
     // this->dataPtr->dtWorld->getLastCollisionResult()
     // so get the results and store them locally.
-    this->dataPtr->dtWorld->checkCollision(opt, &localResult);
+    dart::collision::CollisionResult &result = this->dataPtr->collisionResult;
+    result.clear();
+    this->dataPtr->dtWorld->checkCollision(
+        this->dataPtr->dtWorld->getConstraintSolver()->getCollisionOption(),
+        &result);
 
-    RetrieveDARTCollisions(this, &localResult, this->GetContactManager());
+    RetrieveDARTCollisions(this, &result, this->GetContactManager());
   }
   IGN_PROFILE_END();
 }
@@ -447,30 +510,31 @@ void DARTPhysics::UpdatePhysics()
 
   // common::Time currTime =  this->world->GetRealTime();
 
+  // Remember where the continuous collision links start
+  this->dataPtr->continuousCollisionStarts.clear();
+  for (const DARTLinkPtr &dartLink : this->dataPtr->dartLinks)
+  {
+    dart::dynamics::BodyNode *bodyNode = dartLink->DARTBodyNode();
+    if (dartLink->ContinuousCollision() &&
+        dynamic_cast<dart::dynamics::FreeJoint *>(
+          bodyNode->getParentJoint()))
+    {
+      this->dataPtr->continuousCollisionStarts.push_back(std::make_pair(
+          dartLink, bodyNode->getTransform().translation()));
+    }
+  }
+
   this->dataPtr->dtWorld->setTimeStep(this->maxStepSize);
   this->dataPtr->dtWorld->step(
         this->dataPtr->resetAllForcesAfterSimulationStep);
 
-  // Update all the transformation of DART's links to gazebo's links
-  // TODO: How to visit all the links in the world?
-  unsigned int modelCount = this->world->ModelCount();
-  ModelPtr modelItr;
+  if (!this->dataPtr->continuousCollisionStarts.empty())
+    this->SweepContinuousCollisionLinks();
 
-  for (unsigned int i = 0; i < modelCount; ++i)
-  {
-    modelItr = this->world->ModelByIndex(i);
-    // TODO: need to improve speed
-    Link_V links = modelItr->GetLinks();
-    unsigned int linkCount = links.size();
-    DARTLinkPtr dartLinkItr;
-
-    for (unsigned int j = 0; j < linkCount; ++j)
-    {
-      dartLinkItr
-          = boost::dynamic_pointer_cast<DARTLink>(links.at(j));
-      dartLinkItr->updateDirtyPoseFromDARTTransformation();
-    }
-  }
+  // Update all the transformation of DART's links to gazebo's links. Links
+  // that did not move are skipped.
+  for (const DARTLinkPtr &dartLink : this->dataPtr->dartLinks)
+    dartLink->updateDirtyPoseFromDARTTransformation();
 
   RetrieveDARTCollisions(
         this,
@@ -700,7 +764,8 @@ bool DARTPhysics::GetParam(const std::string &_key, boost::any &_value) const
   }
   else if (_key == "max_contacts")
   {
-    _value = dartElem->GetElement("max_contacts")->Get<int>();
+    _value = static_cast<int>(this->dataPtr->dtWorld->getConstraintSolver()
+        ->getCollisionOption().maxNumContacts);
   }
   else if (_key == "min_step_size")
   {
@@ -726,9 +791,17 @@ bool DARTPhysics::SetParam(const std::string &_key, const boost::any &_value)
     }
     else if (_key == "max_contacts")
     {
+      // Caps the contacts of each collision check of the constraint solver
       int value = any_cast<int>(_value);
-      gzerr << "Setting [" << _key << "] in DART to [" << value
-            << "] not yet supported.\n";
+      if (value < 0)
+      {
+        gzerr << "Setting [" << _key << "] in DART to [" << value
+              << "] is not allowed, it must be non-negative.\n";
+        return false;
+      }
+      this->sdf->GetElement("max_contacts")->Set(value);
+      this->dataPtr->dtWorld->getConstraintSolver()->getCollisionOption()
+          .maxNumContacts = static_cast<std::size_t>(value);
     }
     else if (_key == "min_step_size")
     {
@@ -889,5 +962,77 @@ void DARTPhysics::OnPhysicsMsg(ConstPhysicsPtr& _msg)
 DARTLinkPtr DARTPhysics::FindDARTLink(
     const dart::dynamics::BodyNode *_dtBodyNode)
 {
-  return StaticFindDARTLink(this, _dtBodyNode);
+  auto iter = this->dataPtr->bodyNodeLinks.find(_dtBodyNode);
+  if (iter == this->dataPtr->bodyNodeLinks.end())
+    return DARTLinkPtr();
+  return iter->second;
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::AddDARTLink(DARTLinkPtr _link)
+{
+  GZ_ASSERT(_link && _link->DARTBodyNode(), "DART link is not initialized");
+  auto inserted = this->dataPtr->bodyNodeLinks.emplace(
+      _link->DARTBodyNode(), _link);
+  if (inserted.second)
+    this->dataPtr->dartLinks.push_back(_link);
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::SweepContinuousCollisionLinks()
+{
+  IGN_PROFILE("DARTPhysics::SweepContinuousCollisionLinks");
+
+  dart::constraint::ConstraintSolver *solver =
+      this->dataPtr->dtWorld->getConstraintSolver();
+  dart::collision::CollisionDetectorPtr detector =
+      solver->getCollisionDetector();
+
+  for (const auto &start : this->dataPtr->continuousCollisionStarts)
+  {
+    dart::dynamics::BodyNode *bodyNode = start.first->DARTBodyNode();
+    const Eigen::Isometry3d end = bodyNode->getTransform();
+    const Eigen::Vector3d motion = end.translation() - start.second;
+
+    // A link that moved by less than half its size can't have skipped a
+    // collision that the step didn't see.
+    const double radius = SweepRadius(start.first);
+    const double distance = motion.norm();
+    if (radius <= 0 || distance <= radius)
+      continue;
+
+    auto group = detector->createCollisionGroup(bodyNode);
+    dart::collision::CollisionOption option(false, 1u,
+        std::make_shared<SweepCollisionFilter>(
+          solver->getCollisionOption().collisionFilter));
+
+    const unsigned int samples = std::min(CCD_MAX_SAMPLES,
+        static_cast<unsigned int>(std::ceil(distance / radius)));
+    bool hit = false;
+    for (unsigned int i = 1; i < samples && !hit; ++i)
+    {
+      Eigen::Isometry3d transform = end;
+      transform.translation() =
+          start.second + motion * (static_cast<double>(i) / samples);
+      SetFreeJointTransform(bodyNode, transform);
+      hit = group->collide(solver->getCollisionGroup().get(), option);
+    }
+
+    // Keep the velocity, the contacts of the next step stop the link
+    if (!hit)
+      SetFreeJointTransform(bodyNode, end);
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::RemoveDARTLink(const DARTLink *_link)
+{
+  auto &links = this->dataPtr->dartLinks;
+  auto iter = std::find_if(links.begin(), links.end(),
+      [_link](const DARTLinkPtr &_l) { return _l.get() == _link; });
+  if (iter == links.end())
+    return;
+
+  this->dataPtr->bodyNodeLinks.erase((*iter)->DARTBodyNode());
+  links.erase(iter);
 }
@@ -159,18 +159,36 @@ namespace gazebo
       /// detector has been loaded yet, the empty string is returned.
       public: std::string CollisionDetectorInUse() const;
 
+      /// \brief Find DART Link corresponding to DART BodyNode.
+      /// \param[in] _dtBodyNode The DART BodyNode.
+      /// \return Pointer to the DART Link, null if the body node does not
+      /// belong to a registered link.
+      public: DARTLinkPtr FindDARTLink(
+          const dart::dynamics::BodyNode *_dtBodyNode);
+
+      /// \brief Register a link whose body node is part of the DART world.
+      /// Registered links are found by their body node when contacts are
+      /// retrieved, and their poses are synced after each step.
+      /// \param[in] _link The initialized DART link.
+      public: void AddDARTLink(DARTLinkPtr _link);
+
+      /// \brief Unregister a link, see AddDARTLink.
+      /// \param[in] _link The link to remove.
+      public: void RemoveDARTLink(const DARTLink *_link);
+
+      /// \brief Conservative advancement of the continuous collision links
+      /// that moved by more than their size during the last step, see
+      /// Link::SetContinuousCollision. Each link is moved back along its
+      /// path to the first position where it overlaps another collision.
+      /// Only links with a free joint are swept.
+      private: void SweepContinuousCollisionLinks();
+
       // Documentation inherited
       protected: virtual void OnRequest(ConstRequestPtr &_msg);
 
       // Documentation inherited
       protected: virtual void OnPhysicsMsg(ConstPhysicsPtr &_msg);
 
-      /// \brief Find DART Link corresponding to DART BodyNode.
-      /// \param[in] _dtBodyNode The DART BodyNode.
-      /// \return Pointer to the DART Link.
-      private: DARTLinkPtr FindDARTLink(
-          const dart::dynamics::BodyNode *_dtBodyNode);
-
       /// \internal
       /// \brief Pointer to private data.
       private: DARTPhysicsPrivate *dataPtr = nullptr;
@@ -18,7 +18,12 @@
 #ifndef _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 #define _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "gazebo/physics/dart/dart_inc.h"
+#include "gazebo/physics/dart/DARTTypes.hh"
 
 namespace gazebo
 {
@@ -50,6 +55,23 @@ namespace gazebo
       /// and torques (both internal and external) after completing a simulation
       /// step. Default value is true.
       public: bool resetAllForcesAfterSimulationStep;
+
+      /// \brief Links registered with DARTPhysics::AddDARTLink, in order of
+      /// registration.
+      public: std::vector<DARTLinkPtr> dartLinks;
+
+      /// \brief Registered links indexed by their body node.
+      public: std::unordered_map<const dart::dynamics::BodyNode *,
+              DARTLinkPtr> bodyNodeLinks;
+
+      /// \brief Collision result of UpdateCollision when physics is
+      /// disabled, kept to reuse its storage.
+      public: dart::collision::CollisionResult collisionResult;
+
+      /// \brief Position of the continuous collision links before the
+      /// current step.
+      public: std::vector<std::pair<DARTLinkPtr, Eigen::Vector3d>>
+              continuousCollisionStarts;
     };
   }
 }
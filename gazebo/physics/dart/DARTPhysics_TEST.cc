@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class DARTPhysics_TEST : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// Test the contact cap
+TEST_F(DARTPhysics_TEST, MaxContacts)
+{
+  Load("worlds/empty.world", true, "dart");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_EQ(physics->GetType(), "dart");
+
+  EXPECT_FALSE(physics->SetParam("max_contacts", -1));
+  EXPECT_TRUE(physics->SetParam("max_contacts", 4));
+  EXPECT_EQ(4, boost::any_cast<int>(physics->GetParam("max_contacts")));
+
+  // A box still rests on the ground with few contacts
+  SpawnBox("box", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 0, 0.5));
+  world->Step(1000);
+
+  ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  EXPECT_NEAR(0.25, box->WorldPose().Pos().Z(), 0.01);
+}
+
+/////////////////////////////////////////////////
+/// Test that the link poses follow DART, and that poses set from gazebo
+/// are kept while the body doesn't move
+TEST_F(DARTPhysics_TEST, LinkPoses)
+{
+  Load("worlds/empty.world", true, "dart");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("falling", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 0, 2));
+  SpawnBox("static", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(2, 0, 0.25), ignition::math::Vector3d::Zero,
+      true);
+
+  ModelPtr falling = world->ModelByName("falling");
+  ASSERT_TRUE(falling != nullptr);
+  ModelPtr staticBox = world->ModelByName("static");
+  ASSERT_TRUE(staticBox != nullptr);
+  LinkPtr link = falling->GetLink("body");
+  ASSERT_TRUE(link != nullptr);
+
+  // The falling box is updated from DART
+  world->Step(100);
+  EXPECT_LT(link->WorldPose().Pos().Z(), 2.0);
+  EXPECT_LT(link->WorldLinearVel().Z(), 0.0);
+
+  // It rests on the ground
+  world->Step(1000);
+  EXPECT_NEAR(0.25, link->WorldPose().Pos().Z(), 0.01);
+
+  // A pose set from gazebo is not overwritten by the old DART transform
+  const ignition::math::Pose3d pose(-2, 1, 0.25, 0, 0, 0.5);
+  falling->SetWorldPose(pose);
+  world->Step(10);
+  EXPECT_NEAR(pose.Pos().X(), link->WorldPose().Pos().X(), 1e-3);
+  EXPECT_NEAR(pose.Pos().Y(), link->WorldPose().Pos().Y(), 1e-3);
+  EXPECT_NEAR(pose.Pos().Z(), link->WorldPose().Pos().Z(), 1e-2);
+  EXPECT_NEAR(pose.Rot().Yaw(), link->WorldPose().Rot().Yaw(), 1e-3);
+
+  // The static box doesn't move
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0.25, 0, 0, 0),
+      staticBox->WorldPose());
+
+  // Stepping after a link is removed is fine
+  world->RemoveModel("falling");
+  world->Step(10);
+  EXPECT_TRUE(world->ModelByName("falling") == nullptr);
+}
+
+/////////////////////////////////////////////////
+/// Test that the contacts of DART are reported with their links
+TEST_F(DARTPhysics_TEST, Contacts)
+{
+  Load("worlds/empty.world", true, "dart");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 0, 0.25));
+  world->Step(10);
+
+  ContactManager *contactManager = world->Physics()->GetContactManager();
+  ASSERT_TRUE(contactManager != nullptr);
+  contactManager->SetNeverDropContacts(true);
+  world->Step(1);
+
+  EXPECT_GT(contactManager->GetContactCount(), 0u);
+  bool boxContact = false;
+  for (auto const &contact : contactManager->GetContacts())
+  {
+    ASSERT_TRUE(contact->collision1 != nullptr);
+    ASSERT_TRUE(contact->collision2 != nullptr);
+    if (contact->collision1->GetLink()->GetModel()->GetName() == "box" ||
+        contact->collision2->GetLink()->GetModel()->GetName() == "box")
+    {
+      boxContact = true;
+    }
+  }
+  EXPECT_TRUE(boxContact);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -19,7 +19,12 @@
  * Date: 13 Feb 2006
  */
 
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -28,10 +33,48 @@
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODELink.hh"
 #include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/World.hh"
+
+/// \internal
+/// \brief Private data for the ODECollision class.
+class gazebo::physics::ODECollisionPrivate
+{
+  /// \brief Convex parts used to generate contacts.
+  public: std::vector<dGeomID> compoundIds;
+
+  /// \brief Position of each convex part in the collision frame.
+  public: std::vector<ignition::math::Vector3d> compoundOffsets;
+
+  /// \brief Index of the filter record of this collision.
+  public: unsigned int filterIndex = std::numeric_limits<unsigned int>::max();
+};
 
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Private data of the ODE collisions, by collision. It is kept
+  /// out of ODECollision so that the layout of the class doesn't change.
+  class ODECollisionPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the collisions.
+    public: static ODECollisionPrivates &Instance()
+    {
+      static ODECollisionPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by collision.
+    public: std::unordered_map<const ODECollision *,
+            std::unique_ptr<ODECollisionPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 ODECollision::ODECollision(LinkPtr _link)
 : Collision(_link)
@@ -40,6 +83,12 @@ ODECollision::ODECollision(LinkPtr _link)
   this->collisionId = nullptr;
   this->onPoseChangeFunc = &ODECollision::OnPoseChangeNull;
 
+  {
+    ODECollisionPrivates &privates = ODECollisionPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new ODECollisionPrivate);
+  }
+
   this->SetSpaceId(
       boost::static_pointer_cast<ODELink>(this->link)->GetSpaceId());
 
@@ -49,11 +98,28 @@ ODECollision::ODECollision(LinkPtr _link)
 //////////////////////////////////////////////////
 ODECollision::~ODECollision()
 {
+  ODECollisionPrivate *data = this->ODECollisionData();
+  for (auto id : data->compoundIds)
+    dGeomDestroy(id);
+  data->compoundIds.clear();
+
   if (this->collisionId)
     dGeomDestroy(this->collisionId);
   this->collisionId = nullptr;
 
   this->Fini();
+
+  ODECollisionPrivates &privates = ODECollisionPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+ODECollisionPrivate *ODECollision::ODECollisionData() const
+{
+  ODECollisionPrivates &privates = ODECollisionPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -151,12 +217,28 @@ int ODECollision::GetCollisionClass() const
   return result;
 }
 
+//////////////////////////////////////////////////
+/// \brief Check whether the bits of a collision also apply to its space.
+/// The space shared by the compact static models keeps its own bits.
+/// \param[in] _collision The collision.
+/// \param[in] _space Space of the collision.
+/// \return True if the space belongs to the model of the collision.
+static bool OwnsSpace(const ODECollision &_collision, dSpaceID _space)
+{
+  if (!_space)
+    return false;
+
+  ODEPhysicsPtr physics = boost::dynamic_pointer_cast<ODEPhysics>(
+      _collision.GetWorld()->Physics());
+  return !physics || physics->StaticSpaceId() != _space;
+}
+
 //////////////////////////////////////////////////
 void ODECollision::SetCategoryBits(unsigned int _bits)
 {
   if (this->collisionId)
     dGeomSetCategoryBits(this->collisionId, _bits);
-  if (this->spaceId)
+  if (OwnsSpace(*this, this->spaceId))
     dGeomSetCategoryBits((dGeomID)this->spaceId, _bits);
 }
 
@@ -165,7 +247,7 @@ void ODECollision::SetCollideBits(unsigned int _bits)
 {
   if (this->collisionId)
     dGeomSetCollideBits(this->collisionId, _bits);
-  if (this->spaceId)
+  if (OwnsSpace(*this, this->spaceId))
     dGeomSetCollideBits((dGeomID)this->spaceId, _bits);
 }
 
@@ -203,6 +285,52 @@ ODESurfaceParamsPtr ODECollision::GetODESurface() const
   return boost::dynamic_pointer_cast<ODESurfaceParams>(this->surface);
 }
 
+/////////////////////////////////////////////////
+void ODECollision::SetCompoundCollisionIds(
+    const std::vector<dGeomID> &_collisionIds,
+    const std::vector<ignition::math::Vector3d> &_offsets)
+{
+  GZ_ASSERT(_collisionIds.size() == _offsets.size(),
+      "Each convex part needs an offset");
+
+  ODECollisionPrivate *data = this->ODECollisionData();
+  for (auto id : data->compoundIds)
+    dGeomDestroy(id);
+
+  data->compoundIds = _collisionIds;
+  data->compoundOffsets = _offsets;
+  for (auto id : data->compoundIds)
+    dGeomSetData(id, this);
+
+  this->UpdateCompoundPoses();
+}
+
+/////////////////////////////////////////////////
+const std::vector<dGeomID> &ODECollision::CompoundCollisionIds() const
+{
+  return this->ODECollisionData()->compoundIds;
+}
+
+/////////////////////////////////////////////////
+void ODECollision::UpdateCompoundPoses()
+{
+  ODECollisionPrivate *data = this->ODECollisionData();
+  if (data->compoundIds.empty() || !this->collisionId)
+    return;
+
+  const dReal *pos = dGeomGetPosition(this->collisionId);
+  const dReal *rot = dGeomGetRotation(this->collisionId);
+  for (size_t i = 0; i < data->compoundIds.size(); ++i)
+  {
+    const ignition::math::Vector3d &offset = data->compoundOffsets[i];
+    dGeomSetPosition(data->compoundIds[i],
+        pos[0] + rot[0]*offset.X() + rot[1]*offset.Y() + rot[2]*offset.Z(),
+        pos[1] + rot[4]*offset.X() + rot[5]*offset.Y() + rot[6]*offset.Z(),
+        pos[2] + rot[8]*offset.X() + rot[9]*offset.Y() + rot[10]*offset.Z());
+    dGeomSetRotation(data->compoundIds[i], rot);
+  }
+}
+
 /////////////////////////////////////////////////
 void ODECollision::OnPoseChangeGlobal()
 {
@@ -260,3 +388,15 @@ void ODECollision::OnPoseChangeRelative()
 void ODECollision::OnPoseChangeNull()
 {
 }
+
+/////////////////////////////////////////////////
+void ODECollision::SetFilterIndex(const unsigned int _index)
+{
+  this->ODECollisionData()->filterIndex = _index;
+}
+
+/////////////////////////////////////////////////
+unsigned int ODECollision::FilterIndex() const
+{
+  return this->ODECollisionData()->filterIndex;
+}
@@ -22,6 +22,10 @@
 #ifndef _ODECOLLISION_HH_
 #define _ODECOLLISION_HH_
 
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
 #include "gazebo/physics/ode/ode_inc.h"
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -33,6 +37,8 @@ namespace gazebo
 {
   namespace physics
   {
+    class ODECollisionPrivate;
+
     /// \addtogroup gazebo_physics_ode
     /// \{
 
@@ -90,6 +96,43 @@ namespace gazebo
       /// \return Dynamically casted pointer to ODESurfaceParams.
       public: ODESurfaceParamsPtr GetODESurface() const;
 
+      /// \brief Set the convex parts used instead of the collision object
+      /// to generate contacts, such as the convex decomposition of a mesh.
+      /// The parts are not in any space and have no body, their poses are
+      /// set by UpdateCompoundPoses.
+      /// \param[in] _collisionIds ODE ids of the parts. This collision
+      /// takes ownership of them.
+      /// \param[in] _offsets Position of each part in the frame of the
+      /// collision object.
+      public: void SetCompoundCollisionIds(
+                  const std::vector<dGeomID> &_collisionIds,
+                  const std::vector<ignition::math::Vector3d> &_offsets);
+
+      /// \brief Get the convex parts of the collision.
+      /// \return ODE ids of the parts, empty if the collision object itself
+      /// is used to generate contacts.
+      public: const std::vector<dGeomID> &CompoundCollisionIds() const;
+
+      /// \brief Move the convex parts to the current pose of the collision
+      /// object.
+      public: void UpdateCompoundPoses();
+
+      /// \internal
+      /// \brief Set the index of the filter record of this collision in
+      /// the collision filter table of ODEPhysics.
+      /// \param[in] _index Index of the record.
+      public: void SetFilterIndex(const unsigned int _index);
+
+      /// \internal
+      /// \brief Get the index of the filter record of this collision.
+      /// \return Index of the record, which may be stale until the table
+      /// is refreshed.
+      public: unsigned int FilterIndex() const;
+
+      /// \brief Get the private data of the collision.
+      /// \return The private data, see ODECollisionPrivate.
+      private: ODECollisionPrivate *ODECollisionData() const;
+
       /// \brief Used when this is static to set the posse.
       private: void OnPoseChangeGlobal();
 
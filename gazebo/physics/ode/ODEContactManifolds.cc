@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+
+#include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEContactManifolds.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Frame of the body of a geom, the world frame for static geoms.
+class BodyFrame
+{
+  /// \brief Constructor.
+  /// \param[in] _geom The geom.
+  public: explicit BodyFrame(dGeomID _geom)
+  {
+    dBodyID body = dGeomGetBody(_geom);
+    if (body)
+    {
+      this->pos = dBodyGetPosition(body);
+      this->rot = dBodyGetRotation(body);
+    }
+  }
+
+  /// \brief Move a world point to the frame.
+  /// \param[in] _v The point.
+  /// \return The point in the frame.
+  public: ignition::math::Vector3d FromWorld(
+              const ignition::math::Vector3d &_v) const
+  {
+    if (!this->rot)
+      return _v;
+    return this->Rotate(_v - this->Position(), true);
+  }
+
+  /// \brief Move a point of the frame to the world frame.
+  /// \param[in] _v The point.
+  /// \return The point in the world frame.
+  public: ignition::math::Vector3d ToWorld(
+              const ignition::math::Vector3d &_v) const
+  {
+    if (!this->rot)
+      return _v;
+    return this->Rotate(_v, false) + this->Position();
+  }
+
+  /// \brief Rotate a vector by the frame rotation or its inverse.
+  /// \param[in] _v The vector.
+  /// \param[in] _inverse True to use the inverse rotation.
+  /// \return The rotated vector.
+  public: ignition::math::Vector3d Rotate(const ignition::math::Vector3d &_v,
+              const bool _inverse) const
+  {
+    if (!this->rot)
+      return _v;
+    ignition::math::Vector3d result;
+    for (int i = 0; i < 3; ++i)
+    {
+      result[i] = _inverse ?
+        this->rot[i] * _v[0] + this->rot[4+i] * _v[1] + this->rot[8+i] * _v[2] :
+        this->rot[i*4] * _v[0] + this->rot[i*4+1] * _v[1] +
+        this->rot[i*4+2] * _v[2];
+    }
+    return result;
+  }
+
+  /// \brief Origin of the frame.
+  /// \return The origin.
+  private: ignition::math::Vector3d Position() const
+  {
+    return ignition::math::Vector3d(this->pos[0], this->pos[1], this->pos[2]);
+  }
+
+  /// \brief Body position, null for the world frame.
+  private: const dReal *pos = nullptr;
+
+  /// \brief Body rotation, null for the world frame.
+  private: const dReal *rot = nullptr;
+};
+
+/// \brief Contact in the world frame.
+class WorldPoint
+{
+  /// \brief Contact position.
+  public: ignition::math::Vector3d pos;
+
+  /// \brief Normal, pointing into the first geom.
+  public: ignition::math::Vector3d normal;
+
+  /// \brief Penetration depth.
+  public: double depth = 0;
+};
+
+//////////////////////////////////////////////////
+/// \brief Choose the contacts of a manifold: the deepest one, then the
+/// contacts that span the largest area.
+/// \param[in] _points Candidate contacts.
+/// \param[in] _minDistance Distance under which two contacts are the same.
+/// \return Indices of the chosen contacts, at most four.
+static std::vector<size_t> ChooseContacts(
+    const std::vector<WorldPoint> &_points, const double _minDistance)
+{
+  std::vector<size_t> chosen;
+  if (_points.empty())
+    return chosen;
+
+  // Deepest contact
+  size_t best = 0;
+  for (size_t i = 1; i < _points.size(); ++i)
+  {
+    if (_points[i].depth > _points[best].depth)
+      best = i;
+  }
+  chosen.push_back(best);
+  const ignition::math::Vector3d &p0 = _points[best].pos;
+
+  // Farthest from the deepest one
+  double bestScore = _minDistance * _minDistance;
+  best = _points.size();
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    const double score = (_points[i].pos - p0).SquaredLength();
+    if (score > bestScore)
+    {
+      bestScore = score;
+      best = i;
+    }
+  }
+  if (best == _points.size())
+    return chosen;
+  chosen.push_back(best);
+  const ignition::math::Vector3d &p1 = _points[best].pos;
+
+  // Largest triangle
+  const ignition::math::Vector3d edge = p1 - p0;
+  bestScore = _minDistance * edge.Length();
+  best = _points.size();
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    const double score = edge.Cross(_points[i].pos - p0).Length();
+    if (score > bestScore)
+    {
+      bestScore = score;
+      best = i;
+    }
+  }
+  if (best == _points.size())
+    return chosen;
+  chosen.push_back(best);
+  const ignition::math::Vector3d &p2 = _points[best].pos;
+
+  // Largest area added to the triangle, by a contact on the outer side of
+  // one of its edges
+  const ignition::math::Vector3d corners[3] = {p0, p1, p2};
+  const ignition::math::Vector3d inner = (p1 - p0).Cross(p2 - p0);
+  bestScore = 0;
+  best = _points.size();
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    for (int e = 0; e < 3; ++e)
+    {
+      const ignition::math::Vector3d &a = corners[e];
+      const ignition::math::Vector3d &b = corners[(e + 1) % 3];
+      const ignition::math::Vector3d side = (b - a).Cross(_points[i].pos - a);
+      const double score = side.Length();
+      if (side.Dot(inner) < 0 && score > _minDistance * (b - a).Length() &&
+          score > bestScore)
+      {
+        bestScore = score;
+        best = i;
+      }
+    }
+  }
+  if (best != _points.size())
+    chosen.push_back(best);
+
+  return chosen;
+}
+
+//////////////////////////////////////////////////
+void ODEContactManifolds::BeginStep()
+{
+  for (auto iter = this->manifolds.begin(); iter != this->manifolds.end();)
+  {
+    if (iter->second.prepared != this->step)
+      iter = this->manifolds.erase(iter);
+    else
+      ++iter;
+  }
+
+  ++this->step;
+}
+
+//////////////////////////////////////////////////
+void ODEContactManifolds::Prepare(ODECollision *_collision1,
+    ODECollision *_collision2)
+{
+  Manifold &manifold = this->manifolds[std::make_pair(_collision1,
+      _collision2)];
+
+  // Start over when the address of a collision was reused
+  boost::shared_ptr<Base> owner1 = manifold.owner1.lock();
+  boost::shared_ptr<Base> owner2 = manifold.owner2.lock();
+  if (owner1.get() != _collision1 || owner2.get() != _collision2)
+  {
+    manifold = Manifold();
+    manifold.owner1 = _collision1->shared_from_this();
+    manifold.owner2 = _collision2->shared_from_this();
+  }
+
+  manifold.prepared = this->step;
+}
+
+//////////////////////////////////////////////////
+unsigned int ODEContactManifolds::Reduce(ODECollision *_collision1,
+    ODECollision *_collision2, dContactGeom *_contacts,
+    const unsigned int _count)
+{
+  const dGeomID id1 = _collision1->GetCollisionId();
+  const dGeomID id2 = _collision2->GetCollisionId();
+  const BodyFrame frame1(id1);
+  const BodyFrame frame2(id2);
+
+  std::vector<WorldPoint> points(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    points[i].pos.Set(_contacts[i].pos[0], _contacts[i].pos[1],
+        _contacts[i].pos[2]);
+    points[i].normal.Set(_contacts[i].normal[0], _contacts[i].normal[1],
+        _contacts[i].normal[2]);
+    points[i].depth = _contacts[i].depth;
+  }
+
+  // Only the map entry of this pair is modified, so that pairs can be
+  // reduced in parallel.
+  auto iter = this->manifolds.find(std::make_pair(_collision1, _collision2));
+  Manifold *manifold = iter != this->manifolds.end() ? &iter->second : nullptr;
+
+  // Move the contacts kept at the last step with the bodies
+  if (manifold && manifold->reduced + 1 == this->step)
+  {
+    for (const Point &kept : manifold->points)
+    {
+      const ignition::math::Vector3d a = frame1.ToWorld(kept.pos1);
+      const ignition::math::Vector3d b = frame2.ToWorld(kept.pos2);
+      WorldPoint point;
+      point.normal = frame1.Rotate(kept.normal, false);
+      point.depth = (b - a).Dot(point.normal);
+      point.pos = (a + b) * 0.5;
+
+      // Separated, or slid too far
+      if (point.depth < 0 ||
+          (b - a - point.normal * point.depth).Length() > this->distance)
+      {
+        continue;
+      }
+
+      // Replaced by a new contact
+      bool replaced = false;
+      for (unsigned int i = 0; i < _count && !replaced; ++i)
+        replaced = points[i].pos.Distance(point.pos) < this->distance;
+
+      if (!replaced)
+        points.push_back(point);
+    }
+  }
+
+  const std::vector<size_t> chosen = ChooseContacts(points, this->distance);
+
+  dContactGeom result[MaxPoints];
+  if (manifold)
+  {
+    manifold->points.clear();
+    manifold->reduced = this->step;
+  }
+  for (size_t i = 0; i < chosen.size(); ++i)
+  {
+    const WorldPoint &point = points[chosen[i]];
+    if (chosen[i] < _count)
+    {
+      result[i] = _contacts[chosen[i]];
+    }
+    else
+    {
+      result[i] = dContactGeom();
+      for (int j = 0; j < 3; ++j)
+      {
+        result[i].pos[j] = point.pos[j];
+        result[i].normal[j] = point.normal[j];
+      }
+      result[i].depth = point.depth;
+      result[i].g1 = id1;
+      result[i].g2 = id2;
+      result[i].side1 = -1;
+      result[i].side2 = -1;
+    }
+
+    if (manifold)
+    {
+      const ignition::math::Vector3d offset =
+        point.normal * (point.depth * 0.5);
+      Point kept;
+      kept.pos1 = frame1.FromWorld(point.pos - offset);
+      kept.pos2 = frame2.FromWorld(point.pos + offset);
+      kept.normal = frame1.Rotate(point.normal, true);
+      manifold->points.push_back(kept);
+    }
+  }
+
+  std::copy(result, result + chosen.size(), _contacts);
+  return static_cast<unsigned int>(chosen.size());
+}
+
+//////////////////////////////////////////////////
+void ODEContactManifolds::SetDistance(const double _distance)
+{
+  this->distance = _distance;
+}
+
+//////////////////////////////////////////////////
+double ODEContactManifolds::Distance() const
+{
+  return this->distance;
+}
+
+//////////////////////////////////////////////////
+size_t ODEContactManifolds::ManifoldCount() const
+{
+  return this->manifolds.size();
+}
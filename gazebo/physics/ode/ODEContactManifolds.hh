@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODECONTACTMANIFOLDS_HH_
+#define GAZEBO_PHYSICS_ODE_ODECONTACTMANIFOLDS_HH_
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class ODECollision;
+
+    /// \internal
+    /// \brief Contact manifolds of the colliding pairs, see the
+    /// "contact_manifold_reduction" parameter of ODEPhysics.
+    ///
+    /// Each pair keeps at most four contacts. The contacts generated by
+    /// the narrow phase are merged with the contacts kept at the previous
+    /// step, moved with the bodies, and reduced to the deepest contact plus
+    /// the three contacts that span the largest area. Kept contacts are
+    /// dropped once they separate, slide more than Distance(), or a new
+    /// contact is generated within Distance() of them.
+    ///
+    /// Prepare must be called serially, after the broadphase and before
+    /// Reduce. Reduce is then safe to call from several threads, for
+    /// different pairs.
+    class ODEContactManifolds
+    {
+      /// \brief Maximum number of contacts of a manifold.
+      public: static const unsigned int MaxPoints = 4;
+
+      /// \brief Start a new step: manifolds of the pairs that weren't
+      /// prepared during the last step are dropped.
+      public: void BeginStep();
+
+      /// \brief Create the manifold of a pair if needed.
+      /// \param[in] _collision1 First collision.
+      /// \param[in] _collision2 Second collision.
+      public: void Prepare(ODECollision *_collision1,
+                  ODECollision *_collision2);
+
+      /// \brief Merge the contacts generated for a pair with its manifold,
+      /// and replace them by the contacts of the manifold.
+      /// \param[in] _collision1 First collision.
+      /// \param[in] _collision2 Second collision.
+      /// \param[in,out] _contacts Contacts, at least MaxPoints.
+      /// \param[in] _count Number of generated contacts, at least 1.
+      /// \return Number of contacts of the manifold, at most MaxPoints.
+      public: unsigned int Reduce(ODECollision *_collision1,
+                  ODECollision *_collision2, dContactGeom *_contacts,
+                  const unsigned int _count);
+
+      /// \brief Set the distance under which two contacts are the same.
+      /// \param[in] _distance Distance in meters.
+      public: void SetDistance(const double _distance);
+
+      /// \brief Get the distance under which two contacts are the same.
+      /// \return Distance in meters. Default is 0.01.
+      public: double Distance() const;
+
+      /// \brief Number of pairs with a manifold.
+      /// \return Number of manifolds.
+      public: size_t ManifoldCount() const;
+
+      /// \brief Contact of a manifold, in the frames of the bodies.
+      private: class Point
+      {
+        /// \brief Deepest point of the first geom, in the first body frame.
+        public: ignition::math::Vector3d pos1;
+
+        /// \brief Deepest point of the second geom, in the second body
+        /// frame.
+        public: ignition::math::Vector3d pos2;
+
+        /// \brief Normal, pointing into the first geom, in the first body
+        /// frame.
+        public: ignition::math::Vector3d normal;
+      };
+
+      /// \brief Manifold of a pair.
+      private: class Manifold
+      {
+        /// \brief First collision, used to detect reused addresses.
+        public: boost::weak_ptr<Base> owner1;
+
+        /// \brief Second collision, used to detect reused addresses.
+        public: boost::weak_ptr<Base> owner2;
+
+        /// \brief Contacts of the last Reduce.
+        public: std::vector<Point> points;
+
+        /// \brief Step of the last Prepare.
+        public: uint64_t prepared = 0;
+
+        /// \brief Step of the last Reduce.
+        public: uint64_t reduced = 0;
+      };
+
+      /// \brief Manifolds indexed by collision pair.
+      private: std::map<std::pair<const ODECollision *, const ODECollision *>,
+               Manifold> manifolds;
+
+      /// \brief Distance under which two contacts are the same.
+      private: double distance = 0.01;
+
+      /// \brief Current step.
+      private: uint64_t step = 0;
+    };
+  }
+}
+#endif
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <vector>
+
+#include <fcl/BVH_model.h>
+#include <fcl/collision.h>
+#include <fcl/geometric_shapes.h>
+
+#include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEFCLCollider.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+/// \brief Get the parameters of a geom that define its FCL object.
+/// \param[in] _geom The geom.
+/// \param[out] _params The parameters.
+/// \return False if FCL doesn't support the geom class.
+static bool GeomParams(dGeomID _geom, std::vector<dReal> &_params)
+{
+  _params.clear();
+  switch (dGeomGetClass(_geom))
+  {
+    case dBoxClass:
+    {
+      dVector3 lengths;
+      dGeomBoxGetLengths(_geom, lengths);
+      _params.assign(lengths, lengths + 3);
+      return true;
+    }
+    case dSphereClass:
+      _params.push_back(dGeomSphereGetRadius(_geom));
+      return true;
+    case dCapsuleClass:
+    {
+      dReal radius, length;
+      dGeomCapsuleGetParams(_geom, &radius, &length);
+      _params = {radius, length};
+      return true;
+    }
+    case dCylinderClass:
+    {
+      dReal radius, length;
+      dGeomCylinderGetParams(_geom, &radius, &length);
+      _params = {radius, length};
+      return true;
+    }
+    case dPlaneClass:
+    {
+      dVector4 plane;
+      dGeomPlaneGetParams(_geom, plane);
+      _params.assign(plane, plane + 4);
+      return true;
+    }
+    case dTriMeshClass:
+      _params.push_back(dGeomTriMeshGetTriangleCount(_geom));
+      return true;
+    default:
+      return false;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Build the FCL object of a geom.
+/// \param[in] _geom The geom.
+/// \param[in] _params Parameters returned by GeomParams.
+/// \return The object.
+static fcl::CollisionObject *CreateObject(dGeomID _geom,
+    const std::vector<dReal> &_params)
+{
+  switch (dGeomGetClass(_geom))
+  {
+    case dBoxClass:
+      return new fcl::Box(_params[0], _params[1], _params[2]);
+    case dSphereClass:
+      return new fcl::Sphere(_params[0]);
+    case dCapsuleClass:
+      return new fcl::Capsule(_params[0], _params[1]);
+    case dCylinderClass:
+      return new fcl::Cylinder(_params[0], _params[1]);
+    case dPlaneClass:
+      return new fcl::Plane(_params[0], _params[1], _params[2], _params[3]);
+    case dTriMeshClass:
+    {
+      // ODE only gives the triangles in the world frame, so they are moved
+      // back to the frame of the geom.
+      const dReal *pos = dGeomGetPosition(_geom);
+      const dReal *rot = dGeomGetRotation(_geom);
+      const int count = dGeomTriMeshGetTriangleCount(_geom);
+
+      std::vector<fcl::Vec3f> points;
+      std::vector<fcl::Triangle> triangles;
+      points.reserve(count * 3);
+      triangles.reserve(count);
+      for (int i = 0; i < count; ++i)
+      {
+        dVector3 v[3];
+        dGeomTriMeshGetTriangle(_geom, i, &v[0], &v[1], &v[2]);
+        for (int j = 0; j < 3; ++j)
+        {
+          const dReal x = v[j][0] - pos[0];
+          const dReal y = v[j][1] - pos[1];
+          const dReal z = v[j][2] - pos[2];
+          points.push_back(fcl::Vec3f(
+                rot[0]*x + rot[4]*y + rot[8]*z,
+                rot[1]*x + rot[5]*y + rot[9]*z,
+                rot[2]*x + rot[6]*y + rot[10]*z));
+        }
+        triangles.push_back(fcl::Triangle(i*3, i*3+1, i*3+2));
+      }
+
+      fcl::BVHModel<fcl::OBB> *model = new fcl::BVHModel<fcl::OBB>();
+      model->beginModel(triangles.size(), points.size());
+      model->addSubModel(points, triangles);
+      model->endModel();
+      return model;
+    }
+    default:
+      return nullptr;
+  }
+}
+
+//////////////////////////////////////////////////
+ODEFCLCollider::ODEFCLCollider()
+{
+}
+
+//////////////////////////////////////////////////
+ODEFCLCollider::~ODEFCLCollider()
+{
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::BeginStep()
+{
+  ++this->step;
+
+  for (auto iter = this->objects.begin(); iter != this->objects.end();)
+  {
+    if (iter->second.owner.expired())
+      iter = this->objects.erase(iter);
+    else
+      ++iter;
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::Update(ODECollision *_collision)
+{
+  Object &entry = this->objects[_collision];
+  if (entry.step == this->step && entry.step != 0)
+    return;
+  entry.step = this->step;
+
+  dGeomID geom = _collision->GetCollisionId();
+  if (!geom)
+  {
+    entry.object.reset();
+    return;
+  }
+
+  // Rebuild the object when the collision is new, its address was reused,
+  // or its geom changed.
+  std::vector<dReal> params;
+  const bool supported = GeomParams(geom, params);
+  const dTriMeshDataID meshData = dGeomGetClass(geom) == dTriMeshClass ?
+    dGeomTriMeshGetTriMeshDataID(geom) : nullptr;
+  boost::shared_ptr<Base> owner = entry.owner.lock();
+  if (owner.get() != _collision || entry.geom != geom ||
+      entry.params != params || entry.meshData != meshData)
+  {
+    entry.owner = _collision->shared_from_this();
+    entry.geom = geom;
+    entry.params = params;
+    entry.meshData = meshData;
+    entry.object.reset(supported ? CreateObject(geom, params) : nullptr);
+    if (entry.object)
+      entry.object->computeLocalAABB();
+  }
+
+  if (!entry.object)
+    return;
+
+  // Planes are not placeable, their parameters are in the world frame
+  if (dGeomGetClass(geom) != dPlaneClass)
+  {
+    const dReal *pos = dGeomGetPosition(geom);
+    const dReal *rot = dGeomGetRotation(geom);
+    const fcl::Vec3f R[3] = {
+      fcl::Vec3f(rot[0], rot[1], rot[2]),
+      fcl::Vec3f(rot[4], rot[5], rot[6]),
+      fcl::Vec3f(rot[8], rot[9], rot[10])};
+    entry.object->setTransform(R, fcl::Vec3f(pos[0], pos[1], pos[2]));
+  }
+  entry.object->computeAABB();
+}
+
+//////////////////////////////////////////////////
+bool ODEFCLCollider::Collide(ODECollision *_collision1,
+    ODECollision *_collision2, const unsigned int _maxContacts,
+    dContactGeom *_contacts, unsigned int &_count) const
+{
+  _count = 0;
+
+  auto iter1 = this->objects.find(_collision1);
+  auto iter2 = this->objects.find(_collision2);
+  if (iter1 == this->objects.end() || iter2 == this->objects.end() ||
+      !iter1->second.object || !iter2->second.object ||
+      iter1->second.step != this->step || iter2->second.step != this->step)
+  {
+    return false;
+  }
+
+  std::vector<fcl::Contact> contacts;
+  const int count = fcl::collide(iter1->second.object.get(),
+      iter2->second.object.get(), _maxContacts, false, true, contacts);
+  for (int i = 0; i < count && _count < _maxContacts; ++i)
+  {
+    const fcl::Contact &contact = contacts[i];
+    dContactGeom &geom = _contacts[_count++];
+    geom.pos[0] = contact.pos[0];
+    geom.pos[1] = contact.pos[1];
+    geom.pos[2] = contact.pos[2];
+    geom.normal[0] = contact.normal[0];
+    geom.normal[1] = contact.normal[1];
+    geom.normal[2] = contact.normal[2];
+    geom.depth = contact.penetration_depth;
+    geom.g1 = _collision1->GetCollisionId();
+    geom.g2 = _collision2->GetCollisionId();
+    geom.side1 = -1;
+    geom.side2 = -1;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t ODEFCLCollider::ObjectCount() const
+{
+  return this->objects.size();
+}
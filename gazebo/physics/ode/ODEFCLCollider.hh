@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODEFCLCOLLIDER_HH_
+#define GAZEBO_PHYSICS_ODE_ODEFCLCOLLIDER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace fcl
+{
+  class CollisionObject;
+}
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class ODECollision;
+
+    /// \internal
+    /// \brief Narrow phase that generates the contacts of ODE collisions
+    /// with the FCL library in deps/fcl, see the "narrow_phase" parameter
+    /// of ODEPhysics.
+    ///
+    /// Boxes, spheres, capsules, cylinders, planes and triangle meshes are
+    /// supported. Each collision gets an FCL object, built on first use and
+    /// kept across steps: meshes keep their OBB hierarchy, and only the
+    /// transforms are refreshed. Pairs with any other geom class are left
+    /// to ODE.
+    ///
+    /// Update must be called serially, after the broadphase and before
+    /// Collide. Collide is then safe to call from several threads.
+    class ODEFCLCollider
+    {
+      /// \brief Constructor.
+      public: ODEFCLCollider();
+
+      /// \brief Destructor.
+      public: ~ODEFCLCollider();
+
+      /// \brief Start a new step: the objects of deleted collisions are
+      /// dropped, and transforms are refreshed on the next Update.
+      public: void BeginStep();
+
+      /// \brief Create the FCL object of a collision if needed, and refresh
+      /// its transform once per step.
+      /// \param[in] _collision The collision.
+      public: void Update(ODECollision *_collision);
+
+      /// \brief Generate the contacts of a pair of collisions.
+      /// \param[in] _collision1 First collision.
+      /// \param[in] _collision2 Second collision.
+      /// \param[in] _maxContacts Maximum number of contacts.
+      /// \param[out] _contacts Array of at least _maxContacts contacts.
+      /// \param[out] _count Number of contacts.
+      /// \return False if FCL doesn't handle the pair, in which case ODE
+      /// must generate the contacts.
+      public: bool Collide(ODECollision *_collision1,
+                  ODECollision *_collision2, const unsigned int _maxContacts,
+                  dContactGeom *_contacts, unsigned int &_count) const;
+
+      /// \brief Number of collisions with an FCL object.
+      /// \return Number of objects.
+      public: size_t ObjectCount() const;
+
+      /// \brief FCL object of a collision.
+      private: class Object
+      {
+        /// \brief The collision, used to detect reused addresses.
+        public: boost::weak_ptr<Base> owner;
+
+        /// \brief ODE geom the object was built from.
+        public: dGeomID geom = nullptr;
+
+        /// \brief Parameters of the geom the object was built from.
+        public: std::vector<dReal> params;
+
+        /// \brief Triangle mesh data the object was built from.
+        public: dTriMeshDataID meshData = nullptr;
+
+        /// \brief The FCL object, null if the geom class isn't supported.
+        public: std::unique_ptr<fcl::CollisionObject> object;
+
+        /// \brief Step of the last transform update.
+        public: uint64_t step = 0;
+      };
+
+      /// \brief Objects indexed by collision.
+      private: std::unordered_map<const ODECollision *, Object> objects;
+
+      /// \brief Current step.
+      private: uint64_t step = 0;
+    };
+  }
+}
+#endif
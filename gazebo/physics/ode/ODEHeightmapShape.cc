@@ -26,6 +26,7 @@ ODEHeightmapShape::ODEHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
   this->flipY = false;
+  this->SetTilePagingSupported(true);
 }
 
 //////////////////////////////////////////////////
@@ -40,6 +41,19 @@ dReal ODEHeightmapShape::GetHeightCallback(void *_data, int _x, int _y)
   return static_cast<ODEHeightmapShape*>(_data)->GetHeight(_x, _y);
 }
 
+//////////////////////////////////////////////////
+void ODEHeightmapShape::GetRangeCallback(void *_data, int _minX, int _maxX,
+    int _minY, int _maxY, dReal *_minHeight, dReal *_maxHeight)
+{
+  HeightType minHeight, maxHeight;
+  if (static_cast<ODEHeightmapShape*>(_data)->Pyramid().Range(
+        _minX, _minY, _maxX, _maxY, minHeight, maxHeight))
+  {
+    *_minHeight = minHeight;
+    *_maxHeight = maxHeight;
+  }
+}
+
 
 //////////////////////////////////////////////////
 // creates the ODE height field. Only enabled if the height data type is float.
@@ -110,19 +124,42 @@ void ODEHeightmapShape::Init()
 
 
   // Step 3: Setup a callback method for ODE
-  setOdeHeightfieldDetails(
-      this->odeData,
-      this->heights.data(),
-      // in meters
-      this->Size().X(),
-      // in meters
-      this->Size().Y(),
-      // number of vertices
-      this->vertSize,
-      // vertical (z-axis) offset
-      this->Pos().Z(),
-      // vertical thickness for closing the height map mesh
-      1.0);
+  if (this->Pyramid().Paged())
+  {
+    // The heights are paged from disk, ODE reads them through GetHeight
+    dGeomHeightfieldDataBuildCallback(
+        this->odeData,
+        this,
+        &ODEHeightmapShape::GetHeightCallback,
+        this->Size().X(),
+        this->Size().Y(),
+        this->vertSize,
+        this->vertSize,
+        1.0,
+        this->Pos().Z(),
+        1.0,
+        0);
+  }
+  else
+  {
+    setOdeHeightfieldDetails(
+        this->odeData,
+        this->heights.data(),
+        // in meters
+        this->Size().X(),
+        // in meters
+        this->Size().Y(),
+        // number of vertices
+        this->vertSize,
+        // vertical (z-axis) offset
+        this->Pos().Z(),
+        // vertical thickness for closing the height map mesh
+        1.0);
+  }
+
+  // Let ODE skip the cells under a geom that is above all of them
+  dGeomHeightfieldDataSetRangeCallback(this->odeData, this,
+      &ODEHeightmapShape::GetRangeCallback);
 
   // Step 4: Restrict the bounds of the AABB to improve efficiency
   dGeomHeightfieldDataSetBounds(this->odeData, this->GetMinHeight(),
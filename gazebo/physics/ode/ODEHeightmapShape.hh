@@ -50,6 +50,18 @@ namespace gazebo
       /// \param[in] _y Y location.
       private: static dReal GetHeightCallback(void *_data, int _x, int _y);
 
+      /// \brief Called by ODE to bound the heights of a zone of vertices.
+      /// \param[in] _data Pointer to the heightmap data.
+      /// \param[in] _minX First X location.
+      /// \param[in] _maxX Last X location.
+      /// \param[in] _minY First Y location.
+      /// \param[in] _maxY Last Y location.
+      /// \param[out] _minHeight Lower bound of the heights.
+      /// \param[out] _maxHeight Upper bound of the heights.
+      private: static void GetRangeCallback(void *_data, int _minX,
+                   int _maxX, int _minY, int _maxY, dReal *_minHeight,
+                   dReal *_maxHeight);
+
       /// \brief The heightmap data.
       private: dHeightfieldDataID odeData;
     };
@@ -1082,6 +1082,12 @@ void ODEJoint::SetStiffnessDamping(unsigned int _index,
     gzerr << "SetStiffnessDamping _index too large.\n";
 }
 
+//////////////////////////////////////////////////
+dJointID ODEJoint::GetODEId() const
+{
+  return this->jointId;
+}
+
 //////////////////////////////////////////////////
 void ODEJoint::SetProvideFeedback(bool _enable)
 {
@@ -238,6 +238,10 @@ namespace gazebo
       public: virtual double GetParam(const std::string &_key,
                                                 unsigned int _index) override;
 
+      /// \brief Get the ODE id of this joint.
+      /// \return ODE joint id.
+      public: dJointID GetODEId() const;
+
       // Documentation inherited.
       public: virtual void SetProvideFeedback(bool _enable) override;
 
@@ -38,6 +38,12 @@ ODELink::ODELink(EntityPtr _parent)
     : Link(_parent)
 {
   this->linkId = nullptr;
+
+  this->SetContinuousCollisionFunction([this](const bool _enable)
+      {
+        if (this->odePhysics)
+          this->odePhysics->SetContinuousCollisionLink(this, _enable);
+      });
 }
 
 //////////////////////////////////////////////////
@@ -181,6 +187,8 @@ void ODELink::Fini()
     dBodyDestroy(this->linkId);
   this->linkId = nullptr;
 
+  if (this->odePhysics)
+    this->odePhysics->SetContinuousCollisionLink(this, false);
   this->odePhysics.reset();
 
   Link::Fini();
@@ -14,23 +14,102 @@
  * limitations under the License.
  *
 */
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "gazebo/common/Mesh.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryAccounting.hh"
 
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODEMesh.hh"
 
+/// \internal
+/// \brief Private data for the ODEMesh class.
+class gazebo::physics::ODEMeshPrivate
+{
+  /// \brief Face planes of each convex part, four values per face.
+  public: std::vector<std::vector<dReal>> hullPlanes;
+
+  /// \brief Vertices of each convex part, three values per vertex.
+  public: std::vector<std::vector<dReal>> hullPoints;
+
+  /// \brief Faces of each convex part, a vertex count followed by the
+  /// vertex indices for each face.
+  public: std::vector<std::vector<unsigned int>> hullPolygons;
+
+  /// \brief Memory of the vertex, index and convex part arrays.
+  public: common::MemoryAccounting::Account memory{
+              common::MemoryAccounting::PHYSICS_MESHES};
+};
+
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Private data of the ODE meshes, by mesh. It is kept out of
+  /// ODEMesh so that the layout of the class doesn't change.
+  class ODEMeshPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the meshes.
+    public: static ODEMeshPrivates &Instance()
+    {
+      static ODEMeshPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by mesh.
+    public: std::unordered_map<const ODEMesh *,
+            std::unique_ptr<ODEMeshPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
+//////////////////////////////////////////////////
+/// \brief Check if meshes of a collision use their convex decomposition.
+/// \param[in] _collision The collision.
+/// \return Value of the mesh_convex_decomposition physics parameter.
+static bool ConvexDecompositionEnabled(ODECollisionPtr _collision)
+{
+  WorldPtr world = _collision->GetWorld();
+  if (!world || !world->Physics())
+    return false;
+
+  boost::any value;
+  if (!world->Physics()->GetParam("mesh_convex_decomposition", value))
+    return false;
+
+  try
+  {
+    return boost::any_cast<bool>(value);
+  }
+  catch(boost::bad_any_cast &)
+  {
+    return false;
+  }
+}
+
 //////////////////////////////////////////////////
 ODEMesh::ODEMesh()
 {
   this->odeData = nullptr;
   this->vertices = nullptr;
   this->indices = nullptr;
+
+  ODEMeshPrivates &privates = ODEMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new ODEMeshPrivate);
 }
 
 //////////////////////////////////////////////////
@@ -39,11 +118,26 @@ ODEMesh::~ODEMesh()
   delete [] this->vertices;
   delete [] this->indices;
   dGeomTriMeshDataDestroy(this->odeData);
+
+  ODEMeshPrivates &privates = ODEMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+ODEMeshPrivate *ODEMesh::ODEMeshData() const
+{
+  ODEMeshPrivates &privates = ODEMeshPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
 void ODEMesh::Update()
 {
+  if (!this->odeData)
+    return;
+
   /// FIXME: use below to update trimesh geometry for collision without
   // using above Ogre codes
   // tell the tri-tri collider the current transform of the trimesh --
@@ -92,12 +186,25 @@ void ODEMesh::Init(const common::SubMesh *_subMesh, ODECollisionPtr _collision,
   this->vertices = nullptr;
   this->indices = nullptr;
 
-  // Get all the vertex and index data
-  _subMesh->FillArrays(&this->vertices, &this->indices);
-
   this->collisionId = _collision->GetCollisionId();
 
-  this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  if (_subMesh->IsCompact())
+    this->CreateMesh(_subMesh, _collision, _scale);
+  else
+  {
+    // Get all the vertex and index data
+    _subMesh->FillArrays(&this->vertices, &this->indices);
+    this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  }
+
+  if (ConvexDecompositionEnabled(_collision))
+  {
+    this->CreateHulls(
+        common::ConvexDecomposition::Instance()->Decompose(_subMesh),
+        _collision, _scale);
+  }
+
+  this->CountMemory(numVertices, numIndices, _collision);
 }
 
 //////////////////////////////////////////////////
@@ -113,21 +220,63 @@ void ODEMesh::Init(const common::Mesh *_mesh, ODECollisionPtr _collision,
   this->vertices = nullptr;
   this->indices = nullptr;
 
-  // Get all the vertex and index data
-  _mesh->FillArrays(&this->vertices, &this->indices);
-
   this->collisionId = _collision->GetCollisionId();
-  this->CreateMesh(numVertices, numIndices, _collision, _scale);
+
+  // A mesh with a single compact submesh is used without copying it
+  if (_mesh->GetSubMeshCount() == 1 && _mesh->GetSubMesh(0)->IsCompact() &&
+      _mesh->GetSubMesh(0)->GetVertexCount() > 2)
+  {
+    this->CreateMesh(_mesh->GetSubMesh(0), _collision, _scale);
+  }
+  else
+  {
+    // Get all the vertex and index data
+    _mesh->FillArrays(&this->vertices, &this->indices);
+    this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  }
+
+  if (ConvexDecompositionEnabled(_collision))
+  {
+    this->CreateHulls(
+        common::ConvexDecomposition::Instance()->Decompose(_mesh),
+        _collision, _scale);
+  }
+
+  this->CountMemory(numVertices, numIndices, _collision);
+}
+
+//////////////////////////////////////////////////
+void ODEMesh::CountMemory(unsigned int _numVertices,
+    unsigned int _numIndices, ODECollisionPtr _collision)
+{
+  if (!common::MemoryAccounting::Enabled())
+    return;
+
+  // Compact submeshes are used in place, and counted with the meshes
+  int64_t bytes = 0;
+  if (this->vertices)
+    bytes += _numVertices * 3 * sizeof(this->vertices[0]);
+  if (this->indices)
+    bytes += _numIndices * sizeof(this->indices[0]);
+
+  ODEMeshPrivate *data = this->ODEMeshData();
+  for (size_t h = 0; h < data->hullPlanes.size(); ++h)
+  {
+    bytes += data->hullPlanes[h].capacity() * sizeof(dReal) +
+      data->hullPoints[h].capacity() * sizeof(dReal) +
+      data->hullPolygons[h].capacity() * sizeof(unsigned int);
+  }
+
+  ModelPtr model = _collision->GetParentModel();
+  if (model)
+    data->memory.SetOwner(model->GetScopedName());
+  data->memory.Set(bytes);
 }
 
 //////////////////////////////////////////////////
 void ODEMesh::CreateMesh(unsigned int _numVertices, unsigned int _numIndices,
     ODECollisionPtr _collision, const ignition::math::Vector3d &_scale)
 {
-  /// This will hold the vertex data of the triangle mesh
-  if (this->odeData == nullptr)
-    this->odeData = dGeomTriMeshDataCreate();
-
   // Scale the vertex data
   for (unsigned int j = 0;  j < _numVertices; j++)
   {
@@ -136,10 +285,63 @@ void ODEMesh::CreateMesh(unsigned int _numVertices, unsigned int _numIndices,
     this->vertices[j*3+2] = this->vertices[j*3+2] * _scale.Z();
   }
 
+  this->BuildMesh(this->vertices, 3*sizeof(this->vertices[0]), _numVertices,
+      this->indices, _numIndices, _collision);
+}
+
+//////////////////////////////////////////////////
+void ODEMesh::CreateMesh(const common::SubMesh *_subMesh,
+    ODECollisionPtr _collision, const ignition::math::Vector3d &_scale)
+{
+  const unsigned int numVertices = _subMesh->GetVertexCount();
+  const unsigned int numIndices = _subMesh->GetIndexCount();
+  const unsigned int stride = _subMesh->VertexStride();
+
+  // ODE reads the positions of the interleaved vertex buffer through the
+  // vertex stride. Only scaled meshes need their own copy.
+  const float *vertexData = _subMesh->VertexBuffer();
+  int vertexStride = stride * sizeof(float);
+  if (_scale != ignition::math::Vector3d::One)
+  {
+    this->vertices = new float[numVertices * 3];
+    for (unsigned int j = 0; j < numVertices; ++j)
+    {
+      this->vertices[j*3+0] = vertexData[j*stride+0] * _scale.X();
+      this->vertices[j*3+1] = vertexData[j*stride+1] * _scale.Y();
+      this->vertices[j*3+2] = vertexData[j*stride+2] * _scale.Z();
+    }
+    vertexData = this->vertices;
+    vertexStride = 3*sizeof(this->vertices[0]);
+  }
+
+  // 16 bit indices are widened to the index type of ODE
+  const void *indexData = _subMesh->IndexBuffer();
+  if (_subMesh->IndexSize() != sizeof(this->indices[0]))
+  {
+    const uint16_t *indices16 = static_cast<const uint16_t *>(indexData);
+    this->indices = new int[numIndices];
+    for (unsigned int j = 0; j < numIndices; ++j)
+      this->indices[j] = indices16[j];
+    indexData = this->indices;
+  }
+
+  this->BuildMesh(vertexData, vertexStride, numVertices, indexData,
+      numIndices, _collision);
+}
+
+//////////////////////////////////////////////////
+void ODEMesh::BuildMesh(const float *_vertices, int _vertexStride,
+    unsigned int _numVertices, const void *_indices,
+    unsigned int _numIndices, ODECollisionPtr _collision)
+{
+  /// This will hold the vertex data of the triangle mesh
+  if (this->odeData == nullptr)
+    this->odeData = dGeomTriMeshDataCreate();
+
   // Build the ODE triangle mesh
   dGeomTriMeshDataBuildSingle(this->odeData,
-      this->vertices, 3*sizeof(this->vertices[0]), _numVertices,
-      this->indices, _numIndices, 3*sizeof(this->indices[0]));
+      _vertices, _vertexStride, _numVertices,
+      _indices, _numIndices, 3*sizeof(this->indices[0]));
 
   if (_collision->GetCollisionId() == nullptr)
   {
@@ -155,3 +357,83 @@ void ODEMesh::CreateMesh(unsigned int _numVertices, unsigned int _numIndices,
   memset(this->transform, 0, 32*sizeof(dReal));
   this->transformIndex = 0;
 }
+
+//////////////////////////////////////////////////
+void ODEMesh::CreateHulls(const common::ConvexHull_V &_hulls,
+    ODECollisionPtr _collision, const ignition::math::Vector3d &_scale)
+{
+  if (_hulls.empty())
+    return;
+
+  // A negative scale mirrors the hulls and flips their faces
+  const bool mirrored = _scale.X() * _scale.Y() * _scale.Z() < 0;
+
+  ODEMeshPrivate *data = this->ODEMeshData();
+  data->hullPlanes.assign(_hulls.size(), std::vector<dReal>());
+  data->hullPoints.assign(_hulls.size(), std::vector<dReal>());
+  data->hullPolygons.assign(_hulls.size(), std::vector<unsigned int>());
+
+  std::vector<dGeomID> ids;
+  std::vector<ignition::math::Vector3d> offsets;
+  for (size_t h = 0; h < _hulls.size(); ++h)
+  {
+    const common::ConvexHull &hull = _hulls[h];
+
+    // ODE expects the origin of a convex geom to be inside of it, so each
+    // hull is centered and placed at an offset.
+    std::vector<ignition::math::Vector3d> points;
+    points.reserve(hull.vertices.size());
+    ignition::math::Vector3d center;
+    for (const auto &v : hull.vertices)
+    {
+      points.push_back(v * _scale);
+      center += points.back();
+    }
+    center /= static_cast<double>(points.size());
+
+    std::vector<dReal> &hullPts = data->hullPoints[h];
+    for (auto &p : points)
+    {
+      p -= center;
+      hullPts.push_back(p.X());
+      hullPts.push_back(p.Y());
+      hullPts.push_back(p.Z());
+    }
+
+    std::vector<dReal> &planes = data->hullPlanes[h];
+    std::vector<unsigned int> &polygons = data->hullPolygons[h];
+    for (size_t i = 0; i + 2 < hull.indices.size(); i += 3)
+    {
+      unsigned int a = hull.indices[i];
+      unsigned int b = hull.indices[i+1];
+      unsigned int c = hull.indices[i+2];
+      if (mirrored)
+        std::swap(b, c);
+
+      ignition::math::Vector3d normal =
+        (points[b] - points[a]).Cross(points[c] - points[a]);
+      const double length = normal.Length();
+      if (length <= 0)
+        continue;
+      normal /= length;
+
+      planes.push_back(normal.X());
+      planes.push_back(normal.Y());
+      planes.push_back(normal.Z());
+      planes.push_back(normal.Dot(points[a]));
+      polygons.push_back(3);
+      polygons.push_back(a);
+      polygons.push_back(b);
+      polygons.push_back(c);
+    }
+
+    if (planes.size() < 16)
+      continue;
+
+    ids.push_back(dCreateConvex(0, planes.data(), planes.size() / 4,
+          hullPts.data(), points.size(), polygons.data()));
+    offsets.push_back(center);
+  }
+
+  _collision->SetCompoundCollisionIds(ids, offsets);
+}
@@ -20,6 +20,7 @@
 
 #include <ignition/math/Vector3.hh>
 
+#include "gazebo/common/ConvexDecomposition.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 #include "gazebo/physics/ode/ode_inc.h"
 #include "gazebo/physics/MeshShape.hh"
@@ -29,10 +30,18 @@ namespace gazebo
 {
   namespace physics
   {
+    class ODEMeshPrivate;
+
     /// \addtogroup gazebo_physics_ode
     /// \{
 
     /// \brief Triangle mesh helper class.
+    ///
+    /// If the mesh_convex_decomposition parameter of the physics engine is
+    /// true when the mesh is initialized, the convex decomposition of the
+    /// mesh is used to generate contacts, see ODECollision::
+    /// SetCompoundCollisionIds. The triangle mesh is still used for the
+    /// broadphase, for rays, and against other triangle meshes.
     class GZ_PHYSICS_VISIBLE ODEMesh
     {
       /// \brief Constructor.
@@ -68,16 +77,60 @@ namespace gazebo
                    unsigned int _numIndices, ODECollisionPtr _collision,
                    const ignition::math::Vector3d &_scale);
 
+      /// \brief Helper function to create the collision shape from the
+      /// buffers of a compact submesh, which ODE reads without copying
+      /// them when the mesh is not scaled.
+      /// \param[in] _subMesh Compact submesh.
+      /// \param[in] _collision Pointer to the collision object.
+      /// \param[in] _scale Scaling factor.
+      private: void CreateMesh(const common::SubMesh *_subMesh,
+                   ODECollisionPtr _collision,
+                   const ignition::math::Vector3d &_scale);
+
+      /// \brief Build the ODE trimesh data and attach it to the collision.
+      /// \param[in] _vertices Vertex positions.
+      /// \param[in] _vertexStride Bytes between two vertex positions.
+      /// \param[in] _numVertices Number of vertices.
+      /// \param[in] _indices Vertex indices, three per triangle.
+      /// \param[in] _numIndices Number of indices.
+      /// \param[in] _collision Pointer to the collision object.
+      private: void BuildMesh(const float *_vertices, int _vertexStride,
+                   unsigned int _numVertices, const void *_indices,
+                   unsigned int _numIndices, ODECollisionPtr _collision);
+
+      /// \brief Helper function to create the convex parts of the
+      /// collision.
+      /// \param[in] _hulls Convex decomposition of the mesh.
+      /// \param[in] _collision Pointer to the collision object.
+      /// \param[in] _scale Scaling factor.
+      private: void CreateHulls(const common::ConvexHull_V &_hulls,
+                   ODECollisionPtr _collision,
+                   const ignition::math::Vector3d &_scale);
+
+      /// \brief Get the private data of the mesh.
+      /// \return The private data, see ODEMeshPrivate.
+      private: ODEMeshPrivate *ODEMeshData() const;
+
+      /// \brief Count the memory of the arrays owned by the mesh, for the
+      /// model of the collision.
+      /// \param[in] _numVertices Number of vertices.
+      /// \param[in] _numIndices Number of indices.
+      /// \param[in] _collision Pointer to the collision object.
+      private: void CountMemory(unsigned int _numVertices,
+                   unsigned int _numIndices, ODECollisionPtr _collision);
+
       /// \brief Transform matrix.
       private: dReal transform[16*2];
 
       /// \brief Transform matrix index.
       private: int transformIndex;
 
-      /// \brief Array of vertex values.
+      /// \brief Array of vertex values, nullptr when ODE uses the vertex
+      /// buffer of a compact submesh.
       private: float *vertices;
 
-      /// \brief Array of index values.
+      /// \brief Array of index values, nullptr when ODE uses the index
+      /// buffer of a compact submesh.
       private: int *indices;
 
       /// \brief ODE trimesh data.
@@ -21,14 +21,17 @@
 #include <sdf/sdf.hh>
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3.hh>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/util/Diagnostics.hh"
 #include "gazebo/common/Assert.hh"
@@ -75,55 +78,132 @@
 
 #include "gazebo/physics/ode/ODEPhysicsPrivate.hh"
 
+#ifdef HAVE_PARALLEL_QUICKSTEP
+#include <parallel_quickstep/parallel_quickstep.h>
+#endif
+
 using namespace gazebo;
 using namespace physics;
 
+const unsigned int ODEPhysics::MaxCollisionGroups;
+
 GZ_REGISTER_PHYSICS_ENGINE("ode", ODEPhysics)
 
-/*
-class ContactUpdate_TBB
+/// \brief Number of colliders below which the parallel narrow phase is
+/// not worth the task overhead.
+static const unsigned int MIN_PARALLEL_COLLIDERS = 64;
+
+/// \brief Minimum cosine of the angle between the normals of two matching
+/// contacts when warm starting.
+static const double WARM_START_MIN_NORMAL_DOT = 0.95;
+
+/// \brief Maximum number of positions tested along the path of a
+/// continuous collision link during a step.
+static const unsigned int CCD_MAX_SAMPLES = 64;
+
+/// \brief State of the overlap test of a swept body.
+class SweepData
 {
-  public: ContactUpdate_TBB(tbb::concurrent_vector<ContactFeedback> *_contacts)
-          : contacts(contacts) {}
-  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  /// \brief The swept body.
+  public: dBodyID body = nullptr;
+
+  /// \brief True once the body overlaps another geom.
+  public: bool hit = false;
+};
+
+/////////////////////////////////////////////////
+/// \brief dSpaceCollide2 callback of the overlap test of a swept body.
+/// \param[in] _data The SweepData.
+/// \param[in] _o1 First geom or space.
+/// \param[in] _o2 Second geom or space.
+static void SweepCallback(void *_data, dGeomID _o1, dGeomID _o2)
+{
+  SweepData *data = static_cast<SweepData *>(_data);
+  if (data->hit)
+    return;
+
+  if (dGeomIsSpace(_o1) || dGeomIsSpace(_o2))
   {
-    for (size_t i = _r.begin(); i != _r.end(); i++)
-    {
-      this->engine->ProcessContactFeedback((*this->contacts)[i]);
-    }
+    dSpaceCollide2(_o1, _o2, _data, &SweepCallback);
+    return;
   }
 
-  private: tbb::concurrent_vector<ContactFeedback> *contacts;
-  private: ODEPhysics *engine;
-};
-*/
+  // Skip the pairs that the collision space never reports: geoms of the
+  // same space, such as the links of a model without self collision, and
+  // bodies connected by a joint. Also skip rays and filtered pairs.
+  dBodyID b1 = dGeomGetBody(_o1);
+  dBodyID b2 = dGeomGetBody(_o2);
+  if (b1 == b2 || dGeomGetSpace(_o1) == dGeomGetSpace(_o2) ||
+      (b1 && b2 && dAreConnectedExcluding(b1, b2, dJointTypeContact)) ||
+      dGeomGetClass(_o1) == dRayClass || dGeomGetClass(_o2) == dRayClass)
+  {
+    return;
+  }
+  if (!(dGeomGetCategoryBits(_o1) & dGeomGetCollideBits(_o2)) &&
+      !(dGeomGetCategoryBits(_o2) & dGeomGetCollideBits(_o1)))
+  {
+    return;
+  }
+
+  dContactGeom contact;
+  if (dCollide(_o1, _o2, 1, &contact, sizeof(contact)) > 0)
+    data->hit = true;
+}
 
-class Colliders_TBB
+/////////////////////////////////////////////////
+/// \brief Half of the smallest size of the geoms of a body, along the
+/// world axes.
+/// \param[in] _body The body.
+/// \return The radius, 0 if the body has no geom.
+static double SweepRadius(dBodyID _body)
 {
-  public: Colliders_TBB(
-              std::vector<std::pair<ODECollision*, ODECollision*> > *_colliders,
-              ODEPhysics *_engine,
-              dContactGeom* _contactCollisions) :
-    colliders(_colliders),
-              engine(_engine), contactCollisions(_contactCollisions)
+  double radius = 0;
+  for (dGeomID geom = dBodyGetFirstGeom(_body); geom;
+       geom = dBodyGetNextGeom(geom))
   {
-    // dAllocateODEDataForThread(dAllocateMaskAll);
+    if (dGeomGetClass(geom) == dRayClass)
+      continue;
+
+    dReal aabb[6];
+    dGeomGetAABB(geom, aabb);
+    const double halfSize = 0.5 * std::min(aabb[1] - aabb[0],
+        std::min(aabb[3] - aabb[2], aabb[5] - aabb[4]));
+    if (halfSize > 0 && (radius <= 0 || halfSize < radius))
+      radius = halfSize;
   }
+  return radius;
+}
+
+/// \brief Order contact impulses by geom pair.
+/// \param[in] _a First contact.
+/// \param[in] _b Second contact.
+/// \return True if _a comes before _b.
+static bool ContactImpulseLess(const ODEContactImpulse &_a,
+    const ODEContactImpulse &_b)
+{
+  std::less<dGeomID> less;
+  if (_a.geom1 != _b.geom1)
+    return less(_a.geom1, _b.geom1);
+  return less(_a.geom2, _b.geom2);
+}
 
+/*
+class ContactUpdate_TBB
+{
+  public: ContactUpdate_TBB(tbb::concurrent_vector<ContactFeedback> *_contacts)
+          : contacts(contacts) {}
   public: void operator() (const tbb::blocked_range<size_t> &_r) const
   {
     for (size_t i = _r.begin(); i != _r.end(); i++)
     {
-      ODECollision *collision1 = (*this->colliders)[i].first;
-      ODECollision *collision2 = (*this->colliders)[i].second;
-      this->engine->Collide(collision1, collision2, contactCollisions);
+      this->engine->ProcessContactFeedback((*this->contacts)[i]);
     }
   }
 
-  private: std::vector< std::pair<ODECollision*, ODECollision*> > *colliders;
+  private: tbb::concurrent_vector<ContactFeedback> *contacts;
   private: ODEPhysics *engine;
-  private: dContactGeom* contactCollisions;
 };
+*/
 
 //////////////////////////////////////////////////
 extern "C" void dMessageQuiet(int, const char *, va_list)
@@ -143,6 +223,7 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
   dAllocateODEDataForThread(dAllocateMaskAll);
 
   this->dataPtr->worldId = dWorldCreate();
+  ODEStepMemory::Install(this->dataPtr->worldId);
 
   this->dataPtr->spaceId = dHashSpaceCreate(0);
   dHashSpaceSetLevels(this->dataPtr->spaceId, -2, 8);
@@ -154,6 +235,17 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(ignition::math::Rand::Seed());
+
+  this->dataPtr->engineData = this->EngineData();
+  this->SetSnapshotFunctions(
+      [this](std::vector<double> &_state)
+      {
+        this->SaveODESnapshot(_state);
+      },
+      [this](const std::vector<double> &_state)
+      {
+        return this->RestoreODESnapshot(_state);
+      });
 }
 
 //////////////////////////////////////////////////
@@ -230,6 +322,53 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
     this->GetSORPGSIters());
   dWorldSetQuickStepW(this->dataPtr->worldId, this->GetSORPGSW());
 
+  // Contact persistence, read if the SDF description provides it
+  if (solverElem->HasElement("contact_warm_start"))
+  {
+    this->dataPtr->contactWarmStart =
+        solverElem->Get<bool>("contact_warm_start");
+  }
+  if (solverElem->HasElement("contact_warm_start_distance"))
+  {
+    this->dataPtr->contactWarmStartDistance =
+        solverElem->Get<double>("contact_warm_start_distance");
+  }
+
+  // Contact manifolds, read if the SDF description provides them
+  sdf::ElementPtr constraintsElem = odeElem->GetElement("constraints");
+  if (constraintsElem->HasElement("contact_manifold_reduction"))
+  {
+    this->dataPtr->contactManifoldReduction =
+        constraintsElem->Get<bool>("contact_manifold_reduction");
+  }
+  if (constraintsElem->HasElement("contact_manifold_distance"))
+  {
+    this->dataPtr->contactManifolds.SetDistance(
+        constraintsElem->Get<double>("contact_manifold_distance"));
+  }
+
+  if (odeElem->HasElement("collision_space"))
+  {
+    this->SetCollisionSpaceType(
+        odeElem->Get<std::string>("collision_space"));
+  }
+
+  if (odeElem->HasElement("narrow_phase"))
+    this->SetNarrowPhaseType(odeElem->Get<std::string>("narrow_phase"));
+
+  // Step memory, read if the SDF description provides it
+  if (odeElem->HasElement("step_memory_huge_pages"))
+  {
+    ODEStepMemory::SetHugePages(
+        odeElem->Get<bool>("step_memory_huge_pages"));
+  }
+  if (odeElem->HasElement("step_memory_reserve_factor"))
+  {
+    this->dataPtr->stepMemoryReserveFactor = std::max(1.0,
+        odeElem->Get<double>("step_memory_reserve_factor"));
+  }
+  this->dataPtr->ApplyStepMemoryPolicy();
+
   // Set the physics update function
   this->SetStepType(this->dataPtr->stepType);
   if (this->dataPtr->physicsStepFunc == nullptr)
@@ -283,6 +422,26 @@ void ODEPhysics::OnRequest(ConstRequestPtr &_msg)
     physicsMsg.SerializeToString(serializedData);
     this->responsePub->Publish(response);
   }
+  else if (_msg->request() == "step_memory_info")
+  {
+    const ODEStepMemory::Statistics stats = ODEStepMemory::Stats();
+
+    msgs::StepMemoryInfo memoryMsg;
+    memoryMsg.set_huge_pages(ODEStepMemory::HugePages());
+    memoryMsg.set_bytes(stats.bytes);
+    memoryMsg.set_high_water(stats.highWater);
+    memoryMsg.set_allocations(stats.allocations);
+    memoryMsg.set_huge_page_blocks(stats.hugePageBlocks);
+    {
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      memoryMsg.set_reserve_minimum(this->dataPtr->stepMemoryReserve);
+      memoryMsg.set_reserve_factor(this->dataPtr->stepMemoryReserveFactor);
+    }
+
+    response.set_type(memoryMsg.GetTypeName());
+    memoryMsg.SerializeToString(serializedData);
+    this->responsePub->Publish(response);
+  }
 }
 
 /////////////////////////////////////////////////
@@ -348,6 +507,8 @@ void ODEPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
 //////////////////////////////////////////////////
 void ODEPhysics::Init()
 {
+  this->contactManager->SetWrenchUpdater(
+      std::bind(&ODEPhysics::UpdateContactWrenches, this));
 }
 
 //////////////////////////////////////////////////
@@ -365,12 +526,21 @@ void ODEPhysics::UpdateCollision()
   IGN_PROFILE_BEGIN("dSpaceCollide");
 
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (this->dataPtr->collisionFiltersDirty ||
+      this->dataPtr->collisionFiltersGeneration !=
+      ODESurfaceParams::Generation())
+  {
+    this->UpdateCollisionFilters();
+  }
+
+  if (this->dataPtr->contactWarmStart)
+    this->SaveContactImpulses();
   dJointGroupEmpty(this->dataPtr->contactGroup);
 
   unsigned int i = 0;
   this->dataPtr->collidersCount = 0;
   this->dataPtr->trimeshCollidersCount = 0;
-  this->dataPtr->jointFeedbackIndex = 0;
+  this->dataPtr->jointFeedbacks.Reset();
 
   // Reset the contact count
   this->contactManager->ResetCount();
@@ -380,6 +550,66 @@ void ODEPhysics::UpdateCollision()
   DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
   IGN_PROFILE_END();
 
+  // Move the convex parts of the meshes that may collide. They are shared
+  // between colliders, so this isn't done in the narrow phase.
+  for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+  {
+    this->dataPtr->trimeshColliders[i].first->UpdateCompoundPoses();
+    this->dataPtr->trimeshColliders[i].second->UpdateCompoundPoses();
+  }
+
+  // Create the manifolds of the colliding pairs, so that the narrow phase
+  // only modifies their content.
+  if (this->dataPtr->contactManifoldReduction)
+  {
+    ODEContactManifolds &manifolds = this->dataPtr->contactManifolds;
+    manifolds.BeginStep();
+    for (i = 0; i < this->dataPtr->collidersCount; ++i)
+    {
+      manifolds.Prepare(this->dataPtr->colliders[i].first,
+          this->dataPtr->colliders[i].second);
+    }
+    for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+    {
+      manifolds.Prepare(this->dataPtr->trimeshColliders[i].first,
+          this->dataPtr->trimeshColliders[i].second);
+    }
+  }
+
+#ifdef HAVE_FCL
+  // Refresh the FCL objects of the colliding pairs, so that the narrow
+  // phase only reads them.
+  if (this->dataPtr->fclCollider)
+  {
+    ODEFCLCollider &collider = *this->dataPtr->fclCollider;
+    collider.BeginStep();
+    for (i = 0; i < this->dataPtr->collidersCount; ++i)
+    {
+      collider.Update(this->dataPtr->colliders[i].first);
+      collider.Update(this->dataPtr->colliders[i].second);
+    }
+    for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+    {
+      collider.Update(this->dataPtr->trimeshColliders[i].first);
+      collider.Update(this->dataPtr->trimeshColliders[i].second);
+    }
+  }
+#endif
+
+  // Generate all the collisions on the thread pool. Trimesh colliders use
+  // the per thread caches of ODE, see dAllocateODEDataForThread.
+  if (this->dataPtr->parallelNarrowPhase &&
+      this->dataPtr->collidersCount + this->dataPtr->trimeshCollidersCount >=
+      MIN_PARALLEL_COLLIDERS)
+  {
+    IGN_PROFILE_BEGIN("collideParallel");
+    this->CollideParallel();
+    DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideParallel");
+    IGN_PROFILE_END();
+    DIAG_TIMER_STOP("ODEPhysics::UpdateCollision");
+    return;
+  }
+
   IGN_PROFILE_BEGIN("collideShapes");
   // Generate non-trimesh collisions.
   for (i = 0; i < this->dataPtr->collidersCount; ++i)
@@ -393,7 +623,6 @@ void ODEPhysics::UpdateCollision()
 
   IGN_PROFILE_BEGIN("collideTrimeshes");
   // Generate trimesh collision.
-  // This must happen in this thread sequentially
   for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
   {
     ODECollision *collision1 = this->dataPtr->trimeshColliders[i].first;
@@ -416,44 +645,211 @@ void ODEPhysics::UpdatePhysics()
   {
     boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+    // Remember where the continuous collision links start
+    this->dataPtr->continuousCollisionStarts.clear();
+    for (ODELink *link : this->dataPtr->continuousCollisionLinks)
+    {
+      dBodyID body = link->GetODEId();
+      if (body && dBodyIsEnabled(body))
+      {
+        const dReal *p = dBodyGetPosition(body);
+        this->dataPtr->continuousCollisionStarts.push_back(std::make_pair(
+            link, ignition::math::Vector3d(p[0], p[1], p[2])));
+      }
+    }
+
     // Update the dynamical model
-    (*(this->dataPtr->physicsStepFunc))
-      (this->dataPtr->worldId, this->maxStepSize);
+    if (!this->StepSubsteppedModels())
+    {
+      (*(this->dataPtr->physicsStepFunc))
+        (this->dataPtr->worldId, this->maxStepSize);
+    }
+
+    // Once the working memory grew, keep it at its high water mark, so that
+    // it is allocated at once if it has to be allocated again
+    const uint64_t highWater = ODEStepMemory::Stats().highWater;
+    if (highWater > this->dataPtr->stepMemoryReserve)
+    {
+      this->dataPtr->stepMemoryReserve = highWater;
+      this->dataPtr->ApplyStepMemoryPolicy();
+    }
 
-    ignition::math::Vector3d f1, f2, t1, t2;
+    if (!this->dataPtr->continuousCollisionStarts.empty())
+      this->SweepContinuousCollisionLinks();
 
-    // Set the joint contact feedback for each contact.
-    for (unsigned int i = 0; i < this->dataPtr->jointFeedbackIndex; ++i)
+    // Record the orientation of the links in contact. The wrenches are
+    // only converted to the link frames when the contacts are accessed,
+    // see UpdateContactWrenches.
+    this->dataPtr->linkRotations.clear();
+    for (size_t i = 0; i < this->dataPtr->jointFeedbacks.Count(); ++i)
     {
-      Contact *contactFeedback = this->dataPtr->jointFeedbacks[i]->contact;
-      Collision *col1 = contactFeedback->collision1;
-      Collision *col2 = contactFeedback->collision2;
+      ODEJointFeedback *jointFeedback = this->dataPtr->jointFeedbacks.At(i);
+      Collision *col1 = jointFeedback->contact->collision1;
+      Collision *col2 = jointFeedback->contact->collision2;
 
       GZ_ASSERT(col1 != nullptr, "Collision 1 is null");
       GZ_ASSERT(col2 != nullptr, "Collision 2 is null");
 
-      for (int j = 0; j < this->dataPtr->jointFeedbacks[i]->count; ++j)
+      jointFeedback->rot1 = this->dataPtr->LinkRotation(col1->GetLink());
+      jointFeedback->rot2 = this->dataPtr->LinkRotation(col2->GetLink());
+    }
+
+    if (this->dataPtr->jointFeedbacks.Count() > 0)
+      this->contactManager->SetWrenchesPending();
+  }
+
+  DIAG_TIMER_STOP("ODEPhysics::UpdatePhysics");
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::StepSubsteppedModels()
+{
+  std::vector<ODESubstepBody> &bodies = this->dataPtr->substepBodies;
+  std::vector<std::pair<unsigned int, size_t>> &groups =
+      this->dataPtr->substepGroups;
+  bodies.clear();
+  groups.clear();
+
+  for (unsigned int i = 0; i < this->world->ModelCount(); ++i)
+  {
+    ModelPtr model = this->world->ModelByIndex(i);
+    if (!model || model->IsStatic() || model->PhysicsSubsteps() <= 1)
+      continue;
+
+    const size_t begin = bodies.size();
+    for (auto const &link : model->GetLinks())
+    {
+      ODELinkPtr odeLink = boost::dynamic_pointer_cast<ODELink>(link);
+      if (!odeLink || !odeLink->GetODEId() ||
+          !dBodyIsEnabled(odeLink->GetODEId()))
       {
-        dJointFeedback fb = this->dataPtr->jointFeedbacks[i]->feedbacks[j];
-        f1.Set(fb.f1[0], fb.f1[1], fb.f1[2]);
-        f2.Set(fb.f2[0], fb.f2[1], fb.f2[2]);
-        t1.Set(fb.t1[0], fb.t1[1], fb.t1[2]);
-        t2.Set(fb.t2[0], fb.t2[1], fb.t2[2]);
-
-        // set force torque in link frame
-        this->dataPtr->jointFeedbacks[i]->contact->wrench[j].body1Force =
-             col1->GetLink()->WorldPose().Rot().RotateVectorReverse(f1);
-        this->dataPtr->jointFeedbacks[i]->contact->wrench[j].body2Force =
-             col2->GetLink()->WorldPose().Rot().RotateVectorReverse(f2);
-        this->dataPtr->jointFeedbacks[i]->contact->wrench[j].body1Torque =
-             col1->GetLink()->WorldPose().Rot().RotateVectorReverse(t1);
-        this->dataPtr->jointFeedbacks[i]->contact->wrench[j].body2Torque =
-             col2->GetLink()->WorldPose().Rot().RotateVectorReverse(t2);
+        continue;
       }
+
+      ODESubstepBody body;
+      body.id = odeLink->GetODEId();
+      bodies.push_back(body);
     }
+
+    // Models coupled to the rest of the world are stepped with it
+    if (bodies.size() == begin || this->dataPtr->SubstepBodiesCoupled(begin))
+      bodies.resize(begin);
+    else
+      groups.push_back(std::make_pair(model->PhysicsSubsteps(), bodies.size()));
   }
 
-  DIAG_TIMER_STOP("ODEPhysics::UpdatePhysics");
+  if (groups.empty())
+    return false;
+
+  // Step the world without the models that have substeps. Their forces
+  // are kept, ODE only clears the forces of the bodies it steps.
+  for (auto const &body : bodies)
+    dBodySetEnabledFlag(body.id, 0);
+
+  (*(this->dataPtr->physicsStepFunc))
+    (this->dataPtr->worldId, this->maxStepSize);
+
+  std::vector<dBodyID> &frozen = this->dataPtr->substepFrozenBodies;
+  frozen.clear();
+  for (dBodyID id = dWorldGetFirstBody(this->dataPtr->worldId); id;
+       id = dBodyGetNextBody(id))
+  {
+    if (dBodyIsEnabled(id))
+    {
+      dBodySetEnabledFlag(id, 0);
+      frozen.push_back(id);
+    }
+  }
+
+  // Step each model alone, the substeps end with the world step
+  size_t begin = 0;
+  for (auto const &group : groups)
+  {
+    const unsigned int substeps = group.first;
+    const size_t end = group.second;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      ODESubstepBody &body = bodies[i];
+      dBodySetEnabledFlag(body.id, 1);
+      const dReal *force = dBodyGetForce(body.id);
+      const dReal *torque = dBodyGetTorque(body.id);
+      for (int j = 0; j < 3; ++j)
+      {
+        body.force[j] = force[j];
+        body.torque[j] = torque[j];
+      }
+    }
+
+    for (unsigned int k = 0; k < substeps; ++k)
+    {
+      if (k > 0)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          const ODESubstepBody &body = bodies[i];
+          dBodySetForce(body.id,
+              body.force[0], body.force[1], body.force[2]);
+          dBodySetTorque(body.id,
+              body.torque[0], body.torque[1], body.torque[2]);
+        }
+      }
+
+      (*(this->dataPtr->physicsStepFunc))
+        (this->dataPtr->worldId, this->maxStepSize / substeps);
+    }
+
+    // Bodies may have been disabled automatically during the substeps
+    for (size_t i = begin; i < end; ++i)
+    {
+      bodies[i].enabled = dBodyIsEnabled(bodies[i].id) != 0;
+      dBodySetEnabledFlag(bodies[i].id, 0);
+    }
+
+    begin = end;
+  }
+
+  for (auto const &body : bodies)
+    dBodySetEnabledFlag(body.id, body.enabled ? 1 : 0);
+  for (dBodyID id : frozen)
+    dBodySetEnabledFlag(id, 1);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::UpdateContactWrenches()
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  ignition::math::Vector3d f1, f2, t1, t2;
+
+  // Set the joint contact feedback for each contact.
+  for (size_t i = 0; i < this->dataPtr->jointFeedbacks.Count(); ++i)
+  {
+    const ODEJointFeedback *jointFeedback =
+        this->dataPtr->jointFeedbacks.At(i);
+    Contact *contactFeedback = jointFeedback->contact;
+
+    for (int j = 0; j < jointFeedback->count; ++j)
+    {
+      const dJointFeedback &fb = jointFeedback->feedbacks[j];
+      f1.Set(fb.f1[0], fb.f1[1], fb.f1[2]);
+      f2.Set(fb.f2[0], fb.f2[1], fb.f2[2]);
+      t1.Set(fb.t1[0], fb.t1[1], fb.t1[2]);
+      t2.Set(fb.t2[0], fb.t2[1], fb.t2[2]);
+
+      // set force torque in link frame
+      contactFeedback->wrench[j].body1Force =
+          jointFeedback->rot1.RotateVectorReverse(f1);
+      contactFeedback->wrench[j].body2Force =
+          jointFeedback->rot2.RotateVectorReverse(f2);
+      contactFeedback->wrench[j].body1Torque =
+          jointFeedback->rot1.RotateVectorReverse(t1);
+      contactFeedback->wrench[j].body2Torque =
+          jointFeedback->rot2.RotateVectorReverse(t2);
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -461,17 +857,22 @@ void ODEPhysics::Fini()
 {
   dCloseODE();
 
+  if (this->contactManager)
+    this->contactManager->SetWrenchUpdater(nullptr);
+
   if (this->dataPtr->contactGroup)
     dJointGroupDestroy(this->dataPtr->contactGroup);
   this->dataPtr->contactGroup = nullptr;
 
   // Delete all the joint feedbacks.
-  for (auto iter = this->dataPtr->jointFeedbacks.begin();
-      iter != this->dataPtr->jointFeedbacks.end(); ++iter)
+  this->dataPtr->jointFeedbacks.Clear();
+
+  if (this->dataPtr->staticSpaceId)
   {
-    delete *iter;
+    dSpaceSetCleanup(this->dataPtr->staticSpaceId, 0);
+    dSpaceDestroy(this->dataPtr->staticSpaceId);
   }
-  this->dataPtr->jointFeedbacks.clear();
+  this->dataPtr->staticSpaceId = nullptr;
 
   if (this->dataPtr->spaceId)
   {
@@ -494,6 +895,8 @@ void ODEPhysics::Reset()
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
   // Very important to clear out the contact group
   dJointGroupEmpty(this->dataPtr->contactGroup);
+  this->dataPtr->contactImpulses.clear();
+  this->dataPtr->prevContactImpulses.clear();
 }
 
 //////////////////////////////////////////////////
@@ -502,16 +905,27 @@ LinkPtr ODEPhysics::CreateLink(ModelPtr _parent)
   if (_parent == nullptr)
     gzthrow("Link must have a parent\n");
 
-  std::map<std::string, dSpaceID>::iterator iter;
-  iter = this->dataPtr->spaces.find(_parent->GetName());
+  ODELinkPtr link(new ODELink(_parent));
 
-  if (iter == this->dataPtr->spaces.end())
-    this->dataPtr->spaces[_parent->GetName()] =
-      dSimpleSpaceCreate(this->dataPtr->spaceId);
+  if (_parent->IsStatic() && this->world->CompactStaticModels())
+  {
+    // The broadphase tests the static geometry as one tree, instead of one
+    // space per model.
+    if (!this->dataPtr->staticSpaceId)
+      this->dataPtr->staticSpaceId = dBVHSpaceCreate(this->dataPtr->spaceId);
+    link->SetSpaceId(this->dataPtr->staticSpaceId);
+  }
+  else
+  {
+    std::map<std::string, dSpaceID>::iterator iter;
+    iter = this->dataPtr->spaces.find(_parent->GetName());
 
-  ODELinkPtr link(new ODELink(_parent));
+    if (iter == this->dataPtr->spaces.end())
+      this->dataPtr->spaces[_parent->GetName()] =
+        dSimpleSpaceCreate(this->dataPtr->spaceId);
 
-  link->SetSpaceId(this->dataPtr->spaces[_parent->GetName()]);
+    link->SetSpaceId(this->dataPtr->spaces[_parent->GetName()]);
+  }
   link->SetWorld(_parent->GetWorld());
 
   return link;
@@ -525,6 +939,7 @@ CollisionPtr ODEPhysics::CreateCollision(const std::string &_type,
   ShapePtr shape = this->CreateShape(_type, collision);
   collision->SetShape(shape);
   shape->SetWorld(_body->GetWorld());
+  this->dataPtr->collisionFiltersDirty = true;
   return collision;
 }
 
@@ -735,6 +1150,95 @@ void ODEPhysics::SetFrictionModel(const std::string &_fricModel)
     ConvertFrictionModel(_fricModel));
 }
 
+//////////////////////////////////////////////////
+bool ODEPhysics::SetCollisionSpaceType(const std::string &_type)
+{
+  if (_type == this->dataPtr->spaceType)
+    return true;
+
+  dSpaceID space = nullptr;
+  if (_type == "bvh")
+  {
+    space = dBVHSpaceCreate(0);
+  }
+  else if (_type == "hash")
+  {
+    space = dHashSpaceCreate(0);
+    dHashSpaceSetLevels(space, -2, 8);
+  }
+  else
+  {
+    gzerr << "Unknown collision space type[" << _type
+          << "], must be hash or bvh\n";
+    return false;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  // Move the model spaces and the top level geoms to the new space.
+  while (dSpaceGetNumGeoms(this->dataPtr->spaceId) > 0)
+  {
+    dGeomID geom = dSpaceGetGeom(this->dataPtr->spaceId, 0);
+    dSpaceRemove(this->dataPtr->spaceId, geom);
+    dSpaceAdd(space, geom);
+  }
+  dSpaceDestroy(this->dataPtr->spaceId);
+
+  this->dataPtr->spaceId = space;
+  this->dataPtr->spaceType = _type;
+  return true;
+}
+
+//////////////////////////////////////////////////
+dSpaceID ODEPhysics::StaticSpaceId() const
+{
+  return this->dataPtr->staticSpaceId;
+}
+
+//////////////////////////////////////////////////
+std::string ODEPhysics::GetCollisionSpaceType() const
+{
+  return this->dataPtr->spaceType;
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SetNarrowPhaseType(const std::string &_type)
+{
+  if (_type != "ode" && _type != "fcl")
+  {
+    gzerr << "Unknown narrow phase type[" << _type
+          << "], must be ode or fcl\n";
+    return false;
+  }
+
+#ifdef HAVE_FCL
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (_type == "ode")
+    this->dataPtr->fclCollider.reset();
+  else if (!this->dataPtr->fclCollider)
+    this->dataPtr->fclCollider.reset(new ODEFCLCollider());
+  return true;
+#else
+  if (_type == "fcl")
+  {
+    gzerr << "The fcl narrow phase requires gazebo to be built with "
+          << "ENABLE_FCL_NARROW_PHASE\n";
+    return false;
+  }
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+std::string ODEPhysics::GetNarrowPhaseType() const
+{
+#ifdef HAVE_FCL
+  if (this->dataPtr->fclCollider)
+    return "fcl";
+#endif
+  return "ode";
+}
+
 //////////////////////////////////////////////////
 void ODEPhysics::SetWorldCFM(double _cfm)
 {
@@ -931,6 +1435,18 @@ void ODEPhysics::SetStepType(const std::string &_type)
     this->dataPtr->physicsStepFunc = &dWorldQuickStep;
   else if (this->dataPtr->stepType == "world")
     this->dataPtr->physicsStepFunc = &dWorldStep;
+  else if (this->dataPtr->stepType == "parallel_quick")
+  {
+#ifdef HAVE_PARALLEL_QUICKSTEP
+    this->dataPtr->physicsStepFunc = &dWorldParallelQuickStep;
+#else
+    gzwarn << "Gazebo was built without parallel_quickstep, "
+           << "using the quick step type" << std::endl;
+    elem->GetElement("type")->Set("quick");
+    this->dataPtr->stepType = "quick";
+    this->dataPtr->physicsStepFunc = &dWorldQuickStep;
+#endif
+  }
   else
     gzerr << "Invalid step type[" << this->dataPtr->stepType
           << "]" << std::endl;
@@ -961,6 +1477,14 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
   // Check if either are spaces
   if (dGeomIsSpace(_o1) || dGeomIsSpace(_o2))
   {
+    // Reject whole models whose collision groups don't collide
+    if (dGeomIsSpace(_o1) && dGeomIsSpace(_o2) &&
+        !self->dataPtr->SpacesCollide(reinterpret_cast<dSpaceID>(_o1),
+          reinterpret_cast<dSpaceID>(_o2)))
+    {
+      return;
+    }
+
     dSpaceCollide2(_o1, _o2, self, &CollisionCallback);
   }
   else
@@ -981,6 +1505,41 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
     else
       collision2 = static_cast<ODECollision*>(dGeomGetData(_o2));
 
+    // Make sure both collision pointers are valid.
+    if (!collision1 || !collision2)
+      return;
+
+    // Apply the filters of GenerateContacts from the filter records, which
+    // are missing until the next collision update for new collisions
+    const ODECollisionFilter *filter1 =
+        self->dataPtr->CollisionFilter(collision1);
+    const ODECollisionFilter *filter2 =
+        self->dataPtr->CollisionFilter(collision2);
+    bool mesh;
+    if (filter1 && filter2)
+    {
+      if (!self->dataPtr->GroupsCollide(filter1->group, filter2->group) ||
+          (filter1->collideBitmask & filter2->collideBitmask) == 0)
+      {
+        return;
+      }
+
+      if ((filter1->collideWithoutContact ||
+           filter2->collideWithoutContact) &&
+          (filter1->collideWithoutContactBitmask &
+           filter2->collideWithoutContactBitmask) == 0)
+      {
+        return;
+      }
+
+      mesh = filter1->mesh || filter2->mesh;
+    }
+    else
+    {
+      mesh = collision1->HasType(Base::MESH_SHAPE) ||
+          collision2->HasType(Base::MESH_SHAPE);
+    }
+
     // Exit if both bodies are not enabled
     if (dGeomGetCategoryBits(_o1) != GZ_SENSOR_COLLIDE &&
         dGeomGetCategoryBits(_o2) != GZ_SENSOR_COLLIDE &&
@@ -993,18 +1552,11 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
       return;
     }
 
-    // Make sure both collision pointers are valid.
-    if (collision1 && collision2)
-    {
-      // Add either a tri-mesh collider or a regular collider.
-      if (collision1->HasType(Base::MESH_SHAPE) ||
-          collision2->HasType(Base::MESH_SHAPE))
-        self->AddTrimeshCollider(collision1, collision2);
-      else
-      {
-        self->AddCollider(collision1, collision2);
-      }
-    }
+    // Add either a tri-mesh collider or a regular collider.
+    if (mesh)
+      self->AddTrimeshCollider(collision1, collision2);
+    else
+      self->AddCollider(collision1, collision2);
   }
 }
 
@@ -1012,11 +1564,27 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
 //////////////////////////////////////////////////
 void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
                          dContactGeom *_contactCollisions)
+{
+  dContact contact;
+  const unsigned int numc = this->GenerateContacts(_collision1, _collision2,
+      _contactCollisions, contact);
+
+  if (numc > 0)
+  {
+    this->AddContactJoints(_collision1, _collision2, _contactCollisions, numc,
+        contact);
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int ODEPhysics::GenerateContacts(ODECollision *_collision1,
+    ODECollision *_collision2, dContactGeom *_contactCollisions,
+    dContact &_contact)
 {
   // Filter collisions based on collide bitmask.
   if ((_collision1->GetSurface()->collideBitmask &
         _collision2->GetSurface()->collideBitmask) == 0)
-    return;
+    return 0;
 
   // Filter collisions based on contact bitmask if collide_without_contact is
   // on.The bitmask is set mainly for speed improvements otherwise a collision
@@ -1028,7 +1596,7 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     if ((_collision1->GetSurface()->collideWithoutContactBitmask &
          _collision2->GetSurface()->collideWithoutContactBitmask) == 0)
     {
-      return;
+      return 0;
     }
   }
 
@@ -1045,9 +1613,8 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   }*/
 
   unsigned int numc = 0;
-  dContact contact;
 
-  // maxCollide must less than the size of this->dataPtr->indices
+  // maxCollide must be less than MAX_CONTACT_JOINTS
   // Check the header
   unsigned int maxCollide = MAX_CONTACT_JOINTS;
 
@@ -1062,44 +1629,94 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   if (_collision2->GetMaxContacts() < maxCollide)
     maxCollide = _collision2->GetMaxContacts();
 
-  // Generate the contacts
-  numc = dCollide(_collision1->GetCollisionId(), _collision2->GetCollisionId(),
-      MAX_COLLIDE_RETURNS, _contactCollisions, sizeof(_contactCollisions[0]));
+  // Generate the contacts. The convex parts of a collision are used
+  // instead of the collision object, except against a triangle mesh
+  // since ODE has no convex and triangle mesh collider.
+  dGeomID id1 = _collision1->GetCollisionId();
+  dGeomID id2 = _collision2->GetCollisionId();
+  const std::vector<dGeomID> &parts1 = _collision1->CompoundCollisionIds();
+  const std::vector<dGeomID> &parts2 = _collision2->CompoundCollisionIds();
+  const bool compound1 = !parts1.empty() &&
+    (!parts2.empty() || dGeomGetClass(id2) != dTriMeshClass);
+  const bool compound2 = !parts2.empty() &&
+    (!parts1.empty() || dGeomGetClass(id1) != dTriMeshClass);
+
+  if (!compound1 && !compound2)
+  {
+#ifdef HAVE_FCL
+    if (!this->dataPtr->fclCollider ||
+        !this->dataPtr->fclCollider->Collide(_collision1, _collision2,
+          MAX_COLLIDE_RETURNS, _contactCollisions, numc))
+#endif
+    {
+      numc = dCollide(id1, id2, MAX_COLLIDE_RETURNS, _contactCollisions,
+          sizeof(_contactCollisions[0]));
+    }
+  }
+  else
+  {
+    const dGeomID *geoms1 = compound1 ? parts1.data() : &id1;
+    const dGeomID *geoms2 = compound2 ? parts2.data() : &id2;
+    const size_t count1 = compound1 ? parts1.size() : 1;
+    const size_t count2 = compound2 ? parts2.size() : 1;
+    for (size_t i = 0; i < count1 && numc < MAX_COLLIDE_RETURNS; ++i)
+    {
+      for (size_t j = 0; j < count2 && numc < MAX_COLLIDE_RETURNS; ++j)
+      {
+        numc += dCollide(geoms1[i], geoms2[j], MAX_COLLIDE_RETURNS - numc,
+            _contactCollisions + numc, sizeof(_contactCollisions[0]));
+      }
+    }
+
+    // Report the contacts on the collision objects
+    for (unsigned int i = 0; i < numc; ++i)
+    {
+      _contactCollisions[i].g1 = id1;
+      _contactCollisions[i].g2 = id2;
+    }
+  }
 
   // Return if no contacts.
   if (numc == 0)
-    return;
+    return 0;
 
-  // Store the indices of the contacts.
-  for (int i = 0; i < MAX_CONTACT_JOINTS; i++)
-    this->dataPtr->indices[i] = i;
+  // Merge with the contacts of the last step and reduce to a manifold
+  if (this->dataPtr->contactManifoldReduction)
+  {
+    numc = this->dataPtr->contactManifolds.Reduce(_collision1, _collision2,
+        _contactCollisions, numc);
+  }
 
-  // Choose only the best contacts if too many were generated.
+  // Choose only the best contacts if too many were generated: keep the
+  // first ones, and replace the last kept contact by the deepest of the
+  // dropped ones.
   if (maxCollide > 0 && numc > maxCollide)
   {
+    unsigned int deepest = maxCollide-1;
     double max = _contactCollisions[maxCollide-1].depth;
     for (unsigned int i = maxCollide; i < numc; ++i)
     {
       if (_contactCollisions[i].depth > max)
       {
         max = _contactCollisions[i].depth;
-        this->dataPtr->indices[maxCollide-1] = i;
+        deepest = i;
       }
     }
+    _contactCollisions[maxCollide-1] = _contactCollisions[deepest];
 
     // Make sure numc has the valid number of contacts.
     numc = maxCollide;
   }
 
   // Set the contact surface parameter flags.
-  contact.surface.mode = dContactBounce |
-                         dContactMu2 |
-                         dContactSoftERP |
-                         dContactSoftCFM |
-                         dContactApprox1 |
-                         dContactApprox3 |
-                         dContactSlip1 |
-                         dContactSlip2;
+  _contact.surface.mode = dContactBounce |
+                          dContactMu2 |
+                          dContactSoftERP |
+                          dContactSoftCFM |
+                          dContactApprox1 |
+                          dContactApprox3 |
+                          dContactSlip1 |
+                          dContactSlip2;
 
   ODESurfaceParamsPtr surf1 = _collision1->GetODESurface();
   ODESurfaceParamsPtr surf2 = _collision2->GetODESurface();
@@ -1109,10 +1726,10 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   double kp = 1.0 / (1.0 / surf1->kp + 1.0 / surf2->kp);
   double kd = surf1->kd + surf2->kd;
 
-  contact.surface.soft_erp = (this->maxStepSize * kp) /
-                             (this->maxStepSize * kp + kd);
+  _contact.surface.soft_erp = (this->maxStepSize * kp) /
+                              (this->maxStepSize * kp + kd);
 
-  contact.surface.soft_cfm = 1.0 / (this->maxStepSize * kp + kd);
+  _contact.surface.soft_cfm = 1.0 / (this->maxStepSize * kp + kd);
 
   // contact.surface.soft_erp = 0.5*(_collision1->surface->softERP +
   //                                _collision2->surface->softERP);
@@ -1155,38 +1772,38 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
 
   if (fd != ignition::math::Vector3d::Zero)
   {
-    contact.surface.mode |= dContactFDir1;
-    contact.fdir1[0] = fd.X();
-    contact.fdir1[1] = fd.Y();
-    contact.fdir1[2] = fd.Z();
+    _contact.surface.mode |= dContactFDir1;
+    _contact.fdir1[0] = fd.X();
+    _contact.fdir1[1] = fd.Y();
+    _contact.fdir1[2] = fd.Z();
   }
 
   // Set the friction coefficients.
-  contact.surface.mu = std::min(surf1->FrictionPyramid()->MuPrimary(),
-                                surf2->FrictionPyramid()->MuPrimary());
-  contact.surface.mu2 = std::min(surf1->FrictionPyramid()->MuSecondary(),
-                                 surf2->FrictionPyramid()->MuSecondary());
-  contact.surface.mu3 = std::min(surf1->FrictionPyramid()->MuTorsion(),
-                                 surf2->FrictionPyramid()->MuTorsion());
+  _contact.surface.mu = std::min(surf1->FrictionPyramid()->MuPrimary(),
+                                 surf2->FrictionPyramid()->MuPrimary());
+  _contact.surface.mu2 = std::min(surf1->FrictionPyramid()->MuSecondary(),
+                                  surf2->FrictionPyramid()->MuSecondary());
+  _contact.surface.mu3 = std::min(surf1->FrictionPyramid()->MuTorsion(),
+                                  surf2->FrictionPyramid()->MuTorsion());
 
   // Combine the slip values
   // The slip is equivalent to the inverse of a viscous damping term
   // To combine dampers in series, the inverse of damping is summed
   // So the sum of slip parameters is used to combine them
-  contact.surface.slip1 = surf1->slip1 + surf2->slip1;
-  contact.surface.slip2 = surf1->slip2 + surf2->slip2;
-  contact.surface.slip3 = surf1->slipTorsion + surf2->slipTorsion;
+  _contact.surface.slip1 = surf1->slip1 + surf2->slip1;
+  _contact.surface.slip2 = surf1->slip2 + surf2->slip2;
+  _contact.surface.slip3 = surf1->slipTorsion + surf2->slipTorsion;
   // The slip parameter acts like a damper at each contact point
   // so the total damping for each collision is multiplied by the
   // number of contact points (numc).
   // To eliminate this dependence on numc, the inverse damping
   // is multipled by numc.
-  contact.surface.slip1 *= numc;
-  contact.surface.slip2 *= numc;
-  contact.surface.slip3 *= numc;
+  _contact.surface.slip1 *= numc;
+  _contact.surface.slip2 *= numc;
+  _contact.surface.slip3 *= numc;
 
   // Combine torsional friction patch radius values
-  contact.surface.patch_radius =
+  _contact.surface.patch_radius =
       std::max(surf1->FrictionPyramid()->PatchRadius(),
                surf2->FrictionPyramid()->PatchRadius());
 
@@ -1202,32 +1819,32 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     curv2 = 1 / surf2->FrictionPyramid()->SurfaceRadius();
 
   double curvSum = curv1 + curv2;
-  contact.surface.surface_radius = 0;
+  _contact.surface.surface_radius = 0;
   if (curvSum > 0)
-    contact.surface.surface_radius = 1 / curvSum;
+    _contact.surface.surface_radius = 1 / curvSum;
 
   /// \todo Not sure how to combine these logic flags
   /// If user wanted to use patch radius, but got settings
   /// overwritten by the logic combination, how do we make sure the
   /// the surface radius is specified or makes sense?
-  contact.surface.use_patch_radius =
+  _contact.surface.use_patch_radius =
       surf1->FrictionPyramid()->UsePatchRadius() &&
       surf2->FrictionPyramid()->UsePatchRadius();
 
-  if (contact.surface.mu3 > 0)
+  if (_contact.surface.mu3 > 0)
   {
     // Patch radius
-    if ((contact.surface.use_patch_radius &&
-        contact.surface.patch_radius > 0) ||
+    if ((_contact.surface.use_patch_radius &&
+        _contact.surface.patch_radius > 0) ||
     // Surface radius
-        (!contact.surface.use_patch_radius &&
-        contact.surface.surface_radius > 0))
+        (!_contact.surface.use_patch_radius &&
+        _contact.surface.surface_radius > 0))
     {
-      contact.surface.mode |= dContactMu3;
+      _contact.surface.mode |= dContactMu3;
 
-      if (contact.surface.slip3 > 0)
+      if (_contact.surface.slip3 > 0)
       {
-        contact.surface.mode |= dContactSlip3;
+        _contact.surface.mode |= dContactSlip3;
       }
     }
   }
@@ -1241,23 +1858,31 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   double e2 = surf2->FrictionPyramid()->ElasticModulus();
   if (e1 > 0 && e2 > 0)
   {
-    contact.surface.elastic_modulus = 1.0 /
+    _contact.surface.elastic_modulus = 1.0 /
       ((1.0 - nu1*nu1)/e1 + (1.0 - nu2*nu2)/e2);
 
     // Turn on Contact Elastic Modulus model if elastic modulus > 0
-    if (contact.surface.elastic_modulus > 0.0)
+    if (_contact.surface.elastic_modulus > 0.0)
     {
-      contact.surface.mode |= dContactEM;
+      _contact.surface.mode |= dContactEM;
     }
   }
 
   // Set the bounce values
-  contact.surface.bounce = std::min(surf1->bounce,
-                                    surf2->bounce);
-  contact.surface.bounce_vel =
+  _contact.surface.bounce = std::min(surf1->bounce,
+                                     surf2->bounce);
+  _contact.surface.bounce_vel =
     std::min(surf1->bounceThreshold,
              surf2->bounceThreshold);
 
+  return numc;
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::AddContactJoints(ODECollision *_collision1,
+    ODECollision *_collision2, const dContactGeom *_contactGeoms,
+    const unsigned int _count, dContact &_contact)
+{
   // Get the ODE body IDs
   dBodyID b1 = dGeomGetBody(_collision1->GetCollisionId());
   dBodyID b2 = dGeomGetBody(_collision2->GetCollisionId());
@@ -1272,49 +1897,82 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   // Create a joint feedback mechanism
   if (contactFeedback)
   {
-    if (this->dataPtr->jointFeedbackIndex <
-        this->dataPtr->jointFeedbacks.size())
-      jointFeedback =
-          this->dataPtr->jointFeedbacks[this->dataPtr->jointFeedbackIndex];
-    else
-    {
-      jointFeedback = new ODEJointFeedback();
-      this->dataPtr->jointFeedbacks.push_back(jointFeedback);
-    }
-
-    this->dataPtr->jointFeedbackIndex++;
+    jointFeedback = this->dataPtr->jointFeedbacks.Acquire();
     jointFeedback->count = 0;
     jointFeedback->contact = contactFeedback;
   }
 
+  // Let the contact callbacks of the collisions modify the points of
+  // contacts that constrain the bodies.
+  const bool attach = !_collision1->GetSurface()->collideWithoutContact &&
+                      !_collision2->GetSurface()->collideWithoutContact;
+  std::vector<ContactPoint> &points = this->dataPtr->contactPoints;
+  bool modified = false;
+  if (attach && !this->dataPtr->engineData->contactCallbacks.empty())
+  {
+    points.resize(_count);
+    for (unsigned int j = 0; j < _count; ++j)
+    {
+      const dContactGeom &geom = _contactGeoms[j];
+      points[j].position.Set(geom.pos[0], geom.pos[1], geom.pos[2]);
+      points[j].normal.Set(geom.normal[0], geom.normal[1], geom.normal[2]);
+      points[j].depth = geom.depth;
+      points[j].frictionDirection1 = ignition::math::Vector3d::Zero;
+      points[j].surfaceMotion1 = 0;
+    }
+    modified = this->RunContactCallbacks(_collision1, _collision2,
+        points.data(), _count);
+  }
+
   // Create a joint for each contact
-  for (unsigned int j = 0; j < numc; ++j)
+  for (unsigned int j = 0; j < _count; ++j)
   {
-    contact.geom = _contactCollisions[this->dataPtr->indices[j]];
+    _contact.geom = _contactGeoms[j];
+
+    dContact pointContact;
+    const dContact *contact = &_contact;
+    if (modified && points[j].frictionDirection1 !=
+        ignition::math::Vector3d::Zero)
+    {
+      const ContactPoint &point = points[j];
+      pointContact = _contact;
+      pointContact.fdir1[0] = point.frictionDirection1.X();
+      pointContact.fdir1[1] = point.frictionDirection1.Y();
+      pointContact.fdir1[2] = point.frictionDirection1.Z();
+      pointContact.surface.mode |= dContactFDir1 | dContactMotion1;
+      pointContact.surface.motion1 = point.surfaceMotion1;
+      contact = &pointContact;
+    }
 
     // Create the contact joint. This introduces the contact constraint to
     // ODE
     dJointID contactJoint = dJointCreateContact(this->dataPtr->worldId,
-      this->dataPtr->contactGroup, &contact);
+      this->dataPtr->contactGroup, contact);
+
+    if (this->dataPtr->contactWarmStart)
+    {
+      this->WarmStartContact(contactJoint, _collision1->GetCollisionId(),
+          _collision2->GetCollisionId(), _contactGeoms[j]);
+    }
 
     // Store contact information.
     if (contactFeedback && jointFeedback)
     {
       // Store the contact depth
       contactFeedback->depths[j] =
-        _contactCollisions[this->dataPtr->indices[j]].depth;
+        _contactGeoms[j].depth;
 
       // Store the contact position
       contactFeedback->positions[j].Set(
-          _contactCollisions[this->dataPtr->indices[j]].pos[0],
-          _contactCollisions[this->dataPtr->indices[j]].pos[1],
-          _contactCollisions[this->dataPtr->indices[j]].pos[2]);
+          _contactGeoms[j].pos[0],
+          _contactGeoms[j].pos[1],
+          _contactGeoms[j].pos[2]);
 
       // Store the contact normal
       contactFeedback->normals[j].Set(
-          _contactCollisions[this->dataPtr->indices[j]].normal[0],
-          _contactCollisions[this->dataPtr->indices[j]].normal[1],
-          _contactCollisions[this->dataPtr->indices[j]].normal[2]);
+          _contactGeoms[j].normal[0],
+          _contactGeoms[j].normal[1],
+          _contactGeoms[j].normal[2]);
 
       // Set the joint feedback.
       dJointSetFeedback(contactJoint, &(jointFeedback->feedbacks[j]));
@@ -1325,12 +1983,212 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     }
 
     // Attach the contact joint if collideWithoutContact flags aren't set.
-    if (!_collision1->GetSurface()->collideWithoutContact &&
-        !_collision2->GetSurface()->collideWithoutContact)
+    if (attach)
       dJointAttach(contactJoint, b1, b2);
   }
 }
 
+/////////////////////////////////////////////////
+void ODEPhysics::SaveContactImpulses()
+{
+  std::vector<ODEContactImpulse> &impulses = this->dataPtr->contactImpulses;
+  for (auto &impulse : impulses)
+  {
+    dJointGetWarmStart(impulse.joint, impulse.lambda, impulse.lambdaErp);
+    impulse.joint = nullptr;
+  }
+  std::sort(impulses.begin(), impulses.end(), ContactImpulseLess);
+
+  // Keep the capacity of both buffers from step to step
+  this->dataPtr->prevContactImpulses.swap(impulses);
+  impulses.clear();
+
+  this->dataPtr->warmStartContacts = 0;
+  this->dataPtr->warmStartHits = 0;
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::WarmStartContact(dJointID _joint, dGeomID _geom1,
+    dGeomID _geom2, const dContactGeom &_contactGeom)
+{
+  ODEContactImpulse impulse;
+  impulse.geom1 = _geom1;
+  impulse.geom2 = _geom2;
+  impulse.joint = _joint;
+  for (int i = 0; i < 3; ++i)
+  {
+    impulse.pos[i] = _contactGeom.pos[i];
+    impulse.normal[i] = _contactGeom.normal[i];
+  }
+
+  const std::vector<ODEContactImpulse> &prev =
+      this->dataPtr->prevContactImpulses;
+  auto range = std::equal_range(prev.begin(), prev.end(), impulse,
+      ContactImpulseLess);
+
+  // Closest contact of the same pair, with a similar normal
+  const ODEContactImpulse *match = nullptr;
+  double minDist2 = this->dataPtr->contactWarmStartDistance *
+      this->dataPtr->contactWarmStartDistance;
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    double dist2 = 0;
+    double normalDot = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      const double d = iter->pos[i] - impulse.pos[i];
+      dist2 += d * d;
+      normalDot += iter->normal[i] * impulse.normal[i];
+    }
+
+    if (dist2 <= minDist2 && normalDot >= WARM_START_MIN_NORMAL_DOT)
+    {
+      match = &(*iter);
+      minDist2 = dist2;
+    }
+  }
+
+  if (match)
+  {
+    dJointSetWarmStart(_joint, match->lambda, match->lambdaErp);
+    this->dataPtr->warmStartHits++;
+  }
+  this->dataPtr->warmStartContacts++;
+
+  this->dataPtr->contactImpulses.push_back(impulse);
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::SetContinuousCollisionLink(ODELink *_link,
+    const bool _enable)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (_enable)
+    this->dataPtr->continuousCollisionLinks.insert(_link);
+  else
+    this->dataPtr->continuousCollisionLinks.erase(_link);
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::SweepContinuousCollisionLinks()
+{
+  IGN_PROFILE("ODEPhysics::SweepContinuousCollisionLinks");
+
+  for (const auto &start : this->dataPtr->continuousCollisionStarts)
+  {
+    dBodyID body = start.first->GetODEId();
+    const dReal *p = dBodyGetPosition(body);
+    const ignition::math::Vector3d end(p[0], p[1], p[2]);
+    const ignition::math::Vector3d motion = end - start.second;
+
+    // A link that moved by less than half its size can't have skipped a
+    // collision that the step didn't see.
+    const double radius = SweepRadius(body);
+    const double distance = motion.Length();
+    if (radius <= 0 || distance <= radius)
+      continue;
+
+    const unsigned int samples = std::min(CCD_MAX_SAMPLES,
+        static_cast<unsigned int>(std::ceil(distance / radius)));
+    SweepData data;
+    data.body = body;
+    for (unsigned int i = 1; i < samples && !data.hit; ++i)
+    {
+      const ignition::math::Vector3d pos =
+          start.second + motion * (static_cast<double>(i) / samples);
+      dBodySetPosition(body, pos.X(), pos.Y(), pos.Z());
+      for (dGeomID geom = dBodyGetFirstGeom(body); geom && !data.hit;
+           geom = dBodyGetNextGeom(geom))
+      {
+        dSpaceCollide2(geom, (dGeomID)this->dataPtr->spaceId, &data,
+            &SweepCallback);
+      }
+    }
+
+    // Keep the velocity, the contacts of the next step stop the link
+    if (data.hit)
+      ODELink::MoveCallback(body);
+    else
+      dBodySetPosition(body, end.X(), end.Y(), end.Z());
+  }
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::CollideParallel()
+{
+  // Normal colliders come first, then trimesh colliders, as in the
+  // serial path.
+  const size_t normalCount = this->dataPtr->collidersCount;
+  const size_t count = normalCount + this->dataPtr->trimeshCollidersCount;
+  auto pair = [&](const size_t _index)
+      -> const std::pair<ODECollision*, ODECollision*> &
+  {
+    if (_index < normalCount)
+      return this->dataPtr->colliders[_index];
+    return this->dataPtr->trimeshColliders[_index - normalCount];
+  };
+
+  std::vector<ODENarrowPhaseResult> &results =
+    this->dataPtr->narrowPhaseResults;
+  if (results.size() < count)
+    results.resize(count);
+
+  for (auto &buffer : this->dataPtr->narrowPhaseBuffers)
+    buffer.geoms.clear();
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count),
+      [&](const tbb::blocked_range<size_t> &_r)
+  {
+    // Gives this thread its own trimesh collider cache.
+    dAllocateODEDataForThread(dAllocateMaskAll);
+    ODENarrowPhaseBuffer &buffer = this->dataPtr->narrowPhaseBuffers.local();
+
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+    {
+      ODECollision *collision1 = pair(i).first;
+      ODECollision *collision2 = pair(i).second;
+      ODENarrowPhaseResult &result = results[i];
+      result.count = 0;
+
+      // Heightfield geoms keep scratch memory in the geom itself, so
+      // those pairs are collided in the merge below.
+      result.serial = collision1->HasType(Base::HEIGHTMAP_SHAPE) ||
+                      collision2->HasType(Base::HEIGHTMAP_SHAPE);
+      if (result.serial)
+        continue;
+
+      result.count = this->GenerateContacts(collision1, collision2,
+          buffer.contactCollisions, result.contact);
+      if (result.count == 0)
+        continue;
+
+      result.geoms = &buffer.geoms;
+      result.offset = buffer.geoms.size();
+      buffer.geoms.insert(buffer.geoms.end(), buffer.contactCollisions,
+          buffer.contactCollisions + result.count);
+    }
+  });
+
+  // Create the joints in collider order, so the contact group is the same
+  // as with the serial narrow phase.
+  for (size_t i = 0; i < count; ++i)
+  {
+    ODECollision *collision1 = pair(i).first;
+    ODECollision *collision2 = pair(i).second;
+    ODENarrowPhaseResult &result = results[i];
+
+    if (result.serial)
+    {
+      this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
+    }
+    else if (result.count > 0)
+    {
+      this->AddContactJoints(collision1, collision2,
+          &(*result.geoms)[result.offset], result.count, result.contact);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::AddTrimeshCollider(ODECollision *_collision1,
                                     ODECollision *_collision2)
@@ -1359,6 +2217,296 @@ void ODEPhysics::AddCollider(ODECollision *_collision1,
   this->dataPtr->collidersCount++;
 }
 
+//////////////////////////////////////////////////
+/// \brief Append the filter records of the collisions of a model and its
+/// nested models.
+/// \param[in] _model The model.
+/// \param[in] _group Collision group of the top level model.
+/// \param[out] _filters Records are appended here.
+/// \param[out] _spaceGroups Collision group of each space.
+static void AppendCollisionFilters(const ModelPtr &_model,
+    const unsigned int _group, std::vector<ODECollisionFilter> &_filters,
+    std::unordered_map<dSpaceID, int> &_spaceGroups)
+{
+  for (auto const &link : _model->GetLinks())
+  {
+    for (auto const &collision : link->GetCollisions())
+    {
+      ODECollisionPtr odeCollision =
+          boost::dynamic_pointer_cast<ODECollision>(collision);
+      if (!odeCollision || !odeCollision->GetSurface())
+        continue;
+
+      SurfaceParamsPtr surface = odeCollision->GetSurface();
+      ODECollisionFilter filter;
+      filter.collision = odeCollision.get();
+      filter.collideBitmask = surface->collideBitmask;
+      filter.collideWithoutContactBitmask =
+          surface->collideWithoutContactBitmask;
+      filter.group = static_cast<uint8_t>(_group);
+      filter.collideWithoutContact = surface->collideWithoutContact;
+      filter.mesh = odeCollision->HasType(Base::MESH_SHAPE);
+
+      odeCollision->SetFilterIndex(_filters.size());
+      _filters.push_back(filter);
+
+      dSpaceID space = odeCollision->GetSpaceId();
+      if (space)
+      {
+        auto result = _spaceGroups.insert(
+            std::make_pair(space, static_cast<int>(_group)));
+        if (!result.second && result.first->second != static_cast<int>(_group))
+          result.first->second = -1;
+      }
+    }
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    AppendCollisionFilters(nested, _group, _filters, _spaceGroups);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::UpdateCollisionFilters()
+{
+  this->dataPtr->collisionFiltersDirty = false;
+  this->dataPtr->collisionFiltersGeneration = ODESurfaceParams::Generation();
+  this->dataPtr->collisionFilters.clear();
+  this->dataPtr->spaceCollisionGroups.clear();
+
+  for (auto const &model : this->world->Models())
+  {
+    AppendCollisionFilters(model, this->ModelCollisionGroup(model->GetName()),
+        this->dataPtr->collisionFilters,
+        this->dataPtr->spaceCollisionGroups);
+  }
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SetModelCollisionGroup(const std::string &_model,
+    const unsigned int _group)
+{
+  if (_group >= MaxCollisionGroups)
+  {
+    gzerr << "Collision group [" << _group << "] must be less than ["
+          << MaxCollisionGroups << "]" << std::endl;
+    return false;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  this->dataPtr->modelCollisionGroups[_model] = _group;
+  this->dataPtr->collisionFiltersDirty = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int ODEPhysics::ModelCollisionGroup(const std::string &_model) const
+{
+  auto it = this->dataPtr->modelCollisionGroups.find(_model);
+  if (it == this->dataPtr->modelCollisionGroups.end())
+    return 0;
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SetCollisionGroupsCollide(const unsigned int _group1,
+    const unsigned int _group2, const bool _collide)
+{
+  if (_group1 >= MaxCollisionGroups || _group2 >= MaxCollisionGroups)
+  {
+    gzerr << "Collision groups [" << _group1 << "] and [" << _group2
+          << "] must be less than [" << MaxCollisionGroups << "]"
+          << std::endl;
+    return false;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  std::vector<uint32_t> &matrix = this->dataPtr->collisionGroupMatrix;
+  if (_collide)
+  {
+    matrix[_group1] |= 1u << _group2;
+    matrix[_group2] |= 1u << _group1;
+  }
+  else
+  {
+    matrix[_group1] &= ~(1u << _group2);
+    matrix[_group2] &= ~(1u << _group1);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::CollisionGroupsCollide(const unsigned int _group1,
+    const unsigned int _group2) const
+{
+  if (_group1 >= MaxCollisionGroups || _group2 >= MaxCollisionGroups)
+    return true;
+  return this->dataPtr->GroupsCollide(_group1, _group2);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::InvalidateCollisionFilters()
+{
+  this->dataPtr->collisionFiltersDirty = true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Append the ODE joints of a model and its nested models, with
+/// the ids of the gazebo joints.
+/// \param[in] _model The model.
+/// \param[out] _joints Joints are appended here.
+static void SnapshotJoints(const ModelPtr &_model,
+    std::vector<std::pair<uint32_t, dJointID>> &_joints)
+{
+  for (auto const &joint : _model->GetJoints())
+  {
+    ODEJointPtr odeJoint = boost::dynamic_pointer_cast<ODEJoint>(joint);
+    if (odeJoint && odeJoint->GetODEId())
+      _joints.push_back(std::make_pair(joint->GetId(), odeJoint->GetODEId()));
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    SnapshotJoints(nested, _joints);
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the id of the gazebo link of an ODE body.
+/// \param[in] _body The body.
+/// \return The link, null for bodies that aren't links.
+static ODELink *SnapshotLink(dBodyID _body)
+{
+  return static_cast<ODELink *>(dBodyGetData(_body));
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::SaveODESnapshot(std::vector<double> &_state) const
+{
+  // Layout: body count, joint count, then per body the id of its link,
+  // position, quaternion, linear and angular velocity, force and torque
+  // accumulators and enabled flag, then per joint its id and the solver
+  // impulses used for warm starting. Bodies and joints are stored with
+  // the ids of their entities, so a restore doesn't depend on their order.
+  std::vector<std::pair<uint32_t, dJointID>> joints;
+  for (auto const &model : this->world->Models())
+    SnapshotJoints(model, joints);
+
+  const size_t countIndex = _state.size();
+  _state.push_back(0);
+  _state.push_back(joints.size());
+
+  size_t bodyCount = 0;
+  for (dBodyID b = dWorldGetFirstBody(this->dataPtr->worldId); b;
+       b = dBodyGetNextBody(b))
+  {
+    ODELink *link = SnapshotLink(b);
+    if (!link)
+      continue;
+
+    const dReal *pos = dBodyGetPosition(b);
+    const dReal *quat = dBodyGetQuaternion(b);
+    const dReal *linVel = dBodyGetLinearVel(b);
+    const dReal *angVel = dBodyGetAngularVel(b);
+    const dReal *force = dBodyGetForce(b);
+    const dReal *torque = dBodyGetTorque(b);
+
+    _state.insert(_state.end(), {static_cast<double>(link->GetId()),
+        pos[0], pos[1], pos[2],
+        quat[0], quat[1], quat[2], quat[3],
+        linVel[0], linVel[1], linVel[2],
+        angVel[0], angVel[1], angVel[2],
+        force[0], force[1], force[2],
+        torque[0], torque[1], torque[2],
+        static_cast<double>(dBodyIsEnabled(b))});
+    ++bodyCount;
+  }
+  _state[countIndex] = bodyCount;
+
+  dReal lambda[6];
+  dReal lambdaErp[6];
+  for (auto const &joint : joints)
+  {
+    dJointGetWarmStart(joint.second, lambda, lambdaErp);
+    _state.push_back(joint.first);
+    _state.insert(_state.end(), lambda, lambda + 6);
+    _state.insert(_state.end(), lambdaErp, lambdaErp + 6);
+  }
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::RestoreODESnapshot(const std::vector<double> &_state)
+{
+  std::unordered_map<uint32_t, dBodyID> bodies;
+  for (dBodyID b = dWorldGetFirstBody(this->dataPtr->worldId); b;
+       b = dBodyGetNextBody(b))
+  {
+    ODELink *link = SnapshotLink(b);
+    if (link)
+      bodies[link->GetId()] = b;
+  }
+
+  std::vector<std::pair<uint32_t, dJointID>> jointList;
+  for (auto const &model : this->world->Models())
+    SnapshotJoints(model, jointList);
+  std::unordered_map<uint32_t, dJointID> joints(jointList.begin(),
+      jointList.end());
+
+  const size_t bodySize = 21;
+  const size_t jointSize = 13;
+  bool valid = _state.size() >= 2 &&
+      static_cast<size_t>(_state[0]) == bodies.size() &&
+      static_cast<size_t>(_state[1]) == joints.size() &&
+      _state.size() == 2 + bodies.size() * bodySize +
+      joints.size() * jointSize;
+
+  // Every stored body and joint must still exist
+  const double *v = _state.data() + 2;
+  for (size_t i = 0; valid && i < bodies.size(); ++i, v += bodySize)
+    valid = bodies.count(static_cast<uint32_t>(v[0])) > 0;
+  for (size_t i = 0; valid && i < joints.size(); ++i, v += jointSize)
+    valid = joints.count(static_cast<uint32_t>(v[0])) > 0;
+
+  if (!valid)
+  {
+    gzerr << "Snapshot does not match the bodies and joints of world ["
+          << this->world->Name() << "]\n";
+    return false;
+  }
+
+  v = _state.data() + 2;
+  for (size_t i = 0; i < bodies.size(); ++i, v += bodySize)
+  {
+    dBodyID b = bodies[static_cast<uint32_t>(v[0])];
+    dBodySetPosition(b, v[1], v[2], v[3]);
+
+    const dReal quat[4] = {v[4], v[5], v[6], v[7]};
+    dBodySetQuaternion(b, quat);
+    dBodySetLinearVel(b, v[8], v[9], v[10]);
+    dBodySetAngularVel(b, v[11], v[12], v[13]);
+    dBodySetForce(b, v[14], v[15], v[16]);
+    dBodySetTorque(b, v[17], v[18], v[19]);
+
+    if (v[20] > 0.5)
+      dBodyEnable(b);
+    else
+      dBodyDisable(b);
+
+    // Propagate the pose to the gazebo link, the world applies it when it
+    // drains its dirty poses.
+    ODELink::MoveCallback(b);
+  }
+
+  dReal lambda[6];
+  dReal lambdaErp[6];
+  for (size_t i = 0; i < joints.size(); ++i, v += jointSize)
+  {
+    std::copy(v + 1, v + 7, lambda);
+    std::copy(v + 7, v + 13, lambdaErp);
+    dJointSetWarmStart(joints[static_cast<uint32_t>(v[0])], lambda,
+        lambdaErp);
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::DebugPrint() const
 {
@@ -1555,6 +2703,79 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       }
       dWorldSetIslandThreads(this->dataPtr->worldId, value);
     }
+    else if (_key == "row_threads")
+    {
+      int value;
+      try
+      {
+        value = any_cast<int>(_value);
+      }
+      catch(const boost::bad_any_cast &e)
+      {
+        gzerr << "boost any_cast error:" << e.what() << "\n";
+        return false;
+      }
+      dWorldSetQuickStepThreads(this->dataPtr->worldId, value);
+    }
+    else if (_key == "deterministic_rows")
+    {
+      dWorldSetQuickStepDeterministicRows(this->dataPtr->worldId,
+        any_cast<bool>(_value));
+    }
+    else if (_key == "contact_warm_start")
+    {
+      this->dataPtr->contactWarmStart = any_cast<bool>(_value);
+      if (!this->dataPtr->contactWarmStart)
+      {
+        this->dataPtr->contactImpulses.clear();
+        this->dataPtr->prevContactImpulses.clear();
+        this->dataPtr->warmStartContacts = 0;
+        this->dataPtr->warmStartHits = 0;
+      }
+    }
+    else if (_key == "contact_warm_start_distance")
+    {
+      double value = any_cast<double>(_value);
+      if (value < 0)
+      {
+        gzerr << "contact_warm_start_distance must be positive\n";
+        return false;
+      }
+      this->dataPtr->contactWarmStartDistance = value;
+    }
+    else if (_key == "parallel_narrow_phase")
+      this->dataPtr->parallelNarrowPhase = any_cast<bool>(_value);
+    else if (_key == "mesh_convex_decomposition")
+      this->dataPtr->meshConvexDecomposition = any_cast<bool>(_value);
+    else if (_key == "contact_manifold_reduction")
+      this->dataPtr->contactManifoldReduction = any_cast<bool>(_value);
+    else if (_key == "contact_manifold_distance")
+    {
+      double value = any_cast<double>(_value);
+      if (value < 0)
+      {
+        gzerr << "contact_manifold_distance must be positive\n";
+        return false;
+      }
+      this->dataPtr->contactManifolds.SetDistance(value);
+    }
+    else if (_key == "step_memory_huge_pages")
+      ODEStepMemory::SetHugePages(any_cast<bool>(_value));
+    else if (_key == "step_memory_reserve_factor")
+    {
+      double value = any_cast<double>(_value);
+      if (value < 1)
+      {
+        gzerr << "step_memory_reserve_factor must be at least 1\n";
+        return false;
+      }
+      this->dataPtr->stepMemoryReserveFactor = value;
+      this->dataPtr->ApplyStepMemoryPolicy();
+    }
+    else if (_key == "collision_space")
+      return this->SetCollisionSpaceType(any_cast<std::string>(_value));
+    else if (_key == "narrow_phase")
+      return this->SetNarrowPhaseType(any_cast<std::string>(_value));
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = any_cast<bool>(_value);
@@ -1662,6 +2883,53 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->GetFrictionModel();
   else if (_key == "island_threads")
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
+  else if (_key == "row_threads")
+    _value = dWorldGetQuickStepThreads(this->dataPtr->worldId);
+  else if (_key == "deterministic_rows")
+    _value = dWorldGetQuickStepDeterministicRows(this->dataPtr->worldId);
+  else if (_key == "contact_warm_start")
+    _value = this->dataPtr->contactWarmStart;
+  else if (_key == "contact_warm_start_distance")
+    _value = this->dataPtr->contactWarmStartDistance;
+  else if (_key == "contact_warm_start_hit_rate")
+  {
+    // Fraction of the contacts of the last collision update that were
+    // seeded from the previous step
+    double hitRate = 0;
+    if (this->dataPtr->warmStartContacts > 0)
+    {
+      hitRate = static_cast<double>(this->dataPtr->warmStartHits) /
+          this->dataPtr->warmStartContacts;
+    }
+    _value = hitRate;
+  }
+  else if (_key == "precision")
+  {
+    // Fixed at build time, see ODE_SINGLE_PRECISION
+    _value = std::string(sizeof(dReal) == sizeof(float) ? "single" : "double");
+  }
+  else if (_key == "parallel_narrow_phase")
+    _value = this->dataPtr->parallelNarrowPhase;
+  else if (_key == "mesh_convex_decomposition")
+    _value = this->dataPtr->meshConvexDecomposition;
+  else if (_key == "contact_manifold_reduction")
+    _value = this->dataPtr->contactManifoldReduction;
+  else if (_key == "contact_manifold_distance")
+    _value = this->dataPtr->contactManifolds.Distance();
+  else if (_key == "step_memory_huge_pages")
+    _value = ODEStepMemory::HugePages();
+  else if (_key == "step_memory_reserve_factor")
+    _value = this->dataPtr->stepMemoryReserveFactor;
+  else if (_key == "step_memory_reserve")
+    _value = this->dataPtr->stepMemoryReserve;
+  else if (_key == "step_memory_bytes")
+    _value = ODEStepMemory::Stats().bytes;
+  else if (_key == "step_memory_high_water")
+    _value = ODEStepMemory::Stats().highWater;
+  else if (_key == "collision_space")
+    _value = this->GetCollisionSpaceType();
+  else if (_key == "narrow_phase")
+    _value = this->GetNarrowPhaseType();
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
   else if (_key == "world_step_solver")
@@ -92,6 +92,9 @@ namespace gazebo
         WORLD_SOLVER_TYPE
       };
 
+      /// \brief Number of collision groups, see SetModelCollisionGroup.
+      public: static const unsigned int MaxCollisionGroups = 32;
+
       /// \brief Constructor.
       /// \param[in] _world The World that uses this physics engine.
       public: explicit ODEPhysics(WorldPtr _world);
@@ -172,6 +175,71 @@ namespace gazebo
       public: virtual void
               SetWorldStepSolverType(const std::string &_worldSolverType);
 
+      /// \brief Set the type of the top level collision space. The geoms
+      /// of the current space are moved to the new one.
+      /// \param[in] _type "hash" (default) or "bvh", a persistent dynamic
+      /// AABB tree that only updates the geoms that moved.
+      /// \return False if the type is unknown.
+      public: bool SetCollisionSpaceType(const std::string &_type);
+
+      /// \brief Set the library that generates the contacts of the pairs
+      /// found by the collision space.
+      /// \param[in] _type "ode" (default) or "fcl", which sends the pairs of
+      /// boxes, spheres, capsules, cylinders, planes and triangle meshes to
+      /// FCL. Only available when gazebo is built with
+      /// ENABLE_FCL_NARROW_PHASE.
+      /// \return False if the type is unknown or not available.
+      public: bool SetNarrowPhaseType(const std::string &_type);
+
+      /// \brief Add or remove a link from the links swept after each step
+      /// to keep them from tunnelling. Called by ODELink, see
+      /// Link::SetContinuousCollision.
+      /// \param[in] _link The link.
+      /// \param[in] _enable True to sweep the link.
+      public: void SetContinuousCollisionLink(ODELink *_link,
+                  const bool _enable);
+
+      /// \brief Put a model in a collision group. Pairs of models whose
+      /// groups don't collide are rejected by the broadphase, before their
+      /// collisions are looked at. Nested models are in the group of their
+      /// top level model. Models are in group 0 by default.
+      /// \param[in] _model Name of the top level model.
+      /// \param[in] _group The group, less than MaxCollisionGroups.
+      /// \return False if the group is out of range.
+      /// \sa SetCollisionGroupsCollide
+      public: bool SetModelCollisionGroup(const std::string &_model,
+                  const unsigned int _group);
+
+      /// \brief Get the collision group of a model.
+      /// \param[in] _model Name of the top level model.
+      /// \return The group.
+      public: unsigned int ModelCollisionGroup(
+                  const std::string &_model) const;
+
+      /// \brief Set whether the models of two collision groups collide.
+      /// All groups collide by default.
+      /// \param[in] _group1 The first group.
+      /// \param[in] _group2 The second group, may be the first one.
+      /// \param[in] _collide True if the groups collide.
+      /// \return False if a group is out of range.
+      public: bool SetCollisionGroupsCollide(const unsigned int _group1,
+                  const unsigned int _group2, const bool _collide);
+
+      /// \brief Get whether the models of two collision groups collide.
+      /// \param[in] _group1 The first group.
+      /// \param[in] _group2 The second group.
+      /// \return True if the groups collide, or a group is out of range.
+      public: bool CollisionGroupsCollide(const unsigned int _group1,
+                  const unsigned int _group2) const;
+
+      /// \brief Refresh the collision filters before the next collision
+      /// update. The filters keep the collision group and the bitmasks of
+      /// the surface of each collision, and are refreshed when collisions
+      /// are created or surface parameters are loaded or updated from a
+      /// message. Call this after changing the bitmasks of a surface
+      /// directly.
+      public: void InvalidateCollisionFilters();
+
       // Documentation inherited
       public: virtual void SetMaxContacts(unsigned int max_contacts);
 
@@ -201,6 +269,14 @@ namespace gazebo
       /// \return Type of solver used by world step.
       public: virtual std::string GetWorldStepSolverType() const;
 
+      /// \brief Get the type of the top level collision space.
+      /// \return "hash" or "bvh".
+      public: std::string GetCollisionSpaceType() const;
+
+      /// \brief Get the library that generates the contacts.
+      /// \return "ode" or "fcl".
+      public: std::string GetNarrowPhaseType() const;
+
       // Documentation inherited
       public: virtual double GetContactSurfaceLayer();
 
@@ -228,6 +304,13 @@ namespace gazebo
       /// \return The space id for the world.
       public: dSpaceID GetSpaceId() const;
 
+      /// \brief Get the space shared by the collisions of the compact
+      /// static models. It is a BVH space inside the world space, whose
+      /// category and collide bits are left to its geoms.
+      /// \return The space id, or null if there is no such model.
+      /// \sa World::SetCompactStaticModels
+      public: dSpaceID StaticSpaceId() const;
+
       /// \brief Get the world id.
       /// \return The world id.
       public: dWorldID GetWorldId();
@@ -271,12 +354,16 @@ namespace gazebo
       public: static World_Solver_Type
               ConvertWorldStepSolverType(const std::string &_solverType);
 
-      /// \brief Get the step type (quick, world).
+      /// \brief Get the step type (quick, world, parallel_quick).
       /// \return The step type.
       public: virtual std::string GetStepType() const;
 
-      /// \brief Set the step type (quick, world).
-      /// \param[in] _type The step type (quick or world).
+      /// \brief Set the step type (quick, world, parallel_quick).
+      /// The parallel_quick step type solves all islands in one batched
+      /// PGS solve from deps/parallel_quickstep, using OpenMP unless another
+      /// backend was selected at build time. It falls back to quick when
+      /// gazebo is built without ENABLE_PARALLEL_QUICKSTEP.
+      /// \param[in] _type The step type (quick, world or parallel_quick).
       public: virtual void SetStepType(const std::string &_type);
 
 
@@ -287,6 +374,86 @@ namespace gazebo
       public: void Collide(ODECollision *_collision1, ODECollision *_collision2,
                            dContactGeom *_contactCollisions);
 
+      /// \brief Run dCollide on two collision objects and compute the
+      /// surface parameters of their contacts. This does not modify the
+      /// engine, so it can run concurrently for different pairs. The kept
+      /// contacts are moved to the front of _contactCollisions.
+      /// \param[in] _collision1 First collision object.
+      /// \param[in] _collision2 Second collision object.
+      /// \param[in,out] _contactCollisions Array of MAX_COLLIDE_RETURNS
+      /// contacts.
+      /// \param[out] _contact Surface parameters of the contacts.
+      /// \return Number of contacts to create.
+      private: unsigned int GenerateContacts(ODECollision *_collision1,
+                   ODECollision *_collision2,
+                   dContactGeom *_contactCollisions, dContact &_contact);
+
+      /// \brief Create the contact joints and contact feedback of a
+      /// collider pair, from the output of GenerateContacts.
+      /// \param[in] _collision1 First collision object.
+      /// \param[in] _collision2 Second collision object.
+      /// \param[in] _contactGeoms Contacts of the pair.
+      /// \param[in] _count Number of contacts.
+      /// \param[in] _contact Surface parameters of the contacts.
+      private: void AddContactJoints(ODECollision *_collision1,
+                   ODECollision *_collision2,
+                   const dContactGeom *_contactGeoms, const unsigned int _count,
+                   dContact &_contact);
+
+      /// \brief Convert the contact feedbacks of the last step to link
+      /// frame wrenches. Called by the contact manager the first time the
+      /// contacts are accessed after a step.
+      private: void UpdateContactWrenches();
+
+      /// \brief Read back the impulses of the contacts of the last step,
+      /// before the contact joints are destroyed.
+      private: void SaveContactImpulses();
+
+      /// \brief Seed the impulses of a new contact joint from the closest
+      /// contact of the same geom pair in the previous step, if it is
+      /// within contact_warm_start_distance and has a similar normal.
+      /// \param[in] _joint The new contact joint.
+      /// \param[in] _geom1 First geom of the collision pair.
+      /// \param[in] _geom2 Second geom of the collision pair.
+      /// \param[in] _contactGeom The contact.
+      private: void WarmStartContact(dJointID _joint, dGeomID _geom1,
+                   dGeomID _geom2, const dContactGeom &_contactGeom);
+
+      /// \brief Narrow phase of all the colliders on the thread pool.
+      /// Contacts are generated concurrently into per thread buffers, then
+      /// the contact joints are created serially in collider order, so the
+      /// result is the same as the serial path.
+      private: void CollideParallel();
+
+      /// \brief Conservative advancement of the continuous collision links
+      /// that moved by more than their size during the last step. Each link
+      /// is moved back along its path to the first position where it
+      /// overlaps another collision, in steps smaller than its size, so the
+      /// next step creates the contacts it would have skipped.
+      private: void SweepContinuousCollisionLinks();
+
+      /// \brief Step the world, then the models that have substeps, see
+      /// Model::SetPhysicsSubsteps. The bodies of those models are left out
+      /// of the world step, then each model is stepped alone at its rate,
+      /// with the contacts of the world step. A model connected to another
+      /// dynamic model is stepped with the world instead.
+      /// \return False if no model has substeps, the world wasn't stepped.
+      private: bool StepSubsteppedModels();
+
+      /// \brief Rebuild the collision filters of all the collisions.
+      private: void UpdateCollisionFilters();
+
+      /// \brief Append the state of the ODE bodies and joints to a buffer,
+      /// see PhysicsEngine::SaveSnapshot.
+      /// \param[out] _state Buffer the state is appended to.
+      private: void SaveODESnapshot(std::vector<double> &_state) const;
+
+      /// \brief Restore a state saved with SaveODESnapshot, see
+      /// PhysicsEngine::RestoreSnapshot.
+      /// \param[in] _state State written by SaveODESnapshot.
+      /// \return False if the state does not match the bodies and joints.
+      private: bool RestoreODESnapshot(const std::vector<double> &_state);
+
       /// \brief process joint feedbacks.
       /// \param[in] _feedback ODE Joint Contact feedback information.
       public: void ProcessJointFeedback(ODEJointFeedback *_feedback);
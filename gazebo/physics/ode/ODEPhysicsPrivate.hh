@@ -18,14 +18,37 @@
 #ifndef _ODEPHYSICS_PRIVATE_HH_
 #define _ODEPHYSICS_PRIVATE_HH_
 
+#include <tbb/enumerable_thread_specific.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/gazebo_config.h"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactPoint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/PhysicsEnginePrivate.hh"
+#include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEContactManifolds.hh"
+#include "gazebo/physics/ode/ODEPhysics.hh"
+#include "gazebo/physics/ode/ODEStepMemory.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 
+#ifdef HAVE_FCL
+#include "gazebo/physics/ode/ODEFCLCollider.hh"
+#endif
+
 namespace gazebo
 {
   namespace physics
@@ -43,6 +66,176 @@ namespace gazebo
 
       /// \brief Contact joint feedback information.
       public: dJointFeedback feedbacks[MAX_CONTACT_JOINTS];
+
+      /// \brief World orientation of the first link, at the end of the
+      /// step.
+      public: ignition::math::Quaterniond rot1;
+
+      /// \brief World orientation of the second link, at the end of the
+      /// step.
+      public: ignition::math::Quaterniond rot2;
+    };
+
+    /// \brief Pool of contact feedbacks. Entries are allocated in blocks
+    /// that are kept until Clear, so the pool only allocates when a step
+    /// has more contacts than the high-water mark, and entries never move.
+    class ODEJointFeedbackPool
+    {
+      /// \brief Get the next free entry, growing the pool if needed.
+      /// \return The entry.
+      public: ODEJointFeedback *Acquire()
+      {
+        const size_t block = this->count / BlockSize;
+        if (block == this->blocks.size())
+        {
+          this->blocks.push_back(std::unique_ptr<ODEJointFeedback[]>(
+              new ODEJointFeedback[BlockSize]));
+        }
+        return &this->blocks[block][this->count++ % BlockSize];
+      }
+
+      /// \brief Get an entry in use.
+      /// \param[in] _index Index of the entry, less than Count.
+      /// \return The entry.
+      public: ODEJointFeedback *At(const size_t _index) const
+      {
+        return &this->blocks[_index / BlockSize][_index % BlockSize];
+      }
+
+      /// \brief Number of entries in use.
+      /// \return Entries acquired since the last Reset.
+      public: size_t Count() const
+      {
+        return this->count;
+      }
+
+      /// \brief Number of allocated entries, the high-water mark rounded
+      /// up to a whole block.
+      /// \return Allocated entries.
+      public: size_t Capacity() const
+      {
+        return this->blocks.size() * BlockSize;
+      }
+
+      /// \brief Release all the entries, keeping the memory.
+      public: void Reset()
+      {
+        this->count = 0;
+      }
+
+      /// \brief Free the memory.
+      public: void Clear()
+      {
+        this->blocks.clear();
+        this->count = 0;
+      }
+
+      /// \brief Number of entries per block.
+      private: static const size_t BlockSize = 16;
+
+      /// \brief Blocks of entries.
+      private: std::vector<std::unique_ptr<ODEJointFeedback[]>> blocks;
+
+      /// \brief Number of entries in use.
+      private: size_t count = 0;
+    };
+
+    /// \brief Contacts found by the narrow phase for one collider pair.
+    class ODENarrowPhaseResult
+    {
+      /// \brief Surface parameters shared by all the contacts of the pair.
+      public: dContact contact;
+
+      /// \brief Buffer of the worker that collided the pair.
+      public: const std::vector<dContactGeom> *geoms = nullptr;
+
+      /// \brief Index of the first contact of the pair in geoms.
+      public: size_t offset = 0;
+
+      /// \brief Number of contacts, 0 if the pair is not touching.
+      public: unsigned int count = 0;
+
+      /// \brief True if the pair must be collided on the calling thread.
+      public: bool serial = false;
+    };
+
+    /// \brief Scratch memory of a narrow phase worker thread.
+    class ODENarrowPhaseBuffer
+    {
+      /// \brief Output of dCollide.
+      public: dContactGeom contactCollisions[MAX_COLLIDE_RETURNS];
+
+      /// \brief Contacts kept for all the pairs handled by this worker.
+      public: std::vector<dContactGeom> geoms;
+    };
+
+    /// \brief Constraint impulses of a contact, kept for one step to warm
+    /// start the matching contact of the next step.
+    class ODEContactImpulse
+    {
+      /// \brief First geom of the collision pair.
+      public: dGeomID geom1 = nullptr;
+
+      /// \brief Second geom of the collision pair.
+      public: dGeomID geom2 = nullptr;
+
+      /// \brief Contact joint, only valid until the contact group is
+      /// emptied.
+      public: dJointID joint = nullptr;
+
+      /// \brief Contact position in the world frame.
+      public: dVector3 pos;
+
+      /// \brief Contact normal in the world frame.
+      public: dVector3 normal;
+
+      /// \brief Impulses of the contact rows.
+      public: dReal lambda[6];
+
+      /// \brief Position correction impulses of the contact rows.
+      public: dReal lambdaErp[6];
+    };
+
+    /// \brief Filter record of a collision, refreshed only when collisions
+    /// or surfaces change, so that the collision callback rejects pairs
+    /// without looking at the collisions.
+    class ODECollisionFilter
+    {
+      /// \brief The collision.
+      public: ODECollision *collision = nullptr;
+
+      /// \brief Collide bitmask of the surface.
+      public: unsigned int collideBitmask = 0;
+
+      /// \brief Collide without contact bitmask of the surface.
+      public: unsigned int collideWithoutContactBitmask = 0;
+
+      /// \brief Collision group of the model.
+      public: uint8_t group = 0;
+
+      /// \brief Collide without contact flag of the surface.
+      public: bool collideWithoutContact = false;
+
+      /// \brief True if the collision is a triangle mesh.
+      public: bool mesh = false;
+    };
+
+    /// \brief Body of a model stepped at a finer rate than the world, see
+    /// Model::SetPhysicsSubsteps.
+    class ODESubstepBody
+    {
+      /// \brief The body.
+      public: dBodyID id = nullptr;
+
+      /// \brief Force applied during the world step, reapplied before each
+      /// substep since ODE clears it after a step.
+      public: dVector3 force;
+
+      /// \brief Torque applied during the world step.
+      public: dVector3 torque;
+
+      /// \brief True if the body is still enabled after its substeps.
+      public: bool enabled = true;
     };
 
     class ODEPhysicsPrivate
@@ -53,14 +246,45 @@ namespace gazebo
       /// \brief Top-level space for all sub-spaces/collisions
       public: dSpaceID spaceId;
 
+      /// \brief Type of spaceId, "hash" or "bvh".
+      public: std::string spaceType = "hash";
+
       /// \brief Collision attributes
       public: dJointGroupID contactGroup;
 
       /// \brief The type of the solver.
       public: std::string stepType;
 
-      /// \brief Buffer of contact feedback information.
-      public: std::vector<ODEJointFeedback*> jointFeedbacks;
+      /// \brief Get the world orientation of a link, computed once per
+      /// step.
+      /// \param[in] _link The link.
+      /// \return Orientation of the link.
+      public: const ignition::math::Quaterniond &LinkRotation(
+                  const LinkPtr &_link)
+      {
+        auto iter = this->linkRotations.find(_link.get());
+        if (iter == this->linkRotations.end())
+        {
+          iter = this->linkRotations.insert(
+              std::make_pair(_link.get(), _link->WorldPose().Rot())).first;
+        }
+        return iter->second;
+      }
+
+      /// \brief Pool of contact feedback information.
+      public: ODEJointFeedbackPool jointFeedbacks;
+
+      /// \brief Contact points passed to the contact callbacks, kept from
+      /// step to step to reuse the memory.
+      public: std::vector<ContactPoint> contactPoints;
+
+      /// \brief Private data of the PhysicsEngine, which holds the contact
+      /// callbacks. Kept here to avoid looking it up for each contact.
+      public: PhysicsEnginePrivate *engineData = nullptr;
+
+      /// \brief Link orientations of the current step, see LinkRotation.
+      public: std::unordered_map<const Link *, ignition::math::Quaterniond>
+              linkRotations;
 
       /// \brief Physics step function.
       public: int (*physicsStepFunc)(dxWorld*, dReal);
@@ -68,6 +292,10 @@ namespace gazebo
       /// \brief All the collsiion spaces.
       public: std::map<std::string, dSpaceID> spaces;
 
+      /// \brief Space of the collisions of the compact static models, see
+      /// World::SetCompactStaticModels. Null until the first such model.
+      public: dSpaceID staticSpaceId = nullptr;
+
       /// \brief All the normal colliders.
       public: std::vector< std::pair<ODECollision*, ODECollision*> > colliders;
 
@@ -78,12 +306,6 @@ namespace gazebo
       /// \brief Array of contact collisions.
       public: dContactGeom contactCollisions[MAX_COLLIDE_RETURNS];
 
-      /// \brief Indices used during creation of contact joints.
-      public: int indices[MAX_CONTACT_JOINTS];
-
-      /// \brief Current index into the contactFeedbacks buffer
-      public: unsigned int jointFeedbackIndex;
-
       /// \brief Number of normal colliders.
       public: unsigned int collidersCount;
 
@@ -92,6 +314,188 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief True to run the narrow phase on the thread pool.
+      public: bool parallelNarrowPhase = false;
+
+      /// \brief True to collide meshes with their convex decomposition.
+      public: bool meshConvexDecomposition = false;
+
+      /// \brief True to reduce the contacts of each pair to a manifold of
+      /// at most four contacts, kept across steps.
+      public: bool contactManifoldReduction = false;
+
+      /// \brief Contact manifolds, used if contactManifoldReduction is true.
+      public: ODEContactManifolds contactManifolds;
+
+      /// \brief Extra reserve factor of the step memory, see
+      /// dWorldStepReserveInfo.
+      public: double stepMemoryReserveFactor =
+                  dWORLDSTEP_RESERVEFACTOR_DEFAULT;
+
+      /// \brief Minimum size of the step memory, raised to the high water
+      /// mark of ODEStepMemory.
+      public: uint64_t stepMemoryReserve = dWORLDSTEP_RESERVESIZE_DEFAULT;
+
+      /// \brief Apply stepMemoryReserveFactor and stepMemoryReserve to the
+      /// world.
+      public: void ApplyStepMemoryPolicy()
+      {
+        dWorldStepReserveInfo info;
+        info.struct_size = sizeof(info);
+        info.reserve_factor = static_cast<float>(this->stepMemoryReserveFactor);
+        info.reserve_minimum = static_cast<unsigned>(std::min<uint64_t>(
+            this->stepMemoryReserve, std::numeric_limits<unsigned>::max()));
+        dWorldSetStepMemoryReservationPolicy(this->worldId, &info);
+      }
+
+      /// \brief Filter records, indexed by ODECollision::FilterIndex.
+      public: std::vector<ODECollisionFilter> collisionFilters;
+
+      /// \brief Collision group of the models of each space, -1 if the
+      /// space has models of several groups.
+      public: std::unordered_map<dSpaceID, int> spaceCollisionGroups;
+
+      /// \brief Collision group of the top level models, by name.
+      public: std::map<std::string, unsigned int> modelCollisionGroups;
+
+      /// \brief Bit j of element i is set if groups i and j collide.
+      public: std::vector<uint32_t> collisionGroupMatrix =
+              std::vector<uint32_t>(ODEPhysics::MaxCollisionGroups, ~0u);
+
+      /// \brief True to rebuild the filter records.
+      public: bool collisionFiltersDirty = true;
+
+      /// \brief Surface generation of the filter records, see
+      /// ODESurfaceParams::Generation.
+      public: uint64_t collisionFiltersGeneration = 0;
+
+      /// \brief Get the filter record of a collision.
+      /// \param[in] _collision The collision.
+      /// \return The record, null if the collision has none yet.
+      public: const ODECollisionFilter *CollisionFilter(
+                  const ODECollision *_collision) const
+      {
+        const unsigned int index = _collision->FilterIndex();
+        if (index < this->collisionFilters.size() &&
+            this->collisionFilters[index].collision == _collision)
+        {
+          return &this->collisionFilters[index];
+        }
+        return nullptr;
+      }
+
+      /// \brief Get whether two collision groups collide.
+      /// \param[in] _group1 The first group.
+      /// \param[in] _group2 The second group.
+      /// \return True if they collide.
+      public: bool GroupsCollide(const unsigned int _group1,
+                  const unsigned int _group2) const
+      {
+        return (this->collisionGroupMatrix[_group1] >> _group2) & 1u;
+      }
+
+      /// \brief Get whether the models of two spaces may collide.
+      /// \param[in] _space1 The first space.
+      /// \param[in] _space2 The second space.
+      /// \return False if their groups don't collide.
+      public: bool SpacesCollide(dSpaceID _space1, dSpaceID _space2) const
+      {
+        auto it1 = this->spaceCollisionGroups.find(_space1);
+        auto it2 = this->spaceCollisionGroups.find(_space2);
+        if (it1 == this->spaceCollisionGroups.end() || it1->second < 0 ||
+            it2 == this->spaceCollisionGroups.end() || it2->second < 0)
+        {
+          return true;
+        }
+        return this->GroupsCollide(it1->second, it2->second);
+      }
+
+      /// \brief Bodies of the models stepped at a finer rate, grouped by
+      /// model.
+      public: std::vector<ODESubstepBody> substepBodies;
+
+      /// \brief Number of substeps of each model in substepBodies, with the
+      /// end of its bodies.
+      public: std::vector<std::pair<unsigned int, size_t>> substepGroups;
+
+      /// \brief Bodies left out of the substeps.
+      public: std::vector<dBodyID> substepFrozenBodies;
+
+      /// \brief Get whether the bodies of a model, from _begin to the end
+      /// of substepBodies, are connected to a dynamic body of another model
+      /// by an enabled joint or contact.
+      /// \param[in] _begin Index of the first body of the model.
+      /// \return True if the model is coupled to another model.
+      public: bool SubstepBodiesCoupled(const size_t _begin) const
+      {
+        auto first = this->substepBodies.begin() + _begin;
+        auto last = this->substepBodies.end();
+        for (auto it = first; it != last; ++it)
+        {
+          for (int i = 0; i < dBodyGetNumJoints(it->id); ++i)
+          {
+            dJointID joint = dBodyGetJoint(it->id, i);
+            if (!dJointIsEnabled(joint))
+              continue;
+
+            for (int j = 0; j < 2; ++j)
+            {
+              dBodyID other = dJointGetBody(joint, j);
+              if (other && std::find_if(first, last,
+                    [other](const ODESubstepBody &_body)
+                    {
+                      return _body.id == other;
+                    }) == last)
+              {
+                return true;
+              }
+            }
+          }
+        }
+        return false;
+      }
+
+      /// \brief Links that use continuous collision detection.
+      public: std::set<ODELink *> continuousCollisionLinks;
+
+      /// \brief Position of the continuous collision links before the
+      /// current step.
+      public: std::vector<std::pair<ODELink *, ignition::math::Vector3d>>
+              continuousCollisionStarts;
+
+#ifdef HAVE_FCL
+      /// \brief FCL narrow phase, null when ODE generates the contacts.
+      public: std::unique_ptr<ODEFCLCollider> fclCollider;
+#endif
+
+      /// \brief Narrow phase output, one per collider. Normal colliders
+      /// come first, then trimesh colliders.
+      public: std::vector<ODENarrowPhaseResult> narrowPhaseResults;
+
+      /// \brief Per thread narrow phase scratch memory.
+      public: tbb::enumerable_thread_specific<ODENarrowPhaseBuffer>
+              narrowPhaseBuffers;
+
+      /// \brief True to seed the impulses of new contacts from the
+      /// matching contacts of the previous step.
+      public: bool contactWarmStart = false;
+
+      /// \brief Maximum distance between two matching contacts.
+      public: double contactWarmStartDistance = 0.01;
+
+      /// \brief Contacts created by the current collision update.
+      public: std::vector<ODEContactImpulse> contactImpulses;
+
+      /// \brief Contacts of the previous step, sorted by geom pair.
+      public: std::vector<ODEContactImpulse> prevContactImpulses;
+
+      /// \brief Number of contacts of the last collision update.
+      public: unsigned int warmStartContacts = 0;
+
+      /// \brief Number of contacts of the last collision update that
+      /// matched a contact of the previous step.
+      public: unsigned int warmStartHits = 0;
     };
   }
 }
@@ -16,9 +16,16 @@
 */
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/gazebo_config.h"
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -320,6 +327,181 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
     }
   }
 
+  // Test row_threads
+  {
+    // row_threads should be 0 by default
+    int rowThreads = 1;
+    EXPECT_NO_THROW(rowThreads =
+      boost::any_cast<int>(odePhysics->GetParam("row_threads")));
+    EXPECT_FALSE(rowThreads);
+
+    // try enabling threads, then disabling
+    std::vector<int> threads = {1, 2, 3, 0};
+    for (auto const rowThreadsSet : threads)
+    {
+      odePhysics->SetParam("row_threads", rowThreadsSet);
+      EXPECT_NO_THROW(rowThreads =
+        boost::any_cast<int>(odePhysics->GetParam("row_threads")));
+      EXPECT_EQ(rowThreads, rowThreadsSet);
+    }
+  }
+
+  // Test deterministic_rows
+  {
+    // deterministic_rows should be on by default
+    bool deterministic = false;
+    EXPECT_NO_THROW(deterministic = boost::any_cast<bool>(
+      odePhysics->GetParam("deterministic_rows")));
+    EXPECT_TRUE(deterministic);
+
+    // try turning it off, then on again
+    std::vector<bool> bools = {false, true};
+    for (const bool deterministicSet : bools)
+    {
+      odePhysics->SetParam("deterministic_rows", deterministicSet);
+      EXPECT_NO_THROW(deterministic = boost::any_cast<bool>(
+        odePhysics->GetParam("deterministic_rows")));
+      EXPECT_EQ(deterministic, deterministicSet);
+    }
+  }
+
+  // Test contact_warm_start
+  {
+    // contact_warm_start should be off by default
+    bool warmStart = true;
+    EXPECT_NO_THROW(warmStart = boost::any_cast<bool>(
+      odePhysics->GetParam("contact_warm_start")));
+    EXPECT_FALSE(warmStart);
+
+    // try turning it on, then off again
+    std::vector<bool> bools = {true, false};
+    for (const bool warmStartSet : bools)
+    {
+      odePhysics->SetParam("contact_warm_start", warmStartSet);
+      EXPECT_NO_THROW(warmStart = boost::any_cast<bool>(
+        odePhysics->GetParam("contact_warm_start")));
+      EXPECT_EQ(warmStart, warmStartSet);
+    }
+
+    double distance = 0;
+    EXPECT_TRUE(odePhysics->SetParam("contact_warm_start_distance", 0.02));
+    EXPECT_NO_THROW(distance = boost::any_cast<double>(
+      odePhysics->GetParam("contact_warm_start_distance")));
+    EXPECT_DOUBLE_EQ(distance, 0.02);
+
+    // negative distances are rejected
+    EXPECT_FALSE(odePhysics->SetParam("contact_warm_start_distance", -1.0));
+    EXPECT_NO_THROW(distance = boost::any_cast<double>(
+      odePhysics->GetParam("contact_warm_start_distance")));
+    EXPECT_DOUBLE_EQ(distance, 0.02);
+
+    // no contacts, no hits
+    double hitRate = 1;
+    EXPECT_NO_THROW(hitRate = boost::any_cast<double>(
+      odePhysics->GetParam("contact_warm_start_hit_rate")));
+    EXPECT_DOUBLE_EQ(hitRate, 0.0);
+  }
+
+  // Test contact_manifold_reduction
+  {
+    // contact_manifold_reduction should be off by default
+    bool reduction = true;
+    EXPECT_NO_THROW(reduction = boost::any_cast<bool>(
+      odePhysics->GetParam("contact_manifold_reduction")));
+    EXPECT_FALSE(reduction);
+
+    EXPECT_TRUE(odePhysics->SetParam("contact_manifold_reduction", true));
+    EXPECT_NO_THROW(reduction = boost::any_cast<bool>(
+      odePhysics->GetParam("contact_manifold_reduction")));
+    EXPECT_TRUE(reduction);
+    EXPECT_TRUE(odePhysics->SetParam("contact_manifold_reduction", false));
+
+    double distance = 0;
+    EXPECT_NO_THROW(distance = boost::any_cast<double>(
+      odePhysics->GetParam("contact_manifold_distance")));
+    EXPECT_DOUBLE_EQ(distance, 0.01);
+    EXPECT_TRUE(odePhysics->SetParam("contact_manifold_distance", 0.02));
+    EXPECT_NO_THROW(distance = boost::any_cast<double>(
+      odePhysics->GetParam("contact_manifold_distance")));
+    EXPECT_DOUBLE_EQ(distance, 0.02);
+
+    // negative distances are rejected
+    EXPECT_FALSE(odePhysics->SetParam("contact_manifold_distance", -1.0));
+    EXPECT_NO_THROW(distance = boost::any_cast<double>(
+      odePhysics->GetParam("contact_manifold_distance")));
+    EXPECT_DOUBLE_EQ(distance, 0.02);
+  }
+
+  // Test precision, read only and fixed at build time
+  {
+    std::string precision;
+    EXPECT_NO_THROW(precision = boost::any_cast<std::string>(
+      odePhysics->GetParam("precision")));
+#ifdef ODE_SINGLE_PRECISION
+    EXPECT_EQ(precision, "single");
+#else
+    EXPECT_EQ(precision, "double");
+#endif
+    EXPECT_FALSE(odePhysics->SetParam("precision", std::string("double")));
+  }
+
+  // Test parallel_narrow_phase
+  {
+    // parallel_narrow_phase should be off by default
+    bool parallel = true;
+    EXPECT_NO_THROW(parallel = boost::any_cast<bool>(
+      odePhysics->GetParam("parallel_narrow_phase")));
+    EXPECT_FALSE(parallel);
+
+    // try turning it on, then off again
+    std::vector<bool> bools = {true, false};
+    for (const bool parallelSet : bools)
+    {
+      odePhysics->SetParam("parallel_narrow_phase", parallelSet);
+      EXPECT_NO_THROW(parallel = boost::any_cast<bool>(
+        odePhysics->GetParam("parallel_narrow_phase")));
+      EXPECT_EQ(parallel, parallelSet);
+    }
+  }
+
+  // Test mesh_convex_decomposition
+  {
+    // mesh_convex_decomposition should be off by default
+    bool decomposition = true;
+    EXPECT_NO_THROW(decomposition = boost::any_cast<bool>(
+      odePhysics->GetParam("mesh_convex_decomposition")));
+    EXPECT_FALSE(decomposition);
+
+    // try turning it on, then off again
+    std::vector<bool> bools = {true, false};
+    for (const bool decompositionSet : bools)
+    {
+      odePhysics->SetParam("mesh_convex_decomposition", decompositionSet);
+      EXPECT_NO_THROW(decomposition = boost::any_cast<bool>(
+        odePhysics->GetParam("mesh_convex_decomposition")));
+      EXPECT_EQ(decomposition, decompositionSet);
+    }
+  }
+
+  // Test narrow_phase
+  {
+    // ODE generates the contacts by default
+    std::string narrowPhase;
+    EXPECT_NO_THROW(narrowPhase = boost::any_cast<std::string>(
+      odePhysics->GetParam("narrow_phase")));
+    EXPECT_EQ(narrowPhase, "ode");
+
+    EXPECT_FALSE(odePhysics->SetParam("narrow_phase", std::string("gjk")));
+#ifdef HAVE_FCL
+    EXPECT_TRUE(odePhysics->SetParam("narrow_phase", std::string("fcl")));
+    EXPECT_EQ("fcl", odePhysics->GetNarrowPhaseType());
+#else
+    EXPECT_FALSE(odePhysics->SetParam("narrow_phase", std::string("fcl")));
+#endif
+    EXPECT_TRUE(odePhysics->SetParam("narrow_phase", std::string("ode")));
+    EXPECT_EQ("ode", odePhysics->GetNarrowPhaseType());
+  }
+
   // Test ode_quiet
   // convenient for disabling LCP internal error messages from world solver
   {
@@ -490,6 +672,471 @@ TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Test that the BVH collision space finds the same contacts as the
+/// hash space
+TEST_F(ODEPhysics_TEST, CollisionSpace)
+{
+  Load("worlds/shapes.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+  EXPECT_EQ(odePhysics->GetCollisionSpaceType(), "hash");
+  odePhysics->GetContactManager()->SetNeverDropContacts(true);
+
+  // Let the shapes settle, and count the contacts
+  world->Step(100);
+  const unsigned int hashContacts =
+      odePhysics->GetContactManager()->GetContactCount();
+  EXPECT_GT(hashContacts, 0u);
+
+  EXPECT_FALSE(odePhysics->SetCollisionSpaceType("octree"));
+  EXPECT_TRUE(odePhysics->SetParam("collision_space", std::string("bvh")));
+  EXPECT_EQ(boost::any_cast<std::string>(
+      odePhysics->GetParam("collision_space")), "bvh");
+
+  // The shapes are resting, so the contacts must not change
+  world->Step(100);
+  EXPECT_EQ(odePhysics->GetContactManager()->GetContactCount(),
+      hashContacts);
+
+  // Move a shape away from the ground and check it falls back
+  ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  const double z = box->WorldPose().Pos().Z();
+  box->SetWorldPose(
+      box->WorldPose() + ignition::math::Pose3d(0, 0, 1, 0, 0, 0));
+  world->Step(1000);
+  EXPECT_NEAR(box->WorldPose().Pos().Z(), z, 1e-2);
+  EXPECT_EQ(odePhysics->GetContactManager()->GetContactCount(),
+      hashContacts);
+
+  EXPECT_TRUE(odePhysics->SetCollisionSpaceType("hash"));
+  world->Step(1);
+  EXPECT_EQ(odePhysics->GetContactManager()->GetContactCount(),
+      hashContacts);
+}
+
+#ifdef HAVE_FCL
+/////////////////////////////////////////////////
+/// Test that shapes rest on the ground when FCL generates the contacts
+TEST_F(ODEPhysics_TEST, FCLNarrowPhase)
+{
+  Load("worlds/shapes.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+  EXPECT_TRUE(odePhysics->SetNarrowPhaseType("fcl"));
+  odePhysics->GetContactManager()->SetNeverDropContacts(true);
+
+  std::vector<std::string> names = {"box", "sphere", "cylinder"};
+  std::vector<double> heights;
+  for (const auto &name : names)
+  {
+    ModelPtr model = world->ModelByName(name);
+    ASSERT_TRUE(model != nullptr);
+    heights.push_back(model->WorldPose().Pos().Z());
+  }
+
+  // Drop the shapes from above their resting pose
+  for (const auto &name : names)
+  {
+    ModelPtr model = world->ModelByName(name);
+    model->SetWorldPose(
+        model->WorldPose() + ignition::math::Pose3d(0, 0, 0.5, 0, 0, 0));
+  }
+  world->Step(1000);
+
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    ModelPtr model = world->ModelByName(names[i]);
+    EXPECT_NEAR(model->WorldPose().Pos().Z(), heights[i], 2e-2) << names[i];
+  }
+  EXPECT_GT(odePhysics->GetContactManager()->GetContactCount(), 0u);
+}
+#endif
+
+/////////////////////////////////////////////////
+/// Test that a mesh collides with its convex decomposition when enabled
+TEST_F(ODEPhysics_TEST, MeshConvexDecomposition)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_TRUE(physics->SetParam("mesh_convex_decomposition", true));
+  physics->GetContactManager()->SetNeverDropContacts(true);
+
+  std::ostringstream modelStr;
+  modelStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name ='mesh_model'>"
+    << "<pose>0 0 1 0 0 0</pose>"
+    << "<link name ='link'>"
+    << "  <collision name ='collision'>"
+    << "    <geometry>"
+    << "      <mesh>"
+    << "        <uri>" << std::string(PROJECT_SOURCE_PATH)
+                       << "/test/data/box_offset.dae</uri>"
+    << "      </mesh>"
+    << "    </geometry>"
+    << "  </collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(modelStr.str());
+  ModelPtr model = world->ModelByName("mesh_model");
+  ASSERT_TRUE(model != nullptr);
+
+  ODECollisionPtr collision = boost::dynamic_pointer_cast<ODECollision>(
+      model->GetLink("link")->GetCollision("collision"));
+  ASSERT_TRUE(collision != nullptr);
+
+  // The box is convex, so it is a single part
+  EXPECT_EQ(1u, collision->CompoundCollisionIds().size());
+
+  // It falls and rests on the ground plane
+  world->Step(2000);
+  EXPECT_NEAR(0.0, model->GetLink("link")->WorldLinearVel().Length(), 1e-2);
+  EXPECT_GT(physics->GetContactManager()->GetContactCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+/// Test that a prism with many bottom vertices rests on the ground with at
+/// most four contacts when the contact manifolds are reduced
+TEST_F(ODEPhysics_TEST, ContactManifoldReduction)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_TRUE(physics->SetParam("contact_manifold_reduction", true));
+  physics->GetContactManager()->SetNeverDropContacts(true);
+
+  // 16 sided prism, a triangle mesh with 16 vertices on the ground
+  std::ostringstream modelStr;
+  modelStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name ='prism'>"
+    << "<pose>0 0 0.05 0 0 0</pose>"
+    << "<link name ='link'>"
+    << "  <collision name ='collision'>"
+    << "    <geometry>"
+    << "      <polyline>"
+    << "        <height>0.2</height>";
+  for (int i = 0; i < 16; ++i)
+  {
+    const double angle = 2 * M_PI * i / 16;
+    modelStr << "<point>" << 0.3 * cos(angle) << " " << 0.3 * sin(angle)
+             << "</point>";
+  }
+  modelStr << "      </polyline>"
+    << "    </geometry>"
+    << "  </collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(modelStr.str());
+  ModelPtr model = world->ModelByName("prism");
+  ASSERT_TRUE(model != nullptr);
+
+  for (int i = 0; i < 500; ++i)
+  {
+    world->Step(1);
+    ContactManager *manager = physics->GetContactManager();
+    for (unsigned int j = 0; j < manager->GetContactCount(); ++j)
+      EXPECT_LE(manager->GetContact(j)->count, 4);
+  }
+
+  // It rests flat on the ground plane
+  EXPECT_GT(physics->GetContactManager()->GetContactCount(), 0u);
+  EXPECT_NEAR(0.0, model->GetLink("link")->WorldLinearVel().Length(), 1e-2);
+  EXPECT_NEAR(0.0, model->WorldPose().Rot().Euler().X(), 1e-2);
+  EXPECT_NEAR(0.0, model->WorldPose().Rot().Euler().Y(), 1e-2);
+}
+
+/////////////////////////////////////////////////
+/// Test the step memory parameters and statistics
+TEST_F(ODEPhysics_TEST, StepMemory)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  EXPECT_FALSE(physics->SetParam("step_memory_reserve_factor", 0.5));
+  EXPECT_TRUE(physics->SetParam("step_memory_reserve_factor", 1.5));
+  EXPECT_DOUBLE_EQ(1.5, boost::any_cast<double>(
+      physics->GetParam("step_memory_reserve_factor")));
+
+  EXPECT_TRUE(physics->SetParam("step_memory_huge_pages", true));
+  EXPECT_TRUE(boost::any_cast<bool>(
+      physics->GetParam("step_memory_huge_pages")));
+
+  // A pile of boxes in contact with each other
+  for (int i = 0; i < 10; ++i)
+  {
+    std::ostringstream name;
+    name << "box_" << i;
+    SpawnBox(name.str(), ignition::math::Vector3d(0.5, 0.5, 0.5),
+        ignition::math::Vector3d(0.1 * i, 0, 0.25 + 0.5 * i),
+        ignition::math::Vector3d::Zero);
+  }
+  world->Step(200);
+
+  const uint64_t bytes =
+      boost::any_cast<uint64_t>(physics->GetParam("step_memory_bytes"));
+  const uint64_t highWater =
+      boost::any_cast<uint64_t>(physics->GetParam("step_memory_high_water"));
+  const uint64_t reserve =
+      boost::any_cast<uint64_t>(physics->GetParam("step_memory_reserve"));
+  EXPECT_GT(bytes, 0u);
+  EXPECT_GT(highWater, 0u);
+  EXPECT_GE(reserve, highWater);
+
+  // Later blocks use regular pages, the boxes keep resting
+  EXPECT_TRUE(physics->SetParam("step_memory_huge_pages", false));
+  world->Step(200);
+  ModelPtr box = world->ModelByName("box_0");
+  ASSERT_TRUE(box != nullptr);
+  EXPECT_NEAR(0.25, box->WorldPose().Pos().Z(), 0.05);
+}
+
+/////////////////////////////////////////////////
+/// Test that the quickstep solver keeps a stack of boxes at rest. Every
+/// row update of the solver goes through the vector kernels of the build
+/// (scalar, SSE2, AVX2 or NEON), so wrong kernels break the stack.
+TEST_F(ODEPhysics_TEST, QuickstepStack)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_EQ("quick",
+      boost::any_cast<std::string>(physics->GetParam("solver_type")));
+
+  const int count = 5;
+  for (int i = 0; i < count; ++i)
+  {
+    std::ostringstream name;
+    name << "box_" << i;
+    SpawnBox(name.str(), ignition::math::Vector3d(0.5, 0.5, 0.5),
+        ignition::math::Vector3d(0, 0, 0.25 + 0.5 * i));
+  }
+  world->Step(1000);
+
+  for (int i = 0; i < count; ++i)
+  {
+    std::ostringstream name;
+    name << "box_" << i;
+    ModelPtr box = world->ModelByName(name.str());
+    ASSERT_TRUE(box != nullptr);
+    EXPECT_NEAR(0.25 + 0.5 * i, box->WorldPose().Pos().Z(), 0.02);
+    EXPECT_NEAR(0.0, box->WorldPose().Pos().X(), 0.02);
+    EXPECT_NEAR(0.0, box->WorldLinearVel().Length(), 1e-2);
+  }
+}
+
+/////////////////////////////////////////////////
+/// Test that the parallel narrow phase collides triangle meshes like the
+/// serial one
+TEST_F(ODEPhysics_TEST, ParallelTrimeshNarrowPhase)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_TRUE(physics->SetParam("parallel_narrow_phase", true));
+
+  // Enough mesh boxes on the ground to go over the parallel threshold
+  const std::string mesh = std::string("file://") + TEST_PATH +
+    "/data/box.dae";
+  const int count = 72;
+  for (int i = 0; i < count; ++i)
+  {
+    std::ostringstream name;
+    name << "mesh_" << i;
+    SpawnTrimesh(name.str(), mesh, ignition::math::Vector3d(0.25, 0.25, 0.25),
+        ignition::math::Vector3d(i % 9, i / 9, 0.3));
+  }
+  world->Step(500);
+
+  // All the boxes rest on the ground
+  for (int i = 0; i < count; ++i)
+  {
+    std::ostringstream name;
+    name << "mesh_" << i;
+    ModelPtr model = world->ModelByName(name.str());
+    ASSERT_TRUE(model != nullptr);
+    EXPECT_NEAR(0.25, model->WorldPose().Pos().Z(), 0.05);
+  }
+
+  // The serial narrow phase finds the same contacts
+  world->Step(1);
+  const unsigned int parallelContacts =
+      physics->GetContactManager()->GetContactCount();
+  EXPECT_GE(parallelContacts, static_cast<unsigned int>(count));
+
+  EXPECT_TRUE(physics->SetParam("parallel_narrow_phase", false));
+  world->Step(1);
+  EXPECT_EQ(parallelContacts, physics->GetContactManager()->GetContactCount());
+}
+
+/////////////////////////////////////////////////
+/// Test that a model with substeps falls like a model stepped with smaller
+/// steps, and still rests on the ground
+TEST_F(ODEPhysics_TEST, ModelSubsteps)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnSphere("coarse", ignition::math::Vector3d(0, 0, 10),
+      ignition::math::Vector3d::Zero);
+  SpawnSphere("fine", ignition::math::Vector3d(5, 0, 10),
+      ignition::math::Vector3d::Zero);
+  ModelPtr coarse = world->ModelByName("coarse");
+  ModelPtr fine = world->ModelByName("fine");
+  ASSERT_TRUE(coarse != nullptr);
+  ASSERT_TRUE(fine != nullptr);
+
+  EXPECT_EQ(1u, fine->PhysicsSubsteps());
+  fine->SetPhysicsSubsteps(0);
+  EXPECT_EQ(1u, fine->PhysicsSubsteps());
+  fine->SetPhysicsSubsteps(4);
+  EXPECT_EQ(4u, fine->PhysicsSubsteps());
+
+  // Semi-implicit Euler from rest drops by g dt^2 in one step, and by
+  // g (dt/4)^2 (1 + 2 + 3 + 4) in four substeps
+  world->Step(1);
+  const double coarseDrop = 10 - coarse->WorldPose().Pos().Z();
+  const double fineDrop = 10 - fine->WorldPose().Pos().Z();
+  EXPECT_GT(coarseDrop, 0.0);
+  EXPECT_NEAR(10.0 / 16.0, fineDrop / coarseDrop, 1e-6);
+
+  // Both end the step with the same velocity
+  EXPECT_NEAR(coarse->WorldLinearVel().Z(), fine->WorldLinearVel().Z(),
+      1e-9);
+
+  // Contacts with the ground don't couple the model to another one
+  world->Step(3000);
+  EXPECT_NEAR(0.5, fine->WorldPose().Pos().Z(), 0.01);
+  EXPECT_NEAR(0.5, coarse->WorldPose().Pos().Z(), 0.01);
+}
+
+/////////////////////////////////////////////////
+/// Test that models whose collision groups don't collide go through each
+/// other, and still collide with the ground
+TEST_F(ODEPhysics_TEST, CollisionGroups)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr physics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(physics != nullptr);
+
+  EXPECT_FALSE(physics->SetModelCollisionGroup("lower",
+      ODEPhysics::MaxCollisionGroups));
+  EXPECT_FALSE(physics->SetCollisionGroupsCollide(0,
+      ODEPhysics::MaxCollisionGroups, false));
+
+  EXPECT_TRUE(physics->SetModelCollisionGroup("lower", 1));
+  EXPECT_TRUE(physics->SetModelCollisionGroup("upper", 2));
+  EXPECT_EQ(1u, physics->ModelCollisionGroup("lower"));
+  EXPECT_EQ(0u, physics->ModelCollisionGroup("ground_plane"));
+  EXPECT_TRUE(physics->CollisionGroupsCollide(1, 2));
+  EXPECT_TRUE(physics->SetCollisionGroupsCollide(2, 1, false));
+  EXPECT_FALSE(physics->CollisionGroupsCollide(1, 2));
+  EXPECT_TRUE(physics->CollisionGroupsCollide(0, 2));
+
+  SpawnBox("lower", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 0, 0.25), ignition::math::Vector3d::Zero);
+  SpawnBox("upper", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 0, 0.8), ignition::math::Vector3d::Zero);
+  ModelPtr lower = world->ModelByName("lower");
+  ModelPtr upper = world->ModelByName("upper");
+  ASSERT_TRUE(lower != nullptr);
+  ASSERT_TRUE(upper != nullptr);
+
+  // The upper box falls through the lower one onto the ground
+  world->Step(1000);
+  EXPECT_NEAR(0.25, lower->WorldPose().Pos().Z(), 0.01);
+  EXPECT_NEAR(0.25, upper->WorldPose().Pos().Z(), 0.01);
+
+  EXPECT_TRUE(physics->SetCollisionGroupsCollide(1, 2, true));
+  EXPECT_TRUE(physics->CollisionGroupsCollide(2, 1));
+}
+
+
+/// reporting contacts to the contact manager
+TEST_F(ODEPhysics_TEST, ContactCallback)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 0, 0.25), ignition::math::Vector3d::Zero);
+  ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  CollisionPtr collision = model->GetLink()->GetCollisions()[0];
+
+  // Let it settle
+  world->Step(100);
+
+  unsigned int calls = 0;
+  physics->SetContactCallback(collision.get(),
+      [&](Collision *_collision1, Collision *_collision2,
+          ContactPoint *_points, const unsigned int _count)
+      {
+        EXPECT_TRUE(_collision1 == collision.get() ||
+                    _collision2 == collision.get());
+        for (unsigned int i = 0; i < _count; ++i)
+        {
+          EXPECT_NEAR(0.0, _points[i].position.Z(), 1e-2);
+          _points[i].frictionDirection1.Set(1, 0, 0);
+          _points[i].surfaceMotion1 = 1.0;
+        }
+        ++calls;
+      });
+
+  world->Step(1000);
+  EXPECT_GT(calls, 0u);
+  EXPECT_EQ(0u, physics->GetContactManager()->GetContactCount());
+
+  // The surface motion slides the box along x only
+  const ignition::math::Vector3d pos = model->WorldPose().Pos();
+  EXPECT_GT(std::abs(pos.X()), 0.5);
+  EXPECT_NEAR(0.0, pos.Y(), 1e-2);
+  EXPECT_NEAR(0.25, pos.Z(), 1e-2);
+
+  // Without the callback, friction stops the box
+  physics->SetContactCallback(collision.get(), nullptr);
+  calls = 0;
+  world->Step(1000);
+  EXPECT_EQ(0u, calls);
+  EXPECT_NEAR(0.0, model->GetLink()->WorldLinearVel().Length(), 1e-2);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
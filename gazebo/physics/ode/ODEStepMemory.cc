@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+#include "gazebo/physics/ode/ODEStepMemory.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+const size_t ODEStepMemory::HugePageSize;
+
+/// \brief Mapping of a block.
+class StepMemoryBlock
+{
+  /// \brief Mapped size.
+  public: size_t length = 0;
+
+  /// \brief True if backed by explicit huge pages.
+  public: bool huge = false;
+};
+
+/// \brief Blocks and statistics, shared by the worlds of the process.
+class StepMemoryState
+{
+  /// \brief Protects the other fields.
+  public: std::mutex mutex;
+
+  /// \brief True to back large blocks with huge pages.
+  public: bool hugePages = false;
+
+  /// \brief Current blocks.
+  public: std::unordered_map<void *, StepMemoryBlock> blocks;
+
+  /// \brief Statistics.
+  public: ODEStepMemory::Statistics stats;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the state of the manager.
+/// \return The state.
+static StepMemoryState &State()
+{
+  // Never destroyed, ODE may free blocks while the process exits
+  static StepMemoryState *state = new StepMemoryState;
+  return *state;
+}
+
+/////////////////////////////////////////////////
+/// \brief Round a size up to a multiple of a power of two.
+/// \param[in] _size The size.
+/// \param[in] _multiple The power of two.
+/// \return The rounded size.
+static size_t RoundUp(const size_t _size, const size_t _multiple)
+{
+  return (_size + _multiple - 1) & ~(_multiple - 1);
+}
+
+/////////////////////////////////////////////////
+bool ODEStepMemory::Install(dWorldID _world)
+{
+  dWorldStepMemoryFunctionsInfo info;
+  info.struct_size = sizeof(info);
+  info.alloc_block = &ODEStepMemory::Alloc;
+  info.shrink_block = &ODEStepMemory::Shrink;
+  info.free_block = &ODEStepMemory::Free;
+  return dWorldSetStepMemoryManager(_world, &info) != 0;
+}
+
+/////////////////////////////////////////////////
+void ODEStepMemory::SetHugePages(const bool _enable)
+{
+  StepMemoryState &state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.hugePages = _enable;
+}
+
+/////////////////////////////////////////////////
+bool ODEStepMemory::HugePages()
+{
+  StepMemoryState &state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.hugePages;
+}
+
+/////////////////////////////////////////////////
+ODEStepMemory::Statistics ODEStepMemory::Stats()
+{
+  StepMemoryState &state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.stats;
+}
+
+/////////////////////////////////////////////////
+void *ODEStepMemory::Alloc(size_t _size)
+{
+  StepMemoryState &state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+
+  void *block = nullptr;
+  StepMemoryBlock mapping;
+
+#ifndef _WIN32
+  const bool large = state.hugePages && _size >= HugePageSize;
+
+#ifdef MAP_HUGETLB
+  // Explicit huge pages, only available if the system reserved some
+  if (large)
+  {
+    mapping.length = RoundUp(_size, HugePageSize);
+    block = mmap(nullptr, mapping.length, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (block == MAP_FAILED)
+      block = nullptr;
+    else
+      mapping.huge = true;
+  }
+#endif
+
+  const size_t pageSize = sysconf(_SC_PAGESIZE);
+  if (!block)
+  {
+    mapping.length = RoundUp(_size, large ? HugePageSize : pageSize);
+    block = mmap(nullptr, mapping.length, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED)
+      return nullptr;
+
+#ifdef MADV_HUGEPAGE
+    // Transparent huge pages otherwise, advised before the first touch
+    if (large)
+      madvise(block, mapping.length, MADV_HUGEPAGE);
+#endif
+  }
+
+  // Fault the pages in now, on the thread stepping the world
+  char *bytes = static_cast<char *>(block);
+  for (size_t i = 0; i < mapping.length; i += pageSize)
+    bytes[i] = 0;
+#else
+  mapping.length = _size;
+  block = std::malloc(_size);
+  if (!block)
+    return nullptr;
+#endif
+
+  state.blocks[block] = mapping;
+  state.stats.bytes += mapping.length;
+  state.stats.highWater = std::max<uint64_t>(state.stats.highWater, _size);
+  ++state.stats.allocations;
+  if (mapping.huge)
+    ++state.stats.hugePageBlocks;
+
+  return block;
+}
+
+/////////////////////////////////////////////////
+void *ODEStepMemory::Shrink(void *_block, size_t /*_size*/,
+    size_t /*_smallerSize*/)
+{
+  // The block keeps its mapping, which is released when it is freed
+  return _block;
+}
+
+/////////////////////////////////////////////////
+void ODEStepMemory::Free(void *_block, size_t /*_size*/)
+{
+  if (!_block)
+    return;
+
+  StepMemoryState &state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+
+  auto it = state.blocks.find(_block);
+  if (it == state.blocks.end())
+    return;
+
+#ifndef _WIN32
+  munmap(_block, it->second.length);
+#else
+  std::free(_block);
+#endif
+
+  state.stats.bytes -= it->second.length;
+  if (it->second.huge)
+    --state.stats.hugePageBlocks;
+  state.blocks.erase(it);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODESTEPMEMORY_HH_
+#define GAZEBO_PHYSICS_ODE_ODESTEPMEMORY_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gazebo/physics/ode/ode_inc.h"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Memory manager of the ODE world stepping functions, see the
+    /// "step_memory_huge_pages" parameter of ODEPhysics.
+    ///
+    /// ODE keeps the working memory of a world in one block, which only
+    /// grows. Blocks are mapped directly rather than taken from the heap,
+    /// and their pages are touched when they are allocated, by the thread
+    /// stepping the world. The stepping functions then don't fault pages,
+    /// and the pages are placed on the NUMA node of that thread by the
+    /// first touch policy of the kernel. Blocks of at least HugePageSize
+    /// can be backed by huge pages, explicit ones if the system reserved
+    /// some, transparent ones otherwise. Blocks are shrunk in place, so
+    /// that their memory stays with the world.
+    ///
+    /// ODE doesn't pass a world to its memory manager, so the settings and
+    /// the statistics are shared by the worlds of a process.
+    class ODEStepMemory
+    {
+      /// \brief Size of a huge page, the smallest block backed by huge
+      /// pages.
+      public: static const size_t HugePageSize = 2 * 1024 * 1024;
+
+      /// \brief Statistics of the blocks.
+      public: class Statistics
+      {
+        /// \brief Bytes currently mapped.
+        public: uint64_t bytes = 0;
+
+        /// \brief Largest block requested so far, in bytes.
+        public: uint64_t highWater = 0;
+
+        /// \brief Number of blocks allocated so far.
+        public: uint64_t allocations = 0;
+
+        /// \brief Number of current blocks backed by explicit huge pages.
+        public: uint64_t hugePageBlocks = 0;
+      };
+
+      /// \brief Make the stepping functions of a world use this manager.
+      /// \param[in] _world The world.
+      /// \return True on success.
+      public: static bool Install(dWorldID _world);
+
+      /// \brief Set whether blocks of at least HugePageSize are backed by
+      /// huge pages. Applies to the blocks allocated afterwards.
+      /// \param[in] _enable True to use huge pages.
+      public: static void SetHugePages(const bool _enable);
+
+      /// \brief Get whether huge pages are used.
+      /// \return True if blocks of at least HugePageSize use huge pages.
+      public: static bool HugePages();
+
+      /// \brief Get the statistics of the blocks.
+      /// \return The statistics.
+      public: static Statistics Stats();
+
+      /// \brief Allocate a block, see dWorldStepMemoryFunctionsInfo.
+      /// \param[in] _size Size of the block.
+      /// \return The block, null on failure.
+      private: static void *Alloc(size_t _size);
+
+      /// \brief Shrink a block in place, see dWorldStepMemoryFunctionsInfo.
+      /// \param[in] _block The block.
+      /// \param[in] _size Current size of the block.
+      /// \param[in] _smallerSize New size of the block.
+      /// \return The block.
+      private: static void *Shrink(void *_block, size_t _size,
+                   size_t _smallerSize);
+
+      /// \brief Free a block, see dWorldStepMemoryFunctionsInfo.
+      /// \param[in] _block The block.
+      /// \param[in] _size Current size of the block.
+      private: static void Free(void *_block, size_t _size);
+    };
+  }
+}
+#endif
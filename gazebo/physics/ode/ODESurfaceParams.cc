@@ -15,6 +15,8 @@
  *
 */
 
+#include <atomic>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/physics/ode/ODESurfaceParams.hh"
@@ -22,6 +24,9 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Generation of the surface parameters, see Generation().
+static std::atomic<uint64_t> surfaceGeneration(0);
+
 //////////////////////////////////////////////////
 ODESurfaceParams::ODESurfaceParams()
   : SurfaceParams(),
@@ -43,6 +48,7 @@ void ODESurfaceParams::Load(sdf::ElementPtr _sdf)
 {
   // Load parent class
   SurfaceParams::Load(_sdf);
+  ++surfaceGeneration;
 
   if (!_sdf)
     gzerr << "Surface _sdf is null" << std::endl;
@@ -183,6 +189,7 @@ void ODESurfaceParams::FillMsg(msgs::Surface &_msg)
 void ODESurfaceParams::ProcessMsg(const msgs::Surface &_msg)
 {
   SurfaceParams::ProcessMsg(_msg);
+  ++surfaceGeneration;
 
   if (_msg.has_friction())
   {
@@ -255,3 +262,9 @@ FrictionPyramidPtr ODESurfaceParams::FrictionPyramid() const
 {
   return this->frictionPyramid;
 }
+
+/////////////////////////////////////////////////
+uint64_t ODESurfaceParams::Generation()
+{
+  return surfaceGeneration;
+}
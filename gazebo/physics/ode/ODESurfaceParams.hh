@@ -18,6 +18,8 @@
 #ifndef _GAZEBO_ODESURFACEPARAMS_HH_
 #define _GAZEBO_ODESURFACEPARAMS_HH_
 
+#include <cstdint>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -53,6 +55,13 @@ namespace gazebo
       // Documentation inherited.
       public: virtual FrictionPyramidPtr FrictionPyramid() const;
 
+      /// \brief Get the number of times surface parameters were loaded or
+      /// updated from a message, by all the surfaces of the process. The
+      /// collision filters of ODEPhysics are refreshed when it changes.
+      /// \return The generation of the surface parameters.
+      /// \sa ODEPhysics::InvalidateCollisionFilters
+      public: static uint64_t Generation();
+
       /// \brief bounce restitution coefficient [0,1], with 0 being inelastic,
       ///        and 1 being perfectly elastic.
       /// \sa    http://www.ode.org/ode-latest-userguide.html#sec_7_3_7
@@ -16,8 +16,9 @@
 */
 
 #include <string>
+#include <vector>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/physics/simbody/SimbodyTypes.hh"
 #include "gazebo/physics/simbody/SimbodyModel.hh"
@@ -266,41 +267,28 @@ void SimbodyPhysics::Init()
 //////////////////////////////////////////////////
 void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
 {
-  // Before building a new system, transfer all joints in existing
-  // models, save Simbody joint states in Gazebo Model.
+  // Before building a new system, save the generalized coordinates and
+  // speeds of every existing mobilized body. Bodies of the new model are
+  // appended to the matter subsystem, so the existing ones keep their
+  // index, and their state is restored by index without visiting the
+  // gazebo links and joints of every model.
   const SimTK::State& currentState = this->integ->getState();
   double stateTime = 0;
-  bool simbodyStateSaved = false;
+  std::vector<SimTK::Vector> savedQ;
+  std::vector<SimTK::Vector> savedU;
 
-  if (currentState.getSystemStage() != SimTK::Stage::Empty)
+  if (currentState.getSystemStage() >= SimTK::Stage::Model)
   {
     stateTime = currentState.getTime();
-    physics::Model_V models = this->world->Models();
-    for (physics::Model_V::iterator mi = models.begin();
-         mi != models.end(); ++mi)
+    const int bodyCount = this->matter.getNumBodies();
+    savedQ.resize(bodyCount);
+    savedU.resize(bodyCount);
+    for (SimTK::MobilizedBodyIndex mbx(1); mbx < bodyCount; ++mbx)
     {
-      if ((*mi) != _model)
-      {
-        physics::Joint_V joints = (*mi)->GetJoints();
-        for (physics::Joint_V::iterator jx = joints.begin();
-             jx != joints.end(); ++jx)
-        {
-          SimbodyJointPtr simbodyJoint =
-            boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-          simbodyJoint->SaveSimbodyState(currentState);
-        }
-
-        physics::Link_V links = (*mi)->GetLinks();
-        for (physics::Link_V::iterator lx = links.begin();
-             lx != links.end(); ++lx)
-        {
-          SimbodyLinkPtr simbodyLink =
-            boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-          simbodyLink->SaveSimbodyState(currentState);
-        }
-      }
+      const SimTK::MobilizedBody &mobod = this->matter.getMobilizedBody(mbx);
+      savedQ[mbx] = mobod.getQAsVector(currentState);
+      savedU[mbx] = mobod.getUAsVector(currentState);
     }
-    simbodyStateSaved = true;
   }
 
   try
@@ -340,33 +328,20 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
 
   SimTK::State state = this->system.realizeTopology();
 
-  // Restore Gazebo saved Joint states
-  // back into Simbody state.
-  if (simbodyStateSaved)
+  // Restore the saved states, the bodies of the new model keep the
+  // default state given by their initial pose.
+  if (!savedQ.empty())
   {
-    // set/retsore state time.
     state.setTime(stateTime);
-
-    physics::Model_V models = this->world->Models();
-    for (physics::Model_V::iterator mi = models.begin();
-         mi != models.end(); ++mi)
+    this->system.realizeModel(state);
+    for (SimTK::MobilizedBodyIndex mbx(1);
+         mbx < static_cast<int>(savedQ.size()); ++mbx)
     {
-      physics::Joint_V joints = (*mi)->GetJoints();
-      for (physics::Joint_V::iterator jx = joints.begin();
-           jx != joints.end(); ++jx)
-      {
-        SimbodyJointPtr simbodyJoint =
-          boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-        simbodyJoint->RestoreSimbodyState(state);
-      }
-      physics::Link_V links = (*mi)->GetLinks();
-      for (physics::Link_V::iterator lx = links.begin();
-           lx != links.end(); ++lx)
-      {
-        SimbodyLinkPtr simbodyLink =
-          boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-        simbodyLink->RestoreSimbodyState(state);
-      }
+      const SimTK::MobilizedBody &mobod = this->matter.getMobilizedBody(mbx);
+      if (mobod.getNumQ(state) == savedQ[mbx].size())
+        mobod.setQFromVector(state, savedQ[mbx]);
+      if (mobod.getNumU(state) == savedU[mbx].size())
+        mobod.setUFromVector(state, savedU[mbx]);
     }
   }
 
@@ -697,8 +672,7 @@ void SimbodyPhysics::UpdatePhysics()
       auto pose = SimbodyPhysics::Transform2PoseIgn(
         simbodyLink->masterMobod.getBodyTransform(s));
       simbodyLink->SetDirtyPose(pose);
-      this->world->dataPtr->dirtyPoses.push_back(
-        boost::static_pointer_cast<Entity>(*lx).get());
+      this->world->_AddDirty(boost::static_pointer_cast<Entity>(*lx).get());
     }
 
     physics::Joint_V joints = (*mi)->GetJoints();
@@ -15,6 +15,7 @@
  *
 */
 
+#include <algorithm>
 #include <sstream>
 
 #include <boost/algorithm/string.hpp>
@@ -36,7 +37,9 @@
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/ImageConvert.hh"
 #include "gazebo/common/VideoEncoder.hh"
+#include "gazebo/util/Diagnostics.hh"
 
 #include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/RTShaderSystem.hh"
@@ -52,9 +55,59 @@
 using namespace gazebo;
 using namespace rendering;
 
+/// \brief Weight of a new frame in the averages of the camera statistics.
+static const double RENDER_STATS_SMOOTHING = 0.1;
+
+/// \brief Frames rendered between changes of the render budget level, so
+/// the average render time reflects the last change.
+static const unsigned int RENDER_BUDGET_FRAMES = 20;
+
+/// \brief Highest render budget level.
+static const unsigned int MAX_RENDER_BUDGET_LEVEL = 2;
+
+/// \brief Fraction of the render budget below which rendering is
+/// restored.
+static const double RENDER_BUDGET_RESTORE = 0.5;
+
+/// \brief Levels of detail bias used at the highest budget level.
+static const double RENDER_BUDGET_LOD_BIAS = 0.25;
+
+/// \brief Number of video frames that can wait for the encoder before new
+/// frames are dropped.
+static const unsigned int VIDEO_QUEUE_SIZE = 16;
+
+/// \brief Number of frames that can wait to be written to disk before new
+/// frames are dropped.
+static const unsigned int SAVE_FRAME_QUEUE_SIZE = 8;
+
 
 unsigned int CameraPrivate::cameraCounter = 0;
 
+//////////////////////////////////////////////////
+/// \brief Get the color channel each pixel of a Bayer image format keeps,
+/// as set on the Gazebo/CameraBayer material. The channels match
+/// Camera::ConvertRGBToBAYER.
+/// \param[in] _format Image format.
+/// \param[out] _pattern Channel of the pixels on an (even row, even
+/// column), (even row, odd column), (odd row, even column) and (odd row,
+/// odd column), where 0 is red, 1 is green and 2 is blue.
+/// \return True if _format is a Bayer format.
+static bool BayerPattern(const std::string &_format, Ogre::Vector4 &_pattern)
+{
+  if (_format == "BAYER_RGGB8")
+    _pattern = Ogre::Vector4(0, 1, 1, 2);
+  else if (_format == "BAYER_BGGR8")
+    _pattern = Ogre::Vector4(2, 1, 1, 0);
+  else if (_format == "BAYER_GBRG8")
+    _pattern = Ogre::Vector4(1, 0, 2, 1);
+  else if (_format == "BAYER_GRBG8")
+    _pattern = Ogre::Vector4(1, 2, 0, 1);
+  else
+    return false;
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 Camera::Camera(const std::string &_name, ScenePtr _scene,
                bool _autoRender)
@@ -352,6 +405,7 @@ void Camera::Init()
 void Camera::Fini()
 {
   this->dataPtr->videoEncoder.Reset();
+  this->StopSaveThread();
 
   if (this->saveFrameBuffer)
     delete [] this->saveFrameBuffer;
@@ -369,6 +423,7 @@ void Camera::Fini()
   this->dataPtr->node.reset();
 
   this->dataPtr->distortion.reset();
+  this->dataPtr->bayerInstance = nullptr;
   this->dataPtr->trackedVisual.reset();
 
   if (this->viewport && this->scene)
@@ -557,7 +612,79 @@ void Camera::Render(const bool _force)
         this->dataPtr->renderPeriod))
   {
     this->newData = true;
+    common::Time start = common::Time::GetWallTime();
     this->RenderImpl();
+    this->RecordRender(common::Time::GetWallTime() - start);
+  }
+}
+
+//////////////////////////////////////////////////
+void Camera::RecordRender(const common::Time &_renderTime)
+{
+  const double renderTime = _renderTime.Double();
+  if (this->dataPtr->renderTime <= 0)
+    this->dataPtr->renderTime = renderTime;
+  else
+  {
+    this->dataPtr->renderTime +=
+        RENDER_STATS_SMOOTHING * (renderTime - this->dataPtr->renderTime);
+  }
+
+  if (this->renderTarget)
+  {
+    this->dataPtr->triangleCount = this->renderTarget->getTriangleCount();
+    this->dataPtr->batchCount = this->renderTarget->getBatchCount();
+  }
+
+  DIAG_VALUE(this->Name() + " render time", renderTime);
+  DIAG_VALUE(this->Name() + " triangles", this->dataPtr->triangleCount);
+  DIAG_VALUE(this->Name() + " batches", this->dataPtr->batchCount);
+
+  // Let the average settle before changing the budget level again
+  ++this->dataPtr->budgetFrames;
+  if (this->dataPtr->renderBudget <= 0 ||
+      this->dataPtr->budgetFrames < RENDER_BUDGET_FRAMES)
+  {
+    return;
+  }
+
+  if (this->dataPtr->renderTime > this->dataPtr->renderBudget &&
+      this->dataPtr->budgetLevel < MAX_RENDER_BUDGET_LEVEL)
+  {
+    ++this->dataPtr->budgetLevel;
+    this->ApplyRenderBudget(this->dataPtr->budgetLevel - 1);
+  }
+  else if (this->dataPtr->renderTime <
+      RENDER_BUDGET_RESTORE * this->dataPtr->renderBudget &&
+      this->dataPtr->budgetLevel > 0)
+  {
+    --this->dataPtr->budgetLevel;
+    this->ApplyRenderBudget(this->dataPtr->budgetLevel + 1);
+  }
+}
+
+//////////////////////////////////////////////////
+void Camera::ApplyRenderBudget(const unsigned int _previousLevel)
+{
+  this->dataPtr->budgetFrames = 0;
+
+  if (this->viewport)
+  {
+    if (_previousLevel == 0 && this->dataPtr->budgetLevel > 0)
+    {
+      this->dataPtr->budgetShadows = this->viewport->getShadowsEnabled();
+      this->viewport->setShadowsEnabled(false);
+    }
+    else if (_previousLevel > 0 && this->dataPtr->budgetLevel == 0)
+      this->viewport->setShadowsEnabled(this->dataPtr->budgetShadows);
+  }
+
+  if (this->camera)
+  {
+    double bias = this->dataPtr->lodBias;
+    if (this->dataPtr->budgetLevel >= 2)
+      bias *= RENDER_BUDGET_LOD_BIAS;
+    this->camera->setLodBias(bias);
   }
 }
 
@@ -586,11 +713,13 @@ void Camera::ReadPixelBuffer()
     size = Ogre::PixelUtil::getMemorySize(width, height, 1,
         static_cast<Ogre::PixelFormat>(this->imageFormat));
 
-    // Allocate buffer
+    // Allocate buffer. The read below overwrites the whole frame, so the
+    // buffer is only cleared once.
     if (!this->saveFrameBuffer)
+    {
       this->saveFrameBuffer = new unsigned char[size];
-
-    memset(this->saveFrameBuffer, 128, size);
+      memset(this->saveFrameBuffer, 128, size);
+    }
 
     Ogre::PixelBox box(width, height, 1,
         static_cast<Ogre::PixelFormat>(this->imageFormat),
@@ -651,7 +780,16 @@ common::Time Camera::LastRenderWallTime() const
 //////////////////////////////////////////////////
 void Camera::PostRender()
 {
-  this->ReadPixelBuffer();
+  if (this->newData)
+  {
+    common::Time start = common::Time::GetWallTime();
+    this->ReadPixelBuffer();
+    const double readbackTime =
+        (common::Time::GetWallTime() - start).Double();
+    this->dataPtr->readbackTime +=
+        RENDER_STATS_SMOOTHING * (readbackTime - this->dataPtr->readbackTime);
+    DIAG_VALUE(this->Name() + " readback time", readbackTime);
+  }
 
   // Only record last render time if data was actually generated
   // (If a frame was rendered).
@@ -678,7 +816,7 @@ void Camera::PostRender()
     if (this->sdf->HasElement("save") &&
         this->sdf->GetElement("save")->Get<bool>("enabled"))
     {
-      this->SaveFrame(this->FrameFilename());
+      this->QueueSaveFrame(this->FrameFilename());
     }
 
     // do last minute conversion if Bayer pattern is requested, go from R8G8B8
@@ -690,9 +828,18 @@ void Camera::PostRender()
       if (!this->bayerFrameBuffer)
         this->bayerFrameBuffer = new unsigned char[width * height];
 
-      this->ConvertRGBToBAYER(this->bayerFrameBuffer,
-          this->saveFrameBuffer, this->ImageFormat(),
-          width, height);
+      // The compositor already wrote the pattern to every channel
+      if (this->dataPtr->bayerInstance)
+      {
+        common::ImageConvert::Channel(this->saveFrameBuffer,
+            this->bayerFrameBuffer, width * height, 3, 0);
+      }
+      else
+      {
+        this->ConvertRGBToBAYER(this->bayerFrameBuffer,
+            this->saveFrameBuffer, this->ImageFormat(),
+            width, height);
+      }
 
       buffer = this->bayerFrameBuffer;
     }
@@ -1073,6 +1220,88 @@ double Camera::FarClip() const
     return 0;
 }
 
+//////////////////////////////////////////////////
+void Camera::SetLodBias(const double _bias)
+{
+  if (_bias <= 0)
+  {
+    gzerr << "Camera level of detail bias must be greater than 0\n";
+    return;
+  }
+
+  this->dataPtr->lodBias = _bias;
+  this->ApplyRenderBudget(this->dataPtr->budgetLevel);
+}
+
+//////////////////////////////////////////////////
+double Camera::LodBias() const
+{
+  return this->dataPtr->lodBias;
+}
+
+//////////////////////////////////////////////////
+uint64_t Camera::TriangleCount() const
+{
+  return this->dataPtr->triangleCount;
+}
+
+//////////////////////////////////////////////////
+uint64_t Camera::BatchCount() const
+{
+  return this->dataPtr->batchCount;
+}
+
+//////////////////////////////////////////////////
+double Camera::RenderTime() const
+{
+  return this->dataPtr->renderTime;
+}
+
+//////////////////////////////////////////////////
+double Camera::ReadbackTime() const
+{
+  return this->dataPtr->readbackTime;
+}
+
+//////////////////////////////////////////////////
+void Camera::SetRenderBudget(const double _budget)
+{
+  this->dataPtr->renderBudget = std::max(_budget, 0.0);
+  if (this->dataPtr->renderBudget <= 0 && this->dataPtr->budgetLevel > 0)
+  {
+    const unsigned int previousLevel = this->dataPtr->budgetLevel;
+    this->dataPtr->budgetLevel = 0;
+    this->ApplyRenderBudget(previousLevel);
+  }
+}
+
+//////////////////////////////////////////////////
+double Camera::RenderBudget() const
+{
+  return this->dataPtr->renderBudget;
+}
+
+//////////////////////////////////////////////////
+unsigned int Camera::RenderBudgetLevel() const
+{
+  return this->dataPtr->budgetLevel;
+}
+
+//////////////////////////////////////////////////
+void Camera::FillStatsMsg(msgs::RenderingStats::Camera &_msg) const
+{
+  _msg.set_name(this->ScopedName());
+  _msg.set_triangles(this->dataPtr->triangleCount);
+  _msg.set_batches(this->dataPtr->batchCount);
+  _msg.set_render_time(this->dataPtr->renderTime);
+  _msg.set_readback_time(this->dataPtr->readbackTime);
+  if (this->dataPtr->renderBudget > 0)
+  {
+    _msg.set_render_budget(this->dataPtr->renderBudget);
+    _msg.set_budget_level(this->dataPtr->budgetLevel);
+  }
+}
+
 //////////////////////////////////////////////////
 unsigned int Camera::ViewportWidth() const
 {
@@ -1172,6 +1401,83 @@ bool Camera::SaveFrame(const std::string &_filename)
                           this->ImageFormat(), _filename);
 }
 
+//////////////////////////////////////////////////
+void Camera::QueueSaveFrame(const std::string &_filename)
+{
+  if (!this->saveFrameBuffer)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->saveMutex);
+
+  // Drop the frame rather than stall rendering on disk writes
+  if (this->dataPtr->saveQueue.size() >= SAVE_FRAME_QUEUE_SIZE)
+  {
+    if (this->dataPtr->droppedSaveFrames++ == 0)
+    {
+      gzwarn << "Camera[" << this->Name() << "] can't write frames as fast "
+             << "as they are rendered. Dropping frames.\n";
+    }
+    return;
+  }
+
+  SavedFrame frame;
+  frame.width = this->ImageWidth();
+  frame.height = this->ImageHeight();
+  frame.depth = this->ImageDepth();
+  frame.format = this->ImageFormat();
+  frame.filename = _filename;
+  frame.data.assign(this->saveFrameBuffer, this->saveFrameBuffer +
+      Camera::ImageByteSize(frame.width, frame.height, frame.format));
+  this->dataPtr->saveQueue.push_back(std::move(frame));
+
+  if (!this->dataPtr->saveThread.joinable())
+  {
+    this->dataPtr->stopSaveThread = false;
+    this->dataPtr->saveThread = std::thread(&Camera::RunSaveThread, this);
+  }
+  this->dataPtr->saveCondition.notify_one();
+}
+
+//////////////////////////////////////////////////
+void Camera::RunSaveThread()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->saveMutex);
+  while (true)
+  {
+    this->dataPtr->saveCondition.wait(lock, [this]
+        {
+          return this->dataPtr->stopSaveThread ||
+                 !this->dataPtr->saveQueue.empty();
+        });
+
+    // Stop once every queued frame has been written
+    if (this->dataPtr->saveQueue.empty())
+      break;
+
+    SavedFrame frame = std::move(this->dataPtr->saveQueue.front());
+    this->dataPtr->saveQueue.pop_front();
+
+    lock.unlock();
+    Camera::SaveFrame(frame.data.data(), frame.width, frame.height,
+        frame.depth, frame.format, frame.filename);
+    lock.lock();
+  }
+}
+
+//////////////////////////////////////////////////
+void Camera::StopSaveThread()
+{
+  if (!this->dataPtr->saveThread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->saveMutex);
+    this->dataPtr->stopSaveThread = true;
+  }
+  this->dataPtr->saveCondition.notify_all();
+  this->dataPtr->saveThread.join();
+}
+
 //////////////////////////////////////////////////
 std::string Camera::FrameFilename()
 {
@@ -1313,103 +1619,8 @@ void Camera::ConvertRGBToBAYER(unsigned char *_dst,
 {
   if (_src)
   {
-    // do last minute conversion if Bayer pattern is requested, go from R8G8B8
-    if (_format == "BAYER_RGGB8")
-    {
-      for (int i = 0; i < _width; i++)
-      {
-        for (int j = 0; j < _height; j++)
-        {
-          //
-          // RG
-          // GB
-          //
-          // determine position
-          if (j%2)  // even column
-            if (i%2)  // even row, red
-              _dst[i+j*_width] = _src[i*3+j*_width*3+2];
-            else  // odd row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-          else  // odd column
-            if (i%2)  // even row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-            else  // odd row, blue
-              _dst[i+j*_width] = _src[i*3+j*_width*3+0];
-        }
-      }
-    }
-    else if (_format == "BAYER_BGGR8")
-    {
-      for (int i = 0; i < _width; i++)
-      {
-        for (int j = 0; j < _height; j++)
-        {
-          //
-          // BG
-          // GR
-          //
-          // determine position
-          if (j%2)  // even column
-            if (i%2)  // even row, blue
-              _dst[i+j*_width] = _src[i*3+j*_width*3+0];
-            else  // odd row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-          else  // odd column
-            if (i%2)  // even row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-            else  // odd row, red
-              _dst[i+j*_width] = _src[i*3+j*_width*3+2];
-        }
-      }
-    }
-    else if (_format == "BAYER_GBRG8")
-    {
-      for (int i = 0; i < _width; i++)
-      {
-        for (int j = 0; j < _height; j++)
-        {
-          //
-          // GB
-          // RG
-          //
-          // determine position
-          if (j%2)  // even column
-            if (i%2)  // even row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-            else  // odd row, blue
-              _dst[i+j*_width] = _src[i*3+j*_width*3+2];
-          else  // odd column
-            if (i%2)  // even row, red
-              _dst[i+j*_width] = _src[i*3+j*_width*3+0];
-            else  // odd row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-        }
-      }
-    }
-    else if (_format == "BAYER_GRBG8")
-    {
-      for (int i = 0; i < _width; i++)
-      {
-        for (int j = 0; j < _height; j++)
-        {
-          //
-          // GR
-          // BG
-          //
-          // determine position
-          if (j%2)  // even column
-            if (i%2)  // even row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-            else  // odd row, red
-              _dst[i+j*_width] = _src[i*3+j*_width*3+0];
-          else  // odd column
-            if (i%2)  // even row, blue
-              _dst[i+j*_width] = _src[i*3+j*_width*3+2];
-            else  // odd row, green
-              _dst[i+j*_width] = _src[i*3+j*_width*3+1];
-        }
-      }
-    }
+    common::ImageConvert::RGBToBayer(_src, _dst, _width, _height,
+        common::Image::ConvertPixelFormat(_format));
   }
 }
 
@@ -1429,6 +1640,8 @@ void Camera::SetCaptureDataOnce()
 bool Camera::StartVideo(const std::string &_format,
                         const std::string &_filename)
 {
+  // Encode in a worker thread so that recording doesn't stall rendering
+  this->dataPtr->videoEncoder.SetQueueSize(VIDEO_QUEUE_SIZE);
   return this->dataPtr->videoEncoder.Start(_format, _filename,
       this->ImageWidth(), this->ImageHeight());
 }
@@ -1506,6 +1719,7 @@ void Camera::CreateCamera()
   this->cameraNode = this->sceneNode->createChildSceneNode(
       this->scopedUniqueName + "_cameraNode");
   this->cameraNode->attachObject(this->camera);
+  this->camera->setLodBias(this->dataPtr->lodBias);
 
   if (this->sdf->HasElement("projection_type"))
     this->SetProjectionType(this->sdf->Get<std::string>("projection_type"));
@@ -1613,6 +1827,46 @@ void Camera::SetRenderTarget(Ogre::RenderTarget *_target)
     if (this->dataPtr->distortion)
       this->dataPtr->distortion->SetCamera(shared_from_this());
 
+    // Generate the Bayer pattern of Bayer image formats on the GPU, after
+    // distortion, so the image read back only needs one of its channels
+    Ogre::Vector4 pattern;
+    if (BayerPattern(this->ImageFormat(), pattern))
+    {
+      std::string materialName = "Gazebo/" + this->Name() + "_CameraBayer";
+      Ogre::MaterialPtr material =
+          Ogre::MaterialManager::getSingleton().getByName(materialName);
+      if (material.isNull())
+      {
+        material = Ogre::MaterialManager::getSingleton().getByName(
+            "Gazebo/CameraBayer");
+        if (!material.isNull())
+          material = material->clone(materialName);
+      }
+
+      if (!material.isNull())
+      {
+        material->getTechnique(0)->getPass(0)->getFragmentProgramParameters()->
+            setNamedConstant("pattern", pattern);
+
+        this->dataPtr->bayerInstance =
+            Ogre::CompositorManager::getSingleton().addCompositor(
+            this->viewport, "CameraBayer/Default");
+        if (this->dataPtr->bayerInstance &&
+            this->dataPtr->bayerInstance->getTechnique())
+        {
+          this->dataPtr->bayerInstance->getTechnique()->
+              getOutputTargetPass()->getPass(0)->setMaterial(material);
+          this->dataPtr->bayerInstance->setEnabled(true);
+        }
+        else
+        {
+          gzwarn << "Unable to generate the Bayer pattern of camera["
+                 << this->Name() << "] on the GPU\n";
+          this->dataPtr->bayerInstance = nullptr;
+        }
+      }
+    }
+
     if (this->GetScene()->GetSkyX() != NULL)
       this->renderTarget->addListener(this->GetScene()->GetSkyX());
   }
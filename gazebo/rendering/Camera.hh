@@ -393,6 +393,63 @@ namespace gazebo
       /// \return Far clip distance
       public: double FarClip() const;
 
+      /// \brief Set the bias of the levels of detail picked by the camera.
+      /// Each camera picks the level of detail of the meshes it renders
+      /// from their distance. A bias above 1 keeps more detail, for
+      /// instance for a high resolution sensor, and a bias below 1 keeps
+      /// less detail.
+      /// \param[in] _bias The bias, greater than 0.
+      /// \sa LodBias
+      public: void SetLodBias(const double _bias);
+
+      /// \brief Get the bias of the levels of detail picked by the camera.
+      /// \return The bias.
+      /// \sa SetLodBias
+      public: double LodBias() const;
+
+      /// \brief Get the number of triangles drawn in the last frame the
+      /// camera rendered.
+      /// \return Number of triangles.
+      public: uint64_t TriangleCount() const;
+
+      /// \brief Get the number of batches, or draw calls, in the last frame
+      /// the camera rendered.
+      /// \return Number of batches.
+      public: uint64_t BatchCount() const;
+
+      /// \brief Get the average wall time the camera spends rendering a
+      /// frame. This is the time to submit the frame, which includes the
+      /// GPU time when the driver has to wait for the GPU.
+      /// \return Average time over recent frames, in seconds.
+      public: double RenderTime() const;
+
+      /// \brief Get the average wall time the camera spends reading back a
+      /// frame from the GPU.
+      /// \return Average time over recent frames, in seconds.
+      public: double ReadbackTime() const;
+
+      /// \brief Set a wall time budget for rendering a frame. When the
+      /// average render time exceeds the budget, the camera first stops
+      /// rendering shadows, and then picks lower levels of detail. Both
+      /// come back once the render time is well within the budget.
+      /// \param[in] _budget Budget in seconds, zero to disable it.
+      /// \sa RenderBudgetLevel
+      public: void SetRenderBudget(const double _budget);
+
+      /// \brief Get the wall time budget for rendering a frame.
+      /// \return Budget in seconds, zero if disabled.
+      public: double RenderBudget() const;
+
+      /// \brief Get how much rendering is reduced to meet the render
+      /// budget: 0 for not at all, 1 without shadows, and 2 without shadows
+      /// and with lower levels of detail.
+      /// \return The budget level.
+      public: unsigned int RenderBudgetLevel() const;
+
+      /// \brief Fill a message with the rendering statistics of the camera.
+      /// \param[out] _msg Message to fill.
+      public: void FillStatsMsg(msgs::RenderingStats::Camera &_msg) const;
+
       /// \brief Enable or disable saving
       /// \param[in] _enable Set to True to enable saving of frames
       public: void EnableSaveFrame(const bool _enable);
@@ -876,6 +933,26 @@ namespace gazebo
       /// \brief Create the ogre camera.
       private: void CreateCamera();
 
+      /// \brief Copy the last frame into the save queue, to be written to
+      /// disk by the save thread. The frame is dropped if the queue is full.
+      /// \param[in] _filename File to write the frame to.
+      private: void QueueSaveFrame(const std::string &_filename);
+
+      /// \brief Write queued frames to disk until stopped.
+      private: void RunSaveThread();
+
+      /// \brief Stop the save thread once it has written the queued frames.
+      private: void StopSaveThread();
+
+      /// \brief Record the statistics of a rendered frame, and change the
+      /// budget level if the render time is out of the budget.
+      /// \param[in] _renderTime Wall time spent rendering the frame.
+      protected: void RecordRender(const common::Time &_renderTime);
+
+      /// \brief Apply the shadows and levels of detail of the budget level.
+      /// \param[in] _previousLevel Budget level before the change.
+      private: void ApplyRenderBudget(const unsigned int _previousLevel);
+
       /// \brief Name of the camera.
       protected: std::string name;
 
@@ -17,10 +17,14 @@
 #ifndef GAZEBO_RENDERING_CAMERAPRIVATE_HH_
 #define GAZEBO_RENDERING_CAMERAPRIVATE_HH_
 
+#include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
 #include <list>
+#include <vector>
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/common/PID.hh"
@@ -37,6 +41,28 @@ namespace gazebo
 {
   namespace rendering
   {
+    /// \brief A frame waiting to be written to disk.
+    class SavedFrame
+    {
+      /// \brief Image data.
+      public: std::vector<unsigned char> data;
+
+      /// \brief Image width.
+      public: unsigned int width = 0;
+
+      /// \brief Image height.
+      public: unsigned int height = 0;
+
+      /// \brief Image depth.
+      public: int depth = 0;
+
+      /// \brief Image format.
+      public: std::string format;
+
+      /// \brief File to write the image to.
+      public: std::string filename;
+    };
+
     /// \brief Private data for the Camera class
     class GZ_RENDERING_VISIBLE CameraPrivate
     {
@@ -64,6 +90,10 @@ namespace gazebo
       /// \brief Lens distortion model
       public: DistortionPtr distortion;
 
+      /// \brief Compositor that generates the Bayer pattern of Bayer image
+      /// formats, null if the pattern is generated after readback.
+      public: Ogre::CompositorInstance *bayerInstance = nullptr;
+
       /// \brief Queue of move positions.
       public: std::deque<std::pair<ignition::math::Pose3d, double> >
               moveToPositionQueue;
@@ -117,6 +147,53 @@ namespace gazebo
 
       /// \brief Fixed axis to yaw around.
       public: ignition::math::Vector3d yawFixedAxis;
+
+      /// \brief Bias applied to the levels of detail picked by the camera.
+      public: double lodBias = 1.0;
+
+      /// \brief Number of triangles drawn in the last rendered frame.
+      public: uint64_t triangleCount = 0;
+
+      /// \brief Number of batches drawn in the last rendered frame.
+      public: uint64_t batchCount = 0;
+
+      /// \brief Average wall time of rendering a frame, in seconds.
+      public: double renderTime = 0;
+
+      /// \brief Average wall time of reading back a frame, in seconds.
+      public: double readbackTime = 0;
+
+      /// \brief Wall time budget of rendering a frame, in seconds. Zero
+      /// disables the budget.
+      public: double renderBudget = 0;
+
+      /// \brief How much rendering is currently reduced to meet the budget.
+      public: unsigned int budgetLevel = 0;
+
+      /// \brief Frames rendered since the budget level last changed.
+      public: unsigned int budgetFrames = 0;
+
+      /// \brief Whether the viewport had shadows before the budget
+      /// disabled them.
+      public: bool budgetShadows = true;
+
+      /// \brief Frames waiting to be written to disk.
+      public: std::deque<SavedFrame> saveQueue;
+
+      /// \brief Thread writing the queued frames to disk.
+      public: std::thread saveThread;
+
+      /// \brief True to stop the save thread once the queue is empty.
+      public: bool stopSaveThread = false;
+
+      /// \brief Number of frames dropped because the save queue was full.
+      public: uint64_t droppedSaveFrames = 0;
+
+      /// \brief Protects the save queue.
+      public: std::mutex saveMutex;
+
+      /// \brief Signals the save thread of a new frame or of a stop.
+      public: std::condition_variable saveCondition;
     };
   }
 }
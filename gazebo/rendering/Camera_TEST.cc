@@ -16,6 +16,10 @@
 */
 
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+#include "gazebo/common/Image.hh"
+#include "gazebo/common/ImageConvert.hh"
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/RenderTypes.hh"
@@ -184,6 +188,136 @@ TEST_F(Camera_TEST, Create)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, RenderBudget)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_budget", false);
+  ASSERT_TRUE(camera != nullptr);
+
+  // No budget by default
+  EXPECT_DOUBLE_EQ(0.0, camera->RenderBudget());
+  EXPECT_EQ(0u, camera->RenderBudgetLevel());
+  EXPECT_EQ(0u, camera->TriangleCount());
+  EXPECT_EQ(0u, camera->BatchCount());
+  EXPECT_DOUBLE_EQ(0.0, camera->RenderTime());
+
+  camera->SetRenderBudget(0.01);
+  EXPECT_DOUBLE_EQ(0.01, camera->RenderBudget());
+
+  // Negative budgets disable the budget
+  camera->SetRenderBudget(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, camera->RenderBudget());
+  EXPECT_EQ(0u, camera->RenderBudgetLevel());
+
+  msgs::RenderingStats::Camera msg;
+  camera->FillStatsMsg(msg);
+  EXPECT_EQ(camera->ScopedName(), msg.name());
+  EXPECT_EQ(0u, msg.triangles());
+  EXPECT_FALSE(msg.has_render_budget());
+
+  scene->RemoveCamera(camera->Name());
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a camera that captures its images.
+/// \param[in] _scene Scene to create the camera in.
+/// \param[in] _name Name of the camera.
+/// \param[in] _format Image format.
+/// \return The camera.
+rendering::CameraPtr createCapturingCamera(rendering::ScenePtr _scene,
+    const std::string &_name, const std::string &_format)
+{
+  rendering::CameraPtr camera = _scene->CreateCamera(_name, false);
+  if (!camera)
+    return camera;
+
+  std::stringstream ss;
+  ss << "<sdf version='" << SDF_VERSION << "'>"
+     << "  <camera>"
+     << "    <horizontal_fov>1.0</horizontal_fov>"
+     << "    <image>"
+     << "      <width>160</width>"
+     << "      <height>120</height>"
+     << "      <format>" << _format << "</format>"
+     << "    </image>"
+     << "    <clip>"
+     << "      <near>0.1</near><far>100</far>"
+     << "    </clip>"
+     << "  </camera>"
+     << "</sdf>";
+  sdf::ElementPtr cameraSDF(new sdf::Element);
+  sdf::initFile("camera.sdf", cameraSDF);
+  sdf::readString(ss.str(), cameraSDF);
+  camera->Load(cameraSDF);
+  camera->Init();
+  camera->CreateRenderTexture(_name + "_render_target");
+  camera->SetCaptureData(true);
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 2, 0, 0.3, 0));
+  return camera;
+}
+
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, BayerPattern)
+{
+  Load("worlds/shapes.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr rgbCamera =
+      createCapturingCamera(scene, "test_camera_bayer_rgb", "R8G8B8");
+  ASSERT_TRUE(rgbCamera != nullptr);
+
+  const unsigned int width = rgbCamera->ImageWidth();
+  const unsigned int height = rgbCamera->ImageHeight();
+
+  for (auto const &format : {"BAYER_RGGB8", "BAYER_BGGR8", "BAYER_GBRG8",
+                             "BAYER_GRBG8"})
+  {
+    rendering::CameraPtr camera = createCapturingCamera(scene,
+        std::string("test_camera_") + format, format);
+    ASSERT_TRUE(camera != nullptr);
+    EXPECT_EQ(1u, camera->ImageDepth());
+
+    scene->PreRender();
+    rgbCamera->Render(true);
+    rgbCamera->PostRender();
+    camera->Render(true);
+    camera->PostRender();
+
+    const unsigned char *rgb = rgbCamera->ImageData();
+    const unsigned char *bayer = camera->ImageData();
+    ASSERT_TRUE(rgb != nullptr);
+    ASSERT_TRUE(bayer != nullptr);
+
+    // The pattern generated by the camera matches the one of the RGB image
+    std::vector<uint8_t> expected(width * height);
+    ASSERT_TRUE(common::ImageConvert::RGBToBayer(rgb, expected.data(),
+        width, height, common::Image::ConvertPixelFormat(format)));
+
+    unsigned int mismatches = 0;
+    for (unsigned int i = 0; i < width * height; ++i)
+    {
+      if (std::abs(static_cast<int>(expected[i]) - bayer[i]) > 2)
+        ++mismatches;
+    }
+    EXPECT_EQ(0u, mismatches) << format;
+
+    scene->RemoveCamera(camera->Name());
+  }
+
+  scene->RemoveCamera(rgbCamera->Name());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -19,7 +19,6 @@
  */
 #include <boost/bind.hpp>
 
-#include "gazebo/common/MeshManager.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Subscriber.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -53,9 +52,6 @@ ContactVisual::ContactVisual(const std::string &_name, VisualPtr _vis,
   dPtr->contactsSub = dPtr->node->Subscribe(dPtr->topicName,
       &ContactVisual::OnContact, this);
 
-  common::MeshManager::Instance()->CreateSphere("contact_sphere", 0.02, 10, 10);
-  this->InsertMesh("contact_sphere");
-
   dPtr->connections.push_back(
       event::Events::ConnectPreRender(
         boost::bind(&ContactVisual::Update, this)));
@@ -85,7 +81,22 @@ void ContactVisual::Update()
   double vRange = vMax - vMin;
   double offset = vRange - vMin;
 
-  unsigned int c = 0;
+  // Create the renderables on first use, once the scene node exists
+  if (!dPtr->points)
+  {
+    dPtr->points = this->CreateDynamicLine(RENDERING_POINT_LIST);
+    dPtr->normals = this->CreateDynamicLine(RENDERING_LINE_LIST);
+    dPtr->depths = this->CreateDynamicLine(RENDERING_LINE_LIST);
+    GZ_OGRE_SET_MATERIAL_BY_NAME(dPtr->points, "Gazebo/ContactPoint");
+    GZ_OGRE_SET_MATERIAL_BY_NAME(dPtr->normals, "Gazebo/LightOn");
+    GZ_OGRE_SET_MATERIAL_BY_NAME(dPtr->depths, "Gazebo/LightOff");
+    this->SetVisibilityFlags(GZ_VISIBILITY_GUI);
+  }
+
+  dPtr->points->Clear();
+  dPtr->normals->Clear();
+  dPtr->depths->Clear();
+
   for (int i = 0; i < dPtr->contactsMsg->contact_size(); i++)
   {
     for (int j = 0; j < dPtr->contactsMsg->contact(i).position_size(); j++)
@@ -104,26 +115,19 @@ void ContactVisual::Update()
       double normalScale = (2.0 * vRange) / (1 + exp
           (-force.SquaredLength() / magScale)) - offset;
 
-      // Create a new contact visualization point if necessary
-      if (c >= dPtr->points.size())
-        this->CreateNewPoint();
-
-      dPtr->points[c]->contactPointVis->SetVisible(true);
-      dPtr->points[c]->contactPointVis->SetPosition(pos);
+      dPtr->points->AddPoint(pos, ignition::math::Color::Blue);
 
-      dPtr->points[c]->normal->SetPoint(1, (normal*normalScale));
-      dPtr->points[c]->depth->SetPoint(1, (normal*-depth*10));
+      dPtr->normals->AddPoint(pos);
+      dPtr->normals->AddPoint(pos + normal * normalScale);
 
-      GZ_OGRE_SET_MATERIAL_BY_NAME(dPtr->points[c]->normal, "Gazebo/LightOn");
-      GZ_OGRE_SET_MATERIAL_BY_NAME(dPtr->points[c]->depth, "Gazebo/LightOff");
-      dPtr->points[c]->depth->Update();
-      dPtr->points[c]->normal->Update();
-      c++;
+      dPtr->depths->AddPoint(pos);
+      dPtr->depths->AddPoint(pos + normal * -depth * 10);
     }
   }
 
-  for ( ; c < dPtr->points.size(); c++)
-    dPtr->points[c]->contactPointVis->SetVisible(false);
+  dPtr->points->Update();
+  dPtr->normals->Update();
+  dPtr->depths->Update();
 
   dPtr->receivedMsg = false;
 }
@@ -159,8 +163,15 @@ void ContactVisual::SetEnabled(bool _enabled)
     dPtr->contactsMsg.reset();
     dPtr->receivedMsg = false;
 
-    for (unsigned int c = 0 ; c < dPtr->points.size(); c++)
-      dPtr->points[c]->contactPointVis->SetVisible(false);
+    if (dPtr->points)
+    {
+      dPtr->points->Clear();
+      dPtr->normals->Clear();
+      dPtr->depths->Clear();
+      dPtr->points->Update();
+      dPtr->normals->Update();
+      dPtr->depths->Update();
+    }
   }
   else if (!dPtr->contactsSub)
   {
@@ -168,38 +179,3 @@ void ContactVisual::SetEnabled(bool _enabled)
         &ContactVisual::OnContact, this);
   }
 }
-
-/////////////////////////////////////////////////
-void ContactVisual::CreateNewPoint()
-{
-  ContactVisualPrivate *dPtr =
-      reinterpret_cast<ContactVisualPrivate *>(this->dataPtr);
-
-  std::string objName = this->Name() +
-    "_contactpoint_" + std::to_string(dPtr->points.size());
-
-  ContactVisualPrivate::ContactPoint *cp =
-      new ContactVisualPrivate::ContactPoint();
-
-  cp->contactPointVis.reset(
-      new Visual(objName + "_node", shared_from_this(), false));
-  cp->contactPointVis->Load();
-
-  /// \todo We can improve this by using instanced geometry.
-  cp->contactPointVis->AttachMesh("contact_sphere");
-  cp->contactPointVis->SetMaterial("Gazebo/BlueLaser");
-
-  cp->normal = cp->contactPointVis->CreateDynamicLine(RENDERING_LINE_LIST);
-  cp->depth = cp->contactPointVis->CreateDynamicLine(RENDERING_LINE_LIST);
-
-  cp->normal->AddPoint(ignition::math::Vector3d(0, 0, 0));
-  cp->normal->AddPoint(ignition::math::Vector3d(0, 0, 0.1));
-
-  cp->depth->AddPoint(ignition::math::Vector3d(0, 0, 0));
-  cp->depth->AddPoint(ignition::math::Vector3d(0, 0, -1));
-
-  cp->contactPointVis->SetVisibilityFlags(GZ_VISIBILITY_GUI);
-  cp->contactPointVis->SetVisible(false);
-
-  dPtr->points.push_back(cp);
-}
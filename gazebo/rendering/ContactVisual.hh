@@ -35,7 +35,8 @@ namespace gazebo
     /// \brief Contact visualization
     ///
     /// This class visualizes contact points by drawing arrows in the 3D
-    /// environment.
+    /// environment. All the contacts are drawn with three renderables,
+    /// for the points, the normals and the depths, updated in place.
     class GZ_RENDERING_VISIBLE ContactVisual : public Visual
     {
       /// \brief Constructor
@@ -59,9 +60,6 @@ namespace gazebo
       /// \brief Callback when a Contact message is received
       /// \param[in] _msg The Contact message
       private: void OnContact(ConstContactsPtr &_msg);
-
-      /// \brief Create a new contact visualization point.
-      private: void CreateNewPoint();
     };
     /// \}
   }
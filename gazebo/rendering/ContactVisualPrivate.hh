@@ -47,17 +47,14 @@ namespace gazebo
       /// \brief All the event connections.
       public: std::vector<event::ConnectionPtr> connections;
 
-      /// \brief A contact point visualization.
-      public: class ContactPoint
-               {
-                 /// \brief The contact point visual
-                 public: VisualPtr contactPointVis;
-                 /// \brief Normal and depth for the contact point.
-                 public: DynamicLines *normal, *depth;
-               };
+      /// \brief All the contact points, drawn as point sprites.
+      public: DynamicLines *points = nullptr;
 
-      /// \brief All the contact points.
-      public: std::vector<ContactVisualPrivate::ContactPoint *> points;
+      /// \brief Normals of all the contact points.
+      public: DynamicLines *normals = nullptr;
+
+      /// \brief Depths of all the contact points.
+      public: DynamicLines *depths = nullptr;
 
       /// \brief Mutex to protect the contact message.
       public: boost::mutex mutex;
@@ -16,6 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include "gazebo/common/Events.hh"
+#include "gazebo/rendering/DynamicLines.hh"
+#include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/rendering/Scene.hh"
@@ -61,6 +64,129 @@ TEST_F(ContactVisual_TEST, ContactVisualTest)
   EXPECT_EQ(scene->WorldVisual()->GetChildCount(), count);
 }
 
+/////////////////////////////////////////////////
+/// \brief Count the points of the lines drawn by a visual.
+/// \param[in] _vis The visual.
+/// \param[in] _type Operation type of the lines to count.
+/// \param[out] _lines Number of lines of that type.
+/// \return Number of points.
+unsigned int PointCount(gazebo::rendering::VisualPtr _vis,
+    const gazebo::rendering::RenderOpType _type, unsigned int &_lines)
+{
+  unsigned int count = 0;
+  _lines = 0;
+  auto iter = _vis->GetSceneNode()->getAttachedObjectIterator();
+  while (iter.hasMoreElements())
+  {
+    auto line = dynamic_cast<gazebo::rendering::DynamicLines *>(
+        iter.getNext());
+    if (line && line->GetOperationType() == _type)
+    {
+      count += line->GetPointCount();
+      ++_lines;
+    }
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+TEST_F(ContactVisual_TEST, Contacts)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  std::shared_ptr<gazebo::rendering::ContactVisual> contactVis(
+      new gazebo::rendering::ContactVisual(
+      "contact_vis", scene->WorldVisual(), "~/test_contacts"));
+  contactVis->Load();
+  contactVis->SetEnabled(true);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  transport::PublisherPtr pub =
+      node->Advertise<msgs::Contacts>("~/test_contacts");
+  pub->WaitForConnection();
+
+  // Two contacts with three points in all
+  msgs::Contacts msg;
+  for (int i = 0; i < 2; ++i)
+  {
+    msgs::Contact *contact = msg.add_contact();
+    contact->set_collision1("box::link::collision");
+    contact->set_collision2("ground_plane::link::collision");
+    for (int j = 0; j <= i; ++j)
+    {
+      msgs::Set(contact->add_position(), ignition::math::Vector3d(i, j, 0));
+      msgs::Set(contact->add_normal(), ignition::math::Vector3d::UnitZ);
+      contact->add_depth(0.01);
+      msgs::JointWrench *wrench = contact->add_wrench();
+      wrench->set_body_1_name("box::link");
+      wrench->set_body_1_id(1);
+      wrench->set_body_2_name("ground_plane::link");
+      wrench->set_body_2_id(2);
+      msgs::Set(wrench->mutable_body_1_wrench()->mutable_force(),
+          ignition::math::Vector3d(0, 0, 10));
+      msgs::Set(wrench->mutable_body_1_wrench()->mutable_torque(),
+          ignition::math::Vector3d::Zero);
+      msgs::Set(wrench->mutable_body_2_wrench()->mutable_force(),
+          ignition::math::Vector3d(0, 0, -10));
+      msgs::Set(wrench->mutable_body_2_wrench()->mutable_torque(),
+          ignition::math::Vector3d::Zero);
+    }
+  }
+  msgs::Set(msg.mutable_time(), common::Time(1));
+  pub->Publish(msg);
+
+  // All the contacts are drawn by one point list and two line lists
+  unsigned int pointLists = 0;
+  unsigned int lineLists = 0;
+  int sleep = 0;
+  const int maxSleep = 50;
+  while (PointCount(contactVis, gazebo::rendering::RENDERING_POINT_LIST,
+        pointLists) < 3u && sleep++ < maxSleep)
+  {
+    common::Time::MSleep(100);
+    event::Events::preRender();
+  }
+  EXPECT_EQ(3u, PointCount(contactVis,
+        gazebo::rendering::RENDERING_POINT_LIST, pointLists));
+  EXPECT_EQ(1u, pointLists);
+  EXPECT_EQ(12u, PointCount(contactVis,
+        gazebo::rendering::RENDERING_LINE_LIST, lineLists));
+  EXPECT_EQ(2u, lineLists);
+  EXPECT_EQ(0u, contactVis->GetChildCount());
+
+  // Fewer contacts reuse the same lines
+  msg.mutable_contact()->RemoveLast();
+  pub->Publish(msg);
+  sleep = 0;
+  while (PointCount(contactVis, gazebo::rendering::RENDERING_POINT_LIST,
+        pointLists) > 1u && sleep++ < maxSleep)
+  {
+    common::Time::MSleep(100);
+    event::Events::preRender();
+  }
+  EXPECT_EQ(1u, PointCount(contactVis,
+        gazebo::rendering::RENDERING_POINT_LIST, pointLists));
+  EXPECT_EQ(1u, pointLists);
+  EXPECT_EQ(4u, PointCount(contactVis,
+        gazebo::rendering::RENDERING_LINE_LIST, lineLists));
+  EXPECT_EQ(2u, lineLists);
+
+  // Disabling the visual clears the contacts
+  contactVis->SetEnabled(false);
+  EXPECT_EQ(0u, PointCount(contactVis,
+        gazebo::rendering::RENDERING_POINT_LIST, pointLists));
+  EXPECT_EQ(0u, PointCount(contactVis,
+        gazebo::rendering::RENDERING_LINE_LIST, lineLists));
+
+  contactVis->Fini();
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -47,12 +47,243 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
 #include "gazebo/rendering/CustomPSSMShadowCameraSetup.hh"
+#include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/rendering/ogre_gazebo.h"
 
 using namespace gazebo;
 using namespace rendering;
 
+/// \brief Number of calls to UpdateCasters after which a caster that
+/// stopped moving is static again.
+static const unsigned int RestUpdates = 100u;
+
+/// \brief Number of changes of the static casters in one update beyond
+/// which all the cached shadow maps of the scene are discarded.
+static const size_t MaxDirtyBoxes = 64u;
+
+/// \brief Number of cascades whose last key is kept, beyond which the keys
+/// are forgotten.
+static const size_t MaxLastKeys = 4096u;
+
+/// \brief Name of the material restoring cached shadow maps.
+static const char *RestoreMaterialName = "Gazebo/shadow_cache_restore";
+
+/// \brief Everything the content of a cached shadow map depends on.
+class ShadowCacheKey
+{
+  /// \brief Equality operator.
+  /// \param[in] _key Key to compare with.
+  /// \return True if the keys are equal.
+  public: bool operator==(const ShadowCacheKey &_key) const
+  {
+    return this->sceneManager == _key.sceneManager &&
+        this->light == _key.light &&
+        this->width == _key.width && this->height == _key.height &&
+        this->mask == _key.mask &&
+        this->lightDir == _key.lightDir &&
+        this->view == _key.view && this->proj == _key.proj &&
+        this->scheme == _key.scheme;
+  }
+
+  /// \brief Scene manager.
+  public: const Ogre::SceneManager *sceneManager = nullptr;
+
+  /// \brief Light casting the shadows.
+  public: const Ogre::Light *light = nullptr;
+
+  /// \brief Direction of the light.
+  public: Ogre::Vector3 lightDir = Ogre::Vector3::ZERO;
+
+  /// \brief View matrix of the shadow camera.
+  public: Ogre::Matrix4 view = Ogre::Matrix4::IDENTITY;
+
+  /// \brief Projection matrix of the shadow camera.
+  public: Ogre::Matrix4 proj = Ogre::Matrix4::IDENTITY;
+
+  /// \brief Visibility mask of the shadow texture viewport.
+  public: uint32_t mask = 0u;
+
+  /// \brief Material scheme of the shadow texture viewport.
+  public: Ogre::String scheme;
+
+  /// \brief Width of the shadow texture.
+  public: size_t width = 0u;
+
+  /// \brief Height of the shadow texture.
+  public: size_t height = 0u;
+};
+
+/// \brief Cached shadow map of static casters.
+class ShadowCacheEntry
+{
+  /// \brief Key of the shadow map.
+  public: ShadowCacheKey key;
+
+  /// \brief False once discarded.
+  public: bool valid = false;
+
+  /// \brief Texture holding the shadow map.
+  public: Ogre::TexturePtr texture;
+
+  /// \brief World bounds of the shadow camera frustum.
+  public: Ogre::AxisAlignedBox bounds;
+
+  /// \brief Bounds of the static casters seen by the shadow camera.
+  public: Ogre::AxisAlignedBox casterBounds;
+
+  /// \brief Value of the use counter when last used.
+  public: uint64_t lastUse = 0u;
+};
+
+/// \brief Tracked shadow caster.
+class ShadowCasterState
+{
+  /// \brief Derived position of the parent node.
+  public: Ogre::Vector3 position = Ogre::Vector3::ZERO;
+
+  /// \brief Derived orientation of the parent node.
+  public: Ogre::Quaternion orientation = Ogre::Quaternion::IDENTITY;
+
+  /// \brief Derived scale of the parent node.
+  public: Ogre::Vector3 scale = Ogre::Vector3::UNIT_SCALE;
+
+  /// \brief World bounds, while in the static shadow maps.
+  public: Ogre::AxisAlignedBox bounds;
+
+  /// \brief True if drawn in the static shadow maps.
+  public: bool isStatic = false;
+
+  /// \brief True if drawn over the static shadow maps.
+  public: bool dynamic = false;
+
+  /// \brief Number of updates since the caster last moved.
+  public: unsigned int rest = 0u;
+
+  /// \brief Last update that found the caster.
+  public: uint64_t update = 0u;
+};
+
+/// \brief Shadow casters of a scene manager.
+class ShadowCasterTracker
+{
+  /// \brief Number of updates.
+  public: uint64_t update = 0u;
+
+  /// \brief Tracked casters.
+  public: std::unordered_map<Ogre::Entity *, ShadowCasterState> casters;
+
+  /// \brief Dynamic casters, with their names to check they still exist.
+  public: std::vector<std::pair<Ogre::String, Ogre::Entity *>> dynamic;
+};
+
+/// \brief State of a shadow texture, by shadow camera.
+class ShadowTextureState
+{
+  /// \brief True if the viewport only draws dynamic casters.
+  public: bool overridden = false;
+
+  /// \brief Visibility mask of the viewport, while overridden.
+  public: uint32_t mask = 0u;
+
+  /// \brief True once the matrices were set.
+  public: bool hasMatrices = false;
+
+  /// \brief View matrix of the shadow camera.
+  public: Ogre::Matrix4 view = Ogre::Matrix4::IDENTITY;
+
+  /// \brief Projection matrix of the shadow camera.
+  public: Ogre::Matrix4 proj = Ogre::Matrix4::IDENTITY;
+
+  /// \brief Bounds of the static casters of the restored shadow map, null
+  /// if the last update drew all casters.
+  public: Ogre::AxisAlignedBox staticBounds;
+};
+
+/// \brief Private data for the CustomPSSMShadowCameraSetup class.
+class gazebo::rendering::CustomPSSMShadowCameraSetupPrivate
+{
+  /// \brief Number of cached shadow maps, 0 if disabled.
+  public: unsigned int cacheSize = 0u;
+
+  /// \brief Cached shadow maps.
+  public: std::vector<ShadowCacheEntry> entries;
+
+  /// \brief Use counter of the cached shadow maps.
+  public: uint64_t useCount = 0u;
+
+  /// \brief Number of cache hits.
+  public: uint64_t hits = 0u;
+
+  /// \brief Number of textures created, to name them.
+  public: unsigned int textureCount = 0u;
+
+  /// \brief State of the shadow textures, by shadow camera.
+  public: std::map<const Ogre::Camera *, ShadowTextureState> textures;
+
+  /// \brief Last key of each cascade of the viewing cameras.
+  public: std::map<std::pair<const Ogre::Camera *, size_t>, ShadowCacheKey>
+          lastKeys;
+
+  /// \brief Shadow casters, by scene manager.
+  public: std::map<const Ogre::SceneManager *, ShadowCasterTracker> trackers;
+
+  /// \brief Material restoring cached shadow maps.
+  public: Ogre::MaterialPtr restoreMaterial;
+
+  /// \brief Full screen quad drawn with the restore material.
+  public: std::unique_ptr<Ogre::Rectangle2D> quad;
+
+  /// \brief True if the restore material couldn't be loaded.
+  public: bool restoreFailed = false;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get whether a caster is seen by every camera that sees any
+/// visual, so that it can be drawn with the GZ_VISIBILITY_SHADOW_DYNAMIC
+/// mask alone.
+/// \param[in] _flags Visibility flags of the caster.
+/// \return True if the caster can be dynamic.
+static bool CanBeDynamic(const uint32_t _flags)
+{
+  return (_flags & GZ_VISIBILITY_ALL) == GZ_VISIBILITY_ALL;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the world bounds of a frustum.
+/// \param[in] _view View matrix.
+/// \param[in] _proj Projection matrix.
+/// \return Bounds of the frustum.
+static Ogre::AxisAlignedBox FrustumBounds(const Ogre::Matrix4 &_view,
+    const Ogre::Matrix4 &_proj)
+{
+  const Ogre::Matrix4 inverse = (_proj * _view).inverse();
+  Ogre::AxisAlignedBox bounds;
+  for (int i = 0; i < 8; ++i)
+  {
+    bounds.merge(inverse * Ogre::Vector3(
+        i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1));
+  }
+  return bounds;
+}
+
+//////////////////////////////////////////////////
+/// \brief Remove a texture from the texture manager.
+/// \param[in, out] _texture The texture, null afterwards.
+static void RemoveTexture(Ogre::TexturePtr &_texture)
+{
+  if (!_texture.isNull() && Ogre::TextureManager::getSingletonPtr())
+    Ogre::TextureManager::getSingleton().remove(_texture->getName());
+  _texture.setNull();
+}
+
 Ogre::String CustomPSSM3::Type = "CustomPSSM3";
 
 //////////////////////////////////////////////////
@@ -314,12 +545,15 @@ Ogre::RTShader::SubRenderState *CustomPSSM3Factory::createInstanceImpl()
 
 //////////////////////////////////////////////////
 CustomPSSMShadowCameraSetup::CustomPSSMShadowCameraSetup()
+  : dataPtr(new CustomPSSMShadowCameraSetupPrivate)
 {
 }
 
 //////////////////////////////////////////////////
 CustomPSSMShadowCameraSetup::~CustomPSSMShadowCameraSetup()
 {
+  for (auto &entry : this->dataPtr->entries)
+    RemoveTexture(entry.texture);
 }
 
 //////////////////////////////////////////////////
@@ -508,6 +742,12 @@ void CustomPSSMShadowCameraSetup::getZUpFocusedShadowCamera(
   const Ogre::VisibleObjectsBoundsInfo& visInfo =
       _sm->getVisibleObjectsBoundsInfo(_texCam);
   Ogre::AxisAlignedBox sceneBB = visInfo.aabb;
+
+  // The last update of a cached shadow map only found the dynamic casters,
+  // add the static ones so that the frustum doesn't change
+  auto texState = this->dataPtr->textures.find(_texCam);
+  if (texState != this->dataPtr->textures.end())
+    sceneBB.merge(texState->second.staticBounds);
   Ogre::AxisAlignedBox receiverAABB =
       _sm->getVisibleObjectsBoundsInfo(_cam).receiverAabb;
   sceneBB.merge(receiverAABB);
@@ -517,12 +757,7 @@ void CustomPSSMShadowCameraSetup::getZUpFocusedShadowCamera(
   // return the standard shadow mapping matrix
   if (sceneBB.isNull())
   {
-#if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 11
-    _texCam->setCustomViewMatrix(true, Ogre::Affine3(LView));
-#else
-    _texCam->setCustomViewMatrix(true, LView);
-#endif
-    _texCam->setCustomProjectionMatrix(true, LProj);
+    this->SetShadowCameraMatrices(_texCam, LView, LProj);
     return;
   }
 
@@ -535,12 +770,7 @@ void CustomPSSMShadowCameraSetup::getZUpFocusedShadowCamera(
   // simply return the standard shadow mapping matrix
   if (mPointListBodyB.getPointCount() == 0)
   {
-#if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 11
-    _texCam->setCustomViewMatrix(true, Ogre::Affine3(LView));
-#else
-    _texCam->setCustomViewMatrix(true, LView);
-#endif
-    _texCam->setCustomProjectionMatrix(true, LProj);
+    this->SetShadowCameraMatrices(_texCam, LView, LProj);
     return;
   }
 
@@ -575,12 +805,7 @@ void CustomPSSMShadowCameraSetup::getZUpFocusedShadowCamera(
   // LProj = msLightSpaceToNormal * LProj;
 
   // set the two custom matrices
-#if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 11
-    _texCam->setCustomViewMatrix(true, Ogre::Affine3(LView));
-#else
-    _texCam->setCustomViewMatrix(true, LView);
-#endif
-    _texCam->setCustomProjectionMatrix(true, LProj);
+  this->SetShadowCameraMatrices(_texCam, LView, LProj);
 }
 
 //////////////////////////////////////////////////
@@ -624,6 +849,372 @@ void CustomPSSMShadowCameraSetup::getShadowCamera(const Ogre::SceneManager *_sm,
   // restore near/far
   cam->setNearClipDistance(oldNear);
   cam->setFarClipDistance(oldFar);
+
+  this->UpdateStaticCache(_sm, _cam, _light, _texCam, _iteration);
+}
+
+//////////////////////////////////////////////////
+void CustomPSSMShadowCameraSetup::SetShadowCameraMatrices(
+    Ogre::Camera *_texCam, const Ogre::Matrix4 &_view,
+    const Ogre::Matrix4 &_proj) const
+{
+#if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 11
+  _texCam->setCustomViewMatrix(true, Ogre::Affine3(_view));
+#else
+  _texCam->setCustomViewMatrix(true, _view);
+#endif
+  _texCam->setCustomProjectionMatrix(true, _proj);
+
+  ShadowTextureState &texState = this->dataPtr->textures[_texCam];
+  texState.hasMatrices = true;
+  texState.view = _view;
+  texState.proj = _proj;
+}
+
+//////////////////////////////////////////////////
+void CustomPSSMShadowCameraSetup::UpdateStaticCache(
+    const Ogre::SceneManager *_sm, const Ogre::Camera *_cam,
+    const Ogre::Light *_light, Ogre::Camera *_texCam,
+    const size_t _iteration) const
+{
+  Ogre::Viewport *vp = _texCam->getViewport();
+  if (!vp)
+    return;
+
+  // Undo the changes made for the previous update of this shadow texture.
+  // The scene manager may have set the visibility mask again already.
+  ShadowTextureState &texState = this->dataPtr->textures[_texCam];
+  if (texState.overridden)
+  {
+    if (vp->getVisibilityMask() == GZ_VISIBILITY_SHADOW_DYNAMIC)
+      vp->setVisibilityMask(texState.mask);
+    vp->setClearEveryFrame(true);
+    texState.overridden = false;
+  }
+  texState.staticBounds.setNull();
+
+  const uint32_t mask = vp->getVisibilityMask();
+  if (this->dataPtr->cacheSize == 0u || !texState.hasMatrices ||
+      _light->getType() != Ogre::Light::LT_DIRECTIONAL ||
+      !(mask & GZ_VISIBILITY_ALL))
+  {
+    return;
+  }
+
+  // Dynamic casters are unknown until UpdateCasters is called
+  auto tracker = this->dataPtr->trackers.find(_sm);
+  if (tracker == this->dataPtr->trackers.end())
+    return;
+
+  Ogre::SceneManager *sm = const_cast<Ogre::SceneManager *>(_sm);
+  Ogre::TexturePtr shadowTex;
+  for (size_t i = 0; i < sm->getShadowTextureCount(); ++i)
+  {
+    const Ogre::TexturePtr &tex = sm->getShadowTexture(i);
+    if (tex->getBuffer()->getRenderTarget() == vp->getTarget())
+    {
+      shadowTex = tex;
+      break;
+    }
+  }
+  if (shadowTex.isNull())
+    return;
+
+  if (this->dataPtr->restoreMaterial.isNull())
+  {
+    if (this->dataPtr->restoreFailed)
+      return;
+
+    this->dataPtr->restoreMaterial =
+        Ogre::MaterialManager::getSingleton().getByName(RestoreMaterialName);
+    if (this->dataPtr->restoreMaterial.isNull())
+    {
+      gzerr << "Unable to find material [" << RestoreMaterialName
+            << "], shadow maps won't be cached" << std::endl;
+      this->dataPtr->restoreFailed = true;
+      return;
+    }
+    this->dataPtr->restoreMaterial->load();
+
+    // The scene manager replaces the passes drawn into shadow textures by
+    // the shadow caster material of their technique
+    this->dataPtr->restoreMaterial->getBestTechnique()->
+        setShadowCasterMaterial(this->dataPtr->restoreMaterial);
+
+    this->dataPtr->quad.reset(new Ogre::Rectangle2D(true));
+    this->dataPtr->quad->setCorners(-1, 1, 1, -1);
+  }
+
+  ShadowCacheKey key;
+  key.sceneManager = _sm;
+  key.light = _light;
+  key.lightDir = _light->getDerivedDirection();
+  key.view = texState.view;
+  key.proj = texState.proj;
+  key.mask = mask;
+  key.scheme = vp->getMaterialScheme();
+  key.width = shadowTex->getWidth();
+  key.height = shadowTex->getHeight();
+
+  ShadowCacheEntry *entry = nullptr;
+  for (auto &e : this->dataPtr->entries)
+  {
+    if (e.valid && e.key == key)
+    {
+      entry = &e;
+      break;
+    }
+  }
+
+  // Only cache the cascades that repeat, those of moving cameras would
+  // evict the others
+  if (this->dataPtr->lastKeys.size() > MaxLastKeys)
+    this->dataPtr->lastKeys.clear();
+  ShadowCacheKey &lastKey = this->dataPtr->lastKeys[{_cam, _iteration}];
+  const bool repeated = lastKey == key;
+  lastKey = key;
+
+  if (entry)
+  {
+    // Restore the colour and the depth of the shadow map
+    Ogre::Pass *pass =
+        this->dataPtr->restoreMaterial->getBestTechnique()->getPass(0);
+    pass->getTextureUnitState(0)->setTextureName(entry->texture->getName());
+    Ogre::RenderOperation op;
+    this->dataPtr->quad->getRenderOperation(op);
+    sm->manualRender(&op, pass, vp, Ogre::Matrix4::IDENTITY,
+        Ogre::Matrix4::IDENTITY, Ogre::Matrix4::IDENTITY, true);
+    ++this->dataPtr->hits;
+  }
+  else
+  {
+    if (!repeated)
+      return;
+
+    // Reuse a discarded entry, or the least recently used one
+    if (this->dataPtr->entries.size() < this->dataPtr->cacheSize)
+    {
+      this->dataPtr->entries.emplace_back();
+      entry = &this->dataPtr->entries.back();
+    }
+    else
+    {
+      for (auto &e : this->dataPtr->entries)
+      {
+        if (!entry || !e.valid ||
+            (entry->valid && e.lastUse < entry->lastUse))
+        {
+          entry = &e;
+        }
+      }
+    }
+
+    if (!entry->texture.isNull() &&
+        (entry->texture->getWidth() != key.width ||
+         entry->texture->getHeight() != key.height))
+    {
+      RemoveTexture(entry->texture);
+    }
+    if (entry->texture.isNull())
+    {
+      entry->texture = Ogre::TextureManager::getSingleton().createManual(
+          "__gazebo_shadow_cache_" +
+          std::to_string(this->dataPtr->textureCount++),
+          "General", Ogre::TEX_TYPE_2D, key.width, key.height, 0,
+          shadowTex->getFormat(), Ogre::TU_RENDERTARGET);
+    }
+
+    // Draw the static casters, those of the tracker that still exist are
+    // hidden
+    std::vector<Ogre::Entity *> hidden;
+    for (const auto &dynamic : tracker->second.dynamic)
+    {
+      if (sm->hasEntity(dynamic.first) &&
+          sm->getEntity(dynamic.first) == dynamic.second &&
+          dynamic.second->getVisible())
+      {
+        dynamic.second->setVisible(false);
+        hidden.push_back(dynamic.second);
+      }
+    }
+    vp->setBackgroundColour(Ogre::ColourValue::White);
+    vp->update();
+    for (auto &entity : hidden)
+      entity->setVisible(true);
+
+    entry->texture->getBuffer()->blit(shadowTex->getBuffer());
+    entry->key = key;
+    entry->valid = true;
+    entry->bounds = FrustumBounds(key.view, key.proj);
+    entry->casterBounds = sm->getVisibleObjectsBoundsInfo(_texCam).aabb;
+  }
+
+  entry->lastUse = ++this->dataPtr->useCount;
+
+  // The update of the shadow texture now only adds the dynamic casters
+  texState.overridden = true;
+  texState.mask = mask;
+  texState.staticBounds = entry->casterBounds;
+  vp->setClearEveryFrame(false);
+  vp->setVisibilityMask(GZ_VISIBILITY_SHADOW_DYNAMIC);
+}
+
+//////////////////////////////////////////////////
+void CustomPSSMShadowCameraSetup::SetStaticCacheSize(const unsigned int _size)
+{
+  this->InvalidateStaticCache();
+  this->dataPtr->cacheSize = _size;
+
+  while (this->dataPtr->entries.size() > _size)
+  {
+    RemoveTexture(this->dataPtr->entries.back().texture);
+    this->dataPtr->entries.pop_back();
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int CustomPSSMShadowCameraSetup::StaticCacheSize() const
+{
+  return this->dataPtr->cacheSize;
+}
+
+//////////////////////////////////////////////////
+void CustomPSSMShadowCameraSetup::UpdateCasters(Ogre::SceneManager *_sm)
+{
+  if (this->dataPtr->cacheSize == 0u || !_sm)
+    return;
+
+  ShadowCasterTracker &tracker = this->dataPtr->trackers[_sm];
+  ++tracker.update;
+  tracker.dynamic.clear();
+
+  // World bounds of the casters added to or removed from the static
+  // shadow maps
+  std::vector<Ogre::AxisAlignedBox> dirty;
+
+  Ogre::SceneManager::MovableObjectIterator it =
+      _sm->getMovableObjectIterator("Entity");
+  while (it.hasMoreElements())
+  {
+    Ogre::Entity *entity = static_cast<Ogre::Entity *>(it.getNext());
+    const uint32_t flags =
+        entity->getVisibilityFlags() & ~GZ_VISIBILITY_SHADOW_DYNAMIC;
+
+    const bool known = tracker.casters.count(entity) > 0;
+    ShadowCasterState &state = tracker.casters[entity];
+    state.update = tracker.update;
+
+    bool moved = false;
+    const Ogre::Node *node = entity->getParentNode();
+    if (node)
+    {
+      moved = known && (node->_getDerivedPosition() != state.position ||
+          node->_getDerivedOrientation() != state.orientation ||
+          node->_getDerivedScale() != state.scale);
+      state.position = node->_getDerivedPosition();
+      state.orientation = node->_getDerivedOrientation();
+      state.scale = node->_getDerivedScale();
+    }
+
+    // Casters that can't be dynamic stay in the static shadow maps, which
+    // are updated whenever they move
+    bool dynamic = false;
+    if (CanBeDynamic(flags))
+    {
+      if (moved || entity->hasSkeleton() || entity->hasVertexAnimation())
+      {
+        dynamic = true;
+        state.rest = 0u;
+      }
+      else if (state.dynamic)
+      {
+        dynamic = ++state.rest < RestUpdates;
+      }
+    }
+
+    const bool casting = entity->isAttached() && entity->getVisible() &&
+        entity->getCastShadows();
+    const bool isStatic = casting && !dynamic;
+    if (isStatic != state.isStatic || (isStatic && moved))
+    {
+      if (state.isStatic)
+        dirty.push_back(state.bounds);
+      if (isStatic)
+      {
+        state.bounds = entity->getWorldBoundingBox(true);
+        dirty.push_back(state.bounds);
+      }
+    }
+    state.isStatic = isStatic;
+    state.dynamic = dynamic;
+
+    // Dynamic casters are drawn over the static shadow maps with the
+    // GZ_VISIBILITY_SHADOW_DYNAMIC mask
+    if (dynamic)
+    {
+      const uint32_t dynamicFlags = flags | GZ_VISIBILITY_SHADOW_DYNAMIC;
+      if (entity->getVisibilityFlags() != dynamicFlags)
+        entity->setVisibilityFlags(dynamicFlags);
+      if (casting)
+        tracker.dynamic.emplace_back(entity->getName(), entity);
+    }
+    else if (entity->getVisibilityFlags() != flags)
+    {
+      entity->setVisibilityFlags(flags);
+    }
+  }
+
+  // Casters that were destroyed
+  for (auto iter = tracker.casters.begin(); iter != tracker.casters.end();)
+  {
+    if (iter->second.update != tracker.update)
+    {
+      if (iter->second.isStatic)
+        dirty.push_back(iter->second.bounds);
+      iter = tracker.casters.erase(iter);
+    }
+    else
+      ++iter;
+  }
+
+  if (dirty.empty())
+    return;
+
+  for (auto &entry : this->dataPtr->entries)
+  {
+    if (!entry.valid || entry.key.sceneManager != _sm)
+      continue;
+
+    if (dirty.size() > MaxDirtyBoxes)
+    {
+      entry.valid = false;
+      continue;
+    }
+
+    for (const auto &box : dirty)
+    {
+      if (entry.bounds.intersects(box))
+      {
+        entry.valid = false;
+        break;
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void CustomPSSMShadowCameraSetup::InvalidateStaticCache()
+{
+  for (auto &entry : this->dataPtr->entries)
+    entry.valid = false;
+  this->dataPtr->lastKeys.clear();
+  this->dataPtr->trackers.clear();
+}
+
+//////////////////////////////////////////////////
+uint64_t CustomPSSMShadowCameraSetup::StaticCacheHits() const
+{
+  return this->dataPtr->hits;
 }
 
 //////////////////////////////////////////////////
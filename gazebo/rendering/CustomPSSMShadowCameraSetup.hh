@@ -18,6 +18,10 @@
 #ifndef GAZEBO_RENDERING_CUSTOMPSSMSHADOWCAMERASETUP_HH_
 #define GAZEBO_RENDERING_CUSTOMPSSMSHADOWCAMERASETUP_HH_
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 #include "gazebo/rendering/ogre_gazebo.h"
 
 #include "gazebo/util/system.hh"
@@ -68,6 +72,9 @@ namespace gazebo
                   override;
     };
 
+    // Forward declare private data.
+    class CustomPSSMShadowCameraSetupPrivate;
+
     /// \brief Parallel Split Shadow Map (PSSM) shadow camera setup.
     /// Ogre's LiSPSM algorithm makes buggy shadow frusta that often put high
     /// resolution areas in the wrong places. To fix this we subclass a new
@@ -86,6 +93,16 @@ namespace gazebo
     /// functionality, th efollowing member functions will have no effect:
     /// setOptimalAdjustFactor(), setUseSimpleOptimalAdjust(),
     /// setCameraLightDirectionThreshold().
+    ///
+    /// Shadow maps of static casters can be cached, see
+    /// SetStaticCacheSize(). A cascade is cached once it repeats, i.e. once
+    /// the camera, the light and the casters in view stopped moving. It is
+    /// then restored instead of being drawn, and only the dynamic casters,
+    /// the entities that moved or are animated, are drawn over it. The
+    /// dynamic casters are found by UpdateCasters(), which also discards
+    /// the cascades touched by static casters that were added, removed or
+    /// started moving. Cascades are looked up by content, so cameras with
+    /// the same cascades share them.
     class GAZEBO_VISIBLE CustomPSSMShadowCameraSetup
           : public Ogre::PSSMShadowCameraSetup
     {
@@ -122,6 +139,56 @@ namespace gazebo
           const Ogre::Camera *_cam, const Ogre::Viewport *_vp,
           const Ogre::Light *_light, Ogre::Camera *_texCam, size_t _iteration)
           const override;
+
+      /// \brief Set the number of shadow maps of static casters that are
+      /// cached. Each one uses the memory of a shadow texture, and three are
+      /// needed per camera that doesn't move.
+      /// \param[in] _size Number of cached shadow maps, 0 to disable the
+      /// cache, which is the default.
+      public: void SetStaticCacheSize(const unsigned int _size);
+
+      /// \brief Get the number of shadow maps of static casters that are
+      /// cached.
+      /// \return Number of cached shadow maps, 0 if disabled.
+      public: unsigned int StaticCacheSize() const;
+
+      /// \brief Find the shadow casters of a scene that moved. Must be
+      /// called once per frame, after the poses of the frame were applied,
+      /// while the cache is enabled. Only entities are tracked, other
+      /// objects are considered static, call InvalidateStaticCache() if they
+      /// change.
+      /// \param[in] _sm Scene manager of the scene.
+      public: void UpdateCasters(Ogre::SceneManager *_sm);
+
+      /// \brief Discard the cached shadow maps.
+      public: void InvalidateStaticCache();
+
+      /// \brief Get the number of shadow maps restored from the cache so
+      /// far.
+      /// \return Number of cache hits.
+      public: uint64_t StaticCacheHits() const;
+
+      /// \brief Set the custom matrices of a shadow camera.
+      /// \param[in] _texCam Shadow camera.
+      /// \param[in] _view View matrix.
+      /// \param[in] _proj Projection matrix.
+      private: void SetShadowCameraMatrices(Ogre::Camera *_texCam,
+          const Ogre::Matrix4 &_view, const Ogre::Matrix4 &_proj) const;
+
+      /// \brief Restore a shadow map from the cache, or cache it, and make
+      /// the following update of its texture only draw dynamic casters.
+      /// \param[in] _sm Scene manager.
+      /// \param[in] _cam Viewing camera.
+      /// \param[in] _light Light casting the shadows.
+      /// \param[in] _texCam Shadow camera, already set up.
+      /// \param[in] _iteration Index of the cascade.
+      private: void UpdateStaticCache(const Ogre::SceneManager *_sm,
+          const Ogre::Camera *_cam, const Ogre::Light *_light,
+          Ogre::Camera *_texCam, const size_t _iteration) const;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<CustomPSSMShadowCameraSetupPrivate> dataPtr;
     };
 
     /// \brief This overrides ogre's default GLSLProgramWriter to fix
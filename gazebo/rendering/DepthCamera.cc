@@ -15,6 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 #ifndef _WIN32
   #include <dirent.h>
 #else
@@ -261,37 +265,22 @@ void DepthCamera::CreateDepthTexture(const std::string &_textureName)
 
   if (this->dataPtr->outputPoints)
   {
-    this->dataPtr->pcdTexture =
-        Ogre::TextureManager::getSingleton().createManual(
-        _textureName + "_pcd",
-        "General",
-        Ogre::TEX_TYPE_2D,
-        this->ImageWidth(), this->ImageHeight(), 0,
-        Ogre::PF_FLOAT32_RGBA,
-        Ogre::TU_RENDERTARGET).getPointer();
-
-    this->dataPtr->pcdTarget =
-        this->dataPtr->pcdTexture->getBuffer()->getRenderTarget();
-    this->dataPtr->pcdTarget->setAutoUpdated(false);
-
-    this->dataPtr->pcdViewport =
-        this->dataPtr->pcdTarget->addViewport(this->camera);
-    this->dataPtr->pcdViewport->setClearEveryFrame(true);
-
-    auto const &ignBG = this->scene->BackgroundColor();
-    this->dataPtr->pcdViewport->setBackgroundColour(
-        Conversions::Convert(ignBG));
-    this->dataPtr->pcdViewport->setOverlaysEnabled(false);
-    this->dataPtr->pcdViewport->setVisibilityMask(
-        GZ_VISIBILITY_ALL & ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE));
-
-    this->dataPtr->pcdMaterial = (Ogre::Material*)(
-    Ogre::MaterialManager::getSingleton().getByName("Gazebo/XYZPoints").get());
-
-    this->dataPtr->pcdMaterial->getTechnique(0)->getPass(0)->
-        createTextureUnitState(this->renderTexture->getName());
-
+    // Each camera samples its own image to color the points
+    std::string pcdMaterialName = "Gazebo/" + this->Name() + "_XYZPoints";
+    Ogre::MaterialPtr pcdMaterial =
+        Ogre::MaterialManager::getSingleton().getByName(pcdMaterialName);
+    if (pcdMaterial.isNull())
+    {
+      pcdMaterial = Ogre::MaterialManager::getSingleton().getByName(
+          "Gazebo/XYZPoints")->clone(pcdMaterialName);
+      pcdMaterial->getTechnique(0)->getPass(0)->
+          createTextureUnitState(this->renderTexture->getName());
+    }
+    this->dataPtr->pcdMaterial = pcdMaterial.get();
     this->dataPtr->pcdMaterial->load();
+
+    this->dataPtr->pcdTextureName = _textureName + "_pcd";
+    this->CreatePointCloudTexture();
   }
 
 /*
@@ -391,6 +380,76 @@ void DepthCamera::CreateNormalsTexture(const std::string &_textureName)
   }
 }
 
+//////////////////////////////////////////////////
+void DepthCamera::CreatePointCloudTexture()
+{
+  if (this->dataPtr->pcdTarget)
+    this->dataPtr->pcdTarget->removeAllViewports();
+  this->dataPtr->pcdTarget = nullptr;
+  this->dataPtr->pcdViewport = nullptr;
+
+  if (this->dataPtr->pcdTexture)
+  {
+    Ogre::TextureManager::getSingleton().remove(
+        this->dataPtr->pcdTexture->getName());
+  }
+
+  delete [] this->dataPtr->pcdBuffer;
+  this->dataPtr->pcdBuffer = nullptr;
+
+  // Decimation happens on the GPU, which renders fewer points
+  const unsigned int decimation = this->dataPtr->pcdDecimation;
+  this->dataPtr->pcdTextureDecimation = decimation;
+  this->dataPtr->pcdTexture =
+      Ogre::TextureManager::getSingleton().createManual(
+      this->dataPtr->pcdTextureName,
+      "General",
+      Ogre::TEX_TYPE_2D,
+      std::max(1u, this->ImageWidth() / decimation),
+      std::max(1u, this->ImageHeight() / decimation), 0,
+      Ogre::PF_FLOAT32_RGBA,
+      Ogre::TU_RENDERTARGET).getPointer();
+
+  this->dataPtr->pcdTarget =
+      this->dataPtr->pcdTexture->getBuffer()->getRenderTarget();
+  this->dataPtr->pcdTarget->setAutoUpdated(false);
+
+  this->dataPtr->pcdViewport =
+      this->dataPtr->pcdTarget->addViewport(this->camera);
+  this->dataPtr->pcdViewport->setClearEveryFrame(true);
+
+  auto const &ignBG = this->scene->BackgroundColor();
+  this->dataPtr->pcdViewport->setBackgroundColour(
+      Conversions::Convert(ignBG));
+  this->dataPtr->pcdViewport->setOverlaysEnabled(false);
+  this->dataPtr->pcdViewport->setVisibilityMask(
+      GZ_VISIBILITY_ALL & ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE));
+}
+
+//////////////////////////////////////////////////
+void DepthCamera::SetPointCloudDecimation(const unsigned int _decimation)
+{
+  this->dataPtr->pcdDecimation = std::max(1u, _decimation);
+}
+
+//////////////////////////////////////////////////
+unsigned int DepthCamera::PointCloudDecimation() const
+{
+  return this->dataPtr->pcdDecimation;
+}
+
+//////////////////////////////////////////////////
+void DepthCamera::SetPointCloudMaxRange(const double _range)
+{
+  this->dataPtr->pcdMaxRange = std::max(0.0, _range);
+}
+
+//////////////////////////////////////////////////
+double DepthCamera::PointCloudMaxRange() const
+{
+  return this->dataPtr->pcdMaxRange;
+}
+
 //////////////////////////////////////////////////
 void DepthCamera::PostRender()
 {
@@ -437,23 +496,32 @@ void DepthCamera::PostRender()
 
       // Get access to the buffer and make an image and write it to file
       pcdPixelBuffer = this->dataPtr->pcdTexture->getBuffer();
+      const unsigned int pcdWidth = pcdPixelBuffer->getWidth();
+      const unsigned int pcdHeight = pcdPixelBuffer->getHeight();
 
-      // Blit the depth buffer if needed
+      // Blit the point cloud buffer, every point of which is rendered
       if (!this->dataPtr->pcdBuffer)
-        this->dataPtr->pcdBuffer = new float[width * height * 4];
+        this->dataPtr->pcdBuffer = new float[pcdWidth * pcdHeight * 4];
 
-      memset(this->dataPtr->pcdBuffer, 0, width * height * 4);
-
-      Ogre::Box pcd_src_box(0, 0, width, height);
-      Ogre::PixelBox pcd_dst_box(width, height,
+      Ogre::Box pcd_src_box(0, 0, pcdWidth, pcdHeight);
+      Ogre::PixelBox pcd_dst_box(pcdWidth, pcdHeight,
           1, Ogre::PF_FLOAT32_RGBA, this->dataPtr->pcdBuffer);
 
       pcdPixelBuffer->lock(Ogre::HardwarePixelBuffer::HBL_NORMAL);
       pcdPixelBuffer->blitToMemory(pcd_src_box, pcd_dst_box);
       pcdPixelBuffer->unlock();
 
+      // The shader writes colors as integer values, store their bits in
+      // the float like sensor_msgs/PointCloud2 does
+      float *rgb = this->dataPtr->pcdBuffer + 3;
+      for (unsigned int i = 0; i < pcdWidth * pcdHeight; ++i, rgb += 4)
+      {
+        const uint32_t packed = static_cast<uint32_t>(*rgb);
+        std::memcpy(rgb, &packed, sizeof(packed));
+      }
+
       this->dataPtr->newRGBPointCloud(
-          this->dataPtr->pcdBuffer, width, height, 1, "RGBPOINTS");
+          this->dataPtr->pcdBuffer, pcdWidth, pcdHeight, 1, "RGBPOINTS");
     }
 
     if (this->dataPtr->outputReflectance)
@@ -621,6 +689,13 @@ void DepthCamera::RenderImpl()
 
   if (this->dataPtr->outputPoints)
   {
+    // Apply the point cloud settings here, in the rendering thread
+    if (this->dataPtr->pcdTextureDecimation != this->dataPtr->pcdDecimation)
+      this->CreatePointCloudTexture();
+    this->dataPtr->pcdMaterial->getTechnique(0)->getPass(0)->
+        getFragmentProgramParameters()->setNamedConstant("maxRange",
+        static_cast<Ogre::Real>(this->dataPtr->pcdMaxRange));
+
     sceneMgr->setShadowTechnique(Ogre::SHADOWTYPE_NONE);
     sceneMgr->_suppressRenderStateChanges(true);
 
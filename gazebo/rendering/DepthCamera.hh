@@ -103,13 +103,41 @@ namespace gazebo
           std::function<void (const float *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber);
 
-      /// \brief Connect a to the new rgb point cloud signal
+      /// \brief Connect a to the new rgb point cloud signal. The point
+      /// cloud is organized, each point has four floats laid out like the
+      /// x, y, z and rgb fields of a sensor_msgs/PointCloud2: a position in
+      /// the camera frame followed by the color of the point, whose bits
+      /// hold the 0x00RRGGBB integer.
       /// \param[in] _subscriber Subscriber callback function
       /// \return Pointer to the new Connection. This must be kept in scope
       public: event::ConnectionPtr ConnectNewRGBPointCloud(
           std::function<void (const float *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber);
 
+      /// \brief Set the decimation of the point cloud, which is rendered
+      /// at the image size divided by the decimation. The point cloud stays
+      /// organized, with one point per rendered pixel. It takes effect at
+      /// the next render.
+      /// \param[in] _decimation Decimation, 1 for a point per image pixel.
+      public: void SetPointCloudDecimation(const unsigned int _decimation);
+
+      /// \brief Get the decimation of the point cloud.
+      /// \return Decimation, 1 for a point per image pixel.
+      /// \sa SetPointCloudDecimation
+      public: unsigned int PointCloudDecimation() const;
+
+      /// \brief Set the range beyond which points are dropped while the
+      /// point cloud is rendered. Dropped points are left like the points
+      /// that see no object, at the far clip distance. It takes effect at
+      /// the next render.
+      /// \param[in] _range Range in meters, 0 to only use the far clip.
+      public: void SetPointCloudMaxRange(const double _range);
+
+      /// \brief Get the range beyond which points are dropped.
+      /// \return Range in meters, 0 if only the far clip is used.
+      /// \sa SetPointCloudMaxRange
+      public: double PointCloudMaxRange() const;
+
       /// \brief Connect a to the new reflectance data
       /// \param[in] _subscriber Subscriber callback function
       /// \return Pointer to the new Connection. This must be kept in scope
@@ -130,6 +158,10 @@ namespace gazebo
       /// \brief Implementation of the render call
       private: virtual void RenderImpl();
 
+      /// \brief Create the texture the point cloud is rendered to, with the
+      /// size given by the decimation.
+      private: void CreatePointCloudTexture();
+
       /// \brief Update a render target
       /// \param[in] _target Render target to update
       /// \param[in] _material Material to use
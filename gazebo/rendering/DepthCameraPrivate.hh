@@ -18,6 +18,7 @@
 #ifndef _GAZEBO_RENDERING_DEPTHCAMERA_PRIVATE_HH_
 #define _GAZEBO_RENDERING_DEPTHCAMERA_PRIVATE_HH_
 
+#include <atomic>
 #include <string>
 
 #include "gazebo/common/Event.hh"
@@ -72,6 +73,20 @@ namespace gazebo
       /// \brief Point cloud data buffer
       public: float *pcdBuffer = nullptr;
 
+      /// \brief Point cloud decimation, the image size is divided by it.
+      /// It is applied by the next render.
+      public: std::atomic<unsigned int> pcdDecimation{1};
+
+      /// \brief Decimation of the point cloud texture.
+      public: unsigned int pcdTextureDecimation = 1;
+
+      /// \brief Range beyond which points are dropped, 0 to keep them.
+      /// It is applied by the next render.
+      public: std::atomic<double> pcdMaxRange{0};
+
+      /// \brief Name of the point cloud texture.
+      public: std::string pcdTextureName;
+
       /// \brief reflectance data buffer
       public: float *reflectanceBuffer = nullptr;
 
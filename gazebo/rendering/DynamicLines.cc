@@ -36,6 +36,9 @@ class gazebo::rendering::DynamicLinesPrivate
 {
   /// \brief list of colors at each point
   public: std::vector<ignition::math::Color> colors;
+
+  /// \brief True if the colors changed since they were last uploaded
+  public: bool colorsDirty = true;
 };
 
 /////////////////////////////////////////////////
@@ -71,6 +74,7 @@ void DynamicLines::AddPoint(const ignition::math::Vector3d &_pt,
 {
   this->points.push_back(_pt);
   this->dataPtr->colors.push_back(_color);
+  this->dataPtr->colorsDirty = true;
   this->dirty = true;
 }
 
@@ -102,6 +106,7 @@ void DynamicLines::SetColor(const unsigned int _index,
                             const ignition::math::Color &_color)
 {
   this->dataPtr->colors[_index] = _color;
+  this->dataPtr->colorsDirty = true;
   this->dirty = true;
 }
 
@@ -132,13 +137,27 @@ unsigned int DynamicLines::GetPointCount() const
 void DynamicLines::Clear()
 {
   this->points.clear();
+  this->dataPtr->colors.clear();
+  this->dataPtr->colorsDirty = true;
+  this->dirty = true;
+}
+
+/////////////////////////////////////////////////
+void DynamicLines::Truncate(const unsigned int _count)
+{
+  if (_count >= this->points.size())
+    return;
+
+  this->points.resize(_count);
+  this->dataPtr->colors.resize(_count);
+  this->dataPtr->colorsDirty = true;
   this->dirty = true;
 }
 
 /////////////////////////////////////////////////
 void DynamicLines::Update()
 {
-  if (this->dirty && this->points.size() > 1)
+  if (this->dirty)
     this->FillHardwareBuffers();
 }
 
@@ -156,20 +175,31 @@ void DynamicLines::CreateVertexDeclaration()
 void DynamicLines::FillHardwareBuffers()
 {
   int size = this->points.size();
+  const size_t capacity = this->vertexBufferCapacity;
   this->PrepareHardwareBuffers(size, 0);
 
+  // Colors are kept by new buffers only once they're uploaded
+  if (this->vertexBufferCapacity != capacity)
+    this->dataPtr->colorsDirty = true;
+
   if (!size)
   {
     this->mBox.setExtents(Ogre::Vector3::ZERO, Ogre::Vector3::ZERO);
     this->dirty = false;
+    if (this->getParentSceneNode())
+      this->getParentSceneNode()->needUpdate();
+    return;
   }
 
   Ogre::HardwareVertexBufferSharedPtr vbuf =
     this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
 
+  // The whole buffer is rewritten, so let the driver discard the previous
+  // content instead of waiting for the frames which still use it.
   Ogre::Real *prPos =
-    static_cast<Ogre::Real*>(vbuf->lock(Ogre::HardwareBuffer::HBL_NORMAL));
+    static_cast<Ogre::Real*>(vbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
   {
+    this->mBox.setNull();
     for (int i = 0; i < size; i++)
     {
       *prPos++ = this->points[i].X();
@@ -182,23 +212,28 @@ void DynamicLines::FillHardwareBuffers()
   vbuf->unlock();
 
   // Update the colors
-  Ogre::HardwareVertexBufferSharedPtr cbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
+  if (this->dataPtr->colorsDirty)
+  {
+    Ogre::HardwareVertexBufferSharedPtr cbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
 
-  Ogre::RGBA *colorArrayBuffer =
+    Ogre::RGBA *colorArrayBuffer =
         static_cast<Ogre::RGBA*>(cbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-  Ogre::RenderSystem *renderSystemForVertex =
+    Ogre::RenderSystem *renderSystemForVertex =
         Ogre::Root::getSingleton().getRenderSystem();
-  for (int i = 0; i < size; ++i)
-  {
-    Ogre::ColourValue color = Conversions::Convert(this->dataPtr->colors[i]);
-    renderSystemForVertex->convertColourValue(color, &colorArrayBuffer[i]);
+    for (int i = 0; i < size; ++i)
+    {
+      Ogre::ColourValue color = Conversions::Convert(this->dataPtr->colors[i]);
+      renderSystemForVertex->convertColourValue(color, &colorArrayBuffer[i]);
+    }
+    cbuf->unlock();
+    this->dataPtr->colorsDirty = false;
   }
-  cbuf->unlock();
 
   // need to update after mBox change, otherwise the lines goes in and out
   // of scope based on old mBox
-  this->getParentSceneNode()->needUpdate();
+  if (this->getParentSceneNode())
+    this->getParentSceneNode()->needUpdate();
 
   this->dirty = false;
 }
@@ -99,6 +99,11 @@ namespace gazebo
       /// \brief Remove all points from the point list
       public: void Clear();
 
+      /// \brief Remove the points at the end of the point list, keeping the
+      /// others in place.
+      /// \param[in] _count Number of points to keep.
+      public: void Truncate(const unsigned int _count);
+
       /// \brief Call this to update the hardware buffer after making changes.
       public: void Update();
 
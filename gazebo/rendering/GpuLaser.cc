@@ -56,12 +56,15 @@ GpuLaser::GpuLaser(const std::string &_namePrefix, ScenePtr _scene,
   dataPtr(new GpuLaserPrivate)
 {
   this->dataPtr->laserBuffer = NULL;
-  this->dataPtr->laserScan = NULL;
   this->dataPtr->matFirstPass = NULL;
   this->dataPtr->matSecondPass = NULL;
+  this->dataPtr->firstPassTexture = NULL;
+  this->dataPtr->firstPassTarget = NULL;
   for (int i = 0; i < 3; ++i)
-    this->dataPtr->firstPassTextures[i] = NULL;
+    this->dataPtr->firstPassViewports[i] = NULL;
   this->dataPtr->secondPassTexture = NULL;
+  this->dataPtr->currentViewport = NULL;
+  this->dataPtr->channels = 3;
   this->dataPtr->orthoCam = NULL;
   this->dataPtr->w2nd = 0;
   this->dataPtr->h2nd = 0;
@@ -99,14 +102,12 @@ void GpuLaser::Init()
 //////////////////////////////////////////////////
 void GpuLaser::Fini()
 {
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  if (this->dataPtr->firstPassTexture)
   {
-    if (this->dataPtr->firstPassTextures[i])
-    {
-      Ogre::TextureManager::getSingleton().remove(
-          this->dataPtr->firstPassTextures[i]->getName());
-      this->dataPtr->firstPassTextures[i] = nullptr;
-    }
+    Ogre::TextureManager::getSingleton().remove(
+        this->dataPtr->firstPassTexture->getName());
+    this->dataPtr->firstPassTexture = nullptr;
+    this->dataPtr->firstPassTarget = nullptr;
   }
   if (this->dataPtr->secondPassTexture)
   {
@@ -127,8 +128,6 @@ void GpuLaser::Fini()
 
   delete [] this->dataPtr->laserBuffer;
   this->dataPtr->laserBuffer = nullptr;
-  delete [] this->dataPtr->laserScan;
-  this->dataPtr->laserScan = nullptr;
 
   Camera::Fini();
 }
@@ -157,21 +156,21 @@ void GpuLaser::CreateLaserTexture(const std::string &_textureName)
     this->dataPtr->cameraYaws[3] = -this->hfov;
   }
 
+  // All the views of the first pass are rendered side by side into a
+  // single texture, so the second pass samples one texture unit and the
+  // views share one render target.
+  this->dataPtr->firstPassTexture =
+    Ogre::TextureManager::getSingleton().createManual(
+    _textureName + "first_pass", "General", Ogre::TEX_TYPE_2D,
+    this->ImageWidth() * this->dataPtr->textureCount, this->ImageHeight(), 0,
+    Ogre::PF_FLOAT32_RGB, Ogre::TU_RENDERTARGET).getPointer();
+
   for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
   {
-    std::stringstream texName;
-    texName << _textureName << "first_pass_" << i;
-    this->dataPtr->firstPassTextures[i] =
-      Ogre::TextureManager::getSingleton().createManual(
-      texName.str(), "General", Ogre::TEX_TYPE_2D,
-      this->ImageWidth(), this->ImageHeight(), 0,
-      Ogre::PF_FLOAT32_RGB, Ogre::TU_RENDERTARGET).getPointer();
-
     this->Set1stPassTarget(
-        this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget(), i);
-
-    this->dataPtr->firstPassTargets[i]->setAutoUpdated(false);
+        this->dataPtr->firstPassTexture->getBuffer()->getRenderTarget(), i);
   }
+  this->dataPtr->firstPassTarget->setAutoUpdated(false);
 
   this->dataPtr->matFirstPass = (Ogre::Material*)(
   Ogre::MaterialManager::getSingleton().getByName("Gazebo/LaserScan1st").get());
@@ -179,13 +178,24 @@ void GpuLaser::CreateLaserTexture(const std::string &_textureName)
   this->dataPtr->matFirstPass->load();
   this->dataPtr->matFirstPass->setCullingMode(Ogre::CULL_NONE);
 
+  // Only range and intensity are needed from the second pass, so keep them
+  // in a two channel texture when the render system can render to one.
+  Ogre::PixelFormat secondPassFormat = Ogre::PF_FLOAT32_GR;
+  if (!Ogre::TextureManager::getSingleton().isFormatSupported(
+      Ogre::TEX_TYPE_2D, secondPassFormat, Ogre::TU_RENDERTARGET))
+  {
+    secondPassFormat = Ogre::PF_FLOAT32_RGB;
+  }
+  this->dataPtr->channels =
+      Ogre::PixelUtil::getComponentCount(secondPassFormat);
+
   this->dataPtr->secondPassTexture =
       Ogre::TextureManager::getSingleton().createManual(
       _textureName + "second_pass",
       "General",
       Ogre::TEX_TYPE_2D,
       this->dataPtr->w2nd, this->dataPtr->h2nd, 0,
-      Ogre::PF_FLOAT32_RGB,
+      secondPassFormat,
       Ogre::TU_RENDERTARGET).getPointer();
 
   this->Set2ndPassTarget(
@@ -198,27 +208,22 @@ void GpuLaser::CreateLaserTexture(const std::string &_textureName)
 
   this->dataPtr->matSecondPass->load();
 
-  Ogre::TextureUnitState *texUnit;
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
-  {
-    unsigned int texIndex = this->dataPtr->texCount++;
-    Ogre::Technique *technique = this->dataPtr->matSecondPass->getTechnique(0);
-    GZ_ASSERT(technique, "GpuLaser material script error: technique not found");
+  Ogre::Technique *technique = this->dataPtr->matSecondPass->getTechnique(0);
+  GZ_ASSERT(technique, "GpuLaser material script error: technique not found");
 
-    Ogre::Pass *pass = technique->getPass(0);
-    GZ_ASSERT(pass, "GpuLaser material script error: pass not found");
+  Ogre::Pass *pass = technique->getPass(0);
+  GZ_ASSERT(pass, "GpuLaser material script error: pass not found");
 
-    if (!pass->getTextureUnitState(
-        this->dataPtr->firstPassTextures[i]->getName()))
-    {
-      texUnit = pass->createTextureUnitState(
-            this->dataPtr->firstPassTextures[i]->getName(), texIndex);
+  if (!pass->getTextureUnitState(this->dataPtr->firstPassTexture->getName()))
+  {
+    unsigned int texIndex = this->dataPtr->texCount++;
+    Ogre::TextureUnitState *texUnit = pass->createTextureUnitState(
+          this->dataPtr->firstPassTexture->getName(), texIndex);
 
-      this->dataPtr->texIdx.push_back(texIndex);
+    this->dataPtr->texIdx.push_back(texIndex);
 
-      texUnit->setTextureFiltering(Ogre::TFO_NONE);
-      texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_MIRROR);
-    }
+    texUnit->setTextureFiltering(Ogre::TFO_NONE);
+    texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
   }
 
   this->CreateCanvas();
@@ -227,10 +232,7 @@ void GpuLaser::CreateLaserTexture(const std::string &_textureName)
 //////////////////////////////////////////////////
 void GpuLaser::PostRender()
 {
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
-  {
-    this->dataPtr->firstPassTargets[i]->swapBuffers();
-  }
+  this->dataPtr->firstPassTarget->swapBuffers();
   this->dataPtr->secondPassTarget->swapBuffers();
 
   if (this->newData && this->captureData)
@@ -243,32 +245,22 @@ void GpuLaser::PostRender()
     // Get access to the buffer and make an image and write it to file
     pixelBuffer = this->dataPtr->secondPassTexture->getBuffer();
 
-    size_t size = Ogre::PixelUtil::getMemorySize(
-                    width, height, 1, Ogre::PF_FLOAT32_RGB);
-
-    // Blit the depth buffer if needed
+    // The blit overwrites the whole buffer, and the buffer is read directly
+    // by the data iterators and the new laser frame subscribers.
     if (!this->dataPtr->laserBuffer)
-      this->dataPtr->laserBuffer = new float[size];
-
-    memset(this->dataPtr->laserBuffer, 255, size);
-
-    Ogre::PixelBox dstBox(width, height,
-        1, Ogre::PF_FLOAT32_RGB, this->dataPtr->laserBuffer);
-
-    pixelBuffer->blitToMemory(dstBox);
-
-    if (!this->dataPtr->laserScan)
     {
-      int len = this->dataPtr->w2nd * this->dataPtr->h2nd * 3;
-      this->dataPtr->laserScan = new float[len];
+      this->dataPtr->laserBuffer =
+          new float[width * height * this->dataPtr->channels];
     }
 
-    memcpy(this->dataPtr->laserScan, this->dataPtr->laserBuffer,
-           this->dataPtr->w2nd * this->dataPtr->h2nd * 3 *
-           sizeof(this->dataPtr->laserScan[0]));
+    Ogre::PixelBox dstBox(width, height, 1, pixelBuffer->getFormat(),
+        this->dataPtr->laserBuffer);
+
+    pixelBuffer->blitToMemory(dstBox);
 
-    this->dataPtr->newLaserFrame(this->dataPtr->laserScan, this->dataPtr->w2nd,
-        this->dataPtr->h2nd, 3, "BLABLA");
+    this->dataPtr->newLaserFrame(this->dataPtr->laserBuffer,
+        this->dataPtr->w2nd, this->dataPtr->h2nd, this->dataPtr->channels,
+        "BLABLA");
   }
 
   this->newData = false;
@@ -320,14 +312,6 @@ void GpuLaser::UpdateRenderTarget(Ogre::RenderTarget *_target,
   {
     pass->getFragmentProgramParameters()->setNamedConstant("tex1",
       this->dataPtr->texIdx[0]);
-    if (this->dataPtr->texIdx.size() > 1)
-    {
-      pass->getFragmentProgramParameters()->setNamedConstant("tex2",
-        this->dataPtr->texIdx[1]);
-      if (this->dataPtr->texIdx.size() > 2)
-        pass->getFragmentProgramParameters()->setNamedConstant("tex3",
-          this->dataPtr->texIdx[2]);
-    }
   }
 
   // NOTE: We MUST bind parameters AFTER updating the autos
@@ -381,13 +365,13 @@ void GpuLaser::notifyRenderSingleObject(Ogre::Renderable *_rend,
 
   Ogre::AutoParamDataSource autoParamDataSource;
 
-  Ogre::Viewport *vp = this->dataPtr->currentTarget->getViewport(0);
+  Ogre::Viewport *vp = this->dataPtr->currentViewport;
 
   renderSys->_setViewport(vp);
   autoParamDataSource.setCurrentRenderable(_rend);
   autoParamDataSource.setCurrentPass(pass);
   autoParamDataSource.setCurrentViewport(vp);
-  autoParamDataSource.setCurrentRenderTarget(this->dataPtr->currentTarget);
+  autoParamDataSource.setCurrentRenderTarget(vp->getTarget());
   autoParamDataSource.setCurrentSceneManager(this->scene->OgreSceneManager());
   autoParamDataSource.setCurrentCamera(this->camera, true);
 
@@ -421,6 +405,10 @@ void GpuLaser::RenderImpl()
   sceneMgr->_suppressRenderStateChanges(true);
   sceneMgr->addRenderObjectListener(this);
 
+  // Render every view into its own viewport of the shared first pass
+  // target, so the target is bound and swapped only once per scan.
+  this->dataPtr->currentMat = this->dataPtr->matFirstPass;
+  this->dataPtr->firstPassTarget->_beginUpdate();
   for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
   {
     if (this->dataPtr->textureCount > 1)
@@ -430,13 +418,13 @@ void GpuLaser::RenderImpl()
       this->sceneNode->roll(Ogre::Radian(this->dataPtr->cameraYaws[i]));
     }
 
-    this->dataPtr->currentMat = this->dataPtr->matFirstPass;
-    this->dataPtr->currentTarget = this->dataPtr->firstPassTargets[i];
+    this->dataPtr->currentViewport = this->dataPtr->firstPassViewports[i];
 
-    this->UpdateRenderTarget(this->dataPtr->firstPassTargets[i],
+    this->UpdateRenderTarget(this->dataPtr->firstPassTarget,
                   this->dataPtr->matFirstPass, this->camera);
-    this->dataPtr->firstPassTargets[i]->update(false);
+    this->dataPtr->firstPassTarget->_updateViewport(i, false);
   }
+  this->dataPtr->firstPassTarget->_endUpdate();
 
   if (this->dataPtr->textureCount > 1)
       this->sceneNode->roll(Ogre::Radian(this->dataPtr->cameraYaws[3]));
@@ -464,8 +452,8 @@ void GpuLaser::RenderImpl()
 GpuLaser::DataIter GpuLaser::LaserDataBegin() const
 {
   const unsigned int index = 0;
-  // Data stuffed into three floats (RGB)
-  const unsigned int skip = 3;
+  // Data stuffed into two (range, intensity) or three (RGB) floats
+  const unsigned int skip = this->dataPtr->channels;
   // range data in R channel
   const unsigned int rangeOffset = 0;
   // intensity data in G channel
@@ -479,8 +467,8 @@ GpuLaser::DataIter GpuLaser::LaserDataEnd() const
 {
   const unsigned int index = this->dataPtr->h2nd * this->dataPtr->w2nd;
 
-  // Data stuffed into three floats (RGB)
-  const unsigned int skip = 3;
+  // Data stuffed into two (range, intensity) or three (RGB) floats
+  const unsigned int skip = this->dataPtr->channels;
   // range data in R channel
   const unsigned int rangeOffset = 0;
   // intensity data in G channel
@@ -489,6 +477,18 @@ GpuLaser::DataIter GpuLaser::LaserDataEnd() const
       intenOffset, this->dataPtr->w2nd);
 }
 
+//////////////////////////////////////////////////
+const float *GpuLaser::LaserBuffer() const
+{
+  return this->dataPtr->laserBuffer;
+}
+
+//////////////////////////////////////////////////
+unsigned int GpuLaser::LaserChannelCount() const
+{
+  return this->dataPtr->channels;
+}
+
 /////////////////////////////////////////////////
 void GpuLaser::CreateOrthoCam()
 {
@@ -544,13 +544,15 @@ Ogre::Matrix4 GpuLaser::BuildScaledOrthoMatrix(const float _left,
 void GpuLaser::Set1stPassTarget(Ogre::RenderTarget *_target,
                                 const unsigned int _index)
 {
-  this->dataPtr->firstPassTargets[_index] = _target;
+  this->dataPtr->firstPassTarget = _target;
 
-  if (this->dataPtr->firstPassTargets[_index])
+  if (this->dataPtr->firstPassTarget)
   {
-    // Setup the viewport to use the texture
+    // Setup the viewport to use its part of the texture
+    const float width = 1.0f / this->dataPtr->textureCount;
     this->dataPtr->firstPassViewports[_index] =
-      this->dataPtr->firstPassTargets[_index]->addViewport(this->camera);
+      this->dataPtr->firstPassTarget->addViewport(this->camera, _index,
+      _index * width, 0.0f, width, 1.0f);
     this->dataPtr->firstPassViewports[_index]->setClearEveryFrame(true);
     this->dataPtr->firstPassViewports[_index]->setOverlaysEnabled(false);
     this->dataPtr->firstPassViewports[_index]->setShadowsEnabled(false);
@@ -688,10 +690,9 @@ void GpuLaser::CreateMesh()
       }
       ptsOnLine++;
 
-      // the texture/1000.0 value is used in the laser_2nd_pass.frag shader
-      // as a trick to determine which camera texture to use when stitching
-      // together the final depth image.
-      submesh->AddVertex(texture/1000.0, startX, startY);
+      // the view that contains the depth value is selected through the
+      // texture coordinates below.
+      submesh->AddVertex(0, startX, startY);
 
       // first compute angle from the start of current camera's horizontal
       // min angle, then set delta to be angle from center of current camera.
@@ -704,6 +705,12 @@ void GpuLaser::CreateMesh()
       double v = 0.5 - (tan(gamma) * cos(theta)) /
           (2.0 * tan(phiCamera) * cos(delta));
 
+      // the views are side by side in the first pass texture, keep u
+      // inside the view so the neighbouring view isn't sampled
+      double halfTexel = 0.5 / this->ImageWidth();
+      u = ignition::math::clamp(u, halfTexel, 1.0 - halfTexel);
+      u = (texture + u) / this->dataPtr->textureCount;
+
       submesh->AddTexCoord(u, v);
       submesh->AddIndex(this->dataPtr->w2nd * j + i);
     }
@@ -96,6 +96,16 @@ namespace gazebo
       /// \brief Return an iterator to one past the end of the laser data
       public: DataIter LaserDataEnd() const;
 
+      /// \brief Get the laser data of the last frame read back, row by row,
+      /// with LaserChannelCount floats per ray: the range, then the
+      /// intensity. Faster than the iterators to copy a whole frame.
+      /// \return The data, null before the first frame.
+      public: const float *LaserBuffer() const;
+
+      /// \brief Get the number of floats per ray in LaserBuffer.
+      /// \return 2 or 3, depending on the render system.
+      public: unsigned int LaserChannelCount() const;
+
       /// \brief Connect to a laser frame signal
       /// \param[in] _subscriber Callback that is called when a new image is
       /// generated
@@ -59,11 +59,13 @@ namespace gazebo
                    unsigned int _height, unsigned int _depth,
                    const std::string &_format)> newLaserFrame;
 
-      /// \brief Raw buffer of laser data.
+      /// \brief Raw buffer of laser data, also used by newLaserFrame event.
       public: float *laserBuffer;
 
-      /// \brief Outgoing laser data, used by newLaserFrame event.
-      public: float *laserScan;
+      /// \brief Number of floats per ray in the laser buffer. This is 2
+      /// (range, intensity) when the render system supports two channel
+      /// float render targets, and 3 otherwise.
+      public: unsigned int channels;
 
       /// \brief Pointer to Ogre material for the first rendering pass.
       public: Ogre::Material *matFirstPass;
@@ -71,19 +73,19 @@ namespace gazebo
       /// \brief Pointer to Ogre material for the sencod rendering pass.
       public: Ogre::Material *matSecondPass;
 
-      /// \brief An array of first pass textures.
-      public: Ogre::Texture *firstPassTextures[3];
+      /// \brief First pass texture, with the views side by side.
+      public: Ogre::Texture *firstPassTexture;
 
       /// \brief Second pass texture.
       public: Ogre::Texture *secondPassTexture;
 
-      /// \brief First pass render targets.
-      public: Ogre::RenderTarget *firstPassTargets[3];
+      /// \brief First pass render target.
+      public: Ogre::RenderTarget *firstPassTarget;
 
       /// \brief Second pass render target.
       public: Ogre::RenderTarget *secondPassTarget;
 
-      /// \brief First pass viewports.
+      /// \brief First pass viewports, one per view.
       public: Ogre::Viewport *firstPassViewports[3];
 
       /// \brief Second pass viewport
@@ -95,8 +97,8 @@ namespace gazebo
       /// \brief A list of camera angles for first pass rendering.
       public: double cameraYaws[4];
 
-      /// \brief Temporary pointer to the current render target.
-      public: Ogre::RenderTarget *currentTarget;
+      /// \brief Temporary pointer to the current viewport.
+      public: Ogre::Viewport *currentViewport;
 
       /// \brief Temporary pointer to the current material.
       public: Ogre::Material *currentMat;
@@ -15,7 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 #include <string.h>
 #include <math.h>
@@ -24,6 +28,7 @@
 #include <ignition/math/Matrix4.hh>
 
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "gazebo/common/Assert.hh"
@@ -58,6 +63,7 @@ const double HeightmapPrivate::loadRadiusFactor = 1.0;
 const double HeightmapPrivate::holdRadiusFactor = 1.15;
 const boost::filesystem::path HeightmapPrivate::pagingDirname = "paging";
 const boost::filesystem::path HeightmapPrivate::hashFilename = "gzterrain.SHA1";
+const boost::filesystem::path HeightmapPrivate::lockFilename = "gzterrain.lock";
 
 static std::string glslVersion = "130";
 static std::string vpInStr = "in";
@@ -314,12 +320,28 @@ void Heightmap::UpdateTerrainHash(const std::string &_hash,
 bool Heightmap::PrepareTerrain(
     const boost::filesystem::path &_terrainDirPath)
 {
-  std::string heightmapHash;
   boost::filesystem::path terrainHashFullPath;
   bool updateHash = true;
 
-  // Compute the original heightmap's image.
-  heightmapHash = common::get_sha1<std::vector<float> >(this->dataPtr->heights);
+  // Hash the heights and the parameters baked into the terrain files, so that
+  // a cache generated with other textures or subdivisions is not reused
+  std::ostringstream params;
+  params << common::get_sha1<std::vector<float> >(this->dataPtr->heights)
+         << " " << this->dataPtr->dataSize << " " << this->dataPtr->terrainSize
+         << " " << this->dataPtr->numTerrainSubdivisions
+         << " " << this->dataPtr->useTerrainPaging;
+  for (unsigned int i = 0; i < this->dataPtr->diffuseTextures.size(); ++i)
+    params << " " << this->dataPtr->diffuseTextures[i];
+  for (unsigned int i = 0; i < this->dataPtr->normalTextures.size(); ++i)
+    params << " " << this->dataPtr->normalTextures[i];
+  for (unsigned int i = 0; i < this->dataPtr->worldSizes.size(); ++i)
+    params << " " << this->dataPtr->worldSizes[i];
+  for (unsigned int i = 0; i < this->dataPtr->blendHeight.size(); ++i)
+    params << " " << this->dataPtr->blendHeight[i];
+  for (unsigned int i = 0; i < this->dataPtr->blendFade.size(); ++i)
+    params << " " << this->dataPtr->blendFade[i];
+  this->dataPtr->terrainHash = common::get_sha1<std::string>(params.str());
+  this->dataPtr->terrainDir = _terrainDirPath;
 
   // Check if the terrain hash exists
   terrainHashFullPath = _terrainDirPath / this->dataPtr->hashFilename;
@@ -332,18 +354,19 @@ bool Heightmap::PrepareTerrain(
       std::stringstream buffer;
       buffer << in.rdbuf();
       std::string terrainHash(buffer.str());
-      updateHash = terrainHash != heightmapHash;
+      updateHash = terrainHash != this->dataPtr->terrainHash;
     }
     catch(std::ifstream::failure &e)
     {
       gzerr << "Terrain paging error: Unable to read terrain hash\n";
     }
-  }
 
-  // Update the terrain hash and split the terrain into small pieces
-  if (updateHash)
-  {
-    this->UpdateTerrainHash(heightmapHash, _terrainDirPath);
+    // The hash is written again once the new terrain files are saved
+    if (updateHash)
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove(terrainHashFullPath, ec);
+    }
   }
 
   return updateHash;
@@ -594,41 +617,13 @@ void Heightmap::Load()
 
   this->dataPtr->terrainHashChanged = this->PrepareTerrain(terrainDirPath);
 
-  if (this->dataPtr->useTerrainPaging)
+  if (this->dataPtr->useTerrainPaging && this->dataPtr->terrainHashChanged)
   {
-    if (this->dataPtr->terrainHashChanged)
-    {
-      // Split the terrain. Every subterrain will be saved on disk and paged
-      this->SplitHeights(this->dataPtr->heights, nTerrains,
-          this->dataPtr->subTerrains);
-    }
-
-    this->dataPtr->pageManager = OGRE_NEW Ogre::PageManager();
-    this->dataPtr->pageManager->setPageProvider(
-        &this->dataPtr->dummyPageProvider);
-
-    // Add cameras
-    for (unsigned int i = 0; i < this->dataPtr->scene->CameraCount(); ++i)
-    {
-      this->dataPtr->pageManager->addCamera(
-          this->dataPtr->scene->GetCamera(i)->OgreCamera());
-    }
-    for (unsigned int i = 0; i < this->dataPtr->scene->UserCameraCount();
-        ++i)
-    {
-      this->dataPtr->pageManager->addCamera(
-          this->dataPtr->scene->GetUserCamera(i)->OgreCamera());
-    }
-
-    this->dataPtr->terrainPaging =
-        OGRE_NEW Ogre::TerrainPaging(this->dataPtr->pageManager);
-    this->dataPtr->world = this->dataPtr->pageManager->createWorld();
-    this->dataPtr->terrainPaging->createWorldSection(
-        this->dataPtr->world, this->dataPtr->terrainGroup,
-        this->dataPtr->loadRadiusFactor * this->dataPtr->terrainSize.X(),
-        this->dataPtr->holdRadiusFactor * this->dataPtr->terrainSize.X(),
-        0, 0, sqrtN - 1, sqrtN - 1);
+    // Split the terrain. Every subterrain will be saved on disk and paged
+    this->SplitHeights(this->dataPtr->heights, nTerrains,
+        this->dataPtr->subTerrains);
   }
+  this->dataPtr->terrainsPerSide = static_cast<int>(sqrtN);
 
   gzmsg << "Loading heightmap: " << terrainName.string() << std::endl;
   common::Time time = common::Time::GetWallTime();
@@ -640,67 +635,219 @@ void Heightmap::Load()
   // use gazebo shaders
   this->CreateMaterial();
 
-  // Sync load since we want everything in place when we start
-  this->dataPtr->terrainGroup->loadAllTerrains(true);
+  if (this->dataPtr->useTerrainPaging)
+  {
+    if (this->dataPtr->terrainsImported)
+    {
+      // Generate the terrains on the Ogre work queue instead of blocking the
+      // render thread. They are paged from the cache once saved.
+      gzmsg << "Generating heightmap cache data in the background"
+            << std::endl;
+      this->dataPtr->pagingPending = true;
+      this->dataPtr->terrainGroup->loadAllTerrains(false);
+    }
+    else
+    {
+      // The pages are loaded in the background around the cameras
+      this->CreatePaging();
+    }
+  }
+  else
+  {
+    // Sync load since we want everything in place when we start
+    this->dataPtr->terrainGroup->loadAllTerrains(true);
 
-  gzmsg << "Heightmap loaded. Process took: "
-        <<  (common::Time::GetWallTime() - time).Double()
-        << " seconds" << std::endl;
+    gzmsg << "Heightmap loaded. Process took: "
+          <<  (common::Time::GetWallTime() - time).Double()
+          << " seconds" << std::endl;
 
-  // Calculate blend maps
+    // Calculate blend maps
+    if (this->dataPtr->terrainsImported)
+    {
+      Ogre::TerrainGroup::TerrainIterator ti =
+        this->dataPtr->terrainGroup->getTerrainIterator();
+      while (ti.hasMoreElements())
+      {
+        Ogre::Terrain *t = ti.getNext()->instance;
+        this->InitBlendMaps(t);
+        this->dataPtr->blendedTerrains.insert(t);
+      }
+    }
+
+    this->dataPtr->terrainGroup->freeTemporaryResources();
+  }
+
+  // save the terrain once its loaded, and keep adding the new cameras to
+  // the paging
+  if (this->dataPtr->terrainsImported || this->dataPtr->useTerrainPaging)
+  {
+    this->dataPtr->connections.push_back(
+        event::Events::ConnectPreRender(
+        std::bind(&Heightmap::UpdateTerrains, this)));
+  }
+}
+
+///////////////////////////////////////////////////
+void Heightmap::UpdateTerrains()
+{
   if (this->dataPtr->terrainsImported)
   {
+    // Initialize the blend maps of one terrain per frame, as they finish
+    // loading in the background
     Ogre::TerrainGroup::TerrainIterator ti =
       this->dataPtr->terrainGroup->getTerrainIterator();
     while (ti.hasMoreElements())
     {
       Ogre::Terrain *t = ti.getNext()->instance;
+      if (!t || !t->isLoaded() || this->dataPtr->blendedTerrains.count(t))
+        continue;
+
       this->InitBlendMaps(t);
+      this->dataPtr->blendedTerrains.insert(t);
+      break;
     }
+
+    this->SaveHeightmap();
   }
 
-  this->dataPtr->terrainGroup->freeTemporaryResources();
+  if (!this->dataPtr->pageManager)
+    return;
 
-  // save the terrain once its loaded
-  if (this->dataPtr->terrainsImported)
+  // Sensor cameras are usually created after the heightmap. Every camera
+  // drives the paging, so that sensors don't wait for their pages.
+  for (unsigned int i = 0; i < this->dataPtr->scene->CameraCount(); ++i)
   {
-    this->dataPtr->connections.push_back(
-        event::Events::ConnectPreRender(
-        std::bind(&Heightmap::SaveHeightmap, this)));
+    Ogre::Camera *cam = this->dataPtr->scene->GetCamera(i)->OgreCamera();
+    if (cam && !this->dataPtr->pageManager->hasCamera(cam))
+      this->dataPtr->pageManager->addCamera(cam);
+  }
+  for (unsigned int i = 0; i < this->dataPtr->scene->UserCameraCount(); ++i)
+  {
+    Ogre::Camera *cam = this->dataPtr->scene->GetUserCamera(i)->OgreCamera();
+    if (cam && !this->dataPtr->pageManager->hasCamera(cam))
+      this->dataPtr->pageManager->addCamera(cam);
   }
 }
 
+///////////////////////////////////////////////////
+void Heightmap::CreatePaging()
+{
+  const int n = this->dataPtr->terrainsPerSide;
+
+  this->dataPtr->pageManager = OGRE_NEW Ogre::PageManager();
+  this->dataPtr->pageManager->setPageProvider(
+      &this->dataPtr->dummyPageProvider);
+
+  // Add cameras
+  for (unsigned int i = 0; i < this->dataPtr->scene->CameraCount(); ++i)
+  {
+    Ogre::Camera *cam = this->dataPtr->scene->GetCamera(i)->OgreCamera();
+    if (cam)
+      this->dataPtr->pageManager->addCamera(cam);
+  }
+  for (unsigned int i = 0; i < this->dataPtr->scene->UserCameraCount(); ++i)
+  {
+    Ogre::Camera *cam = this->dataPtr->scene->GetUserCamera(i)->OgreCamera();
+    if (cam)
+      this->dataPtr->pageManager->addCamera(cam);
+  }
+
+  this->dataPtr->terrainPaging =
+      OGRE_NEW Ogre::TerrainPaging(this->dataPtr->pageManager);
+  this->dataPtr->world = this->dataPtr->pageManager->createWorld();
+  this->dataPtr->terrainPaging->createWorldSection(
+      this->dataPtr->world, this->dataPtr->terrainGroup,
+      this->dataPtr->loadRadiusFactor * this->dataPtr->terrainSize.X(),
+      this->dataPtr->holdRadiusFactor * this->dataPtr->terrainSize.X(),
+      0, 0, n - 1, n - 1);
+}
+
 ///////////////////////////////////////////////////
 void Heightmap::SaveHeightmap()
 {
-  if (this->dataPtr->terrainsImported &&
-      !this->dataPtr->terrainGroup->isDerivedDataUpdateInProgress())
+  if (!this->dataPtr->terrainsImported ||
+      this->dataPtr->terrainGroup->isDerivedDataUpdateInProgress())
   {
-    // check to see if all terrains have been loaded before saving
-    Ogre::TerrainGroup::TerrainIterator ti =
-      this->dataPtr->terrainGroup->getTerrainIterator();
-    while (ti.hasMoreElements())
+    return;
+  }
+
+  // check to see if all terrains have been loaded and blended before saving
+  Ogre::TerrainGroup::TerrainIterator ti =
+    this->dataPtr->terrainGroup->getTerrainIterator();
+  while (ti.hasMoreElements())
+  {
+    Ogre::Terrain *t = ti.getNext()->instance;
+    if (!t || !t->isLoaded() || !this->dataPtr->blendedTerrains.count(t))
+      return;
+  }
+
+  // Processes sharing the cache directory save the terrain files one at a
+  // time, and only if no other process saved the same terrain meanwhile
+  const boost::filesystem::path &dir = this->dataPtr->terrainDir;
+  std::unique_ptr<boost::interprocess::file_lock> lock;
+  bool save = true;
+  if (!dir.empty())
+  {
+    try
     {
-      Ogre::Terrain *t = ti.getNext()->instance;
-      if (!t->isLoaded())
+      boost::filesystem::create_directories(dir);
+      const std::string lockPath = (dir / this->dataPtr->lockFilename).string();
+      std::ofstream lockFile(lockPath.c_str(), std::ios::app);
+      lockFile.close();
+
+      lock.reset(new boost::interprocess::file_lock(lockPath.c_str()));
+      // Try again next frame
+      if (!lock->try_lock())
         return;
+      save = this->PrepareTerrain(dir);
+    }
+    catch(boost::interprocess::interprocess_exception &_e)
+    {
+      gzerr << "Unable to lock the heightmap cache data in " << dir.string()
+            << ": " << _e.what() << std::endl;
+      lock.reset();
     }
+  }
 
-    // saving an ogre terrain data file can take quite some time for large dems.
-    gzmsg << "Saving heightmap cache data to " << (this->dataPtr->gzPagingDir /
-        boost::filesystem::path(this->dataPtr->filename).stem()).string()
-        << std::endl;
+  if (save)
+  {
+    // saving an ogre terrain data file can take quite some time for large
+    // dems.
+    gzmsg << "Saving heightmap cache data to " << dir.string() << std::endl;
     common::Time time = common::Time::GetWallTime();
 
     this->dataPtr->terrainGroup->saveAllTerrains(true);
 
+    // The hash marks the terrain files as complete
+    if (!dir.empty())
+      this->UpdateTerrainHash(this->dataPtr->terrainHash, dir);
+
     gzmsg << "Heightmap cache data saved. Process took: "
           << (common::Time::GetWallTime() - time).Double() << " seconds."
           << std::endl;
+  }
 
-    this->dataPtr->terrainsImported = false;
-    this->dataPtr->connections.clear();
+  if (lock)
+    lock->unlock();
+
+  this->dataPtr->terrainsImported = false;
+  this->dataPtr->blendedTerrains.clear();
+  this->dataPtr->terrainGroup->freeTemporaryResources();
+
+  if (this->dataPtr->pagingPending)
+  {
+    // Page the saved terrains around the cameras from now on
+    this->dataPtr->pagingPending = false;
+    this->dataPtr->terrainGroup->removeAllTerrains();
+    this->dataPtr->terrainHashChanged = false;
+    for (int y = 0; y < this->dataPtr->terrainsPerSide; ++y)
+      for (int x = 0; x < this->dataPtr->terrainsPerSide; ++x)
+        this->dataPtr->terrainGroup->defineTerrain(x, y);
+    this->CreatePaging();
   }
+
+  if (!this->dataPtr->useTerrainPaging)
+    this->dataPtr->connections.clear();
 }
 
 ///////////////////////////////////////////////////
@@ -741,6 +888,11 @@ void Heightmap::ConfigureTerrainDefaults()
   this->dataPtr->terrainGlobals->setCastsDynamicShadows(
         this->dataPtr->castShadows);
 
+  // The terrain doesn't move, keep it out of the dynamic shadow casters
+  this->dataPtr->terrainGlobals->setVisibilityFlags(
+      this->dataPtr->terrainGlobals->getVisibilityFlags() &
+      ~GZ_VISIBILITY_SHADOW_DYNAMIC);
+
   this->dataPtr->terrainGlobals->setCompositeMapAmbient(
       this->dataPtr->scene->OgreSceneManager()->getAmbientLight());
 
@@ -890,7 +1042,6 @@ bool Heightmap::InitBlendMaps(Ogre::Terrain *_terrain)
       return false;
   }
 
-  Ogre::Real val, height;
   unsigned int i = 0;
 
   std::vector<Ogre::TerrainLayerBlendMap *> blendMaps;
@@ -903,25 +1054,43 @@ bool Heightmap::InitBlendMaps(Ogre::Terrain *_terrain)
     pBlend.push_back(blendMaps[i]->getBlendPointer());
   }
 
-  // Set the blend values based on the height of the terrain
-  for (Ogre::uint16 y = 0; y < _terrain->getLayerBlendMapSize(); ++y)
+  // Set the blend values based on the height of the terrain. The rows are
+  // independent, split them between threads.
+  const Ogre::uint16 size = _terrain->getLayerBlendMapSize();
+  auto blendRows = [&](const Ogre::uint16 _begin, const Ogre::uint16 _end)
   {
-    for (Ogre::uint16 x = 0; x < _terrain->getLayerBlendMapSize(); ++x)
+    for (Ogre::uint16 y = _begin; y < _end; ++y)
     {
-      Ogre::Real tx, ty;
+      for (Ogre::uint16 x = 0; x < size; ++x)
+      {
+        Ogre::Real tx, ty;
 
-      blendMaps[0]->convertImageToTerrainSpace(x, y, &tx, &ty);
-      height = _terrain->getHeightAtTerrainPosition(tx, ty);
+        blendMaps[0]->convertImageToTerrainSpace(x, y, &tx, &ty);
+        Ogre::Real height = _terrain->getHeightAtTerrainPosition(tx, ty);
 
-      for (i = 0; i < this->dataPtr->blendHeight.size(); ++i)
-      {
-        val = (height - this->dataPtr->blendHeight[i]) /
-            this->dataPtr->blendFade[i];
-        val = Ogre::Math::Clamp(val, (Ogre::Real)0, (Ogre::Real)1);
-        *pBlend[i]++ = val;
+        for (unsigned int j = 0; j < this->dataPtr->blendHeight.size(); ++j)
+        {
+          Ogre::Real val = (height - this->dataPtr->blendHeight[j]) /
+              this->dataPtr->blendFade[j];
+          pBlend[j][static_cast<size_t>(y) * size + x] =
+              Ogre::Math::Clamp(val, (Ogre::Real)0, (Ogre::Real)1);
+        }
       }
     }
+  };
+
+  const unsigned int threadCount = std::max(1u, std::min(
+      std::thread::hardware_concurrency(), static_cast<unsigned int>(size)));
+  std::vector<std::thread> threads;
+  for (unsigned int t = 1; t < threadCount; ++t)
+  {
+    threads.push_back(std::thread(blendRows,
+        static_cast<Ogre::uint16>(size * t / threadCount),
+        static_cast<Ogre::uint16>(size * (t + 1) / threadCount)));
   }
+  blendRows(0, static_cast<Ogre::uint16>(size / threadCount));
+  for (auto &thread : threads)
+    thread.join();
 
   // Make sure the blend maps are properly updated
   for (i = 0; i < blendMaps.size(); ++i)
@@ -253,9 +253,9 @@ namespace gazebo
       private: void SetupShadows(const bool _enabled);
 
       /// \brief Update the hash of a terrain file. The hash will be written in
-      /// a file called gzterrain.SHA1 . This method will be used when the
-      /// paging is enabled and the terrain is loaded for the first time or if
-      /// the heightmap's image has been modified.
+      /// a file called gzterrain.SHA1 . This method is called once the
+      /// terrain files are saved, when the terrain is loaded for the first
+      /// time or if the heightmap's image has been modified.
       /// \param[in] _hash New hash value
       /// \param[in] _terrainDir Directory where the terrain hash and the
       /// terrain pages are stored. Ex: $TMP/gazebo-paging/heigthmap_bowl
@@ -263,16 +263,29 @@ namespace gazebo
           const boost::filesystem::path &_terrainDir);
 
       /// \brief Checks if the terrain was previously loaded by comparing its
-      /// hash against the one stored in the terrain directory
+      /// hash against the one stored in the terrain directory. The hash
+      /// covers the heights and the parameters baked into the terrain files.
+      /// A stale hash is removed, so that other processes sharing the
+      /// directory don't load the files while they are regenerated.
       /// \param[in] _terrainDirPath Path to the directory containing the
       /// terrain files and hash.
       /// \return True if the terrain requires to regenerate the terrain files.
       private: bool PrepareTerrain(
           const boost::filesystem::path &_terrainDirPath);
 
-      /// \brief Save the heightmap tiles to disk
+      /// \brief Save the heightmap tiles to disk, once every imported
+      /// terrain is loaded and has its blend maps.
       private: void SaveHeightmap();
 
+      /// \brief Called before rendering. Initializes the blend maps of the
+      /// terrains loaded in the background, saves them, and registers new
+      /// cameras with the terrain paging.
+      private: void UpdateTerrains();
+
+      /// \brief Create the paged world section of the terrain group and
+      /// register the cameras of the scene.
+      private: void CreatePaging();
+
       /// \internal
       /// \brief Pointer to private data.
       private: std::unique_ptr<HeightmapPrivate> dataPtr;
@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_RENDERING_HEIGHTMAPPRIVATE_HH_
 #define _GAZEBO_RENDERING_HEIGHTMAPPRIVATE_HH_
 
+#include <set>
 #include <string>
 #include <vector>
 #include <boost/filesystem.hpp>
@@ -43,6 +44,7 @@ namespace Ogre
 {
   class PageManager;
   class PagedWorld;
+  class Terrain;
   class TerrainGlobalOptions;
   class TerrainGroup;
   class TerrainPaging;
@@ -372,9 +374,15 @@ namespace gazebo
       public: static const double holdRadiusFactor;
 
       /// \brief Hash file name that should be present for every terrain file
-      /// loaded using paging.
+      /// loaded using paging. It is written once the terrain files are
+      /// completely saved, so a process never loads a partial cache.
       public: static const boost::filesystem::path hashFilename;
 
+      /// \brief Name of the file locked by the process that saves the
+      /// terrain files, so that processes sharing the cache don't write them
+      /// at the same time.
+      public: static const boost::filesystem::path lockFilename;
+
       /// \brief Name of the top level directory where all the paging info is
       /// stored
       public: static const boost::filesystem::path pagingDirname;
@@ -485,6 +493,23 @@ namespace gazebo
 
       /// \brief Event connections
       public: std::vector<event::ConnectionPtr> connections;
+
+      /// \brief Hash of the heights and of the parameters baked into the
+      /// terrain files.
+      public: std::string terrainHash;
+
+      /// \brief Directory of the terrain files and hash.
+      public: boost::filesystem::path terrainDir;
+
+      /// \brief Imported terrains whose blend maps were initialized.
+      public: std::set<Ogre::Terrain *> blendedTerrains;
+
+      /// \brief Number of terrains along each side of the group.
+      public: int terrainsPerSide = 1;
+
+      /// \brief True if the paged world section must be created once the
+      /// imported terrains are saved.
+      public: bool pagingPending = false;
     };
   }
 }
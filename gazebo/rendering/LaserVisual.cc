@@ -15,6 +15,9 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+
 #include <boost/bind.hpp>
 
 #include "gazebo/common/MeshManager.hh"
@@ -22,6 +25,7 @@
 
 #include "gazebo/rendering/Conversions.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/UserCamera.hh"
 #include "gazebo/rendering/DynamicLines.hh"
 #include "gazebo/rendering/LaserVisualPrivate.hh"
 #include "gazebo/rendering/LaserVisual.hh"
@@ -29,6 +33,37 @@
 using namespace gazebo;
 using namespace rendering;
 
+/////////////////////////////////////////////////
+/// \brief Get the number of consecutive rays of a scan drawn as one, so
+/// that far away scans don't draw several rays per pixel of the camera.
+/// \param[in] _scan Laser scan.
+/// \param[in] _camera Camera the scan is seen from, may be null.
+/// \return Number of rays drawn as one, at least 1.
+static unsigned int RayStride(const msgs::LaserScan &_scan,
+    const UserCameraPtr &_camera)
+{
+  if (!_camera || _camera->ImageWidth() == 0u)
+    return 1u;
+
+  const double hfov = _camera->HFOV().Radian();
+  if (hfov <= 0)
+    return 1u;
+
+  // The ends of the rays nearest to the camera are the furthest apart
+  const double rangeMax = _scan.range_max();
+  const double distance = _camera->WorldPosition().Distance(
+      msgs::ConvertIgn(_scan.world_pose().position())) - rangeMax;
+  if (distance <= 0)
+    return 1u;
+
+  const double pixels = rangeMax * std::fabs(_scan.angle_step()) / distance *
+      _camera->ImageWidth() / hfov;
+  if (pixels <= 0 || pixels >= 1.0)
+    return 1u;
+
+  return static_cast<unsigned int>(1.0 / pixels);
+}
+
 /////////////////////////////////////////////////
 LaserVisual::LaserVisual(const std::string &_name, VisualPtr _vis,
                          const std::string &_topicName)
@@ -116,6 +151,14 @@ void LaserVisual::Update()
 
   double minRange = dPtr->laserMsg->scan().range_min();
 
+  UserCameraPtr camera;
+  if (this->GetScene()->UserCameraCount() > 0u)
+    camera = this->GetScene()->GetUserCamera(0);
+  const unsigned int stride = RayStride(dPtr->laserMsg->scan(), camera);
+
+  const unsigned int count = dPtr->laserMsg->scan().count();
+  const unsigned int rayCount = (count + stride - 1) / stride;
+
   // Process each ray fan
   for (unsigned int j = 0; j < vertCount; ++j)
   {
@@ -150,16 +193,37 @@ void LaserVisual::Update()
 
       this->SetVisibilityFlags(GZ_VISIBILITY_GUI);
     }
+    else if (dPtr->rayLines[j]->GetPointCount() / 2 > rayCount)
+    {
+      // Fewer rays are drawn than before, start over
+      dPtr->rayStrips[j]->Clear();
+      dPtr->noHitRayStrips[j]->Clear();
+      dPtr->rayLines[j]->Clear();
+      dPtr->deadzoneRayFans[j]->Clear();
+      dPtr->deadzoneRayFans[j]->AddPoint(ignition::math::Vector3d(0, 0, 0));
+    }
     dPtr->deadzoneRayFans[j]->SetPoint(0, offset.Pos());
 
-    double angle = dPtr->laserMsg->scan().angle_min();
-    unsigned int count = dPtr->laserMsg->scan().count();
-
-    // Process each ray in the current scan.
-    for (unsigned int i = 0; i < count; ++i)
+    // Process each ray in the current scan. Rays drawn as one show the
+    // nearest range among them.
+    for (unsigned int i = 0; i < rayCount; ++i)
     {
+      unsigned int index = i * stride;
+      double r = dPtr->laserMsg->scan().ranges(j*count + index);
+      const unsigned int end = std::min((i + 1) * stride, count);
+      for (unsigned int k = index + 1; k < end; ++k)
+      {
+        const double range = dPtr->laserMsg->scan().ranges(j*count + k);
+        if (range < r)
+        {
+          r = range;
+          index = k;
+        }
+      }
+      const double angle = dPtr->laserMsg->scan().angle_min() +
+          index * dPtr->laserMsg->scan().angle_step();
+
       // Calculate the range of the ray
-      double r = dPtr->laserMsg->scan().ranges(j*count + i);
       if (r < minRange)
       {
         // Less than min range, don't display a ray
@@ -217,8 +281,6 @@ void LaserVisual::Update()
         dPtr->deadzoneRayFans[j]->AddPoint(startPt);
       else
         dPtr->deadzoneRayFans[j]->SetPoint(i+1, startPt);
-
-      angle += dPtr->laserMsg->scan().angle_step();
     }
     verticalAngle += dPtr->laserMsg->scan().vertical_angle_step();
   }
@@ -15,10 +15,17 @@
  *
 */
 
+#include <cmath>
+#include <functional>
+
 #include <gtest/gtest.h>
+#include "gazebo/common/Events.hh"
+#include "gazebo/rendering/DynamicLines.hh"
 #include "gazebo/rendering/LaserVisual.hh"
+#include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/UserCamera.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -60,6 +67,133 @@ TEST_F(LaserVisual_TEST, LoadDestroy)
   EXPECT_EQ(scene->WorldVisual()->GetChildCount(), count);
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the ray lines of a laser visual.
+/// \param[in] _vis The laser visual.
+/// \return The line list with two points per ray, null if not found.
+gazebo::rendering::DynamicLines *RayLines(gazebo::rendering::VisualPtr _vis)
+{
+  auto iter = _vis->GetSceneNode()->getAttachedObjectIterator();
+  while (iter.hasMoreElements())
+  {
+    auto line = dynamic_cast<gazebo::rendering::DynamicLines *>(
+        iter.getNext());
+    if (line &&
+        line->GetOperationType() == gazebo::rendering::RENDERING_LINE_LIST)
+    {
+      return line;
+    }
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+/// \brief Publish a scan, and wait until a laser visual draws it.
+/// \param[in] _pub Publisher of the scan.
+/// \param[in] _msg The scan.
+/// \param[in] _vis The laser visual.
+/// \param[in] _drawn Returns true once the number of rays drawn is the
+/// expected one.
+void DrawScan(transport::PublisherPtr _pub,
+    const msgs::LaserScanStamped &_msg, gazebo::rendering::VisualPtr _vis,
+    const std::function<bool (unsigned int)> &_drawn)
+{
+  _pub->Publish(_msg);
+  int sleep = 0;
+  const int maxSleep = 50;
+  while (sleep++ < maxSleep)
+  {
+    common::Time::MSleep(100);
+    event::Events::preRender();
+    auto lines = RayLines(_vis);
+    if (lines && _drawn(lines->GetPointCount() / 2))
+      break;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(LaserVisual_TEST, FarAwayScan)
+{
+  this->Load("worlds/empty.world");
+
+  auto scene = gazebo::rendering::get_scene("default");
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_NE(scene, nullptr);
+
+  gazebo::rendering::UserCameraPtr camera =
+      scene->CreateUserCamera("test_user_camera");
+  ASSERT_NE(camera, nullptr);
+  ASSERT_GT(camera->ImageWidth(), 0u);
+
+  gazebo::rendering::VisualPtr vis(
+      new gazebo::rendering::LaserVisual("test_vis",
+      scene->WorldVisual(), "~/test_scan"));
+  vis->Load();
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  transport::PublisherPtr pub =
+      node->Advertise<msgs::LaserScanStamped>("~/test_scan");
+  pub->WaitForConnection();
+
+  // 1000 rays over 1 rad, one of them hitting a near obstacle
+  const unsigned int count = 1000;
+  msgs::LaserScanStamped msg;
+  msgs::Set(msg.mutable_time(), common::Time(1));
+  msgs::LaserScan *scan = msg.mutable_scan();
+  scan->set_frame("test_frame");
+  msgs::Set(scan->mutable_world_pose(), ignition::math::Pose3d::Zero);
+  scan->set_angle_min(-0.5);
+  scan->set_angle_max(0.5);
+  scan->set_angle_step(1.0 / (count - 1));
+  scan->set_range_min(0.0);
+  scan->set_range_max(1.0);
+  scan->set_count(count);
+  scan->set_vertical_angle_min(0.0);
+  scan->set_vertical_angle_max(0.0);
+  scan->set_vertical_angle_step(0.0);
+  scan->set_vertical_count(1);
+  for (unsigned int i = 0; i < count; ++i)
+    scan->add_ranges(i == 501 ? 0.2 : 0.9);
+
+  // Seen from nearby, every ray is drawn
+  auto all = [count](unsigned int _rays) {return _rays == count;};
+  camera->SetWorldPosition(ignition::math::Vector3d(0, 0, 0.5));
+  DrawScan(pub, msg, vis, all);
+  auto lines = RayLines(vis);
+  ASSERT_NE(lines, nullptr);
+  EXPECT_EQ(count * 2, lines->GetPointCount());
+
+  // Seen from far away, rays closer than a pixel are merged
+  camera->SetWorldPosition(ignition::math::Vector3d(-30, 0, 0));
+  DrawScan(pub, msg, vis,
+      [count](unsigned int _rays) {return _rays < count;});
+  const unsigned int merged = lines->GetPointCount() / 2;
+  EXPECT_GT(merged, 0u);
+  EXPECT_LT(merged, count);
+
+  // The merged rays keep the nearest range
+  bool nearest = false;
+  for (unsigned int i = 1; i < lines->GetPointCount(); i += 2)
+  {
+    const double range = lines->Point(i).Length();
+    if (std::fabs(range - 0.2) < 1e-6)
+      nearest = true;
+    else
+      EXPECT_NEAR(range, 0.9, 1e-6);
+  }
+  EXPECT_TRUE(nearest);
+
+  // Back to every ray from nearby
+  camera->SetWorldPosition(ignition::math::Vector3d(0, 0, 0.5));
+  DrawScan(pub, msg, vis, all);
+  EXPECT_EQ(count * 2, lines->GetPointCount());
+
+  vis->Fini();
+  vis.reset();
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/rendering/RenderEvents.hh"
+#include "gazebo/rendering/DynamicLines.hh"
+#include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/VisualPrivate.hh"
+#include "gazebo/rendering/MarkerBatchVisual.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+/// \brief An element of a batch.
+class MarkerBatchElement
+{
+  /// \brief Id of the marker.
+  public: uint64_t id = 0;
+
+  /// \brief Pose of the element.
+  public: ignition::math::Pose3d pose;
+
+  /// \brief Scale of the element.
+  public: ignition::math::Vector3d scale = ignition::math::Vector3d::One;
+
+  /// \brief Points of the element, in its frame.
+  public: std::vector<ignition::math::Vector3d> points;
+};
+
+/// \brief Private data for the MarkerBatchVisual class.
+class gazebo::rendering::MarkerBatchVisualPrivate : public VisualPrivate
+{
+  /// \brief Vertices of all the elements, owned by the visual.
+  public: DynamicLines *lines = nullptr;
+
+  /// \brief Type of the elements.
+  public: ignition::msgs::Marker::Type type = ignition::msgs::Marker::NONE;
+
+  /// \brief Triangles of a shape element, empty for the other types.
+  public: std::vector<ignition::math::Vector3d> shape;
+
+  /// \brief Number of vertices of each element, 0 until the first
+  /// element of a type without shape is added.
+  public: unsigned int stride = 0;
+
+  /// \brief Elements, in the order of their vertices.
+  public: std::vector<MarkerBatchElement> elements;
+
+  /// \brief Index of each element in elements, by id.
+  public: std::unordered_map<uint64_t, size_t> slots;
+
+  /// \brief Lifetime of the batch.
+  public: common::Time lifetime;
+
+  /// \brief True when the batch has already been loaded.
+  public: bool loaded = false;
+};
+
+/////////////////////////////////////////////////
+MarkerBatchVisual::MarkerBatchVisual(const std::string &_name, VisualPtr _vis)
+: Visual(*new MarkerBatchVisualPrivate, _name, _vis, false)
+{
+  this->dPtr = reinterpret_cast<MarkerBatchVisualPrivate *>(this->dataPtr);
+}
+
+/////////////////////////////////////////////////
+MarkerBatchVisual::~MarkerBatchVisual()
+{
+  this->Fini();
+  this->dPtr = nullptr;
+}
+
+/////////////////////////////////////////////////
+bool MarkerBatchVisual::Load(const ignition::msgs::Marker_V &_msg)
+{
+  if (!this->dPtr->loaded)
+  {
+    Visual::Load();
+    this->dPtr->loaded = true;
+  }
+
+  bool result = true;
+  bool shared = false;
+  for (int i = 0; i < _msg.marker_size(); ++i)
+  {
+    const ignition::msgs::Marker &marker = _msg.marker(i);
+
+    if (marker.action() == ignition::msgs::Marker::DELETE_ALL)
+    {
+      this->dPtr->elements.clear();
+      this->dPtr->slots.clear();
+      if (this->dPtr->shape.empty())
+        this->dPtr->stride = 0;
+      if (this->dPtr->lines)
+        this->dPtr->lines->Clear();
+      continue;
+    }
+
+    if (marker.action() == ignition::msgs::Marker::DELETE_MARKER)
+    {
+      if (!this->Delete(marker.id()))
+      {
+        gzwarn << "Unable to delete bulk marker with id[" << marker.id()
+          << "] in namespace[" << marker.ns() << "]" << std::endl;
+        result = false;
+      }
+      continue;
+    }
+
+    if (marker.action() != ignition::msgs::Marker::ADD_MODIFY)
+    {
+      gzerr << "Unknown marker action[" << marker.action() << "]\n";
+      result = false;
+      continue;
+    }
+
+    // The settings of the batch come from the first marker of the message
+    // which adds or modifies an element
+    if (!shared)
+    {
+      shared = true;
+
+      if (marker.type() != ignition::msgs::Marker::NONE &&
+          marker.type() != this->dPtr->type && !this->SetType(marker.type()))
+      {
+        return false;
+      }
+
+      if (marker.has_material())
+        this->ProcessMaterialMsg(marker.material());
+
+      if (marker.has_lifetime() &&
+          (marker.lifetime().sec() > 0 ||
+          (marker.lifetime().sec() == 0 && marker.lifetime().nsec() > 0)))
+      {
+        this->dPtr->lifetime = this->GetScene()->SimTime() +
+          common::Time(marker.lifetime().sec(), marker.lifetime().nsec());
+      }
+
+      if (!marker.parent().empty())
+      {
+        VisualPtr parent = this->GetScene()->GetVisual(marker.parent());
+        if (parent)
+        {
+          if (this->GetParent())
+            this->GetParent()->DetachVisual(shared_from_this());
+          parent->AttachVisual(shared_from_this());
+        }
+        else
+          gzerr << "No visual with the name[" << marker.parent() << "]\n";
+      }
+
+      rendering::Events::newLayer(marker.layer());
+      this->SetLayer(marker.layer());
+
+      this->SetVisibilityFlags(GZ_VISIBILITY_GUI);
+    }
+
+    if (this->dPtr->type == ignition::msgs::Marker::NONE)
+    {
+      gzerr << "Bulk markers in namespace[" << marker.ns()
+        << "] need a type" << std::endl;
+      return false;
+    }
+
+    if (!this->AddModify(marker))
+      result = false;
+  }
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+bool MarkerBatchVisual::SetType(const ignition::msgs::Marker::Type _type)
+{
+  RenderOpType opType;
+  std::string meshName;
+  switch (_type)
+  {
+    case ignition::msgs::Marker::BOX:
+      opType = RENDERING_TRIANGLE_LIST;
+      meshName = "unit_box";
+      break;
+    case ignition::msgs::Marker::CYLINDER:
+      opType = RENDERING_TRIANGLE_LIST;
+      meshName = "unit_cylinder";
+      break;
+    case ignition::msgs::Marker::SPHERE:
+      opType = RENDERING_TRIANGLE_LIST;
+      meshName = "unit_sphere";
+      break;
+    case ignition::msgs::Marker::LINE_LIST:
+      opType = RENDERING_LINE_LIST;
+      break;
+    case ignition::msgs::Marker::POINTS:
+      opType = RENDERING_POINT_LIST;
+      break;
+    case ignition::msgs::Marker::TRIANGLE_LIST:
+      opType = RENDERING_TRIANGLE_LIST;
+      break;
+    default:
+      gzerr << "Unable to create bulk markers of type[" << _type << "]\n";
+      return false;
+  };
+
+  // Shapes are unrolled to triangle lists, so that the elements don't
+  // share vertices
+  this->dPtr->shape.clear();
+  if (!meshName.empty())
+  {
+    const common::Mesh *mesh =
+        common::MeshManager::Instance()->GetMesh(meshName);
+    if (!mesh)
+    {
+      gzerr << "Unable to find mesh[" << meshName << "]\n";
+      return false;
+    }
+
+    for (unsigned int i = 0; i < mesh->GetSubMeshCount(); ++i)
+    {
+      const common::SubMesh *subMesh = mesh->GetSubMesh(i);
+      for (unsigned int j = 0; j < subMesh->GetIndexCount(); ++j)
+        this->dPtr->shape.push_back(subMesh->Vertex(subMesh->GetIndex(j)));
+    }
+  }
+
+  this->dPtr->type = _type;
+  this->dPtr->stride = this->dPtr->shape.size();
+  this->dPtr->elements.clear();
+  this->dPtr->slots.clear();
+
+  if (!this->dPtr->lines)
+  {
+    this->dPtr->lines = this->CreateDynamicLine(opType);
+  }
+  else
+  {
+    this->dPtr->lines->SetOperationType(opType);
+    this->dPtr->lines->Clear();
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool MarkerBatchVisual::AddModify(const ignition::msgs::Marker &_msg)
+{
+  auto iter = this->dPtr->slots.find(_msg.id());
+
+  MarkerBatchElement element;
+  if (iter != this->dPtr->slots.end())
+    element = this->dPtr->elements[iter->second];
+  element.id = _msg.id();
+
+  if (_msg.has_pose())
+    element.pose = ignition::msgs::Convert(_msg.pose());
+  if (_msg.has_scale())
+    element.scale = ignition::msgs::Convert(_msg.scale());
+
+  // The presence of points means the existing points are replaced
+  if (_msg.point_size() > 0)
+  {
+    element.points.clear();
+    for (int i = 0; i < _msg.point_size(); ++i)
+      element.points.push_back(ignition::msgs::Convert(_msg.point(i)));
+  }
+
+  unsigned int count = this->dPtr->shape.size();
+  if (this->dPtr->shape.empty())
+  {
+    if (element.points.empty() &&
+        this->dPtr->type != ignition::msgs::Marker::POINTS)
+    {
+      gzerr << "Bulk marker with id[" << element.id << "] in namespace["
+        << _msg.ns() << "] has no points" << std::endl;
+      return false;
+    }
+    count = std::max<size_t>(1u, element.points.size());
+  }
+
+  if (this->dPtr->stride == 0)
+    this->dPtr->stride = count;
+
+  if (count != this->dPtr->stride)
+  {
+    gzerr << "Bulk marker with id[" << element.id << "] in namespace["
+      << _msg.ns() << "] has " << count << " points, the other markers "
+      << "of the namespace have " << this->dPtr->stride << std::endl;
+    return false;
+  }
+
+  size_t slot;
+  if (iter == this->dPtr->slots.end())
+  {
+    slot = this->dPtr->elements.size();
+    this->dPtr->elements.push_back(element);
+    this->dPtr->slots[element.id] = slot;
+    for (unsigned int i = 0; i < this->dPtr->stride; ++i)
+      this->dPtr->lines->AddPoint(ignition::math::Vector3d::Zero);
+  }
+  else
+  {
+    slot = iter->second;
+    this->dPtr->elements[slot] = element;
+  }
+
+  this->WriteElement(slot);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool MarkerBatchVisual::Delete(const uint64_t _id)
+{
+  auto iter = this->dPtr->slots.find(_id);
+  if (iter == this->dPtr->slots.end())
+    return false;
+
+  const size_t slot = iter->second;
+  const size_t last = this->dPtr->elements.size() - 1;
+  this->dPtr->slots.erase(iter);
+
+  // Move the last element to the deleted one, to keep the vertices packed
+  if (slot != last)
+  {
+    this->dPtr->elements[slot] = this->dPtr->elements[last];
+    this->dPtr->slots[this->dPtr->elements[slot].id] = slot;
+    this->WriteElement(slot);
+  }
+  this->dPtr->elements.pop_back();
+  this->dPtr->lines->Truncate(
+      this->dPtr->elements.size() * this->dPtr->stride);
+
+  if (this->dPtr->elements.empty() && this->dPtr->shape.empty())
+    this->dPtr->stride = 0;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void MarkerBatchVisual::WriteElement(const size_t _slot)
+{
+  const MarkerBatchElement &element = this->dPtr->elements[_slot];
+  const unsigned int first = _slot * this->dPtr->stride;
+
+  const std::vector<ignition::math::Vector3d> &points =
+      this->dPtr->shape.empty() ? element.points : this->dPtr->shape;
+
+  if (points.empty())
+  {
+    this->dPtr->lines->SetPoint(first, element.pose.Pos());
+    return;
+  }
+
+  for (unsigned int i = 0; i < points.size(); ++i)
+  {
+    this->dPtr->lines->SetPoint(first + i,
+        element.pose.Pos() + element.pose.Rot() * (element.scale * points[i]));
+  }
+}
+
+/////////////////////////////////////////////////
+common::Time MarkerBatchVisual::Lifetime() const
+{
+  return this->dPtr->lifetime;
+}
+
+/////////////////////////////////////////////////
+unsigned int MarkerBatchVisual::ElementCount() const
+{
+  return this->dPtr->elements.size();
+}
+
+/////////////////////////////////////////////////
+void MarkerBatchVisual::Fini()
+{
+  if (this->dPtr->lines)
+  {
+    this->DeleteDynamicLine(this->dPtr->lines);
+    this->dPtr->lines = nullptr;
+  }
+  Visual::Fini();
+}
+
+/////////////////////////////////////////////////
+void MarkerBatchVisual::FillMsg(const std::string &_ns,
+    ignition::msgs::Marker_V &_msg) const
+{
+  for (const auto &element : this->dPtr->elements)
+  {
+    ignition::msgs::Marker *markerMsg = _msg.add_marker();
+    markerMsg->set_ns(_ns);
+    markerMsg->set_id(element.id);
+    markerMsg->set_type(this->dPtr->type);
+    markerMsg->set_layer(this->dataPtr->layer);
+    markerMsg->mutable_lifetime()->set_sec(this->dPtr->lifetime.sec);
+    markerMsg->mutable_lifetime()->set_nsec(this->dPtr->lifetime.nsec);
+    ignition::msgs::Set(markerMsg->mutable_pose(), element.pose);
+    ignition::msgs::Set(markerMsg->mutable_scale(), element.scale);
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_MARKERBATCHVISUAL_HH_
+#define GAZEBO_RENDERING_MARKERBATCHVISUAL_HH_
+
+#include <string>
+
+#include <ignition/msgs.hh>
+
+#include "gazebo/rendering/Visual.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class
+    class MarkerBatchVisualPrivate;
+
+    /// \cond
+    /// \brief All the markers of a namespace sent in bulk, rendered as one
+    /// batch. The MarkerManager class should instantiate instances of this
+    /// class.
+    ///
+    /// The markers of a batch share the type, material, layer, parent and
+    /// lifetime of the batch, set by the first marker of each message
+    /// that has them. Each marker is an element of the batch with its own
+    /// id, pose, scale and points. The elements are written to a single
+    /// vertex list, each one in a range of vertices of the same size, so
+    /// that adding, moving or deleting elements only rewrites their ranges
+    /// and the whole batch is drawn at once.
+    ///
+    /// Box, cylinder and sphere elements are triangles of the unit meshes.
+    /// Points elements without points are one point at their position.
+    /// Line list, points and triangle list elements must have as many
+    /// points as the first element of the batch.
+    /// \sa MarkerManager
+    class GZ_RENDERING_VISIBLE MarkerBatchVisual : public Visual
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Name of the visual.
+      /// \param[in] _vis Pointer to the parent Visual.
+      public: MarkerBatchVisual(const std::string &_name, VisualPtr _vis);
+
+      /// \brief Destructor.
+      public: virtual ~MarkerBatchVisual();
+
+      /// \brief Add, modify or delete elements of the batch.
+      /// \param[in] _msg Markers of the batch, processed in order.
+      /// \return False if the batch has no type, or if some markers
+      /// couldn't be processed.
+      public: bool Load(const ignition::msgs::Marker_V &_msg);
+      using Visual::Load;
+
+      /// \brief Get the lifetime of the batch.
+      /// \return Life time of the batch in simulation time.
+      public: common::Time Lifetime() const;
+
+      /// \brief Get the number of elements of the batch.
+      /// \return Number of elements.
+      public: unsigned int ElementCount() const;
+
+      // Documentation inherited
+      public: virtual void Fini();
+
+      /// \brief Add a marker message for each element, without points.
+      /// \param[in] _ns Namespace of the batch.
+      /// \param[out] _msg The message to populate.
+      public: void FillMsg(const std::string &_ns,
+                  ignition::msgs::Marker_V &_msg) const;
+
+      /// \brief Set the type of the elements, which clears the batch.
+      /// \param[in] _type Type of marker.
+      /// \return False if the type can't be batched.
+      private: bool SetType(const ignition::msgs::Marker::Type _type);
+
+      /// \brief Add or modify an element.
+      /// \param[in] _msg The element.
+      /// \return False if the element has the wrong number of points.
+      private: bool AddModify(const ignition::msgs::Marker &_msg);
+
+      /// \brief Delete an element, the last element takes its vertices.
+      /// \param[in] _id Id of the element.
+      /// \return False if there is no such element.
+      private: bool Delete(const uint64_t _id);
+
+      /// \brief Write the vertices of an element.
+      /// \param[in] _slot Index of the element.
+      private: void WriteElement(const size_t _slot);
+
+      /// \brief Private data pointer
+      private: MarkerBatchVisualPrivate *dPtr;
+    };
+    /// \endcond
+  }
+}
+#endif
@@ -29,6 +29,7 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/MarkerBatchVisual.hh"
 #include "gazebo/rendering/MarkerVisual.hh"
 #include "gazebo/rendering/MarkerManager.hh"
 
@@ -51,11 +52,34 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \brief List of marker messages.
   typedef std::list<ignition::msgs::Marker> MarkerMsgs_L;
 
+  /// \def MarkerBatchVisualPtr
+  /// \brief Shared pointer to MarkerBatchVisual
+  typedef std::shared_ptr<MarkerBatchVisual> MarkerBatchVisualPtr;
+
+  /// \def MarkerBatch_M
+  /// \brief Map of bulk markers. The key is a marker namespace, the value
+  /// is the batch of the namespace.
+  typedef std::map<std::string, MarkerBatchVisualPtr> MarkerBatch_M;
+
+  /// \def MarkerBatchMsgs_L
+  /// \brief List of bulk marker messages.
+  typedef std::list<ignition::msgs::Marker_V> MarkerBatchMsgs_L;
+
   /// \brief Process a marker message.
   /// \param[in] _msg The message data.
   /// \return True if the marker was processed successfully.
   public: bool ProcessMarkerMsg(const ignition::msgs::Marker &_msg);
 
+  /// \brief Process a bulk marker message.
+  /// \param[in] _msg The message data.
+  /// \return True if the markers were processed successfully.
+  public: bool ProcessMarkerBatchMsg(const ignition::msgs::Marker_V &_msg);
+
+  /// \brief Remove the batch of a namespace.
+  /// \param[in] _iter Iterator to the batch.
+  /// \return Iterator to the next batch.
+  public: MarkerBatch_M::iterator RemoveBatch(MarkerBatch_M::iterator _iter);
+
   /// \brief Update the markers. This function is called on
   /// the PreRender event.
   public: void OnPreRender();
@@ -64,6 +88,10 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \param[in] _req The marker message.
   public: void OnMarkerMsg(const ignition::msgs::Marker &_req);
 
+  /// \brief Callback that receives bulk marker messages.
+  /// \param[in] _req The markers.
+  public: void OnMarkerBatchMsg(const ignition::msgs::Marker_V &_req);
+
   /// \brief Service callback that returns a list of markers.
   /// \param[out] _rep Service reply
   /// \return True on success.
@@ -85,6 +113,12 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \brief List of marker message to process.
   public: MarkerMsgs_L markerMsgs;
 
+  /// \brief Bulk markers, by namespace
+  public: MarkerBatch_M batches;
+
+  /// \brief List of bulk marker messages to process.
+  public: MarkerBatchMsgs_L batchMsgs;
+
   /// \brief Pointer to the scene
   public: Scene *scene = nullptr;
 
@@ -142,6 +176,13 @@ bool MarkerManager::Init(Scene *_scene)
     gzerr << "Unable to advertise to the /marker service.\n";
   }
 
+  // Advertise to the bulk marker service
+  if (!this->dataPtr->node.Advertise("/marker/bulk",
+        &MarkerManagerPrivate::OnMarkerBatchMsg, this->dataPtr.get()))
+  {
+    gzerr << "Unable to advertise to the /marker/bulk service.\n";
+  }
+
   this->dataPtr->gznode = transport::NodePtr(new transport::Node());
   this->dataPtr->gznode->Init();
 
@@ -168,6 +209,11 @@ void MarkerManagerPrivate::OnPreRender()
     this->markerMsgs.erase(markerIter++);
   }
 
+  // Process the bulk marker messages.
+  for (const auto &msg : this->batchMsgs)
+    this->ProcessMarkerBatchMsg(msg);
+  this->batchMsgs.clear();
+
   // Erase any markers that have a lifetime.
   for (auto mit = this->markers.begin();
        mit != this->markers.end();)
@@ -195,6 +241,19 @@ void MarkerManagerPrivate::OnPreRender()
     else
       ++mit;
   }
+
+  // Erase any batches that have a lifetime.
+  for (auto bit = this->batches.begin(); bit != this->batches.end();)
+  {
+    if (bit->second->Lifetime() != common::Time::Zero &&
+        (bit->second->Lifetime() <= this->simTime ||
+        this->simTime < this->lastSimTime))
+    {
+      bit = this->RemoveBatch(bit);
+    }
+    else
+      ++bit;
+  }
   this->lastSimTime = this->simTime;
 }
 
@@ -284,9 +343,26 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
   // Remove all markers, or all markers in a namespace
   else if (_msg.action() == ignition::msgs::Marker::DELETE_ALL)
   {
+    // Bulk markers are removed as well
+    bool batchFound = false;
+    for (auto batchIter = this->batches.begin();
+         batchIter != this->batches.end();)
+    {
+      if (ns.empty() || batchIter->first == ns)
+      {
+        batchIter = this->RemoveBatch(batchIter);
+        batchFound = true;
+      }
+      else
+        ++batchIter;
+    }
+
     // If given namespace doesn't exist
     if (!ns.empty() && nsIter == this->markers.end())
     {
+      if (batchFound)
+        return true;
+
       gzwarn << "Unable to delete all markers in namespace[" << ns <<
           "], namespace can't be found." << std::endl;
       return false;
@@ -326,6 +402,50 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
   return true;
 }
 
+//////////////////////////////////////////////////
+bool MarkerManagerPrivate::ProcessMarkerBatchMsg(
+    const ignition::msgs::Marker_V &_msg)
+{
+  if (_msg.marker_size() == 0)
+    return true;
+
+  // All the markers of a message belong to the namespace of the first one
+  const std::string &ns = _msg.marker(0).ns();
+  auto batchIter = this->batches.find(ns);
+
+  // Remove the batch
+  if (_msg.marker_size() == 1 &&
+      _msg.marker(0).action() == ignition::msgs::Marker::DELETE_ALL)
+  {
+    if (batchIter == this->batches.end())
+    {
+      gzwarn << "Unable to delete all bulk markers in namespace[" << ns <<
+          "], namespace can't be found." << std::endl;
+      return false;
+    }
+    this->RemoveBatch(batchIter);
+    return true;
+  }
+
+  if (batchIter == this->batches.end())
+  {
+    MarkerBatchVisualPtr batch(new MarkerBatchVisual(
+          "__GZ_MARKER_BATCH_VISUAL_" + ns, this->scene->WorldVisual()));
+    batchIter = this->batches.insert(std::make_pair(ns, batch)).first;
+  }
+
+  return batchIter->second->Load(_msg);
+}
+
+//////////////////////////////////////////////////
+MarkerManagerPrivate::MarkerBatch_M::iterator
+MarkerManagerPrivate::RemoveBatch(MarkerBatch_M::iterator _iter)
+{
+  _iter->second->Fini();
+  this->scene->RemoveVisual(_iter->second);
+  return this->batches.erase(_iter);
+}
+
 /////////////////////////////////////////////////
 void MarkerManagerPrivate::OnMarkerMsg(const ignition::msgs::Marker &_req)
 {
@@ -333,6 +453,14 @@ void MarkerManagerPrivate::OnMarkerMsg(const ignition::msgs::Marker &_req)
   this->markerMsgs.push_back(_req);
 }
 
+/////////////////////////////////////////////////
+void MarkerManagerPrivate::OnMarkerBatchMsg(
+    const ignition::msgs::Marker_V &_req)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->batchMsgs.push_back(_req);
+}
+
 /////////////////////////////////////////////////
 bool MarkerManagerPrivate::OnList(ignition::msgs::Marker_V &_rep)
 {
@@ -353,6 +481,9 @@ bool MarkerManagerPrivate::OnList(ignition::msgs::Marker_V &_rep)
     }
   }
 
+  for (const auto &batch : this->batches)
+    batch.second->FillMsg(batch.first, _rep);
+
   return true;
 }
 
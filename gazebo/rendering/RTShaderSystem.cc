@@ -16,6 +16,10 @@
 */
 
 #include <sys/stat.h>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
 #include <boost/filesystem.hpp>
 
 #if defined(HAVE_OPENGL)
@@ -46,6 +50,42 @@
 #include "gazebo/rendering/RTShaderSystem.hh"
 
 #define MINOR_VERSION 7
+
+/// \brief Name of the compiled program cache file in the shader cache.
+static const char *MICROCODE_CACHE_FILE = "microcode.cache";
+
+//////////////////////////////////////////////////
+/// \brief Get the shader cache directory of the current GPU and driver.
+/// Shaders are cached in ~/.gazebo/shader_cache, or in the directory set
+/// by the GAZEBO_SHADER_CACHE_PATH environment variable, in a sub
+/// directory keyed by the render system, GPU, driver and Ogre version, so
+/// a cache is never used with another driver.
+/// \return The directory, which ends with a separator.
+static std::string ShaderCacheDir()
+{
+  const Ogre::RenderSystem *renderSys =
+      Ogre::Root::getSingleton().getRenderSystem();
+  const Ogre::RenderSystemCapabilities *capabilities =
+      renderSys->getCapabilities();
+
+  std::ostringstream key;
+  key << renderSys->getName() << "|" << OGRE_VERSION;
+  if (capabilities)
+  {
+    key << "|" << capabilities->getDeviceName()
+        << "|" << capabilities->vendorToString(capabilities->getVendor())
+        << "|" << capabilities->getDriverVersion().toString();
+  }
+
+  const char *env = getenv("GAZEBO_SHADER_CACHE_PATH");
+  boost::filesystem::path path = env ? env :
+      gazebo::common::SystemPaths::Instance()->GetLogPath() + "/shader_cache";
+
+  std::ostringstream dir;
+  dir << std::hex << std::hash<std::string>()(key.str());
+  path /= dir.str();
+  return path.make_preferred().string() + "/";
+}
 using namespace gazebo;
 using namespace rendering;
 
@@ -57,6 +97,10 @@ RTShaderSystem::RTShaderSystem()
   this->dataPtr->shadowsApplied = false;
   this->dataPtr->pssmSetup.setNull();
   this->dataPtr->updateShaders = false;
+
+  const char *cacheSize = getenv("GAZEBO_SHADOW_CACHE_SIZE");
+  if (cacheSize)
+    this->dataPtr->shadowCacheSize = std::strtoul(cacheSize, nullptr, 10);
 }
 
 //////////////////////////////////////////////////
@@ -96,6 +140,35 @@ void RTShaderSystem::Init()
 
     // Set shader cache path.
     this->dataPtr->shaderGenerator->setShaderCachePath(cachePath);
+    this->dataPtr->cachePath = cachePath;
+
+#if OGRE_VERSION >= ((1 << 16) | (9 << 8) | 0)
+    // Reuse the programs compiled on a previous start, where the render
+    // system can read back compiled programs.
+    Ogre::GpuProgramManager &programMgr =
+        Ogre::GpuProgramManager::getSingleton();
+    if (programMgr.canGetCompiledShaderBuffer())
+    {
+      programMgr.setSaveMicrocodesToCache(true);
+
+      std::ifstream file(cachePath + MICROCODE_CACHE_FILE,
+          std::ios::in | std::ios::binary);
+      if (file)
+      {
+        try
+        {
+          Ogre::DataStreamPtr stream(
+              OGRE_NEW Ogre::FileStreamDataStream(&file, false));
+          programMgr.loadMicrocodeCache(stream);
+        }
+        catch(Ogre::Exception &e)
+        {
+          gzwarn << "Unable to load the compiled shader cache in ["
+                 << cachePath << "]: " << e.getDescription() << "\n";
+        }
+      }
+    }
+#endif
 
 #if OGRE_VERSION_MAJOR >= 1 && OGRE_VERSION_MINOR <= 8
     this->dataPtr->programWriterFactory =
@@ -138,6 +211,25 @@ void RTShaderSystem::Fini()
   Ogre::MaterialManager::getSingleton().setActiveScheme(
       Ogre::MaterialManager::DEFAULT_SCHEME_NAME);
 
+#if OGRE_VERSION >= ((1 << 16) | (9 << 8) | 0)
+  // Save the programs compiled in this run for the next start
+  Ogre::GpuProgramManager &programMgr =
+      Ogre::GpuProgramManager::getSingleton();
+  if (!this->dataPtr->cachePath.empty() &&
+      programMgr.getSaveMicrocodesToCache() && programMgr.isCacheDirty())
+  {
+    std::ofstream file(this->dataPtr->cachePath + MICROCODE_CACHE_FILE,
+        std::ios::out | std::ios::binary);
+    if (file)
+    {
+      Ogre::DataStreamPtr stream(
+          OGRE_NEW Ogre::FileStreamDataStream(&file, false));
+      programMgr.saveMicrocodeCache(stream);
+    }
+  }
+#endif
+  this->dataPtr->cachePath.clear();
+
   // Finalize RTShader system.
   if (this->dataPtr->shaderGenerator != NULL)
   {
@@ -261,6 +353,13 @@ void RTShaderSystem::GenerateShaders(const VisualPtr &_vis)
   if (!this->dataPtr->initialized || !_vis)
     return;
 
+  // Visuals that only the GUI shows don't need shaders for other scenes,
+  // such as the sensor only scene of the server.
+  const Visual::VisualType type = _vis->GetType();
+  const bool guiOnly = type == Visual::VT_GUI ||
+      type == Visual::VT_PHYSICS || type == Visual::VT_COLLISION;
+  const ScenePtr visScene = _vis->GetScene();
+
   for (unsigned int k = 0; _vis->GetSceneNode() &&
       k < _vis->GetSceneNode()->numAttachedObjects(); ++k)
   {
@@ -277,6 +376,9 @@ void RTShaderSystem::GenerateShaders(const VisualPtr &_vis)
 
       for (unsigned int s = 0; s < this->dataPtr->scenes.size(); s++)
       {
+        if (guiOnly && this->dataPtr->scenes[s] != visScene)
+          continue;
+
         try
         {
 #if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 10
@@ -426,6 +528,18 @@ bool RTShaderSystem::GetPaths(std::string &coreLibsPath, std::string &cachePath)
         {
           coreLibsPath = (*it)->archive->getName() + "/";
 #endif
+          // setup path name for the persistent rt shader cache
+          cachePath = ShaderCacheDir();
+          boost::system::error_code ec;
+          boost::filesystem::create_directories(cachePath, ec);
+          if (!ec)
+          {
+            coreLibsFound = true;
+            break;
+          }
+          gzwarn << "Unable to create shader cache [" << cachePath << "]: "
+                 << ec.message() << ". Using a temporary cache.\n";
+
           // setup patch name for rt shader cache in tmp
           char *tmpdir;
           char *user;
@@ -593,6 +707,7 @@ void RTShaderSystem::ApplyShadows(ScenePtr _scene)
   cameraSetup->calculateSplitPoints(3, this->dataPtr->shadowNear,
     this->dataPtr->shadowFar, this->dataPtr->shadowSplitLambda);
   cameraSetup->setSplitPadding(this->dataPtr->shadowSplitPadding);
+  cameraSetup->SetStaticCacheSize(this->dataPtr->shadowCacheSize);
 
   sceneMgr->setShadowCameraSetup(this->dataPtr->pssmSetup);
 
@@ -725,3 +840,21 @@ double RTShaderSystem::ShadowSplitPadding() const
 {
   return this->dataPtr->shadowSplitPadding;
 }
+
+/////////////////////////////////////////////////
+void RTShaderSystem::SetShadowCacheSize(const unsigned int _size)
+{
+  this->dataPtr->shadowCacheSize = _size;
+
+  CustomPSSMShadowCameraSetup *cameraSetup =
+      dynamic_cast<CustomPSSMShadowCameraSetup *>(
+      this->dataPtr->pssmSetup.get());
+  if (cameraSetup)
+    cameraSetup->SetStaticCacheSize(_size);
+}
+
+/////////////////////////////////////////////////
+unsigned int RTShaderSystem::ShadowCacheSize() const
+{
+  return this->dataPtr->shadowCacheSize;
+}
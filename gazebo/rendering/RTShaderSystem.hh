@@ -166,6 +166,19 @@ namespace gazebo
       /// \return PSSM split point overlap.
       public: double ShadowSplitPadding() const;
 
+      /// \brief Set the number of shadow maps of static casters that are
+      /// cached, see CustomPSSMShadowCameraSetup::SetStaticCacheSize. The
+      /// default is taken from the GAZEBO_SHADOW_CACHE_SIZE environment
+      /// variable, 0 if unset.
+      /// \param[in] _size Number of cached shadow maps, 0 to disable the
+      /// cache.
+      public: void SetShadowCacheSize(const unsigned int _size);
+
+      /// \brief Get the number of shadow maps of static casters that are
+      /// cached.
+      /// \return Number of cached shadow maps, 0 if disabled.
+      public: unsigned int ShadowCacheSize() const;
+
       /// \brief Get paths for the shader system
       /// \param[out] _coreLibsPath Path to the core libraries.
       /// \param[out] _cachePath Path to where the generated shaders are
@@ -73,12 +73,19 @@ namespace gazebo
       /// \brief Parallel Split Shadow Map (PSSM) overlap between splits.
       public: double shadowSplitPadding = 2.0;
 
+      /// \brief Number of cached shadow maps of static casters.
+      public: unsigned int shadowCacheSize = 0u;
+
       /// \brief Custom program writer factory that supports sampler2DShadow,
       /// only used in ogre versions <= 1.8
       public: CustomGLSLProgramWriterFactory *programWriterFactory = nullptr;
 
       /// \brief Flag to indicate if normal map should be enabled
       public: bool enableNormalMap = true;
+
+      /// \brief Directory of the generated shaders and of the compiled
+      /// program cache of the current GPU and driver.
+      public: std::string cachePath;
     };
   }
 }
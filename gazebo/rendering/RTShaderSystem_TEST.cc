@@ -16,7 +16,12 @@
 */
 
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include <boost/filesystem.hpp>
+#include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/CustomPSSMShadowCameraSetup.hh"
 #include "gazebo/rendering/RTShaderSystem.hh"
 #include "gazebo/test/ServerFixture.hh"
 
@@ -26,6 +31,48 @@ class RTShaderSystem_TEST : public RenderingFixture
 {
 };
 
+#ifdef _WIN32
+static int setenv(const char *envname, const char *envval, int overwrite)
+{
+  char *original = getenv(envname);
+  if (!original || !!overwrite)
+  {
+    std::string envstring = std::string(envname) + "=" + envval;
+    return _putenv(envstring.c_str());
+  }
+  return 0;
+}
+
+static int unsetenv(const char *envname)
+{
+  return _putenv((std::string(envname) + "=").c_str());
+}
+#endif
+
+/// \brief Keeps the shader cache in a temporary directory.
+class RTShaderSystemCache_TEST : public RenderingFixture
+{
+  // Documentation inherited.
+  public: virtual void SetUp()
+  {
+    this->cachePath = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("shader_cache-%%%%%%");
+    setenv("GAZEBO_SHADER_CACHE_PATH", this->cachePath.string().c_str(), 1);
+    RenderingFixture::SetUp();
+  }
+
+  // Documentation inherited.
+  protected: virtual void TearDown()
+  {
+    RenderingFixture::TearDown();
+    unsetenv("GAZEBO_SHADER_CACHE_PATH");
+    boost::filesystem::remove_all(this->cachePath);
+  }
+
+  /// \brief Directory of the shader cache.
+  protected: boost::filesystem::path cachePath;
+};
+
 /////////////////////////////////////////////////
 TEST_F(RTShaderSystem_TEST, Shadows)
 {
@@ -55,6 +102,95 @@ TEST_F(RTShaderSystem_TEST, Shadows)
   EXPECT_DOUBLE_EQ(4.8, shaderSys->ShadowSplitPadding());
 }
 
+/////////////////////////////////////////////////
+TEST_F(RTShaderSystem_TEST, ShadowCache)
+{
+  Load("worlds/shapes.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  scene->SetShadowsEnabled(true);
+  EXPECT_TRUE(scene->ShadowsEnabled());
+
+  rendering::RTShaderSystem *shaderSys =
+      rendering::RTShaderSystem::Instance();
+
+  shaderSys->SetShadowCacheSize(6u);
+  EXPECT_EQ(6u, shaderSys->ShadowCacheSize());
+
+  rendering::CustomPSSMShadowCameraSetup *cameraSetup =
+      dynamic_cast<rendering::CustomPSSMShadowCameraSetup *>(
+      shaderSys->GetPSSMShadowCameraSetup());
+  ASSERT_TRUE(cameraSetup != nullptr);
+  EXPECT_EQ(6u, cameraSetup->StaticCacheSize());
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("shadow_cache_camera", false);
+  ASSERT_TRUE(camera != nullptr);
+  camera->Load();
+  camera->Init();
+  camera->CreateRenderTexture("shadow_cache_render_target");
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 2, 0, 0.3, 0));
+
+  // Nothing moves, the cascades are cached once they repeat and then
+  // restored
+  const uint64_t hits = cameraSetup->StaticCacheHits();
+  for (unsigned int i = 0; i < 10u; ++i)
+  {
+    scene->PreRender();
+    camera->Render(true);
+    camera->PostRender();
+  }
+  EXPECT_GT(cameraSetup->StaticCacheHits(), hits);
+
+  shaderSys->SetShadowCacheSize(0u);
+  EXPECT_EQ(0u, shaderSys->ShadowCacheSize());
+  EXPECT_EQ(0u, cameraSetup->StaticCacheSize());
+
+  scene->RemoveCamera(camera->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_F(RTShaderSystemCache_TEST, CachePath)
+{
+  Load("worlds/shapes.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("shader_cache_camera", false);
+  ASSERT_TRUE(camera != nullptr);
+  camera->Load();
+  camera->Init();
+  camera->CreateRenderTexture("shader_cache_render_target");
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 2, 0, 0.3, 0));
+  scene->PreRender();
+  camera->Render(true);
+  camera->PostRender();
+
+  // The generated shaders are in one directory for this GPU and driver
+  ASSERT_TRUE(boost::filesystem::is_directory(this->cachePath));
+  unsigned int dirs = 0;
+  unsigned int files = 0;
+  for (boost::filesystem::directory_iterator dir(this->cachePath);
+       dir != boost::filesystem::directory_iterator(); ++dir)
+  {
+    ASSERT_TRUE(boost::filesystem::is_directory(dir->path()));
+    ++dirs;
+    for (boost::filesystem::directory_iterator file(dir->path());
+         file != boost::filesystem::directory_iterator(); ++file)
+    {
+      ++files;
+    }
+  }
+  EXPECT_EQ(1u, dirs);
+  EXPECT_GT(files, 0u);
+
+  scene->RemoveCamera(camera->Name());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -72,41 +72,55 @@ bool RayQuery::SelectMeshTriangle(const int _x, const int _y,
 
   for (unsigned int i = 0; i < visuals.size(); ++i)
   {
+    Ogre::SceneNode *node = visuals[i]->GetSceneNode();
+
+    // Skip visuals whose bounds the ray misses, without going through
+    // their triangles. The bounds are derived from the current transform,
+    // since the visual may have moved since it was last rendered.
+    Ogre::AxisAlignedBox box;
+    for (unsigned short j = 0; j < node->numAttachedObjects(); ++j)
+      box.merge(node->getAttachedObject(j)->getWorldBoundingBox(true));
+    if (box.isFinite() && !Ogre::Math::intersects(ray, box).first)
+      continue;
+
     const common::Mesh *mesh =
         common::MeshManager::Instance()->GetMesh(visuals[i]->GetMeshName());
 
     if (!mesh)
       continue;
 
-    Ogre::Matrix4 transform = visuals[i]->GetSceneNode()->_getFullTransform();
-    // test for hitting individual triangles on the mesh
+    // Test the triangles in the frame of the mesh, so that only the ray is
+    // transformed instead of every vertex. The direction isn't normalized,
+    // so distances along the ray are the same in both frames.
+    const Ogre::Matrix4 &transform = node->_getFullTransform();
+    const Ogre::Matrix4 inverse = transform.inverseAffine();
+    Ogre::Matrix3 inverseLinear;
+    inverse.extract3x3Matrix(inverseLinear);
+    const Ogre::Ray localRay(inverse.transformAffine(ray.getOrigin()),
+        inverseLinear * ray.getDirection());
+
+    const common::SubMesh *closestSubMesh = nullptr;
+    unsigned int closestIndex = 0;
+
     for (unsigned int j = 0; j < mesh->GetSubMeshCount(); ++j)
     {
       const common::SubMesh *submesh = mesh->GetSubMesh(j);
       if (submesh->GetVertexCount() < 3u)
         continue;
       unsigned int indexCount = submesh->GetIndexCount();
-      for (unsigned int k = 0; k < indexCount; k += 3)
+      for (unsigned int k = 0; k + 2 < indexCount; k += 3)
       {
-        if (indexCount <= k+2)
-          continue;
-
-        ignition::math::Vector3d vertexA =
-          submesh->Vertex(submesh->GetIndex(k));
-        ignition::math::Vector3d vertexB =
-          submesh->Vertex(submesh->GetIndex(k+1));
-        ignition::math::Vector3d vertexC =
-          submesh->Vertex(submesh->GetIndex(k+2));
-
-        Ogre::Vector3 worldVertexA = transform * Conversions::Convert(vertexA);
-        Ogre::Vector3 worldVertexB = transform * Conversions::Convert(vertexB);
-        Ogre::Vector3 worldVertexC = transform * Conversions::Convert(vertexC);
+        const Ogre::Vector3 vertexA = Conversions::Convert(
+            submesh->Vertex(submesh->GetIndex(k)));
+        const Ogre::Vector3 vertexB = Conversions::Convert(
+            submesh->Vertex(submesh->GetIndex(k+1)));
+        const Ogre::Vector3 vertexC = Conversions::Convert(
+            submesh->Vertex(submesh->GetIndex(k+2)));
 
         // check for a hit against this triangle
-        std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(ray,
-            worldVertexA, worldVertexB, worldVertexC,
-           (worldVertexB - worldVertexA).crossProduct(
-           worldVertexC - worldVertexA));
+        std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(localRay,
+            vertexA, vertexB, vertexC,
+            (vertexB - vertexA).crossProduct(vertexC - vertexA));
 
         // if it was a hit check if its the closest
         if (hit.first &&
@@ -114,14 +128,24 @@ bool RayQuery::SelectMeshTriangle(const int _x, const int _y,
         {
           // this is the closest so far, save it off
           closestDistance = hit.second;
-          vertices.clear();
-          vertices.push_back(worldVertexA);
-          vertices.push_back(worldVertexB);
-          vertices.push_back(worldVertexC);
+          closestSubMesh = submesh;
+          closestIndex = k;
           newClosestFound = true;
         }
       }
     }
+
+    // Only the closest triangle of the visual is transformed to the world
+    if (closestSubMesh)
+    {
+      vertices.clear();
+      for (unsigned int k = 0; k < 3u; ++k)
+      {
+        vertices.push_back(transform * Conversions::Convert(
+            closestSubMesh->Vertex(closestSubMesh->GetIndex(
+            closestIndex + k))));
+      }
+    }
   }
 
   // if we found a new closest raycast for this object, update the
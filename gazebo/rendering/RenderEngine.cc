@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <cstdlib>
 #include <string>
 #include <iostream>
 #include <functional>
@@ -35,6 +36,11 @@
 
 #include "gazebo/gazebo_config.h"
 
+#ifdef HAVE_EGL
+# include <EGL/egl.h>
+# include <EGL/eglext.h>
+#endif
+
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
@@ -54,6 +60,42 @@
 using namespace gazebo;
 using namespace rendering;
 
+#ifdef HAVE_EGL
+/// \brief Maximum number of EGL devices to look at.
+static const EGLint MAX_EGL_DEVICES = 16;
+
+//////////////////////////////////////////////////
+/// \brief Get the EGL display of a GPU device, without a display server.
+/// \param[in] _device Index of the device. Device 0 is used if there is no
+/// such device.
+/// \return The display of the device, or the default EGL display if the
+/// EGL device extensions are not available.
+static EGLDisplay EGLDeviceDisplay(unsigned int _device)
+{
+  auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(
+      eglGetProcAddress("eglQueryDevicesEXT"));
+  auto platformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+      eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+  EGLDeviceEXT devices[MAX_EGL_DEVICES];
+  EGLint count = 0;
+  if (!queryDevices || !platformDisplay ||
+      !queryDevices(MAX_EGL_DEVICES, devices, &count) || count <= 0)
+  {
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+
+  if (_device >= static_cast<unsigned int>(count))
+  {
+    gzwarn << "EGL device [" << _device << "] not found, only " << count
+           << " devices are available. Using device 0.\n";
+    _device = 0;
+  }
+
+  return platformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[_device], nullptr);
+}
+#endif
+
 //////////////////////////////////////////////////
 RenderEngine::RenderEngine()
   : dataPtr(new RenderEnginePrivate)
@@ -84,7 +126,8 @@ void RenderEngine::Load()
 {
   if (!this->CreateContext())
   {
-    gzwarn << "Unable to create X window. Rendering will be disabled\n";
+    gzwarn << "Unable to create a rendering context. "
+           << "Rendering will be disabled\n";
     return;
   }
 
@@ -141,9 +184,15 @@ void RenderEngine::Load()
   // Create a 1x1 render window so that we can grab a GL context. Based on
   // testing, this is a hard requirement by Apple. We also need it to
   // properly initialize GLWidget and UserCameras. See the GLWidget
-  // constructor.
-  this->dataPtr->windowManager->CreateWindow(
-      std::to_string(this->dummyWindowId), 1, 1);
+  // constructor. Without a display server there is no window to parent
+  // to, and the window uses the current EGL context instead.
+  if (this->dataPtr->eglContext)
+    this->dataPtr->windowManager->CreateWindow("", 1, 1);
+  else
+  {
+    this->dataPtr->windowManager->CreateWindow(
+        std::to_string(this->dummyWindowId), 1, 1);
+  }
 
   this->CheckSystemCapabilities();
 }
@@ -277,6 +326,13 @@ void RenderEngine::PostRender()
   // a regression.
   this->dataPtr->root->_fireFrameRenderingQueued();
   this->dataPtr->root->_fireFrameEnded();
+
+  if (common::MemoryAccounting::Enabled())
+  {
+    this->dataPtr->memory.Set(
+        Ogre::TextureManager::getSingleton().getMemoryUsage() +
+        Ogre::MeshManager::getSingleton().getMemoryUsage());
+  }
 }
 
 //////////////////////////////////////////////////
@@ -386,6 +442,22 @@ void RenderEngine::Fini()
   }
 # endif
 
+#ifdef HAVE_EGL
+  if (this->dataPtr->eglDisplay)
+  {
+    eglMakeCurrent(this->dataPtr->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+        EGL_NO_CONTEXT);
+    if (this->dataPtr->eglContext)
+      eglDestroyContext(this->dataPtr->eglDisplay, this->dataPtr->eglContext);
+    if (this->dataPtr->eglSurface)
+      eglDestroySurface(this->dataPtr->eglDisplay, this->dataPtr->eglSurface);
+    eglTerminate(this->dataPtr->eglDisplay);
+    this->dataPtr->eglContext = nullptr;
+    this->dataPtr->eglSurface = nullptr;
+    this->dataPtr->eglDisplay = nullptr;
+  }
+#endif
+
   this->dataPtr->initialized = false;
 }
 
@@ -736,6 +808,15 @@ bool RenderEngine::CreateContext()
 #if defined __APPLE__ || _WIN32
   this->dummyDisplay = 0;
 #else
+#ifdef HAVE_EGL
+  // Render through EGL when there is no display server, or when a GPU
+  // device is requested explicitly.
+  const char *display = std::getenv("DISPLAY");
+  const char *device = std::getenv("GAZEBO_EGL_DEVICE");
+  if (!display || std::string(display).empty() || device)
+    return this->CreateEGLContext(device ? device : "0");
+#endif
+
   try
   {
     this->dummyDisplay = XOpenDisplay(0);
@@ -787,6 +868,74 @@ bool RenderEngine::CreateContext()
   return result;
 }
 
+/////////////////////////////////////////////////
+bool RenderEngine::CreateEGLContext(const std::string &_device)
+{
+#ifdef HAVE_EGL
+  unsigned int deviceIndex = 0;
+  try
+  {
+    deviceIndex = std::stoul(_device);
+  }
+  catch(...)
+  {
+    gzwarn << "Invalid EGL device [" << _device << "]. Using device 0.\n";
+  }
+
+  EGLDisplay display = EGLDeviceDisplay(deviceIndex);
+  EGLint major, minor;
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+  {
+    gzerr << "Unable to initialize EGL\n";
+    return false;
+  }
+
+  const EGLint configAttribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+    EGL_DEPTH_SIZE, 16, EGL_STENCIL_SIZE, 8,
+    EGL_NONE};
+
+  EGLConfig config;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) ||
+      configCount == 0 || !eglBindAPI(EGL_OPENGL_API))
+  {
+    gzerr << "Unable to find an EGL config for OpenGL\n";
+    eglTerminate(display);
+    return false;
+  }
+
+  // Terminating the display releases the surface and context too
+  const EGLint surfaceAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+  EGLSurface surface = eglCreatePbufferSurface(display, config,
+      surfaceAttribs);
+  EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT,
+      nullptr);
+
+  if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(display, surface, surface, context))
+  {
+    gzerr << "Unable to create EGL context\n";
+    eglTerminate(display);
+    return false;
+  }
+
+  this->dataPtr->eglDisplay = display;
+  this->dataPtr->eglSurface = surface;
+  this->dataPtr->eglContext = context;
+
+  gzmsg << "Rendering without a display server on EGL device ["
+        << deviceIndex << "], EGL " << major << "." << minor << "\n";
+  return true;
+#else
+  gzerr << "Unable to use EGL device [" << _device
+        << "]. Gazebo was built without EGL.\n";
+  return false;
+#endif
+}
+
 /////////////////////////////////////////////////
 void RenderEngine::CheckSystemCapabilities()
 {
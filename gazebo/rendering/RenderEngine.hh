@@ -147,6 +147,13 @@ namespace gazebo
       /// \return True if the context was created.
       private: bool CreateContext();
 
+      /// \brief Create an EGL render context on a GPU device, which doesn't
+      /// need a display server. This is used when DISPLAY is not set, or
+      /// when the GAZEBO_EGL_DEVICE environment variable selects a device.
+      /// \param[in] _device Index of the EGL device, as a string.
+      /// \return True if the context was created.
+      private: bool CreateEGLContext(const std::string &_device);
+
       /// \brief Load all OGRE plugins.
       private: void LoadPlugins();
 
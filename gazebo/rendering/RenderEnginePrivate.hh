@@ -20,6 +20,7 @@
 
 #include <vector>
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/MemoryAccounting.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/RenderTypes.hh"
@@ -67,6 +68,21 @@ namespace gazebo
       /// \brief A list of supported fsaa levels
       public: std::vector<unsigned int> fsaaLevels;
 
+      /// \brief Memory of the Ogre textures and meshes, updated after
+      /// each frame.
+      public: common::MemoryAccounting::Account memory{
+                  common::MemoryAccounting::RENDERING};
+
+      /// \brief EGL display used when rendering without a display server.
+      public: void *eglDisplay = nullptr;
+
+      /// \brief EGL pbuffer surface used when rendering without a display
+      /// server.
+      public: void *eglSurface = nullptr;
+
+      /// \brief EGL context used when rendering without a display server.
+      public: void *eglContext = nullptr;
+
 #if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 9
       /// \brief Ogre overlay system needed for initialization of Ogre
       public: Ogre::OverlaySystem *overlaySystem;
@@ -16,7 +16,10 @@
 */
 
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include "gazebo/gazebo_config.h"
 #include "gazebo/test/ServerFixture.hh"
+#include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/RenderEngine.hh"
 
 using namespace gazebo;
@@ -24,6 +27,26 @@ class RenderEngine_TEST : public RenderingFixture
 {
 };
 
+#if defined(HAVE_EGL) && !defined(_WIN32) && !defined(__APPLE__)
+/// \brief Loads the render engine on an EGL device that doesn't exist.
+class RenderEngineEGL_TEST : public RenderingFixture
+{
+  // Documentation inherited.
+  public: virtual void SetUp()
+  {
+    setenv("GAZEBO_EGL_DEVICE", "99", 1);
+    RenderingFixture::SetUp();
+  }
+
+  // Documentation inherited.
+  protected: virtual void TearDown()
+  {
+    RenderingFixture::TearDown();
+    unsetenv("GAZEBO_EGL_DEVICE");
+  }
+};
+#endif
+
 /////////////////////////////////////////////////
 TEST_F(RenderEngine_TEST, FSAATest)
 {
@@ -50,6 +73,51 @@ TEST_F(RenderEngine_TEST, FSAATest)
   }
 }
 
+#if defined(HAVE_EGL) && !defined(_WIN32) && !defined(__APPLE__)
+/////////////////////////////////////////////////
+/// \brief Render through EGL, which falls back to the first device when
+/// the requested one doesn't exist.
+TEST_F(RenderEngineEGL_TEST, Render)
+{
+  Load("worlds/shapes.world");
+
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No EGL device, unable to run the EGL test\n";
+    return;
+  }
+
+  rendering::ScenePtr scene = rendering::get_scene("default");
+  if (!scene)
+    scene = rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera = scene->CreateCamera("egl_camera", false);
+  ASSERT_TRUE(camera != nullptr);
+  camera->Load();
+  camera->Init();
+  camera->CreateRenderTexture("egl_camera_render_target");
+  camera->SetCaptureData(true);
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 2, 0, 0.3, 0));
+
+  scene->PreRender();
+  camera->Render(true);
+  camera->PostRender();
+
+  // Something other than the clear color was rendered
+  const unsigned char *image = camera->ImageData();
+  ASSERT_TRUE(image != nullptr);
+  bool differs = false;
+  const unsigned int size = camera->ImageMemorySize();
+  for (unsigned int i = 1; i < size && !differs; ++i)
+    differs = image[i] != image[0];
+  EXPECT_TRUE(differs);
+
+  scene->RemoveCamera(camera->Name());
+}
+#endif
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
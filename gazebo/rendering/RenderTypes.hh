@@ -37,6 +37,11 @@
 /// \brief Render visuals that are selectable mask.
 #define GZ_VISIBILITY_SELECTABLE      0x00000002
 
+/// \def GZ_VISIBILITY_SHADOW_DYNAMIC
+/// \brief Set on the shadow casters drawn over cached shadow maps, see
+/// CustomPSSMShadowCameraSetup.
+#define GZ_VISIBILITY_SHADOW_DYNAMIC  0x20000000
+
 namespace gazebo
 {
   namespace rendering
@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cstdlib>
+#include <string>
 #include <boost/thread.hpp>
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
@@ -25,6 +28,16 @@
 using namespace gazebo;
 
 bool g_lockstep = false;
+bool g_shareMaterials = false;
+double g_sceneMessageBudget = -1;
+bool g_poseInterpolation = false;
+bool g_sensorOnlyScenes = false;
+bool g_remoteClient = false;
+bool g_compactPoses = false;
+
+/// \brief Default wall time a client scene may spend on each frame
+/// processing queued messages.
+static const double DEFAULT_SCENE_MESSAGE_BUDGET = 0.02;
 
 //////////////////////////////////////////////////
 bool rendering::load()
@@ -148,3 +161,107 @@ bool rendering::lockstep_enabled()
 {
   return g_lockstep;
 }
+
+//////////////////////////////////////////////////
+void rendering::set_share_materials(const bool _enable)
+{
+  g_shareMaterials = _enable;
+}
+
+//////////////////////////////////////////////////
+bool rendering::share_materials()
+{
+  if (g_shareMaterials)
+    return true;
+
+  const char *env = getenv("GAZEBO_SHARE_MATERIALS");
+  return env && std::string(env) == "1";
+}
+
+//////////////////////////////////////////////////
+void rendering::set_scene_message_budget(const double _budget)
+{
+  g_sceneMessageBudget = std::max(0.0, _budget);
+}
+
+//////////////////////////////////////////////////
+double rendering::scene_message_budget()
+{
+  if (g_sceneMessageBudget >= 0)
+    return g_sceneMessageBudget;
+
+  const char *env = getenv("GAZEBO_SCENE_MESSAGE_BUDGET");
+  if (env)
+  {
+    const double budget = atof(env);
+    if (budget >= 0)
+      return budget;
+    gzerr << "Invalid GAZEBO_SCENE_MESSAGE_BUDGET value [" << env
+          << "], using the default budget\n";
+  }
+  return DEFAULT_SCENE_MESSAGE_BUDGET;
+}
+
+//////////////////////////////////////////////////
+void rendering::set_pose_interpolation(const bool _enable)
+{
+  g_poseInterpolation = _enable;
+}
+
+//////////////////////////////////////////////////
+bool rendering::pose_interpolation()
+{
+  if (g_poseInterpolation || rendering::remote_client())
+    return true;
+
+  const char *env = getenv("GAZEBO_POSE_INTERPOLATION");
+  return env && std::string(env) == "1";
+}
+
+//////////////////////////////////////////////////
+void rendering::set_remote_client(const bool _enable)
+{
+  g_remoteClient = _enable;
+}
+
+//////////////////////////////////////////////////
+bool rendering::remote_client()
+{
+  if (g_remoteClient)
+    return true;
+
+  const char *env = getenv("GAZEBO_REMOTE_CLIENT");
+  return env && std::string(env) == "1";
+}
+
+//////////////////////////////////////////////////
+void rendering::set_sensor_only_scenes(const bool _enable)
+{
+  g_sensorOnlyScenes = _enable;
+}
+
+//////////////////////////////////////////////////
+bool rendering::sensor_only_scenes()
+{
+  if (g_sensorOnlyScenes)
+    return true;
+
+  const char *env = getenv("GAZEBO_SENSOR_ONLY_SCENES");
+  return env && std::string(env) == "1";
+}
+
+//////////////////////////////////////////////////
+void rendering::set_compact_poses(const bool _enable)
+{
+  g_compactPoses = _enable;
+}
+
+//////////////////////////////////////////////////
+bool rendering::compact_poses()
+{
+  if (g_compactPoses || rendering::remote_client())
+    return true;
+
+  const char *env = getenv("GAZEBO_COMPACT_POSES");
+  return env && std::string(env) == "1";
+}
@@ -71,6 +71,112 @@ namespace gazebo
     GZ_RENDERING_VISIBLE
     bool lockstep_enabled();
 
+    /// \brief Set whether the visuals of links share their materials with
+    /// the visuals that look the same, instead of each cloning its own.
+    /// Sharing keeps the number of materials, and the render state changes
+    /// between the draw calls, small when a world repeats a model many
+    /// times. A visual which changes its material, e.g. its colors or
+    /// transparency, moves to a material shared by the visuals with the
+    /// same changes. Code that modifies the Ogre material of a visual
+    /// directly must not enable this. This can also be enabled by setting
+    /// the GAZEBO_SHARE_MATERIALS environment variable to 1.
+    /// \param[in] _enable True to share materials, false to clone them.
+    /// Only visuals created afterwards are affected.
+    GZ_RENDERING_VISIBLE
+    void set_share_materials(const bool _enable);
+
+    /// \brief Get whether the visuals of links share their materials.
+    /// \return True if materials are shared.
+    /// \sa set_share_materials
+    GZ_RENDERING_VISIBLE
+    bool share_materials();
+
+    /// \brief Set the wall time a client scene may spend on each frame
+    /// creating the visuals, links and joints of queued messages. The
+    /// messages left are processed on the following frames, so that the
+    /// client stays responsive while a large world is loaded. Scenes of the
+    /// server always process all their messages. This can also be set with
+    /// the GAZEBO_SCENE_MESSAGE_BUDGET environment variable, in seconds.
+    /// \param[in] _budget Budget in seconds, 0 for no limit.
+    GZ_RENDERING_VISIBLE
+    void set_scene_message_budget(const double _budget);
+
+    /// \brief Get the wall time a client scene may spend on each frame
+    /// processing queued messages.
+    /// \return Budget in seconds, 0 for no limit.
+    /// \sa set_scene_message_budget
+    GZ_RENDERING_VISIBLE
+    double scene_message_budget();
+
+    /// \brief Set whether client scenes interpolate the poses of visuals.
+    /// Instead of snapping to each pose received from physics, a visual
+    /// then moves from its current pose to the new pose over the time
+    /// between pose messages, which smooths the motion at the cost of that
+    /// much latency. Scenes of the server never interpolate. This can also
+    /// be enabled by setting the GAZEBO_POSE_INTERPOLATION environment
+    /// variable to 1, and is always enabled for remote clients.
+    /// \param[in] _enable True to interpolate poses.
+    GZ_RENDERING_VISIBLE
+    void set_pose_interpolation(const bool _enable);
+
+    /// \brief Get whether client scenes interpolate the poses of visuals.
+    /// \return True if poses are interpolated.
+    /// \sa set_pose_interpolation
+    GZ_RENDERING_VISIBLE
+    bool pose_interpolation();
+
+    /// \brief Set whether the client is connected to the server over a slow
+    /// network, such as a VPN. Client scenes then ask the server for poses
+    /// at a reduced rate, and only as fast as the link can send them. Scene
+    /// and pose messages are compressed, poses are interpolated, and image
+    /// viewers receive previews at a reduced rate. This can also be enabled
+    /// by setting the GAZEBO_REMOTE_CLIENT environment variable to 1, or
+    /// with the --remote option of gzclient.
+    /// \param[in] _enable True for a remote client.
+    GZ_RENDERING_VISIBLE
+    void set_remote_client(const bool _enable);
+
+    /// \brief Get whether the client is connected to the server over a slow
+    /// network.
+    /// \return True for a remote client.
+    /// \sa set_remote_client
+    GZ_RENDERING_VISIBLE
+    bool remote_client();
+
+    /// \brief Set whether server scenes without visualizations only render
+    /// sensors. Such scenes then skip the visuals that only the GUI needs,
+    /// such as collision, joint, COM, inertia, link frame and contact
+    /// visuals, and the shaders for them. This can also be enabled by
+    /// setting the GAZEBO_SENSOR_ONLY_SCENES environment variable to 1.
+    /// \param[in] _enable True to make server scenes sensor only.
+    /// \sa Scene::SensorOnly
+    GZ_RENDERING_VISIBLE
+    void set_sensor_only_scenes(const bool _enable);
+
+    /// \brief Get whether server scenes without visualizations only render
+    /// sensors.
+    /// \return True if server scenes are sensor only.
+    /// \sa set_sensor_only_scenes
+    GZ_RENDERING_VISIBLE
+    bool sensor_only_scenes();
+
+    /// \brief Set whether client scenes receive compact poses. They then
+    /// subscribe to ~/pose/compact/info instead of ~/pose/info, whose
+    /// poses have no names, quantized positions and packed orientations,
+    /// see msgs::PosesCompact. This can also be enabled by setting the
+    /// GAZEBO_COMPACT_POSES environment variable to 1, and is always
+    /// enabled for remote clients. It must be set before the scenes are
+    /// loaded.
+    /// \param[in] _enable True to receive compact poses.
+    GZ_RENDERING_VISIBLE
+    void set_compact_poses(const bool _enable);
+
+    /// \brief Get whether client scenes receive compact poses.
+    /// \return True if poses are compact.
+    /// \sa set_compact_poses
+    GZ_RENDERING_VISIBLE
+    bool compact_poses();
+
     /// \brief wait until a render request occurs
     /// \param[in] _name Name of the scene to retrieve
     /// \param[in] _timeoutsec timeout expressed in seconds
@@ -15,7 +15,15 @@
  *
 */
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
@@ -29,7 +37,10 @@
 
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Assert.hh"
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/rendering/CustomPSSMShadowCameraSetup.hh"
 #include "gazebo/rendering/Road2d.hh"
 #include "gazebo/rendering/Projector.hh"
 #include "gazebo/rendering/Heightmap.hh"
@@ -75,6 +86,7 @@
 #include "gazebo/rendering/RTShaderSystem.hh"
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Node.hh"
+#include "gazebo/transport/SubscribeOptions.hh"
 
 #include "gazebo/rendering/ScenePrivate.hh"
 #include "gazebo/rendering/Scene.hh"
@@ -88,13 +100,210 @@ using namespace rendering;
 
 uint32_t ScenePrivate::idCounter = 0;
 
-struct VisualMessageLess {
-    bool operator() (boost::shared_ptr<msgs::Visual const> _i,
-                     boost::shared_ptr<msgs::Visual const> _j)
+/// \brief Rate in Hz at which remote clients receive poses, see
+/// rendering::set_remote_client.
+static const double REMOTE_POSE_RATE = 20.0;
+
+/////////////////////////////////////////////////
+void rendering::SortVisualMsgs(VisualMsgs_L &_msgs,
+    const boost::unordered_map<std::string, ignition::math::Vector3d>
+    &_positions, const ignition::math::Vector3d &_position)
+{
+  if (_msgs.size() < 2u)
+    return;
+
+  struct VisualKey
+  {
+    double distance;
+    size_t nameSize;
+    boost::shared_ptr<msgs::Visual const> msg;
+  };
+
+  std::vector<VisualKey> keys;
+  keys.reserve(_msgs.size());
+  for (auto &msg : _msgs)
+  {
+    const std::string &name = msg->name();
+    double distance = 0;
+    auto iter = _positions.find(name.substr(0, name.find("::")));
+    if (iter != _positions.end())
+      distance = (iter->second - _position).SquaredLength();
+    keys.push_back({distance, name.size(), msg});
+  }
+
+  std::stable_sort(keys.begin(), keys.end(),
+      [](const VisualKey &_a, const VisualKey &_b)
+      {
+        if (_a.distance < _b.distance)
+          return true;
+        if (_b.distance < _a.distance)
+          return false;
+        return _a.nameSize < _b.nameSize;
+      });
+
+  _msgs.clear();
+  for (auto &key : keys)
+    _msgs.push_back(std::move(key.msg));
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \brief Thread that loads the meshes of new visuals, so that the
+    /// render thread only creates their Ogre objects. The mesh manager
+    /// parses one mesh at a time, so a single thread is used.
+    class SceneMeshLoader
+    {
+      /// \brief Constructor. Starts the thread.
+      public: SceneMeshLoader();
+
+      /// \brief Destructor. Stops the thread, once the mesh it is loading
+      /// is loaded.
+      public: ~SceneMeshLoader();
+
+      /// \brief Check whether a new visual can be created, and start
+      /// loading its mesh otherwise.
+      /// \param[in] _msg Message of the visual.
+      /// \return True if the visual has no mesh, or its mesh was loaded or
+      /// failed to load.
+      public: bool Ready(const msgs::Visual &_msg);
+
+      /// \brief Loop of the thread.
+      private: void Run();
+
+      /// \brief URIs of the meshes to load, in order.
+      private: std::deque<std::string> queue;
+
+      /// \brief URIs of the meshes queued or being loaded.
+      private: std::set<std::string> pending;
+
+      /// \brief URIs of the meshes that were loaded, or failed to load.
+      private: std::set<std::string> done;
+
+      /// \brief True to stop the thread.
+      private: bool stop = false;
+
+      /// \brief Protects the members above.
+      private: std::mutex mutex;
+
+      /// \brief Notified when a mesh is queued, or to stop.
+      private: std::condition_variable condition;
+
+      /// \brief The thread.
+      private: std::thread thread;
+    };
+  }
+}
+
+/// \brief Visuals with a smaller id are kept in the index of visuals.
+static const uint32_t VISUAL_INDEX_SIZE = 1u << 20;
+
+/// \brief Wall time between publications of the rendering statistics.
+static const common::Time RENDERING_STATS_PERIOD(1.0);
+
+//////////////////////////////////////////////////
+/// \brief Find the entry of a visual in the map of visuals of a scene,
+/// through the index of visuals for small ids.
+/// \param[in] _data Private data of the scene.
+/// \param[in] _id Id of the visual.
+/// \return Entry of the visual, null if there is none.
+static VisualPtr *FindVisual(ScenePrivate *_data, const uint32_t _id)
+{
+  if (_id < _data->visualIndex.size() && _data->visualIndex[_id])
+    return _data->visualIndex[_id];
+
+  auto iter = _data->visuals.find(_id);
+  if (iter == _data->visuals.end())
+    return nullptr;
+
+  // Entries of a map stay in place until they are erased
+  if (_id < VISUAL_INDEX_SIZE)
+  {
+    if (_id >= _data->visualIndex.size())
+      _data->visualIndex.resize(_id + 1, nullptr);
+    _data->visualIndex[_id] = &iter->second;
+  }
+  return &iter->second;
+}
+
+//////////////////////////////////////////////////
+SceneMeshLoader::SceneMeshLoader()
+  : thread(std::bind(&SceneMeshLoader::Run, this))
+{
+}
+
+//////////////////////////////////////////////////
+SceneMeshLoader::~SceneMeshLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->condition.notify_one();
+  this->thread.join();
+}
+
+//////////////////////////////////////////////////
+bool SceneMeshLoader::Ready(const msgs::Visual &_msg)
+{
+  if (!_msg.has_geometry() ||
+      _msg.geometry().type() != msgs::Geometry::MESH ||
+      !_msg.geometry().has_mesh() ||
+      _msg.geometry().mesh().filename().empty())
+  {
+    return true;
+  }
+
+  const std::string &uri = _msg.geometry().mesh().filename();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->done.find(uri) != this->done.end())
+    return true;
+
+  if (this->pending.insert(uri).second)
+  {
+    this->queue.push_back(uri);
+    this->condition.notify_one();
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+void SceneMeshLoader::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->condition.wait(lock, [this]
+        {return this->stop || !this->queue.empty();});
+    if (this->stop)
+      return;
+
+    std::string uri = this->queue.front();
+    this->queue.pop_front();
+    lock.unlock();
+
+    // Errors are reported by the render thread when it creates the visual
+    std::string filename = common::find_file(uri);
+    common::MeshManager *meshManager = common::MeshManager::Instance();
+    if (!filename.empty() && meshManager->IsValidFilename(filename) &&
+        !meshManager->HasMesh(filename))
     {
-      return _i->name().size() < _j->name().size();
+      try
+      {
+        meshManager->Load(filename);
+      }
+      catch(common::Exception &)
+      {
+      }
     }
-} VisualMessageLessOp;
+
+    lock.lock();
+    this->pending.erase(uri);
+    this->done.insert(uri);
+  }
+}
 
 //////////////////////////////////////////////////
 Scene::Scene()
@@ -144,10 +353,23 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
       rendering::Events::ConnectToggleLayer(
         std::bind(&Scene::ToggleLayer, this, std::placeholders::_1)));
 
+  // Remote clients ask for compressed scene messages, and for poses at a
+  // reduced rate. Latest only delivery drops the poses that the link has no
+  // bandwidth for, so the rate also adapts to the throughput of the link.
+  transport::SubscribeOptions sceneLimits;
+  transport::SubscribeOptions poseLimits;
+  if (!_isServer && rendering::remote_client())
+  {
+    sceneLimits.SetCodec("zlib");
+    poseLimits.SetMaxRate(REMOTE_POSE_RATE);
+    poseLimits.SetLatestOnly(true);
+    poseLimits.SetCodec("zlib_delta");
+  }
+
   this->dataPtr->sensorSub = this->dataPtr->node->Subscribe("~/sensor",
                                           &Scene::OnSensorMsg, this, true);
-  this->dataPtr->visSub =
-      this->dataPtr->node->Subscribe("~/visual", &Scene::OnVisualMsg, this);
+  this->dataPtr->visSub = this->dataPtr->node->Subscribe("~/visual",
+      &Scene::OnVisualMsg, this, sceneLimits);
 
   this->dataPtr->lightFactorySub =
       this->dataPtr->node->Subscribe("~/factory/light",
@@ -159,6 +381,11 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
 
   this->dataPtr->isServer = _isServer;
 
+  // Sensors of the server need the meshes of visuals as soon as they are
+  // created, only the client loads them in the background
+  if (!_isServer)
+    this->dataPtr->meshLoader.reset(new SceneMeshLoader());
+
   if (_isServer && !rendering::lockstep_enabled())
   {
     this->dataPtr->poseSub = this->dataPtr->node->Subscribe("~/pose/local/info",
@@ -167,10 +394,15 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
 
   // When ready to use the direct API for updating scene poses from server,
   // uncomment the following line and delete the if and else directly above
-  if (!_isServer)
+  if (!_isServer && rendering::compact_poses())
+  {
+    this->dataPtr->poseSub = this->dataPtr->node->Subscribe(
+        "~/pose/compact/info", &Scene::OnCompactPoseMsg, this, poseLimits);
+  }
+  else if (!_isServer)
   {
     this->dataPtr->poseSub = this->dataPtr->node->Subscribe("~/pose/info",
-        &Scene::OnPoseMsg, this);
+        &Scene::OnPoseMsg, this, poseLimits);
   }
 
   this->dataPtr->jointSub =
@@ -181,7 +413,9 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
   this->dataPtr->skySub =
       this->dataPtr->node->Subscribe("~/sky", &Scene::OnSkyMsg, this);
   this->dataPtr->modelInfoSub = this->dataPtr->node->Subscribe("~/model/info",
-                                             &Scene::OnModelMsg, this);
+      &Scene::OnModelMsg, this, sceneLimits);
+  this->dataPtr->modelInfoVSub = this->dataPtr->node->Subscribe(
+      "~/model/info_v", &Scene::OnModelVMsg, this, sceneLimits);
 
   this->dataPtr->roadSub =
       this->dataPtr->node->Subscribe("~/roads", &Scene::OnRoadMsg, this, true);
@@ -189,13 +423,17 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
   this->dataPtr->requestPub =
       this->dataPtr->node->Advertise<msgs::Request>("~/request");
 
+  this->dataPtr->statsPub =
+      this->dataPtr->node->Advertise<msgs::RenderingStats>(
+      "~/rendering/stats");
+
   this->dataPtr->requestSub = this->dataPtr->node->Subscribe("~/request",
       &Scene::OnRequest, this);
 
   this->dataPtr->responseSub = this->dataPtr->node->Subscribe("~/response",
-      &Scene::OnResponse, this, true);
-  this->dataPtr->sceneSub =
-      this->dataPtr->node->Subscribe("~/scene", &Scene::OnScene, this);
+      &Scene::OnResponse, this, sceneLimits, true);
+  this->dataPtr->sceneSub = this->dataPtr->node->Subscribe("~/scene",
+      &Scene::OnScene, this, sceneLimits);
 
   this->dataPtr->sdf.reset(new sdf::Element);
   sdf::initFile("scene.sdf", this->dataPtr->sdf);
@@ -226,8 +464,10 @@ void Scene::Clear()
   this->dataPtr->requestSub.reset();
   this->dataPtr->responseSub.reset();
   this->dataPtr->modelInfoSub.reset();
+  this->dataPtr->modelInfoVSub.reset();
   this->dataPtr->responsePub.reset();
   this->dataPtr->requestPub.reset();
+  this->dataPtr->statsPub.reset();
   this->dataPtr->roadSub.reset();
 
   if (this->dataPtr->node)
@@ -261,6 +501,7 @@ void Scene::Clear()
     this->RemoveVisual(this->dataPtr->visuals.begin()->first);
 
   this->dataPtr->visuals.clear();
+  this->dataPtr->visualIndex.clear();
 
   if (this->dataPtr->originVisual)
   {
@@ -404,10 +645,13 @@ void Scene::Init()
   // Force shadows on.
   this->SetShadowsEnabled(true);
 
-  // Create origin visual
-  this->dataPtr->originVisual.reset(new OriginVisual("__WORLD_ORIGIN__",
-      this->dataPtr->worldVisual));
-  this->dataPtr->originVisual->Load();
+  // Create origin visual, which sensors never see
+  if (!this->SensorOnly())
+  {
+    this->dataPtr->originVisual.reset(new OriginVisual("__WORLD_ORIGIN__",
+        this->dataPtr->worldVisual));
+    this->dataPtr->originVisual->Load();
+  }
 
   this->dataPtr->requestPub->WaitForConnection();
   this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
@@ -1632,6 +1876,15 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
   std::string modelName, linkName;
 
   modelName = _msg.name() + "::";
+
+  // Keep the positions of the top level models, to create their visuals
+  // by distance to the user camera.
+  if (_msg.has_pose() && _msg.name().find("::") == std::string::npos)
+  {
+    this->dataPtr->modelPositions[_msg.name()] =
+        msgs::ConvertIgn(_msg.pose().position());
+  }
+
   for (int j = 0; j < _msg.visual_size(); ++j)
   {
     boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
@@ -1866,7 +2119,11 @@ void Scene::PreRender()
               std::back_inserter(linkVisualMsgsCopy));
     this->dataPtr->linkVisualMsgs.clear();
 
-    this->dataPtr->visualMsgs.sort(VisualMessageLessOp);
+    // Create the visuals nearest to the user camera first, so that large
+    // worlds appear progressively from the viewpoint.
+    SortVisualMsgs(this->dataPtr->visualMsgs, this->dataPtr->modelPositions,
+        this->dataPtr->userCameras.empty() ? ignition::math::Vector3d::Zero :
+        this->dataPtr->userCameras[0]->WorldPosition());
     std::copy(this->dataPtr->visualMsgs.begin(),
               this->dataPtr->visualMsgs.end(),
               std::back_inserter(visualMsgsCopy));
@@ -1904,8 +2161,20 @@ void Scene::PreRender()
       ++sIter;
   }
 
+  // On the client, stop creating models and visuals once the budget of the
+  // frame is spent. The messages left are processed on the next frames.
+  const double budget =
+      this->dataPtr->isServer ? 0.0 : rendering::scene_message_budget();
+  const common::Time budgetStart = common::Time::GetWallTime();
+  auto withinBudget = [&budget, &budgetStart]()
+  {
+    return budget <= 0 ||
+        (common::Time::GetWallTime() - budgetStart).Double() < budget;
+  };
+
   // Process the model messages.
-  for (modelIter = modelMsgsCopy.begin(); modelIter != modelMsgsCopy.end();)
+  for (modelIter = modelMsgsCopy.begin();
+      modelIter != modelMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessModelMsg(**modelIter))
       modelMsgsCopy.erase(modelIter++);
@@ -1924,7 +2193,7 @@ void Scene::PreRender()
 
   // Process the model visual messages.
   for (visualIter = modelVisualMsgsCopy.begin();
-      visualIter != modelVisualMsgsCopy.end();)
+      visualIter != modelVisualMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_MODEL))
       modelVisualMsgsCopy.erase(visualIter++);
@@ -1934,7 +2203,7 @@ void Scene::PreRender()
 
   // Process the link visual messages.
   for (visualIter = linkVisualMsgsCopy.begin();
-      visualIter != linkVisualMsgsCopy.end();)
+      visualIter != linkVisualMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_LINK))
       linkVisualMsgsCopy.erase(visualIter++);
@@ -1943,7 +2212,8 @@ void Scene::PreRender()
   }
 
   // Process the visual messages.
-  for (visualIter = visualMsgsCopy.begin(); visualIter != visualMsgsCopy.end();)
+  for (visualIter = visualMsgsCopy.begin();
+      visualIter != visualMsgsCopy.end() && withinBudget();)
   {
     Visual::VisualType visualType = Visual::VT_VISUAL;
     if ((*visualIter)->has_type())
@@ -1957,7 +2227,7 @@ void Scene::PreRender()
 
   // Process the collision visual messages.
   for (visualIter = collisionVisualMsgsCopy.begin();
-      visualIter != collisionVisualMsgsCopy.end();)
+      visualIter != collisionVisualMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_COLLISION))
       collisionVisualMsgsCopy.erase(visualIter++);
@@ -2055,24 +2325,42 @@ void Scene::PreRender()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
 
+    // If an object is selected, don't let the physics engine move it.
+    auto movable = [this](const uint32_t _id, const VisualPtr &_vis)
+    {
+      return !this->dataPtr->selectedVis ||
+          this->dataPtr->selectionMode != "move" ||
+          (_id != this->dataPtr->selectedVis->GetId() &&
+           !this->dataPtr->selectedVis->IsAncestorOf(_vis));
+    };
+
+    const bool interpolate = !this->dataPtr->isServer &&
+        rendering::pose_interpolation() &&
+        this->dataPtr->poseSamplePeriod > common::Time::Zero;
+    const common::Time now = common::Time::GetWallTime();
+
     // Process all the model messages last. Remove pose message from the list
     // only when a corresponding visual exits. We may receive pose updates
     // over the wire before  we recieve the visual
     pIter = this->dataPtr->poseMsgs.begin();
     while (pIter != this->dataPtr->poseMsgs.end())
     {
-      Visual_M::iterator iter = this->dataPtr->visuals.find(pIter->first);
-      if (iter != this->dataPtr->visuals.end() && iter->second)
+      VisualPtr *vis = FindVisual(this->dataPtr.get(), pIter->first);
+      if (vis && *vis)
       {
-        // If an object is selected, don't let the physics engine move it.
-        if (!this->dataPtr->selectedVis
-            || this->dataPtr->selectionMode != "move" ||
-            (iter->first != this->dataPtr->selectedVis->GetId() &&
-            !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
+        if (movable(pIter->first, *vis))
         {
           ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          GZ_ASSERT(iter->second, "Visual pointer is NULL");
-          iter->second->SetPose(pose);
+          if (interpolate)
+          {
+            PoseInterpolation &interpolation =
+                this->dataPtr->poseInterpolations[pIter->first];
+            interpolation.start = (*vis)->Pose();
+            interpolation.target = pose;
+            interpolation.startTime = now;
+          }
+          else
+            (*vis)->SetPose(pose);
           PoseMsgs_M::iterator prev = pIter++;
           this->dataPtr->poseMsgs.erase(prev);
         }
@@ -2096,6 +2384,36 @@ void Scene::PreRender()
       }
     }
 
+    // Move the visuals towards their latest pose sample, over the time
+    // between pose samples
+    auto interpIter = this->dataPtr->poseInterpolations.begin();
+    while (interpIter != this->dataPtr->poseInterpolations.end())
+    {
+      VisualPtr *vis = FindVisual(this->dataPtr.get(), interpIter->first);
+      if (!vis || !*vis || !movable(interpIter->first, *vis))
+      {
+        this->dataPtr->poseInterpolations.erase(interpIter++);
+        continue;
+      }
+
+      const PoseInterpolation &interpolation = interpIter->second;
+      const double t = (now - interpolation.startTime).Double() /
+          this->dataPtr->poseSamplePeriod.Double();
+      if (!interpolate || t >= 1.0)
+      {
+        (*vis)->SetPose(interpolation.target);
+        this->dataPtr->poseInterpolations.erase(interpIter++);
+        continue;
+      }
+
+      (*vis)->SetPose(ignition::math::Pose3d(
+          interpolation.start.Pos() +
+          (interpolation.target.Pos() - interpolation.start.Pos()) * t,
+          ignition::math::Quaterniond::Slerp(t, interpolation.start.Rot(),
+            interpolation.target.Rot(), true)));
+      ++interpIter;
+    }
+
     // process skeleton pose msgs
     spIter = this->dataPtr->skeletonPoseMsgs.begin();
     while (spIter != this->dataPtr->skeletonPoseMsgs.end())
@@ -2159,6 +2477,42 @@ void Scene::PreRender()
     this->dataPtr->sceneSimTimePosesApplied =
         this->dataPtr->sceneSimTimePosesReceived;
   }
+
+  // Find the shadow casters that moved, for the cached shadow maps
+  if (this->dataPtr->manager->getShadowTechnique() != Ogre::SHADOWTYPE_NONE)
+  {
+    CustomPSSMShadowCameraSetup *cameraSetup =
+        dynamic_cast<CustomPSSMShadowCameraSetup *>(
+        RTShaderSystem::Instance()->GetPSSMShadowCameraSetup());
+    if (cameraSetup)
+      cameraSetup->UpdateCasters(this->dataPtr->manager);
+  }
+
+  this->PublishStats();
+}
+
+/////////////////////////////////////////////////
+void Scene::PublishStats()
+{
+  common::Time wallTime = common::Time::GetWallTime();
+  if (!this->dataPtr->statsPub || wallTime - this->dataPtr->statsTime <
+      RENDERING_STATS_PERIOD)
+  {
+    return;
+  }
+  this->dataPtr->statsTime = wallTime;
+
+  if (!this->dataPtr->statsPub->HasConnections())
+    return;
+
+  msgs::RenderingStats msg;
+  msg.set_scene(this->Name());
+  msgs::Set(msg.mutable_wall_time(), wallTime);
+  for (const auto &camera : this->dataPtr->cameras)
+    camera->FillStatsMsg(*msg.add_camera());
+  for (const auto &camera : this->dataPtr->userCameras)
+    camera->FillStatsMsg(*msg.add_camera());
+  this->dataPtr->statsPub->Publish(msg);
 }
 
 /////////////////////////////////////////////////
@@ -2375,6 +2729,10 @@ bool Scene::ProcessLinkMsg(ConstLinkPtr &_msg)
     }
   }
 
+  // The link message is only kept for GUI visualizations
+  if (this->SensorOnly())
+    return true;
+
   linkVis->SetTypeMsg(&*_msg);
 
   // Trigger visualizations that depend on type msg
@@ -2400,7 +2758,9 @@ bool Scene::ProcessJointMsg(ConstJointPtr &_msg)
   if (!childVis)
     return false;
 
-  childVis->AddPendingChild(std::make_pair(Visual::VT_PHYSICS, &*_msg));
+  // Joint visuals are only shown in the GUI
+  if (!this->SensorOnly())
+    childVis->AddPendingChild(std::make_pair(Visual::VT_PHYSICS, &*_msg));
   // If this needs to be added, make sure it is called after all of the visuals
   // the childVis link have been loaded
   // childVis->ShowJoints(this->dataPtr->showJoints);
@@ -2493,7 +2853,10 @@ void Scene::ProcessRequestMsg(ConstRequestPtr &_msg)
       }
 
       if (visPtr)
+      {
+        this->dataPtr->modelPositions.erase(visPtr->Name());
         this->RemoveVisual(visPtr);
+      }
     }
   }
   else if (_msg->request() == "show_contact")
@@ -2726,6 +3089,7 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
     if (iter != this->dataPtr->visuals.end())
     {
       this->dataPtr->visuals.erase(iter);
+      this->dataPtr->visualIndex.clear();
       return true;
     }
     else
@@ -2790,6 +3154,10 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
   // Creating collision
   if (_type == Visual::VT_COLLISION)
   {
+    // Collision visuals are only shown in the GUI
+    if (this->SensorOnly())
+      return true;
+
     // Collisions need a parent
     if (!_msg->has_parent_name() && !_msg->has_parent_id())
     {
@@ -2811,6 +3179,10 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
     return true;
   }
 
+  // Wait for the mesh of a new visual to be loaded in the background
+  if (this->dataPtr->meshLoader && !this->dataPtr->meshLoader->Ready(*_msg))
+    return false;
+
   // All other visuals
   VisualPtr visual;
 
@@ -2838,6 +3210,15 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
   if (_msg->has_id())
     visual->SetId(_msg->id());
 
+  // The shaders generated for a material depend on the shader type of the
+  // visual, so only visuals with the default shaders share materials
+  if (_type == Visual::VT_VISUAL && rendering::share_materials() &&
+      (!_msg->has_material() || !_msg->material().has_shader_type() ||
+       _msg->material().shader_type() == msgs::Material::PIXEL))
+  {
+    visual->SetShareMaterials(true);
+  }
+
   visual->LoadFromMsg(_msg);
   visual->SetType(_type);
 
@@ -2862,12 +3243,26 @@ common::Time Scene::SimTime() const
   return this->dataPtr->sceneSimTimePosesApplied;
 }
 
+/////////////////////////////////////////////////
+/// \brief Record the reception of a pose message. The pose message mutex
+/// must be locked.
+/// \param[in] _data Private data of the scene.
+/// \param[in] _time Time stamp of the message.
+static void ReceivePoses(ScenePrivate *_data, const msgs::Time &_time)
+{
+  _data->sceneSimTimePosesReceived = common::Time(_time.sec(), _time.nsec());
+
+  const common::Time now = common::Time::GetWallTime();
+  if (_data->poseSampleTime != common::Time::Zero)
+    _data->poseSamplePeriod = now - _data->poseSampleTime;
+  _data->poseSampleTime = now;
+}
+
 /////////////////////////////////////////////////
 void Scene::OnPoseMsg(ConstPosesStampedPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-  this->dataPtr->sceneSimTimePosesReceived =
-    common::Time(_msg->time().sec(), _msg->time().nsec());
+  ReceivePoses(this->dataPtr.get(), _msg->time());
 
   for (int i = 0; i < _msg->pose_size(); ++i)
   {
@@ -2881,6 +3276,22 @@ void Scene::OnPoseMsg(ConstPosesStampedPtr &_msg)
   }
 }
 
+/////////////////////////////////////////////////
+void Scene::OnCompactPoseMsg(ConstPosesCompactPtr &_msg)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
+  ReceivePoses(this->dataPtr.get(), _msg->time());
+
+  // The poses are decoded into the pending pose of each entity, which is
+  // applied by PreRender like full poses
+  for (int i = 0; i < _msg->id_size(); ++i)
+  {
+    msgs::Pose &pose = this->dataPtr->poseMsgs[_msg->id(i)];
+    pose.set_id(_msg->id(i));
+    msgs::Set(&pose, msgs::CompactPose(*_msg, i));
+  }
+}
+
 /////////////////////////////////////////////////
 void Scene::UpdatePoses(const msgs::PosesStamped &_msg)
 {
@@ -3012,6 +3423,17 @@ void Scene::OnModelMsg(ConstModelPtr &_msg)
   this->dataPtr->modelMsgs.push_back(_msg);
 }
 
+/////////////////////////////////////////////////
+void Scene::OnModelVMsg(ConstModel_VPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  for (int i = 0; i < _msg->models_size(); ++i)
+  {
+    this->dataPtr->modelMsgs.push_back(
+        boost::make_shared<const msgs::Model>(_msg->models(i)));
+  }
+}
+
 /////////////////////////////////////////////////
 void Scene::OnSkyMsg(ConstSkyPtr &_msg)
 {
@@ -3319,6 +3741,7 @@ void Scene::RemoveVisual(uint32_t _id)
         ++piter;
     }
     this->dataPtr->visuals.erase(iter);
+    this->dataPtr->visualIndex.clear();
 
     this->RemoveVisualizations(vis);
     vis->Fini();
@@ -3345,6 +3768,7 @@ void Scene::SetVisualId(VisualPtr _vis, uint32_t _id)
   if (iter != this->dataPtr->visuals.end())
   {
     this->dataPtr->visuals.erase(_vis->GetId());
+    this->dataPtr->visualIndex.clear();
     this->dataPtr->visuals[_id] = _vis;
     _vis->SetId(_id);
   }
@@ -3392,7 +3816,8 @@ void Scene::SetGrid(const bool _enabled)
 /////////////////////////////////////////////////
 void Scene::ShowOrigin(const bool _show)
 {
-  this->dataPtr->originVisual->SetVisible(_show);
+  if (this->dataPtr->originVisual)
+    this->dataPtr->originVisual->SetVisible(_show);
 }
 
 //////////////////////////////////////////////////
@@ -3543,6 +3968,9 @@ void Scene::SetTransparent(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowCOMs(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   this->dataPtr->showCOMs = _show;
   for (auto visual : this->dataPtr->visuals)
   {
@@ -3553,6 +3981,9 @@ void Scene::ShowCOMs(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowInertias(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   this->dataPtr->showInertias = _show;
   for (auto visual : this->dataPtr->visuals)
   {
@@ -3563,6 +3994,9 @@ void Scene::ShowInertias(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowLinkFrames(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   this->dataPtr->showLinkFrames = _show;
   for (auto visual : this->dataPtr->visuals)
   {
@@ -3573,6 +4007,9 @@ void Scene::ShowLinkFrames(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowSkeleton(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   this->dataPtr->showSkeleton = _show;
   for (auto visual : this->dataPtr->visuals)
   {
@@ -3584,6 +4021,9 @@ void Scene::ShowSkeleton(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowCollisions(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   this->dataPtr->showCollisions = _show;
   for (auto visual : this->dataPtr->visuals)
   {
@@ -3594,6 +4034,9 @@ void Scene::ShowCollisions(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowJoints(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   this->dataPtr->showJoints = _show;
   for (auto visual : this->dataPtr->visuals)
   {
@@ -3604,6 +4047,9 @@ void Scene::ShowJoints(const bool _show)
 /////////////////////////////////////////////////
 void Scene::ShowContacts(const bool _show)
 {
+  if (this->SensorOnly())
+    return;
+
   ContactVisualPtr vis;
 
   if (this->dataPtr->contactVisId == ignition::math::MAX_UI32 && _show)
@@ -3738,3 +4184,10 @@ bool Scene::EnableVisualizations() const
 {
   return this->dataPtr->enableVisualizations;
 }
+
+/////////////////////////////////////////////////
+bool Scene::SensorOnly() const
+{
+  return this->dataPtr->isServer && !this->dataPtr->enableVisualizations &&
+      rendering::sensor_only_scenes();
+}
@@ -84,6 +84,11 @@ namespace gazebo
     ///   * Request message type: ign_msgs.Marker
     ///   * Response mssage type: ign_msgs.StringMsg
     ///   * Purpose: Add, modify, or delete a visualization marker.
+    /// 1. /marker/bulk
+    ///   * Request message type: ign_msgs.Marker_V
+    ///   * Purpose: Add, modify, or delete many markers of one namespace,
+    ///     which are rendered as a single batch sharing a material. See
+    ///     MarkerBatchVisual.
     /// 1. /marker/list
     ///   * Response mssage type: ign_msgs.Marker_V
     ///   * Purpose: Get the list of markers.
@@ -605,6 +610,17 @@ namespace gazebo
       /// \sa EnableVisualizations(bool)
       public: bool EnableVisualizations() const;
 
+      /// \brief Check whether this is a sensor only scene, which is a
+      /// server scene without visualizations when sensor only scenes are
+      /// enabled with rendering::set_sensor_only_scenes. Sensor only scenes
+      /// don't create the visuals that only the GUI needs, such as the
+      /// origin, collision, joint, COM, inertia, link frame and contact
+      /// visuals.
+      /// \return True if this scene only renders sensors.
+      /// \sa EnableVisualizations()
+      /// \sa rendering::set_sensor_only_scenes
+      public: bool SensorOnly() const;
+
       /// \brief Helper function to setup the sky.
       private: void SetSky();
 
@@ -726,10 +742,23 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: void OnModelMsg(ConstModelPtr &_msg);
 
+      /// \brief Callback for models inserted together.
+      /// \param[in] _msg The message data.
+      private: void OnModelVMsg(ConstModel_VPtr &_msg);
+
       /// \brief Pose message callback.
       /// \param[in] _msg The message data.
       private: void OnPoseMsg(ConstPosesStampedPtr &_msg);
 
+      /// \brief Compact pose message callback, used by clients instead of
+      /// OnPoseMsg when compact_poses is enabled.
+      /// \param[in] _msg The message data.
+      private: void OnCompactPoseMsg(ConstPosesCompactPtr &_msg);
+
+      /// \brief Publish the rendering statistics of the cameras on
+      /// ~/rendering/stats, at most once a second.
+      private: void PublishStats();
+
       /// \brief Skeleton animation callback.
       /// \param[in] _msg The message data.
       private: void OnSkeletonPoseMsg(ConstPoseAnimationPtr &_msg);
@@ -19,16 +19,19 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
 
 #include <boost/unordered/unordered_map.hpp>
+#include <ignition/math/Pose3.hh>
 
 #include <sdf/sdf.hh>
 
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/rendering/MarkerManager.hh"
@@ -55,6 +58,7 @@ namespace gazebo
     class Visual;
     class Grid;
     class Heightmap;
+    class SceneMeshLoader;
 
     /// \def Visual_M
     /// \brief Map of visuals and their names.
@@ -104,6 +108,20 @@ namespace gazebo
     /// \brief Map of lights
     typedef std::map<uint32_t, LightPtr> Light_M;
 
+    /// \brief Motion of a visual from its pose to the latest pose sample
+    /// received, when poses are interpolated.
+    class PoseInterpolation
+    {
+      /// \brief Pose of the visual when the sample was received.
+      public: ignition::math::Pose3d start;
+
+      /// \brief Pose of the sample.
+      public: ignition::math::Pose3d target;
+
+      /// \brief Wall time at which the sample was applied.
+      public: common::Time startTime;
+    };
+
     /// \def SkeletonPoseMsgs_L
     /// \brief List of skeleton messages.
     typedef std::list<boost::shared_ptr<msgs::PoseAnimation const> >
@@ -118,6 +136,18 @@ namespace gazebo
     /// \brief List of road messages
     typedef std::list<boost::shared_ptr<msgs::Road const> > RoadMsgs_L;
 
+    /// \brief Sort visual messages so that the visuals of the models nearest
+    /// to a position are created first. The visuals of a model are sorted by
+    /// the length of their names, so that parents come before their children.
+    /// \param[in,out] _msgs Visual messages to sort.
+    /// \param[in] _positions Positions of the top level models, by name.
+    /// Visuals of other models are sorted as if they were at _position.
+    /// \param[in] _position Position to sort from, such as the user camera's.
+    GZ_RENDERING_VISIBLE
+    void SortVisualMsgs(VisualMsgs_L &_msgs,
+        const boost::unordered_map<std::string, ignition::math::Vector3d>
+        &_positions, const ignition::math::Vector3d &_position);
+
     /// \brief Private data for the Visual class
     class ScenePrivate
     {
@@ -175,6 +205,11 @@ namespace gazebo
       /// \brief List of collision visual messages to process.
       public: VisualMsgs_L collisionVisualMsgs;
 
+      /// \brief Positions of the top level models, by name, used to create
+      /// the visuals nearest to the user camera first.
+      public: boost::unordered_map<std::string, ignition::math::Vector3d>
+              modelPositions;
+
       /// \brief List of light factory message to process.
       public: LightMsgs_L lightFactoryMsgs;
 
@@ -232,6 +267,21 @@ namespace gazebo
       /// \brief Mutex to lock the pose message buffers.
       public: std::recursive_mutex poseMsgMutex;
 
+      /// \brief Entries of the map of visuals by id, for the ids small
+      /// enough, so that pose updates don't search the map. Entries are
+      /// filled on first use, and the index is cleared when a visual is
+      /// erased from the map.
+      public: std::vector<VisualPtr *> visualIndex;
+
+      /// \brief Visuals moving towards their latest pose sample, by id.
+      public: std::map<uint32_t, PoseInterpolation> poseInterpolations;
+
+      /// \brief Wall time at which the latest pose message was received.
+      public: common::Time poseSampleTime;
+
+      /// \brief Wall time between the two latest pose messages.
+      public: common::Time poseSamplePeriod;
+
       /// \brief Communication Node
       public: transport::NodePtr node;
 
@@ -271,12 +321,21 @@ namespace gazebo
       /// \brief Subscribe to model info updates
       public: transport::SubscriberPtr modelInfoSub;
 
+      /// \brief Subscribe to updates of many models at once
+      public: transport::SubscriberPtr modelInfoVSub;
+
       /// \brief Respond to requests.
       public: transport::PublisherPtr responsePub;
 
       /// \brief Publish requests
       public: transport::PublisherPtr requestPub;
 
+      /// \brief Publish the rendering statistics of the cameras.
+      public: transport::PublisherPtr statsPub;
+
+      /// \brief Wall time the rendering statistics were last published.
+      public: common::Time statsTime;
+
       /// \brief Subscribe to roads topic
       public: transport::SubscriberPtr roadSub;
 
@@ -308,6 +367,10 @@ namespace gazebo
       /// \brief True if this scene is running on the server.
       public: bool isServer;
 
+      /// \brief Loads the meshes of new visuals in the background. Only
+      /// created on the client.
+      public: std::unique_ptr<SceneMeshLoader> meshLoader;
+
       /// \brief The heightmap, if any.
       public: Heightmap *terrain = nullptr;
 
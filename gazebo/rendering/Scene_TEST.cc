@@ -15,8 +15,15 @@
  *
 */
 
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/ScenePrivate.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 
@@ -402,6 +409,211 @@ TEST_F(Scene_TEST, AddRemoveLights)
   EXPECT_FALSE(scene->LightByName("light1"));
 }
 
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, LoadMeshInBackground)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::set_scene_message_budget(0.5);
+  EXPECT_DOUBLE_EQ(rendering::scene_message_budget(), 0.5);
+
+  const std::string meshFile = std::string(PROJECT_SOURCE_PATH) +
+      "/test/data/box_with_multiple_geoms.dae";
+  EXPECT_FALSE(common::MeshManager::Instance()->HasMesh(meshFile));
+
+  // Publish a visual with a mesh that was not loaded yet
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr visPub =
+      node->Advertise<msgs::Visual>("~/visual");
+  visPub->WaitForConnection();
+
+  msgs::Visual visualMsg;
+  visualMsg.set_name("background_mesh_visual");
+  visualMsg.set_parent_name(scene->Name());
+  visualMsg.mutable_geometry()->set_type(msgs::Geometry::MESH);
+  visualMsg.mutable_geometry()->mutable_mesh()->set_filename(meshFile);
+  visPub->Publish(visualMsg);
+
+  // The visual is created once the mesh is loaded
+  int sleep = 0;
+  int maxSleep = 50;
+  rendering::VisualPtr vis;
+  while (!vis && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    vis = scene->GetVisual("background_mesh_visual");
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_TRUE(vis != nullptr);
+  EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(meshFile));
+  EXPECT_EQ(vis->GetMeshName(), meshFile);
+
+  rendering::set_scene_message_budget(0);
+  EXPECT_DOUBLE_EQ(rendering::scene_message_budget(), 0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, SensorOnly)
+{
+  rendering::set_sensor_only_scenes(true);
+  EXPECT_TRUE(rendering::sensor_only_scenes());
+
+  Load("worlds/shapes.world");
+
+  // The scene of the server has no visualizations
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+  EXPECT_TRUE(scene->SensorOnly());
+
+  // Wait until the models are inserted
+  int sleep = 0;
+  int maxSleep = 50;
+  rendering::VisualPtr box;
+  while (!box && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    box = scene->GetVisual("box");
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_TRUE(box != nullptr);
+
+  // GUI only visuals are never created
+  scene->ShowCollisions(true);
+  scene->ShowCOMs(true);
+  scene->ShowJoints(true);
+  event::Events::preRender();
+  EXPECT_TRUE(scene->GetVisual("box::link_COM_VISUAL__") == nullptr);
+  EXPECT_TRUE(scene->GetVisual("box::link::collision__COLLISION_VISUAL__")
+      == nullptr);
+
+  rendering::set_sensor_only_scenes(false);
+  EXPECT_FALSE(scene->SensorOnly());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, SortVisualMsgs)
+{
+  auto visualMsg = [](const std::string &_name)
+  {
+    boost::shared_ptr<msgs::Visual> msg(new msgs::Visual);
+    msg->set_name(_name);
+    return boost::shared_ptr<msgs::Visual const>(msg);
+  };
+
+  rendering::VisualMsgs_L msgs;
+  msgs.push_back(visualMsg("far::link::visual"));
+  msgs.push_back(visualMsg("near::link::visual"));
+  msgs.push_back(visualMsg("far::link"));
+  msgs.push_back(visualMsg("unknown::link::visual"));
+  msgs.push_back(visualMsg("near::link"));
+  msgs.push_back(visualMsg("middle::link::visual"));
+  msgs.push_back(visualMsg("near::nested::link::visual"));
+
+  boost::unordered_map<std::string, ignition::math::Vector3d> positions;
+  positions["near"] = ignition::math::Vector3d(10, 1, 0);
+  positions["middle"] = ignition::math::Vector3d(-10, 0, 0);
+  positions["far"] = ignition::math::Vector3d(100, 0, 0);
+
+  // Visuals of unknown models come first, then by distance to the camera,
+  // parents before their children
+  rendering::SortVisualMsgs(msgs, positions,
+      ignition::math::Vector3d(10, 0, 0));
+  std::vector<std::string> names;
+  for (auto const &msg : msgs)
+    names.push_back(msg->name());
+  EXPECT_EQ(std::vector<std::string>({
+      "unknown::link::visual",
+      "near::link",
+      "near::link::visual",
+      "near::nested::link::visual",
+      "middle::link::visual",
+      "far::link",
+      "far::link::visual"}), names);
+
+  // Moving the camera changes the order. The camera is on the far model,
+  // as close as the unknown one.
+  rendering::SortVisualMsgs(msgs, positions,
+      ignition::math::Vector3d(100, 0, 0));
+  names.clear();
+  for (auto const &msg : msgs)
+    names.push_back(msg->name());
+  EXPECT_EQ(std::vector<std::string>({
+      "far::link",
+      "far::link::visual",
+      "unknown::link::visual",
+      "near::link",
+      "near::link::visual",
+      "near::nested::link::visual",
+      "middle::link::visual"}), names);
+
+  // Names of the same length keep their order
+  rendering::VisualMsgs_L same;
+  same.push_back(visualMsg("b"));
+  same.push_back(visualMsg("a"));
+  rendering::SortVisualMsgs(same, positions,
+      ignition::math::Vector3d::Zero);
+  EXPECT_EQ("b", same.front()->name());
+  EXPECT_EQ("a", same.back()->name());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, RemoteClient)
+{
+  // Remote clients always interpolate poses
+  rendering::set_remote_client(true);
+  EXPECT_TRUE(rendering::remote_client());
+  EXPECT_TRUE(rendering::pose_interpolation());
+
+  Load("worlds/shapes.world");
+
+  // A client scene, next to the scene of the server. Its subscriptions ask
+  // for compressed scene messages and for poses at a reduced rate.
+  rendering::ScenePtr scene = rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  // Wait until the models are inserted
+  int sleep = 0;
+  int maxSleep = 50;
+  rendering::VisualPtr box;
+  while (!box && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    box = scene->GetVisual("box");
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_TRUE(box != nullptr);
+
+  // Move the box on the server, the client still receives its pose
+  physics::ModelPtr model = physics::get_world()->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  model->SetWorldPose(ignition::math::Pose3d(5, 0, 0.5, 0, 0, 0));
+
+  sleep = 0;
+  while (!ignition::math::equal(box->WorldPose().Pos().X(), 5.0, 1e-3) &&
+      sleep < maxSleep)
+  {
+    event::Events::preRender();
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_NEAR(box->WorldPose().Pos().X(), 5.0, 1e-3);
+
+  rendering::set_remote_client(false);
+  EXPECT_FALSE(rendering::remote_client());
+
+  // The environment variable turns it on too
+  setenv("GAZEBO_REMOTE_CLIENT", "1", 1);
+  EXPECT_TRUE(rendering::remote_client());
+  unsetenv("GAZEBO_REMOTE_CLIENT");
+  EXPECT_FALSE(rendering::remote_client());
+}
 
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
@@ -251,7 +251,13 @@ void UserCamera::Render(const bool /*_force*/)
   if (this->initialized)
   {
     this->newData = true;
+    common::Time start = common::Time::GetWallTime();
     this->RenderImpl();
+    this->RecordRender(common::Time::GetWallTime() - start);
+
+    // The scene may have changed, so picks read the selection buffer again
+    if (this->dataPtr->selectionBuffer)
+      this->dataPtr->selectionBuffer->Invalidate();
   }
 }
 
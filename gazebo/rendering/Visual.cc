@@ -14,6 +14,11 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
@@ -56,6 +61,187 @@ using namespace rendering;
 // Note: The value of ignition::math::MAX_UI32 is reserved as a flag.
 uint32_t VisualPrivate::visualIdCount = ignition::math::MAX_UI32 - 1;
 
+/// \brief Prefix of the names of the materials shared between visuals.
+static const std::string SHARED_MATERIAL_PREFIX = "__SHARED_MATERIAL__";
+
+/////////////////////////////////////////////////
+/// \brief Describe a color change of a shared material.
+/// \param[in] _component Name of the color component.
+/// \param[in] _color The new color.
+/// \return Description of the change.
+static std::string ColorChange(const std::string &_component,
+    const ignition::math::Color &_color)
+{
+  std::ostringstream change;
+  change << _component << " " << _color;
+  return change.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the Ogre operation type of a submesh primitive type.
+/// \param[in] _type Primitive type.
+/// \return The operation type, a triangle list for unknown types.
+static Ogre::RenderOperation::OperationType OperationType(
+    const common::SubMesh::PrimitiveType _type)
+{
+  switch (_type)
+  {
+    case common::SubMesh::TRIANGLES:
+      return Ogre::RenderOperation::OT_TRIANGLE_LIST;
+    case common::SubMesh::LINES:
+      return Ogre::RenderOperation::OT_LINE_LIST;
+    case common::SubMesh::LINESTRIPS:
+      return Ogre::RenderOperation::OT_LINE_STRIP;
+    case common::SubMesh::TRIFANS:
+      return Ogre::RenderOperation::OT_TRIANGLE_FAN;
+    case common::SubMesh::TRISTRIPS:
+      return Ogre::RenderOperation::OT_TRIANGLE_STRIP;
+    case common::SubMesh::POINTS:
+      return Ogre::RenderOperation::OT_POINT_LIST;
+    default:
+      gzerr << "Unknown primitive type[" << _type << "]\n";
+      return Ogre::RenderOperation::OT_TRIANGLE_LIST;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Set the material of an Ogre submesh.
+/// \param[in] _ogreSubMesh The Ogre submesh.
+/// \param[in] _mesh The mesh.
+/// \param[in] _subMesh The submesh of _mesh.
+static void SetSubMeshMaterial(Ogre::SubMesh *_ogreSubMesh,
+    const common::Mesh *_mesh, const common::SubMesh *_subMesh)
+{
+  const common::Material *material =
+    _mesh->GetMaterial(_subMesh->GetMaterialIndex());
+  if (material)
+  {
+    rendering::Material::Update(material);
+    _ogreSubMesh->setMaterialName(material->GetName());
+  }
+  else
+  {
+    _ogreSubMesh->setMaterialName("Gazebo/White");
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Add a compact submesh to an Ogre mesh. The Ogre vertex and
+/// index buffers use the layout of the compact buffers, which are copied
+/// without conversion.
+/// \param[in] _ogreMesh The Ogre mesh.
+/// \param[in] _mesh The mesh.
+/// \param[in] _subMesh Compact submesh of _mesh.
+static void InsertCompactSubMesh(Ogre::Mesh *_ogreMesh,
+    const common::Mesh *_mesh, const common::SubMesh *_subMesh)
+{
+  Ogre::SubMesh *ogreSubMesh = _ogreMesh->createSubMesh();
+  ogreSubMesh->useSharedVertices = false;
+  ogreSubMesh->operationType = OperationType(_subMesh->GetPrimitiveType());
+
+  ogreSubMesh->vertexData = new Ogre::VertexData();
+  Ogre::VertexData *vertexData = ogreSubMesh->vertexData;
+  Ogre::VertexDeclaration *vertexDecl = vertexData->vertexDeclaration;
+
+  vertexDecl->addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+  if (_subMesh->NormalOffset() >= 0)
+  {
+    vertexDecl->addElement(0, _subMesh->NormalOffset() * sizeof(float),
+        Ogre::VET_FLOAT3, Ogre::VES_NORMAL);
+  }
+  if (_subMesh->TexCoordOffset() >= 0)
+  {
+    vertexDecl->addElement(0, _subMesh->TexCoordOffset() * sizeof(float),
+        Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES, 0);
+  }
+
+  const size_t vertexSize = _subMesh->VertexStride() * sizeof(float);
+  vertexData->vertexCount = _subMesh->GetVertexCount();
+  Ogre::HardwareVertexBufferSharedPtr vBuf =
+    Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+        vertexSize, vertexData->vertexCount,
+        Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
+  vBuf->writeData(0, vertexSize * vertexData->vertexCount,
+      _subMesh->VertexBuffer(), true);
+  vertexData->vertexBufferBinding->setBinding(0, vBuf);
+
+  Ogre::IndexData *indexData = ogreSubMesh->indexData;
+  indexData->indexCount = _subMesh->GetIndexCount();
+  indexData->indexBuffer =
+    Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+        _subMesh->IndexSize() == sizeof(uint16_t) ?
+        Ogre::HardwareIndexBuffer::IT_16BIT :
+        Ogre::HardwareIndexBuffer::IT_32BIT,
+        indexData->indexCount,
+        Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
+  indexData->indexBuffer->writeData(0,
+      _subMesh->IndexSize() * indexData->indexCount,
+      _subMesh->IndexBuffer(), true);
+
+  SetSubMeshMaterial(ogreSubMesh, _mesh, _subMesh);
+}
+
+/////////////////////////////////////////////////
+/// \brief Add the levels of detail of a mesh to its Ogre mesh. The levels
+/// only replace the indices of the submeshes, so that the entities of the
+/// mesh keep their materials at every level. Ogre picks the level of each
+/// entity for every camera that renders it.
+/// \param[in] _ogreMesh The Ogre mesh.
+/// \param[in] _mesh The mesh.
+/// \param[in] _subMeshes Index of the submesh of _mesh of each submesh of
+/// _ogreMesh.
+/// \param[in] _distances Distances at which each level is used.
+static void InsertMeshLods(Ogre::Mesh *_ogreMesh, const common::Mesh *_mesh,
+    const std::vector<unsigned int> &_subMeshes,
+    const std::vector<double> &_distances)
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  // The levels may have been generated for more distances before
+  unsigned int levels = std::min<unsigned int>(
+      meshManager->GenerateLods(_mesh, _distances.size()), _distances.size());
+  if (levels == 0)
+    return;
+
+#if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR < 10
+  _ogreMesh->_setLodInfo(levels + 1, false);
+#else
+  _ogreMesh->_setLodInfo(levels + 1);
+#endif
+
+  for (unsigned int level = 1; level <= levels; ++level)
+  {
+    Ogre::MeshLodUsage usage;
+    usage.userValue = _distances[level - 1];
+    usage.value =
+        _ogreMesh->getLodStrategy()->transformUserValue(usage.userValue);
+    usage.edgeData = nullptr;
+    _ogreMesh->_setLodUsage(level, usage);
+
+    for (unsigned int i = 0; i < _subMeshes.size(); ++i)
+    {
+      std::vector<unsigned int> indices;
+      meshManager->LodIndices(_mesh->GetName(), level, _subMeshes[i],
+          indices);
+
+      Ogre::IndexData *indexData = new Ogre::IndexData();
+      indexData->indexStart = 0;
+      indexData->indexCount = indices.size();
+      indexData->indexBuffer =
+        Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+            Ogre::HardwareIndexBuffer::IT_32BIT,
+            std::max<size_t>(indices.size(), 1),
+            Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY,
+            false);
+      if (!indices.empty())
+      {
+        indexData->indexBuffer->writeData(0,
+            indices.size() * sizeof(uint32_t), indices.data(), true);
+      }
+      _ogreMesh->_setSubMeshLodFaceList(i, level, indexData);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 Visual::Visual(const std::string &_name, VisualPtr _parent, bool _useRTShader)
   : dataPtr(new VisualPrivate)
@@ -240,6 +426,7 @@ void Visual::Fini()
 VisualPtr Visual::Clone(const std::string &_name, VisualPtr _newParent)
 {
   VisualPtr result(new Visual(_name, _newParent));
+  this->UpdateSDFPose();
   result->Load(this->dataPtr->sdf);
   result->SetScale(this->dataPtr->scale);
   result->SetVisibilityFlags(this->dataPtr->visibilityFlags);
@@ -330,6 +517,7 @@ void Visual::Init()
 void Visual::LoadFromMsg(const boost::shared_ptr< msgs::Visual const> &_msg)
 {
   this->dataPtr->sdf = msgs::VisualToSDF(*_msg.get());
+  this->dataPtr->sdfPoseDirty = false;
   this->Load();
   this->UpdateFromMsg(_msg);
 }
@@ -338,6 +526,7 @@ void Visual::LoadFromMsg(const boost::shared_ptr< msgs::Visual const> &_msg)
 void Visual::Load(sdf::ElementPtr _sdf)
 {
   this->dataPtr->sdf->Copy(_sdf);
+  this->dataPtr->sdfPoseDirty = false;
   this->Load();
 }
 
@@ -352,12 +541,36 @@ void Visual::Load()
     this->dataPtr->parent->AttachVisual(shared_from_this());
 
   // Read the desired position and rotation of the mesh
+  this->UpdateSDFPose();
   pose = this->dataPtr->sdf->Get<ignition::math::Pose3d>("pose");
 
   std::string mesh = this->GetMeshName();
   std::string subMesh = this->GetSubMeshName();
   bool centerSubMesh = this->GetCenterSubMesh();
 
+  // Levels of detail requested for the mesh
+  this->dataPtr->lodDistances.clear();
+  if (this->dataPtr->sdf->HasElement("geometry") &&
+      this->dataPtr->sdf->GetElement("geometry")->HasElement("mesh"))
+  {
+    msgs::MeshGeom meshMsg = msgs::MeshFromSDF(
+        this->dataPtr->sdf->GetElement("geometry")->GetElement("mesh"));
+    for (const auto distance : meshMsg.lod_distance())
+    {
+      if (distance > 0 && (this->dataPtr->lodDistances.empty() ||
+          distance > this->dataPtr->lodDistances.back()))
+      {
+        this->dataPtr->lodDistances.push_back(distance);
+      }
+      else
+      {
+        gzwarn << "Ignoring level of detail distance [" << distance
+               << "] of visual [" << this->Name()
+               << "], distances must be positive and increasing\n";
+      }
+    }
+  }
+
   if (!mesh.empty())
   {
     try
@@ -634,9 +847,9 @@ void Visual::AttachObject(Ogre::MovableObject *_obj)
 
   if (!this->HasAttachedObject(_obj->getName()))
   {
-    // update to use unique materials
+    // update to use unique materials, unless they are shared
     Ogre::Entity *entity = dynamic_cast<Ogre::Entity *>(_obj);
-    if (entity)
+    if (entity && !this->dataPtr->shareMaterials)
     {
       for (unsigned j = 0; j < entity->getNumSubEntities(); ++j)
       {
@@ -702,6 +915,8 @@ void Visual::DetachObjects()
   this->dataPtr->subMeshName = "";
   this->dataPtr->myMaterialName = "";
   this->dataPtr->skeleton = nullptr;
+  this->dataPtr->poseBones.clear();
+  this->dataPtr->poseBonesSkeleton = nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -936,6 +1151,12 @@ void Visual::SetLighting(bool _lighting)
 
   try
   {
+    if (this->dataPtr->shareMaterials)
+    {
+      this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+          _lighting ? "lighting on" : "lighting off");
+    }
+
     for (int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects(); ++i)
     {
       Ogre::MovableObject *obj = this->dataPtr->sceneNode->getAttachedObject(i);
@@ -959,6 +1180,11 @@ void Visual::SetLighting(bool _lighting)
     {
       Ogre::SceneNode *sn = dynamic_cast<Ogre::SceneNode *>(
           this->dataPtr->sceneNode->getChild(i));
+      if (this->dataPtr->shareMaterials)
+      {
+        this->SwitchSharedMaterials(sn,
+            _lighting ? "lighting on" : "lighting off");
+      }
       for (int j = 0; j < sn->numAttachedObjects(); j++)
       {
         Ogre::MovableObject *obj = sn->getAttachedObject(j);
@@ -1017,10 +1243,14 @@ void Visual::SetMaterial(const std::string &_materialName, bool _unique,
 
   if (_unique)
   {
-    // Create a custom material name
+    // Create a custom material name. Shared materials are used as they
+    // are, they are only cloned when they change.
     std::string newMaterialName;
-    newMaterialName = this->dataPtr->sceneNode->getName() + "_MATERIAL_" +
-        _materialName;
+    if (this->dataPtr->shareMaterials)
+      newMaterialName = _materialName;
+    else
+      newMaterialName = this->dataPtr->sceneNode->getName() + "_MATERIAL_" +
+          _materialName;
 
     if (this->GetMaterialName() == newMaterialName &&
         matAmbient == this->Ambient() &&
@@ -1066,7 +1296,7 @@ void Visual::SetMaterial(const std::string &_materialName, bool _unique,
         (Ogre::MaterialPtr)(Ogre::MaterialManager::getSingleton().getByName(
               this->dataPtr->myMaterialName));
     }
-    else
+    else if (!this->dataPtr->shareMaterials)
     {
       myMaterial = origMaterial->clone(this->dataPtr->myMaterialName);
     }
@@ -1134,6 +1364,18 @@ void Visual::SetMaterial(const std::string &_materialName, bool _unique,
       ->GetElement("name")->Set(_materialName);
 }
 
+/////////////////////////////////////////////////
+void Visual::SetShareMaterials(const bool _share)
+{
+  this->dataPtr->shareMaterials = _share;
+}
+
+/////////////////////////////////////////////////
+bool Visual::ShareMaterials() const
+{
+  return this->dataPtr->shareMaterials;
+}
+
 /////////////////////////////////////////////////
 void Visual::SetMaterialShaderParam(const std::string &_paramName,
     const std::string &_shaderType, const std::string &_value)
@@ -1203,6 +1445,12 @@ void Visual::SetMaterialShaderParam(const std::string &_paramName,
     }
   };
 
+  if (this->dataPtr->shareMaterials)
+  {
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+        _shaderType + " " + _paramName + " " + _value);
+  }
+
   // loop through material techniques and passes to find the param
   Ogre::MaterialPtr mat = Ogre::MaterialManager::getSingleton().getByName(
       this->dataPtr->myMaterialName);
@@ -1256,11 +1504,19 @@ void Visual::SetAmbient(const ignition::math::Color &_color,
 
   if (this->dataPtr->myMaterialName.empty())
   {
-    std::string matName = this->Name() + "_MATERIAL_";
-    Ogre::MaterialManager::getSingleton().create(matName, "General");
+    std::string matName = this->dataPtr->shareMaterials ?
+        SHARED_MATERIAL_PREFIX : this->Name() + "_MATERIAL_";
+    if (!Ogre::MaterialManager::getSingleton().resourceExists(matName))
+      Ogre::MaterialManager::getSingleton().create(matName, "General");
     this->SetMaterial(matName);
   }
 
+  if (this->dataPtr->shareMaterials)
+  {
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+        ColorChange("ambient", _color));
+  }
+
   for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
       ++i)
   {
@@ -1321,11 +1577,19 @@ void Visual::SetDiffuse(const ignition::math::Color &_color,
 
   if (this->dataPtr->myMaterialName.empty())
   {
-    std::string matName = this->Name() + "_MATERIAL_";
-    Ogre::MaterialManager::getSingleton().create(matName, "General");
+    std::string matName = this->dataPtr->shareMaterials ?
+        SHARED_MATERIAL_PREFIX : this->Name() + "_MATERIAL_";
+    if (!Ogre::MaterialManager::getSingleton().resourceExists(matName))
+      Ogre::MaterialManager::getSingleton().create(matName, "General");
     this->SetMaterial(matName);
   }
 
+  if (this->dataPtr->shareMaterials)
+  {
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+        ColorChange("diffuse", _color));
+  }
+
   for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
       i++)
   {
@@ -1391,11 +1655,19 @@ void Visual::SetSpecular(const ignition::math::Color &_color,
 
   if (this->dataPtr->myMaterialName.empty())
   {
-    std::string matName = this->Name() + "_MATERIAL_";
-    Ogre::MaterialManager::getSingleton().create(matName, "General");
+    std::string matName = this->dataPtr->shareMaterials ?
+        SHARED_MATERIAL_PREFIX : this->Name() + "_MATERIAL_";
+    if (!Ogre::MaterialManager::getSingleton().resourceExists(matName))
+      Ogre::MaterialManager::getSingleton().create(matName, "General");
     this->SetMaterial(matName);
   }
 
+  if (this->dataPtr->shareMaterials)
+  {
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+        ColorChange("specular", _color));
+  }
+
   for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
       i++)
   {
@@ -1451,6 +1723,12 @@ void Visual::SetSpecular(const ignition::math::Color &_color,
 void Visual::SetEmissive(const ignition::math::Color &_color,
     const bool _cascade)
 {
+  if (this->dataPtr->shareMaterials)
+  {
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+        ColorChange("emissive", _color));
+  }
+
   for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
       i++)
   {
@@ -1542,6 +1820,12 @@ void Visual::SetWireframe(bool _show)
     return;
 
   this->dataPtr->wireframe = _show;
+  if (this->dataPtr->shareMaterials)
+  {
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode,
+        _show ? "wireframe on" : "wireframe off");
+  }
+
   for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
       i++)
   {
@@ -1595,6 +1879,20 @@ void Visual::SetTransparencyInnerLoop(Ogre::SceneNode *_sceneNode)
   float derivedTransparency = this->dataPtr->inheritTransparency ?
       this->DerivedTransparency() : this->dataPtr->transparency;
 
+  if (this->dataPtr->shareMaterials)
+  {
+    // Shared materials that never changed transparency are already opaque
+    if (ignition::math::equal(derivedTransparency, 0.0f) &&
+        this->dataPtr->submeshMaterials.empty())
+    {
+      return;
+    }
+
+    std::ostringstream change;
+    change << "transparency " << derivedTransparency;
+    this->SwitchSharedMaterials(_sceneNode, change.str());
+  }
+
   for (unsigned int i = 0; i < _sceneNode->numAttachedObjects(); ++i)
   {
     Ogre::Entity *entity = nullptr;
@@ -1738,6 +2036,53 @@ void Visual::UpdateTransparency(const bool _cascade)
       this->dataPtr->transparency);
 }
 
+//////////////////////////////////////////////////
+void Visual::SwitchSharedMaterials(Ogre::SceneNode *_sceneNode,
+    const std::string &_change)
+{
+  if (!_sceneNode)
+    return;
+
+  for (unsigned int i = 0; i < _sceneNode->numAttachedObjects(); ++i)
+  {
+    Ogre::Entity *entity =
+        dynamic_cast<Ogre::Entity *>(_sceneNode->getAttachedObject(i));
+    if (!entity)
+      continue;
+
+    for (unsigned int j = 0; j < entity->getNumSubEntities(); ++j)
+    {
+      Ogre::SubEntity *subEntity = entity->getSubEntity(j);
+      Ogre::MaterialPtr material = subEntity->getMaterial();
+      if (material.isNull())
+        continue;
+
+      // The name only depends on the material and the change, so visuals
+      // that get the same changes end up with the same material
+      std::string sharedName = SHARED_MATERIAL_PREFIX + std::to_string(
+          std::hash<std::string>()(material->getName() + "|" + _change));
+
+      Ogre::MaterialPtr shared =
+          Ogre::MaterialManager::getSingleton().getByName(sharedName);
+      if (shared.isNull())
+        shared = material->clone(sharedName);
+
+      // keep a pointer to the material the shared one derives from, to
+      // restore material state when setting transparency
+      auto orig = this->dataPtr->submeshMaterials.find(material->getName());
+      if (orig != this->dataPtr->submeshMaterials.end())
+        this->dataPtr->submeshMaterials[sharedName] = orig->second;
+      else
+        this->dataPtr->submeshMaterials[sharedName] = material;
+
+      if (this->dataPtr->myMaterialName == material->getName())
+        this->dataPtr->myMaterialName = sharedName;
+
+      subEntity->setMaterial(shared);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void Visual::SetTransparency(float _trans)
 {
@@ -1897,6 +2242,7 @@ void Visual::SetPosition(const ignition::math::Vector3d &_pos)
   this->dataPtr->sceneNode->setPosition(_pos.X(), _pos.Y(), _pos.Z());
 
   this->dataPtr->sdf->GetElement("pose")->Set(this->Pose());
+  this->dataPtr->sdfPoseDirty = false;
 }
 
 //////////////////////////////////////////////////
@@ -1907,13 +2253,30 @@ void Visual::SetRotation(const ignition::math::Quaterniond &_rot)
       Ogre::Quaternion(_rot.W(), _rot.X(), _rot.Y(), _rot.Z()));
 
   this->dataPtr->sdf->GetElement("pose")->Set(this->Pose());
+  this->dataPtr->sdfPoseDirty = false;
 }
 
 //////////////////////////////////////////////////
 void Visual::SetPose(const ignition::math::Pose3d &_pose)
 {
-  this->SetPosition(_pose.Pos());
-  this->SetRotation(_pose.Rot());
+  GZ_ASSERT(this->dataPtr->sceneNode, "Visual SceneNode is null");
+  this->dataPtr->sceneNode->setPosition(
+      _pose.Pos().X(), _pose.Pos().Y(), _pose.Pos().Z());
+  this->dataPtr->sceneNode->setOrientation(Ogre::Quaternion(
+      _pose.Rot().W(), _pose.Rot().X(), _pose.Rot().Y(), _pose.Rot().Z()));
+
+  // Writing the pose to the SDF converts it to text, which is slow
+  this->dataPtr->sdfPoseDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Visual::UpdateSDFPose() const
+{
+  if (!this->dataPtr->sdfPoseDirty || !this->dataPtr->sdf)
+    return;
+
+  this->dataPtr->sdfPoseDirty = false;
+  this->dataPtr->sdf->GetElement("pose")->Set(this->Pose());
 }
 
 //////////////////////////////////////////////////
@@ -2033,6 +2396,8 @@ void Visual::SetNormalMap(const std::string &_nmap)
 {
   this->dataPtr->sdf->GetElement("material")->GetElement(
       "shader")->GetElement("normal_map")->GetValue()->Set(_nmap);
+  if (this->dataPtr->shareMaterials)
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode, "normal " + _nmap);
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
     RTShaderSystem::Instance()->UpdateShaders();
 }
@@ -2049,6 +2414,8 @@ void Visual::SetShaderType(const std::string &_type)
 {
   this->dataPtr->sdf->GetElement("material")->GetElement(
       "shader")->GetAttribute("type")->Set(_type);
+  if (this->dataPtr->shareMaterials)
+    this->SwitchSharedMaterials(this->dataPtr->sceneNode, "shader " + _type);
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
     RTShaderSystem::Instance()->UpdateShaders();
 }
@@ -2291,6 +2658,9 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
 
     Ogre::SkeletonPtr ogreSkeleton;
 
+    // Index of the submesh of _mesh of each Ogre submesh
+    std::vector<unsigned int> subMeshIndices;
+
     if (_mesh->HasSkeleton())
     {
       common::Skeleton *skel = _mesh->GetSkeleton();
@@ -2324,6 +2694,16 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
       if (!_subMesh.empty() && _mesh->GetSubMesh(i)->GetName() != _subMesh)
         continue;
 
+      // Compact submeshes go straight to the hardware buffers. Recentered
+      // and skinned submeshes need their own vertices.
+      const common::SubMesh *source = _mesh->GetSubMesh(i);
+      if (source->IsCompact() && !_centerSubmesh && !_mesh->HasSkeleton())
+      {
+        InsertCompactSubMesh(ogreMesh.get(), _mesh, source);
+        subMeshIndices.push_back(i);
+        continue;
+      }
+
       Ogre::SubMesh *ogreSubMesh;
       Ogre::VertexData *vertexData;
       Ogre::VertexDeclaration* vertexDecl;
@@ -2338,7 +2718,7 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
 
       // Copy the original submesh. We may need to modify the vertices, and
       // we don't want to change the original.
-      common::SubMesh subMesh(_mesh->GetSubMesh(i));
+      common::SubMesh subMesh(source);
 
       // Recenter the vertices if requested.
       if (_centerSubmesh)
@@ -2346,21 +2726,8 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
 
       ogreSubMesh = ogreMesh->createSubMesh();
       ogreSubMesh->useSharedVertices = false;
-      if (subMesh.GetPrimitiveType() == common::SubMesh::TRIANGLES)
-        ogreSubMesh->operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
-      else if (subMesh.GetPrimitiveType() == common::SubMesh::LINES)
-        ogreSubMesh->operationType = Ogre::RenderOperation::OT_LINE_LIST;
-      else if (subMesh.GetPrimitiveType() == common::SubMesh::LINESTRIPS)
-        ogreSubMesh->operationType = Ogre::RenderOperation::OT_LINE_STRIP;
-      else if (subMesh.GetPrimitiveType() == common::SubMesh::TRIFANS)
-        ogreSubMesh->operationType = Ogre::RenderOperation::OT_TRIANGLE_FAN;
-      else if (subMesh.GetPrimitiveType() == common::SubMesh::TRISTRIPS)
-        ogreSubMesh->operationType = Ogre::RenderOperation::OT_TRIANGLE_STRIP;
-      else if (subMesh.GetPrimitiveType() == common::SubMesh::POINTS)
-        ogreSubMesh->operationType = Ogre::RenderOperation::OT_POINT_LIST;
-      else
-        gzerr << "Unknown primitive type["
-              << subMesh.GetPrimitiveType() << "]\n";
+      subMeshIndices.push_back(i);
+      ogreSubMesh->operationType = OperationType(subMesh.GetPrimitiveType());
 
       ogreSubMesh->vertexData = new Ogre::VertexData();
       vertexData = ogreSubMesh->vertexData;
@@ -2500,17 +2867,7 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
       for (j = 0; j < subMesh.GetIndexCount(); j++)
         *indices++ = subMesh.GetIndex(j);
 
-      const common::Material *material;
-      material = _mesh->GetMaterial(subMesh.GetMaterialIndex());
-      if (material)
-      {
-        rendering::Material::Update(material);
-        ogreSubMesh->setMaterialName(material->GetName());
-      }
-      else
-      {
-        ogreSubMesh->setMaterialName("Gazebo/White");
-      }
+      SetSubMeshMaterial(ogreSubMesh, _mesh, &subMesh);
 
       // Unlock
       vBuf->unlock();
@@ -2541,6 +2898,12 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
           Ogre::Vector3(max.X(), max.Y(), max.Z())),
           false);
 
+    if (!this->dataPtr->lodDistances.empty())
+    {
+      InsertMeshLods(ogreMesh.get(), _mesh, subMeshIndices,
+          this->dataPtr->lodDistances);
+    }
+
     // this line makes clear the mesh is loaded (avoids memory leaks)
     ogreMesh->load();
   }
@@ -3379,12 +3742,29 @@ void Visual::SetSkeletonPose(const msgs::PoseAnimation &_pose)
     return;
   }
 
+  // Actors send their poses in the same order every frame, so the bones are
+  // only looked up by name when the skeleton or the number of poses changes.
+  std::vector<Ogre::Bone *> &bones = this->dataPtr->poseBones;
+  if (this->dataPtr->poseBonesSkeleton != this->dataPtr->skeleton ||
+      bones.size() != static_cast<size_t>(_pose.pose_size()))
+  {
+    bones.assign(_pose.pose_size(), nullptr);
+    for (int i = 0; i < _pose.pose_size(); i++)
+    {
+      const std::string &name = _pose.pose(i).name();
+      if (this->dataPtr->skeleton->hasBone(name))
+        bones[i] = this->dataPtr->skeleton->getBone(name);
+    }
+    this->dataPtr->poseBonesSkeleton = this->dataPtr->skeleton;
+  }
+
   for (int i = 0; i < _pose.pose_size(); i++)
   {
     const msgs::Pose& bonePose = _pose.pose(i);
-    if (!this->dataPtr->skeleton->hasBone(bonePose.name()))
+    Ogre::Bone *bone = bones[i];
+    if (!bone)
       continue;
-    Ogre::Bone *bone = this->dataPtr->skeleton->getBone(bonePose.name());
+
     Ogre::Vector3 p(bonePose.position().x(),
                     bonePose.position().y(),
                     bonePose.position().z());
@@ -3490,6 +3870,7 @@ void Visual::SetId(uint32_t _id)
 //////////////////////////////////////////////////
 sdf::ElementPtr Visual::GetSDF() const
 {
+  this->UpdateSDFPose();
   return this->dataPtr->sdf;
 }
 
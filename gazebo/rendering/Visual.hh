@@ -220,6 +220,18 @@ namespace gazebo
       public: void SetMaterial(const std::string &_materialName,
                                bool _unique = true, const bool _cascade = true);
 
+      /// \brief Set whether the visual shares its materials with the
+      /// visuals that look the same, instead of cloning unique ones. This
+      /// must be set before the visual is loaded.
+      /// \param[in] _share True to share materials.
+      /// \sa rendering::set_share_materials
+      public: void SetShareMaterials(const bool _share);
+
+      /// \brief Get whether the visual shares its materials with the
+      /// visuals that look the same.
+      /// \return True if materials are shared.
+      public: bool ShareMaterials() const;
+
       /// \brief Set a shader program parameter associated to this visual's
       /// material
       /// \param[in] _paramName Name of shader parameter
@@ -345,8 +357,11 @@ namespace gazebo
       /// \param[in] _rot The rotation of the visual.
       public: void SetRotation(const ignition::math::Quaterniond &_rot);
 
-      /// \brief Set the pose of the visual.
+      /// \brief Set the pose of the visual. The scene sets the poses of
+      /// moving visuals on every frame, so the pose in the SDF of the
+      /// visual is only updated when the SDF is requested.
       /// \param[in] _pose The new pose of the visual.
+      /// \sa GetSDF
       public: void SetPose(const ignition::math::Pose3d &_pose);
 
       /// \brief Get the position of the visual.
@@ -746,6 +761,19 @@ namespace gazebo
       /// \param[in] _cascade True to update the children's transparency too.
       private: void UpdateTransparency(const bool _cascade = true);
 
+      /// \brief Move the sub-entities of a scene node of a visual that
+      /// shares its materials to the shared materials which, in addition,
+      /// have the given change. The caller then applies the change, which
+      /// must only depend on _change, to the new materials.
+      /// \param[in] _sceneNode The scene node whose entities are changed.
+      /// \param[in] _change Unique description of the change.
+      private: void SwitchSharedMaterials(Ogre::SceneNode *_sceneNode,
+                   const std::string &_change);
+
+      /// \brief Write the pose of the visual to its SDF, if it changed
+      /// since the SDF was last updated.
+      private: void UpdateSDFPose() const;
+
       /// \internal
       /// \brief Pointer to private data.
       protected: VisualPrivate *dataPtr;
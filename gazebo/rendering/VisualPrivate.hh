@@ -42,6 +42,7 @@ namespace Ogre
   class StaticGeometry;
   class RibbonTrail;
   class AnimationState;
+  class Bone;
   class SkeletonInstance;
 }
 
@@ -122,6 +123,14 @@ namespace gazebo
       /// \brief The visual's skeleton, used only for person simulation.
       public: Ogre::SkeletonInstance *skeleton;
 
+      /// \brief Bone of every pose of the last skeleton pose message, null
+      /// for the poses of links, so that bones are only looked up by name
+      /// when the poses change.
+      public: std::vector<Ogre::Bone *> poseBones;
+
+      /// \brief Skeleton the bones of poseBones belong to.
+      public: Ogre::SkeletonInstance *poseBonesSkeleton = nullptr;
+
       /// \brief Connection for the pre render event.
       public: event::ConnectionPtr preRenderConnection;
 
@@ -176,6 +185,13 @@ namespace gazebo
       /// \brief The visual's submesh name.
       public: std::string subMeshName;
 
+      /// \brief True if the pose was set since it was written to the SDF.
+      public: bool sdfPoseDirty = false;
+
+      /// \brief Distances from the camera at which the reduced levels of
+      /// detail of the visual's mesh are used, in increasing order.
+      public: std::vector<double> lodDistances;
+
       /// \brief Ambient color of the visual.
       public: ignition::math::Color ambient = ignition::math::Color(0, 0, 0, 0);
 
@@ -222,6 +238,10 @@ namespace gazebo
 
       /// \brief Original ogre materials used by the submeshes in the visual
       public: std::map<std::string, Ogre::MaterialPtr> submeshMaterials;
+
+      /// \brief True if the visual shares its materials with the visuals
+      /// that look the same.
+      public: bool shareMaterials = false;
     };
     /// \}
   }
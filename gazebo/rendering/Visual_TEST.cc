@@ -839,6 +839,63 @@ TEST_F(Visual_TEST, Material)
   EXPECT_EQ(boxVis2->GetMaterialName(), "Gazebo/OrangeTransparent");
 }
 
+/////////////////////////////////////////////////
+TEST_F(Visual_TEST, ShareMaterials)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_NE(scene, nullptr);
+
+  // Two visuals that look the same share their material
+  std::vector<gazebo::rendering::VisualPtr> visuals;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    sdf::ElementPtr boxSDF(new sdf::Element);
+    sdf::initFile("visual.sdf", boxSDF);
+    sdf::readString(GetVisualSDFString("visual_box_" + std::to_string(i),
+        "box", ignition::math::Vector3d::One, ignition::math::Pose3d::Zero,
+        0, true, "Gazebo/Red"), boxSDF);
+    gazebo::rendering::VisualPtr vis(new gazebo::rendering::Visual(
+        "shared_box_visual_" + std::to_string(i), scene));
+    EXPECT_FALSE(vis->ShareMaterials());
+    vis->SetShareMaterials(true);
+    EXPECT_TRUE(vis->ShareMaterials());
+    vis->Load(boxSDF);
+    visuals.push_back(vis);
+  }
+  EXPECT_FALSE(visuals[0]->GetMaterialName().empty());
+  EXPECT_EQ(visuals[0]->GetMaterialName(), visuals[1]->GetMaterialName());
+
+  // The colors of the sdf are applied to a copy of the script material
+  Ogre::MaterialPtr red =
+      Ogre::MaterialManager::getSingleton().getByName("Gazebo/Red");
+  ASSERT_FALSE(red.isNull());
+  EXPECT_NE(red->getTechnique(0)->getPass(0)->getAmbient(),
+      Ogre::ColourValue::White);
+
+  // A visual that changes gets another material, without changing the
+  // other visual
+  std::string sharedName = visuals[1]->GetMaterialName();
+  ignition::math::Color color(0.1, 0.2, 0.3, 1.0);
+  visuals[0]->SetAmbient(color);
+  EXPECT_NE(visuals[0]->GetMaterialName(), sharedName);
+  EXPECT_EQ(visuals[1]->GetMaterialName(), sharedName);
+  EXPECT_EQ(visuals[0]->Ambient(), color);
+  EXPECT_NE(visuals[1]->Ambient(), color);
+
+  // The same change leads to the same material
+  visuals[1]->SetAmbient(color);
+  EXPECT_EQ(visuals[0]->GetMaterialName(), visuals[1]->GetMaterialName());
+
+  // Transparency is shared the same way
+  visuals[0]->SetTransparency(0.5);
+  EXPECT_NE(visuals[0]->GetMaterialName(), visuals[1]->GetMaterialName());
+  visuals[1]->SetTransparency(0.5);
+  EXPECT_EQ(visuals[0]->GetMaterialName(), visuals[1]->GetMaterialName());
+  EXPECT_FLOAT_EQ(visuals[0]->DerivedTransparency(), 0.5f);
+}
+
 /////////////////////////////////////////////////
 TEST_F(Visual_TEST, ChildMaterial)
 {
@@ -2045,6 +2102,10 @@ TEST_F(Visual_TEST, Pose)
   EXPECT_EQ(sphereVis->Pose(), newSpherePose);
   EXPECT_EQ(sphereVis->WorldPose(), newSpherePose + boxPose);
   EXPECT_EQ(sphereVis->InitialRelativePose(), spherePose);
+
+  // the sdf has the new pose once requested
+  EXPECT_EQ(sphereVis->GetSDF()->Get<ignition::math::Pose3d>("pose"),
+      newSpherePose);
 }
 
 /////////////////////////////////////////////////
@@ -698,8 +698,14 @@ void WideAngleCamera::RenderImpl()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->renderMutex);
 
+  this->UpdateEnvFaces();
+
+  // Faces out of the field of view keep their last image, never sampled
   for (int i = 0; i < 6; ++i)
-    this->dataPtr->envRenderTargets[i]->update();
+  {
+    if (this->dataPtr->envFaces[i])
+      this->dataPtr->envRenderTargets[i]->update();
+  }
 
   this->dataPtr->compMat->getTechnique(0)->getPass(0)->getTextureUnitState(0)->
       setTextureName(this->dataPtr->envCubeMapTexture->getName());
@@ -707,6 +713,98 @@ void WideAngleCamera::RenderImpl()
   this->renderTarget->update();
 }
 
+//////////////////////////////////////////////////
+void WideAngleCamera::UpdateEnvFaces()
+{
+  CameraLens *lens = this->Lens();
+  const double c1 = lens->C1();
+  const double c2 = lens->C2();
+  const double c3 = lens->C3();
+  const double hfov = this->HFOV().Radian();
+  const double ratio = this->AspectRatio();
+  const std::string fun = lens->Fun();
+
+  std::vector<double> params = {c1, c2, c3, lens->F(), lens->CutOffAngle(),
+      lens->ScaleToHFOV() ? 1.0 : 0.0, hfov, ratio};
+  if (params == this->dataPtr->envFacesParams &&
+      fun == this->dataPtr->envFacesFun)
+  {
+    return;
+  }
+  this->dataPtr->envFacesParams = params;
+  this->dataPtr->envFacesFun = fun;
+
+  // Same mapping as the Gazebo/WideLensMap material
+  CameraLensPrivate::MapFunctionEnum mapFun(fun);
+  double f = lens->F();
+  if (lens->ScaleToHFOV())
+    f = 1.0 / (c1 * mapFun.Apply(static_cast<float>((hfov/2.0)/c2 + c3)));
+  const double cutRadius = c1 * f *
+      mapFun.Apply(static_cast<float>(lens->CutOffAngle()/c2 + c3));
+
+  for (int i = 0; i < 6; ++i)
+    this->dataPtr->envFaces[i] = false;
+
+  // Sample the image, and mark the faces that the direction of each sample
+  // falls in, or is close to, so that filtering across the seams and the
+  // directions between samples are covered
+  const int samples = 64;
+  for (int i = 0; i <= samples; ++i)
+  {
+    for (int j = 0; j <= samples; ++j)
+    {
+      const double x = -(-1.0 + 2.0 * i / samples);
+      const double y = -(-1.0 + 2.0 * j / samples) / ratio;
+      const double r = std::sqrt(x * x + y * y);
+      if (r >= cutRadius)
+        continue;
+
+      ignition::math::Vector3d dir(0, 0, 1);
+      if (r > 0)
+      {
+        const double param = r / (c1 * f);
+        double inverse = param;
+        if (fun == "sin")
+          inverse = std::asin(param);
+        else if (fun == "tan")
+          inverse = std::atan(param);
+        if (!std::isfinite(inverse))
+          continue;
+
+        const double theta = (inverse - c3) * c2;
+        dir.Set(-std::sin(theta) * x / r, std::sin(theta) * y / r,
+            std::cos(theta));
+      }
+
+      const double largest = dir.Abs().Max();
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        if (std::fabs(dir[axis]) >= 0.9 * largest)
+          this->dataPtr->envFaces[axis * 2 + (dir[axis] < 0 ? 1 : 0)] = true;
+      }
+    }
+  }
+
+  this->dataPtr->envFaceCount = 0;
+  for (int i = 0; i < 6; ++i)
+    this->dataPtr->envFaceCount += this->dataPtr->envFaces[i] ? 1 : 0;
+
+  // Render everything rather than nothing if the lens is degenerate
+  if (this->dataPtr->envFaceCount == 0)
+  {
+    for (int i = 0; i < 6; ++i)
+      this->dataPtr->envFaces[i] = true;
+    this->dataPtr->envFaceCount = 6;
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int WideAngleCamera::RenderedEnvFaceCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->renderMutex);
+  return this->dataPtr->envFaceCount;
+}
+
 //////////////////////////////////////////////////
 void WideAngleCamera::notifyMaterialRender(Ogre::uint32 /*_pass_id*/,
                                            Ogre::MaterialPtr &_material)
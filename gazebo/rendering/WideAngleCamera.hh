@@ -236,6 +236,12 @@ namespace gazebo
       /// \return A list of OGRE cameras
       public: std::vector<Ogre::Camera *> OgreEnvCameras() const;
 
+      /// \brief Get the number of faces of the cube map rendered each frame.
+      /// Faces the lens never samples, given its mapping function, cut-off
+      /// angle and the aspect ratio of the image, are skipped.
+      /// \return Number of faces, up to 6.
+      public: unsigned int RenderedEnvFaceCount() const;
+
       /// \brief Set the camera's render target
       /// \param[in] _textureName Name used as a base for environment texture
       protected: void CreateEnvRenderTexture(const std::string &_textureName);
@@ -253,6 +259,10 @@ namespace gazebo
       protected: void notifyMaterialRender(Ogre::uint32 _pass_id,
         Ogre::MaterialPtr &_material) override;
 
+      /// \brief Find the faces of the cube map sampled by the lens, when
+      /// the lens or the image changed since the last frame.
+      private: void UpdateEnvFaces();
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<WideAngleCameraPrivate> dataPtr;
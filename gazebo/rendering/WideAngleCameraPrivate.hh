@@ -18,6 +18,8 @@
 #define _GAZEBO_RENDERING_WIDE_ANGLE_CAMERA_CAMERA_PRIVATE_HH_
 
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/util/system.hh"
@@ -68,6 +70,18 @@ namespace gazebo
       /// \brief Camera lens description
       public: CameraLens *lens;
 
+      /// \brief True for the faces of the cube map sampled by the lens.
+      public: bool envFaces[6] = {true, true, true, true, true, true};
+
+      /// \brief Number of true values in envFaces.
+      public: unsigned int envFaceCount = 6;
+
+      /// \brief Lens and image parameters envFaces was computed for.
+      public: std::vector<double> envFacesParams;
+
+      /// \brief Lens mapping function envFaces was computed for.
+      public: std::string envFacesFun;
+
       /// \brief Mutex to lock while rendering the world
       public: std::mutex renderMutex;
 
@@ -97,11 +97,17 @@ int WindowManager::CreateWindow(const std::string &_ogreHandle,
   Ogre::RenderWindow *window = NULL;
 
   // Mac and Windows *must* use externalWindow handle.
+  // Without a handle, the window uses the current GL context.
+  if (_ogreHandle.empty())
+    params["currentGLContext"] = "true";
+  else
+  {
 #if defined(__APPLE__) || defined(_MSC_VER)
-  params["externalWindowHandle"] = _ogreHandle;
+    params["externalWindowHandle"] = _ogreHandle;
 #else
-  params["parentWindowHandle"] = _ogreHandle;
+    params["parentWindowHandle"] = _ogreHandle;
 #endif
+  }
   params["FSAA"] = "4";
   params["stereoMode"] = "Frame Sequential";
 
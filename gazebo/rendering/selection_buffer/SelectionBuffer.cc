@@ -16,6 +16,7 @@
 */
 
 #include <memory>
+#include <string>
 #include <ignition/math/Color.hh>
 
 #include "gazebo/common/Console.hh"
@@ -71,6 +72,27 @@ namespace gazebo
       /// \brief A 2D overlay used for debugging the selection buffer. It
       /// is hidden by default.
       Ogre::Overlay *selectionDebugOverlay;
+
+      /// \brief True if the last query can be returned again.
+      bool cacheValid = false;
+
+      /// \brief X coordinate of the last query.
+      int cacheX = 0;
+
+      /// \brief Y coordinate of the last query.
+      int cacheY = 0;
+
+      /// \brief Camera position of the last query.
+      Ogre::Vector3 cachePosition;
+
+      /// \brief Camera orientation of the last query.
+      Ogre::Quaternion cacheOrientation;
+
+      /// \brief Camera projection of the last query.
+      Ogre::Matrix4 cacheProjection;
+
+      /// \brief Name of the entity found by the last query.
+      std::string cacheEntityName;
     };
   }
 }
@@ -128,6 +150,12 @@ void SelectionBuffer::Update()
       Ogre::RenderTarget::FB_FRONT);
 }
 
+/////////////////////////////////////////////////
+void SelectionBuffer::Invalidate()
+{
+  this->dataPtr->cacheValid = false;
+}
+
 /////////////////////////////////////////////////
 void SelectionBuffer::DeleteRTTBuffer()
 {
@@ -200,6 +228,24 @@ Ogre::Entity *SelectionBuffer::OnSelectionClick(int _x, int _y)
       || _y >= static_cast<int>(targetHeight))
     return nullptr;
 
+  const Ogre::Vector3 &position =
+      this->dataPtr->camera->getDerivedPosition();
+  const Ogre::Quaternion &orientation =
+      this->dataPtr->camera->getDerivedOrientation();
+  const Ogre::Matrix4 &projection =
+      this->dataPtr->camera->getProjectionMatrix();
+
+  // Hover, manipulation and snapping often query the same pixel before the
+  // scene is rendered again, so read the buffer back only once for them.
+  if (this->dataPtr->cacheValid && this->dataPtr->cacheX == _x &&
+      this->dataPtr->cacheY == _y &&
+      this->dataPtr->cachePosition == position &&
+      this->dataPtr->cacheOrientation == orientation &&
+      this->dataPtr->cacheProjection == projection)
+  {
+    return this->CachedEntity();
+  }
+
   // 1x1 selection buffer, adapted from rviz
   // http://docs.ros.org/indigo/api/rviz/html/c++/selection__manager_8cpp.html
   unsigned int width = 1;
@@ -219,11 +265,9 @@ Ogre::Entity *SelectionBuffer::OnSelectionClick(int _x, int _y)
   transMatrix[0][3] -= x1+x2;
   transMatrix[1][3] += y1+y2;
   this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
-      scaleMatrix * transMatrix * this->dataPtr->camera->getProjectionMatrix());
-  this->dataPtr->selectionCamera->setPosition(
-      this->dataPtr->camera->getDerivedPosition());
-  this->dataPtr->selectionCamera->setOrientation(
-      this->dataPtr->camera->getDerivedOrientation());
+      scaleMatrix * transMatrix * projection);
+  this->dataPtr->selectionCamera->setPosition(position);
+  this->dataPtr->selectionCamera->setOrientation(orientation);
   Ogre::Viewport* renderViewport = this->dataPtr->renderTexture->getViewport(0);
   renderViewport->setDimensions(0, 0, width, height);
 
@@ -242,11 +286,25 @@ Ogre::Entity *SelectionBuffer::OnSelectionClick(int _x, int _y)
   ignition::math::Color cv;
   cv.SetFromARGB(color);
   cv.A(1.0);
-  const std::string &entName =
+  this->dataPtr->cacheEntityName =
     this->dataPtr->materialSwitchListener->GetEntityName(cv);
+  this->dataPtr->cacheX = _x;
+  this->dataPtr->cacheY = _y;
+  this->dataPtr->cachePosition = position;
+  this->dataPtr->cacheOrientation = orientation;
+  this->dataPtr->cacheProjection = projection;
+  this->dataPtr->cacheValid = true;
+
+  return this->CachedEntity();
+}
 
-  if (entName.empty())
-    return 0;
+/////////////////////////////////////////////////
+Ogre::Entity *SelectionBuffer::CachedEntity() const
+{
+  // The entity may have been destroyed since the buffer was read
+  const std::string &entName = this->dataPtr->cacheEntityName;
+  if (entName.empty() || !this->dataPtr->sceneMgr->hasEntity(entName))
+    return nullptr;
   else
     return this->dataPtr->sceneMgr->getEntity(entName);
 }
@@ -60,6 +60,16 @@ namespace gazebo
       /// \brief Call this to update the selection buffer contents
       public: void Update();
 
+      /// \brief Discard the result of the last query. Call this when the
+      /// scene changes, e.g. it's rendered again, so that a query at the
+      /// same pixel reads the buffer again.
+      public: void Invalidate();
+
+      /// \brief Get the entity found by the last query.
+      /// \return The entity, or null if none was found or it no longer
+      /// exists.
+      private: Ogre::Entity *CachedEntity() const;
+
       /// \brief Delete the render texture
       private: void DeleteRTTBuffer();
 
@@ -16,7 +16,7 @@
 */
 #include <boost/algorithm/string.hpp>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/common/common.hh"
 #include "gazebo/physics/physics.hh"
@@ -37,6 +37,8 @@ AltimeterSensor::AltimeterSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new AltimeterSensorPrivate)
 {
+  // An altimeter only reads the pose and velocity of its link
+  this->SetConcurrentUpdate([]() { return true; });
 }
 
 /////////////////////////////////////////////////
@@ -116,6 +118,13 @@ void AltimeterSensor::Fini()
   this->dataPtr->parentLink.reset();
 }
 
+/////////////////////////////////////////////////
+bool AltimeterSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->altPub && this->dataPtr->altPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void AltimeterSensor::Init()
 {
@@ -66,6 +66,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Fini();
 
+      // Documentation inherited.
+      public: virtual bool IsActive() const;
+
       /// \brief Accessor for current vertical position
       /// \return Current vertical position
       public: double Altitude() const;
@@ -15,14 +15,18 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <cmath>
+#include <cstring>
 #include <functional>
-#include <ignition/common/Profiler.hh>
+#include <type_traits>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/msgs/Utility.hh>
 
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Image.hh"
 #include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Timer.hh"
 
 #include "gazebo/msgs/msgs.hh"
 
@@ -47,6 +51,57 @@ using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("camera", CameraSensor)
 
+//////////////////////////////////////////////////
+/// \brief Bin a region of interest of a frame.
+/// \param[in] _src Frame.
+/// \param[in] _srcWidth Width of the frame in pixels.
+/// \param[in] _channels Number of channels of a pixel.
+/// \param[in] _region Region to extract.
+/// \param[out] _dst Binned region, of the size of the region divided by the
+/// binning factor.
+template<typename T>
+static void BinImageRegion(const T *_src, const unsigned int _srcWidth,
+    const unsigned int _channels, const CameraImageRegion &_region, T *_dst)
+{
+  const unsigned int b = _region.binning;
+  const unsigned int width = _region.width / b;
+  const unsigned int height = _region.height / b;
+
+  for (unsigned int r = 0; r < height; ++r)
+  {
+    for (unsigned int c = 0; c < width; ++c)
+    {
+      const T *block = _src + ((_region.y + r * b) * _srcWidth +
+          _region.x + c * b) * _channels;
+      for (unsigned int ch = 0; ch < _channels; ++ch)
+      {
+        // Average the finite samples, so that a depth bin keeps the depth of
+        // the surfaces it sees
+        double sum = 0;
+        unsigned int count = 0;
+        for (unsigned int dy = 0; dy < b; ++dy)
+        {
+          const T *row = block + dy * _srcWidth * _channels + ch;
+          for (unsigned int dx = 0; dx < b; ++dx)
+          {
+            const double value = row[dx * _channels];
+            if (std::isfinite(value))
+            {
+              sum += value;
+              ++count;
+            }
+          }
+        }
+
+        double mean = count ? sum / count : static_cast<double>(block[ch]);
+        if (std::is_integral<T>::value && count)
+          mean = std::round(mean);
+        *_dst++ = static_cast<T>(mean);
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 CameraSensor::CameraSensor()
 : Sensor(sensors::IMAGE),
@@ -109,6 +164,7 @@ void CameraSensor::Load(const std::string &_worldName)
   }
 
   this->imagePub = this->node->Advertise<msgs::ImageStamped>(this->Topic(), 50);
+  this->imagePub->SetPriority(transport::Publisher::BULK);
 
   ignition::transport::AdvertiseMessageOptions opts;
   opts.SetMsgsPerSec(50);
@@ -165,6 +221,7 @@ void CameraSensor::Init()
 
     this->camera->Init();
     this->camera->CreateRenderTexture(scopedName + "_RttTex");
+    this->SetMemoryUsage(this->camera->ImageByteSize());
     ignition::math::Pose3d cameraPose = this->pose;
     if (cameraSdf->HasElement("pose"))
       cameraPose = cameraSdf->Get<ignition::math::Pose3d>("pose") + cameraPose;
@@ -197,6 +254,11 @@ void CameraSensor::Fini()
 {
   this->imagePub.reset();
 
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->regionMutex);
+    this->dataPtr->regions.clear();
+  }
+
   if (this->camera)
   {
     this->scene->RemoveCamera(this->camera->Name());
@@ -306,7 +368,10 @@ void CameraSensor::Render()
       return;
 
     // Update all the cameras
+    common::Timer timer;
+    timer.Start();
     this->camera->Render();
+    this->RecordStageTime(STAGE_RENDER, timer.GetElapsed());
 
     this->dataPtr->rendered = true;
     this->dataPtr->renderNeeded = false;
@@ -317,7 +382,10 @@ void CameraSensor::Render()
       return;
 
     // Update all the cameras
+    common::Timer timer;
+    timer.Start();
     this->camera->Render();
+    this->RecordStageTime(STAGE_RENDER, timer.GetElapsed());
 
     this->dataPtr->rendered = true;
     this->lastMeasurementTime = this->scene->SimTime();
@@ -333,7 +401,10 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
     return false;
 
   IGN_PROFILE_BEGIN("PostRender");
+  common::Timer timer;
+  timer.Start();
   this->camera->PostRender();
+  this->RecordStageTime(STAGE_READBACK, timer.GetElapsed());
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("fillarray");
@@ -341,23 +412,26 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
   if ((this->imagePub && this->imagePub->HasConnections()) ||
       this->imagePubIgn.HasConnections())
   {
+    timer.Start();
     auto simTime = this->scene->SimTime();
     if (this->imagePub && this->imagePub->HasConnections())
     {
-      msgs::ImageStamped msg;
-      msgs::Set(msg.mutable_time(), simTime);
-      msg.mutable_image()->set_width(this->camera->ImageWidth());
-      msg.mutable_image()->set_height(this->camera->ImageHeight());
-      msg.mutable_image()->set_pixel_format(common::Image::ConvertPixelFormat(
-            this->camera->ImageFormat()));
-
-      msg.mutable_image()->set_step(this->camera->ImageWidth() *
+      // Fill a recycled message, whose image storage is reused, and hand it
+      // to the publisher without a copy
+      auto msg = this->imagePub->BorrowMessage<msgs::ImageStamped>();
+      msgs::Set(msg->mutable_time(), simTime);
+      msg->mutable_image()->set_width(this->camera->ImageWidth());
+      msg->mutable_image()->set_height(this->camera->ImageHeight());
+      msg->mutable_image()->set_pixel_format(
+          common::Image::ConvertPixelFormat(this->camera->ImageFormat()));
+
+      msg->mutable_image()->set_step(this->camera->ImageWidth() *
           this->camera->ImageDepth());
-      msg.mutable_image()->set_data(this->camera->ImageData(),
-          msg.image().width() * this->camera->ImageDepth() *
-          msg.image().height());
+      msg->mutable_image()->set_data(this->camera->ImageData(),
+          msg->image().width() * this->camera->ImageDepth() *
+          msg->image().height());
 
-      this->imagePub->Publish(msg);
+      this->imagePub->Publish(transport::MessagePtr(msg));
     }
 
     if (this->imagePubIgn.HasConnections())
@@ -379,6 +453,16 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
 
       this->imagePubIgn.Publish(msg);
     }
+    this->RecordStageTime(STAGE_PUBLISH, timer.GetElapsed());
+  }
+
+  if (this->ImageRegionsConnected())
+  {
+    timer.Start();
+    this->PublishImageRegions(this->camera->ImageData(),
+        common::Image::ConvertPixelFormat(this->camera->ImageFormat()),
+        this->camera->ImageDepth(), this->scene->SimTime());
+    this->RecordStageTime(STAGE_PUBLISH, timer.GetElapsed());
   }
 
   this->dataPtr->rendered = false;
@@ -440,12 +524,184 @@ bool CameraSensor::SaveFrame(const std::string &_filename)
     return false;
 }
 
+//////////////////////////////////////////////////
+std::string CameraSensor::AddImageRegion(const std::string &_name,
+    const ignition::math::Vector2i &_offset,
+    const ignition::math::Vector2i &_size, const unsigned int _binning)
+{
+  if (!this->node)
+  {
+    gzerr << "Unable to add image region [" << _name << "] to camera sensor ["
+          << this->Name() << "] before it is loaded" << std::endl;
+    return std::string();
+  }
+
+  const int width = this->ImageWidth();
+  const int height = this->ImageHeight();
+  if (_name.empty() || _binning == 0 || _offset.X() < 0 || _offset.Y() < 0 ||
+      _size.X() <= 0 || _size.Y() <= 0 ||
+      _offset.X() + _size.X() > width || _offset.Y() + _size.Y() > height ||
+      _size.X() % _binning != 0 || _size.Y() % _binning != 0)
+  {
+    gzerr << "Invalid image region [" << _name << "] of camera sensor ["
+          << this->Name() << "]: offset [" << _offset << "], size ["
+          << _size << "], binning [" << _binning << "] in a ["
+          << width << "x" << height << "] image" << std::endl;
+    return std::string();
+  }
+
+  const std::string topic = this->Topic() + "/" + _name;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->regionMutex);
+  for (auto const &region : this->dataPtr->regions)
+  {
+    if (region.name == _name)
+    {
+      gzerr << "Camera sensor [" << this->Name() << "] already has an image "
+            << "region [" << _name << "]" << std::endl;
+      return std::string();
+    }
+  }
+
+  CameraImageRegion region;
+  region.name = _name;
+  region.x = _offset.X();
+  region.y = _offset.Y();
+  region.width = _size.X();
+  region.height = _size.Y();
+  region.binning = _binning;
+  region.pub = this->node->Advertise<msgs::ImageStamped>(topic, 50);
+  region.pub->SetPriority(transport::Publisher::BULK);
+  this->dataPtr->regions.push_back(region);
+
+  return topic;
+}
+
+//////////////////////////////////////////////////
+bool CameraSensor::RemoveImageRegion(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->regionMutex);
+  for (auto it = this->dataPtr->regions.begin();
+       it != this->dataPtr->regions.end(); ++it)
+  {
+    if (it->name == _name)
+    {
+      this->dataPtr->regions.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool CameraSensor::ImageRegionsConnected() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->regionMutex);
+  for (auto const &region : this->dataPtr->regions)
+  {
+    if (region.pub->HasConnections())
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+void CameraSensor::PublishImageRegions(const unsigned char *_data,
+    const common::Image::PixelFormat _format, const unsigned int _pixelSize,
+    const common::Time &_time)
+{
+  if (!_data || _pixelSize == 0)
+    return;
+
+  const unsigned int frameWidth = this->camera->ImageWidth();
+
+  // Formats whose pixels can't be averaged per channel are only cropped
+  bool binnable = true;
+  switch (_format)
+  {
+    case common::Image::R_FLOAT16:
+    case common::Image::RGB_FLOAT16:
+    case common::Image::BAYER_RGGB8:
+    case common::Image::BAYER_BGGR8:
+    case common::Image::BAYER_GBRG8:
+    case common::Image::BAYER_GRBG8:
+      binnable = false;
+      break;
+    default:
+      break;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->regionMutex);
+  for (auto const &region : this->dataPtr->regions)
+  {
+    if (!region.pub->HasConnections())
+      continue;
+
+    CameraImageRegion binned = region;
+    if (!binnable)
+      binned.binning = 1;
+    const unsigned int width = binned.width / binned.binning;
+    const unsigned int height = binned.height / binned.binning;
+
+    auto msg = region.pub->BorrowMessage<msgs::ImageStamped>();
+    msgs::Set(msg->mutable_time(), _time);
+    msgs::Image *image = msg->mutable_image();
+    image->set_width(width);
+    image->set_height(height);
+    image->set_pixel_format(_format);
+    image->set_step(width * _pixelSize);
+
+    std::string *data = image->mutable_data();
+    data->resize(width * height * _pixelSize);
+    unsigned char *dst = reinterpret_cast<unsigned char *>(&(*data)[0]);
+
+    if (binned.binning == 1)
+    {
+      // Copy the rows of the crop
+      for (unsigned int r = 0; r < height; ++r)
+      {
+        std::memcpy(dst + r * width * _pixelSize,
+            _data + ((binned.y + r) * frameWidth + binned.x) * _pixelSize,
+            width * _pixelSize);
+      }
+    }
+    else if (_format == common::Image::R_FLOAT32 ||
+        _format == common::Image::RGB_FLOAT32)
+    {
+      BinImageRegion(reinterpret_cast<const float *>(_data), frameWidth,
+          _pixelSize / sizeof(float), binned, reinterpret_cast<float *>(dst));
+    }
+    else if (_format == common::Image::L_INT16 ||
+        _format == common::Image::RGB_INT16 ||
+        _format == common::Image::BGR_INT16)
+    {
+      BinImageRegion(reinterpret_cast<const uint16_t *>(_data), frameWidth,
+          _pixelSize / sizeof(uint16_t), binned,
+          reinterpret_cast<uint16_t *>(dst));
+    }
+    else if (_format == common::Image::RGB_INT32 ||
+        _format == common::Image::BGR_INT32)
+    {
+      BinImageRegion(reinterpret_cast<const uint32_t *>(_data), frameWidth,
+          _pixelSize / sizeof(uint32_t), binned,
+          reinterpret_cast<uint32_t *>(dst));
+    }
+    else
+    {
+      BinImageRegion(_data, frameWidth, _pixelSize, binned, dst);
+    }
+
+    region.pub->Publish(transport::MessagePtr(msg));
+  }
+}
+
 //////////////////////////////////////////////////
 bool CameraSensor::IsActive() const
 {
   return Sensor::IsActive() ||
     (this->imagePub && this->imagePub->HasConnections()) ||
-    this->imagePubIgn.HasConnections();
+    this->imagePubIgn.HasConnections() ||
+    this->ImageRegionsConnected();
 }
 
 //////////////////////////////////////////////////
@@ -19,8 +19,10 @@
 
 #include <memory>
 #include <string>
+#include <ignition/math/Vector2.hh>
 #include <ignition/transport/Node.hh>
 
+#include "gazebo/common/Image.hh"
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -109,12 +111,55 @@ namespace gazebo
       /// \return True if successful, false if unsuccessful.
       public: bool SaveFrame(const std::string &_filename);
 
+      /// \brief Publish a region of interest of the images on its own
+      /// topic, the image topic followed by the name of the region.
+      ///
+      /// The region is cropped from each rendered frame and binned, each
+      /// pixel of the region averaging a square of _binning by _binning
+      /// pixels of the frame, so that subscribers needing only a crop or a
+      /// lower resolution receive and deserialize less data. Images of
+      /// 16-bit floats and Bayer images are cropped but not binned. A
+      /// region is only extracted while its topic has subscribers.
+      /// \param[in] _name Name of the region, unique for this sensor.
+      /// \param[in] _offset Top left corner of the region in the frame, in
+      /// pixels.
+      /// \param[in] _size Size of the region in the frame, in pixels, a
+      /// multiple of _binning.
+      /// \param[in] _binning Binning factor, 1 to only crop.
+      /// \return The topic of the region, empty if the region is invalid.
+      /// \sa RemoveImageRegion
+      public: std::string AddImageRegion(const std::string &_name,
+                  const ignition::math::Vector2i &_offset,
+                  const ignition::math::Vector2i &_size,
+                  const unsigned int _binning = 1);
+
+      /// \brief Stop publishing a region of interest.
+      /// \param[in] _name Name of the region.
+      /// \return True if the region existed.
+      /// \sa AddImageRegion
+      public: bool RemoveImageRegion(const std::string &_name);
+
       // Documentation inherited
       public: virtual bool IsActive() const override;
 
       // Documentation inherited
       protected: virtual bool UpdateImpl(const bool _force) override;
 
+      /// \brief Get whether a region of interest has subscribers.
+      /// \return True if a region topic has subscribers.
+      protected: bool ImageRegionsConnected() const;
+
+      /// \brief Publish the regions of interest with subscribers.
+      /// \param[in] _data Frame to extract the regions from, of the size of
+      /// the images of the camera.
+      /// \param[in] _format Pixel format of the frame.
+      /// \param[in] _pixelSize Size of a pixel of the frame in bytes.
+      /// \param[in] _time Time of the frame.
+      protected: void PublishImageRegions(const unsigned char *_data,
+                     const common::Image::PixelFormat _format,
+                     const unsigned int _pixelSize,
+                     const common::Time &_time);
+
       /// \brief Finalize the camera
       protected: virtual void Fini() override;
 
@@ -18,11 +18,42 @@
 #define GAZEBO_SENSORS_CAMERASENSOR_PRIVATE_HH_
 
 #include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
 {
   namespace sensors
   {
+    /// \internal
+    /// \brief Region of interest published by a camera sensor.
+    class CameraImageRegion
+    {
+      /// \brief Name of the region.
+      public: std::string name;
+
+      /// \brief Left column of the region in the frame.
+      public: unsigned int x = 0;
+
+      /// \brief Top row of the region in the frame.
+      public: unsigned int y = 0;
+
+      /// \brief Width of the region in the frame.
+      public: unsigned int width = 0;
+
+      /// \brief Height of the region in the frame.
+      public: unsigned int height = 0;
+
+      /// \brief Binning factor.
+      public: unsigned int binning = 1;
+
+      /// \brief Publisher of the region.
+      public: transport::PublisherPtr pub;
+    };
+
     /// \internal
     /// \brief CameraSensor private data
     class CameraSensorPrivate
@@ -36,6 +67,12 @@ namespace gazebo
       /// \brief Timestamp of the forthcoming rendering
       public: double nextRenderingTime
                            = std::numeric_limits<double>::quiet_NaN();
+
+      /// \brief Regions of interest.
+      public: std::vector<CameraImageRegion> regions;
+
+      /// \brief Protects regions.
+      public: mutable std::mutex regionMutex;
     };
   }
 }
@@ -15,9 +15,12 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <functional>
+#include <memory>
 #include <sstream>
+#include <vector>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/common/Exception.hh"
 
@@ -44,6 +47,8 @@ ContactSensor::ContactSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new ContactSensorPrivate)
 {
+  // A contact sensor only processes the contact messages it received
+  this->SetConcurrentUpdate([]() { return true; });
 }
 
 //////////////////////////////////////////////////
@@ -111,16 +116,11 @@ void ContactSensor::Load(const std::string &_worldName)
 
   if (!this->dataPtr->collisions.empty())
   {
-    // request the contact manager to publish messages to a custom topic for
-    // this sensor
+    // request the contact manager to hand the contacts of the collisions
+    // to this sensor after each step
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
-    std::string topic = mgr->CreateFilter(this->dataPtr->filterName,
-        this->dataPtr->collisions);
-    if (!this->dataPtr->contactSub)
-    {
-      this->dataPtr->contactSub = this->node->Subscribe(topic,
-          &ContactSensor::OnContacts, this);
-    }
+    mgr->CreateFilter(this->dataPtr->filterName, this->dataPtr->collisions,
+        std::bind(&ContactSensor::OnContacts, this, std::placeholders::_1));
   }
 }
 
@@ -142,53 +142,15 @@ bool ContactSensor::UpdateImpl(const bool /*_force*/)
   if (this->dataPtr->incomingContacts.empty())
     return false;
 
-  std::vector<std::string>::iterator collIter;
-  std::string collision1;
-
   // Clear the outgoing contact message.
   this->dataPtr->contactsMsg.clear_contact();
 
-  // Iterate over all the contact messages
-  for (auto iter = this->dataPtr->incomingContacts.begin();
-       iter != this->dataPtr->incomingContacts.end(); ++iter)
+  // The incoming contacts only hold the monitored collisions, move them to
+  // the outgoing message.
+  for (auto &msg : this->dataPtr->incomingContacts)
   {
-    // Iterate over all the contacts in the message
-    for (int i = 0; i < (*iter)->contact_size(); ++i)
-    {
-      collision1 = (*iter)->contact(i).collision1();
-
-      // Try to find the first collision's name
-      collIter = std::find(this->dataPtr->collisions.begin(),
-          this->dataPtr->collisions.end(), collision1);
-
-      // If unable to find the first collision's name, try the second
-      if (collIter == this->dataPtr->collisions.end())
-      {
-        collision1 = (*iter)->contact(i).collision2();
-        collIter = std::find(this->dataPtr->collisions.begin(),
-            this->dataPtr->collisions.end(), collision1);
-      }
-
-      // If this sensor is monitoring one of the collision's in the
-      // contact, then add the contact to our outgoing message.
-      if (collIter != this->dataPtr->collisions.end())
-      {
-        int count = (*iter)->contact(i).position_size();
-
-        // Check to see if the contact arrays all have the same size.
-        if (count != (*iter)->contact(i).normal_size() ||
-            count != (*iter)->contact(i).wrench_size() ||
-            count != (*iter)->contact(i).depth_size())
-        {
-          gzerr << "Contact message has invalid array sizes\n";
-          continue;
-        }
-
-        // Copy the contact message.
-        msgs::Contact *contactMsg = this->dataPtr->contactsMsg.add_contact();
-        contactMsg->CopyFrom((*iter)->contact(i));
-      }
-    }
+    for (int i = 0; i < msg->contact_size(); ++i)
+      this->dataPtr->contactsMsg.add_contact()->Swap(msg->mutable_contact(i));
   }
 
   IGN_PROFILE_END();
@@ -215,14 +177,15 @@ bool ContactSensor::UpdateImpl(const bool /*_force*/)
 //////////////////////////////////////////////////
 void ContactSensor::Fini()
 {
-  if (this->world && this->world->Running())
+  // Always remove the filter while the physics engine exists, since it
+  // calls back into this sensor
+  if (this->world && this->world->Physics())
   {
     physics::ContactManager *mgr =
         this->world->Physics()->GetContactManager();
     mgr->RemoveFilter(this->dataPtr->filterName);
   }
 
-  this->dataPtr->contactSub.reset();
   this->dataPtr->contactsPub.reset();
   Sensor::Fini();
 }
@@ -304,26 +267,34 @@ std::map<std::string, gazebo::physics::Contact> ContactSensor::Contacts(
 }
 
 //////////////////////////////////////////////////
-void ContactSensor::OnContacts(ConstContactsPtr &_msg)
+void ContactSensor::OnContacts(
+    const std::vector<physics::Contact *> &_contacts)
 {
+  // Only store information if the sensor is active
+  if (!this->IsActive())
+    return;
+
+  // Convert the contacts here, since they are only valid during the call.
+  // Steps without contacts are stored too, so that UpdateImpl clears the
+  // outgoing message.
+  std::unique_ptr<msgs::Contacts> msg(new msgs::Contacts);
+  for (auto const &contact : _contacts)
+    contact->FillMsg(*msg->add_contact());
+
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-  // Only store information if the sensor is active
-  if (this->IsActive())
-  {
-    // Store the contacts message for processing in UpdateImpl
-    this->dataPtr->incomingContacts.push_back(_msg);
+  // Store the contacts message for processing in UpdateImpl
+  this->dataPtr->incomingContacts.push_back(std::move(msg));
 
-    // Prevent the incomingContacts list to grow indefinitely.
-    if (this->dataPtr->incomingContacts.size() > 100)
-      this->dataPtr->incomingContacts.pop_front();
-  }
+  // Prevent the incomingContacts list to grow indefinitely.
+  if (this->dataPtr->incomingContacts.size() > 100)
+    this->dataPtr->incomingContacts.pop_front();
 }
 
 //////////////////////////////////////////////////
 bool ContactSensor::IsActive() const
 {
-  return this->active ||
+  return Sensor::IsActive() ||
     (this->dataPtr->contactsPub &&
      this->dataPtr->contactsPub->HasConnections());
 }
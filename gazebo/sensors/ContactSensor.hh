@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "gazebo/msgs/msgs.hh"
 
@@ -94,10 +95,10 @@ namespace gazebo
       /// to publish all contacts generated within a timestep onto
       /// Gazebo topic ~/physics/contacts.
       ///
-      /// Each ContactSensor subscribes to the Gazebo ~/physics/contacts topic,
-      /// retrieves all contact pairs in a time step and filters them wthin
-      /// ContactSensor::OnContacts against <collision> body name
-      /// specified by the ContactSensor SDF.
+      /// The ContactManager also hands each ContactSensor the contacts of
+      /// its <collision> bodies, specified by the ContactSensor SDF, within
+      /// ContactSensor::OnContacts. The monitored collisions are looked up
+      /// once per contact, so a step is a single pass over its contacts.
       /// All collision pairs between ContactSensor <collision> body and
       /// other bodies in the world are stored in an array inside
       /// contacts.proto.
@@ -133,8 +134,11 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
-      /// \brief Callback for contact messages from the physics engine.
-      private: void OnContacts(ConstContactsPtr &_msg);
+      /// \brief Callback for the contacts of the monitored collisions,
+      /// called by the contact manager after each step.
+      /// \param[in] _contacts The contacts of the step.
+      private: void OnContacts(
+                   const std::vector<physics::Contact *> &_contacts);
 
       /// \internal
       /// \brief Private data pointer
@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <string>
 #include <mutex>
 
@@ -39,9 +40,6 @@ namespace gazebo
       /// \brief Output contact information.
       public: transport::PublisherPtr contactsPub;
 
-      /// \brief Subscription to contact messages from the physics engine
-      public: transport::SubscriberPtr contactSub;
-
       /// \brief Mutex to protect reads and writes.
       public: mutable std::mutex mutex;
 
@@ -50,9 +48,10 @@ namespace gazebo
 
       /// \type ContactMsgs_L
       /// List of contact messages
-      typedef std::list<boost::shared_ptr<msgs::Contacts const> > ContactMsgs_L;
+      typedef std::list<std::unique_ptr<msgs::Contacts> > ContactMsgs_L;
 
-      /// \brief List of incoming messages.
+      /// \brief List of incoming messages, one per step, with the contacts
+      /// of the monitored collisions.
       public: ContactMsgs_L incomingContacts;
 
       /// \brief Name of filter used to filter contact messages.
@@ -16,7 +16,9 @@
 */
 #include <functional>
 
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
+
+#include "gazebo/common/Timer.hh"
 
 #include "gazebo/physics/World.hh"
 
@@ -107,6 +109,11 @@ void DepthCameraSensor::Init()
     this->dataPtr->depthCamera->CreateNormalsTexture(
         this->Name() + "_RttTex_Normals");
 
+    // The image and the depth buffer
+    this->SetMemoryUsage(this->dataPtr->depthCamera->ImageByteSize() +
+        this->dataPtr->depthCamera->ImageWidth() *
+        this->dataPtr->depthCamera->ImageHeight() * sizeof(float));
+
     ignition::math::Pose3d cameraPose = this->pose;
     if (cameraSdf->HasElement("pose"))
       cameraPose = cameraSdf->Get<ignition::math::Pose3d>("pose") + cameraPose;
@@ -141,27 +148,26 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
     return false;
 
   IGN_PROFILE_BEGIN("PostRender");
+  common::Timer timer;
+  timer.Start();
   this->camera->PostRender();
+  this->RecordStageTime(STAGE_READBACK, timer.GetElapsed());
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("fillarray");
 
-  if (this->imagePub && this->imagePub->HasConnections() &&
+  const bool imageConnected = this->imagePub &&
+      this->imagePub->HasConnections();
+  const bool regionsConnected = this->ImageRegionsConnected();
+
+  if ((imageConnected || regionsConnected) &&
       // check if depth data is available. If not, the depth camera could be
       // generating point clouds instead
       this->dataPtr->depthCamera->DepthData())
   {
-    msgs::ImageStamped msg;
-    msgs::Set(msg.mutable_time(), this->scene->SimTime());
-    msg.mutable_image()->set_width(this->camera->ImageWidth());
-    msg.mutable_image()->set_height(this->camera->ImageHeight());
-    msg.mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
-
-
-    msg.mutable_image()->set_step(this->camera->ImageWidth() *
-        this->camera->ImageDepth());
-
-    unsigned int depthSamples = msg.image().width() * msg.image().height();
+    timer.Start();
+    unsigned int depthSamples = this->camera->ImageWidth() *
+        this->camera->ImageHeight();
     float f;
     // cppchecker recommends using sizeof(varname)
     unsigned int depthBufferSize = depthSamples * sizeof(f);
@@ -184,8 +190,30 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
         this->dataPtr->depthBuffer[i] = -ignition::math::INF_D;
       }
     }
-    msg.mutable_image()->set_data(this->dataPtr->depthBuffer, depthBufferSize);
-    this->imagePub->Publish(msg);
+
+    if (imageConnected)
+    {
+      msgs::ImageStamped msg;
+      msgs::Set(msg.mutable_time(), this->scene->SimTime());
+      msg.mutable_image()->set_width(this->camera->ImageWidth());
+      msg.mutable_image()->set_height(this->camera->ImageHeight());
+      msg.mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
+
+      msg.mutable_image()->set_step(this->camera->ImageWidth() *
+          this->camera->ImageDepth());
+      msg.mutable_image()->set_data(this->dataPtr->depthBuffer,
+          depthBufferSize);
+      this->imagePub->Publish(msg);
+    }
+
+    // The regions of a depth camera are cropped from the depth image
+    if (regionsConnected)
+    {
+      this->PublishImageRegions(
+          reinterpret_cast<const unsigned char *>(this->dataPtr->depthBuffer),
+          common::Image::R_FLOAT32, sizeof(f), this->scene->SimTime());
+    }
+    this->RecordStageTime(STAGE_PUBLISH, timer.GetElapsed());
   }
 
   this->SetRendered(false);
@@ -16,7 +16,7 @@
 */
 #include <boost/algorithm/string.hpp>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
@@ -42,6 +42,8 @@ ForceTorqueSensor::ForceTorqueSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new ForceTorqueSensorPrivate)
 {
+  // A force torque sensor only reads the wrench of its joint
+  this->SetConcurrentUpdate([]() { return true; });
 }
 
 //////////////////////////////////////////////////
@@ -169,12 +171,24 @@ void ForceTorqueSensor::Load(const std::string &_worldName)
 void ForceTorqueSensor::Init()
 {
   Sensor::Init();
-  this->dataPtr->parentJoint->SetProvideFeedback(true);
+
+  // The engine gathers the wrench after each physics update
+  this->dataPtr->wrenchIndex =
+    this->world->Physics()->AddJointWrenchMonitor(this->dataPtr->parentJoint);
+  this->dataPtr->wrenchMonitored = true;
 }
 
 //////////////////////////////////////////////////
 void ForceTorqueSensor::Fini()
 {
+  if (this->dataPtr->wrenchMonitored && this->world &&
+      this->world->Physics())
+  {
+    this->world->Physics()->RemoveJointWrenchMonitor(
+        this->dataPtr->wrenchIndex);
+  }
+  this->dataPtr->wrenchMonitored = false;
+
   this->dataPtr->wrenchPub.reset();
   this->dataPtr->parentJoint.reset();
 
@@ -211,7 +225,8 @@ bool ForceTorqueSensor::UpdateImpl(const bool /*_force*/)
   msgs::Set(this->dataPtr->wrenchMsg.mutable_time(),
       this->lastMeasurementTime);
 
-  physics::JointWrench wrench = this->dataPtr->parentJoint->GetForceTorque(0u);
+  physics::JointWrench wrench =
+    this->world->Physics()->MonitoredJointWrench(this->dataPtr->wrenchIndex);
 
   // Get the force and torque in the appropriate frame.
   ignition::math::Vector3d measuredForce;
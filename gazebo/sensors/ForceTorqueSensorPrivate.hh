@@ -37,6 +37,13 @@ namespace gazebo
       /// \brief Parent joint, from which we get force torque info.
       public: physics::JointPtr parentJoint;
 
+      /// \brief Index of the wrench of the parent joint in the physics
+      /// engine, see physics::PhysicsEngine::AddJointWrenchMonitor.
+      public: unsigned int wrenchIndex = 0;
+
+      /// \brief True while the wrench of the parent joint is monitored.
+      public: bool wrenchMonitored = false;
+
       /// \brief Publishes the wrenchMsg.
       public: transport::PublisherPtr wrenchPub;
 
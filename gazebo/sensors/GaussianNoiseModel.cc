@@ -14,6 +14,14 @@
  * limitations under the License.
  *
 */
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 
@@ -76,9 +84,87 @@ namespace gazebo
   };
 }  // namespace gazebo
 
+/// \internal
+/// \brief Private data for the GaussianNoiseModel class.
+class gazebo::sensors::GaussianNoiseModelPrivate
+{
+  /// \brief Random number stream of the model, used for blocks of data
+  /// values. It is seeded from the global seed so that runs stay
+  /// repeatable, and isn't shared with other sensors.
+  public: std::mt19937_64 engine;
+
+  /// \brief White noise of a block of data values, kept to reuse its
+  /// storage.
+  public: std::vector<double> whiteNoise;
+};
+
 using namespace gazebo;
 using namespace sensors;
 
+namespace
+{
+  /// \brief Private data of the Gaussian noise models, by model. It is kept
+  /// out of GaussianNoiseModel so that the layout of the class doesn't
+  /// change.
+  class GaussianNoiseModelPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the Gaussian noise models.
+    public: static GaussianNoiseModelPrivates &Instance()
+    {
+      static GaussianNoiseModelPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by model.
+    public: std::unordered_map<const GaussianNoiseModel *,
+            std::unique_ptr<GaussianNoiseModelPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
+/// \brief Number of random number streams handed to noise models. Each
+/// model seeds its stream with the global seed and its own index.
+static std::atomic<unsigned int> g_noiseStreams(0);
+
+//////////////////////////////////////////////////
+/// \brief Draw Gaussian samples with the Box-Muller transform. The uniform
+/// samples are drawn first, so that the transform runs in a loop without
+/// branches which the compiler can vectorize.
+/// \param[in] _engine Random number stream.
+/// \param[in] _mean Mean of the samples.
+/// \param[in] _stdDev Standard deviation of the samples.
+/// \param[in] _size Number of samples.
+/// \param[out] _out The samples, it may hold one more sample than asked.
+static void DrawNormal(std::mt19937_64 &_engine, const double _mean,
+    const double _stdDev, const size_t _size, std::vector<double> &_out)
+{
+  // Each pair of uniform samples gives two Gaussian samples
+  const size_t pairs = (_size + 1) / 2;
+  _out.resize(pairs * 2);
+  double *radius = _out.data();
+  double *angle = _out.data() + pairs;
+
+  // Use 53 random bits per sample. The radius sample is in (0, 1] so
+  // that its logarithm is finite.
+  const double scale = 1.0 / 9007199254740992.0;
+  for (size_t i = 0; i < pairs; ++i)
+  {
+    radius[i] = ((_engine() >> 11) + 1) * scale;
+    angle[i] = (_engine() >> 11) * scale;
+  }
+
+  for (size_t i = 0; i < pairs; ++i)
+  {
+    const double r = _stdDev * std::sqrt(-2.0 * std::log(radius[i]));
+    const double theta = 2.0 * IGN_PI * angle[i];
+    radius[i] = _mean + r * std::cos(theta);
+    angle[i] = _mean + r * std::sin(theta);
+  }
+}
+
 //////////////////////////////////////////////////
 GaussianNoiseModel::GaussianNoiseModel()
   : Noise(Noise::GAUSSIAN),
@@ -92,11 +178,35 @@ GaussianNoiseModel::GaussianNoiseModel()
     dynamicBiasStdDev(0),
     dynamicBiasCorrTime(0)
 {
+  GaussianNoiseModelPrivate *data = new GaussianNoiseModelPrivate;
+  std::seed_seq seed{ignition::math::Rand::Seed(), g_noiseStreams++};
+  data->engine.seed(seed);
+  {
+    GaussianNoiseModelPrivates &privates =
+        GaussianNoiseModelPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(data);
+  }
+
+  this->SetApplyArrayFunction(std::bind(&GaussianNoiseModel::ApplyArray,
+        this, std::placeholders::_1, std::placeholders::_2,
+        std::placeholders::_3));
 }
 
 //////////////////////////////////////////////////
 GaussianNoiseModel::~GaussianNoiseModel()
 {
+  GaussianNoiseModelPrivates &privates = GaussianNoiseModelPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+GaussianNoiseModelPrivate *GaussianNoiseModel::GaussianData() const
+{
+  GaussianNoiseModelPrivates &privates = GaussianNoiseModelPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -150,6 +260,47 @@ double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
   // Add independent (uncorrelated) Gaussian noise to each input value.
   double whiteNoise = ignition::math::Rand::DblNormal(this->mean, this->stdDev);
 
+  this->UpdateDynamicBias(_dt);
+
+  double output = _in + this->bias + whiteNoise;
+  if (this->quantized)
+  {
+    // Apply this->precision
+    if (!ignition::math::equal(this->precision, 0.0, 1e-6))
+    {
+      output = std::round(output / this->precision) * this->precision;
+    }
+  }
+  return output;
+}
+
+//////////////////////////////////////////////////
+void GaussianNoiseModel::ApplyArray(double *_data, const size_t _size,
+    const double _dt)
+{
+  GaussianNoiseModelPrivate *data = this->GaussianData();
+  this->UpdateDynamicBias(_dt);
+  DrawNormal(data->engine, this->mean, this->stdDev, _size,
+      data->whiteNoise);
+
+  // Values that are not finite stay as they are without a branch, since
+  // adding noise to them or rounding them doesn't change them.
+  const double *whiteNoise = data->whiteNoise.data();
+  const double offset = this->bias;
+  for (size_t i = 0; i < _size; ++i)
+    _data[i] += offset + whiteNoise[i];
+
+  if (this->quantized)
+  {
+    const double precision = this->precision;
+    for (size_t i = 0; i < _size; ++i)
+      _data[i] = std::round(_data[i] / precision) * precision;
+  }
+}
+
+//////////////////////////////////////////////////
+void GaussianNoiseModel::UpdateDynamicBias(const double _dt)
+{
   // Generate varying (correlated) bias for each input value.
   // This implementation is based on the one available in Rotors:
   // https://github.com/ethz-asl/rotors_simulator/blob/master/rotors_gazebo_plugins/src/gazebo_imu_plugin.cpp
@@ -171,17 +322,6 @@ double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
     this->bias = phiD * this->bias +
       ignition::math::Rand::DblNormal(0, sigmaBD);
   }
-
-  double output = _in + this->bias + whiteNoise;
-  if (this->quantized)
-  {
-    // Apply this->precision
-    if (!ignition::math::equal(this->precision, 0.0, 1e-6))
-    {
-      output = std::round(output / this->precision) * this->precision;
-    }
-  }
-  return output;
 }
 
 //////////////////////////////////////////////////
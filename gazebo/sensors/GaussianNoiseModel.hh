@@ -38,6 +38,9 @@ namespace gazebo
 
   namespace sensors
   {
+    // Forward declare private data class
+    class GaussianNoiseModelPrivate;
+
     /// \class GaussianNoiseModel
     /// \brief Gaussian noise class
     class GZ_SENSORS_VISIBLE GaussianNoiseModel : public Noise
@@ -99,6 +102,26 @@ namespace gazebo
         /// \brief Sample the bias.
         private: void SampleBias();
 
+        /// \brief Apply noise to a block of data values, see
+        /// Noise::SetApplyArrayFunction. The white noise of all the values is
+        /// drawn at once from the random number stream of this model, and
+        /// the dynamic bias takes a single step of _dt.
+        /// \param[in,out] _data The data values.
+        /// \param[in] _size Number of data values.
+        /// \param[in] _dt Time since the previous block of data values.
+        private: void ApplyArray(double *_data, const size_t _size,
+                     const double _dt);
+
+        /// \internal
+        /// \brief Get the private data of this model. It is kept out of the
+        /// class so that its layout doesn't change.
+        /// \return The private data.
+        private: GaussianNoiseModelPrivate *GaussianData() const;
+
+        /// \brief Take a step of the dynamic bias process.
+        /// \param[in] _dt Time step, in seconds.
+        private: void UpdateDynamicBias(const double _dt);
+
         /// \brief If type starts with GAUSSIAN, the mean of the distribution
         /// from which we sample when adding noise.
         protected: double mean;
@@ -16,7 +16,7 @@
 */
 #include <boost/algorithm/string.hpp>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/sensors/SensorFactory.hh"
 
@@ -38,6 +38,8 @@ GpsSensor::GpsSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new GpsSensorPrivate)
 {
+  // A GPS only reads the pose and velocity of its link
+  this->SetConcurrentUpdate([]() { return true; });
 }
 
 /////////////////////////////////////////////////
@@ -114,6 +116,13 @@ void GpsSensor::Fini()
   this->dataPtr->sphericalCoordinates.reset();
 }
 
+/////////////////////////////////////////////////
+bool GpsSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->gpsPub && this->dataPtr->gpsPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void GpsSensor::Init()
 {
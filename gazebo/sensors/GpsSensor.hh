@@ -63,6 +63,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Fini();
 
+      // Documentation inherited.
+      public: virtual bool IsActive() const;
+
       /// \brief Accessor for current longitude angle
       /// \return Current longitude angle.
       public: ignition::math::Angle Longitude() const;
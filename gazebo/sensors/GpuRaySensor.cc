@@ -14,8 +14,9 @@
  * limitations under the License.
  *
 */
+#include <cmath>
 #include <boost/algorithm/string.hpp>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <functional>
 #include <ignition/math.hh>
 #include <ignition/math/Helpers.hh>
@@ -26,6 +27,7 @@
 
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Timer.hh"
 
 #include "gazebo/transport/transport.hh"
 
@@ -104,6 +106,7 @@ void GpuRaySensor::Load(const std::string &_worldName)
 
   this->dataPtr->scanPub =
     this->node->Advertise<msgs::LaserScanStamped>(this->Topic(), 50);
+  this->dataPtr->scanPub->SetPriority(transport::Publisher::BULK);
 
   sdf::ElementPtr rayElem = this->sdf->GetElement("ray");
   this->dataPtr->scanElem = rayElem->GetElement("scan");
@@ -331,6 +334,10 @@ void GpuRaySensor::Init()
     this->dataPtr->laserCam->AttachToVisual(this->ParentId(), true, 0, 0);
 
     this->dataPtr->laserMsg.mutable_scan()->set_frame(this->ParentName());
+
+    // The ranges and intensities of the scan message
+    this->SetMemoryUsage(2 * sizeof(double) * this->RangeCount() *
+        this->VerticalRangeCount());
   }
   else
     gzerr << "No world name\n";
@@ -678,7 +685,10 @@ void GpuRaySensor::Render()
     if (!this->dataPtr->renderNeeded)
       return;
 
+    common::Timer timer;
+    timer.Start();
     this->dataPtr->laserCam->Render();
+    this->RecordStageTime(STAGE_RENDER, timer.GetElapsed());
     this->dataPtr->rendered = true;
     this->dataPtr->renderNeeded = false;
   }
@@ -689,7 +699,10 @@ void GpuRaySensor::Render()
 
     this->lastMeasurementTime = this->scene->SimTime();
 
+    common::Timer timer;
+    timer.Start();
     this->dataPtr->laserCam->Render();
+    this->RecordStageTime(STAGE_RENDER, timer.GetElapsed());
     this->dataPtr->rendered = true;
   }
 }
@@ -702,7 +715,10 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
   if (!this->dataPtr->rendered)
     return false;
   IGN_PROFILE_BEGIN("PostRender");
+  common::Timer timer;
+  timer.Start();
   this->dataPtr->laserCam->PostRender();
+  this->RecordStageTime(STAGE_READBACK, timer.GetElapsed());
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("fillarray");
@@ -734,47 +750,56 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
     this->dataPtr->horzRangeCount;
   if (scan->ranges_size() != numRays)
   {
-    // gzdbg << "Size mismatch; allocating memory\n";
-    scan->clear_ranges();
-    scan->clear_intensities();
-    for (int i = 0; i < numRays; ++i)
-    {
-      scan->add_ranges(ignition::math::NAN_F);
-      scan->add_intensities(ignition::math::NAN_F);
-    }
+    scan->mutable_ranges()->Resize(numRays, ignition::math::NAN_F);
+    scan->mutable_intensities()->Resize(numRays, ignition::math::NAN_F);
   }
 
-  auto dataIter = this->dataPtr->laserCam->LaserDataBegin();
-  auto dataEnd = this->dataPtr->laserCam->LaserDataEnd();
-  for (int i = 0; dataIter != dataEnd; ++dataIter, ++i)
+  // Convert the packed frame into the message fields directly, rather than
+  // through the data iterators and the repeated field accessors.
+  const float *frame = this->dataPtr->laserCam->LaserBuffer();
+  const unsigned int channels = this->dataPtr->laserCam->LaserChannelCount();
+  const int size = frame ? numRays : 0;
+  double *ranges = scan->mutable_ranges()->mutable_data();
+  double *intensities = scan->mutable_intensities()->mutable_data();
+  for (int i = 0; i < size; ++i, frame += channels)
   {
-    const rendering::GpuLaserData data = *dataIter;
-    double range = data.range;
-    double intensity = data.intensity;
+    double range = frame[0];
 
     // Mask ranges outside of min/max to +/- inf, as per REP 117
     if (range >= this->dataPtr->rangeMax)
-    {
       range = ignition::math::INF_D;
-    }
     else if (range <= this->dataPtr->rangeMin)
-    {
       range = -ignition::math::INF_D;
+
+    ranges[i] = range;
+    intensities[i] = frame[1];
+  }
+
+  // Apply the noise to all the ranges at once. Masked ranges aren't finite,
+  // and are left as they are.
+  auto noise = this->noises.find(GPU_RAY_NOISE);
+  if (noise != this->noises.end())
+    noise->second->Apply(ranges, size);
+
+  for (int i = 0; i < size; ++i)
+  {
+    if (ignition::math::isnan(ranges[i]))
+    {
+      ranges[i] = this->dataPtr->rangeMax;
     }
-    else if (this->noises.find(GPU_RAY_NOISE) != this->noises.end())
+    else if (noise != this->noises.end() && std::isfinite(ranges[i]))
     {
-      range = this->noises[GPU_RAY_NOISE]->Apply(range);
-      range = ignition::math::clamp(range,
+      ranges[i] = ignition::math::clamp(ranges[i],
           this->dataPtr->rangeMin, this->dataPtr->rangeMax);
     }
-
-    range = ignition::math::isnan(range) ? this->dataPtr->rangeMax : range;
-    scan->set_ranges(i, range);
-    scan->set_intensities(i, intensity);
   }
 
   if (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections())
+  {
+    timer.Start();
     this->dataPtr->scanPub->Publish(this->dataPtr->laserMsg);
+    this->RecordStageTime(STAGE_PUBLISH, timer.GetElapsed());
+  }
 
   this->dataPtr->rendered = false;
   IGN_PROFILE_END();
@@ -15,13 +15,14 @@
  *
 */
 #include <boost/algorithm/string.hpp>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 
 #include "gazebo/physics/Link.hh"
+#include "gazebo/physics/LinkDataRegistry.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 
@@ -40,10 +41,8 @@ ImuSensor::ImuSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new ImuSensorPrivate)
 {
-  this->dataPtr->dataIndex = 0;
-  this->dataPtr->dataDirty = false;
-  this->dataPtr->incomingLinkData[0].reset();
-  this->dataPtr->incomingLinkData[1].reset();
+  // An IMU only reads the state of its link
+  this->SetConcurrentUpdate([]() { return true; });
 }
 
 //////////////////////////////////////////////////
@@ -184,12 +183,8 @@ void ImuSensor::Load(const std::string &_worldName, sdf::ElementPtr _sdf)
     gzlog << out.str();
   }
 
-  // Start publishing measurements on the topic.
+  // Request the data of the link, read from the registry of the world
   this->dataPtr->parentEntity->SetPublishData(true);
-
-  std::string topic = "~/" + this->dataPtr->parentEntity->GetScopedName();
-  this->dataPtr->linkDataSub = this->node->Subscribe(topic,
-    &ImuSensor::OnLinkData, this);
 }
 
 //////////////////////////////////////////////////
@@ -228,16 +223,12 @@ void ImuSensor::Fini()
   // Clean transport
   {
     this->dataPtr->pub.reset();
-    this->dataPtr->linkDataSub.reset();
   }
 
   if (this->dataPtr->parentEntity)
     this->dataPtr->parentEntity->SetPublishData(false);
   this->dataPtr->parentEntity.reset();
 
-  this->dataPtr->incomingLinkData[0].reset();
-  this->dataPtr->incomingLinkData[1].reset();
-
   Sensor::Fini();
 }
 
@@ -248,15 +239,6 @@ msgs::IMU ImuSensor::ImuMessage() const
   return this->dataPtr->imuMsg;
 }
 
-//////////////////////////////////////////////////
-void ImuSensor::OnLinkData(ConstLinkDataPtr &_msg)
-{
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  // Store the contacts message for processing in UpdateImpl
-  this->dataPtr->incomingLinkData[this->dataPtr->dataIndex] = _msg;
-  this->dataPtr->dataDirty = true;
-}
-
 //////////////////////////////////////////////////
 ignition::math::Vector3d ImuSensor::AngularVelocity(const bool _noiseFree) const
 {
@@ -303,25 +285,20 @@ bool ImuSensor::UpdateImpl(const bool /*_force*/)
 {
   IGN_PROFILE("ImuSensor::UpdateImpl");
   IGN_PROFILE_BEGIN("Update");
-  msgs::LinkData msg;
-  int readIndex = 0;
+  if (!this->dataPtr->parentEntity)
+    return false;
 
+  physics::LinkDataRegistry::Sample sample;
+  if (!this->world->LinkData().Data(this->dataPtr->parentEntity.get(),
+        sample))
   {
-    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-    // Don't do anything if there is no new data to process.
-    if (!this->dataPtr->dataDirty)
-      return false;
-
-    readIndex = this->dataPtr->dataIndex;
-    this->dataPtr->dataIndex ^= 1;
-    this->dataPtr->dataDirty = false;
+    return false;
   }
 
-  // toggle the index
-  msg.CopyFrom(*this->dataPtr->incomingLinkData[readIndex].get());
-
-  common::Time timestamp = msgs::Convert(msg.time());
+  // Don't do anything if there is no new data to process.
+  common::Time timestamp = sample.time;
+  if (timestamp == this->lastMeasurementTime)
+    return false;
 
   double dt = (timestamp - this->lastMeasurementTime).Double();
 
@@ -342,8 +319,7 @@ bool ImuSensor::UpdateImpl(const bool /*_force*/)
     ignition::math::Pose3d imuWorldPose = this->pose + parentEntityPose;
 
     // Get the angular velocity
-    ignition::math::Vector3d linkWorldAngularVel = msgs::ConvertIgn(
-        msg.angular_velocity());
+    ignition::math::Vector3d linkWorldAngularVel = sample.angularVel;
 
     /////////////////////////////////////////////////////////////////////
     // Set the IMU angular velocity (defined in imu's local frame)
@@ -357,8 +333,7 @@ bool ImuSensor::UpdateImpl(const bool /*_force*/)
     // Compute and set the IMU linear acceleration in the imu local frame
     /////////////////////////////////////////////////////////////////////
     // first get imu link's linear velocity in world frame
-    ignition::math::Vector3d linkWorldLinearVel
-        = msgs::ConvertIgn(msg.linear_velocity());
+    ignition::math::Vector3d linkWorldLinearVel = sample.linearVel;
     // next, account for vel in world frame of the imu
     // given the imu frame is offset from link frame, and link is rotating
     // compute the velocity of the imu axis origin in world frame
@@ -17,7 +17,6 @@
 #ifndef GAZEBO_SENSORS_IMUSENSOR_PRIVATE_HH_
 #define GAZEBO_SENSORS_IMUSENSOR_PRIVATE_HH_
 
-#include <array>
 #include <mutex>
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Pose3.hh>
@@ -50,9 +49,6 @@ namespace gazebo
       /// \brief Imu data publisher
       public: transport::PublisherPtr pub;
 
-      /// \brief Subscriber to link data published by parent entity
-      public: transport::SubscriberPtr linkDataSub;
-
       /// \brief Parent entity which the IMU is attached to
       public: physics::LinkPtr parentEntity;
 
@@ -62,16 +58,6 @@ namespace gazebo
       /// \brief Mutex to protect reads and writes.
       public: mutable std::mutex mutex;
 
-      /// \brief Buffer for storing link data
-      public: std::array<boost::shared_ptr<msgs::LinkData const>, 2>
-              incomingLinkData;
-
-      /// \brief Index for accessing element in the link data array
-      public: unsigned int dataIndex;
-
-      /// \brief True if new link data is received
-      public: bool dataDirty;
-
       /// \brief Noise free angular velocity.
       public: ignition::math::Vector3d angularVel;
     };
@@ -32,9 +32,9 @@ namespace gazebo
     /// \brief Logical camera sensor private data.
     class LogicalCameraSensorPrivate
     {
-      /// \brief Add models that are visible to the camera to a vector of models
+      /// \brief Add the models that are visible to the camera to the message
       /// \param[in] _myPose pose of the logical camera
-      /// \param[in] _models list of models to test against frustum
+      /// \param[in] _models models in the frustum
       public: void AddVisibleModels(ignition::math::Pose3d &_myPose,
         const physics::Model_V &_models);
 
@@ -55,6 +55,10 @@ namespace gazebo
 
       /// \brief Name of the parent model.
       public: std::string modelName;
+
+      /// \brief Models in the frustum. Only the storage is kept between
+      /// updates.
+      public: physics::Model_V visibleModels;
     };
   }
 }
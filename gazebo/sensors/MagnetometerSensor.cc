@@ -15,7 +15,7 @@
  *
 */
 #include <boost/algorithm/string.hpp>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/transport/Node.hh"
@@ -37,6 +37,8 @@ MagnetometerSensor::MagnetometerSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new MagnetometerSensorPrivate)
 {
+  // A magnetometer only reads the pose of its link and the magnetic field
+  this->SetConcurrentUpdate([]() { return true; });
 }
 
 /////////////////////////////////////////////////
@@ -119,6 +121,13 @@ void MagnetometerSensor::Fini()
   this->dataPtr->parentLink.reset();
 }
 
+/////////////////////////////////////////////////
+bool MagnetometerSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->magPub && this->dataPtr->magPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void MagnetometerSensor::Init()
 {
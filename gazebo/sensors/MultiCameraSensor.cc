@@ -16,7 +16,7 @@
 */
 #include <boost/algorithm/string.hpp>
 #include <functional>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/common/Exception.hh"
@@ -92,6 +92,7 @@ void MultiCameraSensor::Load(const std::string &_worldName)
   // Create the publisher of image data.
   this->dataPtr->imagePub =
     this->node->Advertise<msgs::ImagesStamped>(this->Topic(), 50);
+  this->dataPtr->imagePub->SetPriority(transport::Publisher::BULK);
 }
 
 //////////////////////////////////////////////////
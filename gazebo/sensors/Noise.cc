@@ -15,6 +15,10 @@
  *
 */
 
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/function.hpp>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -22,9 +26,42 @@
 #include "gazebo/sensors/GaussianNoiseModel.hh"
 #include "gazebo/sensors/Noise.hh"
 
+/// \internal
+/// \brief Private data for the Noise class.
+class gazebo::sensors::NoisePrivate
+{
+  /// \brief Applies noise to a block of data values, see
+  /// Noise::SetApplyArrayFunction.
+  public: std::function<void (double *, const size_t, const double)>
+          applyArray;
+};
+
 using namespace gazebo;
 using namespace sensors;
 
+namespace
+{
+  /// \brief Private data of the noise models, by model. It is kept out of
+  /// Noise so that the layout of the class doesn't change.
+  class NoisePrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the noise models.
+    public: static NoisePrivates &Instance()
+    {
+      static NoisePrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by noise model.
+    public: std::unordered_map<const Noise *,
+            std::unique_ptr<NoisePrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 //////////////////////////////////////////////////
 NoisePtr NoiseFactory::NewNoiseModel(sdf::ElementPtr _sdf,
     const std::string &_sensorType)
@@ -75,11 +112,25 @@ NoisePtr NoiseFactory::NewNoiseModel(sdf::ElementPtr _sdf,
 Noise::Noise(NoiseType _type)
   : type(_type)
 {
+  NoisePrivates &privates = NoisePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new NoisePrivate);
 }
 
 //////////////////////////////////////////////////
 Noise::~Noise()
 {
+  NoisePrivates &privates = NoisePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+NoisePrivate *Noise::NoiseData() const
+{
+  NoisePrivates &privates = NoisePrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -124,6 +175,56 @@ double Noise::ApplyImpl(double _in, double /*_dt*/)
   return _in;
 }
 
+//////////////////////////////////////////////////
+void Noise::Apply(double *_data, const size_t _size, const double _dt)
+{
+  if (this->type == NONE || _size == 0)
+    return;
+  else if (this->type == CUSTOM)
+  {
+    if (!this->customNoiseCallbackTime && !this->customNoiseCallback)
+    {
+      gzerr << "Custom noise callback function not set!"
+          << " Please call SetCustomNoiseCallback within a sensor plugin."
+          << std::endl;
+      return;
+    }
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+      if (!std::isfinite(_data[i]))
+        continue;
+
+      if (this->customNoiseCallbackTime)
+        _data[i] = this->customNoiseCallbackTime(_data[i], _dt);
+      else
+        _data[i] = this->customNoiseCallback(_data[i]);
+    }
+  }
+  else
+  {
+    const NoisePrivate *data = this->NoiseData();
+    if (data->applyArray)
+    {
+      data->applyArray(_data, _size, _dt);
+      return;
+    }
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+      if (std::isfinite(_data[i]))
+        _data[i] = this->ApplyImpl(_data[i], _dt);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Noise::SetApplyArrayFunction(
+    const std::function<void (double *, const size_t, const double)> &_apply)
+{
+  this->NoiseData()->applyArray = _apply;
+}
+
 //////////////////////////////////////////////////
 Noise::NoiseType Noise::GetNoiseType() const
 {
@@ -18,6 +18,7 @@
 #ifndef _GAZEBO_NOISE_HH_
 #define _GAZEBO_NOISE_HH_
 
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -50,6 +51,9 @@ namespace gazebo
           const std::string &_sensorType = "");
     };
 
+    // Forward declare private data class
+    class NoisePrivate;
+
     /// \class Noise Noise.hh
     /// \brief Noise models for sensor output signals.
     class GZ_SENSORS_VISIBLE Noise
@@ -88,6 +92,15 @@ namespace gazebo
       /// \return Data with noise applied.
       public: virtual double ApplyImpl(double _in, double _dt = 0.0);
 
+      /// \brief Apply noise to a block of data values measured at the same
+      /// time, such as the ranges of a scan. Values that are not finite,
+      /// such as out of range readings, are left as they are.
+      /// \param[in,out] _data The data values.
+      /// \param[in] _size Number of data values.
+      /// \param[in] _dt Time since the previous block of data values.
+      public: void Apply(double *_data, const size_t _size,
+                  const double _dt = 0.0);
+
       /// \brief Finalize the noise model
       public: virtual void Fini();
 
@@ -123,6 +136,22 @@ namespace gazebo
       /// \param[in] _out Output stream
       public: virtual void Print(std::ostream &_out) const;
 
+      /// \brief Set the function that applies noise to a block of data
+      /// values, in place of a loop over ApplyImpl. Derived classes set it
+      /// in their constructor.
+      /// \param[in] _apply Function called by Apply with the data values,
+      /// their number and the time step.
+      /// \sa Apply(double *, const size_t, const double)
+      protected: void SetApplyArrayFunction(
+                     const std::function<void (double *, const size_t,
+                       const double)> &_apply);
+
+      /// \internal
+      /// \brief Get the private data of this noise model. It is kept out of
+      /// the class so that its layout doesn't change.
+      /// \return The private data.
+      private: NoisePrivate *NoiseData() const;
+
       /// \brief Which type of noise we're applying
       private: NoiseType type;
 
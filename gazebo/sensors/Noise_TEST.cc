@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
@@ -23,6 +25,7 @@
 #include <boost/accumulators/statistics/variance.hpp>
 #include <boost/bind.hpp>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/sensors/Noise.hh"
@@ -371,6 +374,87 @@ TEST_F(NoiseTest, OnApplyNoise)
     double value = noise->Apply(i);
     EXPECT_DOUBLE_EQ(value, i*2);
   }
+
+  // Custom noise is applied to each finite value of a block
+  std::vector<double> data = {1.0, 2.0, ignition::math::INF_D, 3.0};
+  noise->Apply(data.data(), data.size());
+  EXPECT_DOUBLE_EQ(data[0], 2.0);
+  EXPECT_DOUBLE_EQ(data[1], 4.0);
+  EXPECT_DOUBLE_EQ(data[2], ignition::math::INF_D);
+  EXPECT_DOUBLE_EQ(data[3], 6.0);
+}
+
+//////////////////////////////////////////////////
+// Test noise application to a block of values
+TEST_F(NoiseTest, ApplyArray)
+{
+  // An odd count checks the last Box-Muller pair
+  const size_t count = 10001;
+
+  // NONE leaves the values as they are
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("none", 0, 0, 0, 0, 0));
+    std::vector<double> data(count, 1.0);
+    noise->Apply(data.data(), data.size());
+    for (const auto value : data)
+      EXPECT_DOUBLE_EQ(value, 1.0);
+  }
+
+  // GAUSSIAN values follow the distribution, and values that are not
+  // finite are left as they are
+  const double mean = 10.0;
+  const double stddev = 5.0;
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("gaussian", mean, stddev, 0, 0, 0));
+    std::vector<double> data(count, 0.0);
+    data[3] = ignition::math::INF_D;
+    data[4] = -ignition::math::INF_D;
+    data[5] = ignition::math::NAN_D;
+    noise->Apply(data.data(), data.size());
+
+    EXPECT_DOUBLE_EQ(data[3], ignition::math::INF_D);
+    EXPECT_DOUBLE_EQ(data[4], -ignition::math::INF_D);
+    EXPECT_TRUE(std::isnan(data[5]));
+
+    boost::accumulators::accumulator_set<double,
+      boost::accumulators::stats<boost::accumulators::tag::mean,
+                                 boost::accumulators::tag::variance > > acc;
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (i < 3 || i > 5)
+        acc(data[i]);
+    }
+
+    // See comments in GaussianNoise function to explain these calculations.
+    const double samples = count - 3;
+    double sampleStdDev = g_sigma*stddev / sqrt(samples);
+    EXPECT_NEAR(boost::accumulators::mean(acc), mean, sampleStdDev);
+
+    double variance = stddev*stddev;
+    double sampleVariance2 = 2 * variance*variance / (samples - 1);
+    EXPECT_NEAR(boost::accumulators::variance(acc),
+                variance, g_sigma*sqrt(sampleVariance2));
+
+    // Each block draws new values
+    std::vector<double> next(count, 0.0);
+    noise->Apply(next.data(), next.size());
+    EXPECT_NE(data[0], next[0]);
+  }
+
+  // GAUSSIAN_QUANTIZED values are rounded to the precision
+  const double precision = 0.5;
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("gaussian_quantized", mean, stddev, 0, 0, precision));
+    std::vector<double> data(count, 0.0);
+    noise->Apply(data.data(), data.size());
+    for (const auto value : data)
+    {
+      EXPECT_NEAR(value / precision, std::round(value / precision), 1e-6);
+    }
+  }
 }
 
 /////////////////////////////////////////////////
@@ -14,12 +14,15 @@
  * limitations under the License.
  *
 */
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/transport.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelSpatialIndex.hh"
 
 #include "gazebo/sensors/RFIDTag.hh"
 #include "gazebo/sensors/SensorFactory.hh"
@@ -31,6 +34,9 @@ using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("rfid", RFIDSensor)
 
+/// \brief Distance within which tags are detected, in meters.
+static const double TagRange = 5.0;
+
 /////////////////////////////////////////////////
 RFIDSensor::RFIDSensor()
 : Sensor(sensors::OTHER),
@@ -108,6 +114,13 @@ void RFIDSensor::Fini()
   Sensor::Fini();
 }
 
+/////////////////////////////////////////////////
+bool RFIDSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void RFIDSensor::Init()
 {
@@ -138,21 +151,32 @@ bool RFIDSensor::UpdateImpl(const bool /*_force*/)
 //////////////////////////////////////////////////
 void RFIDSensor::EvaluateTags()
 {
-  std::vector<RFIDTag*>::const_iterator ci;
+  const ignition::math::Vector3d pos =
+    this->dataPtr->entity->WorldPose().Pos();
+  const ignition::math::Vector3d range(TagRange, TagRange, TagRange);
+
+  // Only check the tags of the models near the sensor, found with the
+  // spatial index of the world
+  this->world->ModelIndex().Intersect(
+      ignition::math::AxisAlignedBox(pos - range, pos + range),
+      this->dataPtr->nearbyModels);
 
-  // iterate through the tags contained given rfid tag manager
-  for (ci = this->dataPtr->tags.begin(); ci != this->dataPtr->tags.end(); ++ci)
+  for (auto const &model : this->dataPtr->nearbyModels)
   {
-    ignition::math::Pose3d pos = (*ci)->TagPose();
-    // std::cout << "link: " << tagModelPtr->GetName() << std::endl;
-    // std::cout << "link pos: x" << pos.pos.x
-    //     << " y:" << pos.pos.y
-    //     << " z:" << pos.pos.z << std::endl;
-    this->CheckTagRange(pos);
+    auto iter = this->dataPtr->tagsByModel.find(model->GetId());
+    if (iter == this->dataPtr->tagsByModel.end())
+      continue;
+
+    for (auto const tag : iter->second)
+      this->CheckTagRange(tag->TagPose());
   }
+  this->dataPtr->nearbyModels.clear();
+
+  for (auto const tag : this->dataPtr->unindexedTags)
+    this->CheckTagRange(tag->TagPose());
 }
 
-//////////////////////////////////////////////////
+/////////////////////////////////////////////////
 bool RFIDSensor::CheckTagRange(const ignition::math::Pose3d &_pose)
 {
   // copy sensor vector pos into a temp var
@@ -161,7 +185,7 @@ bool RFIDSensor::CheckTagRange(const ignition::math::Pose3d &_pose)
 
   // std::cout << v.GetLength() << std::endl;
 
-  if (v.Length() <= 5.0)
+  if (v.Length() <= TagRange)
   {
     // std::cout << "detected " <<  v.GetLength() << std::endl;
     return true;
@@ -175,4 +199,11 @@ bool RFIDSensor::CheckTagRange(const ignition::math::Pose3d &_pose)
 void RFIDSensor::AddTag(RFIDTag *_tag)
 {
   this->dataPtr->tags.push_back(_tag);
+
+  physics::LinkPtr link =
+    boost::dynamic_pointer_cast<physics::Link>(_tag->TagEntity());
+  if (link && link->GetModel())
+    this->dataPtr->tagsByModel[link->GetModel()->GetId()].push_back(_tag);
+  else
+    this->dataPtr->unindexedTags.push_back(_tag);
 }
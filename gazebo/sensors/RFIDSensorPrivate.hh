@@ -17,6 +17,8 @@
 #ifndef _GAZEBO_SENSORS_RFIDSENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_RFIDSENSOR_PRIVATE_HH_
 
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -38,6 +40,16 @@ namespace gazebo
 
       /// \brief All the RFID tags.
       public: std::vector<RFIDTag*> tags;
+
+      /// \brief Tags attached to links, by the id of the model of the link.
+      public: std::unordered_map<uint32_t, std::vector<RFIDTag*>> tagsByModel;
+
+      /// \brief Tags not attached to a link, checked on every update.
+      public: std::vector<RFIDTag*> unindexedTags;
+
+      /// \brief Models near the sensor. Only the storage is kept between
+      /// updates.
+      public: physics::Model_V nearbyModels;
     };
   }
 }
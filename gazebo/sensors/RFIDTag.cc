@@ -129,3 +129,9 @@ ignition::math::Pose3d RFIDTag::TagPose() const
 {
   return this->dataPtr->entity->WorldPose();
 }
+
+/////////////////////////////////////////////////
+physics::EntityPtr RFIDTag::TagEntity() const
+{
+  return this->dataPtr->entity;
+}
@@ -64,6 +64,10 @@ namespace gazebo
       /// \return Pose of object.
       public: ignition::math::Pose3d TagPose() const;
 
+      /// \brief Returns the entity the tag is attached to.
+      /// \return The parent entity, usually a link.
+      public: physics::EntityPtr TagEntity() const;
+
       /// \internal
       /// \brief Private data pointer.
       private: std::unique_ptr<RFIDTagPrivate> dataPtr;
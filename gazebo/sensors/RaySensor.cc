@@ -14,9 +14,10 @@
  * limitations under the License.
  *
 */
+#include <cmath>
 #include <boost/algorithm/string.hpp>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/MultiRayShape.hh"
@@ -52,6 +53,14 @@ RaySensor::RaySensor()
 : Sensor(sensors::RAY),
   dataPtr(new RaySensorPrivate)
 {
+  // Batched shapes read the ray query snapshot of the world instead of
+  // the physics engine
+  this->SetConcurrentUpdate([this]()
+      {
+        return this->dataPtr->laserShape &&
+            this->dataPtr->laserShape->Batched() && this->world &&
+            this->world->RayQuerySnapshotEnabled();
+      });
 }
 
 //////////////////////////////////////////////////
@@ -75,6 +84,7 @@ void RaySensor::Load(const std::string &_worldName)
   Sensor::Load(_worldName);
   this->dataPtr->scanPub =
     this->node->Advertise<msgs::LaserScanStamped>(this->Topic(), 50);
+  this->dataPtr->scanPub->SetPriority(transport::Publisher::BULK);
 
   GZ_ASSERT(this->world != nullptr,
       "RaySensor did not get a valid World pointer");
@@ -487,19 +497,30 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
       {
         range = -ignition::math::INF_D;
       }
-      else if (this->noises.find(RAY_NOISE) !=
-               this->noises.end())
-      {
-        // currently supports only one noise model per laser sensor
-        range = this->noises[RAY_NOISE]->Apply(range);
-        range = ignition::math::clamp(range,
-            this->RangeMin(), this->RangeMax());
-      }
 
       scan->add_ranges(range);
       scan->add_intensities(intensity);
     }
   }
+
+  // Apply the noise to all the ranges at once. Masked ranges aren't finite,
+  // and are left as they are.
+  // currently supports only one noise model per laser sensor
+  auto noise = this->noises.find(RAY_NOISE);
+  if (noise != this->noises.end())
+  {
+    double *ranges = scan->mutable_ranges()->mutable_data();
+    const int size = scan->ranges_size();
+    noise->second->Apply(ranges, size);
+    for (int i = 0; i < size; ++i)
+    {
+      if (std::isfinite(ranges[i]))
+      {
+        ranges[i] = ignition::math::clamp(ranges[i],
+            this->RangeMin(), this->RangeMax());
+      }
+    }
+  }
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("Publish");
@@ -14,7 +14,7 @@
  * limitations under the License.
  *
 */
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/transport/transport.hh"
 
@@ -28,7 +28,9 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/PluginProfiler.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
+#include "gazebo/common/URI.hh"
 
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/Distortion.hh"
@@ -41,6 +43,9 @@
 #include "gazebo/sensors/SensorPrivate.hh"
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/sensors/SensorsIface.hh"
+
+#include "gazebo/util/IntrospectionManager.hh"
 
 using namespace gazebo;
 using namespace sensors;
@@ -49,6 +54,10 @@ sdf::ElementPtr SensorPrivate::sdfSensor;
 
 bool Sensor::useStrictRate = false;
 
+/// \brief Weight of the latest sample in the averages of the update
+/// statistics.
+static const double STATS_SMOOTHING = 0.1;
+
 //////////////////////////////////////////////////
 Sensor::Sensor(SensorCategory _cat)
 : dataPtr(new SensorPrivate)
@@ -142,6 +151,8 @@ void Sensor::Load(const std::string &_worldName)
   if (this->sdf->Get<bool>("always_on"))
     this->SetActive(true);
 
+  this->dataPtr->onDemand = sensors::on_demand_enabled();
+
   this->useStrictRate = rendering::lockstep_enabled();
 
   if (this->dataPtr->category == IMAGE)
@@ -176,6 +187,9 @@ void Sensor::Init()
   msgs::Sensor msg;
   this->FillMsg(msg);
   this->dataPtr->sensorPub->Publish(msg);
+
+  this->UnregisterIntrospectionItems();
+  this->RegisterIntrospectionItems();
 }
 
 //////////////////////////////////////////////////
@@ -213,7 +227,7 @@ bool Sensor::NeedsUpdate()
   if (this->dataPtr->category == IMAGE && this->scene)
     simTime = this->scene->SimTime();
   else
-    simTime = this->world->SimTime();
+    simTime = this->world->StepSimTime();
 
   // case when last update occurred in the future probably due to
   // world reset
@@ -236,19 +250,25 @@ void Sensor::Update(const bool _force)
 {
   if (this->IsActive() || _force)
   {
+    common::Time simTime;
+    if (this->dataPtr->category == IMAGE && this->scene)
+      simTime = this->scene->SimTime();
+    else
+      simTime = this->world->StepSimTime();
+
+    common::Timer timer;
     if (this->useStrictRate)
     {
+      timer.Start();
       if (this->UpdateImpl(_force))
+      {
+        this->RecordUpdate(simTime, timer.GetElapsed(), 0);
         this->updated();
+      }
     }
     else
     {
-      common::Time simTime;
-      if (this->dataPtr->category == IMAGE && this->scene)
-        simTime = this->scene->SimTime();
-      else
-        simTime = this->world->SimTime();
-
+      uint64_t missed = 0;
       {
         std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
 
@@ -268,6 +288,13 @@ void Sensor::Update(const bool _force)
         this->dataPtr->updateDelay = std::max(common::Time::Zero,
             adjustedElapsed - this->updatePeriod);
 
+        // Every full update period beyond the first since the last update
+        // is an update the sensor missed
+        double periods = this->updatePeriod > common::Time::Zero ?
+            adjustedElapsed.Double() / this->updatePeriod.Double() : 0.0;
+        if (periods >= 2.0 && this->lastUpdateTime > common::Time::Zero)
+          missed = static_cast<uint64_t>(periods) - 1;
+
         // if delay is more than a full update period, then give up trying
         // to catch up. This happens normally when the sensor just changed from
         // an inactive to an active state, or the sensor just cannot hit its
@@ -276,8 +303,10 @@ void Sensor::Update(const bool _force)
           this->dataPtr->updateDelay = common::Time::Zero;
       }
 
+      timer.Start();
       if (this->UpdateImpl(_force))
       {
+        this->RecordUpdate(simTime, timer.GetElapsed(), missed);
         std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
         this->lastUpdateTime = simTime;
         this->updated();
@@ -289,6 +318,8 @@ void Sensor::Update(const bool _force)
 //////////////////////////////////////////////////
 void Sensor::Fini()
 {
+  this->UnregisterIntrospectionItems();
+
   if (this->node)
     this->node->Fini();
   this->node.reset();
@@ -301,6 +332,7 @@ void Sensor::Fini()
 
   this->active = false;
   this->plugins.clear();
+  this->dataPtr->memory.Set(0);
 
   if (this->sdf)
     this->sdf->Reset();
@@ -344,6 +376,8 @@ void Sensor::LoadPlugin(sdf::ElementPtr _sdf)
     }
 
     SensorPtr myself = shared_from_this();
+    common::PluginProfiler::Scope scope(filename,
+        this->ScopedName() + "::" + name);
     plugin->Load(myself, _sdf);
     plugin->Init();
     this->plugins.push_back(plugin);
@@ -359,9 +393,31 @@ void Sensor::SetActive(const bool _value)
 //////////////////////////////////////////////////
 bool Sensor::IsActive() const
 {
+  if (this->dataPtr->onDemand)
+    return this->updated.ConnectionCount() > 0;
+
   return this->active;
 }
 
+//////////////////////////////////////////////////
+void Sensor::SetOnDemand(const bool _onDemand)
+{
+  this->dataPtr->onDemand = _onDemand;
+}
+
+//////////////////////////////////////////////////
+bool Sensor::OnDemand() const
+{
+  return this->dataPtr->onDemand;
+}
+
+//////////////////////////////////////////////////
+bool Sensor::ConcurrentUpdate() const
+{
+  return this->dataPtr->concurrentUpdate &&
+      this->dataPtr->concurrentUpdate();
+}
+
 //////////////////////////////////////////////////
 ignition::math::Pose3d Sensor::Pose() const
 {
@@ -418,6 +474,201 @@ common::Time Sensor::LastMeasurementTime() const
   return this->lastMeasurementTime;
 }
 
+//////////////////////////////////////////////////
+common::Time Sensor::NextUpdateTime() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+
+  // Matches the condition in Sensor::Update
+  return this->lastUpdateTime + std::max(common::Time::Zero,
+      this->updatePeriod - this->dataPtr->updateDelay);
+}
+
+//////////////////////////////////////////////////
+common::Time Sensor::ScheduleSlip() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  return this->dataPtr->scheduleSlip;
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetScheduleSlip(const common::Time &_slip)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  this->dataPtr->scheduleSlip = _slip;
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetMemoryUsage(const size_t _bytes)
+{
+  // The top level model of the parent link owns the buffers
+  this->dataPtr->memory.SetOwner(
+      this->parentName.substr(0, this->parentName.find("::")));
+  this->dataPtr->memory.Set(_bytes);
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetConcurrentUpdate(const std::function<bool ()> &_check)
+{
+  this->dataPtr->concurrentUpdate = _check;
+}
+
+//////////////////////////////////////////////////
+void Sensor::RecordStageTime(const SensorStage _stage,
+    const common::Time &_time)
+{
+  if (_stage < 0 || _stage >= STAGE_COUNT)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStats);
+  double &average = this->dataPtr->stageTimes[_stage];
+  if (ignition::math::equal(average, 0.0))
+    average = _time.Double();
+  else
+    average += STATS_SMOOTHING * (_time.Double() - average);
+}
+
+//////////////////////////////////////////////////
+void Sensor::RecordUpdate(const common::Time &_simTime,
+    const common::Time &_wallTime, const uint64_t _missed)
+{
+  this->RecordStageTime(STAGE_UPDATE, _wallTime);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStats);
+  ++this->dataPtr->updateCount;
+  this->dataPtr->missedCount += _missed;
+
+  // The interval is skipped for the first update and when simulation time
+  // went backwards, after a world reset
+  if (this->dataPtr->prevUpdateTime > common::Time::Zero &&
+      _simTime > this->dataPtr->prevUpdateTime)
+  {
+    double interval = (_simTime - this->dataPtr->prevUpdateTime).Double();
+    double &average = this->dataPtr->updateInterval;
+    if (ignition::math::equal(average, 0.0))
+      average = interval;
+    else
+      average += STATS_SMOOTHING * (interval - average);
+  }
+  this->dataPtr->prevUpdateTime = _simTime;
+}
+
+//////////////////////////////////////////////////
+double Sensor::StageTime(const SensorStage _stage) const
+{
+  if (_stage < 0 || _stage >= STAGE_COUNT)
+    return 0.0;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStats);
+  return this->dataPtr->stageTimes[_stage];
+}
+
+//////////////////////////////////////////////////
+double Sensor::AchievedUpdateRate() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStats);
+  if (this->dataPtr->updateInterval > 0.0)
+    return 1.0 / this->dataPtr->updateInterval;
+  return 0.0;
+}
+
+//////////////////////////////////////////////////
+uint64_t Sensor::UpdateCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStats);
+  return this->dataPtr->updateCount;
+}
+
+//////////////////////////////////////////////////
+uint64_t Sensor::MissedUpdateCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStats);
+  return this->dataPtr->missedCount;
+}
+
+//////////////////////////////////////////////////
+void Sensor::FillStatsMsg(msgs::SensorStats::Sensor &_msg) const
+{
+  _msg.set_name(this->ScopedName());
+  _msg.set_type(this->Type());
+  _msg.set_update_rate(this->UpdateRate());
+  _msg.set_achieved_rate(this->AchievedUpdateRate());
+  _msg.set_update_time(this->StageTime(STAGE_UPDATE));
+  if (this->dataPtr->category == IMAGE)
+  {
+    _msg.set_render_time(this->StageTime(STAGE_RENDER));
+    _msg.set_readback_time(this->StageTime(STAGE_READBACK));
+  }
+  _msg.set_publish_time(this->StageTime(STAGE_PUBLISH));
+  _msg.set_update_count(this->UpdateCount());
+  _msg.set_missed_count(this->MissedUpdateCount());
+}
+
+//////////////////////////////////////////////////
+void Sensor::RegisterIntrospectionItems()
+{
+  common::URI uri;
+  auto parent = this->world->BaseByName(this->ParentName());
+  if (parent)
+  {
+    uri = parent->URI();
+  }
+  else
+  {
+    uri.SetScheme("data");
+    uri.Path().PushBack("world");
+    uri.Path().PushBack(this->world->Name());
+  }
+  uri.Path().PushBack("sensor");
+  uri.Path().PushBack(this->Name());
+
+  auto registerItem = [&](const std::string &_name,
+      const std::function<double()> &_cb)
+  {
+    common::URI itemURI(uri);
+    itemURI.Query().Insert("p", "double/" + _name);
+    this->dataPtr->introspectionItems.push_back(itemURI.Str());
+    util::IntrospectionManager::Instance()->Register<double>(
+        itemURI.Str(), _cb);
+  };
+
+  registerItem("update_time", [this]()
+  {
+    return this->StageTime(STAGE_UPDATE);
+  });
+  if (this->dataPtr->category == IMAGE)
+  {
+    registerItem("render_time", [this]()
+    {
+      return this->StageTime(STAGE_RENDER);
+    });
+    registerItem("readback_time", [this]()
+    {
+      return this->StageTime(STAGE_READBACK);
+    });
+  }
+  registerItem("publish_time", [this]()
+  {
+    return this->StageTime(STAGE_PUBLISH);
+  });
+  registerItem("achieved_rate", [this]()
+  {
+    return this->AchievedUpdateRate();
+  });
+  registerItem("missed_count", [this]()
+  {
+    return static_cast<double>(this->MissedUpdateCount());
+  });
+}
+
+//////////////////////////////////////////////////
+void Sensor::UnregisterIntrospectionItems()
+{
+  for (auto const &item : this->dataPtr->introspectionItems)
+    util::IntrospectionManager::Instance()->Unregister(item);
+  this->dataPtr->introspectionItems.clear();
+}
+
 //////////////////////////////////////////////////
 std::string Sensor::Type() const
 {
@@ -520,6 +771,7 @@ void Sensor::ResetLastUpdateTime()
   this->lastUpdateTime = 0.0;
   this->lastMeasurementTime = 0.0;
   this->dataPtr->updateDelay = 0.0;
+  this->dataPtr->scheduleSlip = 0.0;
 }
 
 //////////////////////////////////////////////////
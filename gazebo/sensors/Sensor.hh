@@ -17,6 +17,7 @@
 #ifndef GAZEBO_SENSORS_SENSOR_HH_
 #define GAZEBO_SENSORS_SENSOR_HH_
 
+#include <functional>
 #include <vector>
 #include <memory>
 #include <map>
@@ -119,9 +120,36 @@ namespace gazebo
       public: virtual void SetActive(const bool _value);
 
       /// \brief Returns true if sensor generation is active.
+      /// In on demand mode, the sensor is only active while a callback is
+      /// connected with ConnectUpdated, or, for sensors that publish their
+      /// data, while the topic has subscribers.
       /// \return True if active, false if not.
+      /// \sa SetOnDemand
       public: virtual bool IsActive() const;
 
+      /// \brief Set whether the sensor is only updated on demand. In on
+      /// demand mode, <always_on> and SetActive don't keep the sensor
+      /// active, and the sensor skips its updates until someone consumes
+      /// its data. The default is given by sensors::on_demand_enabled.
+      /// \param[in] _onDemand True to update the sensor on demand.
+      /// \sa IsActive
+      public: void SetOnDemand(const bool _onDemand);
+
+      /// \brief Get whether the sensor is only updated on demand.
+      /// \return True if the sensor is updated on demand.
+      /// \sa SetOnDemand
+      public: bool OnDemand() const;
+
+      /// \brief Check whether the sensor can be updated on a worker
+      /// thread, concurrently with the other sensors of its category. Only
+      /// sensors that do not query or change the physics engine can, such
+      /// as ray sensors that read a ray query snapshot, or sensors that
+      /// only read the state of their link. Sensors of the OTHER category
+      /// are updated on get_worker_thread_count() threads.
+      /// \return True for a concurrent update, false by default.
+      /// \sa SetConcurrentUpdate
+      public: bool ConcurrentUpdate() const;
+
       /// \brief Get sensor type.
       /// \return Type of sensor.
       public: std::string Type() const;
@@ -134,6 +162,45 @@ namespace gazebo
       /// \return Time of last measurement.
       public: common::Time LastMeasurementTime() const;
 
+      /// \brief Get the simulation time at which the sensor is next due
+      /// for an update, from its last update, its update rate and the delay
+      /// it is catching up on.
+      /// \return Time of the next update. Sensors without an update rate
+      /// are due as soon as simulation time moves past the last update.
+      public: common::Time NextUpdateTime() const;
+
+      /// \brief Get how late the last scheduled update of the sensor was,
+      /// which grows when the sensor thread can't keep up.
+      /// \return Simulation time between the time the sensor was due and
+      /// the time it was updated.
+      public: common::Time ScheduleSlip() const;
+
+      /// \brief Get the average wall time the sensor spends in a stage of
+      /// its updates. Stages a sensor doesn't have take no time.
+      /// \param[in] _stage The stage of the update.
+      /// \return Average wall time of the stage over recent updates, in
+      /// seconds.
+      public: double StageTime(const SensorStage _stage) const;
+
+      /// \brief Get the update rate the sensor actually achieves, which is
+      /// lower than UpdateRate when the sensor can't keep up.
+      /// \return Updates per second of simulation time over recent updates,
+      /// or zero before the second update.
+      public: double AchievedUpdateRate() const;
+
+      /// \brief Get the number of updates of the sensor.
+      /// \return Number of successful calls to UpdateImpl.
+      public: uint64_t UpdateCount() const;
+
+      /// \brief Get the number of update periods the sensor missed, because
+      /// its updates came more than a full update period late.
+      /// \return Number of missed updates.
+      public: uint64_t MissedUpdateCount() const;
+
+      /// \brief Fill a message with the update statistics of the sensor.
+      /// \param[out] _msg Message to fill.
+      public: void FillStatsMsg(msgs::SensorStats::Sensor &_msg) const;
+
       /// \brief Return true if user requests the sensor to be visualized
       ///        via tag:  <visualize>true</visualize> in SDF.
       /// \return True if visualized, false if not.
@@ -197,10 +264,46 @@ namespace gazebo
       /// \return True if the sensor was updated.
       protected: virtual bool UpdateImpl(const bool /*_force*/) {return false;}
 
+      /// \brief Record the wall time spent in a stage of an update.
+      /// UpdateImpl implementations call this for the stages that run
+      /// outside of Sensor::Update, such as rendering and publishing.
+      /// \param[in] _stage The stage of the update.
+      /// \param[in] _time Wall time spent in the stage.
+      protected: void RecordStageTime(const SensorStage _stage,
+                     const common::Time &_time);
+
+      /// \brief Set the memory held by the data buffers of the sensor,
+      /// counted by common::MemoryAccounting for the model of the sensor.
+      /// \param[in] _bytes Size in bytes.
+      protected: void SetMemoryUsage(const size_t _bytes);
+
+      /// \brief Set the check returned by ConcurrentUpdate. Sensors whose
+      /// update only reads state that does not change while the physics
+      /// engine steps set it in their constructor.
+      /// \param[in] _check Returns true when the sensor can update
+      /// concurrently.
+      protected: void SetConcurrentUpdate(
+                     const std::function<bool ()> &_check);
+
       /// \brief Return true if the sensor needs to be updated.
       /// \return True when sensor should be updated.
       protected: virtual bool NeedsUpdate();
 
+      /// \brief Record the statistics of a successful update.
+      /// \param[in] _simTime Simulation time of the update.
+      /// \param[in] _wallTime Wall time spent in UpdateImpl.
+      /// \param[in] _missed Number of update periods missed before it.
+      private: void RecordUpdate(const common::Time &_simTime,
+                   const common::Time &_wallTime, const uint64_t _missed);
+
+      /// \brief Register the update statistics of the sensor in the
+      /// introspection service.
+      private: void RegisterIntrospectionItems();
+
+      /// \brief Unregister the update statistics of the sensor from the
+      /// introspection service.
+      private: void UnregisterIntrospectionItems();
+
       /// \brief Load a plugin for this sensor.
       /// \param[in] _sdf SDF parameters.
       private: void LoadPlugin(sdf::ElementPtr _sdf);
@@ -262,6 +365,14 @@ namespace gazebo
       /// \brief Ignition transport node
       protected: ignition::transport::Node nodeIgn;
 
+      /// \brief Set how late the last scheduled update was.
+      /// \param[in] _slip Simulation time between the time the sensor was
+      /// due and the time it was updated.
+      private: void SetScheduleSlip(const common::Time &_slip);
+
+      /// \brief The sensor manager schedules the updates.
+      private: friend class SensorManager;
+
       /// \internal
       /// \brief Data pointer for private data
       private: std::unique_ptr<SensorPrivate> dataPtr;
@@ -14,20 +14,34 @@
  * limitations under the License.
  *
 */
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
 
+#include <algorithm>
+#include <condition_variable>
 #include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <boost/bind.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Time.hh"
 
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/sensors/SensorsIface.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/transport/transport.hh"
 #include "gazebo/util/LogPlay.hh"
 
 using namespace gazebo;
@@ -37,14 +51,318 @@ using namespace sensors;
 /// for timing coordination.
 boost::mutex g_sensorTimingMutex;
 
-/// \brief Flag to indicate if number of sensors has changed and that the
-/// max update rate needs to be recalculated
-bool g_sensorsDirty = true;
+/// \brief Wall time between publications of the sensor statistics.
+static const common::Time STATS_PERIOD(1.0);
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \brief Threads that update sensors in parallel. Each sensor is
+    /// always updated by the same thread, so that its state stays in the
+    /// cache of one core.
+    class SensorWorkerPool
+    {
+      /// \brief Constructor.
+      /// \param[in] _threadCount Number of threads. With one thread, the
+      /// sensors are updated by the caller of Update.
+      public: explicit SensorWorkerPool(const unsigned int _threadCount);
+
+      /// \brief Destructor. Stops the threads.
+      public: ~SensorWorkerPool();
+
+      /// \brief Update sensors, and wait for all of them to finish.
+      /// \param[in] _sensors The sensors.
+      /// \param[in] _force True to force the sensors to update.
+      public: void Update(const Sensor_V &_sensors, const bool _force);
+
+      /// \brief Forget the thread of a removed sensor.
+      /// \param[in] _id Id of the sensor.
+      public: void Remove(const uint32_t _id);
+
+      /// \brief Get the thread of a sensor, assigning the thread with the
+      /// fewest sensors on first use.
+      /// \param[in] _id Id of the sensor.
+      /// \return Index of the thread.
+      private: size_t Worker(const uint32_t _id);
+
+      /// \brief Loop of a thread.
+      /// \param[in] _index Index of the thread.
+      private: void Run(const size_t _index);
+
+      /// \brief The threads, empty with a thread count of one.
+      private: std::vector<std::unique_ptr<boost::thread>> threads;
+
+      /// \brief Sensors to update, by thread.
+      private: std::vector<Sensor_V> tasks;
+
+      /// \brief Thread of each sensor, by sensor id.
+      private: std::map<uint32_t, size_t> affinity;
+
+      /// \brief Number of sensors of each thread.
+      private: std::vector<size_t> load;
+
+      /// \brief Number of threads that have not finished the update.
+      private: size_t pending = 0;
+
+      /// \brief Incremented for each update, wakes up the threads.
+      private: uint64_t generation = 0;
+
+      /// \brief Force argument of the current update.
+      private: bool force = false;
+
+      /// \brief True to stop the threads.
+      private: bool stop = false;
+
+      /// \brief Protects the members above.
+      private: std::mutex mutex;
+
+      /// \brief Notified when an update starts, or to stop.
+      private: std::condition_variable workCondition;
+
+      /// \brief Notified when the threads finished an update.
+      private: std::condition_variable doneCondition;
+    };
+  }
+}
+
+/// \internal
+/// \brief Private data for the SensorManager class.
+class gazebo::sensors::SensorManagerPrivate
+{
+  /// \brief Node for publishing the update statistics of the sensors.
+  public: transport::NodePtr statsNode;
+
+  /// \brief Publisher of the update statistics of the sensors.
+  public: transport::PublisherPtr statsPub;
+
+  /// \brief Wall time the statistics were last published.
+  public: common::Time statsTime;
+};
+
+namespace
+{
+  /// \brief Private data of the sensor managers, by manager. It is kept
+  /// out of SensorManager so that the layout of the class doesn't change.
+  class SensorManagerPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the managers.
+    public: static SensorManagerPrivates &Instance()
+    {
+      static SensorManagerPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by manager.
+    public: std::unordered_map<const SensorManager *,
+            std::unique_ptr<SensorManagerPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
+/// \internal
+/// \brief Private data for the SensorContainer class.
+class gazebo::sensors::SensorManager::SensorContainerPrivate
+{
+  /// \brief A sensor and the simulation time it is due.
+  public: typedef std::pair<common::Time, SensorPtr> DueSensor;
+
+  /// \brief Orders the schedule, earliest time first.
+  public: class LaterDue
+  {
+    /// \brief Compare two scheduled sensors.
+    /// \param[in] _a First sensor.
+    /// \param[in] _b Second sensor.
+    /// \return True if _a is due after _b.
+    public: bool operator()(const DueSensor &_a, const DueSensor &_b) const
+    {
+      return _a.first > _b.first;
+    }
+  };
+
+  /// \brief Sensors of the run thread, by the simulation time they are
+  /// next due. Sensors that are not due are left alone.
+  public: std::priority_queue<DueSensor, std::vector<DueSensor>, LaterDue>
+          schedule;
+
+  /// \brief Sensors taken from the schedule by the last UpdateDue, kept to
+  /// avoid an allocation per update.
+  public: std::vector<DueSensor> dueEntries;
+
+  /// \brief Sensors updated by the last UpdateDue.
+  public: Sensor_V dueSensors;
+
+  /// \brief True to rebuild the schedule, after sensors are added or
+  /// removed, or time is reset.
+  public: bool scheduleDirty = true;
+
+  /// \brief Simulation time of the last UpdateDue, used to detect that
+  /// time went back.
+  public: common::Time scheduleTime;
+
+  /// \brief Sensors updated concurrently during the last Update, kept to
+  /// avoid an allocation per update.
+  public: Sensor_V concurrentSensors;
+
+  /// \brief True to update concurrent sensors on a worker pool.
+  public: bool useWorkers = false;
+
+  /// \brief Threads that update the concurrent sensors, while the
+  /// runThread runs.
+  public: std::unique_ptr<SensorWorkerPool> workers;
+
+  /// \brief Index of the window of simulation time that was last rendered
+  /// by an ImageSensorContainer, when rendering is batched.
+  /// \sa set_render_batch_window
+  public: double renderBatch = std::numeric_limits<double>::quiet_NaN();
+};
+
+/// \internal
+/// \brief Private data of the sensor containers, by container. It is kept
+/// out of SensorContainer so that the layout of the class doesn't change.
+class gazebo::sensors::SensorManager::SensorContainerPrivates
+{
+  /// \brief Get the instance.
+  /// \return The private data of all the containers.
+  public: static SensorContainerPrivates &Instance()
+  {
+    static SensorContainerPrivates instance;
+    return instance;
+  }
+
+  /// \brief Private data by container.
+  public: std::unordered_map<const SensorContainer *,
+          std::unique_ptr<SensorContainerPrivate>> data;
+
+  /// \brief Protects data.
+  public: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+SensorWorkerPool::SensorWorkerPool(const unsigned int _threadCount)
+{
+  const size_t count = _threadCount > 1 ? _threadCount : 0;
+  this->tasks.resize(count);
+  this->load.resize(count, 0);
+  for (size_t i = 0; i < count; ++i)
+  {
+    this->threads.push_back(std::unique_ptr<boost::thread>(new boost::thread(
+        boost::bind(&SensorWorkerPool::Run, this, i))));
+  }
+}
+
+//////////////////////////////////////////////////
+SensorWorkerPool::~SensorWorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->workCondition.notify_all();
+
+  for (auto &thread : this->threads)
+    thread->join();
+}
+
+//////////////////////////////////////////////////
+void SensorWorkerPool::Update(const Sensor_V &_sensors, const bool _force)
+{
+  if (this->threads.empty())
+  {
+    for (auto &sensor : _sensors)
+      sensor->Update(_force);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(this->mutex);
+  for (auto &sensor : _sensors)
+    this->tasks[this->Worker(sensor->Id())].push_back(sensor);
+
+  this->pending = 0;
+  for (auto &task : this->tasks)
+  {
+    if (!task.empty())
+      ++this->pending;
+  }
+
+  if (this->pending == 0)
+    return;
+
+  this->force = _force;
+  ++this->generation;
+  this->workCondition.notify_all();
+
+  this->doneCondition.wait(lock, [this] {return this->pending == 0;});
+}
+
+//////////////////////////////////////////////////
+void SensorWorkerPool::Remove(const uint32_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto iter = this->affinity.find(_id);
+  if (iter != this->affinity.end())
+  {
+    --this->load[iter->second];
+    this->affinity.erase(iter);
+  }
+}
+
+//////////////////////////////////////////////////
+size_t SensorWorkerPool::Worker(const uint32_t _id)
+{
+  auto iter = this->affinity.find(_id);
+  if (iter != this->affinity.end())
+    return iter->second;
+
+  size_t worker = std::min_element(this->load.begin(), this->load.end()) -
+    this->load.begin();
+  ++this->load[worker];
+  this->affinity[_id] = worker;
+  return worker;
+}
+
+//////////////////////////////////////////////////
+void SensorWorkerPool::Run(const size_t _index)
+{
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->workCondition.wait(lock, [this, seen]
+        {return this->stop || this->generation != seen;});
+    if (this->stop)
+      return;
+
+    seen = this->generation;
+    if (this->tasks[_index].empty())
+      continue;
+
+    // The tasks of this thread are not changed until all threads are done
+    const bool updateForce = this->force;
+    lock.unlock();
+    for (auto &sensor : this->tasks[_index])
+      sensor->Update(updateForce);
+    lock.lock();
+
+    this->tasks[_index].clear();
+    if (--this->pending == 0)
+      this->doneCondition.notify_one();
+  }
+}
 
 //////////////////////////////////////////////////
 SensorManager::SensorManager()
   : initialized(false), removeAllSensors(false)
 {
+  {
+    SensorManagerPrivates &privates = SensorManagerPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new SensorManagerPrivate);
+  }
+
   // sensors::IMAGE container
   this->sensorContainers.push_back(new ImageSensorContainer());
 
@@ -52,7 +370,7 @@ SensorManager::SensorManager()
   this->sensorContainers.push_back(new SensorContainer());
 
   // sensors::OTHER container
-  this->sensorContainers.push_back(new SensorContainer());
+  this->sensorContainers.push_back(new SensorContainer(true));
 }
 
 //////////////////////////////////////////////////
@@ -71,6 +389,18 @@ SensorManager::~SensorManager()
   this->sensorContainers.clear();
 
   this->initSensors.clear();
+
+  SensorManagerPrivates &privates = SensorManagerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+SensorManagerPrivate *SensorManager::SensorManagerData() const
+{
+  SensorManagerPrivates &privates = SensorManagerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -203,6 +533,43 @@ void SensorManager::Update(bool _force)
   // Only update if there are sensors
   if (this->sensorContainers[sensors::IMAGE]->sensors.size() > 0)
     this->sensorContainers[sensors::IMAGE]->Update(_force);
+
+  this->PublishStats();
+}
+
+//////////////////////////////////////////////////
+void SensorManager::PublishStats()
+{
+  SensorManagerPrivate *data = this->SensorManagerData();
+  common::Time wallTime = common::Time::GetWallTime();
+  if (wallTime - data->statsTime < STATS_PERIOD)
+    return;
+  data->statsTime = wallTime;
+
+  physics::WorldPtr world;
+  {
+    boost::recursive_mutex::scoped_lock lock(this->mutex);
+    if (this->worlds.empty())
+      return;
+    world = this->worlds.begin()->second;
+  }
+
+  if (!data->statsNode)
+  {
+    data->statsNode = transport::NodePtr(new transport::Node());
+    data->statsNode->Init(world->Name());
+    data->statsPub =
+      data->statsNode->Advertise<msgs::SensorStats>("~/sensors/stats");
+  }
+
+  if (!data->statsPub->HasConnections())
+    return;
+
+  msgs::SensorStats msg;
+  msgs::Set(msg.mutable_sim_time(), world->SimTime());
+  for (auto const &sensor : this->GetSensors())
+    sensor->FillStatsMsg(*msg.add_sensor());
+  data->statsPub->Publish(msg);
 }
 
 //////////////////////////////////////////////////
@@ -299,6 +666,12 @@ void SensorManager::Fini()
   delete this->simTimeEventHandler;
   this->simTimeEventHandler = nullptr;
 
+  SensorManagerPrivate *data = this->SensorManagerData();
+  data->statsPub.reset();
+  if (data->statsNode)
+    data->statsNode->Fini();
+  data->statsNode.reset();
+
   this->initialized = false;
 }
 
@@ -434,6 +807,30 @@ Sensor_V SensorManager::GetSensors() const
   return result;
 }
 
+//////////////////////////////////////////////////
+unsigned int SensorManager::ActiveSensorCount() const
+{
+  unsigned int count = 0;
+  for (auto const &sensor : this->GetSensors())
+  {
+    if (sensor->IsActive())
+      ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorManager::IdleSensorCount() const
+{
+  unsigned int count = 0;
+  for (auto const &sensor : this->GetSensors())
+  {
+    if (!sensor->IsActive())
+      ++count;
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////
 void SensorManager::RemoveSensor(const std::string &_name)
 {
@@ -472,7 +869,21 @@ void SensorManager::RemoveSensors()
 
 //////////////////////////////////////////////////
 SensorManager::SensorContainer::SensorContainer()
+  : SensorContainer(false)
+{
+}
+
+//////////////////////////////////////////////////
+SensorManager::SensorContainer::SensorContainer(const bool _useWorkers)
 {
+  {
+    SensorContainerPrivates &privates = SensorContainerPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    SensorContainerPrivate *data = new SensorContainerPrivate;
+    data->useWorkers = _useWorkers;
+    privates.data[this].reset(data);
+  }
+
   this->stop = true;
   this->initialized = false;
   this->runThread = nullptr;
@@ -482,6 +893,19 @@ SensorManager::SensorContainer::SensorContainer()
 SensorManager::SensorContainer::~SensorContainer()
 {
   this->sensors.clear();
+
+  SensorContainerPrivates &privates = SensorContainerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+SensorManager::SensorContainerPrivate *
+SensorManager::SensorContainer::ContainerData() const
+{
+  SensorContainerPrivates &privates = SensorContainerPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -521,6 +945,10 @@ void SensorManager::SensorContainer::Fini()
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::Run()
 {
+  SensorContainerPrivate *data = this->ContainerData();
+  if (data->useWorkers)
+    data->workers.reset(new SensorWorkerPool(get_worker_thread_count()));
+
   this->runThread = new boost::thread(
       boost::bind(&SensorManager::SensorContainer::RunLoop, this));
 
@@ -541,6 +969,7 @@ void SensorManager::SensorContainer::Stop()
     delete this->runThread;
     this->runThread = nullptr;
   }
+  this->ContainerData()->workers.reset();
 }
 
 //////////////////////////////////////////////////
@@ -570,8 +999,7 @@ void SensorManager::SensorContainer::RunLoop()
   // Release engine pointer, we don't need it in the loop
   engine.reset();
 
-  common::Time sleepTime, startTime, eventTime, diffTime;
-  double maxUpdateRate = 0;
+  common::Time startTime, eventTime, diffTime, nextTime;
 
   boost::mutex tmpMutex;
   boost::mutex::scoped_lock lock2(tmpMutex);
@@ -585,35 +1013,6 @@ void SensorManager::SensorContainer::RunLoop()
       return;
   }
 
-
-  auto computeMaxUpdateRate = [&]()
-  {
-    {
-      boost::recursive_mutex::scoped_lock lock(this->mutex);
-
-      if (!g_sensorsDirty)
-        return;
-
-      // Get the minimum update rate from the sensors.
-      for (Sensor_V::iterator iter = this->sensors.begin();
-          iter != this->sensors.end() && !this->stop; ++iter)
-      {
-        GZ_ASSERT((*iter) != nullptr, "Sensor is null");
-        maxUpdateRate = std::max((*iter)->UpdateRate(), maxUpdateRate);
-      }
-
-      g_sensorsDirty = false;
-    }
-
-    // Calculate an appropriate sleep time.
-    if (maxUpdateRate > 0)
-      sleepTime.Set(1.0 / (maxUpdateRate));
-    else
-      sleepTime.Set(0, 1e6);
-  };
-
-  computeMaxUpdateRate();
-
   IGN_PROFILE_THREAD_NAME("SensorManager");
 
   while (!this->stop)
@@ -629,13 +1028,11 @@ void SensorManager::SensorContainer::RunLoop()
         return;
     }
 
-    computeMaxUpdateRate();
-
     // Get the start time of the update.
     startTime = world->SimTime();
 
     IGN_PROFILE_BEGIN("UpdateSensors");
-    this->Update(false);
+    nextTime = this->UpdateDue(startTime);
     IGN_PROFILE_END();
 
     // Compute the time it took to update the sensors.
@@ -643,8 +1040,10 @@ void SensorManager::SensorContainer::RunLoop()
     // would case a negative diffTime. Instead, just use a event time of zero
     diffTime = std::max(common::Time::Zero, world->SimTime() - startTime);
 
-    // Set the default sleep time
-    eventTime = std::max(common::Time::Zero, sleepTime - diffTime);
+    // Sleep until the earliest sensor is due. A zero time wakes up at the
+    // next world update.
+    eventTime = std::max(common::Time::Zero,
+        nextTime - startTime - diffTime);
 
     // Make sure update time is reasonable.
     // During log playback, time can jump forward an arbitrary amount.
@@ -656,13 +1055,6 @@ void SensorManager::SensorContainer::RunLoop()
         << "This warning can be ignored during log playback" << std::endl;
     }
 
-    // Make sure eventTime is not negative.
-    if (eventTime < common::Time::Zero)
-    {
-      gzerr << "Time to next sensor update is negative." << std::endl;
-      continue;
-    }
-
     boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
 
     // Add an event to trigger when the appropriate simulation time has been
@@ -688,15 +1080,109 @@ void SensorManager::SensorContainer::Update(bool _force)
   if (this->sensors.empty())
     gzlog << "Updating a sensor container without any sensors.\n";
 
-  // Update all the sensors in this container.
-  for (Sensor_V::iterator iter = this->sensors.begin();
-       iter != this->sensors.end(); ++iter)
+  this->UpdateSensors(this->sensors, _force);
+}
+
+//////////////////////////////////////////////////
+common::Time SensorManager::SensorContainer::UpdateDue(
+    const common::Time &_simTime)
+{
+  typedef SensorContainerPrivate::DueSensor DueSensor;
+  SensorContainerPrivate *data = this->ContainerData();
+
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  // Schedule all the sensors again when they changed, or when time went
+  // back after a world reset
+  if (data->scheduleDirty || _simTime < data->scheduleTime)
+  {
+    data->schedule = decltype(data->schedule)();
+    for (auto &sensor : this->sensors)
+    {
+      GZ_ASSERT(sensor != nullptr, "Sensor is null");
+      data->schedule.push(DueSensor(sensor->NextUpdateTime(), sensor));
+    }
+    data->scheduleDirty = false;
+  }
+  data->scheduleTime = _simTime;
+
+  // Take the sensors that are due
+  data->dueEntries.clear();
+  data->dueSensors.clear();
+  while (!data->schedule.empty() && data->schedule.top().first <= _simTime)
+  {
+    data->dueEntries.push_back(data->schedule.top());
+    data->dueSensors.push_back(data->schedule.top().second);
+    data->schedule.pop();
+  }
+
+  this->UpdateSensors(data->dueSensors, false);
+
+  // Schedule the next update of each sensor
+  for (auto &due : data->dueEntries)
+  {
+    SensorPtr &sensor = due.second;
+    sensor->SetScheduleSlip(_simTime - due.first);
+
+    // Sensors that didn't update, such as inactive sensors, are checked
+    // again one period later. Sensors without an update rate are due at
+    // every world update.
+    common::Time next = sensor->NextUpdateTime();
+    if (next <= _simTime && sensor->UpdateRate() > 0)
+      next = _simTime + common::Time(1.0 / sensor->UpdateRate());
+
+    data->schedule.push(DueSensor(next, sensor));
+  }
+
+  if (data->schedule.empty())
+    return _simTime;
+
+  return data->schedule.top().first;
+}
+
+//////////////////////////////////////////////////
+void SensorManager::SensorContainer::UpdateSensors(const Sensor_V &_sensors,
+    const bool _force)
+{
+  // Update all the sensors. Sensors that do not touch the physics engine
+  // are deferred and updated together below.
+  Sensor_V &concurrentSensors = this->ContainerData()->concurrentSensors;
+  concurrentSensors.clear();
+  for (Sensor_V::const_iterator iter = _sensors.begin();
+       iter != _sensors.end(); ++iter)
   {
     GZ_ASSERT((*iter) != nullptr, "Sensor is null");
+    if ((*iter)->ConcurrentUpdate())
+    {
+      concurrentSensors.push_back(*iter);
+      continue;
+    }
+
     IGN_PROFILE_BEGIN((*iter)->Name().c_str());
     (*iter)->Update(_force);
     IGN_PROFILE_END();
   }
+
+  const std::unique_ptr<SensorWorkerPool> &workers =
+    this->ContainerData()->workers;
+  if (workers)
+  {
+    workers->Update(concurrentSensors, _force);
+  }
+  else if (concurrentSensors.size() == 1)
+  {
+    concurrentSensors[0]->Update(_force);
+  }
+  else if (!concurrentSensors.empty())
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0,
+        concurrentSensors.size(), 1),
+        [&](const tbb::blocked_range<size_t> &_r)
+        {
+          for (size_t i = _r.begin(); i != _r.end(); ++i)
+            concurrentSensors[i]->Update(_force);
+        });
+  }
 }
 
 //////////////////////////////////////////////////
@@ -734,7 +1220,7 @@ void SensorManager::SensorContainer::AddSensor(SensorPtr _sensor)
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
     this->sensors.push_back(_sensor);
-    g_sensorsDirty = true;
+    this->ContainerData()->scheduleDirty = true;
   }
 
   // Tell the run loop that we have received a sensor
@@ -744,6 +1230,7 @@ void SensorManager::SensorContainer::AddSensor(SensorPtr _sensor)
 //////////////////////////////////////////////////
 bool SensorManager::SensorContainer::RemoveSensor(const std::string &_name)
 {
+  SensorContainerPrivate *data = this->ContainerData();
   boost::recursive_mutex::scoped_lock lock(this->mutex);
 
   Sensor_V::iterator iter;
@@ -757,6 +1244,8 @@ bool SensorManager::SensorContainer::RemoveSensor(const std::string &_name)
 
     if ((*iter)->ScopedName() == _name)
     {
+      if (data->workers)
+        data->workers->Remove((*iter)->Id());
       (*iter)->Fini();
       this->sensors.erase(iter);
       removed = true;
@@ -764,7 +1253,7 @@ bool SensorManager::SensorContainer::RemoveSensor(const std::string &_name)
     }
   }
 
-  g_sensorsDirty = true;
+  data->scheduleDirty = true;
 
   return removed;
 }
@@ -782,6 +1271,7 @@ void SensorManager::SensorContainer::ResetLastUpdateTimes()
     GZ_ASSERT((*iter) != nullptr, "Sensor is null");
     (*iter)->ResetLastUpdateTime();
   }
+  this->ContainerData()->scheduleDirty = true;
 
   // Tell the run loop that world time has been reset.
   this->runCondition.notify_one();
@@ -790,6 +1280,7 @@ void SensorManager::SensorContainer::ResetLastUpdateTimes()
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::RemoveSensors()
 {
+  SensorContainerPrivate *data = this->ContainerData();
   boost::recursive_mutex::scoped_lock lock(this->mutex);
 
   Sensor_V::iterator iter;
@@ -798,10 +1289,12 @@ void SensorManager::SensorContainer::RemoveSensors()
   for (iter = this->sensors.begin(); iter != this->sensors.end(); ++iter)
   {
     GZ_ASSERT((*iter) != nullptr, "Sensor is null");
+    if (data->workers)
+      data->workers->Remove((*iter)->Id());
     (*iter)->Fini();
   }
 
-  g_sensorsDirty = true;
+  data->scheduleDirty = true;
 
   this->sensors.clear();
 }
@@ -809,6 +1302,23 @@ void SensorManager::SensorContainer::RemoveSensors()
 //////////////////////////////////////////////////
 void SensorManager::ImageSensorContainer::Update(bool _force)
 {
+  // When rendering is batched, the sensors due in a window of simulation
+  // time are rendered together once the next window is reached, and the
+  // render cycles in between are skipped.
+  const double window = sensors::get_render_batch_window();
+  if (window > 0 && !_force && !rendering::lockstep_enabled())
+  {
+    physics::WorldPtr world = physics::get_world();
+    if (!world)
+      return;
+
+    SensorContainerPrivate *data = this->ContainerData();
+    const double batch = std::floor(world->SimTime().Double() / window);
+    if (ignition::math::equal(batch, data->renderBatch))
+      return;
+    data->renderBatch = batch;
+  }
+
   // Prerender phase
   event::Events::preRender();
 
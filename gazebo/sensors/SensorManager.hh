@@ -28,6 +28,7 @@
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/common/SingletonT.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/sensors/Sensor.hh"
@@ -42,6 +43,9 @@ namespace gazebo
   /// \brief Sensors namespace
   namespace sensors
   {
+    // Forward declare private data class
+    class SensorManagerPrivate;
+
     /// \cond
     /// \brief A simulation time event
     class GZ_SENSORS_VISIBLE SimTimeEvent
@@ -179,6 +183,18 @@ namespace gazebo
       /// \brief Reset last update times in all sensors.
       public: void ResetLastUpdateTimes();
 
+      /// \brief Get the number of active sensors, which are updated when
+      /// they are due.
+      /// \return Number of active sensors.
+      /// \sa Sensor::IsActive
+      public: unsigned int ActiveSensorCount() const;
+
+      /// \brief Get the number of idle sensors, which skip their updates,
+      /// such as on demand sensors that nobody consumes data from.
+      /// \return Number of idle sensors.
+      /// \sa Sensor::SetOnDemand
+      public: unsigned int IdleSensorCount() const;
+
       /// \brief Block until all sensors do not need current world tick
       /// \param[in] _clk simulated clock of the world
       /// \param[in] _dt world time step
@@ -193,6 +209,12 @@ namespace gazebo
       /// \param[in] _sensor Pointer to a sensor to add.
       private: void AddSensor(SensorPtr _sensor);
 
+      /// \brief Private data of a SensorContainer.
+      private: class SensorContainerPrivate;
+
+      /// \brief Private data of the sensor containers, by container.
+      private: class SensorContainerPrivates;
+
       /// \cond
       /// \brief A container for sensors of a specific type. This is used to
       /// separate sensors which rely on the rendering engine from those
@@ -204,6 +226,12 @@ namespace gazebo
                  /// \brief Constructor
                  public: SensorContainer();
 
+                 /// \brief Constructor
+                 /// \param[in] _useWorkers True to update the sensors that
+                 /// support concurrent updates on a pool of
+                 /// get_worker_thread_count() threads, created by Run.
+                 public: explicit SensorContainer(const bool _useWorkers);
+
                  /// \brief Destructor
                  public: virtual ~SensorContainer();
 
@@ -255,6 +283,29 @@ namespace gazebo
                  /// runThread.
                  private: void RunLoop();
 
+                 /// \brief Update the sensors that are due, and schedule
+                 /// their next update. Used by the runThread.
+                 /// \param[in] _simTime Current simulation time.
+                 /// \return Simulation time at which the next sensor is
+                 /// due.
+                 private: common::Time UpdateDue(
+                              const common::Time &_simTime);
+
+                 /// \brief Update a set of sensors, the ones that don't use
+                 /// the physics engine in parallel.
+                 /// \param[in] _sensors The sensors.
+                 /// \param[in] _force True to force the sensors to update,
+                 /// even if they are not active.
+                 private: void UpdateSensors(const Sensor_V &_sensors,
+                                             const bool _force);
+
+                 /// \internal
+                 /// \brief Get the private data of this container. It is
+                 /// kept out of the class so that its layout doesn't
+                 /// change.
+                 /// \return The private data.
+                 protected: SensorContainerPrivate *ContainerData() const;
+
                  /// \brief The set of sensors to maintain.
                  public: Sensor_V sensors;
 
@@ -340,6 +391,16 @@ namespace gazebo
 
       /// \brief Connect to the remove sensor event.
       private: event::ConnectionPtr removeSensorConnection;
+
+      /// \brief Publish the update statistics of all the sensors on
+      /// ~/sensors/stats, once per STATS_PERIOD of wall time.
+      private: void PublishStats();
+
+      /// \internal
+      /// \brief Get the private data of the sensor manager. It is kept
+      /// out of the class so that its layout doesn't change.
+      /// \return The private data.
+      private: SensorManagerPrivate *SensorManagerData() const;
     };
     /// \}
   }
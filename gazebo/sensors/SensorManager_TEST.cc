@@ -16,15 +16,36 @@
 */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "gazebo/physics/PhysicsIface.hh"
+#include "gazebo/sensors/SensorsIface.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/test/ServerFixture.hh"
+#include "gazebo/util/IntrospectionManager.hh"
 
 using namespace gazebo;
 class SensorManager_TEST : public ServerFixture
 {
 };
 
+/// \brief Mutex protecting g_sensorStats.
+static std::mutex g_sensorStatsMutex;
+
+/// \brief Last sensor statistics received.
+static msgs::SensorStats g_sensorStats;
+
+/////////////////////////////////////////////////
+/// \brief Callback for the sensor statistics.
+/// \param[in] _msg Sensor statistics message.
+void OnSensorStats(ConstSensorStatsPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_sensorStatsMutex);
+  g_sensorStats.CopyFrom(*_msg);
+}
+
 /////////////////////////////////////////////////
 /// \brief Test SensorManager initialization
 TEST_F(SensorManager_TEST, InitEmpty)
@@ -96,6 +117,248 @@ TEST_F(SensorManager_TEST, Data)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that sensors of the same thread are updated at their own
+/// rate.
+TEST_F(SensorManager_TEST, Schedule)
+{
+  Load("worlds/empty.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnImuSensor("fast_model", "fast_imu");
+  SpawnImuSensor("slow_model", "slow_imu", ignition::math::Vector3d(1, 0, 0));
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr fast = mgr->GetSensor("fast_imu");
+  sensors::SensorPtr slow = mgr->GetSensor("slow_imu");
+  ASSERT_TRUE(fast != nullptr);
+  ASSERT_TRUE(slow != nullptr);
+
+  fast->SetUpdateRate(1000);
+  slow->SetUpdateRate(2);
+
+  // Let two seconds of simulation time go by
+  common::Time start = world->SimTime();
+  for (int i = 0; i < 200 && world->SimTime() - start < 2.0; ++i)
+    common::Time::MSleep(100);
+  ASSERT_GE((world->SimTime() - start).Double(), 2.0);
+
+  // The slow sensor is updated at its rate, and is next due one period
+  // after its last update
+  EXPECT_GT(slow->LastUpdateTime(), start);
+  EXPECT_LE((slow->NextUpdateTime() - slow->LastUpdateTime()).Double(),
+      0.5 + 1e-6);
+  EXPECT_LT(slow->ScheduleSlip().Double(), 0.5);
+
+  // The fast sensor kept up too
+  EXPECT_GE(fast->LastUpdateTime(), slow->LastUpdateTime());
+  EXPECT_LE((fast->NextUpdateTime() - fast->LastUpdateTime()).Double(),
+      0.001 + 1e-6);
+}
+
+/////////////////////////////////////////////////
+/// \brief Test that sensors are updated on a pool of worker threads.
+TEST_F(SensorManager_TEST, WorkerThreads)
+{
+  sensors::set_worker_thread_count(4);
+  EXPECT_EQ(sensors::get_worker_thread_count(), 4u);
+
+  Load("worlds/empty.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  std::vector<sensors::SensorPtr> imus;
+  for (int i = 0; i < 8; ++i)
+  {
+    std::string name = "imu_" + std::to_string(i);
+    SpawnImuSensor("model_" + std::to_string(i), name,
+        ignition::math::Vector3d(i, 0, 0));
+    imus.push_back(mgr->GetSensor(name));
+    ASSERT_TRUE(imus.back() != nullptr);
+    EXPECT_TRUE(imus.back()->ConcurrentUpdate());
+    imus.back()->SetUpdateRate(100);
+  }
+
+  common::Time start = world->SimTime();
+  for (int i = 0; i < 200 && world->SimTime() - start < 1.0; ++i)
+    common::Time::MSleep(100);
+  ASSERT_GE((world->SimTime() - start).Double(), 1.0);
+
+  for (auto &imu : imus)
+    EXPECT_GT(imu->LastUpdateTime(), start);
+
+  sensors::set_worker_thread_count(0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Callback for IMU messages, which are dropped.
+void OnImu(ConstIMUPtr &/*_msg*/)
+{
+}
+
+/////////////////////////////////////////////////
+/// \brief Test that on demand sensors are only updated while their data
+/// is consumed.
+TEST_F(SensorManager_TEST, OnDemand)
+{
+  Load("worlds/empty.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnImuSensor("imu_model", "imu");
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr imu = mgr->GetSensor("imu");
+  ASSERT_TRUE(imu != nullptr);
+  EXPECT_FALSE(imu->OnDemand());
+  EXPECT_TRUE(imu->IsActive());
+  const unsigned int active = mgr->ActiveSensorCount();
+  const unsigned int idle = mgr->IdleSensorCount();
+
+  // Without subscribers or callbacks the sensor is idle
+  imu->SetOnDemand(true);
+  EXPECT_TRUE(imu->OnDemand());
+  EXPECT_FALSE(imu->IsActive());
+  EXPECT_EQ(mgr->ActiveSensorCount(), active - 1);
+  EXPECT_EQ(mgr->IdleSensorCount(), idle + 1);
+
+  common::Time::MSleep(500);
+  common::Time lastUpdate = imu->LastUpdateTime();
+  common::Time start = world->SimTime();
+  for (int i = 0; i < 100 && world->SimTime() - start < 0.5; ++i)
+    common::Time::MSleep(100);
+  EXPECT_EQ(imu->LastUpdateTime(), lastUpdate);
+
+  // A callback wakes the sensor up
+  std::atomic<int> updates(0);
+  event::ConnectionPtr connection = imu->ConnectUpdated(
+      [&updates]() { ++updates; });
+  EXPECT_TRUE(imu->IsActive());
+  EXPECT_EQ(mgr->ActiveSensorCount(), active);
+
+  start = world->SimTime();
+  for (int i = 0; i < 100 && world->SimTime() - start < 0.5; ++i)
+    common::Time::MSleep(100);
+  EXPECT_GT(imu->LastUpdateTime(), lastUpdate);
+  EXPECT_GT(updates, 0);
+
+  // And so does a subscriber
+  connection.reset();
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  transport::SubscriberPtr sub = node->Subscribe(imu->Topic(), &OnImu);
+  for (int i = 0; i < 50 && !imu->IsActive(); ++i)
+    common::Time::MSleep(100);
+  EXPECT_TRUE(imu->IsActive());
+
+  imu->SetOnDemand(false);
+}
+
+/////////////////////////////////////////////////
+/// \brief Test that image sensors due in the same window of simulation
+/// time are rendered together.
+TEST_F(SensorManager_TEST, RenderBatch)
+{
+  sensors::set_render_batch_window(0.5);
+  EXPECT_DOUBLE_EQ(sensors::get_render_batch_window(), 0.5);
+
+  Load("worlds/empty.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnCamera("camera_model_1", "camera_1",
+      ignition::math::Vector3d(0, 0, 1), ignition::math::Vector3d::Zero,
+      320, 240, 10);
+  SpawnCamera("camera_model_2", "camera_2",
+      ignition::math::Vector3d(1, 0, 1), ignition::math::Vector3d::Zero,
+      320, 240, 10);
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr camera1 = mgr->GetSensor("camera_1");
+  sensors::SensorPtr camera2 = mgr->GetSensor("camera_2");
+  ASSERT_TRUE(camera1 != nullptr);
+  ASSERT_TRUE(camera2 != nullptr);
+
+  std::atomic<int> updates(0);
+  event::ConnectionPtr connection = camera1->ConnectUpdated(
+      [&updates]() { ++updates; });
+
+  common::Time start = world->SimTime();
+  for (int i = 0; i < 200 && world->SimTime() - start < 2.0; ++i)
+    common::Time::MSleep(100);
+  ASSERT_GE((world->SimTime() - start).Double(), 2.0);
+
+  // Let the last render cycle finish
+  world->SetPaused(true);
+  common::Time::MSleep(200);
+
+  // The cameras are due in every window, so they are rendered once per
+  // window, in the same render cycle
+  EXPECT_GT(updates, 0);
+  EXPECT_LE(updates, 6);
+  EXPECT_EQ(camera1->LastMeasurementTime(), camera2->LastMeasurementTime());
+
+  connection.reset();
+  world->SetPaused(false);
+  sensors::set_render_batch_window(0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Test the update statistics of sensors
+TEST_F(SensorManager_TEST, Stats)
+{
+  Load("worlds/empty.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  double rate = 10;
+  SpawnCamera("camera_model", "camera",
+      ignition::math::Vector3d(0, 0, 1), ignition::math::Vector3d::Zero,
+      320, 240, rate);
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr camera = mgr->GetSensor("camera");
+  ASSERT_TRUE(camera != nullptr);
+
+  transport::SubscriberPtr sub =
+    this->node->Subscribe("~/sensors/stats", &OnSensorStats);
+
+  common::Time start = world->SimTime();
+  for (int i = 0; i < 200 && world->SimTime() - start < 3.0; ++i)
+    common::Time::MSleep(100);
+  ASSERT_GE((world->SimTime() - start).Double(), 3.0);
+
+  EXPECT_GT(camera->UpdateCount(), 0u);
+  EXPECT_GT(camera->StageTime(sensors::STAGE_UPDATE), 0.0);
+  EXPECT_GT(camera->StageTime(sensors::STAGE_RENDER), 0.0);
+  EXPECT_GT(camera->StageTime(sensors::STAGE_READBACK), 0.0);
+  EXPECT_GT(camera->AchievedUpdateRate(), 0.0);
+  EXPECT_LE(camera->AchievedUpdateRate(), rate * 1.5);
+
+  // The statistics are published about once a second
+  {
+    std::lock_guard<std::mutex> lock(g_sensorStatsMutex);
+    ASSERT_GT(g_sensorStats.sensor_size(), 0);
+    const msgs::SensorStats::Sensor &stats = g_sensorStats.sensor(0);
+    EXPECT_EQ(stats.name(), camera->ScopedName());
+    EXPECT_EQ(stats.type(), "camera");
+    EXPECT_DOUBLE_EQ(stats.update_rate(), rate);
+    EXPECT_GT(stats.update_count(), 0u);
+    EXPECT_GT(stats.render_time(), 0.0);
+  }
+
+  // The statistics are also available through introspection
+  bool found = false;
+  for (auto const &item : util::IntrospectionManager::Instance()->Items())
+  {
+    if (item.find("/sensor/camera?p=double/render_time") != std::string::npos)
+      found = true;
+  }
+  EXPECT_TRUE(found);
+}
+
 /////////////////////////////////////////////////
 /// \brief Test SensorManager init and removal of sensors
 TEST_F(SensorManager_TEST, InitRemove)
@@ -17,12 +17,16 @@
 #ifndef GAZEBO_SENSORS_SENSOR_PRIVATE_HH_
 #define GAZEBO_SENSORS_SENSOR_PRIVATE_HH_
 
+#include <functional>
 #include <mutex>
+#include <string>
+#include <vector>
 #include <sdf/sdf.hh>
 
 #include "gazebo/rendering/RenderTypes.hh"
 
 #include "gazebo/common/Event.hh"
+#include "gazebo/common/MemoryAccounting.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -48,9 +52,45 @@ namespace gazebo
       /// \brief Keep track how much the update has been delayed.
       public: common::Time updateDelay;
 
+      /// \brief How late the last scheduled update was, protected by
+      /// mutexLastUpdateTime.
+      public: common::Time scheduleSlip;
+
+      /// \brief Mutex to protect the update statistics.
+      public: std::mutex mutexStats;
+
+      /// \brief Average wall time of each stage of an update, in seconds.
+      public: double stageTimes[STAGE_COUNT] = {};
+
+      /// \brief Average simulation time between updates, in seconds.
+      public: double updateInterval = 0;
+
+      /// \brief Simulation time of the previous update, for updateInterval.
+      public: common::Time prevUpdateTime;
+
+      /// \brief Number of updates of the sensor.
+      public: uint64_t updateCount = 0;
+
+      /// \brief Number of update periods the sensor missed.
+      public: uint64_t missedCount = 0;
+
+      /// \brief Introspection items registered for the sensor.
+      public: std::vector<std::string> introspectionItems;
+
+      /// \brief True if the sensor is only updated on demand.
+      public: bool onDemand = false;
+
       /// \brief The sensors unique ID.
       public: uint32_t id;
 
+      /// \brief Memory of the data buffers, see Sensor::SetMemoryUsage.
+      public: common::MemoryAccounting::Account memory{
+                  common::MemoryAccounting::SENSORS};
+
+      /// \brief Check returned by Sensor::ConcurrentUpdate, empty if the
+      /// sensor always updates after the physics step.
+      public: std::function<bool ()> concurrentUpdate;
+
       /// \brief An SDF pointer that allows us to only read the sensor.sdf
       /// file once, which in turns limits disk reads.
       public: static sdf::ElementPtr sdfSensor;
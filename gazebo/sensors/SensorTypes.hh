@@ -322,6 +322,26 @@ namespace gazebo
       /// \brief Number of Sensor Categories
       CATEGORY_COUNT = 3
     };
+
+    /// \brief SensorStage identifies the timed stages of a sensor update.
+    /// \sa Sensor::StageTime
+    enum SensorStage
+    {
+      /// \brief The whole update of the sensor, Sensor::UpdateImpl.
+      STAGE_UPDATE = 0,
+
+      /// \brief Rendering of the sensor data.
+      STAGE_RENDER = 1,
+
+      /// \brief Reading the rendered sensor data back from the GPU.
+      STAGE_READBACK = 2,
+
+      /// \brief Publishing the sensor data.
+      STAGE_PUBLISH = 3,
+
+      /// \brief Number of sensor stages
+      STAGE_COUNT = 4
+    };
   }
 }
 #endif
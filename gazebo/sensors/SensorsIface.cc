@@ -15,6 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
 #include "gazebo/common/Console.hh"
 
 #include "gazebo/transport/TransportIface.hh"
@@ -29,6 +33,10 @@
 using namespace gazebo;
 
 bool g_disable = false;
+unsigned int g_workerThreadCount = 0;
+bool g_onDemand = false;
+double g_renderBatchWindow = 0;
+bool g_sonarRayFan = false;
 
 /////////////////////////////////////////////////
 bool sensors::load()
@@ -158,3 +166,82 @@ bool sensors::running()
   return sensors::SensorManager::Instance()->Running();
 }
 
+/////////////////////////////////////////////////
+void sensors::set_worker_thread_count(const unsigned int _count)
+{
+  g_workerThreadCount = _count;
+}
+
+/////////////////////////////////////////////////
+unsigned int sensors::get_worker_thread_count()
+{
+  if (g_workerThreadCount > 0)
+    return g_workerThreadCount;
+
+  const char *env = getenv("GAZEBO_SENSOR_THREADS");
+  if (env)
+  {
+    const int count = atoi(env);
+    if (count > 0)
+      return count;
+    gzerr << "Invalid GAZEBO_SENSOR_THREADS value [" << env
+          << "], using 1 sensor worker thread\n";
+  }
+  return 1;
+}
+
+/////////////////////////////////////////////////
+void sensors::set_on_demand_enabled(const bool _enable)
+{
+  g_onDemand = _enable;
+}
+
+/////////////////////////////////////////////////
+bool sensors::on_demand_enabled()
+{
+  if (g_onDemand)
+    return true;
+
+  const char *env = getenv("GAZEBO_SENSORS_ON_DEMAND");
+  return env && std::string(env) == "1";
+}
+
+/////////////////////////////////////////////////
+void sensors::set_render_batch_window(const double _window)
+{
+  g_renderBatchWindow = std::max(0.0, _window);
+}
+
+/////////////////////////////////////////////////
+double sensors::get_render_batch_window()
+{
+  if (g_renderBatchWindow > 0)
+    return g_renderBatchWindow;
+
+  const char *env = getenv("GAZEBO_RENDER_BATCH_WINDOW");
+  if (env)
+  {
+    const double window = atof(env);
+    if (window >= 0)
+      return window;
+    gzerr << "Invalid GAZEBO_RENDER_BATCH_WINDOW value [" << env
+          << "], rendering image sensors as soon as they are due\n";
+  }
+  return 0;
+}
+
+/////////////////////////////////////////////////
+void sensors::set_sonar_ray_fan_enabled(const bool _enable)
+{
+  g_sonarRayFan = _enable;
+}
+
+/////////////////////////////////////////////////
+bool sensors::sonar_ray_fan_enabled()
+{
+  if (g_sonarRayFan)
+    return true;
+
+  const char *env = getenv("GAZEBO_SONAR_RAY_FAN");
+  return env && std::string(env) == "1";
+}
@@ -104,6 +104,70 @@ namespace gazebo
     /// \return True if manager is running.
     GAZEBO_VISIBLE
     bool running();
+
+    /// \brief Set the number of threads that update the sensors of the
+    /// sensors::OTHER category that support concurrent updates. Must be
+    /// called before run_threads to take effect.
+    /// \param[in] _count Number of threads, 0 to use the
+    /// GAZEBO_SENSOR_THREADS environment variable, or 1 if it isn't set.
+    /// With 1 thread the sensors are updated one after the other.
+    GZ_SENSORS_VISIBLE
+    void set_worker_thread_count(const unsigned int _count);
+
+    /// \brief Get the number of threads that update the sensors of the
+    /// sensors::OTHER category that support concurrent updates.
+    /// \return Number of threads, at least 1.
+    GZ_SENSORS_VISIBLE
+    unsigned int get_worker_thread_count();
+
+    /// \brief Set whether sensors are only updated on demand, when a
+    /// callback is connected to them or their topic has subscribers. Must
+    /// be called before the sensors are loaded to take effect.
+    /// \param[in] _enable True to update the sensors on demand.
+    /// \sa Sensor::SetOnDemand
+    GZ_SENSORS_VISIBLE
+    void set_on_demand_enabled(const bool _enable);
+
+    /// \brief Get whether sensors are only updated on demand.
+    /// \return True if set_on_demand_enabled was called with true, or if the
+    /// GAZEBO_SENSORS_ON_DEMAND environment variable is set to 1.
+    GZ_SENSORS_VISIBLE
+    bool on_demand_enabled();
+
+    /// \brief Set the window of simulation time in which the image sensors
+    /// that are due are rendered together. The rendering of a window is
+    /// done once, when simulation time reaches the next window, so that
+    /// many cameras share a scene update and a render cycle instead of
+    /// each triggering their own. A sensor is late by less than the
+    /// window, which its update rate compensates for. Batching is not used
+    /// with lockstep, where each sensor renders at its exact time.
+    /// \param[in] _window Window duration in seconds, 0 to use the
+    /// GAZEBO_RENDER_BATCH_WINDOW environment variable, or to render the
+    /// sensors as soon as they are due if it isn't set.
+    GZ_SENSORS_VISIBLE
+    void set_render_batch_window(const double _window);
+
+    /// \brief Get the window of simulation time in which the image sensors
+    /// that are due are rendered together.
+    /// \return Window duration in seconds, 0 if rendering isn't batched.
+    /// \sa set_render_batch_window
+    GZ_SENSORS_VISIBLE
+    double get_render_batch_window();
+
+    /// \brief Set whether sonar sensors sense with a fan of rays cast at
+    /// their update rate, instead of a cone or sphere collision that
+    /// collides with the world at every physics step. Must be called
+    /// before the sonar sensors are loaded to take effect.
+    /// \param[in] _enable True to use ray fans.
+    /// \sa SonarSensor
+    GZ_SENSORS_VISIBLE
+    void set_sonar_ray_fan_enabled(const bool _enable);
+
+    /// \brief Get whether sonar sensors sense with a fan of rays.
+    /// \return True if set_sonar_ray_fan_enabled was called with true, or if
+    /// the GAZEBO_SONAR_RAY_FAN environment variable is set to 1.
+    GZ_SENSORS_VISIBLE
+    bool sonar_ray_fan_enabled();
     /// \}
   }
 }
@@ -14,9 +14,12 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+#include <memory>
+#include <string>
 #include <boost/algorithm/string.hpp>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/physics/World.hh"
@@ -25,6 +28,8 @@
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/RayQuery.hh"
+#include "gazebo/physics/RayShape.hh"
 
 #include "gazebo/common/Assert.hh"
 
@@ -34,12 +39,22 @@
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/SonarSensorPrivate.hh"
 #include "gazebo/sensors/SonarSensor.hh"
+#include "gazebo/sensors/SensorsIface.hh"
 
 using namespace gazebo;
 using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("sonar", SonarSensor)
 
+/// \brief Number of rings of rays around the axis of a sonar cone.
+static const unsigned int g_sonarConeRings = 2;
+
+/// \brief Number of rays on each ring of a sonar cone.
+static const unsigned int g_sonarConeSegments = 8;
+
+/// \brief Number of rays of a sonar sphere.
+static const unsigned int g_sonarSphereRays = 64;
+
 //////////////////////////////////////////////////
 SonarSensor::SonarSensor()
 : Sensor(sensors::OTHER),
@@ -51,11 +66,17 @@ SonarSensor::SonarSensor()
 //////////////////////////////////////////////////
 SonarSensor::~SonarSensor()
 {
-  this->dataPtr->sonarCollision->Fini();
-  this->dataPtr->sonarCollision.reset();
+  if (this->dataPtr->sonarCollision)
+  {
+    this->dataPtr->sonarCollision->Fini();
+    this->dataPtr->sonarCollision.reset();
+  }
 
-  this->dataPtr->sonarShape->Fini();
-  this->dataPtr->sonarShape.reset();
+  if (this->dataPtr->sonarShape)
+  {
+    this->dataPtr->sonarShape->Fini();
+    this->dataPtr->sonarShape.reset();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -83,7 +104,6 @@ void SonarSensor::Load(const std::string &_worldName)
   this->dataPtr->radius = sonarElem->Get<double>("radius");
   const std::string geometry =
       sonarElem->GetElement("geometry")->Get<std::string>();
-  double range = this->dataPtr->rangeMax - this->dataPtr->rangeMin;
 
   if (this->dataPtr->radius < 0 && geometry == "cone")
   {
@@ -117,11 +137,40 @@ void SonarSensor::Load(const std::string &_worldName)
   GZ_ASSERT(this->dataPtr->parentEntity != nullptr,
       "Unable to get the parent entity.");
 
-  physics::PhysicsEnginePtr physicsEngine = this->world->Physics();
-
-  GZ_ASSERT(physicsEngine != nullptr,
+  GZ_ASSERT(this->world->Physics() != nullptr,
       "Unable to get a pointer to the physics engine");
 
+  if (sensors::sonar_ray_fan_enabled())
+    this->CreateRayFan(geometry);
+  else
+    this->CreateCollision(geometry);
+
+  // Advertise the sensor's topic on which we will output range data.
+  this->dataPtr->sonarPub = this->node->Advertise<msgs::SonarStamped>(
+      this->Topic());
+
+  // Initialize the message that will be published on this->dataPtr->sonarPub.
+  this->dataPtr->sonarMsg.mutable_sonar()->set_geometry(geometry);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range_min(
+      this->dataPtr->rangeMin);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range_max(
+      this->dataPtr->rangeMax);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_radius(
+      this->dataPtr->radius);
+
+  ignition::math::Pose3d referencePose =
+    this->pose + this->dataPtr->parentEntity->WorldPose();
+  msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
+      referencePose);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range(0);
+}
+
+//////////////////////////////////////////////////
+void SonarSensor::CreateCollision(const std::string &_geometry)
+{
+  physics::PhysicsEnginePtr physicsEngine = this->world->Physics();
+  double range = this->dataPtr->rangeMax - this->dataPtr->rangeMin;
+
   /// \todo: Change the collision shape to a cone. Needs a collision shape
   /// within ODE. Or, switch out the collision engine.
   this->dataPtr->sonarCollision = physicsEngine->CreateCollision("mesh",
@@ -145,7 +194,7 @@ void SonarSensor::Load(const std::string &_worldName)
   GZ_ASSERT(this->dataPtr->sonarShape != nullptr,
       "Unable to get the sonar shape from the sonar collision.");
 
-  if (geometry == "sphere")
+  if (_geometry == "sphere")
   {
     // Use a scaled sphere mesh for the sonar collision shape.
     this->dataPtr->sonarShape->SetMesh("unit_sphere");
@@ -157,9 +206,9 @@ void SonarSensor::Load(const std::string &_worldName)
   }
   else
   {
-    if (geometry != "cone")
+    if (_geometry != "cone")
     {
-      gzerr << "Invalid sonar collision shape [" << geometry
+      gzerr << "Invalid sonar collision shape [" << _geometry
             << "]. Defaults to cone." << std::endl;
     }
 
@@ -201,25 +250,60 @@ void SonarSensor::Load(const std::string &_worldName)
   // Subscribe to the contact topic
   this->dataPtr->contactSub = this->node->Subscribe(topic,
       &SonarSensor::OnContacts, this);
+}
 
-  // Advertise the sensor's topic on which we will output range data.
-  this->dataPtr->sonarPub = this->node->Advertise<msgs::SonarStamped>(
-      this->Topic());
+//////////////////////////////////////////////////
+void SonarSensor::CreateRayFan(const std::string &_geometry)
+{
+  this->dataPtr->rayFan = true;
+  this->dataPtr->rayDirections.clear();
 
-  // Initialize the message that will be published on this->dataPtr->sonarPub.
-  this->dataPtr->sonarMsg.mutable_sonar()->set_geometry(geometry);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_range_min(
-      this->dataPtr->rangeMin);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_range_max(
-      this->dataPtr->rangeMax);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_radius(
-      this->dataPtr->radius);
+  if (_geometry == "sphere")
+  {
+    // Spread the rays evenly over the sphere along a Fibonacci spiral
+    const double goldenAngle = IGN_PI * (3.0 - std::sqrt(5.0));
+    for (unsigned int i = 0; i < g_sonarSphereRays; ++i)
+    {
+      const double z = 1.0 - (2.0 * i + 1.0) / g_sonarSphereRays;
+      const double r = std::sqrt(1.0 - z * z);
+      const double angle = goldenAngle * i;
+      this->dataPtr->rayDirections.push_back(ignition::math::Vector3d(
+          r * std::cos(angle), r * std::sin(angle), z));
+    }
+  }
+  else
+  {
+    if (_geometry != "cone")
+    {
+      gzerr << "Invalid sonar collision shape [" << _geometry
+            << "]. Defaults to cone." << std::endl;
+    }
 
-  ignition::math::Pose3d referencePose =
-    this->pose + this->dataPtr->parentEntity->WorldPose();
-  msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
-      referencePose);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_range(0);
+    // The cone has its apex at the sensor and opens along -Z, like the
+    // collision mesh. Rays go along the axis and on rings up to the edge.
+    const double range = this->dataPtr->rangeMax - this->dataPtr->rangeMin;
+    const double halfAngle = std::atan2(this->dataPtr->radius, range);
+    this->dataPtr->rayDirections.push_back(
+        ignition::math::Vector3d(0, 0, -1));
+    for (unsigned int ring = 1; ring <= g_sonarConeRings; ++ring)
+    {
+      const double polar = halfAngle * ring / g_sonarConeRings;
+      for (unsigned int i = 0; i < g_sonarConeSegments; ++i)
+      {
+        // Offset every other ring so that the rays interleave
+        const double azimuth = 2.0 * IGN_PI *
+            (i + 0.5 * (ring % 2)) / g_sonarConeSegments;
+        this->dataPtr->rayDirections.push_back(ignition::math::Vector3d(
+            std::sin(polar) * std::cos(azimuth),
+            std::sin(polar) * std::sin(azimuth),
+            -std::cos(polar)));
+      }
+    }
+  }
+
+  const size_t count = this->dataPtr->rayDirections.size();
+  this->dataPtr->rayStarts.resize(count);
+  this->dataPtr->rayEnds.resize(count);
 }
 
 //////////////////////////////////////////////////
@@ -237,7 +321,7 @@ void SonarSensor::Init()
 //////////////////////////////////////////////////
 void SonarSensor::Fini()
 {
-  if (this->world && this->world->Running())
+  if (this->world && this->world->Running() && this->dataPtr->sonarCollision)
   {
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
     mgr->RemoveFilter(this->dataPtr->sonarCollision->GetScopedName());
@@ -245,6 +329,7 @@ void SonarSensor::Fini()
 
   this->dataPtr->sonarPub.reset();
   this->dataPtr->contactSub.reset();
+  this->dataPtr->fallbackRay.reset();
   Sensor::Fini();
 }
 
@@ -296,61 +381,69 @@ bool SonarSensor::UpdateImpl(const bool /*_force*/)
   msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
       referencePose);
 
-  ignition::math::Vector3d pos;
-
-  // A 5-step hysteresis window was chosen to reduce range value from
-  // bouncing.
-  if (!this->dataPtr->incomingContacts.empty() ||
-      this->dataPtr->emptyContactCount > 5)
+  if (this->dataPtr->rayFan)
   {
-    this->dataPtr->sonarMsg.mutable_sonar()->set_range(
-        this->dataPtr->rangeMax);
-    this->dataPtr->emptyContactCount = 0;
+    this->UpdateRayFan(referencePose);
   }
   else
   {
-    ++this->dataPtr->emptyContactCount;
-  }
+    ignition::math::Vector3d pos;
 
-
-  // Iterate over all the contact messages
-  for (auto iter = this->dataPtr->incomingContacts.begin();
-      iter != this->dataPtr->incomingContacts.end(); ++iter)
-  {
-    // Iterate over all the contacts in the message
-    for (int i = 0; i < (*iter)->contact_size(); ++i)
+    // A 5-step hysteresis window was chosen to reduce range value from
+    // bouncing.
+    if (!this->dataPtr->incomingContacts.empty() ||
+        this->dataPtr->emptyContactCount > 5)
     {
-      // Debug output:
-      // std::cout << "C1[" << (*iter)->contact(i).collision1() << "]"
-      //   << "C2[" << (*iter)->contact(i).collision2() << "]\n";
-
-      for (int j = 0; j < (*iter)->contact(i).position_size(); ++j)
-      {
-        // Get the contact position relative to the reference position.
-        pos = msgs::ConvertIgn((*iter)->contact(i).position(j)) -
-          referencePose.Pos();
+      this->dataPtr->sonarMsg.mutable_sonar()->set_range(
+          this->dataPtr->rangeMax);
+      this->dataPtr->emptyContactCount = 0;
+    }
+    else
+    {
+      ++this->dataPtr->emptyContactCount;
+    }
 
-        // Compute the sensed range.
-        double len = pos.Length() - (*iter)->contact(i).depth(j);
 
+    // Iterate over all the contact messages
+    for (auto iter = this->dataPtr->incomingContacts.begin();
+        iter != this->dataPtr->incomingContacts.end(); ++iter)
+    {
+      // Iterate over all the contacts in the message
+      for (int i = 0; i < (*iter)->contact_size(); ++i)
+      {
         // Debug output:
-        // std::cout << "  RP[" << referencePose << "]  P[" << pos
-        //   << "] L[" << len << "] D["
-        //   << (*iter)->contact(i).depth(j) << "]\n";
+        // std::cout << "C1[" << (*iter)->contact(i).collision1() << "]"
+        //   << "C2[" << (*iter)->contact(i).collision2() << "]\n";
 
-        // Copy the contact message.
-        if (len < this->dataPtr->sonarMsg.sonar().range())
+        for (int j = 0; j < (*iter)->contact(i).position_size(); ++j)
         {
-          this->dataPtr->sonarMsg.mutable_sonar()->set_range(len);
-          msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
-              referencePose.Rot().RotateVectorReverse(pos));
+          // Get the contact position relative to the reference position.
+          pos = msgs::ConvertIgn((*iter)->contact(i).position(j)) -
+            referencePose.Pos();
+
+          // Compute the sensed range.
+          double len = pos.Length() - (*iter)->contact(i).depth(j);
+
+          // Debug output:
+          // std::cout << "  RP[" << referencePose << "]  P[" << pos
+          //   << "] L[" << len << "] D["
+          //   << (*iter)->contact(i).depth(j) << "]\n";
+
+          // Copy the contact message.
+          if (len < this->dataPtr->sonarMsg.sonar().range())
+          {
+            this->dataPtr->sonarMsg.mutable_sonar()->set_range(len);
+            msgs::Set(
+                this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
+                referencePose.Rot().RotateVectorReverse(pos));
+          }
         }
       }
     }
-  }
 
-  // Clear the incoming contact list.
-  this->dataPtr->incomingContacts.clear();
+    // Clear the incoming contact list.
+    this->dataPtr->incomingContacts.clear();
+  }
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("Publish");
@@ -363,6 +456,100 @@ bool SonarSensor::UpdateImpl(const bool /*_force*/)
   return true;
 }
 
+//////////////////////////////////////////////////
+void SonarSensor::UpdateRayFan(const ignition::math::Pose3d &_referencePose)
+{
+  for (size_t i = 0; i < this->dataPtr->rayDirections.size(); ++i)
+  {
+    const ignition::math::Vector3d dir =
+        _referencePose.Rot().RotateVector(this->dataPtr->rayDirections[i]);
+    this->dataPtr->rayStarts[i] =
+        _referencePose.Pos() + dir * this->dataPtr->rangeMin;
+    this->dataPtr->rayEnds[i] =
+        _referencePose.Pos() + dir * this->dataPtr->rangeMax;
+  }
+
+  bool cast = false;
+
+  // The snapshot is immutable, so no lock against physics is needed.
+  if (this->world->RayQuerySnapshotEnabled())
+  {
+    std::shared_ptr<const physics::RayQuery> snapshot =
+        this->world->RayQuerySnapshot();
+    if (snapshot)
+    {
+      snapshot->CastRays(this->dataPtr->rayStarts, this->dataPtr->rayEnds,
+          this->dataPtr->rayDistances, this->dataPtr->rayHits);
+      cast = true;
+    }
+  }
+
+  if (!cast)
+  {
+    // Acquire the mutex for avoiding race condition with the physics engine
+    boost::recursive_mutex::scoped_lock lock(
+        *this->world->Physics()->GetPhysicsUpdateMutex());
+
+    physics::RayQuery &query = this->world->SharedRayQuery();
+    if (query.Update(this->world->Models(), this->world->Iterations()))
+    {
+      query.CastRays(this->dataPtr->rayStarts, this->dataPtr->rayEnds,
+          this->dataPtr->rayDistances, this->dataPtr->rayHits);
+    }
+    else
+    {
+      if (!this->dataPtr->fallbackRay)
+      {
+        this->dataPtr->fallbackRay =
+            boost::dynamic_pointer_cast<physics::RayShape>(
+            this->world->Physics()->CreateShape("ray",
+            physics::CollisionPtr()));
+      }
+
+      const size_t count = this->dataPtr->rayStarts.size();
+      this->dataPtr->rayDistances.assign(count, ignition::math::MAX_D);
+      this->dataPtr->rayHits.assign(count, -1);
+
+      std::string entityName;
+      double dist;
+      for (size_t i = 0; i < count; ++i)
+      {
+        this->dataPtr->fallbackRay->SetPoints(this->dataPtr->rayStarts[i],
+            this->dataPtr->rayEnds[i]);
+        this->dataPtr->fallbackRay->GetIntersection(dist, entityName);
+        if (!entityName.empty())
+        {
+          this->dataPtr->rayDistances[i] = dist;
+          this->dataPtr->rayHits[i] = 0;
+        }
+      }
+    }
+  }
+
+  // The range is the closest hit of the fan
+  int closest = -1;
+  double range = this->dataPtr->rangeMax;
+  for (size_t i = 0; i < this->dataPtr->rayHits.size(); ++i)
+  {
+    if (this->dataPtr->rayHits[i] < 0)
+      continue;
+
+    const double len = this->dataPtr->rangeMin + this->dataPtr->rayDistances[i];
+    if (len < range)
+    {
+      range = len;
+      closest = static_cast<int>(i);
+    }
+  }
+
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range(range);
+  if (closest >= 0)
+  {
+    msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
+        this->dataPtr->rayDirections[closest] * range);
+  }
+}
+
 //////////////////////////////////////////////////
 bool SonarSensor::IsActive() const
 {
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <ignition/math/Pose3.hh>
 
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/util/system.hh"
@@ -38,7 +39,12 @@ namespace gazebo
     /// \class SonarSensor SonarSensor.hh sensors/sensors.hh
     /// \brief Sensor with sonar cone.
     ///
-    /// This sensor uses a cone .
+    /// By default, this sensor uses a cone or sphere collision that collides
+    /// without contact, and takes the range from the contacts of the
+    /// collision. When sensors::set_sonar_ray_fan_enabled is set, it casts a
+    /// fan of rays spanning the cone or sphere at its update rate instead,
+    /// through the ray query of the world, and adds nothing to the
+    /// collision space.
     class GZ_SENSORS_VISIBLE SonarSensor: public Sensor
     {
       /// \brief Constructor
@@ -101,6 +107,18 @@ namespace gazebo
       /// \brief Callback for contact messages from the physics engine.
       private: void OnContacts(ConstContactsPtr &_msg);
 
+      /// \brief Create the collision that senses contacts.
+      /// \param[in] _geometry Shape of the collision, cone or sphere.
+      private: void CreateCollision(const std::string &_geometry);
+
+      /// \brief Create the directions of the rays of the fan.
+      /// \param[in] _geometry Shape spanned by the rays, cone or sphere.
+      private: void CreateRayFan(const std::string &_geometry);
+
+      /// \brief Cast the rays of the fan and update the range.
+      /// \param[in] _referencePose World pose of the sensor.
+      private: void UpdateRayFan(const ignition::math::Pose3d &_referencePose);
+
       /// \internal
       /// \brief Internal data pointer
       private: std::unique_ptr<SonarSensorPrivate> dataPtr;
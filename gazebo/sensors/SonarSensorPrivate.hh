@@ -19,7 +19,9 @@
 
 #include <list>
 #include <mutex>
+#include <vector>
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -78,6 +80,30 @@ namespace gazebo
       /// \brief Counts the number of times there were no contacts. This is
       /// used to reduce the range value jumping.
       public: int emptyContactCount;
+
+      /// \brief True if the sonar senses with a fan of rays instead of a
+      /// collision. See sensors::set_sonar_ray_fan_enabled.
+      public: bool rayFan = false;
+
+      /// \brief Unit directions of the rays of the fan, in the sensor
+      /// frame.
+      public: std::vector<ignition::math::Vector3d> rayDirections;
+
+      /// \brief Start points of the rays, in the world frame, reused.
+      public: std::vector<ignition::math::Vector3d> rayStarts;
+
+      /// \brief End points of the rays, in the world frame, reused.
+      public: std::vector<ignition::math::Vector3d> rayEnds;
+
+      /// \brief Distance to the hit of each ray, reused.
+      public: std::vector<double> rayDistances;
+
+      /// \brief Index of the collision hit by each ray, reused.
+      public: std::vector<int> rayHits;
+
+      /// \brief Physics engine ray used when the world has shapes the ray
+      /// query doesn't support, created on first use.
+      public: physics::RayShapePtr fallbackRay;
     };
   }
 }
@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include "gazebo/sensors/SensorsIface.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/test/helper_physics_generator.hh"
 
@@ -39,6 +40,10 @@ class SonarSensor_TEST : public ServerFixture,
   /// \brief Test sonar with just a ground plane.
   /// \param[in] _physicsEngine Name of physics engine to use.
   public: void GroundPlane(const std::string &_physicsEngine);
+
+  /// \brief Test a ray fan sonar with just a ground plane.
+  /// \param[in] _physicsEngine Name of physics engine to use.
+  public: void GroundPlaneRayFan(const std::string &_physicsEngine);
 };
 
 static std::string sonarSensorString =
@@ -191,6 +196,41 @@ void SonarSensor_TEST::GroundPlane(const std::string &_physicsEngine)
   EXPECT_NEAR(sonar->Range(), 2.0, 0.01);
 }
 
+/////////////////////////////////////////////////
+void SonarSensor_TEST::GroundPlaneRayFan(const std::string &_physicsEngine)
+{
+  sensors::set_sonar_ray_fan_enabled(true);
+
+  // Paused, the ray query only refreshes poses when the world steps
+  Load("worlds/empty.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  sensors::SonarSensorPtr sonar = SpawnSonar("sonar", "sonar",
+      ignition::math::Pose3d(0, 0, 1, 0, 0, 0), 0, 2, 0.2);
+  ASSERT_TRUE(sonar != nullptr);
+
+  physics::ModelPtr model = world->ModelByName("sonar");
+  ASSERT_TRUE(model != nullptr);
+
+  // The sonar adds no collision to the world
+  EXPECT_TRUE(world->EntityByName(sonar->ScopedName() + "sensor_collision")
+      == nullptr);
+
+  // Sonar should detect the ground plane, without waiting for contacts
+  sonar->Update(true);
+  EXPECT_NEAR(sonar->Range(), 1.0, 0.01);
+
+  // Rotate the model, and the sonar should not see the ground plane
+  model->SetWorldPose(ignition::math::Pose3d(0, 0, 1, 0, 1.5707, 0));
+  world->Step(1);
+
+  sonar->Update(true);
+  EXPECT_NEAR(sonar->Range(), 2.0, 0.01);
+
+  sensors::set_sonar_ray_fan_enabled(false);
+}
+
 TEST_P(SonarSensor_TEST, CreateSonar)
 {
   std::string physics = std::get<0>(GetParam());
@@ -217,6 +257,12 @@ TEST_P(SonarSensor_TEST, GroundPlane)
   GroundPlane(physics);
 }
 
+TEST_P(SonarSensor_TEST, GroundPlaneRayFan)
+{
+  std::string physics = std::get<0>(GetParam());
+  GroundPlaneRayFan(physics);
+}
+
 INSTANTIATE_TEST_CASE_P(SonarTests, SonarSensor_TEST,
   ::testing::Combine(PHYSICS_ENGINE_VALUES,
   ::testing::Values(false, true)),);  // NOLINT
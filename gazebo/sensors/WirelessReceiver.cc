@@ -14,7 +14,9 @@
  * limitations under the License.
  *
 */
-#include <ignition/common/Profiler.hh>
+#include <memory>
+#include <vector>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -106,14 +108,16 @@ bool WirelessReceiver::UpdateImpl(const bool /*_force*/)
   IGN_PROFILE("WirelessReceiver::UpdateImpl");
   IGN_PROFILE_BEGIN("Update");
 
-  std::string txEssid;
   msgs::WirelessNodes msg;
-  double rxPower;
-  double txFreq;
 
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
 
   ignition::math::Pose3d myPos = this->referencePose;
+
+  // Keep the transmitters within our frequency range, and check the
+  // obstacles between them and us in a single batch of rays
+  std::vector<std::shared_ptr<WirelessTransmitter>> transmitters;
+  std::vector<ignition::math::Vector3d> starts;
   Sensor_V sensors = SensorManager::Instance()->GetSensors();
   for (Sensor_V::iterator it = sensors.begin(); it != sensors.end(); ++it)
   {
@@ -122,26 +126,39 @@ bool WirelessReceiver::UpdateImpl(const bool /*_force*/)
       std::shared_ptr<gazebo::sensors::WirelessTransmitter> transmitter =
           std::static_pointer_cast<WirelessTransmitter>(*it);
 
-      txFreq = transmitter->Freq();
-      rxPower = transmitter->SignalStrength(myPos, this->Gain());
-
-      // Discard if the frequency received is out of our frequency range,
-      // or if the received signal strengh is lower than the sensivity
+      double txFreq = transmitter->Freq();
       if ((txFreq < this->MinFreqFiltered()) ||
-          (txFreq > this->MaxFreqFiltered()) ||
-          (rxPower < this->Sensitivity()))
+          (txFreq > this->MaxFreqFiltered()))
       {
         continue;
       }
 
-      txEssid = transmitter->ESSID();
-
-      msgs::WirelessNode *wirelessNode = msg.add_node();
-      wirelessNode->set_essid(txEssid);
-      wirelessNode->set_frequency(txFreq);
-      wirelessNode->set_signal_level(rxPower);
+      transmitters.push_back(transmitter);
+      starts.push_back(transmitter->ReferencePose().Pos());
     }
   }
+
+  std::vector<bool> obstructed;
+  if (!transmitters.empty())
+  {
+    std::vector<ignition::math::Vector3d> ends(starts.size(), myPos.Pos());
+    this->CastObstructionRays(starts, ends, obstructed);
+  }
+
+  for (size_t i = 0; i < transmitters.size(); ++i)
+  {
+    double rxPower = transmitters[i]->SignalStrength(myPos, this->Gain(),
+        obstructed[i]);
+
+    // Discard if the received signal strengh is lower than the sensivity
+    if (rxPower < this->Sensitivity())
+      continue;
+
+    msgs::WirelessNode *wirelessNode = msg.add_node();
+    wirelessNode->set_essid(transmitters[i]->ESSID());
+    wirelessNode->set_frequency(transmitters[i]->Freq());
+    wirelessNode->set_signal_level(rxPower);
+  }
   IGN_PROFILE_END();
   IGN_PROFILE_BEGIN("Publish");
   if (msg.node_size() > 0)
@@ -15,29 +15,85 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/SensorManager.hh"
 #include "gazebo/physics/physics.hh"
+#include "gazebo/physics/RayQuery.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 
 #include "gazebo/sensors/WirelessTransceiver.hh"
 
+/// \internal
+/// \brief Private data for the WirelessTransceiver class.
+class gazebo::sensors::WirelessTransceiverPrivate
+{
+  /// \brief Physics engine ray used by CastObstructionRays when the ray
+  /// query can't be used, created on first use.
+  public: physics::RayShapePtr obstacleRay;
+};
+
 using namespace gazebo;
 using namespace sensors;
 
+namespace
+{
+  /// \brief Private data of the transceivers, by transceiver. It is kept
+  /// out of WirelessTransceiver so that the layout of the class doesn't
+  /// change.
+  class WirelessTransceiverPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the transceivers.
+    public: static WirelessTransceiverPrivates &Instance()
+    {
+      static WirelessTransceiverPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by transceiver.
+    public: std::unordered_map<const WirelessTransceiver *,
+            std::unique_ptr<WirelessTransceiverPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 /////////////////////////////////////////////////
 WirelessTransceiver::WirelessTransceiver()
   : Sensor(sensors::OTHER)
 {
   this->active = false;
+
+  WirelessTransceiverPrivates &privates =
+      WirelessTransceiverPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new WirelessTransceiverPrivate);
 }
 
 /////////////////////////////////////////////////
 WirelessTransceiver::~WirelessTransceiver()
 {
+  WirelessTransceiverPrivates &privates =
+      WirelessTransceiverPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+WirelessTransceiverPrivate *WirelessTransceiver::WirelessTransceiverData()
+    const
+{
+  WirelessTransceiverPrivates &privates =
+      WirelessTransceiverPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -96,6 +152,7 @@ void WirelessTransceiver::Init()
 /////////////////////////////////////////////////
 void WirelessTransceiver::Fini()
 {
+  this->WirelessTransceiverData()->obstacleRay.reset();
   this->pub.reset();
   this->parentEntity.lock().reset();
   Sensor::Fini();
@@ -112,3 +169,76 @@ double WirelessTransceiver::Gain() const
 {
   return this->gain;
 }
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d WirelessTransceiver::ReferencePose() const
+{
+  return this->referencePose;
+}
+
+/////////////////////////////////////////////////
+void WirelessTransceiver::CastObstructionRays(
+    const std::vector<ignition::math::Vector3d> &_starts,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    std::vector<bool> &_obstructed)
+{
+  _obstructed.assign(_starts.size(), false);
+  if (_starts.empty())
+    return;
+
+  // Avoid computing the intersection of coincident points
+  // This prevents an assertion in bullet (issue #849)
+  std::vector<ignition::math::Vector3d> ends = _ends;
+  for (size_t i = 0; i < ends.size(); ++i)
+  {
+    if (_starts[i] == ends[i])
+      ends[i].Z() += 0.00001;
+  }
+
+  std::vector<double> distances;
+  std::vector<int> hits;
+
+  // The snapshot is immutable, so no lock against physics is needed.
+  if (this->world->RayQuerySnapshotEnabled())
+  {
+    std::shared_ptr<const physics::RayQuery> snapshot =
+        this->world->RayQuerySnapshot();
+    if (snapshot)
+    {
+      snapshot->CastRays(_starts, ends, distances, hits);
+      for (size_t i = 0; i < hits.size(); ++i)
+        _obstructed[i] = hits[i] >= 0;
+      return;
+    }
+  }
+
+  // Acquire the mutex for avoiding race condition with the physics engine
+  boost::recursive_mutex::scoped_lock lock(
+      *this->world->Physics()->GetPhysicsUpdateMutex());
+
+  physics::RayQuery &query = this->world->SharedRayQuery();
+  if (query.Update(this->world->Models(), this->world->Iterations()))
+  {
+    query.CastRays(_starts, ends, distances, hits);
+    for (size_t i = 0; i < hits.size(); ++i)
+      _obstructed[i] = hits[i] >= 0;
+    return;
+  }
+
+  physics::RayShapePtr &obstacleRay =
+      this->WirelessTransceiverData()->obstacleRay;
+  if (!obstacleRay)
+  {
+    obstacleRay = boost::dynamic_pointer_cast<physics::RayShape>(
+        this->world->Physics()->CreateShape("ray", physics::CollisionPtr()));
+  }
+
+  std::string entityName;
+  double dist;
+  for (size_t i = 0; i < _starts.size(); ++i)
+  {
+    obstacleRay->SetPoints(_starts[i], ends[i]);
+    obstacleRay->GetIntersection(dist, entityName);
+    _obstructed[i] = !entityName.empty();
+  }
+}
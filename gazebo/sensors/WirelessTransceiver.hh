@@ -18,7 +18,9 @@
 #define _GAZEBO_SENSORS_WIRELESSTRANSCEIVER_HH_
 
 #include <string>
+#include <vector>
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -29,6 +31,9 @@ namespace gazebo
 {
   namespace sensors
   {
+    // Forward declare private data class
+    class WirelessTransceiverPrivate;
+
     /// \addtogroup gazebo_sensors
     /// \{
 
@@ -62,6 +67,29 @@ namespace gazebo
       /// \return Receiver power (dBm).
       public: double Power() const;
 
+      /// \brief Get the world pose of the antenna, as of the last update.
+      /// \return World pose of the antenna.
+      public: ignition::math::Pose3d ReferencePose() const;
+
+      /// \brief Check for obstacles between pairs of points. The segments
+      /// are cast in one batch against the shared ray query of the world,
+      /// or its snapshot, and one by one with a physics engine ray when the
+      /// world has shapes the ray query doesn't support.
+      /// \param[in] _starts Start points, in the world frame.
+      /// \param[in] _ends End points, in the world frame.
+      /// \param[out] _obstructed True for the segments that hit a
+      /// collision.
+      protected: void CastObstructionRays(
+          const std::vector<ignition::math::Vector3d> &_starts,
+          const std::vector<ignition::math::Vector3d> &_ends,
+          std::vector<bool> &_obstructed);
+
+      /// \internal
+      /// \brief Get the private data of the transceiver. It is kept out of
+      /// the class so that its layout doesn't change.
+      /// \return The private data.
+      private: WirelessTransceiverPrivate *WirelessTransceiverData() const;
+
       /// \brief Publisher to publish propagation model data
       protected: transport::PublisherPtr pub;
 
@@ -14,6 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -74,15 +78,49 @@ void WirelessTransmitter::Load(const std::string &_worldName)
       "wirelessTransmitterSensor did not get a valid publisher pointer");
 }
 
+//////////////////////////////////////////////////
+/// \brief Get the models whose bounding box is within a distance of a
+/// point.
+/// \param[in] _world The world.
+/// \param[in] _center The point.
+/// \param[in] _radius The distance.
+/// \param[out] _models Ids and bounding boxes of the models.
+static void NearbyModels(const physics::WorldPtr &_world,
+    const ignition::math::Vector3d &_center, const double _radius,
+    std::vector<std::pair<uint32_t, ignition::math::AxisAlignedBox>> &_models)
+{
+  const ignition::math::Vector3d extent(_radius, _radius, _radius);
+  const ignition::math::AxisAlignedBox area(_center - extent,
+      _center + extent);
+
+  _models.clear();
+  for (auto const &model : _world->Models())
+  {
+    ignition::math::AxisAlignedBox box = model->BoundingBox();
+    if (box.Intersects(area))
+      _models.push_back(std::make_pair(model->GetId(), box));
+  }
+}
+
 //////////////////////////////////////////////////
 void WirelessTransmitter::Init()
 {
   WirelessTransceiver::Init();
 
-  // This ray will be used in SignalStrength() for checking obstacles
-  // between the transmitter and a given point.
-  this->dataPtr->testRay = boost::dynamic_pointer_cast<RayShape>(
-      this->world->Physics()->CreateShape("ray", CollisionPtr()));
+  // Iterate using a rectangular grid, but only choose the points within
+  // a circunference of radius MaxRadius
+  this->dataPtr->gridPoints.clear();
+  for (double x = -this->dataPtr->MaxRadius;
+       x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
+  {
+    for (double y = -this->dataPtr->MaxRadius;
+         y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
+    {
+      if (std::hypot(x, y) <= this->dataPtr->MaxRadius)
+        this->dataPtr->gridPoints.push_back(ignition::math::Vector3d(x, y, 0));
+    }
+  }
+  this->dataPtr->gridObstructed.clear();
 }
 
 //////////////////////////////////////////////////
@@ -92,38 +130,47 @@ bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
 
   if (this->dataPtr->visualize)
   {
+    // The obstacles of the grid only change when the transmitter or the
+    // models around it move, so their rays are only cast then.
+    std::vector<std::pair<uint32_t, ignition::math::AxisAlignedBox>> models;
+    NearbyModels(this->world, this->referencePose.Pos(),
+        this->dataPtr->MaxRadius, models);
+
+    if (this->dataPtr->gridObstructed.empty() ||
+        this->referencePose != this->dataPtr->fieldPose ||
+        models != this->dataPtr->fieldModels)
+    {
+      const ignition::math::Vector3d start = this->referencePose.Pos();
+      std::vector<ignition::math::Vector3d> starts(
+          this->dataPtr->gridPoints.size(), start);
+      std::vector<ignition::math::Vector3d> ends;
+      ends.reserve(this->dataPtr->gridPoints.size());
+      for (auto const &point : this->dataPtr->gridPoints)
+        ends.push_back(this->referencePose.CoordPositionAdd(point));
+
+      this->CastObstructionRays(starts, ends, this->dataPtr->gridObstructed);
+      this->dataPtr->fieldPose = this->referencePose;
+      this->dataPtr->fieldModels = std::move(models);
+    }
+
     msgs::PropagationGrid msg;
-    ignition::math::Pose3d pos;
-    ignition::math::Pose3d worldPose;
-    double strength;
-    msgs::PropagationParticle *p;
-
-    // Iterate using a rectangular grid, but only choose the points within
-    // a circunference of radius MaxRadius
-    for (double x = -this->dataPtr->MaxRadius;
-         x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
+    for (size_t i = 0; i < this->dataPtr->gridPoints.size(); ++i)
     {
-      for (double y = -this->dataPtr->MaxRadius;
-           y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
-      {
-        pos.Set(x, y, 0.0, 0, 0, 0);
-
-        worldPose = pos + this->referencePose;
-
-        if (this->referencePose.Pos().Distance(worldPose.Pos()) <=
-            this->dataPtr->MaxRadius)
-        {
-          // For the propagation model assume the receiver antenna has the same
-          // gain as the transmitter
-          strength = this->SignalStrength(worldPose, this->Gain());
-
-          // Add a new particle to the grid
-          p = msg.add_particle();
-          p->set_x(x);
-          p->set_y(y);
-          p->set_signal_level(strength);
-        }
-      }
+      const ignition::math::Vector3d &point = this->dataPtr->gridPoints[i];
+      ignition::math::Pose3d worldPose(
+          this->referencePose.CoordPositionAdd(point),
+          this->referencePose.Rot());
+
+      // For the propagation model assume the receiver antenna has the same
+      // gain as the transmitter
+      double strength = this->SignalStrength(worldPose, this->Gain(),
+          this->dataPtr->gridObstructed[i]);
+
+      // Add a new particle to the grid
+      msgs::PropagationParticle *p = msg.add_particle();
+      p->set_x(point.X());
+      p->set_y(point.Y());
+      p->set_signal_level(strength);
     }
     this->pub->Publish(msg);
   }
@@ -148,34 +195,22 @@ double WirelessTransmitter::SignalStrength(
     const ignition::math::Pose3d &_receiver,
     const double _rxGain)
 {
-  std::string entityName;
-  double dist;
-  ignition::math::Vector3d end = _receiver.Pos();
-  ignition::math::Vector3d start = this->referencePose.Pos();
-
-  // Avoid computing the intersection of coincident points
-  // This prevents an assertion in bullet (issue #849)
-  if (start == end)
-  {
-    end.Z() += 0.00001;
-  }
+  std::vector<bool> obstructed;
+  this->CastObstructionRays({this->referencePose.Pos()}, {_receiver.Pos()},
+      obstructed);
 
-  // Acquire the mutex for avoiding race condition with the physics engine
-  boost::recursive_mutex::scoped_lock lock(*(
-        this->world->Physics()->GetPhysicsUpdateMutex()));
+  return this->SignalStrength(_receiver, _rxGain, obstructed[0]);
+}
 
+/////////////////////////////////////////////////
+double WirelessTransmitter::SignalStrength(
+    const ignition::math::Pose3d &_receiver,
+    const double _rxGain, const bool _obstructed) const
+{
   // Compute the value of n depending on the obstacles between Tx and Rx
-  double n = WirelessTransmitterPrivate::NEmpty;
-
-  // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
-
   // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
-  {
-    n = WirelessTransmitterPrivate::NObstacle;
-  }
+  double n = _obstructed ? WirelessTransmitterPrivate::NObstacle :
+      WirelessTransmitterPrivate::NEmpty;
 
   double distance = std::max(1.0,
       this->referencePose.Pos().Distance(_receiver.Pos()));
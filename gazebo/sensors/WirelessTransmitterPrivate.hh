@@ -17,7 +17,13 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 #include "gazebo/physics/PhysicsTypes.hh"
 
 namespace gazebo
@@ -57,8 +63,22 @@ namespace gazebo
       /// \brief Reception frequency (MHz).
       public: double freq = 2442.0;
 
-      // \brief Ray used to test for collisions when placing entities
-      public: physics::RayShapePtr testRay;
+      /// \brief Points of the visualization grid, in the frame of the
+      /// transmitter.
+      public: std::vector<ignition::math::Vector3d> gridPoints;
+
+      /// \brief True for the points of the grid hidden from the
+      /// transmitter by an obstacle, when the transmitter was at fieldPose
+      /// and the models around it had the boxes of fieldModels.
+      public: std::vector<bool> gridObstructed;
+
+      /// \brief Pose of the transmitter when gridObstructed was computed.
+      public: ignition::math::Pose3d fieldPose;
+
+      /// \brief Ids and bounding boxes of the models within MaxRadius of
+      /// the transmitter when gridObstructed was computed.
+      public: std::vector<std::pair<uint32_t, ignition::math::AxisAlignedBox>>
+          fieldModels;
     };
   }
 }
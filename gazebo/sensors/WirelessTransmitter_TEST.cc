@@ -27,6 +27,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
+    public: void TestObstacles();
     private: void TxMsg(const ConstPropagationGridPtr &_msg);
 
     private: std::mutex mutex;
@@ -236,6 +237,108 @@ void WirelessTransmitter_TEST::TestUpdateImplNoVisual()
   EXPECT_FALSE(this->receivedMsg);
 }
 
+/////////////////////////////////////////////////
+/// \brief Test the signal behind an obstacle, for single points and for
+/// the propagation grid
+void WirelessTransmitter_TEST::TestObstacles()
+{
+  const int samples = 100;
+  ignition::math::Pose3d behind(3, 0, 0.055, 0, 0, 0);
+  ignition::math::Pose3d aside(0, 3, 0.055, 0, 0, 0);
+
+  // The obstacle flag lowers the signal
+  double clearAvg = 0.0;
+  double obstructedAvg = 0.0;
+  for (int i = 0; i < samples; ++i)
+  {
+    clearAvg += this->tx->SignalStrength(behind, this->tx->Gain(), false);
+    obstructedAvg += this->tx->SignalStrength(behind, this->tx->Gain(), true);
+  }
+  clearAvg /= samples;
+  obstructedAvg /= samples;
+  EXPECT_LT(obstructedAvg, clearAvg - 20.0);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  std::string txTopic =
+      "/gazebo/default/tx/link/wirelessTransmitterConstructor/transceiver";
+  transport::SubscriberPtr sub = node->Subscribe(txTopic,
+      &WirelessTransmitter_TEST::TxMsg, this);
+
+  // Average signal of the grid at the two points over several updates
+  auto gridSignal = [this](double &_behind, double &_aside)
+  {
+    _behind = 0.0;
+    _aside = 0.0;
+    int count = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->receivedMsg = false;
+      }
+      this->tx->Update(true);
+      for (int j = 0; j < 50; ++j)
+      {
+        {
+          std::lock_guard<std::mutex> lock(this->mutex);
+          if (this->receivedMsg)
+            break;
+        }
+        common::Time::MSleep(10);
+      }
+
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (!this->receivedMsg)
+        continue;
+      for (int k = 0; k < this->gridMsg->particle_size(); ++k)
+      {
+        const msgs::PropagationParticle &p = this->gridMsg->particle(k);
+        if (ignition::math::equal(p.x(), 3.0) &&
+            ignition::math::equal(p.y(), 0.0))
+        {
+          _behind += p.signal_level();
+        }
+        else if (ignition::math::equal(p.x(), 0.0) &&
+            ignition::math::equal(p.y(), 3.0))
+        {
+          _aside += p.signal_level();
+        }
+      }
+      ++count;
+    }
+    ASSERT_GT(count, 0);
+    _behind /= count;
+    _aside /= count;
+  };
+
+  // Without obstacles the two points are alike
+  double gridBehind, gridAside;
+  gridSignal(gridBehind, gridAside);
+  EXPECT_NEAR(gridBehind, gridAside, 10.0);
+
+  // A box between the transmitter and the first point. The grid is cast
+  // again, since a model appeared within its radius.
+  SpawnBox("obstacle", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(1.5, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  gridSignal(gridBehind, gridAside);
+  EXPECT_LT(gridBehind, gridAside - 20.0);
+
+  // Single points see the obstacle too
+  double behindAvg = 0.0;
+  double asideAvg = 0.0;
+  for (int i = 0; i < samples; ++i)
+  {
+    behindAvg += this->tx->SignalStrength(behind, this->tx->Gain());
+    asideAvg += this->tx->SignalStrength(aside, this->tx->Gain());
+  }
+  behindAvg /= samples;
+  asideAvg /= samples;
+  EXPECT_LT(behindAvg, asideAvg - 20.0);
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestSensorCreation)
 {
@@ -266,6 +369,12 @@ TEST_F(WirelessTransmitter_TEST, TestUpdateImplNoVisual)
   TestUpdateImplNoVisual();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestObstacles)
+{
+  TestObstacles();
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -14,7 +14,23 @@
  * limitations under the License.
  *
 */
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 #include "gazebo/common/Exception.hh"
 #include "gazebo/util/LogRecord.hh"
 #include "gazebo/common/Console.hh"
@@ -22,7 +38,11 @@
 #include "gazebo/Server.hh"
 
 //////////////////////////////////////////////////
-int main(int argc, char **argv)
+/// \brief Run a server with the given arguments.
+/// \param[in] _argc Number of arguments.
+/// \param[in] _argv Arguments.
+/// \return Exit code of the process.
+static int RunServer(int _argc, char **_argv)
 {
   std::unique_ptr<gazebo::Server> server;
 
@@ -36,7 +56,7 @@ int main(int argc, char **argv)
     gazebo::util::LogRecord::Instance()->Init("gzserver");
 
     server.reset(new gazebo::Server());
-    if (!server->ParseArgs(argc, argv))
+    if (!server->ParseArgs(_argc, _argv))
       return -1;
 
     server->Run();
@@ -59,3 +79,247 @@ int main(int argc, char **argv)
 
   return 0;
 }
+
+#ifndef _WIN32
+/// \brief Seconds a client of the zygote has to send its request, so that
+/// a client that doesn't send it can't block the other ones.
+static const int ZYGOTE_REQUEST_TIMEOUT = 5;
+
+//////////////////////////////////////////////////
+/// \brief Read a spawn request from a client of the zygote. A request is
+/// one argument per line, ended by an empty line. The first argument is
+/// the port of the master of the child, 0 to keep GAZEBO_MASTER_URI, and
+/// the others are the gzserver arguments of the child.
+/// \param[in] _fd Socket of the client.
+/// \param[out] _args Arguments of the request.
+/// \return False if the client closed the socket before the end of the
+/// request, or didn't send it within ZYGOTE_REQUEST_TIMEOUT seconds.
+static bool ReadRequest(const int _fd, std::vector<std::string> &_args)
+{
+  timeval timeout;
+  timeout.tv_sec = ZYGOTE_REQUEST_TIMEOUT;
+  timeout.tv_usec = 0;
+  if (setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+        sizeof(timeout)) != 0)
+  {
+    return false;
+  }
+
+  std::string line;
+  char c;
+  while (true)
+  {
+    const ssize_t n = read(_fd, &c, 1);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+
+    if (c != '\n')
+      line += c;
+    else if (line.empty())
+      return !_args.empty();
+    else
+    {
+      _args.push_back(line);
+      line.clear();
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Remove the socket left by a zygote that didn't exit cleanly.
+/// Nothing is removed if the path isn't a socket, or if a zygote still
+/// listens on it.
+/// \param[in] _addr Address of the socket.
+/// \return True if the path is free.
+static bool RemoveStaleSocket(const sockaddr_un &_addr)
+{
+  struct stat info;
+  if (lstat(_addr.sun_path, &info) != 0)
+  {
+    if (errno == ENOENT)
+      return true;
+    std::cerr << "Unable to check zygote socket [" << _addr.sun_path
+              << "]: " << strerror(errno) << "\n";
+    return false;
+  }
+
+  if (!S_ISSOCK(info.st_mode))
+  {
+    std::cerr << "Zygote socket path [" << _addr.sun_path
+              << "] exists and is not a socket\n";
+    return false;
+  }
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+  {
+    std::cerr << "Unable to check zygote socket [" << _addr.sun_path
+              << "]: " << strerror(errno) << "\n";
+    return false;
+  }
+  const bool refused = connect(fd, reinterpret_cast<const sockaddr *>(&_addr),
+      sizeof(_addr)) != 0 && errno == ECONNREFUSED;
+  close(fd);
+
+  if (!refused)
+  {
+    std::cerr << "Zygote socket [" << _addr.sun_path
+              << "] is in use by another process\n";
+    return false;
+  }
+
+  if (unlink(_addr.sun_path) != 0)
+  {
+    std::cerr << "Unable to remove stale zygote socket [" << _addr.sun_path
+              << "]: " << strerror(errno) << "\n";
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Run gzserver as a zygote. The zygote loads the given libraries
+/// once, then listens on a UNIX socket and forks a server for each
+/// request. The children share the loaded libraries copy-on-write, so
+/// they start without loading them again. Nothing that starts threads is
+/// initialized before forking, since threads don't survive a fork.
+/// \param[in] _socketPath Path of the UNIX socket to listen on.
+/// \param[in] _preload Libraries to load before forking, typically the
+/// plugins of the worlds that will be spawned.
+/// \param[in] _baseArgs Arguments given to every child before the
+/// arguments of its request, starting with the name of the program.
+/// \return Exit code of the zygote, or of a child.
+static int RunZygote(const std::string &_socketPath,
+    const std::vector<std::string> &_preload,
+    const std::vector<std::string> &_baseArgs)
+{
+  for (auto const &lib : _preload)
+  {
+    if (!dlopen(lib.c_str(), RTLD_NOW | RTLD_GLOBAL))
+      std::cerr << "Unable to preload [" << lib << "]: " << dlerror() << "\n";
+  }
+
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (_socketPath.size() >= sizeof(addr.sun_path))
+  {
+    std::cerr << "Zygote socket path [" << _socketPath << "] is too long\n";
+    return -1;
+  }
+  std::strncpy(addr.sun_path, _socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+  if (!RemoveStaleSocket(addr))
+    return -1;
+
+  const int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0 ||
+      bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      listen(listenFd, 16) != 0)
+  {
+    std::cerr << "Unable to listen on zygote socket [" << _socketPath
+              << "]: " << strerror(errno) << "\n";
+    return -1;
+  }
+
+  // Children are reaped by the system, their clients follow them by pid.
+  signal(SIGCHLD, SIG_IGN);
+
+  std::cout << "Zygote listening on [" << _socketPath << "]" << std::endl;
+
+  while (true)
+  {
+    const int clientFd = accept(listenFd, nullptr, nullptr);
+    if (clientFd < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      std::cerr << "Zygote accept failed: " << strerror(errno) << "\n";
+      break;
+    }
+
+    std::vector<std::string> request;
+    if (!ReadRequest(clientFd, request))
+    {
+      close(clientFd);
+      continue;
+    }
+
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      close(listenFd);
+      close(clientFd);
+      signal(SIGCHLD, SIG_DFL);
+
+      const int port = std::atoi(request[0].c_str());
+      if (port > 0)
+      {
+        const std::string uri = "http://localhost:" + std::to_string(port);
+        setenv("GAZEBO_MASTER_URI", uri.c_str(), 1);
+      }
+
+      std::vector<std::string> args = _baseArgs;
+      args.insert(args.end(), request.begin() + 1, request.end());
+      std::vector<char *> argv;
+      for (auto &arg : args)
+        argv.push_back(&arg[0]);
+      argv.push_back(nullptr);
+
+      return RunServer(static_cast<int>(args.size()), argv.data());
+    }
+
+    // Reply with the pid of the child, or -1 if the fork failed. A client
+    // that left doesn't raise SIGPIPE.
+    const std::string reply = std::to_string(pid) + "\n";
+    if (send(clientFd, reply.c_str(), reply.size(), MSG_NOSIGNAL) < 0)
+      std::cerr << "Unable to reply to zygote client\n";
+    close(clientFd);
+  }
+
+  close(listenFd);
+  unlink(_socketPath.c_str());
+  return -1;
+}
+#endif
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // The zygote options are handled here, before anything is initialized.
+  // Like the other options, they take their value as the next argument or
+  // after an equal sign.
+  const std::string zygoteOpt = "--zygote";
+  const std::string preloadOpt = "--zygote_preload";
+  std::string zygote;
+  std::vector<std::string> preload;
+  std::vector<std::string> baseArgs;
+  for (int i = 0; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == zygoteOpt && i + 1 < argc)
+      zygote = argv[++i];
+    else if (arg.compare(0, zygoteOpt.size() + 1, zygoteOpt + "=") == 0)
+      zygote = arg.substr(zygoteOpt.size() + 1);
+    else if (arg == preloadOpt && i + 1 < argc)
+      preload.push_back(argv[++i]);
+    else if (arg.compare(0, preloadOpt.size() + 1, preloadOpt + "=") == 0)
+      preload.push_back(arg.substr(preloadOpt.size() + 1));
+    else
+      baseArgs.push_back(arg);
+  }
+
+  if (!zygote.empty())
+  {
+#ifndef _WIN32
+    return RunZygote(zygote, preload, baseArgs);
+#else
+    std::cerr << "The zygote mode is not supported on Windows\n";
+    return -1;
+#endif
+  }
+
+  return RunServer(argc, argv);
+}
@@ -16,6 +16,7 @@
 */
 
 #include "gazebo/transport/CallbackHelper.hh"
+#include "gazebo/transport/SubscriptionTransport.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -58,3 +59,21 @@ unsigned int CallbackHelper::GetId() const
 {
   return this->id;
 }
+
+/////////////////////////////////////////////////
+bool CallbackHelper::HandleEncoded(const EncodedMessagePtr &_msg,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  // Dispatched on the type of the callback, so that the class keeps its
+  // virtual functions
+  if (SubscriptionTransport *sub = dynamic_cast<SubscriptionTransport *>(this))
+    return sub->OutputEncoded(_msg, _cb, _id);
+
+  if (!this->IsLocal() || dynamic_cast<RawCallbackHelper *>(this))
+    return this->HandleData(_msg->Data(), _cb, _id);
+
+  bool result = this->HandleMessage(_msg->Message());
+  if (!_cb.empty())
+    _cb(_id);
+  return result;
+}
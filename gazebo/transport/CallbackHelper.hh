@@ -29,6 +29,7 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/Exception.hh"
 
+#include "gazebo/transport/EncodedMessage.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/util/system.hh"
 
@@ -69,6 +70,18 @@ namespace gazebo
       /// \return true if successfully processed; false otherwise
       public: virtual bool HandleMessage(MessagePtr _newMsg) = 0;
 
+      /// \brief Process a published message, shared with the other
+      /// subscribers. Local callbacks get the message, remote and raw ones
+      /// get the serialized data, which is only serialized once for all of
+      /// them.
+      /// \param[in] _msg Published message
+      /// \param[in] _cb If non-null, callback to be invoked which signals
+      /// that transmission is complete.
+      /// \param[in] _id ID associated with the message data.
+      /// \return true if successfully processed; false otherwise
+      public: bool HandleEncoded(const EncodedMessagePtr &_msg,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
       /// \brief Is the callback local?
       /// \return true if the callback is local, false if the callback
       ///         is tied to a remote connection
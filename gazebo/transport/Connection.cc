@@ -49,6 +49,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
@@ -56,18 +62,104 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/msgs/msgs.hh"
 
+#include "gazebo/transport/EncodedMessage.hh"
 #include "gazebo/transport/IOManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/TransportIface.hh"
+
+/// \internal
+/// \brief Private data for the Connection class.
+class gazebo::transport::ConnectionPrivate
+{
+  /// \brief Data sent by a single socket write. Small messages are copied
+  /// and coalesced, large encoded messages are referenced and gathered by
+  /// the write.
+  public: class WriteBatch
+  {
+    /// \brief Part of a batch.
+    public: class Chunk
+    {
+      /// \brief Copied headers and data, when msg is null.
+      public: std::string bytes;
+
+      /// \brief Message whose header and data are written.
+      public: EncodedMessagePtr msg;
+    };
+
+    /// \brief Get the buffers to write, valid until the batch is
+    /// modified.
+    /// \return The buffers.
+    public: std::vector<boost::asio::const_buffer> Buffers() const;
+
+    /// \brief Parts of the batch.
+    public: std::vector<Chunk> chunks;
+
+    /// \brief Number of bytes of the batch.
+    public: size_t size = 0;
+  };
+
+  /// \brief Outgoing data queue, protected by the write mutex of the
+  /// connection.
+  public: std::deque<WriteBatch> writeQueue;
+
+  /// \brief Content data from a new message.
+  public: std::string inboundData;
+
+  /// \brief Index of the IO thread that handles the connection.
+  public: unsigned int ioIndex = 0;
+
+  /// \brief Number of messages in writeQueue.
+  public: std::atomic<unsigned int> outgoingCount{0};
+
+  /// \brief Number of bytes in writeQueue.
+  public: std::atomic<uint64_t> outgoingBytes{0};
+};
 
 using namespace gazebo;
 using namespace transport;
 
+namespace
+{
+  /// \brief Private data of the connections, by connection. It is kept out
+  /// of Connection so that the layout of the class doesn't change.
+  class ConnectionPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the connections.
+    public: static ConnectionPrivates &Instance()
+    {
+      static ConnectionPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by connection.
+    public: std::unordered_map<const Connection *,
+            std::unique_ptr<ConnectionPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 extern void dummy_callback_fn(uint32_t);
 
 unsigned int Connection::idCounter = 0;
 IOManager *Connection::iomanager = NULL;
 
+/// \brief Maximum number of unused receive buffers.
+static const size_t RECEIVE_BUFFER_COUNT = 16;
+
+/// \brief Unused receive buffers, see ConnectionReadTask::AcquireBuffer.
+static std::vector<std::string> receiveBuffers;
+
+/// \brief Protects receiveBuffers.
+static boost::mutex receiveBuffersMutex;
+
+/// \brief Size over which queued messages aren't coalesced into one write,
+/// and encoded messages are written without a copy.
+static const size_t WRITE_BATCH_SIZE = 4096;
+
 // Version 1.52 of boost has an address::is_unspecfied function, but
 // Version 1.46.1 (installed on ubuntu) does not. So this helper function
 // is stolen from adress::is_unspecified function in boost v1.52.
@@ -84,16 +176,54 @@ static bool addressIsLoopback(const boost::asio::ip::address_v4 &_addr)
   return (_addr.to_ulong() & 0xFF000000) == 0x7F000000;
 }
 
+//////////////////////////////////////////////////
+std::string ConnectionReadTask::AcquireBuffer()
+{
+  std::string buffer;
+  boost::mutex::scoped_lock lock(receiveBuffersMutex);
+  if (!receiveBuffers.empty())
+  {
+    buffer.swap(receiveBuffers.back());
+    receiveBuffers.pop_back();
+  }
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+void ConnectionReadTask::ReleaseBuffer(std::string &_buffer)
+{
+  _buffer.clear();
+  {
+    boost::mutex::scoped_lock lock(receiveBuffersMutex);
+    if (receiveBuffers.size() < RECEIVE_BUFFER_COUNT)
+    {
+      receiveBuffers.push_back(std::string());
+      receiveBuffers.back().swap(_buffer);
+      return;
+    }
+  }
+  std::string().swap(_buffer);
+}
+
 //////////////////////////////////////////////////
 Connection::Connection()
 {
+  {
+    ConnectionPrivates &privates = ConnectionPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new ConnectionPrivate);
+  }
+
   this->isOpen = false;
   this->dropMsgLogged = false;
 
   if (iomanager == NULL)
-    iomanager = new IOManager();
+    iomanager = new IOManager(getIOThreadCount());
 
-  this->socket = new boost::asio::ip::tcp::socket(iomanager->GetIO());
+  // Pin the connection to an IO thread
+  this->ConnectionData()->ioIndex = iomanager->NextIndex();
+  this->socket = new boost::asio::ip::tcp::socket(
+      iomanager->GetIO(this->ConnectionData()->ioIndex));
 
   iomanager->IncCount();
   this->id = idCounter++;
@@ -101,7 +231,6 @@ Connection::Connection()
   this->acceptor = NULL;
   this->readQuit = false;
   this->connectError = false;
-  this->writeQueue.clear();
   this->writeCount = 0;
 
   this->localURI = std::string("http://") + this->GetLocalHostname() + ":" +
@@ -136,6 +265,18 @@ Connection::~Connection()
       iomanager = NULL;
     }
   }
+
+  ConnectionPrivates &privates = ConnectionPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+ConnectionPrivate *Connection::ConnectionData() const
+{
+  ConnectionPrivates &privates = ConnectionPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -152,7 +293,8 @@ bool Connection::Connect(const std::string &_host, unsigned int _port)
 
   // Resolve the host name into an IP address
   boost::asio::ip::tcp::resolver::iterator end;
-  boost::asio::ip::tcp::resolver resolver(iomanager->GetIO());
+  boost::asio::ip::tcp::resolver resolver(
+      iomanager->GetIO(this->ConnectionData()->ioIndex));
   boost::asio::ip::tcp::resolver::query query(host, service,
       boost::asio::ip::resolver_query_base::numeric_service);
   boost::asio::ip::tcp::resolver::iterator endpointIter;
@@ -216,7 +358,8 @@ void Connection::Listen(unsigned int port, const AcceptCallback &_acceptCB)
 {
   this->acceptCB = _acceptCB;
 
-  this->acceptor = new boost::asio::ip::tcp::acceptor(iomanager->GetIO());
+  this->acceptor = new boost::asio::ip::tcp::acceptor(
+      iomanager->GetIO(this->ConnectionData()->ioIndex));
   boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port);
   this->acceptor->open(endpoint.protocol());
   this->acceptor->set_option(
@@ -306,22 +449,65 @@ void Connection::EnqueueMsg(const std::string &_buffer,
   snprintf(headerBuffer, HEADER_LENGTH + 1, "%08x",
       static_cast<unsigned int>(_buffer.size()));
 
+  this->EnqueueFrame(headerBuffer, _buffer, EncodedMessagePtr(), _cb, _id,
+      _force);
+}
+
+//////////////////////////////////////////////////
+void Connection::EnqueueMsg(const EncodedMessagePtr &_msg,
+    boost::function<void(uint32_t)> _cb, uint32_t _id, bool _force)
+{
+  const std::string &buffer = _msg->Data();
+
+  // Don't enqueue empty messages
+  if (buffer.empty() || !this->IsOpen())
+  {
+    return;
+  }
+
+  this->EnqueueFrame(_msg->Header().c_str(), buffer, _msg, _cb, _id, _force);
+}
+
+//////////////////////////////////////////////////
+void Connection::EnqueueFrame(const char *_header, const std::string &_buffer,
+    const EncodedMessagePtr &_msg, boost::function<void(uint32_t)> _cb,
+    uint32_t _id, bool _force)
+{
+  const size_t frameSize = HEADER_LENGTH + _buffer.size();
+
   {
+    ConnectionPrivate *data = this->ConnectionData();
+    std::deque<ConnectionPrivate::WriteBatch> &writeQueue = data->writeQueue;
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
-    if (this->writeQueue.empty() ||
-        (this->writeCount > 0 && this->writeQueue.size() == 1) ||
-        (this->writeQueue.back().size() + HEADER_LENGTH + _buffer.size() >
-         4096))
+    if (writeQueue.empty() ||
+        (this->writeCount > 0 && writeQueue.size() == 1) ||
+        (writeQueue.back().size + frameSize > WRITE_BATCH_SIZE))
     {
-      this->writeQueue.push_back(std::string(headerBuffer) + _buffer);
+      writeQueue.push_back(ConnectionPrivate::WriteBatch());
       this->callbacks.push_back({std::make_pair(_cb, _id)});
     }
     else
     {
-      this->writeQueue.back() += std::string(headerBuffer) + _buffer;
       this->callbacks.back().push_back(std::make_pair(_cb, _id));
     }
+
+    ConnectionPrivate::WriteBatch &batch = writeQueue.back();
+    if (_msg && frameSize > WRITE_BATCH_SIZE)
+    {
+      // Written from the message, which outlives the batch
+      batch.chunks.push_back(ConnectionPrivate::WriteBatch::Chunk());
+      batch.chunks.back().msg = _msg;
+    }
+    else
+    {
+      if (batch.chunks.empty() || batch.chunks.back().msg)
+        batch.chunks.push_back(ConnectionPrivate::WriteBatch::Chunk());
+      batch.chunks.back().bytes.append(_header, HEADER_LENGTH).append(_buffer);
+    }
+    batch.size += frameSize;
+    ++data->outgoingCount;
+    data->outgoingBytes += frameSize;
   }
 
   if (_force)
@@ -347,7 +533,9 @@ void Connection::ProcessWriteQueue(bool _blocking)
 
   // async_write should only be called when the last async_write has
   // completed. therefore we have to check the writeCount attribute
-  if (this->writeQueue.empty() || this->writeCount > 0)
+  std::deque<ConnectionPrivate::WriteBatch> &writeQueue =
+    this->ConnectionData()->writeQueue;
+  if (writeQueue.empty() || this->writeCount > 0)
   {
     return;
   }
@@ -355,13 +543,13 @@ void Connection::ProcessWriteQueue(bool _blocking)
   this->writeCount++;
 
   // Write the serialized data to the socket. We use
-  // "gather-write" to send both the head and the data in
-  // a single write operation
+  // "gather-write" to send the coalesced messages and the large
+  // messages in a single write operation
+  const std::vector<boost::asio::const_buffer> buffers =
+    writeQueue.front().Buffers();
   if (!_blocking)
   {
-    boost::asio::async_write(*this->socket,
-        boost::asio::buffer(this->writeQueue.front().c_str(),
-          this->writeQueue.front().size()),
+    boost::asio::async_write(*this->socket, buffers,
           common::weakBind(&Connection::OnWrite, this->shared_from_this(),
             boost::asio::placeholders::error));
   }
@@ -369,9 +557,9 @@ void Connection::ProcessWriteQueue(bool _blocking)
   {
     try
     {
-      boost::asio::write(*this->socket,
-          boost::asio::buffer(this->writeQueue.front().c_str(),
-            this->writeQueue.front().size()));
+      boost::asio::write(*this->socket, buffers);
+      iomanager->AddBytesWritten(this->ConnectionData()->ioIndex,
+          writeQueue.front().size);
     }
     catch(...)
     {
@@ -397,26 +585,98 @@ std::string Connection::GetRemoteURI() const
 //////////////////////////////////////////////////
 void Connection::PostWrite()
 {
+  ConnectionPrivate *data = this->ConnectionData();
+
   // Call the callbacks, if not NULL
   if (!this->callbacks.empty())
   {
+    data->outgoingCount -= this->callbacks.front().size();
     for (auto const &callback : this->callbacks.front())
       if (!callback.first.empty())
         callback.first(callback.second);
     this->callbacks.pop_front();
   }
 
-  if (!this->writeQueue.empty())
-    this->writeQueue.pop_front();
+  if (!data->writeQueue.empty())
+  {
+    data->outgoingBytes -= data->writeQueue.front().size;
+    data->writeQueue.pop_front();
+  }
   this->writeCount--;
 }
 
+//////////////////////////////////////////////////
+std::vector<boost::asio::const_buffer>
+ConnectionPrivate::WriteBatch::Buffers() const
+{
+  std::vector<boost::asio::const_buffer> result;
+  for (const Chunk &chunk : this->chunks)
+  {
+    if (chunk.msg)
+    {
+      result.push_back(boost::asio::buffer(chunk.msg->Header()));
+      result.push_back(boost::asio::buffer(chunk.msg->Data()));
+    }
+    else
+      result.push_back(boost::asio::buffer(chunk.bytes));
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+unsigned int Connection::GetOutgoingCount() const
+{
+  return this->ConnectionData()->outgoingCount;
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::GetOutgoingBytes() const
+{
+  return this->ConnectionData()->outgoingBytes;
+}
+
+//////////////////////////////////////////////////
+std::string &Connection::InboundData()
+{
+  return this->ConnectionData()->inboundData;
+}
+
+//////////////////////////////////////////////////
+void Connection::CountBytesRead(const size_t _bytes)
+{
+  if (iomanager)
+    iomanager->AddBytesRead(this->ConnectionData()->ioIndex, _bytes);
+}
+
+//////////////////////////////////////////////////
+void Connection::GetIOStatistics(std::vector<uint64_t> &_bytesRead,
+    std::vector<uint64_t> &_bytesWritten)
+{
+  _bytesRead.clear();
+  _bytesWritten.clear();
+  if (!iomanager)
+    return;
+
+  for (unsigned int i = 0; i < iomanager->ThreadCount(); ++i)
+  {
+    _bytesRead.push_back(iomanager->BytesRead(i));
+    _bytesWritten.push_back(iomanager->BytesWritten(i));
+  }
+}
+
 //////////////////////////////////////////////////
 void Connection::OnWrite(const boost::system::error_code &_e)
 {
   {
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
+    const std::deque<ConnectionPrivate::WriteBatch> &writeQueue =
+      this->ConnectionData()->writeQueue;
+    if (!_e && !writeQueue.empty())
+    {
+      iomanager->AddBytesWritten(this->ConnectionData()->ioIndex,
+          writeQueue.front().size);
+    }
     this->PostWrite();
   }
 
@@ -487,9 +747,12 @@ void Connection::Close()
     this->acceptor = NULL;
   }
 
+  ConnectionPrivate *data = this->ConnectionData();
   boost::recursive_mutex::scoped_lock lock2(this->writeMutex);
-  this->writeQueue.clear();
+  data->writeQueue.clear();
   this->callbacks.clear();
+  data->outgoingCount = 0;
+  data->outgoingBytes = 0;
 }
 
 //////////////////////////////////////////////////
@@ -531,7 +794,6 @@ bool Connection::Read(std::string &data)
 {
   bool result = false;
   char header[HEADER_LENGTH];
-  std::vector<char> incoming;
 
   std::size_t incoming_size;
   boost::system::error_code error;
@@ -539,7 +801,7 @@ bool Connection::Read(std::string &data)
   boost::recursive_mutex::scoped_lock lock(this->readMutex);
 
   // First read the header
-  this->socket->read_some(boost::asio::buffer(header), error);
+  boost::asio::read(*this->socket, boost::asio::buffer(header), error);
 
   if (error)
   {
@@ -551,13 +813,14 @@ bool Connection::Read(std::string &data)
   incoming_size = this->ParseHeader(std::string(header, HEADER_LENGTH));
   if (incoming_size > 0)
   {
-    incoming.resize(incoming_size);
+    // Read directly in the caller's buffer, which keeps its capacity
+    data.resize(incoming_size);
 
     std::size_t len = 0;
     do
     {
       // Read in the actual data
-      len += this->socket->read_some(boost::asio::buffer(&incoming[len],
+      len += this->socket->read_some(boost::asio::buffer(&data[len],
             incoming_size - len), error);
     } while (len < incoming_size && !error && !this->readQuit);
 
@@ -565,12 +828,13 @@ bool Connection::Read(std::string &data)
     {
       gzerr << "Did not read everying. Read[" << len
         << "] Needed[" << incoming_size << "]\n";
+      data.resize(len);
     }
 
     if (error)
       throw boost::system::system_error(error);
 
-    data = std::string(&incoming[0], incoming.size());
+    this->CountBytesRead(HEADER_LENGTH + len);
     result = true;
   }
 
@@ -688,7 +952,7 @@ boost::asio::ip::tcp::endpoint Connection::GetLocalEndpoint()
   // First try GAZEBO_HOSTNAME if it is set.
   if (hostname && !std::string(hostname).empty())
   {
-    boost::asio::ip::tcp::resolver resolver(iomanager->GetIO());
+    boost::asio::ip::tcp::resolver resolver(iomanager->GetIO(0));
     boost::asio::ip::tcp::resolver::query query(hostname, "");
     boost::asio::ip::tcp::resolver::iterator iter = resolver.resolve(query);
     boost::asio::ip::tcp::resolver::iterator end;
@@ -921,7 +1185,7 @@ std::string Connection::GetHostname(boost::asio::ip::tcp::endpoint _ep)
   // Otherwise perform a lookup
   else
   {
-    boost::asio::ip::tcp::resolver resolver(iomanager->GetIO());
+    boost::asio::ip::tcp::resolver resolver(iomanager->GetIO(0));
     boost::asio::ip::tcp::resolver::iterator iter = resolver.resolve(_ep);
     boost::asio::ip::tcp::resolver::iterator end;
 
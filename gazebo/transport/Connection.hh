@@ -37,6 +37,7 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/WeakBind.hh"
+#include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/util/system.hh"
 
 #define HEADER_LENGTH 8
@@ -49,6 +50,7 @@ namespace gazebo
 
     class IOManager;
     class Connection;
+    class ConnectionPrivate;
     typedef boost::shared_ptr<Connection> ConnectionPtr;
 
     /// \cond
@@ -59,13 +61,14 @@ namespace gazebo
       /// \brief Constructor
       /// \param[_in] _func Boost function pointer, which is the function
       /// that receives the data.
-      /// \param[in] _data Data to send to the boost function pointer.
+      /// \param[in] _data Data to send to the boost function pointer,
+      /// returned to the receive buffers once the function returns.
       public: ConnectionReadTask(
                   boost::function<void (const std::string &)> _func,
-                  const std::string &_data) :
-                func(_func),
-                data(_data)
+                  std::string _data) :
+                func(_func)
               {
+                this->data.swap(_data);
               }
 
       /// \bried Overridden function from tbb::task that exectues the data
@@ -73,9 +76,20 @@ namespace gazebo
       public: tbb::task *execute()
               {
                 this->func(this->data);
+                ReleaseBuffer(this->data);
                 return NULL;
               }
 
+      /// \brief Get a receive buffer. Buffers are reused, so that their
+      /// capacity grows to the size of the largest messages and reading a
+      /// message doesn't allocate memory.
+      /// \return An empty buffer.
+      public: static std::string AcquireBuffer();
+
+      /// \brief Give a receive buffer back.
+      /// \param[in,out] _buffer The buffer, left empty.
+      public: static void ReleaseBuffer(std::string &_buffer);
+
       /// \brief The boost function pointer
       private: boost::function<void (const std::string &)> func;
 
@@ -168,6 +182,19 @@ namespace gazebo
       /// to the socket, otherwise just enqueue the data for asynchronous write
       public: void EnqueueMsg(const std::string &_buffer, bool _force = false);
 
+      /// \brief Write a message to the socket, using its serialized data
+      /// and header, which are shared with other connections. Large
+      /// messages are written from the shared data, without a copy.
+      /// \param[in] _msg Message to write
+      /// \param[in] _cb If non-null, callback to be invoked after
+      /// transmission is complete.
+      /// \param[in] _id ID associated with the message data.
+      /// \param[in] _force If true, block until the data has been written
+      /// to the socket, otherwise just enqueue the data for asynchronous write
+      public: void EnqueueMsg(const EncodedMessagePtr &_msg,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id,
+                  bool _force = false);
+
       /// \brief Get the local URI
       /// \return The local URI
       public: std::string GetLocalURI() const;
@@ -251,14 +278,17 @@ namespace gazebo
                  if (inboundData_size > 0)
                   {
                     // Start the asynchronous call to receive data
-                    this->inboundData.resize(inboundData_size);
+                    std::string &inboundData = this->InboundData();
+                    inboundData = ConnectionReadTask::AcquireBuffer();
+                    inboundData.resize(inboundData_size);
 
                     void (Connection::*f)(const boost::system::error_code &e,
                         boost::tuple<Handler>) =
                       &Connection::OnReadData<Handler>;
 
                     boost::asio::async_read(*this->socket,
-                        boost::asio::buffer(this->inboundData),
+                        boost::asio::buffer(&inboundData[0],
+                          inboundData_size),
                         common::weakBind(f, this->shared_from_this(),
                                     boost::asio::placeholders::error,
                                     _handler));
@@ -300,10 +330,12 @@ namespace gazebo
                     this->isOpen = false;
                 }
 
-                // Inform caller that data has been received
-                std::string data(&this->inboundData[0],
-                                  this->inboundData.size());
-                this->inboundData.clear();
+                // Inform caller that data has been received. The task takes
+                // the buffer, without a copy.
+                std::string data;
+                data.swap(this->InboundData());
+                if (!_e)
+                  this->CountBytesRead(HEADER_LENGTH + data.size());
 
                 if (data.empty())
                   gzerr << "OnReadData got empty data!!!\n";
@@ -311,12 +343,15 @@ namespace gazebo
                 if (!_e && !transport::is_stopped())
                 {
                   ConnectionReadTask *task = new(tbb::task::allocate_root())
-                        ConnectionReadTask(boost::get<0>(_handler), data);
+                        ConnectionReadTask(boost::get<0>(_handler),
+                            std::move(data));
                   tbb::task::enqueue(*task);
 
                   // Non-tbb version:
                   // boost::get<0>(_handler)(data);
                 }
+                else
+                  ConnectionReadTask::ReleaseBuffer(data);
               }
 
       /// \brief Register a function to be called when the connection is shut
@@ -329,6 +364,23 @@ namespace gazebo
       /// \brief Handle on-write callbacks
       public: void ProcessWriteQueue(bool _blocking = false);
 
+      /// \brief Get the throughput of the IO threads, see
+      /// transport::setIOThreadCount.
+      /// \param[out] _bytesRead Bytes read by each thread.
+      /// \param[out] _bytesWritten Bytes written by each thread.
+      public: static void GetIOStatistics(std::vector<uint64_t> &_bytesRead,
+                  std::vector<uint64_t> &_bytesWritten);
+
+      /// \brief Get the number of messages queued for writing, including
+      /// the ones being written.
+      /// \return Number of messages.
+      public: unsigned int GetOutgoingCount() const;
+
+      /// \brief Get the number of bytes queued for writing, including the
+      /// ones being written.
+      /// \return Number of bytes, headers included.
+      public: uint64_t GetOutgoingBytes() const;
+
       /// \brief Get the ID of the connection.
       /// \return The connection's unique ID.
       public: unsigned int GetId() const;
@@ -347,6 +399,33 @@ namespace gazebo
       /// Called afer a write is finished.
       private: void PostWrite();
 
+      /// \brief Add to the bytes read by the IO thread of the connection.
+      /// \param[in] _bytes Number of bytes.
+      private: void CountBytesRead(const size_t _bytes);
+
+      /// \brief Get the buffer of the message being read.
+      /// \return The content data of the message.
+      private: std::string &InboundData();
+
+      /// \brief Append a header and its data to the write queue.
+      /// \param[in] _header Header of the data.
+      /// \param[in] _buffer Data to write.
+      /// \param[in] _msg Message that owns the header and the data, null
+      /// if they must be copied.
+      /// \param[in] _cb Callback to be invoked after transmission.
+      /// \param[in] _id ID associated with the message data.
+      /// \param[in] _force If true, block until the data has been written.
+      private: void EnqueueFrame(const char *_header,
+                   const std::string &_buffer, const EncodedMessagePtr &_msg,
+                   boost::function<void(uint32_t)> _cb, uint32_t _id,
+                   bool _force);
+
+      /// \internal
+      /// \brief Get the private data of this connection. It is kept out of
+      /// the class so that its layout doesn't change.
+      /// \return The private data.
+      private: ConnectionPrivate *ConnectionData() const;
+
       /// \brief Callback when a write has occurred.
       /// \param[in] _e Error code
       /// \param[in] _b Buffer of the data that was written.
@@ -388,7 +467,8 @@ namespace gazebo
       /// \brief Accepts new connections.
       private: boost::asio::ip::tcp::acceptor *acceptor;
 
-      /// \brief Outgoing data queue
+      /// \brief Unused, the outgoing data is queued in the private data,
+      /// see ConnectionData.
       private: std::deque<std::string> writeQueue;
 
       /// \brief List of callbacks, paired with writeQueue. The callbacks
@@ -418,7 +498,8 @@ namespace gazebo
       /// \brief Header data from a new message.
       private: std::vector<char> inboundHeader;
 
-      /// \brief Content data from a new message.
+      /// \brief Unused, the content data is read into the private data,
+      /// see InboundData.
       private: std::vector<char> inboundData;
 
       /// \brief Set to true to stop reading on the connection.
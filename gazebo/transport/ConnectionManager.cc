@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <map>
+#include <string>
 #include <boost/bind.hpp>
 
 #include "gazebo/msgs/msgs.hh"
@@ -27,6 +29,10 @@
 using namespace gazebo;
 using namespace transport;
 
+/// \brief Suffix of the type of a message from the master that holds
+/// several notifications of the same type.
+static const std::string BATCH_SUFFIX = "_batch";
+
 /// TBB task to process nodes.
 class TopicManagerProcessTask : public tbb::task
 {
@@ -38,22 +44,23 @@ class TopicManagerProcessTask : public tbb::task
           }
 };
 
-/// TBB task to establish subscriber to publisher connection.
+/// TBB task to establish subscriber to publisher connections.
 class TopicManagerConnectionTask : public tbb::task
 {
   /// \brief Constructor.
-  /// \param[in] _pub Publish message
-  public: explicit TopicManagerConnectionTask(msgs::Publish _pub) : pub(_pub) {}
+  /// \param[in] _pubs Publish messages, of one remote host and port.
+  public: explicit TopicManagerConnectionTask(msgs::Publishers _pubs)
+          : pubs(_pubs) {}
 
   /// Implements the necessary execute function
   public: tbb::task *execute()
           {
-            TopicManager::Instance()->ConnectSubToPub(pub);
+            TopicManager::Instance()->ConnectSubToPubs(pubs);
             return NULL;
           }
 
-  /// \brief Publish message
-  private: msgs::Publish pub;
+  /// \brief Publish messages
+  private: msgs::Publishers pubs;
 };
 
 //////////////////////////////////////////////////
@@ -186,6 +193,11 @@ bool ConnectionManager::Init(const std::string &_masterHost,
   else
     gzerr << "Did not get publishers_init msg from master" << std::endl;
 
+  // Tell the master that "<type>_batch" notifications are handled
+  msgs::Request *batchReq = msgs::CreateRequest("publisher_batches");
+  this->masterConn->EnqueueMsg(msgs::Package("request", *batchReq), true);
+  delete batchReq;
+
   this->masterConn->AsyncRead(
       boost::bind(&ConnectionManager::OnMasterRead, this, _1));
 
@@ -349,29 +361,47 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
   msgs::Packet packet;
   packet.ParseFromString(_data);
 
-  if (packet.type() == "publisher_add")
+  // The master sends the notifications of the same type together as
+  // "<type>_batch" messages
+  msgs::Publishers batch;
+  std::string type = packet.type();
+  if (type.size() > BATCH_SUFFIX.size() &&
+      type.compare(type.size() - BATCH_SUFFIX.size(), BATCH_SUFFIX.size(),
+        BATCH_SUFFIX) == 0)
   {
-    msgs::Publish result;
-    result.ParseFromString(packet.serialized_data());
-    this->publishers.push_back(result);
+    type.erase(type.size() - BATCH_SUFFIX.size());
+    batch.ParseFromString(packet.serialized_data());
   }
-  else if (packet.type() == "publisher_del")
+  else if (type == "publisher_add" || type == "publisher_del" ||
+           type == "publisher_advertise" || type == "publisher_subscribe")
   {
-    msgs::Publish result;
-    result.ParseFromString(packet.serialized_data());
+    batch.add_publisher()->ParseFromString(packet.serialized_data());
+  }
 
-    std::list<msgs::Publish>::iterator iter = this->publishers.begin();
-    while (iter != this->publishers.end())
+  if (type == "publisher_add")
+  {
+    for (int i = 0; i < batch.publisher_size(); ++i)
+      this->publishers.push_back(batch.publisher(i));
+  }
+  else if (type == "publisher_del")
+  {
+    for (int i = 0; i < batch.publisher_size(); ++i)
     {
-      if ((*iter).topic() == result.topic() &&
-          (*iter).host() == result.host() &&
-          (*iter).port() == result.port())
-        iter = this->publishers.erase(iter);
-      else
-        ++iter;
+      const msgs::Publish &result = batch.publisher(i);
+
+      std::list<msgs::Publish>::iterator iter = this->publishers.begin();
+      while (iter != this->publishers.end())
+      {
+        if ((*iter).topic() == result.topic() &&
+            (*iter).host() == result.host() &&
+            (*iter).port() == result.port())
+          iter = this->publishers.erase(iter);
+        else
+          ++iter;
+      }
     }
   }
-  else if (packet.type() == "topic_namespace_add")
+  else if (type == "topic_namespace_add")
   {
     msgs::GzString result;
     result.ParseFromString(packet.serialized_data());
@@ -385,7 +415,7 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
   // as a workaround to address transport blocking issue when gzclient connects
   // to gzserver, see issue #714. "publisher_advertise", intended
   // for gzserver when gzclient connects, is parallelized and made non-blocking.
-  else if (packet.type() == "publisher_update")
+  else if (type == "publisher_update")
   {
     msgs::Publish pub;
     pub.ParseFromString(packet.serialized_data());
@@ -395,32 +425,26 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
       TopicManager::Instance()->ConnectSubToPub(pub);
     }
   }
-  else if (packet.type() == "publisher_advertise")
+  else if (type == "publisher_advertise")
   {
-    msgs::Publish pub;
-    pub.ParseFromString(packet.serialized_data());
-    if (pub.host() != this->serverConn->GetLocalAddress() ||
-        pub.port() != this->serverConn->GetLocalPort())
+    // One task per remote host, so that an unreachable host only delays
+    // its own topics
+    for (auto const &peer : this->RemotePublishers(batch))
     {
       TopicManagerConnectionTask *task = new(tbb::task::allocate_root())
-      TopicManagerConnectionTask(pub);
+      TopicManagerConnectionTask(peer.second);
       tbb::task::enqueue(*task);
     }
   }
   // publisher_subscribe. This occurs when we try to subscribe to a topic, and
   // the master informs us of a remote host that is publishing on our
   // requested topic
-  else if (packet.type() == "publisher_subscribe")
+  else if (type == "publisher_subscribe")
   {
-    msgs::Publish pub;
-    pub.ParseFromString(packet.serialized_data());
-    if (pub.host() != this->serverConn->GetLocalAddress() ||
-        pub.port() != this->serverConn->GetLocalPort())
-    {
-      TopicManager::Instance()->ConnectSubToPub(pub);
-    }
+    for (auto const &peer : this->RemotePublishers(batch))
+      TopicManager::Instance()->ConnectSubToPubs(peer.second);
   }
-  else if (packet.type() == "unsubscribe")
+  else if (type == "unsubscribe")
   {
     msgs::Subscribe sub;
     sub.ParseFromString(packet.serialized_data());
@@ -429,7 +453,7 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
     TopicManager::Instance()->DisconnectPubFromSub(sub.topic(),
         sub.host(), sub.port());
   }
-  else if (packet.type() == "unadvertise")
+  else if (type == "unadvertise")
   {
     msgs::Publish pub;
     pub.ParseFromString(packet.serialized_data());
@@ -446,6 +470,24 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
   }
 }
 
+/////////////////////////////////////////////////
+std::map<std::string, msgs::Publishers> ConnectionManager::RemotePublishers(
+    const msgs::Publishers &_pubs) const
+{
+  std::map<std::string, msgs::Publishers> result;
+  for (int i = 0; i < _pubs.publisher_size(); ++i)
+  {
+    const msgs::Publish &pub = _pubs.publisher(i);
+    if (pub.host() != this->serverConn->GetLocalAddress() ||
+        pub.port() != this->serverConn->GetLocalPort())
+    {
+      std::string peer = pub.host() + ":" + std::to_string(pub.port());
+      result[peer].add_publisher()->CopyFrom(pub);
+    }
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////
 void ConnectionManager::OnAccept(ConnectionPtr _newConnection)
 {
@@ -481,7 +523,10 @@ void ConnectionManager::OnRead(ConnectionPtr _connection,
     // Create a transport link for the publisher to the remote subscriber
     // via the connection
     SubscriptionTransportPtr subLink(new SubscriptionTransport());
-    subLink->Init(_connection, sub.latching());
+    subLink->Init(_connection, sub.latching(), sub.shm_name(),
+        sub.shm_channel());
+    subLink->SetDeliveryLimits(sub.max_rate(), sub.latest_only());
+    subLink->SetCodec(sub.codec());
 
     // Connect the publisher to this transport mechanism
     TopicManager::Instance()->ConnectPubToSub(sub.topic(), subLink);
@@ -22,6 +22,7 @@
 #include <boost/interprocess/sync/interprocess_semaphore.hpp>
 #include <string>
 #include <list>
+#include <map>
 #include <vector>
 
 #include "gazebo/msgs/msgs.hh"
@@ -161,6 +162,12 @@ namespace gazebo
       /// \param[in] _packet The raw message data.
       private: void ProcessMessage(const std::string &_packet);
 
+      /// \brief Group the publishers on other hosts by host and port.
+      /// \param[in] _pubs Publishers from the master.
+      /// \return The publishers not in this process, by "host:port".
+      private: std::map<std::string, msgs::Publishers> RemotePublishers(
+                   const msgs::Publishers &_pubs) const;
+
       /// \brief Run the manager update loop once
       private: void RunUpdate();
 
@@ -17,9 +17,15 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 #include <stdlib.h>
+#include <boost/thread/mutex.hpp>
 
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/EncodedMessage.hh"
+#include "gazebo/transport/TransportIface.hh"
 #include "test/util.hh"
 
 using namespace gazebo;
@@ -64,6 +70,87 @@ TEST_F(Connection, IPWhiteList)
     setenv("GAZEBO_IP_WHITE_LIST", ipEnv, 1);
 }
 
+/////////////////////////////////////////////////
+TEST_F(Connection, EnqueueEncoded)
+{
+  boost::mutex mutex;
+  transport::ConnectionPtr accepted;
+  transport::ConnectionPtr server(new transport::Connection());
+  server->Listen(0, [&](const transport::ConnectionPtr &_conn)
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        accepted = _conn;
+      });
+
+  transport::ConnectionPtr client(new transport::Connection());
+  ASSERT_TRUE(client->Connect("127.0.0.1", server->GetLocalPort()));
+
+  transport::ConnectionPtr conn;
+  for (int i = 0; i < 500 && !conn; ++i)
+  {
+    common::Time::MSleep(10);
+    boost::mutex::scoped_lock lock(mutex);
+    conn = accepted;
+  }
+  ASSERT_TRUE(conn != NULL);
+
+  // A large message written from its shared data, between small messages
+  // that are copied
+  boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+  msg->set_data(std::string(100000, 'x'));
+  transport::EncodedMessagePtr large(new transport::EncodedMessage(msg));
+  msg.reset(new msgs::GzString);
+  msg->set_data("small");
+  transport::EncodedMessagePtr small(new transport::EncodedMessage(msg));
+
+  client->EnqueueMsg(std::string("first"), true);
+  client->EnqueueMsg(large, NULL, 0, true);
+  client->EnqueueMsg(small, NULL, 0, true);
+
+  std::string data;
+  EXPECT_TRUE(conn->Read(data));
+  EXPECT_EQ(data, "first");
+  EXPECT_TRUE(conn->Read(data));
+  EXPECT_EQ(data, large->Data());
+  EXPECT_TRUE(conn->Read(data));
+  EXPECT_EQ(data, small->Data());
+
+  // Both ends are counted by the IO threads
+  std::vector<uint64_t> bytesRead, bytesWritten;
+  transport::Connection::GetIOStatistics(bytesRead, bytesWritten);
+  ASSERT_EQ(bytesRead.size(), transport::getIOThreadCount());
+  ASSERT_EQ(bytesWritten.size(), bytesRead.size());
+  uint64_t totalRead = 0, totalWritten = 0;
+  for (size_t i = 0; i < bytesRead.size(); ++i)
+  {
+    totalRead += bytesRead[i];
+    totalWritten += bytesWritten[i];
+  }
+  EXPECT_GE(totalRead, large->Data().size());
+  EXPECT_GE(totalWritten, large->Data().size());
+
+  client->Shutdown();
+  conn->Shutdown();
+  server->Shutdown();
+}
+
+/////////////////////////////////////////////////
+TEST_F(Connection, ReceiveBuffers)
+{
+  // Released buffers are reused with their capacity
+  std::string buffer = transport::ConnectionReadTask::AcquireBuffer();
+  EXPECT_TRUE(buffer.empty());
+  buffer.resize(100000);
+  transport::ConnectionReadTask::ReleaseBuffer(buffer);
+  EXPECT_TRUE(buffer.empty());
+
+  buffer = transport::ConnectionReadTask::AcquireBuffer();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_GE(buffer.capacity(), 100000u);
+  transport::ConnectionReadTask::ReleaseBuffer(buffer);
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <cstdio>
+#include <mutex>
+
+#include "gazebo/common/MemoryAccounting.hh"
+#include "gazebo/common/Timestamp.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/EncodedMessage.hh"
+#include "gazebo/transport/TopicStatistics.hh"
+
+namespace gazebo
+{
+namespace transport
+{
+/////////////////////////////////////////////////
+class EncodedMessagePrivate
+{
+  /// \brief The message.
+  public: MessagePtr msg;
+
+  /// \brief The serialized message, set once.
+  public: std::string data;
+
+  /// \brief Connection header of the serialized message, set once.
+  public: std::string header;
+
+  /// \brief Guards the serialization.
+  public: std::once_flag dataOnce;
+
+  /// \brief Guards the header.
+  public: std::once_flag headerOnce;
+
+  /// \brief Stats of the topic, null if none.
+  public: TopicStats *stats = nullptr;
+
+  /// \brief Publication time in nanoseconds.
+  public: int64_t publishTime = 0;
+
+  /// \brief Memory of the serialized message, counted until the last
+  /// queue or connection releases it.
+  public: common::MemoryAccounting::Account memory{
+              common::MemoryAccounting::TRANSPORT};
+};
+}
+}
+
+using namespace gazebo;
+using namespace transport;
+
+/////////////////////////////////////////////////
+EncodedMessage::EncodedMessage(MessagePtr _msg, TopicStats *_stats)
+  : dataPtr(new EncodedMessagePrivate)
+{
+  this->dataPtr->msg = _msg;
+  this->dataPtr->stats = _stats;
+  this->dataPtr->publishTime = common::Timestamp::Now().Nanoseconds();
+}
+
+/////////////////////////////////////////////////
+EncodedMessage::~EncodedMessage()
+{
+}
+
+/////////////////////////////////////////////////
+MessagePtr EncodedMessage::Message() const
+{
+  return this->dataPtr->msg;
+}
+
+/////////////////////////////////////////////////
+const std::string &EncodedMessage::Data() const
+{
+  std::call_once(this->dataPtr->dataOnce, [this]()
+      {
+        if (this->dataPtr->msg)
+        {
+          const common::Timestamp start = common::Timestamp::Now();
+          this->dataPtr->msg->SerializeToString(&this->dataPtr->data);
+          if (this->dataPtr->stats)
+          {
+            this->dataPtr->stats->RecordSerialization(
+                (common::Timestamp::Now() - start).Nanoseconds());
+          }
+          this->dataPtr->memory.Set(this->dataPtr->data.capacity());
+        }
+      });
+  return this->dataPtr->data;
+}
+
+/////////////////////////////////////////////////
+const std::string &EncodedMessage::Header() const
+{
+  std::call_once(this->dataPtr->headerOnce, [this]()
+      {
+        char headerBuffer[HEADER_LENGTH + 1];
+        snprintf(headerBuffer, HEADER_LENGTH + 1, "%08x",
+            static_cast<unsigned int>(this->Data().size()));
+        this->dataPtr->header = headerBuffer;
+      });
+  return this->dataPtr->header;
+}
+
+/////////////////////////////////////////////////
+int64_t EncodedMessage::PublishTime() const
+{
+  return this->dataPtr->publishTime;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_ENCODEDMESSAGE_HH_
+#define GAZEBO_TRANSPORT_ENCODEDMESSAGE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private class.
+    class EncodedMessagePrivate;
+    class TopicStats;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class EncodedMessage EncodedMessage.hh transport/transport.hh
+    /// \brief A published message, shared by all the subscribers of a
+    /// topic. The message is serialized the first time a subscriber needs
+    /// the serialized data, and only once.
+    ///
+    /// The message must not be modified once it is wrapped. All the
+    /// functions are thread safe.
+    class GZ_TRANSPORT_VISIBLE EncodedMessage
+    {
+      /// \brief Constructor, which also sets the publication time.
+      /// \param[in] _msg The message.
+      /// \param[in] _stats Stats of the topic the message is published
+      /// on, to add the serialization time to, null if none.
+      public: explicit EncodedMessage(MessagePtr _msg,
+                  TopicStats *_stats = nullptr);
+
+      /// \brief Destructor.
+      public: ~EncodedMessage();
+
+      /// \brief Get the message.
+      /// \return The message, which must not be modified.
+      public: MessagePtr Message() const;
+
+      /// \brief Get the serialized message, serializing it if needed.
+      /// \return The serialized message.
+      public: const std::string &Data() const;
+
+      /// \brief Get the header that precedes the serialized message on a
+      /// Connection, see HEADER_LENGTH.
+      /// \return The header.
+      public: const std::string &Header() const;
+
+      /// \brief Get the time the message was published, measured with
+      /// common::Timestamp::Now.
+      /// \return Time in nanoseconds.
+      public: int64_t PublishTime() const;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<EncodedMessagePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/EncodedMessage.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class EncodedMessage : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(EncodedMessage, Data)
+{
+  boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+  msg->set_data(std::string(1000, 'x'));
+  std::string expected;
+  msg->SerializeToString(&expected);
+
+  transport::EncodedMessage encoded(msg);
+  EXPECT_EQ(encoded.Message(), msg);
+  EXPECT_EQ(encoded.Data(), expected);
+
+  // Serialized once, the same data is returned by every call
+  EXPECT_EQ(&encoded.Data(), &encoded.Data());
+
+  char header[HEADER_LENGTH + 1];
+  snprintf(header, HEADER_LENGTH + 1, "%08x",
+      static_cast<unsigned int>(expected.size()));
+  EXPECT_EQ(encoded.Header(), std::string(header));
+}
+
+/////////////////////////////////////////////////
+TEST_F(EncodedMessage, Threads)
+{
+  boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+  msg->set_data("threads");
+  std::string expected;
+  msg->SerializeToString(&expected);
+
+  transport::EncodedMessage encoded(msg);
+  std::vector<const std::string *> data(8, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    threads.push_back(std::thread([&encoded, &data, i]()
+        {
+          data[i] = &encoded.Data();
+        }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (const std::string *d : data)
+  {
+    EXPECT_EQ(d, data[0]);
+    EXPECT_EQ(*d, expected);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(EncodedMessage, Empty)
+{
+  transport::EncodedMessage encoded((transport::MessagePtr()));
+  EXPECT_FALSE(encoded.Message());
+  EXPECT_TRUE(encoded.Data().empty());
+  EXPECT_EQ(encoded.Header(), std::string("00000000"));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
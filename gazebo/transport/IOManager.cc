@@ -14,7 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <atomic>
+#include <memory>
+#include <vector>
 #include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <iostream>
@@ -25,31 +28,53 @@ namespace gazebo
 namespace transport
 {
 /////////////////////////////////////////////////
-class IOManagerPrivate
+/// \brief An IO thread and its service.
+class IOThread
 {
   /// \brief IO service.
-  public: boost::asio::io_service *io_service = nullptr;
+  public: boost::asio::io_service io_service;
 
   /// \brief Use io_service::work to keep the io_service running in thread.
-  public: boost::asio::io_service::work *work = nullptr;
+  public: std::unique_ptr<boost::asio::io_service::work> work;
+
+  /// \brief Thread running the io_service.
+  public: std::unique_ptr<boost::thread> thread;
+
+  /// \brief Number of bytes read by the connections of the thread.
+  public: std::atomic<uint64_t> bytesRead{0};
+
+  /// \brief Number of bytes written by the connections of the thread.
+  public: std::atomic<uint64_t> bytesWritten{0};
+};
+
+/////////////////////////////////////////////////
+class IOManagerPrivate
+{
+  /// \brief IO threads.
+  public: std::vector<std::unique_ptr<IOThread>> threads;
+
+  /// \brief Index of the next thread given to a connection.
+  public: std::atomic_uint next;
 
   /// \brief Reference count of connections using this IOManager.
   public: std::atomic_int count;
-
-  /// \brief Thread for IOManager.
-  public: boost::thread *thread = nullptr;
 };
 
 /////////////////////////////////////////////////
-IOManager::IOManager()
+IOManager::IOManager(const unsigned int _threadCount)
   : dataPtr(new IOManagerPrivate)
 {
-  this->dataPtr->io_service = new boost::asio::io_service;
-  this->dataPtr->work = new boost::asio::io_service::work(
-      *this->dataPtr->io_service);
+  this->dataPtr->next = 0;
   this->dataPtr->count = 0;
-  this->dataPtr->thread = new boost::thread(boost::bind(
-      &boost::asio::io_service::run, this->dataPtr->io_service));
+  for (unsigned int i = 0; i < std::max(1u, _threadCount); ++i)
+  {
+    std::unique_ptr<IOThread> ioThread(new IOThread);
+    ioThread->work.reset(
+        new boost::asio::io_service::work(ioThread->io_service));
+    ioThread->thread.reset(new boost::thread(boost::bind(
+        &boost::asio::io_service::run, &ioThread->io_service)));
+    this->dataPtr->threads.push_back(std::move(ioThread));
+  }
 }
 
 /////////////////////////////////////////////////
@@ -57,12 +82,6 @@ IOManager::~IOManager()
 {
   this->Stop();
 
-  delete this->dataPtr->work;
-  this->dataPtr->work = nullptr;
-
-  delete this->dataPtr->io_service;
-  this->dataPtr->io_service = nullptr;
-
   delete this->dataPtr;
   this->dataPtr = nullptr;
 }
@@ -70,20 +89,76 @@ IOManager::~IOManager()
 /////////////////////////////////////////////////
 void IOManager::Stop()
 {
-  this->dataPtr->io_service->reset();
-  this->dataPtr->io_service->stop();
-  if (this->dataPtr->thread)
+  for (auto &ioThread : this->dataPtr->threads)
+  {
+    ioThread->io_service.reset();
+    ioThread->io_service.stop();
+  }
+
+  for (auto &ioThread : this->dataPtr->threads)
   {
-    this->dataPtr->thread->join();
-    delete this->dataPtr->thread;
-    this->dataPtr->thread = nullptr;
+    if (ioThread->thread)
+    {
+      ioThread->thread->join();
+      ioThread->thread.reset();
+    }
   }
 }
 
 /////////////////////////////////////////////////
 boost::asio::io_service &IOManager::GetIO()
 {
-  return *this->dataPtr->io_service;
+  return this->GetIO(this->NextIndex());
+}
+
+/////////////////////////////////////////////////
+boost::asio::io_service &IOManager::GetIO(const unsigned int _index)
+{
+  return this->dataPtr->threads[
+    _index % this->dataPtr->threads.size()]->io_service;
+}
+
+/////////////////////////////////////////////////
+unsigned int IOManager::NextIndex()
+{
+  return this->dataPtr->next++ % this->dataPtr->threads.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int IOManager::ThreadCount() const
+{
+  return this->dataPtr->threads.size();
+}
+
+/////////////////////////////////////////////////
+void IOManager::AddBytesRead(const unsigned int _index, const uint64_t _bytes)
+{
+  if (_index < this->dataPtr->threads.size())
+    this->dataPtr->threads[_index]->bytesRead += _bytes;
+}
+
+/////////////////////////////////////////////////
+void IOManager::AddBytesWritten(const unsigned int _index,
+    const uint64_t _bytes)
+{
+  if (_index < this->dataPtr->threads.size())
+    this->dataPtr->threads[_index]->bytesWritten += _bytes;
+}
+
+/////////////////////////////////////////////////
+uint64_t IOManager::BytesRead(const unsigned int _index) const
+{
+  if (_index < this->dataPtr->threads.size())
+    return this->dataPtr->threads[_index]->bytesRead;
+  return 0;
+}
+
+/////////////////////////////////////////////////
+uint64_t IOManager::BytesWritten(const unsigned int _index) const
+{
+  if (_index < this->dataPtr->threads.size())
+    return this->dataPtr->threads[_index]->bytesWritten;
+  return 0;
 }
 
 /////////////////////////////////////////////////
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_TRANSPORT_IOMANAGER_HH_
 #define GAZEBO_TRANSPORT_IOMANAGER_HH_
 
+#include <cstdint>
 #include <boost/asio.hpp>
 #include "gazebo/util/system.hh"
 
@@ -32,18 +33,59 @@ namespace gazebo
 
     /// \class IOManager IOManager.hh transport/transport.hh
     /// \brief Manages boost::asio IO
+    ///
+    /// IO is handled by a pool of threads, each running its own
+    /// io_service. Connections are assigned to the threads round-robin,
+    /// so that the handlers of a connection always run on the same thread.
     class GZ_TRANSPORT_VISIBLE IOManager
     {
       /// \brief Constructor
-      public: IOManager();
+      /// \param[in] _threadCount Number of IO threads, at least 1.
+      public: explicit IOManager(const unsigned int _threadCount = 1);
 
       /// \brief Destructor
       public: ~IOManager();
 
-      /// \brief Get handle to boost::asio IO service
+      /// \brief Get handle to boost::asio IO service of the next thread,
+      /// round-robin.
       /// \return Handle to boost::asio IO service
       public: boost::asio::io_service &GetIO();
 
+      /// \brief Get handle to boost::asio IO service of a thread.
+      /// \param[in] _index Index of the thread, see NextIndex.
+      /// \return Handle to boost::asio IO service
+      public: boost::asio::io_service &GetIO(const unsigned int _index);
+
+      /// \brief Get the index of the next thread, round-robin.
+      /// \return Index of the thread.
+      public: unsigned int NextIndex();
+
+      /// \brief Get the number of IO threads.
+      /// \return Number of threads.
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Count bytes read by a thread.
+      /// \param[in] _index Index of the thread.
+      /// \param[in] _bytes Number of bytes.
+      public: void AddBytesRead(const unsigned int _index,
+                  const uint64_t _bytes);
+
+      /// \brief Count bytes written by a thread.
+      /// \param[in] _index Index of the thread.
+      /// \param[in] _bytes Number of bytes.
+      public: void AddBytesWritten(const unsigned int _index,
+                  const uint64_t _bytes);
+
+      /// \brief Get the number of bytes read by a thread.
+      /// \param[in] _index Index of the thread.
+      /// \return Number of bytes, 0 for an invalid index.
+      public: uint64_t BytesRead(const unsigned int _index) const;
+
+      /// \brief Get the number of bytes written by a thread.
+      /// \param[in] _index Index of the thread.
+      /// \return Number of bytes, 0 for an invalid index.
+      public: uint64_t BytesWritten(const unsigned int _index) const;
+
       /// \brief Increment the event count by 1
       public: void IncCount();
 
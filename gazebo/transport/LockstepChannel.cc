@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstring>
+#include <new>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/LockstepChannel.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace ipc = boost::interprocess;
+
+/// \brief Beginning of a segment, followed by the state buffer and the
+/// command buffer.
+class LockstepHeader
+{
+  /// \brief Protects the other fields and the buffers.
+  public: ipc::interprocess_mutex mutex;
+
+  /// \brief Notified when a state or a command is written, or a side
+  /// leaves.
+  public: ipc::interprocess_condition changed;
+
+  /// \brief Size of the state buffer in bytes.
+  public: uint64_t stateCapacity = 0;
+
+  /// \brief Size of the command buffer in bytes.
+  public: uint64_t commandCapacity = 0;
+
+  /// \brief Step of the state in the buffer, 0 if none.
+  public: uint64_t stateStep = 0;
+
+  /// \brief Step of the command in the buffer, 0 if none.
+  public: uint64_t commandStep = 0;
+
+  /// \brief Size of the state in the buffer.
+  public: uint64_t stateSize = 0;
+
+  /// \brief Size of the command in the buffer.
+  public: uint64_t commandSize = 0;
+
+  /// \brief True while a client is connected.
+  public: bool client = false;
+
+  /// \brief True once the server closed the channel.
+  public: bool closed = false;
+};
+
+namespace gazebo
+{
+namespace transport
+{
+/////////////////////////////////////////////////
+class LockstepChannelPrivate
+{
+  /// \brief Name of the segment.
+  public: std::string name;
+
+  /// \brief Mapping of the segment.
+  public: ipc::mapped_region region;
+
+  /// \brief Header at the beginning of the segment.
+  public: LockstepHeader *header = nullptr;
+
+  /// \brief State buffer, after the header.
+  public: char *state = nullptr;
+
+  /// \brief Command buffer, after the state buffer.
+  public: char *command = nullptr;
+
+  /// \brief Step of the last state read by the client.
+  public: uint64_t lastStep = 0;
+
+  /// \brief True if the segment was created by this object.
+  public: bool owner = false;
+};
+}
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the deadline of a wait.
+/// \param[in] _timeoutMs Timeout in milliseconds.
+/// \return The deadline.
+static boost::posix_time::ptime Deadline(const unsigned int _timeoutMs)
+{
+  return boost::posix_time::microsec_clock::universal_time() +
+    boost::posix_time::milliseconds(_timeoutMs);
+}
+
+/////////////////////////////////////////////////
+LockstepChannel::LockstepChannel()
+  : dataPtr(new LockstepChannelPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+LockstepChannel::~LockstepChannel()
+{
+  this->Close();
+  if (this->dataPtr->owner)
+    ipc::shared_memory_object::remove(this->dataPtr->name.c_str());
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::Create(const std::string &_name,
+    const size_t _stateCapacity, const size_t _commandCapacity)
+{
+  if (this->dataPtr->header)
+  {
+    gzerr << "Lockstep channel [" << this->dataPtr->name
+          << "] is already open\n";
+    return false;
+  }
+
+  try
+  {
+    ipc::shared_memory_object::remove(_name.c_str());
+    ipc::shared_memory_object shm(ipc::create_only, _name.c_str(),
+        ipc::read_write);
+    this->dataPtr->owner = true;
+    this->dataPtr->name = _name;
+    shm.truncate(sizeof(LockstepHeader) + _stateCapacity + _commandCapacity);
+    ipc::mapped_region region(shm, ipc::read_write);
+    this->dataPtr->region.swap(region);
+  }
+  catch(ipc::interprocess_exception &_e)
+  {
+    gzerr << "Unable to create lockstep channel [" << _name << "]: "
+          << _e.what() << std::endl;
+    if (this->dataPtr->owner)
+      ipc::shared_memory_object::remove(_name.c_str());
+    this->dataPtr->owner = false;
+    this->dataPtr->name.clear();
+    return false;
+  }
+
+  char *address = static_cast<char *>(this->dataPtr->region.get_address());
+  this->dataPtr->header = new (address) LockstepHeader;
+  this->dataPtr->header->stateCapacity = _stateCapacity;
+  this->dataPtr->header->commandCapacity = _commandCapacity;
+  this->dataPtr->state = address + sizeof(LockstepHeader);
+  this->dataPtr->command = this->dataPtr->state + _stateCapacity;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::Open(const std::string &_name)
+{
+  if (this->dataPtr->header)
+  {
+    gzerr << "Lockstep channel [" << this->dataPtr->name
+          << "] is already open\n";
+    return false;
+  }
+
+  try
+  {
+    ipc::shared_memory_object shm(ipc::open_only, _name.c_str(),
+        ipc::read_write);
+    ipc::mapped_region region(shm, ipc::read_write);
+    this->dataPtr->region.swap(region);
+  }
+  catch(ipc::interprocess_exception &_e)
+  {
+    gzwarn << "Unable to open lockstep channel [" << _name << "]: "
+           << _e.what() << std::endl;
+    return false;
+  }
+
+  char *address = static_cast<char *>(this->dataPtr->region.get_address());
+  LockstepHeader *header = reinterpret_cast<LockstepHeader *>(address);
+  if (this->dataPtr->region.get_size() < sizeof(LockstepHeader) ||
+      this->dataPtr->region.get_size() < sizeof(LockstepHeader) +
+      header->stateCapacity + header->commandCapacity)
+  {
+    gzerr << "Lockstep channel [" << _name << "] is truncated\n";
+    ipc::mapped_region empty;
+    this->dataPtr->region.swap(empty);
+    return false;
+  }
+
+  {
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+    if (header->closed || header->client)
+    {
+      gzerr << "Lockstep channel [" << _name << "] is closed or already "
+            << "has a client\n";
+      ipc::mapped_region empty;
+      this->dataPtr->region.swap(empty);
+      return false;
+    }
+    header->client = true;
+
+    // Start from the state in the buffer, if any
+    this->dataPtr->lastStep = 0;
+  }
+
+  this->dataPtr->name = _name;
+  this->dataPtr->header = header;
+  this->dataPtr->state = address + sizeof(LockstepHeader);
+  this->dataPtr->command = this->dataPtr->state + header->stateCapacity;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::HasClient() const
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+  return header->client && !header->closed;
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::WriteState(const std::string &_data,
+    const uint64_t _step)
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header || _data.size() > header->stateCapacity)
+    return false;
+
+  {
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+    if (header->closed)
+      return false;
+
+    std::memcpy(this->dataPtr->state, _data.data(), _data.size());
+    header->stateSize = _data.size();
+    header->stateStep = _step;
+  }
+
+  header->changed.notify_all();
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::WaitForCommand(std::string &_data,
+    const uint64_t _step, const unsigned int _timeoutMs)
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  const boost::posix_time::ptime deadline = Deadline(_timeoutMs);
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+  while (!header->closed && header->client && header->commandStep < _step)
+  {
+    if (!header->changed.timed_wait(lock, deadline))
+      break;
+  }
+
+  if (header->closed || header->commandStep < _step)
+    return false;
+
+  _data.assign(this->dataPtr->command, header->commandSize);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::WaitForState(std::string &_data, uint64_t &_step,
+    const unsigned int _timeoutMs)
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  const boost::posix_time::ptime deadline = Deadline(_timeoutMs);
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+  while (!header->closed && header->stateStep <= this->dataPtr->lastStep)
+  {
+    if (!header->changed.timed_wait(lock, deadline))
+      break;
+  }
+
+  if (header->closed || header->stateStep <= this->dataPtr->lastStep)
+    return false;
+
+  _data.assign(this->dataPtr->state, header->stateSize);
+  _step = header->stateStep;
+  this->dataPtr->lastStep = _step;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::WriteCommand(const std::string &_data)
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header || this->dataPtr->lastStep == 0 ||
+      _data.size() > header->commandCapacity)
+  {
+    return false;
+  }
+
+  {
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+    if (header->closed)
+      return false;
+
+    std::memcpy(this->dataPtr->command, _data.data(), _data.size());
+    header->commandSize = _data.size();
+    header->commandStep = this->dataPtr->lastStep;
+  }
+
+  header->changed.notify_all();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LockstepChannel::Close()
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header)
+    return;
+
+  {
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+    if (this->dataPtr->owner)
+      header->closed = true;
+    else
+      header->client = false;
+  }
+  header->changed.notify_all();
+
+  if (!this->dataPtr->owner)
+  {
+    this->dataPtr->header = nullptr;
+    this->dataPtr->state = nullptr;
+    this->dataPtr->command = nullptr;
+    this->dataPtr->name.clear();
+    ipc::mapped_region empty;
+    this->dataPtr->region.swap(empty);
+  }
+}
+
+/////////////////////////////////////////////////
+bool LockstepChannel::IsClosed() const
+{
+  LockstepHeader *header = this->dataPtr->header;
+  if (!header)
+    return true;
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+  return header->closed;
+}
+
+/////////////////////////////////////////////////
+std::string LockstepChannel::Name() const
+{
+  return this->dataPtr->header ? this->dataPtr->name : std::string();
+}
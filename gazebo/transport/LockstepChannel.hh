@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_LOCKSTEPCHANNEL_HH_
+#define GAZEBO_TRANSPORT_LOCKSTEPCHANNEL_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private class.
+    class LockstepChannelPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class LockstepChannel LockstepChannel.hh transport/transport.hh
+    /// \brief Step barrier between gzserver and a single external
+    /// controller on the same host, in a shared memory segment.
+    ///
+    /// The server creates the channel. Before each step it writes the
+    /// state of the simulation with WriteState, then waits with
+    /// WaitForCommand until the client has answered for that step. The
+    /// client opens the channel, reads each state with WaitForState and
+    /// answers with WriteCommand. Both buffers hold one serialized message
+    /// each, so every step costs two copies and two wake ups instead of a
+    /// round trip through the sockets of the transport.
+    ///
+    /// The server doesn't wait when no client is connected, so a client
+    /// can join and leave a running simulation. See CosimPlugin.
+    class GZ_TRANSPORT_VISIBLE LockstepChannel
+    {
+      /// \brief Constructor.
+      public: LockstepChannel();
+
+      /// \brief Destructor. Closes the channel, and removes the segment if
+      /// it was created by this object.
+      public: ~LockstepChannel();
+
+      /// \brief Create a segment as the server, replacing any stale segment
+      /// of the same name.
+      /// \param[in] _name Name of the segment.
+      /// \param[in] _stateCapacity Size of the state buffer in bytes.
+      /// \param[in] _commandCapacity Size of the command buffer in bytes.
+      /// \return False if the segment couldn't be created.
+      public: bool Create(const std::string &_name,
+                  const size_t _stateCapacity,
+                  const size_t _commandCapacity);
+
+      /// \brief Open a segment created by the server, as its client.
+      /// \param[in] _name Name of the segment.
+      /// \return False if the segment doesn't exist or already has a
+      /// client.
+      public: bool Open(const std::string &_name);
+
+      /// \brief Get whether a client is connected.
+      /// \return True between the Open and the Close of a client.
+      public: bool HasClient() const;
+
+      /// \brief Write the state of a step and wake the client. Server side.
+      /// \param[in] _data The serialized state.
+      /// \param[in] _step Step number, positive and increasing.
+      /// \return False if the channel is closed or the state is larger than
+      /// its buffer.
+      public: bool WriteState(const std::string &_data, const uint64_t _step);
+
+      /// \brief Wait for the command of the client for a step. Server side.
+      /// \param[out] _data The serialized command, its storage is reused.
+      /// \param[in] _step Step number given to WriteState.
+      /// \param[in] _timeoutMs Maximum time to wait in milliseconds.
+      /// \return False on timeout, or if the client left or the channel is
+      /// closed.
+      public: bool WaitForCommand(std::string &_data, const uint64_t _step,
+                  const unsigned int _timeoutMs);
+
+      /// \brief Wait for a state newer than the last one read. Client side.
+      /// \param[out] _data The serialized state, its storage is reused.
+      /// \param[out] _step Step number of the state.
+      /// \param[in] _timeoutMs Maximum time to wait in milliseconds.
+      /// \return False on timeout or if the channel is closed.
+      public: bool WaitForState(std::string &_data, uint64_t &_step,
+                  const unsigned int _timeoutMs);
+
+      /// \brief Answer the last state read, and let the server step. Client
+      /// side.
+      /// \param[in] _data The serialized command.
+      /// \return False if the channel is closed, no state was read, or the
+      /// command is larger than its buffer.
+      public: bool WriteCommand(const std::string &_data);
+
+      /// \brief Close the channel. The server closes it for both sides, a
+      /// client only disconnects.
+      public: void Close();
+
+      /// \brief Get whether the channel was closed by the server.
+      /// \return True if the channel is closed or not open.
+      public: bool IsClosed() const;
+
+      /// \brief Get the name of the segment.
+      /// \return The name, empty if the channel is not open.
+      public: std::string Name() const;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<LockstepChannelPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <boost/thread/thread.hpp>
+
+#include "gazebo/transport/LockstepChannel.hh"
+#include "gazebo/transport/SharedMemoryRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LockstepChannel : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(LockstepChannel, CreateOpen)
+{
+  transport::LockstepChannel server;
+  EXPECT_TRUE(server.IsClosed());
+  EXPECT_FALSE(server.HasClient());
+  EXPECT_FALSE(server.WriteState("state", 1));
+
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  ASSERT_TRUE(server.Create(name, 16, 8));
+  EXPECT_FALSE(server.IsClosed());
+  EXPECT_EQ(server.Name(), name);
+  EXPECT_FALSE(server.HasClient());
+
+  // No client, so no command
+  std::string data;
+  EXPECT_FALSE(server.WaitForCommand(data, 1, 10));
+
+  transport::LockstepChannel client;
+  ASSERT_TRUE(client.Open(name));
+  EXPECT_TRUE(server.HasClient());
+
+  // A single client at a time
+  transport::LockstepChannel second;
+  EXPECT_FALSE(second.Open(name));
+
+  client.Close();
+  EXPECT_FALSE(server.HasClient());
+  EXPECT_TRUE(client.Name().empty());
+  EXPECT_TRUE(second.Open(name));
+
+  transport::LockstepChannel missing;
+  EXPECT_FALSE(missing.Open(name + "_missing"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(LockstepChannel, StateCommand)
+{
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::LockstepChannel server;
+  ASSERT_TRUE(server.Create(name, 16, 8));
+  transport::LockstepChannel client;
+  ASSERT_TRUE(client.Open(name));
+
+  std::string data;
+  uint64_t step = 0;
+
+  // Nothing to answer yet
+  EXPECT_FALSE(client.WriteCommand("cmd"));
+  EXPECT_FALSE(client.WaitForState(data, step, 10));
+
+  // Too large for the buffers
+  EXPECT_FALSE(server.WriteState(std::string(17, 'x'), 1));
+
+  EXPECT_TRUE(server.WriteState("state 1", 1));
+  EXPECT_TRUE(client.WaitForState(data, step, 0));
+  EXPECT_EQ(data, "state 1");
+  EXPECT_EQ(step, 1u);
+
+  // Each state is read once
+  EXPECT_FALSE(client.WaitForState(data, step, 10));
+
+  EXPECT_FALSE(client.WriteCommand(std::string(9, 'x')));
+  EXPECT_TRUE(client.WriteCommand("cmd 1"));
+  EXPECT_TRUE(server.WaitForCommand(data, 1, 0));
+  EXPECT_EQ(data, "cmd 1");
+
+  // The command of step 1 doesn't answer step 2
+  EXPECT_TRUE(server.WriteState("state 2", 2));
+  EXPECT_FALSE(server.WaitForCommand(data, 2, 10));
+}
+
+/////////////////////////////////////////////////
+TEST_F(LockstepChannel, Lockstep)
+{
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::LockstepChannel server;
+  ASSERT_TRUE(server.Create(name, 32, 32));
+
+  const uint64_t stepCount = 1000;
+
+  // The client answers each state with its step number
+  boost::thread clientThread([&]
+  {
+    transport::LockstepChannel client;
+    ASSERT_TRUE(client.Open(name));
+
+    std::string state;
+    uint64_t step = 0;
+    while (step < stepCount && client.WaitForState(state, step, 5000))
+      EXPECT_TRUE(client.WriteCommand(std::to_string(step)));
+  });
+
+  // Wait for the client
+  for (int i = 0; i < 500 && !server.HasClient(); ++i)
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  ASSERT_TRUE(server.HasClient());
+
+  std::string command;
+  for (uint64_t step = 1; step <= stepCount; ++step)
+  {
+    ASSERT_TRUE(server.WriteState("state", step));
+    ASSERT_TRUE(server.WaitForCommand(command, step, 5000));
+    EXPECT_EQ(command, std::to_string(step));
+  }
+
+  clientThread.join();
+
+  // Closing wakes the client and fails later calls
+  server.Close();
+  EXPECT_TRUE(server.IsClosed());
+  EXPECT_FALSE(server.WriteState("state", stepCount + 1));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
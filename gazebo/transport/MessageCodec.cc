@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/MessageCodec.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace io = boost::iostreams;
+
+/// \brief First byte of a message kept as it is.
+static const char CODEC_RAW = 0;
+
+/// \brief First byte of a compressed message.
+static const char CODEC_ZLIB = 1;
+
+/// \brief First byte of a message compressed after a XOR with the
+/// previous message.
+static const char CODEC_ZLIB_DELTA = 2;
+
+/// \brief Size under which messages are not compressed, in bytes.
+static const size_t CODEC_MIN_SIZE = 512;
+
+namespace gazebo
+{
+namespace transport
+{
+/////////////////////////////////////////////////
+class MessageCodecPrivate
+{
+  /// \brief XOR a message with the previous one.
+  /// \param[in,out] _data The message.
+  public: void Xor(std::string &_data) const
+  {
+    const size_t size = std::min(_data.size(), this->prev.size());
+    for (size_t i = 0; i < size; ++i)
+      _data[i] ^= this->prev[i];
+  }
+
+  /// \brief True to encode messages against the previous one.
+  public: bool delta = false;
+
+  /// \brief Previous message, used in delta mode.
+  public: std::string prev;
+
+  /// \brief Message XORed with the previous one, kept to reuse its
+  /// storage.
+  public: std::string scratch;
+};
+}
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the compressed bytes of a buffer to a string.
+/// \param[in] _data The buffer.
+/// \param[out] _out The string.
+static void Compress(const std::string &_data, std::string &_out)
+{
+  io::filtering_ostream out;
+  out.push(io::zlib_compressor(io::zlib_params(io::zlib::best_speed)));
+  out.push(io::back_inserter(_out));
+  out.write(_data.data(), _data.size());
+  out.reset();
+}
+
+/////////////////////////////////////////////////
+/// \brief Decompress a buffer.
+/// \param[in] _data Start of the compressed bytes.
+/// \param[in] _size Number of compressed bytes.
+/// \param[out] _out The decompressed bytes.
+/// \return False if the bytes are corrupt.
+static bool Decompress(const char *_data, const size_t _size,
+    std::string &_out)
+{
+  _out.clear();
+  try
+  {
+    io::filtering_istream in;
+    in.push(io::zlib_decompressor());
+    in.push(io::array_source(_data, _size));
+    io::copy(in, io::back_inserter(_out));
+  }
+  catch(std::exception &_e)
+  {
+    gzerr << "Unable to decompress message: " << _e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+MessageCodec::MessageCodec(const bool _delta)
+  : dataPtr(new MessageCodecPrivate)
+{
+  this->dataPtr->delta = _delta;
+}
+
+/////////////////////////////////////////////////
+MessageCodec::~MessageCodec()
+{
+}
+
+/////////////////////////////////////////////////
+std::unique_ptr<MessageCodec> MessageCodec::Create(const std::string &_name)
+{
+  if (_name == "zlib")
+    return std::unique_ptr<MessageCodec>(new MessageCodec(false));
+  else if (_name == "zlib_delta")
+    return std::unique_ptr<MessageCodec>(new MessageCodec(true));
+
+  return std::unique_ptr<MessageCodec>();
+}
+
+/////////////////////////////////////////////////
+bool MessageCodec::IsSupported(const std::string &_name)
+{
+  return _name == "zlib" || _name == "zlib_delta";
+}
+
+/////////////////////////////////////////////////
+void MessageCodec::Encode(const std::string &_data, std::string &_encoded)
+{
+  _encoded.clear();
+  if (_data.size() >= CODEC_MIN_SIZE)
+  {
+    if (this->dataPtr->delta && !this->dataPtr->prev.empty())
+    {
+      this->dataPtr->scratch = _data;
+      this->dataPtr->Xor(this->dataPtr->scratch);
+      _encoded.push_back(CODEC_ZLIB_DELTA);
+      Compress(this->dataPtr->scratch, _encoded);
+    }
+    else
+    {
+      _encoded.push_back(CODEC_ZLIB);
+      Compress(_data, _encoded);
+    }
+
+    // Keep messages that don't compress as they are
+    if (_encoded.size() > _data.size())
+      _encoded.clear();
+  }
+
+  if (_encoded.empty())
+  {
+    _encoded.reserve(_data.size() + 1);
+    _encoded.push_back(CODEC_RAW);
+    _encoded.append(_data);
+  }
+
+  if (this->dataPtr->delta)
+    this->dataPtr->prev = _data;
+}
+
+/////////////////////////////////////////////////
+bool MessageCodec::Decode(const std::string &_encoded, std::string &_data)
+{
+  if (_encoded.empty())
+    return false;
+
+  bool result = false;
+  switch (_encoded[0])
+  {
+    case CODEC_RAW:
+      _data.assign(_encoded, 1, std::string::npos);
+      result = true;
+      break;
+    case CODEC_ZLIB:
+      result = Decompress(_encoded.data() + 1, _encoded.size() - 1, _data);
+      break;
+    case CODEC_ZLIB_DELTA:
+      if (this->dataPtr->delta &&
+          Decompress(_encoded.data() + 1, _encoded.size() - 1, _data))
+      {
+        this->dataPtr->Xor(_data);
+        result = true;
+      }
+      break;
+    default:
+      gzerr << "Unknown message encoding [" << static_cast<int>(_encoded[0])
+            << "]\n";
+      break;
+  }
+
+  if (result && this->dataPtr->delta)
+    this->dataPtr->prev = _data;
+
+  return result;
+}
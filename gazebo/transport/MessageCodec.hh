@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_MESSAGECODEC_HH_
+#define GAZEBO_TRANSPORT_MESSAGECODEC_HH_
+
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private class.
+    class MessageCodecPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class MessageCodec MessageCodec.hh transport/transport.hh
+    /// \brief Compresses the serialized messages sent in one direction of
+    /// a link between a publisher and a remote subscriber.
+    ///
+    /// The subscriber names a codec in its Subscribe message, and both
+    /// ends create one with the same name. The supported codecs are:
+    /// - "zlib": each large message is compressed on its own.
+    /// - "zlib_delta": each large message is XORed with the previous
+    /// message of the link before it is compressed, which removes the
+    /// bytes that didn't change in messages with a repeated layout, such
+    /// as poses. Messages must be decoded in the order they were encoded.
+    ///
+    /// Without delta, Encode and Decode keep no state and can be called
+    /// from several threads at once.
+    class GZ_TRANSPORT_VISIBLE MessageCodec
+    {
+      /// \brief Constructor.
+      /// \param[in] _delta True to encode messages against the previous
+      /// one.
+      public: explicit MessageCodec(const bool _delta);
+
+      /// \brief Destructor.
+      public: ~MessageCodec();
+
+      /// \brief Create a codec from its name.
+      /// \param[in] _name Name of the codec.
+      /// \return The codec, null if the name is empty or unknown.
+      public: static std::unique_ptr<MessageCodec> Create(
+                  const std::string &_name);
+
+      /// \brief Get whether a codec name is supported.
+      /// \param[in] _name Name of the codec.
+      /// \return True if Create would succeed.
+      public: static bool IsSupported(const std::string &_name);
+
+      /// \brief Encode a serialized message. Small messages, and messages
+      /// that don't compress, are kept as they are.
+      /// \param[in] _data The serialized message.
+      /// \param[out] _encoded The encoded message, its storage is reused.
+      public: void Encode(const std::string &_data, std::string &_encoded);
+
+      /// \brief Decode a message encoded by a codec of the same name.
+      /// \param[in] _encoded The encoded message.
+      /// \param[out] _data The serialized message.
+      /// \return False if the message is corrupt.
+      public: bool Decode(const std::string &_encoded, std::string &_data);
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<MessageCodecPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/transport/MessageCodec.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MessageCodec : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Build a message with a repeated layout.
+/// \param[in] _seed Value that changes a few bytes of the message.
+/// \return The message.
+static std::string RepeatedMessage(const int _seed)
+{
+  std::string data;
+  for (int i = 0; i < 1000; ++i)
+  {
+    data += "pose_" + std::to_string(i) + ":";
+    data.push_back(static_cast<char>((i * 31 + (i % 50 == 0 ? _seed : 0))
+          % 256));
+  }
+  return data;
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageCodec, Create)
+{
+  EXPECT_TRUE(transport::MessageCodec::IsSupported("zlib"));
+  EXPECT_TRUE(transport::MessageCodec::IsSupported("zlib_delta"));
+  EXPECT_FALSE(transport::MessageCodec::IsSupported(""));
+  EXPECT_FALSE(transport::MessageCodec::IsSupported("lz4"));
+
+  EXPECT_TRUE(transport::MessageCodec::Create("zlib") != nullptr);
+  EXPECT_TRUE(transport::MessageCodec::Create("zlib_delta") != nullptr);
+  EXPECT_TRUE(transport::MessageCodec::Create("") == nullptr);
+  EXPECT_TRUE(transport::MessageCodec::Create("zstd") == nullptr);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageCodec, Zlib)
+{
+  transport::MessageCodec encoder(false);
+  transport::MessageCodec decoder(false);
+  std::string encoded;
+  std::string decoded;
+
+  // Small messages are kept as they are
+  encoder.Encode("small", encoded);
+  EXPECT_EQ(encoded.size(), 6u);
+  EXPECT_TRUE(decoder.Decode(encoded, decoded));
+  EXPECT_EQ(decoded, "small");
+
+  encoder.Encode("", encoded);
+  EXPECT_TRUE(decoder.Decode(encoded, decoded));
+  EXPECT_TRUE(decoded.empty());
+
+  // Large messages are compressed
+  const std::string data = RepeatedMessage(0);
+  encoder.Encode(data, encoded);
+  EXPECT_LT(encoded.size(), data.size() / 2);
+  EXPECT_TRUE(decoder.Decode(encoded, decoded));
+  EXPECT_EQ(decoded, data);
+
+  // Corrupt messages are rejected
+  EXPECT_FALSE(decoder.Decode("", decoded));
+  encoded.resize(encoded.size() / 2);
+  EXPECT_FALSE(decoder.Decode(encoded, decoded));
+  EXPECT_FALSE(decoder.Decode(std::string(1, 9) + "data", decoded));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageCodec, Delta)
+{
+  transport::MessageCodec encoder(true);
+  transport::MessageCodec decoder(true);
+  transport::MessageCodec plain(false);
+  std::string encoded;
+  std::string plainEncoded;
+  std::string decoded;
+
+  for (int i = 0; i < 10; ++i)
+  {
+    const std::string data = RepeatedMessage(i);
+    encoder.Encode(data, encoded);
+    plain.Encode(data, plainEncoded);
+    EXPECT_TRUE(decoder.Decode(encoded, decoded));
+    EXPECT_EQ(decoded, data);
+
+    // Messages after the first only hold the changed bytes
+    if (i > 0)
+      EXPECT_LT(encoded.size(), plainEncoded.size());
+  }
+
+  // Messages of a different size, and small messages in between
+  encoder.Encode("small", encoded);
+  EXPECT_TRUE(decoder.Decode(encoded, decoded));
+  EXPECT_EQ(decoded, "small");
+
+  const std::string longer = RepeatedMessage(3) + RepeatedMessage(4);
+  encoder.Encode(longer, encoded);
+  EXPECT_TRUE(decoder.Decode(encoded, decoded));
+  EXPECT_EQ(decoded, longer);
+
+  // A codec without delta can't decode delta messages
+  encoder.Encode(RepeatedMessage(5), encoded);
+  EXPECT_FALSE(plain.Decode(encoded, decoded));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,8 @@
 */
 #include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
+#include "gazebo/common/Timestamp.hh"
+#include "gazebo/transport/EncodedMessage.hh"
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Node.hh"
 
@@ -66,6 +68,14 @@ void Node::Fini()
   {
     boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
     this->callbacks.clear();
+
+    // Messages left are never processed
+    for (auto const &topicMsgs : this->incomingMsgs)
+      this->GetTopicStats(topicMsgs.first)->incoming -= topicMsgs.second.size();
+    for (auto const &topicMsgs : this->incomingMsgsLocal)
+      this->GetTopicStats(topicMsgs.first)->incoming -= topicMsgs.second.size();
+    this->incomingMsgs.clear();
+    this->incomingMsgsLocal.clear();
   }
 }
 
@@ -195,16 +205,27 @@ void Node::ProcessPublishers()
 bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgs[_topic].push_back(_msg);
+  this->incomingMsgs[_topic].push_back(
+      std::make_pair(_msg, common::Timestamp::Now().Nanoseconds()));
+  ++this->GetTopicStats(_topic)->incoming;
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
 
 /////////////////////////////////////////////////
 bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg)
+{
+  return this->HandleMessage(_topic,
+      EncodedMessagePtr(new EncodedMessage(_msg)));
+}
+
+/////////////////////////////////////////////////
+bool Node::HandleMessage(const std::string &_topic,
+    const EncodedMessagePtr &_msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
   this->incomingMsgsLocal[_topic].push_back(_msg);
+  ++this->GetTopicStats(_topic)->incoming;
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
@@ -223,9 +244,10 @@ void Node::ProcessIncoming()
 
   // For each topic
   {
-    std::list<std::string>::iterator msgIter;
-    std::map<std::string, std::list<std::string> >::iterator inIter;
-    std::map<std::string, std::list<std::string> >::iterator endIter;
+    typedef std::list<std::pair<std::string, int64_t> > Data_L;
+    Data_L::iterator msgIter;
+    std::map<std::string, Data_L>::iterator inIter;
+    std::map<std::string, Data_L>::iterator endIter;
 
     boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
     inIter = this->incomingMsgs.begin();
@@ -233,12 +255,15 @@ void Node::ProcessIncoming()
 
     for (; inIter != endIter; ++inIter)
     {
+      TopicStats *stats = this->GetTopicStats(inIter->first);
+      stats->incoming -= inIter->second.size();
+
       // Find the callbacks for the topic
       cbIter = this->callbacks.find(inIter->first);
       if (cbIter != this->callbacks.end())
       {
-        std::list<std::string>::iterator msgInIter;
-        std::list<std::string>::iterator msgEndIter;
+        Data_L::iterator msgInIter;
+        Data_L::iterator msgEndIter;
 
         msgInIter = inIter->second.begin();
         msgEndIter = inIter->second.end();
@@ -246,11 +271,16 @@ void Node::ProcessIncoming()
         // For each message in the buffer
         for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
         {
+          // The serialized data has no publication time, the latency is
+          // counted from the reception
+          stats->RecordLatency(
+              common::Timestamp::Now().Nanoseconds() - msgIter->second);
+
           // Send the message to all callbacks
           for (liter = cbIter->second.begin();
               liter != cbIter->second.end(); ++liter)
           {
-            (*liter)->HandleData(*msgIter,
+            (*liter)->HandleData(msgIter->first,
                 boost::bind(&dummy_callback_fn, _1), 0);
           }
         }
@@ -261,9 +291,9 @@ void Node::ProcessIncoming()
   }
 
   {
-    std::list<MessagePtr>::iterator msgIter;
-    std::map<std::string, std::list<MessagePtr> >::iterator inIter;
-    std::map<std::string, std::list<MessagePtr> >::iterator endIter;
+    std::list<EncodedMessagePtr>::iterator msgIter;
+    std::map<std::string, std::list<EncodedMessagePtr> >::iterator inIter;
+    std::map<std::string, std::list<EncodedMessagePtr> >::iterator endIter;
 
     boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
     inIter = this->incomingMsgsLocal.begin();
@@ -271,12 +301,15 @@ void Node::ProcessIncoming()
 
     for (; inIter != endIter; ++inIter)
     {
+      TopicStats *stats = this->GetTopicStats(inIter->first);
+      stats->incoming -= inIter->second.size();
+
       // Find the callbacks for the topic
       cbIter = this->callbacks.find(inIter->first);
       if (cbIter != this->callbacks.end())
       {
-        std::list<MessagePtr>::iterator msgInIter;
-        std::list<MessagePtr>::iterator msgEndIter;
+        std::list<EncodedMessagePtr>::iterator msgInIter;
+        std::list<EncodedMessagePtr>::iterator msgEndIter;
 
         msgInIter = inIter->second.begin();
         msgEndIter = inIter->second.end();
@@ -284,11 +317,15 @@ void Node::ProcessIncoming()
         // For each message in the buffer
         for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
         {
+          stats->RecordLatency(common::Timestamp::Now().Nanoseconds() -
+              (*msgIter)->PublishTime());
+
           // Send the message to all callbacks
           for (liter = cbIter->second.begin();
               liter != cbIter->second.end(); ++liter)
           {
-            (*liter)->HandleMessage(*msgIter);
+            (*liter)->HandleEncoded(*msgIter,
+                boost::bind(&dummy_callback_fn, _1), 0);
           }
         }
       }
@@ -321,6 +358,13 @@ void Node::InsertLatchedMsg(const std::string &_topic, const std::string &_msg)
 
 //////////////////////////////////////////////////
 void Node::InsertLatchedMsg(const std::string &_topic, MessagePtr _msg)
+{
+  this->InsertLatchedMsg(_topic, EncodedMessagePtr(new EncodedMessage(_msg)));
+}
+
+//////////////////////////////////////////////////
+void Node::InsertLatchedMsg(const std::string &_topic,
+    const EncodedMessagePtr &_msg)
 {
   // Find the callbacks for the topic
   Callback_M::iterator cbIter = this->callbacks.find(_topic);
@@ -333,7 +377,7 @@ void Node::InsertLatchedMsg(const std::string &_topic, MessagePtr _msg)
     {
       if ((*liter)->GetLatching())
       {
-        (*liter)->HandleMessage(_msg);
+        (*liter)->HandleEncoded(_msg, boost::bind(&dummy_callback_fn, _1), 0);
         (*liter)->SetLatching(false);
       }
     }
@@ -387,3 +431,9 @@ void Node::RemoveCallback(const std::string &_topic, unsigned int _id)
     }
   }
 }
+
+/////////////////////////////////////////////////
+TopicStats *Node::GetTopicStats(const std::string &_topic)
+{
+  return TopicStatistics::Get(_topic);
+}
@@ -24,10 +24,12 @@
 #include <map>
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/TopicManager.hh"
+#include "gazebo/transport/TopicStatistics.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -260,6 +262,43 @@ namespace gazebo
         return result;
       }
 
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// and limit the messages sent by remote publishers.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _limits Options that hold the maximum rate, the latest
+      /// only flag and the codec, see SubscribeOptions::SetMaxRate,
+      /// SubscribeOptions::SetLatestOnly and SubscribeOptions::SetCodec.
+      /// \param[in] _latching If true, latch latest incoming message;
+      /// otherwise don't latch
+      /// \return Pointer to new Subscriber object
+      public: template<typename M, typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const boost::shared_ptr<M const> &), T *_obj,
+          const SubscribeOptions &_limits, bool _latching = false)
+      {
+        SubscribeOptions ops;
+        std::string decodedTopic = this->DecodeTopicName(_topic);
+        ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
+        ops.SetMaxRate(_limits.GetMaxRate());
+        ops.SetLatestOnly(_limits.GetLatestOnly());
+        ops.SetCodec(_limits.GetCodec());
+
+        {
+          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+          this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
+                new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
+        }
+
+        SubscriberPtr result =
+          transport::TopicManager::Instance()->Subscribe(ops);
+
+        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
+
+        return result;
+      }
+
       /// \brief Subscribe to a topic using a bare function as the callback
       /// \param[in] _topic The topic to subscribe to
       /// \param[in] _fp Function to be called on receipt of new message
@@ -360,6 +399,13 @@ namespace gazebo
       /// \return true if the message was handled successfully, false otherwise
       public: bool HandleMessage(const std::string &_topic, MessagePtr _msg);
 
+      /// \brief Handle incoming msg, shared with other subscribers.
+      /// \param[in] _topic Topic for which the data was received
+      /// \param[in] _msg The message that was received
+      /// \return true if the message was handled successfully, false otherwise
+      public: bool HandleMessage(const std::string &_topic,
+                                 const EncodedMessagePtr &_msg);
+
       /// \brief Add a latched message to the node for publication.
       ///
       /// This is called when a subscription is connected to a
@@ -378,6 +424,16 @@ namespace gazebo
       public: void InsertLatchedMsg(const std::string &_topic,
                                     MessagePtr _msg);
 
+      /// \brief Add a latched message to the node for publication.
+      ///
+      /// This is called when a subscription is connected to a
+      /// publication.
+      /// \param[in] _topic Name of the topic to publish data on.
+      /// \param[in] _msg The message to publish, shared with other
+      /// subscribers.
+      public: void InsertLatchedMsg(const std::string &_topic,
+                                    const EncodedMessagePtr &_msg);
+
       /// \brief Get the message type for a topic
       /// \param[in] _topic The topic
       /// \return The message type
@@ -405,6 +461,11 @@ namespace gazebo
                                 const common::Time &_maxWait,
                                 const bool _fallbackToDefault);
 
+      /// \brief Get the stats of a topic, see TopicStatistics.
+      /// \param[in] _topic Name of the topic.
+      /// \return The stats.
+      private: TopicStats *GetTopicStats(const std::string &_topic);
+
       private: std::string topicNamespace;
       private: std::vector<PublisherPtr> publishers;
       private: std::vector<PublisherPtr>::iterator publishersIter;
@@ -414,10 +475,15 @@ namespace gazebo
       private: typedef std::list<CallbackHelperPtr> Callback_L;
       private: typedef std::map<std::string, Callback_L> Callback_M;
       private: Callback_M callbacks;
-      private: std::map<std::string, std::list<std::string> > incomingMsgs;
+
+      /// \brief List of newly arrived serialized messages, with the time
+      /// they were received.
+      private: std::map<std::string,
+               std::list<std::pair<std::string, int64_t> > > incomingMsgs;
 
       /// \brief List of newly arrive messages
-      private: std::map<std::string, std::list<MessagePtr> > incomingMsgsLocal;
+      private: std::map<std::string, std::list<EncodedMessagePtr> >
+               incomingMsgsLocal;
 
       private: boost::mutex publisherMutex;
       private: boost::mutex publisherDeleteMutex;
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_OUTBOUNDQUEUE_HH_
+#define GAZEBO_TRANSPORT_OUTBOUNDQUEUE_HH_
+
+#include <atomic>
+#include <utility>
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class OutboundQueue OutboundQueue.hh transport/transport.hh
+    /// \brief Unbounded multiple producer, single consumer queue that
+    /// doesn't use locks.
+    ///
+    /// Producers, such as the world thread, push without ever waiting on
+    /// the consumer. Only one thread at a time may pop, which the caller
+    /// must ensure. An element pushed while a pop is in progress may only
+    /// be visible to the next pop.
+    template<typename T>
+    class OutboundQueue
+    {
+      /// \brief Constructor.
+      public: OutboundQueue()
+              : head(new Element), tail(head.load())
+              {
+              }
+
+      /// \brief Destructor. Destroys the elements left in the queue.
+      public: ~OutboundQueue()
+              {
+                T value;
+                while (this->Pop(value))
+                {
+                }
+                delete this->tail;
+              }
+
+      /// \brief Add an element at the end of the queue. Can be called
+      /// from any thread.
+      /// \param[in] _value The element.
+      public: void Push(const T &_value)
+              {
+                Element *element = new Element;
+                element->value = _value;
+
+                Element *prev = this->head.exchange(element,
+                    std::memory_order_acq_rel);
+                prev->next.store(element, std::memory_order_release);
+              }
+
+      /// \brief Remove the element at the front of the queue. Must only be
+      /// called by one thread at a time.
+      /// \param[out] _value The element, unchanged if the queue is empty.
+      /// \return False if the queue is empty.
+      public: bool Pop(T &_value)
+              {
+                Element *front = this->tail;
+                Element *next = front->next.load(std::memory_order_acquire);
+                if (!next)
+                  return false;
+
+                // The next element becomes the new stub
+                _value = std::move(next->value);
+                next->value = T();
+                this->tail = next;
+                delete front;
+                return true;
+              }
+
+      /// \brief Get whether the queue is empty. Must only be called by the
+      /// consumer.
+      /// \return True if the queue is empty.
+      public: bool Empty() const
+              {
+                return !this->tail->next.load(std::memory_order_acquire);
+              }
+
+      /// \brief An element of the queue.
+      private: class Element
+               {
+                 /// \brief Next element, null at the end of the queue.
+                 public: std::atomic<Element *> next{nullptr};
+
+                 /// \brief The value, default constructed in the stub.
+                 public: T value;
+               };
+
+      /// \brief Last element pushed, updated by producers.
+      private: std::atomic<Element *> head;
+
+      /// \brief Stub before the front of the queue, owned by the consumer.
+      private: Element *tail;
+
+      /// \brief Not copyable.
+      private: OutboundQueue(const OutboundQueue &) = delete;
+
+      /// \brief Not assignable.
+      private: OutboundQueue &operator=(const OutboundQueue &) = delete;
+    };
+    /// \}
+  }
+}
+#endif
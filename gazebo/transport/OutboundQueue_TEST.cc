@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include <boost/thread/thread.hpp>
+
+#include "gazebo/transport/OutboundQueue.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class OutboundQueue : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(OutboundQueue, PushPop)
+{
+  transport::OutboundQueue<int> queue;
+  EXPECT_TRUE(queue.Empty());
+
+  int value = -1;
+  EXPECT_FALSE(queue.Pop(value));
+  EXPECT_EQ(value, -1);
+
+  for (int i = 0; i < 10; ++i)
+    queue.Push(i);
+  EXPECT_FALSE(queue.Empty());
+
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.Pop(value));
+}
+
+/////////////////////////////////////////////////
+TEST_F(OutboundQueue, Release)
+{
+  std::shared_ptr<int> value(new int(3));
+  {
+    transport::OutboundQueue<std::shared_ptr<int> > queue;
+    queue.Push(value);
+    queue.Push(value);
+    EXPECT_EQ(value.use_count(), 3);
+
+    // Popped elements don't stay referenced by the stub
+    std::shared_ptr<int> popped;
+    EXPECT_TRUE(queue.Pop(popped));
+    popped.reset();
+    EXPECT_EQ(value.use_count(), 2);
+  }
+
+  // The remaining elements are destroyed with the queue
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+/////////////////////////////////////////////////
+TEST_F(OutboundQueue, Producers)
+{
+  const int producerCount = 4;
+  const int pushCount = 10000;
+  transport::OutboundQueue<int> queue;
+
+  std::vector<boost::thread *> producers;
+  for (int p = 0; p < producerCount; ++p)
+  {
+    producers.push_back(new boost::thread([&queue, p, pushCount]()
+        {
+          for (int i = 0; i < pushCount; ++i)
+            queue.Push(p * pushCount + i);
+        }));
+  }
+
+  // Each producer's elements come out in order
+  std::vector<int> last(producerCount, -1);
+  int popped = 0;
+  int value = 0;
+  while (popped < producerCount * pushCount)
+  {
+    if (!queue.Pop(value))
+    {
+      boost::this_thread::yield();
+      continue;
+    }
+
+    const int producer = value / pushCount;
+    EXPECT_GT(value % pushCount, last[producer]);
+    last[producer] = value % pushCount;
+    ++popped;
+  }
+  EXPECT_TRUE(queue.Empty());
+
+  for (auto producer : producers)
+  {
+    producer->join();
+    delete producer;
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,9 @@
  *
 */
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/common/WeakBind.hh"
@@ -22,9 +25,45 @@
 #include "Publication.hh"
 #include "Node.hh"
 
+/// \internal
+/// \brief Private data for the Publication class.
+class gazebo::transport::PublicationPrivate
+{
+  /// \brief Publishers and their last messages.
+  public: std::map<uint32_t, EncodedMessagePtr> prevMsgs;
+
+  /// \brief Mutex to protect prevMsgs. It is separate from the callback
+  /// mutex so that publishing from the world thread doesn't wait for
+  /// messages being handed to the connections.
+  public: boost::mutex prevMsgMutex;
+};
+
 using namespace gazebo;
 using namespace transport;
 
+namespace
+{
+  /// \brief Private data of the publications, by publication. It is kept
+  /// out of Publication so that the layout of the class doesn't change.
+  class PublicationPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the publications.
+    public: static PublicationPrivates &Instance()
+    {
+      static PublicationPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by publication.
+    public: std::unordered_map<const Publication *,
+            std::unique_ptr<PublicationPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 extern void dummy_callback_fn(uint32_t);
 unsigned int Publication::idCounter = 0;
 
@@ -33,13 +72,31 @@ Publication::Publication(const std::string &_topic, const std::string &_msgType)
   : topic(_topic), msgType(_msgType), locallyAdvertised(false)
 {
   this->id = idCounter++;
+
+  PublicationPrivates &privates = PublicationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data[this].reset(new PublicationPrivate);
 }
 
 //////////////////////////////////////////////////
 Publication::~Publication()
 {
-  boost::mutex::scoped_lock lock(this->callbackMutex);
-  this->publishers.clear();
+  {
+    boost::mutex::scoped_lock lock(this->callbackMutex);
+    this->publishers.clear();
+  }
+
+  PublicationPrivates &privates = PublicationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+PublicationPrivate *Publication::PublicationData() const
+{
+  PublicationPrivates &privates = PublicationPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -61,9 +118,16 @@ void Publication::AddSubscription(const NodePtr &_node)
 
   boost::mutex::scoped_lock lock(this->callbackMutex);
 
+  std::map<uint32_t, EncodedMessagePtr> latched;
+  {
+    PublicationPrivate *data = this->PublicationData();
+    boost::mutex::scoped_lock prevLock(data->prevMsgMutex);
+    latched = data->prevMsgs;
+  }
+
   // Send latched messages to the subscription.
-  for (std::map<uint32_t, MessagePtr>::iterator pubIter =
-      this->prevMsgs.begin(); pubIter != this->prevMsgs.end(); ++pubIter)
+  for (std::map<uint32_t, EncodedMessagePtr>::iterator pubIter =
+      latched.begin(); pubIter != latched.end(); ++pubIter)
   {
     if (pubIter->second)
     {
@@ -86,13 +150,21 @@ void Publication::AddSubscription(const CallbackHelperPtr _callback)
 
     if (_callback->GetLatching())
     {
+      std::map<uint32_t, EncodedMessagePtr> latched;
+      {
+        PublicationPrivate *data = this->PublicationData();
+        boost::mutex::scoped_lock prevLock(data->prevMsgMutex);
+        latched = data->prevMsgs;
+      }
+
       // Send latched messages to the subscription.
-      for (std::map<uint32_t, MessagePtr>::iterator pubIter =
-          this->prevMsgs.begin(); pubIter != this->prevMsgs.end(); ++pubIter)
+      for (std::map<uint32_t, EncodedMessagePtr>::iterator pubIter =
+          latched.begin(); pubIter != latched.end(); ++pubIter)
       {
         if (pubIter->second)
         {
-          _callback->HandleMessage(pubIter->second);
+          _callback->HandleEncoded(pubIter->second,
+              boost::bind(&dummy_callback_fn, _1), 0);
         }
       }
       _callback->SetLatching(false);
@@ -103,15 +175,23 @@ void Publication::AddSubscription(const CallbackHelperPtr _callback)
 //////////////////////////////////////////////////
 void Publication::SetPrevMsg(uint32_t _pubId, MessagePtr _msg)
 {
-  boost::mutex::scoped_lock lock(this->callbackMutex);
-  this->prevMsgs[_pubId] = _msg;
+  this->SetPrevMsg(_pubId, EncodedMessagePtr(new EncodedMessage(_msg)));
+}
+
+//////////////////////////////////////////////////
+void Publication::SetPrevMsg(uint32_t _pubId, const EncodedMessagePtr &_msg)
+{
+  PublicationPrivate *data = this->PublicationData();
+  boost::mutex::scoped_lock lock(data->prevMsgMutex);
+  data->prevMsgs[_pubId] = _msg;
 }
 
 //////////////////////////////////////////////////
 void Publication::ClearPrevMsgs()
 {
-  boost::mutex::scoped_lock lock(this->callbackMutex);
-  this->prevMsgs.clear();
+  PublicationPrivate *data = this->PublicationData();
+  boost::mutex::scoped_lock lock(data->prevMsgMutex);
+  data->prevMsgs.clear();
 }
 
 //////////////////////////////////////////////////
@@ -291,6 +371,13 @@ void Publication::LocalPublish(const std::string &_data)
 //////////////////////////////////////////////////
 int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     uint32_t _id)
+{
+  return this->Publish(EncodedMessagePtr(new EncodedMessage(_msg)), _cb, _id);
+}
+
+//////////////////////////////////////////////////
+int Publication::Publish(const EncodedMessagePtr &_msg,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
 {
   int result = 0;
   std::list<NodePtr>::iterator iter, endIter;
@@ -319,14 +406,12 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
 
     if (!this->callbacks.empty())
     {
-      std::string data;
-      _msg->SerializeToString(&data);
       std::list<CallbackHelperPtr>::iterator cbIter;
       cbIter = this->callbacks.begin();
 
       while (cbIter != this->callbacks.end())
       {
-        if ((*cbIter)->HandleData(data, _cb, _id))
+        if ((*cbIter)->HandleEncoded(_msg, _cb, _id))
         {
           ++result;
           ++cbIter;
@@ -517,10 +602,19 @@ void Publication::RemoveNodes()
 //////////////////////////////////////////////////
 MessagePtr Publication::GetPrevMsg(uint32_t _pubId)
 {
-  boost::mutex::scoped_lock lock(this->callbackMutex);
-  if (this->prevMsgs.find(_pubId) != this->prevMsgs.end())
-    return this->prevMsgs[_pubId];
+  EncodedMessagePtr msg = this->GetPrevEncodedMsg(_pubId);
+  return msg ? msg->Message() : MessagePtr();
+}
+
+//////////////////////////////////////////////////
+EncodedMessagePtr Publication::GetPrevEncodedMsg(uint32_t _pubId)
+{
+  PublicationPrivate *data = this->PublicationData();
+  boost::mutex::scoped_lock lock(data->prevMsgMutex);
+  auto iter = data->prevMsgs.find(_pubId);
+  if (iter != data->prevMsgs.end())
+    return iter->second;
   else
-    return MessagePtr();
+    return EncodedMessagePtr();
 }
 
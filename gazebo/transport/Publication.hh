@@ -36,6 +36,9 @@ namespace gazebo
 {
   namespace transport
   {
+    // Forward declare private data class
+    class PublicationPrivate;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -126,6 +129,18 @@ namespace gazebo
                   boost::function<void(uint32_t)> _cb,
                   uint32_t _id);
 
+      /// \brief Publish a message to local and remote subscribers, which
+      /// share its serialized data.
+      /// \param[in] _msg Message to be published
+      /// \param[in] _cb Callback to be invoked after publishing
+      /// is completed
+      /// \param[in] _id ID associated with the message.
+      /// \return Number of remote subscribers that will receive the
+      /// message.
+      public: int Publish(const EncodedMessagePtr &_msg,
+                  boost::function<void(uint32_t)> _cb,
+                  uint32_t _id);
+
       /// \brief Remove a publisher.
       /// \param[in] _pub Pointer to publisher object to remove.
       public: void RemovePublisher(PublisherPtr _pub);
@@ -140,12 +155,25 @@ namespace gazebo
       /// \param[in] _msg The previous message.
       public: void SetPrevMsg(uint32_t _pubId, MessagePtr _msg);
 
+      /// \brief Set the previous message for a publisher.
+      /// \param[in] _pubId ID of the publisher.
+      /// \param[in] _msg The previous message, shared with the subscribers
+      /// it was published to.
+      public: void SetPrevMsg(uint32_t _pubId, const EncodedMessagePtr &_msg);
+
       /// \brief Get a previous message for a publisher.
       /// \param[in] _pubId ID of the publisher.
       /// \return Pointer to the previous message. NULL if there is no
       /// previous message.
       public: MessagePtr GetPrevMsg(uint32_t _pubId);
 
+      /// \brief Get a previous message for a publisher, with its serialized
+      /// data.
+      /// \param[in] _pubId ID of the publisher.
+      /// \return Pointer to the previous message. NULL if there is no
+      /// previous message.
+      public: EncodedMessagePtr GetPrevEncodedMsg(uint32_t _pubId);
+
       /// \brief Clear all previous messages for a publisher.
       public: void ClearPrevMsgs();
 
@@ -167,6 +195,12 @@ namespace gazebo
       /// \brief Remove nodes that have been marked for removal
       private: void RemoveNodes();
 
+      /// \internal
+      /// \brief Get the private data of this publication. It is kept out
+      /// of the class so that its layout doesn't change.
+      /// \return The private data.
+      private: PublicationPrivate *PublicationData() const;
+
       /// \brief Unique if of the publication.
       private: unsigned int id;
 
@@ -209,7 +243,8 @@ namespace gazebo
       /// \brief Mutex to protect the list of nodes id for removed.
       private: mutable boost::mutex nodeRemoveMutex;
 
-      /// \brief Publishers and their last messages.
+      /// \brief Unused, the last messages of the publishers are kept in
+      /// the private data, see PublicationData.
       private: std::map<uint32_t, MessagePtr> prevMsgs;
     };
     /// \}
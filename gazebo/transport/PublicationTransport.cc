@@ -14,11 +14,19 @@
  * limitations under the License.
  *
 */
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/MessageCodec.hh"
 #include "gazebo/transport/PublicationTransport.hh"
+#include "gazebo/transport/SharedMemoryRing.hh"
 #include "gazebo/common/WeakBind.hh"
 
 using namespace gazebo;
@@ -26,11 +34,186 @@ using namespace transport;
 
 int PublicationTransport::counter = 0;
 
+/// \brief Size of the shared memory ring of each remote process, in
+/// bytes.
+static const size_t SHM_RING_CAPACITY = 8 * 1024 * 1024;
+
+namespace gazebo
+{
+namespace transport
+{
+/// \brief Shared memory ring shared by the publication transports that
+/// read from the same remote process. Each transport is a channel of the
+/// ring. Messages are taken out of the ring when their placeholder arrives
+/// on the connection of their transport, so no thread reads the ring.
+class SharedMemoryPeer
+{
+  /// \brief Get the peer of the remote end of a connection, creating it
+  /// if needed.
+  /// \param[in] _conn The connection.
+  /// \return The peer, null if its ring couldn't be created.
+  public: static std::shared_ptr<SharedMemoryPeer> Get(
+              const ConnectionPtr &_conn)
+  {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::weak_ptr<SharedMemoryPeer>> registry;
+
+    const std::string key = _conn->GetRemoteAddress() + ":" +
+      std::to_string(_conn->GetRemotePort());
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::shared_ptr<SharedMemoryPeer> peer = registry[key].lock();
+    if (!peer)
+    {
+      peer.reset(new SharedMemoryPeer);
+      if (!peer->ring.Create(SharedMemoryRing::UniqueName(),
+            SHM_RING_CAPACITY))
+      {
+        registry.erase(key);
+        return nullptr;
+      }
+      registry[key] = peer;
+    }
+    return peer;
+  }
+
+  /// \brief Add a channel.
+  /// \return The channel.
+  public: uint32_t AddChannel()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const uint32_t channel = this->nextChannel++;
+    this->pending[channel];
+    return channel;
+  }
+
+  /// \brief Remove a channel, and the messages of the channel taken out
+  /// of the ring.
+  /// \param[in] _channel The channel.
+  public: void RemoveChannel(const uint32_t _channel)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->pending.erase(_channel);
+  }
+
+  /// \brief Take the next message of a channel. Messages of other
+  /// channels that come first in the ring are kept for their channels.
+  /// \param[in] _channel The channel.
+  /// \param[out] _data The message.
+  /// \return False if the ring has no message for the channel.
+  public: bool Take(const uint32_t _channel, std::string &_data)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto iter = this->pending.find(_channel);
+    if (iter == this->pending.end())
+      return false;
+
+    if (!iter->second.empty())
+    {
+      _data.swap(iter->second.front());
+      iter->second.pop_front();
+      return true;
+    }
+
+    // The message was written before its placeholder was sent, so it is
+    // already in the ring
+    uint32_t channel = 0;
+    while (this->ring.Read(_data, channel, 0))
+    {
+      if (channel == _channel)
+        return true;
+
+      auto other = this->pending.find(channel);
+      if (other != this->pending.end())
+        other->second.push_back(std::move(_data));
+    }
+    return false;
+  }
+
+  /// \brief The ring, created by this process.
+  public: SharedMemoryRing ring;
+
+  /// \brief Protects the channels and the reads of the ring.
+  private: std::mutex mutex;
+
+  /// \brief Messages taken out of the ring before their placeholder
+  /// arrived, by channel.
+  private: std::map<uint32_t, std::deque<std::string>> pending;
+
+  /// \brief Next channel.
+  private: uint32_t nextChannel = 0;
+};
+
+/// \internal
+/// \brief Private data for the PublicationTransport class.
+class PublicationTransportPrivate
+{
+  /// \brief Shared memory ring of the advertiser process, null if
+  /// shared memory is disabled or the advertiser is remote.
+  public: std::shared_ptr<SharedMemoryPeer> shmPeer;
+
+  /// \brief Channel of this transport in the shared memory ring.
+  public: uint32_t shmChannel = 0;
+
+  /// \brief Decodes the messages of the connection, null if they are
+  /// not compressed.
+  public: std::unique_ptr<MessageCodec> codec;
+};
+}
+}
+
+namespace
+{
+  /// \brief Private data of the publication transports, by transport. It
+  /// is kept out of PublicationTransport so that the layout of the class
+  /// doesn't change.
+  class PublicationTransportPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the transports.
+    public: static PublicationTransportPrivates &Instance()
+    {
+      static PublicationTransportPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by transport.
+    public: std::unordered_map<const PublicationTransport *,
+            std::unique_ptr<PublicationTransportPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a connection can use a shared memory ring.
+/// \param[in] _conn The connection.
+/// \return True if shared memory is enabled with the GAZEBO_TRANSPORT_SHM
+/// environment variable, and both ends of the connection are on this host.
+static bool UseSharedMemory(const ConnectionPtr &_conn)
+{
+  const char *env = getenv("GAZEBO_TRANSPORT_SHM");
+  if (!env || std::string(env) != "1")
+    return false;
+
+  const std::string remote = _conn->GetRemoteAddress();
+  return !remote.empty() && (remote == _conn->GetLocalAddress() ||
+    remote.compare(0, 4, "127.") == 0);
+}
+
 /////////////////////////////////////////////////
 PublicationTransport::PublicationTransport(const std::string &_topic,
                                            const std::string &_msgType)
 : topic(_topic), msgType(_msgType)
 {
+  {
+    PublicationTransportPrivates &privates =
+      PublicationTransportPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(new PublicationTransportPrivate);
+  }
+
   this->id = counter++;
   TopicManager::Instance()->UpdatePublications(this->topic, this->msgType);
 }
@@ -38,6 +221,10 @@ PublicationTransport::PublicationTransport(const std::string &_topic,
 /////////////////////////////////////////////////
 PublicationTransport::~PublicationTransport()
 {
+  PublicationTransportPrivate *data = this->PublicationData();
+  if (data->shmPeer)
+    data->shmPeer->RemoveChannel(data->shmChannel);
+
   if (this->connection)
   {
     msgs::Subscribe sub;
@@ -52,10 +239,31 @@ PublicationTransport::~PublicationTransport()
     ConnectionManager::Instance()->RemoveConnection(this->connection);
   }
   this->callback.clear();
+
+  PublicationTransportPrivates &privates =
+    PublicationTransportPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+/////////////////////////////////////////////////
+PublicationTransportPrivate *PublicationTransport::PublicationData() const
+{
+  PublicationTransportPrivates &privates =
+    PublicationTransportPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 /////////////////////////////////////////////////
 void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
+{
+  this->Init(_conn, _latched, 0, false, "");
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched,
+    const double _maxRate, const bool _latestOnly, const std::string &_codec)
 {
   this->connection = _conn;
   msgs::Subscribe sub;
@@ -64,6 +272,34 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
   sub.set_host(this->connection->GetLocalAddress());
   sub.set_port(this->connection->GetLocalPort());
   sub.set_latching(_latched);
+  sub.set_max_rate(_maxRate);
+  sub.set_latest_only(_latestOnly);
+
+  std::string codecName = _codec;
+  const char *env = getenv("GAZEBO_TRANSPORT_CODEC");
+  if (codecName.empty() && env)
+    codecName = env;
+
+  // Latest only subscribers skip messages on the connection, which would
+  // leave their messages in the ring
+  PublicationTransportPrivate *data = this->PublicationData();
+  if (!_latestOnly && UseSharedMemory(this->connection))
+    data->shmPeer = SharedMemoryPeer::Get(this->connection);
+
+  if (data->shmPeer)
+  {
+    data->shmChannel = data->shmPeer->AddChannel();
+    sub.set_shm_name(data->shmPeer->ring.Name());
+    sub.set_shm_channel(data->shmChannel);
+  }
+  else if (!codecName.empty())
+  {
+    data->codec = MessageCodec::Create(codecName);
+    if (data->codec)
+      sub.set_codec(codecName);
+    else
+      gzwarn << "Unknown transport codec [" << codecName << "]\n";
+  }
 
   this->connection->EnqueueMsg(msgs::Package("sub", sub));
 
@@ -86,14 +322,41 @@ void PublicationTransport::OnPublish(const std::string &_data)
 {
   if (this->connection && this->connection->IsOpen())
   {
+    // Decode before the next read, since delta encoded messages must be
+    // decoded in order, and messages must be taken out of the shared
+    // memory ring in the order of their placeholders
+    PublicationTransportPrivate *privateData = this->PublicationData();
+    std::string decoded;
+    const std::string *data = &_data;
+    if (privateData->shmPeer && _data == SharedMemoryRing::Placeholder())
+    {
+      if (!privateData->shmPeer->Take(privateData->shmChannel, decoded))
+      {
+        gzerr << "Missing shared memory message on topic[" << this->topic
+              << "]\n";
+        decoded.clear();
+      }
+      data = &decoded;
+    }
+    else if (privateData->codec && !_data.empty())
+    {
+      if (!privateData->codec->Decode(_data, decoded))
+      {
+        gzerr << "Unable to decode message on topic[" << this->topic
+              << "]\n";
+        decoded.clear();
+      }
+      data = &decoded;
+    }
+
     this->connection->AsyncRead(
         common::weakBind(&PublicationTransport::OnPublish,
             this->shared_from_this(), _1));
 
-    if (!_data.empty())
+    if (!data->empty())
     {
       if (this->callback)
-        (this->callback)(_data);
+        (this->callback)(*data);
     }
   }
 }
@@ -30,6 +30,9 @@ namespace gazebo
 {
   namespace transport
   {
+    // Forward declare private data class
+    class PublicationTransportPrivate;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -37,6 +40,13 @@ namespace gazebo
     /// transport/transport.hh
     /// \brief Reads data from a remote advertiser, and passes the data
     /// along to local subscribers
+    ///
+    /// When the GAZEBO_TRANSPORT_SHM environment variable is set to 1 and
+    /// the advertiser runs on the same host, messages are read from a
+    /// shared memory ring shared by all the links to the advertiser
+    /// process. The connection carries a placeholder for each of these
+    /// messages, and the messages that don't fit in the ring, so that
+    /// messages keep their order.
     class GZ_TRANSPORT_VISIBLE PublicationTransport :
         public boost::enable_shared_from_this<PublicationTransport>
     {
@@ -55,6 +65,22 @@ namespace gazebo
       /// topic.
       public: void Init(const ConnectionPtr &_conn, bool _latched);
 
+      /// \brief Initialize the transport, with delivery limits
+      /// \param[in] _conn The underlying connection.
+      /// \param[in] _latched True to grab the last message sent on the
+      /// topic.
+      /// \param[in] _maxRate Maximum rate in Hz at which the publisher
+      /// sends messages, 0 for no limit.
+      /// \param[in] _latestOnly True to ask the publisher to only send the
+      /// latest message while the connection is busy.
+      /// \param[in] _codec Codec the publisher uses to compress messages,
+      /// see MessageCodec. When empty, the GAZEBO_TRANSPORT_CODEC
+      /// environment variable is used. Links that use shared memory are
+      /// never compressed.
+      public: void Init(const ConnectionPtr &_conn, bool _latched,
+                  const double _maxRate, const bool _latestOnly,
+                  const std::string &_codec);
+
       /// \brief Finalize the transport
       public: void Fini();
 
@@ -79,6 +105,11 @@ namespace gazebo
       /// \param[in] _data Data to be published.
       private: void OnPublish(const std::string &_data);
 
+      /// \internal
+      /// \brief Get the private data of this transport.
+      /// \return The private data.
+      private: PublicationTransportPrivate *PublicationData() const;
+
       /// \brief The topic for this publication transport.
       private: std::string topic;
 
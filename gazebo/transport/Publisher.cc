@@ -17,19 +17,53 @@
 /* Desc: Handles pushing messages out on a named topic
  * Author: Nate Koenig
  */
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/bind.hpp>
 
 #include <ignition/math/Helpers.hh>
 
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/WeakBind.hh"
+#include "gazebo/transport/EncodedMessage.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/TopicManager.hh"
+#include "gazebo/transport/TopicStatistics.hh"
 #include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/PublisherPrivate.hh"
 
 using namespace gazebo;
 using namespace transport;
 
+/// \brief Number of messages a publisher recycles. Besides the message
+/// being filled, the outgoing queue and the latched message reference
+/// published messages for a while.
+static const size_t MESSAGE_POOL_SIZE = 4;
+
+namespace
+{
+  /// \brief Private data of the publishers, by publisher. It is kept out
+  /// of Publisher so that the layout of the class doesn't change.
+  class PublisherPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the publishers.
+    public: static PublisherPrivates &Instance()
+    {
+      static PublisherPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by publisher.
+    public: std::unordered_map<const Publisher *,
+            std::unique_ptr<PublisherPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
 uint32_t Publisher::idCounter = 0;
 
 //////////////////////////////////////////////////
@@ -38,6 +72,15 @@ Publisher::Publisher(const std::string &_topic, const std::string &_msgType,
   : topic(_topic), msgType(_msgType), queueLimit(_limit),
     updatePeriod(0)
 {
+  {
+    PublisherPrivate *data = new PublisherPrivate;
+    data->stats = TopicStatistics::Get(_topic);
+
+    PublisherPrivates &privates = PublisherPrivates::Instance();
+    std::lock_guard<std::mutex> lock(privates.mutex);
+    privates.data[this].reset(data);
+  }
+
   if (!ignition::math::equal(_hzRate, 0.0))
     this->updatePeriod = 1.0 / _hzRate;
 
@@ -50,6 +93,18 @@ Publisher::Publisher(const std::string &_topic, const std::string &_msgType,
 Publisher::~Publisher()
 {
   this->Fini();
+
+  PublisherPrivates &privates = PublisherPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+PublisherPrivate *Publisher::PublisherData() const
+{
+  PublisherPrivates &privates = PublisherPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
@@ -86,6 +141,52 @@ bool Publisher::WaitForConnection(const common::Time &_timeout) const
 //////////////////////////////////////////////////
 void Publisher::PublishImpl(const google::protobuf::Message &_message,
                             bool _block)
+{
+  if (!this->CanPublish(_message))
+    return;
+
+  // Save the latest message, in storage of a previous one
+  MessagePtr msgPtr = this->RecycledMessage(_message);
+  msgPtr->CopyFrom(_message);
+  this->PublishImpl(msgPtr, _block);
+}
+
+//////////////////////////////////////////////////
+MessagePtr Publisher::RecycledMessage(
+    const google::protobuf::Message &_prototype)
+{
+  if (_prototype.GetTypeName() != this->msgType)
+    gzthrow("Invalid message type\n");
+
+  PublisherPrivate *data = this->PublisherData();
+  std::lock_guard<std::mutex> lock(data->poolMutex);
+  for (auto const &msg : data->messagePool)
+  {
+    // Clear keeps the allocated strings and repeated messages
+    if (msg.use_count() == 1)
+    {
+      msg->Clear();
+      return msg;
+    }
+  }
+
+  MessagePtr msg(_prototype.New());
+  if (data->messagePool.size() < MESSAGE_POOL_SIZE)
+    data->messagePool.push_back(msg);
+  return msg;
+}
+
+//////////////////////////////////////////////////
+void Publisher::Publish(const MessagePtr &_message, bool _block)
+{
+  if (!_message || !this->CanPublish(*_message))
+    return;
+
+  this->PublishImpl(_message, _block);
+}
+
+//////////////////////////////////////////////////
+bool Publisher::CanPublish(const google::protobuf::Message &_message)
 {
   if (_message.GetTypeName() != this->msgType)
     gzthrow("Invalid message type\n");
@@ -95,7 +196,7 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     gzerr << "Publishing an uninitialized message on topic[" <<
       this->topic << "]. Required field [" <<
       _message.InitializationErrorString() << "] missing.\n";
-    return;
+    return false;
   }
 
   // Check if a throttling rate has been set
@@ -109,27 +210,36 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
         (this->currentTime - this->prevPublishTime).Double() <
         this->updatePeriod)
     {
-      return;
+      return false;
     }
 
     // Set the previous time a message was published
     this->prevPublishTime = this->currentTime;
   }
 
-  // Save the latest message
-  MessagePtr msgPtr(_message.New());
-  msgPtr->CopyFrom(_message);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Publisher::PublishImpl(const MessagePtr &_message, bool _block)
+{
+  TopicStats *stats = this->PublisherData()->stats;
+  EncodedMessagePtr encoded(new EncodedMessage(_message, stats));
 
-  this->publication->SetPrevMsg(this->id, msgPtr);
+  this->publication->SetPrevMsg(this->id, encoded);
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
 
-    this->messages.push_back(msgPtr);
+    this->messages.push_back(encoded);
+    ++stats->published;
+    ++stats->outgoing;
 
     if (this->messages.size() > this->queueLimit)
     {
       this->messages.pop_front();
+      ++stats->dropped;
+      --stats->outgoing;
 
       if (!queueLimitWarned)
       {
@@ -142,7 +252,9 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     }
   }
 
-  TopicManager::Instance()->AddNodeToProcess(this->node);
+  // Queue the publisher for the transport thread, without waiting for it
+  if (this->node)
+    TopicManager::Instance()->AddPublisherToProcess(shared_from_this());
 
   if (_block)
   {
@@ -158,7 +270,7 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
 //////////////////////////////////////////////////
 void Publisher::SendMessage()
 {
-  std::list<MessagePtr> localBuffer;
+  std::list<EncodedMessagePtr> localBuffer;
   std::list<uint32_t> localIds;
 
   {
@@ -177,6 +289,7 @@ void Publisher::SendMessage()
 
     std::copy(this->messages.begin(), this->messages.end(),
         std::back_inserter(localBuffer));
+    this->PublisherData()->stats->outgoing -= this->messages.size();
     this->messages.clear();
   }
 
@@ -186,7 +299,7 @@ void Publisher::SendMessage()
     std::list<uint32_t>::iterator pubIter = localIds.begin();
 
     // Send all the current messages
-    for (std::list<MessagePtr>::iterator iter = localBuffer.begin();
+    for (std::list<EncodedMessagePtr>::iterator iter = localBuffer.begin();
         iter != localBuffer.end(); ++iter, ++pubIter)
     {
       // Expected number of calls to the callback function
@@ -285,6 +398,7 @@ void Publisher::OnPublishComplete(uint32_t _id)
   if (!this->node)
     return;
 
+  bool pending = false;
   try {
     // This is the deeply unsatisfying way of dealing with a race
     // condition where the publisher is destroyed before all
@@ -294,11 +408,21 @@ void Publisher::OnPublishComplete(uint32_t _id)
     std::map<uint32_t, int>::iterator iter = this->pubIds.find(_id);
     if (iter != this->pubIds.end() && (--iter->second) <= 0)
       this->pubIds.erase(iter);
+
+    pending = this->pubIds.empty() && !this->messages.empty();
   }
   catch(...)
   {
     return;
   }
+
+  // Messages published while the previous ones were in flight can be sent
+  // now
+  if (pending)
+  {
+    TopicManager::Instance()->AddPublisherToProcess(shared_from_this());
+    ConnectionManager::Instance()->TriggerUpdate();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -318,7 +442,12 @@ void Publisher::Fini()
 {
   if (!this->messages.empty())
     this->SendMessage();
-  this->messages.clear();
+
+  {
+    boost::mutex::scoped_lock lock(this->mutex);
+    this->PublisherData()->stats->outgoing -= this->messages.size();
+    this->messages.clear();
+  }
 
   if (!this->topic.empty())
     TopicManager::Instance()->Unadvertise(this->topic, this->id);
@@ -332,9 +461,9 @@ std::string Publisher::GetPrevMsg() const
   std::string result;
   if (this->publication)
   {
-    MessagePtr msg = this->publication->GetPrevMsg(this->id);
+    EncodedMessagePtr msg = this->publication->GetPrevEncodedMsg(this->id);
     if (msg)
-      msg->SerializeToString(&result);
+      result = msg->Data();
   }
 
   return result;
@@ -349,6 +478,19 @@ MessagePtr Publisher::GetPrevMsgPtr() const
     return MessagePtr();
 }
 
+//////////////////////////////////////////////////
+void Publisher::SetPriority(const Priority _priority)
+{
+  if (_priority >= CONTROL && _priority < PRIORITY_COUNT)
+    this->PublisherData()->priority = _priority;
+}
+
+//////////////////////////////////////////////////
+Publisher::Priority Publisher::GetPriority() const
+{
+  return this->PublisherData()->priority;
+}
+
 //////////////////////////////////////////////////
 uint32_t Publisher::Id() const
 {
@@ -36,6 +36,8 @@ namespace gazebo
 {
   namespace transport
   {
+    class PublisherPrivate;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -44,6 +46,23 @@ namespace gazebo
     class GZ_TRANSPORT_VISIBLE Publisher :
         public boost::enable_shared_from_this<Publisher>
     {
+      /// \brief Priority classes of publishers. The transport thread sends
+      /// the messages of higher priority publishers first.
+      public: enum Priority
+              {
+                /// \brief Control, request and response topics.
+                CONTROL = 0,
+
+                /// \brief Default priority.
+                NORMAL = 1,
+
+                /// \brief Bulk data, such as images and contacts.
+                BULK = 2,
+
+                /// \brief Number of priority classes.
+                PRIORITY_COUNT = 3
+              };
+
       /// \brief Constructor
       /// \param[in] _topic Name of topic to be published
       /// \param[in] _msgType Type of the message to be published
@@ -101,6 +120,31 @@ namespace gazebo
               void Publish(M _message, bool _block = false)
               { this->PublishImpl(_message, _block); }
 
+      /// \brief Publish a message without copying it. The publisher and
+      /// the local subscribers keep references to the message, so it must
+      /// not be modified until the caller holds the only reference again,
+      /// which lets large messages, such as images, be reused.
+      /// \param[in] _message Message to be published.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written into the local message buffer, see Publish.
+      public: void Publish(const MessagePtr &_message, bool _block = false);
+
+      /// \brief Get an empty message to fill and publish with
+      /// Publish(const MessagePtr &). Messages are recycled once the
+      /// transport and the subscribers released them, and keep the storage
+      /// of their strings and repeated fields, so publishing a message every
+      /// cycle doesn't allocate.
+      ///
+      /// Wrap the message in a MessagePtr to publish it, e.g.
+      /// `pub->Publish(transport::MessagePtr(msg))`.
+      /// \return Message of the type of the publisher.
+      public: template<typename M>
+              boost::shared_ptr<M> BorrowMessage()
+              {
+                return boost::static_pointer_cast<M>(
+                    this->RecycledMessage(M::default_instance()));
+              }
+
       /// \brief Get the number of outgoing messages
       /// \return The number of outgoing messages
       public: unsigned int GetOutgoingCount() const;
@@ -136,6 +180,14 @@ namespace gazebo
       /// \brief Finalize the publisher.
       public: void Fini();
 
+      /// \brief Set the priority of the messages of this publisher.
+      /// \param[in] _priority The priority class.
+      public: void SetPriority(const Priority _priority);
+
+      /// \brief Get the priority of the messages of this publisher.
+      /// \return The priority class, NORMAL by default.
+      public: Priority GetPriority() const;
+
       /// \brief Get the id of this publisher.
       /// \return Unique id of this publisher.
       public: uint32_t Id() const;
@@ -147,6 +199,31 @@ namespace gazebo
       private: void PublishImpl(const google::protobuf::Message &_message,
                                 bool _block);
 
+      /// \brief Queue a message that passed CanPublish.
+      /// \param[in] _message Message to be published, which is not copied.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out.
+      private: void PublishImpl(const MessagePtr &_message, bool _block);
+
+      /// \brief Get a recycled message, or a new one if every message of the
+      /// pool is still referenced.
+      /// \param[in] _prototype Message of the type to get.
+      /// \return Empty message.
+      private: MessagePtr RecycledMessage(
+                   const google::protobuf::Message &_prototype);
+
+      /// \brief Check whether a message can be published now: its type
+      /// matches, it is initialized and the publisher is not throttled.
+      /// \param[in] _message Message to be published.
+      /// \return True if the message can be published.
+      private: bool CanPublish(const google::protobuf::Message &_message);
+
+      /// \internal
+      /// \brief Get the private data of this publisher. It is kept out of
+      /// the class so that its layout doesn't change.
+      /// \return The private data.
+      private: PublisherPrivate *PublisherData() const;
+
       /// \brief Callback when a publish is completed
       /// \param[in] _id ID associated with the publication.
       private: void OnPublishComplete(uint32_t _id);
@@ -169,8 +246,9 @@ namespace gazebo
       /// was produced.
       private: bool queueLimitWarned;
 
-      /// \brief List of messages to publish.
-      private: std::list<MessagePtr> messages;
+      /// \brief List of messages to publish, shared with the latched
+      /// message so that they are serialized once.
+      private: std::list<EncodedMessagePtr> messages;
 
       /// \brief For mutual exclusion.
       private: mutable boost::mutex mutex;
@@ -196,6 +274,11 @@ namespace gazebo
 
       /// \brief Counter to create unique ID for publishers.
       private: static uint32_t idCounter;
+
+
+      /// \brief The TopicManager manages the queued flag of the private
+      /// data.
+      private: friend class TopicManager;
     };
     /// \}
   }
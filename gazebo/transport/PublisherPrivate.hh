@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_PUBLISHERPRIVATE_HH_
+#define GAZEBO_TRANSPORT_PUBLISHERPRIVATE_HH_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/TopicStatistics.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the Publisher class. It is kept out of the
+    /// class, see Publisher::PublisherData, so that its layout doesn't
+    /// change.
+    class PublisherPrivate
+    {
+      /// \brief Priority of the messages.
+      public: std::atomic<Publisher::Priority> priority{Publisher::NORMAL};
+
+      /// \brief True while the publisher is in an outbound queue of the
+      /// TopicManager, so that it is queued once.
+      public: std::atomic<bool> queued{false};
+
+      /// \brief Stats of the topic, see TopicStatistics.
+      public: TopicStats *stats = nullptr;
+
+      /// \brief Messages recycled by Publisher::RecycledMessage.
+      public: std::vector<MessagePtr> messagePool;
+
+      /// \brief Protects messagePool.
+      public: std::mutex poolMutex;
+    };
+  }
+}
+#endif
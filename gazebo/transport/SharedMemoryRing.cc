@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifdef _WIN32
+  #include <process.h>
+  #define getpid _getpid
+#else
+  #include <unistd.h>
+#endif
+
+#ifdef __linux__
+  #include <dirent.h>
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <cerrno>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/SharedMemoryRing.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace ipc = boost::interprocess;
+
+/// \brief Beginning of a segment, followed by the ring.
+class RingHeader
+{
+  /// \brief Protects the other fields and the ring.
+  public: ipc::interprocess_mutex mutex;
+
+  /// \brief Notified when a message is written or the ring is closed.
+  public: ipc::interprocess_condition written;
+
+  /// \brief Size of the ring in bytes.
+  public: uint64_t capacity = 0;
+
+  /// \brief Total number of bytes written, including the size prefixes.
+  public: uint64_t head = 0;
+
+  /// \brief Total number of bytes read.
+  public: uint64_t tail = 0;
+
+  /// \brief True once either side closed the ring.
+  public: bool closed = false;
+};
+
+/// \brief Size of the prefix of each message: its size and its channel.
+static const uint64_t RECORD_PREFIX = 2 * sizeof(uint32_t);
+
+/// \brief Beginning of the names returned by UniqueName.
+static const char SEGMENT_PREFIX[] = "gazebo_shm_";
+
+namespace gazebo
+{
+namespace transport
+{
+/////////////////////////////////////////////////
+class SharedMemoryRingPrivate
+{
+  /// \brief Copy bytes into the ring, wrapping around its end.
+  /// \param[in] _offset Offset of the bytes, as a total count.
+  /// \param[in] _src Bytes to copy.
+  /// \param[in] _size Number of bytes.
+  public: void CopyIn(const uint64_t _offset, const char *_src,
+              const uint64_t _size)
+  {
+    const uint64_t start = _offset % this->header->capacity;
+    const uint64_t first = std::min(_size, this->header->capacity - start);
+    std::memcpy(this->ring + start, _src, first);
+    std::memcpy(this->ring, _src + first, _size - first);
+  }
+
+  /// \brief Copy bytes out of the ring, wrapping around its end.
+  /// \param[in] _offset Offset of the bytes, as a total count.
+  /// \param[out] _dst Destination of the bytes.
+  /// \param[in] _size Number of bytes.
+  public: void CopyOut(const uint64_t _offset, char *_dst,
+              const uint64_t _size) const
+  {
+    const uint64_t start = _offset % this->header->capacity;
+    const uint64_t first = std::min(_size, this->header->capacity - start);
+    std::memcpy(_dst, this->ring + start, first);
+    std::memcpy(_dst + first, this->ring, _size - first);
+  }
+
+  /// \brief Size and channel of the message at the tail of the ring.
+  /// \param[out] _channel Channel of the message.
+  /// \return Size of the message, without its prefix.
+  public: uint32_t TailSize(uint32_t &_channel) const
+  {
+    uint32_t prefix[2] = {0, 0};
+    this->CopyOut(this->header->tail, reinterpret_cast<char *>(prefix),
+        RECORD_PREFIX);
+    _channel = prefix[1];
+    return prefix[0];
+  }
+
+  /// \brief Name of the segment.
+  public: std::string name;
+
+  /// \brief Mapping of the segment.
+  public: ipc::mapped_region region;
+
+  /// \brief Header at the beginning of the segment.
+  public: RingHeader *header = nullptr;
+
+  /// \brief Ring, after the header.
+  public: char *ring = nullptr;
+
+  /// \brief True if the segment was created by this object.
+  public: bool owner = false;
+};
+}
+}
+
+/////////////////////////////////////////////////
+SharedMemoryRing::SharedMemoryRing()
+  : dataPtr(new SharedMemoryRingPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+SharedMemoryRing::~SharedMemoryRing()
+{
+  this->Close();
+  if (this->dataPtr->owner)
+    ipc::shared_memory_object::remove(this->dataPtr->name.c_str());
+}
+
+/////////////////////////////////////////////////
+bool SharedMemoryRing::Create(const std::string &_name,
+    const size_t _capacity)
+{
+  if (this->dataPtr->header)
+  {
+    gzerr << "Shared memory ring [" << this->dataPtr->name
+          << "] is already open\n";
+    return false;
+  }
+
+  if (_capacity <= RECORD_PREFIX)
+  {
+    gzerr << "Shared memory ring capacity [" << _capacity
+          << "] is too small\n";
+    return false;
+  }
+
+  static std::once_flag staleFlag;
+  std::call_once(staleFlag, []() { SharedMemoryRing::RemoveStale(); });
+
+  try
+  {
+    ipc::shared_memory_object::remove(_name.c_str());
+    ipc::shared_memory_object shm(ipc::create_only, _name.c_str(),
+        ipc::read_write);
+    this->dataPtr->owner = true;
+    this->dataPtr->name = _name;
+    shm.truncate(sizeof(RingHeader) + _capacity);
+#ifdef __linux__
+    // Truncating only makes a sparse segment, whose pages would raise
+    // SIGBUS when touched once /dev/shm is full. Allocate them now so that
+    // a full /dev/shm makes the creation fail instead.
+    const int err = posix_fallocate(shm.get_mapping_handle().handle, 0,
+        sizeof(RingHeader) + _capacity);
+    if (err != 0)
+    {
+      throw ipc::interprocess_exception(
+          ("posix_fallocate failed: " + std::string(strerror(err))).c_str());
+    }
+#endif
+    ipc::mapped_region region(shm, ipc::read_write);
+    this->dataPtr->region.swap(region);
+  }
+  catch(ipc::interprocess_exception &_e)
+  {
+    gzerr << "Unable to create shared memory ring [" << _name << "]: "
+          << _e.what() << std::endl;
+    if (this->dataPtr->owner)
+      ipc::shared_memory_object::remove(_name.c_str());
+    this->dataPtr->owner = false;
+    this->dataPtr->name.clear();
+    return false;
+  }
+
+  char *address = static_cast<char *>(this->dataPtr->region.get_address());
+  this->dataPtr->header = new (address) RingHeader;
+  this->dataPtr->header->capacity = _capacity;
+  this->dataPtr->ring = address + sizeof(RingHeader);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SharedMemoryRing::Open(const std::string &_name)
+{
+  if (this->dataPtr->header)
+  {
+    gzerr << "Shared memory ring [" << this->dataPtr->name
+          << "] is already open\n";
+    return false;
+  }
+
+  try
+  {
+    ipc::shared_memory_object shm(ipc::open_only, _name.c_str(),
+        ipc::read_write);
+    ipc::mapped_region region(shm, ipc::read_write);
+    this->dataPtr->region.swap(region);
+  }
+  catch(ipc::interprocess_exception &_e)
+  {
+    gzwarn << "Unable to open shared memory ring [" << _name << "]: "
+           << _e.what() << std::endl;
+    return false;
+  }
+
+  char *address = static_cast<char *>(this->dataPtr->region.get_address());
+  RingHeader *header = reinterpret_cast<RingHeader *>(address);
+  if (this->dataPtr->region.get_size() < sizeof(RingHeader) ||
+      this->dataPtr->region.get_size() < sizeof(RingHeader) + header->capacity)
+  {
+    gzerr << "Shared memory ring [" << _name << "] is truncated\n";
+    ipc::mapped_region empty;
+    this->dataPtr->region.swap(empty);
+    return false;
+  }
+
+  this->dataPtr->name = _name;
+  this->dataPtr->header = header;
+  this->dataPtr->ring = address + sizeof(RingHeader);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SharedMemoryRing::Write(const std::string &_data,
+    const uint32_t _channel)
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  const uint64_t needed = RECORD_PREFIX + _data.size();
+  if (needed > header->capacity)
+    return false;
+
+  {
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+    if (header->closed ||
+        header->capacity - (header->head - header->tail) < needed)
+    {
+      return false;
+    }
+
+    const uint32_t prefix[2] = {static_cast<uint32_t>(_data.size()),
+      _channel};
+    this->dataPtr->CopyIn(header->head,
+        reinterpret_cast<const char *>(prefix), RECORD_PREFIX);
+    this->dataPtr->CopyIn(header->head + RECORD_PREFIX, _data.data(),
+        _data.size());
+    header->head += needed;
+  }
+
+  header->written.notify_all();
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SharedMemoryRing::Read(std::string &_data,
+    const unsigned int _timeoutMs)
+{
+  uint32_t channel = 0;
+  return this->Read(_data, channel, _timeoutMs);
+}
+
+/////////////////////////////////////////////////
+bool SharedMemoryRing::Read(std::string &_data, uint32_t &_channel,
+    const unsigned int _timeoutMs)
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  const boost::posix_time::ptime timeout =
+    boost::posix_time::microsec_clock::universal_time() +
+    boost::posix_time::milliseconds(_timeoutMs);
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+  while (!header->closed && header->head == header->tail)
+  {
+    if (!header->written.timed_wait(lock, timeout))
+      break;
+  }
+
+  if (header->closed || header->head == header->tail)
+    return false;
+
+  const uint32_t size = this->dataPtr->TailSize(_channel);
+  _data.resize(size);
+  if (size > 0)
+    this->dataPtr->CopyOut(header->tail + RECORD_PREFIX, &_data[0], size);
+  header->tail += RECORD_PREFIX + size;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SharedMemoryRing::Close()
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return;
+
+  {
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+    header->closed = true;
+  }
+  header->written.notify_all();
+}
+
+/////////////////////////////////////////////////
+bool SharedMemoryRing::IsClosed() const
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return true;
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex);
+  return header->closed;
+}
+
+/////////////////////////////////////////////////
+std::string SharedMemoryRing::Name() const
+{
+  return this->dataPtr->header ? this->dataPtr->name : std::string();
+}
+
+/////////////////////////////////////////////////
+size_t SharedMemoryRing::Capacity() const
+{
+  return this->dataPtr->header ?
+    static_cast<size_t>(this->dataPtr->header->capacity) : 0;
+}
+
+/////////////////////////////////////////////////
+std::string SharedMemoryRing::UniqueName()
+{
+  static std::atomic<unsigned int> counter(0);
+  return SEGMENT_PREFIX + std::to_string(getpid()) + "_" +
+    std::to_string(counter++);
+}
+
+/////////////////////////////////////////////////
+const std::string &SharedMemoryRing::Placeholder()
+{
+  static const std::string placeholder(1, '\0');
+  return placeholder;
+}
+
+/////////////////////////////////////////////////
+unsigned int SharedMemoryRing::RemoveStale()
+{
+  unsigned int removed = 0;
+#ifdef __linux__
+  DIR *dir = opendir("/dev/shm");
+  if (!dir)
+    return removed;
+
+  const size_t prefixSize = sizeof(SEGMENT_PREFIX) - 1;
+  while (struct dirent *entry = readdir(dir))
+  {
+    const std::string name = entry->d_name;
+    if (name.compare(0, prefixSize, SEGMENT_PREFIX) != 0)
+      continue;
+
+    char *end = nullptr;
+    const long pid = std::strtol(name.c_str() + prefixSize, &end, 10);
+    if (pid <= 0 || *end != '_')
+      continue;
+
+    if (kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH &&
+        ipc::shared_memory_object::remove(name.c_str()))
+    {
+      ++removed;
+    }
+  }
+  closedir(dir);
+
+  if (removed > 0)
+  {
+    gzmsg << "Removed [" << removed << "] shared memory segments of "
+          << "processes that no longer run\n";
+  }
+#endif
+  return removed;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_SHAREDMEMORYRING_HH_
+#define GAZEBO_TRANSPORT_SHAREDMEMORYRING_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private class.
+    class SharedMemoryRingPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class SharedMemoryRing SharedMemoryRing.hh transport/transport.hh
+    /// \brief Ring buffer of serialized messages in a shared memory
+    /// segment, used instead of the socket when a publisher and a
+    /// subscriber run on the same host.
+    ///
+    /// The subscriber process creates the segment and reads from it, the
+    /// publisher process opens it and writes to it. Each message is tagged
+    /// with a channel so that several links between the same two processes
+    /// can share one ring. Messages are never dropped: a write fails when
+    /// the ring is full, and the message must be sent another way.
+    ///
+    /// Segment names encode the id of the creating process, and segments
+    /// left behind by processes that no longer run are removed by the next
+    /// Create.
+    class GZ_TRANSPORT_VISIBLE SharedMemoryRing
+    {
+      /// \brief Constructor.
+      public: SharedMemoryRing();
+
+      /// \brief Destructor. Closes the ring, and removes the segment if it
+      /// was created by this object.
+      public: ~SharedMemoryRing();
+
+      /// \brief Create a segment, replacing any stale segment of the same
+      /// name.
+      /// \param[in] _name Name of the segment, see UniqueName.
+      /// \param[in] _capacity Size of the ring in bytes.
+      /// \return False if the segment couldn't be created.
+      public: bool Create(const std::string &_name, const size_t _capacity);
+
+      /// \brief Open a segment created by another process.
+      /// \param[in] _name Name of the segment.
+      /// \return False if the segment doesn't exist.
+      public: bool Open(const std::string &_name);
+
+      /// \brief Copy a message at the end of the ring.
+      /// \param[in] _data The serialized message.
+      /// \param[in] _channel Channel of the message.
+      /// \return False if the ring is closed, or doesn't have room for the
+      /// message, in which case it must be sent another way.
+      public: bool Write(const std::string &_data,
+                  const uint32_t _channel = 0);
+
+      /// \brief Wait for the next message and copy it out of the ring.
+      /// \param[out] _data The serialized message, its storage is reused.
+      /// \param[in] _timeoutMs Maximum time to wait in milliseconds.
+      /// \return False on timeout or if the ring is closed.
+      public: bool Read(std::string &_data, const unsigned int _timeoutMs);
+
+      /// \brief Wait for the next message and copy it out of the ring.
+      /// \param[out] _data The serialized message, its storage is reused.
+      /// \param[out] _channel Channel of the message.
+      /// \param[in] _timeoutMs Maximum time to wait in milliseconds.
+      /// \return False on timeout or if the ring is closed.
+      public: bool Read(std::string &_data, uint32_t &_channel,
+                  const unsigned int _timeoutMs);
+
+      /// \brief Close the ring and wake the reader. Later writes fail.
+      public: void Close();
+
+      /// \brief Get whether the ring was closed, by either side.
+      /// \return True if the ring is closed or not open.
+      public: bool IsClosed() const;
+
+      /// \brief Get the name of the segment.
+      /// \return The name, empty if the ring is not open.
+      public: std::string Name() const;
+
+      /// \brief Get the size of the ring.
+      /// \return The size in bytes, 0 if the ring is not open.
+      public: size_t Capacity() const;
+
+      /// \brief Get a segment name that is unique on this host, and that
+      /// encodes the id of this process.
+      /// \return The name.
+      public: static std::string UniqueName();
+
+      /// \brief Get the message sent on the connection of a link in place
+      /// of each message written to the ring. The reader takes one message
+      /// of the link out of the ring for each placeholder, so that messages
+      /// sent through the ring and through the connection keep their order.
+      /// Serialized messages never start with a null byte.
+      /// \return The placeholder.
+      public: static const std::string &Placeholder();
+
+      /// \brief Remove the segments created by processes that no longer
+      /// run, for instance after a crash. Only implemented on Linux.
+      /// \return Number of segments removed.
+      public: static unsigned int RemoveStale();
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<SharedMemoryRingPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+#include <string>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "gazebo/transport/SharedMemoryRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SharedMemoryRing : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, CreateOpen)
+{
+  transport::SharedMemoryRing reader;
+  EXPECT_TRUE(reader.IsClosed());
+  EXPECT_EQ(reader.Capacity(), 0u);
+  EXPECT_FALSE(reader.Write("data"));
+
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  EXPECT_NE(name, transport::SharedMemoryRing::UniqueName());
+  ASSERT_TRUE(reader.Create(name, 64));
+  EXPECT_FALSE(reader.IsClosed());
+  EXPECT_EQ(reader.Name(), name);
+  EXPECT_EQ(reader.Capacity(), 64u);
+
+  transport::SharedMemoryRing writer;
+  ASSERT_TRUE(writer.Open(name));
+  EXPECT_EQ(writer.Capacity(), 64u);
+
+  transport::SharedMemoryRing missing;
+  EXPECT_FALSE(missing.Open(name + "_missing"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, WriteRead)
+{
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::SharedMemoryRing reader;
+  ASSERT_TRUE(reader.Create(name, 32));
+  transport::SharedMemoryRing writer;
+  ASSERT_TRUE(writer.Open(name));
+
+  // Messages wrap around the end of the ring
+  std::string data;
+  for (int i = 0; i < 20; ++i)
+  {
+    const std::string msg(1 + i % 9, static_cast<char>('a' + i));
+    EXPECT_TRUE(writer.Write(msg));
+    EXPECT_TRUE(reader.Read(data, 0));
+    EXPECT_EQ(data, msg);
+  }
+  EXPECT_FALSE(reader.Read(data, 10));
+
+  // Empty messages
+  EXPECT_TRUE(writer.Write(""));
+  EXPECT_TRUE(reader.Read(data, 0));
+  EXPECT_TRUE(data.empty());
+
+  // Too large for the ring
+  EXPECT_FALSE(writer.Write(std::string(25, 'x')));
+  EXPECT_TRUE(writer.Write(std::string(24, 'x')));
+  EXPECT_TRUE(reader.Read(data, 0));
+  EXPECT_EQ(data, std::string(24, 'x'));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, Full)
+{
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::SharedMemoryRing reader;
+  ASSERT_TRUE(reader.Create(name, 42));
+  transport::SharedMemoryRing writer;
+  ASSERT_TRUE(writer.Open(name));
+
+  // Three messages of 14 bytes fit, the fourth is refused instead of
+  // replacing the first
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(writer.Write(std::string(6, static_cast<char>('a' + i))));
+  EXPECT_FALSE(writer.Write(std::string(6, 'd')));
+
+  // Reading makes room
+  std::string data;
+  EXPECT_TRUE(reader.Read(data, 0));
+  EXPECT_EQ(data, std::string(6, 'a'));
+  EXPECT_TRUE(writer.Write(std::string(6, 'd')));
+
+  for (int i = 1; i < 4; ++i)
+  {
+    EXPECT_TRUE(reader.Read(data, 0));
+    EXPECT_EQ(data, std::string(6, static_cast<char>('a' + i)));
+  }
+  EXPECT_FALSE(reader.Read(data, 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, Channels)
+{
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::SharedMemoryRing reader;
+  ASSERT_TRUE(reader.Create(name, 1024));
+
+  // Two writers share the ring
+  transport::SharedMemoryRing writer1;
+  ASSERT_TRUE(writer1.Open(name));
+  transport::SharedMemoryRing writer2;
+  ASSERT_TRUE(writer2.Open(name));
+
+  EXPECT_TRUE(writer1.Write("one", 1));
+  EXPECT_TRUE(writer2.Write("two", 2));
+  EXPECT_TRUE(writer1.Write("three"));
+
+  std::string data;
+  uint32_t channel = 99;
+  EXPECT_TRUE(reader.Read(data, channel, 0));
+  EXPECT_EQ(data, "one");
+  EXPECT_EQ(channel, 1u);
+  EXPECT_TRUE(reader.Read(data, channel, 0));
+  EXPECT_EQ(data, "two");
+  EXPECT_EQ(channel, 2u);
+  EXPECT_TRUE(reader.Read(data, channel, 0));
+  EXPECT_EQ(data, "three");
+  EXPECT_EQ(channel, 0u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, Placeholder)
+{
+  // A serialized message never starts with a null byte, since field
+  // numbers start at 1
+  const std::string &placeholder =
+    transport::SharedMemoryRing::Placeholder();
+  ASSERT_EQ(placeholder.size(), 1u);
+  EXPECT_EQ(placeholder[0], '\0');
+}
+
+#ifdef __linux__
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, RemoveStale)
+{
+  // The first creation removes stale segments once
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::SharedMemoryRing live;
+  ASSERT_TRUE(live.Create(name, 64));
+
+  // Segment left by a process that no longer runs, as after a crash.
+  // Pids are below 4194304, the highest pid_max.
+  const std::string stale = "gazebo_shm_4194304_0";
+  {
+    boost::interprocess::shared_memory_object shm(
+        boost::interprocess::open_or_create, stale.c_str(),
+        boost::interprocess::read_write);
+    shm.truncate(64);
+  }
+
+  EXPECT_GE(transport::SharedMemoryRing::RemoveStale(), 1u);
+
+  transport::SharedMemoryRing removed;
+  EXPECT_FALSE(removed.Open(stale));
+
+  // The segment of this process is kept
+  transport::SharedMemoryRing writer;
+  EXPECT_TRUE(writer.Open(name));
+}
+#endif
+
+/////////////////////////////////////////////////
+TEST_F(SharedMemoryRing, Close)
+{
+  const std::string name = transport::SharedMemoryRing::UniqueName();
+  transport::SharedMemoryRing reader;
+  ASSERT_TRUE(reader.Create(name, 1024));
+  transport::SharedMemoryRing writer;
+  ASSERT_TRUE(writer.Open(name));
+
+  // A reader waiting for a message is woken by the writer
+  std::string data;
+  boost::thread thread([&writer]()
+      {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+        writer.Write("message");
+      });
+  EXPECT_TRUE(reader.Read(data, 5000));
+  EXPECT_EQ(data, "message");
+  thread.join();
+
+  // Closing wakes the reader, and makes later writes fail
+  boost::thread closer([&reader]()
+      {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+        reader.Close();
+      });
+  EXPECT_FALSE(reader.Read(data, 5000));
+  closer.join();
+  EXPECT_TRUE(writer.IsClosed());
+  EXPECT_FALSE(writer.Write("message"));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
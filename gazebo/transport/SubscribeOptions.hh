@@ -36,7 +36,7 @@ namespace gazebo
     {
       /// \brief Constructor
       public: SubscribeOptions()
-              : latching(false)
+              : latching(false), maxRate(0), latestOnly(false)
               {}
 
       /// \brief Initialize the options
@@ -103,10 +103,68 @@ namespace gazebo
                 return this->latching;
               }
 
+      /// \brief Set the maximum rate at which remote publishers send
+      /// messages. Messages above the rate are dropped by the publisher
+      /// before they are serialized.
+      /// \param[in] _rate Maximum rate in Hz, 0 for no limit.
+      public: void SetMaxRate(const double _rate)
+              {
+                this->maxRate = _rate > 0 ? _rate : 0;
+              }
+
+      /// \brief Get the maximum rate at which remote publishers send
+      /// messages.
+      /// \return Maximum rate in Hz, 0 for no limit.
+      public: double GetMaxRate() const
+              {
+                return this->maxRate;
+              }
+
+      /// \brief Set whether remote publishers only send the latest message
+      /// while the connection is busy writing a previous one. Older
+      /// messages are dropped instead of queued.
+      /// \param[in] _latestOnly True to only receive the latest message.
+      public: void SetLatestOnly(const bool _latestOnly)
+              {
+                this->latestOnly = _latestOnly;
+              }
+
+      /// \brief Get whether remote publishers only send the latest message.
+      /// \return True if only the latest message is sent.
+      public: bool GetLatestOnly() const
+              {
+                return this->latestOnly;
+              }
+
+      /// \brief Set the codec used by remote publishers to compress the
+      /// messages, see MessageCodec. This saves bandwidth on large
+      /// messages, such as scenes and poses, sent over slow networks.
+      /// \param[in] _codec Name of the codec, empty for none.
+      public: void SetCodec(const std::string &_codec)
+              {
+                this->codec = _codec;
+              }
+
+      /// \brief Get the codec used by remote publishers.
+      /// \return Name of the codec, empty for none.
+      public: std::string GetCodec() const
+              {
+                return this->codec;
+              }
+
       private: std::string topic;
       private: std::string msgType;
       private: NodePtr node;
       private: bool latching;
+
+      /// \brief Maximum rate in Hz, 0 for no limit.
+      private: double maxRate;
+
+      /// \brief True to only receive the latest message.
+      private: bool latestOnly;
+
+      /// \brief Name of the codec, empty for none.
+      private: std::string codec;
     };
     /// \}
   }
@@ -14,9 +14,18 @@
  * limitations under the License.
  *
 */
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include "gazebo/common/Time.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/EncodedMessage.hh"
+#include "gazebo/transport/MessageCodec.hh"
+#include "gazebo/transport/SharedMemoryRing.hh"
 #include "gazebo/transport/SubscriptionTransport.hh"
 
 using namespace gazebo;
@@ -24,9 +33,213 @@ using namespace transport;
 
 extern void dummy_callback_fn(uint32_t);
 
+namespace gazebo
+{
+namespace transport
+{
+/// \brief Delivery limits requested by a subscriber.
+class SubscriptionDelivery
+{
+  /// \brief Maximum rate in Hz, 0 for no limit.
+  public: double maxRate = 0;
+
+  /// \brief True to only keep the latest message while writing.
+  public: bool latestOnly = false;
+
+  /// \brief Protects the fields below.
+  public: boost::mutex mutex;
+
+  /// \brief Wall time of the last message sent.
+  public: common::Time lastSent;
+
+  /// \brief True while a message is queued on the connection.
+  public: bool writing = false;
+
+  /// \brief Latest message received while writing, null if none.
+  public: EncodedMessagePtr pending;
+
+  /// \brief Callback of the pending message.
+  public: boost::function<void(uint32_t)> pendingCb;
+
+  /// \brief ID of the pending message.
+  public: uint32_t pendingId = 0;
+
+  /// \brief Compresses the messages, null to send them as they are.
+  public: std::unique_ptr<MessageCodec> codec;
+
+  /// \brief True if the codec encodes messages against the previous one,
+  /// so that encoding and queueing must happen in the same order.
+  public: bool codecOrdered = false;
+
+  /// \brief Keeps the order of the messages of an ordered codec.
+  public: boost::mutex codecMutex;
+};
+
+/// \internal
+/// \brief Private data for the SubscriptionTransport class.
+class SubscriptionTransportPrivate
+{
+  /// \brief Shared memory ring used instead of the connection for
+  /// messages that fit in it, null if the subscriber is remote. The
+  /// ring is shared by the links to the same subscriber process.
+  public: std::shared_ptr<SharedMemoryRing> ring;
+
+  /// \brief Channel of the subscriber in the ring.
+  public: uint32_t shmChannel = 0;
+
+  /// \brief Rate limit and pending message of the subscriber, shared
+  /// with the write callbacks of the connection.
+  public: std::shared_ptr<SubscriptionDelivery> delivery;
+};
+}
+}
+
+namespace
+{
+  /// \brief Private data of the subscription transports, by transport.
+  /// It is kept out of SubscriptionTransport so that the layout of the
+  /// class doesn't change.
+  class SubscriptionTransportPrivates
+  {
+    /// \brief Get the instance.
+    /// \return The private data of all the transports.
+    public: static SubscriptionTransportPrivates &Instance()
+    {
+      static SubscriptionTransportPrivates instance;
+      return instance;
+    }
+
+    /// \brief Private data by transport.
+    public: std::unordered_map<const SubscriptionTransport *,
+            std::unique_ptr<SubscriptionTransportPrivate>> data;
+
+    /// \brief Protects data.
+    public: std::mutex mutex;
+  };
+}
+
+//////////////////////////////////////////////////
+/// \brief Queue a message on the connection to the subscriber, compressed
+/// if the subscriber asked for a codec.
+/// \param[in] _delivery Delivery state of the subscriber.
+/// \param[in] _conn Connection to the subscriber.
+/// \param[in] _data The serialized message.
+/// \param[in] _cb Callback invoked once the message is written.
+/// \param[in] _id ID of the message.
+static void SendEncoded(const std::shared_ptr<SubscriptionDelivery> &_delivery,
+    const ConnectionPtr &_conn, const std::string &_data,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  std::string encoded;
+  if (_delivery->codecOrdered)
+  {
+    boost::mutex::scoped_lock lock(_delivery->codecMutex);
+    _delivery->codec->Encode(_data, encoded);
+    _conn->EnqueueMsg(encoded, _cb, _id);
+  }
+  else
+  {
+    _delivery->codec->Encode(_data, encoded);
+    _conn->EnqueueMsg(encoded, _cb, _id);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Queue a message on the connection to the subscriber.
+/// \param[in] _delivery Delivery state of the subscriber.
+/// \param[in] _conn Connection to the subscriber.
+/// \param[in] _msg The message.
+/// \param[in] _cb Callback invoked once the message is written.
+/// \param[in] _id ID of the message.
+static void Send(const std::shared_ptr<SubscriptionDelivery> &_delivery,
+    const ConnectionPtr &_conn, const EncodedMessagePtr &_msg,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  if (_delivery->codec)
+    SendEncoded(_delivery, _conn, _msg->Data(), _cb, _id);
+  else
+    _conn->EnqueueMsg(_msg, _cb, _id);
+}
+
+//////////////////////////////////////////////////
+/// \brief Called when a message of a latest only subscriber is written,
+/// sends the pending message if any.
+/// \param[in] _delivery Delivery state of the subscriber.
+/// \param[in] _conn Connection to the subscriber.
+/// \param[in] _cb Callback of the written message.
+/// \param[in] _id ID of the written message.
+static void OnDelivered(std::shared_ptr<SubscriptionDelivery> _delivery,
+    boost::weak_ptr<Connection> _conn, boost::function<void(uint32_t)> _cb,
+    uint32_t _id)
+{
+  if (!_cb.empty())
+    _cb(_id);
+
+  EncodedMessagePtr msg;
+  boost::function<void(uint32_t)> cb;
+  uint32_t id = 0;
+  {
+    boost::mutex::scoped_lock lock(_delivery->mutex);
+    msg.swap(_delivery->pending);
+    cb.swap(_delivery->pendingCb);
+    id = _delivery->pendingId;
+    _delivery->writing = static_cast<bool>(msg);
+  }
+
+  if (!msg)
+    return;
+
+  ConnectionPtr conn = _conn.lock();
+  if (conn && conn->IsOpen())
+  {
+    Send(_delivery, conn, msg,
+        boost::bind(&OnDelivered, _delivery, _conn, cb, _1), id);
+  }
+  else
+  {
+    {
+      boost::mutex::scoped_lock lock(_delivery->mutex);
+      _delivery->writing = false;
+    }
+    if (!cb.empty())
+      cb(id);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Open a shared memory ring, or get the ring already opened by
+/// another link to the same subscriber process.
+/// \param[in] _name Name of the ring.
+/// \return The ring, null if it couldn't be opened.
+static std::shared_ptr<SharedMemoryRing> OpenRing(const std::string &_name)
+{
+  static boost::mutex registryMutex;
+  static std::map<std::string, std::weak_ptr<SharedMemoryRing>> registry;
+
+  boost::mutex::scoped_lock lock(registryMutex);
+  std::shared_ptr<SharedMemoryRing> ring = registry[_name].lock();
+  if (!ring)
+  {
+    ring.reset(new SharedMemoryRing());
+    if (!ring->Open(_name))
+    {
+      registry.erase(_name);
+      return nullptr;
+    }
+    registry[_name] = ring;
+  }
+  return ring;
+}
+
 //////////////////////////////////////////////////
 SubscriptionTransport::SubscriptionTransport()
 {
+  SubscriptionTransportPrivates &privates =
+    SubscriptionTransportPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  SubscriptionTransportPrivate *data = new SubscriptionTransportPrivate;
+  data->delivery.reset(new SubscriptionDelivery);
+  privates.data[this].reset(data);
 }
 
 //////////////////////////////////////////////////
@@ -34,35 +247,225 @@ SubscriptionTransport::~SubscriptionTransport()
 {
   ConnectionManager::Instance()->RemoveConnection(this->connection);
   this->connection.reset();
+
+  SubscriptionTransportPrivates &privates =
+    SubscriptionTransportPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  privates.data.erase(this);
+}
+
+//////////////////////////////////////////////////
+SubscriptionTransportPrivate *SubscriptionTransport::SubscriptionData() const
+{
+  SubscriptionTransportPrivates &privates =
+    SubscriptionTransportPrivates::Instance();
+  std::lock_guard<std::mutex> lock(privates.mutex);
+  return privates.data.at(this).get();
 }
 
 //////////////////////////////////////////////////
 void SubscriptionTransport::Init(ConnectionPtr _conn, bool _latching)
+{
+  this->Init(_conn, _latching, "", 0);
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::Init(ConnectionPtr _conn, bool _latching,
+    const std::string &_shmName, const uint32_t _shmChannel)
 {
   this->connection = _conn;
   this->latching = _latching;
+
+  if (!_shmName.empty())
+  {
+    SubscriptionTransportPrivate *data = this->SubscriptionData();
+    data->ring = OpenRing(_shmName);
+    data->shmChannel = _shmChannel;
+  }
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::SetDeliveryLimits(const double _maxRate,
+    const bool _latestOnly)
+{
+  const std::shared_ptr<SubscriptionDelivery> &delivery =
+    this->SubscriptionData()->delivery;
+
+  delivery->maxRate = _maxRate > 0 ? _maxRate : 0;
+  delivery->latestOnly = _latestOnly;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::SetCodec(const std::string &_codec)
+{
+  const std::shared_ptr<SubscriptionDelivery> &delivery =
+    this->SubscriptionData()->delivery;
+
+  if (_codec.empty())
+    return true;
+
+  // Messages of a latest only subscriber are queued from the write
+  // callbacks of the connection, which can't wait for the codec order, so
+  // they are compressed on their own
+  std::string name = _codec;
+  if (delivery->latestOnly && name == "zlib_delta")
+    name = "zlib";
+
+  delivery->codec = MessageCodec::Create(name);
+  if (!delivery->codec)
+  {
+    gzerr << "Unknown transport codec [" << _codec << "]\n";
+    return false;
+  }
+  delivery->codecOrdered = name == "zlib_delta";
+  return true;
 }
 
 //////////////////////////////////////////////////
 bool SubscriptionTransport::HandleMessage(MessagePtr _newMsg)
 {
-  std::string data;
-  _newMsg->SerializeToString(&data);
-  return this->HandleData(data, boost::bind(&dummy_callback_fn, _1), 0);
+  return this->OutputEncoded(EncodedMessagePtr(new EncodedMessage(_newMsg)),
+      boost::bind(&dummy_callback_fn, _1), 0);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::OutputEncoded(const EncodedMessagePtr &_msg,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  SubscriptionTransportPrivate *data = this->SubscriptionData();
+  bool result = false;
+  if (this->connection->IsOpen())
+  {
+    result = true;
+
+    // Drop messages above the rate requested by the subscriber, before
+    // they are serialized
+    if (this->RateLimited())
+    {
+      if (!_cb.empty())
+        _cb(_id);
+      return result;
+    }
+
+    // Messages written to the ring are replaced by a placeholder on the
+    // connection, which keeps their order with the messages that don't
+    // fit in the ring
+    if (data->ring && data->ring->Write(_msg->Data(), data->shmChannel))
+    {
+      this->connection->EnqueueMsg(SharedMemoryRing::Placeholder(), _cb,
+          _id);
+    }
+    else if (data->delivery->latestOnly)
+      this->EnqueueLatest(_msg, _cb, _id);
+    else
+      Send(data->delivery, this->connection, _msg, _cb, _id);
+  }
+  else
+  {
+    this->connection.reset();
+    data->ring.reset();
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::RateLimited()
+{
+  const std::shared_ptr<SubscriptionDelivery> &delivery =
+    this->SubscriptionData()->delivery;
+
+  if (delivery->maxRate <= 0)
+    return false;
+
+  boost::mutex::scoped_lock lock(delivery->mutex);
+  common::Time now = common::Time::GetWallTime();
+  if (delivery->lastSent != common::Time::Zero &&
+      (now - delivery->lastSent).Double() < 1.0 / delivery->maxRate)
+  {
+    return true;
+  }
+
+  delivery->lastSent = now;
+  return false;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::EnqueueLatest(const EncodedMessagePtr &_msg,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  const std::shared_ptr<SubscriptionDelivery> &delivery =
+    this->SubscriptionData()->delivery;
+
+  boost::function<void(uint32_t)> replacedCb;
+  uint32_t replacedId = 0;
+  bool send = false;
+  {
+    boost::mutex::scoped_lock lock(delivery->mutex);
+    if (delivery->writing)
+    {
+      // Replace the pending message, which is never sent
+      if (delivery->pending)
+      {
+        replacedCb.swap(delivery->pendingCb);
+        replacedId = delivery->pendingId;
+      }
+      delivery->pending = _msg;
+      delivery->pendingCb = _cb;
+      delivery->pendingId = _id;
+    }
+    else
+    {
+      delivery->writing = true;
+      send = true;
+    }
+  }
+
+  if (!replacedCb.empty())
+    replacedCb(replacedId);
+
+  if (!send)
+    return;
+
+  Send(delivery, this->connection, _msg, boost::bind(&OnDelivered,
+        delivery, boost::weak_ptr<Connection>(this->connection), _cb,
+        _1), _id);
 }
 
 //////////////////////////////////////////////////
 bool SubscriptionTransport::HandleData(const std::string &_newdata,
     boost::function<void(uint32_t)> _cb, uint32_t _id)
 {
+  SubscriptionTransportPrivate *data = this->SubscriptionData();
   bool result = false;
   if (this->connection->IsOpen())
   {
-    this->connection->EnqueueMsg(_newdata, _cb, _id);
+    if (this->RateLimited())
+    {
+      if (!_cb.empty())
+        _cb(_id);
+      return true;
+    }
+
+    // Messages written to the ring are replaced by a placeholder on the
+    // connection, which keeps their order with the messages that don't
+    // fit in the ring
+    if (data->ring && data->ring->Write(_newdata, data->shmChannel))
+    {
+      this->connection->EnqueueMsg(SharedMemoryRing::Placeholder(), _cb,
+          _id);
+    }
+    else if (data->delivery->codec)
+      SendEncoded(data->delivery, this->connection, _newdata, _cb, _id);
+    else
+      this->connection->EnqueueMsg(_newdata, _cb, _id);
     result = true;
   }
   else
+  {
     this->connection.reset();
+    data->ring.reset();
+  }
 
   return result;
 }
@@ -29,6 +29,9 @@ namespace gazebo
 {
   namespace transport
   {
+    // Forward declare private data class
+    class SubscriptionTransportPrivate;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -50,6 +53,31 @@ namespace gazebo
       /// don't latch
       public: void Init(ConnectionPtr _conn, bool _latching);
 
+      /// \brief Initialize the publication link, with a shared memory ring
+      /// \param[in] _conn The connection to use
+      /// \param[in] _latching If true, latch the latest message; if false,
+      /// don't latch
+      /// \param[in] _shmName Shared memory ring created by a subscriber on
+      /// the same host, empty to only use the connection.
+      /// \param[in] _shmChannel Channel of the subscriber in the ring.
+      public: void Init(ConnectionPtr _conn, bool _latching,
+                  const std::string &_shmName, const uint32_t _shmChannel);
+
+      /// \brief Limit the messages sent to the subscriber. Messages that
+      /// are dropped are not serialized.
+      /// \param[in] _maxRate Maximum rate in Hz, 0 for no limit.
+      /// \param[in] _latestOnly True to only keep the latest message while
+      /// the connection is busy writing a previous one.
+      public: void SetDeliveryLimits(const double _maxRate,
+                  const bool _latestOnly);
+
+      /// \brief Compress the messages sent to the subscriber. Must be
+      /// called after SetDeliveryLimits.
+      /// \param[in] _codec Name of the codec requested by the subscriber,
+      /// see MessageCodec, empty for none.
+      /// \return False if the codec is unknown.
+      public: bool SetCodec(const std::string &_codec);
+
       /// \brief Output a message to a connection
       /// \param[in] _newdata The message to be handled
       /// \return true if the message was handled successfully, false otherwise
@@ -62,6 +90,17 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool HandleMessage(MessagePtr _newMsg);
 
+      /// \brief Output a published message to the connection, see
+      /// CallbackHelper::HandleEncoded.
+      /// \param[in] _msg Published message, serialized once for all the
+      /// subscribers.
+      /// \param[in] _cb If non-null, callback to be invoked which signals
+      /// that transmission is complete.
+      /// \param[in] _id ID associated with the message data.
+      /// \return true if the connection is open; false otherwise
+      public: bool OutputEncoded(const EncodedMessagePtr &_msg,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
       /// \brief Get the connection we're using
       /// \return Pointer to the connection we're using
       public: const ConnectionPtr &GetConnection() const;
@@ -71,6 +110,25 @@ namespace gazebo
       /// is tied to a  remote connection
       public: virtual bool IsLocal() const;
 
+      /// \brief Check the rate requested by the subscriber, and record the
+      /// time of the message if it is sent.
+      /// \return True if the message must be dropped.
+      private: bool RateLimited();
+
+      /// \brief Send a message of a latest only subscriber, or keep it
+      /// as the pending message while a previous message is written.
+      /// \param[in] _msg The message.
+      /// \param[in] _cb Callback invoked once the message is written or
+      /// replaced.
+      /// \param[in] _id ID associated with the message.
+      private: void EnqueueLatest(const EncodedMessagePtr &_msg,
+                   boost::function<void(uint32_t)> _cb, uint32_t _id);
+
+      /// \internal
+      /// \brief Get the private data of this transport.
+      /// \return The private data.
+      private: SubscriptionTransportPrivate *SubscriptionData() const;
+
       private: ConnectionPtr connection;
     };
     /// \}
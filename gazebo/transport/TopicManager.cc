@@ -14,6 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
@@ -21,7 +25,9 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publication.hh"
+#include "gazebo/transport/PublisherPrivate.hh"
 #include "gazebo/transport/TopicManager.hh"
+#include "gazebo/transport/TopicStatistics.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -149,18 +155,55 @@ void TopicManager::AddNodeToProcess(NodePtr _ptr)
   }
 }
 
+//////////////////////////////////////////////////
+void TopicManager::AddPublisherToProcess(PublisherPtr _pub)
+{
+  if (_pub && !_pub->PublisherData()->queued.exchange(true))
+    this->outbound[_pub->GetPriority()].Push(_pub);
+}
+
 //////////////////////////////////////////////////
 void TopicManager::ProcessNodes(bool _onlyOut)
 {
   {
-    boost::mutex::scoped_lock lock(this->processNodesMutex);
-    for (boost::unordered_set<NodePtr>::iterator iter =
-        this->nodesToProcess.begin();
-        iter != this->nodesToProcess.end(); ++iter)
+    // Process the nodes outside of the lock, so that AddNodeToProcess
+    // doesn't wait for the messages to be sent
+    boost::unordered_set<NodePtr> nodes;
+    {
+      boost::mutex::scoped_lock lock(this->processNodesMutex);
+      nodes.swap(this->nodesToProcess);
+    }
+
+    for (boost::unordered_set<NodePtr>::iterator iter = nodes.begin();
+        iter != nodes.end(); ++iter)
     {
       (*iter)->ProcessPublishers();
     }
-    this->nodesToProcess.clear();
+  }
+
+  {
+    // Look at the highest priority queue again before each publisher, so
+    // that control messages pre-empt bulk data
+    boost::mutex::scoped_lock lock(this->outboundMutex);
+    boost::weak_ptr<Publisher> next;
+    int priority = 0;
+    while (priority < Publisher::PRIORITY_COUNT)
+    {
+      if (!this->outbound[priority].Pop(next))
+      {
+        ++priority;
+        continue;
+      }
+
+      PublisherPtr pub = next.lock();
+      next.reset();
+      if (pub)
+      {
+        pub->PublisherData()->queued = false;
+        pub->SendMessage();
+      }
+      priority = 0;
+    }
   }
 
   // Note: In general there are very few nodes. So, parallelization is not
@@ -227,10 +270,31 @@ PublicationPtr TopicManager::FindPublication(const std::string &_topic)
 SubscriberPtr TopicManager::Subscribe(const SubscribeOptions &_ops)
 {
   boost::mutex::scoped_lock lock(this->subscriberMutex);
+
+  // A remote publisher sends to all the subscribers of this process, so it
+  // can only drop messages that none of them want
+  std::list<NodePtr> &nodes = this->subscribedNodes[_ops.GetTopic()];
+  std::pair<double, bool> &limits = this->deliveryLimits[_ops.GetTopic()];
+  if (nodes.empty())
+    limits = std::make_pair(_ops.GetMaxRate(), _ops.GetLatestOnly());
+  else
+  {
+    if (limits.first > 0)
+    {
+      limits.first = _ops.GetMaxRate() > 0 ?
+        std::max(limits.first, _ops.GetMaxRate()) : 0;
+    }
+    limits.second = limits.second && _ops.GetLatestOnly();
+  }
+
+  std::string &codec = this->codecs[_ops.GetTopic()];
+  if (codec.empty())
+    codec = _ops.GetCodec();
+
   // Create a subscription (essentially a callback that gets
   // fired every time a Publish occurs on the corresponding
   // topic
-  this->subscribedNodes[_ops.GetTopic()].push_back(_ops.GetNode());
+  nodes.push_back(_ops.GetNode());
 
   // The object that gets returned to the caller of this
   // function
@@ -264,6 +328,11 @@ void TopicManager::Unsubscribe(const std::string &_topic,
       _node->GetMsgType(_topic));
 
   this->subscribedNodes[_topic].remove(_node);
+  if (this->subscribedNodes[_topic].empty())
+  {
+    this->deliveryLimits.erase(_topic);
+    this->codecs.erase(_topic);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -272,6 +341,7 @@ void TopicManager::ConnectPubToSub(const std::string &_topic,
 {
   PublicationPtr publication = this->FindPublication(_topic);
   publication->AddSubscription(_sublink);
+  TopicStatistics::Get(_topic)->AddConnection(_sublink->GetConnection());
 }
 
 //////////////////////////////////////////////////
@@ -320,18 +390,47 @@ void TopicManager::ConnectSubscribers(const std::string &_topic)
 
 //////////////////////////////////////////////////
 void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
+{
+  bool reachable = true;
+  this->ConnectSubToPub(_pub, reachable);
+}
+
+//////////////////////////////////////////////////
+void TopicManager::ConnectSubToPubs(const msgs::Publishers &_pubs)
+{
+  // Hosts and ports that could not be connected to
+  std::set<std::pair<std::string, unsigned int> > unreachable;
+
+  for (int i = 0; i < _pubs.publisher_size(); ++i)
+  {
+    const msgs::Publish &pub = _pubs.publisher(i);
+    std::pair<std::string, unsigned int> peer(pub.host(), pub.port());
+
+    bool reachable = unreachable.find(peer) == unreachable.end();
+    this->ConnectSubToPub(pub, reachable);
+    if (!reachable)
+      unreachable.insert(peer);
+  }
+}
+
+//////////////////////////////////////////////////
+void TopicManager::ConnectSubToPub(const msgs::Publish &_pub,
+    bool &_reachable)
 {
   this->UpdatePublications(_pub.topic(), _pub.msg_type());
 
   PublicationPtr publication = this->FindPublication(_pub.topic());
 
-  if (publication && !publication->HasTransport(_pub.host(), _pub.port()))
+  if (_reachable && publication &&
+      !publication->HasTransport(_pub.host(), _pub.port()))
   {
     // Connect to the remote publisher
     ConnectionPtr conn = ConnectionManager::Instance()->ConnectToRemoteHost(
         _pub.host(), _pub.port());
 
-    if (conn)
+    if (!conn)
+      _reachable = false;
+    else
     {
       // Create a transport link that will read from the connection, and
       // send data to a Publication.
@@ -354,7 +453,19 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
         }
       }
 
-      publink->Init(conn, latched);
+      std::pair<double, bool> limits(0, false);
+      std::map<std::string, std::pair<double, bool> >::const_iterator
+        limitsIter = this->deliveryLimits.find(_pub.topic());
+      if (limitsIter != this->deliveryLimits.end())
+        limits = limitsIter->second;
+
+      std::string codec;
+      std::map<std::string, std::string>::const_iterator codecIter =
+        this->codecs.find(_pub.topic());
+      if (codecIter != this->codecs.end())
+        codec = codecIter->second;
+
+      publink->Init(conn, latched, limits.first, limits.second, codec);
 
       publication->AddTransport(publink);
     }
@@ -20,10 +20,12 @@
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <map>
+#include <utility>
 #include <list>
 #include <string>
 #include <vector>
 #include <boost/unordered/unordered_set.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Exception.hh"
@@ -35,6 +37,7 @@
 #include "gazebo/transport/SubscriptionTransport.hh"
 #include "gazebo/transport/PublicationTransport.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/OutboundQueue.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/Publication.hh"
 #include "gazebo/transport/Subscriber.hh"
@@ -193,6 +196,12 @@ namespace gazebo
       /// \param[in] _pub The publish object to use
       public: void ConnectSubToPub(const msgs::Publish &_pub);
 
+      /// \brief Connect local Subscribers to remote Publishers, in order.
+      /// Once a connection to a host and port fails, the next publishers
+      /// on the same host and port are not tried.
+      /// \param[in] _pubs The publish objects to use
+      public: void ConnectSubToPubs(const msgs::Publishers &_pubs);
+
       /// \brief Disconnect a local publisher from a remote subscriber
       /// \param[in] _topic The topic to be disconnected
       /// \param[in] _host The host to be disconnected
@@ -240,6 +249,19 @@ namespace gazebo
       /// \param[in] _ptr Node to process.
       public: void AddNodeToProcess(NodePtr _ptr);
 
+      /// \brief Queue a publisher that has messages to send. This never
+      /// blocks, so it can be called from the world thread.
+      /// \param[in] _pub Publisher to process, in the queue of its
+      /// priority.
+      public: void AddPublisherToProcess(PublisherPtr _pub);
+
+      /// \brief Connect a local Subscriber to a remote Publisher.
+      /// \param[in] _pub The publish object to use
+      /// \param[in,out] _reachable False to skip connecting to the remote
+      /// host, set to false if connecting fails.
+      private: void ConnectSubToPub(const msgs::Publish &_pub,
+                                    bool &_reachable);
+
       /// \brief A map of string->list of Node pointers
       typedef std::map<std::string, std::list<NodePtr> > SubNodeMap;
 
@@ -247,6 +269,15 @@ namespace gazebo
       private: PublicationPtr_M advertisedTopics;
       private: PublicationPtr_M::iterator advertisedTopicsEnd;
       private: SubNodeMap subscribedNodes;
+
+      /// \brief Delivery limits sent to remote publishers of each topic, as
+      /// a maximum rate and a latest only flag. The limits are the loosest
+      /// requested by the subscribers of the topic.
+      private: std::map<std::string, std::pair<double, bool> > deliveryLimits;
+
+      /// \brief Codec requested from remote publishers of each topic, the
+      /// first one requested by a subscriber of the topic.
+      private: std::map<std::string, std::string> codecs;
       private: std::vector<NodePtr> nodes;
 
       /// \brief Nodes that require processing.
@@ -260,6 +291,13 @@ namespace gazebo
       /// \brief Mutex to protect node processing
       private: boost::mutex processNodesMutex;
 
+      /// \brief Publishers with messages to send, one queue per priority.
+      private: OutboundQueue<boost::weak_ptr<Publisher> >
+               outbound[Publisher::PRIORITY_COUNT];
+
+      /// \brief Only one thread at a time pops the outbound queues.
+      private: boost::mutex outboundMutex;
+
       private: bool pauseIncoming;
 
       // Singleton implementation
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <map>
+#include <memory>
+
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/TopicStatistics.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+/// \brief Stats of every topic seen by the process.
+class TopicStatsRegistry
+{
+  /// \brief Stats by topic.
+  public: std::map<std::string, std::unique_ptr<TopicStats>> stats;
+
+  /// \brief Stats in the order they were created.
+  public: std::vector<TopicStats *> ordered;
+
+  /// \brief Protects the stats.
+  public: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the registry of the stats. It is never destroyed, since
+/// publishers may be destroyed while the process exits.
+/// \return The registry.
+static TopicStatsRegistry &Registry()
+{
+  static TopicStatsRegistry *registry = new TopicStatsRegistry;
+  return *registry;
+}
+
+//////////////////////////////////////////////////
+TopicStats::TopicStats(const std::string &_topic)
+  : topic(_topic)
+{
+}
+
+//////////////////////////////////////////////////
+void TopicStats::RecordLatency(const int64_t _nsec)
+{
+  ++this->delivered;
+  this->totalLatency += _nsec;
+
+  int64_t max = this->maxLatency;
+  while (_nsec > max && !this->maxLatency.compare_exchange_weak(max, _nsec))
+  {
+  }
+}
+
+//////////////////////////////////////////////////
+void TopicStats::RecordSerialization(const int64_t _nsec)
+{
+  ++this->serialized;
+  this->totalSerialization += _nsec;
+}
+
+//////////////////////////////////////////////////
+void TopicStats::AddConnection(const ConnectionPtr &_conn)
+{
+  if (!_conn)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->connectionMutex);
+  this->connections.push_back(_conn);
+}
+
+//////////////////////////////////////////////////
+std::vector<ConnectionPtr> TopicStats::Connections()
+{
+  std::vector<ConnectionPtr> result;
+
+  std::lock_guard<std::mutex> lock(this->connectionMutex);
+  auto iter = this->connections.begin();
+  while (iter != this->connections.end())
+  {
+    ConnectionPtr conn = iter->lock();
+    if (conn && conn->IsOpen())
+    {
+      result.push_back(conn);
+      ++iter;
+    }
+    else
+      iter = this->connections.erase(iter);
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+TopicStats *TopicStatistics::Get(const std::string &_topic)
+{
+  TopicStatsRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto &stats = registry.stats[_topic];
+  if (!stats)
+  {
+    stats.reset(new TopicStats(_topic));
+    registry.ordered.push_back(stats.get());
+  }
+  return stats.get();
+}
+
+//////////////////////////////////////////////////
+std::vector<TopicStats *> TopicStatistics::Stats()
+{
+  TopicStatsRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.ordered;
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::Fill(msgs::TransportStats &_msg)
+{
+  for (auto const stats : Stats())
+  {
+    if (stats->topic.empty())
+      continue;
+
+    msgs::TransportStats::Topic *topicMsg = _msg.add_topic();
+    topicMsg->set_name(stats->topic);
+    topicMsg->set_published(stats->published);
+    topicMsg->set_dropped(stats->dropped);
+    topicMsg->set_outgoing(std::max<int64_t>(0, stats->outgoing));
+    topicMsg->set_incoming(std::max<int64_t>(0, stats->incoming));
+
+    const uint64_t delivered = stats->delivered;
+    topicMsg->set_delivered(delivered);
+    topicMsg->set_latency_avg(delivered > 0 ?
+        stats->totalLatency * 1e-9 / delivered : 0.0);
+    topicMsg->set_latency_max(stats->maxLatency * 1e-9);
+
+    const uint64_t serialized = stats->serialized;
+    topicMsg->set_serialized(serialized);
+    topicMsg->set_serialization_avg(serialized > 0 ?
+        stats->totalSerialization * 1e-9 / serialized : 0.0);
+
+    for (auto const &conn : stats->Connections())
+    {
+      msgs::TransportStats::Connection *connMsg = topicMsg->add_connection();
+      connMsg->set_remote_uri(conn->GetRemoteURI());
+      connMsg->set_queued_messages(conn->GetOutgoingCount());
+      connMsg->set_queued_bytes(conn->GetOutgoingBytes());
+    }
+  }
+}
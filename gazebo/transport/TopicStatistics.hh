@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_TOPICSTATISTICS_HH_
+#define GAZEBO_TRANSPORT_TOPICSTATISTICS_HH_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    class Connection;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class TopicStats TopicStatistics.hh transport/transport.hh
+    /// \brief Queue depths and delivery times of a topic in this process.
+    class GZ_TRANSPORT_VISIBLE TopicStats
+    {
+      /// \brief Constructor.
+      /// \param[in] _topic Fully qualified name of the topic.
+      public: explicit TopicStats(const std::string &_topic);
+
+      /// \brief Add the time from publication to the callbacks of a
+      /// message.
+      /// \param[in] _nsec Wall time in nanoseconds.
+      public: void RecordLatency(const int64_t _nsec);
+
+      /// \brief Add the time spent serializing a message.
+      /// \param[in] _nsec Wall time in nanoseconds.
+      public: void RecordSerialization(const int64_t _nsec);
+
+      /// \brief Add a connection to a remote subscriber of the topic.
+      /// \param[in] _conn The connection.
+      public: void AddConnection(const boost::shared_ptr<Connection> &_conn);
+
+      /// \brief Get the open connections to remote subscribers.
+      /// \return The connections.
+      public: std::vector<boost::shared_ptr<Connection>> Connections();
+
+      /// \brief Fully qualified name of the topic.
+      public: const std::string topic;
+
+      /// \brief Messages published.
+      public: std::atomic<uint64_t> published{0};
+
+      /// \brief Messages dropped because a publisher queue was full.
+      public: std::atomic<uint64_t> dropped{0};
+
+      /// \brief Messages in the publisher queues.
+      public: std::atomic<int64_t> outgoing{0};
+
+      /// \brief Messages in the node queues.
+      public: std::atomic<int64_t> incoming{0};
+
+      /// \brief Messages given to the callbacks of the nodes.
+      public: std::atomic<uint64_t> delivered{0};
+
+      /// \brief Total latency in nanoseconds.
+      public: std::atomic<int64_t> totalLatency{0};
+
+      /// \brief Longest latency in nanoseconds.
+      public: std::atomic<int64_t> maxLatency{0};
+
+      /// \brief Messages serialized.
+      public: std::atomic<uint64_t> serialized{0};
+
+      /// \brief Total serialization time in nanoseconds.
+      public: std::atomic<int64_t> totalSerialization{0};
+
+      /// \brief Connections to remote subscribers, pruned as they close.
+      private: std::vector<boost::weak_ptr<Connection>> connections;
+
+      /// \brief Protects connections.
+      private: std::mutex connectionMutex;
+    };
+
+    /// \class TopicStatistics TopicStatistics.hh transport/transport.hh
+    /// \brief Counts the messages queued, dropped and delivered on each
+    /// topic of this process.
+    ///
+    /// Publishers, nodes and encoded messages update the stats of their
+    /// topic with atomic counters, so counting doesn't add locks to the
+    /// publish path. The stats of a topic live until the end of the
+    /// process.
+    class GZ_TRANSPORT_VISIBLE TopicStatistics
+    {
+      /// \brief Get the stats of a topic, created on first use.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \return The stats, valid until the end of the process.
+      public: static TopicStats *Get(const std::string &_topic);
+
+      /// \brief Get the stats of all the topics.
+      /// \return Stats, in the order the topics were first seen.
+      public: static std::vector<TopicStats *> Stats();
+
+      /// \brief Fill a message with the stats of all the topics.
+      /// \param[out] _msg Message to fill.
+      public: static void Fill(msgs::TransportStats &_msg);
+    };
+    /// \}
+  }
+}
+#endif
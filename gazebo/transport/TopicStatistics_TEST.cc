@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/EncodedMessage.hh"
+#include "gazebo/transport/TopicStatistics.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TopicStatistics : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(TopicStatistics, Get)
+{
+  transport::TopicStats *stats =
+    transport::TopicStatistics::Get("/gazebo/test/stats_get");
+  ASSERT_NE(stats, nullptr);
+  EXPECT_EQ(stats->topic, "/gazebo/test/stats_get");
+  EXPECT_EQ(stats, transport::TopicStatistics::Get("/gazebo/test/stats_get"));
+  EXPECT_NE(stats, transport::TopicStatistics::Get("/gazebo/test/other"));
+
+  bool found = false;
+  for (auto const s : transport::TopicStatistics::Stats())
+    found = found || s == stats;
+  EXPECT_TRUE(found);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TopicStatistics, Fill)
+{
+  transport::TopicStats *stats =
+    transport::TopicStatistics::Get("/gazebo/test/stats_fill");
+  stats->published += 3;
+  ++stats->dropped;
+  stats->outgoing += 2;
+  stats->RecordLatency(1000000);
+  stats->RecordLatency(3000000);
+  stats->RecordSerialization(2000);
+
+  msgs::TransportStats msg;
+  transport::TopicStatistics::Fill(msg);
+
+  const msgs::TransportStats::Topic *topic = nullptr;
+  for (auto const &t : msg.topic())
+  {
+    if (t.name() == "/gazebo/test/stats_fill")
+      topic = &t;
+  }
+  ASSERT_NE(topic, nullptr);
+  EXPECT_EQ(topic->published(), 3u);
+  EXPECT_EQ(topic->dropped(), 1u);
+  EXPECT_EQ(topic->outgoing(), 2u);
+  EXPECT_EQ(topic->incoming(), 0u);
+  EXPECT_EQ(topic->delivered(), 2u);
+  EXPECT_DOUBLE_EQ(topic->latency_avg(), 0.002);
+  EXPECT_DOUBLE_EQ(topic->latency_max(), 0.003);
+  EXPECT_EQ(topic->serialized(), 1u);
+  EXPECT_DOUBLE_EQ(topic->serialization_avg(), 2e-6);
+  EXPECT_EQ(topic->connection_size(), 0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TopicStatistics, Serialization)
+{
+  transport::TopicStats *stats =
+    transport::TopicStatistics::Get("/gazebo/test/stats_serialization");
+
+  msgs::GzString *str = new msgs::GzString;
+  str->set_data("serialized once");
+  transport::EncodedMessage encoded(transport::MessagePtr(str), stats);
+  EXPECT_GT(encoded.PublishTime(), 0);
+
+  encoded.Data();
+  encoded.Data();
+  EXPECT_EQ(stats->serialized, 1u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -33,6 +33,7 @@ std::condition_variable g_responseCondition;
 std::mutex requestMutex;
 bool g_stopped = true;
 bool g_minimalComms = false;
+unsigned int g_ioThreadCount = 0;
 
 std::list<msgs::Request *> g_requests;
 std::list<boost::shared_ptr<msgs::Response> > g_responses;
@@ -358,6 +359,30 @@ bool transport::getMinimalComms()
   return g_minimalComms;
 }
 
+/////////////////////////////////////////////////
+void transport::setIOThreadCount(const unsigned int _count)
+{
+  g_ioThreadCount = _count;
+}
+
+/////////////////////////////////////////////////
+unsigned int transport::getIOThreadCount()
+{
+  if (g_ioThreadCount > 0)
+    return g_ioThreadCount;
+
+  const char *env = getenv("GAZEBO_IO_THREADS");
+  if (env)
+  {
+    const int count = atoi(env);
+    if (count > 0)
+      return count;
+    gzerr << "Invalid GAZEBO_IO_THREADS value [" << env
+          << "], using 1 IO thread\n";
+  }
+  return 1;
+}
+
 /////////////////////////////////////////////////
 transport::ConnectionPtr transport::connectToMaster()
 {
@@ -172,6 +172,19 @@ namespace gazebo
     GZ_TRANSPORT_VISIBLE
     bool getMinimalComms();
 
+    /// \brief Set the number of threads that handle the IO of the
+    /// connections. Must be called before transport::init to take effect.
+    /// \param[in] _count Number of threads, 0 to use the GAZEBO_IO_THREADS
+    /// environment variable, or 1 if it isn't set.
+    GZ_TRANSPORT_VISIBLE
+    void setIOThreadCount(const unsigned int _count);
+
+    /// \brief Get the number of threads that handle the IO of the
+    /// connections.
+    /// \return Number of threads, at least 1.
+    GZ_TRANSPORT_VISIBLE
+    unsigned int getIOThreadCount();
+
     /// \brief Create a connection to master.
     /// \return Connection to the master, NULL on error.
     GZ_TRANSPORT_VISIBLE
@@ -33,6 +33,7 @@ namespace gazebo
 {
   namespace transport
   {
+    class EncodedMessage;
     class Publisher;
     class Publication;
     class PublicationTransport;
@@ -44,6 +45,10 @@ namespace gazebo
     /// \brief Shared_ptr to protobuf message
     typedef boost::shared_ptr<google::protobuf::Message> MessagePtr;
 
+    /// \def EncodedMessagePtr
+    /// \brief Shared_ptr to EncodedMessage object
+    typedef boost::shared_ptr<EncodedMessage> EncodedMessagePtr;
+
     /// \def PublisherPtr
     /// \brief Shared_ptr to Publisher object
     typedef boost::shared_ptr<Publisher> PublisherPtr;
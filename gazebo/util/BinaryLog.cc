@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gazebo/gazebo_config.h>
+
+#include <fstream>
+#include <sstream>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/copy.hpp>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/util/BinaryLog.hh"
+
+using namespace gazebo;
+using namespace util;
+
+/// \brief Magic string at the start of a binary log file.
+static const std::string BINARY_LOG_MAGIC = "GZLOGBIN";
+
+/// \brief Magic string at the end of a binary log file's footer.
+static const std::string BINARY_LOG_INDEX_MAGIC = "GZLOGIDX";
+
+/// \brief Footer size: the index offset followed by the index magic string.
+static const size_t BINARY_LOG_FOOTER_SIZE = 8 + 8;
+
+/// \brief XML tag delimiting the beginning of a simulation time element.
+static const std::string START_TIME_TAG = "<sim_time>";
+
+/// \brief XML tag delimiting the end of a simulation time element.
+static const std::string END_TIME_TAG = "</sim_time>";
+
+#ifdef HAVE_ZSTD
+/// \brief Compression level of zstd chunks. Low levels keep up with high
+/// rate state logging.
+static const int ZSTD_LEVEL = 3;
+#endif
+
+//////////////////////////////////////////////////
+/// \brief Append an unsigned integer in little endian byte order.
+/// \param[in] _value Value to append.
+/// \param[in] _bytes Number of bytes to append.
+/// \param[in,out] _buffer Buffer to append to.
+static void appendUint(const uint64_t _value, const unsigned int _bytes,
+    std::string &_buffer)
+{
+  for (unsigned int i = 0; i < _bytes; ++i)
+    _buffer.push_back(static_cast<char>((_value >> (8 * i)) & 0xff));
+}
+
+//////////////////////////////////////////////////
+/// \brief Read an unsigned integer stored in little endian byte order.
+/// \param[in] _in Stream to read from.
+/// \param[in] _bytes Number of bytes to read.
+/// \param[out] _value Value read.
+/// \return False if the stream ended.
+static bool readUint(std::istream &_in, const unsigned int _bytes,
+    uint64_t &_value)
+{
+  unsigned char bytes[8];
+  if (!_in.read(reinterpret_cast<char *>(bytes), _bytes))
+    return false;
+
+  _value = 0;
+  for (unsigned int i = 0; i < _bytes; ++i)
+    _value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::IsBinary(const std::string &_filename)
+{
+  std::ifstream in(_filename, std::ios::binary);
+  std::string magic(BINARY_LOG_MAGIC.size(), '\0');
+  return in.read(&magic[0], magic.size()) && magic == BINARY_LOG_MAGIC;
+}
+
+//////////////////////////////////////////////////
+std::string BinaryLog::Begin(const msgs::LogFile::Header &_header)
+{
+  std::string buffer = BINARY_LOG_MAGIC;
+  appendUint(GZ_LOG_BINARY_VERSION, 4, buffer);
+  AppendRecord(_header, buffer);
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+std::string BinaryLog::End(const msgs::LogFile::Index &_index,
+    const uint64_t _offset)
+{
+  std::string buffer;
+  AppendRecord(_index, buffer);
+  appendUint(_offset, 8, buffer);
+  buffer.append(BINARY_LOG_INDEX_MAGIC);
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+size_t BinaryLog::AppendRecord(const google::protobuf::Message &_msg,
+    std::string &_buffer)
+{
+  std::string data;
+  _msg.SerializeToString(&data);
+
+  appendUint(data.size(), 4, _buffer);
+  _buffer.append(data);
+  return data.size() + 4;
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::ReadRecord(std::istream &_in, google::protobuf::Message &_msg)
+{
+  uint64_t size = 0;
+  if (!readUint(_in, 4, size))
+    return false;
+
+  // Don't trust the size of a truncated record
+  const std::streampos start = _in.tellg();
+  _in.seekg(0, std::ios::end);
+  const std::streampos end = _in.tellg();
+  _in.seekg(start);
+  if (start < 0 || static_cast<uint64_t>(end - start) < size)
+    return false;
+
+  std::string data(size, '\0');
+  if (size > 0 && !_in.read(&data[0], size))
+    return false;
+
+  return _msg.ParseFromString(data);
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::Open(std::istream &_in, msgs::LogFile::Header &_header,
+    msgs::LogFile::Index &_index)
+{
+  _index.Clear();
+
+  std::string magic(BINARY_LOG_MAGIC.size(), '\0');
+  if (!_in.read(&magic[0], magic.size()) || magic != BINARY_LOG_MAGIC)
+    return false;
+
+  uint64_t version = 0;
+  if (!readUint(_in, 4, version))
+    return false;
+
+  if (version > GZ_LOG_BINARY_VERSION)
+  {
+    gzerr << "Binary log format version[" << version << "] is newer than "
+          << "the supported version[" << GZ_LOG_BINARY_VERSION << "]\n";
+    return false;
+  }
+
+  if (!ReadRecord(_in, _header))
+  {
+    gzerr << "Unable to read the binary log header\n";
+    return false;
+  }
+
+  const std::streampos chunksStart = _in.tellg();
+
+  // Use the index of a complete file
+  _in.seekg(0, std::ios::end);
+  const std::streampos fileEnd = _in.tellg();
+  if (fileEnd - chunksStart >=
+      static_cast<std::streamoff>(BINARY_LOG_FOOTER_SIZE))
+  {
+    _in.seekg(fileEnd - static_cast<std::streamoff>(BINARY_LOG_FOOTER_SIZE));
+
+    uint64_t indexOffset = 0;
+    std::string indexMagic(BINARY_LOG_INDEX_MAGIC.size(), '\0');
+    if (readUint(_in, 8, indexOffset) &&
+        _in.read(&indexMagic[0], indexMagic.size()) &&
+        indexMagic == BINARY_LOG_INDEX_MAGIC)
+    {
+      _in.seekg(indexOffset);
+      if (ReadRecord(_in, _index))
+        return true;
+
+      _index.Clear();
+    }
+  }
+
+  // Without a footer, index the chunks by reading them all.
+  _in.clear();
+  _in.seekg(chunksStart);
+  while (true)
+  {
+    const std::streampos offset = _in.tellg();
+    msgs::LogFile::Chunk chunk;
+    if (!ReadRecord(_in, chunk))
+      break;
+
+    auto entry = _index.add_chunk();
+    entry->set_offset(static_cast<std::streamoff>(offset));
+    if (chunk.has_start_time())
+      entry->mutable_start_time()->CopyFrom(chunk.start_time());
+    if (chunk.has_end_time())
+      entry->mutable_end_time()->CopyFrom(chunk.end_time());
+  }
+  _in.clear();
+
+  gzwarn << "Binary log file has no index, it may be incomplete. "
+         << "Found " << _index.chunk_size() << " chunks.\n";
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::IsEncoding(const std::string &_encoding)
+{
+#ifdef HAVE_ZSTD
+  if (_encoding == "zstd")
+    return true;
+#endif
+  return _encoding == "txt" || _encoding == "zlib" || _encoding == "bz2";
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::Compress(const std::string &_data,
+    const std::string &_encoding, std::string &_compressed)
+{
+  _compressed.clear();
+
+  if (_encoding == "bz2")
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::bzip2_compressor());
+    out.push(std::back_inserter(_compressed));
+    boost::iostreams::copy(boost::make_iterator_range(_data), out);
+  }
+  else if (_encoding == "zlib")
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor());
+    out.push(std::back_inserter(_compressed));
+    boost::iostreams::copy(boost::make_iterator_range(_data), out);
+  }
+#ifdef HAVE_ZSTD
+  else if (_encoding == "zstd")
+  {
+    _compressed.resize(ZSTD_compressBound(_data.size()));
+    size_t size = ZSTD_compress(&_compressed[0], _compressed.size(),
+        _data.data(), _data.size(), ZSTD_LEVEL);
+    if (ZSTD_isError(size))
+    {
+      gzerr << "Unable to compress log data: "
+            << ZSTD_getErrorName(size) << "\n";
+      _compressed.clear();
+      return false;
+    }
+    _compressed.resize(size);
+  }
+#endif
+  else if (_encoding == "txt")
+    _compressed = _data;
+  else
+  {
+    gzerr << "Unknown log file encoding[" << _encoding << "]\n";
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::Decompress(const std::string &_compressed,
+    const std::string &_encoding, std::string &_data)
+{
+  _data.clear();
+
+  if (_encoding == "txt")
+  {
+    _data = _compressed;
+    return true;
+  }
+
+#ifdef HAVE_ZSTD
+  if (_encoding == "zstd")
+  {
+    auto size = ZSTD_getFrameContentSize(_compressed.data(),
+        _compressed.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+      gzerr << "Invalid zstd data in log file\n";
+      return false;
+    }
+
+    _data.resize(size);
+    size_t result = ZSTD_decompress(&_data[0], _data.size(),
+        _compressed.data(), _compressed.size());
+    if (ZSTD_isError(result))
+    {
+      gzerr << "Unable to decompress log data: "
+            << ZSTD_getErrorName(result) << "\n";
+      _data.clear();
+      return false;
+    }
+    _data.resize(result);
+    return true;
+  }
+#endif
+
+  boost::iostreams::filtering_istream in;
+  if (_encoding == "bz2")
+    in.push(boost::iostreams::bzip2_decompressor());
+  else if (_encoding == "zlib")
+    in.push(boost::iostreams::zlib_decompressor());
+  else
+  {
+    gzerr << "Invalid encoding[" << _encoding << "] in log file\n";
+    return false;
+  }
+
+  in.push(boost::make_iterator_range(_compressed));
+  boost::iostreams::copy(in, std::back_inserter(_data));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::Chunk(const std::string &_data, const std::string &_encoding,
+    msgs::LogFile::Chunk &_chunk)
+{
+  _chunk.Clear();
+  _chunk.set_encoding(_encoding);
+
+  if (!Compress(_data, _encoding, *_chunk.mutable_data()))
+    return false;
+
+  common::Time startTime, endTime;
+  if (SimTimes(_data, startTime, endTime))
+  {
+    msgs::Set(_chunk.mutable_start_time(), startTime);
+    msgs::Set(_chunk.mutable_end_time(), endTime);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::ChunkData(const msgs::LogFile::Chunk &_chunk,
+    std::string &_data)
+{
+  return Decompress(_chunk.data(), _chunk.encoding(), _data);
+}
+
+//////////////////////////////////////////////////
+bool BinaryLog::SimTimes(const std::string &_data, common::Time &_start,
+    common::Time &_end)
+{
+  auto from = _data.find(START_TIME_TAG);
+  auto to = _data.find(END_TIME_TAG, from);
+  if (from == std::string::npos || to == std::string::npos)
+    return false;
+
+  from += START_TIME_TAG.size();
+  std::istringstream startStream(_data.substr(from, to - from));
+  startStream >> _start;
+
+  to = _data.rfind(END_TIME_TAG);
+  from = _data.rfind(START_TIME_TAG, to);
+  from += START_TIME_TAG.size();
+  std::istringstream endStream(_data.substr(from, to - from));
+  endStream >> _end;
+
+  return true;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_UTIL_BINARYLOG_HH_
+#define GAZEBO_UTIL_BINARYLOG_HH_
+
+#include <cstdint>
+#include <istream>
+#include <string>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/util/system.hh"
+
+/// \brief Version of the binary log file layout. This is independent of
+/// GZ_LOG_VERSION, which versions the state data stored in the chunks.
+#define GZ_LOG_BINARY_VERSION 1
+
+namespace gazebo
+{
+  namespace util
+  {
+    /// \addtogroup gazebo_util
+    /// \{
+
+    /// \class BinaryLog BinaryLog.hh util/util.hh
+    /// \brief Functions to write and read binary state log files.
+    ///
+    /// A binary log file starts with a magic string and the
+    /// GZ_LOG_BINARY_VERSION, followed by length prefixed msgs::LogFile
+    /// records: one Header and any number of Chunk records. Chunk data is
+    /// compressed without any text encoding. A complete file ends with an
+    /// Index record, which holds the offset and simulation time range of
+    /// every chunk, and a footer pointing at the index. Files without a
+    /// footer, such as those of an interrupted recording, are indexed by
+    /// reading every chunk.
+    ///
+    /// \sa LogRecord, LogPlay
+    class GZ_UTIL_VISIBLE BinaryLog
+    {
+      /// \brief Get whether a file is a binary log file.
+      /// \param[in] _filename Path to the file.
+      /// \return True if the file starts with the binary log magic string.
+      public: static bool IsBinary(const std::string &_filename);
+
+      /// \brief Get the bytes that start a binary log file.
+      /// \param[in] _header Header of the log file.
+      /// \return Magic string, format version and header record.
+      public: static std::string Begin(const msgs::LogFile::Header &_header);
+
+      /// \brief Get the bytes that end a binary log file.
+      /// \param[in] _index Index of the chunks in the file.
+      /// \param[in] _offset Offset in the file at which the index record
+      /// will be written.
+      /// \return Index record and footer.
+      public: static std::string End(const msgs::LogFile::Index &_index,
+                                     const uint64_t _offset);
+
+      /// \brief Append a length prefixed record to a buffer.
+      /// \param[in] _msg Record to append.
+      /// \param[in,out] _buffer Buffer to append to.
+      /// \return Number of bytes appended.
+      public: static size_t AppendRecord(
+                  const google::protobuf::Message &_msg,
+                  std::string &_buffer);
+
+      /// \brief Read a length prefixed record.
+      /// \param[in] _in Stream positioned at the start of a record.
+      /// \param[out] _msg Record read.
+      /// \return False if the record is truncated or can't be parsed.
+      public: static bool ReadRecord(std::istream &_in,
+                                     google::protobuf::Message &_msg);
+
+      /// \brief Read the header and the index of a binary log file.
+      /// \param[in] _in Stream positioned at the start of the file.
+      /// \param[out] _header Header of the file.
+      /// \param[out] _index Index of the chunks in the file.
+      /// \return False if the file is not a readable binary log file.
+      public: static bool Open(std::istream &_in,
+                               msgs::LogFile::Header &_header,
+                               msgs::LogFile::Index &_index);
+
+      /// \brief Get whether an encoding is supported. The txt, zlib and
+      /// bz2 encodings are always available, zstd only if Gazebo was built
+      /// with libzstd.
+      /// \param[in] _encoding Name of the encoding.
+      /// \return True if data can be compressed with the encoding.
+      public: static bool IsEncoding(const std::string &_encoding);
+
+      /// \brief Compress data.
+      /// \param[in] _data Data to compress.
+      /// \param[in] _encoding Compression to use (txt, zlib, bz2 or zstd).
+      /// \param[out] _compressed Compressed data.
+      /// \return False if the encoding is not supported.
+      public: static bool Compress(const std::string &_data,
+                                   const std::string &_encoding,
+                                   std::string &_compressed);
+
+      /// \brief Decompress data.
+      /// \param[in] _compressed Compressed data.
+      /// \param[in] _encoding Compression of the data.
+      /// \param[out] _data Decompressed data.
+      /// \return False if the encoding is not supported or the data is
+      /// corrupt.
+      public: static bool Decompress(const std::string &_compressed,
+                                     const std::string &_encoding,
+                                     std::string &_data);
+
+      /// \brief Create a chunk from state data.
+      /// \param[in] _data State data, one or more <sdf> frames.
+      /// \param[in] _encoding Compression of the chunk, see IsEncoding.
+      /// \param[out] _chunk Chunk with compressed data and the simulation
+      /// time range of the frames.
+      /// \return False if the encoding is unknown.
+      public: static bool Chunk(const std::string &_data,
+                                const std::string &_encoding,
+                                msgs::LogFile::Chunk &_chunk);
+
+      /// \brief Get the uncompressed state data of a chunk.
+      /// \param[in] _chunk Chunk to read.
+      /// \param[out] _data State data.
+      /// \return False if the encoding is unknown.
+      public: static bool ChunkData(const msgs::LogFile::Chunk &_chunk,
+                                    std::string &_data);
+
+      /// \brief Find the simulation times of the first and the last frame
+      /// in state data.
+      /// \param[in] _data State data, one or more <sdf> frames.
+      /// \param[out] _start Simulation time of the first frame.
+      /// \param[out] _end Simulation time of the last frame.
+      /// \return False if the data has no <sim_time>.
+      public: static bool SimTimes(const std::string &_data,
+                                   common::Time &_start,
+                                   common::Time &_end);
+    };
+    /// \}
+  }
+}
+#endif
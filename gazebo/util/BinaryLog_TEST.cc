@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/util/BinaryLog.hh"
+#include "gazebo/util/LogPlay.hh"
+#include "gazebo/util/LogRecord.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class BinaryLog_TEST : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Initial world frame of the test log.
+static const std::string WORLD_FRAME =
+  "<sdf version='1.6'><world name='default'></world></sdf>";
+
+/////////////////////////////////////////////////
+/// \brief Get a state frame with the given simulation time.
+/// \param[in] _sec Simulation time in seconds.
+/// \return State frame.
+std::string stateFrame(const int _sec)
+{
+  std::ostringstream stream;
+  stream << "<sdf version='1.6'><state world_name='default'>"
+         << "<sim_time>" << _sec << " 0</sim_time>"
+         << "<iterations>" << _sec * 1000 << "</iterations>"
+         << "</state></sdf>";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a binary log file with a world chunk and two state chunks.
+/// \param[in] _filename File to write.
+/// \param[in] _complete False to leave out the index, as if recording was
+/// interrupted.
+void writeLog(const std::string &_filename, const bool _complete)
+{
+  msgs::LogFile::Header header;
+  header.set_log_version(GZ_LOG_VERSION);
+  header.set_gazebo_version("11.0.0");
+  header.set_rand_seed(1234);
+
+  std::string buffer = util::BinaryLog::Begin(header);
+
+  msgs::LogFile::Index index;
+  const std::string chunks[] = {WORLD_FRAME,
+      stateFrame(1) + stateFrame(2), stateFrame(3) + stateFrame(4)};
+  for (auto const &data : chunks)
+  {
+    msgs::LogFile::Chunk chunk;
+    ASSERT_TRUE(util::BinaryLog::Chunk(data, "zlib", chunk));
+
+    auto entry = index.add_chunk();
+    entry->set_offset(buffer.size());
+    if (chunk.has_start_time())
+      entry->mutable_start_time()->CopyFrom(chunk.start_time());
+    if (chunk.has_end_time())
+      entry->mutable_end_time()->CopyFrom(chunk.end_time());
+
+    util::BinaryLog::AppendRecord(chunk, buffer);
+  }
+
+  if (_complete)
+    buffer += util::BinaryLog::End(index, buffer.size());
+
+  std::ofstream out(_filename, std::ios::binary);
+  out.write(buffer.c_str(), buffer.size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(BinaryLog_TEST, Chunk)
+{
+  const std::string data = stateFrame(1) + stateFrame(2);
+
+  for (auto const &encoding : {"txt", "zlib", "bz2"})
+  {
+    msgs::LogFile::Chunk chunk;
+    EXPECT_TRUE(util::BinaryLog::Chunk(data, encoding, chunk));
+    EXPECT_EQ(encoding, chunk.encoding());
+    ASSERT_TRUE(chunk.has_start_time());
+    ASSERT_TRUE(chunk.has_end_time());
+    EXPECT_EQ(common::Time(1, 0), msgs::Convert(chunk.start_time()));
+    EXPECT_EQ(common::Time(2, 0), msgs::Convert(chunk.end_time()));
+
+    std::string result;
+    EXPECT_TRUE(util::BinaryLog::ChunkData(chunk, result));
+    EXPECT_EQ(data, result);
+  }
+
+  // Unknown encoding
+  msgs::LogFile::Chunk chunk;
+  EXPECT_FALSE(util::BinaryLog::Chunk(data, "garbage", chunk));
+
+  // Frames without a simulation time
+  EXPECT_TRUE(util::BinaryLog::Chunk(WORLD_FRAME, "txt", chunk));
+  EXPECT_FALSE(chunk.has_start_time());
+}
+
+/////////////////////////////////////////////////
+TEST_F(BinaryLog_TEST, Compress)
+{
+  const std::string data = stateFrame(1) + stateFrame(2) + stateFrame(3);
+
+  for (auto const &encoding : {"txt", "zlib", "bz2", "zstd"})
+  {
+    std::string compressed;
+    std::string result;
+    if (!util::BinaryLog::IsEncoding(encoding))
+    {
+      // zstd support is optional
+      EXPECT_EQ(std::string("zstd"), encoding);
+      EXPECT_FALSE(util::BinaryLog::Compress(data, encoding, compressed));
+      continue;
+    }
+
+    EXPECT_TRUE(util::BinaryLog::Compress(data, encoding, compressed));
+    EXPECT_FALSE(compressed.empty());
+    EXPECT_TRUE(util::BinaryLog::Decompress(compressed, encoding, result));
+    EXPECT_EQ(data, result);
+  }
+
+  std::string compressed;
+  EXPECT_FALSE(util::BinaryLog::IsEncoding("garbage"));
+  EXPECT_FALSE(util::BinaryLog::Compress(data, "garbage", compressed));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BinaryLog_TEST, Records)
+{
+  msgs::LogFile::Header header;
+  header.set_log_version(GZ_LOG_VERSION);
+  header.set_gazebo_version("11.0.0");
+  header.set_rand_seed(1234);
+
+  std::string buffer;
+  const size_t expectedSize = header.ByteSize() + 4;
+  EXPECT_EQ(expectedSize, util::BinaryLog::AppendRecord(header, buffer));
+  EXPECT_EQ(expectedSize, buffer.size());
+
+  std::istringstream in(buffer);
+  msgs::LogFile::Header result;
+  EXPECT_TRUE(util::BinaryLog::ReadRecord(in, result));
+  EXPECT_EQ(header.DebugString(), result.DebugString());
+
+  // Nothing left to read
+  EXPECT_FALSE(util::BinaryLog::ReadRecord(in, result));
+
+  // Truncated record
+  std::istringstream truncated(buffer.substr(0, buffer.size() - 1));
+  EXPECT_FALSE(util::BinaryLog::ReadRecord(truncated, result));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BinaryLog_TEST, Play)
+{
+  const std::string filename =
+    (boost::filesystem::temp_directory_path() /
+     boost::filesystem::unique_path("gz_binary_log_%%%%.log")).string();
+
+  util::LogPlay *player = util::LogPlay::Instance();
+
+  for (auto const complete : {true, false})
+  {
+    writeLog(filename, complete);
+    EXPECT_TRUE(util::BinaryLog::IsBinary(filename));
+
+    EXPECT_NO_THROW(player->Open(filename));
+    EXPECT_TRUE(player->IsOpen());
+    EXPECT_EQ(GZ_LOG_VERSION, player->LogVersion());
+    EXPECT_EQ("11.0.0", player->GazeboVersion());
+    EXPECT_EQ(1234u, player->RandSeed());
+    EXPECT_EQ(3u, player->ChunkCount());
+    EXPECT_EQ(common::Time(1, 0), player->LogStartTime());
+    EXPECT_EQ(common::Time(4, 0), player->LogEndTime());
+    EXPECT_TRUE(player->HasIterations());
+    EXPECT_EQ(1000u, player->InitialIterations());
+
+    std::string chunk;
+    EXPECT_TRUE(player->Chunk(1, chunk));
+    EXPECT_EQ(stateFrame(1) + stateFrame(2), chunk);
+    EXPECT_FALSE(player->Chunk(3, chunk));
+
+    // Step through every frame
+    EXPECT_TRUE(player->Rewind());
+    std::string frame;
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(1), frame);
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(2), frame);
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(3), frame);
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(4), frame);
+    EXPECT_FALSE(player->Step(frame));
+
+    // And back
+    EXPECT_TRUE(player->StepBack(frame));
+    EXPECT_EQ(stateFrame(3), frame);
+    EXPECT_TRUE(player->StepBack(frame));
+    EXPECT_EQ(stateFrame(2), frame);
+
+    // Seek through the chunk index
+    EXPECT_TRUE(player->Seek(common::Time(3, 0)));
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(3), frame);
+    EXPECT_TRUE(player->Seek(common::Time(2.5)));
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(3), frame);
+    EXPECT_TRUE(player->Seek(common::Time(2, 0)));
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(2), frame);
+    EXPECT_TRUE(player->Seek(common::Time(1, 0)));
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(1), frame);
+    EXPECT_TRUE(player->Seek(common::Time(10, 0)));
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(4), frame);
+  }
+
+  boost::filesystem::remove(filename);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BinaryLog_TEST, Prefetch)
+{
+  const std::string filename =
+    (boost::filesystem::temp_directory_path() /
+     boost::filesystem::unique_path("gz_binary_log_%%%%.log")).string();
+  writeLog(filename, true);
+
+  util::LogPlay *player = util::LogPlay::Instance();
+  EXPECT_NO_THROW(player->Open(filename));
+
+  // Read chunks in and out of the decode-ahead window
+  const std::string expected[] = {WORLD_FRAME,
+      stateFrame(1) + stateFrame(2), stateFrame(3) + stateFrame(4)};
+  for (auto const index : {0u, 1u, 2u, 1u, 0u, 2u, 2u})
+  {
+    std::string chunk;
+    EXPECT_TRUE(player->Chunk(index, chunk));
+    EXPECT_EQ(expected[index], chunk);
+  }
+
+  // Playback across chunks after moving around
+  EXPECT_TRUE(player->Rewind());
+  std::string frame;
+  for (int sec = 1; sec <= 4; ++sec)
+  {
+    EXPECT_TRUE(player->Step(frame));
+    EXPECT_EQ(stateFrame(sec), frame);
+  }
+  EXPECT_FALSE(player->Step(frame));
+
+  boost::filesystem::remove(filename);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
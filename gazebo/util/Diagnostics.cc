@@ -14,8 +14,12 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iomanip>
+#include <string>
+#include <vector>
 #include <ignition/math/SignalStats.hh>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/CommonIface.hh"
@@ -28,6 +32,29 @@
 using namespace gazebo;
 using namespace util;
 
+/// \brief Period at which the probe statistics are published.
+static const common::Timestamp PROBE_PUBLISH_PERIOD(1000000000);
+
+/// \brief Sample buffer of the calling thread, shared with the manager so
+/// that the samples recorded before the thread exits are still published.
+static thread_local std::shared_ptr<DiagnosticProbeRing> g_probeRing;
+
+//////////////////////////////////////////////////
+/// \brief Get the value of the samples at a percentile, with the nearest
+/// rank method. Reorders the samples.
+/// \param[in,out] _samples Samples, not empty.
+/// \param[in] _percentile Percentile, in (0, 1].
+/// \return The value at the percentile.
+static int64_t Percentile(std::vector<int64_t> &_samples,
+    const double _percentile)
+{
+  size_t rank = static_cast<size_t>(std::ceil(_percentile * _samples.size()));
+  rank = std::min(std::max(rank, static_cast<size_t>(1)), _samples.size());
+  std::nth_element(_samples.begin(), _samples.begin() + (rank - 1),
+      _samples.end());
+  return _samples[rank - 1];
+}
+
 //////////////////////////////////////////////////
 DiagnosticManager::DiagnosticManager()
 : dataPtr(new DiagnosticManagerPrivate)
@@ -59,6 +86,9 @@ DiagnosticManager::DiagnosticManager()
 #endif
 
   this->dataPtr->logPath = this->dataPtr->logPath / "diagnostics" / timeStr;
+
+  const char *probes = common::getEnv("GAZEBO_DIAGNOSTIC_PROBES");
+  this->dataPtr->probesEnabled = probes && std::string(probes) != "0";
 }
 
 //////////////////////////////////////////////////
@@ -116,10 +146,43 @@ void DiagnosticManager::Update(const common::UpdateInfo &_info)
   msgs::Set(this->dataPtr->msg.mutable_real_time(), _info.realTime);
   msgs::Set(this->dataPtr->msg.mutable_sim_time(), _info.simTime);
 
+  if (this->ProbesEnabled())
+  {
+    const common::Timestamp now = common::Timestamp::Now();
+    if (now - this->dataPtr->probePublishTime >= PROBE_PUBLISH_PERIOD)
+    {
+      this->dataPtr->probePublishTime = now;
+      for (auto const &stats : this->CollectProbes())
+      {
+        this->AddValue(stats.name + "/mean", stats.mean);
+        this->AddValue(stats.name + "/p50", stats.p50);
+        this->AddValue(stats.name + "/p99", stats.p99);
+        this->AddValue(stats.name + "/max", stats.max);
+      }
+
+      if (this->dataPtr->probeDropped > 0)
+      {
+        this->AddValue("diagnostic_probes/dropped",
+            static_cast<double>(this->dataPtr->probeDropped));
+        this->dataPtr->probeDropped = 0;
+      }
+    }
+  }
+
   if (this->dataPtr->pub && this->dataPtr->pub->HasConnections())
     this->dataPtr->pub->Publish(this->dataPtr->msg);
 
   this->dataPtr->msg.clear_time();
+  this->dataPtr->msg.clear_value();
+}
+
+//////////////////////////////////////////////////
+void DiagnosticManager::AddValue(const std::string &_name,
+    const double _value)
+{
+  msgs::Diagnostics::DiagValue *value = this->dataPtr->msg.add_value();
+  value->set_name(_name);
+  value->set_value(_value);
 }
 
 //////////////////////////////////////////////////
@@ -249,6 +312,114 @@ common::Time DiagnosticManager::Time(const std::string &_label) const
   return common::Time();
 }
 
+//////////////////////////////////////////////////
+uint32_t DiagnosticManager::ProbeId(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->probeMutex);
+  auto iter = this->dataPtr->probeIds.find(_name);
+  if (iter != this->dataPtr->probeIds.end())
+    return iter->second;
+
+  const uint32_t id = this->dataPtr->probeNames.size();
+  this->dataPtr->probeIds[_name] = id;
+  this->dataPtr->probeNames.push_back(_name);
+  return id;
+}
+
+//////////////////////////////////////////////////
+void DiagnosticManager::SetProbesEnabled(const bool _enabled)
+{
+  this->dataPtr->probesEnabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool DiagnosticManager::ProbesEnabled() const
+{
+  return this->dataPtr->probesEnabled.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void DiagnosticManager::RecordProbe(const uint32_t _id, const int64_t _nsec)
+{
+  if (!g_probeRing)
+  {
+    g_probeRing = std::make_shared<DiagnosticProbeRing>();
+    std::lock_guard<std::mutex> lock(this->dataPtr->probeMutex);
+    this->dataPtr->probeRings.push_back(g_probeRing);
+  }
+  g_probeRing->Push({_id, _nsec});
+}
+
+//////////////////////////////////////////////////
+std::vector<DiagnosticProbeStats> DiagnosticManager::CollectProbes()
+{
+  std::vector<DiagnosticProbeStats> result;
+  std::lock_guard<std::mutex> lock(this->dataPtr->probeMutex);
+
+  auto &rings = this->dataPtr->probeRings;
+  auto &samples = this->dataPtr->probeSamples;
+  for (auto iter = rings.begin(); iter != rings.end();)
+  {
+    // The buffer of a thread which exited is only held here
+    const bool orphan = iter->use_count() == 1;
+
+    (*iter)->Drain(samples);
+    this->dataPtr->probeDropped += (*iter)->dropped.exchange(0);
+
+    if (orphan)
+      iter = rings.erase(iter);
+    else
+      ++iter;
+  }
+
+  for (size_t id = 0; id < samples.size(); ++id)
+  {
+    std::vector<int64_t> &times = samples[id];
+    if (times.empty())
+      continue;
+
+    DiagnosticProbeStats stats;
+    stats.name = this->dataPtr->probeNames[id];
+    stats.count = times.size();
+
+    int64_t sum = 0;
+    int64_t max = times[0];
+    for (auto const time : times)
+    {
+      sum += time;
+      max = std::max(max, time);
+    }
+    stats.mean = sum * 1e-9 / times.size();
+    stats.max = max * 1e-9;
+
+    stats.p50 = Percentile(times, 0.5) * 1e-9;
+    stats.p99 = Percentile(times, 0.99) * 1e-9;
+
+    result.push_back(stats);
+    times.clear();
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+DiagnosticProbe::DiagnosticProbe(const uint32_t _id)
+: id(_id), start(-1)
+{
+  if (DiagnosticManager::Instance()->ProbesEnabled())
+    this->start = common::Timestamp::Now().Nanoseconds();
+}
+
+//////////////////////////////////////////////////
+DiagnosticProbe::~DiagnosticProbe()
+{
+  if (this->start >= 0)
+  {
+    DiagnosticManager::Instance()->RecordProbe(this->id,
+        common::Timestamp::Now().Nanoseconds() - this->start);
+  }
+}
+
 //////////////////////////////////////////////////
 DiagnosticTimer::DiagnosticTimer(const std::string &_name)
 : Timer(),
@@ -17,7 +17,10 @@
 #ifndef _GAZEBO_UTIL_DIAGNOSTICMANAGER_HH_
 #define _GAZEBO_UTIL_DIAGNOSTICMANAGER_HH_
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 
 #include "gazebo/gazebo_config.h"
@@ -66,12 +69,59 @@ namespace gazebo
     /// \param[in] name Name of the timer to stop
     #define DIAG_TIMER_STOP(_name) \
     gazebo::util::DiagnosticManager::Instance()->StopTimer(_name);
+
+    /// \brief Report a named value, such as a rate or a counter, with the
+    /// next diagnostics message.
+    /// \param[in] _name Name of the value.
+    /// \param[in] _value The value.
+    #define DIAG_VALUE(_name, _value) \
+    gazebo::util::DiagnosticManager::Instance()->AddValue(_name, _value);
 #else
     #define DIAG_TIMER_START(_name) ((void) 0)
     #define DIAG_TIMER_LAP(_name, _prefix) ((void)0)
     #define DIAG_TIMER_STOP(_name) ((void) 0)
+    #define DIAG_VALUE(_name, _value) ((void) 0)
 #endif
 
+    /// \brief Concatenate two tokens after expanding them, to name the
+    /// variables of DIAG_PROBE.
+    #define GZ_DIAG_PROBE_CONCAT_IMPL(_a, _b) _a##_b
+    #define GZ_DIAG_PROBE_CONCAT(_a, _b) GZ_DIAG_PROBE_CONCAT_IMPL(_a, _b)
+
+    /// \brief Time the rest of the enclosing scope with a probe. Unlike
+    /// the timers, probes are always compiled in, and only read the clock
+    /// when enabled with DiagnosticManager::SetProbesEnabled or the
+    /// GAZEBO_DIAGNOSTIC_PROBES environment variable. The name is looked
+    /// up once per call site.
+    /// \param[in] _name Name of the probe.
+    #define DIAG_PROBE(_name) \
+    static const uint32_t GZ_DIAG_PROBE_CONCAT(gzDiagProbeId, __LINE__) = \
+      gazebo::util::DiagnosticManager::Instance()->ProbeId(_name); \
+    gazebo::util::DiagnosticProbe GZ_DIAG_PROBE_CONCAT(gzDiagProbe, __LINE__)( \
+      GZ_DIAG_PROBE_CONCAT(gzDiagProbeId, __LINE__));
+
+    /// \brief Statistics of the samples of a probe.
+    class GZ_UTIL_VISIBLE DiagnosticProbeStats
+    {
+      /// \brief Name of the probe.
+      public: std::string name;
+
+      /// \brief Number of samples.
+      public: uint64_t count = 0;
+
+      /// \brief Mean time in seconds.
+      public: double mean = 0;
+
+      /// \brief Median time in seconds.
+      public: double p50 = 0;
+
+      /// \brief 99th percentile of the times in seconds.
+      public: double p99 = 0;
+
+      /// \brief Maximum time in seconds.
+      public: double max = 0;
+    };
+
     /// \class DiagnosticManager Diagnostics.hh util/util.hh
     /// \brief A diagnostic manager class
     class GZ_UTIL_VISIBLE DiagnosticManager :
@@ -107,6 +157,12 @@ namespace gazebo
       /// elapsed time.
       public: void Lap(const std::string &_name, const std::string &_prefix);
 
+      /// \brief Report a named value, such as a rate or a counter. The value
+      /// is published with the next diagnostics message.
+      /// \param[in] _name Name of the value.
+      /// \param[in] _value The value.
+      public: void AddValue(const std::string &_name, const double _value);
+
       /// \brief Get the number of timers
       /// \return The number of timers
       public: int TimerCount() const;
@@ -130,6 +186,26 @@ namespace gazebo
       /// \return The path in which logs are stored.
       public: boost::filesystem::path LogPath() const;
 
+      /// \brief Get the id of a probe, adding it if needed.
+      /// \param[in] _name Name of the probe.
+      /// \return Id of the probe.
+      public: uint32_t ProbeId(const std::string &_name);
+
+      /// \brief Enable or disable the probes.
+      /// \param[in] _enabled True to record the probes.
+      public: void SetProbesEnabled(const bool _enabled);
+
+      /// \brief Get whether the probes are enabled.
+      /// \return True if the probes are recorded.
+      public: bool ProbesEnabled() const;
+
+      /// \brief Take the samples recorded by the probes since the last
+      /// call. This is called once a second to publish the statistics on
+      /// ~/diagnostics, as values named after the probe followed by
+      /// "/mean", "/p50", "/p99" and "/max".
+      /// \return Statistics of each probe with samples.
+      public: std::vector<DiagnosticProbeStats> CollectProbes();
+
       /// \brief Publishes diagnostic information.
       /// \param[in] _info World update information.
       private: void Update(const common::UpdateInfo &_info);
@@ -146,9 +222,18 @@ namespace gazebo
       // Singleton implementation
       private: friend class SingletonT<DiagnosticManager>;
 
+      /// \brief Record a sample of a probe, in the buffer of the calling
+      /// thread.
+      /// \param[in] _id Id of the probe.
+      /// \param[in] _nsec Time in nanoseconds.
+      private: void RecordProbe(const uint32_t _id, const int64_t _nsec);
+
       /// \brief Give DiagnosticTimer special rights.
       private: friend class DiagnosticTimer;
 
+      /// \brief Give DiagnosticProbe special rights.
+      private: friend class DiagnosticProbe;
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<DiagnosticManagerPrivate> dataPtr;
@@ -187,6 +272,25 @@ namespace gazebo
       /// \brief Private data pointer
       private: std::unique_ptr<DiagnosticTimerPrivate> dataPtr;
     };
+
+    /// \class DiagnosticProbe Diagnostics.hh util/util.hh
+    /// \brief Times its own lifetime, if the probes are enabled when it's
+    /// constructed. Use DIAG_PROBE instead of constructing it directly.
+    class GZ_UTIL_VISIBLE DiagnosticProbe
+    {
+      /// \brief Constructor
+      /// \param[in] _id Id of the probe, from DiagnosticManager::ProbeId.
+      public: explicit DiagnosticProbe(const uint32_t _id);
+
+      /// \brief Destructor. Records the time since construction.
+      public: ~DiagnosticProbe();
+
+      /// \brief Id of the probe.
+      private: uint32_t id;
+
+      /// \brief Start time in nanoseconds, negative when disabled.
+      private: int64_t start;
+    };
     /// \}
   }
 }
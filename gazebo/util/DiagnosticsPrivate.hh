@@ -17,8 +17,14 @@
 #ifndef _GAZEBO_UTILS_DIAGNOSTICMANAGER_PRIVATE_HH_
 #define _GAZEBO_UTILS_DIAGNOSTICMANAGER_PRIVATE_HH_
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/unordered_map.hpp>
 #include <ignition/math/SignalStats.hh>
@@ -26,6 +32,7 @@
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Timestamp.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/util/UtilTypes.hh"
 
@@ -33,6 +40,69 @@ namespace gazebo
 {
   namespace util
   {
+    /// \brief A sample of a probe.
+    class DiagnosticProbeSample
+    {
+      /// \brief Id of the probe.
+      public: uint32_t id;
+
+      /// \brief Time in nanoseconds.
+      public: int64_t nsec;
+    };
+
+    /// \brief Buffer of the samples of the probes of one thread. Only
+    /// that thread pushes samples, and only the manager takes them, so the
+    /// buffer needs no lock.
+    class DiagnosticProbeRing
+    {
+      /// \brief Number of samples the buffer holds, a power of two.
+      public: static const size_t CAPACITY = 8192;
+
+      /// \brief Add a sample, or drop it if the buffer is full.
+      /// \param[in] _sample Sample to add.
+      public: void Push(const DiagnosticProbeSample &_sample)
+              {
+                const size_t h = this->head.load(std::memory_order_relaxed);
+                if (h - this->tail.load(std::memory_order_acquire) >=
+                    CAPACITY)
+                {
+                  this->dropped.fetch_add(1, std::memory_order_relaxed);
+                  return;
+                }
+                this->samples[h & (CAPACITY - 1)] = _sample;
+                this->head.store(h + 1, std::memory_order_release);
+              }
+
+      /// \brief Take all the samples in the buffer.
+      /// \param[out] _samples Samples taken, by probe id.
+      public: void Drain(std::vector<std::vector<int64_t>> &_samples)
+              {
+                const size_t t = this->tail.load(std::memory_order_relaxed);
+                const size_t h = this->head.load(std::memory_order_acquire);
+                for (size_t i = t; i != h; ++i)
+                {
+                  const DiagnosticProbeSample &sample =
+                    this->samples[i & (CAPACITY - 1)];
+                  if (sample.id >= _samples.size())
+                    _samples.resize(sample.id + 1);
+                  _samples[sample.id].push_back(sample.nsec);
+                }
+                this->tail.store(h, std::memory_order_release);
+              }
+
+      /// \brief Samples.
+      public: DiagnosticProbeSample samples[CAPACITY];
+
+      /// \brief Count of samples pushed.
+      public: std::atomic<size_t> head{0};
+
+      /// \brief Count of samples taken.
+      public: std::atomic<size_t> tail{0};
+
+      /// \brief Count of samples dropped because the buffer was full.
+      public: std::atomic<uint64_t> dropped{0};
+    };
+
     /// \brief Private data for the DiagnosticManager class
     class DiagnosticManagerPrivate
     {
@@ -53,6 +123,30 @@ namespace gazebo
 
       /// \brief Pointer to the update event connection
       public: event::ConnectionPtr updateConnection;
+
+      /// \brief True to record the probes.
+      public: std::atomic<bool> probesEnabled{false};
+
+      /// \brief Mutex to protect the probe names and buffers.
+      public: std::mutex probeMutex;
+
+      /// \brief Id of each probe, by name.
+      public: std::unordered_map<std::string, uint32_t> probeIds;
+
+      /// \brief Name of each probe, by id.
+      public: std::vector<std::string> probeNames;
+
+      /// \brief Sample buffers of the threads which recorded probes.
+      public: std::vector<std::shared_ptr<DiagnosticProbeRing>> probeRings;
+
+      /// \brief Samples taken from the buffers, by probe id.
+      public: std::vector<std::vector<int64_t>> probeSamples;
+
+      /// \brief Wall time when the probe statistics were last published.
+      public: common::Timestamp probePublishTime;
+
+      /// \brief Count of samples dropped since the last publication.
+      public: uint64_t probeDropped = 0;
     };
 
     /// \brief Private data for the DiagnosticTimer class
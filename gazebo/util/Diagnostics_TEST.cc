@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/Diagnostics.hh"
@@ -43,6 +45,52 @@ TEST_F(DiagnosticsTest, Diagnostics)
   EXPECT_TRUE(mgr->Time(0) <= after - prev);
 }
 
+/////////////////////////////////////////////////
+TEST_F(DiagnosticsTest, Probes)
+{
+  util::DiagnosticManager *mgr = util::DiagnosticManager::Instance();
+  mgr->CollectProbes();
+
+  // Names are interned once
+  const uint32_t id = mgr->ProbeId("probe_test");
+  EXPECT_EQ(id, mgr->ProbeId("probe_test"));
+  EXPECT_NE(id, mgr->ProbeId("probe_test_other"));
+
+  // Nothing is recorded while disabled
+  mgr->SetProbesEnabled(false);
+  for (int i = 0; i < 10; ++i)
+  {
+    DIAG_PROBE("probe_test");
+  }
+  EXPECT_TRUE(mgr->CollectProbes().empty());
+
+  // Samples from several threads are aggregated
+  mgr->SetProbesEnabled(true);
+  EXPECT_TRUE(mgr->ProbesEnabled());
+  auto record = []()
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      DIAG_PROBE("probe_test");
+    }
+  };
+  std::thread thread(record);
+  record();
+  thread.join();
+  mgr->SetProbesEnabled(false);
+
+  std::vector<util::DiagnosticProbeStats> stats = mgr->CollectProbes();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ("probe_test", stats[0].name);
+  EXPECT_EQ(200u, stats[0].count);
+  EXPECT_GE(stats[0].p50, 0.0);
+  EXPECT_LE(stats[0].p50, stats[0].p99);
+  EXPECT_LE(stats[0].p99, stats[0].max);
+  EXPECT_LE(stats[0].mean, stats[0].max);
+
+  // Samples are only returned once
+  EXPECT_TRUE(mgr->CollectProbes().empty());
+}
 
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
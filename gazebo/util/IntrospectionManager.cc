@@ -14,9 +14,11 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
 #include <functional>
 #include <set>
 #include <string>
+#include <vector>
 #include <ignition/math/Rand.hh>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -97,44 +99,151 @@ std::string IntrospectionManager::Id() const
   return this->dataPtr->managerId;
 }
 
+//////////////////////////////////////////////////
+/// \brief Add an item to the registered items.
+/// \param[in] _data Private data of the manager, locked.
+/// \param[in] _item Name of the item.
+/// \return The new item, or null if it was already registered.
+static IntrospectionItem *AddItem(IntrospectionManagerPrivate &_data,
+    const std::string &_item)
+{
+  // Sanity check: Make sure that nobody has registered the same item before.
+  if (_data.itemSlots.find(_item) != _data.itemSlots.end())
+  {
+    gzwarn << "Item [" << _item << "] already registered" << std::endl;
+    return nullptr;
+  }
+
+  size_t slot;
+  if (_data.freeSlots.empty())
+  {
+    slot = _data.items.size();
+    _data.items.emplace_back();
+  }
+  else
+  {
+    slot = _data.freeSlots.back();
+    _data.freeSlots.pop_back();
+  }
+
+  _data.itemSlots[_item] = slot;
+  _data.allItemsKeys.insert(_item);
+  _data.itemsUpdated = true;
+  _data.slotsDirty = true;
+
+  IntrospectionItem &item = _data.items[slot];
+  item.name = _item;
+  return &item;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the slots of the items of every filter, and the items
+/// observed by at least one filter.
+/// \param[in] _data Private data of the manager, locked.
+static void UpdateSlots(IntrospectionManagerPrivate &_data)
+{
+  std::vector<bool> observed(_data.items.size(), false);
+  _data.observedSlots.clear();
+
+  for (auto &filter : _data.filters)
+  {
+    filter.second.slots.clear();
+    for (auto const &name : filter.second.items)
+    {
+      // Items that aren't registered yet are ignored.
+      auto iter = _data.itemSlots.find(name);
+      if (iter == _data.itemSlots.end())
+        continue;
+
+      filter.second.slots.push_back(iter->second);
+      if (!observed[iter->second])
+      {
+        observed[iter->second] = true;
+        _data.observedSlots.push_back(iter->second);
+      }
+    }
+  }
+
+  std::sort(_data.observedSlots.begin(), _data.observedSlots.end());
+  _data.slotsDirty = false;
+}
+
 //////////////////////////////////////////////////
 bool IntrospectionManager::Register(const std::string &_item,
     const std::function <gazebo::msgs::Any ()> &_cb)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-  // Sanity check: Make sure that nobody has registered the same item before.
-  if (this->dataPtr->allItems.find(_item) != this->dataPtr->allItems.end())
-  {
-    gzwarn << "Item [" << _item << "] already registered" << std::endl;
+  IntrospectionItem *item = AddItem(*this->dataPtr, _item);
+  if (!item)
     return false;
-  }
 
-  this->dataPtr->allItemsKeys.insert(_item);
-  this->dataPtr->allItems[_item] = _cb;
+  item->callback = _cb;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool IntrospectionManager::Register(const std::string &_item,
+    const void *_obj, void (*_getter)(), const unsigned int _index,
+    IntrospectionSampler _sampler)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-  this->dataPtr->itemsUpdated = true;
+  IntrospectionItem *item = AddItem(*this->dataPtr, _item);
+  if (!item)
+    return false;
 
+  item->object = _obj;
+  item->getter = _getter;
+  item->index = _index;
+  item->sampler = _sampler;
   return true;
 }
 
+//////////////////////////////////////////////////
+void IntrospectionManager::SetValue(const double _v, msgs::Any &_value)
+{
+  _value.set_type(msgs::Any::DOUBLE);
+  _value.set_double_value(_v);
+}
+
+//////////////////////////////////////////////////
+void IntrospectionManager::SetValue(const ignition::math::Vector3d &_v,
+    msgs::Any &_value)
+{
+  _value.set_type(msgs::Any::VECTOR3D);
+  msgs::Set(_value.mutable_vector3d_value(), _v);
+}
+
+//////////////////////////////////////////////////
+void IntrospectionManager::SetValue(const ignition::math::Pose3d &_v,
+    msgs::Any &_value)
+{
+  _value.set_type(msgs::Any::POSE3D);
+  msgs::Set(_value.mutable_pose3d_value(), _v);
+}
+
 //////////////////////////////////////////////////
 bool IntrospectionManager::Unregister(const std::string &_item)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Sanity check: Make sure that the item has been previously registered.
-  if (this->dataPtr->allItems.find(_item) == this->dataPtr->allItems.end())
+  auto iter = this->dataPtr->itemSlots.find(_item);
+  if (iter == this->dataPtr->itemSlots.end())
   {
     gzwarn << "Item [" << _item << "] is not registered" << std::endl;
     return false;
   }
 
-  // Remove the item from the list of all items.
+  // Remove the item from the list of all items, and free its slot.
+  this->dataPtr->items[iter->second] = IntrospectionItem();
+  this->dataPtr->freeSlots.push_back(iter->second);
+  this->dataPtr->itemSlots.erase(iter);
   this->dataPtr->allItemsKeys.erase(_item);
-  this->dataPtr->allItems.erase(_item);
 
   this->dataPtr->itemsUpdated = true;
+  this->dataPtr->slotsDirty = true;
 
   return true;
 }
@@ -144,8 +253,11 @@ void IntrospectionManager::Clear()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   this->dataPtr->allItemsKeys.clear();
-  this->dataPtr->allItems.clear();
+  this->dataPtr->itemSlots.clear();
+  this->dataPtr->items.clear();
+  this->dataPtr->freeSlots.clear();
   this->dataPtr->itemsUpdated = true;
+  this->dataPtr->slotsDirty = true;
 }
 
 //////////////////////////////////////////////////
@@ -164,105 +276,62 @@ std::set<std::string> IntrospectionManager::Items() const
 //////////////////////////////////////////////////
 void IntrospectionManager::Update()
 {
-  std::map<std::string, IntrospectionFilter> filtersCopy;
-  std::map<std::string, ObservedItem> observedItemsCopy;
-  std::map<std::string, std::function <gazebo::msgs::Any ()>> usedItemsCopy;
-
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-    filtersCopy = this->dataPtr->filters;
-    observedItemsCopy = this->dataPtr->observedItems;
+    if (this->dataPtr->slotsDirty)
+      UpdateSlots(*this->dataPtr);
 
-    for (const auto &observedItem: this->dataPtr->observedItems)
+    // Update the values of the items under observation, in one pass over
+    // the items.
+    for (auto const slot : this->dataPtr->observedSlots)
     {
-      auto &item = observedItem.first;
-      // Sanity check: Make sure that someone registered this item.
-      if (this->dataPtr->allItemsKeys.count(item) == 0)
+      IntrospectionItem &item = this->dataPtr->items[slot];
+      try
       {
-        continue;
+        if (item.sampler)
+          item.sampler(item.object, item.getter, item.index, item.value);
+        else
+          item.value = item.callback();
       }
-
-      usedItemsCopy[item] = this->dataPtr->allItems[item];
-    }
-
-    for (auto& filter: filtersCopy)
-    {
-      for (auto const &item : filter.second.items)
+      catch(...)
       {
-        // Sanity check: Make sure that someone registered this item.
-        if (this->dataPtr->allItemsKeys.count(item) == 0)
-        {
-          continue;
-        }
-        usedItemsCopy[item] = this->dataPtr->allItems[item];
+        gzerr << "Exception caught calling user callback" << std::endl;
+        item.value.Clear();
       }
     }
-  }
-
-  for (auto &observedItem : observedItemsCopy)
-  {
-    auto &item = observedItem.first;
-    auto itemIter = usedItemsCopy.find(item);
-
-    // Sanity check: Make sure that we can update the item.
-    if (itemIter == usedItemsCopy.end())
-      continue;
-
-    try
-    {
-      // Update the values of the items under observation.
-      gazebo::msgs::Any value = itemIter->second();
-      auto &lastValue = observedItem.second.lastValue;
-      lastValue.CopyFrom(value);
-    }
-    catch(...)
-    {
-      gzerr << "Exception caught calling user callback" << std::endl;
-      continue;
-    }
-  }
-
-  // Prepare the next message to be sent in each filter.
-  for (auto &filter : filtersCopy)
-  {
-    // First of all, clear the old message.
-    auto &nextMsg = filter.second.msg;
-    nextMsg.Clear();
 
-    // Insert the last value of each item under observation for this filter.
-    for (auto const &item : filter.second.items)
+    // Prepare and publish the next message of each filter.
+    for (auto &filter : this->dataPtr->filters)
     {
-      // Sanity check: Make sure that someone registered this item.
-      if (usedItemsCopy.find(item) == usedItemsCopy.end())
+      auto &nextMsg = filter.second.msg;
+      if (!filter.second.pub.HasConnections())
         continue;
 
-      // Sanity check: Make sure that the value was updated.
-      // (e.g.: an exception was not raised).
-      auto &lastValue = observedItemsCopy[item].lastValue;
-      if (lastValue.type() == gazebo::msgs::Any::NONE)
-        continue;
+      // Clearing keeps the params allocated, for the next ones.
+      nextMsg.Clear();
 
-      auto nextParam = nextMsg.add_param();
-      nextParam->set_name(item);
-      nextParam->mutable_value()->CopyFrom(lastValue);
-    }
+      for (auto const slot : filter.second.slots)
+      {
+        // Sanity check: Make sure that the value was updated.
+        // (e.g.: an exception was not raised).
+        const IntrospectionItem &item = this->dataPtr->items[slot];
+        if (item.value.type() == gazebo::msgs::Any::NONE)
+          continue;
 
-    // Sanity check: Make sure that we have at least one item updated.
-    if (nextMsg.param_size() == 0)
-      continue;
+        auto nextParam = nextMsg.add_param();
+        nextParam->set_name(item.name);
+        nextParam->mutable_value()->CopyFrom(item.value);
+      }
 
-    // Publish the update for this filter.
-    std::string topicName = this->dataPtr->prefix + "filter/" + filter.first;
+      // Sanity check: Make sure that we have at least one item updated.
+      if (nextMsg.param_size() == 0)
+        continue;
 
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-      if (this->dataPtr->filterPubs.find(topicName) ==
-          this->dataPtr->filterPubs.end() ||
-          !this->dataPtr->filterPubs[topicName].Publish(nextMsg))
+      if (!filter.second.pub.Publish(nextMsg))
       {
-        gzerr << "Error publishing update for topic [" << topicName << "]"
-          << std::endl;
+        gzerr << "Error publishing update for topic [" << this->dataPtr->prefix
+          << "filter/" << filter.first << "]" << std::endl;
       }
     }
   }
@@ -318,11 +387,7 @@ bool IntrospectionManager::NewFilterImpl(const std::set<std::string> &_newItems,
     this->dataPtr->node.Advertise<gazebo::msgs::Param_V>(topicName);
 
   // Advertise the new topic.
-  if (pub)
-  {
-    this->dataPtr->filterPubs[topicName] = pub;
-  }
-  else
+  if (!pub)
   {
     gzerr << "Error advertising topic [" << topicName << "]." << std::endl;
     gzerr << "Ignoring request." << std::endl;
@@ -330,11 +395,10 @@ bool IntrospectionManager::NewFilterImpl(const std::set<std::string> &_newItems,
   }
 
   // Add the items to the new filter.
-  this->dataPtr->filters[_filterId].items = _newItems;
-
-  // Register the new filter in the list of observed items.
-  for (auto const &item : _newItems)
-    this->dataPtr->observedItems[item].filters.emplace(_filterId);
+  IntrospectionFilter &filter = this->dataPtr->filters[_filterId];
+  filter.items = _newItems;
+  filter.pub = pub;
+  this->dataPtr->slotsDirty = true;
 
   return true;
 }
@@ -354,44 +418,17 @@ bool IntrospectionManager::UpdateFilterImpl(const std::string &_filterId,
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Sanity check: Make sure that filter ID exists.
-  if (this->dataPtr->filters.find(_filterId) == this->dataPtr->filters.end())
+  auto iter = this->dataPtr->filters.find(_filterId);
+  if (iter == this->dataPtr->filters.end())
   {
     gzwarn << "Unknown ID [" << _filterId << "] in filter update" << std::endl;
     gzwarn << "Ignoring request." << std::endl;
     return false;
   }
 
-  // Save the old list of items.
-  auto oldItems = this->dataPtr->filters.at(_filterId).items;
-
   // Update the list of items for this filter.
-  this->dataPtr->filters[_filterId].items = _newItems;
-
-  // The next block is needed for updating the 'observedItems' data structure
-  // that contains references to the filters.
-  {
-    // We need to ensure that the items that were part of the old filter but are
-    // not in the new filter are removed.
-    for (auto const &oldItem : oldItems)
-    {
-      if (_newItems.find(oldItem) == _newItems.end())
-      {
-        auto &filters = this->dataPtr->observedItems[oldItem].filters;
-        filters.erase(_filterId);
-
-        // If there is nobody interested in this item, remove it.
-        if (filters.empty())
-          this->dataPtr->observedItems.erase(oldItem);
-      }
-    }
-
-    // We need to add the new items that were not part of the old filter.
-    for (auto const &newItem : _newItems)
-    {
-      if (oldItems.find(newItem) == oldItems.end())
-        this->dataPtr->observedItems[newItem].filters.emplace(_filterId);
-    }
-  }
+  iter->second.items = _newItems;
+  this->dataPtr->slotsDirty = true;
 
   return true;
 }
@@ -409,37 +446,9 @@ bool IntrospectionManager::RemoveFilterImpl(const std::string &_filterId)
     return false;
   }
 
-  // Unadvertise topic.
-  std::string topicName = this->dataPtr->prefix + "filter/" + _filterId;
-  if (this->dataPtr->filterPubs.find(topicName) ==
-      this->dataPtr->filterPubs.end())
-  {
-    gzerr << "Error unadvertising topic [" << topicName << "]" << std::endl;
-    gzerr << "Ignoring request." << std::endl;
-    return false;
-  }
-  else
-  {
-    // Removing the publisher should unadvertise the topic.
-    this->dataPtr->filterPubs.erase(topicName);
-  }
-
-  // Save the old list of items.
-  auto oldItems = this->dataPtr->filters.at(_filterId).items;
-
-  // Let's remove the filter.
+  // Removing the filter and its publisher should unadvertise the topic.
   this->dataPtr->filters.erase(_filterId);
-
-  // Remove any reference to this filter inside observedItems.
-  for (auto const &oldItem : oldItems)
-  {
-    auto &filters = this->dataPtr->observedItems[oldItem].filters;
-    filters.erase(_filterId);
-
-    // If there is nobody interested in this item, remove it.
-    if (filters.empty())
-      this->dataPtr->observedItems.erase(oldItem);
-  }
+  this->dataPtr->slotsDirty = true;
 
   return true;
 }
@@ -578,12 +587,12 @@ bool IntrospectionManager::Items(const gazebo::msgs::Empty &/*_req*/,
 {
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-    for (auto const &item : this->dataPtr->allItems)
+    for (auto const &item : this->dataPtr->allItemsKeys)
     {
       auto nextParam = _rep.add_param();
       nextParam->set_name("item");
       nextParam->mutable_value()->set_type(gazebo::msgs::Any::STRING);
-      nextParam->mutable_value()->set_string_value(item.first);
+      nextParam->mutable_value()->set_string_value(item);
     }
   }
   return true;
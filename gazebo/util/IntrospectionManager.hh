@@ -41,6 +41,25 @@ namespace gazebo
     // Forward declare private data classes.
     class IntrospectionManagerPrivate;
 
+    /// \brief Type of the functions that sample typed items.
+    template<typename T, typename C>
+    struct IntrospectionGetter
+    {
+      /// \brief Function returning the value of an item of an object.
+      /// \param[in] _obj Object the item belongs to.
+      /// \param[in] _index Index given at registration, e.g. a joint axis.
+      /// \return Value of the item.
+      typedef T (*Type)(const C &_obj, const unsigned int _index);
+    };
+
+    /// \brief Function that writes the value of a typed item.
+    /// \param[in] _obj Object the item belongs to.
+    /// \param[in] _getter Getter of the item, cast to a generic function.
+    /// \param[in] _index Index given at registration.
+    /// \param[out] _value Value of the item.
+    typedef void (*IntrospectionSampler)(const void *_obj,
+        void (*_getter)(), const unsigned int _index, msgs::Any &_value);
+
     /// addtogroup gazebo_util
     /// \{
 
@@ -70,6 +89,27 @@ namespace gazebo
         return this->Register(_item, func);
       }
 
+      /// \brief Register a new item sampled by a plain function of an object,
+      /// such as a lambda without captures. Unlike an item registered with a
+      /// std::function, the value is written in place, without converting
+      /// it to a new message.
+      /// \param[in] _item New item. E.g.: /default/world/model1/pose
+      /// \param[in] _obj Object passed to the getter, which must outlive
+      /// the registration.
+      /// \param[in] _getter Function returning the value of the item.
+      /// \param[in] _index Index passed to the getter.
+      /// \result True when the registration succeed or false otherwise
+      /// (item already existing).
+      public: template<typename T, typename C>
+      bool Register(const std::string &_item, const C &_obj,
+                    typename IntrospectionGetter<T, C>::Type _getter,
+                    const unsigned int _index = 0)
+      {
+        return this->Register(_item, &_obj,
+            reinterpret_cast<void (*)()>(_getter), _index,
+            &IntrospectionManager::Sample<T, C>);
+      }
+
       /// \brief Unregister an existing item from the introspection manager.
       /// \param[in] _item Item to remove.
       /// \return True if the unregistration succeed or false otherwise
@@ -86,7 +126,9 @@ namespace gazebo
       /// \brief Update all the items under observation and publish updates
       /// through all the topics. The message received in the update will
       /// contain the name and latest values of all the items specified
-      /// in the filter.
+      /// in the filter. Only the items of at least one filter are sampled,
+      /// and filters without subscribers are skipped. The callbacks are
+      /// called with the manager locked, so they must not call it.
       /// If there are changes in the items list since the last update,
       /// a new message is published under the topic
       /// "/introspection/<manager_id>/items_update".
@@ -111,6 +153,58 @@ namespace gazebo
       private: bool Register(const std::string &_item,
                              const std::function <gazebo::msgs::Any()> &_cb);
 
+      /// \brief Register a new typed item in the introspection manager.
+      /// \param[in] _item New item.
+      /// \param[in] _obj Object the item belongs to.
+      /// \param[in] _getter Getter of the item, cast to a generic function.
+      /// \param[in] _index Index passed to the getter.
+      /// \param[in] _sampler Function that calls the getter.
+      /// \result True when the registration succeed or false otherwise
+      /// (item already existing).
+      private: bool Register(const std::string &_item, const void *_obj,
+                             void (*_getter)(), const unsigned int _index,
+                             IntrospectionSampler _sampler);
+
+      /// \brief Call the getter of a typed item and write its value.
+      /// \param[in] _obj Object the item belongs to.
+      /// \param[in] _getter Getter of the item, cast to a generic function.
+      /// \param[in] _index Index passed to the getter.
+      /// \param[out] _value Value of the item.
+      private: template<typename T, typename C>
+      static void Sample(const void *_obj, void (*_getter)(),
+                         const unsigned int _index, msgs::Any &_value)
+      {
+        auto getter =
+          reinterpret_cast<typename IntrospectionGetter<T, C>::Type>(_getter);
+        SetValue(getter(*static_cast<const C *>(_obj), _index), _value);
+      }
+
+      /// \brief Write a value of a type without an overload below.
+      /// \param[in] _v Value.
+      /// \param[out] _value Message to write.
+      private: template<typename T>
+      static void SetValue(const T &_v, msgs::Any &_value)
+      {
+        _value = msgs::ConvertAny(_v);
+      }
+
+      /// \brief Write a double value, reusing the message.
+      /// \param[in] _v Value.
+      /// \param[out] _value Message to write.
+      private: static void SetValue(const double _v, msgs::Any &_value);
+
+      /// \brief Write a vector value, reusing the message.
+      /// \param[in] _v Value.
+      /// \param[out] _value Message to write.
+      private: static void SetValue(const ignition::math::Vector3d &_v,
+                                    msgs::Any &_value);
+
+      /// \brief Write a pose value, reusing the message.
+      /// \param[in] _v Value.
+      /// \param[out] _value Message to write.
+      private: static void SetValue(const ignition::math::Pose3d &_v,
+                                    msgs::Any &_value);
+
       /// \brief Create a new filter for observing item updates. This function
       /// will create a new topic for sending periodic updates of the items
       /// specified in the filter.
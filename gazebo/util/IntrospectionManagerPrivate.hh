@@ -22,6 +22,7 @@
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 #include <ignition/transport.hh>
 #include "gazebo/msgs/any.pb.h"
 #include "gazebo/msgs/param_v.pb.h"
@@ -37,47 +38,75 @@ namespace gazebo
       /// \brief Items observed by this filter.
       std::set<std::string> items;
 
+      /// \brief Slots of the registered items of this filter, in the order
+      /// of the items.
+      std::vector<size_t> slots;
+
       /// \brief Message containing the next update. A message is a collection
-      /// of items and values.
+      /// of items and values. It's reused to avoid allocating every update.
       msgs::Param_V msg;
+
+      /// \brief Publisher of the updates.
+      ignition::transport::Node::Publisher pub;
     };
 
-    /// \brief Todo.
-    struct ObservedItem
+    /// \brief An item registered in the manager.
+    struct IntrospectionItem
     {
-      /// \brief ToDo.
-      gazebo::msgs::Any lastValue;
+      /// \brief Name of the item, empty for a free slot.
+      std::string name;
+
+      /// \brief Callback of an item registered with a std::function.
+      std::function<gazebo::msgs::Any ()> callback;
+
+      /// \brief Object of a typed item.
+      const void *object = nullptr;
+
+      /// \brief Getter of a typed item.
+      void (*getter)() = nullptr;
+
+      /// \brief Index passed to the getter of a typed item.
+      unsigned int index = 0;
 
-      /// \brief ToDo.
-      std::set<std::string> filters;
+      /// \brief Function that calls the getter of a typed item, null for
+      /// items with a callback.
+      IntrospectionSampler sampler = nullptr;
+
+      /// \brief Last value sampled.
+      gazebo::msgs::Any value;
     };
 
     /// \brief Private data for the IntrospectionManager class.
     class IntrospectionManagerPrivate
     {
       /// \brief List of active filters.
-      /// The key is the topic where the filter publishes updates.
+      /// The key is the filter ID.
       /// The value is the associated introspection filter.
       public: std::map<std::string, IntrospectionFilter> filters;
 
-      /// \brief List of all registered items.
-      /// The key contains the item name.
-      /// The value contains the string representation of the protobuf type
-      /// that stores the value.
-      /// E.g.: allItems["model1::pose"] = "gazebo::msgs::Pose"
-      public: std::map<std::string, std::function <gazebo::msgs::Any ()>>
-          allItems;
+      /// \brief All the registered items, stored contiguously so that the
+      /// observed ones are sampled in one pass. Slots of unregistered items
+      /// are reused.
+      public: std::vector<IntrospectionItem> items;
+
+      /// \brief Slots of the unregistered items.
+      public: std::vector<size_t> freeSlots;
+
+      /// \brief Slot of each registered item, by name.
+      public: std::map<std::string, size_t> itemSlots;
 
       /// \brief Set of all registered items names.
       /// This is a convenience/performance enhancement for retreving
       /// registered keys.
       public: std::set<std::string> allItemsKeys;
 
-      /// \brief List of items that have at least one active observer.
-      /// The key contains the item name.
-      /// The value contains the last value stored for this item, as well as a
-      /// list of all the filters that contain the item.
-      public: std::map<std::string, ObservedItem> observedItems;
+      /// \brief Slots of the items that have at least one filter, in
+      /// increasing order.
+      public: std::vector<size_t> observedSlots;
+
+      /// \brief True when the items or filters changed since the slots of
+      /// the filters were last updated.
+      public: bool slotsDirty = true;
 
       /// \brief Mutex to make this class thread-safe.
       public: mutable std::mutex mutex;
@@ -96,10 +125,6 @@ namespace gazebo
       /// changed since the last update.
       public: bool itemsUpdated = false;
 
-      /// \brief Map of filter topic names to publishers.
-      public: std::map<std::string, ignition::transport::Node::Publisher>
-              filterPubs;
-
       /// \brief Items update publisher for ignition transport.
       public: ignition::transport::Node::Publisher itemsUpdatePub;
     };
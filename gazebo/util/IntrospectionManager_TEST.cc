@@ -134,6 +134,45 @@ TEST_F(IntrospectionManagerTest, RegisterAllTypes)
   EXPECT_TRUE(this->manager->Unregister("item12"));
 }
 
+/////////////////////////////////////////////////
+TEST_F(IntrospectionManagerTest, RegisterTyped)
+{
+  const ignition::math::Vector3d values[] = {
+    ignition::math::Vector3d(1, 2, 3), ignition::math::Vector3d(4, 5, 6)};
+  auto getter = [](const ignition::math::Vector3d (&_values)[2],
+      const unsigned int _index)
+  {
+    return _values[_index];
+  };
+
+  EXPECT_TRUE(this->manager->Register<ignition::math::Vector3d>(
+      "item4", values, getter));
+  EXPECT_TRUE(this->manager->Register<ignition::math::Vector3d>(
+      "item5", values, getter, 1));
+
+  // The same item can't be registered twice, with either form.
+  EXPECT_FALSE(this->manager->Register<ignition::math::Vector3d>(
+      "item4", values, getter));
+  EXPECT_FALSE(this->manager->Register<double>("item5",
+      std::function<double()>([]() { return 1.0; })));
+
+  auto items = this->manager->Items();
+  EXPECT_EQ(5u, items.size());
+  EXPECT_TRUE(items.find("item4") != items.end());
+  EXPECT_TRUE(items.find("item5") != items.end());
+
+  // The slot of a removed item is reused.
+  EXPECT_TRUE(this->manager->Unregister("item4"));
+  EXPECT_TRUE(this->manager->Register<ignition::math::Vector3d>(
+      "item6", values, getter));
+  items = this->manager->Items();
+  EXPECT_TRUE(items.find("item4") == items.end());
+  EXPECT_TRUE(items.find("item6") != items.end());
+
+  EXPECT_TRUE(this->manager->Unregister("item5"));
+  EXPECT_TRUE(this->manager->Unregister("item6"));
+}
+
 /////////////////////////////////////////////////
 TEST_F(IntrospectionManagerTest, RegistrationAndItems)
 {
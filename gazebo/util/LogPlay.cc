@@ -29,6 +29,8 @@
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
 #include <boost/archive/iterators/base64_from_binary.hpp>
 #include <boost/archive/iterators/binary_from_base64.hpp>
 #include <boost/archive/iterators/remove_whitespace.hpp>
@@ -40,6 +42,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Base64.hh"
+#include "gazebo/util/BinaryLog.hh"
 #include "gazebo/util/LogRecord.hh"
 
 #include "gazebo/util/LogPlayPrivate.hh"
@@ -58,6 +61,7 @@ LogPlay::LogPlay()
 /////////////////////////////////////////////////
 LogPlay::~LogPlay()
 {
+  this->dataPtr->StopPrefetch();
 }
 
 /////////////////////////////////////////////////
@@ -72,6 +76,17 @@ void LogPlay::Open(const std::string &_logFile)
   if (boost::filesystem::is_directory(path))
     gzthrow("Invalid logfile [" + _logFile + "]. This is a directory.");
 
+  if (BinaryLog::IsBinary(_logFile))
+  {
+    this->OpenBinary(_logFile);
+    return;
+  }
+
+  this->dataPtr->binary = false;
+  this->dataPtr->StopPrefetch();
+  if (this->dataPtr->binaryFile.is_open())
+    this->dataPtr->binaryFile.close();
+
   // Flag use to indicate if a parser failure has occurred
   bool xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
     tinyxml2::XML_SUCCESS;
@@ -141,6 +156,15 @@ void LogPlay::Open(const std::string &_logFile)
   if (!this->dataPtr->logStartXml)
     gzthrow("Log file is missing the <gazebo_log> element");
 
+  // Keep the chunks, so they can be reached by index.
+  this->dataPtr->xmlChunks.clear();
+  this->dataPtr->chunkStartTimes.clear();
+  for (auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+       xml; xml = xml->NextSiblingElement("chunk"))
+  {
+    this->dataPtr->xmlChunks.push_back(xml);
+  }
+
   // Store the filename for future use.
   this->dataPtr->filename = _logFile;
 
@@ -156,20 +180,91 @@ void LogPlay::Open(const std::string &_logFile)
   // Extract the initial "iterations" value from the log.
   this->dataPtr->iterationsFound = this->ReadIterations();
 
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->xmlChunks.empty())
     gzthrow("Unable to find the first chunk");
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
-  {
+  if (!this->dataPtr->LoadChunk(0, this->dataPtr->currentChunk))
     gzthrow("Unable to decode log file");
+
+  this->dataPtr->start = 0;
+  this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
+}
+
+/////////////////////////////////////////////////
+void LogPlay::OpenBinary(const std::string &_logFile)
+{
+  // Release a previously opened XML log file
+  this->dataPtr->xmlDoc.Clear();
+  this->dataPtr->logStartXml = nullptr;
+  this->dataPtr->logCurrXml = nullptr;
+  this->dataPtr->xmlChunks.clear();
+  this->dataPtr->chunkStartTimes.clear();
+
+  this->dataPtr->StopPrefetch();
+  if (this->dataPtr->binaryFile.is_open())
+    this->dataPtr->binaryFile.close();
+
+  // Map the file, so chunks are read without copying them through a stream
+  // buffer, and from more than one thread.
+  try
+  {
+    this->dataPtr->binaryFile.open(_logFile);
+  }
+  catch(std::exception &_e)
+  {
+    gzerr << "Unable to map file[" << _logFile << "]: " << _e.what() << "\n";
+  }
+
+  msgs::LogFile::Header header;
+  this->dataPtr->binary = false;
+  if (this->dataPtr->binaryFile.is_open())
+  {
+    boost::iostreams::stream<boost::iostreams::array_source> in(
+        this->dataPtr->binaryFile.data(), this->dataPtr->binaryFile.size());
+    this->dataPtr->binary =
+      BinaryLog::Open(in, header, this->dataPtr->index);
+  }
+
+  if (!this->dataPtr->binary)
+  {
+    gzerr << "Unable to load file[" << _logFile << "]. "
+      << "Check the Gazebo server log file for more information.\n";
+    gzthrow("Error parsing log file");
+  }
+
+  // Store the filename for future use.
+  this->dataPtr->filename = _logFile;
+
+  this->dataPtr->logVersion = header.log_version();
+  this->dataPtr->gazeboVersion = header.gazebo_version();
+  this->dataPtr->randSeed = header.rand_seed();
+
+  if (this->dataPtr->logVersion != GZ_LOG_VERSION)
+  {
+    gzwarn << "Log version[" << this->dataPtr->logVersion << "] in file["
+           << this->dataPtr->filename
+           << "] does not match Gazebo's log version["
+           << GZ_LOG_VERSION << "]\n";
   }
 
+  // Set the random number seed for simulation
+  ignition::math::Rand::Seed(this->dataPtr->randSeed);
+
+  this->dataPtr->encoding.clear();
+
+  // Extract the start/end log times from the index.
+  this->ReadLogTimes();
+
+  // Extract the initial "iterations" value from the log.
+  this->dataPtr->iterationsFound = this->ReadIterations();
+
+  if (!this->dataPtr->LoadChunk(0, this->dataPtr->currentChunk))
+    gzthrow("Unable to find the first chunk");
+
   this->dataPtr->start = 0;
   this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
+
+  this->dataPtr->StartPrefetch();
 }
 
 /////////////////////////////////////////////////
@@ -258,6 +353,32 @@ void LogPlay::ReadHeader()
 /////////////////////////////////////////////////
 void LogPlay::ReadLogTimes()
 {
+  // Binary log files index the time range of every chunk
+  if (this->dataPtr->binary)
+  {
+    const auto &chunks = this->dataPtr->index.chunk();
+    auto first = std::find_if(chunks.begin(), chunks.end(),
+        [](const msgs::LogFile::Index::Entry &_entry)
+        {
+          return _entry.has_start_time();
+        });
+    auto last = std::find_if(chunks.rbegin(), chunks.rend(),
+        [](const msgs::LogFile::Index::Entry &_entry)
+        {
+          return _entry.has_end_time();
+        });
+
+    if (first == chunks.end() || last == chunks.rend())
+    {
+      gzwarn << "Unable to find <sim_time> tags in any chunk." << std::endl;
+      return;
+    }
+
+    this->dataPtr->logStartTime = msgs::Convert(first->start_time());
+    this->dataPtr->logEndTime = msgs::Convert(last->end_time());
+    return;
+  }
+
   std::string chunk;
   bool found = false;
 
@@ -336,7 +457,8 @@ bool LogPlay::ReadIterations()
   const std::string kStartDelim = "<iterations>";
   const std::string kEndDelim = "</iterations>";
 
-  auto chunkXml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  tinyxml2::XMLElement *chunkXml = this->dataPtr->binary ? nullptr :
+    this->dataPtr->logStartXml->FirstChildElement("chunk");
 
   // Read the first "iterations" value of the log from the first chunk.
   auto numChunksToTry =
@@ -344,15 +466,25 @@ bool LogPlay::ReadIterations()
 
   for (unsigned int i = 0; i < numChunksToTry; ++i)
   {
-    if (!chunkXml)
+    std::string chunk;
+    if (this->dataPtr->binary)
     {
-      gzerr << "Unable to find the first chunk" << std::endl;
-      return false;
+      if (!this->dataPtr->BinaryChunkData(i, chunk))
+        return false;
     }
+    else
+    {
+      if (!chunkXml)
+      {
+        gzerr << "Unable to find the first chunk" << std::endl;
+        return false;
+      }
 
-    std::string chunk;
-    if (!this->dataPtr->ChunkData(chunkXml, chunk))
-      return false;
+      if (!this->dataPtr->ChunkData(chunkXml, chunk))
+        return false;
+
+      chunkXml = chunkXml->NextSiblingElement("chunk");
+    }
 
     // Find the first <iterations> of the log.
     auto from = chunk.find(kStartDelim);
@@ -365,8 +497,6 @@ bool LogPlay::ReadIterations()
       ss >> this->dataPtr->initialIterations;
       return true;
     }
-
-    chunkXml = chunkXml->NextSiblingElement("chunk");
   }
 
   gzwarn << "Unable to find <iterations>...</iterations> tags in the first "
@@ -378,7 +508,7 @@ bool LogPlay::ReadIterations()
 /////////////////////////////////////////////////
 bool LogPlay::IsOpen() const
 {
-  return this->dataPtr->logStartXml != NULL;
+  return this->dataPtr->logStartXml != NULL || this->dataPtr->binary;
 }
 
 /////////////////////////////////////////////////
@@ -536,21 +666,13 @@ bool LogPlay::Rewind()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   this->dataPtr->currentChunk.clear();
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
 
-  if (!this->dataPtr->logCurrXml)
+  if (!this->dataPtr->LoadChunk(0, this->dataPtr->currentChunk))
   {
     gzerr << "Unable to jump to the beginning of the log file\n";
     return false;
   }
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
-  {
-    return false;
-  }
-
   // Skip first <sdf> block (it doesn't have a world state).
   this->dataPtr->end = this->dataPtr->currentChunk.find(
       this->dataPtr->kEndFrame);
@@ -576,21 +698,13 @@ bool LogPlay::Forward()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Get the last chunk.
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->LastChildElement("chunk");
-
-  if (!this->dataPtr->logCurrXml)
+  if (!this->dataPtr->LoadChunk(static_cast<int>(this->ChunkCount()) - 1,
+        this->dataPtr->currentChunk))
   {
     gzerr << "Unable to jump to the end of the log file\n";
     return false;
   }
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
-  {
-    return false;
-  }
-
   this->dataPtr->start = this->dataPtr->currentChunk.size() - 1;
   this->dataPtr->end = this->dataPtr->currentChunk.size() - 1;
 
@@ -608,79 +722,43 @@ bool LogPlay::Seek(const common::Time &_time)
     return true;
   }
 
-  common::Time logTime = this->dataPtr->logStartTime;
-
-  // 1st step: Locate the chunk: We're looking for the first chunk that has
-  // a time greater than the target time.
-  int64_t imin = 0;
-  int64_t imax = this->ChunkCount() - 1;
+  // 1st step: Locate the last chunk that starts before the target time.
+  int chunkIndex = -1;
+  int imin = 0;
+  int imax = static_cast<int>(this->ChunkCount()) - 1;
   while (imin <= imax)
   {
-    int64_t imid = imin + ((imax - imin) / 2);
-    this->Chunk(imid, this->dataPtr->currentChunk);
-
-    this->dataPtr->start = 0;
-    this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
-
-    // We try a few times looking for <sim_time>.
-    for (unsigned int i = 0; i < 2; ++i)
+    int imid = imin + ((imax - imin) / 2);
+    if (this->dataPtr->ChunkStartTime(imid) < _time)
     {
-      std::string frame;
-      if (!this->Step(frame))
-        return false;
-
-      // Search the <sim_time> in the first frame of the current chunk.
-      auto from = frame.find(this->dataPtr->kStartTime);
-      auto to = frame.find(
-          this->dataPtr->kEndTime, from + this->dataPtr->kStartTime.size());
-      if (from != std::string::npos && to != std::string::npos)
-      {
-        auto length = to - from - this->dataPtr->kStartTime.size();
-        auto logTimeStr = frame.substr(
-            from + this->dataPtr->kStartTime.size(), length);
-        std::stringstream ss(logTimeStr);
-        ss >> logTime;
-        break;
-      }
-    }
-
-    // Chunk found.
-    if (logTime == _time)
-      break;
-    else if (logTime < _time)
+      chunkIndex = imid;
       imin = imid + 1;
+    }
     else
       imax = imid - 1;
   }
 
-  if (logTime < _time)
-  {
-    if (!this->NextChunk())
-      this->Forward();
-  }
+  // The target time is before the first frame.
+  if (chunkIndex < 0)
+    return this->Rewind();
 
-  // 2nd step: Locate the frame in the previous chunk.
-  while (true)
-  {
-    std::string frame;
-    if (!this->StepBack(frame))
-      break;
+  if (!this->dataPtr->LoadChunk(chunkIndex, this->dataPtr->currentChunk))
+    return false;
 
-    // Search the <sim_time> in the frame of the current chunk.
-    auto from = frame.find(this->dataPtr->kStartTime);
-    auto to = frame.find(
-        this->dataPtr->kEndTime, from + this->dataPtr->kStartTime.size());
-    if (from != std::string::npos && to != std::string::npos)
+  this->dataPtr->start = this->dataPtr->currentChunk.size() - 1;
+  this->dataPtr->end = this->dataPtr->currentChunk.size() - 1;
+
+  // 2nd step: Locate the last frame of the chunk before the target time.
+  // Every frame holds the full world state, so playback can resume from it.
+  std::string frame;
+  while (this->StepBack(frame))
+  {
+    common::Time frameStart;
+    common::Time frameEnd;
+    if (BinaryLog::SimTimes(frame, frameStart, frameEnd) &&
+        frameStart < _time)
     {
-      auto length = to - from - this->dataPtr->kStartTime.size();
-      auto logTimeStr = frame.substr(
-          from + this->dataPtr->kStartTime.size(), length);
-      std::stringstream ss(logTimeStr);
-      ss >> logTime;
-
-      // frame found.
-      if (logTime < _time)
-        break;
+      break;
     }
   }
 
@@ -688,23 +766,35 @@ bool LogPlay::Seek(const common::Time &_time)
 }
 
 /////////////////////////////////////////////////
-bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
+bool LogPlay::ChunkFrames(std::vector<std::string> &_frames)
 {
-  unsigned int count = 0;
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
+  _frames.clear();
+
+  if (!this->IsOpen())
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-  while (this->dataPtr->logCurrXml && count < _index)
+  const std::string &chunk = this->dataPtr->currentChunk;
+  auto from = chunk.find(this->dataPtr->kStartFrame);
+  while (from != std::string::npos && from <= this->dataPtr->start)
   {
-    count++;
-    this->dataPtr->logCurrXml =
-      this->dataPtr->logCurrXml->NextSiblingElement("chunk");
+    auto to = chunk.find(this->dataPtr->kEndFrame, from);
+    if (to == std::string::npos)
+      break;
+
+    _frames.push_back(chunk.substr(
+          from, to + this->dataPtr->kEndFrame.size() - from));
+    from = chunk.find(this->dataPtr->kStartFrame, to);
   }
 
-  if (this->dataPtr->logCurrXml && count == _index)
-    return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
-  else
-    return false;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
+{
+  return this->dataPtr->LoadChunk(_index, _data);
 }
 
 /////////////////////////////////////////////////
@@ -768,6 +858,15 @@ bool LogPlayPrivate::ChunkData(
       _data += '\0';
     }
   }
+  else if (this->encoding == "zstd")
+  {
+    // Decode the base64 string and decompress
+    if (!BinaryLog::Decompress(Base64Decode(_xml->GetText()), this->encoding,
+          _data))
+    {
+      return false;
+    }
+  }
   else
   {
     gzerr << "Invalid encoding[" << this->encoding << "] in log file["
@@ -779,36 +878,234 @@ bool LogPlayPrivate::ChunkData(
 }
 
 /////////////////////////////////////////////////
-std::string LogPlay::Encoding() const
+bool LogPlayPrivate::BinaryChunkData(const int _index, std::string &_data)
 {
-  return this->dataPtr->encoding;
+  if (_index < 0 || _index >= this->index.chunk_size())
+    return false;
+
+  // Use the chunk decoded by the prefetch thread, if it is ready.
+  DecodedChunk chunk;
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    auto iter = this->prefetched.find(_index);
+    if (iter != this->prefetched.end())
+    {
+      chunk = std::move(iter->second);
+      this->prefetched.erase(iter);
+      found = true;
+    }
+  }
+
+  if (!found && !this->DecodeBinaryChunk(_index, chunk))
+    return false;
+
+  this->encoding = chunk.encoding;
+  this->currentChunkIndex = _index;
+  _data = std::move(chunk.data);
+
+  // Let the prefetch thread decode the chunks that follow.
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->prefetchIndex = _index;
+  }
+  this->prefetchCondition.notify_one();
+
+  return true;
 }
 
 /////////////////////////////////////////////////
-unsigned int LogPlay::ChunkCount() const
+bool LogPlayPrivate::DecodeBinaryChunk(const int _index,
+    DecodedChunk &_chunk) const
 {
-  unsigned int count = 0;
-  auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  if (_index < 0 || _index >= this->index.chunk_size() ||
+      !this->binaryFile.is_open())
+  {
+    return false;
+  }
 
-  while (xml)
+  const uint64_t offset = this->index.chunk(_index).offset();
+  if (offset >= this->binaryFile.size())
   {
-    count++;
-    xml = xml->NextSiblingElement("chunk");
+    gzerr << "Chunk[" << _index << "] is out of the bounds of log file["
+      << this->filename << "]\n";
+    return false;
   }
 
-  return count;
+  boost::iostreams::stream<boost::iostreams::array_source> in(
+      this->binaryFile.data() + offset, this->binaryFile.size() - offset);
+
+  msgs::LogFile::Chunk chunk;
+  if (!BinaryLog::ReadRecord(in, chunk))
+  {
+    gzerr << "Unable to read chunk[" << _index << "] in log file["
+      << this->filename << "]\n";
+    return false;
+  }
+
+  _chunk.encoding = chunk.encoding();
+  return BinaryLog::ChunkData(chunk, _chunk.data);
 }
 
 /////////////////////////////////////////////////
-bool LogPlay::NextChunk()
+void LogPlayPrivate::StartPrefetch()
+{
+  this->StopPrefetch();
+
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->stopPrefetch = false;
+    this->prefetchIndex = this->currentChunkIndex;
+  }
+
+  this->prefetchThread = std::thread(&LogPlayPrivate::PrefetchWorker, this);
+}
+
+/////////////////////////////////////////////////
+void LogPlayPrivate::StopPrefetch()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->stopPrefetch = true;
+  }
+  this->prefetchCondition.notify_all();
+
+  if (this->prefetchThread.joinable())
+    this->prefetchThread.join();
+
+  std::lock_guard<std::mutex> lock(this->prefetchMutex);
+  this->prefetched.clear();
+}
+
+/////////////////////////////////////////////////
+void LogPlayPrivate::PrefetchWorker()
 {
-  auto next = this->dataPtr->logCurrXml->NextSiblingElement("chunk");
-  if (!next)
+  std::unique_lock<std::mutex> lock(this->prefetchMutex);
+  while (!this->stopPrefetch)
+  {
+    const int first = this->prefetchIndex + 1;
+    const int last = std::min(this->prefetchIndex + this->kPrefetchChunks,
+        this->index.chunk_size() - 1);
+
+    // Drop the chunks that playback moved away from.
+    for (auto iter = this->prefetched.begin();
+         iter != this->prefetched.end();)
+    {
+      if (iter->first < first || iter->first > last)
+        iter = this->prefetched.erase(iter);
+      else
+        ++iter;
+    }
+
+    // Find the next chunk to decode.
+    int next = -1;
+    for (int i = first; i <= last && next < 0; ++i)
+    {
+      if (this->prefetched.find(i) == this->prefetched.end())
+        next = i;
+    }
+
+    if (next < 0)
+    {
+      this->prefetchCondition.wait(lock);
+      continue;
+    }
+
+    // Decode without holding the lock, so playback isn't blocked.
+    lock.unlock();
+    DecodedChunk chunk;
+    const bool decoded = this->DecodeBinaryChunk(next, chunk);
+    lock.lock();
+
+    // Don't retry a broken chunk until playback moves.
+    if (!decoded)
+    {
+      this->prefetchCondition.wait(lock);
+      continue;
+    }
+
+    if (next > this->prefetchIndex &&
+        next <= this->prefetchIndex + this->kPrefetchChunks)
+    {
+      this->prefetched[next] = std::move(chunk);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::LoadChunk(const int _index, std::string &_data)
+{
+  if (this->binary)
+    return this->BinaryChunkData(_index, _data);
+
+  if (_index < 0 || _index >= static_cast<int>(this->xmlChunks.size()))
+    return false;
+
+  if (!this->ChunkData(this->xmlChunks[_index], _data))
     return false;
 
-  this->dataPtr->logCurrXml = next;
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
+  this->logCurrXml = this->xmlChunks[_index];
+  this->currentChunkIndex = _index;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+common::Time LogPlayPrivate::ChunkStartTime(const int _index)
+{
+  common::Time startTime;
+  common::Time endTime;
+
+  if (this->binary)
+  {
+    if (_index >= 0 && _index < this->index.chunk_size() &&
+        this->index.chunk(_index).has_start_time())
+    {
+      startTime = msgs::Convert(this->index.chunk(_index).start_time());
+    }
+    return startTime;
+  }
+
+  auto iter = this->chunkStartTimes.find(_index);
+  if (iter != this->chunkStartTimes.end())
+    return iter->second;
+
+  // XML log files have no index, read the chunk once. Reading it must not
+  // change the encoding reported for the current chunk.
+  const std::string currentEncoding = this->encoding;
+  std::string data;
+  if (_index < 0 || _index >= static_cast<int>(this->xmlChunks.size()) ||
+      !this->ChunkData(this->xmlChunks[_index], data) ||
+      !BinaryLog::SimTimes(data, startTime, endTime))
+  {
+    startTime = common::Time::Zero;
+  }
+  this->encoding = currentEncoding;
+
+  this->chunkStartTimes[_index] = startTime;
+  return startTime;
+}
+
+/////////////////////////////////////////////////
+std::string LogPlay::Encoding() const
+{
+  return this->dataPtr->encoding;
+}
+
+/////////////////////////////////////////////////
+unsigned int LogPlay::ChunkCount() const
+{
+  if (this->dataPtr->binary)
+    return this->dataPtr->index.chunk_size();
+
+  return this->dataPtr->xmlChunks.size();
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::NextChunk()
+{
+  if (!this->dataPtr->LoadChunk(this->dataPtr->currentChunkIndex + 1,
+        this->dataPtr->currentChunk))
   {
     return false;
   }
@@ -822,13 +1119,8 @@ bool LogPlay::NextChunk()
 /////////////////////////////////////////////////
 bool LogPlay::PrevChunk()
 {
-  auto prev = this->dataPtr->logCurrXml->PreviousSiblingElement("chunk");
-  if (!prev)
-    return false;
-
-  this->dataPtr->logCurrXml = prev;
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
+  if (!this->dataPtr->LoadChunk(this->dataPtr->currentChunkIndex - 1,
+        this->dataPtr->currentChunk))
   {
     return false;
   }
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/common/Time.hh"
@@ -57,7 +58,9 @@ namespace gazebo
 
       /// \brief Open a log file for reading
       ///
-      /// Open a log file that was previously recorded.
+      /// Open a log file that was previously recorded. Binary log files
+      /// are mapped into memory, and the chunks that follow the current one
+      /// are decoded ahead in a background thread.
       /// \param[in] _logFile The file to load
       /// \throws Exception When the log file does not exist, is a directory
       /// instead of a regular file, or Gazebo was unable to parse it.
@@ -121,6 +124,15 @@ namespace gazebo
       /// \return True if operation succeed or false otherwise.
       public: bool Seek(const common::Time &_time);
 
+      /// \brief Get the frames of the current chunk, from its start up to
+      /// and including the frame at the current position. Frames that are
+      /// not keyframes only hold what changed, but every chunk starts with
+      /// a keyframe, so applying these frames in order rebuilds the full
+      /// state at the current position, e.g. after a Seek.
+      /// \param[out] _frames The frames, in log order.
+      /// \return False if no log file is open.
+      public: bool ChunkFrames(std::vector<std::string> &_frames);
+
       /// \brief Jump to the beginning of the log file. The next step() call
       /// will return the first data "chunk".
       /// \return True If the function succeed or false otherwise.
@@ -161,6 +173,12 @@ namespace gazebo
       /// false otherwise.
       public: bool HasIterations() const;
 
+      /// \brief Open a log file in the binary format.
+      /// \param[in] _logFile The file to load
+      /// \throws Exception When Gazebo was unable to read the file.
+      /// \sa BinaryLog
+      private: void OpenBinary(const std::string &_logFile);
+
       /// \brief Read the header from the log file.
       private: void ReadHeader();
 
@@ -25,10 +25,17 @@
 #include <tinyxml2.h>
 #endif
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <condition_variable>
+#include <map>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -39,6 +46,16 @@ namespace gazebo
     /// \brief Private data for log play
     class LogPlayPrivate
     {
+      /// \brief A chunk decoded ahead of playback.
+      public: class DecodedChunk
+      {
+        /// \brief Encoding of the chunk.
+        public: std::string encoding;
+
+        /// \brief Decoded chunk data.
+        public: std::string data;
+      };
+
       /// \brief Helper function to get chunk data from XML.
       /// \param[in] _xml Pointer to an xml block that has state data.
       /// \param[out] _data Storage for the chunk's data.
@@ -47,9 +64,52 @@ namespace gazebo
                   tinyxml2::XMLElement *_xml,
                   std::string &_data);
 
+      /// \brief Helper function to get chunk data from a binary log file.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the chunk was successfully read.
+      public: bool BinaryChunkData(const int _index, std::string &_data);
+
+      /// \brief Read and decode a chunk of the memory-mapped binary log file.
+      /// This doesn't change any member, so it can run in the prefetch
+      /// thread while playback reads other chunks.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _chunk Storage for the decoded chunk.
+      /// \return True if the chunk was successfully read.
+      public: bool DecodeBinaryChunk(const int _index,
+                                     DecodedChunk &_chunk) const;
+
+      /// \brief Start decoding the chunks that follow the current one.
+      public: void StartPrefetch();
+
+      /// \brief Stop the prefetch thread and drop the decoded chunks.
+      public: void StopPrefetch();
+
+      /// \brief Prefetch thread. Keeps the kPrefetchChunks chunks after the
+      /// current one decoded.
+      public: void PrefetchWorker();
+
+      /// \brief Load a chunk and make it the current one.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the chunk was successfully loaded.
+      public: bool LoadChunk(const int _index, std::string &_data);
+
+      /// \brief Get the simulation time of the first frame in a chunk.
+      /// Binary log files store it in their index. For XML log files the
+      /// chunk is read the first time it is needed and the result is kept.
+      /// Chunks without a simulation time, such as the one holding the
+      /// initial world, are reported at time zero.
+      /// \param[in] _index Index of the chunk.
+      /// \return Simulation time of the first frame in the chunk.
+      public: common::Time ChunkStartTime(const int _index);
+
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
 
+      /// \brief Number of chunks after the current one to decode ahead.
+      public: const int kPrefetchChunks = 2;
+
       /// \brief XML tag delimiting the beginning of a frame.
       public: const std::string kStartFrame = "<sdf ";
 
@@ -71,6 +131,24 @@ namespace gazebo
       /// \brief Current position in the log file.
       public: tinyxml2::XMLElement *logCurrXml = nullptr;
 
+      /// \brief True if the open log file is in the binary format.
+      public: bool binary = false;
+
+      /// \brief The open binary log file, mapped into memory.
+      public: boost::iostreams::mapped_file_source binaryFile;
+
+      /// \brief Index of the chunks of the open binary log file.
+      public: msgs::LogFile::Index index;
+
+      /// \brief Index of the current chunk.
+      public: int currentChunkIndex = 0;
+
+      /// \brief The chunks of an XML log file, in order.
+      public: std::vector<tinyxml2::XMLElement *> xmlChunks;
+
+      /// \brief Start times of the XML chunks read so far, by chunk index.
+      public: std::map<int, common::Time> chunkStartTimes;
+
       /// \brief Name of the log file.
       public: std::string filename;
 
@@ -113,6 +191,24 @@ namespace gazebo
 
       /// \brief A mutex to avoid race conditions.
       public: std::mutex mutex;
+
+      /// \brief Thread decoding binary chunks ahead of playback.
+      public: std::thread prefetchThread;
+
+      /// \brief Protects the prefetch members below.
+      public: std::mutex prefetchMutex;
+
+      /// \brief Wakes the prefetch thread when the current chunk changes.
+      public: std::condition_variable prefetchCondition;
+
+      /// \brief Chunks decoded ahead of playback, by chunk index.
+      public: std::map<int, DecodedChunk> prefetched;
+
+      /// \brief Index of the current chunk, as seen by the prefetch thread.
+      public: int prefetchIndex = 0;
+
+      /// \brief True to stop the prefetch thread.
+      public: bool stopPrefetch = false;
     };
   }
 }
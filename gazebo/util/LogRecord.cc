@@ -25,7 +25,11 @@
   #define access _access
 #endif
 
+#include <algorithm>
+#include <fstream>
 #include <functional>
+#include <iterator>
+#include <vector>
 
 #include <boost/archive/iterators/base64_from_binary.hpp>
 #include <boost/archive/iterators/insert_linebreaks.hpp>
@@ -52,12 +56,23 @@
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo/transport/transport.hh"
+#include "gazebo/util/BinaryLog.hh"
 #include "gazebo/util/LogRecordPrivate.hh"
 #include "gazebo/util/LogRecord.hh"
 
 using namespace gazebo;
 using namespace util;
 
+/// \brief Number of chunks that can wait for compression before the
+/// update thread blocks.
+static const unsigned int COMPRESS_QUEUE_SIZE = 64;
+
+/// \brief Maximum number of compression threads.
+static const unsigned int MAX_COMPRESS_THREADS = 4;
+
+/// \brief Size of the blocks in which resources are copied, in bytes.
+static const size_t RESOURCE_BLOCK_SIZE = 1 << 16;
+
 //////////////////////////////////////////////////
 LogRecord::LogRecord()
 : dataPtr(new LogRecordPrivate)
@@ -139,7 +154,12 @@ bool LogRecord::Start(const LogRecordParams &_params)
 {
   this->dataPtr->period = _params.period;
   this->dataPtr->filter = _params.filter;
+  this->dataPtr->keyframePeriod = _params.keyframePeriod;
+  this->dataPtr->tolerance = _params.tolerance;
   this->dataPtr->recordResources = _params.recordResources;
+  this->dataPtr->format = _params.format;
+  this->dataPtr->resourceStore = _params.resourceStore;
+  this->dataPtr->bandwidth = _params.bandwidth;
   return this->Start(_params.encoding, _params.path);
 }
 
@@ -186,12 +206,16 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
   if (!boost::filesystem::exists(this->dataPtr->logCompletePath))
     boost::filesystem::create_directories(this->dataPtr->logCompletePath);
 
-  if (_encoding != "bz2" && _encoding != "txt" && _encoding != "zlib")
+  if (!BinaryLog::IsEncoding(_encoding))
     gzthrow("Invalid log encoding[" + _encoding +
-            "]. Must be one of [bz2, zlib, txt]");
+            "]. Must be one of [bz2, zlib, zstd, txt]");
 
   this->dataPtr->encoding = _encoding;
 
+  if (this->dataPtr->format != "binary" && this->dataPtr->format != "xml")
+    gzthrow("Invalid log format[" + this->dataPtr->format +
+            "]. Must be one of [binary, xml]");
+
   {
     std::unique_lock<std::mutex> logLock(this->dataPtr->writeMutex);
     this->dataPtr->logsEnd = this->dataPtr->logs.end();
@@ -202,6 +226,8 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
       iter->second->Start(this->dataPtr->logCompletePath);
   }
 
+  this->dataPtr->StartCompressThreads();
+
   this->dataPtr->running = true;
   this->dataPtr->paused = false;
   this->dataPtr->firstUpdate = true;
@@ -262,6 +288,8 @@ void LogRecord::Fini()
     this->dataPtr->cleanupThread->join();
   this->dataPtr->cleanupThread.reset();
 
+  this->dataPtr->StopResourceThread();
+
   std::lock_guard<std::mutex> lock(this->dataPtr->controlMutex);
   this->dataPtr->connections.clear();
 
@@ -285,6 +313,9 @@ void LogRecord::Stop()
 //////////////////////////////////////////////////
 void LogRecord::ClearLogs()
 {
+  // Compression threads hold pointers to the logs.
+  this->dataPtr->StopCompressThreads();
+
   std::lock_guard<std::mutex> logLock(this->dataPtr->writeMutex);
 
   // Delete all the log objects
@@ -334,6 +365,42 @@ void LogRecord::SetFilter(const std::string &_filter)
   this->dataPtr->filter = _filter;
 }
 
+//////////////////////////////////////////////////
+double LogRecord::KeyframePeriod() const
+{
+  return this->dataPtr->keyframePeriod;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetKeyframePeriod(const double _period)
+{
+  this->dataPtr->keyframePeriod = _period;
+}
+
+//////////////////////////////////////////////////
+double LogRecord::Tolerance() const
+{
+  return this->dataPtr->tolerance;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetTolerance(const double _tolerance)
+{
+  this->dataPtr->tolerance = _tolerance;
+}
+
+//////////////////////////////////////////////////
+std::string LogRecord::Format() const
+{
+  return this->dataPtr->format;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetFormat(const std::string &_format)
+{
+  this->dataPtr->format = _format;
+}
+
 //////////////////////////////////////////////////
 bool LogRecord::Running() const
 {
@@ -352,6 +419,36 @@ void LogRecord::SetRecordResources(const bool _record)
   this->dataPtr->recordResources = _record;
 }
 
+//////////////////////////////////////////////////
+std::string LogRecord::ResourceStore() const
+{
+  return this->dataPtr->resourceStore;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetResourceStore(const std::string &_path)
+{
+  this->dataPtr->resourceStore = _path;
+}
+
+//////////////////////////////////////////////////
+double LogRecord::Bandwidth() const
+{
+  return this->dataPtr->bandwidth;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetBandwidth(const double _bandwidth)
+{
+  this->dataPtr->bandwidth = _bandwidth;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::WaitForResources()
+{
+  this->dataPtr->WaitForResources();
+}
+
 //////////////////////////////////////////////////
 void LogRecord::Add(const std::string &_name, const std::string &_filename,
                     std::function<bool (std::ostringstream &)> _logCallback)
@@ -382,7 +479,8 @@ void LogRecord::Add(const std::string &_name, const std::string &_filename,
   // Create a new log object
   try
   {
-    newLog = new LogRecordPrivate::Log(this, _filename, _logCallback);
+    newLog = new LogRecordPrivate::Log(this, this->dataPtr.get(), _filename,
+        _logCallback);
   }
   catch(...)
   {
@@ -414,6 +512,8 @@ void LogRecord::Add(const std::string &_name, const std::string &_filename,
 //////////////////////////////////////////////////
 bool LogRecord::Remove(const std::string &_name)
 {
+  this->dataPtr->WaitForCompress();
+
   std::lock_guard<std::mutex> logLock(this->dataPtr->writeMutex);
 
   bool result = false;
@@ -547,13 +647,8 @@ bool LogRecord::SaveModels(const std::set<std::string> &_models)
       if (boost::filesystem::exists(srcModelPath))
       {
         modelFound = true;
-        boost::filesystem::path destModelPath =
-          this->dataPtr->logCompletePath / model;
-        if (!gazebo::common::copyDir(srcModelPath, destModelPath))
-        {
-          gzerr << "Failed to copy model from '" << srcModelPath.string()
-                 << "' to '" << destModelPath.string() << "'" << std::endl;
-        }
+        this->dataPtr->QueueResource(srcModelPath,
+            this->dataPtr->logCompletePath / model);
         break;
       }
     }
@@ -628,36 +723,14 @@ bool LogRecord::SaveFiles(const std::set<std::string> &_files)
       {
         auto modelPath =
             boost::filesystem::path(fileName.substr(0, meshIdx));
-        srcPath = srcPath / modelPath;
-        boost::filesystem::path destPath =
-          this->dataPtr->logCompletePath / modelPath;
-        boost::system::error_code errorCode;
-        boost::filesystem::create_directories(destPath, errorCode);
-        if (errorCode != boost::system::errc::success ||
-            !gazebo::common::copyDir(srcPath, destPath))
-        {
-          gzerr << "Failed to copy model from '" << srcPath.string()
-                 << "' to '" << destPath.string() << "'" << std::endl;
-          saveError = true;
-        }
+        this->dataPtr->QueueResource(srcPath / modelPath,
+            this->dataPtr->logCompletePath / modelPath);
       }
       // else copy only the specified file
       else
       {
-        srcPath = srcPath / fileName;
-        boost::filesystem::path destPath =
-          this->dataPtr->logCompletePath / fileName;
-        boost::system::error_code errorCode;
-        boost::filesystem::create_directories(
-            destPath.parent_path(), errorCode);
-        if (errorCode == boost::system::errc::success)
-          boost::filesystem::copy_file(srcPath, destPath, errorCode);
-        else
-        {
-          gzerr << "Failed to copy file from '" << srcPath.string()
-                 << "' to '" << destPath.string() << "'" << std::endl;
-          saveError = true;
-        }
+        this->dataPtr->QueueResource(srcPath / fileName,
+            this->dataPtr->logCompletePath / fileName);
       }
     }
     else
@@ -713,6 +786,9 @@ void LogRecord::Update()
       }
     }
 
+    // Slow down if compression can't keep up.
+    this->dataPtr->WaitForCompressQueue();
+
     if (this->dataPtr->firstUpdate)
     {
       this->dataPtr->firstUpdate = false;
@@ -749,15 +825,23 @@ void LogRecord::RunWrite()
 //////////////////////////////////////////////////
 void LogRecord::Write(const bool /*_force*/)
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
-
-  // Collect all the new log data.
-  for (this->dataPtr->updateIter = this->dataPtr->logs.begin();
-      this->dataPtr->updateIter != this->dataPtr->logsEnd;
-      ++this->dataPtr->updateIter)
+  uint64_t bytes = 0;
   {
-    this->dataPtr->updateIter->second->Write();
+    std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
+
+    // Collect all the new log data.
+    for (this->dataPtr->updateIter = this->dataPtr->logs.begin();
+        this->dataPtr->updateIter != this->dataPtr->logsEnd;
+        ++this->dataPtr->updateIter)
+    {
+      bytes += this->dataPtr->updateIter->second->buffer.size();
+      this->dataPtr->updateIter->second->Write();
+    }
   }
+
+  // Pace the write thread without holding the write mutex, so that the
+  // update thread keeps buffering data meanwhile.
+  this->dataPtr->Throttle(bytes);
 }
 
 //////////////////////////////////////////////////
@@ -767,11 +851,12 @@ common::Time LogRecord::RunTime() const
 }
 
 //////////////////////////////////////////////////
-LogRecordPrivate::Log::Log(LogRecord *_parent,
+LogRecordPrivate::Log::Log(LogRecord *_parent, LogRecordPrivate *_record,
     const std::string &_relativeFilename,
     std::function<bool (std::ostringstream &)> _logCB)
 {
   this->parent = _parent;
+  this->record = _record;
   this->logCB = _logCB;
 
   this->relativeFilename = _relativeFilename;
@@ -784,65 +869,77 @@ LogRecordPrivate::Log::~Log()
 }
 
 //////////////////////////////////////////////////
-unsigned int LogRecordPrivate::Log::Update()
+unsigned int LogRecordPrivate::Log::Update(const bool _queue)
 {
   std::ostringstream stream;
 
   // Get log data via the callback.
   if (this->logCB(stream))
   {
-    std::string data = stream.str();
-    if (!data.empty())
+    LogRecordPrivate::CompressJob job;
+    job.data = stream.str();
+    if (!job.data.empty())
     {
-      const std::string &encodingLocal = this->parent->Encoding();
+      job.log = this;
+      job.sequence = this->nextSequence++;
+      job.encoding = this->parent->Encoding();
+      job.base64 = !this->binary && job.encoding != "txt";
 
-      this->buffer.append("<chunk encoding='");
-      this->buffer.append(encodingLocal);
-      this->buffer.append("'>\n");
-
-      this->buffer.append("<![CDATA[");
-      // Compress the data.
-      if (encodingLocal == "bz2")
+      if (_queue)
+        this->record->QueueCompress(std::move(job));
+      else
       {
-        std::string str;
+        msgs::LogFile::Chunk chunk;
+        LogRecordPrivate::Compress(job, chunk);
+        this->AddChunk(job.sequence, chunk);
+      }
+    }
+  }
 
-        // Compress to bzip2
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::bzip2_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
+  return this->buffer.size();
+}
 
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
-      }
-      else if (encodingLocal == "zlib")
-      {
-        std::string str;
+//////////////////////////////////////////////////
+void LogRecordPrivate::Log::AddChunk(const uint64_t _sequence,
+    msgs::LogFile::Chunk &_chunk)
+{
+  this->compressedChunks[_sequence].Swap(&_chunk);
 
-        // Compress to zlib
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::zlib_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
+  // Add all the chunks that are next in line.
+  for (auto iter = this->compressedChunks.begin();
+       iter != this->compressedChunks.end() &&
+       iter->first == this->bufferSequence;
+       iter = this->compressedChunks.erase(iter), ++this->bufferSequence)
+  {
+    const msgs::LogFile::Chunk &chunk = iter->second;
+    if (chunk.encoding().empty())
+      continue;
 
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
-      }
-      else if (encodingLocal == "txt")
-        this->buffer.append(data);
-      else
-        gzerr << "Unknown log file encoding[" << encodingLocal << "]\n";
+    if (this->binary)
+    {
+      auto entry = this->index.add_chunk();
+      entry->set_offset(this->fileOffset);
+      if (chunk.has_start_time())
+        entry->mutable_start_time()->CopyFrom(chunk.start_time());
+      if (chunk.has_end_time())
+        entry->mutable_end_time()->CopyFrom(chunk.end_time());
+
+      this->fileOffset += BinaryLog::AppendRecord(chunk, this->buffer);
+    }
+    else
+    {
+      this->buffer.append("<chunk encoding='");
+      this->buffer.append(chunk.encoding());
+      this->buffer.append("'>\n");
+
+      this->buffer.append("<![CDATA[");
+      this->buffer.append(chunk.data());
       this->buffer.append("]]>\n");
 
       this->buffer.append("</chunk>\n");
     }
   }
-
-  return this->buffer.size();
+  this->memory.Set(this->buffer.capacity());
 }
 
 //////////////////////////////////////////////////
@@ -874,11 +971,19 @@ void LogRecordPrivate::Log::Stop()
 {
   if (this->logFile.is_open())
   {
-    this->Update();
+    this->Update(false);
     this->Write();
 
-    std::string xmlEnd = "</gazebo_log>";
-    this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
+    if (this->binary)
+    {
+      std::string end = BinaryLog::End(this->index, this->fileOffset);
+      this->logFile.write(end.c_str(), end.size());
+    }
+    else
+    {
+      std::string xmlEnd = "</gazebo_log>";
+      this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
+    }
 
     this->logFile.close();
   }
@@ -897,6 +1002,24 @@ void LogRecordPrivate::Log::Start(const boost::filesystem::path &_path)
     gzlog << "Filename [" + this->completePath.string() + "], already exists."
           << " The log file will be overwritten.\n";
 
+  this->binary = this->parent->Format() == "binary";
+  this->index.Clear();
+  this->nextSequence = 0;
+  this->bufferSequence = 0;
+  this->compressedChunks.clear();
+
+  if (this->binary)
+  {
+    msgs::LogFile::Header header;
+    header.set_log_version(GZ_LOG_VERSION);
+    header.set_gazebo_version(GAZEBO_VERSION_FULL);
+    header.set_rand_seed(ignition::math::Rand::Seed());
+
+    this->buffer.append(BinaryLog::Begin(header));
+    this->fileOffset = this->buffer.size();
+    return;
+  }
+
   std::ostringstream stream;
   stream << "<?xml version='1.0'?>\n"
          << "<gazebo_log>\n"
@@ -976,6 +1099,384 @@ void LogRecord::OnLogControl(ConstLogControlPtr &_data)
   this->PublishLogStatus();
 }
 
+//////////////////////////////////////////////////
+void LogRecordPrivate::QueueCompress(CompressJob &&_job)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->compressMutex);
+    if (!this->compressThreads.empty() && !this->stopCompress)
+    {
+      this->compressQueue.push_back(std::move(_job));
+      this->compressCondition.notify_one();
+      return;
+    }
+  }
+
+  msgs::LogFile::Chunk chunk;
+  Compress(_job, chunk);
+  _job.log->AddChunk(_job.sequence, chunk);
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::Compress(const CompressJob &_job,
+    msgs::LogFile::Chunk &_chunk)
+{
+  if (!BinaryLog::Chunk(_job.data, _job.encoding, _chunk))
+  {
+    _chunk.Clear();
+    return;
+  }
+
+  if (_job.base64)
+  {
+    std::string encoded;
+    Base64Encode(_chunk.data().c_str(), _chunk.data().size(), encoded);
+    _chunk.set_data(encoded);
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::StartCompressThreads()
+{
+  std::lock_guard<std::mutex> lock(this->compressMutex);
+  if (!this->compressThreads.empty())
+    return;
+
+  this->stopCompress = false;
+  this->compressStalls = 0;
+  this->compressStallTime.Set(0, 0);
+
+  unsigned int count = std::max(1u,
+      std::min(MAX_COMPRESS_THREADS, std::thread::hardware_concurrency()));
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    this->compressThreads.push_back(
+        std::thread(&LogRecordPrivate::RunCompress, this));
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::StopCompressThreads()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->compressMutex);
+    if (this->compressThreads.empty())
+      return;
+    this->stopCompress = true;
+  }
+
+  // The threads compress all the queued data before they exit.
+  this->compressCondition.notify_all();
+  for (auto &compressThread : this->compressThreads)
+    compressThread.join();
+
+  std::lock_guard<std::mutex> lock(this->compressMutex);
+  this->compressThreads.clear();
+  this->stopCompress = false;
+  this->compressDoneCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::WaitForCompressQueue()
+{
+  std::unique_lock<std::mutex> lock(this->compressMutex);
+  if (this->compressQueue.size() < COMPRESS_QUEUE_SIZE)
+    return;
+
+  common::Time start = common::Time::GetWallTime();
+  ++this->compressStalls;
+
+  this->compressDoneCondition.wait(lock, [this]
+      {
+        return this->compressThreads.empty() ||
+          this->compressQueue.size() < COMPRESS_QUEUE_SIZE;
+      });
+
+  this->compressStallTime += common::Time::GetWallTime() - start;
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::WaitForCompress()
+{
+  std::unique_lock<std::mutex> lock(this->compressMutex);
+  this->compressDoneCondition.wait(lock, [this]
+      {
+        return this->compressQueue.empty() && this->compressing == 0;
+      });
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::RunCompress()
+{
+  std::unique_lock<std::mutex> lock(this->compressMutex);
+
+  while (true)
+  {
+    this->compressCondition.wait(lock, [this]
+        {
+          return this->stopCompress || !this->compressQueue.empty();
+        });
+
+    // Stop once all the queued data is compressed.
+    if (this->compressQueue.empty())
+      break;
+
+    CompressJob job = std::move(this->compressQueue.front());
+    this->compressQueue.pop_front();
+    ++this->compressing;
+    lock.unlock();
+
+    // There is room in the queue for the update thread.
+    this->compressDoneCondition.notify_all();
+
+    msgs::LogFile::Chunk chunk;
+    Compress(job, chunk);
+
+    {
+      std::lock_guard<std::mutex> writeLock(this->writeMutex);
+
+      // The log may have been removed while its data was compressed.
+      for (auto const &log : this->logs)
+      {
+        if (log.second == job.log)
+        {
+          job.log->AddChunk(job.sequence, chunk);
+          break;
+        }
+      }
+    }
+
+    // Signal that new data is available.
+    this->dataAvailableCondition.notify_one();
+
+    lock.lock();
+    --this->compressing;
+    this->compressDoneCondition.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::QueueResource(const boost::filesystem::path &_source,
+    const boost::filesystem::path &_destination)
+{
+  std::lock_guard<std::mutex> lock(this->resourceMutex);
+  if (!this->resourceThread)
+  {
+    this->stopResources = false;
+    this->resourceThread.reset(
+        new std::thread(&LogRecordPrivate::RunResources, this));
+  }
+
+  ResourceJob job;
+  job.source = _source;
+  job.destination = _destination;
+  this->resourceQueue.push_back(std::move(job));
+  this->resourceCondition.notify_one();
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::StopResourceThread()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->resourceMutex);
+    if (!this->resourceThread)
+      return;
+    this->stopResources = true;
+  }
+
+  // The thread copies all the queued resources before it exits.
+  this->resourceCondition.notify_all();
+  this->resourceThread->join();
+
+  std::lock_guard<std::mutex> lock(this->resourceMutex);
+  this->resourceThread.reset();
+  this->stopResources = false;
+  this->resourceDoneCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::WaitForResources()
+{
+  std::unique_lock<std::mutex> lock(this->resourceMutex);
+  this->resourceDoneCondition.wait(lock, [this]
+      {
+        return this->resourceQueue.empty() && !this->copyingResource;
+      });
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::RunResources()
+{
+  std::unique_lock<std::mutex> lock(this->resourceMutex);
+
+  while (true)
+  {
+    this->resourceCondition.wait(lock, [this]
+        {
+          return this->stopResources || !this->resourceQueue.empty();
+        });
+
+    // Stop once all the queued resources are copied.
+    if (this->resourceQueue.empty())
+      break;
+
+    ResourceJob job = std::move(this->resourceQueue.front());
+    this->resourceQueue.pop_front();
+    this->copyingResource = true;
+    lock.unlock();
+
+    if (!this->CopyResource(job))
+    {
+      gzerr << "Failed to copy resource from '" << job.source.string()
+            << "' to '" << job.destination.string() << "'" << std::endl;
+    }
+
+    lock.lock();
+    this->copyingResource = false;
+    this->resourceDoneCondition.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::CopyResource(const ResourceJob &_job)
+{
+  if (!boost::filesystem::is_directory(_job.source))
+    return this->SaveResourceFile(_job.source, _job.destination);
+
+  boost::system::error_code errorCode;
+  boost::filesystem::create_directories(_job.destination, errorCode);
+  if (errorCode)
+    return false;
+
+  bool result = true;
+  const size_t prefix = _job.source.string().size();
+  boost::filesystem::recursive_directory_iterator iter(_job.source,
+      errorCode);
+  const boost::filesystem::recursive_directory_iterator end;
+  for (; !errorCode && iter != end; iter.increment(errorCode))
+  {
+    if (!boost::filesystem::is_regular_file(iter->path()))
+      continue;
+
+    // Keep the layout of the model directory, meshes reference textures
+    // by relative path.
+    boost::filesystem::path destination = _job.destination.string() +
+        iter->path().string().substr(prefix);
+    result = this->SaveResourceFile(iter->path(), destination) && result;
+  }
+
+  return result && !errorCode;
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::SaveResourceFile(
+    const boost::filesystem::path &_source,
+    const boost::filesystem::path &_destination)
+{
+  boost::system::error_code errorCode;
+  if (boost::filesystem::exists(_destination, errorCode))
+    return true;
+
+  boost::filesystem::create_directories(_destination.parent_path(),
+      errorCode);
+  if (errorCode)
+    return false;
+
+  if (this->resourceStore.empty())
+    return this->CopyFile(_source, _destination);
+
+  // Hash the content, so that a resource used by many recordings is
+  // written to disk once.
+  std::ifstream in(_source.string(), std::ios::binary);
+  if (!in)
+    return false;
+  const std::string content((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  const std::string hash = common::get_sha1<std::string>(content);
+
+  boost::filesystem::path stored(this->resourceStore);
+  stored /= hash.substr(0, 2);
+  stored /= hash;
+
+  if (!boost::filesystem::exists(stored, errorCode))
+  {
+    boost::filesystem::create_directories(stored.parent_path(), errorCode);
+    if (errorCode)
+      return false;
+
+    // Write to a temporary file first, so that other recordings sharing
+    // the store never link a partial file.
+    boost::filesystem::path tmp = stored.string() + "." +
+        boost::filesystem::unique_path("%%%%%%%%").string();
+    if (!this->CopyFile(_source, tmp))
+    {
+      boost::filesystem::remove(tmp, errorCode);
+      return false;
+    }
+
+    boost::filesystem::rename(tmp, stored, errorCode);
+    if (errorCode)
+    {
+      boost::filesystem::remove(tmp, errorCode);
+      return false;
+    }
+  }
+
+  // Fall back to a copy when the store is on another file system.
+  boost::filesystem::create_hard_link(stored, _destination, errorCode);
+  if (errorCode)
+    return this->CopyFile(stored, _destination);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::CopyFile(const boost::filesystem::path &_source,
+    const boost::filesystem::path &_destination)
+{
+  std::ifstream in(_source.string(), std::ios::binary);
+  std::ofstream out(_destination.string(), std::ios::binary);
+  if (!in || !out)
+    return false;
+
+  std::vector<char> block(RESOURCE_BLOCK_SIZE);
+  while (in)
+  {
+    in.read(block.data(), block.size());
+    const std::streamsize count = in.gcount();
+    if (count <= 0)
+      break;
+
+    out.write(block.data(), count);
+    this->Throttle(count);
+  }
+
+  return static_cast<bool>(out);
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::Throttle(const uint64_t _bytes)
+{
+  if (this->bandwidth <= 0 || _bytes == 0)
+    return;
+
+  common::Time wait;
+  {
+    std::lock_guard<std::mutex> lock(this->throttleMutex);
+    common::Time now = common::Time::GetWallTime();
+
+    // Unused bandwidth is not saved up, so that a burst after an idle
+    // period is also paced.
+    if (this->throttleTime < now)
+      this->throttleTime = now;
+
+    this->throttleTime += common::Time(_bytes / this->bandwidth);
+    wait = this->throttleTime - now;
+  }
+
+  common::Time::Sleep(wait);
+}
+
 //////////////////////////////////////////////////
 void LogRecord::PublishLogStatus()
 {
@@ -1024,6 +1525,16 @@ void LogRecord::PublishLogStatus()
     msg.mutable_log_file()->set_size_units(msgs::LogStatus::LogFile::G_BYTES);
   }
 
+  // Report how well compression keeps up.
+  msg.set_buffer_size(this->BufferSize());
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->compressMutex);
+    msg.set_compress_queue(this->dataPtr->compressQueue.size());
+    msg.set_compress_stalls(this->dataPtr->compressStalls);
+    msgs::Set(msg.mutable_compress_stall_time(),
+        this->dataPtr->compressStallTime);
+  }
+
   this->dataPtr->logStatusPub->Publish(msg);
 }
 
@@ -1069,8 +1580,10 @@ void LogRecord::Cleanup()
 
   // Update and write one last time to make sure we log all data.
   this->Update();
+  this->dataPtr->StopCompressThreads();
 
   this->Write(true);
+  this->dataPtr->StopResourceThread();
 
   // Stop all the logs
   for (LogRecordPrivate::Log_M::iterator iter = this->dataPtr->logs.begin();
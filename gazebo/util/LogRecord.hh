@@ -38,9 +38,14 @@ namespace gazebo
     /// \sa LogRecord::Start
     class LogRecordParams
     {
-      /// \brief The type of encoding (txt, zlib, or bz2).
+      /// \brief The type of encoding (txt, zlib, bz2, or zstd).
       public: std::string encoding = "zlib";
 
+      /// \brief The file format (xml or binary). The xml format stores
+      /// Base64 encoded chunks in an XML document, which all the log tools
+      /// read. The binary format is opt-in, see BinaryLog.
+      public: std::string format = "xml";
+
       /// \brief Path in which to store log files.
       public: std::string path;
 
@@ -51,9 +56,27 @@ namespace gazebo
       /// \brief Log filter string
       public: std::string filter;
 
+      /// \brief Simulation time between full keyframes, in seconds. Frames
+      /// in between only hold the models and lights that changed. The
+      /// default, 0, records every frame in full. Any value <= 0 does.
+      public: double keyframePeriod = 0;
+
+      /// \brief Changes in position (meters), rotation (radians) and scale
+      /// up to this value are left out of frames that are not keyframes.
+      public: double tolerance = 1e-6;
+
       /// \brief Recording resources. True will record state logs
       /// together with model meshes and materials.
       public: bool recordResources = false;
+
+      /// \brief Directory shared by recordings, in which resources are
+      /// stored once by content hash and hard linked into each log. An
+      /// empty string copies resources into every log directory.
+      public: std::string resourceStore;
+
+      /// \brief Maximum rate at which log data and resources are written
+      /// to disk, in bytes per second. A value <= 0 is unlimited.
+      public: double bandwidth = 0;
     };
 
     // Forward declare private data class
@@ -153,6 +176,38 @@ namespace gazebo
       /// \param[in] _filter New log record filter regex string
       public: void SetFilter(const std::string &_filter);
 
+      /// \brief Get the simulation time between full keyframes.
+      /// \return Keyframe period in seconds, <= 0 if every frame is a
+      /// keyframe.
+      /// \sa LogRecordParams::keyframePeriod
+      public: double KeyframePeriod() const;
+
+      /// \brief Set the simulation time between full keyframes.
+      /// \param[in] _period Keyframe period in seconds, <= 0 to record
+      /// every frame in full.
+      public: void SetKeyframePeriod(const double _period);
+
+      /// \brief Get the tolerance below which changes are left out of
+      /// frames that are not keyframes.
+      /// \return Tolerance on positions (meters), rotations (radians) and
+      /// scale.
+      /// \sa LogRecordParams::tolerance
+      public: double Tolerance() const;
+
+      /// \brief Set the tolerance below which changes are left out of
+      /// frames that are not keyframes.
+      /// \param[in] _tolerance Tolerance on positions (meters), rotations
+      /// (radians) and scale.
+      public: void SetTolerance(const double _tolerance);
+
+      /// \brief Get the log file format.
+      /// \return Either xml, the default, or binary.
+      public: std::string Format() const;
+
+      /// \brief Set the log file format, used by the next call to Start.
+      /// \param[in] _format Either binary or xml.
+      public: void SetFormat(const std::string &_format);
+
       /// \brief Get whether the model meshes and materials are saved when
       /// recording.
       /// \return True if model meshes and materials are saved when recording.
@@ -162,6 +217,33 @@ namespace gazebo
       /// \param[in] _record True to save model resources when recording.
       public: void SetRecordResources(const bool _record);
 
+      /// \brief Get the directory in which resources are shared between
+      /// recordings.
+      /// \return Resource store path, empty if resources are copied into
+      /// every log directory.
+      /// \sa LogRecordParams::resourceStore
+      public: std::string ResourceStore() const;
+
+      /// \brief Set the directory in which resources are shared between
+      /// recordings.
+      /// \param[in] _path Resource store path, empty to copy resources into
+      /// every log directory.
+      public: void SetResourceStore(const std::string &_path);
+
+      /// \brief Get the maximum rate at which data is written to disk.
+      /// \return Bandwidth in bytes per second, <= 0 if unlimited.
+      /// \sa LogRecordParams::bandwidth
+      public: double Bandwidth() const;
+
+      /// \brief Set the maximum rate at which data is written to disk.
+      /// \param[in] _bandwidth Bandwidth in bytes per second, <= 0 for
+      /// unlimited.
+      public: void SetBandwidth(const double _bandwidth);
+
+      /// \brief Block until all the resources queued by SaveModels and
+      /// SaveFiles have been written to disk.
+      public: void WaitForResources();
+
       /// \brief Get whether the logger is ready to start, which implies
       /// that any previous runs have finished.
       // \return True if logger is ready to start.
@@ -176,14 +258,15 @@ namespace gazebo
       public: bool Start(const LogRecordParams &_params);
 
       /// \brief Start the logger.
-      /// \param[in] _encoding The type of encoding (txt, zlib, or bz2).
+      /// \param[in] _encoding The type of encoding (txt, zlib, bz2, or zstd).
       /// \param[in] _path Path in which to store log files.
       public: bool Start(const std::string &_encoding="zlib",
                          const std::string &_path="");
 
       /// \brief Get the encoding used.
-      /// \return Either [txt, zlib, or bz2], where txt is plain txt and bz2
-      /// and zlib are compressed data with Base64 encoding.
+      /// \return Either [txt, zlib, bz2, or zstd], where txt is plain txt
+      /// and the others are compressed data. Compressed data is Base64
+      /// encoded in the xml format.
       public: const std::string &Encoding() const;
 
       /// \brief Get the filename for a log object.
@@ -215,13 +298,17 @@ namespace gazebo
       /// \return True if an Update has not yet been completed.
       public: bool FirstUpdate() const;
 
-      /// \brief Return true if all the models are saved successfully.
+      /// \brief Save model directories with the log. The models are looked
+      /// up right away, and copied by a background thread.
       /// \return True if all the models are saved successfully.
+      /// \sa WaitForResources
       public: bool SaveModels(const std::set<std::string> &models);
 
-      /// \brief Return true if all the files are saved successfully.
-      /// \return True if all the files are saved successfully, and false if
-      /// there are errors saving the files.
+      /// \brief Save resource files with the log. The files are looked up
+      /// right away, and copied by a background thread.
+      /// \return True if all the files are found, and false if there are
+      /// errors saving the files. Copy errors are reported to the console.
+      /// \sa WaitForResources
       public: bool SaveFiles(const std::set<std::string> &resources);
 
       /// \brief Write all logs.
@@ -17,15 +17,20 @@
 #ifndef _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 #define _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 #include <functional>
 #include <condition_variable>
 #include <boost/filesystem.hpp>
 
+#include "gazebo/common/MemoryAccounting.hh"
+#include "gazebo/msgs/msgs.hh"
+
 namespace gazebo
 {
   namespace util
@@ -44,11 +49,14 @@ namespace gazebo
       {
         /// \brief Constructor
         /// \param[in] _parent Pointer to the LogRecord parent.
+        /// \param[in] _record Private data of the parent, which owns the
+        /// compression threads.
         /// \param[in] _relativeFilename The name of the log file to
         /// generate, sans the complete path.
         /// \param[in] _logCB Callback function, which is used to get log
         /// data.
-        public: Log(LogRecord *_parent, const std::string &_relativeFilename,
+        public: Log(LogRecord *_parent, LogRecordPrivate *_record,
+                    const std::string &_relativeFilename,
                     std::function<bool (std::ostringstream &)> _logCB);
 
         /// \brief Destructor
@@ -64,9 +72,21 @@ namespace gazebo
         /// \brief Write data to disk.
         public: void Write();
 
-        /// \brief Update the data buffer.
+        /// \brief Update the data buffer. New data is handed to the
+        /// compression threads when they are running, and is added to the
+        /// buffer once compressed.
+        /// \param[in] _queue False to compress new data right away.
         /// \return The size of the data buffer.
-        public: unsigned int Update();
+        public: unsigned int Update(const bool _queue = true);
+
+        /// \brief Add a compressed chunk to the data buffer. Chunks are
+        /// added in the order in which their data was collected.
+        /// \param[in] _sequence Sequence number of the chunk.
+        /// \param[in] _chunk The compressed chunk, its content is moved
+        /// into the log. An empty encoding marks a chunk that could not be
+        /// compressed.
+        public: void AddChunk(const uint64_t _sequence,
+                    msgs::LogFile::Chunk &_chunk);
 
         /// \brief Clear the data buffer.
         public: void ClearBuffer();
@@ -87,12 +107,20 @@ namespace gazebo
         /// \brief Pointer to the log record parent.
         public: LogRecord *parent;
 
+        /// \brief Private data of the log record parent.
+        public: LogRecordPrivate *record;
+
         /// \brief Callback from which to get data.
         public: std::function<bool (std::ostringstream &)> logCB;
 
         /// \brief Data buffer.
         public: std::string buffer;
 
+        /// \brief Memory of the data buffer, which keeps its capacity
+        /// when written to the file.
+        public: common::MemoryAccounting::Account memory{
+                    common::MemoryAccounting::LOGGING};
+
         /// \brief The log file.
         public: std::ofstream logFile;
 
@@ -101,8 +129,132 @@ namespace gazebo
 
         /// \brief Complete file path.
         public: boost::filesystem::path completePath;
+
+        /// \brief True if the log is written in the binary format.
+        public: bool binary = false;
+
+        /// \brief Number of bytes written to the log file or waiting in
+        /// the buffer. Used to index the chunks of a binary log.
+        public: uint64_t fileOffset = 0;
+
+        /// \brief Index of the chunks of a binary log.
+        public: msgs::LogFile::Index index;
+
+        /// \brief Sequence number of the next chunk of collected data.
+        public: uint64_t nextSequence = 0;
+
+        /// \brief Sequence number of the next chunk to add to the buffer.
+        public: uint64_t bufferSequence = 0;
+
+        /// \brief Compressed chunks waiting for an earlier chunk, by
+        /// sequence number.
+        public: std::map<uint64_t, msgs::LogFile::Chunk> compressedChunks;
+      };
+
+      /// \brief Data of a log waiting to be compressed.
+      public: class CompressJob
+      {
+        /// \brief Log the data belongs to. Compression threads check that
+        /// it is still in the map of logs before they use it.
+        public: Log *log = nullptr;
+
+        /// \brief Sequence number of the data in its log.
+        public: uint64_t sequence = 0;
+
+        /// \brief Compression to use.
+        public: std::string encoding;
+
+        /// \brief True to Base64 encode the compressed data, as required
+        /// by the xml format.
+        public: bool base64 = false;
+
+        /// \brief The uncompressed data.
+        public: std::string data;
+      };
+
+      /// \brief Queue data for compression. Data is compressed right away
+      /// when the compression threads are not running.
+      /// Must be called with writeMutex locked.
+      /// \param[in] _job The data to compress.
+      public: void QueueCompress(CompressJob &&_job);
+
+      /// \brief Compress a chunk of data.
+      /// \param[in] _job The data to compress.
+      /// \param[out] _chunk The compressed chunk. Its encoding is left
+      /// empty if the data could not be compressed.
+      public: static void Compress(const CompressJob &_job,
+                  msgs::LogFile::Chunk &_chunk);
+
+      /// \brief Start the compression threads.
+      public: void StartCompressThreads();
+
+      /// \brief Compress all the queued data, and stop the compression
+      /// threads.
+      public: void StopCompressThreads();
+
+      /// \brief Block while the compression queue is full. This slows
+      /// down the update thread until compression catches up.
+      public: void WaitForCompressQueue();
+
+      /// \brief Block until all the queued data has been compressed.
+      public: void WaitForCompress();
+
+      /// \brief Compression thread loop.
+      public: void RunCompress();
+
+      /// \brief A model directory or file to save with the log.
+      public: class ResourceJob
+      {
+        /// \brief File or directory to copy.
+        public: boost::filesystem::path source;
+
+        /// \brief Destination inside the log directory.
+        public: boost::filesystem::path destination;
       };
 
+      /// \brief Queue a resource to be copied by the resource thread,
+      /// which is started if needed.
+      /// \param[in] _source File or directory to copy.
+      /// \param[in] _destination Destination inside the log directory.
+      public: void QueueResource(const boost::filesystem::path &_source,
+                  const boost::filesystem::path &_destination);
+
+      /// \brief Copy all the queued resources, and stop the resource
+      /// thread.
+      public: void StopResourceThread();
+
+      /// \brief Block until all the queued resources have been copied.
+      public: void WaitForResources();
+
+      /// \brief Resource thread loop.
+      public: void RunResources();
+
+      /// \brief Copy a resource, walking directories file by file.
+      /// \param[in] _job Resource to copy.
+      /// \return True if every file was copied.
+      public: bool CopyResource(const ResourceJob &_job);
+
+      /// \brief Save a single resource file. With a resource store the
+      /// content is stored once by hash and hard linked into the log.
+      /// \param[in] _source File to copy.
+      /// \param[in] _destination Destination inside the log directory.
+      /// \return True on success.
+      public: bool SaveResourceFile(const boost::filesystem::path &_source,
+                  const boost::filesystem::path &_destination);
+
+      /// \brief Copy a file in blocks, at no more than the bandwidth.
+      /// \param[in] _source File to copy.
+      /// \param[in] _destination File to write.
+      /// \return True on success.
+      public: bool CopyFile(const boost::filesystem::path &_source,
+                  const boost::filesystem::path &_destination);
+
+      /// \brief Account for bytes written to disk, and sleep as needed to
+      /// keep writes under the bandwidth. Shared by the logs and the
+      /// resource thread.
+      /// \param[in] _bytes Number of bytes just written.
+      public: void Throttle(const uint64_t _bytes);
+
       /// \def Log_M
       /// \brief Map of names to logs.
       public: typedef std::map<std::string, Log*> Log_M;
@@ -137,6 +289,35 @@ namespace gazebo
       /// \brief Thread to cleanup log recording.
       public: std::unique_ptr<std::thread> cleanupThread;
 
+      /// \brief Threads that compress log data.
+      public: std::vector<std::thread> compressThreads;
+
+      /// \brief Data waiting to be compressed.
+      public: std::deque<CompressJob> compressQueue;
+
+      /// \brief Number of chunks being compressed.
+      public: unsigned int compressing = 0;
+
+      /// \brief Flag used to stop the compression threads.
+      public: bool stopCompress = false;
+
+      /// \brief Number of times the update thread blocked on a full
+      /// compression queue.
+      public: uint64_t compressStalls = 0;
+
+      /// \brief Wall time the update thread spent blocked on a full
+      /// compression queue.
+      public: common::Time compressStallTime;
+
+      /// \brief Mutex to protect the compression queue and counters.
+      public: mutable std::mutex compressMutex;
+
+      /// \brief Used by the compression threads to wait for data.
+      public: std::condition_variable compressCondition;
+
+      /// \brief Signaled when a chunk has been compressed.
+      public: std::condition_variable compressDoneCondition;
+
       /// \brief Mutex to protect against parallel calls to Write()
       public: mutable std::mutex writeMutex;
 
@@ -166,6 +347,9 @@ namespace gazebo
       /// \brief Encoding format for each chunk.
       public: std::string encoding;
 
+      /// \brief Log file format, xml or binary.
+      public: std::string format = "xml";
+
       /// \brief True if initialized.
       public: bool initialized;
 
@@ -209,9 +393,52 @@ namespace gazebo
       /// \brief Record filter string.
       public: std::string filter = "";
 
+      /// \brief Simulation time between full keyframes.
+      public: double keyframePeriod = 0;
+
+      /// \brief Tolerance below which changes are left out of frames that
+      /// are not keyframes.
+      public: double tolerance = 1e-6;
+
       /// \brief Record with model resources.
       public: bool recordResources = false;
 
+      /// \brief Directory in which resources are shared between
+      /// recordings, empty to copy them into every log.
+      public: std::string resourceStore;
+
+      /// \brief Maximum write rate, in bytes per second. <= 0 is
+      /// unlimited.
+      public: double bandwidth = 0;
+
+      /// \brief Wall time at which the bytes written so far are within
+      /// the bandwidth.
+      public: common::Time throttleTime;
+
+      /// \brief Mutex to protect throttleTime.
+      public: std::mutex throttleMutex;
+
+      /// \brief Thread that copies resources into the log.
+      public: std::unique_ptr<std::thread> resourceThread;
+
+      /// \brief Resources waiting to be copied.
+      public: std::deque<ResourceJob> resourceQueue;
+
+      /// \brief True while the resource thread copies a resource.
+      public: bool copyingResource = false;
+
+      /// \brief Flag used to stop the resource thread.
+      public: bool stopResources = false;
+
+      /// \brief Mutex to protect the resource queue.
+      public: std::mutex resourceMutex;
+
+      /// \brief Used by the resource thread to wait for resources.
+      public: std::condition_variable resourceCondition;
+
+      /// \brief Signaled when a resource has been copied.
+      public: std::condition_variable resourceDoneCondition;
+
       /// \brief List of saved models if record with resources is enabled.
       public: std::set<std::string> savedModels;
 
@@ -15,6 +15,9 @@
  *
 */
 #include <gtest/gtest.h>
+#include <fstream>
+#include <set>
+#include <string>
 #include <boost/filesystem.hpp>
 
 #include "gazebo/common/CommonIface.hh"
@@ -58,6 +61,22 @@ TEST_F(LogRecord_TEST, Constructor)
   EXPECT_FALSE(recorder->Init(""));
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that frames are recorded in full unless delta frames are
+/// requested
+TEST_F(LogRecord_TEST, KeyframePeriod)
+{
+  gazebo::util::LogRecord *recorder = gazebo::util::LogRecord::Instance();
+
+  EXPECT_DOUBLE_EQ(0.0, gazebo::util::LogRecordParams().keyframePeriod);
+  EXPECT_DOUBLE_EQ(0.0, recorder->KeyframePeriod());
+
+  recorder->SetKeyframePeriod(1.0);
+  EXPECT_DOUBLE_EQ(1.0, recorder->KeyframePeriod());
+  recorder->SetKeyframePeriod(0.0);
+  EXPECT_DOUBLE_EQ(0.0, recorder->KeyframePeriod());
+}
+
 /////////////////////////////////////////////////
 /// \brief Test LogRecord Start errors
 TEST_F(LogRecord_TEST, StartErrors)
@@ -75,6 +94,16 @@ TEST_F(LogRecord_TEST, StartErrors)
     EXPECT_THROW(recorder->Start("garbage"), gazebo::common::Exception);
   }
 
+  // Invalid format
+  {
+    EXPECT_EQ("xml", recorder->Format());
+    EXPECT_EQ("xml", gazebo::util::LogRecordParams().format);
+    recorder->SetFormat("garbage");
+    EXPECT_EQ("garbage", recorder->Format());
+    EXPECT_THROW(recorder->Start("bz2"), gazebo::common::Exception);
+    recorder->SetFormat("xml");
+  }
+
   // Double start
   {
     EXPECT_TRUE(recorder->Start("bz2"));
@@ -226,6 +255,84 @@ TEST_F(LogRecord_TEST, RecordResources)
   EXPECT_FALSE(recorder->RecordResources());
 }
 
+/////////////////////////////////////////////////
+/// \brief Test sharing resources between recordings, and throttling
+TEST_F(LogRecord_TEST, ResourceStore)
+{
+  gazebo::util::LogRecord *recorder = gazebo::util::LogRecord::Instance();
+
+  // check default values
+  EXPECT_EQ(recorder->ResourceStore(), std::string());
+  EXPECT_DOUBLE_EQ(recorder->Bandwidth(), 0);
+
+  recorder->SetBandwidth(1e6);
+  EXPECT_DOUBLE_EQ(recorder->Bandwidth(), 1e6);
+  recorder->SetBandwidth(0);
+
+  boost::filesystem::path tmpDir = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_resource_store_%%%%");
+  boost::filesystem::path store = tmpDir / "store";
+  boost::filesystem::create_directories(tmpDir / "src");
+
+  // A resource of 100 kB
+  const std::string resource = (tmpDir / "src" / "mesh.dae").string();
+  {
+    std::ofstream out(resource, std::ios::binary);
+    out << std::string(100000, 'x');
+  }
+
+  gazebo::util::LogRecordParams params;
+  params.resourceStore = store.string();
+  params.bandwidth = 5e5;
+
+  for (auto const &logDir : {"log1", "log2"})
+  {
+    params.path = (tmpDir / logDir).string();
+    EXPECT_TRUE(recorder->Init("test"));
+    EXPECT_TRUE(recorder->Start(params));
+    EXPECT_EQ(recorder->ResourceStore(), store.string());
+
+    gazebo::common::Time start = gazebo::common::Time::GetWallTime();
+    EXPECT_TRUE(recorder->SaveFiles(std::set<std::string>({resource})));
+    recorder->WaitForResources();
+    gazebo::common::Time elapsed =
+        gazebo::common::Time::GetWallTime() - start;
+
+    // Only the first recording writes the resource, at 500 kB/s.
+    if (std::string(logDir) == "log1")
+      EXPECT_GT(elapsed.Double(), 0.15);
+
+    EXPECT_TRUE(boost::filesystem::exists(
+        boost::filesystem::path(params.path) / resource));
+
+    recorder->Stop();
+    int i = 0;
+    while (!recorder->IsReadyToStart())
+    {
+      gazebo::common::Time::MSleep(100);
+      if ((++i % 50) == 0)
+        gzdbg << "Waiting for recorder->IsReadyToStart()" << std::endl;
+    }
+  }
+
+  // The content is stored once, and linked into both logs.
+  unsigned int stored = 0;
+  for (boost::filesystem::recursive_directory_iterator iter(store), end;
+       iter != end; ++iter)
+  {
+    if (boost::filesystem::is_regular_file(iter->path()))
+    {
+      ++stored;
+      EXPECT_EQ(3u, boost::filesystem::hard_link_count(iter->path()));
+    }
+  }
+  EXPECT_EQ(1u, stored);
+
+  recorder->SetResourceStore("");
+  recorder->SetBandwidth(0);
+  boost::filesystem::remove_all(tmpDir);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
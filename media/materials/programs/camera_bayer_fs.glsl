@@ -0,0 +1,30 @@
+// This fragment shader turns a rendered RGB image into a Bayer pattern, so
+// that the mosaic is generated on the GPU instead of on the CPU after the
+// image is read back. Each pixel keeps a single color channel, picked by the
+// parity of its row and column, and that value is written to all the output
+// channels. The camera then only needs to keep one byte of each pixel.
+
+// The input texture, which is set up by the Ogre Compositor infrastructure.
+uniform sampler2D RT;
+
+// Channel kept by the pixels on an (even row, even column), (even row, odd
+// column), (odd row, even column) and (odd row, odd column), in that order.
+// 0 is red, 1 is green and 2 is blue.
+uniform vec4 pattern;
+
+// Width and height of the image, in pixels.
+uniform vec4 viewportSize;
+
+void main()
+{
+  vec2 pixel = floor(gl_TexCoord[0].st * viewportSize.xy);
+  vec2 parity = mod(pixel, 2.0);
+
+  float channel = mix(mix(pattern.x, pattern.y, parity.x),
+                      mix(pattern.z, pattern.w, parity.x), parity.y);
+
+  vec3 color = texture2D(RT, gl_TexCoord[0].st).rgb;
+  float value = channel < 0.5 ? color.r : (channel < 1.5 ? color.g : color.b);
+
+  gl_FragColor = vec4(value, value, value, 1.0);
+}
@@ -1,17 +1,26 @@
 #version 120
 
+// Camera image, rendered before the points
 uniform sampler2D tex;
 
 uniform float width;
 uniform float height;
 
+// Points further away are dropped, unless it is not positive
+uniform float maxRange;
+
 varying vec4 point;
 
 void main()
 {
-  //vec3 color = 255 * texture2D(tex, vec2(gl_FragCoord.s / width , gl_FragCoord.t / height)).xyz;
-  vec3 color = vec3(80, 0, 0);
-  // int rgb = int(color.r) << 16 | int(color.g) << 8 | int(color.b);
-  int rgb = 1;
+  if (maxRange > 0.0 && length(point.xyz) > maxRange)
+    discard;
+
+  // Pack the color of the point as the integer 0xRRGGBB, which a float
+  // represents exactly
+  vec3 color = floor(255.0 * texture2D(tex,
+      vec2(gl_FragCoord.s / width, gl_FragCoord.t / height)).rgb + 0.5);
+  float rgb = color.r * 65536.0 + color.g * 256.0 + color.b;
+
   gl_FragColor = vec4(point.x, -point.y, -point.z, rgb);
 }
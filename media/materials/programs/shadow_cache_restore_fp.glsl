@@ -0,0 +1,14 @@
+uniform sampler2D cached_map;
+uniform vec4 viewport_size;
+
+void main()
+{
+  // The cached map has the texels of the shadow texture, read the one of
+  // this fragment
+  float depth = texture2D(cached_map, gl_FragCoord.xy * viewport_size.zw).r;
+
+  gl_FragColor = vec4(depth, depth, depth, 1.0);
+
+  // Casters wrote their clip space depth
+  gl_FragDepth = depth * 0.5 + 0.5;
+}
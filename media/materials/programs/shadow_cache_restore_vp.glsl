@@ -0,0 +1,5 @@
+void main()
+{
+  // Full screen quad, already in clip space
+  gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);
+}
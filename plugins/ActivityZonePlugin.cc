@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/ActivityZoneManager.hh"
+#include "gazebo/physics/World.hh"
+#include "plugins/ActivityZonePlugin.hh"
+
+using namespace gazebo;
+
+GZ_REGISTER_WORLD_PLUGIN(ActivityZonePlugin)
+
+/////////////////////////////////////////////////
+ActivityZonePlugin::ActivityZonePlugin()
+{
+}
+
+/////////////////////////////////////////////////
+ActivityZonePlugin::~ActivityZonePlugin()
+{
+}
+
+/////////////////////////////////////////////////
+void ActivityZonePlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
+{
+  GZ_ASSERT(_world, "ActivityZonePlugin world pointer is NULL");
+  GZ_ASSERT(_sdf, "ActivityZonePlugin sdf pointer is NULL");
+
+  physics::ActivityZoneManager &zones = _world->ActivityZones();
+
+  if (_sdf->HasElement("tile_size"))
+    zones.SetTileSize(_sdf->Get<double>("tile_size"));
+
+  if (_sdf->HasElement("refresh_period"))
+    zones.SetRefreshPeriod(_sdf->Get<unsigned int>("refresh_period"));
+
+  if (_sdf->HasElement("inactive_update_period"))
+  {
+    zones.SetInactiveUpdatePeriod(
+        _sdf->Get<unsigned int>("inactive_update_period"));
+  }
+
+  if (_sdf->HasElement("defer_plugins"))
+    zones.SetDeferPlugins(_sdf->Get<bool>("defer_plugins"));
+
+  sdf::ElementPtr zoneElem;
+  if (_sdf->HasElement("zone"))
+    zoneElem = _sdf->GetElement("zone");
+
+  while (zoneElem)
+  {
+    if (!zoneElem->HasElement("model") || !zoneElem->HasElement("radius"))
+    {
+      gzerr << "ActivityZonePlugin: a <zone> needs a <model> and a <radius>"
+            << std::endl;
+    }
+    else
+    {
+      zones.SetZone(zoneElem->Get<std::string>("model"),
+          zoneElem->Get<double>("radius"));
+    }
+    zoneElem = zoneElem->GetNextElement("zone");
+  }
+
+  if (zones.ZoneCount() == 0)
+  {
+    gzwarn << "ActivityZonePlugin: no activity zone, every dynamic model "
+           << "will be frozen" << std::endl;
+  }
+
+  zones.SetEnabled(true);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_ACTIVITYZONEPLUGIN_HH_
+#define GAZEBO_PLUGINS_ACTIVITYZONEPLUGIN_HH_
+
+#include <sdf/sdf.hh>
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  /// \brief World plugin that enables the tile based update of
+  /// physics::ActivityZoneManager and defines its activity zones.
+  ///
+  /// Models outside of every zone are frozen, see
+  /// physics::ActivityZoneManager for details.
+  ///
+  /// Example:
+  /// \verbatim
+  ///   <plugin name="activity_zones" filename="libActivityZonePlugin.so">
+  ///     <!-- Side of the tiles of the spatial index, in meters -->
+  ///     <tile_size>50</tile_size>
+  ///     <!-- Iterations between refreshes of the index -->
+  ///     <refresh_period>10</refresh_period>
+  ///     <!-- Iterations between updates of frozen models, 0 for never -->
+  ///     <inactive_update_period>100</inactive_update_period>
+  ///     <!-- Load the plugins of frozen models once they are active -->
+  ///     <defer_plugins>true</defer_plugins>
+  ///     <!-- One or more zones that follow a model -->
+  ///     <zone>
+  ///       <model>robot</model>
+  ///       <radius>100</radius>
+  ///     </zone>
+  ///   </plugin>
+  /// \endverbatim
+  class GZ_PLUGIN_VISIBLE ActivityZonePlugin : public WorldPlugin
+  {
+    /// \brief Constructor.
+    public: ActivityZonePlugin();
+
+    /// \brief Destructor.
+    public: ~ActivityZonePlugin();
+
+    // Documentation Inherited.
+    public: virtual void Load(physics::WorldPtr _world,
+                              sdf::ElementPtr _sdf);
+  };
+}
+#endif
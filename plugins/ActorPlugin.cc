@@ -18,7 +18,7 @@
 #include <functional>
 
 #include <ignition/math.hh>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/physics/physics.hh"
 #include "plugins/ActorPlugin.hh"
 
@@ -39,8 +39,14 @@ void ActorPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
   this->actor = boost::dynamic_pointer_cast<physics::Actor>(_model);
   this->world = this->actor->GetWorld();
 
-  this->connections.push_back(event::Events::ConnectWorldUpdateBegin(
-          std::bind(&ActorPlugin::OnUpdate, this, std::placeholders::_1)));
+  // The motion is integrated over the time since the last update, so the
+  // actor can be updated at a lower rate than the physics.
+  double rate = 0.0;
+  if (_sdf->HasElement("update_rate"))
+    rate = _sdf->Get<double>("update_rate");
+  this->connections.push_back(this->world->Scheduler().Connect(
+          std::bind(&ActorPlugin::OnUpdate, this, std::placeholders::_1),
+          rate, this->actor->GetName() + "::" + this->GetHandle()));
 
   this->Reset();
 
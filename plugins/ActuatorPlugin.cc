@@ -17,7 +17,7 @@
 
 #include <functional>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "ActuatorPlugin.hh"
 
@@ -15,7 +15,7 @@
  *
 */
 
-#include "ignition/common/Profiler.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Events.hh"
 #include "plugins/BuoyancyPlugin.hh"
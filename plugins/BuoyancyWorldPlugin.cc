@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Profiler.hh"
+#include <ignition/math/Vector2.hh>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Events.hh"
+#include "plugins/BuoyancyWorldPlugin.hh"
+
+namespace gazebo
+{
+  /// \brief A sinusoidal wave of the water surface.
+  class BuoyancyWave
+  {
+    /// \brief Height of the crests above the calm surface.
+    public: double amplitude = 0;
+
+    /// \brief Wave number, 2 pi over the wavelength.
+    public: double wavenumber = 0;
+
+    /// \brief Angular frequency, 2 pi over the period.
+    public: double frequency = 0;
+
+    /// \brief Unit direction in which the wave travels.
+    public: ignition::math::Vector2d direction = {1, 0};
+  };
+
+  /// \brief Volume properties of a floating link.
+  class FloatingVolume
+  {
+    /// \brief Center of volume in the link frame.
+    public: ignition::math::Vector3d cov;
+
+    /// \brief Volume in m^3.
+    public: double volume = 0;
+
+    /// \brief Height of the volume, over which it gets submerged. 0 to use
+    /// the height of the bounding box of the link.
+    public: double height = 0;
+  };
+}
+
+/// \brief Private class for BuoyancyWorldPlugin
+class gazebo::BuoyancyWorldPluginPrivate
+{
+  /// \brief World pointer.
+  public: physics::WorldPtr world;
+
+  /// \brief Connection to World Update events.
+  public: event::ConnectionPtr updateConnection;
+
+  /// \brief Connection to add entity events.
+  public: event::ConnectionPtr addEntityConnection;
+
+  /// \brief Density of the fluid in kg/m^3. Defaults to the density of
+  /// liquid water at 1 atm pressure and 15 degrees Celsius.
+  public: double fluidDensity = 999.1026;
+
+  /// \brief Height of the calm water surface.
+  public: double waterLevel = 0;
+
+  /// \brief Waves of the water surface.
+  public: std::vector<BuoyancyWave> waves;
+
+  /// \brief Drag force per unit of velocity and of submerged volume.
+  public: double linearDrag = 0;
+
+  /// \brief Drag torque per unit of angular velocity and of submerged
+  /// volume.
+  public: double angularDrag = 0;
+
+  /// \brief Names of the models that float, every dynamic model if empty.
+  public: std::set<std::string> modelNames;
+
+  /// \brief Volume properties given in SDF, by model and link name.
+  public: std::map<std::string, std::map<std::string, FloatingVolume>>
+      sdfVolumes;
+
+  /// \brief Volume properties computed from the collision shapes, by link
+  /// id, so that they are only computed once.
+  public: std::map<uint32_t, FloatingVolume> computedVolumes;
+
+  /// \brief True when models were added since the links were gathered.
+  public: bool linksDirty = true;
+
+  /// \brief Number of models when the links were gathered.
+  public: unsigned int modelCount = 0;
+
+  /// \brief Floating links.
+  public: std::vector<physics::LinkPtr> links;
+
+  /// \brief Center of volume of every floating link, in the link frame.
+  public: std::vector<ignition::math::Vector3d> covs;
+
+  /// \brief Volume of every floating link.
+  public: std::vector<double> volumes;
+
+  /// \brief Height of the volume of every floating link.
+  public: std::vector<double> heights;
+
+  /// \brief Pose of every floating link, reused each step.
+  public: std::vector<ignition::math::Pose3d> poses;
+
+  /// \brief Height of the center of volume of every floating link below
+  /// the water surface, then fraction of the volume submerged. Reused each
+  /// step.
+  public: std::vector<double> submerged;
+};
+
+using namespace gazebo;
+
+GZ_REGISTER_WORLD_PLUGIN(BuoyancyWorldPlugin)
+
+/////////////////////////////////////////////////
+BuoyancyWorldPlugin::BuoyancyWorldPlugin()
+  : dataPtr(new BuoyancyWorldPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+BuoyancyWorldPlugin::~BuoyancyWorldPlugin()
+{
+}
+
+/////////////////////////////////////////////////
+void BuoyancyWorldPlugin::Load(physics::WorldPtr _world,
+    sdf::ElementPtr _sdf)
+{
+  GZ_ASSERT(_world, "BuoyancyWorldPlugin world pointer is NULL");
+  GZ_ASSERT(_sdf, "BuoyancyWorldPlugin sdf pointer is NULL");
+  this->dataPtr->world = _world;
+
+  if (_sdf->HasElement("fluid_density"))
+    this->dataPtr->fluidDensity = _sdf->Get<double>("fluid_density");
+
+  if (_sdf->HasElement("water_level"))
+    this->dataPtr->waterLevel = _sdf->Get<double>("water_level");
+
+  if (_sdf->HasElement("linear_drag"))
+    this->dataPtr->linearDrag = _sdf->Get<double>("linear_drag");
+
+  if (_sdf->HasElement("angular_drag"))
+    this->dataPtr->angularDrag = _sdf->Get<double>("angular_drag");
+
+  sdf::ElementPtr waveElem;
+  if (_sdf->HasElement("wave"))
+    waveElem = _sdf->GetElement("wave");
+  for (; waveElem; waveElem = waveElem->GetNextElement("wave"))
+  {
+    if (!waveElem->HasElement("amplitude") ||
+        !waveElem->HasElement("wavelength") ||
+        !waveElem->HasElement("period"))
+    {
+      gzerr << "BuoyancyWorldPlugin: a <wave> needs an <amplitude>, a "
+            << "<wavelength> and a <period>" << std::endl;
+      continue;
+    }
+
+    const double wavelength = waveElem->Get<double>("wavelength");
+    const double period = waveElem->Get<double>("period");
+    if (wavelength <= 0 || period <= 0)
+    {
+      gzerr << "BuoyancyWorldPlugin: nonpositive wavelength or period"
+            << std::endl;
+      continue;
+    }
+
+    BuoyancyWave wave;
+    wave.amplitude = waveElem->Get<double>("amplitude");
+    wave.wavenumber = 2 * M_PI / wavelength;
+    wave.frequency = 2 * M_PI / period;
+    if (waveElem->HasElement("direction"))
+    {
+      const ignition::math::Vector2d direction =
+        waveElem->Get<ignition::math::Vector2d>("direction");
+      if (direction.Length() > 0)
+        wave.direction = direction / direction.Length();
+    }
+    this->dataPtr->waves.push_back(wave);
+  }
+
+  sdf::ElementPtr modelElem;
+  if (_sdf->HasElement("model"))
+    modelElem = _sdf->GetElement("model");
+  for (; modelElem; modelElem = modelElem->GetNextElement("model"))
+  {
+    if (!modelElem->HasAttribute("name"))
+    {
+      gzwarn << "Required attribute name missing from model in "
+             << "BuoyancyWorldPlugin SDF" << std::endl;
+      continue;
+    }
+    const std::string modelName = modelElem->Get<std::string>("name");
+    this->dataPtr->modelNames.insert(modelName);
+
+    sdf::ElementPtr linkElem;
+    if (modelElem->HasElement("link"))
+      linkElem = modelElem->GetElement("link");
+    for (; linkElem; linkElem = linkElem->GetNextElement("link"))
+    {
+      const std::string linkName = linkElem->Get<std::string>("name");
+      if (!linkElem->HasElement("volume") ||
+          linkElem->Get<double>("volume") <= 0)
+      {
+        gzwarn << "Missing or nonpositive volume of link [" << linkName
+               << "] in BuoyancyWorldPlugin SDF" << std::endl;
+        continue;
+      }
+
+      FloatingVolume &volume =
+        this->dataPtr->sdfVolumes[modelName][linkName];
+      volume.volume = linkElem->Get<double>("volume");
+      if (linkElem->HasElement("center_of_volume"))
+      {
+        volume.cov =
+          linkElem->Get<ignition::math::Vector3d>("center_of_volume");
+      }
+      if (linkElem->HasElement("height"))
+        volume.height = linkElem->Get<double>("height");
+    }
+  }
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&BuoyancyWorldPlugin::OnUpdate, this));
+  this->dataPtr->addEntityConnection = event::Events::ConnectAddEntity(
+      [this](const std::string &)
+      {
+        this->dataPtr->linksDirty = true;
+      });
+}
+
+/////////////////////////////////////////////////
+double BuoyancyWorldPlugin::SurfaceHeight(const double _x, const double _y,
+    const double _time) const
+{
+  double height = this->dataPtr->waterLevel;
+  for (auto const &wave : this->dataPtr->waves)
+  {
+    height += wave.amplitude * std::sin(wave.wavenumber *
+        (wave.direction.X() * _x + wave.direction.Y() * _y) -
+        wave.frequency * _time);
+  }
+  return height;
+}
+
+/////////////////////////////////////////////////
+void BuoyancyWorldPlugin::UpdateLinks()
+{
+  this->dataPtr->linksDirty = false;
+  this->dataPtr->modelCount = this->dataPtr->world->ModelCount();
+  this->dataPtr->links.clear();
+  this->dataPtr->covs.clear();
+  this->dataPtr->volumes.clear();
+  this->dataPtr->heights.clear();
+
+  for (auto const &model : this->dataPtr->world->Models())
+  {
+    if (model->IsStatic())
+      continue;
+
+    if (!this->dataPtr->modelNames.empty() &&
+        this->dataPtr->modelNames.count(model->GetName()) == 0)
+    {
+      continue;
+    }
+
+    auto sdfModel = this->dataPtr->sdfVolumes.find(model->GetName());
+    for (auto const &link : model->GetLinks())
+    {
+      const FloatingVolume *sdfVolume = nullptr;
+      if (sdfModel != this->dataPtr->sdfVolumes.end())
+      {
+        auto sdfLink = sdfModel->second.find(link->GetName());
+        if (sdfLink != sdfModel->second.end())
+          sdfVolume = &sdfLink->second;
+      }
+
+      FloatingVolume volume;
+      if (sdfVolume)
+      {
+        volume = *sdfVolume;
+      }
+      else
+      {
+        auto computed = this->dataPtr->computedVolumes.find(link->GetId());
+        if (computed == this->dataPtr->computedVolumes.end())
+        {
+          // The center of volume of the link is a weighted average over the
+          // pose of each collision shape, where the weight is the volume of
+          // the shape
+          double volumeSum = 0;
+          ignition::math::Vector3d weightedPosSum;
+          for (auto const &collision : link->GetCollisions())
+          {
+            const double shapeVolume = collision->GetShape()->ComputeVolume();
+            volumeSum += shapeVolume;
+            weightedPosSum += shapeVolume * collision->WorldPose().Pos();
+          }
+
+          FloatingVolume linkVolume;
+          if (volumeSum > 0)
+          {
+            const ignition::math::Pose3d linkPose = link->WorldPose();
+            linkVolume.volume = volumeSum;
+            linkVolume.cov = linkPose.Rot().RotateVectorReverse(
+                weightedPosSum / volumeSum - linkPose.Pos());
+          }
+          computed = this->dataPtr->computedVolumes.insert(
+              std::make_pair(link->GetId(), linkVolume)).first;
+        }
+        volume = computed->second;
+      }
+
+      // Links without collision volume, such as meshes, don't float
+      if (volume.volume <= 0)
+        continue;
+
+      if (volume.height <= 0)
+        volume.height = link->BoundingBox().ZLength();
+      if (!(volume.height > 0) || !std::isfinite(volume.height))
+        volume.height = std::cbrt(volume.volume);
+
+      this->dataPtr->links.push_back(link);
+      this->dataPtr->covs.push_back(volume.cov);
+      this->dataPtr->volumes.push_back(volume.volume);
+      this->dataPtr->heights.push_back(volume.height);
+    }
+  }
+
+  this->dataPtr->poses.resize(this->dataPtr->links.size());
+  this->dataPtr->submerged.resize(this->dataPtr->links.size());
+}
+
+/////////////////////////////////////////////////
+void BuoyancyWorldPlugin::OnUpdate()
+{
+  IGN_PROFILE("BuoyancyWorldPlugin::OnUpdate");
+
+  if (this->dataPtr->linksDirty ||
+      this->dataPtr->modelCount != this->dataPtr->world->ModelCount())
+  {
+    this->UpdateLinks();
+  }
+
+  const size_t count = this->dataPtr->links.size();
+  if (count == 0)
+    return;
+
+  const double time = this->dataPtr->world->SimTime().Double();
+  const ignition::math::Vector3d gravity = this->dataPtr->world->Gravity();
+  std::vector<ignition::math::Pose3d> &poses = this->dataPtr->poses;
+  std::vector<double> &submerged = this->dataPtr->submerged;
+  const std::vector<double> &heights = this->dataPtr->heights;
+
+  // Depth of the centers of volume below the surface
+  for (size_t i = 0; i < count; ++i)
+  {
+    poses[i] = this->dataPtr->links[i]->WorldPose();
+    const ignition::math::Vector3d center = poses[i].Pos() +
+      poses[i].Rot().RotateVector(this->dataPtr->covs[i]);
+    submerged[i] = this->SurfaceHeight(center.X(), center.Y(), time) -
+      center.Z();
+  }
+
+  // Fractions of the volumes under the surface, with each volume spread
+  // evenly over its height. A plain loop over the arrays, which the
+  // compiler vectorizes.
+  for (size_t i = 0; i < count; ++i)
+    submerged[i] = std::min(std::max(0.5 + submerged[i] / heights[i], 0.0),
+        1.0);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (submerged[i] <= 0)
+      continue;
+
+    const physics::LinkPtr &link = this->dataPtr->links[i];
+    const ignition::math::Quaterniond &rot = poses[i].Rot();
+    const double volume = this->dataPtr->volumes[i] * submerged[i];
+
+    // By Archimedes' principle, applied at the center of the submerged
+    // part of the volume, which is below the center of volume
+    const ignition::math::Vector3d buoyancy =
+      -this->dataPtr->fluidDensity * volume * gravity;
+    const ignition::math::Vector3d center = this->dataPtr->covs[i] +
+      rot.RotateVectorReverse(ignition::math::Vector3d(0, 0,
+            -0.5 * (1.0 - submerged[i]) * heights[i]));
+    link->AddLinkForce(rot.RotateVectorReverse(buoyancy), center);
+
+    if (this->dataPtr->linearDrag > 0)
+    {
+      link->AddForce(-this->dataPtr->linearDrag * volume *
+          link->WorldLinearVel());
+    }
+
+    if (this->dataPtr->angularDrag > 0)
+    {
+      link->AddTorque(-this->dataPtr->angularDrag * volume *
+          link->WorldAngularVel());
+    }
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_BUOYANCYWORLDPLUGIN_HH_
+#define GAZEBO_PLUGINS_BUOYANCYWORLDPLUGIN_HH_
+
+#include <memory>
+
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/physics/physics.hh"
+
+namespace gazebo
+{
+  // Forward declaration
+  class BuoyancyWorldPluginPrivate;
+
+  /// \brief A world plugin that simulates the buoyancy and drag of every
+  /// floating model in a world in one pass, for worlds with many vessels.
+  /// Unlike BuoyancyPlugin, links may be partially submerged and the water
+  /// surface can have waves. All SDF parameters are optional.
+  /// <fluid_density> Density of the fluid in kg/m^3, 999.1026 by default.
+  /// <water_level> Height of the calm water surface, 0 by default.
+  /// <wave> Sinusoidal waves added to the surface, for example:
+  /// <wave>
+  ///   <amplitude>0.5</amplitude>
+  ///   <wavelength>20</wavelength>
+  ///   <period>6</period>
+  ///   <direction>1 0</direction>
+  /// </wave>
+  /// <linear_drag> Drag force per unit of velocity and of submerged volume,
+  /// in N s/m^4, 0 by default.
+  /// <angular_drag> Drag torque per unit of angular velocity and of
+  /// submerged volume, in N m s/m^3, 0 by default.
+  /// <model> Models that float, by name. Every dynamic model floats when
+  /// none is given. The volume properties of their links can be given like
+  /// in BuoyancyPlugin, plus the height of the volume:
+  /// <model name="boat">
+  ///   <link name="hull">
+  ///     <center_of_volume>0 0 -0.2</center_of_volume>
+  ///     <volume>3</volume>
+  ///     <height>0.8</height>
+  ///   </link>
+  /// </model>
+  /// Otherwise they are computed from the collision shapes, and the height
+  /// is the height of the bounding box of the link.
+  class GZ_PLUGIN_VISIBLE BuoyancyWorldPlugin : public WorldPlugin
+  {
+    /// \brief Constructor.
+    public: BuoyancyWorldPlugin();
+
+    /// \brief Destructor.
+    public: virtual ~BuoyancyWorldPlugin();
+
+    // Documentation inherited
+    public: virtual void Load(physics::WorldPtr _world, sdf::ElementPtr _sdf);
+
+    /// \brief Get the height of the water surface.
+    /// \param[in] _x X coordinate in the world frame.
+    /// \param[in] _y Y coordinate in the world frame.
+    /// \param[in] _time Simulation time in seconds.
+    /// \return Height of the surface above the point.
+    public: double SurfaceHeight(const double _x, const double _y,
+                                 const double _time) const;
+
+    /// \brief Callback for World Update events.
+    private: void OnUpdate();
+
+    /// \brief Gather the links of the floating models, after models were
+    /// added or removed.
+    private: void UpdateLinks();
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<BuoyancyWorldPluginPrivate> dataPtr;
+  };
+}
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/transport/LockstepChannel.hh"
+#include "plugins/CosimPlugin.hh"
+
+/// \brief Private class for CosimPlugin
+class gazebo::CosimPluginPrivate
+{
+  /// \brief World pointer.
+  public: physics::WorldPtr world;
+
+  /// \brief Model whose joints are exchanged.
+  public: physics::ModelPtr model;
+
+  /// \brief Joints whose state is sent and which receive the efforts.
+  public: physics::Joint_V joints;
+
+  /// \brief Connection to World Update Begin events.
+  public: event::ConnectionPtr updateConnection;
+
+  /// \brief Channel shared with the controller.
+  public: transport::LockstepChannel channel;
+
+  /// \brief Wall time to wait for a command, in milliseconds.
+  public: unsigned int timeout = 1000;
+
+  /// \brief State sent each step, reused.
+  public: msgs::CosimState state;
+
+  /// \brief Command received each step, reused.
+  public: msgs::CosimCommand command;
+
+  /// \brief Serialized state or command, reused.
+  public: std::string data;
+
+  /// \brief Joint positions, reused.
+  public: std::vector<double> positions;
+
+  /// \brief Joint velocities, reused.
+  public: std::vector<double> velocities;
+
+  /// \brief Joint efforts, reused.
+  public: std::vector<double> efforts;
+
+  /// \brief True once a timeout of the current controller was reported.
+  public: bool timeoutReported = false;
+};
+
+using namespace gazebo;
+
+GZ_REGISTER_WORLD_PLUGIN(CosimPlugin)
+
+/// \brief Size of the buffers of the channel per joint axis, large enough
+/// for a position, a velocity and an effort with their tags.
+static const size_t BYTES_PER_AXIS = 32;
+
+/// \brief Size of the buffers of the channel besides the joint values.
+static const size_t BYTES_BASE = 256;
+
+/////////////////////////////////////////////////
+CosimPlugin::CosimPlugin()
+  : dataPtr(new CosimPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+CosimPlugin::~CosimPlugin()
+{
+  this->dataPtr->updateConnection.reset();
+  this->dataPtr->channel.Close();
+}
+
+/////////////////////////////////////////////////
+void CosimPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
+{
+  GZ_ASSERT(_world, "CosimPlugin world pointer is NULL");
+  GZ_ASSERT(_sdf, "CosimPlugin sdf pointer is NULL");
+  this->dataPtr->world = _world;
+
+  if (!_sdf->HasElement("model"))
+  {
+    gzerr << "CosimPlugin: missing <model>" << std::endl;
+    return;
+  }
+
+  const std::string modelName = _sdf->Get<std::string>("model");
+  this->dataPtr->model = _world->ModelByName(modelName);
+  if (!this->dataPtr->model)
+  {
+    gzerr << "CosimPlugin: unable to find model [" << modelName << "]"
+          << std::endl;
+    return;
+  }
+
+  sdf::ElementPtr jointElem;
+  if (_sdf->HasElement("joint"))
+    jointElem = _sdf->GetElement("joint");
+  for (; jointElem; jointElem = jointElem->GetNextElement("joint"))
+  {
+    const std::string jointName = jointElem->Get<std::string>();
+    physics::JointPtr joint = this->dataPtr->model->GetJoint(jointName);
+    if (!joint)
+    {
+      gzerr << "CosimPlugin: unable to find joint [" << jointName
+            << "] in model [" << modelName << "]" << std::endl;
+      return;
+    }
+    this->dataPtr->joints.push_back(joint);
+  }
+  if (this->dataPtr->joints.empty())
+    this->dataPtr->joints = this->dataPtr->model->GetJoints();
+
+  if (_sdf->HasElement("timeout"))
+    this->dataPtr->timeout = _sdf->Get<unsigned int>("timeout");
+
+  std::string segment = "gazebo_cosim_" + _world->Name();
+  if (_sdf->HasElement("segment"))
+    segment = _sdf->Get<std::string>("segment");
+
+  size_t axes = 0;
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    this->dataPtr->state.add_joint(joint->GetName());
+    axes += joint->DOF();
+  }
+
+  size_t nameBytes = 0;
+  for (auto const &joint : this->dataPtr->joints)
+    nameBytes += joint->GetName().size() + 2;
+
+  if (!this->dataPtr->channel.Create(segment,
+        BYTES_BASE + nameBytes + axes * BYTES_PER_AXIS,
+        BYTES_BASE + axes * BYTES_PER_AXIS))
+  {
+    return;
+  }
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&CosimPlugin::OnUpdate, this));
+
+  gzmsg << "CosimPlugin: waiting for controllers on [" << segment << "]"
+        << std::endl;
+}
+
+/////////////////////////////////////////////////
+std::string CosimPlugin::SegmentName() const
+{
+  return this->dataPtr->channel.Name();
+}
+
+/////////////////////////////////////////////////
+void CosimPlugin::OnUpdate()
+{
+  // Run freely without a controller
+  if (!this->dataPtr->channel.HasClient())
+  {
+    this->dataPtr->timeoutReported = false;
+    return;
+  }
+
+  this->dataPtr->model->JointStates(this->dataPtr->joints,
+      &this->dataPtr->positions, &this->dataPtr->velocities);
+
+  // Steps start at 1, the channel reserves 0 for no state
+  const uint64_t step = this->dataPtr->world->Iterations() + 1;
+
+  msgs::CosimState &state = this->dataPtr->state;
+  state.set_iteration(this->dataPtr->world->Iterations());
+  msgs::Set(state.mutable_sim_time(), this->dataPtr->world->SimTime());
+  state.clear_position();
+  state.clear_velocity();
+  for (auto const position : this->dataPtr->positions)
+    state.add_position(position);
+  for (auto const velocity : this->dataPtr->velocities)
+    state.add_velocity(velocity);
+
+  state.SerializeToString(&this->dataPtr->data);
+  if (!this->dataPtr->channel.WriteState(this->dataPtr->data, step))
+  {
+    gzerr << "CosimPlugin: unable to write the state" << std::endl;
+    return;
+  }
+
+  if (!this->dataPtr->channel.WaitForCommand(this->dataPtr->data, step,
+        this->dataPtr->timeout))
+  {
+    if (!this->dataPtr->timeoutReported)
+    {
+      gzwarn << "CosimPlugin: no command at iteration ["
+             << state.iteration() << "], stepping without it" << std::endl;
+      this->dataPtr->timeoutReported = true;
+    }
+    return;
+  }
+
+  msgs::CosimCommand &command = this->dataPtr->command;
+  if (!command.ParseFromString(this->dataPtr->data))
+  {
+    gzerr << "CosimPlugin: unable to parse the command" << std::endl;
+    return;
+  }
+
+  this->dataPtr->efforts.assign(command.effort().begin(),
+      command.effort().end());
+  if (!this->dataPtr->model->SetJointForces(this->dataPtr->joints,
+        this->dataPtr->efforts))
+  {
+    gzerr << "CosimPlugin: expected [" << this->dataPtr->positions.size()
+          << "] efforts, got [" << command.effort_size() << "]"
+          << std::endl;
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_COSIMPLUGIN_HH_
+#define GAZEBO_PLUGINS_COSIMPLUGIN_HH_
+
+#include <memory>
+#include <string>
+
+#include <sdf/sdf.hh>
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  // Forward declaration
+  class CosimPluginPrivate;
+
+  /// \brief World plugin that steps the world in lockstep with an external
+  /// controller on the same host, through a transport::LockstepChannel
+  /// instead of ~/world_stats and ~/world_control.
+  ///
+  /// Before each step, the plugin writes a msgs::CosimState with the
+  /// joint positions and velocities of a model, and waits for the
+  /// msgs::CosimCommand of the controller, whose efforts are applied to the
+  /// joints during the step. The world runs freely while no controller is
+  /// connected, and steps anyway if the controller misses the timeout.
+  ///
+  /// A controller opens the channel by name, then loops:
+  /// \verbatim
+  ///   transport::LockstepChannel channel;
+  ///   channel.Open("gazebo_cosim_default");
+  ///   while (channel.WaitForState(data, step, 1000))
+  ///   {
+  ///     state.ParseFromString(data);
+  ///     // Compute one effort per position
+  ///     command.SerializeToString(&data);
+  ///     channel.WriteCommand(data);
+  ///   }
+  /// \endverbatim
+  ///
+  /// Example:
+  /// \verbatim
+  ///   <plugin name="cosim" filename="libCosimPlugin.so">
+  ///     <!-- Model whose joints are exchanged -->
+  ///     <model>robot</model>
+  ///     <!-- Joints, in order. All the joints of the model if none -->
+  ///     <joint>shoulder</joint>
+  ///     <joint>elbow</joint>
+  ///     <!-- Name of the shared memory segment, gazebo_cosim_ followed
+  ///          by the world name by default -->
+  ///     <segment>robot_cosim</segment>
+  ///     <!-- Wall time to wait for a command, in milliseconds -->
+  ///     <timeout>1000</timeout>
+  ///   </plugin>
+  /// \endverbatim
+  class GZ_PLUGIN_VISIBLE CosimPlugin : public WorldPlugin
+  {
+    /// \brief Constructor.
+    public: CosimPlugin();
+
+    /// \brief Destructor.
+    public: virtual ~CosimPlugin();
+
+    // Documentation inherited
+    public: virtual void Load(physics::WorldPtr _world, sdf::ElementPtr _sdf);
+
+    /// \brief Get the name of the shared memory segment.
+    /// \return The name, empty if the plugin failed to load.
+    public: std::string SegmentName() const;
+
+    /// \brief Callback for World Update Begin events.
+    private: void OnUpdate();
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<CosimPluginPrivate> dataPtr;
+  };
+}
+#endif
@@ -646,8 +646,13 @@ void FlashLightPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
   // listen to the update event by the World
   if (!this->dataPtr->listFlashLight.empty())
   {
-    this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-      std::bind(&FlashLightPlugin::OnUpdate, this));
+    double rate = 0.0;
+    if (_sdf->HasElement("update_rate"))
+      rate = _sdf->Get<double>("update_rate");
+    this->dataPtr->updateConnection =
+      this->dataPtr->world->Scheduler().Connect(
+        std::bind(&FlashLightPlugin::OnUpdate, this), rate,
+        this->dataPtr->model->GetName() + "::" + this->GetHandle());
   }
 }
 
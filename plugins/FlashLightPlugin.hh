@@ -177,6 +177,10 @@ namespace gazebo
   /// <color> is optional. It specifies the color of light. If it is not given,
   /// the original color of the <light> element in the model will be used.
   ///
+  /// <update_rate> is optional. It is the rate in Hz at which the lights are
+  /// updated, on the world's update scheduler. The default value of 0
+  /// updates them on every iteration.
+  ///
   /// <block> is optional. It specifies a single phase. By adding multiple
   /// <block> elements, the light can generate a specific sequence of light
   /// patterns with different colors. It must have <duration> and <interval>.
@@ -19,7 +19,7 @@
 #include <mutex>
 #include <string>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/AxisAlignedBox.hh>
 
 #include <sdf/sdf.hh>
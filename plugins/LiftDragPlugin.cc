@@ -17,9 +17,12 @@
 
 #include <algorithm>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <typeinfo>
+#include <vector>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/common/Assert.hh"
@@ -28,10 +31,45 @@
 #include "gazebo/transport/transport.hh"
 #include "plugins/LiftDragPlugin.hh"
 
+namespace gazebo
+{
+  /// \brief The lift drag plugins updated from the shared World Update
+  /// callback, and the state of their links read at each update.
+  class LiftDragSurfaces
+  {
+    /// \brief Protects the plugins.
+    public: std::mutex mutex;
+
+    /// \brief Connection to World Update events.
+    public: event::ConnectionPtr updateConnection;
+
+    /// \brief Registered plugins.
+    public: std::vector<LiftDragPlugin *> plugins;
+
+    /// \brief Pose of the link of every plugin.
+    public: std::vector<ignition::math::Pose3d> poses;
+
+    /// \brief Velocity of the center of pressure of every plugin.
+    public: std::vector<ignition::math::Vector3d> velocities;
+
+    /// \brief Force computed for every plugin.
+    public: std::vector<ignition::math::Vector3d> forces;
+
+    /// \brief Torque computed for every plugin.
+    public: std::vector<ignition::math::Vector3d> torques;
+
+    /// \brief Whether each plugin generates a force this update.
+    public: std::vector<char> active;
+  };
+}
+
 using namespace gazebo;
 
 GZ_REGISTER_MODEL_PLUGIN(LiftDragPlugin)
 
+/// \brief Lift drag plugins of every world.
+static LiftDragSurfaces g_liftDragSurfaces;
+
 /////////////////////////////////////////////////
 LiftDragPlugin::LiftDragPlugin() : cla(1.0), cda(0.01), cma(0.01), rho(1.2041)
 {
@@ -61,6 +99,15 @@ LiftDragPlugin::LiftDragPlugin() : cla(1.0), cda(0.01), cma(0.01), rho(1.2041)
 /////////////////////////////////////////////////
 LiftDragPlugin::~LiftDragPlugin()
 {
+  std::lock_guard<std::mutex> lock(g_liftDragSurfaces.mutex);
+  auto &plugins = g_liftDragSurfaces.plugins;
+  auto iter = std::find(plugins.begin(), plugins.end(), this);
+  if (iter != plugins.end())
+  {
+    plugins.erase(iter);
+    if (plugins.empty())
+      g_liftDragSurfaces.updateConnection.reset();
+  }
 }
 
 /////////////////////////////////////////////////
@@ -141,8 +188,14 @@ void LiftDragPlugin::Load(physics::ModelPtr _model,
     }
     else
     {
-      this->updateConnection = event::Events::ConnectWorldUpdateBegin(
-          std::bind(&LiftDragPlugin::OnUpdate, this));
+      std::lock_guard<std::mutex> lock(g_liftDragSurfaces.mutex);
+      if (g_liftDragSurfaces.plugins.empty())
+      {
+        g_liftDragSurfaces.updateConnection =
+          event::Events::ConnectWorldUpdateBegin(
+              std::bind(&LiftDragPlugin::UpdateSurfaces));
+      }
+      g_liftDragSurfaces.plugins.push_back(this);
     }
   }
 
@@ -160,12 +213,92 @@ void LiftDragPlugin::Load(physics::ModelPtr _model,
     this->controlJointRadToCL = _sdf->Get<double>("control_joint_rad_to_cl");
 }
 
+/////////////////////////////////////////////////
+void LiftDragPlugin::UpdateSurfaces()
+{
+  IGN_PROFILE("LiftDragPlugin::UpdateSurfaces");
+  std::lock_guard<std::mutex> lock(g_liftDragSurfaces.mutex);
+  LiftDragSurfaces &surfaces = g_liftDragSurfaces;
+  const size_t count = surfaces.plugins.size();
+  surfaces.poses.resize(count);
+  surfaces.velocities.resize(count);
+  surfaces.forces.resize(count);
+  surfaces.torques.resize(count);
+  surfaces.active.assign(count, 0);
+
+  // Subclasses may override OnUpdate, so they are updated through it
+  for (size_t i = 0; i < count; ++i)
+  {
+    surfaces.active[i] =
+      typeid(*surfaces.plugins[i]) == typeid(LiftDragPlugin);
+  }
+
+  // Read the state of the links
+  IGN_PROFILE_BEGIN("Read");
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!surfaces.active[i])
+      continue;
+    LiftDragPlugin *plugin = surfaces.plugins[i];
+    surfaces.poses[i] = plugin->link->WorldPose();
+    surfaces.velocities[i] = plugin->link->WorldLinearVel(plugin->cp);
+  }
+  IGN_PROFILE_END();
+
+  IGN_PROFILE_BEGIN("Compute");
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!surfaces.active[i])
+      continue;
+    surfaces.active[i] = surfaces.plugins[i]->SurfaceForce(surfaces.poses[i],
+        surfaces.velocities[i], surfaces.forces[i], surfaces.torques[i]);
+  }
+  IGN_PROFILE_END();
+
+  IGN_PROFILE_BEGIN("Apply");
+  for (size_t i = 0; i < count; ++i)
+  {
+    LiftDragPlugin *plugin = surfaces.plugins[i];
+    if (typeid(*plugin) != typeid(LiftDragPlugin))
+    {
+      plugin->OnUpdate();
+    }
+    else if (surfaces.active[i])
+    {
+      // apply forces at cg (with torques for position shift)
+      plugin->link->AddForceAtRelativePosition(surfaces.forces[i],
+          plugin->cp);
+      plugin->link->AddTorque(surfaces.torques[i]);
+    }
+  }
+  IGN_PROFILE_END();
+}
+
 /////////////////////////////////////////////////
 void LiftDragPlugin::OnUpdate()
 {
   GZ_ASSERT(this->link, "Link was NULL");
-  // get linear velocity at cp in inertial frame
-  ignition::math::Vector3d vel = this->link->WorldLinearVel(this->cp);
+
+  ignition::math::Vector3d force;
+  ignition::math::Vector3d torque;
+  if (!this->SurfaceForce(this->link->WorldPose(),
+        this->link->WorldLinearVel(this->cp), force, torque))
+  {
+    return;
+  }
+
+  // apply forces at cg (with torques for position shift)
+  this->link->AddForceAtRelativePosition(force, this->cp);
+  this->link->AddTorque(torque);
+}
+
+/////////////////////////////////////////////////
+bool LiftDragPlugin::SurfaceForce(const ignition::math::Pose3d &_pose,
+    const ignition::math::Vector3d &_vel, ignition::math::Vector3d &_force,
+    ignition::math::Vector3d &_torque)
+{
+  // linear velocity at cp in inertial frame
+  const ignition::math::Vector3d &vel = _vel;
   ignition::math::Vector3d velI = vel;
   velI.Normalize();
 
@@ -175,13 +308,10 @@ void LiftDragPlugin::OnUpdate()
   // vel = this->velSmooth;
 
   if (vel.Length() <= 0.01)
-    return;
-
-  IGN_PROFILE("LiftDragPlugin::OnUpdate");
-  IGN_PROFILE_BEGIN(std::string(this->link->GetName()).c_str());
+    return false;
 
   // pose of body
-  ignition::math::Pose3d pose = this->link->WorldPose();
+  const ignition::math::Pose3d &pose = _pose;
 
   // rotate forward and upward vectors into inertial frame
   ignition::math::Vector3d forwardI = pose.Rot().RotateVector(this->forward);
@@ -397,8 +527,7 @@ void LiftDragPlugin::OnUpdate()
   this->cp.Correct();
   torque.Correct();
 
-  // apply forces at cg (with torques for position shift)
-  this->link->AddForceAtRelativePosition(force, this->cp);
-  this->link->AddTorque(torque);
-  IGN_PROFILE_END();
+  _force = force;
+  _torque = torque;
+  return true;
 }
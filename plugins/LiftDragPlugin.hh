@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/common/Plugin.hh"
@@ -43,6 +44,25 @@ namespace gazebo
     /// \brief Callback for World Update events.
     protected: virtual void OnUpdate();
 
+    /// \brief Compute the aerodynamic force and torque on the link.
+    /// \param[in] _pose Pose of the link in the world.
+    /// \param[in] _vel Linear velocity of the center of pressure in the
+    /// world frame.
+    /// \param[out] _force Force to apply at the center of pressure, in the
+    /// world frame.
+    /// \param[out] _torque Torque to apply, in the world frame.
+    /// \return False if the inflow is too slow to generate forces.
+    protected: bool SurfaceForce(const ignition::math::Pose3d &_pose,
+                   const ignition::math::Vector3d &_vel,
+                   ignition::math::Vector3d &_force,
+                   ignition::math::Vector3d &_torque);
+
+    /// \brief Update every lift drag plugin from a single World Update
+    /// callback. The state of all the links is read first, then the forces
+    /// are computed and applied. Subclasses are updated through OnUpdate, which
+    /// they may override.
+    private: static void UpdateSurfaces();
+
     /// \brief Connection to World Update events.
     protected: event::ConnectionPtr updateConnection;
 
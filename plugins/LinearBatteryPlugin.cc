@@ -14,10 +14,11 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <string>
 #include <functional>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Time.hh"
@@ -85,6 +86,10 @@ void LinearBatteryPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
   if (_sdf->HasElement("smooth_current_tau"))
     this->tau = _sdf->Get<double>("smooth_current_tau");
 
+  double updateRate = 0.0;
+  if (_sdf->HasElement("update_rate"))
+    updateRate = _sdf->Get<double>("update_rate");
+
   if (_sdf->HasElement("battery_name"))
   {
     sdf::ElementPtr elem = _sdf->GetElement("battery_name");
@@ -100,6 +105,7 @@ void LinearBatteryPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
     }
     else
     {
+      this->battery->SetUpdateRate(updateRate);
       this->battery->SetUpdateFunc(
         std::bind(&LinearBatteryPlugin::OnUpdateVoltage, this,
           std::placeholders::_1));
@@ -115,6 +121,7 @@ void LinearBatteryPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
 void LinearBatteryPlugin::Init()
 {
   this->q = this->q0;
+  this->lastUpdateTime = this->world->SimTime();
 }
 
 /////////////////////////////////////////////////
@@ -130,17 +137,21 @@ double LinearBatteryPlugin::OnUpdateVoltage(const common::BatteryPtr &_battery)
 {
   IGN_PROFILE("LinearBatteryPlugin::OnUpdateVoltage");
   IGN_PROFILE_BEGIN("Update");
-  double dt = this->world->Physics()->GetMaxStepSize();
-  double totalpower = 0.0;
-  double k = dt / this->tau;
+  // Time since the last update, which is longer than a step if the update
+  // rate of the battery is lower than the physics rate
+  const common::Time simTime = this->world->SimTime();
+  double dt = (simTime - this->lastUpdateTime).Double();
+  if (simTime < this->lastUpdateTime)
+    dt = this->world->Physics()->GetMaxStepSize();
+  this->lastUpdateTime = simTime;
+
+  // The filter would overshoot with periods longer than its time constant
+  double k = std::min(1.0, dt / this->tau);
 
   if (fabs(_battery->Voltage()) < 1e-3)
     return 0.0;
 
-  for (auto powerLoad : _battery->PowerLoads())
-    totalpower += powerLoad.second;
-
-  this->iraw = totalpower / _battery->Voltage();
+  this->iraw = _battery->TotalPowerLoad() / _battery->Voltage();
 
   this->ismooth = this->ismooth + k * (this->iraw - this->ismooth);
 
@@ -27,6 +27,11 @@
 namespace gazebo
 {
   /// \brief A plugin that simulates a linear battery.
+  ///
+  /// The battery is updated by the battery registry of the world, every
+  /// iteration by default. Fleets that don't need the physics rate can
+  /// lower it with <update_rate>, in Hz of simulation time. The charge is
+  /// integrated over the simulation time elapsed between updates.
   class GZ_PLUGIN_VISIBLE LinearBatteryPlugin : public ModelPlugin
   {
     /// \brief Constructor.
@@ -92,6 +97,9 @@ namespace gazebo
 
     /// \brief Instantaneous battery charge in Ah.
     protected: double q;
+
+    /// \brief Simulation time of the last voltage update.
+    protected: common::Time lastUpdateTime;
   };
 }
 #endif
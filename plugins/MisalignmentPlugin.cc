@@ -17,7 +17,7 @@
 
 #include <string>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/common/Events.hh"
@@ -18,7 +18,7 @@
 #include <chrono>
 #include <functional>
 #include <thread>
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Pose3.hh>
 
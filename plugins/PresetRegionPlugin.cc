@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Box.hh>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PresetManager.hh"
+#include "gazebo/physics/World.hh"
+#include "plugins/PresetRegionPlugin.hh"
+
+/// \brief Private class for PresetRegionPlugin
+class gazebo::PresetRegionPluginPrivate
+{
+  /// \brief World pointer.
+  public: physics::WorldPtr world;
+
+  /// \brief Names of the models and the models, null until found.
+  public: std::vector<std::pair<std::string, physics::ModelPtr>> models;
+
+  /// \brief Regions and their profiles, in order.
+  public: std::vector<std::pair<ignition::math::Box, std::string>> regions;
+
+  /// \brief Profile outside of the regions, empty to keep the profile.
+  public: std::string defaultProfile;
+
+  /// \brief Profile requested last.
+  public: std::string requested;
+
+  /// \brief Connection to World Update Begin events.
+  public: event::ConnectionPtr updateConnection;
+};
+
+using namespace gazebo;
+
+GZ_REGISTER_WORLD_PLUGIN(PresetRegionPlugin)
+
+/////////////////////////////////////////////////
+PresetRegionPlugin::PresetRegionPlugin()
+  : dataPtr(new PresetRegionPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+PresetRegionPlugin::~PresetRegionPlugin()
+{
+  this->dataPtr->updateConnection.reset();
+}
+
+/////////////////////////////////////////////////
+void PresetRegionPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
+{
+  GZ_ASSERT(_world, "PresetRegionPlugin world pointer is NULL");
+  GZ_ASSERT(_sdf, "PresetRegionPlugin sdf pointer is NULL");
+  this->dataPtr->world = _world;
+
+  physics::PresetManagerPtr presetManager = _world->PresetMgr();
+  if (!presetManager)
+  {
+    gzerr << "PresetRegionPlugin: the world has no preset manager"
+          << std::endl;
+    return;
+  }
+
+  sdf::ElementPtr elem;
+  if (_sdf->HasElement("model"))
+    elem = _sdf->GetElement("model");
+  for (; elem; elem = elem->GetNextElement("model"))
+  {
+    this->dataPtr->models.push_back(
+        std::make_pair(elem->Get<std::string>(), physics::ModelPtr()));
+  }
+
+  if (_sdf->HasElement("default_profile"))
+  {
+    this->dataPtr->defaultProfile = _sdf->Get<std::string>("default_profile");
+    if (!presetManager->HasProfile(this->dataPtr->defaultProfile))
+    {
+      gzerr << "PresetRegionPlugin: unknown profile ["
+            << this->dataPtr->defaultProfile << "]" << std::endl;
+      this->dataPtr->defaultProfile.clear();
+    }
+  }
+
+  elem.reset();
+  if (_sdf->HasElement("region"))
+    elem = _sdf->GetElement("region");
+  for (; elem; elem = elem->GetNextElement("region"))
+  {
+    if (!elem->HasElement("profile") || !elem->HasElement("min") ||
+        !elem->HasElement("max"))
+    {
+      gzerr << "PresetRegionPlugin: a <region> needs a <profile>, a <min> "
+            << "and a <max>" << std::endl;
+      continue;
+    }
+
+    const std::string profile = elem->Get<std::string>("profile");
+    if (!presetManager->HasProfile(profile))
+    {
+      gzerr << "PresetRegionPlugin: unknown profile [" << profile << "]"
+            << std::endl;
+      continue;
+    }
+
+    this->dataPtr->regions.push_back(std::make_pair(ignition::math::Box(
+        elem->Get<ignition::math::Vector3d>("min"),
+        elem->Get<ignition::math::Vector3d>("max")), profile));
+  }
+
+  if (this->dataPtr->models.empty() || this->dataPtr->regions.empty())
+  {
+    gzerr << "PresetRegionPlugin: needs at least one <model> and one "
+          << "<region>" << std::endl;
+    return;
+  }
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&PresetRegionPlugin::OnUpdate, this));
+}
+
+/////////////////////////////////////////////////
+void PresetRegionPlugin::OnUpdate()
+{
+  std::string profile = this->dataPtr->defaultProfile;
+
+  bool found = false;
+  for (const auto &region : this->dataPtr->regions)
+  {
+    for (auto &model : this->dataPtr->models)
+    {
+      if (!model.second)
+        model.second = this->dataPtr->world->ModelByName(model.first);
+      if (model.second &&
+          region.first.Contains(model.second->WorldPose().Pos()))
+      {
+        profile = region.second;
+        found = true;
+        break;
+      }
+    }
+    if (found)
+      break;
+  }
+
+  if (profile.empty() || profile == this->dataPtr->requested)
+    return;
+
+  // Applied by the world once the World Update Begin event is over
+  if (this->dataPtr->world->PresetMgr()->RequestProfile(profile))
+    this->dataPtr->requested = profile;
+}
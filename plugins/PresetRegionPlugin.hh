@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_PRESETREGIONPLUGIN_HH_
+#define GAZEBO_PLUGINS_PRESETREGIONPLUGIN_HH_
+
+#include <memory>
+
+#include <sdf/sdf.hh>
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  // Forward declaration
+  class PresetRegionPluginPrivate;
+
+  /// \brief World plugin that switches the physics profile depending on
+  /// where some models are, for example a coarse profile while a robot
+  /// drives and a fine one while it manipulates objects in a work cell.
+  ///
+  /// At each World Update Begin event, the profile of the first region
+  /// that holds the origin of one of the models is requested with
+  /// physics::PresetManager::RequestProfile, or the default profile if no
+  /// region holds a model. The world applies it before the step.
+  ///
+  /// Example:
+  /// \verbatim
+  ///   <plugin name="preset_regions" filename="libPresetRegionPlugin.so">
+  ///     <!-- One or more models -->
+  ///     <model>robot</model>
+  ///     <!-- Profile outside of the regions, optional -->
+  ///     <default_profile>coarse</default_profile>
+  ///     <!-- One or more axis aligned boxes, checked in order -->
+  ///     <region>
+  ///       <profile>fine</profile>
+  ///       <min>-1 -1 0</min>
+  ///       <max>1 1 2</max>
+  ///     </region>
+  ///   </plugin>
+  /// \endverbatim
+  class GZ_PLUGIN_VISIBLE PresetRegionPlugin : public WorldPlugin
+  {
+    /// \brief Constructor.
+    public: PresetRegionPlugin();
+
+    /// \brief Destructor.
+    public: virtual ~PresetRegionPlugin();
+
+    // Documentation inherited
+    public: virtual void Load(physics::WorldPtr _world, sdf::ElementPtr _sdf);
+
+    /// \brief Callback for World Update Begin events.
+    private: void OnUpdate();
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<PresetRegionPluginPrivate> dataPtr;
+  };
+}
+#endif
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/Subscriber.hh"
+#include "plugins/RemoteRenderPlugin.hh"
+
+/// \brief Private class for RemoteRenderPlugin
+class gazebo::RemoteRenderPluginPrivate
+{
+  /// \brief World pointer.
+  public: physics::WorldPtr world;
+
+  /// \brief True on the render node.
+  public: bool render = false;
+
+  /// \brief Connection to World Update Begin events.
+  public: event::ConnectionPtr beginConnection;
+
+  /// \brief Connection to World Update End events.
+  public: event::ConnectionPtr endConnection;
+
+  /// \brief Transport node.
+  public: transport::NodePtr node;
+
+  /// \brief Publisher of ~/render/sync on the physics node, or of
+  /// ~/render/done on the render node.
+  public: transport::PublisherPtr pub;
+
+  /// \brief Subscriber to ~/render/done on the physics node, or to
+  /// ~/render/sync on the render node.
+  public: transport::SubscriberPtr sub;
+
+  /// \brief Wall time to wait for the render node, in seconds.
+  public: double timeout = 1;
+
+  /// \brief Time the next image of the render node is due, NaN if none.
+  public: double nextRequired = std::numeric_limits<double>::quiet_NaN();
+
+  /// \brief Latest time received from the physics node, NaN if none.
+  public: double pendingTime = std::numeric_limits<double>::quiet_NaN();
+
+  /// \brief True once a timeout of the render node was reported.
+  public: bool timeoutReported = false;
+
+  /// \brief Answer of the render node, reused.
+  public: msgs::RenderSync msg;
+
+  /// \brief Thread of the render node.
+  public: std::thread thread;
+
+  /// \brief True to stop the thread.
+  public: bool stop = false;
+
+  /// \brief Protects nextRequired, pendingTime and stop.
+  public: std::mutex mutex;
+
+  /// \brief Notified when nextRequired or pendingTime changes.
+  public: std::condition_variable condition;
+};
+
+using namespace gazebo;
+
+GZ_REGISTER_WORLD_PLUGIN(RemoteRenderPlugin)
+
+/////////////////////////////////////////////////
+RemoteRenderPlugin::RemoteRenderPlugin()
+  : dataPtr(new RemoteRenderPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+RemoteRenderPlugin::~RemoteRenderPlugin()
+{
+  this->dataPtr->beginConnection.reset();
+  this->dataPtr->endConnection.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->condition.notify_all();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+
+  this->dataPtr->sub.reset();
+  this->dataPtr->pub.reset();
+  if (this->dataPtr->node)
+    this->dataPtr->node->Fini();
+}
+
+/////////////////////////////////////////////////
+void RemoteRenderPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
+{
+  GZ_ASSERT(_world, "RemoteRenderPlugin world pointer is NULL");
+  GZ_ASSERT(_sdf, "RemoteRenderPlugin sdf pointer is NULL");
+  this->dataPtr->world = _world;
+
+  std::string role = "physics";
+  if (_sdf->HasElement("role"))
+    role = _sdf->Get<std::string>("role");
+
+  const char *roleEnv = std::getenv("GAZEBO_RENDER_ROLE");
+  if (roleEnv)
+    role = roleEnv;
+
+  if (role != "physics" && role != "render")
+  {
+    gzerr << "RemoteRenderPlugin: unknown role [" << role
+          << "], expected physics or render" << std::endl;
+    return;
+  }
+  this->dataPtr->render = role == "render";
+
+  if (_sdf->HasElement("timeout"))
+    this->dataPtr->timeout = std::max(0.0, _sdf->Get<double>("timeout"));
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(_world->Name());
+
+  if (this->dataPtr->render)
+  {
+    // Time only moves with the physics node, whose poses are mirrored
+    _world->SetPhysicsEnabled(false);
+    _world->SetPaused(true);
+
+    this->dataPtr->pub = this->dataPtr->node->Advertise<msgs::RenderSync>(
+        "~/render/done");
+    this->dataPtr->sub = this->dataPtr->node->Subscribe("~/render/sync",
+        &RemoteRenderPlugin::OnSync, this);
+    this->dataPtr->thread =
+        std::thread(std::bind(&RemoteRenderPlugin::RenderLoop, this));
+  }
+  else
+  {
+    this->dataPtr->pub = this->dataPtr->node->Advertise<msgs::RenderSync>(
+        "~/render/sync");
+    this->dataPtr->sub = this->dataPtr->node->Subscribe("~/render/done",
+        &RemoteRenderPlugin::OnDone, this);
+    this->dataPtr->beginConnection = event::Events::ConnectWorldUpdateBegin(
+        std::bind(&RemoteRenderPlugin::OnUpdateBegin, this));
+    this->dataPtr->endConnection = event::Events::ConnectWorldUpdateEnd(
+        std::bind(&RemoteRenderPlugin::OnUpdateEnd, this));
+  }
+
+  gzmsg << "RemoteRenderPlugin: " << role << " node of world ["
+        << _world->Name() << "]" << std::endl;
+}
+
+/////////////////////////////////////////////////
+bool RemoteRenderPlugin::IsRenderNode() const
+{
+  return this->dataPtr->render;
+}
+
+/////////////////////////////////////////////////
+void RemoteRenderPlugin::OnUpdateBegin()
+{
+  // The time was already advanced, wait for the images due at the time
+  // published by the last iteration
+  const double dt = this->dataPtr->world->Physics()->GetMaxStepSize();
+  const double clk = this->dataPtr->world->SimTime().Double() - dt;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  const bool ready = this->dataPtr->condition.wait_for(lock,
+      std::chrono::duration<double>(this->dataPtr->timeout), [&]
+      {
+        return std::isnan(this->dataPtr->nextRequired) ||
+            this->dataPtr->nextRequired - dt / 2.0 > clk;
+      });
+
+  if (ready)
+  {
+    this->dataPtr->timeoutReported = false;
+    return;
+  }
+
+  // Run freely until the render node answers again
+  this->dataPtr->nextRequired = std::numeric_limits<double>::quiet_NaN();
+  if (!this->dataPtr->timeoutReported)
+  {
+    gzwarn << "RemoteRenderPlugin: timed out waiting for the render node at "
+           << "time [" << clk << "], stepping without it" << std::endl;
+    this->dataPtr->timeoutReported = true;
+  }
+}
+
+/////////////////////////////////////////////////
+void RemoteRenderPlugin::OnUpdateEnd()
+{
+  msgs::RenderSync msg;
+  msg.set_sim_time(this->dataPtr->world->SimTime().Double());
+  this->dataPtr->pub->Publish(msg);
+}
+
+/////////////////////////////////////////////////
+void RemoteRenderPlugin::OnDone(ConstRenderSyncPtr &_msg)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->nextRequired = _msg->has_next_required() ?
+        _msg->next_required() : std::numeric_limits<double>::quiet_NaN();
+  }
+  this->dataPtr->condition.notify_all();
+}
+
+/////////////////////////////////////////////////
+void RemoteRenderPlugin::OnSync(ConstRenderSyncPtr &_msg)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->pendingTime = _msg->sim_time();
+  }
+  this->dataPtr->condition.notify_all();
+}
+
+/////////////////////////////////////////////////
+void RemoteRenderPlugin::RenderLoop()
+{
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+
+  while (true)
+  {
+    double clk;
+    {
+      std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+      this->dataPtr->condition.wait(lock, [this]
+          {
+            return this->dataPtr->stop ||
+                !std::isnan(this->dataPtr->pendingTime);
+          });
+      if (this->dataPtr->stop)
+        return;
+      clk = this->dataPtr->pendingTime;
+      this->dataPtr->pendingTime = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    this->dataPtr->world->SetSimTime(common::Time(clk));
+
+    // Wait until the sensors due at this time have rendered, as
+    // SensorManager::WaitForSensors does for a local world
+    const double dt = this->dataPtr->world->Physics()->GetMaxStepSize();
+    const auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration<double>(this->dataPtr->timeout);
+    double tnext = mgr->NextRequiredTimestamp();
+    while (!std::isnan(tnext) && tnext - dt / 2.0 <= clk &&
+        std::chrono::steady_clock::now() < deadline)
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+        if (this->dataPtr->stop)
+          return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      tnext = mgr->NextRequiredTimestamp();
+    }
+
+    this->dataPtr->msg.set_sim_time(clk);
+    if (std::isnan(tnext))
+      this->dataPtr->msg.clear_next_required();
+    else
+      this->dataPtr->msg.set_next_required(tnext);
+    this->dataPtr->pub->Publish(this->dataPtr->msg);
+  }
+}
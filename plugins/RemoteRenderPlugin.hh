@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_REMOTERENDERPLUGIN_HH_
+#define GAZEBO_PLUGINS_REMOTERENDERPLUGIN_HH_
+
+#include <memory>
+
+#include <sdf/sdf.hh>
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  // Forward declaration
+  class RemoteRenderPluginPrivate;
+
+  /// \brief World plugin that renders the image sensors of a world on
+  /// another gzserver, the render node, so that the physics node needs no
+  /// GPU.
+  ///
+  /// Both nodes load the same world, with the same name, and connect to the
+  /// same master, so they share their topics. The camera, depth and GpuRay
+  /// sensors should only be in the world of the render node, which mirrors
+  /// the poses published by the physics node on ~/pose/local/info and
+  /// publishes the images on the usual sensor topics.
+  ///
+  /// After each iteration, the physics node publishes its simulation time on
+  /// ~/render/sync. The render node, which doesn't simulate physics, moves
+  /// its clock to that time and answers on ~/render/done once its image
+  /// sensors have rendered, with the time their next images are due. Before
+  /// an iteration reaching that time, the physics node waits for the next
+  /// answer, like SensorManager waits for local image sensors. The physics
+  /// node runs freely until a render node answers, and steps anyway if the
+  /// render node misses the timeout.
+  ///
+  /// Example:
+  /// \verbatim
+  ///   <plugin name="remote_render" filename="libRemoteRenderPlugin.so">
+  ///     <!-- physics or render, overridden by the GAZEBO_RENDER_ROLE
+  ///          environment variable so that both nodes can load the same
+  ///          world file -->
+  ///     <role>physics</role>
+  ///     <!-- Wall time to wait for the render node, in seconds -->
+  ///     <timeout>1</timeout>
+  ///   </plugin>
+  /// \endverbatim
+  class GZ_PLUGIN_VISIBLE RemoteRenderPlugin : public WorldPlugin
+  {
+    /// \brief Constructor.
+    public: RemoteRenderPlugin();
+
+    /// \brief Destructor.
+    public: virtual ~RemoteRenderPlugin();
+
+    // Documentation inherited
+    public: virtual void Load(physics::WorldPtr _world, sdf::ElementPtr _sdf);
+
+    /// \brief Get whether this plugin runs on the render node.
+    /// \return True on the render node, false on the physics node.
+    public: bool IsRenderNode() const;
+
+    /// \brief Callback for World Update Begin events on the physics node.
+    /// Waits for the render node if an image is due.
+    private: void OnUpdateBegin();
+
+    /// \brief Callback for World Update End events on the physics node.
+    /// Publishes the simulation time.
+    private: void OnUpdateEnd();
+
+    /// \brief Callback for the answers of the render node, on the physics
+    /// node.
+    /// \param[in] _msg The message.
+    private: void OnDone(ConstRenderSyncPtr &_msg);
+
+    /// \brief Callback for the simulation time of the physics node, on the
+    /// render node.
+    /// \param[in] _msg The message.
+    private: void OnSync(ConstRenderSyncPtr &_msg);
+
+    /// \brief Thread of the render node that answers once the image sensors
+    /// have rendered.
+    private: void RenderLoop();
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<RemoteRenderPluginPrivate> dataPtr;
+  };
+}
+#endif
@@ -46,6 +46,10 @@ void RubblePlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
   double maxMass = _sdf->Get<double>("max_mass");
   unsigned int count = _sdf->Get<unsigned int>("count");
 
+  // All the rubble is inserted in a single batch
+  std::ostringstream modelsStr;
+  modelsStr << "<sdf version='" << SDF_VERSION << "'>";
+
   for (unsigned int i = 0; i < count; ++i)
   {
     int rubbleType = ignition::math::Rand::IntUniform(0, 1);
@@ -105,9 +109,9 @@ void RubblePlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
     name << "rubble_" << i;
 
     if (rubbleType == 0)
-      this->MakeBox(name.str(), obj.pose, obj.size, mass);
+      this->MakeBox(name.str(), obj.pose, obj.size, mass, modelsStr);
     else if (rubbleType == 1)
-      this->MakeCinderBlock(name.str(), obj.pose, obj.size, mass);
+      this->MakeCinderBlock(name.str(), obj.pose, obj.size, mass, modelsStr);
     /*else
       this->MakeCylinder(name.str(), obj.pos, obj.size, mass);
       */
@@ -178,6 +182,10 @@ void RubblePlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
     name << "rubble_" << i;
     this->MakeCompound(name.str(), *iter);
   }*/
+
+  modelsStr << "</sdf>";
+  if (count > 0)
+    this->world->InsertModelInstances(modelsStr.str());
 }
 
 /////////////////////////////////////////////////
@@ -189,16 +197,14 @@ void RubblePlugin::Init()
 void RubblePlugin::MakeCinderBlock(const std::string &_name,
                                    ignition::math::Pose3d &_pose,
                                    ignition::math::Vector3d &_size,
-                                   const double _mass)
+                                   const double _mass,
+                                   std::ostringstream &_sdf)
 {
-  std::ostringstream newModelStr;
-
   float sx = _size.X();
   float sy = _size.Y();
   float sz = _size.Z();
 
-  newModelStr << "<sdf version='" << SDF_VERSION << "'>"
-    "<model name='" << _name << "'>"
+  _sdf << "<model name='" << _name << "'>"
     "<pose>" << _pose << "</pose>"
     "<link name='link'>"
       "<velocity_decay>"
@@ -226,26 +232,21 @@ void RubblePlugin::MakeCinderBlock(const std::string &_name,
         "</geometry>"
       "</visual>"
     "</link>"
-  "</model>"
-  "</sdf>";
-
-  this->world->InsertModelString(newModelStr.str());
+  "</model>";
 }
 
 /////////////////////////////////////////////////
 void RubblePlugin::MakeBox(const std::string &_name,
                            ignition::math::Pose3d &_pose,
                            ignition::math::Vector3d &_size,
-                           const double _mass)
+                           const double _mass,
+                           std::ostringstream &_sdf)
 {
-  std::ostringstream newModelStr;
-
   float sx = _size.X();
   float sy = _size.Y();
   float sz = _size.Z();
 
-  newModelStr << "<sdf version='" << SDF_VERSION << "'>"
-    "<model name='" << _name << "'>"
+  _sdf << "<model name='" << _name << "'>"
     "<allow_auto_disable>true</allow_auto_disable>"
     "<pose>" << _pose << "</pose>"
     "<link name='link'>"
@@ -274,10 +275,7 @@ void RubblePlugin::MakeBox(const std::string &_name,
         "</geometry>"
       "</visual>"
     "</link>"
-  "</model>"
-  "</sdf>";
-
-  this->world->InsertModelString(newModelStr.str());
+  "</model>";
 }
 
 /////////////////////////////////////////////////
@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PLUGINS_RUBBLEPLUGIN_HH_
 #define GAZEBO_PLUGINS_RUBBLEPLUGIN_HH_
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -41,15 +42,29 @@ namespace gazebo
     /// \brief Initialize the plugin.
     public: virtual void Init();
 
+    /// \brief Append the SDF of a 2x4 model.
+    /// \param[in] _name Model name.
+    /// \param[in] _pose Model pose.
+    /// \param[in] _size Box size.
+    /// \param[in] _mass Model mass.
+    /// \param[out] _sdf Stream the <model> element is written to.
     private: void MakeBox(const std::string &_name,
                           ignition::math::Pose3d &_pose,
                           ignition::math::Vector3d &_size,
-                          const double _mass);
+                          const double _mass,
+                          std::ostringstream &_sdf);
 
+    /// \brief Append the SDF of a cinder block model.
+    /// \param[in] _name Model name.
+    /// \param[in] _pose Model pose.
+    /// \param[in] _size Block size.
+    /// \param[in] _mass Model mass.
+    /// \param[out] _sdf Stream the <model> element is written to.
     private: void MakeCinderBlock(const std::string &_name,
                                   ignition::math::Pose3d &_pose,
                                   ignition::math::Vector3d &_size,
-                                  const double _mass);
+                                  const double _mass,
+                                  std::ostringstream &_sdf);
 
     // private: void MakeCylinder(const std::string &_name,
     //    ignition::math::Vector3d &_pos,
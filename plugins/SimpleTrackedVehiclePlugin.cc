@@ -18,7 +18,7 @@
 #include <functional>
 #include <vector>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Pose3.hh>
 
@@ -54,6 +54,12 @@ GZ_REGISTER_MODEL_PLUGIN(SimpleTrackedVehiclePlugin)
 
 SimpleTrackedVehiclePlugin::~SimpleTrackedVehiclePlugin()
 {
+  if (this->physicsEngine != nullptr)
+  {
+    for (auto const &trackCollision : this->trackCollisions)
+      this->physicsEngine->SetContactCallback(trackCollision.first, nullptr);
+  }
+
   if (this->body != nullptr)
   {
     if (globalTracks.find(this->body) != globalTracks.end())
@@ -199,11 +205,6 @@ void SimpleTrackedVehiclePlugin::Init()
 
   physics::ModelPtr model = this->body->GetModel();
 
-  this->contactManager = model->GetWorld()->Physics()->GetContactManager();
-  // otherwise contact manager would not publish any contacts (since we are not
-  // a real contact subscriber)
-  this->contactManager->SetNeverDropContacts(true);
-
   // set correct categories and collide bitmasks
   this->SetGeomCategories();
 
@@ -211,14 +212,28 @@ void SimpleTrackedVehiclePlugin::Init()
   // SDF model)
   this->UpdateTrackSurface();
 
-  // initialize Gazebo node, subscribers and publishers and event connections
+  // initialize Gazebo node, subscribers and publishers
   this->node = transport::NodePtr(new transport::Node());
   this->node->Init(model->GetWorld()->Name());
 
-  this->beforePhysicsUpdateConnection =
-      event::Events::ConnectBeforePhysicsUpdate(
-          std::bind(&SimpleTrackedVehiclePlugin::DriveTracks, this,
-                    std::placeholders::_1));
+  // Drive the tracks from the contact points of their collisions, so that
+  // contacts don't need to be reported for the whole world.
+  this->physicsEngine = model->GetWorld()->Physics();
+  auto& gtracks = globalTracks.at(this->body);
+  for (auto trackSide : gtracks)
+  {
+    for (auto trackLink : trackSide.second)
+    {
+      for (auto const &collision : trackLink->GetCollisions())
+      {
+        this->trackCollisions[collision.get()] = trackSide.first;
+        this->physicsEngine->SetContactCallback(collision.get(),
+            std::bind(&SimpleTrackedVehiclePlugin::DriveTracks, this,
+              std::placeholders::_1, std::placeholders::_2,
+              std::placeholders::_3, std::placeholders::_4));
+      }
+    }
+  }
 }
 
 void SimpleTrackedVehiclePlugin::Reset()
@@ -296,13 +311,22 @@ size_t SimpleTrackedVehiclePlugin::GetNumTracks(const Tracks side) const
 }
 
 void SimpleTrackedVehiclePlugin::DriveTracks(
-    const common::UpdateInfo &/*_unused*/)
+    physics::Collision *_collision1, physics::Collision *_collision2,
+    physics::ContactPoint *_points, const unsigned int _count)
 {
-  if (this->contactManager->GetContactCount() == 0)
+  IGN_PROFILE("SimpleTrackedVehiclePlugin::DriveTracks");
+
+  if (!_collision1->GetLink()->GetEnabled() ||
+    !_collision2->GetLink()->GetEnabled())
     return;
 
-  IGN_PROFILE("SimpleTrackedVehiclePlugin::DriveTracks");
-  IGN_PROFILE_BEGIN("Update");
+  // determine if track is the first or second collision element
+  auto track = this->trackCollisions.find(_collision1);
+  if (track == this->trackCollisions.end())
+    track = this->trackCollisions.find(_collision2);
+  if (track == this->trackCollisions.end())
+    return;
+  const physics::Collision *trackCollision = track->first;
 
   /////////////////////////////////////////////
   // Calculate the desired center of rotation
@@ -334,153 +358,55 @@ void SimpleTrackedVehiclePlugin::DriveTracks(
   const auto centerOfRotation =
     (bodyYAxisGlobal * desiredRotationRadiusSigned) + bodyPose.Pos();
 
+  // speed of the track in collision
+  const dReal beltSpeed = track->second == Tracks::LEFT ?
+    leftBeltSpeed : rightBeltSpeed;
+  const auto trackPos = trackCollision->WorldPose().Pos();
+
   ////////////////////////////////////////////////////////////////////////
-  // For each contact, compute the friction force direction and speed of
-  // surface movement.
+  // For each contact point, compute the friction force direction and speed
+  // of surface movement.
   ////////////////////////////////////////////////////////////////////////
-  size_t i = 0;
-  const auto contacts = this->contactManager->GetContacts();
-  const auto model = this->body->GetModel();
-
-  for (auto contact : contacts)
+  for (unsigned int i = 0; i < _count; ++i)
   {
-    // Beware! There may be invalid contacts beyond GetContactCount()...
-    if (i == this->contactManager->GetContactCount())
-      break;
-
-    ++i;
-
-    if (contact->collision1->GetSurface()->collideWithoutContact ||
-      contact->collision2->GetSurface()->collideWithoutContact)
-      continue;
-
-    if (!contact->collision1->GetLink()->GetEnabled() ||
-      !contact->collision2->GetLink()->GetEnabled())
-      continue;
-
-    if (contact->collision1->IsStatic() && contact->collision2->IsStatic())
-    {
-      // we're not interested in static model collisions
-      // (they do not have any ODE bodies).
-      continue;
-    }
-
-    if (model != contact->collision1->GetLink()->GetModel() &&
-        model != contact->collision2->GetLink()->GetModel())
-    {
-      // Verify one of the collisions' bodies is a track of this vehicle
-      continue;
-    }
-
-    dBodyID body1 = dynamic_cast<physics::ODELink&>(
-      *contact->collision1->GetLink()).GetODEId();
-    dBodyID body2 = dynamic_cast<physics::ODELink& >(
-      *contact->collision2->GetLink()).GetODEId();
-
-    dGeomID geom1 = dynamic_cast<physics::ODECollision& >(
-      *contact->collision1).GetCollisionId();
-    dGeomID geom2 = dynamic_cast<physics::ODECollision& >(
-      *contact->collision2).GetCollisionId();
-
-    bool bodiesSwapped = false;
-    if (body1 == 0)
+    physics::ContactPoint &point = _points[i];
+    const ignition::math::Vector3d &contactWorldPosition = point.position;
+    ignition::math::Vector3d contactNormal = point.normal;
+
+    // We always want contactNormal to point "inside" the track.
+    // The dot product is 1 for co-directional vectors and -1 for
+    // opposite-pointing vectors.
+    // The contact can be flipped either by the order of the collisions,
+    // or by having some flipped faces on collision meshes.
+    const double normalToTrackCenterDot =
+      contactNormal.Dot(trackPos - contactWorldPosition);
+    if (normalToTrackCenterDot < 0)
     {
-      std::swap(body1, body2);
-      std::swap(geom1, geom2);
-
-      // we'll take care of the normal flipping later
-      bodiesSwapped = true;
+      contactNormal = -contactNormal;
     }
 
-    // determine if track is the first or second collision element
-    const bool isGeom1Track = (dGeomGetCategoryBits(geom1) & BELT_CATEGORY) > 0;
-    const bool isGeom2Track = (dGeomGetCategoryBits(geom2) & BELT_CATEGORY) > 0;
-
-    if (!isGeom1Track && !isGeom2Track)
-      continue;
-
-    // speed and geometry of the track in collision
-    const auto trackGeom = (isGeom1Track ? geom1 : geom2);
-    // the != means XOR here; we basically want to get the collision belonging
-    // to the track, but we might have swapped the ODE bodies in between,
-    // so we have to account for it
-    const physics::Collision* trackCollision =
-      ((isGeom1Track != bodiesSwapped) ? contact->collision1
-                                       : contact->collision2);
-    const dReal beltSpeed =
-      (dGeomGetCategoryBits(trackGeom) & LEFT_CATEGORY) != 0 ?
-      leftBeltSpeed : rightBeltSpeed;
-
-    // remember if we've found at least one contact joint (we should!)
-    bool foundContact = false;
-    for (auto contactIterator = ContactIterator::begin(body1, geom1, geom2);
-         contactIterator != ContactIterator::end();
-         ++contactIterator)
-    {
-      dContact* odeContact = contactIterator.getPointer();
-
-      // now we're sure it is a contact between our two geometries
-      foundContact = true;
-
-      const ignition::math::Vector3d contactWorldPosition(
-        odeContact->geom.pos[0],
-        odeContact->geom.pos[1],
-        odeContact->geom.pos[2]);
-
-      ignition::math::Vector3d contactNormal(
-        odeContact->geom.normal[0],
-        odeContact->geom.normal[1],
-        odeContact->geom.normal[2]);
-
-      // We always want contactNormal to point "inside" the track.
-      // The dot product is 1 for co-directional vectors and -1 for
-      // opposite-pointing vectors.
-      // The contact can be flipped either by swapping body1 and body2 above,
-      // or by having some flipped faces on collision meshes.
-      const double normalToTrackCenterDot =
-        contactNormal.Dot(
-          trackCollision->WorldPose().Pos() - contactWorldPosition);
-      if (normalToTrackCenterDot < 0)
-      {
-        contactNormal = -contactNormal;
-      }
-
-      // vector tangent to the belt pointing in the belt's movement direction
-      auto beltDirection(contactNormal.Cross(bodyYAxisGlobal));
-
-      if (beltSpeed > 0)
-        beltDirection = -beltDirection;
-
-      const auto frictionDirection =
-        this->ComputeFrictionDirection(linearSpeed,
-                                       angularSpeed,
-                                       desiredRotationRadiusSigned == dInfinity,
-                                       bodyPose,
-                                       bodyYAxisGlobal,
-                                       centerOfRotation,
-                                       contactWorldPosition,
-                                       contactNormal,
-                                       beltDirection);
-
-      odeContact->fdir1[0] = frictionDirection.X();
-      odeContact->fdir1[1] = frictionDirection.Y();
-      odeContact->fdir1[2] = frictionDirection.Z();
-
-      // use friction direction and motion1 to simulate the track movement
-      odeContact->surface.mode |= dContactFDir1 | dContactMotion1;
-
-      odeContact->surface.motion1 = this->ComputeSurfaceMotion(
-        beltSpeed, beltDirection, frictionDirection);
-    }
-
-    if (!foundContact)
-    {
-      gzwarn << "No ODE contact joint found for contact " <<
-             contact->DebugString() << std::endl;
-      continue;
-    }
+    // vector tangent to the belt pointing in the belt's movement direction
+    auto beltDirection(contactNormal.Cross(bodyYAxisGlobal));
+
+    if (beltSpeed > 0)
+      beltDirection = -beltDirection;
+
+    const auto frictionDirection =
+      this->ComputeFrictionDirection(linearSpeed,
+                                     angularSpeed,
+                                     desiredRotationRadiusSigned == dInfinity,
+                                     bodyPose,
+                                     bodyYAxisGlobal,
+                                     centerOfRotation,
+                                     contactWorldPosition,
+                                     contactNormal,
+                                     beltDirection);
+
+    // use friction direction and motion1 to simulate the track movement
+    point.frictionDirection1 = frictionDirection;
+    point.surfaceMotion1 = this->ComputeSurfaceMotion(
+      beltSpeed, beltDirection, frictionDirection);
   }
-  IGN_PROFILE_END();
 }
 
 ignition::math::Vector3d SimpleTrackedVehiclePlugin::ComputeFrictionDirection(
@@ -97,8 +97,17 @@ namespace gazebo {
     /// \brief Desired velocities of the tracks.
     protected: std::unordered_map<Tracks, double> trackVelocity;
 
-    /// \brief Compute and apply the forces that make the tracks move.
-    protected: void DriveTracks(const common::UpdateInfo &/*_unused*/);
+    /// \brief Set the friction directions and surface motion that make the
+    ///        tracks move, in the contact points of a track collision.
+    ///        Called by the physics engine before the solve.
+    /// \param[in] _collision1 First collision of the contact.
+    /// \param[in] _collision2 Second collision of the contact.
+    /// \param[in,out] _points Contact points.
+    /// \param[in] _count Number of contact points.
+    protected: void DriveTracks(physics::Collision *_collision1,
+                                physics::Collision *_collision2,
+                                physics::ContactPoint *_points,
+                                const unsigned int _count);
 
     /// \brief Return the number of tracks on the given side. Should always be
     /// at least 1 for the main track. If flippers are present, the number is
@@ -144,7 +153,12 @@ namespace gazebo {
 
     private: transport::NodePtr node;
 
-    private: event::ConnectionPtr beforePhysicsUpdateConnection;
+    /// \brief Physics engine calling DriveTracks.
+    private: physics::PhysicsEnginePtr physicsEngine;
+
+    /// \brief Side of each track collision.
+    private: std::unordered_map<const physics::Collision *, Tracks>
+             trackCollisions;
 
     /// \brief This bitmask will be set to the whole vehicle body.
     protected: unsigned int collideWithoutContactBitmask;
@@ -155,8 +169,6 @@ namespace gazebo {
     /// \brief Category for all items on the left side.
     protected: static const unsigned int LEFT_CATEGORY = 0x40000000;
 
-    private: physics::ContactManager *contactManager;
-
     /// \class ContactIterator
     /// \brief An iterator over all contacts between two geometries.
     class ContactIterator : std::iterator<std::input_iterator_tag, dContact>
@@ -18,6 +18,10 @@
 #include <curl/curl.h>
 #include <boost/filesystem.hpp>
 
+#include <atomic>
+#include <map>
+#include <thread>
+
 #include <ignition/math/Angle.hh>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/SphericalCoordinates.hh>
@@ -50,6 +54,22 @@ namespace gazebo
   };
 
 
+  /// \brief A file to download with DownloadFiles.
+  class FileDownload
+  {
+    /// \brief URL of the file.
+    public: std::string url;
+
+    /// \brief Path to save the file to.
+    public: std::string path;
+
+    /// \brief File the download is written to, until it completes.
+    public: FILE *file = nullptr;
+
+    /// \brief True if the file was downloaded.
+    public: bool done = false;
+  };
+
   /// \brief Private data class for StaticMapPlugin
   class StaticMapPluginPrivate
   {
@@ -95,6 +115,10 @@ namespace gazebo
     public: double GroundResolution(const double _lat,
         const unsigned int _zoom) const;
 
+    /// \brief Download the map tiles, create the map model and spawn it.
+    /// Runs on buildThread.
+    public: void BuildMap();
+
     /// \brief Spawn a model into the world
     /// \param[in] _name Name of model
     /// \param[in] _pose Pose of model
@@ -132,6 +156,10 @@ namespace gazebo
     /// files.
     public: bool useCache = false;
 
+    /// \brief True to keep the downloaded tile images in a cache shared by
+    /// all map models, so that tiles are only downloaded once.
+    public: bool useTileCache = true;
+
     /// \brief Google API key
     public: std::string apiKey;
 
@@ -146,6 +174,13 @@ namespace gazebo
 
     /// \brief True if the plugin is loaded successfully
     public: bool loaded = false;
+
+    /// \brief Thread that builds the map model, so that the world doesn't
+    /// wait for the downloads.
+    public: std::thread buildThread;
+
+    /// \brief Set to stop building the map model.
+    public: std::atomic<bool> stop{false};
   };
 }
 
@@ -156,6 +191,9 @@ const unsigned int MercatorProjection::TILE_SIZE = 256;
 GZ_REGISTER_WORLD_PLUGIN(StaticMapPlugin)
 
 
+/// \brief Maximum number of tiles downloaded at the same time.
+static const size_t MAX_PARALLEL_DOWNLOADS = 8;
+
 /////////////////////////////////////////////////
 size_t WriteData(void *_ptr, size_t _size, size_t _nmemb, FILE *_stream)
 {
@@ -163,59 +201,108 @@ size_t WriteData(void *_ptr, size_t _size, size_t _nmemb, FILE *_stream)
 }
 
 /////////////////////////////////////////////////
-bool DownloadFile(const std::string &_url, const std::string &_outputFile)
+/// \brief Download files, several at the same time. Each file is written
+/// to a ".part" file first, and renamed when it completes, so that failed
+/// or interrupted downloads don't leave partial files behind.
+/// \param[in,out] _downloads The files to download.
+/// \param[in] _stop Set to abandon the downloads.
+/// \return Number of files downloaded.
+static unsigned int DownloadFiles(std::vector<FileDownload> &_downloads,
+    const std::atomic<bool> &_stop)
 {
-  if (_url.empty())
-    return false;
+  CURLM *multi = curl_multi_init();
+  if (!multi)
+    return 0;
 
-  CURL *curl = curl_easy_init();
+  // Index of the download of each running transfer
+  std::map<CURL *, size_t> active;
+  size_t next = 0;
+  unsigned int count = 0;
 
-  curl_easy_setopt(curl, CURLOPT_URL, _url.c_str());
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteData);
-
-  FILE *fp = fopen(_outputFile.c_str(), "wb");
-  if (!fp)
+  while (!_stop && (next < _downloads.size() || !active.empty()))
   {
-    gzerr << "Could not download model[" << _url << "] because we were"
-      << "unable to write to file[" << _outputFile << "]."
-      << "Please fix file permissions.";
-    return false;
-  }
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+    // Keep up to MAX_PARALLEL_DOWNLOADS transfers running
+    while (next < _downloads.size() && active.size() < MAX_PARALLEL_DOWNLOADS)
+    {
+      FileDownload &download = _downloads[next++];
+      const std::string partPath = download.path + ".part";
+      download.file = fopen(partPath.c_str(), "wb");
+      if (!download.file)
+      {
+        gzerr << "Unable to write map tile to file[" << partPath << "]. "
+              << "Please fix file permissions." << std::endl;
+        continue;
+      }
 
-  char errbuf[CURL_ERROR_SIZE];
-  // provide a buffer to store errors in
-  curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
-  // set the error buffer as empty before performing a request
-  errbuf[0] = 0;
+      CURL *curl = curl_easy_init();
+      curl_easy_setopt(curl, CURLOPT_URL, download.url.c_str());
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteData);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, download.file);
+      curl_multi_add_handle(multi, curl);
+      active[curl] = next - 1;
+    }
 
-  CURLcode success = curl_easy_perform(curl);
-  if (success != CURLE_OK)
-  {
-    gzerr << "Error in REST request" << std::endl;
-    size_t len = strlen(errbuf);
-    fprintf(stderr, "\nlibcurl: (%d) ", success);
-    if (len)
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    CURLMsg *msg;
+    int left = 0;
+    while ((msg = curl_multi_info_read(multi, &left)) != nullptr)
     {
-      fprintf(stderr, "%s%s", errbuf,
-              ((errbuf[len - 1] != '\n') ? "\n" : ""));
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      CURL *curl = msg->easy_handle;
+      const CURLcode result = msg->data.result;
+      FileDownload &download = _downloads[active[curl]];
+      long statusCode = 0;
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+      curl_multi_remove_handle(multi, curl);
+      curl_easy_cleanup(curl);
+      active.erase(curl);
+
+      fclose(download.file);
+      download.file = nullptr;
+      const std::string partPath = download.path + ".part";
+      boost::system::error_code ec;
+      if (result == CURLE_OK && statusCode == 200)
+      {
+        boost::filesystem::rename(partPath, download.path, ec);
+        download.done = !ec;
+        if (download.done)
+          ++count;
+      }
+      else
+      {
+        // Don't print the URL, which has the API key
+        gzerr << "Failed to download map tile[" << download.path << "]: "
+              << curl_easy_strerror(result) << ", HTTP status "
+              << statusCode << std::endl;
+      }
+      if (!download.done)
+        boost::filesystem::remove(partPath, ec);
     }
-    else
-      fprintf(stderr, "%s\n", curl_easy_strerror(success));
-  }
-  fclose(fp);
 
-  // Update the status code.
-  int statusCode = 0;
-  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+    if (!active.empty())
+      curl_multi_wait(multi, nullptr, 0, 100, nullptr);
+  }
 
-  // Cleaning.
-  curl_easy_cleanup(curl);
+  // Abandon the transfers still running when stopped
+  for (auto const &transfer : active)
+  {
+    curl_multi_remove_handle(multi, transfer.first);
+    curl_easy_cleanup(transfer.first);
+    FileDownload &download = _downloads[transfer.second];
+    fclose(download.file);
+    download.file = nullptr;
+    boost::system::error_code ec;
+    boost::filesystem::remove(download.path + ".part", ec);
+  }
+  curl_multi_cleanup(multi);
 
-  return true;
+  return count;
 }
 
-
 /////////////////////////////////////////////////
 ignition::math::Vector2d MercatorProjection::LatLonToPoint(
     const ignition::math::SphericalCoordinates &_latLon)
@@ -261,6 +348,14 @@ StaticMapPlugin::StaticMapPlugin()
 {
 }
 
+/////////////////////////////////////////////////
+StaticMapPlugin::~StaticMapPlugin()
+{
+  this->dataPtr->stop = true;
+  if (this->dataPtr->buildThread.joinable())
+    this->dataPtr->buildThread.join();
+}
+
 /////////////////////////////////////////////////
 void StaticMapPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
 {
@@ -322,6 +417,9 @@ void StaticMapPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
   if (_sdf->HasElement("use_cache"))
     this->dataPtr->useCache = _sdf->Get<bool>("use_cache");
 
+  if (_sdf->HasElement("use_tile_cache"))
+    this->dataPtr->useTileCache = _sdf->Get<bool>("use_tile_cache");
+
   if (_sdf->HasElement("pose"))
     this->dataPtr->modelPose = _sdf->Get<ignition::math::Pose3d>("pose");
 
@@ -367,37 +465,53 @@ void StaticMapPlugin::Init()
     return;
   }
 
+  // Download and create the model in the background, so that the world
+  // doesn't wait for it
+  this->dataPtr->buildThread =
+      std::thread(&StaticMapPluginPrivate::BuildMap, this->dataPtr.get());
+}
+
+/////////////////////////////////////////////////
+void StaticMapPluginPrivate::BuildMap()
+{
+  auto basePath = common::SystemPaths::Instance()->GetLogPath() /
+        boost::filesystem::path("models");
+  boost::filesystem::path modelPath = basePath / this->modelName;
 
   // create tmp dir to save model files
   boost::filesystem::path tmpModelPath =
-      boost::filesystem::temp_directory_path() / this->dataPtr->modelName;
+      boost::filesystem::temp_directory_path() / this->modelName;
   boost::filesystem::path scriptsPath(tmpModelPath / "materials" / "scripts");
   boost::filesystem::create_directories(scriptsPath);
   boost::filesystem::path texturesPath(tmpModelPath / "materials" / "textures");
   boost::filesystem::create_directories(texturesPath);
 
   // download map tile images into model/materials/textures
-  std::vector<std::string> tiles = this->dataPtr->DownloadMapTiles(
-      this->dataPtr->center.X(),
-      this->dataPtr->center.Y(),
-      this->dataPtr->zoom,
-      this->dataPtr->tileSizePx,
-      this->dataPtr->worldSize,
-      this->dataPtr->mapType,
-      this->dataPtr->apiKey,
+  std::vector<std::string> tiles = this->DownloadMapTiles(
+      this->center.X(),
+      this->center.Y(),
+      this->zoom,
+      this->tileSizePx,
+      this->worldSize,
+      this->mapType,
+      this->apiKey,
       texturesPath.string());
 
+  // the plugin is being destroyed
+  if (this->stop)
+    return;
+
   // assume square model for now
   unsigned int xNumTiles = std::sqrt(tiles.size());
   unsigned int yNumTiles = xNumTiles;
 
-  double tileWorldSize = this->dataPtr->GroundResolution(
-      IGN_DTOR(this->dataPtr->center.X()), this->dataPtr->zoom)
-      * this->dataPtr->tileSizePx;
+  double tileWorldSize = this->GroundResolution(
+      IGN_DTOR(this->center.X()), this->zoom)
+      * this->tileSizePx;
 
   // create model and spawn it into the world
-  if (this->dataPtr->CreateMapTileModel(
-      this->dataPtr->modelName, tileWorldSize,
+  if (this->CreateMapTileModel(
+      this->modelName, tileWorldSize,
       xNumTiles, yNumTiles, tiles, tmpModelPath.string()))
   {
     // verify model dir is created
@@ -429,8 +543,8 @@ void StaticMapPlugin::Init()
         }
       }
       // spawn the model
-      this->dataPtr->SpawnModel("model://" + this->dataPtr->modelName,
-          this->dataPtr->modelPose);
+      this->SpawnModel("model://" + this->modelName,
+          this->modelPose);
     }
     else
       gzerr << "Failed to create model: " << tmpModelPath.string() << std::endl;
@@ -493,8 +607,21 @@ std::vector<std::string> StaticMapPluginPrivate::DownloadMapTiles(
     y += halfTileSize;
   double startx = x;
 
+  // tiles are cached by center, zoom, size and type, which is everything
+  // that changes the image except the API key
+  boost::filesystem::path tileCachePath =
+      boost::filesystem::path(common::SystemPaths::Instance()->GetLogPath()) /
+      "map_tiles";
+  if (this->useTileCache)
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(tileCachePath, ec);
+  }
+
   // download map tiles using google static map API
   std::string url = "https://maps.googleapis.com/maps/api/staticmap";
+  std::vector<FileDownload> downloads;
+  std::vector<std::pair<std::string, std::string>> cachedTiles;
   for (unsigned int i = 0; i < yNumTiles; ++i)
   {
     for (unsigned int j = 0; j < xNumTiles; ++j)
@@ -505,7 +632,26 @@ std::vector<std::string> StaticMapPluginPrivate::DownloadMapTiles(
       // convert world point to lat lon
       auto latLon = MercatorProjection::PointToLatLon(point);
 
-      // download tile image
+      std::stringstream filename;
+      filename << "tile_"
+               << std::setprecision(9) << latLon.LatitudeReference().Degree()
+               << "_" << latLon.LongitudeReference().Degree() << ".png";
+      std::string fullPath = _saveDirPath + "/" + filename.str();
+      mapTileFilenames.push_back(filename.str());
+
+      x += _tileSizePx;
+
+      std::stringstream cacheName;
+      cacheName << _mapType << "_" << _zoom << "_" << _tileSizePx << "_"
+                << filename.str();
+      const std::string cachePath = (tileCachePath / cacheName.str()).string();
+      if (this->useTileCache && common::exists(cachePath))
+      {
+        cachedTiles.push_back(std::make_pair(cachePath, fullPath));
+        continue;
+      }
+
+      // tile image to download
       std::stringstream query;
       query << "?center="
             << std::setprecision(9)
@@ -515,21 +661,35 @@ std::vector<std::string> StaticMapPluginPrivate::DownloadMapTiles(
             << "&size=" << _tileSizePx << "x" << _tileSizePx
             << "&maptype=" << _mapType
             << "&key=" << _apiKey;
-      std::string fullURL = url + query.str();
-      std::stringstream filename;
-      filename << "tile_"
-               << std::setprecision(9) << latLon.LatitudeReference().Degree()
-               << "_" << latLon.LongitudeReference().Degree() << ".png";
-      std::string fullPath = _saveDirPath + "/" + filename.str();
-      DownloadFile(fullURL, fullPath);
-      gzmsg << "Downloading map tile: " << filename.str() << std::endl;
-      mapTileFilenames.push_back(filename.str());
-
-      x += _tileSizePx;
+      FileDownload download;
+      download.url = url + query.str();
+      download.path = this->useTileCache ? cachePath : fullPath;
+      downloads.push_back(download);
+      if (this->useTileCache)
+        cachedTiles.push_back(std::make_pair(cachePath, fullPath));
     }
     x = startx;
     y += _tileSizePx;
   }
+
+  if (!downloads.empty())
+  {
+    gzmsg << "Downloading " << downloads.size() << " map tiles" << std::endl;
+    const unsigned int count = DownloadFiles(downloads, this->stop);
+    if (count < downloads.size() && !this->stop)
+    {
+      gzerr << "Failed to download " << downloads.size() - count
+            << " map tiles" << std::endl;
+    }
+  }
+
+  // copy the cached tiles into the model
+  for (auto const &tile : cachedTiles)
+  {
+    if (common::exists(tile.first))
+      common::copyFile(tile.first, tile.second);
+  }
+
   return mapTileFilenames;
 }
 
@@ -52,11 +52,21 @@ namespace gazebo
   ///              API documentation for more details.
   /// <use_cache>  Use model in gazebo model path if exists, otherwise
   ///              recreate the model and save it in <HOME>/.gazebo/models
+  /// <use_tile_cache> Keep the tile images in <HOME>/.gazebo/map_tiles, and
+  ///              only download the tiles that are not there yet. True by
+  ///              default.
+  ///
+  /// The tiles are downloaded in parallel on a background thread, and the
+  /// map model is spawned when they are ready, so the world doesn't wait for
+  /// the downloads.
   class GZ_PLUGIN_VISIBLE StaticMapPlugin : public WorldPlugin
   {
     /// \brief Constructor.
     public: StaticMapPlugin();
 
+    /// \brief Destructor. Stops building the map model.
+    public: virtual ~StaticMapPlugin();
+
     /// \brief Load the plugin.
     /// \param[in] _world Pointer to world
     /// \param[in] _sdf Pointer to the SDF configuration.
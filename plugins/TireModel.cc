@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Profiler.hh"
+
+#include "gazebo/common/UpdateInfo.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/UpdateScheduler.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/ode/ODESurfaceParams.hh"
+
+#include "plugins/TireModel.hh"
+
+namespace gazebo
+{
+  /// \brief Command applied to a wheel every step.
+  enum class WheelCommand
+  {
+    /// \brief No command.
+    NONE,
+
+    /// \brief Set the joint velocity.
+    SPEED,
+
+    /// \brief Apply a torque up to a velocity limit.
+    TORQUE
+  };
+
+  /// \internal
+  /// \brief Private data for the TireModel class. The state of a wheel is
+  /// at the same index of every vector.
+  class TireModelPrivate
+  {
+    /// \brief Wheel joints, null for unused ids.
+    public: std::vector<physics::JointPtr> joints;
+
+    /// \brief Wheel links, the children of the joints.
+    public: std::vector<physics::LinkPtr> links;
+
+    /// \brief Spin axis of each joint.
+    public: std::vector<unsigned int> axes;
+
+    /// \brief Wheel radii.
+    public: std::vector<double> radii;
+
+    /// \brief Wheel commands.
+    public: std::vector<WheelCommand> commands;
+
+    /// \brief Joint velocity of SPEED commands, torque of TORQUE commands.
+    public: std::vector<double> values;
+
+    /// \brief Joint velocity limit of TORQUE commands.
+    public: std::vector<double> limits;
+
+    /// \brief Slip surfaces, null for wheels without slip.
+    public: std::vector<physics::ODESurfaceParamsPtr> surfaces;
+
+    /// \brief Unitless lateral slip compliances.
+    public: std::vector<double> slipLateral;
+
+    /// \brief Unitless longitudinal slip compliances.
+    public: std::vector<double> slipLongitudinal;
+
+    /// \brief Expected normal force of the wheels with slip.
+    public: std::vector<double> normalForces;
+
+    /// \brief Unused ids.
+    public: std::vector<int> freeIds;
+
+    /// \brief Number of registered wheels.
+    public: unsigned int wheelCount = 0;
+
+    /// \brief Protects the wheel state.
+    public: mutable std::mutex mutex;
+
+    /// \brief Connection to the update scheduler of the world.
+    public: event::ConnectionPtr updateConnection;
+
+    /// \brief Check a wheel id.
+    /// \param[in] _wheel Wheel id.
+    /// \return True if _wheel is registered.
+    public: bool Valid(const int _wheel) const
+            {
+              return _wheel >= 0 &&
+                static_cast<size_t>(_wheel) < this->joints.size() &&
+                this->joints[_wheel];
+            }
+  };
+}
+
+using namespace gazebo;
+
+/// \brief Tire models of the worlds, by world name.
+static std::map<std::string, std::weak_ptr<TireModel>> g_tireModels;
+
+/// \brief Protects g_tireModels.
+static std::mutex g_tireModelsMutex;
+
+/////////////////////////////////////////////////
+std::shared_ptr<TireModel> TireModel::Get(const physics::WorldPtr &_world)
+{
+  if (!_world)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(g_tireModelsMutex);
+  std::shared_ptr<TireModel> tireModel = g_tireModels[_world->Name()].lock();
+  if (!tireModel)
+  {
+    tireModel.reset(new TireModel());
+    // The connection is owned by the tire model, so it can't outlive it.
+    // The scheduler runs after the world update begin event, where the
+    // plugins set their commands, and before collision detection, which
+    // reads the slip parameters.
+    TireModel *model = tireModel.get();
+    tireModel->dataPtr->updateConnection = _world->Scheduler().Connect(
+        [model](const common::UpdateInfo &)
+        {
+          model->Update();
+        }, 0, "TireModel");
+    g_tireModels[_world->Name()] = tireModel;
+  }
+  return tireModel;
+}
+
+/////////////////////////////////////////////////
+TireModel::TireModel()
+  : dataPtr(new TireModelPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+TireModel::~TireModel()
+{
+}
+
+/////////////////////////////////////////////////
+int TireModel::AddWheel(const physics::JointPtr &_joint,
+    const double _radius, const unsigned int _axis)
+{
+  if (!_joint || !(_radius > 0))
+    return -1;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+
+  int wheel;
+  if (!d.freeIds.empty())
+  {
+    wheel = d.freeIds.back();
+    d.freeIds.pop_back();
+  }
+  else
+  {
+    wheel = static_cast<int>(d.joints.size());
+    const size_t size = d.joints.size() + 1;
+    d.joints.resize(size);
+    d.links.resize(size);
+    d.axes.resize(size);
+    d.radii.resize(size);
+    d.commands.resize(size);
+    d.values.resize(size);
+    d.limits.resize(size);
+    d.surfaces.resize(size);
+    d.slipLateral.resize(size);
+    d.slipLongitudinal.resize(size);
+    d.normalForces.resize(size);
+  }
+
+  d.joints[wheel] = _joint;
+  d.links[wheel] = _joint->GetChild();
+  d.axes[wheel] = _axis;
+  d.radii[wheel] = _radius;
+  d.commands[wheel] = WheelCommand::NONE;
+  d.values[wheel] = 0;
+  d.limits[wheel] = 0;
+  d.surfaces[wheel].reset();
+  d.slipLateral[wheel] = 0;
+  d.slipLongitudinal[wheel] = 0;
+  d.normalForces[wheel] = 0;
+  ++d.wheelCount;
+
+  return wheel;
+}
+
+/////////////////////////////////////////////////
+void TireModel::RemoveWheel(const int _wheel)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+  if (!d.Valid(_wheel))
+    return;
+
+  d.joints[_wheel].reset();
+  d.links[_wheel].reset();
+  d.surfaces[_wheel].reset();
+  d.commands[_wheel] = WheelCommand::NONE;
+  d.freeIds.push_back(_wheel);
+  --d.wheelCount;
+}
+
+/////////////////////////////////////////////////
+unsigned int TireModel::WheelCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->wheelCount;
+}
+
+/////////////////////////////////////////////////
+void TireModel::SetSpeed(const int _wheel, const double _speed)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+  if (!d.Valid(_wheel))
+    return;
+
+  d.commands[_wheel] = WheelCommand::SPEED;
+  d.values[_wheel] = _speed / d.radii[_wheel];
+}
+
+/////////////////////////////////////////////////
+void TireModel::SetTorque(const int _wheel, const double _torque,
+    const double _speedLimit)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+  if (!d.Valid(_wheel))
+    return;
+
+  d.commands[_wheel] = WheelCommand::TORQUE;
+  d.values[_wheel] = _torque;
+  d.limits[_wheel] = _speedLimit / d.radii[_wheel];
+}
+
+/////////////////////////////////////////////////
+void TireModel::ClearCommand(const int _wheel)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+  if (d.Valid(_wheel))
+    d.commands[_wheel] = WheelCommand::NONE;
+}
+
+/////////////////////////////////////////////////
+void TireModel::SetSlipSurface(const int _wheel,
+    const physics::ODESurfaceParamsPtr &_surface, const double _normalForce)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+  if (!d.Valid(_wheel) || !(_normalForce > 0))
+    return;
+
+  d.surfaces[_wheel] = _surface;
+  d.normalForces[_wheel] = _normalForce;
+}
+
+/////////////////////////////////////////////////
+void TireModel::SetSlipCompliance(const int _wheel, const double _lateral,
+    const double _longitudinal)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+  if (!d.Valid(_wheel))
+    return;
+
+  d.slipLateral[_wheel] = _lateral;
+  d.slipLongitudinal[_wheel] = _longitudinal;
+}
+
+/////////////////////////////////////////////////
+void TireModel::Update()
+{
+  IGN_PROFILE("TireModel::Update");
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TireModelPrivate &d = *this->dataPtr;
+
+  const size_t size = d.joints.size();
+  for (size_t i = 0; i < size; ++i)
+  {
+    physics::Joint *joint = d.joints[i].get();
+    if (!joint)
+      continue;
+
+    switch (d.commands[i])
+    {
+      case WheelCommand::SPEED:
+        joint->SetVelocity(d.axes[i], d.values[i]);
+        break;
+      case WheelCommand::TORQUE:
+        joint->SetVelocityLimit(d.axes[i], d.limits[i]);
+        joint->SetForce(d.axes[i], d.values[i]);
+        break;
+      default:
+        break;
+    }
+
+    physics::ODESurfaceParams *surface = d.surfaces[i].get();
+    if (!surface || !d.links[i])
+      continue;
+
+    // As discussed in WheelSlipPlugin.hh, the ODE slip1 and slip2
+    // parameters have units of inverse viscous damping:
+    // [linear velocity / force] or [m / s / N].
+    // Since the slip compliances are unitless, they must be scaled by a
+    // linear speed and force magnitude before being passed to ODE.
+    // The force is a user-defined constant that should roughly match the
+    // steady-state normal force at the wheel.
+    // The linear speed is computed at each time step as
+    // radius * spin angular velocity.
+    // This choice of linear speed corresponds to the denominator of
+    // the slip ratio during acceleration (see equation (1) in
+    // Yoshida, Hamano 2002 DOI 10.1109/ROBOT.2002.1013712
+    // "Motion dynamics of a rover with slip-based traction model").
+    // The acceleration form is more well-behaved numerically at low-speed
+    // and when the vehicle is at rest than the braking form,
+    // so it is used for both slip directions.
+    const double spin =
+      d.links[i]->WorldAngularVel().Dot(joint->GlobalAxis(d.axes[i]));
+    const double speedOverForce =
+      d.radii[i] * std::abs(spin) / d.normalForces[i];
+    surface->slip1 = speedOverForce * d.slipLateral[i];
+    surface->slip2 = speedOverForce * d.slipLongitudinal[i];
+  }
+}
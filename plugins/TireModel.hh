@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_TIREMODEL_HH_
+#define GAZEBO_PLUGINS_TIREMODEL_HH_
+
+#include <memory>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/ode/ODETypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  // Forward declare private data class
+  class TireModelPrivate;
+
+  /// \class TireModel TireModel.hh plugins/TireModel.hh
+  /// \brief The wheels of all the vehicles of a world, updated together
+  /// once per step.
+  ///
+  /// Vehicle plugins register their wheel joints once, and then only set
+  /// the command of each wheel. On every world iteration, the commands
+  /// and slip parameters of all the registered wheels are applied in one
+  /// pass over contiguous per wheel state, with the joint, link and surface
+  /// pointers cached at registration. This avoids one update callback and
+  /// one set of lookups per vehicle in worlds with many vehicles.
+  class GZ_PLUGIN_VISIBLE TireModel
+  {
+    /// \brief Get the tire model of a world. It is created by the first
+    /// call, and destroyed when the last plugin releases it.
+    /// \param[in] _world The world.
+    /// \return The tire model of _world.
+    public: static std::shared_ptr<TireModel> Get(
+                const physics::WorldPtr &_world);
+
+    /// \brief Destructor.
+    public: ~TireModel();
+
+    /// \brief Register a wheel. It has no command until one is set.
+    /// \param[in] _joint Joint that spins the wheel.
+    /// \param[in] _radius Wheel radius, in meters.
+    /// \param[in] _axis Index of the spin axis of _joint.
+    /// \return Id of the wheel, or -1 if _joint is null or _radius is not
+    /// positive.
+    public: int AddWheel(const physics::JointPtr &_joint,
+                         const double _radius,
+                         const unsigned int _axis = 0);
+
+    /// \brief Unregister a wheel. Its id may be reused by later wheels.
+    /// \param[in] _wheel Wheel id.
+    public: void RemoveWheel(const int _wheel);
+
+    /// \brief Get the number of registered wheels.
+    /// \return Number of wheels.
+    public: unsigned int WheelCount() const;
+
+    /// \brief Set the joint velocity of a wheel every step, so that its
+    /// tread moves at a linear speed.
+    /// \param[in] _wheel Wheel id.
+    /// \param[in] _speed Tread speed, in m/s.
+    public: void SetSpeed(const int _wheel, const double _speed);
+
+    /// \brief Apply a torque to a wheel every step, up to a tread speed.
+    /// \param[in] _wheel Wheel id.
+    /// \param[in] _torque Torque on the spin axis, in N m.
+    /// \param[in] _speedLimit Tread speed at which the torque stops
+    /// accelerating the wheel, in m/s.
+    public: void SetTorque(const int _wheel, const double _torque,
+                           const double _speedLimit);
+
+    /// \brief Stop commanding a wheel.
+    /// \param[in] _wheel Wheel id.
+    public: void ClearCommand(const int _wheel);
+
+    /// \brief Update the ODE slip parameters of a wheel every step, from
+    /// unitless slip compliances. See WheelSlipPlugin for the model.
+    /// \param[in] _wheel Wheel id.
+    /// \param[in] _surface Surface of the wheel collision.
+    /// \param[in] _normalForce Expected normal force on the wheel, in N.
+    public: void SetSlipSurface(const int _wheel,
+                                const physics::ODESurfaceParamsPtr &_surface,
+                                const double _normalForce);
+
+    /// \brief Set the slip compliances of a wheel with a slip surface.
+    /// \param[in] _wheel Wheel id.
+    /// \param[in] _lateral Unitless lateral slip compliance.
+    /// \param[in] _longitudinal Unitless longitudinal slip compliance.
+    public: void SetSlipCompliance(const int _wheel, const double _lateral,
+                                   const double _longitudinal);
+
+    /// \brief Apply the commands and slip parameters of all the wheels.
+    /// Called on every iteration by the update scheduler of the world.
+    public: void Update();
+
+    /// \brief Constructor, use Get().
+    private: TireModel();
+
+    /// \internal
+    /// \brief Private data pointer.
+    private: std::unique_ptr<TireModelPrivate> dataPtr;
+  };
+}
+#endif
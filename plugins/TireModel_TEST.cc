@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/test/ServerFixture.hh"
+#include "plugins/TireModel.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TireModelTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Spawn a box body with one wheel of radius 0.5 m.
+/// \param[in] _fixture Server fixture.
+/// \param[in] _name Model name.
+void SpawnWheeledModel(ServerFixture *_fixture, const std::string &_name)
+{
+  msgs::Model modelMsg;
+  modelMsg.set_name(_name);
+  modelMsg.set_is_static(false);
+
+  msgs::AddBoxLink(modelMsg, 10., ignition::math::Vector3d(1., 1., 1.));
+  auto bodyLink = modelMsg.mutable_link(modelMsg.link_size()-1);
+  bodyLink->set_name("body");
+
+  msgs::AddCylinderLink(modelMsg, 1.0, 0.5, 1.0);
+  auto wheelLink = modelMsg.mutable_link(modelMsg.link_size()-1);
+  wheelLink->set_name("wheel");
+  wheelLink->mutable_collision(0)->set_name("wheel_collision");
+  wheelLink->mutable_visual(0)->set_name("wheel_visual");
+
+  auto joint = modelMsg.add_joint();
+  joint->set_name("wheel_j");
+  joint->set_type(msgs::Joint_Type::Joint_Type_REVOLUTE);
+  joint->mutable_pose()->mutable_position()->set_y(1.);
+  joint->mutable_axis1()->mutable_xyz()->set_y(1.);
+  joint->set_parent("body");
+  joint->set_child("wheel");
+
+  _fixture->SpawnModel(modelMsg);
+  _fixture->WaitUntilEntitySpawn(_name, 10, 100);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TireModelTest, Wheels)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnWheeledModel(this, "model");
+  physics::ModelPtr model = world->ModelByName("model");
+  ASSERT_TRUE(model != nullptr);
+  physics::JointPtr joint = model->GetJoint("wheel_j");
+  ASSERT_TRUE(joint != nullptr);
+
+  // One tire model per world
+  std::shared_ptr<TireModel> tireModel = TireModel::Get(world);
+  ASSERT_TRUE(tireModel != nullptr);
+  EXPECT_EQ(tireModel, TireModel::Get(world));
+  EXPECT_TRUE(TireModel::Get(nullptr) == nullptr);
+
+  // Invalid wheels
+  EXPECT_EQ(-1, tireModel->AddWheel(nullptr, 0.5));
+  EXPECT_EQ(-1, tireModel->AddWheel(joint, 0.0));
+  EXPECT_EQ(0u, tireModel->WheelCount());
+
+  const int wheel = tireModel->AddWheel(joint, 0.5);
+  EXPECT_LE(0, wheel);
+  EXPECT_EQ(1u, tireModel->WheelCount());
+
+  // The speed is applied on every step
+  tireModel->SetSpeed(wheel, 2.0);
+  world->Step(100);
+  EXPECT_NEAR(4.0, joint->GetVelocity(0), 0.25);
+
+  tireModel->SetSpeed(wheel, 0.0);
+  world->Step(100);
+  EXPECT_NEAR(0.0, joint->GetVelocity(0), 0.1);
+
+  // Unknown ids are ignored
+  tireModel->SetSpeed(wheel + 1, 1.0);
+  tireModel->SetSpeed(-1, 1.0);
+  tireModel->RemoveWheel(wheel + 1);
+  EXPECT_EQ(1u, tireModel->WheelCount());
+
+  // Ids are reused
+  tireModel->RemoveWheel(wheel);
+  EXPECT_EQ(0u, tireModel->WheelCount());
+  tireModel->SetSpeed(wheel, 1.0);
+  EXPECT_EQ(wheel, tireModel->AddWheel(joint, 0.5));
+  EXPECT_EQ(1u, tireModel->WheelCount());
+  tireModel->RemoveWheel(wheel);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,7 +17,7 @@
 
 #include <functional>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include <gazebo/common/Events.hh>
 #include <gazebo/common/Assert.hh>
@@ -17,7 +17,7 @@
 
 #include <functional>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/transport/transport.hh"
@@ -44,6 +44,16 @@ VehiclePlugin::VehiclePlugin()
   this->tireAngleRange = 1.0;
 }
 
+/////////////////////////////////////////////////
+VehiclePlugin::~VehiclePlugin()
+{
+  if (this->tireModel)
+  {
+    for (const int id : this->wheelIds)
+      this->tireModel->RemoveWheel(id);
+  }
+}
+
 /////////////////////////////////////////////////
 void VehiclePlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 {
@@ -167,6 +177,12 @@ void VehiclePlugin::Init()
   ignition::math::AxisAlignedBox bb = parent->BoundingBox();
   this->wheelRadius = bb.Size().Max() * 0.5;
 
+  // The wheels spin about the second axis of the joints
+  this->tireModel = TireModel::Get(this->model->GetWorld());
+  for (const auto &joint : this->joints)
+    this->wheelIds.push_back(
+        this->tireModel->AddWheel(joint, this->wheelRadius, 1));
+
   // The total range the steering wheel can rotate
   double steeringRange = this->steeringJoint->UpperLimit(0) -
                          this->steeringJoint->LowerLimit(0);
@@ -204,22 +220,18 @@ void VehiclePlugin::OnUpdate()
 
   // double idleSpeed = 0.5;
 
-  // Compute the rotational velocity of the wheels
-  double jointVel = (std::max(0.0, gas-brake) * this->maxSpeed) /
-                    this->wheelRadius;
-
-  // Set velocity and max force for each wheel
-  this->joints[0]->SetVelocityLimit(1, -jointVel);
-  this->joints[0]->SetForce(1, (gas + brake) * this->frontPower);
-
-  this->joints[1]->SetVelocityLimit(1, -jointVel);
-  this->joints[1]->SetForce(1, (gas + brake) * this->frontPower);
-
-  this->joints[2]->SetVelocityLimit(1, -jointVel);
-  this->joints[2]->SetForce(1, (gas + brake) * this->rearPower);
-
-  this->joints[3]->SetVelocityLimit(1, -jointVel);
-  this->joints[3]->SetForce(1, (gas + brake) * this->rearPower);
+  // Compute the tread speed of the wheels
+  double speed = std::max(0.0, gas-brake) * this->maxSpeed;
+
+  // Set speed and max torque for each wheel, applied by the tire model
+  this->tireModel->SetTorque(this->wheelIds[0],
+      (gas + brake) * this->frontPower, -speed);
+  this->tireModel->SetTorque(this->wheelIds[1],
+      (gas + brake) * this->frontPower, -speed);
+  this->tireModel->SetTorque(this->wheelIds[2],
+      (gas + brake) * this->rearPower, -speed);
+  this->tireModel->SetTorque(this->wheelIds[3],
+      (gas + brake) * this->rearPower, -speed);
 
   // Set the front-left wheel angle
   this->joints[0]->SetLowerLimit(0, wheelAngle);
@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PLUGINS_VEHICLEPLUGIN_HH_
 #define GAZEBO_PLUGINS_VEHICLEPLUGIN_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,7 @@
 #include "gazebo/physics/physics.hh"
 #include "gazebo/transport/transport.hh"
 #include "gazebo/util/system.hh"
+#include "plugins/TireModel.hh"
 
 namespace gazebo
 {
@@ -36,6 +38,9 @@ namespace gazebo
     /// \brief Constructor
     public: VehiclePlugin();
 
+    /// \brief Destructor
+    public: virtual ~VehiclePlugin();
+
     public: virtual void Load(physics::ModelPtr _model, sdf::ElementPtr _sdf);
     public: virtual void Init();
 
@@ -60,6 +65,12 @@ namespace gazebo
     private: double maxSpeed;
     private: double wheelRadius;
 
+    /// \brief Tire model that drives the wheels.
+    private: std::shared_ptr<TireModel> tireModel;
+
+    /// \brief Tire model ids of the wheel joints.
+    private: std::vector<int> wheelIds;
+
     private: double steeringRatio;
     private: double tireAngleRange;
     private: double maxGas, maxBrake;
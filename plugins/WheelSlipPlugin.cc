@@ -17,7 +17,7 @@
 #include <map>
 #include <mutex>
 
-#include <ignition/common/Profiler.hh>
+#include "gazebo/common/Profiler.hh"
 
 #include <gazebo/common/Assert.hh>
 #include <gazebo/common/CommonTypes.hh>
@@ -39,6 +39,7 @@
 #include <gazebo/transport/Publisher.hh>
 #include <gazebo/transport/Subscriber.hh>
 
+#include "plugins/TireModel.hh"
 #include "plugins/WheelSlipPlugin.hh"
 
 namespace gazebo
@@ -83,8 +84,14 @@ namespace gazebo
 
       /// \brief Publish slip for each wheel.
       public: transport::PublisherPtr slipPub;
+
+      /// \brief Id of the wheel in the tire model.
+      public: int wheelId = -1;
     };
 
+    /// \brief Tire model that updates the slip parameters every step.
+    public: std::shared_ptr<TireModel> tireModel;
+
     /// \brief Initial gravity direction in parent model frame.
     public: ignition::math::Vector3d initialGravityDirection;
 
@@ -129,6 +136,7 @@ WheelSlipPlugin::WheelSlipPlugin()
 /////////////////////////////////////////////////
 WheelSlipPlugin::~WheelSlipPlugin()
 {
+  this->Fini();
 }
 
 /////////////////////////////////////////////////
@@ -138,9 +146,12 @@ void WheelSlipPlugin::Fini()
 
   this->dataPtr->lateralComplianceSub.reset();
   this->dataPtr->longitudinalComplianceSub.reset();
-  for (auto linkSurface : this->dataPtr->mapLinkSurfaceParams)
+  for (auto &linkSurface : this->dataPtr->mapLinkSurfaceParams)
   {
     linkSurface.second.slipPub.reset();
+    if (this->dataPtr->tireModel)
+      this->dataPtr->tireModel->RemoveWheel(linkSurface.second.wheelId);
+    linkSurface.second.wheelId = -1;
   }
   if (this->dataPtr->gzNode)
     this->dataPtr->gzNode->Fini();
@@ -316,6 +327,20 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
       continue;
     }
 
+    if (!this->dataPtr->tireModel)
+      this->dataPtr->tireModel = TireModel::Get(world);
+
+    auto &tireModel = this->dataPtr->tireModel;
+    auto existing = this->dataPtr->mapLinkSurfaceParams.find(link);
+    if (existing != this->dataPtr->mapLinkSurfaceParams.end())
+      tireModel->RemoveWheel(existing->second.wheelId);
+
+    params.wheelId = tireModel->AddWheel(joint, params.wheelRadius);
+    tireModel->SetSlipSurface(params.wheelId, odeSurface,
+        params.wheelNormalForce);
+    tireModel->SetSlipCompliance(params.wheelId,
+        params.slipComplianceLateral, params.slipComplianceLongitudinal);
+
     this->dataPtr->mapLinkSurfaceParams[link] = params;
   }
 
@@ -440,7 +465,10 @@ void WheelSlipPlugin::SetSlipComplianceLateral(const double _compliance)
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   for (auto &linkSurface : this->dataPtr->mapLinkSurfaceParams)
   {
-    linkSurface.second.slipComplianceLateral = _compliance;
+    auto &params = linkSurface.second;
+    params.slipComplianceLateral = _compliance;
+    this->dataPtr->tireModel->SetSlipCompliance(params.wheelId,
+        params.slipComplianceLateral, params.slipComplianceLongitudinal);
   }
 }
 
@@ -450,7 +478,10 @@ void WheelSlipPlugin::SetSlipComplianceLongitudinal(const double _compliance)
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   for (auto &linkSurface : this->dataPtr->mapLinkSurfaceParams)
   {
-    linkSurface.second.slipComplianceLongitudinal = _compliance;
+    auto &params = linkSurface.second;
+    params.slipComplianceLongitudinal = _compliance;
+    this->dataPtr->tireModel->SetSlipCompliance(params.wheelId,
+        params.slipComplianceLateral, params.slipComplianceLongitudinal);
   }
 }
 
@@ -463,53 +494,15 @@ void WheelSlipPlugin::Update()
   std::map<std::string, ignition::math::Vector3d> slips;
   this->GetSlips(slips);
 
+  // The slip parameters of the surfaces are updated by the tire model, see
+  // TireModel::Update for how the unitless compliances are scaled.
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   for (const auto &linkSurface : this->dataPtr->mapLinkSurfaceParams)
   {
     const auto &params = linkSurface.second;
 
-    // get user-defined normal force constant
-    double force = params.wheelNormalForce;
-
-    // get link angular velocity parallel to joint axis
-    ignition::math::Vector3d wheelAngularVelocity;
-    auto link = linkSurface.first.lock();
-    if (link)
-      wheelAngularVelocity = link->WorldAngularVel();
-
-    ignition::math::Vector3d jointAxis;
-    auto joint = params.joint.lock();
-    if (joint)
-      jointAxis = joint->GlobalAxis(0);
-
-    double spinAngularVelocity = wheelAngularVelocity.Dot(jointAxis);
-
-    auto surface = params.surface.lock();
-    if (surface)
-    {
-      // As discussed in WheelSlipPlugin.hh, the ODE slip1 and slip2
-      // parameters have units of inverse viscous damping:
-      // [linear velocity / force] or [m / s / N].
-      // Since the slip compliance parameters supplied to the plugin
-      // are unitless, they must be scaled by a linear speed and force
-      // magnitude before being passed to ODE.
-      // The force is taken from a user-defined constant that should roughly
-      // match the steady-state normal force at the wheel.
-      // The linear speed is computed dynamically at each time step as
-      // radius * spin angular velocity.
-      // This choice of linear speed corresponds to the denominator of
-      // the slip ratio during acceleration (see equation (1) in
-      // Yoshida, Hamano 2002 DOI 10.1109/ROBOT.2002.1013712
-      // "Motion dynamics of a rover with slip-based traction model").
-      // The acceleration form is more well-behaved numerically at low-speed
-      // and when the vehicle is at rest than the braking form,
-      // so it is used for both slip directions.
-      double speed = params.wheelRadius * std::abs(spinAngularVelocity);
-      surface->slip1 = speed / force * params.slipComplianceLateral;
-      surface->slip2 = speed / force * params.slipComplianceLongitudinal;
-    }
-
     // Try to publish slip data for this wheel
+    auto link = linkSurface.first.lock();
     if (link)
     {
       msgs::Vector3d msg;
@@ -17,8 +17,6 @@
 
 #include <boost/pointer_cast.hpp>
 
-#include <ignition/common/Profiler.hh>
-
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 
@@ -29,12 +27,25 @@ using namespace gazebo;
 
 GZ_REGISTER_MODEL_PLUGIN(WheelTrackedVehiclePlugin)
 
+WheelTrackedVehiclePlugin::~WheelTrackedVehiclePlugin()
+{
+  if (!this->tireModel)
+    return;
+
+  for (const auto &trackWheels : this->wheels)
+  {
+    for (const auto &wheel : trackWheels.second)
+      this->tireModel->RemoveWheel(wheel->id);
+  }
+}
+
 void WheelTrackedVehiclePlugin::Load(physics::ModelPtr _model,
                                      sdf::ElementPtr _sdf)
 {
   TrackedVehiclePlugin::Load(_model, _sdf);
 
   this->world = _model->GetWorld();
+  this->tireModel = TireModel::Get(this->world);
 
   this->LoadParam(_sdf, "default_wheel_radius", this->defaultWheelRadius, 0.5);
 
@@ -143,6 +154,7 @@ void WheelTrackedVehiclePlugin::LoadWheel(physics::ModelPtr &_model,
   wheel->joint = joint;
   wheel->jointName = _jointName;
   wheel->radius = radius;
+  wheel->id = this->tireModel->AddWheel(joint, radius);
 
   wheels[_track].push_back(wheel);
 }
@@ -177,8 +189,9 @@ void WheelTrackedVehiclePlugin::Init()
   // SDF model)
   this->UpdateTrackSurface();
 
-  this->updateConnection = event::Events::ConnectWorldUpdateBegin(
-    std::bind(&WheelTrackedVehiclePlugin::OnUpdate, this));
+  // hold the wheels at the track velocities from the first step on
+  WheelTrackedVehiclePlugin::SetTrackVelocityImpl(
+    this->trackVelocity[Tracks::LEFT], this->trackVelocity[Tracks::RIGHT]);
 }
 
 void WheelTrackedVehiclePlugin::Reset()
@@ -193,38 +206,26 @@ void WheelTrackedVehiclePlugin::SetTrackVelocityImpl(double _left,
 
   this->trackVelocity[Tracks::LEFT] = _left;
   this->trackVelocity[Tracks::RIGHT] = _right;
-}
-
-void WheelTrackedVehiclePlugin::UpdateTrackSurface()
-{
-  std::lock_guard<std::mutex> lock(this->mutex);
 
-  for (auto trackPair : this->trackNames)
+  for (const auto &trackWheels : this->wheels)
   {
-    auto track(trackPair.first);
-    for (const auto &wheel : this->wheels[track])
-    {
-      auto wheelLink = wheel->joint->GetChild();
-      this->SetLinkMu(wheelLink);
-    }
+    const double speed = this->trackVelocity[trackWheels.first];
+    for (const auto &wheel : trackWheels.second)
+      this->tireModel->SetSpeed(wheel->id, speed);
   }
 }
 
-void WheelTrackedVehiclePlugin::OnUpdate()
+void WheelTrackedVehiclePlugin::UpdateTrackSurface()
 {
-  IGN_PROFILE("WheelTrackedVehiclePlugin::OnUpdate");
-  IGN_PROFILE_BEGIN("Update");
   std::lock_guard<std::mutex> lock(this->mutex);
 
   for (auto trackPair : this->trackNames)
   {
     auto track(trackPair.first);
-
     for (const auto &wheel : this->wheels[track])
     {
-      double angularVelocity = this->trackVelocity[track] / wheel->radius;
-      wheel->joint->SetVelocity(0, angularVelocity);
+      auto wheelLink = wheel->joint->GetChild();
+      this->SetLinkMu(wheelLink);
     }
   }
-  IGN_PROFILE_END();
 }
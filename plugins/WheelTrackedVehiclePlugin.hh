@@ -26,6 +26,7 @@
 
 #include "gazebo/physics/Joint.hh"
 
+#include "plugins/TireModel.hh"
 #include "plugins/TrackedVehiclePlugin.hh"
 
 namespace gazebo
@@ -51,7 +52,7 @@ namespace gazebo
   {
     public: WheelTrackedVehiclePlugin() = default;
 
-    public: virtual ~WheelTrackedVehiclePlugin() = default;
+    public: virtual ~WheelTrackedVehiclePlugin();
 
     /// \brief Called when the plugin is loaded
     /// \param[in] model Pointer to the model for which the plugin is loaded
@@ -96,6 +97,10 @@ namespace gazebo
       /// \brief Radius of the wheel (used to convert linear to angular speed).
       // cppcheck-suppress unusedStructMember
       double radius;
+
+      /// \brief Id of the wheel in the tire model.
+      // cppcheck-suppress unusedStructMember
+      int id = -1;
     };
 
     typedef std::shared_ptr<WheelInfo> WheelInfoPtr;
@@ -113,12 +118,11 @@ namespace gazebo
     /// \brief Pointer to the world the model lives in.
     protected: physics::WorldPtr world;
 
+    /// \brief Tire model that sets the wheel velocities every step.
+    protected: std::shared_ptr<TireModel> tireModel;
+
     /// \brief Mutex to protect updates
     protected: std::mutex mutex;
-
-    private: event::ConnectionPtr updateConnection;
-
-    private: void OnUpdate();
   };
 }
 
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/physics/FreezeRegistry.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/Subscriber.hh"
+#include "plugins/WorldPartitionPlugin.hh"
+
+/// \brief Private class for WorldPartitionPlugin
+class gazebo::WorldPartitionPluginPrivate
+{
+  /// \brief World pointer.
+  public: physics::WorldPtr world;
+
+  /// \brief Connection to World Update End events.
+  public: event::ConnectionPtr updateConnection;
+
+  /// \brief Transport node.
+  public: transport::NodePtr node;
+
+  /// \brief Publisher of the messages of this node.
+  public: transport::PublisherPtr stepPub;
+
+  /// \brief Subscriber to the messages of the other nodes.
+  public: transport::SubscriberPtr stepSub;
+
+  /// \brief Number of nodes.
+  public: unsigned int nodeCount = 1;
+
+  /// \brief Index of this node.
+  public: unsigned int nodeIndex = 0;
+
+  /// \brief Width of the strips.
+  public: double stripWidth = 100;
+
+  /// \brief Distance to a boundary below which models are shared.
+  public: double ghostMargin = 5;
+
+  /// \brief Wall time to wait for the other nodes, in seconds.
+  public: double syncTimeout = 5;
+
+  /// \brief Names of the top level models this node simulates.
+  public: std::set<std::string> owned;
+
+  /// \brief Names of the top level models already seen.
+  public: std::set<std::string> known;
+
+  /// \brief Number of models when the models were last checked.
+  public: unsigned int modelCount = 0;
+
+  /// \brief Message of this node, reused each iteration.
+  public: msgs::PartitionStep stepMsg;
+
+  /// \brief Messages received from the other nodes, by iteration. A node
+  /// can be one iteration ahead of this one.
+  public: std::map<uint64_t, std::vector<msgs::PartitionStep>> received;
+
+  /// \brief True once a synchronization timeout was reported.
+  public: bool timeoutReported = false;
+
+  /// \brief Protects received.
+  public: std::mutex mutex;
+
+  /// \brief Notified when a message is received.
+  public: std::condition_variable condition;
+};
+
+using namespace gazebo;
+
+GZ_REGISTER_WORLD_PLUGIN(WorldPartitionPlugin)
+
+/////////////////////////////////////////////////
+/// \brief Freeze or unfreeze a model owned by another node, keeping the
+/// other reasons to freeze it, see physics::FreezeRegistry.
+/// \param[in] _model The model.
+/// \param[in] _frozen True to freeze.
+static void SetFrozen(const physics::ModelPtr &_model, const bool _frozen)
+{
+  physics::FreezeRegistry &freezes = _model->GetWorld()->Freezes();
+  if (_frozen)
+    freezes.Freeze(_model, "world_partition");
+  else
+    freezes.Unfreeze(_model, "world_partition");
+}
+
+/////////////////////////////////////////////////
+WorldPartitionPlugin::WorldPartitionPlugin()
+  : dataPtr(new WorldPartitionPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+WorldPartitionPlugin::~WorldPartitionPlugin()
+{
+  this->dataPtr->updateConnection.reset();
+  this->dataPtr->stepSub.reset();
+  this->dataPtr->stepPub.reset();
+  if (this->dataPtr->node)
+    this->dataPtr->node->Fini();
+}
+
+/////////////////////////////////////////////////
+void WorldPartitionPlugin::Load(physics::WorldPtr _world,
+    sdf::ElementPtr _sdf)
+{
+  GZ_ASSERT(_world, "WorldPartitionPlugin world pointer is NULL");
+  GZ_ASSERT(_sdf, "WorldPartitionPlugin sdf pointer is NULL");
+  this->dataPtr->world = _world;
+
+  if (_sdf->HasElement("node_count"))
+  {
+    this->dataPtr->nodeCount =
+        std::max(1u, _sdf->Get<unsigned int>("node_count"));
+  }
+
+  if (_sdf->HasElement("node_index"))
+    this->dataPtr->nodeIndex = _sdf->Get<unsigned int>("node_index");
+
+  const char *nodeEnv = std::getenv("GAZEBO_PARTITION_NODE");
+  if (nodeEnv)
+  {
+    try
+    {
+      this->dataPtr->nodeIndex = std::stoul(nodeEnv);
+    }
+    catch(...)
+    {
+      gzerr << "WorldPartitionPlugin: invalid GAZEBO_PARTITION_NODE ["
+            << nodeEnv << "]" << std::endl;
+    }
+  }
+
+  if (this->dataPtr->nodeIndex >= this->dataPtr->nodeCount)
+  {
+    gzerr << "WorldPartitionPlugin: node index [" << this->dataPtr->nodeIndex
+          << "] is not below the node count [" << this->dataPtr->nodeCount
+          << "], the world is not partitioned" << std::endl;
+    return;
+  }
+
+  if (_sdf->HasElement("strip_width"))
+  {
+    const double width = _sdf->Get<double>("strip_width");
+    if (width > 0)
+      this->dataPtr->stripWidth = width;
+    else
+      gzerr << "WorldPartitionPlugin: nonpositive <strip_width>" << std::endl;
+  }
+
+  if (_sdf->HasElement("ghost_margin"))
+  {
+    this->dataPtr->ghostMargin =
+        std::max(0.0, _sdf->Get<double>("ghost_margin"));
+  }
+
+  if (_sdf->HasElement("sync_timeout"))
+  {
+    this->dataPtr->syncTimeout =
+        std::max(0.0, _sdf->Get<double>("sync_timeout"));
+  }
+
+  if (this->dataPtr->nodeCount == 1)
+  {
+    gzwarn << "WorldPartitionPlugin: a single node, the world is not "
+           << "partitioned" << std::endl;
+    return;
+  }
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(_world->Name());
+  this->dataPtr->stepPub = this->dataPtr->node->Advertise<msgs::PartitionStep>(
+      "~/partition/step");
+  this->dataPtr->stepSub = this->dataPtr->node->Subscribe("~/partition/step",
+      &WorldPartitionPlugin::OnStep, this);
+
+  this->UpdateModels();
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateEnd(
+      std::bind(&WorldPartitionPlugin::OnUpdateEnd, this));
+
+  gzmsg << "WorldPartitionPlugin: node [" << this->dataPtr->nodeIndex
+        << "] of [" << this->dataPtr->nodeCount << "] owns ["
+        << this->dataPtr->owned.size() << "] models" << std::endl;
+}
+
+/////////////////////////////////////////////////
+unsigned int WorldPartitionPlugin::Owner(const double _x) const
+{
+  const int64_t strip = static_cast<int64_t>(
+      std::floor(_x / this->dataPtr->stripWidth));
+  const int64_t count = this->dataPtr->nodeCount;
+  return static_cast<unsigned int>(((strip % count) + count) % count);
+}
+
+/////////////////////////////////////////////////
+bool WorldPartitionPlugin::Owns(const std::string &_name) const
+{
+  return this->dataPtr->owned.count(_name) > 0;
+}
+
+/////////////////////////////////////////////////
+void WorldPartitionPlugin::UpdateModels()
+{
+  const unsigned int modelCount = this->dataPtr->world->ModelCount();
+  if (modelCount == this->dataPtr->modelCount)
+    return;
+  this->dataPtr->modelCount = modelCount;
+
+  for (auto const &model : this->dataPtr->world->Models())
+  {
+    if (model->IsStatic() || this->dataPtr->known.count(model->GetName()))
+      continue;
+    this->dataPtr->known.insert(model->GetName());
+
+    if (this->Owner(model->WorldPose().Pos().X()) == this->dataPtr->nodeIndex)
+      this->dataPtr->owned.insert(model->GetName());
+    else
+      SetFrozen(model, true);
+  }
+}
+
+/////////////////////////////////////////////////
+void WorldPartitionPlugin::OnStep(ConstPartitionStepPtr &_msg)
+{
+  if (_msg->node() == this->dataPtr->nodeIndex ||
+      _msg->node() >= this->dataPtr->nodeCount)
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->received[_msg->iteration()].push_back(*_msg);
+  }
+  this->dataPtr->condition.notify_all();
+}
+
+/////////////////////////////////////////////////
+bool WorldPartitionPlugin::WaitForNodes(const uint64_t _iteration)
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->condition.wait_for(lock,
+      std::chrono::duration<double>(this->dataPtr->syncTimeout),
+      [&]
+      {
+        auto iter = this->dataPtr->received.find(_iteration);
+        return iter != this->dataPtr->received.end() &&
+            iter->second.size() + 1 >= this->dataPtr->nodeCount;
+      });
+}
+
+/////////////////////////////////////////////////
+void WorldPartitionPlugin::OnUpdateEnd()
+{
+  this->UpdateModels();
+
+  const physics::WorldPtr &world = this->dataPtr->world;
+  const uint64_t iteration = world->Iterations();
+  const double width = this->dataPtr->stripWidth;
+
+  // Share the models near the boundaries, and hand over the models which
+  // left the strips of this node
+  msgs::PartitionStep &stepMsg = this->dataPtr->stepMsg;
+  stepMsg.Clear();
+  stepMsg.set_node(this->dataPtr->nodeIndex);
+  stepMsg.set_iteration(iteration);
+
+  for (auto iter = this->dataPtr->owned.begin();
+       iter != this->dataPtr->owned.end();)
+  {
+    physics::ModelPtr model = world->ModelByName(*iter);
+    if (!model)
+    {
+      this->dataPtr->known.erase(*iter);
+      iter = this->dataPtr->owned.erase(iter);
+      continue;
+    }
+
+    const ignition::math::Pose3d pose = model->WorldPose();
+    const double x = pose.Pos().X();
+    const double strip = std::floor(x / width);
+    const bool migrate = this->Owner(x) != this->dataPtr->nodeIndex;
+    const double distance = std::min(x - strip * width,
+        (strip + 1) * width - x);
+
+    if (migrate || distance < this->dataPtr->ghostMargin)
+    {
+      msgs::PartitionStep::Model *modelMsg = stepMsg.add_model();
+      modelMsg->set_name(*iter);
+      msgs::Set(modelMsg->mutable_pose(), pose);
+      msgs::Set(modelMsg->mutable_linear_velocity(), model->WorldLinearVel());
+      msgs::Set(modelMsg->mutable_angular_velocity(),
+          model->WorldAngularVel());
+      modelMsg->set_migrate(migrate);
+    }
+
+    if (migrate)
+    {
+      SetFrozen(model, true);
+      iter = this->dataPtr->owned.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  this->dataPtr->stepPub->Publish(stepMsg, true);
+
+  // Deterministic barrier: every node has finished this iteration before
+  // any node steps the next one
+  if (!this->WaitForNodes(iteration) && !this->dataPtr->timeoutReported)
+  {
+    gzwarn << "WorldPartitionPlugin: timed out waiting for the other nodes "
+           << "at iteration [" << iteration << "], stepping anyway"
+           << std::endl;
+    this->dataPtr->timeoutReported = true;
+  }
+
+  std::vector<msgs::PartitionStep> steps;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto iter = this->dataPtr->received.find(iteration);
+    if (iter != this->dataPtr->received.end())
+      steps.swap(iter->second);
+    this->dataPtr->received.erase(this->dataPtr->received.begin(),
+        this->dataPtr->received.upper_bound(iteration));
+  }
+
+  // Move the ghosts, and take over the models handed to this node
+  for (auto const &step : steps)
+  {
+    for (auto const &modelMsg : step.model())
+    {
+      physics::ModelPtr model = world->ModelByName(modelMsg.name());
+      if (!model || this->Owns(modelMsg.name()))
+        continue;
+
+      const ignition::math::Pose3d pose = msgs::ConvertIgn(modelMsg.pose());
+      model->SetWorldPose(pose);
+
+      if (modelMsg.migrate() &&
+          this->Owner(pose.Pos().X()) == this->dataPtr->nodeIndex)
+      {
+        SetFrozen(model, false);
+        model->SetLinearVel(msgs::ConvertIgn(modelMsg.linear_velocity()));
+        model->SetAngularVel(msgs::ConvertIgn(modelMsg.angular_velocity()));
+        this->dataPtr->owned.insert(modelMsg.name());
+      }
+    }
+  }
+}
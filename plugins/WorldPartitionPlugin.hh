@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_WORLDPARTITIONPLUGIN_HH_
+#define GAZEBO_PLUGINS_WORLDPARTITIONPLUGIN_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <sdf/sdf.hh>
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  // Forward declaration
+  class WorldPartitionPluginPrivate;
+
+  /// \brief World plugin that splits the simulation of a world across
+  /// several gzserver processes, the nodes.
+  ///
+  /// Every node loads the same world and connects to the same master. The
+  /// world is cut along x into strips of equal width, assigned to the nodes
+  /// in turn. A node simulates the dynamic top level models it owns, which
+  /// start as the models whose origin is in its strips, and freezes the
+  /// others with the "world_partition" reason, see physics::FreezeRegistry.
+  ///
+  /// After each iteration, every node publishes on ~/partition/step the
+  /// pose and velocity of its models within the ghost margin of a strip
+  /// boundary, then waits for the message of every other node for the same
+  /// iteration before stepping again. The frozen copies of those models,
+  /// the ghosts, are moved to the received poses so that they collide with
+  /// the owned models. A model whose origin leaves the strips of its owner
+  /// is handed over to the owner of its new strip, with its velocity.
+  ///
+  /// Nodes should be started paused, and run with ~/world_control, which
+  /// every node receives. A node that misses the synchronization timeout
+  /// steps anyway and prints a warning. Joints between top level models,
+  /// and activity zones, are not supported.
+  ///
+  /// Example:
+  /// \verbatim
+  ///   <plugin name="partition" filename="libWorldPartitionPlugin.so">
+  ///     <!-- Number of nodes -->
+  ///     <node_count>2</node_count>
+  ///     <!-- Index of this node, overridden by the GAZEBO_PARTITION_NODE
+  ///          environment variable so that every node can load the same
+  ///          world file -->
+  ///     <node_index>0</node_index>
+  ///     <!-- Width of the strips, in meters -->
+  ///     <strip_width>100</strip_width>
+  ///     <!-- Distance to a boundary below which models are shared -->
+  ///     <ghost_margin>5</ghost_margin>
+  ///     <!-- Wall time to wait for the other nodes, in seconds -->
+  ///     <sync_timeout>5</sync_timeout>
+  ///   </plugin>
+  /// \endverbatim
+  class GZ_PLUGIN_VISIBLE WorldPartitionPlugin : public WorldPlugin
+  {
+    /// \brief Constructor.
+    public: WorldPartitionPlugin();
+
+    /// \brief Destructor.
+    public: virtual ~WorldPartitionPlugin();
+
+    // Documentation inherited
+    public: virtual void Load(physics::WorldPtr _world, sdf::ElementPtr _sdf);
+
+    /// \brief Get the node that owns a position.
+    /// \param[in] _x X coordinate in the world frame.
+    /// \return Index of the node.
+    public: unsigned int Owner(const double _x) const;
+
+    /// \brief Get whether this node simulates a model.
+    /// \param[in] _name Name of a top level model.
+    /// \return True if the model is owned by this node.
+    public: bool Owns(const std::string &_name) const;
+
+    /// \brief Callback for World Update End events. Publishes the states
+    /// of the models near the boundaries and waits for the other nodes.
+    private: void OnUpdateEnd();
+
+    /// \brief Callback for messages of the other nodes.
+    /// \param[in] _msg The message.
+    private: void OnStep(ConstPartitionStepPtr &_msg);
+
+    /// \brief Take the new models of the world, or freeze them.
+    private: void UpdateModels();
+
+    /// \brief Wait for the messages of every other node for an iteration.
+    /// \param[in] _iteration The iteration.
+    /// \return False on timeout.
+    private: bool WaitForNodes(const uint64_t _iteration);
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<WorldPartitionPluginPrivate> dataPtr;
+  };
+}
+#endif
@@ -23,8 +23,10 @@ using namespace gazebo;
 
 ////////////////////////////////////////////////////////////////////////////////
 InRegionEventSource::InRegionEventSource(transport::PublisherPtr _pub,
-    physics::WorldPtr _world, const std::map<std::string, RegionPtr> &_regions)
-  : EventSource(_pub, "region", _world), regions(_regions), isInside(false)
+    physics::WorldPtr _world, const std::map<std::string, RegionPtr> &_regions,
+    RegionIndexPtr _index)
+  : EventSource(_pub, "region", _world), regions(_regions), index(_index),
+    isInside(false)
 {
 }
 
@@ -63,6 +65,7 @@ void InRegionEventSource::Init()
   if (it != this->regions.end())
   {
     this->region = it->second;
+    this->regionId = this->index->RegionId(this->regionName);
   }
   else
   {
@@ -106,9 +109,12 @@ void InRegionEventSource::Update()
   if (!this->region)
     return;
 
-  ignition::math::Vector3d point = this->model->WorldPose().Pos();
+  // nothing changed since the last check
+  if (!this->index->Update())
+    return;
+
   bool oldState = this->isInside;
-  bool currentState = this->region->Contains(point);
+  bool currentState = this->index->Contains(this->model, this->regionId);
 
   if (oldState != currentState)
   {
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "plugins/events/Region.hh"
+#include "plugins/events/RegionIndex.hh"
 #include "plugins/events/EventSource.hh"
 
 namespace gazebo
@@ -34,9 +35,11 @@ namespace gazebo
     /// \param[in] _pub the publisher for the SimEvents
     /// \param[in] _world Pointer to the world.
     /// \param[in] _regions dictionary of regions in the world
+    /// \param[in] _index Index of the regions, shared by the event sources
     public: InRegionEventSource(transport::PublisherPtr _pub,
                 physics::WorldPtr _world,
-                const std::map<std::string, RegionPtr> &_regions);
+                const std::map<std::string, RegionPtr> &_regions,
+                RegionIndexPtr _index);
 
     /// \brief Initialize the event
     public: virtual void Init();
@@ -68,9 +71,15 @@ namespace gazebo
     /// \brief The region pointer
     private: RegionPtr region;
 
+    /// \brief Id of the region in the region index
+    private: int regionId = -1;
+
     /// \brief A map of region names to region pointers.
     private: const std::map<std::string, RegionPtr> &regions;
 
+    /// \brief Index of the regions
+    private: RegionIndexPtr index;
+
     /// \brief true if the model is currently inside the region
     private: bool isInside;
   };
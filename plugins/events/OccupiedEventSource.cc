@@ -34,8 +34,9 @@ using namespace gazebo;
 
 ////////////////////////////////////////////////////////////////////////////////
 OccupiedEventSource::OccupiedEventSource(transport::PublisherPtr _pub,
-    physics::WorldPtr _world, const std::map<std::string, RegionPtr> &_regions)
-  : EventSource(_pub, "occupied", _world), regions(_regions)
+    physics::WorldPtr _world, const std::map<std::string, RegionPtr> &_regions,
+    RegionIndexPtr _index)
+  : EventSource(_pub, "occupied", _world), regions(_regions), index(_index)
 {
 }
 
@@ -93,6 +94,7 @@ void OccupiedEventSource::Load(const sdf::ElementPtr _sdf)
     this->msgPub = this->node->Advertise<gazebo::msgs::GzString>(topic);
 
     this->msg.set_data(data);
+    this->regionId = this->index->RegionId(this->regionName);
 
     // Connect to the update event.
     this->updateConnection = event::Events::ConnectWorldUpdateBegin(
@@ -103,21 +105,11 @@ void OccupiedEventSource::Load(const sdf::ElementPtr _sdf)
 /////////////////////////////////////////////////
 void OccupiedEventSource::Update()
 {
-  // Get all the models.
-  physics::Model_V models = this->world->Models();
+  if (!this->index->Update())
+    return;
 
-  // Process each model.
-  for (physics::Model_V::iterator iter = models.begin();
-       iter != models.end(); ++iter)
-  {
-    // Skip models that are static
-    if ((*iter)->IsStatic())
-      continue;
-
-    // If inside, then transmit the desired message.
-    if (this->regions[this->regionName]->Contains((*iter)->WorldPose().Pos()))
-    {
-      this->msgPub->Publish(this->msg);
-    }
-  }
+  // Transmit the desired message once for each non-static model inside.
+  const unsigned int count = this->index->Occupancy(this->regionId);
+  for (unsigned int i = 0; i < count; ++i)
+    this->msgPub->Publish(this->msg);
 }
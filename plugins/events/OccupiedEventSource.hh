@@ -29,6 +29,7 @@
 #include <gazebo/util/system.hh>
 
 #include "Region.hh"
+#include "RegionIndex.hh"
 #include "EventSource.hh"
 
 namespace gazebo
@@ -60,7 +61,8 @@ namespace gazebo
     // Documentation inherited
     public: OccupiedEventSource(transport::PublisherPtr _pub,
                 physics::WorldPtr _world,
-                const std::map<std::string, RegionPtr> &_regions);
+                const std::map<std::string, RegionPtr> &_regions,
+                RegionIndexPtr _index);
 
     /// \brief Destructor.
     public: ~OccupiedEventSource() = default;
@@ -91,6 +93,12 @@ namespace gazebo
 
     /// \brief The region used for the in region check.
     private: std::string regionName;
+
+    /// \brief Index of the regions.
+    private: RegionIndexPtr index;
+
+    /// \brief Id of the region in the region index.
+    private: int regionId = -1;
   };
 }
 #endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <gazebo/physics/Model.hh>
+#include <gazebo/physics/World.hh>
+
+#include "plugins/events/RegionIndex.hh"
+
+using namespace gazebo;
+
+/// \brief Boxes overlapping more grid cells are checked for every point.
+static const double MAX_BOX_CELLS = 4096;
+
+/// \brief Cell indices are clamped to this magnitude, so that keys of
+/// huge or infinite coordinates stay defined.
+static const double MAX_CELL_INDEX = 1e6;
+
+/////////////////////////////////////////////////
+/// \brief Check if two positions are exactly the same.
+/// \param[in] _a First position.
+/// \param[in] _b Second position.
+/// \return True if all the coordinates are equal.
+static bool SamePosition(const ignition::math::Vector3d &_a,
+    const ignition::math::Vector3d &_b)
+{
+  return _a.X() == _b.X() && _a.Y() == _b.Y() && _a.Z() == _b.Z();
+}
+
+/////////////////////////////////////////////////
+RegionIndex::RegionIndex(physics::WorldPtr _world,
+    const std::map<std::string, RegionPtr> &_regions)
+  : world(_world)
+{
+  // Size the cells after the boxes, so that most boxes overlap a few cells
+  double size = 0;
+  unsigned int boxCount = 0;
+  for (auto const &region : _regions)
+  {
+    for (auto const &box : region.second->boxes)
+    {
+      size += std::max(box.XLength(), std::max(box.YLength(), box.ZLength()));
+      ++boxCount;
+    }
+  }
+  if (boxCount > 0 && std::isfinite(size) && size > 0)
+    this->cellSize = std::max(size / boxCount, 0.01);
+
+  for (auto const &region : _regions)
+  {
+    const int id = static_cast<int>(this->regions.size());
+    this->regions.push_back(region.second);
+    this->regionIds[region.first] = id;
+
+    for (auto const &box : region.second->boxes)
+    {
+      const int64_t minX = this->CellIndex(box.Min().X());
+      const int64_t minY = this->CellIndex(box.Min().Y());
+      const int64_t minZ = this->CellIndex(box.Min().Z());
+      const int64_t maxX = this->CellIndex(box.Max().X());
+      const int64_t maxY = this->CellIndex(box.Max().Y());
+      const int64_t maxZ = this->CellIndex(box.Max().Z());
+
+      const double count = static_cast<double>(maxX - minX + 1) *
+        (maxY - minY + 1) * (maxZ - minZ + 1);
+      if (count > MAX_BOX_CELLS)
+      {
+        if (this->largeRegions.empty() || this->largeRegions.back() != id)
+          this->largeRegions.push_back(id);
+        continue;
+      }
+
+      for (int64_t x = minX; x <= maxX; ++x)
+      {
+        for (int64_t y = minY; y <= maxY; ++y)
+        {
+          for (int64_t z = minZ; z <= maxZ; ++z)
+          {
+            std::vector<int> &cell = this->cells[CellKey(x, y, z)];
+            if (cell.empty() || cell.back() != id)
+              cell.push_back(id);
+          }
+        }
+      }
+    }
+  }
+
+  this->occupancy.resize(this->regions.size(), 0);
+}
+
+/////////////////////////////////////////////////
+void RegionIndex::SetUpdateRate(const double _rate)
+{
+  if (_rate > 0)
+    this->updatePeriod = common::Time(1.0 / _rate);
+  else
+    this->updatePeriod = common::Time::Zero;
+}
+
+/////////////////////////////////////////////////
+int RegionIndex::RegionId(const std::string &_name) const
+{
+  auto it = this->regionIds.find(_name);
+  if (it == this->regionIds.end())
+    return -1;
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+bool RegionIndex::Update()
+{
+  // The first event source to call this during a world update does the
+  // work for all of them.
+  const uint64_t iterations = this->world->Iterations();
+  if (iterations == this->lastIterations)
+    return this->updated;
+  this->lastIterations = iterations;
+
+  // Check right away when the time went back, e.g. after a world reset
+  const common::Time simTime = this->world->SimTime();
+  if (this->updateCount > 0 && simTime >= this->lastUpdateTime &&
+      simTime - this->lastUpdateTime < this->updatePeriod)
+  {
+    this->updated = false;
+    return false;
+  }
+  this->lastUpdateTime = simTime;
+  this->updated = true;
+  ++this->updateCount;
+
+  std::vector<int> current;
+  for (auto const &model : this->world->Models())
+  {
+    auto inserted = this->models.emplace(model->GetId(), ModelRegions());
+    ModelRegions &state = inserted.first->second;
+    state.seen = this->updateCount;
+
+    // Only the models that moved can enter or leave a region
+    const ignition::math::Vector3d pos = model->WorldPose().Pos();
+    const bool isStatic = model->IsStatic();
+    if (!inserted.second && isStatic == state.isStatic &&
+        SamePosition(pos, state.pos))
+    {
+      continue;
+    }
+
+    this->RegionsAt(pos, current);
+    if (!state.isStatic)
+    {
+      for (auto const region : state.regions)
+        --this->occupancy[region];
+    }
+    if (!isStatic)
+    {
+      for (auto const region : current)
+        ++this->occupancy[region];
+    }
+    state.regions.swap(current);
+    state.pos = pos;
+    state.isStatic = isStatic;
+  }
+
+  // Forget the models that were removed from the world
+  for (auto it = this->models.begin(); it != this->models.end();)
+  {
+    if (it->second.seen == this->updateCount)
+    {
+      ++it;
+      continue;
+    }
+    if (!it->second.isStatic)
+    {
+      for (auto const region : it->second.regions)
+        --this->occupancy[region];
+    }
+    it = this->models.erase(it);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool RegionIndex::Contains(const physics::ModelPtr &_model,
+    const int _region) const
+{
+  if (!_model || _region < 0)
+    return false;
+
+  auto it = this->models.find(_model->GetId());
+  if (it == this->models.end())
+    return false;
+
+  return std::binary_search(it->second.regions.begin(),
+      it->second.regions.end(), _region);
+}
+
+/////////////////////////////////////////////////
+unsigned int RegionIndex::Occupancy(const int _region) const
+{
+  if (_region < 0 || _region >= static_cast<int>(this->occupancy.size()))
+    return 0;
+  return this->occupancy[_region];
+}
+
+/////////////////////////////////////////////////
+void RegionIndex::RegionsAt(const ignition::math::Vector3d &_p,
+    std::vector<int> &_regions) const
+{
+  _regions.clear();
+
+  auto cell = this->cells.find(CellKey(this->CellIndex(_p.X()),
+        this->CellIndex(_p.Y()), this->CellIndex(_p.Z())));
+  if (cell != this->cells.end())
+  {
+    for (auto const region : cell->second)
+    {
+      if (this->regions[region]->Contains(_p))
+        _regions.push_back(region);
+    }
+  }
+
+  for (auto const region : this->largeRegions)
+  {
+    if (this->regions[region]->Contains(_p))
+      _regions.push_back(region);
+  }
+
+  // A region can have boxes both in the grid and in the large list
+  std::sort(_regions.begin(), _regions.end());
+  _regions.erase(std::unique(_regions.begin(), _regions.end()),
+      _regions.end());
+}
+
+/////////////////////////////////////////////////
+int64_t RegionIndex::CellKey(const int64_t _x, const int64_t _y,
+    const int64_t _z)
+{
+  // Distant cells may share a key, which only adds candidates that the
+  // exact check rejects.
+  const uint64_t mask = (1u << 21) - 1;
+  return static_cast<int64_t>(
+      ((static_cast<uint64_t>(_x) & mask) << 42) |
+      ((static_cast<uint64_t>(_y) & mask) << 21) |
+      (static_cast<uint64_t>(_z) & mask));
+}
+
+/////////////////////////////////////////////////
+int64_t RegionIndex::CellIndex(const double _v) const
+{
+  const double index = std::floor(_v / this->cellSize);
+  if (!(index > -MAX_CELL_INDEX))
+    return static_cast<int64_t>(-MAX_CELL_INDEX);
+  if (index > MAX_CELL_INDEX)
+    return static_cast<int64_t>(MAX_CELL_INDEX);
+  return static_cast<int64_t>(index);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_EVENTS_REGIONINDEX_HH_
+#define GAZEBO_PLUGINS_EVENTS_REGIONINDEX_HH_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+#include "plugins/events/Region.hh"
+
+namespace gazebo
+{
+  /// \brief A uniform grid over the boxes of the regions of a SimEvents
+  /// plugin, and the regions each model of the world is in.
+  ///
+  /// The event sources that check models against regions share one index.
+  /// It is refreshed at most once per world update, or at the rate set with
+  /// SetUpdateRate, and only the models that moved since the last refresh
+  /// are checked against the regions near them.
+  class RegionIndex
+  {
+    /// \brief Constructor.
+    /// \param[in] _world The world of the models.
+    /// \param[in] _regions The regions, by name.
+    public: RegionIndex(physics::WorldPtr _world,
+                        const std::map<std::string, RegionPtr> &_regions);
+
+    /// \brief Set how often the models are checked against the regions.
+    /// \param[in] _rate Checks per second of simulation time, or 0 to
+    /// check on every world update.
+    public: void SetUpdateRate(const double _rate);
+
+    /// \brief Get the id of a region, to check models against.
+    /// \param[in] _name Name of the region.
+    /// \return Id of the region, or -1 if there's no such region.
+    public: int RegionId(const std::string &_name) const;
+
+    /// \brief Check the models that moved against the regions, unless
+    /// they were already checked during this world update or the update
+    /// period has not passed. Event sources call this from their world
+    /// update callbacks.
+    /// \return True if the models were checked during this world update.
+    public: bool Update();
+
+    /// \brief Check if a model was in a region at the last update.
+    /// \param[in] _model The model.
+    /// \param[in] _region Id of the region.
+    /// \return True if the origin of the model is in the region.
+    public: bool Contains(const physics::ModelPtr &_model,
+                          const int _region) const;
+
+    /// \brief Get the number of non-static models in a region at the last
+    /// update.
+    /// \param[in] _region Id of the region.
+    /// \return Number of models.
+    public: unsigned int Occupancy(const int _region) const;
+
+    /// \brief Get the regions a point is in.
+    /// \param[in] _p The point.
+    /// \param[out] _regions Sorted ids of the regions.
+    public: void RegionsAt(const ignition::math::Vector3d &_p,
+                           std::vector<int> &_regions) const;
+
+    /// \brief Get the key of a grid cell.
+    /// \param[in] _x Cell index along x.
+    /// \param[in] _y Cell index along y.
+    /// \param[in] _z Cell index along z.
+    /// \return Key of the cell.
+    private: static int64_t CellKey(const int64_t _x, const int64_t _y,
+                                    const int64_t _z);
+
+    /// \brief Get the index of the cell containing a coordinate.
+    /// \param[in] _v The coordinate.
+    /// \return Cell index.
+    private: int64_t CellIndex(const double _v) const;
+
+    /// \brief The region state of a model.
+    private: class ModelRegions
+    {
+      /// \brief Position of the model at the last check.
+      public: ignition::math::Vector3d pos;
+
+      /// \brief Sorted ids of the regions the model is in.
+      public: std::vector<int> regions;
+
+      /// \brief True if the model is static.
+      public: bool isStatic = false;
+
+      /// \brief Update counter when the model was last seen.
+      public: uint64_t seen = 0;
+    };
+
+    /// \brief The world of the models.
+    private: physics::WorldPtr world;
+
+    /// \brief The regions, by id.
+    private: std::vector<RegionPtr> regions;
+
+    /// \brief Ids of the regions, by name.
+    private: std::map<std::string, int> regionIds;
+
+    /// \brief Edge length of the grid cells.
+    private: double cellSize = 1.0;
+
+    /// \brief Ids of the regions with a box overlapping each cell, by
+    /// cell key.
+    private: std::unordered_map<int64_t, std::vector<int>> cells;
+
+    /// \brief Ids of the regions with boxes too large to add to the grid,
+    /// checked for every point.
+    private: std::vector<int> largeRegions;
+
+    /// \brief The region state of each model, by model id.
+    private: std::unordered_map<uint32_t, ModelRegions> models;
+
+    /// \brief Number of non-static models in each region.
+    private: std::vector<unsigned int> occupancy;
+
+    /// \brief Update period, 0 to check on every world update.
+    private: common::Time updatePeriod;
+
+    /// \brief Simulation time of the last check.
+    private: common::Time lastUpdateTime;
+
+    /// \brief World iterations at the last call to Update.
+    private: uint64_t lastIterations = UINT64_MAX;
+
+    /// \brief Result of the last call to Update.
+    private: bool updated = false;
+
+    /// \brief Number of checks so far.
+    private: uint64_t updateCount = 0;
+  };
+
+  /// \def RegionIndexPtr
+  /// \brief Shared pointer to a region index
+  typedef std::shared_ptr<RegionIndex> RegionIndexPtr;
+}
+#endif
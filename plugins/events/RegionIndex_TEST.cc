@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/test/ServerFixture.hh"
+#include "plugins/events/RegionIndex.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class RegionIndexTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Add a region made of boxes.
+/// \param[in,out] _regions The regions, by name.
+/// \param[in] _name Name of the region.
+/// \param[in] _boxes Boxes of the region.
+void AddRegion(std::map<std::string, RegionPtr> &_regions,
+    const std::string &_name,
+    const std::vector<ignition::math::AxisAlignedBox> &_boxes)
+{
+  RegionPtr region(new Region);
+  region->name = _name;
+  region->boxes = _boxes;
+  _regions[_name] = region;
+}
+
+/////////////////////////////////////////////////
+// The grid gives the same regions as checking every region
+TEST_F(RegionIndexTest, RegionsAt)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  std::map<std::string, RegionPtr> regions;
+  AddRegion(regions, "small", {
+      ignition::math::AxisAlignedBox(0, 0, 0, 1, 1, 1)});
+  AddRegion(regions, "two_boxes", {
+      ignition::math::AxisAlignedBox(-3, -3, 0, -1, -1, 2),
+      ignition::math::AxisAlignedBox(0.5, 0.5, 0.5, 2.5, 2.5, 1.5)});
+  AddRegion(regions, "huge", {
+      ignition::math::AxisAlignedBox(-1e4, -1e4, -1, 1e4, 1e4, 0.25)});
+  AddRegion(regions, "negative", {
+      ignition::math::AxisAlignedBox(-4.5, 1, -2, -2, 4, 0)});
+
+  // Many small boxes keep the cells small enough for the huge box to be
+  // checked outside the grid
+  std::vector<ignition::math::AxisAlignedBox> tiles;
+  for (int x = -5; x < 5; ++x)
+  {
+    for (int y = -5; y < 5; ++y)
+    {
+      tiles.push_back(
+          ignition::math::AxisAlignedBox(x, y, -2.5, x + 0.5, y + 0.5, -2));
+    }
+  }
+  AddRegion(regions, "tiles", tiles);
+
+  RegionIndex index(world, regions);
+  for (auto const &region : regions)
+    EXPECT_GE(index.RegionId(region.first), 0);
+  EXPECT_EQ(-1, index.RegionId("missing"));
+
+  ignition::math::Rand::Seed(42);
+  std::vector<int> found;
+  for (int i = 0; i < 10000; ++i)
+  {
+    const ignition::math::Vector3d p(
+        ignition::math::Rand::DblUniform(-6, 6),
+        ignition::math::Rand::DblUniform(-6, 6),
+        ignition::math::Rand::DblUniform(-3, 3));
+
+    std::vector<int> expected;
+    for (auto const &region : regions)
+    {
+      if (region.second->Contains(p))
+        expected.push_back(index.RegionId(region.first));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    index.RegionsAt(p, found);
+    EXPECT_EQ(expected, found) << p;
+  }
+
+  // Points on the edges of the boxes
+  index.RegionsAt(ignition::math::Vector3d(1, 1, 1), found);
+  EXPECT_EQ(std::vector<int>({index.RegionId("small"),
+        index.RegionId("two_boxes")}), found);
+  index.RegionsAt(ignition::math::Vector3d(1e4, 0, 0), found);
+  EXPECT_EQ(std::vector<int>({index.RegionId("huge")}), found);
+}
+
+/////////////////////////////////////////////////
+// Models moving and being removed update the regions
+TEST_F(RegionIndexTest, Update)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  world->SetGravity(ignition::math::Vector3d::Zero);
+
+  std::map<std::string, RegionPtr> regions;
+  AddRegion(regions, "a", {
+      ignition::math::AxisAlignedBox(-1, -1, 4, 1, 1, 6)});
+  AddRegion(regions, "b", {
+      ignition::math::AxisAlignedBox(9, -1, 4, 11, 1, 6)});
+
+  RegionIndex index(world, regions);
+  const int a = index.RegionId("a");
+  const int b = index.RegionId("b");
+
+  SpawnBox("box1", ignition::math::Vector3d(0.1, 0.1, 0.1),
+      ignition::math::Vector3d(0, 0, 5));
+  SpawnBox("box2", ignition::math::Vector3d(0.1, 0.1, 0.1),
+      ignition::math::Vector3d(0, 0.5, 5));
+  SpawnBox("wall", ignition::math::Vector3d(0.1, 0.1, 0.1),
+      ignition::math::Vector3d(10, 0, 5), ignition::math::Vector3d::Zero,
+      true);
+  physics::ModelPtr box1 = world->ModelByName("box1");
+  physics::ModelPtr box2 = world->ModelByName("box2");
+  physics::ModelPtr wall = world->ModelByName("wall");
+  ASSERT_TRUE(box1 != NULL);
+  ASSERT_TRUE(box2 != NULL);
+  ASSERT_TRUE(wall != NULL);
+
+  world->Step(1);
+  EXPECT_TRUE(index.Update());
+  EXPECT_TRUE(index.Contains(box1, a));
+  EXPECT_TRUE(index.Contains(box2, a));
+  EXPECT_FALSE(index.Contains(box1, b));
+  EXPECT_TRUE(index.Contains(wall, b));
+  EXPECT_EQ(2u, index.Occupancy(a));
+  // Static models don't occupy a region
+  EXPECT_EQ(0u, index.Occupancy(b));
+
+  // Only the first call during a world update checks the models
+  box1->SetWorldPose(ignition::math::Pose3d(10, 0, 5, 0, 0, 0));
+  EXPECT_TRUE(index.Update());
+  EXPECT_TRUE(index.Contains(box1, a));
+
+  world->Step(1);
+  EXPECT_TRUE(index.Update());
+  EXPECT_FALSE(index.Contains(box1, a));
+  EXPECT_TRUE(index.Contains(box1, b));
+  EXPECT_EQ(1u, index.Occupancy(a));
+  EXPECT_EQ(1u, index.Occupancy(b));
+
+  // A removed model leaves its regions
+  world->RemoveModel("box2");
+  world->Step(1);
+  EXPECT_TRUE(index.Update());
+  EXPECT_EQ(0u, index.Occupancy(a));
+  EXPECT_FALSE(index.Contains(box2, a));
+
+  // Invalid regions
+  EXPECT_EQ(0u, index.Occupancy(-1));
+  EXPECT_EQ(0u, index.Occupancy(100));
+  EXPECT_FALSE(index.Contains(box1, -1));
+  EXPECT_FALSE(index.Contains(physics::ModelPtr(), a));
+}
+
+/////////////////////////////////////////////////
+// The models are only checked at the update rate
+TEST_F(RegionIndexTest, UpdateRate)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  world->SetGravity(ignition::math::Vector3d::Zero);
+  const double dt = world->Physics()->GetMaxStepSize();
+  ASSERT_GT(dt, 0.0);
+
+  std::map<std::string, RegionPtr> regions;
+  AddRegion(regions, "a", {
+      ignition::math::AxisAlignedBox(-1, -1, 4, 1, 1, 6)});
+
+  RegionIndex index(world, regions);
+  index.SetUpdateRate(10);
+  const int a = index.RegionId("a");
+
+  SpawnBox("box", ignition::math::Vector3d(0.1, 0.1, 0.1),
+      ignition::math::Vector3d(0, 0, 5));
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != NULL);
+
+  world->Step(1);
+  EXPECT_TRUE(index.Update());
+  EXPECT_TRUE(index.Contains(box, a));
+
+  // The box left the region, which is only seen after 0.1 s
+  box->SetWorldPose(ignition::math::Pose3d(5, 0, 5, 0, 0, 0));
+  const int steps = static_cast<int>(std::round(0.1 / dt));
+  int checks = 0;
+  for (int i = 0; i < steps; ++i)
+  {
+    world->Step(1);
+    if (index.Update())
+      ++checks;
+  }
+  EXPECT_EQ(1, checks);
+  EXPECT_FALSE(index.Contains(box, a));
+
+  // A world reset checks right away
+  world->Reset();
+  world->Step(1);
+  EXPECT_TRUE(index.Update());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -38,6 +38,17 @@ void SimEventsPlugin::OnModelInfo(ConstModelPtr &_msg)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SimEventsPlugin::OnModelInfoV(ConstModel_VPtr &_msg)
+{
+  for (int i = 0; i < _msg->models_size(); ++i)
+  {
+    const std::string &modelName = _msg->models(i).name();
+    if (models.insert(modelName).second)
+      SimEventConnector::spawnModel(modelName, true);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 SimEventsPlugin::~SimEventsPlugin()
 {
@@ -83,6 +94,8 @@ void SimEventsPlugin::Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
   // Subscribe to model spawning
   this->spawnSub = this->node->Subscribe("~/model/info",
       &SimEventsPlugin::OnModelInfo, this);
+  this->spawnVSub = this->node->Subscribe("~/model/info_v",
+      &SimEventsPlugin::OnModelInfoV, this);
 
   // detect model deletion
   this->requestSub = this->node->Subscribe("~/request",
@@ -106,6 +119,13 @@ void SimEventsPlugin::Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
     }
   }
 
+  this->regionIndex.reset(new RegionIndex(this->world, this->regions));
+
+  // Checks of models against regions per second of simulation time,
+  // every world update by default
+  if (this->sdf->HasElement("update_rate"))
+    this->regionIndex->SetUpdateRate(this->sdf->Get<double>("update_rate"));
+
   // Reading events
   sdf::ElementPtr child = this->sdf->GetElement("event");
   while (child)
@@ -125,12 +145,13 @@ void SimEventsPlugin::Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
     {
       event.reset(new InRegionEventSource(this->pub,
                                           this->world,
-                                          this->regions));
+                                          this->regions,
+                                          this->regionIndex));
     }
     else if (eventType == "occupied")
     {
       event.reset(new OccupiedEventSource(this->pub,
-            this->world, this->regions));
+            this->world, this->regions, this->regionIndex));
     }
     else if (eventType == "existence" )
     {
@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "RegionIndex.hh"
 #include "SimEventsException.hh"
 #include "SimStateEventSource.hh"
 
@@ -48,6 +49,10 @@ namespace gazebo
     /// \param[in] _msg model message
     private: void OnModelInfo(ConstModelPtr &_msg);
 
+    /// \brief callback for ~/model/info_v topic
+    /// \param[in] _msg message with the models inserted together
+    private: void OnModelInfoV(ConstModel_VPtr &_msg);
+
     /// \brief callback for ~/request topic
     /// \param [in] _msg the request message
     private: void OnRequest(ConstRequestPtr &_msg);
@@ -61,6 +66,10 @@ namespace gazebo
     /// \brief All the regions defined in the XML for scoring
     private: std::map<std::string, RegionPtr> regions;
 
+    /// \brief Index of the regions, shared by the event sources that check
+    /// models against them
+    private: RegionIndexPtr regionIndex;
+
     /// \brief List of all sim event emitters
     private: std::vector<EventSourcePtr> events;
 
@@ -73,6 +82,9 @@ namespace gazebo
     /// \brief subscription to the model/info
     private: transport::SubscriberPtr spawnSub;
 
+    /// \brief subscription to the model/info_v
+    private: transport::SubscriberPtr spawnVSub;
+
     /// \brief known models that have been spawned already
     private: std::set<std::string> models;
 
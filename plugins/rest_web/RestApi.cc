@@ -14,11 +14,19 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
 #include <iostream>
 #include <cstring>
 #include <stdlib.h>
 #include <curl/curl.h>
 #include <inttypes.h>
+#include <thread>
+#include <vector>
 
 #include "RestApi.hh"
 
@@ -182,113 +190,206 @@ static size_t WriteMemoryCallback(void *_contents,
   return realsize;
 }
 
-/////////////////////////////////////////////////
-RestApi::RestApi()
-  :isLoggedIn(false)
+/// \brief Shortest delay before retrying a failed post.
+static const std::chrono::milliseconds RETRY_MIN_DELAY(1000);
+
+/// \brief Longest delay before retrying a failed post.
+static const std::chrono::milliseconds RETRY_MAX_DELAY(30000);
+
+/// \brief A dropped post is reported every time this many were dropped.
+static const size_t DROP_WARNING_PERIOD = 100;
+
+/// \brief A post: what (json) and where (route)
+struct Post
 {
-}
+  std::string route;
+  std::string json;
+};
 
-/////////////////////////////////////////////////
-RestApi::~RestApi()
+/// \brief Login information of the REST service.
+struct Credentials
 {
-  curl_global_cleanup();
-}
+  /// \brief REST service host url
+  std::string url;
 
-/////////////////////////////////////////////////
-void RestApi::PostJsonData(const char *_route, const char *_json)
+  /// \brief REST service username
+  std::string user;
+
+  /// \brief REST service password
+  std::string pass;
+};
+
+namespace gazebo
 {
-  Post post;
-  post.route = _route;
-  post.json = _json;
+  /// \internal
+  /// \brief Private data for the RestApi class.
+  class RestApiPrivate
   {
-    std::lock_guard<std::mutex> lock(this->postsMutex);
-    this->posts.push_back(post);
-  }
-  this->SendUnpostedPosts();
+    /// \brief Login information.
+    public: Credentials login;
+
+    /// \brief Login route
+    public: std::string loginRoute;
+
+    /// \brief True when a previous Login attempt was successful
+    public: bool isLoggedIn = false;
+
+    /// \brief Posts waiting to be sent, oldest first.
+    public: std::deque<Post> posts;
+
+    /// \brief Maximum number of posts in memory.
+    public: size_t maxQueueSize = 1000;
+
+    /// \brief Maximum number of posts per request.
+    public: size_t maxBatchSize = 1;
+
+    /// \brief Spill file, empty to drop posts instead.
+    public: std::string spillPath;
+
+    /// \brief Number of posts in the spill file. They are all newer than
+    /// the posts in memory.
+    public: size_t spilledCount = 0;
+
+    /// \brief Number of dropped posts.
+    public: size_t droppedCount = 0;
+
+    /// \brief Callback for failed posts.
+    public: RestApi::ErrorCallback errorCallback;
+
+    /// \brief Protects the members above.
+    public: mutable std::mutex mutex;
+
+    /// \brief Wakes the posting thread up.
+    public: std::condition_variable condition;
+
+    /// \brief Tells the posting thread to stop.
+    public: bool stop = false;
+
+    /// \brief Posting thread.
+    public: std::thread thread;
+
+    /// \brief Handle that shares the DNS cache, SSL sessions and
+    /// connections between requests.
+    public: CURLSH *share = nullptr;
+
+    /// \brief Handle of the posting thread, kept to reuse its connection.
+    public: CURL *postCurl = nullptr;
+
+    /// \brief Locks of the shared data, required by curl.
+    public: std::mutex shareMutexes[CURL_LOCK_DATA_LAST];
+  };
 }
 
 /////////////////////////////////////////////////
-std::string RestApi::Login(const std::string &_urlStr,
-                           const std::string &_route,
-                           const std::string &_userStr,
-                           const std::string &_passStr)
+// Callback given to curl to lock shared data
+static void LockShare(CURL * /*_handle*/, curl_lock_data _data,
+                      curl_lock_access /*_access*/, void *_userp)
 {
-  this->isLoggedIn = false;
-  this->url = _urlStr;
-  this->user = _userStr;
-  this->pass = _passStr;
-
-  // at this point we want to test the (user supplied) login data
-  // so we're hitting the server on the login route ('/login')
-  this->loginRoute = _route;
-  std::string resp;
-
-  gzmsg << "login route: " << this->loginRoute << std::endl;
-  resp = this->Request(loginRoute, "");
-  gzmsg << "login response: " << resp << std::endl;
+  static_cast<RestApiPrivate *>(_userp)->shareMutexes[_data].lock();
+}
 
-  this->isLoggedIn = true;
-  this->SendUnpostedPosts();
-  return resp;
+/////////////////////////////////////////////////
+// Callback given to curl to unlock shared data
+static void UnlockShare(CURL * /*_handle*/, curl_lock_data _data,
+                        void *_userp)
+{
+  static_cast<RestApiPrivate *>(_userp)->shareMutexes[_data].unlock();
 }
 
 /////////////////////////////////////////////////
-void RestApi::Logout()
+/// \brief Write posts to a spill file, as the route, the size of the json
+/// and the json on their own lines.
+/// \param[in] _out Stream to write to.
+/// \param[in] _posts Posts to write.
+/// \return True on success.
+static bool WritePosts(std::ostream &_out, const std::deque<Post> &_posts)
 {
-  this->isLoggedIn = false;
-  gzmsg << "Logout" << std::endl;
+  for (const auto &post : _posts)
+  {
+    _out << post.route << '\n' << post.json.size() << '\n' << post.json
+         << '\n';
+  }
+  _out.flush();
+  return _out.good();
 }
 
 /////////////////////////////////////////////////
-void RestApi::SendUnpostedPosts()
+/// \brief Read the posts of a spill file.
+/// \param[in] _path File path.
+/// \param[out] _posts The posts are appended to this.
+static void ReadPosts(const std::string &_path, std::deque<Post> &_posts)
 {
-  if (this->isLoggedIn)
+  std::ifstream in(_path, std::ios::binary);
+  Post post;
+  size_t size;
+  while (std::getline(in, post.route) && in >> size && in.get() == '\n')
   {
-    while (!this->posts.empty())
+    post.json.resize(size);
+    if (!in.read(&post.json[0], size) || in.get() != '\n')
     {
-      Post post;
-      {
-        std::lock_guard<std::mutex> lock(this->postsMutex);
-        post = this->posts.front();
-
-        //  You can generate a similar request on the cmd line like so:
-        //  curl --verbose --connect-timeout 5 -X POST
-        //    -H \"Content-Type: application/json \" -k --user"
-        this->Request(post.route, post.json);
-        this->posts.pop_front();
-      }
+      gzwarn << "Truncated REST post in [" << _path << "]" << std::endl;
+      break;
     }
-  }
-  else
-  {
-    gzmsg << posts.size() << " post(s) queued to be sent" << std::endl;
+    _posts.push_back(post);
   }
 }
 
 /////////////////////////////////////////////////
-std::string RestApi::GetUser() const
+/// \brief Replace the content of a spill file, or remove it if there are
+/// no posts left.
+/// \param[in] _path File path.
+/// \param[in] _posts Posts to write.
+/// \return True on success.
+static bool RewritePosts(const std::string &_path,
+                         const std::deque<Post> &_posts)
 {
-  return this->user;
+  if (_posts.empty())
+  {
+    std::remove(_path.c_str());
+    return true;
+  }
+
+  std::ofstream out(_path, std::ios::binary | std::ios::trunc);
+  return WritePosts(out, _posts);
 }
 
 /////////////////////////////////////////////////
-std::string RestApi::Request(const std::string &_reqUrl,
-                             const std::string &_postJsonStr)
+/// \brief A Request/Response (can be used for GET and POST)
+/// \param[in] _curl The handle to use. It is reset first, which keeps its
+/// connection to the server open.
+/// \param[in] _share Share handle, or null.
+/// \param[in] _login Login information.
+/// \param[in] _reqUrl The request route.
+/// \param[in] _postJsonStr The data to post, empty for a GET.
+/// \param[out] _httpCode HTTP response code, 0 if there was no response.
+/// \throws RestException When the url or user are empty, and when the
+/// request failed.
+/// \return The web server response
+static std::string Request(CURL *_curl, CURLSH *_share,
+                           const Credentials &_login,
+                           const std::string &_reqUrl,
+                           const std::string &_postJsonStr,
+                           int64_t &_httpCode)
 {
-  if (this->url.empty())
+  _httpCode = 0;
+  if (_login.url.empty())
     throw RestException("A URL must be specified for web service");
 
-  if (this->user.empty())
+  if (_login.user.empty())
   {
     std::string e = "No user specified for the web service. Please login.";
     throw RestException(e.c_str());
   }
   // build full url (with server)
-  std::string path = url + _reqUrl;
-  CURL *curl = curl_easy_init();
+  std::string path = _login.url + _reqUrl;
+  CURL *curl = _curl;
+  curl_easy_reset(curl);
+  if (_share)
+    curl_easy_setopt(curl, CURLOPT_SHARE, _share);
   curl_easy_setopt(curl, CURLOPT_URL, path.c_str() );
 
   // in case things go wrong
+  struct data config;
   if (trace_requests)
   {
     gzmsg << "RestApi::Request" << std::endl;
@@ -296,7 +397,6 @@ std::string RestApi::Request(const std::string &_reqUrl,
     gzmsg << "  data: " << _postJsonStr << std::endl;
     gzmsg << std::endl;
 
-    struct data config;
     config.trace_ascii = 1;  //  enable ascii tracing
     curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, TraceRequest);
     curl_easy_setopt(curl, CURLOPT_DEBUGDATA, &config);
@@ -331,7 +431,7 @@ std::string RestApi::Request(const std::string &_reqUrl,
 
   // set user name and password for the authentication
   curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
-  std::string userpass = this->user + ":" + this->pass;
+  std::string userpass = _login.user + ":" + _login.pass;
   curl_easy_setopt(curl, CURLOPT_USERPWD, userpass.c_str());
 
   // connection timeout 10 sec
@@ -357,25 +457,363 @@ std::string RestApi::Request(const std::string &_reqUrl,
   int64_t http_code = 0;
 
   curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+  _httpCode = http_code;
+
+  // copy the data into a string, and clean up
+  std::string response(chunk.memory ? chunk.memory : "", chunk.size);
+  curl_slist_free_all(slist);
+  if (chunk.memory)
+    free(chunk.memory);
 
-  curl_easy_cleanup(curl);
   if (res != CURLE_OK)
   {
-    gzerr << "Request to " << url << " failed: "
+    gzerr << "Request to " << _login.url << " failed: "
           << curl_easy_strerror(res) << std::endl;
     throw RestException(curl_easy_strerror(res));
   }
-  // copy the data into a string
-  std::string response(chunk.memory, chunk.size);
 
   if (http_code != 200)
   {
-    gzerr << "Request to " << url << " error: " << response << std::endl;
+    gzerr << "Request to " << _login.url << " error: " << response
+          << std::endl;
     throw RestException(response.c_str());
   }
-  // clean up
-  curl_slist_free_all(slist);
-  if (chunk.memory)
-    free(chunk.memory);
   return response;
 }
+
+/////////////////////////////////////////////////
+/// \brief Queue a post, spilling or dropping posts if the queue is full.
+/// The caller holds the mutex.
+/// \param[in] _data Private data of the RestApi.
+/// \param[in] _post Post to queue.
+static void QueuePost(RestApiPrivate &_data, const Post &_post)
+{
+  // Once posts are spilled, newer posts go to the file as well to keep
+  // them in order.
+  if (!_data.spillPath.empty() &&
+      (_data.spilledCount > 0 || _data.posts.size() >= _data.maxQueueSize))
+  {
+    std::ofstream out(_data.spillPath, std::ios::binary | std::ios::app);
+    if (WritePosts(out, {_post}))
+    {
+      ++_data.spilledCount;
+      return;
+    }
+    gzerr << "Unable to write REST post to [" << _data.spillPath << "]"
+          << std::endl;
+  }
+
+  while (!_data.posts.empty() && _data.posts.size() >= _data.maxQueueSize)
+  {
+    _data.posts.pop_front();
+    if (_data.droppedCount++ % DROP_WARNING_PERIOD == 0)
+    {
+      gzwarn << "REST post queue is full, " << _data.droppedCount
+             << " post(s) dropped so far" << std::endl;
+    }
+  }
+  _data.posts.push_back(_post);
+}
+
+/////////////////////////////////////////////////
+/// \brief Move spilled posts back to the queue, as many as fit. The
+/// caller holds the mutex.
+/// \param[in] _data Private data of the RestApi.
+static void LoadSpilledPosts(RestApiPrivate &_data)
+{
+  std::deque<Post> spilled;
+  ReadPosts(_data.spillPath, spilled);
+
+  while (!spilled.empty() && _data.posts.size() < _data.maxQueueSize)
+  {
+    _data.posts.push_back(spilled.front());
+    spilled.pop_front();
+  }
+
+  if (!RewritePosts(_data.spillPath, spilled))
+  {
+    gzerr << "Unable to write REST posts to [" << _data.spillPath << "]"
+          << std::endl;
+  }
+  _data.spilledCount = spilled.size();
+}
+
+/////////////////////////////////////////////////
+RestApi::RestApi()
+  : dataPtr(new RestApiPrivate)
+{
+  curl_global_init(CURL_GLOBAL_ALL);
+
+  this->dataPtr->share = curl_share_init();
+  curl_share_setopt(this->dataPtr->share, CURLSHOPT_LOCKFUNC, LockShare);
+  curl_share_setopt(this->dataPtr->share, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+  curl_share_setopt(this->dataPtr->share, CURLSHOPT_USERDATA,
+      this->dataPtr.get());
+  curl_share_setopt(this->dataPtr->share, CURLSHOPT_SHARE,
+      CURL_LOCK_DATA_DNS);
+  curl_share_setopt(this->dataPtr->share, CURLSHOPT_SHARE,
+      CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+  curl_share_setopt(this->dataPtr->share, CURLSHOPT_SHARE,
+      CURL_LOCK_DATA_CONNECT);
+#endif
+  this->dataPtr->postCurl = curl_easy_init();
+
+  this->dataPtr->thread = std::thread(&RestApi::RunPosts, this);
+}
+
+/////////////////////////////////////////////////
+RestApi::~RestApi()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->condition.notify_all();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+
+  // Keep the unsent posts for the next session, ahead of the ones already
+  // spilled, which are newer
+  RestApiPrivate &d = *this->dataPtr;
+  if (!d.spillPath.empty() && !d.posts.empty())
+  {
+    ReadPosts(d.spillPath, d.posts);
+    if (!RewritePosts(d.spillPath, d.posts))
+    {
+      gzerr << "Unable to write REST posts to [" << d.spillPath << "]"
+            << std::endl;
+    }
+  }
+
+  curl_easy_cleanup(this->dataPtr->postCurl);
+  curl_share_cleanup(this->dataPtr->share);
+  curl_global_cleanup();
+}
+
+/////////////////////////////////////////////////
+void RestApi::PostJsonData(const char *_route, const char *_json)
+{
+  Post post;
+  post.route = _route;
+  post.json = _json;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    QueuePost(*this->dataPtr, post);
+    if (!this->dataPtr->isLoggedIn)
+    {
+      gzmsg << this->dataPtr->posts.size() + this->dataPtr->spilledCount
+            << " post(s) queued to be sent" << std::endl;
+    }
+  }
+  this->dataPtr->condition.notify_one();
+}
+
+/////////////////////////////////////////////////
+std::string RestApi::Login(const std::string &_urlStr,
+                           const std::string &_route,
+                           const std::string &_userStr,
+                           const std::string &_passStr)
+{
+  Credentials login;
+  login.url = _urlStr;
+  login.user = _userStr;
+  login.pass = _passStr;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->isLoggedIn = false;
+    this->dataPtr->login = login;
+
+    // at this point we want to test the (user supplied) login data
+    // so we're hitting the server on the login route ('/login')
+    this->dataPtr->loginRoute = _route;
+  }
+
+  gzmsg << "login route: " << _route << std::endl;
+  CURL *curl = curl_easy_init();
+  std::string resp;
+  int64_t httpCode;
+  try
+  {
+    resp = Request(curl, this->dataPtr->share, login, _route, "", httpCode);
+  }
+  catch(...)
+  {
+    curl_easy_cleanup(curl);
+    throw;
+  }
+  curl_easy_cleanup(curl);
+  gzmsg << "login response: " << resp << std::endl;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->isLoggedIn = true;
+  }
+  this->dataPtr->condition.notify_one();
+  return resp;
+}
+
+/////////////////////////////////////////////////
+void RestApi::Logout()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->isLoggedIn = false;
+  }
+  gzmsg << "Logout" << std::endl;
+}
+
+/////////////////////////////////////////////////
+std::string RestApi::GetUser() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->login.user;
+}
+
+/////////////////////////////////////////////////
+void RestApi::SetErrorCallback(const ErrorCallback &_callback)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->errorCallback = _callback;
+}
+
+/////////////////////////////////////////////////
+void RestApi::SetMaxQueueSize(const size_t _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxQueueSize = std::max(_size, static_cast<size_t>(1));
+}
+
+/////////////////////////////////////////////////
+void RestApi::SetMaxBatchSize(const size_t _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxBatchSize = std::max(_size, static_cast<size_t>(1));
+}
+
+/////////////////////////////////////////////////
+void RestApi::SetSpillPath(const std::string &_path)
+{
+  std::deque<Post> spilled;
+  if (!_path.empty())
+    ReadPosts(_path, spilled);
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->spillPath = _path;
+    this->dataPtr->spilledCount = spilled.size();
+  }
+  if (!spilled.empty())
+  {
+    gzmsg << spilled.size() << " REST post(s) found in [" << _path << "]"
+          << std::endl;
+    this->dataPtr->condition.notify_one();
+  }
+}
+
+/////////////////////////////////////////////////
+size_t RestApi::QueueSize() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->posts.size() + this->dataPtr->spilledCount;
+}
+
+/////////////////////////////////////////////////
+void RestApi::RunPosts()
+{
+  RestApiPrivate &d = *this->dataPtr;
+  std::chrono::milliseconds retryDelay = RETRY_MIN_DELAY;
+
+  std::unique_lock<std::mutex> lock(d.mutex);
+  while (!d.stop)
+  {
+    if (d.posts.empty() && d.spilledCount > 0)
+      LoadSpilledPosts(d);
+
+    if (!d.isLoggedIn || d.posts.empty())
+    {
+      d.condition.wait(lock);
+      continue;
+    }
+
+    // Take the consecutive posts to the same route
+    std::deque<Post> batch;
+    batch.push_back(d.posts.front());
+    d.posts.pop_front();
+    while (batch.size() < d.maxBatchSize && !d.posts.empty() &&
+        d.posts.front().route == batch.front().route)
+    {
+      batch.push_back(d.posts.front());
+      d.posts.pop_front();
+    }
+    const Credentials login = d.login;
+    lock.unlock();
+
+    std::string body;
+    if (batch.size() == 1)
+    {
+      body = batch.front().json;
+    }
+    else
+    {
+      body = "[";
+      for (const auto &post : batch)
+      {
+        if (body.size() > 1)
+          body += ",";
+        body += post.json;
+      }
+      body += "]";
+    }
+
+    //  You can generate a similar request on the cmd line like so:
+    //  curl --verbose --connect-timeout 5 -X POST
+    //    -H \"Content-Type: application/json \" -k --user"
+    std::string error;
+    int64_t httpCode = 0;
+    try
+    {
+      Request(d.postCurl, d.share, login, batch.front().route, body,
+          httpCode);
+    }
+    catch(RestException &_e)
+    {
+      error = _e.what();
+    }
+
+    lock.lock();
+    if (error.empty())
+    {
+      retryDelay = RETRY_MIN_DELAY;
+      continue;
+    }
+
+    // Retry when the service couldn't be reached or had an internal
+    // error. Posts it rejected are dropped, so they don't block the queue.
+    const bool retry = httpCode == 0 || httpCode >= 500;
+    if (retry)
+    {
+      d.posts.insert(d.posts.begin(), batch.begin(), batch.end());
+      if (d.spillPath.empty())
+      {
+        while (d.posts.size() > d.maxQueueSize)
+        {
+          d.posts.pop_front();
+          ++d.droppedCount;
+        }
+      }
+    }
+
+    const RestApi::ErrorCallback callback = d.errorCallback;
+    lock.unlock();
+    if (callback)
+      callback(error);
+    lock.lock();
+
+    if (retry)
+    {
+      d.condition.wait_for(lock, retryDelay, [&d] { return d.stop; });
+      retryDelay = std::min(retryDelay * 2, RETRY_MAX_DELAY);
+    }
+  }
+}
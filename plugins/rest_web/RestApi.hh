@@ -18,23 +18,38 @@
 #ifndef GAZEBO_PLUGINS_REST_WEB_RESTAPI_HH_
 #define GAZEBO_PLUGINS_REST_WEB_RESTAPI_HH_
 
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
-#include <list>
-#include <mutex>
 #include <gazebo/common/Console.hh>
 
 #include "RestException.hh"
 
 namespace gazebo
 {
+  // Forward declare private data class
+  class RestApiPrivate;
+
   /// \class RestApi RestApi.hh RestApi.hh
   /// \brief REST interface
+  ///
+  /// Posts are queued and sent by a background thread, so that a slow or
+  /// unreachable service doesn't block the callers. The thread reuses its
+  /// connection to the service, and retries failed posts with an
+  /// increasing delay. The queue is bounded: when it is full, new posts
+  /// are written to a spill file if one is set, and the oldest posts are
+  /// dropped otherwise.
   class RestApi
   {
+    /// \brief Callback for posts that couldn't be sent.
+    public: using ErrorCallback = std::function<void (const std::string &)>;
+
     /// \brief Constructor
     public: RestApi();
 
-    /// \brief Destructor
+    /// \brief Destructor. Queued posts are written to the spill file, if
+    /// one is set.
     public: virtual ~RestApi();
 
     /// \brief Connects to the REST service.
@@ -42,6 +57,7 @@ namespace gazebo
     /// \param[in] _route The route on the server
     /// \param[in] _user The user name
     /// \param[in] _pass The user password
+    /// \throws RestException When the login request failed.
     /// \return The response message from the REST server
     public: std::string Login(const std::string &_url,
                               const std::string &_route,
@@ -53,7 +69,8 @@ namespace gazebo
     /// a new call to Login has to be made to resume sending messages.
     public: void Logout();
 
-    /// \brief Notify the service with a http POST
+    /// \brief Queue a http POST to the service. Returns right away, the
+    /// post is sent once logged in.
     /// \param[in] _route on the web server
     /// \param[in] _json the data to send to the server
     public: void PostJsonData(const char *_route, const char *_json);
@@ -62,45 +79,38 @@ namespace gazebo
     /// \return The user name
     public: std::string GetUser() const;
 
-    /// \brief A Request/Respone (can be used for GET and POST)
-    /// \param[in] _requestUrl The request url.
-    /// \param[in] _postStr The data to post
-    /// \throws RestException When this->url or this->user are empty, and
-    /// when the request failed.
-    /// \return The web server response
-    private: std::string Request(const std::string &_requestUrl,
-                                 const std::string &_postStr);
-
-    /// \brief Sends unposted posts
-    private: void SendUnpostedPosts();
-
-    /// \brief Login information: REST service host url
-    private: std::string url;
-
-    /// \brief Login information: REST service username
-    private: std::string user;
-
-    /// \brief Login information: REST service password
-    private: std::string pass;
-
-    /// \brief Login information: login route
-    private: std::string loginRoute;
-
-    /// \brief True when a previous Login attempt was successful
-    private: bool isLoggedIn;
-
-    /// \brief A post: what (json) and where (route)
-    private: struct Post
-      {
-        std::string route;
-        std::string json;
-      };
-
-    /// \brief List of unposted posts. Posts await when isLoggedIn is false
-    private: std::list<Post> posts;
-
-    /// \brief A mutex to ensure integrity of the post list
-    private: std::mutex postsMutex;
+    /// \brief Set a callback for posts that failed. It is called from the
+    /// posting thread.
+    /// \param[in] _callback Called with the error message.
+    public: void SetErrorCallback(const ErrorCallback &_callback);
+
+    /// \brief Set the maximum number of posts kept in memory.
+    /// \param[in] _size Maximum number of posts, 1000 by default.
+    public: void SetMaxQueueSize(const size_t _size);
+
+    /// \brief Set the maximum number of posts sent in one request.
+    /// Consecutive posts to the same route are sent as a JSON array, so
+    /// the service must accept arrays when this is more than one.
+    /// \param[in] _size Maximum number of posts, 1 by default.
+    public: void SetMaxBatchSize(const size_t _size);
+
+    /// \brief Set the file where posts go when the queue is full, and
+    /// where they are read back from once the queue has drained. Posts
+    /// left in the file from a previous session are sent too.
+    /// \param[in] _path File path, empty to drop posts instead.
+    public: void SetSpillPath(const std::string &_path);
+
+    /// \brief Get the number of posts waiting to be sent, including the
+    /// spilled ones.
+    /// \return Number of posts.
+    public: size_t QueueSize() const;
+
+    /// \brief Entry point of the posting thread.
+    private: void RunPosts();
+
+    /// \internal
+    /// \brief Private data pointer.
+    private: std::unique_ptr<RestApiPrivate> dataPtr;
   };
 }
 
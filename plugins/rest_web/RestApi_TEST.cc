@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include "plugins/rest_web/RestApi.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class RestApiTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Read the json of the posts in a spill file.
+/// \param[in] _path File path.
+/// \param[in] _route Route expected for every post.
+/// \return The json of each post, in order.
+std::vector<std::string> SpilledPosts(const std::string &_path,
+    const std::string &_route)
+{
+  std::vector<std::string> result;
+  std::ifstream in(_path, std::ios::binary);
+  std::string route;
+  size_t size;
+  while (std::getline(in, route) && in >> size && in.get() == '\n')
+  {
+    EXPECT_EQ(_route, route);
+    std::string json(size, ' ');
+    if (!in.read(&json[0], size) || in.get() != '\n')
+    {
+      ADD_FAILURE() << "Truncated post in " << _path;
+      break;
+    }
+    result.push_back(json);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+// Without a spill file, the oldest posts are dropped once the queue is full
+TEST_F(RestApiTest, DropOldest)
+{
+  RestApi rest;
+  rest.SetMaxQueueSize(3);
+  EXPECT_EQ(0u, rest.QueueSize());
+
+  // Posts wait for a login
+  for (int i = 0; i < 5; ++i)
+  {
+    const std::string json = "{\"i\": " + std::to_string(i) + "}";
+    rest.PostJsonData("/events/new", json.c_str());
+  }
+  EXPECT_EQ(3u, rest.QueueSize());
+}
+
+/////////////////////////////////////////////////
+// Posts beyond the queue size go to the spill file, and posts left at
+// shutdown are kept in it, in order, for the next session
+TEST_F(RestApiTest, Spill)
+{
+  const std::string path = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_rest_posts_%%%%")).string();
+  const std::string route = "/events/new";
+
+  std::vector<std::string> posts;
+  for (int i = 0; i < 5; ++i)
+  {
+    // The json may span several lines
+    posts.push_back("{\n  \"i\": " + std::to_string(i) + "\n}");
+  }
+
+  {
+    RestApi rest;
+    rest.SetMaxQueueSize(2);
+    rest.SetSpillPath(path);
+    for (auto const &post : posts)
+      rest.PostJsonData(route.c_str(), post.c_str());
+    EXPECT_EQ(5u, rest.QueueSize());
+
+    // Only the posts beyond the queue size are spilled
+    EXPECT_EQ(std::vector<std::string>(posts.begin() + 2, posts.end()),
+        SpilledPosts(path, route));
+  }
+
+  // The queued posts are written ahead of the spilled ones
+  EXPECT_EQ(posts, SpilledPosts(path, route));
+
+  // The next session finds them
+  {
+    RestApi rest;
+    rest.SetSpillPath(path);
+    EXPECT_EQ(5u, rest.QueueSize());
+  }
+  EXPECT_EQ(posts, SpilledPosts(path, route));
+
+  boost::filesystem::remove(path);
+}
+
+/////////////////////////////////////////////////
+// A failed login throws, and the posts stay queued
+TEST_F(RestApiTest, LoginFailure)
+{
+  RestApi rest;
+  rest.PostJsonData("/events/new", "{}");
+
+  EXPECT_THROW(rest.Login("", "/login", "user", "pass"), RestException);
+  EXPECT_THROW(rest.Login("https://localhost:1", "/login", "", "pass"),
+      RestException);
+  EXPECT_THROW(rest.Login("https://localhost:1", "/login", "user", "pass"),
+      RestException);
+  EXPECT_EQ(1u, rest.QueueSize());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -29,6 +29,8 @@
 
 #endif
 
+#include <gazebo/common/SystemPaths.hh>
+
 #include "RestWebPlugin.hh"
 
 
@@ -81,6 +83,8 @@ RestWebPlugin::RestWebPlugin()
 //////////////////////////////////////////////////
 RestWebPlugin::~RestWebPlugin()
 {
+  this->restApi.SetErrorCallback(nullptr);
+
   // tell the requestQ to stop precessing
   this->stopMsgProcessing = true;
   if (this->requestQThread && this->requestQThread->joinable())
@@ -107,6 +111,13 @@ void RestWebPlugin::Init()
   this->subSimEvent = node->Subscribe("/gazebo/sim_events",
                                 &RestWebPlugin::OnSimEvent, this);
 
+  // posts that can't be sent while the service is down are kept in the
+  // log directory, and sent in a later session if needed
+  this->restApi.SetSpillPath(
+      common::SystemPaths::Instance()->GetLogPath() + "/rest_posts");
+  this->restApi.SetErrorCallback(
+      std::bind(&RestWebPlugin::OnPostError, this, std::placeholders::_1));
+
   this->requestQThread = new std::thread(
       std::bind(&RestWebPlugin::RunRequestQ, this));
 }
@@ -303,6 +314,22 @@ void RestWebPlugin::OnRestLogoutRequest(ConstRestLogoutPtr &_msg)
   this->pub->Publish(msg);
 }
 
+//////////////////////////////////////////////////
+void RestWebPlugin::OnPostError(const std::string &_error)
+{
+  // posts are sent by the RestApi thread, so errors are reported here
+  // instead of in the response to the post
+  gzerr << "ERROR in REST service POST request: " << _error << std::endl;
+  if (!this->pub)
+    return;
+
+  gazebo::msgs::RestResponse msg;
+  msg.set_type(msgs::RestResponse::ERR);
+  msg.set_msg("There was a problem trying to send data to the server: " +
+      _error);
+  this->pub->Publish(msg);
+}
+
 //////////////////////////////////////////////////
 void RestWebPlugin::ProcessLoginRequest(ConstRestLoginPtr _msg)
 {
@@ -68,6 +68,10 @@ namespace gazebo
     /// \brief Entry point for the web requests processing thread
     private: void RunRequestQ();
 
+    /// \brief Called by the RestApi when a post couldn't be sent
+    /// \param[in] _error The error message
+    private: void OnPostError(const std::string &_error);
+
     /// \brief Process a RestRequest message from the requestThread
     /// \param[in] The message to process
     private: void ProcessLoginRequest(ConstRestLoginPtr _msg);
@@ -15,6 +15,9 @@
  *
 */
 
+#include <sstream>
+#include <string>
+
 #include <gtest/gtest.h>
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/Joint.hh"
@@ -33,8 +36,50 @@ class JointLiftDragPluginTest : public ServerFixture,
   /// Measure / verify force torques against analytical answers.
   /// \param[in] _physicsEngine Type of physics engine to use.
   public: void LiftDragPlugin1(const std::string &_physicsEngine);
+
+  /// \brief Spawn and remove models with lifting surfaces, and verify that
+  /// the surfaces of the remaining models are still updated.
+  /// \param[in] _physicsEngine Type of physics engine to use.
+  public: void AddRemoveSurfaces(const std::string &_physicsEngine);
+
+  /// \brief Spawn a flat plate with a lifting surface.
+  /// \param[in] _name Name of the model.
+  /// \param[in] _pos Position of the model.
+  public: void SpawnPlate(const std::string &_name,
+              const ignition::math::Vector3d &_pos);
 };
 
+/////////////////////////////////////////////////
+void JointLiftDragPluginTest::SpawnPlate(const std::string &_name,
+    const ignition::math::Vector3d &_pos)
+{
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='" << _name << "'>"
+    << "  <pose>" << _pos << " 0 0 0</pose>"
+    << "  <link name='plate'>"
+    << "    <inertial><mass>1.0</mass></inertial>"
+    << "    <collision name='collision'>"
+    << "      <geometry><box><size>1 1 0.1</size></box></geometry>"
+    << "    </collision>"
+    << "  </link>"
+    << "  <plugin name='lift_drag' filename='libLiftDragPlugin.so'>"
+    << "    <a0>0.1</a0>"
+    << "    <cla>4.0</cla>"
+    << "    <cda>0.0</cda>"
+    << "    <alpha_stall>10.0</alpha_stall>"
+    << "    <cp>0 0 0</cp>"
+    << "    <area>10</area>"
+    << "    <air_density>1.2041</air_density>"
+    << "    <forward>-1 0 0</forward>"
+    << "    <upward>0 0 1</upward>"
+    << "    <link_name>" << _name << "::plate</link_name>"
+    << "  </plugin>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+}
+
 /////////////////////////////////////////////////
 void JointLiftDragPluginTest::LiftDragPlugin1(const std::string &_physicsEngine)
 {
@@ -138,6 +183,83 @@ TEST_P(JointLiftDragPluginTest, LiftDragPlugin1)
   LiftDragPlugin1(GetParam());
 }
 
+/////////////////////////////////////////////////
+void JointLiftDragPluginTest::AddRemoveSurfaces(
+    const std::string &_physicsEngine)
+{
+  if (_physicsEngine != "ode")
+  {
+    gzlog << "this test works for ode only for now (Link::AddForce)"
+          << " missing for other engines.\n";
+    return;
+  }
+
+  Load("worlds/lift_drag_plugin.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  world->Physics()->SetGravity(ignition::math::Vector3d::Zero);
+
+  // The surfaces of all the models are updated from the same callback
+  SpawnPlate("plate_1", ignition::math::Vector3d(0, 20, 5));
+  SpawnPlate("plate_2", ignition::math::Vector3d(0, 30, 5));
+  physics::LinkPtr plate1 = world->ModelByName("plate_1")->GetLink("plate");
+  physics::LinkPtr plate2 = world->ModelByName("plate_2")->GetLink("plate");
+  ASSERT_TRUE(plate1 != NULL);
+  ASSERT_TRUE(plate2 != NULL);
+
+  const ignition::math::Vector3d vel(-10, 0, 0);
+  plate1->SetLinearVel(vel);
+  plate2->SetLinearVel(vel);
+  world->Step(1);
+  EXPECT_GT(plate1->WorldLinearVel().Z(), 0.0);
+  EXPECT_NEAR(plate1->WorldLinearVel().Z(), plate2->WorldLinearVel().Z(),
+      TOL);
+
+  // A removed model no longer has its surface updated, and the remaining
+  // surfaces still are.
+  world->RemoveModel("plate_1");
+  world->Step(1);
+  ASSERT_TRUE(world->ModelByName("plate_1") == NULL);
+
+  plate2->SetLinearVel(vel);
+  world->Step(1);
+  EXPECT_GT(plate2->WorldLinearVel().Z(), 0.0);
+
+  world->RemoveModel("plate_2");
+  world->Step(1);
+
+  // The surfaces loaded with the world are still updated
+  physics::ModelPtr model = world->ModelByName("lift_drag_demo_model");
+  ASSERT_TRUE(model != NULL);
+  physics::LinkPtr body = model->GetLink("body");
+  physics::LinkPtr wing1 = model->GetLink("wing_1");
+  physics::JointPtr wing1Joint = model->GetJoint("wing_1_joint");
+
+  double cla = 4.0;
+  double dihedral = 0.1;
+  double rho = 1.2041;
+  double area = 10;
+  double a0 = 0.1;
+  for (unsigned int i = 0; i < 2400; ++i)
+  {
+    world->Step(1);
+    body->AddForce(ignition::math::Vector3d(-1, 0, 0));
+  }
+
+  double v = body->WorldLinearVel().X();
+  double cl = cla * a0 * 0.5 * rho * v * v * area;
+  physics::JointWrench wing1Wrench = wing1Joint->GetForceTorque(0);
+  auto wing1Force =
+    wing1->WorldPose().Rot().RotateVector(wing1Wrench.body2Force);
+  EXPECT_GT(cl, 0.0);
+  EXPECT_NEAR(wing1Force.Z(), cl * cos(dihedral), TOL);
+}
+
+TEST_P(JointLiftDragPluginTest, AddRemoveSurfaces)
+{
+  AddRemoveSurfaces(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, JointLiftDragPluginTest,
                         PHYSICS_ENGINE_VALUES,);  // NOLINT
 
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class BuoyancyWorldPluginTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(BuoyancyWorldPluginTest, Float)
+{
+  Load("worlds/buoyancy_world_plugin.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr boat = world->ModelByName("boat");
+  ASSERT_TRUE(boat != nullptr);
+  physics::ModelPtr rock = world->ModelByName("rock");
+  ASSERT_TRUE(rock != nullptr);
+
+  // Models added later float too
+  SpawnBox("spawned_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(-3, 0, 2));
+  physics::ModelPtr box = world->ModelByName("spawned_box");
+  ASSERT_TRUE(box != nullptr);
+
+  world->Step(10000);
+
+  // Half as dense as water, so half submerged
+  EXPECT_NEAR(0.0, boat->WorldPose().Pos().Z(), 0.02);
+  EXPECT_NEAR(0.0, boat->WorldLinearVel().Length(), 0.02);
+
+  // A 1 kg box is hardly submerged
+  EXPECT_NEAR(0.5, box->WorldPose().Pos().Z(), 0.02);
+
+  // Not listed in the plugin, so it sinks
+  EXPECT_LT(rock->WorldPose().Pos().Z(), -10.0);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,8 @@
 */
 #include <mutex>
 #include <functional>
+#include <string>
+#include <vector>
 
 #include <ignition/math/Rand.hh>
 
@@ -392,6 +394,80 @@ TEST_F(CameraSensor, TopicName)
       std::string::npos);
 }
 
+/////////////////////////////////////////////////
+TEST_F(CameraSensor, ImageRegion)
+{
+  Load("worlds/empty_test.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run camera test\n";
+    return;
+  }
+
+  std::string modelName = "camera_model";
+  std::string cameraName = "camera_sensor";
+  unsigned int width  = 320;
+  unsigned int height = 240;
+  double updateRate = 10;
+  ignition::math::Pose3d setPose(ignition::math::Vector3d(-5, 0, 5),
+      ignition::math::Quaterniond(0, IGN_DTOR(15), 0));
+  SpawnCamera(modelName, cameraName, setPose.Pos(),
+      setPose.Rot().Euler(), width, height, updateRate);
+  sensors::SensorPtr sensor = sensors::get_sensor(cameraName);
+  sensors::CameraSensorPtr camSensor =
+    std::dynamic_pointer_cast<sensors::CameraSensor>(sensor);
+  ASSERT_TRUE(camSensor != nullptr);
+
+  // Out of the image, not a multiple of the binning, duplicated
+  EXPECT_TRUE(camSensor->AddImageRegion("out",
+      ignition::math::Vector2i(300, 0),
+      ignition::math::Vector2i(40, 40)).empty());
+  EXPECT_TRUE(camSensor->AddImageRegion("odd",
+      ignition::math::Vector2i(0, 0),
+      ignition::math::Vector2i(30, 30), 4).empty());
+
+  std::string topic = camSensor->AddImageRegion("center",
+      ignition::math::Vector2i(80, 60),
+      ignition::math::Vector2i(160, 120), 2);
+  EXPECT_EQ(topic, camSensor->Topic() + "/center");
+  EXPECT_TRUE(camSensor->AddImageRegion("center",
+      ignition::math::Vector2i(0, 0),
+      ignition::math::Vector2i(16, 16)).empty());
+
+  g_imagesStamped.clear();
+  transport::SubscriberPtr sub = this->node->Subscribe(topic, OnImage);
+
+  int sleep = 0;
+  int maxSleep = 300;
+  while (sleep < maxSleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!g_imagesStamped.empty())
+        break;
+    }
+    sleep++;
+    gazebo::common::Time::MSleep(10);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_FALSE(g_imagesStamped.empty());
+    const msgs::Image &image = g_imagesStamped.front().image();
+    EXPECT_EQ(image.width(), 80u);
+    EXPECT_EQ(image.height(), 60u);
+    EXPECT_EQ(image.step(), 80u * camSensor->Camera()->ImageDepth());
+    EXPECT_EQ(image.data().size(), image.step() * image.height());
+  }
+
+  sub.reset();
+  EXPECT_TRUE(camSensor->RemoveImageRegion("center"));
+  EXPECT_FALSE(camSensor->RemoveImageRegion("center"));
+}
+
 /////////////////////////////////////////////////
 TEST_F(CameraSensor, FillMsg)
 {
@@ -1217,6 +1293,72 @@ TEST_F(CameraSensor, PointCloud)
   delete [] depthImg;
 }
 
+/////////////////////////////////////////////////
+TEST_F(CameraSensor, PointCloudDecimation)
+{
+  // world contains a point cloud camera looking at 4 boxes whose faces have
+  // different depth in each quadrant of the image
+  Load("worlds/pointcloud_camera.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run camera test\n";
+    return;
+  }
+
+  sensors::DepthCameraSensorPtr camSensor =
+    std::dynamic_pointer_cast<sensors::DepthCameraSensor>(
+    sensors::get_sensor("pointcloud_camera_sensor"));
+  ASSERT_TRUE(camSensor != nullptr);
+  rendering::DepthCameraPtr depthCam = camSensor->DepthCamera();
+  ASSERT_TRUE(depthCam != nullptr);
+
+  // Render a point every other pixel, and drop the bottom left box, whose
+  // face is 1.3 meters away
+  EXPECT_EQ(depthCam->PointCloudDecimation(), 1u);
+  depthCam->SetPointCloudDecimation(2);
+  depthCam->SetPointCloudMaxRange(1.2);
+  EXPECT_EQ(depthCam->PointCloudDecimation(), 2u);
+  EXPECT_DOUBLE_EQ(depthCam->PointCloudMaxRange(), 1.2);
+
+  unsigned int width = depthCam->ImageWidth() / 2;
+  unsigned int height = depthCam->ImageHeight() / 2;
+  std::vector<float> points;
+  std::mutex pointsMutex;
+  event::ConnectionPtr c = depthCam->ConnectNewRGBPointCloud(
+      [&](const float *_points, unsigned int _width, unsigned int _height,
+          unsigned int /*_depth*/, const std::string &/*_format*/)
+      {
+        std::lock_guard<std::mutex> lock(pointsMutex);
+        if (_width == width && _height == height)
+          points.assign(_points, _points + _width * _height * 4);
+      });
+
+  for (int i = 0; i < 300; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(pointsMutex);
+      if (!points.empty())
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+  c.reset();
+
+  std::lock_guard<std::mutex> lock(pointsMutex);
+  ASSERT_EQ(points.size(), width * height * 4);
+
+  // The top right box is 0.5 meters away
+  unsigned int idx = ((height / 4) * width + width * 3 / 4) * 4;
+  EXPECT_NEAR(points[idx + 2], 0.5, 1e-4);
+
+  // The bottom left box is beyond range, like the pixels that see nothing
+  idx = ((height * 3 / 4) * width + width / 4) * 4;
+  EXPECT_NEAR(points[idx + 2], depthCam->FarClip(), 1e-4);
+}
+
 /////////////////////////////////////////////////
 TEST_F(CameraSensor, LensFlare)
 {
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+#include <thread>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/transport/LockstepChannel.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class CosimPluginTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(CosimPluginTest, Lockstep)
+{
+  Load("worlds/cosim_plugin.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::JointPtr joint = world->ModelByName("turntable")->GetJoint("hinge");
+  ASSERT_TRUE(joint != nullptr);
+
+  transport::LockstepChannel channel;
+  ASSERT_TRUE(channel.Open("gazebo_cosim_test"));
+
+  // The controller applies a constant torque, and sees every iteration
+  const int stepCount = 100;
+  std::thread controller([&]
+  {
+    std::string data;
+    uint64_t step = 0;
+    uint64_t prevIteration = 0;
+    for (int i = 0; i < stepCount; ++i)
+    {
+      ASSERT_TRUE(channel.WaitForState(data, step, 5000));
+
+      msgs::CosimState state;
+      ASSERT_TRUE(state.ParseFromString(data));
+      ASSERT_EQ(1, state.joint_size());
+      EXPECT_EQ("hinge", state.joint(0));
+      ASSERT_EQ(1, state.position_size());
+      ASSERT_EQ(1, state.velocity_size());
+      if (i > 0)
+        EXPECT_EQ(prevIteration + 1, state.iteration());
+      prevIteration = state.iteration();
+
+      msgs::CosimCommand command;
+      command.add_effort(1.0);
+      command.SerializeToString(&data);
+      EXPECT_TRUE(channel.WriteCommand(data));
+    }
+  });
+
+  world->Step(stepCount);
+  controller.join();
+
+  // 1 N m on 1 kg m^2
+  const double time = stepCount * world->Physics()->GetMaxStepSize();
+  EXPECT_NEAR(time, joint->GetVelocity(0), 0.01);
+
+  // Without a controller the world runs freely
+  channel.Close();
+  world->Step(stepCount);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
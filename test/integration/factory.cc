@@ -1146,6 +1146,54 @@ TEST_F(FactoryTest, FilenameModelDatabase)
   ASSERT_NE(nullptr, world->ModelByName("cococan"));
 }
 
+//////////////////////////////////////////////////
+TEST_F(FactoryTest, AsyncFactory)
+{
+  this->Load("worlds/empty.world", true);
+
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  world->SetAsyncFactory(true);
+  world->SetFactoryBudget(1e-6);
+  EXPECT_TRUE(world->AsyncFactory());
+  EXPECT_DOUBLE_EQ(world->FactoryBudget(), 1e-6);
+
+  // Messages are inserted in order, at least one each time the world
+  // processes its messages
+  auto pub = this->node->Advertise<msgs::Factory>("~/factory");
+  for (int i = 0; i < 3; ++i)
+  {
+    std::ostringstream sdfStr;
+    sdfStr << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='async_box_" << i << "'>"
+      << "<pose>" << i * 2 << " 0 0.5 0 0 0</pose>"
+      << "<link name='link'><collision name='collision'>"
+      << "<geometry><box><size>1 1 1</size></box></geometry>"
+      << "</collision></link></model></sdf>";
+
+    msgs::Factory msg;
+    msg.set_sdf(sdfStr.str());
+    pub->Publish(msg);
+  }
+
+  int sleep = 0;
+  int maxSleep = 50;
+  while (!world->ModelByName("async_box_2") && sleep++ < maxSleep)
+  {
+    common::Time::MSleep(100);
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_NE(nullptr,
+        world->ModelByName("async_box_" + std::to_string(i))) << i;
+  }
+
+  world->SetAsyncFactory(false);
+  EXPECT_FALSE(world->AsyncFactory());
+}
+
 //////////////////////////////////////////////////
 #ifdef HAVE_IGNITION_FUEL_TOOLS
 TEST_F(FactoryTest, FilenameFuelURL)
@@ -15,6 +15,10 @@
  *
 */
 
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <ignition/math/Helpers.hh>
 #include "gazebo/common/Timer.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -672,6 +676,205 @@ TEST_F(GPURaySensorTest, StrictUpdateRate)
   delete [] scan;
 }
 
+/////////////////////////////////////////////////
+/// \brief Test a GPU laser whose field of view is split into several
+/// views, rendered side by side into one texture.
+TEST_F(GPURaySensorTest, WideFieldOfView)
+{
+  Load("worlds/empty_test.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run gpu laser test\n";
+    return;
+  }
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  world->Physics()->SetGravity(ignition::math::Vector3d::Zero);
+
+  const std::string raySensorName = "gpu_ray_sensor_wide";
+  const double hMinAngle = -2.8;
+  const double hMaxAngle = 2.8;
+  const unsigned int samples = 561;
+  SpawnGpuRaySensor("gpu_ray_model_wide", raySensorName,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      hMinAngle, hMaxAngle, 0.1, 10.0, 0.01, samples);
+
+  // One box in each view, each facing the sensor 1.5 m away
+  const std::vector<double> angles = {-2.6, -M_PI / 2.0, 0.0, M_PI / 2.0,
+      2.6};
+  for (size_t i = 0; i < angles.size(); ++i)
+  {
+    SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d(1, 1, 1),
+        ignition::math::Vector3d(2.0 * cos(angles[i]), 2.0 * sin(angles[i]),
+          0.5),
+        ignition::math::Vector3d(0, 0, angles[i]));
+  }
+
+  sensors::GpuRaySensorPtr raySensor =
+    std::dynamic_pointer_cast<sensors::GpuRaySensor>(
+        sensors::get_sensor(raySensorName));
+  ASSERT_TRUE(raySensor != nullptr);
+  EXPECT_GT(raySensor->CameraCount(), 1u);
+  raySensor->SetActive(true);
+
+  // The frames hold the range and the intensity of each ray
+  std::mutex mutex;
+  std::vector<float> frame;
+  unsigned int frameDepth = 0;
+  int scanCount = 0;
+  event::ConnectionPtr c = raySensor->ConnectNewLaserFrame(
+      [&](const float *_scan, unsigned int _width, unsigned int _height,
+          unsigned int _depth, const std::string &)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame.assign(_scan, _scan + _width * _height * _depth);
+        frameDepth = _depth;
+        ++scanCount;
+      });
+
+  int i = 0;
+  while (i < 300)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (scanCount >= 10)
+        break;
+    }
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_LT(i, 300);
+  c.reset();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_GE(frameDepth, 2u);
+  EXPECT_LE(frameDepth, 3u);
+  ASSERT_EQ(samples * frameDepth, frame.size());
+
+  for (const double angle : angles)
+  {
+    const int ray = static_cast<int>(std::round((angle - hMinAngle) /
+        (hMaxAngle - hMinAngle) * (samples - 1)));
+    EXPECT_NEAR(1.5, raySensor->Range(ray), 0.02) << angle;
+    EXPECT_NEAR(raySensor->Range(ray), frame[ray * frameDepth], 0.02);
+  }
+
+  // Nothing between the boxes
+  const int gap = static_cast<int>(std::round((M_PI / 4.0 - hMinAngle) /
+      (hMaxAngle - hMinAngle) * (samples - 1)));
+  EXPECT_DOUBLE_EQ(ignition::math::INF_D, raySensor->Range(gap));
+}
+
+/////////////////////////////////////////////////
+/// \brief Test that the scans match the frame read back by the laser,
+/// through both the buffer and the data iterators.
+TEST_F(GPURaySensorTest, LaserBuffer)
+{
+  Load("worlds/empty_test.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run gpu laser test\n";
+    return;
+  }
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  world->Physics()->SetGravity(ignition::math::Vector3d::Zero);
+
+  const std::string raySensorName = "gpu_ray_sensor_buffer";
+  const double maxRange = 5.0;
+  SpawnGpuRaySensor("gpu_ray_model_buffer", raySensorName,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      -M_PI / 2.0, M_PI / 2.0, 0.1, maxRange, 0.01, 320);
+
+  // A box in front of the sensor, nothing else in range
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(1, 0, 0.5), ignition::math::Vector3d::Zero);
+
+  sensors::GpuRaySensorPtr raySensor =
+    std::dynamic_pointer_cast<sensors::GpuRaySensor>(
+        sensors::get_sensor(raySensorName));
+  ASSERT_TRUE(raySensor != nullptr);
+  rendering::GpuLaserPtr laserCam = raySensor->LaserCamera();
+  ASSERT_TRUE(laserCam != nullptr);
+  raySensor->SetActive(true);
+
+  // The frames are published straight from the buffer
+  std::mutex mutex;
+  int scanCount = 0;
+  bool sameBuffer = true;
+  event::ConnectionPtr c = raySensor->ConnectNewLaserFrame(
+      [&](const float *_scan, unsigned int, unsigned int,
+          unsigned int _depth, const std::string &)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        sameBuffer = sameBuffer && _scan == laserCam->LaserBuffer() &&
+            _depth == laserCam->LaserChannelCount();
+        ++scanCount;
+      });
+
+  int i = 0;
+  while (i < 300)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (scanCount >= 10)
+        break;
+    }
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_LT(i, 300);
+  c.reset();
+
+  // Stop the updates, so that the scan and the buffer hold the same frame
+  raySensor->SetActive(false);
+  common::Time::MSleep(200);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_TRUE(sameBuffer);
+  }
+
+  const float *buffer = laserCam->LaserBuffer();
+  ASSERT_TRUE(buffer != nullptr);
+  const unsigned int channels = laserCam->LaserChannelCount();
+  EXPECT_GE(channels, 2u);
+  EXPECT_LE(channels, 3u);
+
+  std::vector<double> ranges;
+  raySensor->Ranges(ranges);
+  const int rayCount = raySensor->RayCount() * raySensor->VerticalRayCount();
+  ASSERT_EQ(rayCount, static_cast<int>(ranges.size()));
+
+  int ray = 0;
+  for (auto iter = laserCam->LaserDataBegin();
+       iter != laserCam->LaserDataEnd(); ++iter, ++ray)
+  {
+    ASSERT_LT(ray, rayCount);
+    const rendering::GpuLaserData data = *iter;
+    const float *value = buffer + ray * channels;
+    EXPECT_FLOAT_EQ(value[0], data.range);
+    EXPECT_FLOAT_EQ(value[1], data.intensity);
+
+    // Ranges beyond the max are masked to +inf
+    if (value[0] >= maxRange)
+      EXPECT_DOUBLE_EQ(ignition::math::INF_D, ranges[ray]) << ray;
+    else
+      EXPECT_DOUBLE_EQ(value[0], ranges[ray]) << ray;
+  }
+  EXPECT_EQ(rayCount, ray);
+
+  EXPECT_NEAR(0.5, ranges[rayCount / 2], LASER_TOL);
+  EXPECT_DOUBLE_EQ(ignition::math::INF_D, ranges[rayCount - 1]);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
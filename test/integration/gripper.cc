@@ -47,6 +47,10 @@ TEST_F(GripperTest, Close)
   physics::GripperPtr gripper = model->GetGripper(0);
   ASSERT_TRUE(gripper != NULL);
 
+  // The gripper receives the contacts of its collisions directly
+  EXPECT_TRUE(world->Physics()->GetContactManager()->HasFilter(
+      gripper->Name()));
+
   // The gripper should not be attached to anything
   EXPECT_FALSE(gripper->IsAttached());
 
@@ -70,6 +70,10 @@ class HeightmapTest : public ServerFixture,
   public: void TerrainCollision(const std::string &_physicsEngine,
                                 const std::string &_dartCollision = "");
 
+  /// \brief Test dropping a sphere on a heightmap paged from disk
+  /// \param[in] _physicsEngine the physics engine to test
+  public: void TilePaging(const std::string &_physicsEngine);
+
   /// \brief Test loading a heightmap that has no visuals
   public: void NoVisual();
 
@@ -756,15 +760,19 @@ void HeightmapTest::HeightmapCache()
   rendering::Heightmap *h = scene->GetHeightmap();
   EXPECT_NE(h, nullptr);
 
+  // wait for the terrain tile cache to be saved, the sha-1 file is written
+  // last
+  sleep = 0;
+  while ((!common::exists(cachePath) || !common::exists(shaPath)) &&
+      sleep++ < maxSleep)
+  {
+    common::Time::MSleep(100);
+  }
+
   // verify new sha-1 file exists
   EXPECT_TRUE(common::exists(shaPath));
   EXPECT_TRUE(common::isFile(shaPath));
 
-  // wait for the terrain tile cache to be saved
-  sleep = 0;
-  while (!common::exists(cachePath) && sleep++ < maxSleep)
-    common::Time::MSleep(100);
-
   // verify that terrain tile cache exists
   EXPECT_TRUE(common::exists(cachePath));
   EXPECT_TRUE(common::isFile(cachePath));
@@ -884,6 +892,84 @@ void HeightmapTest::TerrainCollision(const std::string &_physicsEngine,
   EXPECT_GE(spherePose.Pos().Z(), (minHeight + radius*0.99));
 }
 
+/////////////////////////////////////////////////
+void HeightmapTest::TilePaging(const std::string &_physicsEngine)
+{
+  if (_physicsEngine != "ode" && _physicsEngine != "bullet")
+  {
+    gzerr << "Aborting test for " << _physicsEngine
+          << ", it doesn't page heightmaps" << std::endl;
+    return;
+  }
+
+  Load("worlds/empty.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_NE(world, nullptr);
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_NE(physics, nullptr);
+
+  boost::any value;
+  EXPECT_TRUE(physics->GetParam("heightmap_tile_paging", value));
+  EXPECT_FALSE(boost::any_cast<bool>(value));
+  EXPECT_TRUE(physics->SetParam("heightmap_tile_paging", true));
+  EXPECT_FALSE(physics->SetParam("heightmap_tile_cache_size", 0));
+  EXPECT_TRUE(physics->SetParam("heightmap_tile_cache_size", 4));
+  EXPECT_TRUE(physics->GetParam("heightmap_tile_cache_size", value));
+  EXPECT_EQ(4, boost::any_cast<int>(value));
+
+  // Heightmaps inserted from now on are paged
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='heightmap'>"
+    << "  <static>true</static>"
+    << "  <link name='link'>"
+    << "    <collision name='collision'>"
+    << "      <geometry>"
+    << "        <heightmap>"
+    << "          <uri>"
+    << "file://media/materials/textures/heightmap_valley.png</uri>"
+    << "          <size>17 17 10</size>"
+    << "          <pos>0 0 0</pos>"
+    << "        </heightmap>"
+    << "      </geometry>"
+    << "    </collision>"
+    << "  </link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+
+  physics::ModelPtr heightmap = GetModel("heightmap");
+  ASSERT_NE(heightmap, nullptr);
+  physics::HeightmapShapePtr shape =
+    boost::dynamic_pointer_cast<physics::HeightmapShape>(
+        heightmap->GetLink("link")->GetCollision("collision")->GetShape());
+  ASSERT_NE(shape, nullptr);
+  EXPECT_TRUE(shape->Pyramid().Paged());
+  EXPECT_GT(shape->Pyramid().LevelCount(), 1u);
+  EXPECT_LT(shape->GetMinHeight(), shape->GetMaxHeight());
+  EXPECT_LE(shape->Pyramid().ResidentTileCount(), 4u);
+
+  if (_physicsEngine == "bullet")
+  {
+    gzerr << "Skipping collision test for bullet. See issue #2506"
+          << std::endl;
+    return;
+  }
+
+  // The sphere rolls into the valley, reading the heights from the tiles
+  SpawnSphere("test_sphere", ignition::math::Vector3d(0, 0, 12),
+      ignition::math::Vector3d::Zero);
+  physics::ModelPtr sphere = GetModel("test_sphere");
+  ASSERT_NE(sphere, nullptr);
+  world->Step(5000);
+
+  const double minHeight = shape->GetMinHeight();
+  const double radius = 0.5;
+  EXPECT_LE(sphere->WorldPose().Pos().Z(), minHeight + radius * 1.01);
+  EXPECT_GE(sphere->WorldPose().Pos().Z(), minHeight + radius * 0.99);
+  EXPECT_LE(shape->Pyramid().ResidentTileCount(), 4u);
+}
+
 /////////////////////////////////////////////////
 TEST_F(HeightmapTest, NotSquareImage)
 {
@@ -1031,6 +1117,12 @@ TEST_P(HeightmapTest, TerrainCollision)
   TerrainCollision(param);
 }
 
+/////////////////////////////////////////////////
+TEST_P(HeightmapTest, TilePaging)
+{
+  TilePaging(GetParam());
+}
+
 /////////////////////////////////////////////////
 // TerrainCollision() call for Dart using Bullet.
 // We could do the same for ODE but this is disabled
@@ -173,6 +173,66 @@ TEST_F(JointControllerTest, JointCmd)
   EXPECT_DOUBLE_EQ(velPids[jointName].GetDGain(), 9);
 }
 
+/////////////////////////////////////////////////
+// Check that targets changed every step, commands added to a running
+// controller and removed joints are all taken into account
+TEST_F(JointControllerTest, ChangeCommands)
+{
+  Load("worlds/simple_arm_test.world", true);
+  gazebo::physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  gazebo::physics::ModelPtr model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != NULL);
+  gazebo::physics::JointControllerPtr jointController =
+    model->GetJointController();
+  ASSERT_TRUE(jointController != NULL);
+
+  gazebo::physics::JointPtr pan = model->GetJoint("arm_shoulder_pan_joint");
+  ASSERT_TRUE(pan != NULL);
+  gazebo::physics::JointPtr elbow = model->GetJoint("arm_elbow_pan_joint");
+  ASSERT_TRUE(elbow != NULL);
+  const std::string panName = pan->GetScopedName();
+  const std::string elbowName = elbow->GetScopedName();
+
+  world->Step(100);
+
+  // Velocity control of the shoulder
+  jointController->SetVelocityPID(panName, common::PID(10.0, 0.1, 0.1));
+  EXPECT_TRUE(jointController->SetVelocityTarget(panName, 0.2));
+  world->Step(5000);
+  EXPECT_NEAR(pan->GetVelocity(0), 0.2, 0.05);
+
+  // Change the target on every step
+  for (int i = 0; i < 5000; ++i)
+  {
+    EXPECT_TRUE(jointController->SetVelocityTarget(panName, -0.3));
+    world->Step(1);
+  }
+  EXPECT_NEAR(pan->GetVelocity(0), -0.3, 0.05);
+  EXPECT_EQ(jointController->GetVelocities().size(), 1u);
+
+  // Add position control of the elbow, the shoulder keeps its velocity
+  jointController->SetPositionPID(elbowName, common::PID(10.0, 0.1, 4.5));
+  EXPECT_TRUE(jointController->SetPositionTarget(elbowName, 0.5));
+  world->Step(5000);
+  EXPECT_NEAR(elbow->Position(0), 0.5, 0.1);
+  EXPECT_NEAR(pan->GetVelocity(0), -0.3, 0.05);
+
+  // Unknown joints are rejected
+  EXPECT_FALSE(jointController->SetVelocityTarget("simple_arm::bogus", 1.0));
+
+  // Remove the shoulder, the elbow is still controlled
+  jointController->RemoveJoint(pan.get());
+  EXPECT_EQ(jointController->GetJoints().count(panName), 0u);
+  world->Step(5000);
+  EXPECT_NEAR(elbow->Position(0), 0.5, 0.1);
+
+  // Without commands, the damping stops the shoulder
+  jointController->Reset();
+  world->Step(5000);
+  EXPECT_NEAR(pan->GetVelocity(0), 0.0, 0.05);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <utility>
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/Joint.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -61,6 +62,12 @@ class JointForceTorqueTest : public ServerFixture,
   /// Apply force and check acceleration against analytical solution.
   /// \param[in] _physicsEngine Type of physics engine to use.
   public: void JointTorqueTest(const std::string &_physicsEngine);
+
+  /// \brief Load example world with a few joints.
+  /// Monitor the wrench of the joints in the physics engine and compare it
+  /// with Joint::GetForceTorque.
+  /// \param[in] _physicsEngine Type of physics engine to use.
+  public: void MonitoredJointWrench(const std::string &_physicsEngine);
 };
 
 /////////////////////////////////////////////////
@@ -622,6 +629,58 @@ void JointForceTorqueTest::JointTorqueTest(const std::string &_physicsEngine)
   }
 }
 
+/////////////////////////////////////////////////
+void JointForceTorqueTest::MonitoredJointWrench(
+    const std::string &_physicsEngine)
+{
+  Load("worlds/force_torque_test.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+  physics->SetGravity(ignition::math::Vector3d(0, 0, -50));
+
+  physics::ModelPtr model_1 = world->ModelByName("model_1");
+  ASSERT_TRUE(model_1 != NULL);
+  physics::JointPtr joint_01 = model_1->GetJoint("joint_01");
+  physics::JointPtr joint_12 = model_1->GetJoint("joint_12");
+  ASSERT_TRUE(joint_01 != NULL);
+  ASSERT_TRUE(joint_12 != NULL);
+
+  const unsigned int index_01 = physics->AddJointWrenchMonitor(joint_01);
+  const unsigned int index_12 = physics->AddJointWrenchMonitor(joint_12);
+  EXPECT_NE(index_01, index_12);
+
+  // Zero before the first update
+  EXPECT_EQ(physics->MonitoredJointWrench(index_01).body1Force,
+      ignition::math::Vector3d::Zero);
+
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    world->Step(1);
+    for (auto const &monitor : {std::make_pair(joint_01, index_01),
+        std::make_pair(joint_12, index_12)})
+    {
+      physics::JointWrench expected = monitor.first->GetForceTorque(0u);
+      physics::JointWrench wrench =
+          physics->MonitoredJointWrench(monitor.second);
+      EXPECT_EQ(wrench.body1Force, expected.body1Force);
+      EXPECT_EQ(wrench.body1Torque, expected.body1Torque);
+      EXPECT_EQ(wrench.body2Force, expected.body2Force);
+      EXPECT_EQ(wrench.body2Torque, expected.body2Torque);
+    }
+  }
+  EXPECT_FLOAT_EQ(physics->MonitoredJointWrench(index_01).body1Force.Z(),
+      1000.0);
+
+  // Free slots are reused
+  physics->RemoveJointWrenchMonitor(index_01);
+  EXPECT_EQ(index_01, physics->AddJointWrenchMonitor(joint_01));
+  EXPECT_EQ(physics->MonitoredJointWrench(index_01).body1Force,
+      ignition::math::Vector3d::Zero);
+}
+
+/////////////////////////////////////////////////
 TEST_P(JointForceTorqueTest, ForceTorque1)
 {
   ForceTorque1(GetParam());
@@ -647,6 +706,11 @@ TEST_P(JointForceTorqueTest, JointTorqueTest)
   JointTorqueTest(GetParam());
 }
 
+TEST_P(JointForceTorqueTest, MonitoredJointWrench)
+{
+  MonitoredJointWrench(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, JointForceTorqueTest,
                         PHYSICS_ENGINE_VALUES,);  // NOLINT
 
@@ -17,6 +17,7 @@
 
 #include <boost/algorithm/string/replace.hpp>
 
+#include "gazebo/physics/LinkDataRegistry.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -91,6 +92,94 @@ TEST_F(LinkTest, StaticWrench)
   EXPECT_EQ(model0->WorldPose(), model0Initial);
 }
 
+/////////////////////////////////////////////////
+// Latest batched link data.
+static msgs::LinkData_V g_linkDataMsg;
+
+/////////////////////////////////////////////////
+// Callback for the batched link data.
+void OnLinkData(ConstLinkData_VPtr &_msg)
+{
+  g_linkDataMsg.CopyFrom(*_msg);
+}
+
+/////////////////////////////////////////////////
+// Latest link data of a single link.
+static msgs::LinkData g_singleLinkDataMsg;
+
+/////////////////////////////////////////////////
+// Callback for the link data of a single link.
+void OnSingleLinkData(ConstLinkDataPtr &_msg)
+{
+  g_singleLinkDataMsg.CopyFrom(*_msg);
+}
+
+/////////////////////////////////////////////////
+// This tests the link data sampled by the world for the links that
+// requested it
+TEST_F(LinkTest, PublishData)
+{
+  this->Load("test/worlds/static.world", true);
+  auto world = physics::get_world();
+  ASSERT_TRUE(world != nullptr);
+
+  auto link = this->GetModel("model_1")->GetLink("link");
+  ASSERT_TRUE(link != nullptr);
+
+  physics::LinkDataRegistry &registry = world->LinkData();
+  EXPECT_EQ(0u, registry.LinkCount());
+
+  // Requests are counted
+  link->SetPublishData(true);
+  link->SetPublishData(true);
+  EXPECT_EQ(1u, registry.LinkCount());
+
+  physics::LinkDataRegistry::Sample sample;
+  EXPECT_FALSE(registry.Data(link.get(), sample));
+
+  auto sub = this->node->Subscribe("~/link_data", &OnLinkData);
+  auto singleSub = this->node->Subscribe("~/" + link->GetScopedName(),
+      &OnSingleLinkData);
+
+  for (int i = 0; i < 50 && (g_linkDataMsg.link_data_size() == 0 ||
+       !g_singleLinkDataMsg.has_name()); ++i)
+  {
+    world->Step(1);
+    common::Time::MSleep(10);
+  }
+
+  ASSERT_TRUE(registry.Data(link.get(), sample));
+  EXPECT_EQ(world->SimTime(), sample.time);
+  EXPECT_EQ(link->WorldLinearVel(), sample.linearVel);
+  EXPECT_EQ(link->WorldAngularVel(), sample.angularVel);
+
+  ASSERT_EQ(1, g_linkDataMsg.link_data_size());
+  EXPECT_EQ(link->GetScopedName(), g_linkDataMsg.link_data(0).name());
+
+  // The link still publishes on its own topic
+  ASSERT_TRUE(g_singleLinkDataMsg.has_name());
+  EXPECT_EQ(link->GetScopedName(), g_singleLinkDataMsg.name());
+  EXPECT_TRUE(g_singleLinkDataMsg.has_linear_velocity());
+  EXPECT_TRUE(g_singleLinkDataMsg.has_angular_velocity());
+
+  // The link is removed once both requests are withdrawn
+  link->SetPublishData(false);
+  EXPECT_EQ(1u, registry.LinkCount());
+  link->SetPublishData(false);
+  EXPECT_EQ(0u, registry.LinkCount());
+  EXPECT_FALSE(registry.Data(link.get(), sample));
+  EXPECT_FALSE(registry.Contains(link.get()));
+
+  // Nothing is published on the link topic anymore
+  g_singleLinkDataMsg.Clear();
+  for (int i = 0; i < 10; ++i)
+  {
+    world->Step(1);
+    common::Time::MSleep(10);
+  }
+  EXPECT_FALSE(g_singleLinkDataMsg.has_name());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
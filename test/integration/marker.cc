@@ -595,5 +595,143 @@ void Marker_TEST::CornerCases()
   delete mainWindow;
 }
 
+/////////////////////////////////////////////////
+void Marker_TEST::Bulk()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty_bright.world", false, false, false);
+
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != nullptr);
+
+  // Create the main window.
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  QVERIFY(scene != nullptr);
+
+  // Create our node for communication
+  ignition::transport::Node node;
+
+  std::string bulkTopic = "/marker/bulk";
+  std::string markerTopic = "/marker";
+  std::string listTopic = "/marker/list";
+
+  std::vector<std::string> serviceList;
+  node.ServiceList(serviceList);
+  QVERIFY(std::find(serviceList.begin(), serviceList.end(), bulkTopic)
+          != serviceList.end());
+
+  node.Advertise<ignition::msgs::Marker_V>(bulkTopic);
+  node.Advertise<ignition::msgs::Marker>(markerTopic);
+  node.Advertise<ignition::msgs::Marker_V>(listTopic);
+
+  auto visCount = scene->VisualCount();
+
+  // A thousand cells, in a single visual
+  gzmsg << "Add bulk boxes" << std::endl;
+  {
+    ignition::msgs::Marker_V bulkMsg;
+    for (unsigned int i = 1; i <= 1000; ++i)
+    {
+      ignition::msgs::Marker *markerMsg = bulkMsg.add_marker();
+      markerMsg->set_ns("cells");
+      markerMsg->set_id(i);
+      markerMsg->set_action(ignition::msgs::Marker::ADD_MODIFY);
+      if (i == 1)
+      {
+        markerMsg->set_type(ignition::msgs::Marker::BOX);
+        markerMsg->mutable_material()->mutable_script()->set_name(
+            "Gazebo/Red");
+      }
+      ignition::msgs::Set(markerMsg->mutable_pose(),
+          ignition::math::Pose3d(i % 10, i / 10 % 10, i / 100, 0, 0, 0));
+      ignition::msgs::Set(markerMsg->mutable_scale(),
+          ignition::math::Vector3d(0.5, 0.5, 0.5));
+    }
+    QVERIFY(node.Request(bulkTopic, bulkMsg));
+  }
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  QVERIFY(scene->GetVisual("__GZ_MARKER_BATCH_VISUAL_cells") != nullptr);
+  QCOMPARE(scene->VisualCount(), visCount + 1);
+
+  {
+    ignition::msgs::Marker_V rep;
+    bool result = false;
+    QVERIFY(node.Request(listTopic, 5000u, rep, result));
+    QVERIFY(result);
+    QCOMPARE(rep.marker_size(), 1000);
+    QVERIFY(rep.marker(0).ns() == "cells");
+    QVERIFY(rep.marker(0).type() == ignition::msgs::Marker::BOX);
+  }
+
+  // Move one cell and delete another, in place
+  gzmsg << "Modify bulk boxes" << std::endl;
+  {
+    ignition::msgs::Marker_V bulkMsg;
+    ignition::msgs::Marker *markerMsg = bulkMsg.add_marker();
+    markerMsg->set_ns("cells");
+    markerMsg->set_id(500);
+    markerMsg->set_action(ignition::msgs::Marker::ADD_MODIFY);
+    ignition::msgs::Set(markerMsg->mutable_pose(),
+        ignition::math::Pose3d(0, 0, 20, 0, 0, 0));
+
+    markerMsg = bulkMsg.add_marker();
+    markerMsg->set_ns("cells");
+    markerMsg->set_id(10);
+    markerMsg->set_action(ignition::msgs::Marker::DELETE_MARKER);
+    QVERIFY(node.Request(bulkTopic, bulkMsg));
+  }
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  {
+    ignition::msgs::Marker_V rep;
+    bool result = false;
+    QVERIFY(node.Request(listTopic, 5000u, rep, result));
+    QVERIFY(result);
+    QCOMPARE(rep.marker_size(), 999);
+
+    bool moved = false;
+    for (int i = 0; i < rep.marker_size(); ++i)
+    {
+      QVERIFY(rep.marker(i).id() != 10u);
+      if (rep.marker(i).id() == 500u)
+      {
+        QVERIFY(ignition::math::equal(
+            rep.marker(i).pose().position().z(), 20.0));
+        moved = true;
+      }
+    }
+    QVERIFY(moved);
+  }
+  QCOMPARE(scene->VisualCount(), visCount + 1);
+
+  // Delete all the markers of the namespace
+  gzmsg << "Delete bulk boxes" << std::endl;
+  {
+    ignition::msgs::Marker markerMsg;
+    markerMsg.set_ns("cells");
+    markerMsg.set_action(ignition::msgs::Marker::DELETE_ALL);
+    QVERIFY(node.Request(markerTopic, markerMsg));
+  }
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  QVERIFY(scene->GetVisual("__GZ_MARKER_BATCH_VISUAL_cells") == nullptr);
+  QCOMPARE(scene->VisualCount(), visCount);
+
+  mainWindow->close();
+  delete mainWindow;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(Marker_TEST)
@@ -29,5 +29,8 @@ class Marker_TEST : public QTestFixture
 
   /// \brief Test corner cases.
   private slots: void CornerCases();
+
+  /// \brief Test adding, moving and removing bulk markers.
+  private slots: void Bulk();
 };
 #endif
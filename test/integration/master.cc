@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/Master.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MasterTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+// Connect a client to the master, and read the init messages.
+transport::ConnectionPtr ConnectClient(const unsigned int _port)
+{
+  transport::ConnectionPtr conn(new transport::Connection());
+  if (!conn->Connect("127.0.0.1", _port))
+    return transport::ConnectionPtr();
+
+  std::string data;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (!conn->Read(data))
+      return transport::ConnectionPtr();
+  }
+  return conn;
+}
+
+/////////////////////////////////////////////////
+// Advertise a topic on a connection to the master.
+void Advertise(const transport::ConnectionPtr &_conn, const std::string &_topic)
+{
+  msgs::Publish pub;
+  pub.set_topic(_topic);
+  pub.set_msg_type("gazebo.msgs.GzString");
+  pub.set_host("127.0.0.1");
+  pub.set_port(12345);
+  _conn->EnqueueMsg(msgs::Package("advertise", pub), true);
+}
+
+/////////////////////////////////////////////////
+// Let the master read and process the messages sent to it.
+void RunMaster(Master &_master)
+{
+  common::Time::MSleep(500);
+  _master.RunOnce();
+}
+
+/////////////////////////////////////////////////
+// The master batches the publisher notifications only for the clients
+// that handle them
+TEST_F(MasterTest, PublisherBatches)
+{
+  // Find a free port for the master
+  unsigned int port;
+  {
+    transport::ConnectionPtr probe(new transport::Connection());
+    probe->Listen(0, [](const transport::ConnectionPtr &) {});
+    port = probe->GetLocalPort();
+    probe->Shutdown();
+  }
+
+  Master master;
+  master.Init(port);
+
+  transport::ConnectionPtr batched = ConnectClient(port);
+  ASSERT_TRUE(batched != nullptr);
+  msgs::Request *req = msgs::CreateRequest("publisher_batches");
+  batched->EnqueueMsg(msgs::Package("request", *req), true);
+  delete req;
+
+  transport::ConnectionPtr unbatched = ConnectClient(port);
+  ASSERT_TRUE(unbatched != nullptr);
+
+  transport::ConnectionPtr publisher = ConnectClient(port);
+  ASSERT_TRUE(publisher != nullptr);
+  RunMaster(master);
+
+  // Both advertisements are processed in the same iteration
+  Advertise(publisher, "/test/master/a");
+  Advertise(publisher, "/test/master/b");
+  RunMaster(master);
+
+  // One batch for the client that asked for it
+  std::string data;
+  msgs::Packet packet;
+  ASSERT_TRUE(batched->Read(data));
+  packet.ParseFromString(data);
+  EXPECT_EQ("publisher_add_batch", packet.type());
+  msgs::Publishers pubs;
+  pubs.ParseFromString(packet.serialized_data());
+  ASSERT_EQ(2, pubs.publisher_size());
+  EXPECT_EQ("/test/master/a", pubs.publisher(0).topic());
+  EXPECT_EQ("/test/master/b", pubs.publisher(1).topic());
+
+  // One message per publisher for the other client
+  const std::string topics[] = {"/test/master/a", "/test/master/b"};
+  for (auto const &topic : topics)
+  {
+    ASSERT_TRUE(unbatched->Read(data));
+    packet.ParseFromString(data);
+    EXPECT_EQ("publisher_add", packet.type());
+    msgs::Publish pub;
+    pub.ParseFromString(packet.serialized_data());
+    EXPECT_EQ(topic, pub.topic());
+  }
+
+  batched->Shutdown();
+  unbatched->Shutdown();
+  publisher->Shutdown();
+  master.Fini();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,7 @@
  *
 */
 #include <string.h>
+#include <vector>
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -154,7 +155,57 @@ TEST_F(ModelTest, SetScale)
   g_modelMsgs.clear();
 }
 
+/////////////////////////////////////////////////
+// This tests the bulk joint state and force accessors.
+TEST_F(ModelTest, JointStates)
+{
+  Load("worlds/simple_arm_test.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  physics::ModelPtr model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != NULL);
+
+  const physics::Joint_V &joints = model->GetJoints();
+  ASSERT_FALSE(joints.empty());
+
+  size_t dof = 0;
+  for (auto const &joint : joints)
+    dof += joint->DOF();
+
+  // Wrong number of forces
+  EXPECT_FALSE(model->SetJointForces(joints,
+        std::vector<double>(dof + 1, 1.0)));
+
+  EXPECT_TRUE(model->SetJointForces(joints, std::vector<double>(dof, 0.5)));
+  world->Step(10);
+  EXPECT_TRUE(model->SetJointForces(joints, std::vector<double>(dof, 0.5)));
+
+  std::vector<double> positions;
+  std::vector<double> velocities;
+  std::vector<double> efforts;
+  model->JointStates(joints, &positions, &velocities, &efforts);
+  ASSERT_EQ(dof, positions.size());
+  ASSERT_EQ(dof, velocities.size());
+  ASSERT_EQ(dof, efforts.size());
+
+  // Same values as the accessors of the joints
+  size_t index = 0;
+  for (auto const &joint : joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i, ++index)
+    {
+      EXPECT_DOUBLE_EQ(joint->Position(i), positions[index]);
+      EXPECT_DOUBLE_EQ(joint->GetVelocity(i), velocities[index]);
+      EXPECT_DOUBLE_EQ(joint->GetForce(i), efforts[index]);
+    }
+  }
+
+  // Only the requested values are read
+  model->JointStates(joints, &positions, nullptr);
+  EXPECT_EQ(dof, positions.size());
+}
 
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -15,6 +15,9 @@
  *
 */
 
+#include <fstream>
+#include <boost/filesystem.hpp>
+
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "test_config.h"
@@ -175,6 +178,42 @@ TEST_F(ModelDatabaseTest, Version)
   EXPECT_TRUE(model.find("model-1_4.sdf") != std::string::npos);
 }
 
+/////////////////////////////////////////////////
+// Check that a world whose includes are downloaded before it is parsed
+// loads every included model, including models included several times
+TEST_F(ModelDatabaseTest, PrefetchIncludes)
+{
+  gazebo::common::SystemPaths::Instance()->AddModelPaths(
+    PROJECT_SOURCE_PATH "/test/models/testdb");
+
+  const boost::filesystem::path worldFile =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_prefetch_%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << "<?xml version='1.0'?><sdf version='1.6'><world name='default'>"
+        << "<include><uri>model://cococan</uri><name>can_0</name>"
+        << "<pose>0 0 0 0 0 0</pose></include>"
+        << "<include><uri>model://cococan</uri><name>can_1</name>"
+        << "<pose>1 0 0 0 0 0</pose></include>"
+        << "</world></sdf>";
+  }
+
+  Load(worldFile.string(), true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+  EXPECT_NE(nullptr, world->ModelByName("can_0"));
+  EXPECT_NE(nullptr, world->ModelByName("can_1"));
+
+  // The model resolves locally, without a download
+  const std::string path =
+    common::ModelDatabase::Instance()->GetModelPathAsync(
+        "model://cococan").get();
+  EXPECT_NE(std::string::npos, path.find("testdb/cococan")) << path;
+
+  boost::filesystem::remove(worldFile);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
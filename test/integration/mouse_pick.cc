@@ -553,5 +553,103 @@ void MousePickingTest::DistantMovement()
   delete mainWindow;
 }
 
+/////////////////////////////////////////////////
+void MousePickingTest::RepeatedPick()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/shapes.world", false, false, false);
+
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != NULL);
+  // Create the main window.
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  // Get the user camera and scene
+  gazebo::rendering::UserCameraPtr cam = gazebo::gui::get_active_camera();
+  QVERIFY(cam != NULL);
+  gazebo::rendering::ScenePtr scene = cam->GetScene();
+  QVERIFY(scene != NULL);
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  gazebo::rendering::VisualPtr boxVis = scene->GetVisual("box");
+  QVERIFY(boxVis != NULL);
+  gazebo::rendering::VisualPtr sphereVis = scene->GetVisual("sphere");
+  QVERIFY(sphereVis != NULL);
+
+  // Keep the physics from moving the visuals
+  this->SetPause(true);
+
+  // look at the shapes from -x, with the box turned about z
+  cam->SetWorldPose(ignition::math::Pose3d(
+      ignition::math::Vector3d(-5, 0.0, 0.5),
+      ignition::math::Quaterniond::Identity));
+  const double yaw = 0.3;
+  boxVis->SetWorldPose(ignition::math::Pose3d(0, 0, 0.5, 0, 0, yaw));
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  // The ray through the center of the box hits its turned front face
+  auto pickPt = cam->Project(boxVis->WorldPose().Pos());
+  gazebo::rendering::RayQuery rayQuery(cam);
+  ignition::math::Vector3d intersect;
+  ignition::math::Triangle3d triangle;
+  QVERIFY(rayQuery.SelectMeshTriangle(pickPt.X(), pickPt.Y(),
+      scene->WorldVisual(), intersect, triangle));
+  QVERIFY(ignition::math::equal(intersect.X(), -0.5 / cos(yaw), 1e-2));
+  QVERIFY(ignition::math::equal(intersect.Y(), 0.0, 1e-2));
+  QVERIFY(ignition::math::equal(intersect.Z(), 0.5, 1e-2));
+
+  // The triangle is given in world coordinates, on the front face
+  ignition::math::Quaterniond rot(0, 0, yaw);
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    auto local = rot.RotateVectorReverse(
+        triangle[i] - ignition::math::Vector3d(0, 0, 0.5));
+    QVERIFY(ignition::math::equal(local.X(), -0.5, 1e-4));
+  }
+
+  // The ray misses the sphere next to the box
+  QVERIFY(!rayQuery.SelectMeshTriangle(pickPt.X(), pickPt.Y(), sphereVis,
+      intersect, triangle));
+
+  // Pick the box twice at the same pixel
+  ignition::math::Vector2i pt(pickPt.X(), pickPt.Y());
+  gazebo::rendering::VisualPtr vis = cam->Visual(pt);
+  QVERIFY(vis != NULL);
+  QVERIFY(vis->GetRootVisual() == boxVis);
+  vis = cam->Visual(pt);
+  QVERIFY(vis != NULL);
+  QVERIFY(vis->GetRootVisual() == boxVis);
+
+  // Move the box out of the way. Until the next frame is rendered, the
+  // pick at the same pixel is reused.
+  boxVis->SetWorldPose(ignition::math::Pose3d(0, 0, 10.5, 0, 0, 0));
+  vis = cam->Visual(pt);
+  QVERIFY(vis != NULL);
+  QVERIFY(vis->GetRootVisual() == boxVis);
+
+  // After a frame, the pick sees the moved box
+  this->ProcessEventsAndDraw(mainWindow);
+  vis = cam->Visual(pt);
+  QVERIFY(vis == NULL || vis->GetRootVisual() != boxVis);
+
+  // Moving the camera picks again without waiting for a frame
+  cam->SetWorldPose(ignition::math::Pose3d(
+      ignition::math::Vector3d(-5, 0.0, 10.5),
+      ignition::math::Quaterniond::Identity));
+  vis = cam->Visual(pt);
+  QVERIFY(vis != NULL);
+  QVERIFY(vis->GetRootVisual() == boxVis);
+
+  cam->Fini();
+  mainWindow->close();
+  delete mainWindow;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(MousePickingTest)
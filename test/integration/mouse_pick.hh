@@ -39,6 +39,10 @@ class MousePickingTest : public QTestFixture
 
   /// \brief Testing mouse movement at a distance.
   private slots: void DistantMovement();
+
+  /// \brief Verify picks at the same pixel are reused until the next frame,
+  /// and mesh triangles are selected on transformed visuals.
+  private slots: void RepeatedPick();
 };
 
 #endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+class MultipleWorlds : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+// Load a file that contains several worlds and check that they are
+// independent from each other.
+TEST_F(MultipleWorlds, Load)
+{
+  this->Load("test/worlds/multiple_worlds.world", true);
+
+  // The duplicate world must have been skipped
+  EXPECT_EQ(physics::worlds().size(), 2u);
+
+  physics::WorldPtr first = physics::get_world("first_world");
+  ASSERT_TRUE(first != nullptr);
+  physics::WorldPtr second = physics::get_world("second_world");
+  ASSERT_TRUE(second != nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_NE(first->Physics(), second->Physics());
+
+  EXPECT_TRUE(first->ModelByName("box") != nullptr);
+  EXPECT_TRUE(second->ModelByName("box") == nullptr);
+  EXPECT_TRUE(second->ModelByName("ground_plane") != nullptr);
+
+  // Stepping one world leaves the other one untouched
+  first->Step(10);
+  EXPECT_EQ(first->Iterations(), 10u);
+  EXPECT_EQ(second->Iterations(), 0u);
+}
+
+/////////////////////////////////////////////////
+// Loading fails when no world of the file can be loaded.
+TEST_F(MultipleWorlds, LoadFailure)
+{
+  this->Load("test/worlds/multiple_worlds.world", true);
+  ASSERT_TRUE(this->server != nullptr);
+  EXPECT_EQ(physics::worlds().size(), 2u);
+
+  // Only a world whose name is already in use
+  EXPECT_FALSE(this->server->LoadString(
+      "<sdf version='1.6'><world name='first_world'/></sdf>"));
+
+  // No world at all
+  EXPECT_FALSE(this->server->LoadString(
+      "<sdf version='1.6'><model name='box'><link name='link'/></model>"
+      "</sdf>"));
+
+  EXPECT_EQ(physics::worlds().size(), 2u);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -46,6 +46,7 @@ class PhysicsTest : public ServerFixture,
   public: void JointDampingTest(const std::string &_physicsEngine);
   public: void DropStuff(const std::string &_physicsEngine);
   public: void SpawnFixedJoint(const std::string &_physicsEngine);
+  public: void SpawnKeepsState(const std::string &_physicsEngine);
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -1569,6 +1570,40 @@ TEST_P(PhysicsTest, SpawnFixedJoint)
   SpawnFixedJoint(GetParam());
 }
 
+/////////////////////////////////////////////////
+// This test verifies that spawning a model does not change the state of the
+// models that are already simulated, including their joints.
+void PhysicsTest::SpawnKeepsState(const std::string &_physicsEngine)
+{
+  Load("worlds/simple_pendulums.world", true, _physicsEngine);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::ModelPtr model = world->ModelByName("model_1");
+  ASSERT_TRUE(model != NULL);
+  physics::JointPtr joint = model->GetJoint("joint_0");
+  ASSERT_TRUE(joint != NULL);
+
+  world->Step(500);
+  const double position = joint->Position(0);
+  const double velocity = joint->GetVelocity(0);
+  EXPECT_GT(fabs(velocity), 0.0);
+
+  // The world is paused, the pendulum must not move while the box spawns
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 20, 10));
+  ASSERT_TRUE(world->ModelByName("box") != NULL);
+
+  EXPECT_NEAR(joint->Position(0), position, 1e-6);
+  EXPECT_NEAR(joint->GetVelocity(0), velocity, 1e-6);
+}
+
+TEST_P(PhysicsTest, SpawnKeepsState)
+{
+  SpawnKeepsState(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, PhysicsTest, PHYSICS_ENGINE_VALUES,);  // NOLINT
 
 int main(int argc, char **argv)
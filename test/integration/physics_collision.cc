@@ -38,6 +38,11 @@ class PhysicsCollisionTest : public ServerFixture,
   /// and verify that they have matching behavior.
   /// \param[in] _physicsEngine Type of physics engine to use.
   public: void PoseOffsets(const std::string &_physicsEngine);
+
+  /// \brief Shoot a small fast sphere at a thin wall, and verify that it
+  /// doesn't tunnel through with continuous collision detection.
+  /// \param[in] _physicsEngine Type of physics engine to use.
+  public: void ContinuousCollision(const std::string &_physicsEngine);
 };
 
 /////////////////////////////////////////////////
@@ -349,6 +354,62 @@ TEST_F(PhysicsCollisionTest, ModelSelfCollide)
   Unload();
 }
 
+/////////////////////////////////////////////////
+void PhysicsCollisionTest::ContinuousCollision(
+    const std::string &_physicsEngine)
+{
+  if (_physicsEngine == "simbody")
+  {
+    gzerr << "Continuous collision detection not supported by "
+          << _physicsEngine << std::endl;
+    return;
+  }
+
+  Load("worlds/empty.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // 1 cm thick wall
+  SpawnBox("wall", ignition::math::Vector3d(0.01, 2, 2),
+      ignition::math::Vector3d(1, 0, 1), ignition::math::Vector3d::Zero,
+      true);
+
+  // 2 cm radius sphere, with continuous collision detection
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name ='projectile'>"
+    << "<pose>0.05 0 1 0 0 0</pose>"
+    << "<link name=\"link\">"
+      << "<gz:ccd>true</gz:ccd>"
+      << "<inertial><mass>0.01</mass></inertial>"
+      << "<collision name=\"collision\">"
+        << "<geometry>"
+          << "<sphere><radius>0.02</radius></sphere>"
+        << "</geometry>"
+      << "</collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+  physics::ModelPtr model = world->ModelByName("projectile");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink("link");
+  ASSERT_TRUE(link != nullptr);
+  EXPECT_TRUE(link->ContinuousCollision());
+
+  // 10 cm per step, more than the sphere and the wall together, so that
+  // no step ends with the sphere overlapping the wall
+  const double dt = world->Physics()->GetMaxStepSize();
+  link->SetLinearVel(ignition::math::Vector3d(0.1 / dt, 0, 0));
+  world->Step(30);
+  EXPECT_LT(link->WorldPose().Pos().X(), 1.0);
+
+  link->SetContinuousCollision(false);
+  EXPECT_FALSE(link->ContinuousCollision());
+
+  Unload();
+}
+
 /////////////////////////////////////////////////
 TEST_P(PhysicsCollisionTest, GetBoundingBox)
 {
@@ -361,6 +422,12 @@ TEST_P(PhysicsCollisionTest, PoseOffsets)
   PoseOffsets(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(PhysicsCollisionTest, ContinuousCollision)
+{
+  ContinuousCollision(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, PhysicsCollisionTest,
                         PHYSICS_ENGINE_VALUES,);  // NOLINT
 
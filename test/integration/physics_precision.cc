@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <string>
+
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/physics/physics.hh"
+#include "SimplePendulumIntegrator.hh"
+
+using namespace gazebo;
+
+// Trajectory regression tests for the precision of the bundled ODE, see
+// ODE_SINGLE_PRECISION. The same trajectories are checked against a double
+// precision reference with a tolerance that depends on the build.
+class PhysicsPrecisionTest : public ServerFixture
+{
+  /// \brief Check whether ODE was built with single precision dReal.
+  /// \param[in] _physics The ODE physics engine.
+  /// \return True for a single precision build.
+  public: static bool SinglePrecision(physics::PhysicsEnginePtr _physics)
+  {
+    std::string precision;
+    EXPECT_NO_THROW(precision = boost::any_cast<std::string>(
+        _physics->GetParam("precision")));
+    return precision == "single";
+  }
+};
+
+/////////////////////////////////////////////////
+// A falling box follows the semi-implicit Euler trajectory of the solver.
+TEST_F(PhysicsPrecisionTest, FreeFall)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_EQ(physics->GetType(), "ode");
+
+  const double tol = SinglePrecision(physics) ? 1e-3 : 1e-6;
+
+  const double z0 = 10.0;
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, z0));
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+
+  const double dt = physics->GetMaxStepSize();
+  const double g = world->Gravity().Z();
+
+  double z = z0;
+  double vel = 0;
+  for (int i = 0; i < 1000; ++i)
+  {
+    world->Step(1);
+    vel += g * dt;
+    z += vel * dt;
+
+    const ignition::math::Pose3d pose = model->WorldPose();
+    EXPECT_NEAR(pose.Pos().Z(), z, tol);
+    EXPECT_NEAR(pose.Pos().X(), 0.0, tol);
+    EXPECT_NEAR(pose.Pos().Y(), 0.0, tol);
+    EXPECT_NEAR(model->WorldLinearVel().Z(), vel, tol);
+  }
+}
+
+/////////////////////////////////////////////////
+// A simple pendulum released horizontally follows the reference solution
+// of SimplePendulumIntegrator.
+TEST_F(PhysicsPrecisionTest, SimplePendulum)
+{
+  Load("worlds/simple_pendulums.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  const double tol = SinglePrecision(physics) ? 0.05 : 0.01;
+
+  physics::ModelPtr model = world->ModelByName("model_1");
+  ASSERT_TRUE(model != nullptr);
+  physics::JointPtr joint = model->GetJoint("joint_0");
+  ASSERT_TRUE(joint != nullptr);
+
+  physics->SetMaxStepSize(0.0001);
+  physics->SetParam("iters", 1000);
+
+  const double g = 9.81;
+  const double l = 10.0;
+  for (int i = 0; i < 5; ++i)
+  {
+    world->Step(2000);
+
+    const double expected = PendulumAngle(g, l, 1.57079633, 0.0,
+        world->SimTime().Double(), 0.000001) - 1.5707963;
+    EXPECT_NEAR(joint->Position(0), expected, tol);
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -285,6 +285,57 @@ TEST_F(PresetManagerTest, BackwardsCompatibilityTest)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(PresetManagerTest, RequestProfile)
+{
+  Load("test/worlds/presets.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physicsEngine = world->Physics();
+  physics::PresetManagerPtr presetManager = world->PresetMgr();
+  ASSERT_TRUE(presetManager != nullptr);
+  EXPECT_EQ(presetManager->CurrentProfile(), "preset_1");
+
+  EXPECT_FALSE(presetManager->RequestProfile("missing"));
+  EXPECT_TRUE(presetManager->PendingProfile().empty());
+
+  // Nothing changes until the next step
+  EXPECT_TRUE(presetManager->RequestProfile("unused"));
+  EXPECT_TRUE(presetManager->RequestProfile("preset_2"));
+  EXPECT_EQ(presetManager->PendingProfile(), "preset_2");
+  EXPECT_EQ(presetManager->CurrentProfile(), "preset_1");
+  EXPECT_EQ(boost::any_cast<int>(physicsEngine->GetParam("iters")), 50);
+
+  world->Step(1);
+  EXPECT_TRUE(presetManager->PendingProfile().empty());
+  EXPECT_EQ(presetManager->CurrentProfile(), "preset_2");
+  EXPECT_EQ(boost::any_cast<int>(physicsEngine->GetParam("iters")), 100);
+  EXPECT_FLOAT_EQ(boost::any_cast<double>(physicsEngine->GetParam("sor")),
+      1.5);
+
+  // Switching back applies the parameter block of the first switch
+  EXPECT_TRUE(presetManager->RequestProfile("preset_1"));
+  world->Step(1);
+  EXPECT_EQ(presetManager->CurrentProfile(), "preset_1");
+  EXPECT_EQ(boost::any_cast<int>(physicsEngine->GetParam("iters")), 50);
+  EXPECT_FLOAT_EQ(boost::any_cast<double>(physicsEngine->GetParam("cfm")),
+      0.01);
+
+  // A changed parameter is applied at the next switch
+  EXPECT_TRUE(presetManager->SetProfileParam("preset_2", "iters", 75));
+  EXPECT_TRUE(presetManager->RequestProfile("preset_2"));
+  world->Step(1);
+  EXPECT_EQ(boost::any_cast<int>(physicsEngine->GetParam("iters")), 75);
+
+  // Batch steps switch profiles too
+  EXPECT_TRUE(presetManager->RequestProfile("preset_1"));
+  world->BatchStep(1);
+  EXPECT_TRUE(presetManager->PendingProfile().empty());
+  EXPECT_EQ(presetManager->CurrentProfile(), "preset_1");
+  EXPECT_EQ(boost::any_cast<int>(physicsEngine->GetParam("iters")), 50);
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, PresetManagerTest,
                         PHYSICS_ENGINE_VALUES,);  // NOLINT
 
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 
+#include "gazebo/gazebo_config.h"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/physics/physics.hh"
 #include "SimplePendulumIntegrator.hh"
@@ -36,6 +37,33 @@ class PhysicsTest : public ServerFixture,
               const std::string &_worldSolverType);
 };
 
+class ParallelQuickTest : public ServerFixture
+{
+  /// \brief Step the world with an ODE step type and record the final
+  /// positions of the stacked boxes.
+  /// \param[in] _world The world, reset before stepping.
+  /// \param[in] _stepType ODE step type.
+  /// \param[in] _steps Number of steps.
+  /// \return Final box positions, indexed by model name.
+  public: std::map<std::string, ignition::math::Vector3d> StackPositions(
+              physics::WorldPtr _world, const std::string &_stepType,
+              const unsigned int _steps);
+};
+
+class RowThreadsTest : public ServerFixture
+{
+  /// \brief Step the world with the quick step type and a number of row
+  /// threads and record the final model positions.
+  /// \param[in] _world The world, reset before stepping.
+  /// \param[in] _threads Number of row threads.
+  /// \param[in] _deterministic Value of the deterministic_rows parameter.
+  /// \param[in] _steps Number of steps.
+  /// \return Final model positions, indexed by model name.
+  public: std::map<std::string, ignition::math::Vector3d> Positions(
+              physics::WorldPtr _world, const int _threads,
+              const bool _deterministic, const unsigned int _steps);
+};
+
 ////////////////////////////////////////////////////////////////////////
 void PhysicsTest::DropTest(const std::string &_physicsEngine,
     const std::string &_solverType,
@@ -121,6 +149,146 @@ TEST_P(PhysicsTest, DropTest)
 INSTANTIATE_TEST_CASE_P(WorldStepSolvers, PhysicsTest,
                         WORLD_STEP_SOLVERS,);  // NOLINT
 
+////////////////////////////////////////////////////////////////////////
+std::map<std::string, ignition::math::Vector3d>
+ParallelQuickTest::StackPositions(physics::WorldPtr _world,
+    const std::string &_stepType, const unsigned int _steps)
+{
+  _world->Reset();
+  _world->Physics()->SetParam("solver_type", _stepType);
+  _world->Step(_steps);
+
+  std::map<std::string, ignition::math::Vector3d> positions;
+  for (auto const &model : _world->Models())
+  {
+    if (model->GetName().find("box_") == 0)
+      positions[model->GetName()] = model->WorldPose().Pos();
+  }
+  return positions;
+}
+
+////////////////////////////////////////////////////////////////////////
+// The parallel_quick step type must settle the box stacks of stacks.world
+// to the same rest state as the quick step type.
+TEST_F(ParallelQuickTest, MatchesQuickStep)
+{
+  Load("worlds/stacks.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+
+  physics->SetParam("solver_type", std::string("parallel_quick"));
+#ifdef HAVE_PARALLEL_QUICKSTEP
+  EXPECT_EQ(boost::any_cast<std::string>(physics->GetParam("solver_type")),
+      "parallel_quick");
+#else
+  // Without the library the step type falls back to quick
+  EXPECT_EQ(boost::any_cast<std::string>(physics->GetParam("solver_type")),
+      "quick");
+#endif
+
+  const unsigned int steps = 2000;
+  auto quick = this->StackPositions(world, "quick", steps);
+  auto parallel = this->StackPositions(world, "parallel_quick", steps);
+
+  ASSERT_FALSE(quick.empty());
+  ASSERT_EQ(quick.size(), parallel.size());
+  for (auto const &pos : quick)
+  {
+    auto iter = parallel.find(pos.first);
+    ASSERT_TRUE(iter != parallel.end());
+    EXPECT_NEAR(pos.second.X(), iter->second.X(), PHYSICS_TOL) << pos.first;
+    EXPECT_NEAR(pos.second.Y(), iter->second.Y(), PHYSICS_TOL) << pos.first;
+    EXPECT_NEAR(pos.second.Z(), iter->second.Z(), PHYSICS_TOL) << pos.first;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Resting contacts of the box stacks must be warm started from the
+// previous step, and the stacks must stay in place.
+TEST_F(PhysicsTest, ContactWarmStart)
+{
+  Load("worlds/stacks.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+  physics->SetParam("solver_type", std::string("quick"));
+  EXPECT_TRUE(physics->SetParam("contact_warm_start", true));
+
+  std::map<std::string, ignition::math::Vector3d> initial;
+  for (auto const &model : world->Models())
+    initial[model->GetName()] = model->WorldPose().Pos();
+
+  world->Step(1000);
+
+  double hitRate = 0;
+  EXPECT_NO_THROW(hitRate = boost::any_cast<double>(
+    physics->GetParam("contact_warm_start_hit_rate")));
+  EXPECT_GT(hitRate, 0.9);
+
+  for (auto const &model : world->Models())
+  {
+    auto pos = model->WorldPose().Pos();
+    EXPECT_NEAR(pos.X(), initial[model->GetName()].X(), PHYSICS_TOL);
+    EXPECT_NEAR(pos.Y(), initial[model->GetName()].Y(), PHYSICS_TOL);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+std::map<std::string, ignition::math::Vector3d>
+RowThreadsTest::Positions(physics::WorldPtr _world, const int _threads,
+    const bool _deterministic, const unsigned int _steps)
+{
+  _world->Reset();
+  physics::PhysicsEnginePtr physics = _world->Physics();
+  physics->SetParam("solver_type", std::string("quick"));
+  physics->SetParam("row_threads", _threads);
+  physics->SetParam("deterministic_rows", _deterministic);
+  _world->Step(_steps);
+
+  std::map<std::string, ignition::math::Vector3d> positions;
+  for (auto const &model : _world->Models())
+    positions[model->GetName()] = model->WorldPose().Pos();
+  return positions;
+}
+
+////////////////////////////////////////////////////////////////////////
+// The rubble pile is a single large island, which the row threads solve
+// with the colored PGS sweep. With deterministic_rows the result must not
+// depend on the number of threads.
+TEST_F(RowThreadsTest, Deterministic)
+{
+  Load("worlds/parallel_quick_rubble.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  const unsigned int steps = 500;
+  auto one = this->Positions(world, 1, true, steps);
+  auto four = this->Positions(world, 4, true, steps);
+
+  ASSERT_FALSE(one.empty());
+  ASSERT_EQ(one.size(), four.size());
+  for (auto const &pos : one)
+  {
+    auto iter = four.find(pos.first);
+    ASSERT_TRUE(iter != four.end());
+    EXPECT_EQ(pos.second, iter->second) << pos.first;
+  }
+
+  // Without the barriers between colors the pile must still stay in place
+  auto relaxed = this->Positions(world, 4, false, steps);
+  ASSERT_EQ(one.size(), relaxed.size());
+  for (auto const &pos : relaxed)
+  {
+    EXPECT_TRUE(pos.second.IsFinite()) << pos.first;
+    EXPECT_GT(pos.second.Z(), -PHYSICS_TOL) << pos.first;
+  }
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
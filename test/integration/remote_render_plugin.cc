@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class RemoteRenderPluginTest : public ServerFixture
+{
+  /// \brief Callback for the times published by the physics node.
+  /// \param[in] _msg The message.
+  public: void OnSync(ConstRenderSyncPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->syncTime = _msg->sim_time();
+  }
+
+  /// \brief Callback for the answers of the render node.
+  /// \param[in] _msg The message.
+  public: void OnDone(ConstRenderSyncPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->done = *_msg;
+    ++this->doneCount;
+  }
+
+  /// \brief Wall time taken by some world steps, in seconds.
+  /// \param[in] _world The world.
+  /// \param[in] _steps Number of steps.
+  /// \return Wall time.
+  public: double TimedStep(physics::WorldPtr _world, const unsigned int _steps)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    _world->Step(_steps);
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+
+  /// \brief Latest time published by the physics node.
+  public: double syncTime = -1;
+
+  /// \brief Latest answer of the render node.
+  public: msgs::RenderSync done;
+
+  /// \brief Number of answers of the render node.
+  public: int doneCount = 0;
+
+  /// \brief Protects the received messages.
+  public: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+// The test plays the render node of a physics node
+TEST_F(RemoteRenderPluginTest, PhysicsNode)
+{
+  Load("worlds/remote_render_plugin.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  const double dt = world->Physics()->GetMaxStepSize();
+
+  transport::SubscriberPtr sub = this->node->Subscribe("~/render/sync",
+      &RemoteRenderPluginTest::OnSync,
+      static_cast<RemoteRenderPluginTest *>(this));
+  transport::PublisherPtr pub =
+    this->node->Advertise<msgs::RenderSync>("~/render/done");
+  pub->WaitForConnection();
+
+  // Without a render node the world runs freely, and publishes its time
+  EXPECT_LT(this->TimedStep(world, 100), 1.0);
+  for (int i = 0; i < 100; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (ignition::math::equal(this->syncTime, world->SimTime().Double()))
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    EXPECT_DOUBLE_EQ(world->SimTime().Double(), this->syncTime);
+  }
+
+  // An image is due in 50 steps, the steps before it don't wait
+  msgs::RenderSync msg;
+  msg.set_sim_time(world->SimTime().Double());
+  msg.set_next_required(world->SimTime().Double() + 50 * dt);
+  pub->Publish(msg);
+  common::Time::MSleep(100);
+  EXPECT_LT(this->TimedStep(world, 40), 1.0);
+
+  // The world waits for the render node past the due time
+  std::thread render([&]
+      {
+        common::Time::MSleep(300);
+        msgs::RenderSync answer;
+        answer.set_sim_time(msg.next_required());
+        answer.set_next_required(msg.next_required() + 1.0);
+        pub->Publish(answer);
+      });
+  const common::Time before = world->SimTime();
+  double wall = this->TimedStep(world, 20);
+  render.join();
+  EXPECT_GT(wall, 0.2);
+  EXPECT_LT(wall, 1.5);
+  EXPECT_NEAR((world->SimTime() - before).Double(), 20 * dt, 1e-6);
+
+  // The world steps anyway once the render node misses the 2 s timeout
+  msg.set_sim_time(world->SimTime().Double());
+  msg.set_next_required(world->SimTime().Double() + 5 * dt);
+  pub->Publish(msg);
+  common::Time::MSleep(100);
+  wall = this->TimedStep(world, 20);
+  EXPECT_GT(wall, 1.8);
+  EXPECT_LT(wall, 4.0);
+
+  // And then runs freely until the render node answers again
+  EXPECT_LT(this->TimedStep(world, 100), 1.0);
+}
+
+/////////////////////////////////////////////////
+// The test plays the physics node of a render node
+TEST_F(RemoteRenderPluginTest, RenderNode)
+{
+  // The environment variable overrides the role of the world file
+  setenv("GAZEBO_RENDER_ROLE", "render", 1);
+  Load("worlds/remote_render_plugin.world", false);
+  unsetenv("GAZEBO_RENDER_ROLE");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Time only moves with the physics node
+  EXPECT_FALSE(world->PhysicsEnabled());
+  EXPECT_TRUE(world->IsPaused());
+
+  transport::SubscriberPtr sub = this->node->Subscribe("~/render/done",
+      &RemoteRenderPluginTest::OnDone,
+      static_cast<RemoteRenderPluginTest *>(this));
+  transport::PublisherPtr pub =
+    this->node->Advertise<msgs::RenderSync>("~/render/sync");
+  pub->WaitForConnection();
+
+  for (const double time : {1.5, 2.25})
+  {
+    const int count = this->doneCount;
+    msgs::RenderSync msg;
+    msg.set_sim_time(time);
+    pub->Publish(msg);
+
+    for (int i = 0; i < 100; ++i)
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->doneCount > count)
+          break;
+      }
+      common::Time::MSleep(10);
+    }
+
+    // No image sensor is due
+    std::lock_guard<std::mutex> lock(this->mutex);
+    EXPECT_GT(this->doneCount, count);
+    EXPECT_DOUBLE_EQ(time, this->done.sim_time());
+    EXPECT_FALSE(this->done.has_next_required());
+    EXPECT_DOUBLE_EQ(time, world->SimTime().Double());
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
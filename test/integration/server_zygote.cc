@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "test_config.h"
+
+/// \brief Master port of the servers spawned by the tests.
+static const int SPAWN_PORT = 11399;
+
+/// \brief Test fixture that runs gzserver as a zygote.
+class ServerZygote : public ::testing::Test
+{
+  // Documentation inherited
+  protected: virtual void SetUp()
+  {
+    this->socketPath = "/tmp/gzserver_zygote_test_" +
+        std::to_string(getpid()) + ".sock";
+    unlink(this->socketPath.c_str());
+  }
+
+  // Documentation inherited
+  protected: virtual void TearDown()
+  {
+    if (this->spawned > 0)
+      kill(this->spawned, SIGINT);
+    this->StopZygote();
+    unlink(this->socketPath.c_str());
+  }
+
+  /// \brief Start gzserver as a zygote on socketPath.
+  /// \return Pid of the zygote.
+  protected: pid_t StartZygote()
+  {
+    const std::string gzserver =
+        std::string(PROJECT_BINARY_PATH) + "/gazebo/gzserver";
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      execl(gzserver.c_str(), gzserver.c_str(), "--zygote",
+          this->socketPath.c_str(), static_cast<char *>(nullptr));
+      _exit(127);
+    }
+    return pid;
+  }
+
+  /// \brief Stop the zygote started by the test, if any.
+  protected: void StopZygote()
+  {
+    if (this->zygote <= 0)
+      return;
+    kill(this->zygote, SIGKILL);
+    waitpid(this->zygote, nullptr, 0);
+    this->zygote = -1;
+  }
+
+  /// \brief Connect to the zygote, waiting for it to listen.
+  /// \return Socket of the connection, -1 on timeout.
+  protected: int Connect() const
+  {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, this->socketPath.c_str(),
+        sizeof(addr.sun_path) - 1);
+
+    for (int i = 0; i < 200; ++i)
+    {
+      const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (fd < 0)
+        return -1;
+      if (connect(fd, reinterpret_cast<sockaddr *>(&addr),
+            sizeof(addr)) == 0)
+      {
+        return fd;
+      }
+      close(fd);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return -1;
+  }
+
+  /// \brief Send a spawn request and read the reply.
+  /// \param[in] _fd Socket connected to the zygote.
+  /// \return Pid sent back by the zygote, 0 if there was no reply.
+  protected: pid_t Spawn(const int _fd) const
+  {
+    const std::string request = std::to_string(SPAWN_PORT) +
+        "\nworlds/empty.world\n\n";
+    if (write(_fd, request.c_str(), request.size()) !=
+        static_cast<ssize_t>(request.size()))
+    {
+      return 0;
+    }
+
+    std::string reply;
+    char c;
+    while (read(_fd, &c, 1) == 1 && c != '\n')
+      reply += c;
+    return reply.empty() ? 0 : std::atoi(reply.c_str());
+  }
+
+  /// \brief Path of the socket of the zygote.
+  protected: std::string socketPath;
+
+  /// \brief Pid of the zygote.
+  protected: pid_t zygote = -1;
+
+  /// \brief Pid of the server spawned by the test.
+  protected: pid_t spawned = -1;
+};
+
+/////////////////////////////////////////////////
+// Spawn a server and check that its pid is alive
+TEST_F(ServerZygote, Spawn)
+{
+  this->zygote = this->StartZygote();
+  ASSERT_GT(this->zygote, 0);
+
+  const int fd = this->Connect();
+  ASSERT_GE(fd, 0);
+  this->spawned = this->Spawn(fd);
+  close(fd);
+
+  ASSERT_GT(this->spawned, 0);
+  EXPECT_EQ(0, kill(this->spawned, 0));
+}
+
+/////////////////////////////////////////////////
+// A client that doesn't send its request doesn't block the other clients
+TEST_F(ServerZygote, IdleClient)
+{
+  this->zygote = this->StartZygote();
+  ASSERT_GT(this->zygote, 0);
+
+  const int idle = this->Connect();
+  ASSERT_GE(idle, 0);
+
+  const int fd = this->Connect();
+  ASSERT_GE(fd, 0);
+  this->spawned = this->Spawn(fd);
+  close(fd);
+  close(idle);
+
+  ASSERT_GT(this->spawned, 0);
+  EXPECT_EQ(0, kill(this->spawned, 0));
+}
+
+/////////////////////////////////////////////////
+// The socket left by a zygote that was killed is replaced, but not the
+// socket of a live zygote
+TEST_F(ServerZygote, StaleSocket)
+{
+  this->zygote = this->StartZygote();
+  ASSERT_GT(this->zygote, 0);
+  int fd = this->Connect();
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  // A second zygote gives up while the first one listens
+  const pid_t second = this->StartZygote();
+  ASSERT_GT(second, 0);
+  int status = 0;
+  ASSERT_EQ(second, waitpid(second, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_NE(0, WEXITSTATUS(status));
+
+  // The first zygote is killed without removing its socket
+  this->StopZygote();
+  struct stat info;
+  ASSERT_EQ(0, lstat(this->socketPath.c_str(), &info));
+  EXPECT_TRUE(S_ISSOCK(info.st_mode));
+
+  this->zygote = this->StartZygote();
+  ASSERT_GT(this->zygote, 0);
+  fd = this->Connect();
+  ASSERT_GE(fd, 0);
+  this->spawned = this->Spawn(fd);
+  close(fd);
+  EXPECT_GT(this->spawned, 0);
+}
+
+/////////////////////////////////////////////////
+// A file that isn't a socket is left alone
+TEST_F(ServerZygote, NotASocket)
+{
+  {
+    std::ofstream file(this->socketPath);
+    file << "not a socket";
+  }
+
+  const pid_t pid = this->StartZygote();
+  ASSERT_GT(pid, 0);
+  int status = 0;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_NE(0, WEXITSTATUS(status));
+
+  struct stat info;
+  ASSERT_EQ(0, lstat(this->socketPath.c_str(), &info));
+  EXPECT_TRUE(S_ISREG(info.st_mode));
+}
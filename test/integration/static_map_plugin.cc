@@ -15,8 +15,15 @@
  *
 */
 
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/physics/physics.hh"
+#include "test_config.h"
 
 using namespace gazebo;
 class StaticMapTest : public ServerFixture
@@ -75,9 +82,21 @@ TEST_F(StaticMapTest, StaticMapPlugin)
   EXPECT_TRUE(common::isFile(modelPath + "/model.config"));
   EXPECT_TRUE(common::isFile(
       modelPath + "/materials/scripts/map_tiles.material"));
+
+  // the placeholder API key fails the downloads, which leave no files
+  // behind, but the material still refers to the center tile
   std::string centerTileName = "tile_37.386491_-122.065255.png";
-  EXPECT_TRUE(common::isFile(
-      modelPath + "/materials/textures/" + centerTileName));
+  std::ifstream materialFile(
+      modelPath + "/materials/scripts/map_tiles.material");
+  std::string material((std::istreambuf_iterator<char>(materialFile)),
+      std::istreambuf_iterator<char>());
+  EXPECT_NE(material.find(centerTileName), std::string::npos);
+  for (boost::filesystem::directory_iterator it(
+         modelPath + "/materials/textures");
+       it != boost::filesystem::directory_iterator(); ++it)
+  {
+    EXPECT_NE(it->path().extension().string(), ".part") << it->path();
+  }
 
   // done testing, remove cache
   boost::filesystem::remove_all(modelPath);
@@ -91,6 +110,46 @@ TEST_F(StaticMapTest, StaticMapPlugin)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Verify that tiles in the tile cache are used instead of being
+/// downloaded.
+TEST_F(StaticMapTest, TileCache)
+{
+  std::string modelName = "static_map_tile_cache";
+  std::string basePath = common::SystemPaths::Instance()->GetLogPath();
+  std::string modelPath = basePath + "/models/" + modelName;
+  boost::filesystem::remove_all(modelPath);
+
+  // a 10 m map at zoom 21 fits in the center tile, which is cached by map
+  // type, zoom and tile size
+  std::string centerTileName = "tile_37.386491_-122.065255.png";
+  std::string tileCachePath = basePath + "/map_tiles";
+  std::string cachedTile =
+      tileCachePath + "/satellite_21_640_" + centerTileName;
+  boost::filesystem::create_directories(tileCachePath);
+  std::string image =
+      PROJECT_SOURCE_PATH "/media/materials/textures/bricks.png";
+  ASSERT_TRUE(common::copyFile(image, cachedTile));
+
+  this->Load("test/worlds/static_map_tile_cache.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  WaitUntilEntitySpawn(modelName, 300, 300);
+  EXPECT_TRUE(world->ModelByName(modelName) != nullptr);
+
+  // the cached tile is copied into the model, even though the placeholder
+  // API key can't download it
+  std::string tile = modelPath + "/materials/textures/" + centerTileName;
+  ASSERT_TRUE(common::isFile(tile));
+  EXPECT_EQ(boost::filesystem::file_size(image),
+      boost::filesystem::file_size(tile));
+  EXPECT_TRUE(common::isFile(cachedTile));
+
+  boost::filesystem::remove_all(modelPath);
+  boost::filesystem::remove(cachedTile);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
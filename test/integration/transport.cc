@@ -186,6 +186,86 @@ TEST_F(TransportTest, DirectPublish)
   ASSERT_GT(timeout, 0) << "Not received a message in 10 seconds";
 }
 
+/////////////////////////////////////////////////
+// Publish a shared message, which is not copied by the publisher
+TEST_F(TransportTest, SharedPublish)
+{
+  Load("worlds/empty.world");
+
+  g_stringMsg = false;
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  transport::PublisherPtr pub = node->Advertise<msgs::GzString>("~/shared");
+  transport::SubscriberPtr sub = node->Subscribe("~/shared",
+      &ReceiveStringMsg);
+
+  boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+  msg->set_data("Shared message");
+  pub->Publish(transport::MessagePtr(msg));
+
+  int timeout = 1000;
+  while (!g_stringMsg && --timeout > 0)
+    common::Time::MSleep(10);
+  ASSERT_GT(timeout, 0) << "Not received a message in 10 seconds";
+
+  // The publisher keeps the message it was handed as its latest message
+  EXPECT_EQ(pub->GetPrevMsgPtr().get(), msg.get());
+
+  // A null message is ignored
+  pub->Publish(transport::MessagePtr());
+}
+
+/////////////////////////////////////////////////
+// Publish messages borrowed from the publisher, which recycles them
+TEST_F(TransportTest, BorrowedPublish)
+{
+  Load("worlds/empty.world");
+
+  g_stringMsg = false;
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  transport::PublisherPtr pub = node->Advertise<msgs::GzString>("~/borrow");
+  transport::SubscriberPtr sub = node->Subscribe("~/borrow",
+      &ReceiveStringMsg);
+
+  // A message released by the caller is recycled, and comes back empty
+  const msgs::GzString *unused;
+  {
+    auto msg = pub->BorrowMessage<msgs::GzString>();
+    msg->set_data("Unused message");
+    unused = msg.get();
+  }
+  auto msg = pub->BorrowMessage<msgs::GzString>();
+  EXPECT_EQ(unused, msg.get());
+  EXPECT_FALSE(msg->has_data());
+
+  msg->set_data("Borrowed message");
+  pub->Publish(transport::MessagePtr(msg));
+
+  int timeout = 1000;
+  while (!g_stringMsg && --timeout > 0)
+    common::Time::MSleep(10);
+  ASSERT_GT(timeout, 0) << "Not received a message in 10 seconds";
+  EXPECT_EQ(pub->GetPrevMsgPtr().get(), msg.get());
+
+  // The latched message is not recycled
+  msg.reset();
+  EXPECT_NE(unused, pub->BorrowMessage<msgs::GzString>().get());
+
+  // Copied messages are published from recycled storage too
+  msgs::GzString copy;
+  copy.set_data("Copied message");
+  pub->Publish(copy);
+  EXPECT_NE(&copy, pub->GetPrevMsgPtr().get());
+  EXPECT_EQ("Copied message",
+      boost::dynamic_pointer_cast<msgs::GzString>(
+        pub->GetPrevMsgPtr())->data());
+}
+
 /////////////////////////////////////////////////
 void SinglePub()
 {
@@ -788,6 +868,53 @@ TEST_F(TransportTest, TryInit)
   EXPECT_EQ(physics::get_world()->Name(), node->GetTopicNamespace());
 }
 
+/////////////////////////////////////////////////
+class LimitedReceiver
+{
+  public: void OnMsg(ConstGzStringPtr &/*_msg*/)
+  {
+    ++this->count;
+  }
+
+  public: int count = 0;
+};
+
+/////////////////////////////////////////////////
+// Delivery limits only apply to remote publishers, local subscribers
+// receive every message
+TEST_F(TransportTest, DeliveryLimits)
+{
+  Load("worlds/empty.world");
+
+  transport::SubscribeOptions limits;
+  EXPECT_DOUBLE_EQ(limits.GetMaxRate(), 0.0);
+  EXPECT_FALSE(limits.GetLatestOnly());
+  limits.SetMaxRate(-1.0);
+  EXPECT_DOUBLE_EQ(limits.GetMaxRate(), 0.0);
+  limits.SetMaxRate(10.0);
+  limits.SetLatestOnly(true);
+  EXPECT_DOUBLE_EQ(limits.GetMaxRate(), 10.0);
+  EXPECT_TRUE(limits.GetLatestOnly());
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+
+  LimitedReceiver receiver;
+  transport::SubscriberPtr sub = node->Subscribe("~/test/limits",
+      &LimitedReceiver::OnMsg, &receiver, limits);
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::GzString>("~/test/limits");
+
+  msgs::GzString msg;
+  msg.set_data("limited");
+  for (int i = 0; i < 10; ++i)
+    pub->Publish(msg, true);
+
+  for (int i = 0; i < 100 && receiver.count < 10; ++i)
+    common::Time::MSleep(10);
+  EXPECT_EQ(receiver.count, 10);
+}
+
 /////////////////////////////////////////////////
 // Main
 int main(int argc, char **argv)
@@ -225,3 +225,49 @@ TEST_F(WideAngleCameraSensor, Projection)
   EXPECT_LT(screenPt.Z(), 1.0);
 #endif
 }
+
+/////////////////////////////////////////////////
+TEST_F(WideAngleCameraSensor, EnvFaceCulling)
+{
+#if not defined(__APPLE__)
+  Load("worlds/usercamera_test.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run wide angle camera test\n";
+    return;
+  }
+
+  // A narrow gnomonical lens only samples the front face of the cube map
+  std::string modelName = "camera_model";
+  std::string cameraName = "camera_sensor";
+  unsigned int width  = 320;
+  unsigned int height = 240;
+  double updateRate = 10;
+  ignition::math::Pose3d setPose = ignition::math::Pose3d::Zero;
+  SpawnWideAngleCamera(modelName, cameraName, setPose.Pos(),
+      setPose.Rot().Euler(), width, height, updateRate, 1.0, "gnomonical",
+      true, IGN_PI * 0.5);
+  sensors::SensorPtr sensor = sensors::get_sensor(cameraName);
+  sensors::WideAngleCameraSensorPtr camSensor =
+      std::dynamic_pointer_cast<sensors::WideAngleCameraSensor>(sensor);
+  ASSERT_NE(camSensor, nullptr);
+  camSensor->SetActive(true);
+
+  rendering::WideAngleCameraPtr camera =
+      boost::dynamic_pointer_cast<rendering::WideAngleCamera>(
+      camSensor->Camera());
+  ASSERT_NE(camera, nullptr);
+
+  int sleep = 0;
+  int maxSleep = 300;
+  while (camera->RenderedEnvFaceCount() == 6u && sleep < maxSleep)
+  {
+    common::Time::MSleep(10);
+    sleep++;
+  }
+  EXPECT_EQ(camera->RenderedEnvFaceCount(), 1u);
+#endif
+}
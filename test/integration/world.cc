@@ -14,6 +14,14 @@
  * limitations under the License.
  *
 */
+#include <dlfcn.h>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/MeshManager.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/physics.hh"
@@ -573,6 +581,179 @@ TEST_F(WorldTest, CheckWorldEventsWork)
   worldUpdateEndEventConnection.reset();
 }
 
+/// \brief Last world statistics received.
+msgs::WorldStatistics g_worldStats;
+
+/// \brief Protects g_worldStats.
+std::mutex g_worldStatsMutex;
+
+/////////////////////////////////////////////////
+/// \brief Callback for world statistics.
+/// \param[in] _msg World statistics.
+void onWorldStats(ConstWorldStatisticsPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_worldStatsMutex);
+  g_worldStats.CopyFrom(*_msg);
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that the world statistics carry the phase times of the
+/// world update once the world has run for a while.
+TEST_F(WorldTest, PhaseTimes)
+{
+  Load("worlds/shapes.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  transport::SubscriberPtr sub =
+    this->node->Subscribe("~/world_stats", &onWorldStats);
+
+  bool received = false;
+  for (int i = 0; i < 50 && !received; ++i)
+  {
+    common::Time::MSleep(100);
+    std::lock_guard<std::mutex> lock(g_worldStatsMutex);
+    received = g_worldStats.has_phase_times();
+  }
+  ASSERT_TRUE(received);
+
+  std::lock_guard<std::mutex> lock(g_worldStatsMutex);
+  const msgs::WorldStatistics::PhaseTimes &phases =
+    g_worldStats.phase_times();
+  EXPECT_GT(phases.physics(), 0.0);
+  EXPECT_GT(phases.collision(), 0.0);
+  EXPECT_GE(phases.message_processing(), 0.0);
+  EXPECT_GE(phases.model_update(), 0.0);
+  EXPECT_GE(phases.dirty_poses(), 0.0);
+  EXPECT_GE(phases.contact_publish(), 0.0);
+  EXPECT_DOUBLE_EQ(phases.logging(), 0.0);
+
+  // Each phase takes much less than a second per iteration
+  EXPECT_LT(phases.physics(), 1.0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that the world statistics carry the histogram of the step
+/// periods once the world has run for a while.
+TEST_F(WorldTest, StepJitter)
+{
+  Load("worlds/shapes.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  EXPECT_FALSE(world->RealTimeMode());
+
+  transport::SubscriberPtr sub =
+    this->node->Subscribe("~/world_stats", &onWorldStats);
+
+  bool received = false;
+  for (int i = 0; i < 50 && !received; ++i)
+  {
+    common::Time::MSleep(100);
+    std::lock_guard<std::mutex> lock(g_worldStatsMutex);
+    received = g_worldStats.has_step_jitter();
+  }
+  ASSERT_TRUE(received);
+
+  std::lock_guard<std::mutex> lock(g_worldStatsMutex);
+  const msgs::WorldStatistics::StepJitter &jitter =
+    g_worldStats.step_jitter();
+  EXPECT_FALSE(jitter.real_time());
+  EXPECT_DOUBLE_EQ(jitter.target_period(),
+      world->Physics()->GetUpdatePeriod());
+  EXPECT_GT(jitter.period_avg(), 0.0);
+  EXPECT_LE(jitter.period_min(), jitter.period_avg());
+  EXPECT_LE(jitter.period_avg(), jitter.period_max());
+  ASSERT_GT(jitter.bucket_bound_size(), 0);
+  EXPECT_EQ(jitter.bucket_count_size(), jitter.bucket_bound_size() + 1);
+
+  uint64_t periods = 0;
+  for (auto const count : jitter.bucket_count())
+    periods += count;
+  EXPECT_GT(periods, 0u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldTest, CompactStaticModels)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  EXPECT_FALSE(world->CompactStaticModels());
+
+  world->SetCompactStaticModels(true);
+  EXPECT_TRUE(world->CompactStaticModels());
+
+  // Models loaded from now on use the compact representation
+  SpawnBox("static_box", ignition::math::Vector3d(2, 2, 1),
+      ignition::math::Vector3d(0, 0, 2), ignition::math::Vector3d::Zero,
+      true);
+  SpawnSphere("sphere", ignition::math::Vector3d(0, 0, 3.5),
+      ignition::math::Vector3d::Zero);
+
+  physics::ModelPtr box = world->ModelByName("static_box");
+  physics::ModelPtr sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(box != NULL);
+  ASSERT_TRUE(sphere != NULL);
+
+  // The static model only has a pose in the world state
+  physics::WorldState state(world);
+  ASSERT_TRUE(state.HasModelState("static_box"));
+  EXPECT_EQ(state.GetModelState("static_box").GetLinkStateCount(), 0u);
+  EXPECT_EQ(state.GetModelState("static_box").Pose(), box->WorldPose());
+  EXPECT_GT(state.GetModelState("sphere").GetLinkStateCount(), 0u);
+
+  // The sphere still lands on the static box
+  world->Step(1000);
+  EXPECT_NEAR(sphere->WorldPose().Pos().Z(), 3.0, 0.05);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldTest, SDFMemorySaver)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  EXPECT_FALSE(world->SDFMemorySaver());
+
+  world->SetSDFMemorySaver(true);
+  EXPECT_TRUE(world->SDFMemorySaver());
+
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != NULL);
+  physics::LinkPtr link = box->GetLink();
+  ASSERT_TRUE(link != NULL);
+
+  // The visual was released once the model loaded
+  EXPECT_FALSE(link->GetSDF()->HasElement("visual"));
+
+  // and is recreated when the SDF of the model is requested
+  sdf::ElementPtr linkElem = box->GetSDF()->GetElement("link");
+  ASSERT_TRUE(linkElem->HasElement("visual"));
+  sdf::ElementPtr visualElem = linkElem->GetElement("visual");
+  EXPECT_TRUE(visualElem->HasElement("geometry"));
+  EXPECT_TRUE(visualElem->GetElement("geometry")->HasElement("box"));
+  EXPECT_EQ(visualElem->Get<std::string>("name").find("::"),
+      std::string::npos);
+
+  // The world SDF has it too
+  sdf::ElementPtr modelElem = world->SDF()->GetElement("model");
+  bool found = false;
+  while (modelElem)
+  {
+    if (modelElem->Get<std::string>("name") == "box")
+    {
+      found = modelElem->GetElement("link")->HasElement("visual");
+      break;
+    }
+    modelElem = modelElem->GetNextElement("model");
+  }
+  EXPECT_TRUE(found);
+}
+
 /////////////////////////////////////////////////
 TEST_F(WorldTest, URI)
 {
@@ -617,6 +798,139 @@ TEST_F(WorldTest, URI)
       "data://world/default/model/model_00/model/model_01/link/link_01");
 }
 
+/////////////////////////////////////////////////
+// Check that the meshes parsed and the plugin libraries loaded in the
+// background, while the entities are created, are used by the entities
+TEST_F(WorldTest, PrefetchMeshesAndPlugins)
+{
+  const std::string mesh =
+    PROJECT_SOURCE_PATH "/test/media/models/cube_20k/meshes/cube_20k.stl";
+
+  const boost::filesystem::path worldFile =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_prefetch_%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << "<?xml version='1.0'?><sdf version='1.6'><world name='default'>"
+        << "<gravity>0 0 0</gravity>";
+    for (int i = 0; i < 3; ++i)
+    {
+      out << "<model name='mesh_" << i << "'>"
+          << "<pose>" << i * 2 << " 0 1 0 0 0</pose>"
+          << "<link name='link'><collision name='collision'><geometry>"
+          << "<mesh><uri>file://" << mesh << "</uri>"
+          << "<scale>0.5 0.5 0.5</scale></mesh>"
+          << "</geometry></collision></link>";
+      if (i == 0)
+      {
+        out << "<plugin name='velocity' "
+            << "filename='libInitialVelocityPlugin.so'>"
+            << "<linear>0.5 0 0</linear></plugin>";
+      }
+      out << "</model>";
+    }
+    out << "</world></sdf>";
+  }
+
+  Load(worldFile.string(), true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  // The mesh was parsed once, and every model has its collision
+  EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(mesh));
+  for (int i = 0; i < 3; ++i)
+  {
+    auto model = world->ModelByName("mesh_" + std::to_string(i));
+    ASSERT_TRUE(model != NULL);
+    auto link = model->GetLink("link");
+    ASSERT_TRUE(link != NULL);
+    auto collision = link->GetCollision("collision");
+    ASSERT_TRUE(collision != NULL);
+    EXPECT_GT(collision->BoundingBox().Size().Length(), 0.0);
+  }
+
+  // The plugin library was loaded, and the plugin created
+  void *handle = dlopen("libInitialVelocityPlugin.so",
+      RTLD_LAZY | RTLD_NOLOAD);
+  EXPECT_TRUE(handle != NULL);
+  if (handle)
+    dlclose(handle);
+
+  auto model = world->ModelByName("mesh_0");
+  EXPECT_EQ(model->GetPluginCount(), 1u);
+  world->Step(1);
+  EXPECT_NEAR(model->WorldLinearVel().X(), 0.5, 1e-3);
+
+  boost::filesystem::remove(worldFile);
+}
+
+/////////////////////////////////////////////////
+// Check that a world answers requests before it runs, as the server does
+// while the sensors initialize with --staged_startup
+TEST_F(WorldTest, ProcessStartupRequests)
+{
+  Load("worlds/empty.world", true);
+
+  // A world that is loaded, but doesn't run
+  sdf::SDFPtr worldSDF(new sdf::SDF);
+  worldSDF->SetFromString(
+      "<sdf version='1.6'><world name='startup'>"
+      "<model name='box'><static>true</static><link name='link'>"
+      "<collision name='collision'><geometry><box><size>1 1 1</size></box>"
+      "</geometry></collision></link></model>"
+      "</world></sdf>");
+  physics::WorldPtr world = physics::create_world("startup");
+  ASSERT_TRUE(world != NULL);
+  physics::load_world(world, worldSDF->Root()->GetElement("world"));
+  physics::init_world(world, nullptr);
+
+  std::mutex mutex;
+  std::vector<msgs::Response> responses;
+  std::function<void(ConstResponsePtr &)> onResponse =
+    [&mutex, &responses](ConstResponsePtr &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      responses.push_back(*_msg);
+    };
+  transport::SubscriberPtr sub = this->node->Subscribe(
+      "/gazebo/startup/response", onResponse);
+  transport::PublisherPtr pub = this->node->Advertise<msgs::Request>(
+      "/gazebo/startup/request");
+  pub->WaitForConnection();
+
+  msgs::Request *request = msgs::CreateRequest("entity_list");
+  const int id = request->id();
+  pub->Publish(*request);
+  delete request;
+
+  // Nothing answers the request while the world doesn't run
+  common::Time::MSleep(500);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_TRUE(responses.empty());
+  }
+
+  // Until the startup requests are processed
+  bool answered = false;
+  for (int i = 0; i < 50 && !answered; ++i)
+  {
+    world->ProcessStartupRequests();
+    common::Time::MSleep(100);
+    std::lock_guard<std::mutex> lock(mutex);
+    answered = !responses.empty();
+  }
+  ASSERT_TRUE(answered);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(responses[0].id(), id);
+    EXPECT_EQ(responses[0].response(), "success");
+    msgs::Model_V models;
+    ASSERT_TRUE(models.ParseFromString(responses[0].serialized_data()));
+    ASSERT_EQ(models.models_size(), 1);
+    EXPECT_EQ(models.models(0).name(), "box");
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, WorldTest, PHYSICS_ENGINE_VALUES,);  // NOLINT
 
 /////////////////////////////////////////////////
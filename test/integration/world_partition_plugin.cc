@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class WorldPartitionPluginTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(WorldPartitionPluginTest, Ownership)
+{
+  Load("worlds/world_partition_plugin.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr owned = world->ModelByName("owned_box");
+  ASSERT_TRUE(owned != nullptr);
+  physics::ModelPtr ghost = world->ModelByName("ghost_box");
+  ASSERT_TRUE(ghost != nullptr);
+
+  world->Step(100);
+
+  // The box in the strip of this node falls, the other one is frozen
+  EXPECT_LT(owned->WorldPose().Pos().Z(), 1.9);
+  EXPECT_NEAR(2.0, ghost->WorldPose().Pos().Z(), 1e-6);
+  EXPECT_FALSE(ghost->GetLink("link")->GetEnabled());
+
+  // Leaving the strip hands the box over to the other node
+  owned->SetWorldPose(ignition::math::Pose3d(15, 0, 2, 0, 0, 0));
+  world->Step(1);
+  EXPECT_FALSE(owned->GetLink("link")->GetEnabled());
+  world->Step(100);
+  EXPECT_NEAR(2.0, owned->WorldPose().Pos().Z(), 1e-3);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// COLLADA benchmark. Measures the time common::ColladaLoader takes to load
+// each DAE file of media/models and test/data.
+//
+// The results are written as JSON to the file named by the
+// GAZEBO_COLLADA_BENCHMARK_OUTPUT environment variable, or to
+// collada_benchmark.json in the working directory.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/common/ColladaLoader.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Mesh.hh"
+#include "test_config.h"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+/// \brief Number of times each file is loaded. The fastest load is kept.
+static const unsigned int LOAD_COUNT = 3;
+
+/// \brief Metrics of a file.
+struct BenchmarkResult
+{
+  /// \brief Path of the file, relative to the source directory.
+  std::string file;
+
+  /// \brief Size of the file in bytes.
+  uintmax_t bytes = 0;
+
+  /// \brief Vertices of the loaded mesh.
+  unsigned int vertices = 0;
+
+  /// \brief Fastest load, in seconds.
+  double seconds = 0;
+};
+
+/// \brief Results of all the files.
+static std::vector<BenchmarkResult> g_results;
+
+class ColladaBenchmark : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Find the DAE files under a directory.
+/// \param[in] _dir Directory to search.
+/// \return Paths of the files, sorted.
+static std::vector<boost::filesystem::path> FindDaeFiles(
+    const boost::filesystem::path &_dir)
+{
+  std::vector<boost::filesystem::path> files;
+  if (!boost::filesystem::is_directory(_dir))
+    return files;
+
+  for (boost::filesystem::recursive_directory_iterator iter(_dir), end;
+       iter != end; ++iter)
+  {
+    if (boost::filesystem::is_regular_file(iter->path()) &&
+        iter->path().extension() == ".dae")
+    {
+      files.push_back(iter->path());
+    }
+  }
+
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+/////////////////////////////////////////////////
+TEST_F(ColladaBenchmark, Load)
+{
+  const boost::filesystem::path source(PROJECT_SOURCE_PATH);
+  std::vector<boost::filesystem::path> files = FindDaeFiles(
+      source / "media" / "models");
+  std::vector<boost::filesystem::path> testFiles = FindDaeFiles(
+      source / "test" / "data");
+  files.insert(files.end(), testFiles.begin(), testFiles.end());
+  ASSERT_FALSE(files.empty());
+
+  for (auto const &file : files)
+  {
+    BenchmarkResult result;
+    result.file = file.string().substr(source.string().size() + 1);
+    result.bytes = boost::filesystem::file_size(file);
+    result.seconds = std::numeric_limits<double>::max();
+
+    for (unsigned int i = 0; i < LOAD_COUNT; ++i)
+    {
+      common::ColladaLoader loader;
+      const auto start = std::chrono::steady_clock::now();
+      std::unique_ptr<common::Mesh> mesh(loader.Load(file.string()));
+      const double seconds = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+
+      ASSERT_NE(mesh, nullptr) << file;
+      result.vertices = mesh->GetVertexCount();
+      result.seconds = std::min(result.seconds, seconds);
+    }
+
+    std::cout << result.file << ": " << result.bytes << " bytes, "
+              << result.vertices << " vertices, "
+              << result.seconds * 1e3 << " ms" << std::endl;
+    g_results.push_back(result);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the results as JSON.
+/// \param[in] _path Path of the file.
+static void WriteResults(const std::string &_path)
+{
+  std::ofstream out(_path);
+  if (!out)
+  {
+    gzerr << "Unable to write benchmark results to [" << _path << "]\n";
+    return;
+  }
+
+  out << "{\n"
+      << "  \"benchmark\": \"collada\",\n"
+      << "  \"gazebo_version\": \"" << GAZEBO_VERSION_FULL << "\",\n"
+      << "  \"results\": [";
+
+  for (size_t i = 0; i < g_results.size(); ++i)
+  {
+    const BenchmarkResult &result = g_results[i];
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\n"
+        << "      \"file\": \"" << result.file << "\",\n"
+        << "      \"bytes\": " << result.bytes << ",\n"
+        << "      \"vertices\": " << result.vertices << ",\n"
+        << "      \"load_ms\": " << result.seconds * 1e3 << ",\n"
+        << "      \"mb_per_sec\": "
+        << result.bytes / std::max(result.seconds, 1e-9) / 1e6 << "\n"
+        << "    }";
+  }
+
+  out << "\n  ]\n}\n";
+  gzmsg << "Benchmark results written to [" << _path << "]\n";
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+
+  const char *path = std::getenv("GAZEBO_COLLADA_BENCHMARK_OUTPUT");
+  WriteResults(path ? path : "collada_benchmark.json");
+
+  return result;
+}
@@ -14,16 +14,30 @@
  * limitations under the License.
  *
 */
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/common.hh"
+#include "gazebo/common/ImageConvert.hh"
 
 using namespace std;
 using namespace gazebo;
 
+/// \brief Width of the benchmark frames.
+static const unsigned int FRAME_WIDTH = 1280;
+
+/// \brief Height of the benchmark frames.
+static const unsigned int FRAME_HEIGHT = 720;
+
+/// \brief Number of frames converted by each benchmark.
+static const unsigned int FRAME_COUNT = 200;
+
 class ImageConvertStressTest : public ServerFixture
 {
   /////////////////////////////////////////////////
@@ -38,6 +52,28 @@ class ImageConvertStressTest : public ServerFixture
   {
     delete[] ptr;
   }
+
+  /////////////////////////////////////////////////
+  /// \brief Time a conversion and print the time per frame.
+  /// \param[in] _name Name of the conversion.
+  /// \param[in] _convert Function converting one frame.
+  /// \return Milliseconds per frame.
+  public: double Benchmark(const std::string &_name,
+                           const std::function<void()> &_convert)
+  {
+    // Warm up the caches
+    _convert();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < FRAME_COUNT; ++i)
+      _convert();
+    const double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count() / FRAME_COUNT;
+
+    std::cout << _name << " " << FRAME_WIDTH << "x" << FRAME_HEIGHT << ": "
+              << ms << " ms per frame" << std::endl;
+    return ms;
+  }
 };
 
 /////////////////////////////////////////////////
@@ -62,6 +98,57 @@ TEST_F(ImageConvertStressTest, ManyConversions)
   EXPECT_LE(memAfter - memBefore, 2000);
 }
 
+/////////////////////////////////////////////////
+TEST_F(ImageConvertStressTest, Benchmarks)
+{
+  const size_t pixels = FRAME_WIDTH * FRAME_HEIGHT;
+  std::vector<uint8_t> rgb(pixels * 3);
+  for (size_t i = 0; i < rgb.size(); ++i)
+    rgb[i] = static_cast<uint8_t>(i * 7);
+  std::vector<float> depth(pixels);
+  for (size_t i = 0; i < pixels; ++i)
+    depth[i] = (i % 1000) * 0.01f;
+
+  std::vector<uint8_t> bgr(pixels * 3);
+  std::vector<uint8_t> mono(pixels);
+  std::vector<uint16_t> depth16(pixels);
+  std::vector<uint8_t> half(pixels * 3 / 4);
+
+  this->Benchmark("RGBToBGR", [&]()
+      {
+        common::ImageConvert::RGBToBGR(rgb.data(), bgr.data(), pixels);
+      });
+  this->Benchmark("RGBToMono", [&]()
+      {
+        common::ImageConvert::RGBToMono(rgb.data(), mono.data(), pixels);
+      });
+  this->Benchmark("DepthToUInt16", [&]()
+      {
+        common::ImageConvert::DepthToUInt16(depth.data(), depth16.data(),
+            pixels, 1000.0f);
+      });
+  this->Benchmark("RGBToBayer", [&]()
+      {
+        common::ImageConvert::RGBToBayer(rgb.data(), mono.data(),
+            FRAME_WIDTH, FRAME_HEIGHT, common::Image::BAYER_RGGB8);
+      });
+  this->Benchmark("Resize", [&]()
+      {
+        common::ImageConvert::Resize(rgb.data(), FRAME_WIDTH, FRAME_HEIGHT,
+            3, half.data(), FRAME_WIDTH / 2, FRAME_HEIGHT / 2);
+      });
+
+  // The image transport path, for comparison
+  this->Benchmark("Image to msgs::Image", [&]()
+      {
+        common::Image image;
+        msgs::Image msg;
+        image.SetFromData(rgb.data(), FRAME_WIDTH, FRAME_HEIGHT,
+            common::Image::RGB_INT8);
+        msgs::Set(&msg, image);
+      });
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Physics determinism and performance regression harness. Steps reference
+// worlds for a fixed number of iterations with every physics engine Gazebo
+// was built with, and records:
+// - the wall time of the steps,
+// - the solver iterations per step configured by the engine,
+// - the number of contacts summed over the steps,
+// - a hash of the poses and velocities of the links in the final
+//   WorldState, which changes when the trajectories change.
+//
+// The results are compared against the baselines in the file named by the
+// GAZEBO_PHYSICS_BASELINES environment variable, or physics_baselines.txt
+// in the working directory. Wall times are hardware dependent, so the
+// baselines are meant to be recorded on the machine that runs the
+// comparison, by setting GAZEBO_PHYSICS_BASELINES_UPDATE=1.
+//
+// The baselines file has one line per case:
+// <physics> <world> <wall time> <solver iterations> <contacts> <hash>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/test/helper_physics_generator.hh"
+
+using namespace gazebo;
+
+/// \brief Steps taken for every case.
+static const unsigned int STEPS = 2000;
+
+/// \brief Seed of the random number generator, set before loading.
+static const unsigned int SEED = 1;
+
+/// \brief Relative increase of the wall time above which a case fails.
+static const double WALL_TIME_TOLERANCE = 0.2;
+
+/// \brief Relative change of the contact count above which a case fails.
+static const double CONTACT_TOLERANCE = 0.02;
+
+/// \brief Reference worlds.
+static const char *WORLDS[] = {
+  "worlds/shapes.world",
+  "worlds/joints.world",
+  "test/worlds/contact_stability.world"};
+
+/// \brief Result of one case.
+struct RegressionResult
+{
+  /// \brief Wall time of the steps, in seconds.
+  double wallTime = 0;
+
+  /// \brief Solver iterations per step, -1 if the engine has none.
+  int solverIterations = -1;
+
+  /// \brief Contacts summed over the steps.
+  uint64_t contacts = 0;
+
+  /// \brief Hash of the final state.
+  uint64_t hash = 0;
+};
+
+/// \brief Results of the cases run, by physics engine and world.
+static std::map<std::string, RegressionResult> g_results;
+
+class PhysicsRegression : public ServerFixture,
+                          public ::testing::WithParamInterface<const char *>
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Add bytes to a 64 bit FNV-1a hash.
+/// \param[in] _hash Hash to update.
+/// \param[in] _data Bytes to add.
+/// \param[in] _size Number of bytes.
+/// \return Updated hash.
+static uint64_t HashBytes(uint64_t _hash, const void *_data,
+    const size_t _size)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(_data);
+  for (size_t i = 0; i < _size; ++i)
+  {
+    _hash ^= bytes[i];
+    _hash *= 1099511628211ull;
+  }
+  return _hash;
+}
+
+/////////////////////////////////////////////////
+/// \brief Add a pose to a hash, bit for bit.
+/// \param[in] _hash Hash to update.
+/// \param[in] _pose Pose to add.
+/// \return Updated hash.
+static uint64_t HashPose(uint64_t _hash, const ignition::math::Pose3d &_pose)
+{
+  const double values[] = {_pose.Pos().X(), _pose.Pos().Y(),
+    _pose.Pos().Z(), _pose.Rot().W(), _pose.Rot().X(), _pose.Rot().Y(),
+    _pose.Rot().Z()};
+  return HashBytes(_hash, values, sizeof(values));
+}
+
+/////////////////////////////////////////////////
+/// \brief Add the links of a model and its nested models to a hash, in
+/// the order of their names.
+/// \param[in] _hash Hash to update.
+/// \param[in] _state State of the model.
+/// \return Updated hash.
+static uint64_t HashModel(uint64_t _hash, const physics::ModelState &_state)
+{
+  _hash = HashBytes(_hash, _state.GetName().data(), _state.GetName().size());
+  for (auto const &link : _state.GetLinkStates())
+  {
+    _hash = HashBytes(_hash, link.first.data(), link.first.size());
+    _hash = HashPose(_hash, link.second.Pose());
+    _hash = HashPose(_hash, link.second.Velocity());
+  }
+  for (auto const &nested : _state.NestedModelStates())
+    _hash = HashModel(_hash, nested.second);
+  return _hash;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the baselines file.
+/// \return Path of the file.
+static std::string BaselinesPath()
+{
+  const char *path = std::getenv("GAZEBO_PHYSICS_BASELINES");
+  return path ? path : "physics_baselines.txt";
+}
+
+/////////////////////////////////////////////////
+/// \brief Get whether the baselines are written instead of compared.
+/// \return True to write the baselines.
+static bool UpdateBaselines()
+{
+  const char *update = std::getenv("GAZEBO_PHYSICS_BASELINES_UPDATE");
+  return update && std::strcmp(update, "0") != 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the baselines file.
+/// \return Baselines by physics engine and world, empty if the file
+/// doesn't exist.
+static std::map<std::string, RegressionResult> ReadBaselines()
+{
+  std::map<std::string, RegressionResult> baselines;
+  std::ifstream in(BaselinesPath());
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream stream(line);
+    std::string physicsEngine, world;
+    RegressionResult result;
+    stream >> physicsEngine >> world >> result.wallTime
+      >> result.solverIterations >> result.contacts >> std::hex
+      >> result.hash;
+    if (stream)
+      baselines[physicsEngine + " " + world] = result;
+    else
+      gzerr << "Invalid baseline [" << line << "]\n";
+  }
+  return baselines;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the results of the cases as the new baselines.
+static void WriteBaselines()
+{
+  std::ofstream out(BaselinesPath());
+  if (!out)
+  {
+    gzerr << "Unable to write the baselines to [" << BaselinesPath() << "]\n";
+    return;
+  }
+
+  out << "# Gazebo " << GAZEBO_VERSION_FULL << ", " << STEPS << " steps\n"
+      << "# physics world wall_time solver_iterations contacts hash\n";
+  for (auto const &result : g_results)
+  {
+    out << result.first << " " << result.second.wallTime << " "
+        << result.second.solverIterations << " " << result.second.contacts
+        << " " << std::hex << result.second.hash << std::dec << "\n";
+  }
+  gzmsg << "Baselines written to [" << BaselinesPath() << "]\n";
+}
+
+/////////////////////////////////////////////////
+TEST_P(PhysicsRegression, ReferenceWorlds)
+{
+  const std::string physicsEngine = this->GetParam();
+  const std::map<std::string, RegressionResult> baselines = ReadBaselines();
+  if (baselines.empty() && !UpdateBaselines())
+  {
+    gzwarn << "No baselines in [" << BaselinesPath() << "], the results "
+           << "are only printed\n";
+  }
+
+  for (const char *worldFile : WORLDS)
+  {
+    ignition::math::Rand::Seed(SEED);
+    Load(worldFile, true, physicsEngine);
+    physics::WorldPtr world = physics::get_world();
+    ASSERT_TRUE(world != nullptr);
+    physics::PhysicsEnginePtr physics = world->Physics();
+    ASSERT_TRUE(physics != nullptr);
+
+    RegressionResult result;
+    try
+    {
+      result.solverIterations =
+        boost::any_cast<int>(physics->GetParam("iters"));
+    }
+    catch(const boost::bad_any_cast &)
+    {
+      result.solverIterations = -1;
+    }
+
+    // Count the contacts of every step, even without subscribers
+    physics::ContactManager *contactManager = physics->GetContactManager();
+    contactManager->SetNeverDropContacts(true);
+    event::ConnectionPtr connection = event::Events::ConnectWorldUpdateEnd(
+        [&result, contactManager]()
+        {
+          result.contacts += contactManager->GetContactCount();
+        });
+
+    const common::Time start = common::Time::GetWallTime();
+    world->Step(STEPS);
+    result.wallTime = (common::Time::GetWallTime() - start).Double();
+    connection.reset();
+
+    result.hash = 14695981039346656037ull;
+    physics::WorldState state(world);
+    for (auto const &model : state.GetModelStates())
+      result.hash = HashModel(result.hash, model.second);
+
+    const std::string key = physicsEngine + " " + worldFile;
+    gzmsg << key << ": " << result.wallTime << " s, "
+          << result.solverIterations << " solver iterations, "
+          << result.contacts << " contacts, hash " << std::hex
+          << result.hash << std::dec << "\n";
+    g_results[key] = result;
+
+    auto baseline = baselines.find(key);
+    if (!UpdateBaselines() && baseline != baselines.end())
+    {
+      EXPECT_LE(result.wallTime,
+          baseline->second.wallTime * (1 + WALL_TIME_TOLERANCE))
+        << key << " is slower than its baseline";
+      EXPECT_EQ(baseline->second.solverIterations, result.solverIterations)
+        << key << " solver iterations changed";
+      EXPECT_NEAR(static_cast<double>(baseline->second.contacts),
+          static_cast<double>(result.contacts),
+          CONTACT_TOLERANCE * baseline->second.contacts)
+        << key << " contact count changed";
+      EXPECT_EQ(baseline->second.hash, result.hash)
+        << key << " trajectories changed";
+    }
+
+    this->Unload();
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(PhysicsEngines, PhysicsRegression,
+    PHYSICS_ENGINE_VALUES,);  // NOLINT
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  const int result = RUN_ALL_TESTS();
+
+  if (UpdateBaselines())
+    WriteBaselines();
+
+  return result;
+}
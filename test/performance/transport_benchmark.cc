@@ -0,0 +1,534 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Transport benchmark. Measures latency percentiles and throughput of
+// ImageStamped messages for several payload sizes, with:
+// - "local" subscribers, which receive the published message itself,
+// - "serialized" subscribers in the same process, which receive the
+//   serialized message through a raw callback,
+// - a "remote" subscriber in a child process, which sends every message
+//   back, so its latency is a round trip,
+// - local fan-out to 1, 10 and 100 subscribers.
+//
+// The results are written as JSON to the file named by the
+// GAZEBO_TRANSPORT_BENCHMARK_OUTPUT environment variable, or to
+// transport_benchmark.json in the working directory.
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Payload sizes, in bytes.
+static const std::vector<size_t> PAYLOAD_SIZES =
+    {100, 10000, 100000, 1000000, 20000000};
+
+/// \brief Numbers of local subscribers of the fan-out cases.
+static const std::vector<unsigned int> FAN_OUTS = {1, 10, 100};
+
+/// \brief Bytes published by each pass of a case, which sets the number
+/// of messages of the large payloads.
+static const size_t PASS_BYTES = 200000000;
+
+/// \brief Most messages published by each pass of a case.
+static const unsigned int MAX_MESSAGES = 1000;
+
+/// \brief Fewest messages published by each pass of a case.
+static const unsigned int MIN_MESSAGES = 10;
+
+/// \brief Time to wait for a message to be received, in seconds.
+static const double RECEIVE_TIMEOUT = 10.0;
+
+/// \brief Topic the remote subscriber listens to.
+static const char REMOTE_TOPIC[] = "/gazebo/benchmark/remote";
+
+/// \brief Topic the remote subscriber sends the messages back on.
+static const char ECHO_TOPIC[] = "/gazebo/benchmark/echo";
+
+/// \brief Command line argument that runs the remote subscriber.
+static const char ECHO_ARG[] = "--echo";
+
+/// \brief Path of this executable, used to start the remote subscriber.
+static std::string g_executable;
+
+/// \brief Result of one benchmark case.
+struct BenchmarkResult
+{
+  /// \brief Kind of subscribers.
+  std::string mode;
+
+  /// \brief Payload size, in bytes.
+  size_t payload;
+
+  /// \brief Number of subscribers.
+  unsigned int subscribers;
+
+  /// \brief Number of messages published by each pass.
+  unsigned int messages;
+
+  /// \brief Latency of each received message, in seconds.
+  std::vector<double> latencies;
+
+  /// \brief Time to receive a burst of messages, in seconds.
+  double seconds;
+};
+
+/// \brief Results of all the cases, written when the tests end.
+static std::vector<BenchmarkResult> g_results;
+
+/// \brief Receives benchmark messages and records their latency.
+class BenchmarkReceiver
+{
+  /// \brief Callback of a local subscriber.
+  /// \param[in] _msg The message.
+  public: void OnMsg(ConstImageStampedPtr &_msg)
+  {
+    this->Record(*_msg);
+  }
+
+  /// \brief Callback of a serialized subscriber.
+  /// \param[in] _data The serialized message.
+  public: void OnRaw(const std::string &_data)
+  {
+    msgs::ImageStamped msg;
+    msg.ParseFromString(_data);
+    this->Record(msg);
+  }
+
+  /// \brief Forget the received messages.
+  public: void Reset()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->latencies.clear();
+  }
+
+  /// \brief Wait for a number of messages.
+  /// \param[in] _count Number of messages since the last Reset.
+  /// \return False if the messages didn't arrive in time.
+  public: bool Wait(const size_t _count)
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    return this->condition.wait_for(lock,
+        std::chrono::duration<double>(RECEIVE_TIMEOUT),
+        [this, _count] {return this->latencies.size() >= _count;});
+  }
+
+  /// \brief Get the number of messages received since the last Reset.
+  /// \return Number of messages.
+  public: size_t Count()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->latencies.size();
+  }
+
+  /// \brief Get the latencies since the last Reset.
+  /// \return Latency of each message, in seconds.
+  public: std::vector<double> Latencies()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->latencies;
+  }
+
+  /// \brief Get the time the last message was received.
+  /// \return The wall time.
+  public: common::Time Last()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->last;
+  }
+
+  /// \brief Record a received message.
+  /// \param[in] _msg The message, stamped when it was published.
+  private: void Record(const msgs::ImageStamped &_msg)
+  {
+    common::Time now = common::Time::GetWallTime();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->latencies.push_back((now - msgs::Convert(_msg.time())).Double());
+    this->last = now;
+    this->condition.notify_all();
+  }
+
+  /// \brief Latency of each message since the last Reset, in seconds.
+  private: std::vector<double> latencies;
+
+  /// \brief Time the last message was received.
+  private: common::Time last;
+
+  /// \brief Protects the received messages.
+  private: std::mutex mutex;
+
+  /// \brief Notified when a message is received.
+  private: std::condition_variable condition;
+};
+
+typedef std::shared_ptr<BenchmarkReceiver> BenchmarkReceiverPtr;
+
+class TransportBenchmark : public ServerFixture
+{
+  /// \brief Publish the messages of a case and record the results.
+  /// \param[in] _mode Kind of subscribers.
+  /// \param[in] _payload Payload size, in bytes.
+  /// \param[in] _pub Publisher of the case.
+  /// \param[in] _receivers Receivers of the published messages.
+  public: void Run(const std::string &_mode, const size_t _payload,
+              transport::PublisherPtr _pub,
+              const std::vector<BenchmarkReceiverPtr> &_receivers);
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the number of messages of each pass of a case.
+/// \param[in] _payload Payload size, in bytes.
+/// \return Number of messages.
+static unsigned int MessageCount(const size_t _payload)
+{
+  return static_cast<unsigned int>(std::max<size_t>(MIN_MESSAGES,
+        std::min<size_t>(MAX_MESSAGES, PASS_BYTES / _payload)));
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a percentile of sorted values.
+/// \param[in] _values The values, in increasing order.
+/// \param[in] _percentile The percentile, between 0 and 100.
+/// \return The value at the percentile, 0 without values.
+static double Percentile(const std::vector<double> &_values,
+    const double _percentile)
+{
+  if (_values.empty())
+    return 0;
+
+  size_t index = static_cast<size_t>(
+      _percentile / 100.0 * (_values.size() - 1) + 0.5);
+  return _values[std::min(index, _values.size() - 1)];
+}
+
+/////////////////////////////////////////////////
+void TransportBenchmark::Run(const std::string &_mode, const size_t _payload,
+    transport::PublisherPtr _pub,
+    const std::vector<BenchmarkReceiverPtr> &_receivers)
+{
+  BenchmarkResult result;
+  result.mode = _mode;
+  result.payload = _payload;
+  result.subscribers = _receivers.size();
+  result.messages = MessageCount(_payload);
+  result.seconds = 0;
+
+  msgs::ImageStamped msg;
+  msg.mutable_image()->set_width(1);
+  msg.mutable_image()->set_height(1);
+  msg.mutable_image()->set_pixel_format(0);
+  msg.mutable_image()->set_step(_payload);
+  msg.mutable_image()->set_data(std::string(_payload, 'x'));
+
+  // Latency: publish one message at a time
+  for (auto &receiver : _receivers)
+    receiver->Reset();
+
+  for (unsigned int i = 0; i < result.messages; ++i)
+  {
+    msgs::Set(msg.mutable_time(), common::Time::GetWallTime());
+    _pub->Publish(msg);
+
+    for (auto &receiver : _receivers)
+      ASSERT_TRUE(receiver->Wait(i + 1)) << _mode << " " << _payload;
+  }
+
+  for (auto &receiver : _receivers)
+  {
+    std::vector<double> latencies = receiver->Latencies();
+    result.latencies.insert(result.latencies.end(), latencies.begin(),
+        latencies.end());
+  }
+  std::sort(result.latencies.begin(), result.latencies.end());
+
+  // Throughput: publish all the messages at once
+  for (auto &receiver : _receivers)
+    receiver->Reset();
+
+  common::Time start = common::Time::GetWallTime();
+  for (unsigned int i = 0; i < result.messages; ++i)
+  {
+    msgs::Set(msg.mutable_time(), common::Time::GetWallTime());
+    _pub->Publish(msg);
+  }
+
+  common::Time end = start;
+  for (auto &receiver : _receivers)
+  {
+    ASSERT_TRUE(receiver->Wait(result.messages)) << _mode << " " << _payload;
+    end = std::max(end, receiver->Last());
+  }
+  result.seconds = (end - start).Double();
+
+  gzmsg << _mode << " payload[" << _payload << "] subscribers["
+        << result.subscribers << "] p50[" << Percentile(result.latencies, 50)
+        << "s] p99[" << Percentile(result.latencies, 99) << "s] "
+        << result.messages / std::max(result.seconds, 1e-9) << " msgs/s\n";
+
+  g_results.push_back(result);
+}
+
+/////////////////////////////////////////////////
+// Subscribers that receive the published message itself
+TEST_F(TransportBenchmark, Local)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  for (auto payload : PAYLOAD_SIZES)
+  {
+    std::string topic = "/gazebo/benchmark/local_" + std::to_string(payload);
+    transport::PublisherPtr pub = node->Advertise<msgs::ImageStamped>(
+        topic, MAX_MESSAGES);
+
+    BenchmarkReceiverPtr receiver(new BenchmarkReceiver);
+    transport::SubscriberPtr sub = node->Subscribe(topic,
+        &BenchmarkReceiver::OnMsg, receiver.get());
+
+    this->Run("local", payload, pub, {receiver});
+  }
+}
+
+/////////////////////////////////////////////////
+// Subscribers in the same process that receive the serialized message
+TEST_F(TransportBenchmark, Serialized)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  for (auto payload : PAYLOAD_SIZES)
+  {
+    std::string topic = "/gazebo/benchmark/serialized_" +
+      std::to_string(payload);
+    transport::PublisherPtr pub = node->Advertise<msgs::ImageStamped>(
+        topic, MAX_MESSAGES);
+
+    BenchmarkReceiverPtr receiver(new BenchmarkReceiver);
+    transport::SubscriberPtr sub = node->Subscribe(topic,
+        &BenchmarkReceiver::OnRaw, receiver.get());
+
+    this->Run("serialized", payload, pub, {receiver});
+  }
+}
+
+/////////////////////////////////////////////////
+// Local subscribers, each in its own node, to the same publisher
+TEST_F(TransportBenchmark, FanOut)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  for (auto fanOut : FAN_OUTS)
+  {
+    for (auto payload : PAYLOAD_SIZES)
+    {
+      std::string topic = "/gazebo/benchmark/fan_out_" +
+        std::to_string(fanOut) + "_" + std::to_string(payload);
+      transport::PublisherPtr pub = node->Advertise<msgs::ImageStamped>(
+          topic, MAX_MESSAGES);
+
+      std::vector<transport::NodePtr> subNodes;
+      std::vector<transport::SubscriberPtr> subs;
+      std::vector<BenchmarkReceiverPtr> receivers;
+      for (unsigned int i = 0; i < fanOut; ++i)
+      {
+        subNodes.push_back(transport::NodePtr(new transport::Node()));
+        subNodes.back()->Init();
+        receivers.push_back(BenchmarkReceiverPtr(new BenchmarkReceiver));
+        subs.push_back(subNodes.back()->Subscribe(topic,
+              &BenchmarkReceiver::OnMsg, receivers.back().get()));
+      }
+
+      this->Run("fan_out", payload, pub, receivers);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// A subscriber in another process, which sends the messages back
+TEST_F(TransportBenchmark, Remote)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  transport::PublisherPtr pub = node->Advertise<msgs::ImageStamped>(
+      REMOTE_TOPIC, MAX_MESSAGES);
+
+  BenchmarkReceiverPtr receiver(new BenchmarkReceiver);
+  transport::SubscriberPtr sub = node->Subscribe(ECHO_TOPIC,
+      &BenchmarkReceiver::OnMsg, receiver.get());
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0)
+  {
+    execl(g_executable.c_str(), g_executable.c_str(), ECHO_ARG,
+        static_cast<char *>(nullptr));
+    _exit(EXIT_FAILURE);
+  }
+
+  // Wait for the remote subscriber to send messages back
+  msgs::ImageStamped ping;
+  ping.mutable_image()->set_width(1);
+  ping.mutable_image()->set_height(1);
+  ping.mutable_image()->set_pixel_format(0);
+  ping.mutable_image()->set_step(1);
+  ping.mutable_image()->set_data("x");
+
+  bool connected = false;
+  for (int i = 0; i < 300 && !connected; ++i)
+  {
+    msgs::Set(ping.mutable_time(), common::Time::GetWallTime());
+    pub->Publish(ping);
+    common::Time::MSleep(100);
+    connected = receiver->Count() > 0;
+  }
+  EXPECT_TRUE(connected);
+
+  if (connected)
+  {
+    for (auto payload : PAYLOAD_SIZES)
+      this->Run("remote_round_trip", payload, pub, {receiver});
+  }
+
+  kill(child, SIGTERM);
+  waitpid(child, nullptr, 0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the results as JSON.
+/// \param[in] _path Path of the file.
+static void WriteResults(const std::string &_path)
+{
+  std::ofstream out(_path);
+  if (!out)
+  {
+    gzerr << "Unable to write benchmark results to [" << _path << "]\n";
+    return;
+  }
+
+  out << "{\n"
+      << "  \"benchmark\": \"transport\",\n"
+      << "  \"gazebo_version\": \"" << GAZEBO_VERSION_FULL << "\",\n"
+      << "  \"results\": [";
+
+  for (size_t i = 0; i < g_results.size(); ++i)
+  {
+    const BenchmarkResult &result = g_results[i];
+    double seconds = std::max(result.seconds, 1e-9);
+
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\n"
+        << "      \"mode\": \"" << result.mode << "\",\n"
+        << "      \"payload_bytes\": " << result.payload << ",\n"
+        << "      \"subscribers\": " << result.subscribers << ",\n"
+        << "      \"messages\": " << result.messages << ",\n"
+        << "      \"latency_us\": {"
+        << "\"p50\": " << Percentile(result.latencies, 50) * 1e6 << ", "
+        << "\"p90\": " << Percentile(result.latencies, 90) * 1e6 << ", "
+        << "\"p99\": " << Percentile(result.latencies, 99) * 1e6 << ", "
+        << "\"max\": " << Percentile(result.latencies, 100) * 1e6 << "},\n"
+        << "      \"throughput_msgs_per_sec\": "
+        << result.messages / seconds << ",\n"
+        << "      \"throughput_mb_per_sec\": "
+        << result.messages * result.payload / seconds / 1e6 << "\n"
+        << "    }";
+  }
+
+  out << "\n  ]\n}\n";
+  gzmsg << "Benchmark results written to [" << _path << "]\n";
+}
+
+/// \brief Remote subscriber, which publishes back each message it
+/// receives, with its original time stamp.
+class BenchmarkEcho
+{
+  /// \brief Callback of the subscriber.
+  /// \param[in] _msg The message.
+  public: void OnMsg(ConstImageStampedPtr &_msg)
+  {
+    this->pub->Publish(*_msg);
+  }
+
+  /// \brief Publisher of the messages sent back.
+  public: transport::PublisherPtr pub;
+};
+
+/////////////////////////////////////////////////
+/// \brief Run the remote subscriber until it is killed or its parent
+/// exits.
+/// \return Exit code.
+static int RunEcho()
+{
+  if (!transport::init())
+    return EXIT_FAILURE;
+  transport::run();
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  BenchmarkEcho echo;
+  echo.pub = node->Advertise<msgs::ImageStamped>(ECHO_TOPIC, MAX_MESSAGES);
+  transport::SubscriberPtr sub = node->Subscribe(REMOTE_TOPIC,
+      &BenchmarkEcho::OnMsg, &echo);
+
+  pid_t parent = getppid();
+  while (getppid() == parent)
+    common::Time::MSleep(100);
+
+  transport::fini();
+  return EXIT_SUCCESS;
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  if (argc > 1 && std::string(argv[1]) == ECHO_ARG)
+    return RunEcho();
+
+  g_executable = argv[0];
+
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+
+  const char *path = std::getenv("GAZEBO_TRANSPORT_BENCHMARK_OUTPUT");
+  WriteResults(path ? path : "transport_benchmark.json");
+
+  return result;
+}
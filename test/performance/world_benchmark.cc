@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// World stepping benchmark. Measures the steps per second of canonical
+// scenes with 1, 10 and 50 of:
+// - "boxes": boxes stacked in columns of ten,
+// - "humanoids": ragdolls of eleven links and ten revolute joints,
+// - "trimeshes": triangle meshes dropped on the ground,
+// - "rays": ray sensors of 640 samples,
+// - "cameras": 320x240 cameras, when rendering is available,
+// for every physics engine Gazebo was built with.
+//
+// The results are written as JSON to the file named by the
+// GAZEBO_WORLD_BENCHMARK_OUTPUT environment variable, or to
+// world_benchmark.json in the working directory.
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/test/helper_physics_generator.hh"
+#include "test_config.h"
+
+using namespace gazebo;
+
+/// \brief Steps taken before timing, so that the spawned models settle
+/// and the sensors start.
+static const unsigned int WARMUP_STEPS = 100;
+
+/// \brief Steps that are timed.
+static const unsigned int TIMED_STEPS = 1000;
+
+/// \brief Number of boxes in a column of the "boxes" scene.
+static const unsigned int BOX_COLUMN = 10;
+
+/// \brief Result of one benchmark case.
+struct BenchmarkResult
+{
+  /// \brief Physics engine.
+  std::string physics;
+
+  /// \brief Scene.
+  std::string scene;
+
+  /// \brief Number of models or sensors in the scene.
+  unsigned int count;
+
+  /// \brief Time to take the timed steps, in wall clock seconds.
+  double seconds;
+
+  /// \brief Simulated time of the timed steps, in seconds.
+  double simSeconds;
+};
+
+/// \brief Results of all the cases, written when the tests end.
+static std::vector<BenchmarkResult> g_results;
+
+/// \brief Physics engine and number of models or sensors of a case.
+typedef std::tuple<const char *, unsigned int> BenchmarkParam;
+
+class WorldBenchmark : public ServerFixture,
+                       public ::testing::WithParamInterface<BenchmarkParam>
+{
+  /// \brief Take the warmup steps, then time the steps and record the
+  /// results.
+  /// \param[in] _scene Name of the scene.
+  public: void Run(const std::string &_scene);
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a link with one shape, used for both its
+/// collision and its visual.
+/// \param[in] _name Name of the link.
+/// \param[in] _pose Pose of the link in the model frame.
+/// \param[in] _geometry SDF of the geometry.
+/// \param[in] _mass Mass of the link.
+/// \return SDF of the link.
+static std::string LinkSdf(const std::string &_name,
+    const ignition::math::Pose3d &_pose, const std::string &_geometry,
+    const double _mass)
+{
+  std::ostringstream sdf;
+  sdf << "<link name='" << _name << "'>"
+      << "  <pose>" << _pose << "</pose>"
+      << "  <inertial>"
+      << "    <mass>" << _mass << "</mass>"
+      << "    <inertia>"
+      << "      <ixx>" << _mass * 0.01 << "</ixx>"
+      << "      <iyy>" << _mass * 0.01 << "</iyy>"
+      << "      <izz>" << _mass * 0.01 << "</izz>"
+      << "    </inertia>"
+      << "  </inertial>"
+      << "  <collision name='collision'>"
+      << "    <geometry>" << _geometry << "</geometry>"
+      << "  </collision>"
+      << "  <visual name='visual'>"
+      << "    <geometry>" << _geometry << "</geometry>"
+      << "  </visual>"
+      << "</link>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a revolute joint.
+/// \param[in] _name Name of the joint.
+/// \param[in] _parent Name of the parent link.
+/// \param[in] _child Name of the child link.
+/// \param[in] _pos Position of the joint in the child frame.
+/// \param[in] _axis Axis of the joint in the model frame.
+/// \return SDF of the joint.
+static std::string JointSdf(const std::string &_name,
+    const std::string &_parent, const std::string &_child,
+    const ignition::math::Vector3d &_pos,
+    const ignition::math::Vector3d &_axis)
+{
+  std::ostringstream sdf;
+  sdf << "<joint name='" << _name << "' type='revolute'>"
+      << "  <parent>" << _parent << "</parent>"
+      << "  <child>" << _child << "</child>"
+      << "  <pose>" << _pos << " 0 0 0</pose>"
+      << "  <axis>"
+      << "    <xyz>" << _axis << "</xyz>"
+      << "    <limit><lower>-1.5</lower><upper>1.5</upper></limit>"
+      << "  </axis>"
+      << "</joint>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a humanoid ragdoll, standing on the ground.
+/// \param[in] _name Name of the model.
+/// \param[in] _pos Position of the model.
+/// \return SDF of the model.
+static std::string HumanoidSdf(const std::string &_name,
+    const ignition::math::Vector3d &_pos)
+{
+  using ignition::math::Pose3d;
+  using ignition::math::Vector3d;
+
+  const std::string limb =
+    "<cylinder><radius>0.05</radius><length>0.35</length></cylinder>";
+
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='" << _name << "'>"
+      << "<pose>" << _pos << " 0 0 0</pose>"
+      << LinkSdf("pelvis", Pose3d(0, 0, 0.95, 0, 0, 0),
+          "<box><size>0.3 0.2 0.15</size></box>", 8)
+      << LinkSdf("torso", Pose3d(0, 0, 1.3, 0, 0, 0),
+          "<box><size>0.35 0.2 0.45</size></box>", 20)
+      << LinkSdf("head", Pose3d(0, 0, 1.65, 0, 0, 0),
+          "<sphere><radius>0.1</radius></sphere>", 4);
+
+  for (const int side : {-1, 1})
+  {
+    const std::string s = side < 0 ? "right_" : "left_";
+    sdf << LinkSdf(s + "thigh", Pose3d(0, side * 0.1, 0.68, 0, 0, 0),
+            limb, 6)
+        << LinkSdf(s + "shin", Pose3d(0, side * 0.1, 0.3, 0, 0, 0),
+            limb, 4)
+        << LinkSdf(s + "upper_arm", Pose3d(0, side * 0.25, 1.35, 0, 0, 0),
+            limb, 2)
+        << LinkSdf(s + "forearm", Pose3d(0, side * 0.25, 1.0, 0, 0, 0),
+            limb, 1.5)
+        << JointSdf(s + "hip", "pelvis", s + "thigh",
+            Vector3d(0, 0, 0.175), Vector3d::UnitY)
+        << JointSdf(s + "knee", s + "thigh", s + "shin",
+            Vector3d(0, 0, 0.175), Vector3d::UnitY)
+        << JointSdf(s + "shoulder", "torso", s + "upper_arm",
+            Vector3d(0, 0, 0.175), Vector3d::UnitY)
+        << JointSdf(s + "elbow", s + "upper_arm", s + "forearm",
+            Vector3d(0, 0, 0.175), Vector3d::UnitY);
+  }
+
+  sdf << JointSdf("waist", "pelvis", "torso", Vector3d(0, 0, -0.225),
+          Vector3d::UnitX)
+      << JointSdf("neck", "torso", "head", Vector3d(0, 0, -0.1),
+          Vector3d::UnitZ)
+      << "</model>"
+      << "</sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the position of a model in a grid, so that the models of a
+/// scene don't overlap.
+/// \param[in] _index Index of the model.
+/// \param[in] _spacing Distance between the models, in meters.
+/// \return Position of the model on the ground.
+static ignition::math::Vector3d GridPosition(const unsigned int _index,
+    const double _spacing)
+{
+  return ignition::math::Vector3d((_index % 10) * _spacing,
+      (_index / 10) * _spacing, 0);
+}
+
+/////////////////////////////////////////////////
+void WorldBenchmark::Run(const std::string &_scene)
+{
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  world->Step(WARMUP_STEPS);
+
+  const common::Time simStart = world->SimTime();
+  const common::Time start = common::Time::GetWallTime();
+  world->Step(TIMED_STEPS);
+  const common::Time end = common::Time::GetWallTime();
+
+  BenchmarkResult result;
+  result.physics = std::get<0>(this->GetParam());
+  result.scene = _scene;
+  result.count = std::get<1>(this->GetParam());
+  result.seconds = (end - start).Double();
+  result.simSeconds = (world->SimTime() - simStart).Double();
+
+  const double seconds = std::max(result.seconds, 1e-9);
+  gzmsg << result.physics << " " << _scene << "[" << result.count << "] "
+        << TIMED_STEPS / seconds << " steps/s, real time factor "
+        << result.simSeconds / seconds << "\n";
+
+  g_results.push_back(result);
+}
+
+/////////////////////////////////////////////////
+// Boxes stacked in columns
+TEST_P(WorldBenchmark, Boxes)
+{
+  const std::string physicsEngine = std::get<0>(this->GetParam());
+  const unsigned int count = std::get<1>(this->GetParam());
+  Load("worlds/empty.world", true, physicsEngine);
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    ignition::math::Vector3d pos = GridPosition(i / BOX_COLUMN, 2.0);
+    pos.Z(0.5 + (i % BOX_COLUMN) * 1.001);
+    SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d::One, pos);
+  }
+
+  this->Run("boxes");
+}
+
+/////////////////////////////////////////////////
+// Articulated ragdolls falling on the ground
+TEST_P(WorldBenchmark, Humanoids)
+{
+  const std::string physicsEngine = std::get<0>(this->GetParam());
+  const unsigned int count = std::get<1>(this->GetParam());
+  Load("worlds/empty.world", true, physicsEngine);
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    const std::string name = "humanoid_" + std::to_string(i);
+    SpawnSDF(HumanoidSdf(name, GridPosition(i, 2.0)));
+    WaitUntilEntitySpawn(name, 100, 100);
+  }
+
+  this->Run("humanoids");
+}
+
+/////////////////////////////////////////////////
+// Triangle meshes dropped on the ground
+TEST_P(WorldBenchmark, Trimeshes)
+{
+  const std::string physicsEngine = std::get<0>(this->GetParam());
+  if (physicsEngine == "simbody")
+  {
+    gzerr << "Aborting test for " << physicsEngine
+          << ", which doesn't support triangle meshes.\n";
+    return;
+  }
+
+  const unsigned int count = std::get<1>(this->GetParam());
+  Load("worlds/empty.world", true, physicsEngine);
+
+  const std::string mesh = std::string("file://") + TEST_PATH +
+    "/data/cordless_drill/meshes/cordless_drill.dae";
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    ignition::math::Vector3d pos = GridPosition(i, 1.0);
+    pos.Z(0.5);
+    SpawnTrimesh("trimesh_" + std::to_string(i), mesh,
+        ignition::math::Vector3d::One, pos);
+  }
+
+  this->Run("trimeshes");
+}
+
+/////////////////////////////////////////////////
+// Ray sensors above boxes
+TEST_P(WorldBenchmark, Rays)
+{
+  const std::string physicsEngine = std::get<0>(this->GetParam());
+  const unsigned int count = std::get<1>(this->GetParam());
+  Load("worlds/empty.world", true, physicsEngine);
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    const std::string suffix = std::to_string(i);
+    ignition::math::Vector3d pos = GridPosition(i, 3.0);
+    SpawnBox("box_" + suffix, ignition::math::Vector3d::One,
+        pos + ignition::math::Vector3d(1.5, 0, 0.5),
+        ignition::math::Vector3d::Zero, true);
+    pos.Z(0.5);
+    SpawnRaySensor("ray_model_" + suffix, "ray_sensor_" + suffix, pos);
+  }
+
+  this->Run("rays");
+}
+
+/////////////////////////////////////////////////
+// Cameras looking at boxes
+TEST_P(WorldBenchmark, Cameras)
+{
+  const std::string physicsEngine = std::get<0>(this->GetParam());
+  const unsigned int count = std::get<1>(this->GetParam());
+  Load("worlds/empty.world", true, physicsEngine);
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run camera benchmark\n";
+    return;
+  }
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    const std::string suffix = std::to_string(i);
+    ignition::math::Vector3d pos = GridPosition(i, 3.0);
+    SpawnBox("box_" + suffix, ignition::math::Vector3d::One,
+        pos + ignition::math::Vector3d(1.5, 0, 0.5),
+        ignition::math::Vector3d::Zero, true);
+    pos.Z(0.5);
+    SpawnCamera("camera_model_" + suffix, "camera_sensor_" + suffix, pos);
+  }
+
+  this->Run("cameras");
+}
+
+INSTANTIATE_TEST_CASE_P(PhysicsEngines, WorldBenchmark,
+    ::testing::Combine(PHYSICS_ENGINE_VALUES, ::testing::Values(1u, 10u, 50u)));
+
+/////////////////////////////////////////////////
+/// \brief Write the results as JSON.
+/// \param[in] _path Path of the file.
+static void WriteResults(const std::string &_path)
+{
+  std::ofstream out(_path);
+  if (!out)
+  {
+    gzerr << "Unable to write benchmark results to [" << _path << "]\n";
+    return;
+  }
+
+  out << "{\n"
+      << "  \"benchmark\": \"world\",\n"
+      << "  \"gazebo_version\": \"" << GAZEBO_VERSION_FULL << "\",\n"
+      << "  \"results\": [";
+
+  for (size_t i = 0; i < g_results.size(); ++i)
+  {
+    const BenchmarkResult &result = g_results[i];
+    double seconds = std::max(result.seconds, 1e-9);
+
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\n"
+        << "      \"physics\": \"" << result.physics << "\",\n"
+        << "      \"scene\": \"" << result.scene << "\",\n"
+        << "      \"count\": " << result.count << ",\n"
+        << "      \"steps\": " << TIMED_STEPS << ",\n"
+        << "      \"seconds\": " << result.seconds << ",\n"
+        << "      \"steps_per_sec\": " << TIMED_STEPS / seconds << ",\n"
+        << "      \"real_time_factor\": " << result.simSeconds / seconds
+        << "\n"
+        << "    }";
+  }
+
+  out << "\n  ]\n}\n";
+  gzmsg << "Benchmark results written to [" << _path << "]\n";
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+
+  const char *path = std::getenv("GAZEBO_WORLD_BENCHMARK_OUTPUT");
+  WriteResults(path ? path : "world_benchmark.json");
+
+  return result;
+}
@@ -19,11 +19,13 @@
 #include <tinyxml.h>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
+#include <sstream>
 #include <streambuf>
 
 #include <gazebo/common/common.hh>
 #include <gazebo/transport/transport.hh>
 #include <sdf/sdf.hh>
+#include "gz_bench.hh"
 #include "gz_log.hh"
 #include "gz_marker.hh"
 #include "gz_topic.hh"
@@ -900,7 +902,15 @@ StatsCommand::StatsCommand()
     ("world-name,w", po::value<std::string>(), "World name.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run.")
     ("plot,p", "Output comma-separated values, useful for processing and "
-     "plotting.");
+     "plotting.")
+    ("sensors,s", "Print the update statistics of the sensors instead of "
+     "the world statistics.")
+    ("phases", "Also print the average wall time per iteration of the "
+     "phases of the world update.")
+    ("jitter", "Also print the wall time between world updates and the "
+     "number of late updates.")
+    ("memory", "Print the memory counted per subsystem and per model "
+     "instead, once per second.");
 }
 
 /////////////////////////////////////////////////
@@ -909,7 +919,16 @@ void StatsCommand::HelpDetailed()
   std::cerr <<
     "\tPrint gzserver statics to standard out. If a name for the world, \n"
     "\toption -w, is not specified, the first world found on \n"
-    "\tthe Gazebo master will be used.\n"
+    "\tthe Gazebo master will be used. With option -s, the average \n"
+    "\twall time of the stages of the sensor updates and their achieved \n"
+    "\trates are printed instead. With option --phases, the average wall \n"
+    "\ttime per iteration of the phases of the world update is printed \n"
+    "\tafter the world statistics. With option --jitter, the period of \n"
+    "\tthe world updates, its histogram by lateness and the number of \n"
+    "\tupdates that started late are printed after the world statistics.\n"
+    "\tWith option --memory, the memory \n"
+    "\tcounted per subsystem and per model is printed instead, which \n"
+    "\trequires running gzserver with GAZEBO_MEMORY_ACCOUNTING=1.\n"
     << std::endl;
 }
 
@@ -921,11 +940,17 @@ bool StatsCommand::RunImpl()
   if (this->vm.count("world-name"))
     worldName = this->vm["world-name"].as<std::string>();
 
+  if (this->vm.count("memory"))
+    return this->PrintMemory(worldName);
+
   transport::NodePtr node(new transport::Node());
   node->Init(worldName);
 
-  transport::SubscriberPtr sub =
-    node->Subscribe("~/world_stats", &StatsCommand::CB, this);
+  transport::SubscriberPtr sub;
+  if (this->vm.count("sensors"))
+    sub = node->Subscribe("~/sensors/stats", &StatsCommand::SensorsCB, this);
+  else
+    sub = node->Subscribe("~/world_stats", &StatsCommand::CB, this);
 
   boost::mutex::scoped_lock lock(this->sigMutex);
   if (this->vm.count("duration"))
@@ -937,6 +962,82 @@ bool StatsCommand::RunImpl()
   return true;
 }
 
+/////////////////////////////////////////////////
+bool StatsCommand::PrintMemory(const std::string &_worldName)
+{
+  const common::Time end = this->vm.count("duration") ?
+    common::Time::GetWallTime() +
+    common::Time(this->vm["duration"].as<uint64_t>(), 0) : common::Time();
+  const bool plot = this->vm.count("plot") > 0;
+  bool first = true;
+
+  while (true)
+  {
+    boost::shared_ptr<msgs::Response> response =
+      transport::request(_worldName, "memory_info", "", common::Time(5, 0));
+
+    msgs::MemoryInfo msg;
+    if (!response || response->type() != msg.GetTypeName() ||
+        !msg.ParseFromString(response->serialized_data()))
+    {
+      std::cerr << "Unable to get the memory info of the world\n";
+      return false;
+    }
+
+    if (first && !msg.enabled())
+    {
+      std::cerr << "The memory accounting is disabled, run gzserver with "
+        << "GAZEBO_MEMORY_ACCOUNTING=1\n";
+    }
+
+    if (plot)
+    {
+      if (first)
+      {
+        std::cout << "# resident (MB)";
+        for (auto const &subsystem : msg.subsystems())
+          std::cout << ", " << subsystem.name() << " (MB)";
+        std::cout << "\n";
+      }
+      printf("%.3f", msg.resident() / 1e6);
+      for (auto const &subsystem : msg.subsystems())
+        printf(", %.3f", subsystem.bytes() / 1e6);
+      printf("\n");
+    }
+    else
+    {
+      printf("Resident[%.3f MB]", msg.resident() / 1e6);
+      for (auto const &subsystem : msg.subsystems())
+      {
+        printf(" %s[%.3f MB]", subsystem.name().c_str(),
+            subsystem.bytes() / 1e6);
+      }
+      printf("\n");
+
+      for (auto const &model : msg.models())
+      {
+        printf("  Model[%s]", model.name().c_str());
+        for (auto const &subsystem : model.subsystems())
+        {
+          printf(" %s[%.3f MB]", subsystem.name().c_str(),
+              subsystem.bytes() / 1e6);
+        }
+        printf("\n");
+      }
+    }
+    fflush(stdout);
+    first = false;
+
+    // Stop when interrupted or once the duration elapsed
+    boost::mutex::scoped_lock lock(this->sigMutex);
+    if (this->sigCondition.timed_wait(lock, boost::posix_time::seconds(1)) ||
+        (end != common::Time() && common::Time::GetWallTime() >= end))
+    {
+      return true;
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 void StatsCommand::CB(ConstWorldStatisticsPtr &_msg)
 {
@@ -984,22 +1085,136 @@ void StatsCommand::CB(ConstWorldStatisticsPtr &_msg)
   else
     paused = 'F';
 
+  const bool phases = this->vm.count("phases") > 0;
+  const msgs::WorldStatistics::PhaseTimes &phaseTimes = _msg->phase_times();
+  const bool jitter = this->vm.count("jitter") > 0;
+  const msgs::WorldStatistics::StepJitter &stepJitter = _msg->step_jitter();
+
   if (this->vm.count("plot"))
   {
     static bool first = true;
     if (first)
     {
       std::cout << "# real-time factor (percent), simtime (sec), "
-        << "realtime (sec), paused (T or F)\n";
+        << "realtime (sec), paused (T or F)";
+      if (phases)
+      {
+        std::cout << ", messages (ms), models (ms), collision (ms), "
+          << "physics (ms), dirty poses (ms), contacts (ms), logging (ms), "
+          << "sensors (ms)";
+      }
+      if (jitter)
+      {
+        std::cout << ", period min (ms), period avg (ms), period max (ms), "
+          << "overruns";
+      }
+      std::cout << "\n";
       first = false;
     }
-    printf("%4.2f, %16.6f, %16.6f, %c\n",
+    printf("%4.2f, %16.6f, %16.6f, %c",
         percent, simTime.Double(), realTime.Double(), paused);
+    if (phases)
+    {
+      printf(", %.4f, %.4f, %.4f, %.4f, %.4f, %.4f, %.4f, %.4f",
+          phaseTimes.message_processing() * 1e3,
+          phaseTimes.model_update() * 1e3, phaseTimes.collision() * 1e3,
+          phaseTimes.physics() * 1e3, phaseTimes.dirty_poses() * 1e3,
+          phaseTimes.contact_publish() * 1e3, phaseTimes.logging() * 1e3,
+          phaseTimes.sensor_wait() * 1e3);
+    }
+    if (jitter)
+    {
+      std::cout << ", " << stepJitter.period_min() * 1e3
+        << ", " << stepJitter.period_avg() * 1e3
+        << ", " << stepJitter.period_max() * 1e3
+        << ", " << stepJitter.overruns();
+    }
+    printf("\n");
     fflush(stdout);
   }
   else
+  {
     printf("Factor[%4.2f] SimTime[%4.2f] RealTime[%4.2f] Paused[%c]\n",
         percent, simTime.Double(), realTime.Double(), paused);
+    if (phases && _msg->has_phase_times())
+    {
+      printf("  Messages[%.4f ms] Models[%.4f ms] Collision[%.4f ms] "
+          "Physics[%.4f ms] DirtyPoses[%.4f ms] Contacts[%.4f ms] "
+          "Logging[%.4f ms] Sensors[%.4f ms]\n",
+          phaseTimes.message_processing() * 1e3,
+          phaseTimes.model_update() * 1e3, phaseTimes.collision() * 1e3,
+          phaseTimes.physics() * 1e3, phaseTimes.dirty_poses() * 1e3,
+          phaseTimes.contact_publish() * 1e3, phaseTimes.logging() * 1e3,
+          phaseTimes.sensor_wait() * 1e3);
+    }
+    if (jitter && _msg->has_step_jitter())
+    {
+      std::ostringstream stream;
+      stream << "  Period[" << stepJitter.target_period() * 1e3 << " ms] Min["
+        << stepJitter.period_min() * 1e3 << " ms] Avg["
+        << stepJitter.period_avg() * 1e3 << " ms] Max["
+        << stepJitter.period_max() * 1e3 << " ms] Overruns["
+        << stepJitter.overruns() << "]"
+        << (stepJitter.real_time() ? " RealTime" : "") << "\n  Late";
+      for (int i = 0; i < stepJitter.bucket_count_size(); ++i)
+      {
+        if (i < stepJitter.bucket_bound_size())
+          stream << " <=" << stepJitter.bucket_bound(i) * 1e6 << "us";
+        else
+          stream << " >";
+        stream << "[" << stepJitter.bucket_count(i) << "]";
+      }
+      std::cout << stream.str() << std::endl;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void StatsCommand::SensorsCB(ConstSensorStatsPtr &_msg)
+{
+  GZ_ASSERT(_msg, "Invalid message received");
+
+  common::Time simTime = msgs::Convert(_msg->sim_time());
+
+  if (this->vm.count("plot"))
+  {
+    static bool first = true;
+    if (first)
+    {
+      std::cout << "# simtime (sec), sensor, rate (Hz), achieved rate (Hz), "
+        << "update (ms), render (ms), readback (ms), publish (ms), "
+        << "updates, missed\n";
+      first = false;
+    }
+  }
+
+  for (auto const &sensor : _msg->sensor())
+  {
+    if (this->vm.count("plot"))
+    {
+      std::cout << simTime.Double() << ", " << sensor.name() << ", "
+        << sensor.update_rate() << ", " << sensor.achieved_rate() << ", "
+        << sensor.update_time() * 1e3 << ", "
+        << sensor.render_time() * 1e3 << ", "
+        << sensor.readback_time() * 1e3 << ", "
+        << sensor.publish_time() * 1e3 << ", "
+        << sensor.update_count() << ", " << sensor.missed_count() << "\n";
+    }
+    else
+    {
+      std::cout << "SimTime[" << simTime.Double() << "] "
+        << "Sensor[" << sensor.name() << "] "
+        << "Rate[" << sensor.achieved_rate() << "/"
+        << sensor.update_rate() << "] "
+        << "Update[" << sensor.update_time() * 1e3 << " ms] "
+        << "Render[" << sensor.render_time() * 1e3 << " ms] "
+        << "Readback[" << sensor.readback_time() * 1e3 << " ms] "
+        << "Publish[" << sensor.publish_time() * 1e3 << " ms] "
+        << "Missed[" << sensor.missed_count() << "/"
+        << sensor.update_count() << "]\n";
+    }
+  }
+  std::cout << std::flush;
 }
 
 /////////////////////////////////////////////////
@@ -1300,6 +1515,7 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  g_commandMap["bench-world"] = new BenchWorldCommand();
   g_commandMap["camera"] = new CameraCommand();
   g_commandMap["help"] = new HelpCommand();
   g_commandMap["joint"] = new JointCommand();
@@ -195,6 +195,16 @@ namespace gazebo
     /// \param[in] _msg World statistics message.
     private: void CB(ConstWorldStatisticsPtr &_msg);
 
+    /// \brief Sensor statistics callback.
+    /// \param[in] _msg Sensor statistics message.
+    private: void SensorsCB(ConstSensorStatsPtr &_msg);
+
+    /// \brief Request and print the memory counted by the server once per
+    /// second, until the duration elapses or the command is interrupted.
+    /// \param[in] _worldName Name of the world, empty for the first one.
+    /// \return False if the memory could not be requested.
+    private: bool PrintMemory(const std::string &_worldName);
+
     /// \brief Sim time buffer
     private: std::list<common::Time> simTimes;
 
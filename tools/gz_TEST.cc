@@ -31,6 +31,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <fstream>
 #include <string>
 
 #include "test/util.hh"
@@ -692,10 +693,59 @@ TEST_F(gzTest, Topic)
   output = custom_exec_str("gz topic -e /gazebo/default/world_stats -u -d 1");
   EXPECT_NE(output.find("real_time {"), std::string::npos);
 
+  // Echo selected fields
+  output = custom_exec_str("gz topic -e /gazebo/default/world_stats "
+      "--field sim_time.sec --field paused -d 1");
+  EXPECT_NE(output.find("sim_time.sec: "), std::string::npos);
+  EXPECT_NE(output.find("paused: "), std::string::npos);
+  EXPECT_EQ(output.find("real_time"), std::string::npos);
+
+  // Echo unknown field
+  output = custom_exec_str("gz topic -e /gazebo/default/world_stats "
+      "--field sim_time.bogus -d 1");
+  EXPECT_NE(output.find("Unable to find field[bogus]"), std::string::npos);
+
+  // Echo raw
+  output = custom_exec_str("gz topic -e /gazebo/default/world_stats "
+      "--raw -d 3");
+  EXPECT_NE(output.find("Bandwidth["), std::string::npos);
+  EXPECT_EQ(output.find("real_time {"), std::string::npos);
+
+  // Echo to a file
+  {
+    boost::filesystem::path dumpPath =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+    output = custom_exec_str("gz topic -e /gazebo/default/world_stats "
+        "--dump " + dumpPath.string() + " -d 2");
+    std::ifstream dump(dumpPath.string().c_str(), std::ios::binary);
+    ASSERT_TRUE(dump.good());
+    std::string msgType;
+    std::getline(dump, msgType);
+    EXPECT_EQ("gazebo.msgs.WorldStatistics", msgType);
+
+    unsigned char header[12];
+    ASSERT_TRUE(dump.read(reinterpret_cast<char *>(header), 12).good());
+    uint32_t size = 0;
+    for (int i = 0; i < 4; ++i)
+      size |= static_cast<uint32_t>(header[8 + i]) << (8 * i);
+    std::string data(size, '\0');
+    ASSERT_TRUE(dump.read(&data[0], size).good());
+    gazebo::msgs::WorldStatistics stats;
+    EXPECT_TRUE(stats.ParseFromString(data));
+    EXPECT_TRUE(stats.has_sim_time());
+    boost::filesystem::remove(dumpPath);
+  }
+
   // Hz
   output = custom_exec_str("gz topic -z /gazebo/default/world_stats -d 1");
   EXPECT_NE(output.find("Hz:"), std::string::npos);
 
+  // Hz raw
+  output = custom_exec_str("gz topic -z /gazebo/default/world_stats "
+      "--raw -d 3");
+  EXPECT_NE(output.find("Hz["), std::string::npos);
+
   // Bw
   output = custom_exec_str("gz topic -b /gazebo/default/world_stats -d 10");
   EXPECT_NE(output.find("Total["), std::string::npos);
@@ -806,6 +856,73 @@ TEST_F(gzTest, SDF)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(gzTest, BenchWorld)
+{
+  std::string helpOutput = custom_exec_str("gz help bench-world");
+  EXPECT_NE(helpOutput.find("gz bench-world"), std::string::npos);
+
+  auto count = [](const std::string &_str, const std::string &_sub)
+  {
+    size_t n = 0;
+    for (size_t pos = _str.find(_sub); pos != std::string::npos;
+        pos = _str.find(_sub, pos + 1))
+    {
+      ++n;
+    }
+    return n;
+  };
+
+  // Generate a world
+  std::string output = custom_exec_str(
+      "gz bench-world -n 5 -c 4 --seed 3 -s imu,contact");
+  EXPECT_NE(output.find("<world name='bench'>"), std::string::npos);
+  EXPECT_EQ(count(output, "<model name='robot_"), 5u);
+  EXPECT_EQ(count(output, "<model name='clutter_"), 4u);
+  EXPECT_EQ(count(output, "<sensor name='imu' type='imu'>"), 5u);
+  EXPECT_EQ(count(output, "<sensor name='contact' type='contact'>"), 5u);
+
+  // The clutter only changes with the seed
+  EXPECT_EQ(output, custom_exec_str(
+      "gz bench-world -n 5 -c 4 --seed 3 -s imu,contact"));
+  EXPECT_NE(output, custom_exec_str(
+      "gz bench-world -n 5 -c 4 --seed 4 -s imu,contact"));
+
+  // Sensors of included models are on a pod next to them
+  output = custom_exec_str(
+      "gz bench-world -n 2 -m model://pioneer2dx -s camera");
+  EXPECT_EQ(count(output, "<uri>model://pioneer2dx</uri>"), 2u);
+  EXPECT_EQ(count(output, "_sensors'><static>true</static>"), 2u);
+  EXPECT_EQ(count(output, "<sensor name='camera' type='camera'>"), 2u);
+
+  // Unknown sensor
+  output = custom_exec_str("gz bench-world -s imu,bogus");
+  EXPECT_NE(output.find("Unknown sensor [bogus]"), std::string::npos);
+
+  // Write to a file, and check the world
+  boost::filesystem::path dir =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  boost::filesystem::path path = dir / "bench.world";
+  output = custom_exec_str("gz bench-world -n 3 -c 3 -s ray -o " +
+      path.string());
+  EXPECT_TRUE(output.empty());
+  EXPECT_TRUE(boost::filesystem::exists(path));
+  output = custom_exec_str("gz sdf -k " + path.string());
+  EXPECT_EQ(output, "Check complete\n");
+
+  // Run a short benchmark on a world of a single robot
+  output = custom_exec_str("gz bench-world -r 1 -d 3 --warmup 1 -o " +
+      dir.string());
+  EXPECT_NE(output.find("# robots, startup (s), real-time factor"),
+      std::string::npos);
+  EXPECT_NE(output.find("\n1, "), std::string::npos);
+  EXPECT_TRUE(boost::filesystem::exists(dir / "gz_bench_1.world"));
+
+  boost::filesystem::remove_all(dir);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -0,0 +1,519 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _WIN32
+  #include <signal.h>
+  #include <sys/types.h>
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <ignition/math/Helpers.hh>
+
+#include <gazebo/common/common.hh>
+
+#include "gz_bench.hh"
+
+using namespace gazebo;
+
+/// \brief Name of the generated worlds, used to measure them.
+static const char *BENCH_WORLD_NAME = "bench";
+
+/// \brief Sensors that can be part of the loadout.
+static const std::set<std::string> BENCH_SENSORS =
+  {"camera", "contact", "gpu_ray", "imu", "ray"};
+
+/// \brief Number of phases printed by `gz stats --phases`.
+static const size_t BENCH_PHASE_COUNT = 8;
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a box.
+/// \param[in] _x Size along X.
+/// \param[in] _y Size along Y.
+/// \param[in] _z Size along Z.
+/// \return SDF of the geometry.
+static std::string BoxGeometry(const double _x, const double _y,
+    const double _z)
+{
+  std::ostringstream sdf;
+  sdf << "<geometry><box><size>" << _x << " " << _y << " " << _z
+    << "</size></box></geometry>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of an inertial with a diagonal inertia.
+/// \param[in] _mass Mass.
+/// \param[in] _inertia Moment of inertia about each axis.
+/// \return SDF of the inertial.
+static std::string Inertial(const double _mass, const double _inertia)
+{
+  std::ostringstream sdf;
+  sdf << "<inertial><mass>" << _mass << "</mass><inertia>"
+    << "<ixx>" << _inertia << "</ixx><ixy>0</ixy><ixz>0</ixz>"
+    << "<iyy>" << _inertia << "</iyy><iyz>0</iyz>"
+    << "<izz>" << _inertia << "</izz></inertia></inertial>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+BenchWorldCommand::BenchWorldCommand()
+  : Command("bench-world",
+      "Generate worlds to benchmark gzserver, and measure how it scales")
+{
+  // Options that are visible to the user through help.
+  this->visibleOptions.add_options()
+    ("robots,n", po::value<unsigned int>()->default_value(10),
+     "Number of robots, laid out on a grid.")
+    ("model,m", po::value<std::string>(), "URI of the robot model, such as "
+     "model://pioneer2dx. A differential drive robot is generated if not "
+     "set.")
+    ("spacing", po::value<double>()->default_value(2.0),
+     "Distance between the robots of the grid, in meters.")
+    ("clutter,c", po::value<unsigned int>()->default_value(0),
+     "Number of boxes, cylinders and spheres placed at random.")
+    ("terrain-size,t", po::value<double>()->default_value(0),
+     "Size of the ground plane in meters, 0 to fit the grid.")
+    ("sensors,s", po::value<std::string>()->default_value(""),
+     "Comma-separated sensors of each robot: camera, contact, gpu_ray, imu "
+     "and ray.")
+    ("seed", po::value<unsigned int>()->default_value(0),
+     "Seed of the random placement of the clutter.")
+    ("output,o", po::value<std::string>(), "File to write the world to, "
+     "or directory of the worlds with --run. Standard output or a "
+     "temporary directory if not set.")
+    ("run,r", po::value<std::string>(), "Comma-separated numbers of "
+     "robots. Launch gzserver on a world of each size, and print the "
+     "startup time, real time factor and phase times for each.")
+    ("duration,d", po::value<unsigned int>()->default_value(20),
+     "Seconds to measure each world for, applicable with run.")
+    ("warmup", po::value<double>()->default_value(5.0),
+     "Seconds of simulation not measured, applicable with run.")
+    ("timeout", po::value<double>()->default_value(300.0),
+     "Seconds to wait for gzserver to load a world, applicable with run.");
+}
+
+/////////////////////////////////////////////////
+void BenchWorldCommand::HelpDetailed()
+{
+  std::cerr <<
+    "\tGenerate a world with a grid of robots, random clutter and a \n"
+    "\tsensor loadout, to benchmark gzserver. With option -r, launch \n"
+    "\tgzserver on a world of each number of robots and print, as \n"
+    "\tcomma-separated values, the wall time until the world publishes \n"
+    "\tits statistics and the averages of `gz stats --phases` once the \n"
+    "\twarmup elapsed. gzserver and gz must be on the PATH, and no other \n"
+    "\tGazebo master may run.\n"
+    << std::endl;
+}
+
+/////////////////////////////////////////////////
+bool BenchWorldCommand::TransportRequired()
+{
+  // The measurements go through `gz stats`, since each gzserver is a new
+  // master
+  return false;
+}
+
+/////////////////////////////////////////////////
+bool BenchWorldCommand::RunImpl()
+{
+  std::vector<std::string> sensors;
+  const std::string sensorList = this->vm["sensors"].as<std::string>();
+  if (!sensorList.empty())
+    boost::split(sensors, sensorList, boost::is_any_of(","));
+  for (auto const &sensor : sensors)
+  {
+    if (BENCH_SENSORS.count(sensor) == 0)
+    {
+      std::cerr << "Unknown sensor [" << sensor << "]\n";
+      return false;
+    }
+  }
+
+  if (!this->vm.count("run"))
+  {
+    const std::string world =
+      this->Generate(this->vm["robots"].as<unsigned int>());
+    if (!this->vm.count("output"))
+    {
+      std::cout << world;
+      return true;
+    }
+
+    std::ofstream out(this->vm["output"].as<std::string>());
+    out << world;
+    if (!out)
+    {
+      std::cerr << "Unable to write ["
+        << this->vm["output"].as<std::string>() << "]\n";
+      return false;
+    }
+    return true;
+  }
+
+  std::vector<std::string> counts;
+  boost::split(counts, this->vm["run"].as<std::string>(),
+      boost::is_any_of(","));
+
+  boost::filesystem::path dir = this->vm.count("output") ?
+    boost::filesystem::path(this->vm["output"].as<std::string>()) :
+    boost::filesystem::temp_directory_path();
+  boost::filesystem::create_directories(dir);
+
+  std::cout << "# robots, startup (s), real-time factor, messages (ms), "
+    << "models (ms), collision (ms), physics (ms), dirty poses (ms), "
+    << "contacts (ms), logging (ms), sensors (ms), samples" << std::endl;
+
+  for (auto const &count : counts)
+  {
+    unsigned int robots = 0;
+    try
+    {
+      robots = boost::lexical_cast<unsigned int>(boost::trim_copy(count));
+    }
+    catch(const boost::bad_lexical_cast &)
+    {
+      std::cerr << "Invalid number of robots [" << count << "]\n";
+      return false;
+    }
+
+    const boost::filesystem::path worldFile = dir /
+      ("gz_bench_" + std::to_string(robots) + ".world");
+    std::ofstream out(worldFile.string());
+    out << this->Generate(robots);
+    out.close();
+    if (!out)
+    {
+      std::cerr << "Unable to write [" << worldFile.string() << "]\n";
+      return false;
+    }
+
+    Result result;
+    if (!this->Measure(robots, worldFile.string(), result))
+      return false;
+
+    printf("%u, %.3f, %.4f", result.robots, result.startup, result.factor);
+    for (auto const phase : result.phases)
+      printf(", %.4f", phase);
+    printf(", %u\n", result.samples);
+    fflush(stdout);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string BenchWorldCommand::Generate(const unsigned int _robots) const
+{
+  const double spacing = this->vm["spacing"].as<double>();
+  const unsigned int columns = std::max(1u,
+      static_cast<unsigned int>(std::ceil(std::sqrt(_robots))));
+  const unsigned int rows = (_robots + columns - 1) / columns;
+
+  double size = this->vm["terrain-size"].as<double>();
+  if (size <= 0)
+    size = std::max(20.0, (std::max(columns, rows) + 2) * spacing);
+
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?>\n"
+    << "<sdf version='1.6'>\n"
+    << "<world name='" << BENCH_WORLD_NAME << "'>\n"
+    << "<include><uri>model://sun</uri></include>\n"
+    << "<model name='ground_plane'><static>true</static>"
+    << "<link name='link'><collision name='collision'><geometry><plane>"
+    << "<normal>0 0 1</normal><size>" << size << " " << size << "</size>"
+    << "</plane></geometry></collision>"
+    << "<visual name='visual'><geometry><plane><normal>0 0 1</normal>"
+    << "<size>" << size << " " << size << "</size></plane></geometry>"
+    << "<material><script><uri>file://media/materials/scripts/gazebo.material"
+    << "</uri><name>Gazebo/Grey</name></script></material></visual>"
+    << "</link></model>\n";
+
+  for (unsigned int i = 0; i < _robots; ++i)
+  {
+    const double x = (i % columns - (columns - 1) * 0.5) * spacing;
+    const double y = (i / columns - (rows - 1) * 0.5) * spacing;
+    sdf << this->Robot("robot_" + std::to_string(i), x, y);
+  }
+
+  // Clutter anywhere on the ground, dropped from its own height
+  std::mt19937 generator(this->vm["seed"].as<unsigned int>());
+  std::uniform_real_distribution<double> position(-size * 0.45, size * 0.45);
+  std::uniform_real_distribution<double> extent(0.1, 0.5);
+  std::uniform_real_distribution<double> yaw(-IGN_PI, IGN_PI);
+  const unsigned int clutter = this->vm["clutter"].as<unsigned int>();
+  for (unsigned int i = 0; i < clutter; ++i)
+  {
+    const double s = extent(generator);
+    std::ostringstream geometry;
+    switch (i % 3)
+    {
+      case 0:
+        geometry << BoxGeometry(s, extent(generator), extent(generator));
+        break;
+      case 1:
+        geometry << "<geometry><cylinder><radius>" << s * 0.5
+          << "</radius><length>" << extent(generator)
+          << "</length></cylinder></geometry>";
+        break;
+      default:
+        geometry << "<geometry><sphere><radius>" << s * 0.5
+          << "</radius></sphere></geometry>";
+        break;
+    }
+
+    const double x = position(generator);
+    const double y = position(generator);
+    sdf << "<model name='clutter_" << i << "'>"
+      << "<pose>" << x << " " << y << " " << s << " 0 0 " << yaw(generator)
+      << "</pose><link name='link'>" << Inertial(0.5, 0.005)
+      << "<collision name='collision'>" << geometry.str() << "</collision>"
+      << "<visual name='visual'>" << geometry.str() << "</visual>"
+      << "</link></model>\n";
+  }
+
+  sdf << "</world>\n</sdf>\n";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+std::string BenchWorldCommand::Robot(const std::string &_name,
+    const double _x, const double _y) const
+{
+  std::ostringstream sdf;
+
+  if (this->vm.count("model"))
+  {
+    // Sensors can't be added to an included model, they are on a static
+    // pod next to the robot
+    sdf << "<include><uri>" << this->vm["model"].as<std::string>()
+      << "</uri><name>" << _name << "</name><pose>" << _x << " " << _y
+      << " 0 0 0 0</pose></include>\n";
+
+    const std::string sensors = this->Sensors("collision");
+    if (!sensors.empty())
+    {
+      sdf << "<model name='" << _name << "_sensors'><static>true</static>"
+        << "<pose>" << _x << " " << _y + this->vm["spacing"].as<double>() * 0.4
+        << " 0.5 0 0 0</pose><link name='pod'>"
+        << "<collision name='collision'>" << BoxGeometry(0.1, 0.1, 0.1)
+        << "</collision>" << sensors << "</link></model>\n";
+    }
+    return sdf.str();
+  }
+
+  const std::string wheel =
+    "<collision name='collision'><geometry><cylinder><radius>0.1</radius>"
+    "<length>0.05</length></cylinder></geometry></collision>"
+    "<visual name='visual'><geometry><cylinder><radius>0.1</radius>"
+    "<length>0.05</length></cylinder></geometry></visual>";
+
+  sdf << "<model name='" << _name << "'><pose>" << _x << " " << _y
+    << " 0 0 0 0</pose>"
+    << "<link name='chassis'><pose>0 0 0.1 0 0 0</pose>"
+    << Inertial(5.0, 0.05)
+    << "<collision name='collision'>" << BoxGeometry(0.4, 0.3, 0.1)
+    << "</collision>"
+    << "<collision name='caster'><pose>-0.15 0 -0.05 0 0 0</pose>"
+    << "<geometry><sphere><radius>0.05</radius></sphere></geometry>"
+    << "<surface><friction><ode><mu>0</mu><mu2>0</mu2></ode></friction>"
+    << "</surface></collision>"
+    << "<visual name='visual'>" << BoxGeometry(0.4, 0.3, 0.1) << "</visual>"
+    << this->Sensors("collision") << "</link>";
+
+  for (const std::string side : {"left", "right"})
+  {
+    sdf << "<link name='" << side << "_wheel'><pose>0.1 "
+      << (side == "left" ? 0.175 : -0.175) << " 0.1 -1.5707 0 0</pose>"
+      << Inertial(0.5, 0.002) << wheel << "</link>"
+      << "<joint name='" << side << "_wheel_hinge' type='revolute'>"
+      << "<parent>chassis</parent><child>" << side << "_wheel</child>"
+      << "<axis><xyz>0 0 1</xyz></axis></joint>";
+  }
+
+  sdf << "</model>\n";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+std::string BenchWorldCommand::Sensors(const std::string &_collision) const
+{
+  std::vector<std::string> sensors;
+  const std::string sensorList = this->vm["sensors"].as<std::string>();
+  if (!sensorList.empty())
+    boost::split(sensors, sensorList, boost::is_any_of(","));
+
+  std::ostringstream sdf;
+  for (auto const &sensor : sensors)
+  {
+    sdf << "<sensor name='" << sensor << "' type='" << sensor << "'>"
+      << "<always_on>true</always_on>";
+    if (sensor == "camera")
+    {
+      sdf << "<update_rate>30</update_rate><camera>"
+        << "<horizontal_fov>1.047</horizontal_fov>"
+        << "<image><width>320</width><height>240</height></image>"
+        << "<clip><near>0.1</near><far>100</far></clip></camera>";
+    }
+    else if (sensor == "ray" || sensor == "gpu_ray")
+    {
+      sdf << "<update_rate>10</update_rate><ray><scan><horizontal>"
+        << "<samples>360</samples><resolution>1</resolution>"
+        << "<min_angle>-3.14159</min_angle><max_angle>3.14159</max_angle>"
+        << "</horizontal></scan><range><min>0.2</min><max>10</max>"
+        << "</range></ray>";
+    }
+    else if (sensor == "imu")
+    {
+      sdf << "<update_rate>100</update_rate>";
+    }
+    else if (sensor == "contact")
+    {
+      sdf << "<update_rate>100</update_rate><contact><collision>"
+        << _collision << "</collision></contact>";
+    }
+    sdf << "</sensor>";
+  }
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+bool BenchWorldCommand::Measure(const unsigned int _robots,
+    const std::string &_worldFile, Result &_result) const
+{
+#ifdef _WIN32
+  std::cerr << "Running the benchmark is not supported on Windows\n";
+  return false;
+#else
+  _result = Result();
+  _result.robots = _robots;
+  _result.phases.assign(BENCH_PHASE_COUNT, 0.0);
+
+  const double warmup = this->vm["warmup"].as<double>();
+  const double timeout = this->vm["timeout"].as<double>();
+  const common::Time start = common::Time::GetWallTime();
+
+  pid_t pid = fork();
+  if (pid < 0)
+  {
+    std::cerr << "Unable to launch gzserver\n";
+    return false;
+  }
+  if (pid == 0)
+  {
+    execlp("gzserver", "gzserver", _worldFile.c_str(),
+        static_cast<char *>(nullptr));
+    _exit(127);
+  }
+
+  // `gz stats` fails while the master isn't up, run it until the world
+  // publishes its statistics
+  const std::string command = std::string(this->argv[0]) + " stats -w " +
+    BENCH_WORLD_NAME + " -p --phases -d " + std::to_string(
+        this->vm["duration"].as<unsigned int>() +
+        static_cast<unsigned int>(std::ceil(warmup)));
+
+  bool started = false;
+  double firstRealTime = 0;
+  while (!started)
+  {
+    int status = 0;
+    if (waitpid(pid, &status, WNOHANG) == pid)
+    {
+      std::cerr << "gzserver exited while loading [" << _worldFile << "]\n";
+      return false;
+    }
+    if ((common::Time::GetWallTime() - start).Double() > timeout)
+    {
+      std::cerr << "gzserver didn't load [" << _worldFile << "] within "
+        << timeout << " seconds\n";
+      break;
+    }
+
+    FILE *pipe = popen(command.c_str(), "r");
+    if (!pipe)
+      break;
+
+    char buffer[1024];
+    while (fgets(buffer, sizeof(buffer), pipe))
+    {
+      if (buffer[0] == '#')
+        continue;
+
+      std::vector<std::string> fields;
+      boost::split(fields, std::string(buffer), boost::is_any_of(","));
+      if (fields.size() != 4 + BENCH_PHASE_COUNT ||
+          boost::trim_copy(fields[3]) == "T")
+      {
+        continue;
+      }
+
+      try
+      {
+        const double realTime = std::stod(fields[2]);
+        if (!started)
+        {
+          started = true;
+          _result.startup = (common::Time::GetWallTime() - start).Double();
+          firstRealTime = realTime;
+        }
+        if (realTime - firstRealTime < warmup)
+          continue;
+
+        _result.factor += std::stod(fields[0]);
+        for (size_t i = 0; i < BENCH_PHASE_COUNT; ++i)
+          _result.phases[i] += std::stod(fields[4 + i]);
+        ++_result.samples;
+      }
+      catch(const std::exception &)
+      {
+        continue;
+      }
+    }
+    pclose(pipe);
+
+    if (!started)
+      common::Time::MSleep(500);
+  }
+
+  kill(pid, SIGINT);
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  if (!started)
+    return false;
+
+  if (_result.samples > 0)
+  {
+    _result.factor /= _result.samples;
+    for (auto &phase : _result.phases)
+      phase /= _result.samples;
+  }
+  return true;
+#endif
+}
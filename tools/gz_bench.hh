@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TOOLS_BENCH_HH_
+#define GAZEBO_TOOLS_BENCH_HH_
+
+#include <string>
+#include <vector>
+#include "gz.hh"
+
+namespace gazebo
+{
+  /// \brief Bench world command. Generates worlds of a given size to
+  /// benchmark gzserver, and measures how gzserver scales with the size.
+  class BenchWorldCommand : public Command
+  {
+    /// \brief Metrics of a gzserver run.
+    public: class Result
+    {
+      /// \brief Number of robots of the world.
+      public: unsigned int robots = 0;
+
+      /// \brief Wall time from the launch of gzserver to the first world
+      /// statistics, in seconds.
+      public: double startup = 0;
+
+      /// \brief Average real time factor.
+      public: double factor = 0;
+
+      /// \brief Average wall time per iteration of the phases of the world
+      /// update, in milliseconds, in the order printed by `gz stats
+      /// --phases`.
+      public: std::vector<double> phases;
+
+      /// \brief Number of world statistics averaged.
+      public: unsigned int samples = 0;
+    };
+
+    /// \brief Constructor
+    public: BenchWorldCommand();
+
+    // Documentation inherited
+    public: virtual void HelpDetailed();
+
+    // Documentation inherited
+    protected: virtual bool RunImpl();
+
+    // Documentation inherited
+    protected: virtual bool TransportRequired();
+
+    /// \brief Generate a world with the options of the command.
+    /// \param[in] _robots Number of robots.
+    /// \return The world, as an SDF string.
+    private: std::string Generate(const unsigned int _robots) const;
+
+    /// \brief Get the SDF of a robot.
+    /// \param[in] _name Name of the robot model.
+    /// \param[in] _x X position.
+    /// \param[in] _y Y position.
+    /// \return The SDF of the robot, and of its sensor pod if it is
+    /// included from a model URI.
+    private: std::string Robot(const std::string &_name, const double _x,
+                 const double _y) const;
+
+    /// \brief Get the SDF of the sensors of the loadout.
+    /// \param[in] _collision Name of the collision of contact sensors.
+    /// \return The SDF of the sensors.
+    private: std::string Sensors(const std::string &_collision) const;
+
+    /// \brief Launch gzserver on a world and measure it with `gz stats`.
+    /// \param[in] _robots Number of robots of the world.
+    /// \param[in] _worldFile Path of the world.
+    /// \param[out] _result The metrics of the run.
+    /// \return False if gzserver couldn't be launched or measured.
+    private: bool Measure(const unsigned int _robots,
+                 const std::string &_worldFile, Result &_result) const;
+  };
+}
+#endif
@@ -22,6 +22,12 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <thread>
+
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -30,6 +36,9 @@
 
 sdf::ElementPtr g_stateSdf;
 
+/// \brief Number of states parsed together by a log export.
+static const size_t EXPORT_BATCH_SIZE = 1000;
+
 using namespace gazebo;
 
 /////////////////////////////////////////////////
@@ -591,6 +600,133 @@ std::string StateFilter::Filter(const std::string &_stateString)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+bool ExportColumn::Init(const std::string &_spec)
+{
+  this->name = _spec;
+  this->model.clear();
+  this->link.clear();
+  this->joint.clear();
+  this->property.clear();
+
+  std::vector<std::string> mainParts;
+  boost::split(mainParts, _spec, boost::is_any_of("/"));
+  if (mainParts.empty() || mainParts.size() > 3 || mainParts[0].empty())
+    return false;
+
+  std::vector<std::string> parts;
+
+  // A joint column: model//joint.axis
+  if (mainParts.size() == 3)
+  {
+    boost::split(parts, mainParts[2], boost::is_any_of("."));
+    if (!mainParts[1].empty() || parts.size() != 2 || parts[0].empty())
+      return false;
+
+    this->model = mainParts[0];
+    this->joint = parts[0];
+    try
+    {
+      this->axis = boost::lexical_cast<unsigned int>(parts[1]);
+    }
+    catch(...)
+    {
+      return false;
+    }
+    return true;
+  }
+
+  // A model column, model.pose.element, or a link column,
+  // model/link.property.element
+  boost::split(parts, mainParts.back(), boost::is_any_of("."));
+  if (parts.size() != 3 || parts[0].empty() || parts[2].empty())
+    return false;
+
+  if (mainParts.size() == 2)
+  {
+    this->model = mainParts[0];
+    this->link = parts[0];
+  }
+  else
+    this->model = parts[0];
+
+  this->property = parts[1];
+  if (this->property != "pose" && (this->link.empty() ||
+      (this->property != "velocity" && this->property != "acceleration" &&
+       this->property != "wrench")))
+  {
+    return false;
+  }
+
+  this->element = std::tolower(parts[2][0]);
+  return std::string("xyzrpa").find(this->element) != std::string::npos;
+}
+
+/////////////////////////////////////////////////
+bool ExportColumn::Value(const gazebo::physics::WorldState &_state,
+    double &_value) const
+{
+  auto modelIter = _state.GetModelStates().find(this->model);
+  if (modelIter == _state.GetModelStates().end())
+    return false;
+  const gazebo::physics::ModelState &modelState = modelIter->second;
+
+  if (!this->joint.empty())
+  {
+    auto jointIter = modelState.GetJointStates().find(this->joint);
+    if (jointIter == modelState.GetJointStates().end() ||
+        this->axis >= jointIter->second.GetAngleCount())
+    {
+      return false;
+    }
+
+    _value = jointIter->second.Position(this->axis);
+    return true;
+  }
+
+  if (this->link.empty())
+  {
+    _value = this->PoseValue(modelState.Pose());
+    return true;
+  }
+
+  auto linkIter = modelState.GetLinkStates().find(this->link);
+  if (linkIter == modelState.GetLinkStates().end())
+    return false;
+  const gazebo::physics::LinkState &linkState = linkIter->second;
+
+  if (this->property == "pose")
+    _value = this->PoseValue(linkState.Pose());
+  else if (this->property == "velocity")
+    _value = this->PoseValue(linkState.Velocity());
+  else if (this->property == "acceleration")
+    _value = this->PoseValue(linkState.Acceleration());
+  else
+    _value = this->PoseValue(linkState.Wrench());
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+double ExportColumn::PoseValue(const ignition::math::Pose3d &_pose) const
+{
+  switch (this->element)
+  {
+    case 'x':
+      return _pose.Pos().X();
+    case 'y':
+      return _pose.Pos().Y();
+    case 'z':
+      return _pose.Pos().Z();
+    case 'r':
+      return _pose.Rot().Euler().X();
+    case 'p':
+      return _pose.Rot().Euler().Y();
+    default:
+      return _pose.Rot().Euler().Z();
+  }
+}
+
 /////////////////////////////////////////////////
 LogCommand::LogCommand()
   : Command("log", "Introspects and manipulates Gazebo log files.")
@@ -622,7 +758,14 @@ LogCommand::LogCommand()
      "Valid in conjunction with the output command. See also the "
      "--output argument.")
     ("filter", po::value<std::string>(),
-     "Filter output. Valid only with the echo, step, and output commands");
+     "Filter output. Valid only with the echo, step, and output commands")
+    ("export", po::value<std::string>(),
+     "Export the values selected with --columns to a CSV file, with one "
+     "row per state. Valid in conjunction with the hz command.")
+    ("columns", po::value<std::string>(),
+     "Comma separated list of values to export, such as "
+     "model.pose.x, model/link.velocity.z or model//joint.0. Valid only "
+     "with the export command.");
 }
 
 /////////////////////////////////////////////////
@@ -700,6 +843,14 @@ bool LogCommand::RunImpl()
     this->Output(this->vm["output"].as<std::string>(), filter, raw, stamp, hz,
         encoding);
   }
+  else if (this->vm.count("export"))
+  {
+    std::string columns = this->vm.count("columns") ?
+      this->vm["columns"].as<std::string>() : "";
+
+    if (!this->Export(this->vm["export"].as<std::string>(), columns, hz))
+      return false;
+  }
   else if (this->vm.count("echo"))
     this->Echo(filter, raw, stamp, hz);
   else if (this->vm.count("step"))
@@ -892,6 +1043,126 @@ void LogCommand::Output(const std::string &_outFilename,
   outFile.close();
 }
 
+/////////////////////////////////////////////////
+bool LogCommand::Export(const std::string &_outFilename,
+    const std::string &_columns, const double _hz)
+{
+  if (_columns.empty())
+  {
+    std::cerr << "No columns to export. Use the --columns argument.\n";
+    return false;
+  }
+
+  std::vector<std::string> specs;
+  boost::split(specs, _columns, boost::is_any_of(","));
+
+  std::vector<ExportColumn> columns;
+  for (auto const &spec : specs)
+  {
+    ExportColumn column;
+    if (!column.Init(boost::trim_copy(spec)))
+    {
+      std::cerr << "Invalid export column[" << spec << "]\n";
+      return false;
+    }
+    columns.push_back(column);
+  }
+
+  std::ofstream outFile(_outFilename);
+  if (!outFile.is_open())
+  {
+    std::cerr << "Unable to open file[" << _outFilename << "] for writing.\n";
+    return false;
+  }
+
+  gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
+
+  outFile << "sim_time";
+  for (auto const &column : columns)
+    outFile << "," << column.name;
+  outFile << "\n";
+  outFile << std::fixed;
+
+  const unsigned int threadCount =
+    std::max(1u, std::thread::hardware_concurrency());
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // States may only hold the entities that changed, so a missing value
+  // carries over from the previous states.
+  std::vector<double> values(columns.size(), nan);
+  double prevTime = 0;
+  bool written = false;
+
+  // Skip the world description.
+  std::string frame;
+  bool more = play->Step(frame);
+
+  std::vector<std::string> frames;
+  while (more)
+  {
+    frames.clear();
+    while (frames.size() < EXPORT_BATCH_SIZE && (more = play->Step(frame)))
+      frames.push_back(frame);
+
+    // Parse the states of the batch in parallel. The first value of a row
+    // is the simulation time.
+    std::vector<std::vector<double>> rows(frames.size());
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < threadCount; ++t)
+    {
+      threads.push_back(std::thread([&, t]()
+      {
+        sdf::ElementPtr stateSdf(new sdf::Element);
+        sdf::initFile("state.sdf", stateSdf);
+
+        for (size_t i = t; i < frames.size(); i += threadCount)
+        {
+          gazebo::physics::WorldState state;
+          stateSdf->Clear();
+          sdf::readString(frames[i], stateSdf);
+          state.Load(stateSdf);
+
+          rows[i].resize(columns.size() + 1, nan);
+          rows[i][0] = state.GetSimTime().Double();
+          for (size_t c = 0; c < columns.size(); ++c)
+            columns[c].Value(state, rows[i][c + 1]);
+        }
+      }));
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    // Write the rows in order.
+    for (auto const &row : rows)
+    {
+      for (size_t c = 0; c < columns.size(); ++c)
+      {
+        if (!std::isnan(row[c + 1]))
+          values[c] = row[c + 1];
+      }
+
+      if (_hz > 0.0 && written && row[0] - prevTime < 1.0 / _hz)
+        continue;
+
+      outFile << row[0];
+      for (auto const value : values)
+      {
+        outFile << ",";
+        if (!std::isnan(value))
+          outFile << value;
+      }
+      outFile << "\n";
+
+      prevTime = row[0];
+      written = true;
+    }
+  }
+
+  outFile.close();
+  return true;
+}
+
 /////////////////////////////////////////////////
 void LogCommand::Echo(const std::string &_filter, bool _raw,
     const std::string &_stamp, double _hz)
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 
 #include <gazebo/physics/WorldState.hh>
 #include "gz.hh"
@@ -187,6 +188,54 @@ namespace gazebo
     private: gazebo::common::Time prevTime;
   };
 
+  /// \brief One column of a log export: a single value of a model, link,
+  /// or joint state.
+  class ExportColumn
+  {
+    /// \brief Initialize the column from its specification.
+    /// Valid specifications are:
+    /// model.pose.x, model/link.pose.x and model//joint.0. Links accept
+    /// pose, velocity, acceleration, and wrench. Pose elements are
+    /// x, y, z, r, p, and a (yaw).
+    /// \param[in] _spec Column specification.
+    /// \return True if the specification is valid.
+    public: bool Init(const std::string &_spec);
+
+    /// \brief Get the value of the column in a state.
+    /// \param[in] _state World state to read.
+    /// \param[out] _value Value of the column.
+    /// \return False if the state doesn't hold the column's entity.
+    public: bool Value(const gazebo::physics::WorldState &_state,
+                       double &_value) const;
+
+    /// \brief Get a value of a pose.
+    /// \param[in] _pose Pose to read.
+    /// \return The element of the pose selected by the column.
+    private: double PoseValue(const ignition::math::Pose3d &_pose) const;
+
+    /// \brief Column specification, used as the column name.
+    public: std::string name;
+
+    /// \brief Name of the model.
+    private: std::string model;
+
+    /// \brief Name of the link, empty for a model or joint column.
+    private: std::string link;
+
+    /// \brief Name of the joint, empty for a model or link column.
+    private: std::string joint;
+
+    /// \brief Link or model property: pose, velocity, acceleration or
+    /// wrench.
+    private: std::string property;
+
+    /// \brief Pose element (x, y, z, r, p, a).
+    private: char element = 'x';
+
+    /// \brief Joint axis.
+    private: unsigned int axis = 0;
+  };
+
   /// \brief Log command
   class LogCommand : public Command
   {
@@ -222,6 +271,16 @@ namespace gazebo
                  const std::string &_stamp, const double _hz,
                  const std::string &_encoding = "");
 
+    /// \brief Export selected state values to a CSV file, with one row per
+    /// state and one column per value. States are parsed in parallel.
+    /// \param[in] _outFilename Output filename
+    /// \param[in] _columns Comma separated list of column specifications,
+    /// see ExportColumn::Init.
+    /// \param[in] _hz Hertz rate.
+    /// \return True on success.
+    private: bool Export(const std::string &_outFilename,
+                 const std::string &_columns, const double _hz);
+
     /// \brief Dump the contents of a log file to screen
     /// \param[in] _filter Filter string
     /// \param[in] _raw True to output data without xml formatting.
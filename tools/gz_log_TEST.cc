@@ -24,6 +24,8 @@
 #include <sdf/sdf_config.h>
 
 #include <stdio.h>
+#include <fstream>
+#include <sstream>
 #include <string>
 
 // This header file isn't needed if shasums are used
@@ -474,6 +476,42 @@ TEST(gz_log, Output)
 #endif
 }
 
+/////////////////////////////////////////////////
+/// Check that 'gz log --export' writes the selected columns
+TEST(gz_log, Export)
+{
+  std::ostringstream filename;
+  filename << "/tmp/__gz_log_export_test" << std::this_thread::get_id()
+    << ".csv";
+
+  custom_exec(GZ_LOG_PATH + " -f " + PROJECT_SOURCE_PATH +
+      "/test/data/pr2_state.log --export " + filename.str() +
+      " --columns pr2.pose.z,pr2/base_footprint.velocity.z,"
+      "pr2//torso_lift_joint.0");
+
+  std::ifstream in(filename.str());
+  ASSERT_TRUE(in.is_open());
+
+  std::string line;
+  ASSERT_TRUE(std::getline(in, line));
+  EXPECT_EQ("sim_time,pr2.pose.z,pr2/base_footprint.velocity.z,"
+      "pr2//torso_lift_joint.0", line);
+  ASSERT_TRUE(std::getline(in, line));
+  EXPECT_EQ("0.021344,-0.000008,-0.007966,0.000001", line);
+  ASSERT_TRUE(std::getline(in, line));
+  EXPECT_EQ(0u, line.find("0.028958,"));
+  EXPECT_FALSE(std::getline(in, line));
+  in.close();
+
+  // Invalid columns
+  std::remove(filename.str().c_str());
+  custom_exec(GZ_LOG_PATH + " -f " + PROJECT_SOURCE_PATH +
+      "/test/data/pr2_state.log --export " + filename.str() +
+      " --columns pr2/base_footprint.color.z");
+  std::ifstream invalid(filename.str());
+  EXPECT_FALSE(invalid.is_open());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
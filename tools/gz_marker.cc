@@ -46,7 +46,9 @@ MarkerCommand::MarkerCommand()
     ("delete-all,x", "Delete all markers, or all markers in a namespace.")
     ("list,l", "Get a list of the visual markers.")
     ("layer,y", po::value<int32_t>(),
-     "Add or move a marker to the specified layer.");
+     "Add or move a marker to the specified layer.")
+    ("bulk,b", "Send the message of -m, or the deletion of -x, as bulk "
+     "markers.");
 }
 
 /////////////////////////////////////////////////
@@ -108,7 +110,21 @@ void MarkerCommand::HelpDetailed()
     << "     $ ign msg -i ign_msgs.Marker\n\n"
     << "  Example:\n\n"
     << "     $ gz marker -m 'action: ADD_MODIFY, type: SPHERE, id: 2,"
-    << " scale: {x:0.2, y:0.4, z:1.2}'\n"
+    << " scale: {x:0.2, y:0.4, z:1.2}'\n\n"
+
+    << "-b, --bulk: no argument\n\n"
+    << "  Use this option with -m to send an ign_msgs.Marker_V message\n"
+    << "  holding many markers of one namespace, which are rendered as a\n"
+    << "  single batch. The first marker sets the type, material, layer,\n"
+    << "  parent and lifetime of the batch, the others only need an id and\n"
+    << "  a pose, a scale or points. Markers are later moved or deleted by\n"
+    << "  id, in place. Use this option with -x and -n to delete the batch\n"
+    << "  of a namespace.\n\n"
+    << "  Example:\n\n"
+    << "     $ gz marker -b -m 'marker {ns: \"cells\", id: 1,"
+    << " action: ADD_MODIFY, type: BOX,"
+    << " pose {position {x: 1}}} marker {ns: \"cells\", id: 2,"
+    << " pose {position {x: 2}}}'\n"
     << std::endl;
 }
 
@@ -127,6 +143,17 @@ bool MarkerCommand::RunImpl()
 
   node.Advertise<ignition::msgs::Marker>("/marker");
 
+  if (this->vm.count("bulk"))
+  {
+    if (std::find(serviceList.begin(), serviceList.end(), "/marker/bulk")
+        == serviceList.end())
+    {
+      std::cerr << "Error: /marker/bulk service not present on network.\n";
+      return false;
+    }
+    node.Advertise<ignition::msgs::Marker_V>("/marker/bulk");
+  }
+
   std::string ns = "";
   unsigned int id = 0;
   int32_t layer = 0;
@@ -147,7 +174,11 @@ bool MarkerCommand::RunImpl()
   if (this->vm.count("layer"))
     layer = this->vm["layer"].as<int32_t>();
 
-  if (this->vm.count("msg"))
+  if (this->vm.count("bulk") && this->vm.count("msg"))
+    this->BulkMsg(this->vm["msg"].as<std::string>());
+  else if (this->vm.count("bulk") && this->vm.count("delete-all"))
+    this->BulkDeleteAll(ns);
+  else if (this->vm.count("msg"))
     this->Msg(this->vm["msg"].as<std::string>());
   else if (this->vm.count("list"))
     this->List();
@@ -349,6 +380,36 @@ void MarkerCommand::Msg(const std::string &_msg)
   }
 }
 
+/////////////////////////////////////////////////
+void MarkerCommand::BulkMsg(const std::string &_msg)
+{
+  if (!_msg.empty())
+  {
+    ignition::msgs::Marker_V msg;
+    if (google::protobuf::TextFormat::ParseFromString(_msg, &msg))
+    {
+      if (!this->node.Request("/marker/bulk", msg))
+        std::cerr << "Unable to send bulk marker request.\n ";
+    }
+    else
+    {
+      std::cerr << "Invalid string message: " << _msg << std::endl;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void MarkerCommand::BulkDeleteAll(const std::string &_ns)
+{
+  ignition::msgs::Marker_V msg;
+  ignition::msgs::Marker *markerMsg = msg.add_marker();
+  markerMsg->set_ns(_ns);
+  markerMsg->set_action(ignition::msgs::Marker::DELETE_ALL);
+
+  if (!this->node.Request("/marker/bulk", msg))
+    std::cerr << "Failed to delete the bulk markers.";
+}
+
 /////////////////////////////////////////////////
 void MarkerCommand::Delete(const std::string &_ns, const unsigned int _id)
 {
@@ -55,6 +55,14 @@ namespace gazebo
     /// \param[in] _msg String representation of a marker protobuf message.
     private: void Msg(const std::string &_msg);
 
+    /// \brief Send a bulk marker message
+    /// \param[in] _msg String representation of a Marker_V protobuf message.
+    private: void BulkMsg(const std::string &_msg);
+
+    /// \brief Delete the bulk markers of a namespace.
+    /// \param[in] _ns The namespace.
+    private: void BulkDeleteAll(const std::string &_ns);
+
     /// \brief Delete a marker.
     /// \param[in] _ns Namespace for the marker
     /// \param[in] _id Marker id
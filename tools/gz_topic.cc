@@ -14,7 +14,11 @@
  * limitations under the License.
  *
 */
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/text_format.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <boost/algorithm/string.hpp>
 
 #include <gazebo/gui/qt.h>
 #include <gazebo/gui/TopicSelector.hh>
@@ -52,11 +56,21 @@ TopicCommand::TopicCommand()
      "View topic data using a QT widget.")
     ("hz,z", po::value<std::string>(), "Get publish frequency.")
     ("bw,b", po::value<std::string>(), "Get topic bandwidth.")
+    ("stats,s", po::value<std::string>()->implicit_value(""),
+     "Get the queues, drops and latencies of the topics of the server, "
+     "or of a single topic.")
     ("publish,p", po::value<std::string>(), "Publish message on a topic.")
     ("request,r", po::value<std::string>(), "Send a request.")
     ("unformatted,u", "Output data from echo without formatting.")
+    ("field", po::value<std::vector<std::string>>()->composing(),
+     "Only decode and output this field of the messages of echo, as a dot "
+     "separated path such as pose.position. May be repeated.")
+    ("raw", "Output the rate and bandwidth of echo and hz once per second, "
+     "measured from the message sizes without decoding the messages.")
+    ("dump", po::value<std::string>(), "Write the messages of echo to this "
+     "file without decoding them, instead of the screen.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run. "
-     "Applicable with echo, hz, and bw")
+     "Applicable with echo, hz, bw and stats")
     ("msg,m", po::value<std::string>(), "Message to send on topic. "
      "Applicable with publish and request")
     ("file,f", po::value<std::string>(), "Path to a file containing the "
@@ -72,6 +86,15 @@ void TopicCommand::HelpDetailed()
     "If a name for the world, \n"
     "\toption -w, is not specified, the first world found on \n"
     "\tthe Gazebo master will be used.\n"
+    "\tOption --stats prints, once per second, the published, dropped \n"
+    "\tand delivered messages of the topics of the server, the depth of \n"
+    "\ttheir queues, the average and maximum latency to the callbacks \n"
+    "\tand the average serialization time.\n"
+    "\tOptions --field, --raw and --dump inspect busy topics without \n"
+    "\tdecoding every message. The file written by --dump starts with the \n"
+    "\tmessage type and a newline. Each message follows as its receive \n"
+    "\twall time in nanoseconds (8 bytes) and its size (4 bytes), both \n"
+    "\tlittle endian, then its serialized bytes.\n"
     << std::endl;
 }
 
@@ -96,6 +119,8 @@ bool TopicCommand::RunImpl()
     this->Hz(this->vm["hz"].as<std::string>());
   else if (this->vm.count("bw"))
     this->Bw(this->vm["bw"].as<std::string>());
+  else if (this->vm.count("stats"))
+    this->Stats(this->vm["stats"].as<std::string>());
   else if (this->vm.count("view"))
     this->View(this->vm["view"].as<std::string>());
   else if (this->vm.count("publish"))
@@ -197,6 +222,182 @@ void TopicCommand::EchoCB(const std::string &_data)
     std::cout << this->echoMsg->DebugString() << "\n";
 }
 
+/////////////////////////////////////////////////
+void TopicCommand::PrintField(google::protobuf::io::CodedInputStream &_in,
+    const uint8_t *_data, const EchoField &_field, const size_t _depth,
+    const google::protobuf::TextFormat::Printer &_printer, std::ostream &_out)
+{
+  using google::protobuf::internal::WireFormatLite;
+
+  const google::protobuf::FieldDescriptor *field = _field.path[_depth];
+  const bool leaf = _depth + 1 == _field.path.size();
+
+  while (true)
+  {
+    const int start = _in.CurrentPosition();
+    const uint32_t tag = _in.ReadTag();
+    if (tag == 0)
+      return;
+
+    if (WireFormatLite::GetTagFieldNumber(tag) !=
+        static_cast<int>(field->number()))
+    {
+      if (!WireFormatLite::SkipField(&_in, tag))
+        return;
+      continue;
+    }
+
+    if (!leaf)
+    {
+      // Descend into the message without copying it
+      uint32_t length;
+      if (WireFormatLite::GetTagWireType(tag) !=
+          WireFormatLite::WIRETYPE_LENGTH_DELIMITED ||
+          !_in.ReadVarint32(&length))
+      {
+        return;
+      }
+
+      auto limit = _in.PushLimit(length);
+      PrintField(_in, _data, _field, _depth + 1, _printer, _out);
+      _in.Skip(_in.BytesUntilLimit());
+      _in.PopLimit(limit);
+      continue;
+    }
+
+    // Decode the field alone, as the only field of its message
+    if (!WireFormatLite::SkipField(&_in, tag))
+      return;
+
+    google::protobuf::Message &msg = *_field.message;
+    if (!msg.ParsePartialFromArray(_data + start,
+          _in.CurrentPosition() - start))
+    {
+      continue;
+    }
+
+    std::string value;
+    if (field->is_repeated())
+    {
+      const int count = msg.GetReflection()->FieldSize(msg, field);
+      for (int i = 0; i < count; ++i)
+      {
+        _printer.PrintFieldValueToString(msg, field, i, &value);
+        _out << _field.name << ": " << value << "\n";
+      }
+    }
+    else
+    {
+      _printer.PrintFieldValueToString(msg, field, -1, &value);
+      _out << _field.name << ": " << value << "\n";
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool TopicCommand::LoadFields(const google::protobuf::Descriptor *_descriptor)
+{
+  for (auto const &name : this->vm["field"].as<std::vector<std::string>>())
+  {
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of("."));
+
+    EchoField echoField;
+    echoField.name = name;
+    const google::protobuf::Descriptor *descriptor = _descriptor;
+    for (auto const &part : parts)
+    {
+      const google::protobuf::FieldDescriptor *field = descriptor ?
+          descriptor->FindFieldByName(part) : nullptr;
+      if (!field)
+      {
+        gzerr << "Unable to find field[" << part << "] of path[" << name
+              << "] in message of type[" << _descriptor->full_name()
+              << "]\n";
+        return false;
+      }
+      echoField.path.push_back(field);
+      descriptor = field->message_type();
+    }
+
+    const google::protobuf::Message *prototype =
+        google::protobuf::MessageFactory::generated_factory()->GetPrototype(
+            echoField.path.back()->containing_type());
+    if (!prototype)
+    {
+      gzerr << "Unable to create message for field[" << name << "]\n";
+      return false;
+    }
+    echoField.message.reset(prototype->New());
+    this->echoFields.push_back(std::move(echoField));
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::FieldsCB(const std::string &_data)
+{
+  google::protobuf::TextFormat::Printer printer;
+  printer.SetSingleLineMode(this->vm.count("unformatted") > 0);
+
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(_data.data());
+  std::ostringstream out;
+  for (auto const &field : this->echoFields)
+  {
+    google::protobuf::io::CodedInputStream in(data, _data.size());
+    PrintField(in, data, field, 0, printer, out);
+  }
+  std::cout << out.str() << "\n";
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::RawCB(const std::string &_data)
+{
+  const common::Time curTime = common::Time::GetWallTime();
+
+  if (this->dumpFile.is_open())
+  {
+    const uint64_t stamp =
+        static_cast<uint64_t>(curTime.sec) * 1000000000ull + curTime.nsec;
+    const uint32_t size = _data.size();
+    char header[12];
+    for (int i = 0; i < 8; ++i)
+      header[i] = static_cast<char>((stamp >> (8 * i)) & 0xff);
+    for (int i = 0; i < 4; ++i)
+      header[8 + i] = static_cast<char>((size >> (8 * i)) & 0xff);
+    this->dumpFile.write(header, sizeof(header));
+    this->dumpFile.write(_data.data(), _data.size());
+  }
+
+  ++this->rawMessages;
+  this->rawBytes += _data.size();
+
+  // One second time window
+  const double dt = (curTime - this->rawStart).Double();
+  if (dt < 1.0)
+    return;
+
+  const double bps = this->rawBytes / dt;
+  std::ostringstream bandwidth;
+  bandwidth << std::fixed << std::setprecision(2);
+  if (bps < 1000)
+    bandwidth << bps << " B/s";
+  else if (bps < 1000000)
+    bandwidth << bps / 1024.0 << " KB/s";
+  else
+    bandwidth << bps / 1.049e6 << " MB/s";
+
+  std::cout << std::fixed << std::setprecision(2)
+    << "Hz[" << this->rawMessages / dt << "] "
+    << "Bandwidth[" << bandwidth.str() << "] "
+    << "Messages[" << this->rawMessages << "]" << std::endl;
+
+  this->rawMessages = 0;
+  this->rawBytes = 0;
+  this->rawStart = curTime;
+}
+
 /////////////////////////////////////////////////
 void TopicCommand::Echo(const std::string &_topic)
 {
@@ -210,24 +411,60 @@ void TopicCommand::Echo(const std::string &_topic)
     return;
   }
 
-  this->echoMsg = msgs::MsgFactory::NewMsg(msgTypeName);
+  transport::SubscriberPtr sub;
+  if (this->vm.count("raw") || this->vm.count("dump"))
+  {
+    if (this->vm.count("dump"))
+    {
+      const std::string filename = this->vm["dump"].as<std::string>();
+      this->dumpFile.open(filename.c_str(),
+          std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!this->dumpFile.is_open())
+      {
+        gzerr << "Unable to open file[" << filename << "]\n";
+        return;
+      }
+      this->dumpFile << msgTypeName << "\n";
+    }
 
-  if (!this->echoMsg)
+    this->rawStart = common::Time::GetWallTime();
+    sub = this->node->Subscribe(_topic, &TopicCommand::RawCB, this);
+  }
+  else
   {
-    gzerr << "Unable to create message of type[" << msgTypeName << "]\n";
-    transport::fini();
-    return;
+    this->echoMsg = msgs::MsgFactory::NewMsg(msgTypeName);
+
+    if (!this->echoMsg)
+    {
+      gzerr << "Unable to create message of type[" << msgTypeName << "]\n";
+      transport::fini();
+      return;
+    }
+
+    if (this->vm.count("field"))
+    {
+      if (!this->LoadFields(this->echoMsg->GetDescriptor()))
+        return;
+      sub = this->node->Subscribe(_topic, &TopicCommand::FieldsCB, this);
+    }
+    else
+    {
+      sub = this->node->Subscribe(_topic, &TopicCommand::EchoCB, this);
+    }
   }
 
-  transport::SubscriberPtr sub = this->node->Subscribe(_topic,
-      &TopicCommand::EchoCB, this);
+  {
+    boost::mutex::scoped_lock lock(this->sigMutex);
+    if (this->vm.count("duration"))
+      this->sigCondition.timed_wait(lock,
+          boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+    else
+      this->sigCondition.wait(lock);
+  }
 
-  boost::mutex::scoped_lock lock(this->sigMutex);
-  if (this->vm.count("duration"))
-    this->sigCondition.timed_wait(lock,
-        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
-  else
-    this->sigCondition.wait(lock);
+  sub.reset();
+  if (this->dumpFile.is_open())
+    this->dumpFile.close();
 }
 
 /////////////////////////////////////////////////
@@ -244,8 +481,16 @@ void TopicCommand::HzCB(const std::string &/*_data*/)
 /////////////////////////////////////////////////
 void TopicCommand::Hz(const std::string &_topic)
 {
-  transport::SubscriberPtr sub = this->node->Subscribe(_topic,
-      &TopicCommand::HzCB, this);
+  transport::SubscriberPtr sub;
+  if (this->vm.count("raw"))
+  {
+    this->rawStart = common::Time::GetWallTime();
+    sub = this->node->Subscribe(_topic, &TopicCommand::RawCB, this);
+  }
+  else
+  {
+    sub = this->node->Subscribe(_topic, &TopicCommand::HzCB, this);
+  }
 
   boost::mutex::scoped_lock lock(this->sigMutex);
   if (this->vm.count("duration"))
@@ -347,6 +592,54 @@ void TopicCommand::Bw(const std::string &_topic)
     this->sigCondition.wait(lock);
 }
 
+/////////////////////////////////////////////////
+void TopicCommand::StatsCB(ConstTransportStatsPtr &_msg)
+{
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  for (auto const &topic : _msg->topic())
+  {
+    if (!this->statsTopic.empty() && topic.name() != this->statsTopic)
+      continue;
+
+    out << topic.name()
+      << " Published[" << topic.published() << "]"
+      << " Dropped[" << topic.dropped() << "]"
+      << " Outgoing[" << topic.outgoing() << "]"
+      << " Incoming[" << topic.incoming() << "]"
+      << " Delivered[" << topic.delivered() << "]"
+      << " Latency[avg " << topic.latency_avg() * 1e3 << " ms, max "
+      << topic.latency_max() * 1e3 << " ms]"
+      << " Serialization[" << topic.serialized() << ", avg "
+      << topic.serialization_avg() * 1e3 << " ms]\n";
+
+    for (auto const &conn : topic.connection())
+    {
+      out << "  Connection[" << conn.remote_uri() << "]"
+        << " Queued[" << conn.queued_messages() << " messages, "
+        << conn.queued_bytes() / 1024.0 << " KB]\n";
+    }
+  }
+  std::cout << out.str() << std::endl;
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::Stats(const std::string &_topic)
+{
+  if (!_topic.empty())
+    this->statsTopic = this->node->DecodeTopicName(_topic);
+
+  transport::SubscriberPtr sub = this->node->Subscribe("~/transport/stats",
+      &TopicCommand::StatsCB, this);
+
+  boost::mutex::scoped_lock lock(this->sigMutex);
+  if (this->vm.count("duration"))
+    this->sigCondition.timed_wait(lock,
+        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+  else
+    this->sigCondition.wait(lock);
+}
+
 /////////////////////////////////////////////////
 void TopicCommand::View(const std::string &_topic)
 {
@@ -17,6 +17,11 @@
 #ifndef _GZ_TOPIC_HH_
 #define _GZ_TOPIC_HH_
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/text_format.h>
+
+#include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -27,6 +32,20 @@ namespace gazebo
   /// \brief Topic command
   class TopicCommand : public Command
   {
+    /// \brief Field output by echo, see --field.
+    private: class EchoField
+    {
+      /// \brief Path given on the command line.
+      public: std::string name;
+
+      /// \brief Descriptors of the fields along the path.
+      public: std::vector<const google::protobuf::FieldDescriptor *> path;
+
+      /// \brief Message that contains the last field, which receives the
+      /// field alone.
+      public: std::unique_ptr<google::protobuf::Message> message;
+    };
+
     /// \brief Constructor
     public: TopicCommand();
 
@@ -56,6 +75,38 @@ namespace gazebo
     /// \param[in] _data Data message from a topic.
     private: void EchoCB(const std::string &_data);
 
+    /// \brief Callback used by Echo() to output the fields selected with
+    /// --field, decoding only those fields.
+    /// \param[in] _data Data message from a topic.
+    private: void FieldsCB(const std::string &_data);
+
+    /// \brief Callback used by Echo() and Hz() with --raw or --dump, which
+    /// measures the rate and bandwidth of a topic from the message sizes
+    /// without decoding the messages.
+    /// \param[in] _data Data message from a topic.
+    private: void RawCB(const std::string &_data);
+
+    /// \brief Output the values of a field of a serialized message,
+    /// decoding only that field.
+    /// \param[in] _in Stream of the message, positioned at a field.
+    /// \param[in] _data Start of the stream.
+    /// \param[in] _field The field.
+    /// \param[in] _depth Index in the path of the field of the current
+    /// message.
+    /// \param[in] _printer Printer of the values.
+    /// \param[out] _out Stream the values are written to.
+    private: static void PrintField(
+                 google::protobuf::io::CodedInputStream &_in,
+                 const uint8_t *_data, const EchoField &_field,
+                 const size_t _depth,
+                 const google::protobuf::TextFormat::Printer &_printer,
+                 std::ostream &_out);
+
+    /// \brief Resolve the field paths given with --field.
+    /// \param[in] _descriptor Descriptor of the messages of the topic.
+    /// \return False if a path is invalid.
+    private: bool LoadFields(const google::protobuf::Descriptor *_descriptor);
+
     /// \brief Callback used by Hz() to receive topic messages.
     /// \param[in] _data Data message from a topic (unused).
     private: void HzCB(const std::string &_data);
@@ -72,6 +123,14 @@ namespace gazebo
     /// \param[in] _topic Topic name.
     private: void Bw(const std::string &_topic);
 
+    /// \brief Subscription callback used by Stats().
+    /// \param[in] _msg Transport statistics of the server.
+    private: void StatsCB(ConstTransportStatsPtr &_msg);
+
+    /// \brief Output the transport statistics of the server.
+    /// \param[in] _topic Topic name, empty for all the topics.
+    private: void Stats(const std::string &_topic);
+
     /// \brief View topic information using QT.
     /// \param[in] _topic Name of the topic to view. Empty will bring up
     /// a topic selector.
@@ -103,6 +162,24 @@ namespace gazebo
 
     /// \brief Buffer of message publish times, used by Bw().
     private: std::vector<common::Time> bwTime;
+
+    /// \brief Fully qualified topic printed by Stats(), empty for all.
+    private: std::string statsTopic;
+
+    /// \brief Fields output by echo, empty to output whole messages.
+    private: std::vector<EchoField> echoFields;
+
+    /// \brief Messages received by RawCB() in the current window.
+    private: uint64_t rawMessages = 0;
+
+    /// \brief Bytes received by RawCB() in the current window.
+    private: uint64_t rawBytes = 0;
+
+    /// \brief Start of the current window of RawCB().
+    private: common::Time rawStart;
+
+    /// \brief File written by echo with --dump.
+    private: std::ofstream dumpFile;
   };
 }
 #endif